@@ -64,7 +64,7 @@ Url InterceptorManager::RedactUrl(Url const& url)
   redactedUrl.SetHost("REDACTED" + std::string(hostWithNoAccount, host.end()));
   redactedUrl.SetPath(url.GetPath());
   // Query parameters
-  for (auto const& qp : url.GetQueryParameters())
+  for (auto const& qp : url.GetQueryParametersView())
   {
     if (qp.first == "sig")
     {
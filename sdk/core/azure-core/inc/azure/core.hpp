@@ -20,6 +20,7 @@
 #include "azure/core/modified_conditions.hpp"
 #include "azure/core/nullable.hpp"
 #include "azure/core/operation.hpp"
+#include "azure/core/operation_tracker.hpp"
 #include "azure/core/operation_status.hpp"
 #include "azure/core/paged_response.hpp"
 #include "azure/core/platform.hpp"
@@ -35,12 +36,16 @@
 #include "azure/core/cryptography/hash.hpp"
 
 // azure/core/diagnostics
+#include "azure/core/diagnostics/async_log_listener.hpp"
 #include "azure/core/diagnostics/logger.hpp"
+#include "azure/core/diagnostics/metrics.hpp"
+#include "azure/core/diagnostics/tracing.hpp"
 
 // azure/core/http
 #include "azure/core/http/http.hpp"
 #include "azure/core/http/http_status_code.hpp"
 #include "azure/core/http/raw_response.hpp"
+#include "azure/core/http/traffic_class.hpp"
 #include "azure/core/http/transport.hpp"
 
 // azure/core/http/policies
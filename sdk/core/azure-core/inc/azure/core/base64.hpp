@@ -10,6 +10,8 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -49,6 +51,54 @@ namespace Azure { namespace Core {
 
   namespace _internal {
 
+    /**
+     * @brief Provides conversion methods for Base64 which write into buffers provided by the
+     * caller.
+     *
+     */
+    class Base64 final {
+      Base64() = delete;
+
+    public:
+      /**
+       * @brief Gets the length of the Base64 text of binary data, including its padding.
+       *
+       * @param length The length of the binary data.
+       * @return The number of characters written by #Encode().
+       */
+      static size_t EncodedLength(size_t length) { return (length + 2) / 3 * 4; }
+
+      /**
+       * @brief Encodes binary data into Base64.
+       *
+       * @param data The binary data to encode.
+       * @param length The length of \p data.
+       * @param destination Receives the #EncodedLength() characters of the Base64 text, it is not
+       * null-terminated.
+       */
+      static void Encode(const uint8_t* data, size_t length, char* destination);
+
+      /**
+       * @brief Gets the length of the binary data encoded as Base64 text.
+       *
+       * @param text The Base64 text.
+       * @param length The length of \p text.
+       * @return The number of bytes written by #Decode().
+       */
+      static size_t DecodedLength(const char* text, size_t length);
+
+      /**
+       * @brief Decodes Base64 text into binary data.
+       *
+       * @param text The Base64 text to decode.
+       * @param length The length of \p text.
+       * @param destination Receives the #DecodedLength() bytes of the binary data. It may be
+       * \p text, to decode the text in place.
+       * @return The number of bytes written to \p destination.
+       */
+      static size_t Decode(const char* text, size_t length, uint8_t* destination);
+    };
+
     /**
      * @brief Provides conversion methods for Base64URL.
      *
@@ -56,40 +106,59 @@ namespace Azure { namespace Core {
     class Base64Url final {
 
     public:
+      /**
+       * @brief Gets the length of the Base64URL text of binary data, which is not padded.
+       *
+       * @param length The length of the binary data.
+       * @return The number of characters written by #Base64UrlEncode().
+       */
+      static size_t EncodedLength(size_t length) { return (length * 4 + 2) / 3; }
+
+      /**
+       * @brief Encodes binary data into Base64URL.
+       *
+       * @param data The binary data to encode.
+       * @param length The length of \p data.
+       * @param destination Receives the #EncodedLength() characters of the Base64URL text, it is
+       * not null-terminated.
+       */
+      static void Base64UrlEncode(const uint8_t* data, size_t length, char* destination);
+
+      /**
+       * @brief Gets the length of the binary data encoded as Base64URL text.
+       *
+       * @param text The Base64URL text.
+       * @param length The length of \p text.
+       * @return The number of bytes written by #Base64UrlDecode().
+       *
+       * @throw std::invalid_argument when \p length is not a valid length of Base64URL text.
+       */
+      static size_t DecodedLength(const char* text, size_t length);
+
+      /**
+       * @brief Decodes Base64URL text into binary data.
+       *
+       * @param text The Base64URL text to decode.
+       * @param length The length of \p text.
+       * @param destination Receives the #DecodedLength() bytes of the binary data.
+       * @return The number of bytes written to \p destination.
+       *
+       * @throw std::invalid_argument when \p length is not a valid length of Base64URL text.
+       */
+      static size_t Base64UrlDecode(const char* text, size_t length, uint8_t* destination);
+
       static std::string Base64UrlEncode(const std::vector<uint8_t>& data)
       {
-        auto base64 = Azure::Core::Convert::Base64Encode(data);
-        // update to base64url
-        auto trail = base64.find('=');
-        if (trail != std::string::npos)
-        {
-          base64 = base64.substr(0, trail);
-        }
-        std::replace(base64.begin(), base64.end(), '+', '-');
-        std::replace(base64.begin(), base64.end(), '/', '_');
-        return base64;
+        std::string base64url(EncodedLength(data.size()), '\0');
+        Base64UrlEncode(data.data(), data.size(), &base64url[0]);
+        return base64url;
       }
 
       static std::vector<uint8_t> Base64UrlDecode(const std::string& text)
       {
-        std::string base64url(text);
-        // base64url to base64
-        std::replace(base64url.begin(), base64url.end(), '-', '+');
-        std::replace(base64url.begin(), base64url.end(), '_', '/');
-        switch (base64url.size() % 4)
-        {
-          case 0:
-            break;
-          case 2:
-            base64url.append("==");
-            break;
-          case 3:
-            base64url.append("=");
-            break;
-          default:
-            throw std::invalid_argument("Unexpected Base64URL encoding in the HTTP response.");
-        }
-        return Azure::Core::Convert::Base64Decode(base64url);
+        std::vector<uint8_t> data(DecodedLength(text.data(), text.size()));
+        Base64UrlDecode(text.data(), text.size(), data.data());
+        return data;
       }
     };
   } // namespace _internal
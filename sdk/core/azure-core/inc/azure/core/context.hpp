@@ -13,8 +13,11 @@
 #include "azure/core/internal/azure_assert.hpp"
 #include "azure/core/rtti.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -74,15 +77,24 @@ namespace Azure { namespace Core {
     };
 
   private:
-    struct ContextSharedState final
+    struct ContextSharedState
     {
       std::shared_ptr<ContextSharedState> Parent;
       std::atomic<DateTime::rep> Deadline;
       Context::Key Key;
-      std::shared_ptr<void> Value;
+      // Points to the value stored by the derived ContextValueState, in the same allocation.
+      void const* Value;
 #if defined(AZ_CORE_RTTI)
       const std::type_info& ValueType;
 #endif
+      // The earliest deadline of this context and its parents, so checking for cancellation
+      // doesn't walk the parents every time. It is valid while no context is cancelled after
+      // EarliestDeadlineEpoch, see Context::GetEarliestDeadline().
+      std::atomic<DateTime::rep> EarliestDeadline;
+      std::atomic<uint64_t> EarliestDeadlineEpoch;
+
+      // Never matches a cancellation epoch, so the earliest deadline gets computed on first use.
+      static constexpr uint64_t UnknownEpoch = (std::numeric_limits<uint64_t>::max)();
       static constexpr DateTime::rep ToDateTimeRepresentation(DateTime const& dateTime)
       {
         return dateTime.time_since_epoch().count();
@@ -93,12 +105,24 @@ namespace Azure { namespace Core {
         return DateTime(DateTime::time_point(DateTime::duration(dtRepresentation)));
       }
 
+      // Starts from the earliest deadline known by the parent. The epoch is read first, so a
+      // deadline at least as recent as that epoch is read after it.
+      void InheritEarliestDeadline()
+      {
+        auto const epoch = Parent->EarliestDeadlineEpoch.load(std::memory_order_acquire);
+        EarliestDeadline = (std::min)(
+            Parent->EarliestDeadline.load(std::memory_order_relaxed), Deadline.load());
+        EarliestDeadlineEpoch = epoch;
+      }
+
       explicit ContextSharedState()
           : Deadline(ToDateTimeRepresentation((DateTime::max)())), Value(nullptr)
 #if defined(AZ_CORE_RTTI)
             ,
             ValueType(typeid(std::nullptr_t))
 #endif
+            ,
+            EarliestDeadline(Deadline.load()), EarliestDeadlineEpoch(UnknownEpoch)
       {
       }
 
@@ -111,26 +135,56 @@ namespace Azure { namespace Core {
             ValueType(typeid(std::nullptr_t))
 #endif
       {
+        InheritEarliestDeadline();
       }
 
-      template <class T>
+#if defined(AZ_CORE_RTTI)
       explicit ContextSharedState(
           const std::shared_ptr<ContextSharedState>& parent,
           DateTime const& deadline,
           Context::Key const& key,
-          T value) // NOTE, should this be T&&
+          const std::type_info& valueType)
           : Parent(parent), Deadline(ToDateTimeRepresentation(deadline)), Key(key),
-            Value(std::make_shared<T>(std::move(value)))
+            Value(nullptr), ValueType(valueType)
+#else
+      explicit ContextSharedState(
+          const std::shared_ptr<ContextSharedState>& parent,
+          DateTime const& deadline,
+          Context::Key const& key)
+          : Parent(parent), Deadline(ToDateTimeRepresentation(deadline)), Key(key),
+            Value(nullptr)
+#endif
+      {
+        InheritEarliestDeadline();
+      }
+    };
+
+    // The value is stored in the same allocation as the context, instead of a separate one.
+    template <class T> struct ContextValueState final : public ContextSharedState
+    {
+      T StoredValue;
+
+      template <class U>
+      explicit ContextValueState(
+          const std::shared_ptr<ContextSharedState>& parent,
+          DateTime const& deadline,
+          Context::Key const& key,
+          U&& value)
 #if defined(AZ_CORE_RTTI)
-            ,
-            ValueType(typeid(T))
+          : ContextSharedState(parent, deadline, key, typeid(T)),
+#else
+          : ContextSharedState(parent, deadline, key),
 #endif
+            StoredValue(std::forward<U>(value))
       {
+        Value = &StoredValue;
       }
     };
 
     std::shared_ptr<ContextSharedState> m_contextSharedState;
 
+    DateTime::rep GetEarliestDeadline() const noexcept;
+
     explicit Context(std::shared_ptr<ContextSharedState> impl)
         : m_contextSharedState(std::move(impl))
     {
@@ -175,7 +229,7 @@ namespace Azure { namespace Core {
      */
     template <class T> Context WithValue(Key const& key, T&& value) const
     {
-      return Context{std::make_shared<ContextSharedState>(
+      return Context{std::make_shared<ContextValueState<typename std::decay<T>::type>>(
           m_contextSharedState, (DateTime::max)(), key, std::forward<T>(value))};
     }
 
@@ -205,7 +259,8 @@ namespace Azure { namespace Core {
      */
     template <class T> bool TryGetValue(Key const& key, T& outputValue) const
     {
-      for (auto ptr = m_contextSharedState; ptr; ptr = ptr->Parent)
+      // Raw pointers are enough to walk the parents, this context keeps them alive.
+      for (auto ptr = m_contextSharedState.get(); ptr; ptr = ptr->Parent.get())
       {
         if (ptr->Key == key)
         {
@@ -214,7 +269,7 @@ namespace Azure { namespace Core {
               typeid(T) == ptr->ValueType, "Type mismatch for Context::TryGetValue().");
 #endif
 
-          outputValue = *reinterpret_cast<const T*>(ptr->Value.get());
+          outputValue = *static_cast<const T*>(ptr->Value);
           return true;
         }
       }
@@ -225,17 +280,13 @@ namespace Azure { namespace Core {
      * @brief Cancels the context.
      *
      */
-    void Cancel()
-    {
-      m_contextSharedState->Deadline
-          = ContextSharedState::ToDateTimeRepresentation((DateTime::min)());
-    }
+    void Cancel();
 
     /**
      * @brief Checks if the context is cancelled.
      * @return `true` if this context is cancelled; otherwise, `false`.
      */
-    bool IsCancelled() const noexcept { return GetDeadline() < std::chrono::system_clock::now(); }
+    bool IsCancelled() const noexcept;
 
     /**
      * @brief Checks if the context is cancelled.
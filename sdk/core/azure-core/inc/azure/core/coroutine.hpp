@@ -0,0 +1,327 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Awaits the operations of the clients from C++20 coroutines.
+ *
+ * @remark The header is empty unless it is compiled as C++20 with coroutines, so the SDK itself
+ * keeps building as C++14.
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include "azure/core/context.hpp"
+#include "azure/core/http/http.hpp"
+#include "azure/core/http/raw_response.hpp"
+#include "azure/core/http/transport.hpp"
+#include "azure/core/internal/http/pipeline.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Azure { namespace Core {
+
+  /**
+   * @brief Runs the work of an awaitable, by calling the function it is given on one of its
+   * threads.
+   *
+   */
+  using CoroutineExecutor = std::function<void(std::function<void()>)>;
+
+  namespace Http {
+    /**
+     * @brief An HTTP request sent asynchronously, awaited by a C++20 coroutine.
+     *
+     * @details The request is sent by a function taking the
+     * #Azure::Core::Http::ResponseCallback, like #Azure::Core::Http::HttpTransport::SendAsync().
+     * The coroutine is suspended until the callback is called, then resumed with the response, or
+     * with the exception the request failed with. No thread waits for the response when the
+     * transport completes its requests from its own threads, like
+     * #Azure::Core::Http::CurlMultiTransport, so a single thread drives any number of awaited
+     * requests.
+     *
+     * @remark Without an executor, the coroutine is resumed on the thread calling the callback,
+     * which is the thread of the transport: it must not block then. With an executor, the
+     * coroutine is resumed on one of its threads. When the request completes before the sender
+     * returns, the coroutine isn't suspended. The request must stay alive until the coroutine is
+     * resumed.
+     */
+    class ResponseAwaitable final {
+    private:
+      enum State
+      {
+        Sending,
+        Completed,
+        Suspended,
+      };
+
+      std::function<void(ResponseCallback)> m_send;
+      CoroutineExecutor m_executor;
+      std::atomic<int> m_state{Sending};
+      std::unique_ptr<RawResponse> m_response;
+      std::exception_ptr m_exception;
+
+    public:
+      /**
+       * @brief Constructs a `%ResponseAwaitable`.
+       *
+       * @param send The function sending the request, called with the callback receiving the
+       * response once the awaitable is awaited.
+       * @param executor The executor resuming the coroutine. An empty executor resumes it on the
+       * thread completing the request.
+       */
+      explicit ResponseAwaitable(
+          std::function<void(ResponseCallback)> send,
+          CoroutineExecutor executor = CoroutineExecutor())
+          : m_send(std::move(send)), m_executor(std::move(executor))
+      {
+      }
+
+      ResponseAwaitable(ResponseAwaitable const&) = delete;
+      ResponseAwaitable& operator=(ResponseAwaitable const&) = delete;
+
+      /**
+       * @brief The request is never sent before it is awaited.
+       *
+       */
+      bool await_ready() const noexcept { return false; }
+
+      /**
+       * @brief Sends the request, the completion of which resumes \p coroutine.
+       *
+       * @param coroutine The awaiting coroutine.
+       * @return False when the request completed while it was sent, the coroutine then goes on
+       * right away.
+       */
+      bool await_suspend(std::coroutine_handle<> coroutine)
+      {
+        // The executor is copied, the awaitable being destroyed once the coroutine is resumed.
+        m_send([this, coroutine, executor = m_executor](
+                   std::unique_ptr<RawResponse> response, std::exception_ptr exception) {
+          m_response = std::move(response);
+          m_exception = exception;
+          // Only resumes the coroutine once await_suspend() has returned.
+          if (m_state.exchange(Completed) != Suspended)
+          {
+            return;
+          }
+          if (executor)
+          {
+            executor([coroutine]() { coroutine.resume(); });
+          }
+          else
+          {
+            coroutine.resume();
+          }
+        });
+        return m_state.exchange(Suspended) != Completed;
+      }
+
+      /**
+       * @brief Returns the response to the resumed coroutine.
+       *
+       * @throw The exception the request failed with.
+       */
+      std::unique_ptr<RawResponse> await_resume()
+      {
+        if (m_exception)
+        {
+          std::rethrow_exception(m_exception);
+        }
+        return std::move(m_response);
+      }
+    };
+
+    /**
+     * @brief Sends a request with a transport, awaited by a C++20 coroutine.
+     *
+     * @param transport The transport sending the request.
+     * @param request The request, which must stay alive until the coroutine is resumed.
+     * @param context A context to control the request lifetime.
+     * @param executor The executor resuming the coroutine. An empty executor resumes it on the
+     * thread completing the request.
+     *
+     * @return The awaitable response.
+     */
+    inline ResponseAwaitable SendAwaitable(
+        HttpTransport& transport,
+        Request& request,
+        Context const& context,
+        CoroutineExecutor executor = CoroutineExecutor())
+    {
+      return ResponseAwaitable(
+          [&transport, &request, context](ResponseCallback callback) {
+            transport.SendAsync(request, context, std::move(callback));
+          },
+          std::move(executor));
+    }
+
+    namespace _internal {
+      /**
+       * @brief Sends a request through a pipeline, awaited by a C++20 coroutine.
+       *
+       * @param pipeline The pipeline sending the request, which must stay alive until the
+       * coroutine is resumed.
+       * @param request The request, which must stay alive until the coroutine is resumed.
+       * @param context A context to control the request lifetime.
+       * @param executor The executor resuming the coroutine. An empty executor resumes it on the
+       * thread completing the request.
+       *
+       * @return The awaitable response.
+       */
+      inline ResponseAwaitable SendAwaitable(
+          HttpPipeline const& pipeline,
+          Request& request,
+          Context const& context,
+          CoroutineExecutor executor = CoroutineExecutor())
+      {
+        return ResponseAwaitable(
+            [&pipeline, &request, context](ResponseCallback callback) {
+              pipeline.SendAsync(request, context, std::move(callback));
+            },
+            std::move(executor));
+      }
+    } // namespace _internal
+  } // namespace Http
+
+  /**
+   * @brief A synchronous operation of a client awaited by a C++20 coroutine.
+   *
+   * @details The operation runs on a thread of the executor, which it blocks until it returns.
+   * The coroutine is suspended meanwhile, and resumed on that thread with the value returned by
+   * the operation, or the exception it threw. The number of operations in flight is bounded by
+   * the number of threads of the executor. The requests sent with
+   * #Azure::Core::Http::ResponseAwaitable don't block any thread instead.
+   *
+   * @remark Awaiting the operation doesn't cancel it when the coroutine is destroyed. Pass a
+   * #Azure::Core::Context to the operation to cancel it.
+   *
+   * @tparam Function The type of the function calling the operation.
+   */
+  template <class Function> class Awaitable final {
+  public:
+    /**
+     * @brief The type of the value returned by the operation.
+     *
+     */
+    using ValueType = std::invoke_result_t<Function&>;
+
+    /**
+     * @brief Constructs an `%Awaitable`.
+     *
+     * @param function The function calling the operation, called once the awaitable is awaited.
+     * @param executor The executor running \p function.
+     *
+     * @throw std::invalid_argument when \p executor is empty.
+     */
+    explicit Awaitable(Function function, CoroutineExecutor executor)
+        : m_function(std::move(function)), m_executor(std::move(executor))
+    {
+      if (!m_executor)
+      {
+        throw std::invalid_argument("An awaited operation requires an executor.");
+      }
+    }
+
+    Awaitable(Awaitable&&) = default;
+    Awaitable(Awaitable const&) = delete;
+    Awaitable& operator=(Awaitable const&) = delete;
+
+    /**
+     * @brief The operation is never done before it is awaited.
+     *
+     */
+    bool await_ready() const noexcept { return false; }
+
+    /**
+     * @brief Runs the operation on the executor, which resumes \p coroutine once it is done.
+     *
+     * @param coroutine The awaiting coroutine.
+     */
+    void await_suspend(std::coroutine_handle<> coroutine)
+    {
+      // The awaitable lives in the frame of the suspended coroutine until it is resumed, so the
+      // work can store the result in it.
+      std::function<void()> work = [this, coroutine]() {
+        try
+        {
+          if constexpr (std::is_void_v<ValueType>)
+          {
+            m_function();
+          }
+          else
+          {
+            m_value.emplace(m_function());
+          }
+        }
+        catch (...)
+        {
+          m_exception = std::current_exception();
+        }
+        coroutine.resume();
+      };
+      // The coroutine can be resumed, and the awaitable destroyed, before the executor returns, so
+      // the executor isn't called from the awaitable.
+      auto executor = std::move(m_executor);
+      executor(std::move(work));
+    }
+
+    /**
+     * @brief Returns the value returned by the operation to the resumed coroutine.
+     *
+     * @throw The exception thrown by the operation.
+     */
+    ValueType await_resume()
+    {
+      if (m_exception)
+      {
+        std::rethrow_exception(m_exception);
+      }
+      if constexpr (!std::is_void_v<ValueType>)
+      {
+        return std::move(*m_value);
+      }
+    }
+
+  private:
+    Function m_function;
+    CoroutineExecutor m_executor;
+    std::optional<std::conditional_t<std::is_void_v<ValueType>, bool, ValueType>> m_value;
+    std::exception_ptr m_exception;
+  };
+
+  /**
+   * @brief Makes a synchronous operation of a client awaitable by a C++20 coroutine.
+   *
+   * @details For example, `co_await Azure::Core::MakeAwaitable([&] { return
+   * blobClient.DownloadTo(buffer, size, {}, context); }, executor)` resumes the coroutine with the
+   * response of the download once it is done, on the thread of `executor` which ran it.
+   *
+   * @param function The function calling the operation, called once the awaitable is awaited.
+   * The objects it captures by reference must stay alive until the coroutine is resumed.
+   * @param executor The executor running \p function.
+   *
+   * @return The awaitable operation.
+   *
+   * @throw std::invalid_argument when \p executor is empty.
+   */
+  template <class Function>
+  Awaitable<std::decay_t<Function>> MakeAwaitable(Function&& function, CoroutineExecutor executor)
+  {
+    return Awaitable<std::decay_t<Function>>(
+        std::forward<Function>(function), std::move(executor));
+  }
+
+}} // namespace Azure::Core
+
+#endif
@@ -48,6 +48,13 @@ namespace Azure { namespace Core { namespace Credentials {
      *
      */
     std::vector<std::string> Scopes;
+
+    /**
+     * @brief The tenant to get the token from, or empty for the tenant of the credential.
+     *
+     * @note Only the credentials authenticating with a tenant support it.
+     */
+    std::string TenantId = {};
   };
 
   /**
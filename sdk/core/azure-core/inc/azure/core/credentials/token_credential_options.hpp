@@ -10,6 +10,8 @@
 
 #include "azure/core/internal/client_options.hpp"
 
+#include <string>
+
 namespace Azure { namespace Core { namespace Credentials {
   /**
    * @brief Client options for #Azure::Core::Credentials::TokenCredential.
@@ -17,5 +19,24 @@ namespace Azure { namespace Core { namespace Credentials {
    */
   struct TokenCredentialOptions : public Azure::Core::_internal::ClientOptions
   {
+    /**
+     * @brief The fraction of the lifetime of a cached token after which the credential gets a new
+     * one in the background, while still returning the cached token.
+     *
+     * @remark A value of `1` or more disables the background refresh, the credential then gets a
+     * new token when the cached one is about to expire.
+     *
+     */
+    double TokenRefreshLifetimeFraction = 0.5;
+
+    /**
+     * @brief The path of a file where the credential keeps its tokens, so that the next processes
+     * using the same identity don't have to get new ones.
+     *
+     * @remark The file can be shared by several credentials and processes of the same user. The
+     * default is empty, which keeps the tokens in memory only.
+     *
+     */
+    std::string PersistentTokenCachePath;
   };
 }}} // namespace Azure::Core::Credentials
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Log listener which hands the log messages over to a background thread.
+ */
+
+#pragma once
+
+#include "azure/core/diagnostics/logger.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace Azure { namespace Core { namespace Diagnostics {
+
+  /**
+   * @brief What #AsyncLogListener does with a message when its queue is full.
+   *
+   */
+  enum class AsyncLogOverflowPolicy
+  {
+    /**
+     * @brief The message is dropped, so the thread writing it never waits.
+     *
+     */
+    Drop,
+
+    /**
+     * @brief The thread writing the message waits until there is room for it in the queue.
+     *
+     */
+    Block,
+  };
+
+  /**
+   * @brief Options for #AsyncLogListener.
+   *
+   */
+  struct AsyncLogListenerOptions final
+  {
+    /**
+     * @brief The maximum number of messages waiting to be passed to the listener.
+     *
+     * @remark It is rounded up to a power of two. The default value is 8192 messages.
+     */
+    size_t QueueCapacity = 8192;
+
+    /**
+     * @brief What is done with the messages written when the queue is full.
+     *
+     */
+    AsyncLogOverflowPolicy OverflowPolicy = AsyncLogOverflowPolicy::Drop;
+
+    /**
+     * @brief The maximum number of messages queued per second, the messages over it are dropped.
+     *
+     * @remark The default value `0` doesn't limit the rate of the messages.
+     */
+    size_t MaxMessagesPerSecond = 0;
+
+    /**
+     * @brief The maximum time a message waits in the queue before the background thread passes it
+     * to the listener, when the queue doesn't fill up in the meantime.
+     *
+     * @remark The default value is 100 milliseconds.
+     */
+    std::chrono::milliseconds FlushInterval = std::chrono::milliseconds(100);
+  };
+
+  /**
+   * @brief Log listener which queues the log messages and passes them in batches to another
+   * listener from a background thread.
+   *
+   * @details Writing a message only copies it to a lock-free queue, so a slow listener, writing
+   * to a file for example, doesn't slow down the threads sending the requests.
+   *
+   * @code
+   * AsyncLogListener asyncListener([](Logger::Level level, std::string const& message) {
+   *   logFile << message << std::endl;
+   * });
+   * Logger::SetListener(asyncListener.GetListener());
+   * @endcode
+   *
+   * @remark The listener passed to the constructor is only called from the background thread.
+   * The exceptions it throws are ignored.
+   */
+  class AsyncLogListener final {
+  private:
+    struct State;
+
+    std::shared_ptr<State> m_state;
+    std::thread m_thread;
+
+  public:
+    /**
+     * @brief Constructs an #AsyncLogListener, and starts its background thread.
+     *
+     * @param listener The listener the messages are passed to from the background thread.
+     * @param options The options of the queue of the messages.
+     */
+    explicit AsyncLogListener(
+        std::function<void(Logger::Level level, std::string const& message)> listener,
+        AsyncLogListenerOptions const& options = AsyncLogListenerOptions());
+
+    AsyncLogListener(AsyncLogListener const&) = delete;
+    AsyncLogListener& operator=(AsyncLogListener const&) = delete;
+
+    /**
+     * @brief Passes the queued messages to the listener, and stops the background thread.
+     *
+     * @remark The messages written with #GetListener() afterwards are dropped.
+     */
+    ~AsyncLogListener();
+
+    /**
+     * @brief Gets the function queueing the messages, to be passed to #Logger::SetListener().
+     *
+     */
+    std::function<void(Logger::Level level, std::string const& message)> GetListener() const;
+
+    /**
+     * @brief Waits until the messages queued before the call are passed to the listener.
+     *
+     */
+    void Flush();
+
+    /**
+     * @brief Gets the number of messages dropped because the queue was full or because of the
+     * rate limit.
+     *
+     */
+    int64_t GetDroppedMessageCount() const;
+  };
+
+}}} // namespace Azure::Core::Diagnostics
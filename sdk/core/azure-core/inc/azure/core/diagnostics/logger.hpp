@@ -42,6 +42,10 @@ namespace Azure { namespace Core { namespace Diagnostics {
      *
      * @param listener A callback function that will be invoked when the SDK reports a log message.
      * If `nullptr`, no function will be invoked.
+     *
+     * @remark The messages being reported by other threads while the listener is replaced may still
+     * be passed to the previous listener, but this function only returns once they were, so the
+     * previous listener is never called afterwards. It must not be called from a listener.
      */
     static void SetListener(std::function<void(Level level, std::string const& message)> listener);
 
@@ -0,0 +1,346 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Metrics of the requests sent by the SDK clients.
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/http/http.hpp"
+#include "azure/core/nullable.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Core { namespace Diagnostics {
+
+  /**
+   * @brief Metrics of a request sent by a client, passed to the listener of
+   * #Azure::Core::Http::Policies::MetricsOptions.
+   *
+   * @remark The metrics of the connection and of the transfer are the ones of the last try of the
+   * request.
+   */
+  struct RequestMetrics final
+  {
+    /**
+     * @brief The name of the client which sent the request, e.g. "storage-blob".
+     *
+     */
+    std::string ClientName;
+
+    /**
+     * @brief The name of the client operation which sent the request, or the HTTP method of the
+     * request when the client doesn't name its operations.
+     *
+     */
+    std::string OperationName;
+
+    /**
+     * @brief The status code of the response, null when the request failed without a response.
+     *
+     */
+    Azure::Nullable<Azure::Core::Http::HttpStatusCode> StatusCode;
+
+    /**
+     * @brief The number of times the request was tried again.
+     *
+     */
+    int32_t RetryCount = 0;
+
+    /**
+     * @brief The time from the request being sent until its response headers are received,
+     * including the retries.
+     *
+     */
+    std::chrono::microseconds Duration{0};
+
+    /**
+     * @brief The time from the last try being sent until its response headers are received.
+     *
+     */
+    Azure::Nullable<std::chrono::microseconds> TimeToFirstByte;
+
+    /**
+     * @brief Whether the last try was sent on a connection opened for a previous request, null
+     * when the transport doesn't tell.
+     *
+     */
+    Azure::Nullable<bool> IsConnectionReused;
+
+    /**
+     * @brief The time taken to resolve the host name of a new connection.
+     *
+     */
+    Azure::Nullable<std::chrono::microseconds> NameLookup;
+
+    /**
+     * @brief The time taken to connect a new connection, once the host name is resolved.
+     *
+     */
+    Azure::Nullable<std::chrono::microseconds> Connect;
+
+    /**
+     * @brief The time taken by the TLS handshake of a new connection, once it is connected.
+     *
+     */
+    Azure::Nullable<std::chrono::microseconds> TlsHandshake;
+
+    /**
+     * @brief The size of the body of the last try of the request, when it has a known length.
+     *
+     */
+    int64_t BytesSent = 0;
+
+    /**
+     * @brief The size of the body of the response, when it is buffered or has a known length.
+     *
+     */
+    int64_t BytesReceived = 0;
+  };
+
+  /**
+   * @brief Histogram of durations which can be recorded concurrently without locking.
+   *
+   * @details The durations are counted in buckets of microseconds, in the way of HDR histograms:
+   * each power of two is split in 16 buckets of the same width, so any percentile is within 6.25%
+   * of the exact value, and a histogram takes a fixed 8 KB no matter how many durations are
+   * recorded.
+   *
+   */
+  class LatencyHistogram final {
+  public:
+    /**
+     * @brief The number of bits of a duration telling its bucket within its power of two.
+     *
+     */
+    static constexpr int SubBucketBits = 4;
+
+    /**
+     * @brief The number of buckets of a power of two.
+     *
+     */
+    static constexpr size_t SubBucketCount = size_t(1) << SubBucketBits;
+
+    /**
+     * @brief The number of buckets of the histogram.
+     *
+     */
+    static constexpr size_t BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+    /**
+     * @brief Constructs an empty histogram.
+     *
+     */
+    LatencyHistogram() noexcept;
+
+    LatencyHistogram(LatencyHistogram const&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+    /**
+     * @brief Records a duration.
+     *
+     * @param duration The duration, a negative duration is recorded as `0`.
+     */
+    void Record(std::chrono::microseconds duration) noexcept;
+
+    /**
+     * @brief Gets the number of durations recorded.
+     *
+     */
+    int64_t GetCount() const noexcept { return m_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the longest duration recorded.
+     *
+     */
+    std::chrono::microseconds GetMax() const noexcept
+    {
+      return std::chrono::microseconds(m_max.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Gets the sum of the durations recorded.
+     *
+     */
+    std::chrono::microseconds GetSum() const noexcept
+    {
+      return std::chrono::microseconds(m_sum.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Gets the duration which \p percentile percent of the recorded durations don't exceed.
+     *
+     * @param percentile The percentile, between `0` and `100`.
+     *
+     * @return The upper bound of the bucket of the percentile, or `0` when nothing was recorded.
+     */
+    std::chrono::microseconds GetPercentile(double percentile) const noexcept;
+
+    /**
+     * @brief Adds the durations recorded by another histogram to this one.
+     *
+     * @remark Lets each thread record into a histogram of its own, merged once it is done.
+     *
+     * @param other The histogram whose durations are added.
+     */
+    void Merge(LatencyHistogram const& other) noexcept;
+
+  private:
+    std::atomic<int64_t> m_buckets[BucketCount];
+    std::atomic<int64_t> m_count{0};
+    std::atomic<int64_t> m_max{0};
+    std::atomic<int64_t> m_sum{0};
+  };
+
+  /**
+   * @brief The metrics aggregated by #MetricsAggregator for the requests of a client operation.
+   *
+   */
+  struct OperationMetrics final
+  {
+    /**
+     * @brief The durations of the requests, see #RequestMetrics::Duration.
+     *
+     */
+    LatencyHistogram Duration;
+
+    /**
+     * @brief The times to first byte of the last try of the requests.
+     *
+     */
+    LatencyHistogram TimeToFirstByte;
+
+    /**
+     * @brief The number of requests.
+     *
+     */
+    std::atomic<int64_t> RequestCount{0};
+
+    /**
+     * @brief The number of requests failed without a response, or answered with a status code
+     * of `400` or above.
+     *
+     */
+    std::atomic<int64_t> FailedRequestCount{0};
+
+    /**
+     * @brief The number of retries of the requests.
+     *
+     */
+    std::atomic<int64_t> RetryCount{0};
+
+    /**
+     * @brief The number of requests whose last try opened a new connection.
+     *
+     */
+    std::atomic<int64_t> NewConnectionCount{0};
+
+    /**
+     * @brief The number of requests whose last try reused a connection from the pool.
+     *
+     */
+    std::atomic<int64_t> ReusedConnectionCount{0};
+
+    /**
+     * @brief The sum of #RequestMetrics::BytesSent.
+     *
+     */
+    std::atomic<int64_t> BytesSent{0};
+
+    /**
+     * @brief The sum of #RequestMetrics::BytesReceived.
+     *
+     */
+    std::atomic<int64_t> BytesReceived{0};
+  };
+
+  /**
+   * @brief Aggregates the metrics of the requests by client and operation.
+   *
+   * @code
+   * MetricsAggregator aggregator;
+   * BlobClientOptions options;
+   * options.Metrics.Listener = aggregator.GetListener();
+   * // ...
+   * aggregator.Export([](std::string const& clientName, std::string const& operationName,
+   *                      OperationMetrics const& metrics) {
+   *   std::cout << clientName << " " << operationName << " p99 "
+   *             << metrics.Duration.GetPercentile(99).count() << "us" << std::endl;
+   * });
+   * @endcode
+   *
+   */
+  class MetricsAggregator final {
+  private:
+    struct State;
+
+    std::shared_ptr<State> m_state;
+
+  public:
+    /**
+     * @brief Constructs an aggregator without metrics.
+     *
+     */
+    MetricsAggregator();
+
+    /**
+     * @brief Adds the metrics of a request to the ones of its client operation.
+     *
+     * @param metrics The metrics of the request.
+     */
+    void Record(RequestMetrics const& metrics);
+
+    /**
+     * @brief Gets the function recording the metrics with this aggregator, to be set as
+     * #Azure::Core::Http::Policies::MetricsOptions::Listener.
+     *
+     * @remark The function keeps the metrics alive after the aggregator is destroyed.
+     */
+    std::function<void(RequestMetrics const& metrics)> GetListener() const;
+
+    /**
+     * @brief Passes the metrics of each client operation to \p exporter.
+     *
+     * @remark The metrics may be recorded concurrently while they are exported.
+     *
+     * @param exporter The function called for each client operation.
+     */
+    void Export(std::function<void(
+                    std::string const& clientName,
+                    std::string const& operationName,
+                    OperationMetrics const& metrics)> const& exporter) const;
+  };
+
+  namespace _internal {
+    /**
+     * @brief Names the client operations in #Azure::Core::Diagnostics::RequestMetrics.
+     *
+     */
+    class OperationName final {
+    public:
+      /**
+       * @brief Creates a context naming the operation of the requests sent with it.
+       *
+       * @param context The context the requests of the operation would be sent with.
+       * @param operationName The name of the operation, a string literal.
+       */
+      static Context With(Context const& context, char const* operationName);
+
+      /**
+       * @brief Gets the name of the operation set with \p context, or `nullptr`.
+       *
+       */
+      static char const* Get(Context const& context);
+    };
+  } // namespace _internal
+
+}}} // namespace Azure::Core::Diagnostics
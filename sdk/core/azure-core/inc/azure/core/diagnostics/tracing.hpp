@@ -0,0 +1,224 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Distributed tracing of the operations of the SDK clients.
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/http/http_status_code.hpp"
+#include "azure/core/nullable.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Azure { namespace Core { namespace Diagnostics {
+
+  /**
+   * @brief The role of a span.
+   *
+   */
+  enum class SpanKind
+  {
+    /**
+     * @brief A span for work within the process, such as a client operation.
+     *
+     */
+    Internal,
+
+    /**
+     * @brief A span for a request sent to a service.
+     *
+     */
+    Client,
+  };
+
+  /**
+   * @brief Whether the work of a span succeeded.
+   *
+   */
+  enum class SpanStatus
+  {
+    /**
+     * @brief The work succeeded.
+     *
+     */
+    Ok,
+
+    /**
+     * @brief The work failed with an exception, or with a response status code of `400` or above.
+     *
+     */
+    Error,
+  };
+
+  /**
+   * @brief The identifiers of a span propagated to its children, within the process and to the
+   * services in the W3C `traceparent` header.
+   *
+   * @remark See https://www.w3.org/TR/trace-context/.
+   */
+  struct SpanContext final
+  {
+    /**
+     * @brief The identifier of the trace the span belongs to.
+     *
+     */
+    std::array<uint8_t, 16> TraceId{};
+
+    /**
+     * @brief The identifier of the span.
+     *
+     */
+    std::array<uint8_t, 8> SpanId{};
+
+    /**
+     * @brief Whether the spans of the trace are exported.
+     *
+     */
+    bool IsSampled = false;
+
+    /**
+     * @brief Checks that neither the trace identifier nor the span identifier is all zeros.
+     *
+     */
+    bool IsValid() const;
+
+    /**
+     * @brief Formats the span context as the value of a `traceparent` header, e.g.
+     * "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01".
+     *
+     */
+    std::string ToTraceParent() const;
+
+    /**
+     * @brief Parses the value of a `traceparent` header.
+     *
+     * @param traceParent The value of the header.
+     *
+     * @return The span context, or null when \p traceParent isn't a valid `traceparent`.
+     */
+    static Azure::Nullable<SpanContext> FromTraceParent(std::string const& traceParent);
+  };
+
+  /**
+   * @brief A span which ended, passed to the exporter set with #Tracer::SetExporter().
+   *
+   */
+  struct SpanData final
+  {
+    /**
+     * @brief The name of the span, e.g. "BlobClient.Download" or "HTTP GET".
+     *
+     * @remark It is a string literal, which stays valid after the span is exported.
+     */
+    char const* Name = "";
+
+    /**
+     * @brief The role of the span.
+     *
+     */
+    SpanKind Kind = SpanKind::Internal;
+
+    /**
+     * @brief The identifiers of the span.
+     *
+     */
+    SpanContext Context;
+
+    /**
+     * @brief The identifier of the parent span, all zeros for a root span.
+     *
+     */
+    std::array<uint8_t, 8> ParentSpanId{};
+
+    /**
+     * @brief When the span started.
+     *
+     */
+    std::chrono::system_clock::time_point StartTime;
+
+    /**
+     * @brief How long the span lasted.
+     *
+     */
+    std::chrono::microseconds Duration{0};
+
+    /**
+     * @brief Whether the work of the span succeeded.
+     *
+     */
+    SpanStatus Status = SpanStatus::Ok;
+
+    /**
+     * @brief The status code of the response, for the spans of HTTP requests answered.
+     *
+     */
+    Azure::Nullable<Azure::Core::Http::HttpStatusCode> StatusCode;
+
+    /**
+     * @brief The number of times the HTTP request was tried before, for the spans of HTTP
+     * requests.
+     *
+     */
+    int32_t RetryCount = 0;
+  };
+
+  /**
+   * @brief Traces the operations of the SDK clients, and the HTTP requests they send.
+   *
+   * @details Each operation of a client is a span, with a span for each HTTP request it sends,
+   * and a span for each try of the request. The span of a try is propagated to the service in the
+   * `traceparent` header.
+   *
+   * @remark No span is created while no exporter is set, so tracing costs nothing until enabled.
+   */
+  class Tracer final {
+  public:
+    /**
+     * @brief Sets the function called with each span which ended.
+     *
+     * @param exporter The function called from the thread ending the span. It must be thread
+     * safe, the exceptions it throws are ignored. `nullptr` disables tracing.
+     */
+    static void SetExporter(std::function<void(SpanData const& span)> exporter);
+
+    /**
+     * @brief Sets the ratio of the traces which are exported.
+     *
+     * @remark The decision is taken when the root span of a trace starts, and propagated to the
+     * other spans of the trace through the `traceparent` header. The default ratio is `1`.
+     *
+     * @param ratio The ratio of the traces exported, between `0` and `1`.
+     */
+    static void SetSamplingRatio(double ratio);
+
+    /**
+     * @brief Creates a context whose spans are children of \p parent, e.g. of the span of an
+     * incoming request whose `traceparent` header was parsed with
+     * #SpanContext::FromTraceParent().
+     *
+     * @param context The context to create the child of.
+     * @param parent The parent span of the spans started with the context returned.
+     */
+    static Context WithParent(Context const& context, SpanContext const& parent);
+
+    /**
+     * @brief Gets the span the spans started with \p context would be children of.
+     *
+     * @return The span context, or null when \p context has no span.
+     */
+    static Azure::Nullable<SpanContext> GetSpanContext(Context const& context);
+
+  private:
+    Tracer() = delete;
+    ~Tracer() = delete;
+  };
+
+}}} // namespace Azure::Core::Diagnostics
@@ -12,6 +12,12 @@
 #include "azure/core/http/http.hpp"
 #include "azure/core/http/transport.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace Azure { namespace Core { namespace Http {
 
   namespace _detail {
@@ -21,8 +27,99 @@ namespace Azure { namespace Core { namespace Http {
      *
      */
     constexpr std::chrono::milliseconds DefaultConnectionTimeout = std::chrono::minutes(5);
+
+    /**
+     * @brief Default size in bytes of the buffer used to read the status line, headers and small
+     * body reads from the socket.
+     *
+     */
+    constexpr size_t DefaultLibcurlReaderSize = 1024;
+
+    /**
+     * @brief Maximum size in bytes the read buffer can grow to when
+     * #Azure::Core::Http::CurlTransportOptions::AdaptiveReadBuffer is enabled.
+     *
+     */
+    constexpr size_t DefaultMaxAdaptiveReaderSize = 1024 * 256;
+
+    /**
+     * @brief Default maximum number of connections kept in the connection pool for one host.
+     *
+     */
+    constexpr size_t DefaultMaxConnectionsPerHost = 1024;
+
+    /**
+     * @brief Default time a connection can wait in the connection pool before it is closed.
+     *
+     */
+    constexpr std::chrono::milliseconds DefaultConnectionIdleTimeout = std::chrono::seconds(60);
+
+    /**
+     * @brief Default minimum time between two inspections of the connection pool looking for
+     * expired connections.
+     *
+     */
+    constexpr std::chrono::milliseconds DefaultConnectionPoolCleanerInterval
+        = std::chrono::seconds(90);
+
+    /**
+     * @brief Default time spent reading a response body over which its throughput is measured.
+     *
+     */
+    constexpr std::chrono::milliseconds DefaultReadThroughputWindow = std::chrono::seconds(30);
+
+    /**
+     * @brief Default time the addresses a host name resolves to are kept in the DNS cache.
+     *
+     */
+    constexpr std::chrono::seconds DefaultDnsCacheTimeout = std::chrono::seconds(60);
+
+    /**
+     * @brief Default time a connection is idle before TCP keepalive probes are sent, and default
+     * time between two probes.
+     *
+     */
+    constexpr std::chrono::seconds DefaultTcpKeepAliveTime = std::chrono::seconds(60);
+
+    /**
+     * @brief Default size in bytes of a request body from which the server is asked to accept the
+     * request before the body is sent.
+     *
+     */
+    constexpr int64_t DefaultExpectContinueThreshold = 1024 * 1024;
+
+    /**
+     * @brief Default time waited for the server to accept a request before its body is sent
+     * anyway.
+     *
+     */
+    constexpr std::chrono::milliseconds DefaultExpectContinueTimeout = std::chrono::seconds(1);
   } // namespace _detail
 
+  /**
+   * @brief The order in which the connections in the connection pool are re-used and evicted.
+   *
+   */
+  enum class CurlConnectionPoolEvictionPolicy
+  {
+    /**
+     * @brief The connection which was used most recently is re-used first.
+     *
+     * @remark Connections that are not needed to keep up with the requests stay in the pool
+     * without being used, so they are the first ones to expire or to be evicted when the pool is
+     * full. The pool shrinks to the number of connections that are actually used concurrently.
+     */
+    LeastRecentlyUsed,
+
+    /**
+     * @brief Connections are re-used in the order they were moved back to the pool.
+     *
+     * @remark Requests are spread over all the connections in the pool, which keeps them all
+     * alive. The connection waiting for the longest time is evicted when the pool is full.
+     */
+    FirstInFirstOut,
+  };
+
   /**
    * @brief The available options to set libcurl SSL options.
    *
@@ -117,14 +214,322 @@ namespace Azure { namespace Core { namespace Http {
      *
      */
     std::chrono::milliseconds ConnectionTimeout = _detail::DefaultConnectionTimeout;
+
+    /**
+     * @brief The size in bytes of the buffer used to read the response from the socket.
+     *
+     * @details The status line and headers are parsed from this buffer, and body reads smaller than
+     * the buffer are served from it so that several small reads only cost a single read from the
+     * socket. Body reads larger than the buffer go directly from the socket into the caller's
+     * buffer.
+     *
+     * @remark The default value is 1024 bytes and using `0` would set this default value.
+     *
+     */
+    size_t ReadBufferSize = _detail::DefaultLibcurlReaderSize;
+
+    /**
+     * @brief When true, the read buffer grows, up to 256 KiB, while reads from the socket keep
+     * filling it completely.
+     *
+     * @remark This reduces the number of reads from the socket for large response bodies read in
+     * small pieces. It is `false` by default.
+     *
+     */
+    bool AdaptiveReadBuffer = false;
+
+    /**
+     * @brief The minimum number of bytes per second at which a response body must be received,
+     * measured over the last #ReadThroughputWindow of time spent reading it.
+     *
+     * @details Only the time spent waiting for the socket counts, not the time between two reads
+     * of the body. When less than the minimum was received over the window, or nothing is received
+     * for as long as the window, reading the body throws a
+     * #Azure::Core::Http::TransportException, so that the caller can carry on from a new
+     * connection, where the body is likely to be received faster.
+     *
+     * @remark The default value is `0`, which disables the check.
+     *
+     */
+    size_t MinimumReadThroughput = 0;
+
+    /**
+     * @brief The time spent reading a response body over which #MinimumReadThroughput is
+     * measured.
+     *
+     * @remark The default value is 30 seconds and using `0` would set this default value.
+     *
+     */
+    std::chrono::milliseconds ReadThroughputWindow = _detail::DefaultReadThroughputWindow;
+
+    /**
+     * @brief The maximum number of connections kept in the connection pool for one host.
+     *
+     * @remark Once the limit is reached, a connection moved back to the pool evicts another one
+     * according to the #EvictionPolicy. The default value is 1024 connections and using `0` would
+     * set this default value.
+     *
+     */
+    size_t MaxConnectionsPerHost = _detail::DefaultMaxConnectionsPerHost;
+
+    /**
+     * @brief The maximum number of connections kept in the connection pool for all the hosts.
+     *
+     * @remark When the pool is full, a connection moved back to the pool evicts a connection to
+     * the same host, or it is closed if there is none. The default value is `0`, which means there
+     * is no limit other than #MaxConnectionsPerHost.
+     *
+     */
+    size_t MaxConnections = 0;
+
+    /**
+     * @brief The time a connection can wait in the connection pool without being used before it is
+     * closed.
+     *
+     * @remark The default value is 60 seconds and using `0` would set this default value.
+     *
+     */
+    std::chrono::milliseconds ConnectionIdleTimeout = _detail::DefaultConnectionIdleTimeout;
+
+    /**
+     * @brief The minimum time between two inspections of the connection pool looking for expired
+     * connections.
+     *
+     * @details The pool is only inspected when a connection can have expired, so a bigger value
+     * lets an expired connection stay longer in the pool in exchange for less frequent
+     * inspections. Expired connections are never re-used.
+     *
+     * @remark The default value is 90 seconds and using `0` would set this default value.
+     *
+     */
+    std::chrono::milliseconds ConnectionPoolCleanerInterval
+        = _detail::DefaultConnectionPoolCleanerInterval;
+
+    /**
+     * @brief The order in which the connections in the connection pool are re-used and evicted.
+     *
+     * @remark The default value is
+     * #Azure::Core::Http::CurlConnectionPoolEvictionPolicy::LeastRecentlyUsed.
+     *
+     */
+    CurlConnectionPoolEvictionPolicy EvictionPolicy
+        = CurlConnectionPoolEvictionPolicy::LeastRecentlyUsed;
+
+    /**
+     * @brief The time the addresses a host name resolves to are kept in the DNS cache shared by
+     * all the connections of the process, before the host name is resolved again.
+     *
+     * @remark The default value is 60 seconds and using `0` would set this default value.
+     *
+     */
+    std::chrono::seconds DnsCacheTimeout = _detail::DefaultDnsCacheTimeout;
+
+    /**
+     * @brief When true, the connections to a host are spread over all the addresses its name
+     * resolves to, instead of mostly going to the first one.
+     *
+     * @details A new connection goes to the address with the fewest open connections to the host.
+     * Services such as Azure Storage resolve to several front ends, and spreading the connections
+     * of a large parallel transfer over them removes the limit on the throughput of a single front
+     * end.
+     *
+     * @remark Ignored when a #Proxy is used. It is `false` by default.
+     *
+     */
+    bool SpreadConnectionsAcrossAddresses = false;
+
+    /**
+     * @brief The maximum number of connections kept in the connection pool for one address of a
+     * host.
+     *
+     * @remark Once the limit is reached, a connection to the address moved back to the pool evicts
+     * the one to the same address waiting for the longest time. The default value is `0`, which
+     * means there is no limit other than #MaxConnectionsPerHost.
+     *
+     */
+    size_t MaxConnectionsPerAddress = 0;
+
+    /**
+     * @brief The number of idle connections to a host kept in the connection pool for the
+     * interactive requests.
+     *
+     * @remark A request of the #Azure::Core::Http::TrafficClass::Bulk class doesn't re-use a
+     * pooled connection when it would leave fewer idle connections to the host, it opens a new
+     * one instead, so that the interactive requests sent meanwhile don't wait for a handshake.
+     * The default value is `0`, which means that the bulk requests re-use any connection.
+     *
+     */
+    size_t ReservedInteractiveConnections = 0;
+
+    /**
+     * @brief When true, the transport owns a connection pool of its own instead of using the
+     * connection pool shared by the #Azure::Core::Http::CurlTransport instances of the process.
+     *
+     * @details The connections of the pool aren't re-used by the other transports, and the bursts
+     * of requests of the other transports don't evict them. Its limits, such as #MaxConnections,
+     * and its statistics only count the connections of the transport. The pool has its own clean
+     * thread, and its own cache of DNS resolutions and TLS sessions.
+     *
+     * @remark The copies of the transport share its pool, which is closed once the last of them,
+     * and the last response body read from one of its connections, is destroyed. It is `false` by
+     * default.
+     *
+     */
+    bool IsolatedConnectionPool = false;
+
+    /**
+     * @brief When true, the small segments of a request are sent right away instead of being
+     * delayed by the Nagle algorithm to be merged with the next ones.
+     *
+     * @remark The default value is `true`. More about this option:
+     * https://curl.se/libcurl/c/CURLOPT_TCP_NODELAY.html
+     *
+     */
+    bool TcpNoDelay = true;
+
+    /**
+     * @brief The size in bytes of the send buffer of the sockets, set with `SO_SNDBUF` before they
+     * connect.
+     *
+     * @details The throughput of a connection is limited to the size of its buffers per round trip,
+     * so links with a high bandwidth-delay product, such as the ones to another region, need
+     * buffers larger than the operating system gives by default.
+     *
+     * @remark The operating system may round the size or cap it. The default value is `0`, which
+     * keeps the size chosen by the operating system.
+     *
+     */
+    size_t SocketSendBufferSize = 0;
+
+    /**
+     * @brief The size in bytes of the receive buffer of the sockets, set with `SO_RCVBUF` before
+     * they connect so that the TCP window can scale to it.
+     *
+     * @remark The operating system may round the size or cap it. The default value is `0`, which
+     * keeps the size chosen by the operating system.
+     *
+     */
+    size_t SocketReceiveBufferSize = 0;
+
+    /**
+     * @brief When true, TCP keepalive probes are sent on idle connections, so that connections
+     * dropped by a middlebox are detected and idle connections aren't dropped by the ones
+     * tracking them.
+     *
+     * @remark It is `false` by default. More about this option:
+     * https://curl.se/libcurl/c/CURLOPT_TCP_KEEPALIVE.html
+     *
+     */
+    bool TcpKeepAlive = false;
+
+    /**
+     * @brief The time a connection is idle before the first TCP keepalive probe is sent, when
+     * #TcpKeepAlive is true.
+     *
+     * @remark The default value is 60 seconds and using `0` would set this default value.
+     *
+     */
+    std::chrono::seconds TcpKeepAliveIdleTime = _detail::DefaultTcpKeepAliveTime;
+
+    /**
+     * @brief The time between two TCP keepalive probes, when #TcpKeepAlive is true.
+     *
+     * @remark The default value is 60 seconds and using `0` would set this default value.
+     *
+     */
+    std::chrono::seconds TcpKeepAliveInterval = _detail::DefaultTcpKeepAliveTime;
+
+    /**
+     * @brief The name of the TCP congestion control algorithm of the sockets, such as `bbr`, set
+     * with `TCP_CONGESTION` before they connect.
+     *
+     * @remark Only used on Linux, where the algorithm must be available to the process. The
+     * default value is an empty string, which keeps the algorithm of the system.
+     *
+     */
+    std::string TcpCongestionControl;
+
+    /**
+     * @brief The size in bytes of a request body from which the request is sent with an
+     * `Expect: 100-continue` header, so that its body is only sent once the server accepted it.
+     *
+     * @details A request rejected by the server, for example because its credentials expired,
+     * then doesn't cost the upload of its body. Smaller bodies are sent right after the headers,
+     * without waiting for the server.
+     *
+     * @remark The default value is 1 MiB. A negative value never sends the header. A body of
+     * unknown length, sent with chunked transfer-encoding, is treated as larger than the
+     * threshold.
+     *
+     */
+    int64_t ExpectContinueThreshold = _detail::DefaultExpectContinueThreshold;
+
+    /**
+     * @brief The time waited for the server to accept a request sent with an
+     * `Expect: 100-continue` header. The body is sent anyway when the server doesn't answer in
+     * time, as some servers never do.
+     *
+     * @remark The default value is 1 second.
+     *
+     */
+    std::chrono::milliseconds ExpectContinueTimeout = _detail::DefaultExpectContinueTimeout;
   };
 
+  class CurlTransport;
+
+  namespace _detail {
+    class CurlConnectionPool;
+  } // namespace _detail
+
+  namespace _internal {
+    /**
+     * @brief The connections of a connection pool of the #Azure::Core::Http::CurlTransport
+     * instances, summed over all the hosts.
+     *
+     */
+    struct CurlConnectionPoolStatistics final
+    {
+      /**
+       * @brief The number of connections opened, by requests or by a warm up.
+       *
+       */
+      uint64_t CreatedConnections = 0;
+
+      /**
+       * @brief The number of requests which took a connection from the pool.
+       *
+       */
+      uint64_t ReusedConnections = 0;
+    };
+
+    /**
+     * @brief Gets the usage counters of the connection pool since the start of the program.
+     *
+     * @remark Tools like the performance tests use them to tell when the requests stop opening
+     * new connections.
+     */
+    CurlConnectionPoolStatistics GetCurlConnectionPoolStatistics();
+
+    /**
+     * @brief Gets the usage counters of the connection pool used by \p transport, which is its
+     * own when it was created with
+     * #Azure::Core::Http::CurlTransportOptions::IsolatedConnectionPool.
+     *
+     */
+    CurlConnectionPoolStatistics GetCurlConnectionPoolStatistics(CurlTransport const& transport);
+  } // namespace _internal
+
   /**
    * @brief Concrete implementation of an HTTP Transport that uses libcurl.
    */
   class CurlTransport final : public HttpTransport {
   private:
     CurlTransportOptions m_options;
+    // The pool of the transport when the options ask for an isolated pool, null otherwise.
+    std::shared_ptr<_detail::CurlConnectionPool> m_connectionPool;
+
+    friend _internal::CurlConnectionPoolStatistics _internal::GetCurlConnectionPoolStatistics(
+        CurlTransport const& transport);
 
   public:
     /**
@@ -132,9 +537,7 @@ namespace Azure { namespace Core { namespace Http {
      *
      * @param options Optional parameter to override the default options.
      */
-    CurlTransport(CurlTransportOptions const& options = CurlTransportOptions()) : m_options(options)
-    {
-    }
+    CurlTransport(CurlTransportOptions const& options = CurlTransportOptions());
 
     /**
      * @brief Implements interface to send an HTTP Request and produce an HTTP RawResponse
@@ -145,6 +548,131 @@ namespace Azure { namespace Core { namespace Http {
      * @return unique ptr to an HTTP RawResponse.
      */
     std::unique_ptr<RawResponse> Send(Request& request, Context const& context) override;
+
+    /**
+     * @brief Opens connections to a host ahead of time, so the first requests sent to it don't pay
+     * for the DNS resolution and the TCP and TLS handshakes.
+     *
+     * @remark Connections are added to the connection pool until it holds \p connectionCount
+     * connections to the host of \p url, up to
+     * #Azure::Core::Http::CurlTransportOptions::MaxConnectionsPerHost. Like any other pooled
+     * connection, they are closed if they are not used within the
+     * #Azure::Core::Http::CurlTransportOptions::ConnectionIdleTimeout. Up to 16 connections are
+     * opened at the same time, and no more connections are opened after one fails.
+     *
+     * @param url The URL of the host to connect to.
+     * @param connectionCount The number of connections to keep ready for the host.
+     *
+     * @throw #Azure::Core::Http::TransportException if a connection cannot be opened.
+     */
+    void WarmUp(Azure::Core::Url const& url, size_t connectionCount);
+
+    /**
+     * @brief Gets a snapshot of the connections of the transport to each host, and of how often
+     * they were re-used.
+     *
+     * @remark The transports share the statistics of the connection pool shared by the process,
+     * unless they were created with
+     * #Azure::Core::Http::CurlTransportOptions::IsolatedConnectionPool.
+     */
+    ConnectionPoolStatistics GetConnectionPoolStatistics() const;
+  };
+
+  namespace _detail {
+    class CurlEventLoop;
+  } // namespace _detail
+
+  /**
+   * @brief Set the options for the libcurl multi interface transport.
+   */
+  struct CurlMultiTransportOptions final
+  {
+    /**
+     * @brief The libcurl connection options applied to every request.
+     *
+     */
+    CurlTransportOptions TransportOptions;
+
+    /**
+     * @brief The number of threads driving the network I/O for all the requests sent by the
+     * transport.
+     *
+     * @remark Requests are distributed across the event loop threads in a round-robin fashion. The
+     * default value is `1` and using `0` would set this default value.
+     *
+     */
+    size_t EventLoopCount = 1;
+
+    /**
+     * @brief When true, requests to HTTPS endpoints negotiate HTTP/2 and requests sent
+     * concurrently to the same host are multiplexed as streams over a single connection.
+     *
+     * @remark HTTP/1.1 is used when the server doesn't support HTTP/2, when the libcurl library
+     * was built without HTTP/2 support and for plain HTTP endpoints. A request waits for an
+     * existing connection to the host to confirm whether it supports multiplexing before opening a
+     * new one. It is `false` by default.
+     *
+     */
+    bool EnableHttp2 = false;
+  };
+
+  /**
+   * @brief Concrete implementation of an HTTP Transport that uses the libcurl multi interface.
+   *
+   * @details Unlike #Azure::Core::Http::CurlTransport, which drives the socket from the thread
+   * sending the request, this transport multiplexes all in-flight requests on a small, fixed number
+   * of event loop threads. This keeps the number of threads doing network I/O constant no matter
+   * how many requests are sent concurrently. With
+   * #Azure::Core::Http::CurlMultiTransportOptions::EnableHttp2, concurrent requests to the same
+   * host also share a single connection.
+   */
+  class CurlMultiTransport final : public HttpTransport {
+  private:
+    CurlMultiTransportOptions m_options;
+    std::vector<std::shared_ptr<_detail::CurlEventLoop>> m_eventLoops;
+    std::atomic<size_t> m_nextEventLoop{0};
+
+  public:
+    /**
+     * @brief Construct a new CurlMultiTransport object and start its event loop threads.
+     *
+     * @param options Optional parameter to override the default options.
+     */
+    CurlMultiTransport(CurlMultiTransportOptions const& options = CurlMultiTransportOptions());
+
+    /**
+     * @brief Stops the event loop threads. Requests still in progress will fail.
+     *
+     */
+    ~CurlMultiTransport() override;
+
+    /**
+     * @brief Implements interface to send an HTTP Request and produce an HTTP RawResponse
+     *
+     * @remark The call returns as soon as the response headers are received. The body is streamed
+     * from the event loop while it is read from the response body stream.
+     *
+     * @param request an HTTP Request to be send.
+     * @param context A context to control the request lifetime.
+     *
+     * @return unique ptr to an HTTP RawResponse.
+     */
+    std::unique_ptr<RawResponse> Send(Request& request, Context const& context) override;
+
+    /**
+     * @brief Implements interface to send an HTTP Request without waiting for its response.
+     *
+     * @remark The request is handed to an event loop, which calls \p callback once the response
+     * headers are received, or once the whole response body is received when it is buffered. No
+     * thread waits for the response in the meantime. The \p callback runs on the event loop
+     * thread, so it must not block, nor read the body stream of a response which isn't buffered.
+     *
+     * @param request an HTTP Request to be send.
+     * @param context A context to control the request lifetime.
+     * @param callback Called with the HTTP RawResponse, or with the exception the request failed
+     * with.
+     */
+    void SendAsync(Request& request, Context const& context, ResponseCallback callback) override;
   };
 
 }}} // namespace Azure::Core::Http
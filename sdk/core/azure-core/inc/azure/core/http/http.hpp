@@ -20,12 +20,14 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #if defined(TESTING_BUILD)
@@ -34,6 +36,8 @@ namespace Azure { namespace Core { namespace Test {
   class TestHttp_getters_Test;
   class TestHttp_query_parameter_Test;
   class TestHttp_RequestStartTry_Test;
+  class TestHttp_RequestHelpers_Test;
+  class TestHttp_RequestStaticHeaders_Test;
   class TestURL_getters_Test;
   class TestURL_query_parameter_Test;
   class TransportAdapter_headWithStream_Test;
@@ -168,6 +172,10 @@ namespace Azure { namespace Core { namespace Http {
     class RetryPolicy;
   }} // namespace Policies::_internal
 
+  namespace _detail {
+    struct RequestHelpers;
+  } // namespace _detail
+
   /**
    * @brief A request message from a client to a server.
    *
@@ -176,11 +184,14 @@ namespace Azure { namespace Core { namespace Http {
    */
   class Request final {
     friend class Azure::Core::Http::Policies::_internal::RetryPolicy;
+    friend struct Azure::Core::Http::_detail::RequestHelpers;
 #if defined(TESTING_BUILD)
     // make tests classes friends to validate set Retry
     friend class Azure::Core::Test::TestHttp_getters_Test;
     friend class Azure::Core::Test::TestHttp_query_parameter_Test;
     friend class Azure::Core::Test::TestHttp_RequestStartTry_Test;
+    friend class Azure::Core::Test::TestHttp_RequestHelpers_Test;
+    friend class Azure::Core::Test::TestHttp_RequestStaticHeaders_Test;
     friend class Azure::Core::Test::TestURL_getters_Test;
     friend class Azure::Core::Test::TestURL_query_parameter_Test;
     // make tests classes friends to validate private Request ctor that takes both stream and bool
@@ -199,6 +210,9 @@ namespace Azure { namespace Core { namespace Http {
     Url m_url;
     CaseInsensitiveMap m_headers;
     CaseInsensitiveMap m_retryHeaders;
+    // The headers the pipeline sends with every request of a client, shared by its requests
+    // instead of being set on each of them. The headers set on the request replace them.
+    std::shared_ptr<CaseInsensitiveMap const> m_staticHeaders;
 
     Azure::Core::IO::BodyStream* m_bodyStream;
 
@@ -210,10 +224,11 @@ namespace Azure { namespace Core { namespace Http {
     // previously called
     void StartTry();
 
+  public:
     /**
-     * @brief Construct an #Azure::Core::Http::Request.
+     * @brief Constructs a `%Request`.
      *
-     * @param httpMethod HttpMethod.
+     * @param httpMethod HTTP method.
      * @param url %Request URL.
      * @param bodyStream #Azure::Core::IO::BodyStream.
      * @param shouldBufferResponse A boolean value indicating whether the returned response should
@@ -230,7 +245,6 @@ namespace Azure { namespace Core { namespace Http {
       _azure_ASSERT_MSG(bodyStream, "The bodyStream pointer cannot be null.");
     }
 
-  public:
     /**
      * @brief Constructs a `%Request`.
      *
@@ -320,6 +334,121 @@ namespace Azure { namespace Core { namespace Http {
   };
 
   namespace _detail {
+    /**
+     * @brief Read the headers of a #Azure::Core::Http::Request without copying them.
+     *
+     * @remark #Azure::Core::Http::Request::GetHeaders() returns a new map with the headers set
+     * before and after the last retry. The transport adapters only need to read the headers, so
+     * they use these helpers to avoid allocating that map for every request.
+     */
+    struct RequestHelpers final
+    {
+      /**
+       * @brief Find the value of a header of \p request.
+       *
+       * @param request The request with the header.
+       * @param name The case-insensitive name of the header. It is found without being
+       * copied into a `std::string`.
+       *
+       * @return A pointer to the value of the header, or `nullptr` if \p request does not have
+       * it. The pointer is valid until the headers of \p request are modified.
+       */
+      static std::string const* FindHeader(Request const& request, char const* name)
+      {
+        auto header = request.m_retryHeaders.find(name);
+        if (header != request.m_retryHeaders.end())
+        {
+          return &header->second;
+        }
+        header = request.m_headers.find(name);
+        if (header != request.m_headers.end())
+        {
+          return &header->second;
+        }
+        if (request.m_staticHeaders)
+        {
+          header = request.m_staticHeaders->find(name);
+          if (header != request.m_staticHeaders->end())
+          {
+            return &header->second;
+          }
+        }
+        return nullptr;
+      }
+
+      /**
+       * @brief Call \p function with the name and value of each header of \p request.
+       *
+       * @remark The headers are visited in the same order, and with the same values, as the
+       * entries of the map returned by #Azure::Core::Http::Request::GetHeaders().
+       *
+       * @param request The request with the headers.
+       * @param function Called as `function(name, value)` for each header.
+       */
+      template <class Function>
+      static void ForEachHeader(Request const& request, Function function)
+      {
+        // The maps are sorted with the same comparison, so they are merged in one pass. A header
+        // set after the last retry replaces the one with the same name set before it, which
+        // replaces the static header with the same name.
+        auto const less = CaseInsensitiveMap::key_compare();
+        auto retryHeader = request.m_retryHeaders.begin();
+        auto const retryEnd = request.m_retryHeaders.end();
+        auto header = request.m_headers.begin();
+        auto const headerEnd = request.m_headers.end();
+        // Without static headers, both iterators are the end of the headers so none is visited.
+        auto staticHeader
+            = request.m_staticHeaders ? request.m_staticHeaders->begin() : request.m_headers.end();
+        auto const staticEnd
+            = request.m_staticHeaders ? request.m_staticHeaders->end() : request.m_headers.end();
+        while (retryHeader != retryEnd || header != headerEnd || staticHeader != staticEnd)
+        {
+          CaseInsensitiveMap::value_type const* next
+              = retryHeader != retryEnd ? &*retryHeader : nullptr;
+          if (header != headerEnd && (next == nullptr || less(header->first, next->first)))
+          {
+            next = &*header;
+          }
+          if (staticHeader != staticEnd
+              && (next == nullptr || less(staticHeader->first, next->first)))
+          {
+            next = &*staticHeader;
+          }
+          function(next->first, next->second);
+
+          if (retryHeader != retryEnd && !less(next->first, retryHeader->first))
+          {
+            ++retryHeader;
+          }
+          if (header != headerEnd && !less(next->first, header->first))
+          {
+            ++header;
+          }
+          if (staticHeader != staticEnd && !less(next->first, staticHeader->first))
+          {
+            ++staticHeader;
+          }
+        }
+      }
+
+      /**
+       * @brief Share the headers sent with every request of a pipeline with \p request.
+       *
+       * @param request The request to send the headers with.
+       * @param staticHeaders The headers, with lowercase names. The headers set on \p request
+       * replace the ones with the same name.
+       */
+      static void SetStaticHeaders(
+          Request& request,
+          std::shared_ptr<CaseInsensitiveMap const> const& staticHeaders)
+      {
+        if (request.m_staticHeaders != staticHeaders)
+        {
+          request.m_staticHeaders = staticHeaders;
+        }
+      }
+    };
+
     struct RawResponseHelpers final
     {
       /**
@@ -334,8 +463,8 @@ namespace Azure { namespace Core { namespace Http {
        */
       static void InsertHeaderWithValidation(
           CaseInsensitiveMap& headers,
-          std::string const& headerName,
-          std::string const& headerValue);
+          std::string headerName,
+          std::string headerValue);
 
       static void inline SetHeader(
           Azure::Core::Http::RawResponse& response,
@@ -344,26 +473,31 @@ namespace Azure { namespace Core { namespace Http {
       {
         // get name and value from header
         auto start = first;
-        auto end = std::find(start, last, ':');
+        auto end = static_cast<uint8_t const*>(std::memchr(start, ':', last - start));
 
-        if (end == last)
+        if (end == nullptr)
         {
           throw std::invalid_argument("Invalid header. No delimiter ':' found.");
         }
 
-        // Always toLower() headers
-        auto headerName
-            = Azure::Core::_internal::StringExtensions::ToLower(std::string(start, end));
+        // Always toLower() headers. The name is lowered in place to avoid a second copy.
+        std::string headerName(start, end);
+        for (auto& c : headerName)
+        {
+          c = static_cast<char>(
+              Azure::Core::_internal::StringExtensions::ToLower(static_cast<unsigned char>(c)));
+        }
         start = end + 1; // start value
         while (start < last && (*start == ' ' || *start == '\t'))
         {
           ++start;
         }
 
-        end = std::find(start, last, '\r');
-        auto headerValue = std::string(start, end); // remove \r
+        end = static_cast<uint8_t const*>(std::memchr(start, '\r', last - start));
+        auto headerValue = std::string(start, end == nullptr ? last : end); // remove \r
 
-        response.SetHeader(headerName, headerValue);
+        InsertHeaderWithValidation(
+            response.m_headers, std::move(headerName), std::move(headerValue));
       }
     };
   } // namespace _detail
@@ -380,7 +514,7 @@ namespace Azure { namespace Core { namespace Http {
 
       static inline std::string GetHeaderOrEmptyString(
           Azure::Core::CaseInsensitiveMap const& headers,
-          std::string const& headerName)
+          char const* headerName)
       {
         auto header = headers.find(headerName);
         if (header != headers.end())
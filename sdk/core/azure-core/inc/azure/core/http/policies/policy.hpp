@@ -11,18 +11,26 @@
 #include "azure/core/case_insensitive_containers.hpp"
 #include "azure/core/context.hpp"
 #include "azure/core/credentials/credentials.hpp"
+#include "azure/core/diagnostics/metrics.hpp"
 #include "azure/core/dll_import_export.hpp"
 #include "azure/core/http/http.hpp"
 #include "azure/core/http/transport.hpp"
+#include "azure/core/internal/diagnostics/span.hpp"
 #include "azure/core/uuid.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -40,6 +48,7 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
   namespace _detail {
     std::shared_ptr<HttpTransport> GetTransportAdapter();
     AZ_CORE_DLLEXPORT extern Azure::Core::CaseInsensitiveSet const g_defaultAllowedHttpHeaders;
+    struct CachedAccessToken;
   } // namespace _detail
 
   /**
@@ -58,6 +67,152 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
     std::string ApplicationId;
   };
 
+  namespace _internal {
+    class RetryPolicy;
+  } // namespace _internal
+
+  /**
+   * @brief Limits the retries of the requests sharing it to a ratio of the requests sent over a
+   * sliding window of time, so that the retries don't multiply the load on a struggling service.
+   *
+   * @remark A retry which would exceed the budget isn't made, the last response or error is
+   * returned instead. The budget can be shared by the retry options of several clients.
+   *
+   */
+  class RetryBudget final {
+  public:
+    /**
+     * @brief Constructs a retry budget.
+     *
+     * @param retryRatio The maximum number of retries per request sent, over the window.
+     * @param minRetries The number of retries allowed over the window whatever the number of
+     * requests, so that the requests sent rarely can be retried.
+     * @param window The duration over which the requests and the retries are counted.
+     *
+     * @throw std::invalid_argument if \p retryRatio or \p minRetries is negative, or if \p window
+     * isn't positive.
+     */
+    explicit RetryBudget(
+        double retryRatio = 0.1,
+        int32_t minRetries = 10,
+        std::chrono::milliseconds window = std::chrono::seconds(10));
+
+    RetryBudget(RetryBudget const&) = delete;
+    RetryBudget& operator=(RetryBudget const&) = delete;
+
+    /**
+     * @brief Destructs `%RetryBudget`.
+     *
+     */
+    ~RetryBudget();
+
+    /**
+     * @brief Gets the number of requests sent with the budget, not counting the retries.
+     *
+     * @return The number of requests.
+     */
+    int64_t Requests() const;
+
+    /**
+     * @brief Gets the number of retries allowed by the budget.
+     *
+     * @return The number of retries.
+     */
+    int64_t Retries() const;
+
+    /**
+     * @brief Gets the number of retries which weren't made because they would have exceeded the
+     * budget.
+     *
+     * @return The number of retries rejected.
+     */
+    int64_t RejectedRetries() const;
+
+  private:
+    struct State;
+
+    void OnRequest();
+    bool TryRetry();
+
+    std::unique_ptr<State> m_state;
+
+    friend class _internal::RetryPolicy;
+  };
+
+  /**
+   * @brief Fails the requests to a host right away for a cool-down period after several
+   * consecutive tries of requests to it have failed.
+   *
+   * @details A try fails when it throws a #Azure::Core::Http::TransportException or when its
+   * response has one of the status codes of
+   * #Azure::Core::Http::Policies::RetryOptions::StatusCodes.
+   * After the cool-down period, a single request is sent to the host: the circuit is closed again
+   * if it succeeds, or opened for another cool-down period if it fails. The requests failed right
+   * away throw a #Azure::Core::Http::TransportException and aren't retried.
+   *
+   * @remark The circuit breaker can be shared by the retry options of several clients.
+   *
+   */
+  class CircuitBreaker final {
+  public:
+    /**
+     * @brief Constructs a circuit breaker.
+     *
+     * @param failureThreshold The number of consecutive failed tries to a host which opens the
+     * circuit for the host.
+     * @param coolDown The time during which the requests to a host fail right away once its
+     * circuit is open.
+     *
+     * @throw std::invalid_argument if \p failureThreshold or \p coolDown isn't positive.
+     */
+    explicit CircuitBreaker(
+        int32_t failureThreshold = 10,
+        std::chrono::milliseconds coolDown = std::chrono::seconds(30));
+
+    CircuitBreaker(CircuitBreaker const&) = delete;
+    CircuitBreaker& operator=(CircuitBreaker const&) = delete;
+
+    /**
+     * @brief Destructs `%CircuitBreaker`.
+     *
+     */
+    ~CircuitBreaker();
+
+    /**
+     * @brief Checks if the requests to a host fail right away.
+     *
+     * @param host The host of the requests.
+     * @return `true` if the circuit of \p host is open; otherwise, `false`.
+     */
+    bool IsOpen(std::string const& host) const;
+
+    /**
+     * @brief Gets the number of times a circuit was opened.
+     *
+     * @return The number of times a circuit was opened.
+     */
+    int64_t TimesOpened() const;
+
+    /**
+     * @brief Gets the number of requests which failed right away because their circuit was open.
+     *
+     * @return The number of requests failed right away.
+     */
+    int64_t RejectedRequests() const;
+
+  private:
+    struct State;
+
+    // Returns false if the request to the host must fail right away.
+    bool TryAcquire(std::string const& host);
+    void OnTryCompleted(std::string const& host, bool succeeded);
+    void OnTryAbandoned(std::string const& host);
+
+    std::unique_ptr<State> m_state;
+
+    friend class _internal::RetryPolicy;
+  };
+
   /**
    * @brief The set of options that can be specified to influence how retry attempts are made, and a
    * failure is eligible to be retried.
@@ -97,6 +252,87 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
         HttpStatusCode::ServiceUnavailable,
         HttpStatusCode::GatewayTimeout,
     };
+
+    /**
+     * @brief The budget limiting the retries, shared with the other retry options using it.
+     *
+     * @remark The default is `nullptr`, which doesn't limit the retries other than by
+     * #MaxRetries.
+     *
+     */
+    std::shared_ptr<RetryBudget> Budget;
+
+    /**
+     * @brief The circuit breaker failing the requests to a host which keep failing, shared with
+     * the other retry options using it.
+     *
+     * @remark The default is `nullptr`, which never fails the requests right away.
+     *
+     */
+    std::shared_ptr<Policies::CircuitBreaker> CircuitBreaker;
+
+    /**
+     * @brief The maximum time a single try can take, to receive the response headers and the body
+     * of the responses which aren't streamed. A try taking longer is aborted, without reusing its
+     * connection, and retried like a transport failure while the context of the request still
+     * has time left.
+     *
+     * @remark The default is zero, which only limits the tries by the context of the request.
+     *
+     */
+    std::chrono::milliseconds TryTimeout{};
+
+    /**
+     * @brief The minimum throughput, in bytes per second, expected from a try. The #TryTimeout
+     * of a request is extended by the time it takes to transfer its body, and the byte range it
+     * asks for with a `range` or `x-ms-range` header, at this throughput.
+     *
+     * @remark The default is zero, which uses the same #TryTimeout for all the requests.
+     *
+     */
+    int64_t MinimumTryThroughput = 0;
+  };
+
+  /**
+   * @brief The set of options that can be specified to influence when a duplicate of an idempotent
+   * request is sent, to reduce the latency of the requests answered unusually slowly.
+   *
+   */
+  struct HedgingOptions final
+  {
+    /**
+     * @brief When true, a `GET` or `HEAD` request without a body which isn't answered within the
+     * hedging delay is sent again on another connection. The first response is used, and the
+     * other request is cancelled.
+     *
+     * @remark The default is `false`.
+     *
+     */
+    bool Enabled = false;
+
+    /**
+     * @brief The percentile of the recent response times of the requests used as the hedging
+     * delay, between `0` and `100`.
+     *
+     * @remark The default is `95`, which sends a duplicate of about 5% of the requests.
+     *
+     */
+    double DelayPercentile = 95.0;
+
+    /**
+     * @brief The minimum hedging delay.
+     * @note See https://en.cppreference.com/w/cpp/chrono/duration.
+     *
+     */
+    std::chrono::milliseconds MinDelay = std::chrono::milliseconds(10);
+
+    /**
+     * @brief The maximum hedging delay, which is also the delay used until enough response times
+     * are known.
+     * @note See https://en.cppreference.com/w/cpp/chrono/duration.
+     *
+     */
+    std::chrono::milliseconds MaxDelay = std::chrono::seconds(1);
   };
 
   /**
@@ -119,6 +355,26 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
     Azure::Core::CaseInsensitiveSet AllowedHttpHeaders = _detail::g_defaultAllowedHttpHeaders;
   };
 
+  /**
+   * @brief Metrics options, to collect the metrics of the requests sent by a client.
+   *
+   */
+  struct MetricsOptions final
+  {
+    /**
+     * @brief Called with the metrics of each request sent by the client, once its response headers
+     * are received or it failed.
+     *
+     * @remark It is called from the thread sending the request, so it must be thread safe and
+     * return quickly, e.g. by passing the metrics to an
+     * #Azure::Core::Diagnostics::MetricsAggregator. The exceptions it throws are ignored.
+     *
+     * @remark The default is empty, in which case no metrics are collected.
+     *
+     */
+    std::function<void(Azure::Core::Diagnostics::RequestMetrics const& metrics)> Listener;
+  };
+
   /**
    * @brief HTTP transport options parameterize the HTTP transport adapter being used.
    */
@@ -170,6 +426,32 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
         NextHttpPolicy nextPolicy,
         Context const& context) const = 0;
 
+    /**
+     * @brief Applies this HTTP policy without waiting for the response.
+     *
+     * @details The request goes through the policy like with #Send(), and \p callback is called
+     * with the response, or with the exception #Send() would throw, once the response is received.
+     * When the transport completes its requests from its own threads, like
+     * #Azure::Core::Http::CurlMultiTransport, no thread waits for the response in the meantime.
+     *
+     * @remark The default implementation calls #Send() and then \p callback, so a policy which
+     * doesn't override it blocks the thread sending the request until the response is received.
+     * The \p request and the pipeline must stay alive until \p callback is called. This function
+     * never throws, the errors are passed to \p callback.
+     *
+     * @param request An HTTP request being sent.
+     * @param nextPolicy The next HTTP to invoke after this policy has been applied.
+     * @param context A context to control the request lifetime.
+     * @param callback Called with the response after this policy, and all subsequent HTTP
+     * policies in the stack sequence of policies have been applied, or with the exception the
+     * request failed with.
+     */
+    virtual void SendAsync(
+        Request& request,
+        NextHttpPolicy nextPolicy,
+        Context const& context,
+        ResponseCallback callback) const;
+
     /**
      * @brief Destructs `%HttpPolicy`.
      *
@@ -249,10 +531,196 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
      * sequence of policies have been applied.
      */
     std::unique_ptr<RawResponse> Send(Request& request, Context const& context);
+
+    /**
+     * @brief Applies this HTTP policy without waiting for the response.
+     *
+     * @param request An HTTP request being sent.
+     * @param context A context to control the request lifetime.
+     * @param callback Called with the response after this policy, and all subsequent HTTP
+     * policies in the stack sequence of policies have been applied, or with the exception the
+     * request failed with.
+     */
+    void SendAsync(Request& request, Context const& context, ResponseCallback callback);
   };
 
+  namespace _detail {
+    /**
+     * @brief Gets the name of the span of a request sent with \p method, a string literal.
+     *
+     */
+    char const* GetSpanName(HttpMethod const& method);
+
+    /**
+     * @brief A span of a request sent asynchronously, which ends once its response is received
+     * instead of at the end of a scope.
+     *
+     */
+    struct AsyncSpan final
+    {
+      /**
+       * @brief The context the parent span is taken from.
+       *
+       */
+      Context ParentContext;
+
+      /**
+       * @brief The span.
+       *
+       */
+      Azure::Core::Diagnostics::_internal::Span Span;
+
+      /**
+       * @brief Starts a span.
+       *
+       * @param name The name of the span, a string literal.
+       * @param context The context the parent span is taken from.
+       * @param kind The role of the span.
+       */
+      AsyncSpan(
+          char const* name,
+          Context const& context,
+          Azure::Core::Diagnostics::SpanKind kind = Azure::Core::Diagnostics::SpanKind::Internal)
+          : ParentContext(context), Span(name, ParentContext, kind)
+      {
+      }
+
+      /**
+       * @brief Ends the span with the result of the request.
+       *
+       */
+      void End(RawResponse const* response)
+      {
+        if (response)
+        {
+          Span.SetStatusCode(response->GetStatusCode());
+        }
+        else
+        {
+          Span.SetError();
+        }
+        Span.End();
+      }
+    };
+  } // namespace _detail
+
   namespace _internal {
 
+    /**
+     * @brief Runs a sequence of policies known at compile time as a single policy of a pipeline.
+     *
+     * @details Each of the \p Policies provides, besides `Send()`,
+     * `template <class NextPolicy> std::unique_ptr<RawResponse> SendWith(Request&, NextPolicy,
+     * Context const&) const`, which calls `nextPolicy.Send(request, context)` like it would call
+     * an #Azure::Core::Http::Policies::NextHttpPolicy. The policies then call each other directly,
+     * so the compiler can inline them into a single call chain, instead of through a virtual call
+     * and a copy of the next policy each. The last of them calls the policy following the
+     * composed one in the pipeline. They provide `SendAsyncWith()` the same way, for
+     * #Azure::Core::Http::Policies::HttpPolicy::SendAsync().
+     *
+     * @remark A pipeline composes its fixed policies, the ones added by the clients and their
+     * options stay in the pipeline between them.
+     *
+     * @tparam Policies The policies, from the top of the stack.
+     */
+    template <class... Policies> class ComposedHttpPolicy final : public HttpPolicy {
+    private:
+      std::tuple<Policies...> m_policies;
+
+      // The policy after the one at Index - 1 in m_policies, for the policy at Index - 1.
+      template <size_t Index> class ComposedNextPolicy final {
+        ComposedHttpPolicy const& m_composedPolicy;
+        NextHttpPolicy& m_nextPolicy;
+
+      public:
+        ComposedNextPolicy(ComposedHttpPolicy const& composedPolicy, NextHttpPolicy& nextPolicy)
+            : m_composedPolicy(composedPolicy), m_nextPolicy(nextPolicy)
+        {
+        }
+
+        std::unique_ptr<RawResponse> Send(Request& request, Context const& context)
+        {
+          return m_composedPolicy.template SendFrom<Index>(request, m_nextPolicy, context);
+        }
+
+        void SendAsync(Request& request, Context const& context, ResponseCallback callback)
+        {
+          m_composedPolicy.template SendAsyncFrom<Index>(
+              request, m_nextPolicy, context, std::move(callback));
+        }
+      };
+
+      template <size_t Index>
+      typename std::enable_if<(Index < sizeof...(Policies)), std::unique_ptr<RawResponse>>::type
+      SendFrom(Request& request, NextHttpPolicy& nextPolicy, Context const& context) const
+      {
+        return std::get<Index>(m_policies)
+            .SendWith(request, ComposedNextPolicy<Index + 1>(*this, nextPolicy), context);
+      }
+
+      template <size_t Index>
+      typename std::enable_if<Index == sizeof...(Policies), std::unique_ptr<RawResponse>>::type
+      SendFrom(Request& request, NextHttpPolicy& nextPolicy, Context const& context) const
+      {
+        return nextPolicy.Send(request, context);
+      }
+
+      template <size_t Index>
+      typename std::enable_if<(Index < sizeof...(Policies))>::type SendAsyncFrom(
+          Request& request,
+          NextHttpPolicy& nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const
+      {
+        std::get<Index>(m_policies)
+            .SendAsyncWith(
+                request,
+                ComposedNextPolicy<Index + 1>(*this, nextPolicy),
+                context,
+                std::move(callback));
+      }
+
+      template <size_t Index>
+      typename std::enable_if<Index == sizeof...(Policies)>::type SendAsyncFrom(
+          Request& request,
+          NextHttpPolicy& nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const
+      {
+        nextPolicy.SendAsync(request, context, std::move(callback));
+      }
+
+    public:
+      /**
+       * @brief Constructs a composed HTTP policy.
+       *
+       * @param policies The policies, from the top of the stack.
+       */
+      explicit ComposedHttpPolicy(Policies... policies) : m_policies(std::move(policies)...) {}
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<ComposedHttpPolicy>(*this);
+      }
+
+      std::unique_ptr<RawResponse> Send(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context) const override
+      {
+        return SendFrom<0>(request, nextPolicy, context);
+      }
+
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override
+      {
+        SendAsyncFrom<0>(request, nextPolicy, context, std::move(callback));
+      }
+    };
+
     /**
      * @brief Applying this policy sends an HTTP request over the wire.
      * @remark This policy must be the bottom policy in the stack of the HTTP policy stack.
@@ -281,6 +749,45 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
           Request& request,
           NextHttpPolicy nextPolicy,
           Context const& context) const override;
+
+      /**
+       * @brief Sends \p request over the wire, as the last policy of a #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      std::unique_ptr<RawResponse> SendWith(Request& request, NextPolicy, Context const& context)
+          const
+      {
+        return SendToTransport(request, context);
+      }
+
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override;
+
+      /**
+       * @brief Sends \p request over the wire without waiting for the response, as the last policy
+       * of a #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      void SendAsyncWith(
+          Request& request,
+          NextPolicy,
+          Context const& context,
+          ResponseCallback callback) const
+      {
+        SendToTransportAsync(request, context, std::move(callback));
+      }
+
+    private:
+      std::unique_ptr<RawResponse> SendToTransport(Request& request, Context const& context) const;
+      void SendToTransportAsync(
+          Request& request,
+          Context const& context,
+          ResponseCallback callback) const;
     };
 
     /**
@@ -294,6 +801,24 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
     private:
       RetryOptions m_retryOptions;
 
+      struct RequestState;
+
+      // Starts a try of the request, throws if the circuit breaker rejects it.
+      void StartTry(RequestState& state) const;
+      // Decides whether the try which got the response, or failed with the error, is retried
+      // after retryAfter. Returns false for the response to be returned, throws the exception the
+      // request fails with.
+      bool ShouldRetryTry(
+          RequestState& state,
+          RawResponse const* response,
+          std::exception_ptr const& error,
+          std::chrono::milliseconds& retryAfter) const;
+      // Sends a try of the request, and the following ones once it failed.
+      void SendTryAsync(
+          std::shared_ptr<RequestState> state,
+          NextHttpPolicy nextPolicy,
+          ResponseCallback callback) const;
+
     public:
       /**
        * Constructs HTTP retry policy with the provided #Azure::Core::Http::Policies::RetryOptions.
@@ -312,6 +837,19 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
           NextHttpPolicy nextPolicy,
           Context const& context) const final;
 
+      /**
+       * @brief Sends the request without waiting for the response, and retries it like #Send().
+       *
+       * @remark The retries are sent from a thread of the SDK once their delay has elapsed, or
+       * fail as soon as the context is cancelled.
+       *
+       */
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const final;
+
       /**
        * @brief Get the Retry Count from the context.
        *
@@ -340,6 +878,42 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
           double jitterFactor = -1) const;
     };
 
+    /**
+     * @brief HTTP hedging policy.
+     *
+     * @details Sends a duplicate of an idempotent request which isn't answered after a percentile
+     * of the recent response times, as configured by
+     * #Azure::Core::Http::Policies::HedgingOptions, and returns the first response. The duplicate
+     * is sent from another thread, the policy returns once the other request has stopped.
+     */
+    class HedgingPolicy final : public HttpPolicy {
+    private:
+      class ResponseTimes;
+
+      HedgingOptions m_hedgingOptions;
+      // Shared with the clones of the policy.
+      std::shared_ptr<ResponseTimes> m_responseTimes;
+
+    public:
+      /**
+       * @brief Constructs HTTP hedging policy with the provided
+       * #Azure::Core::Http::Policies::HedgingOptions.
+       *
+       * @param options #Azure::Core::Http::Policies::HedgingOptions.
+       */
+      explicit HedgingPolicy(HedgingOptions options);
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<HedgingPolicy>(*this);
+      }
+
+      std::unique_ptr<RawResponse> Send(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context) const override;
+    };
+
     /**
      * @brief HTTP Request ID policy.
      *
@@ -366,12 +940,61 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
           Request& request,
           NextHttpPolicy nextPolicy,
           Context const& context) const override
+      {
+        return SendWith(request, nextPolicy, context);
+      }
+
+      /**
+       * @brief Applies this policy as part of a #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      std::unique_ptr<RawResponse> SendWith(
+          Request& request,
+          NextPolicy nextPolicy,
+          Context const& context) const
       {
         auto uuid = Uuid::CreateUuid().ToString();
 
         request.SetHeader(RequestIdHeader, uuid);
         return nextPolicy.Send(request, context);
       }
+
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override
+      {
+        SendAsyncWith(request, nextPolicy, context, std::move(callback));
+      }
+
+      /**
+       * @brief Applies this policy without waiting for the response, as part of a
+       * #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      void SendAsyncWith(
+          Request& request,
+          NextPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const
+      {
+        std::string uuid;
+        try
+        {
+          uuid = Uuid::CreateUuid().ToString();
+        }
+        catch (...)
+        {
+          callback(nullptr, std::current_exception());
+          return;
+        }
+
+        request.SetHeader(RequestIdHeader, uuid);
+        nextPolicy.SendAsync(request, context, std::move(callback));
+      }
     };
 
     /**
@@ -385,12 +1008,21 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
     private:
       std::string const m_telemetryId;
 
+    public:
+      /**
+       * @brief Build the value of the User-Agent header sent by the policy.
+       *
+       * @param componentName Azure SDK component name (e.g. "storage.blobs").
+       * @param componentVersion Azure SDK component version (e.g. "11.0.0").
+       * @param applicationId The application ID (e.g. "AzCopy").
+       *
+       * @return The telemetry ID.
+       */
       static std::string BuildTelemetryId(
           std::string const& componentName,
           std::string const& componentVersion,
           std::string const& applicationId);
 
-    public:
       /**
        * @brief Construct HTTP telemetry policy.
        *
@@ -415,6 +1047,12 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
           Request& request,
           NextHttpPolicy nextPolicy,
           Context const& context) const override;
+
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override;
     };
 
     /**
@@ -426,26 +1064,30 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
       std::shared_ptr<Credentials::TokenCredential const> const m_credential;
       Credentials::TokenRequestContext m_tokenRequestContext;
 
-      mutable Credentials::AccessToken m_accessToken;
-      mutable std::mutex m_accessTokenMutex;
+      // Shared by all the policies using the same credential and scopes in the process.
+      std::shared_ptr<_detail::CachedAccessToken> const m_cachedAccessToken;
 
       BearerTokenAuthenticationPolicy(BearerTokenAuthenticationPolicy const&) = delete;
       void operator=(BearerTokenAuthenticationPolicy const&) = delete;
 
+      // Sets the authorization header of the request, getting a token first if the cached one
+      // expires soon.
+      void AuthorizeRequest(Request& request, Context const& context) const;
+
     public:
       /**
        * @brief Construct a Bearer Token authentication policy.
        *
+       * @details The tokens are cached for the whole process, the policies using the same \p
+       * credential instance and scopes share them. A token is refreshed in the background a few
+       * minutes before it expires, the requests only wait for a token when none is valid anymore.
+       *
        * @param credential An #Azure::Core::TokenCredential to use with this policy.
        * @param tokenRequestContext A context to get the token in.
        */
       explicit BearerTokenAuthenticationPolicy(
           std::shared_ptr<Credentials::TokenCredential const> credential,
-          Credentials::TokenRequestContext tokenRequestContext)
-          : m_credential(std::move(credential)),
-            m_tokenRequestContext(std::move(tokenRequestContext))
-      {
-      }
+          Credentials::TokenRequestContext tokenRequestContext);
 
       std::unique_ptr<HttpPolicy> Clone() const override
       {
@@ -453,6 +1095,279 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
             m_credential, m_tokenRequestContext);
       }
 
+      std::unique_ptr<RawResponse> Send(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context) const override;
+
+      /**
+       * @brief Authorizes the request and sends it without waiting for the response.
+       *
+       * @remark A token is only got while sending the request when no cached token is valid
+       * anymore. The thread sending the request waits for it then.
+       *
+       */
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override;
+    };
+
+    /**
+     * @brief HTTP tracing policy.
+     *
+     * @details Starts a span for each request, including its retries, while tracing is enabled
+     * with #Azure::Core::Diagnostics::Tracer::SetExporter(). It is paired with a
+     * #TryTracingPolicy sitting right above the transport, which starts a span for each try.
+     */
+    class TracingPolicy final : public HttpPolicy {
+    public:
+      /**
+       * @brief Constructs HTTP tracing policy.
+       *
+       */
+      explicit TracingPolicy() {}
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<TracingPolicy>(*this);
+      }
+
+      std::unique_ptr<RawResponse> Send(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context) const override
+      {
+        return SendWith(request, nextPolicy, context);
+      }
+
+      /**
+       * @brief Applies this policy as part of a #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      std::unique_ptr<RawResponse> SendWith(
+          Request& request,
+          NextPolicy nextPolicy,
+          Context const& context) const
+      {
+        Azure::Core::Diagnostics::_internal::Span span(
+            _detail::GetSpanName(request.GetMethod()), context);
+        auto response = nextPolicy.Send(request, span.GetContext());
+        if (response)
+        {
+          span.SetStatusCode(response->GetStatusCode());
+        }
+        return response;
+      }
+
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override
+      {
+        SendAsyncWith(request, nextPolicy, context, std::move(callback));
+      }
+
+      /**
+       * @brief Applies this policy without waiting for the response, as part of a
+       * #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      void SendAsyncWith(
+          Request& request,
+          NextPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const
+      {
+        std::shared_ptr<_detail::AsyncSpan> span;
+        try
+        {
+          span = std::make_shared<_detail::AsyncSpan>(
+              _detail::GetSpanName(request.GetMethod()), context);
+        }
+        catch (...)
+        {
+          callback(nullptr, std::current_exception());
+          return;
+        }
+        // The context of the span is created before the request is sent, so not concurrently.
+        auto const& spanContext = span->Span.GetContext();
+        nextPolicy.SendAsync(
+            request,
+            spanContext,
+            [span, callback](std::unique_ptr<RawResponse> response, std::exception_ptr error) {
+              span->End(response.get());
+              callback(std::move(response), std::move(error));
+            });
+      }
+    };
+
+    /**
+     * @brief HTTP try tracing policy.
+     *
+     * @details Starts a span for each try of a request while tracing is enabled, and sends it to
+     * the service in the W3C `traceparent` header.
+     */
+    class TryTracingPolicy final : public HttpPolicy {
+    public:
+      /**
+       * @brief Constructs HTTP try tracing policy.
+       *
+       */
+      explicit TryTracingPolicy() {}
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<TryTracingPolicy>(*this);
+      }
+
+      std::unique_ptr<RawResponse> Send(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context) const override
+      {
+        return SendWith(request, nextPolicy, context);
+      }
+
+      /**
+       * @brief Applies this policy as part of a #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      std::unique_ptr<RawResponse> SendWith(
+          Request& request,
+          NextPolicy nextPolicy,
+          Context const& context) const
+      {
+        Azure::Core::Diagnostics::_internal::Span span(
+            _detail::GetSpanName(request.GetMethod()),
+            context,
+            Azure::Core::Diagnostics::SpanKind::Client);
+        if (span.GetSpanContext().IsValid())
+        {
+          request.SetHeader("traceparent", span.GetSpanContext().ToTraceParent());
+          span.SetRetryCount((std::max)(0, RetryPolicy::GetRetryCount(context)));
+        }
+
+        // The transport starts no span, so the try doesn't need a context with its span.
+        auto response = nextPolicy.Send(request, context);
+        if (response)
+        {
+          span.SetStatusCode(response->GetStatusCode());
+        }
+        return response;
+      }
+
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override
+      {
+        SendAsyncWith(request, nextPolicy, context, std::move(callback));
+      }
+
+      /**
+       * @brief Applies this policy without waiting for the response, as part of a
+       * #ComposedHttpPolicy.
+       *
+       */
+      template <class NextPolicy>
+      void SendAsyncWith(
+          Request& request,
+          NextPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const
+      {
+        std::shared_ptr<_detail::AsyncSpan> span;
+        try
+        {
+          span = std::make_shared<_detail::AsyncSpan>(
+              _detail::GetSpanName(request.GetMethod()),
+              context,
+              Azure::Core::Diagnostics::SpanKind::Client);
+          if (span->Span.GetSpanContext().IsValid())
+          {
+            request.SetHeader("traceparent", span->Span.GetSpanContext().ToTraceParent());
+            span->Span.SetRetryCount((std::max)(0, RetryPolicy::GetRetryCount(context)));
+          }
+        }
+        catch (...)
+        {
+          callback(nullptr, std::current_exception());
+          return;
+        }
+
+        nextPolicy.SendAsync(
+            request,
+            context,
+            [span, callback](std::unique_ptr<RawResponse> response, std::exception_ptr error) {
+              span->End(response.get());
+              callback(std::move(response), std::move(error));
+            });
+      }
+    };
+
+    /**
+     * @brief HTTP metrics policy.
+     *
+     * @details Measures each request, including its retries, and passes its
+     * #Azure::Core::Diagnostics::RequestMetrics to the listener of
+     * #Azure::Core::Http::Policies::MetricsOptions. It is paired with a #TransferMetricsPolicy
+     * sitting right above the transport, which measures the tries of the request.
+     */
+    class MetricsPolicy final : public HttpPolicy {
+    private:
+      std::string m_clientName;
+      MetricsOptions m_options;
+
+    public:
+      /**
+       * @brief Constructs HTTP metrics policy.
+       *
+       * @param clientName The name of the client, in the metrics.
+       * @param options #Azure::Core::Http::Policies::MetricsOptions.
+       */
+      explicit MetricsPolicy(std::string clientName, MetricsOptions options)
+          : m_clientName(std::move(clientName)), m_options(std::move(options))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MetricsPolicy>(*this);
+      }
+
+      std::unique_ptr<RawResponse> Send(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context) const override;
+    };
+
+    /**
+     * @brief HTTP transfer metrics policy.
+     *
+     * @details Measures each try of a request for the #MetricsPolicy above it, and lets the
+     * transport report how the connection was opened. It does nothing for a request sent without
+     * a #MetricsPolicy.
+     */
+    class TransferMetricsPolicy final : public HttpPolicy {
+    public:
+      /**
+       * @brief Constructs HTTP transfer metrics policy.
+       *
+       */
+      explicit TransferMetricsPolicy() {}
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<TransferMetricsPolicy>(*this);
+      }
+
       std::unique_ptr<RawResponse> Send(
           Request& request,
           NextHttpPolicy nextPolicy,
@@ -467,13 +1382,15 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
      */
     class LogPolicy final : public HttpPolicy {
       LogOptions m_options;
+      // The allowed query parameters are URL-encoded once, instead of for every logged request.
+      std::set<std::string> m_encodedAllowedHttpQueryParameters;
 
     public:
       /**
        * @brief Constructs HTTP logging policy.
        *
        */
-      explicit LogPolicy(LogOptions options) : m_options(std::move(options)) {}
+      explicit LogPolicy(LogOptions options);
 
       std::unique_ptr<HttpPolicy> Clone() const override
       {
@@ -484,6 +1401,12 @@ namespace Azure { namespace Core { namespace Http { namespace Policies {
           Request& request,
           NextHttpPolicy nextPolicy,
           Context const& context) const override;
+
+      void SendAsync(
+          Request& request,
+          NextHttpPolicy nextPolicy,
+          Context const& context,
+          ResponseCallback callback) const override;
     };
   } // namespace _internal
 }}}} // namespace Azure::Core::Http::Policies
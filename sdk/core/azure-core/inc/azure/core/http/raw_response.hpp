@@ -17,11 +17,17 @@
 #include <vector>
 
 namespace Azure { namespace Core { namespace Http {
+  namespace _detail {
+    struct RawResponseHelpers;
+  } // namespace _detail
+
   /**
    * @brief After receiving and interpreting a request message, a server responds with an HTTP
    * response message.
    */
   class RawResponse final {
+    // Lets the transport adapters move parsed headers into the response without copying them.
+    friend struct Azure::Core::Http::_detail::RawResponseHelpers;
 
   private:
     int32_t m_majorVersion;
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief The traffic classes of the requests, which let interactive requests go before bulk
+ * transfers sharing the same connections.
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/nullable.hpp"
+
+namespace Azure { namespace Core { namespace Http {
+
+  /**
+   * @brief The priority of a request relative to the other requests of the process.
+   *
+   */
+  enum class TrafficClass
+  {
+    /**
+     * @brief A request whose latency matters, such as the operations on metadata. The requests are
+     * interactive unless they are marked otherwise.
+     *
+     */
+    Interactive,
+
+    /**
+     * @brief A request of a bulk transfer, such as the chunks of a large upload or download, which
+     * yields to the interactive requests: it waits while interactive requests are waiting for the
+     * same capacity, and it doesn't take the connections reserved for them.
+     *
+     */
+    Bulk,
+  };
+
+  /**
+   * @brief Creates a context whose requests are sent with \p trafficClass.
+   *
+   * @remark The traffic class of a context replaces the one of the client options.
+   *
+   * @param context The context to create the child of.
+   * @param trafficClass The traffic class of the requests sent with the context returned.
+   */
+  Context WithTrafficClass(Context const& context, TrafficClass trafficClass);
+
+  /**
+   * @brief Gets the traffic class of the requests sent with \p context.
+   *
+   * @return The traffic class, or null when neither \p context nor its parents have one, in which
+   * case the requests are #Azure::Core::Http::TrafficClass::Interactive.
+   */
+  Azure::Nullable<TrafficClass> GetTrafficClass(Context const& context);
+
+}}} // namespace Azure::Core::Http
@@ -11,8 +11,93 @@
 #include "azure/core/context.hpp"
 #include "azure/core/http/http.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
 namespace Azure { namespace Core { namespace Http {
 
+  /**
+   * @brief The state and the usage counters of the connections of a transport to one host.
+   *
+   */
+  struct ConnectionPoolHostStatistics final
+  {
+    /**
+     * @brief The number of connections waiting in the pool to be re-used.
+     *
+     */
+    size_t IdleConnections = 0;
+
+    /**
+     * @brief The number of open connections used by a request, or by the body of its response.
+     *
+     */
+    size_t ActiveConnections = 0;
+
+    /**
+     * @brief The number of requests sent on a connection opened by an earlier request.
+     *
+     */
+    uint64_t ReusedConnections = 0;
+
+    /**
+     * @brief The number of connections opened, by requests or by a warm up.
+     *
+     */
+    uint64_t CreatedConnections = 0;
+
+    /**
+     * @brief The number of connections closed by the pool because they were idle for too long,
+     * the server closed them, the pool was full or a reset was requested.
+     *
+     */
+    uint64_t EvictedConnections = 0;
+
+    /**
+     * @brief The time spent opening the connections, from the DNS resolution to the end of the TCP
+     * and TLS handshakes, summed over all the connections created.
+     *
+     */
+    std::chrono::microseconds HandshakeTime{0};
+  };
+
+  /**
+   * @brief A snapshot of the connection pool of a transport, for monitoring how well the
+   * connections are re-used.
+   *
+   * @remark The counters are summed since the start of the pool. The transports sharing a pool
+   * report the same statistics.
+   */
+  struct ConnectionPoolStatistics final
+  {
+    /**
+     * @brief The statistics of each host, by scheme, host name and port, for example
+     * `https://account.blob.core.windows.net:443`.
+     *
+     */
+    std::map<std::string, ConnectionPoolHostStatistics> Hosts;
+
+    /**
+     * @brief The time the requests spent waiting for another thread to release the lock of the
+     * pool, summed over all the requests.
+     *
+     */
+    std::chrono::microseconds LockWaitTime{0};
+  };
+
+  /**
+   * @brief Receives the result of an HTTP request sent asynchronously: either the response, or the
+   * exception the request failed with and a null response.
+   *
+   * @remark It is called once, from the thread completing the request, so it must not block.
+   */
+  using ResponseCallback = std::function<void(std::unique_ptr<RawResponse>, std::exception_ptr)>;
+
   /**
    * @brief Base class for all HTTP transport implementations.
    */
@@ -31,6 +116,25 @@ namespace Azure { namespace Core { namespace Http {
     // TODO - Should this be const
     virtual std::unique_ptr<RawResponse> Send(Request& request, Context const& context) = 0;
 
+    /**
+     * @brief Send an HTTP request over the wire, and call \p callback with its response.
+     *
+     * @details The response body is read to the end before \p callback is called, unless the
+     * request doesn't buffer its response and the response status code is under 300, like
+     * #Azure::Core::Http::Policies::_internal::TransportPolicy does.
+     *
+     * @remark The default implementation calls #Send() and reads the response body on the calling
+     * thread, which is blocked until then. A transport driving its requests from its own threads,
+     * like #Azure::Core::Http::CurlMultiTransport, returns right away instead. The \p request must
+     * stay alive until \p callback is called. This function never throws, the errors are passed to
+     * \p callback.
+     *
+     * @param request An #Azure::Core::Http::Request to send.
+     * @param context A context to control the request lifetime.
+     * @param callback Called with the response, or with the exception the request failed with.
+     */
+    virtual void SendAsync(Request& request, Context const& context, ResponseCallback callback);
+
     /**
      * @brief Destructs `%HttpTransport`.
      *
@@ -24,6 +24,13 @@
 #include <windows.h>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <type_traits>
 #include <vector>
 #include <winhttp.h>
@@ -35,43 +42,81 @@ namespace Azure { namespace Core { namespace Http {
     constexpr static size_t DefaultUploadChunkSize = 1024 * 64;
     constexpr static size_t MaximumUploadChunkSize = 1024 * 1024;
 
+    // The number of upload buffers kept by a transport for the next requests.
+    constexpr static size_t MaxPooledUploadBuffers = 16;
+
+    // The number of connection handles kept by a transport by default.
+    constexpr static size_t DefaultMaxConnectionHandles = 64;
+
+    // A WinHTTP session or connection handle, shared by the requests using it and closed once the
+    // last of them is done with it.
+    class WinHttpSharedHandle final {
+    private:
+      HINTERNET m_handle;
+      // The session of a connection, closed after it.
+      std::shared_ptr<WinHttpSharedHandle> m_parent;
+
+    public:
+      explicit WinHttpSharedHandle(
+          HINTERNET handle,
+          std::shared_ptr<WinHttpSharedHandle> parent = nullptr)
+          : m_handle(handle), m_parent(std::move(parent))
+      {
+      }
+
+      WinHttpSharedHandle(WinHttpSharedHandle const&) = delete;
+      WinHttpSharedHandle& operator=(WinHttpSharedHandle const&) = delete;
+
+      ~WinHttpSharedHandle() { WinHttpCloseHandle(m_handle); }
+
+      HINTERNET Get() const { return m_handle; }
+    };
+
+    // The statistics of the connections of a transport, shared with its requests, which may
+    // outlive it.
+    struct WinHttpConnectionStatistics final
+    {
+      std::mutex Mutex;
+      // By scheme, host name and port.
+      std::map<std::string, ConnectionPoolHostStatistics> Hosts;
+      // Total time, in nanoseconds, the requests waited for the connection handles.
+      std::atomic<std::chrono::nanoseconds::rep> LockWaitTime{0};
+    };
+
+    // The completion of the asynchronous operation in progress on a request handle.
+    struct WinHttpAsyncState;
+
     struct HandleManager final
     {
       Context const& m_context;
       Request& m_request;
-      HINTERNET m_sessionHandle;
+      // Shared with the transport, which reuses it for the next requests to the same host.
+      std::shared_ptr<WinHttpSharedHandle> m_connection;
       HINTERNET m_connectionHandle;
       HINTERNET m_requestHandle;
+      // Set when the transport uses WinHTTP asynchronously, also referenced by the status
+      // callback until the request handle is closed.
+      std::shared_ptr<WinHttpAsyncState> m_asyncState;
+      // Counts the request as using a connection of its host until the request handle is closed.
+      std::shared_ptr<void> m_activeConnectionLease;
 
       HandleManager(Request& request, Context const& context)
           : m_request(request), m_context(context)
       {
-        m_sessionHandle = NULL;
         m_connectionHandle = NULL;
         m_requestHandle = NULL;
       }
 
       ~HandleManager()
       {
-        // Close the handles and set them to null to avoid multiple calls to WinHTT to close the
-        // handles.
+        // Close the handle and set it to null to avoid multiple calls to WinHTTP to close it. The
+        // connection handle is closed with the last request using it, once the transport has
+        // dropped it.
         if (m_requestHandle)
         {
           WinHttpCloseHandle(m_requestHandle);
           m_requestHandle = NULL;
         }
-
-        if (m_connectionHandle)
-        {
-          WinHttpCloseHandle(m_connectionHandle);
-          m_connectionHandle = NULL;
-        }
-
-        if (m_sessionHandle)
-        {
-          WinHttpCloseHandle(m_sessionHandle);
-          m_sessionHandle = NULL;
-        }
       }
     };
 
@@ -128,7 +173,33 @@ namespace Azure { namespace Core { namespace Http {
    */
   struct WinHttpTransportOptions final
   {
-    // Empty struct reserved for future options.
+    /**
+     * @brief The maximum number of connection handles kept by the transport, one per scheme, host
+     * and port. The least recently used one is dropped beyond it.
+     *
+     * @remark The requests to a host sharing its connection handle, and the transport sharing
+     * its session handle, WinHTTP keeps the connections alive and reuses their TLS sessions.
+     */
+    size_t MaxConnectionHandles = _detail::DefaultMaxConnectionHandles;
+
+    /**
+     * @brief Use WinHTTP asynchronously: the requests are sent, and their responses received and
+     * read, by the WinHTTP thread pool, which notifies the threads waiting for them.
+     *
+     * @remark A request can then be cancelled while it waits for the network, the request handle
+     * being closed as soon as its context is cancelled.
+     */
+    bool EnableAsync = false;
+
+    /**
+     * @brief The maximum number of bytes of a request body written by a single call to
+     * WinHttpWriteData.
+     *
+     * @remark The bodies read from contiguous memory, like the ones of a
+     * #Azure::Core::IO::MemoryBodyStream, are written straight from it. The other ones are copied
+     * into buffers of this size, which the transport keeps for the next requests.
+     */
+    size_t UploadChunkSize = _detail::MaximumUploadChunkSize;
   };
 
   /**
@@ -139,12 +210,42 @@ namespace Azure { namespace Core { namespace Http {
   private:
     WinHttpTransportOptions m_options;
 
-    void CreateSessionHandle(std::unique_ptr<_detail::HandleManager>& handleManager);
+    // The session handle, opened with the first request, and the connection handles from the
+    // most recently used, by scheme, host and port.
+    struct CachedConnectionHandle final
+    {
+      std::string Scheme;
+      std::string Host;
+      uint16_t Port;
+      std::shared_ptr<_detail::WinHttpSharedHandle> Handle;
+    };
+    std::mutex m_handlesMutex;
+    std::shared_ptr<_detail::WinHttpSharedHandle> m_sessionHandle;
+    std::list<CachedConnectionHandle> m_connectionHandles;
+
+    // The buffers the bodies not in contiguous memory are copied into before being written.
+    std::mutex m_uploadBuffersMutex;
+    std::vector<std::unique_ptr<uint8_t[]>> m_uploadBuffers;
+
+    std::shared_ptr<_detail::WinHttpConnectionStatistics> m_statistics
+        = std::make_shared<_detail::WinHttpConnectionStatistics>();
+
+    std::shared_ptr<_detail::WinHttpSharedHandle> CreateSessionHandle();
     void CreateConnectionHandle(std::unique_ptr<_detail::HandleManager>& handleManager);
     void CreateRequestHandle(std::unique_ptr<_detail::HandleManager>& handleManager);
-    void Upload(std::unique_ptr<_detail::HandleManager>& handleManager);
+    void Upload(std::unique_ptr<_detail::HandleManager>& handleManager, bool isChunked);
+    void WriteData(
+        std::unique_ptr<_detail::HandleManager>& handleManager,
+        uint8_t const* data,
+        size_t length);
+    void WriteChunk(
+        std::unique_ptr<_detail::HandleManager>& handleManager,
+        uint8_t const* data,
+        size_t length);
     void SendRequest(std::unique_ptr<_detail::HandleManager>& handleManager);
     void ReceiveResponse(std::unique_ptr<_detail::HandleManager>& handleManager);
+    void LeaseActiveConnection(std::unique_ptr<_detail::HandleManager>& handleManager);
+    void UpdateConnectionStatistics(std::unique_ptr<_detail::HandleManager>& handleManager);
     int64_t GetContentLength(
         std::unique_ptr<_detail::HandleManager>& handleManager,
         HttpMethod requestMethod,
@@ -173,6 +274,16 @@ namespace Azure { namespace Core { namespace Http {
      * @return A unique pointer to an HTTP RawResponse.
      */
     virtual std::unique_ptr<RawResponse> Send(Request& request, Context const& context) override;
+
+    /**
+     * @brief Gets a snapshot of the connections of the transport to each host, and of how often
+     * they were re-used.
+     *
+     * @remark WinHTTP manages its connection pool by itself. The connections are counted as
+     * created or re-used from the statistics of the requests, which need Windows 10 version 1903
+     * or later, and the idle and evicted connections aren't reported.
+     */
+    ConnectionPoolStatistics GetConnectionPoolStatistics() const;
   };
 
 }}} // namespace Azure::Core::Http
@@ -11,6 +11,7 @@
 
 #include "azure/core/http/http.hpp"
 #include "azure/core/http/policies/policy.hpp"
+#include "azure/core/http/traffic_class.hpp"
 
 #include <memory>
 #include <vector>
@@ -68,9 +69,12 @@ namespace Azure { namespace Core { namespace _internal {
     ClientOptions& operator=(const ClientOptions& other)
     {
       this->Retry = other.Retry;
+      this->Hedging = other.Hedging;
       this->Transport = other.Transport;
       this->Telemetry = other.Telemetry;
       this->Log = other.Log;
+      this->Metrics = other.Metrics;
+      this->TrafficClass = other.TrafficClass;
       this->PerOperationPolicies.reserve(other.PerOperationPolicies.size());
       for (auto& policy : other.PerOperationPolicies)
       {
@@ -90,6 +94,12 @@ namespace Azure { namespace Core { namespace _internal {
      */
     Azure::Core::Http::Policies::RetryOptions Retry;
 
+    /**
+     * @brief Specify when a duplicate of an idempotent request is sent to reduce its latency.
+     *
+     */
+    Azure::Core::Http::Policies::HedgingOptions Hedging;
+
     /**
      * @brief Customized HTTP client. We're going to use the default one if this is empty.
      *
@@ -107,6 +117,18 @@ namespace Azure { namespace Core { namespace _internal {
      *
      */
     Azure::Core::Http::Policies::LogOptions Log;
+
+    /**
+     * @brief Define where the metrics of the requests are passed to.
+     *
+     */
+    Azure::Core::Http::Policies::MetricsOptions Metrics;
+
+    /**
+     * @brief The traffic class of the requests sent by the client, unless their context has one.
+     *
+     */
+    Azure::Core::Http::TrafficClass TrafficClass = Azure::Core::Http::TrafficClass::Interactive;
   };
 
 }}} // namespace Azure::Core::_internal
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @brief Compute the HMAC-SHA256 of the input binary data with a key.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Azure { namespace Core { namespace Cryptography { namespace _internal {
+
+  /**
+   * @brief Defines #HmacSha256.
+   *
+   * @details The key is processed once, when the instance is constructed. #Reset() restores the
+   * state right after the key was processed, so computing the HMAC of other data with the same key
+   * doesn't process the key again.
+   *
+   */
+  class HmacSha256 final {
+  public:
+    /**
+     * @brief Construct an instance of #HmacSha256 for a key.
+     *
+     * @param key The pointer to the key.
+     * @param keyLength The size of the key.
+     */
+    HmacSha256(const uint8_t* key, size_t keyLength);
+
+    /**
+     * @brief Construct an instance of #HmacSha256 for a key.
+     *
+     * @param key The key.
+     */
+    explicit HmacSha256(const std::vector<uint8_t>& key) : HmacSha256(key.data(), key.size()) {}
+
+    /**
+     * @brief Construct a copy of #HmacSha256, with the same key and the same data appended.
+     *
+     * @param other The instance to copy.
+     */
+    HmacSha256(const HmacSha256& other);
+
+    HmacSha256& operator=(const HmacSha256&) = delete;
+
+    /**
+     * @brief Cleanup any state when destroying the instance of #HmacSha256.
+     *
+     */
+    ~HmacSha256();
+
+    /**
+     * @brief Used to append partial binary input data to compute the HMAC in a streaming fashion.
+     *
+     * @remark Once all the data has been added, call #Final() to get the computed HMAC.
+     *
+     * @param data The pointer to the current block of binary data that is used for the HMAC
+     * calculation.
+     * @param length The size of the data provided.
+     */
+    void Append(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Computes the HMAC of the specified binary input data, including any previously
+     * appended.
+     *
+     * @remark Call #Reset() before computing another HMAC with the instance.
+     *
+     * @param data The pointer to binary data to compute the HMAC for.
+     * @param length The size of the data provided.
+     *
+     * @return The computed HMAC corresponding to the input provided including any previously
+     * appended.
+     */
+    std::vector<uint8_t> Final(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Computes the HMAC of the previously appended data.
+     *
+     * @remark Call #Reset() before computing another HMAC with the instance.
+     *
+     * @return The computed HMAC corresponding to the input provided previously appended.
+     */
+    std::vector<uint8_t> Final() { return Final(nullptr, 0); }
+
+    /**
+     * @brief Discards the data appended, so another HMAC can be computed with the key.
+     *
+     */
+    void Reset();
+
+  private:
+    struct Impl;
+
+    /**
+     * @brief Underline implementation based on the OS.
+     *
+     */
+    std::unique_ptr<Impl> m_impl;
+    bool m_isDone = false;
+  };
+
+}}}} // namespace Azure::Core::Cryptography::_internal
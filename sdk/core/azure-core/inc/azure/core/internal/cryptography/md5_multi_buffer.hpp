@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @brief Compute the MD5 of buffers hashed by concurrent threads together.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Azure { namespace Core { namespace Cryptography { namespace _internal {
+
+  /**
+   * @brief Computes the MD5 of binary data, together with the data hashed by the other threads
+   * calling it at the same time.
+   *
+   * @details MD5 processes the blocks of a buffer one after the other, but the blocks of
+   * independent buffers can be processed at the same time. Where the CPU supports AVX2, the
+   * buffers of up to 8 concurrent calls are hashed by one of the calling threads at once, with
+   * the instructions which would hash one of them, while the other threads wait for their hash.
+   * The thread which hashes leaves as soon as its own hash is done, another waiting thread takes
+   * over. Elsewhere, and for small buffers, each call hashes its own buffer like #Md5Hash.
+   *
+   * @param data The pointer to binary data to compute the hash for.
+   * @param length The size of the data provided.
+   *
+   * @return The computed MD5 hash value corresponding to the input provided.
+   */
+  std::vector<uint8_t> ComputeMd5MultiBuffer(const uint8_t* data, size_t length);
+
+}}}} // namespace Azure::Core::Cryptography::_internal
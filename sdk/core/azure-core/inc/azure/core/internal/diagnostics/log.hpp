@@ -28,7 +28,10 @@ namespace Azure { namespace Core { namespace Diagnostics { namespace _internal {
   public:
     static bool ShouldWrite(Logger::Level level)
     {
-      return g_isLoggingEnabled && level >= g_logLevel;
+      // Called before building every log message, so it only costs a relaxed load when logging is
+      // disabled.
+      return g_isLoggingEnabled.load(std::memory_order_relaxed)
+          && level >= g_logLevel.load(std::memory_order_relaxed);
     }
 
     static void Write(Logger::Level level, std::string const& message);
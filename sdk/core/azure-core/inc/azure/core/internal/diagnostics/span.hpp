@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief A span of work traced by the SDK, see #Azure::Core::Diagnostics::Tracer.
+ *
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/diagnostics/tracing.hpp"
+#include "azure/core/dll_import_export.hpp"
+#include "azure/core/http/http_status_code.hpp"
+#include "azure/core/nullable.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Azure { namespace Core { namespace Diagnostics { namespace _internal {
+
+  /**
+   * @brief A span, from its construction until it is destroyed or #End() is called.
+   *
+   * @details The span is a child of the span of the context it is constructed with. The spans
+   * started with #GetContext() are its children.
+   *
+   * @code
+   * Span span("BlobClient.GetProperties", context);
+   * return GetPropertiesImpl(options, span.GetContext());
+   * @endcode
+   *
+   * @remark A span lives on the stack of the operation it measures. When tracing is disabled it
+   * only costs a relaxed load, and #GetContext() returns the context it was constructed with.
+   * Otherwise its only allocation is the child context carrying its #SpanContext, created by the
+   * first call to #GetContext(). A span ended by an exception has the #SpanStatus::Error status.
+   */
+  class Span final {
+    friend class Azure::Core::Diagnostics::Tracer;
+
+    static AZ_CORE_DLLEXPORT std::atomic<bool> g_isTracingEnabled;
+
+    SpanData m_data;
+    std::chrono::steady_clock::time_point m_start;
+    Context const& m_parentContext;
+    // Created by the first call to GetContext(), with the span context of this span.
+    Azure::Nullable<Context> m_context;
+    int m_uncaughtExceptions = 0;
+    bool m_isStarted = false;
+    bool m_isRecording = false;
+
+    void Start();
+    Context const& CreateContext();
+    void Export();
+
+  public:
+    /**
+     * @brief Starts a span.
+     *
+     * @param name The name of the span, a string literal.
+     * @param context The context the parent span is taken from, it must outlive the span.
+     * @param kind The role of the span.
+     */
+    Span(char const* name, Context const& context, SpanKind kind = SpanKind::Internal)
+        : m_parentContext(context)
+    {
+      if (g_isTracingEnabled.load(std::memory_order_relaxed))
+      {
+        m_data.Name = name;
+        m_data.Kind = kind;
+        Start();
+      }
+    }
+
+    // The span keeps a reference to its parent context, which can't be a temporary.
+    Span(char const* name, Context&& context, SpanKind kind = SpanKind::Internal) = delete;
+
+    Span(Span const&) = delete;
+    Span& operator=(Span const&) = delete;
+
+    /**
+     * @brief Ends the span if #End() wasn't called.
+     *
+     */
+    ~Span() { End(); }
+
+    /**
+     * @brief Gets the context to start the children of the span with.
+     *
+     * @remark The first call creates the context, so it must not be concurrent with other calls.
+     */
+    Context const& GetContext()
+    {
+      if (!m_isStarted)
+      {
+        return m_parentContext;
+      }
+      return m_context.HasValue() ? m_context.Value() : CreateContext();
+    }
+
+    /**
+     * @brief Checks whether the span is exported when it ends.
+     *
+     */
+    bool IsRecording() const { return m_isRecording; }
+
+    /**
+     * @brief Gets the identifiers of the span, all zeros when tracing is disabled.
+     *
+     */
+    SpanContext const& GetSpanContext() const { return m_data.Context; }
+
+    /**
+     * @brief Sets the status code of the response of the HTTP request of the span.
+     *
+     */
+    void SetStatusCode(Azure::Core::Http::HttpStatusCode statusCode)
+    {
+      m_data.StatusCode = statusCode;
+      if (static_cast<int>(statusCode) >= 400)
+      {
+        m_data.Status = SpanStatus::Error;
+      }
+    }
+
+    /**
+     * @brief Sets the number of times the HTTP request of the span was tried before.
+     *
+     */
+    void SetRetryCount(int32_t retryCount) { m_data.RetryCount = retryCount; }
+
+    /**
+     * @brief Marks the work of the span as failed.
+     *
+     */
+    void SetError() { m_data.Status = SpanStatus::Error; }
+
+    /**
+     * @brief Ends the span, and passes it to the exporter if it is recording.
+     *
+     */
+    void End()
+    {
+      if (m_isRecording)
+      {
+        Export();
+      }
+    }
+  };
+
+}}}} // namespace Azure::Core::Diagnostics::_internal
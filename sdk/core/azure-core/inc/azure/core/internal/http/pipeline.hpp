@@ -12,9 +12,13 @@
 #include "azure/core/context.hpp"
 #include "azure/core/http/http.hpp"
 #include "azure/core/http/policies/policy.hpp"
+#include "azure/core/http/traffic_class.hpp"
 #include "azure/core/http/transport.hpp"
 #include "azure/core/internal/client_options.hpp"
+#include "azure/core/internal/strings.hpp"
 
+#include <exception>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -32,6 +36,11 @@ namespace Azure { namespace Core { namespace Http { namespace _internal {
   class HttpPipeline final {
   protected:
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> m_policies;
+    // The headers sent with every request, such as the User-Agent, shared by the requests instead
+    // of being set on each of them by a policy.
+    std::shared_ptr<CaseInsensitiveMap const> m_staticHeaders;
+    // The traffic class of the requests whose context has none.
+    TrafficClass m_trafficClass = TrafficClass::Interactive;
 
   public:
     /**
@@ -68,24 +77,60 @@ namespace Azure { namespace Core { namespace Http { namespace _internal {
      * @param telemetryServiceVersion The version of the service for sending telemetry.
      * @param perRetryPolicies The service-specific per retry policies.
      * @param perCallPolicies The service-specific per call policies.
+     * @param staticHeaders The headers sent with every request, such as the version of the service
+     * API. They are shared by the requests instead of being set by a policy, and the headers set
+     * on a request replace them. The User-Agent telemetry header is added to them.
+     *
+     * @throw if the name of a static header is invalid.
      */
     explicit HttpPipeline(
         Azure::Core::_internal::ClientOptions const& clientOptions,
         std::string const& telemetryServiceName,
         std::string const& telemetryServiceVersion,
         std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>&& perRetryPolicies,
-        std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>&& perCallPolicies)
+        std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>&& perCallPolicies,
+        CaseInsensitiveMap const& staticHeaders = CaseInsensitiveMap())
     {
+      auto headers = std::make_shared<CaseInsensitiveMap>();
+      for (auto const& header : staticHeaders)
+      {
+        Azure::Core::Http::_detail::RawResponseHelpers::InsertHeaderWithValidation(
+            *headers,
+            Azure::Core::_internal::StringExtensions::ToLower(header.first),
+            header.second);
+      }
+      headers->emplace(
+          "user-agent",
+          Azure::Core::Http::Policies::_internal::TelemetryPolicy::BuildTelemetryId(
+              telemetryServiceName,
+              telemetryServiceVersion,
+              clientOptions.Telemetry.ApplicationId));
+      m_staticHeaders = std::move(headers);
+      m_trafficClass = clientOptions.TrafficClass;
+
       auto const& perCallClientPolicies = clientOptions.PerOperationPolicies;
       auto const& perRetryClientPolicies = clientOptions.PerRetryPolicies;
-      // Adding 5 for:
-      // - TelemetryPolicy
-      // - RequestIdPolicy
+      // Adding 7 for:
+      // - RequestIdPolicy and TracingPolicy
+      // - MetricsPolicy
       // - RetryPolicy
+      // - HedgingPolicy
       // - LogPolicy
-      // - TransportPolicy
+      // - TransferMetricsPolicy
+      // - TryTracingPolicy and TransportPolicy
       auto pipelineSize = perCallClientPolicies.size() + perRetryClientPolicies.size()
-          + perRetryPolicies.size() + perCallPolicies.size() + 5;
+          + perRetryPolicies.size() + perCallPolicies.size() + 7;
+      // The policies always next to each other are composed, so they call each other directly
+      // instead of through a virtual call each.
+      using RequestPolicies = Azure::Core::Http::Policies::_internal::ComposedHttpPolicy<
+          Azure::Core::Http::Policies::_internal::RequestIdPolicy,
+          Azure::Core::Http::Policies::_internal::TracingPolicy>;
+      using TryPolicies = Azure::Core::Http::Policies::_internal::ComposedHttpPolicy<
+          Azure::Core::Http::Policies::_internal::TryTracingPolicy,
+          Azure::Core::Http::Policies::_internal::TransportPolicy>;
+
+      // Metrics are only collected when there is a listener for them.
+      bool const hasMetrics = static_cast<bool>(clientOptions.Metrics.Listener);
 
       m_policies.reserve(pipelineSize);
 
@@ -96,12 +141,20 @@ namespace Azure { namespace Core { namespace Http { namespace _internal {
       }
 
       // Request Id
-      m_policies.emplace_back(
-          std::make_unique<Azure::Core::Http::Policies::_internal::RequestIdPolicy>());
       // Telemetry
-      m_policies.emplace_back(
-          std::make_unique<Azure::Core::Http::Policies::_internal::TelemetryPolicy>(
-              telemetryServiceName, telemetryServiceVersion, clientOptions.Telemetry));
+
+      // Tracing, the span of the request is the parent of the spans of its tries.
+      m_policies.emplace_back(std::make_unique<RequestPolicies>(
+          Azure::Core::Http::Policies::_internal::RequestIdPolicy(),
+          Azure::Core::Http::Policies::_internal::TracingPolicy()));
+
+      // Metrics, measuring the time taken by the retries and by the client policies.
+      if (hasMetrics)
+      {
+        m_policies.emplace_back(
+            std::make_unique<Azure::Core::Http::Policies::_internal::MetricsPolicy>(
+                telemetryServiceName, clientOptions.Metrics));
+      }
 
       // client-options per call policies.
       for (auto& policy : perCallClientPolicies)
@@ -113,6 +166,14 @@ namespace Azure { namespace Core { namespace Http { namespace _internal {
       m_policies.emplace_back(std::make_unique<Azure::Core::Http::Policies::_internal::RetryPolicy>(
           clientOptions.Retry));
 
+      // Hedging policy, every try of a request is hedged.
+      if (clientOptions.Hedging.Enabled)
+      {
+        m_policies.emplace_back(
+            std::make_unique<Azure::Core::Http::Policies::_internal::HedgingPolicy>(
+                clientOptions.Hedging));
+      }
+
       // service-specific per retry policies.
       for (auto& policy : perRetryPolicies)
       {
@@ -128,10 +189,18 @@ namespace Azure { namespace Core { namespace Http { namespace _internal {
       m_policies.emplace_back(
           std::make_unique<Azure::Core::Http::Policies::_internal::LogPolicy>(clientOptions.Log));
 
+      // Metrics of each try, measured as close as possible to the transport.
+      if (hasMetrics)
+      {
+        m_policies.emplace_back(
+            std::make_unique<Azure::Core::Http::Policies::_internal::TransferMetricsPolicy>());
+      }
+
+      // Tracing of each try, the span sent in the traceparent header.
       // transport
-      m_policies.emplace_back(
-          std::make_unique<Azure::Core::Http::Policies::_internal::TransportPolicy>(
-              clientOptions.Transport));
+      m_policies.emplace_back(std::make_unique<TryPolicies>(
+          Azure::Core::Http::Policies::_internal::TryTracingPolicy(),
+          Azure::Core::Http::Policies::_internal::TransportPolicy(clientOptions.Transport)));
     }
 
     /**
@@ -161,6 +230,7 @@ namespace Azure { namespace Core { namespace Http { namespace _internal {
      * of.
      */
     HttpPipeline(const HttpPipeline& other)
+        : m_staticHeaders(other.m_staticHeaders), m_trafficClass(other.m_trafficClass)
     {
       m_policies.reserve(other.m_policies.size());
       for (auto& policy : other.m_policies)
@@ -181,10 +251,101 @@ namespace Azure { namespace Core { namespace Http { namespace _internal {
         Azure::Core::Http::Request& request,
         Context const& context) const
     {
+      if (m_staticHeaders)
+      {
+        Azure::Core::Http::_detail::RequestHelpers::SetStaticHeaders(request, m_staticHeaders);
+      }
       // Accessing position zero is fine because pipeline must be constructed with at least one
       // policy.
+      if (m_trafficClass != TrafficClass::Interactive && !GetTrafficClass(context).HasValue())
+      {
+        return m_policies[0]->Send(
+            request,
+            Azure::Core::Http::Policies::NextHttpPolicy(0, m_policies),
+            WithTrafficClass(context, m_trafficClass));
+      }
       return m_policies[0]->Send(
           request, Azure::Core::Http::Policies::NextHttpPolicy(0, m_policies), context);
     }
+
+    /**
+     * @brief Start the HTTP pipeline without waiting for the response.
+     *
+     * @details The request goes through the same policies as
+     * #Azure::Core::Http::_internal::HttpPipeline::Send(), and \p callback is called with the
+     * response, or with the exception #Send() would throw. With a transport completing its
+     * requests from its own threads, like #Azure::Core::Http::CurlMultiTransport, no thread waits
+     * for the response: the callback is called from the thread of the transport, and the retries
+     * are sent from a thread of the SDK.
+     *
+     * @remark A policy which doesn't implement
+     * #Azure::Core::Http::Policies::HttpPolicy::SendAsync() blocks the thread sending the request,
+     * this one or the one sending a retry, until its response is received. The \p request and the
+     * pipeline must stay alive until \p callback is called. The callback must not block, nor read
+     * the body stream of a response which isn't buffered.
+     *
+     * @param request The HTTP request to be processed.
+     * @param context A context to control the request lifetime.
+     * @param callback Called with the HTTP response, or with the exception the request failed with.
+     */
+    void SendAsync(
+        Azure::Core::Http::Request& request,
+        Context const& context,
+        Azure::Core::Http::ResponseCallback callback) const
+    {
+      if (m_staticHeaders)
+      {
+        Azure::Core::Http::_detail::RequestHelpers::SetStaticHeaders(request, m_staticHeaders);
+      }
+      if (m_trafficClass != TrafficClass::Interactive && !GetTrafficClass(context).HasValue())
+      {
+        m_policies[0]->SendAsync(
+            request,
+            Azure::Core::Http::Policies::NextHttpPolicy(0, m_policies),
+            WithTrafficClass(context, m_trafficClass),
+            std::move(callback));
+        return;
+      }
+      m_policies[0]->SendAsync(
+          request,
+          Azure::Core::Http::Policies::NextHttpPolicy(0, m_policies),
+          context,
+          std::move(callback));
+    }
+
+    /**
+     * @brief Start the HTTP pipeline without waiting for the response.
+     *
+     * @details Like the overload with a callback, the returned future becomes ready with the
+     * response, or with the exception the request failed with.
+     *
+     * @param request The HTTP request to be processed.
+     * @param context A context to control the request lifetime.
+     *
+     * @return A future for the HTTP response after the request has been processed.
+     */
+    std::future<std::unique_ptr<Azure::Core::Http::RawResponse>> SendAsync(
+        Azure::Core::Http::Request& request,
+        Context const& context) const
+    {
+      auto promise
+          = std::make_shared<std::promise<std::unique_ptr<Azure::Core::Http::RawResponse>>>();
+      auto future = promise->get_future();
+      SendAsync(
+          request,
+          context,
+          [promise](
+              std::unique_ptr<Azure::Core::Http::RawResponse> response, std::exception_ptr error) {
+            if (error)
+            {
+              promise->set_exception(std::move(error));
+            }
+            else
+            {
+              promise->set_value(std::move(response));
+            }
+          });
+      return future;
+    }
   };
 }}}} // namespace Azure::Core::Http::_internal
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <string>
 
 namespace Azure { namespace Core { namespace _internal {
@@ -21,13 +22,44 @@ namespace Azure { namespace Core { namespace _internal {
   {
     struct CaseInsensitiveComparator final
     {
+      /**
+       * @brief Lets a CaseInsensitiveMap or CaseInsensitiveSet find a key from a C string, such
+       * as a header name literal, without constructing a `std::string` for it.
+       */
+      using is_transparent = void;
+
       bool operator()(const std::string& lhs, const std::string& rhs) const
       {
+        return Less(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+      }
+
+      bool operator()(const std::string& lhs, const char* rhs) const
+      {
+        return Less(lhs.data(), lhs.size(), rhs, std::char_traits<char>::length(rhs));
+      }
+
+      bool operator()(const char* lhs, const std::string& rhs) const
+      {
+        return Less(lhs, std::char_traits<char>::length(lhs), rhs.data(), rhs.size());
+      }
+
+    private:
+      static bool Less(const char* lhs, size_t lhsSize, const char* rhs, size_t rhsSize)
+      {
+        // The comparison is done inline instead of calling ToLower() for each character since it
+        // runs for every lookup and insertion in a CaseInsensitiveMap, for example the headers of
+        // every request and response. It lowercases the same characters as ToLower().
         return std::lexicographical_compare(
-            lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char c1, char c2) {
-              return ToLower(c1) < ToLower(c2);
+            lhs, lhs + lhsSize, rhs, rhs + rhsSize, [](char c1, char c2) {
+              return AsciiToLower(static_cast<unsigned char>(c1))
+                  < AsciiToLower(static_cast<unsigned char>(c2));
             });
       }
+
+      static constexpr unsigned char AsciiToLower(unsigned char c) noexcept
+      {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+      }
     };
 
     static bool LocaleInvariantCaseInsensitiveEqual(
@@ -26,6 +26,25 @@
 
 namespace Azure { namespace Core { namespace IO {
 
+  /**
+   * @brief One of the buffers a vectored read fills, in order.
+   *
+   */
+  struct ReadBuffer final
+  {
+    /**
+     * @brief Pointer to the first byte of the buffer.
+     *
+     */
+    uint8_t* Data;
+
+    /**
+     * @brief Size of the buffer.
+     *
+     */
+    size_t Count;
+  };
+
   /**
    * @brief Used to read data to/from a service.
    */
@@ -44,6 +63,49 @@ namespace Azure { namespace Core { namespace IO {
      */
     virtual size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) = 0;
 
+    /**
+     * @brief Read portion of data without copying it.
+     *
+     * @remark Derived classes that return `true` from
+     * #Azure::Core::IO::BodyStream::SupportsContiguousRead() MUST override this.
+     *
+     * @param data Set to the first byte of the data read.
+     * @param count Maximum number of bytes to read.
+     * @param context A context to control the request lifetime.
+     *
+     * @return Number of bytes read.
+     */
+    virtual size_t OnReadContiguous(
+        uint8_t const** data,
+        size_t count,
+        Azure::Core::Context const& context)
+    {
+      (void)data;
+      (void)count;
+      (void)context;
+      _azure_ASSERT_MSG(
+          false, "The specified BodyStream doesn't support reading from contiguous memory.");
+      return 0;
+    }
+
+    /**
+     * @brief Read portion of data into several buffers, filling each one before the next.
+     *
+     * @remark The default implementation reads into each buffer with
+     * #Azure::Core::IO::BodyStream::OnRead(), until a buffer isn't filled. Derived classes
+     * wrapping another stream override it to forward the buffers at once.
+     *
+     * @param buffers The buffers to read the data into.
+     * @param bufferCount The number of buffers.
+     * @param context A context to control the request lifetime.
+     *
+     * @return Number of bytes read, in all the buffers.
+     */
+    virtual size_t OnReadV(
+        ReadBuffer const* buffers,
+        size_t bufferCount,
+        Azure::Core::Context const& context);
+
   public:
     /**
      * @brief Destructs `%BodyStream`.
@@ -54,6 +116,9 @@ namespace Azure { namespace Core { namespace IO {
     /**
      * @brief Get the length of the data.
      * @remark Used with the HTTP `Content-Length` header.
+     * @remark A stream whose length isn't known before it's read to the end returns `-1`. The
+     * transports send such a request body with chunked `Transfer-Encoding`, so it's only meant for
+     * the services and operations accepting it.
      */
     virtual int64_t Length() const = 0;
 
@@ -68,7 +133,7 @@ namespace Azure { namespace Core { namespace IO {
           false,
           "The specified BodyStream doesn't support Rewind which is required to guarantee fault "
           "tolerance when retrying any operation. Consider creating a MemoryBodyStream or "
-          "FileBodyStream, which are rewindable.");
+          "FileBodyStream, which are rewindable, or wrapping it in a RewindableBodyStream.");
     }
 
     /**
@@ -92,6 +157,62 @@ namespace Azure { namespace Core { namespace IO {
       return OnRead(buffer, count, context);
     }
 
+    /**
+     * @brief Read portion of data into several buffers, filling each one before the next.
+     * @remark Throws if error/cancelled.
+     *
+     * @remark Like #Azure::Core::IO::BodyStream::Read(), it may read less than the size of the
+     * buffers before the end of the stream, but it only returns 0 at the end of the stream.
+     *
+     * @param buffers The buffers to read the data into.
+     * @param bufferCount The number of buffers.
+     * @param context A context to control the request lifetime.
+     *
+     * @return Number of bytes read, in all the buffers.
+     */
+    size_t ReadV(
+        ReadBuffer const* buffers,
+        size_t bufferCount,
+        Azure::Core::Context const& context = Azure::Core::Context())
+    {
+      _azure_ASSERT(buffers || bufferCount == 0);
+
+      context.ThrowIfCancelled();
+      return OnReadV(buffers, bufferCount, context);
+    }
+
+    /**
+     * @brief Checks if the data of the stream lives in addressable memory that can be read with
+     * #Azure::Core::IO::BodyStream::ReadContiguous().
+     *
+     */
+    virtual bool SupportsContiguousRead() const { return false; }
+
+    /**
+     * @brief Read portion of data without copying it into a buffer.
+     * @remark Throws if error/cancelled.
+     *
+     * @remark Only valid when #Azure::Core::IO::BodyStream::SupportsContiguousRead() returns
+     * `true`. The data pointed by \p data stays valid for as long as the memory backing the
+     * stream.
+     *
+     * @param data Set to the first byte of the data read.
+     * @param count Maximum number of bytes to read.
+     * @param context A context to control the request lifetime.
+     *
+     * @return Number of bytes read.
+     */
+    size_t ReadContiguous(
+        uint8_t const** data,
+        size_t count,
+        Azure::Core::Context const& context = Azure::Core::Context())
+    {
+      _azure_ASSERT(data);
+
+      context.ThrowIfCancelled();
+      return OnReadContiguous(data, count, context);
+    }
+
     /**
      * @brief Read #Azure::Core::IO::BodyStream into a buffer until the buffer is filled, or until
      * the stream is read to end.
@@ -123,12 +244,19 @@ namespace Azure { namespace Core { namespace IO {
    */
   class MemoryBodyStream final : public BodyStream {
   private:
+    // Keeps the data alive when the stream shares its ownership, null otherwise.
+    std::shared_ptr<const void> m_owner;
     const uint8_t* m_data;
     size_t m_length;
     size_t m_offset = 0;
 
     size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
 
+    size_t OnReadContiguous(
+        uint8_t const** data,
+        size_t count,
+        Azure::Core::Context const& context) override;
+
   public:
     // Forbid constructor for rval so we don't end up storing dangling ptr
     MemoryBodyStream(std::vector<uint8_t> const&&) = delete;
@@ -155,9 +283,55 @@ namespace Azure { namespace Core { namespace IO {
       _azure_ASSERT(data || length == 0);
     }
 
+    /**
+     * @brief Construct sharing the ownership of an immutable buffer, so that the streams over the
+     * same data, like the ones of the retries or of the concurrent uploads of its parts, don't
+     * copy it.
+     *
+     * @param buffer The buffer with the contents to provide the data from to the readers.
+     */
+    explicit MemoryBodyStream(std::shared_ptr<const std::vector<uint8_t>> buffer)
+        : m_owner(buffer), m_data(buffer ? buffer->data() : nullptr),
+          m_length(buffer ? buffer->size() : 0)
+    {
+    }
+
+    /**
+     * @brief Construct sharing the ownership of an immutable buffer.
+     *
+     * @param data The first byte of the buffer with the contents to provide the data from to the
+     * readers, owning the buffer.
+     * @param length Size of the buffer.
+     */
+    explicit MemoryBodyStream(std::shared_ptr<const uint8_t> data, size_t length)
+        : m_owner(data), m_data(data.get()), m_length(length)
+    {
+      _azure_ASSERT(m_data || length == 0);
+    }
+
+    /**
+     * @brief Creates a stream over a part of the data of this one, from its start. The new
+     * stream shares the ownership of the data, if this one does, and starts at its beginning.
+     *
+     * @param offset The offset of the part in the data of this stream.
+     * @param length The size of the part.
+     *
+     * @return A stream over the part of the data.
+     */
+    MemoryBodyStream Slice(size_t offset, size_t length) const
+    {
+      _azure_ASSERT(offset <= m_length && length <= m_length - offset);
+
+      MemoryBodyStream slice(m_data + offset, length);
+      slice.m_owner = m_owner;
+      return slice;
+    }
+
     int64_t Length() const override { return this->m_length; }
 
     void Rewind() override { m_offset = 0; }
+
+    bool SupportsContiguousRead() const override { return true; }
   };
 
   namespace _internal {
@@ -177,6 +351,10 @@ namespace Azure { namespace Core { namespace IO {
       int64_t m_length;
       // mutable
       int64_t m_offset;
+      // The end of the data the operating system was asked to read ahead, from the base offset.
+      int64_t m_readAheadOffset = 0;
+
+      void ReadAhead();
 
       size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
 
@@ -233,7 +411,11 @@ namespace Azure { namespace Core { namespace IO {
 #endif
 
       // Rewind seeks back to 0
-      void Rewind() override { this->m_offset = 0; }
+      void Rewind() override
+      {
+        this->m_offset = 0;
+        this->m_readAheadOffset = 0;
+      }
 
       int64_t Length() const override { return this->m_length; }
     };
@@ -295,6 +477,10 @@ namespace Azure { namespace Core { namespace IO {
 
   private:
     size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+    size_t OnReadV(
+        ReadBuffer const* buffers,
+        size_t bufferCount,
+        Azure::Core::Context const& context) override;
 
   public:
     /**
@@ -315,4 +501,63 @@ namespace Azure { namespace Core { namespace IO {
 
     int64_t Length() const override;
   };
+
+  /**
+   * @brief A concrete implementation of #Azure::Core::IO::BodyStream that makes a forward-only
+   * stream rewindable, so that the requests sending it can be retried.
+   *
+   * @remark The data read from the wrapped stream is kept in memory, up to a maximum size, and the
+   * rest in a temporary file. After a rewind, the data kept is read again before the rest of the
+   * wrapped stream.
+   */
+  class RewindableBodyStream final : public BodyStream {
+  private:
+    BodyStream* m_bodyStream;
+    size_t m_maxMemoryBufferSize;
+    // The first bytes read from the wrapped stream, up to the maximum size.
+    std::vector<uint8_t> m_memoryBuffer;
+    // The bytes read from the wrapped stream after the ones of the memory buffer.
+    std::FILE* m_file = nullptr;
+    int64_t m_fileLength = 0;
+    // Whether the file was read since it was last written to.
+    bool m_isFileRead = false;
+    int64_t m_offset = 0;
+
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+
+  public:
+    /**
+     * @brief The default maximum size of the data kept in memory, in bytes.
+     *
+     */
+    static constexpr size_t DefaultMaxMemoryBufferSize = 4 * 1024 * 1024;
+
+    /**
+     * @brief Constructs `%RewindableBodyStream` from a %BodyStream.
+     *
+     * @param bodyStream The body stream to wrap, which doesn't need to support rewinding.
+     * @param maxMemoryBufferSize The maximum size of the data kept in memory, in bytes. The data
+     * read after it is kept in a temporary file.
+     *
+     * @remark The #Azure::Core::IO::RewindableBodyStream does not own the wrapped stream
+     * and is not responsible for closing / cleaning up resources.
+     */
+    explicit RewindableBodyStream(
+        BodyStream& bodyStream,
+        size_t maxMemoryBufferSize = DefaultMaxMemoryBufferSize);
+
+    /**
+     * @brief Removes the temporary file, if any.
+     *
+     */
+    ~RewindableBodyStream();
+
+    RewindableBodyStream(RewindableBodyStream const&) = delete;
+    RewindableBodyStream& operator=(RewindableBodyStream const&) = delete;
+
+    // Rewind reads the kept data again from its start
+    void Rewind() override;
+
+    int64_t Length() const override { return m_bodyStream->Length(); }
+  };
 }}} // namespace Azure::Core::IO
@@ -9,16 +9,52 @@
 #pragma once
 
 #include "azure/core/context.hpp"
+#include "azure/core/http/raw_response.hpp"
 #include "azure/core/operation_status.hpp"
 #include "azure/core/response.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
 #include <string>
 
 namespace Azure { namespace Core {
 
+  namespace _internal {
+    /**
+     * @brief The longest wait between two polls of a long-running operation backing off, unless
+     * the period asked for by the caller is longer.
+     *
+     */
+    constexpr static std::chrono::milliseconds MaxPollPeriod(30000);
+
+    /**
+     * @brief Gets the wait before the next poll of a long-running operation.
+     *
+     * @remark The delay asked for by the service through a Retry-After header of the last
+     * response is used as is. Otherwise, the period doubles after each poll, up to
+     * #Azure::Core::_internal::MaxPollPeriod.
+     *
+     * @param response The last response of the operation, if any.
+     * @param period The period asked for by the caller.
+     * @param pollCount The number of polls made so far.
+     *
+     * @return The wait before the next poll.
+     */
+    std::chrono::milliseconds GetPollDelay(
+        Http::RawResponse const* response,
+        std::chrono::milliseconds period,
+        int32_t pollCount);
+
+    /**
+     * @brief Waits for \p delay before the next poll of a long-running operation, waking up as
+     * soon as \p context is cancelled.
+     *
+     */
+    void WaitForPollDelay(std::chrono::milliseconds delay, Context const& context);
+  } // namespace _internal
+
   /**
    * @brief Methods starting long-running operations return Operation<T> types.
    *
@@ -42,6 +78,24 @@ namespace Azure { namespace Core {
      */
     Operation() = default;
 
+    /**
+     * @brief Waits before polling the long-running operation again, as long as asked for by the
+     * service in the last response or else backing off from \p period.
+     * @remark Throws if the context is cancelled, without waiting for the end of the delay.
+     *
+     * @param period Time in milliseconds asked for by the caller to wait between polls.
+     * @param pollCount The number of polls made so far.
+     * @param context A context to control the request lifetime.
+     */
+    void WaitBeforeNextPoll(
+        std::chrono::milliseconds period,
+        int32_t pollCount,
+        Context const& context) const
+    {
+      _internal::WaitForPollDelay(
+          _internal::GetPollDelay(m_rawResponse.get(), period, pollCount), context);
+    }
+
     // Define how an Operation<T> can be move-constructed from rvalue other. Parameter `other`
     // gave up ownership for the rawResponse.
     /**
@@ -191,6 +245,9 @@ namespace Azure { namespace Core {
     /**
      * @brief Periodically polls till the long-running operation completes.
      *
+     * @remark The operations wait as long as the service asks for between polls, or else back off
+     * exponentially from \p period.
+     *
      * @param period Time in milliseconds to wait between polls.
      *
      * @return Response<T> the final result of the long-running operation.
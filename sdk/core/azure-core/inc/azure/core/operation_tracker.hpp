@@ -0,0 +1,288 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Polls many long-running operations from a few threads.
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/exception.hpp"
+#include "azure/core/operation.hpp"
+#include "azure/core/operation_status.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Azure { namespace Core {
+
+  /**
+   * @brief Options to customize an #Azure::Core::OperationTracker.
+   *
+   */
+  struct OperationTrackerOptions final
+  {
+    /**
+     * @brief The period to wait before the first poll of an operation. The next ones wait as long
+     * as the service asks for, or else back off exponentially from it.
+     *
+     */
+    std::chrono::milliseconds PollPeriod = std::chrono::seconds(1);
+
+    /**
+     * @brief The maximum number of operations polled at the same time, each by one of the
+     * threads of the tracker.
+     *
+     */
+    int32_t MaxConcurrentPolls = 8;
+  };
+
+  /**
+   * @brief Polls many long-running operations until they are done, instead of a loop or a thread
+   * polling each one of them.
+   *
+   * @remark The operations are scheduled by the time of their next poll, and polled by a fixed
+   * number of threads. When an operation is done, its callback is called from one of these
+   * threads, or its future is set. An operation ending without a value, or failing to be polled,
+   * completes with an error.
+   *
+   * @tparam T The long-running operation final result type.
+   */
+  template <class T> class OperationTracker final {
+  public:
+    /**
+     * @brief Called once an operation is done, with the error that ended it, if any.
+     *
+     */
+    using CompletionCallback = std::function<void(Operation<T>& operation, std::exception_ptr)>;
+
+  private:
+    struct Entry final
+    {
+      std::unique_ptr<Operation<T>> TrackedOperation;
+      CompletionCallback OnCompleted;
+      Context OperationContext;
+      int32_t PollCount = 0;
+    };
+
+    OperationTrackerOptions m_options;
+
+    mutable std::mutex m_mutex;
+    // Notified when an operation is added, or the tracker stops.
+    std::condition_variable m_changed;
+    // The operations by the time of their next poll.
+    std::multimap<std::chrono::steady_clock::time_point, std::unique_ptr<Entry>> m_scheduled;
+    size_t m_pendingOperations = 0;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+
+    void Complete(Entry& entry, std::exception_ptr error)
+    {
+      {
+        // The operation isn't pending anymore once its callback is called.
+        std::lock_guard<std::mutex> guard(m_mutex);
+        --m_pendingOperations;
+      }
+      try
+      {
+        entry.OnCompleted(*entry.TrackedOperation, std::move(error));
+      }
+      catch (...)
+      {
+        // The errors of a callback don't stop the other operations.
+      }
+    }
+
+    void Poll(Entry& entry)
+    {
+      entry.OperationContext.ThrowIfCancelled();
+      ++entry.PollCount;
+      entry.TrackedOperation->Poll(entry.OperationContext);
+    }
+
+    void Run()
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (true)
+      {
+        if (m_stopping)
+        {
+          return;
+        }
+        if (m_scheduled.empty())
+        {
+          m_changed.wait(lock);
+          continue;
+        }
+        auto const next = m_scheduled.begin();
+        if (std::chrono::steady_clock::now() < next->first)
+        {
+          m_changed.wait_until(lock, next->first);
+          continue;
+        }
+        std::unique_ptr<Entry> entry = std::move(next->second);
+        m_scheduled.erase(next);
+        lock.unlock();
+
+        std::exception_ptr error;
+        try
+        {
+          Poll(*entry);
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+        }
+        if (error || entry->TrackedOperation->IsDone())
+        {
+          Complete(*entry, error);
+          entry.reset();
+          lock.lock();
+          continue;
+        }
+
+        auto const delay = _internal::GetPollDelay(
+            &entry->TrackedOperation->GetRawResponse(), m_options.PollPeriod, entry->PollCount);
+        lock.lock();
+        m_scheduled.emplace(std::chrono::steady_clock::now() + delay, std::move(entry));
+        // Another thread may be waiting for a later poll.
+        m_changed.notify_one();
+      }
+    }
+
+  public:
+    /**
+     * @brief Construct a new OperationTracker object, starting its threads.
+     *
+     * @param options The options to customize the tracker.
+     */
+    explicit OperationTracker(OperationTrackerOptions const& options = OperationTrackerOptions())
+        : m_options(options)
+    {
+      const int32_t threadCount = m_options.MaxConcurrentPolls > 0 ? m_options.MaxConcurrentPolls
+                                                                   : 1;
+      for (int32_t i = 0; i < threadCount; ++i)
+      {
+        m_threads.emplace_back([this]() { Run(); });
+      }
+    }
+
+    /**
+     * @brief Destructs the tracker, after the polls in progress. The operations not done yet
+     * complete with an #Azure::Core::OperationCancelledException.
+     *
+     */
+    ~OperationTracker()
+    {
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stopping = true;
+      }
+      m_changed.notify_all();
+      for (auto& thread : m_threads)
+      {
+        thread.join();
+      }
+
+      auto const error = std::make_exception_ptr(
+          OperationCancelledException("The operation tracker was destroyed."));
+      for (auto& scheduled : m_scheduled)
+      {
+        Complete(*scheduled.second, error);
+      }
+    }
+
+    OperationTracker(OperationTracker const&) = delete;
+    OperationTracker& operator=(OperationTracker const&) = delete;
+
+    /**
+     * @brief Polls an operation until it's done, then calls \p onCompleted.
+     *
+     * @param operation The operation to poll, owned by the tracker until it's done.
+     * @param onCompleted Called from one of the threads of the tracker once the operation is
+     * done, or failed to be polled.
+     * @param context A context to control the lifetime of the polls.
+     */
+    void Track(
+        std::unique_ptr<Operation<T>> operation,
+        CompletionCallback onCompleted,
+        Context const& context = Context())
+    {
+      auto entry = std::make_unique<Entry>();
+      entry->TrackedOperation = std::move(operation);
+      entry->OnCompleted = std::move(onCompleted);
+      entry->OperationContext = context;
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_pendingOperations;
+        m_scheduled.emplace(
+            std::chrono::steady_clock::now() + m_options.PollPeriod, std::move(entry));
+      }
+      m_changed.notify_one();
+    }
+
+    /**
+     * @brief Polls an operation until it's done.
+     *
+     * @param operation The operation to poll, owned by the tracker until it's done.
+     * @param context A context to control the lifetime of the polls.
+     * @return The final result of the operation, or the error that ended it. An operation done
+     * without a value ends with an #Azure::Core::RequestFailedException.
+     */
+    std::future<T> Track(
+        std::unique_ptr<Operation<T>> operation,
+        Context const& context = Context())
+    {
+      auto promise = std::make_shared<std::promise<T>>();
+      auto future = promise->get_future();
+      Track(
+          std::move(operation),
+          [promise](Operation<T>& completed, std::exception_ptr error) {
+            if (!error && !completed.HasValue())
+            {
+              error = std::make_exception_ptr(RequestFailedException(
+                  "The long-running operation ended with the status "
+                  + completed.Status().Get() + "."));
+            }
+            if (error)
+            {
+              promise->set_exception(error);
+              return;
+            }
+            try
+            {
+              promise->set_value(completed.Value());
+            }
+            catch (...)
+            {
+              promise->set_exception(std::current_exception());
+            }
+          },
+          context);
+      return future;
+    }
+
+    /**
+     * @brief Gets the number of operations tracked which are not done yet.
+     *
+     */
+    size_t PendingOperations() const
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      return m_pendingOperations;
+    }
+  };
+
+}} // namespace Azure::Core
@@ -9,7 +9,10 @@
 #pragma once
 
 #include <cstdlib>
+#include <future>
+#include <memory>
 #include <string>
+#include <type_traits>
 
 #include "azure/core/context.hpp"
 #include "azure/core/http/raw_response.hpp"
@@ -34,6 +37,36 @@ namespace Azure { namespace Core {
     // `m_hasPage` is then turned to `false` once `MoveToNextPage` is called on the last page.
     bool m_hasPage = true;
 
+    // Set by `EnablePrefetch()`. The next page is fetched in `m_nextPage`, on a copy of the
+    // current page.
+    bool m_isPrefetchEnabled = false;
+    std::future<std::unique_ptr<T>> m_nextPage;
+
+    // The copy of the page fetching the next page in the background, while the caller reads and
+    // changes the current page.
+    void StartPrefetch(const Azure::Core::Context& context, std::true_type)
+    {
+      if (!NextPageToken.HasValue() || NextPageToken.Value().empty())
+      {
+        return;
+      }
+      m_nextPage = std::async(
+          std::launch::async,
+          [context](std::unique_ptr<T> nextPage) {
+            nextPage->OnNextPage(context);
+            return nextPage;
+          },
+          std::make_unique<T>(static_cast<const T&>(*this)));
+    }
+
+    void StartPrefetch(const Azure::Core::Context&, std::false_type) {}
+
+    // An alias template, so that it's only evaluated once T is complete.
+    template <class U>
+    using IsPrefetchSupported = std::integral_constant<
+        bool,
+        std::is_copy_constructible<U>::value && std::is_move_assignable<U>::value>;
+
   protected:
     /**
      * @brief Constructs a default instance of `%PagedResponse`.
@@ -53,6 +86,18 @@ namespace Azure { namespace Core {
      */
     PagedResponse& operator=(PagedResponse&&) = default;
 
+    /**
+     * @brief Constructs `%PagedResponse` by copying another instance, without its #RawResponse.
+     *
+     * @remark Used to fetch the next page in the background, see #EnablePrefetch().
+     *
+     */
+    PagedResponse(const PagedResponse& other)
+        : m_hasPage(other.m_hasPage), CurrentPageToken(other.CurrentPageToken),
+          NextPageToken(other.NextPageToken)
+    {
+    }
+
   public:
     /**
      * @brief Destructs `%PagedResponse`.
@@ -92,6 +137,32 @@ namespace Azure { namespace Core {
      */
     bool HasPage() const { return m_hasPage; }
 
+    /**
+     * @brief Fetches each next page in the background as soon as the current page is received,
+     * so that the request for the next page overlaps with the processing of the current one.
+     *
+     * @remark The next page is fetched right away, and then after each call to #MoveToNextPage(),
+     * with the context of the call. #MoveToNextPage() waits for it and throws if the fetch
+     * failed, leaving the current page unchanged.
+     *
+     * @remark The destructor waits for the page being fetched.
+     *
+     * @param context A context to control the lifetime of the request for the next page.
+     */
+    void EnablePrefetch(const Azure::Core::Context& context = Azure::Core::Context())
+    {
+      static_assert(
+          IsPrefetchSupported<T>::value,
+          "Prefetching requires \"T\" to be copy constructible and move assignable.");
+
+      if (m_isPrefetchEnabled)
+      {
+        return;
+      }
+      m_isPrefetchEnabled = true;
+      StartPrefetch(context, IsPrefetchSupported<T>());
+    }
+
     /**
      * @brief Moves to the next page of the response.
      *
@@ -111,9 +182,24 @@ namespace Azure { namespace Core {
         return;
       }
 
-      // Developer must make sure current page is kept unchanged if OnNextPage()
-      // throws exception.
-      static_cast<T*>(this)->OnNextPage(context);
+      if (m_nextPage.valid())
+      {
+        // The future is consumed even if the fetch threw, the next call fetches the page again.
+        std::unique_ptr<T> nextPage = m_nextPage.get();
+        static_cast<T&>(*this) = std::move(*nextPage);
+        m_isPrefetchEnabled = true;
+      }
+      else
+      {
+        // Developer must make sure current page is kept unchanged if OnNextPage()
+        // throws exception.
+        static_cast<T*>(this)->OnNextPage(context);
+      }
+
+      if (m_isPrefetchEnabled)
+      {
+        StartPrefetch(context, IsPrefetchSupported<T>());
+      }
     }
   };
 
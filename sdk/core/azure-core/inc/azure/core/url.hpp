@@ -14,7 +14,8 @@
 #include <map>
 #include <memory>
 #include <string>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace Azure { namespace Core {
   namespace _detail {
@@ -36,6 +37,22 @@ namespace Azure { namespace Core {
         return queryStr;
       }
     }
+
+    inline std::string FormatEncodedUrlQueryParameters(
+        std::vector<std::pair<std::string, std::string>> const& encodedQueryParameters)
+    {
+      std::string queryStr;
+      auto separator = '?';
+      for (const auto& q : encodedQueryParameters)
+      {
+        queryStr += separator;
+        queryStr += q.first;
+        queryStr += '=';
+        queryStr += q.second;
+        separator = '&';
+      }
+      return queryStr;
+    }
   } // namespace _detail
 
   /**
@@ -50,14 +67,15 @@ namespace Azure { namespace Core {
     std::string m_host;
     uint16_t m_port{0};
     std::string m_encodedPath;
-    // query parameters are all encoded
-    std::map<std::string, std::string> m_encodedQueryParameters;
+    // query parameters are all encoded, sorted by name. A URL has a handful of them, which are
+    // copied with the URL of every request, so they are kept in a vector rather than in a map.
+    std::vector<std::pair<std::string, std::string>> m_encodedQueryParameters;
 
-    // List of default non-URL-encode chars. While URL encoding a string, do not escape any chars in
-    // this set.
-    const static std::unordered_set<unsigned char> defaultNonUrlEncodeChars;
+    std::string GetUrl(bool relative) const;
 
-    std::string GetUrlWithoutQuery(bool relative) const;
+    // Inserts the query parameter at its sorted position, or overrides the value of the existing
+    // one.
+    void SetEncodedQueryParameter(std::string encodedKey, std::string encodedValue);
 
     /**
      * @brief Finds the first '?' symbol and parses everything after it as query parameters.
@@ -141,11 +159,7 @@ namespace Azure { namespace Core {
      *
      * @param queryParameters query parameters for request.
      */
-    void SetQueryParameters(std::map<std::string, std::string> queryParameters)
-    {
-      // creates a copy and discard previous
-      m_encodedQueryParameters = std::move(queryParameters);
-    }
+    void SetQueryParameters(std::map<std::string, std::string> queryParameters);
 
     // ===== APIs for mutating URL state: ======
 
@@ -173,20 +187,14 @@ namespace Azure { namespace Core {
      * @param encodedKey Name of the query parameter, already encoded.
      * @param encodedValue Value of the query parameter, already encoded.
      */
-    void AppendQueryParameter(const std::string& encodedKey, const std::string& encodedValue)
-    {
-      m_encodedQueryParameters[encodedKey] = encodedValue;
-    }
+    void AppendQueryParameter(const std::string& encodedKey, const std::string& encodedValue);
 
     /**
      * @brief Removes an existing query parameter.
      *
      * @param encodedKey The name of the query parameter to be removed.
      */
-    void RemoveQueryParameter(const std::string& encodedKey)
-    {
-      m_encodedQueryParameters.erase(encodedKey);
-    }
+    void RemoveQueryParameter(const std::string& encodedKey);
 
     /************** API to read values from Url ***************/
     /**
@@ -221,6 +229,20 @@ namespace Azure { namespace Core {
      * @return A copy of the query parameters map.
      */
     std::map<std::string, std::string> GetQueryParameters() const
+    {
+      return std::map<std::string, std::string>(
+          m_encodedQueryParameters.begin(), m_encodedQueryParameters.end());
+    }
+
+    /**
+     * @brief Gets the list of query parameters from the URL without copying it.
+     *
+     * @note The query parameters are URL-encoded, and sorted by name like in the map returned by
+     * #GetQueryParameters().
+     *
+     * @return A reference to the query parameters, valid until the URL is modified or destroyed.
+     */
+    const std::vector<std::pair<std::string, std::string>>& GetQueryParametersView() const
     {
       return m_encodedQueryParameters;
     }
@@ -12,6 +12,7 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 
 namespace Azure { namespace Core {
   /**
@@ -32,6 +33,9 @@ namespace Azure { namespace Core {
   private:
     Uuid(uint8_t const uuid[UuidSize]) { std::memcpy(m_uuid, uuid, UuidSize); }
 
+    // Sets the version and the variant of the random bytes of a version 4 UUID.
+    static Uuid FromRandomBytes(uint8_t uuid[UuidSize]);
+
   public:
     /**
      * @brief Gets Uuid as a string.
@@ -44,5 +48,16 @@ namespace Azure { namespace Core {
      *
      */
     static Uuid CreateUuid();
+
+    /**
+     * @brief Creates new random UUIDs.
+     *
+     * @details Creating the UUIDs at once is faster than calling #CreateUuid() for each of them.
+     *
+     * @param count The number of UUIDs to create.
+     *
+     * @return The created UUIDs.
+     */
+    static std::vector<Uuid> CreateUuids(size_t count);
   };
 }} // namespace Azure::Core
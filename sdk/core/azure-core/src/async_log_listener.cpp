@@ -0,0 +1,284 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/diagnostics/async_log_listener.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+using Azure::Core::Diagnostics::AsyncLogListener;
+using Azure::Core::Diagnostics::AsyncLogListenerOptions;
+using Azure::Core::Diagnostics::AsyncLogOverflowPolicy;
+using Azure::Core::Diagnostics::Logger;
+
+namespace {
+// The buffers of the messages longer than this are released once the messages are passed to the
+// listener, the shorter ones are reused by the next messages.
+constexpr size_t MaxReusedMessageCapacity = 4096;
+
+size_t GetQueueCapacity(size_t requestedCapacity)
+{
+  size_t capacity = 2;
+  while (capacity < requestedCapacity)
+  {
+    capacity *= 2;
+  }
+  return capacity;
+}
+} // namespace
+
+// Bounded multiple producer queue by Dmitry Vyukov: each slot has a sequence number telling
+// whether it is free to be written for a position, or holds the message for that position.
+struct AsyncLogListener::State final
+{
+  struct Slot final
+  {
+    std::atomic<size_t> Sequence;
+    Logger::Level Level;
+    std::string Message;
+  };
+
+  std::function<void(Logger::Level level, std::string const& message)> const Listener;
+  AsyncLogListenerOptions const Options;
+  size_t const Capacity;
+  std::unique_ptr<Slot[]> const Slots;
+
+  std::atomic<size_t> EnqueuePosition{0};
+  // Only written by the background thread.
+  std::atomic<size_t> DequeuePosition{0};
+  std::atomic<bool> IsStopping{false};
+  std::atomic<int64_t> DroppedMessageCount{0};
+
+  std::atomic<int64_t> RateLimitSecond{-1};
+  std::atomic<size_t> RateLimitSecondMessageCount{0};
+
+  std::mutex Mutex;
+  // Wakes up the background thread before the flush interval.
+  std::condition_variable WakeUp;
+  // Notified by the background thread after passing messages to the listener.
+  std::condition_variable Delivered;
+  // The number of calls to Flush() waiting, guarded by Mutex.
+  size_t FlushRequestCount = 0;
+
+  State(
+      std::function<void(Logger::Level level, std::string const& message)> listener,
+      AsyncLogListenerOptions const& options)
+      : Listener(std::move(listener)), Options(options),
+        Capacity(GetQueueCapacity(options.QueueCapacity)), Slots(new Slot[Capacity])
+  {
+    for (size_t i = 0; i < Capacity; ++i)
+    {
+      Slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool IsRateLimited()
+  {
+    if (Options.MaxMessagesPerSecond == 0)
+    {
+      return false;
+    }
+
+    auto const second = std::chrono::duration_cast<std::chrono::seconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+    auto rateLimitSecond = RateLimitSecond.load(std::memory_order_relaxed);
+    if (rateLimitSecond != second
+        && RateLimitSecond.compare_exchange_strong(
+            rateLimitSecond, second, std::memory_order_relaxed))
+    {
+      RateLimitSecondMessageCount.store(0, std::memory_order_relaxed);
+    }
+    return RateLimitSecondMessageCount.fetch_add(1, std::memory_order_relaxed)
+        >= Options.MaxMessagesPerSecond;
+  }
+
+  bool TryEnqueue(Logger::Level level, std::string const& message)
+  {
+    auto position = EnqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      auto& slot = Slots[position & (Capacity - 1)];
+      auto const sequence = slot.Sequence.load(std::memory_order_acquire);
+      if (sequence == position)
+      {
+        if (EnqueuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed))
+        {
+          slot.Level = level;
+          slot.Message.assign(message);
+          slot.Sequence.store(position + 1, std::memory_order_release);
+
+          if (position + 1 - DequeuePosition.load(std::memory_order_relaxed) >= Capacity / 2)
+          {
+            WakeUp.notify_one();
+          }
+          return true;
+        }
+      }
+      else if (static_cast<std::ptrdiff_t>(sequence - position) < 0)
+      {
+        // The slot still holds the message written a lap before, the queue is full.
+        return false;
+      }
+      else
+      {
+        position = EnqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void Write(Logger::Level level, std::string const& message)
+  {
+    if (IsStopping.load(std::memory_order_relaxed) || IsRateLimited())
+    {
+      DroppedMessageCount.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    while (!TryEnqueue(level, message))
+    {
+      if (Options.OverflowPolicy != AsyncLogOverflowPolicy::Block
+          || IsStopping.load(std::memory_order_relaxed))
+      {
+        DroppedMessageCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+
+      WakeUp.notify_one();
+      std::this_thread::yield();
+    }
+  }
+
+  // Passes the messages written so far to the listener, returns false if there was none.
+  bool DeliverMessages()
+  {
+    auto position = DequeuePosition.load(std::memory_order_relaxed);
+    auto const start = position;
+    for (;;)
+    {
+      auto& slot = Slots[position & (Capacity - 1)];
+      if (slot.Sequence.load(std::memory_order_acquire) != position + 1)
+      {
+        break;
+      }
+
+      try
+      {
+        Listener(slot.Level, slot.Message);
+      }
+      catch (...)
+      {
+      }
+
+      if (slot.Message.capacity() > MaxReusedMessageCapacity)
+      {
+        std::string().swap(slot.Message);
+      }
+      else
+      {
+        slot.Message.clear();
+      }
+
+      slot.Sequence.store(position + Capacity, std::memory_order_release);
+      ++position;
+      DequeuePosition.store(position, std::memory_order_release);
+    }
+    return position != start;
+  }
+
+  void Run()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    for (;;)
+    {
+      lock.unlock();
+      auto const delivered = DeliverMessages();
+      lock.lock();
+
+      if (delivered)
+      {
+        Delivered.notify_all();
+      }
+
+      auto const isPending = [this]() {
+        return EnqueuePosition.load(std::memory_order_relaxed)
+            != DequeuePosition.load(std::memory_order_relaxed);
+      };
+      if (IsStopping.load(std::memory_order_relaxed))
+      {
+        if (!isPending())
+        {
+          break;
+        }
+
+        // A message is being written to the queue.
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+        continue;
+      }
+
+      WakeUp.wait_for(lock, Options.FlushInterval, [&]() {
+        return IsStopping.load(std::memory_order_relaxed)
+            || (FlushRequestCount > 0 && isPending())
+            || EnqueuePosition.load(std::memory_order_relaxed)
+                    - DequeuePosition.load(std::memory_order_relaxed)
+                >= Capacity / 2;
+      });
+    }
+
+    Delivered.notify_all();
+  }
+};
+
+AsyncLogListener::AsyncLogListener(
+    std::function<void(Logger::Level level, std::string const& message)> listener,
+    AsyncLogListenerOptions const& options)
+    : m_state(std::make_shared<State>(std::move(listener), options))
+{
+  auto const state = m_state;
+  m_thread = std::thread([state]() { state->Run(); });
+}
+
+AsyncLogListener::~AsyncLogListener()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_state->Mutex);
+    m_state->IsStopping = true;
+  }
+  m_state->WakeUp.notify_one();
+  m_thread.join();
+}
+
+std::function<void(Logger::Level level, std::string const& message)>
+AsyncLogListener::GetListener() const
+{
+  auto const state = m_state;
+  return [state](Logger::Level level, std::string const& message) {
+    state->Write(level, message);
+  };
+}
+
+void AsyncLogListener::Flush()
+{
+  auto const position = m_state->EnqueuePosition.load(std::memory_order_acquire);
+
+  std::unique_lock<std::mutex> lock(m_state->Mutex);
+  ++m_state->FlushRequestCount;
+  m_state->WakeUp.notify_one();
+  m_state->Delivered.wait(lock, [&]() {
+    return static_cast<std::ptrdiff_t>(
+               m_state->DequeuePosition.load(std::memory_order_acquire) - position)
+        >= 0;
+  });
+  --m_state->FlushRequestCount;
+}
+
+int64_t AsyncLogListener::GetDroppedMessageCount() const
+{
+  return m_state->DroppedMessageCount.load(std::memory_order_relaxed);
+}
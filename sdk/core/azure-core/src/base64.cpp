@@ -4,13 +4,33 @@
 #include "azure/core/base64.hpp"
 #include "azure/core/platform.hpp"
 
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+// The AVX2 code paths are compiled on x86 and used when the CPU supports AVX2 at runtime, the
+// scalar code is used everywhere else.
+#define AZ_CORE_BASE64_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(AZ_CORE_BASE64_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#define AZ_CORE_BASE64_TARGET(features) __attribute__((target(features)))
+#else
+#define AZ_CORE_BASE64_TARGET(features)
+#endif
+
 namespace {
 
 static char const Base64EncodeArray[65]
     = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static char const Base64UrlEncodeArray[65]
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 static char const EncodingPad = '=';
 static int8_t const Base64DecodeArray[256] = {
     -1,
@@ -272,192 +292,300 @@ static int8_t const Base64DecodeArray[256] = {
     -1,
 };
 
-static int32_t Base64Encode(const uint8_t* threeBytes)
+// Base64URL replaces '+' and '/' with '-' and '_', the standard characters are still accepted when
+// decoding it.
+struct Base64UrlDecodeTable final
 {
-  int32_t i = (threeBytes[0] << 16) | (threeBytes[1] << 8) | threeBytes[2];
+  int8_t Values[256];
 
-  int32_t i0 = Base64EncodeArray[i >> 18];
-  int32_t i1 = Base64EncodeArray[(i >> 12) & 0x3F];
-  int32_t i2 = Base64EncodeArray[(i >> 6) & 0x3F];
-  int32_t i3 = Base64EncodeArray[i & 0x3F];
+  Base64UrlDecodeTable()
+  {
+    std::memcpy(Values, Base64DecodeArray, sizeof(Values));
+    Values[static_cast<uint8_t>('-')] = 62;
+    Values[static_cast<uint8_t>('_')] = 63;
+  }
+};
 
-  return i0 | (i1 << 8) | (i2 << 16) | (i3 << 24);
+static int8_t const* GetDecodeArray(bool url)
+{
+  static const Base64UrlDecodeTable urlTable;
+  return url ? urlTable.Values : Base64DecodeArray;
 }
 
-static int32_t Base64EncodeAndPadOne(const uint8_t* twoBytes)
+#if defined(AZ_CORE_BASE64_AVX2)
+#if defined(_MSC_VER)
+AZ_CORE_BASE64_TARGET("xsave") static bool IsAvx2Supported()
 {
-  int32_t i = twoBytes[0] << 16 | (twoBytes[1] << 8);
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+  {
+    return false;
+  }
 
-  int32_t i0 = Base64EncodeArray[i >> 18];
-  int32_t i1 = Base64EncodeArray[(i >> 12) & 0x3F];
-  int32_t i2 = Base64EncodeArray[(i >> 6) & 0x3F];
+  // AVX2 can only be used when the OS saves the YMM registers on context switches.
+  __cpuid(info, 1);
+  int const osxsaveAndAvx = (1 << 27) | (1 << 28);
+  if ((info[2] & osxsaveAndAvx) != osxsaveAndAvx || (_xgetbv(0) & 0x6) != 0x6)
+  {
+    return false;
+  }
 
-  return i0 | (i1 << 8) | (i2 << 16) | (EncodingPad << 24);
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
 }
+#else
+static bool IsAvx2Supported() { return __builtin_cpu_supports("avx2"); }
+#endif
 
-static int32_t Base64EncodeAndPadTwo(const uint8_t* oneByte)
+static bool UseAvx2()
 {
-  int32_t i = oneByte[0] << 8;
-
-  int32_t i0 = Base64EncodeArray[i >> 10];
-  int32_t i1 = Base64EncodeArray[(i >> 4) & 0x3F];
+  static const bool useAvx2 = IsAvx2Supported();
+  return useAvx2;
+}
 
-  return i0 | (i1 << 8) | (EncodingPad << 16) | (EncodingPad << 24);
+// Encodes 24 bytes into 32 characters per iteration, as long as 28 bytes can be read. Returns the
+// number of bytes encoded, which is a multiple of 24.
+// See "Faster Base64 Encoding and Decoding using AVX2 Instructions", W. Mula and D. Lemire.
+AZ_CORE_BASE64_TARGET("avx2")
+static size_t Base64EncodeAvx2(const uint8_t* data, size_t length, char* destination, bool url)
+{
+  // Spreads each group of 3 bytes over 4 bytes, in the order needed to extract the 6-bit indices
+  // with the multiplications below.
+  __m256i const shuffle = _mm256_setr_epi8(
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, //
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  // The offset to add to an index to get its character, by range of indices.
+  char const offset62 = static_cast<char>((url ? '-' : '+') - 62);
+  char const offset63 = static_cast<char>((url ? '_' : '/') - 63);
+  __m256i const offsets = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, //
+      '0' - 52, '0' - 52, '0' - 52, offset62, offset63, 'A', 0, 0, //
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, //
+      '0' - 52, '0' - 52, '0' - 52, offset62, offset63, 'A', 0, 0);
+
+  size_t encoded = 0;
+  while (length - encoded >= 28)
+  {
+    __m256i input = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + encoded))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + encoded + 12)),
+        1);
+    input = _mm256_shuffle_epi8(input, shuffle);
+
+    __m256i const indices01 = _mm256_mulhi_epu16(
+        _mm256_and_si256(input, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+    __m256i const indices23 = _mm256_mullo_epi16(
+        _mm256_and_si256(input, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+    __m256i const indices = _mm256_or_si256(indices01, indices23);
+
+    // 0-25 map to 13, 26-51 to 0, 52-61 to 1-10, 62 to 11 and 63 to 12.
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(
+        range,
+        _mm256_and_si256(
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+    __m256i const characters = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), characters);
+    destination += 32;
+    encoded += 24;
+  }
+  return encoded;
 }
 
-static void Base64WriteIntAsFourBytes(char* destination, int32_t value)
+// Decodes 32 characters into 24 bytes per iteration, as long as 28 bytes can be written. Stops
+// before the first 32 characters which are not all valid, so that the scalar code decodes those.
+// Returns the number of characters decoded, which is a multiple of 32.
+AZ_CORE_BASE64_TARGET("avx2")
+static size_t Base64DecodeAvx2(const char* text, size_t length, uint8_t* destination, bool url)
 {
-  destination[3] = static_cast<uint8_t>((value >> 24) & 0xFF);
-  destination[2] = static_cast<uint8_t>((value >> 16) & 0xFF);
-  destination[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
-  destination[0] = static_cast<uint8_t>(value & 0xFF);
+  // The bits of the low and high nibbles of the valid characters do not intersect, and the offset
+  // to add to a character to get its value is picked from its high nibble, '/' being the exception.
+  __m256i const lowNibbleBits = _mm256_setr_epi8(
+      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, //
+      0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, //
+      0x1B, 0x1A);
+  __m256i const highNibbleBits = _mm256_setr_epi8(
+      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, //
+      0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, //
+      0x10, 0x10);
+  __m256i const offsets = _mm256_setr_epi8(
+      0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, //
+      0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  __m256i const mask2F = _mm256_set1_epi8(0x2F);
+  // Packs the 3 bytes decoded from each group of 4 characters, 12 bytes per 128-bit lane.
+  __m256i const pack = _mm256_setr_epi8(
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, //
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+  size_t decoded = 0;
+  while (length - decoded >= 40)
+  {
+    __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + decoded));
+    if (url)
+    {
+      input = _mm256_blendv_epi8(
+          input, _mm256_set1_epi8('+'), _mm256_cmpeq_epi8(input, _mm256_set1_epi8('-')));
+      input = _mm256_blendv_epi8(
+          input, _mm256_set1_epi8('/'), _mm256_cmpeq_epi8(input, _mm256_set1_epi8('_')));
+    }
+
+    __m256i const highNibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), mask2F);
+    __m256i const lowBits = _mm256_shuffle_epi8(lowNibbleBits, _mm256_and_si256(input, mask2F));
+    __m256i const highBits = _mm256_shuffle_epi8(highNibbleBits, highNibbles);
+    if (!_mm256_testz_si256(lowBits, highBits))
+    {
+      break;
+    }
+
+    __m256i const isSlash = _mm256_cmpeq_epi8(input, mask2F);
+    __m256i const values = _mm256_add_epi8(
+        input, _mm256_shuffle_epi8(offsets, _mm256_add_epi8(isSlash, highNibbles)));
+
+    // Merges the 6-bit values into 12-bit, then 24-bit values.
+    __m256i const merged = _mm256_madd_epi16(
+        _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+    __m256i const packed = _mm256_shuffle_epi8(merged, pack);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm256_castsi256_si128(packed));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(destination + 12), _mm256_extracti128_si256(packed, 1));
+    destination += 24;
+    decoded += 32;
+  }
+  return decoded;
 }
+#endif
 
-std::string Base64Encode(const std::vector<uint8_t>& data)
+static void Base64Encode(const uint8_t* data, size_t length, char* destination, bool url, bool pad)
 {
   size_t sourceIndex = 0;
-  auto inputSize = data.size();
-  auto maxEncodedSize = ((inputSize + 2) / 3) * 4;
-  // Use a string with size to the max possible result
-  std::string encodedResult(maxEncodedSize, '0');
-  // Removing const from the string to update the placeholder string
-  auto destination = const_cast<char*>(encodedResult.data());
-
-  while (sourceIndex + 3 <= inputSize)
+#if defined(AZ_CORE_BASE64_AVX2)
+  if (UseAvx2())
   {
-    int32_t result = Base64Encode(&data[sourceIndex]);
-    Base64WriteIntAsFourBytes(destination, result);
-    destination += 4;
-    sourceIndex += 3;
+    sourceIndex = Base64EncodeAvx2(data, length, destination, url);
+    destination += sourceIndex / 3 * 4;
   }
+#endif
 
-  if (sourceIndex + 1 == inputSize)
+  char const* alphabet = url ? Base64UrlEncodeArray : Base64EncodeArray;
+  for (; sourceIndex + 3 <= length; sourceIndex += 3)
   {
-    int32_t result = Base64EncodeAndPadTwo(&data[sourceIndex]);
-    Base64WriteIntAsFourBytes(destination, result);
+    uint32_t const i = (static_cast<uint32_t>(data[sourceIndex]) << 16)
+        | (static_cast<uint32_t>(data[sourceIndex + 1]) << 8) | data[sourceIndex + 2];
+    destination[0] = alphabet[i >> 18];
+    destination[1] = alphabet[(i >> 12) & 0x3F];
+    destination[2] = alphabet[(i >> 6) & 0x3F];
+    destination[3] = alphabet[i & 0x3F];
     destination += 4;
-    sourceIndex += 1;
   }
-  else if (sourceIndex + 2 == inputSize)
+
+  if (sourceIndex + 1 == length)
   {
-    int32_t result = Base64EncodeAndPadOne(&data[sourceIndex]);
-    Base64WriteIntAsFourBytes(destination, result);
-    destination += 4;
-    sourceIndex += 2;
+    uint32_t const i = static_cast<uint32_t>(data[sourceIndex]) << 8;
+    destination[0] = alphabet[i >> 10];
+    destination[1] = alphabet[(i >> 4) & 0x3F];
+    if (pad)
+    {
+      destination[2] = EncodingPad;
+      destination[3] = EncodingPad;
+    }
+  }
+  else if (sourceIndex + 2 == length)
+  {
+    uint32_t const i = (static_cast<uint32_t>(data[sourceIndex]) << 16)
+        | (static_cast<uint32_t>(data[sourceIndex + 1]) << 8);
+    destination[0] = alphabet[i >> 18];
+    destination[1] = alphabet[(i >> 12) & 0x3F];
+    destination[2] = alphabet[(i >> 6) & 0x3F];
+    if (pad)
+    {
+      destination[3] = EncodingPad;
+    }
   }
-
-  return encodedResult;
-}
-
-static int32_t Base64Decode(const char* encodedBytes)
-{
-  int32_t i0 = encodedBytes[0];
-  int32_t i1 = encodedBytes[1];
-  int32_t i2 = encodedBytes[2];
-  int32_t i3 = encodedBytes[3];
-
-  i0 = Base64DecodeArray[i0];
-  i1 = Base64DecodeArray[i1];
-  i2 = Base64DecodeArray[i2];
-  i3 = Base64DecodeArray[i3];
-
-  i0 <<= 18;
-  i1 <<= 12;
-  i2 <<= 6;
-
-  i0 |= i3;
-  i1 |= i2;
-
-  i0 |= i1;
-  return i0;
 }
 
-static void Base64WriteThreeLowOrderBytes(std::vector<uint8_t>::iterator destination, int64_t value)
+// Invalid characters are not rejected, they decode to unspecified bytes.
+static uint32_t Base64DecodeValue(char encodedByte, int8_t const* decodeArray, int shift)
 {
-  destination[0] = static_cast<uint8_t>(value >> 16);
-  destination[1] = static_cast<uint8_t>(value >> 8);
-  destination[2] = static_cast<uint8_t>(value);
+  return static_cast<uint32_t>(decodeArray[static_cast<uint8_t>(encodedByte)]) << shift;
 }
 
-std::vector<uint8_t> Base64Decode(const std::string& text)
+// Removes the padding of the text, returning the number of characters left to decode.
+static size_t Base64TrimPadding(const char* text, size_t length, bool url)
 {
-  auto inputSize = text.size();
-  if (inputSize < 4)
+  if (length % 4 != 0)
   {
-    return std::vector<uint8_t>(0);
+    if (!url)
+    {
+      // A trailing incomplete group of characters is ignored.
+      length -= length % 4;
+    }
+    else if (length % 4 == 1)
+    {
+      throw std::invalid_argument("Unexpected Base64URL encoding in the HTTP response.");
+    }
+    else
+    {
+      // Base64URL is not padded.
+      return length;
+    }
   }
 
-  size_t sourceIndex = 0;
-  auto inputPtr = text.data();
-  auto decodedSize = (inputSize / 4) * 3;
-
-  if (inputPtr[inputSize - 2] == EncodingPad)
+  if (length >= 4 && text[length - 2] == EncodingPad)
   {
-    decodedSize -= 2;
+    return length - 2;
   }
-  else if (inputPtr[inputSize - 1] == EncodingPad)
+  if (length >= 4 && text[length - 1] == EncodingPad)
   {
-    decodedSize -= 1;
+    return length - 1;
   }
+  return length;
+}
 
-  std::vector<uint8_t> destination(decodedSize);
-  auto destinationPtr = destination.begin();
+static size_t Base64DecodedLength(size_t length)
+{
+  return length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1);
+}
 
-  while (sourceIndex + 4 < inputSize)
+// Decodes text without padding, the length of which is not one more than a multiple of 4.
+static void Base64Decode(const char* text, size_t length, uint8_t* destination, bool url)
+{
+  size_t sourceIndex = 0;
+#if defined(AZ_CORE_BASE64_AVX2)
+  if (UseAvx2())
   {
-    int64_t result = Base64Decode(inputPtr + sourceIndex);
-    Base64WriteThreeLowOrderBytes(destinationPtr, result);
-    destinationPtr += 3;
-    sourceIndex += 4;
+    sourceIndex = Base64DecodeAvx2(text, length, destination, url);
+    destination += sourceIndex / 4 * 3;
   }
+#endif
 
-  // We are guaranteed to have an input with at least 4 bytes at this point, with a size that is a
-  // multiple of 4.
-  int64_t i0 = inputPtr[inputSize - 4];
-  int64_t i1 = inputPtr[inputSize - 3];
-  int64_t i2 = inputPtr[inputSize - 2];
-  int64_t i3 = inputPtr[inputSize - 1];
-
-  i0 = Base64DecodeArray[i0];
-  i1 = Base64DecodeArray[i1];
-
-  i0 <<= 18;
-  i1 <<= 12;
-
-  i0 |= i1;
-
-  if (i3 != EncodingPad)
+  int8_t const* decodeArray = GetDecodeArray(url);
+  for (; sourceIndex + 4 <= length; sourceIndex += 4)
   {
-    i2 = Base64DecodeArray[i2];
-    i3 = Base64DecodeArray[i3];
-
-    i2 <<= 6;
-
-    i0 |= i3;
-    i0 |= i2;
-
-    Base64WriteThreeLowOrderBytes(destinationPtr, i0);
-    destinationPtr += 3;
+    const char* group = text + sourceIndex;
+    uint32_t const i = Base64DecodeValue(group[0], decodeArray, 18)
+        | Base64DecodeValue(group[1], decodeArray, 12) | Base64DecodeValue(group[2], decodeArray, 6)
+        | Base64DecodeValue(group[3], decodeArray, 0);
+    destination[0] = static_cast<uint8_t>(i >> 16);
+    destination[1] = static_cast<uint8_t>(i >> 8);
+    destination[2] = static_cast<uint8_t>(i);
+    destination += 3;
   }
-  else if (i2 != EncodingPad)
-  {
-    i2 = Base64DecodeArray[i2];
-
-    i2 <<= 6;
-
-    i0 |= i2;
 
-    destinationPtr[1] = static_cast<uint8_t>(i0 >> 8);
-    destinationPtr[0] = static_cast<uint8_t>(i0 >> 16);
-    destinationPtr += 2;
-  }
-  else
+  if (sourceIndex + 2 <= length)
   {
-    destinationPtr[0] = static_cast<uint8_t>(i0 >> 16);
-    destinationPtr += 1;
+    uint32_t i = Base64DecodeValue(text[sourceIndex], decodeArray, 18)
+        | Base64DecodeValue(text[sourceIndex + 1], decodeArray, 12);
+    if (sourceIndex + 3 == length)
+    {
+      i |= Base64DecodeValue(text[sourceIndex + 2], decodeArray, 6);
+      destination[1] = static_cast<uint8_t>(i >> 8);
+    }
+    destination[0] = static_cast<uint8_t>(i >> 16);
   }
-
-  return destination;
 }
 
 } // namespace
@@ -466,12 +594,54 @@ namespace Azure { namespace Core {
 
   std::string Convert::Base64Encode(const std::vector<uint8_t>& data)
   {
-    return ::Base64Encode(data);
+    std::string encodedResult(_internal::Base64::EncodedLength(data.size()), '\0');
+    _internal::Base64::Encode(data.data(), data.size(), &encodedResult[0]);
+    return encodedResult;
   }
 
   std::vector<uint8_t> Convert::Base64Decode(const std::string& text)
   {
-    return ::Base64Decode(text);
+    std::vector<uint8_t> decodedResult(_internal::Base64::DecodedLength(text.data(), text.size()));
+    _internal::Base64::Decode(text.data(), text.size(), decodedResult.data());
+    return decodedResult;
   }
 
+  namespace _internal {
+
+    void Base64::Encode(const uint8_t* data, size_t length, char* destination)
+    {
+      ::Base64Encode(data, length, destination, false, true);
+    }
+
+    size_t Base64::DecodedLength(const char* text, size_t length)
+    {
+      return ::Base64DecodedLength(::Base64TrimPadding(text, length, false));
+    }
+
+    size_t Base64::Decode(const char* text, size_t length, uint8_t* destination)
+    {
+      length = ::Base64TrimPadding(text, length, false);
+      ::Base64Decode(text, length, destination, false);
+      return ::Base64DecodedLength(length);
+    }
+
+    void Base64Url::Base64UrlEncode(const uint8_t* data, size_t length, char* destination)
+    {
+      ::Base64Encode(data, length, destination, true, false);
+    }
+
+    size_t Base64Url::DecodedLength(const char* text, size_t length)
+    {
+      return ::Base64DecodedLength(::Base64TrimPadding(text, length, true));
+    }
+
+    size_t Base64Url::Base64UrlDecode(const char* text, size_t length, uint8_t* destination)
+    {
+      length = ::Base64TrimPadding(text, length, true);
+      ::Base64Decode(text, length, destination, true);
+      return ::Base64DecodedLength(length);
+    }
+
+  } // namespace _internal
+
 }} // namespace Azure::Core
@@ -3,23 +3,151 @@
 
 #include "azure/core/context.hpp"
 
+#include "private/context_cancellation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
 using namespace Azure::Core;
+using Azure::Core::_detail::ContextCancellationListener;
+using Azure::Core::_detail::ContextCancellationRegistration;
+
+namespace {
+// Incremented each time a context is cancelled. The earliest deadline cached by a context is only
+// valid while this doesn't change, because a parent of the context might have been cancelled.
+std::atomic<uint64_t> g_cancellationEpoch{0};
+
+// The registrations waiting for a context to be cancelled. They are spread over shards by address,
+// so concurrent requests rarely take the same mutex.
+struct RegistrationShard final
+{
+  std::mutex Mutex;
+  std::vector<ContextCancellationRegistration*> Registrations;
+};
+
+using RegistrationShards = std::array<RegistrationShard, 16>;
+
+RegistrationShards& GetRegistrationShards()
+{
+  // Never destroyed, so registrations ending during the static destruction still find it.
+  static RegistrationShards* const shards = new RegistrationShards();
+  return *shards;
+}
+
+RegistrationShard& GetRegistrationShard(ContextCancellationRegistration const* registration)
+{
+  auto const address = reinterpret_cast<std::uintptr_t>(registration);
+  auto const index
+      = (address / alignof(std::max_align_t)) % std::tuple_size<RegistrationShards>::value;
+  return GetRegistrationShards()[index];
+}
+} // namespace
 
 Context Context::ApplicationContext;
 
-Azure::DateTime Azure::Core::Context::GetDeadline() const
+void Azure::Core::Context::Cancel()
 {
-  // Contexts form a tree. Here, we walk from a node all the way back to the root in order to find
-  // the earliest deadline value.
-  auto result = DateTime::max();
-  for (auto ptr = m_contextSharedState; ptr; ptr = ptr->Parent)
+  m_contextSharedState->Deadline = ContextSharedState::ToDateTimeRepresentation((DateTime::min)());
+  // The deadline is updated first, so the contexts which see the new epoch also see the deadline,
+  // and the listeners see the context as cancelled.
+  g_cancellationEpoch.fetch_add(1);
+
+  // Cancellation is rare compared to waits, so it looks through all the registrations for the
+  // ones made on this context or on the contexts created from it.
+  auto const cancelled = m_contextSharedState.get();
+  for (auto& shard : GetRegistrationShards())
   {
-    auto deadline = ContextSharedState::FromDateTimeRepresentation(ptr->Deadline);
-    if (result > deadline)
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    for (auto registration : shard.Registrations)
     {
-      result = deadline;
+      for (auto state = registration->m_context.m_contextSharedState.get(); state;
+           state = state->Parent.get())
+      {
+        if (state == cancelled)
+        {
+          registration->m_listener->OnContextCancelled();
+          break;
+        }
+      }
     }
   }
+}
+
+Azure::DateTime::rep Azure::Core::Context::GetEarliestDeadline() const noexcept
+{
+  auto& state = *m_contextSharedState;
+  auto const epoch = g_cancellationEpoch.load();
+  if (state.EarliestDeadlineEpoch.load(std::memory_order_acquire) == epoch)
+  {
+    return state.EarliestDeadline.load(std::memory_order_relaxed);
+  }
 
-  return result;
+  // Contexts form a tree. Here, we walk from a node all the way back to the root in order to find
+  // the earliest deadline value.
+  auto result = state.Deadline.load();
+  for (auto ptr = state.Parent.get(); ptr; ptr = ptr->Parent.get())
+  {
+    result = (std::min)(result, ptr->Deadline.load());
+  }
+
+  // Deadlines only get earlier, so when other threads update the cache at the same time the
+  // earliest value is kept.
+  auto cached = state.EarliestDeadline.load(std::memory_order_relaxed);
+  while (result < cached
+         && !state.EarliestDeadline.compare_exchange_weak(
+             cached, result, std::memory_order_relaxed))
+  {
+  }
+  state.EarliestDeadlineEpoch.store(epoch, std::memory_order_release);
+  return (std::min)(result, cached);
+}
+
+bool Azure::Core::Context::IsCancelled() const noexcept
+{
+  auto const deadline = GetEarliestDeadline();
+  // Most contexts have no deadline, and cancelled ones have the minimum one. Neither needs the
+  // current time.
+  if (deadline == ContextSharedState::ToDateTimeRepresentation((DateTime::max)()))
+  {
+    return false;
+  }
+  if (deadline == ContextSharedState::ToDateTimeRepresentation((DateTime::min)()))
+  {
+    return true;
+  }
+  return ContextSharedState::FromDateTimeRepresentation(deadline)
+      < std::chrono::system_clock::now();
+}
+
+Azure::DateTime Azure::Core::Context::GetDeadline() const
+{
+  return ContextSharedState::FromDateTimeRepresentation(GetEarliestDeadline());
+}
+
+ContextCancellationRegistration::ContextCancellationRegistration(
+    Context const& context,
+    ContextCancellationListener* listener)
+    : m_context(context), m_listener(listener)
+{
+  auto& shard = GetRegistrationShard(this);
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+  shard.Registrations.push_back(this);
+}
+
+ContextCancellationRegistration::~ContextCancellationRegistration()
+{
+  auto& shard = GetRegistrationShard(this);
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+  auto& registrations = shard.Registrations;
+  auto registration = std::find(registrations.begin(), registrations.end(), this);
+  if (registration != registrations.end())
+  {
+    *registration = registrations.back();
+    registrations.pop_back();
+  }
 }
@@ -0,0 +1,292 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/platform.hpp>
+
+#if defined(AZ_PLATFORM_WINDOWS)
+// Windows needs to go before bcrypt
+#include <windows.h>
+
+#include <bcrypt.h>
+#elif defined(AZ_PLATFORM_POSIX)
+#include <openssl/evp.h>
+#endif
+
+#include "azure/core/internal/cryptography/hmac.hpp"
+
+#include "azure/core/internal/azure_assert.hpp"
+
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Azure::Core::Cryptography::_internal::HmacSha256;
+
+#if defined(AZ_PLATFORM_POSIX)
+
+// The digest context initialized with the key is copied to restart, so the key isn't processed
+// again.
+struct HmacSha256::Impl final
+{
+  EVP_PKEY* Key = nullptr;
+  EVP_MD_CTX* KeyedContext = nullptr;
+  EVP_MD_CTX* Context = nullptr;
+
+  Impl() {}
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+
+  ~Impl()
+  {
+    EVP_MD_CTX_free(Context);
+    EVP_MD_CTX_free(KeyedContext);
+    EVP_PKEY_free(Key);
+  }
+};
+
+HmacSha256::HmacSha256(const uint8_t* key, size_t keyLength) : m_impl(std::make_unique<Impl>())
+{
+  // HMAC pads the key with zeros, so an empty key is the same as a zero byte.
+  const uint8_t emptyKey = 0;
+  m_impl->Key = EVP_PKEY_new_raw_private_key(
+      EVP_PKEY_HMAC, nullptr, keyLength == 0 ? &emptyKey : key, keyLength == 0 ? 1 : keyLength);
+  if (m_impl->Key == nullptr)
+  {
+    throw std::runtime_error("Crypto error while creating HMAC key.");
+  }
+  if ((m_impl->KeyedContext = EVP_MD_CTX_new()) == nullptr
+      || (m_impl->Context = EVP_MD_CTX_new()) == nullptr)
+  {
+    throw std::runtime_error("Crypto error while creating EVP context.");
+  }
+  if (1 != EVP_DigestSignInit(m_impl->KeyedContext, nullptr, EVP_sha256(), nullptr, m_impl->Key))
+  {
+    throw std::runtime_error("Crypto error while init HmacSha256.");
+  }
+  Reset();
+}
+
+HmacSha256::HmacSha256(const HmacSha256& other)
+    : m_impl(std::make_unique<Impl>()), m_isDone(other.m_isDone)
+{
+  if (1 != EVP_PKEY_up_ref(other.m_impl->Key))
+  {
+    throw std::runtime_error("Crypto error while copying HMAC key.");
+  }
+  m_impl->Key = other.m_impl->Key;
+  if ((m_impl->KeyedContext = EVP_MD_CTX_new()) == nullptr
+      || (m_impl->Context = EVP_MD_CTX_new()) == nullptr)
+  {
+    throw std::runtime_error("Crypto error while creating EVP context.");
+  }
+  if (1 != EVP_MD_CTX_copy_ex(m_impl->KeyedContext, other.m_impl->KeyedContext)
+      || 1 != EVP_MD_CTX_copy_ex(m_impl->Context, other.m_impl->Context))
+  {
+    throw std::runtime_error("Crypto error while copying HmacSha256.");
+  }
+}
+
+HmacSha256::~HmacSha256() {}
+
+void HmacSha256::Append(const uint8_t* data, size_t length)
+{
+  _azure_ASSERT_MSG(!m_isDone, "Cannot call Append after calling Final().");
+  if (length != 0 && 1 != EVP_DigestSignUpdate(m_impl->Context, data, length))
+  {
+    throw std::runtime_error("Crypto error while updating HmacSha256.");
+  }
+}
+
+std::vector<uint8_t> HmacSha256::Final(const uint8_t* data, size_t length)
+{
+  Append(data, length);
+  m_isDone = true;
+
+  unsigned char finalHash[EVP_MAX_MD_SIZE];
+  size_t size = sizeof(finalHash);
+  if (1 != EVP_DigestSignFinal(m_impl->Context, finalHash, &size))
+  {
+    throw std::runtime_error("Crypto error while computing HmacSha256.");
+  }
+  return std::vector<uint8_t>(std::begin(finalHash), std::begin(finalHash) + size);
+}
+
+void HmacSha256::Reset()
+{
+  if (1 != EVP_MD_CTX_copy_ex(m_impl->Context, m_impl->KeyedContext))
+  {
+    throw std::runtime_error("Crypto error while resetting HmacSha256.");
+  }
+  m_isDone = false;
+}
+
+#endif
+
+#if defined(AZ_PLATFORM_WINDOWS)
+
+namespace {
+struct AlgorithmProviderInstance final
+{
+  BCRYPT_ALG_HANDLE Handle;
+  size_t ContextSize;
+  size_t HashLength;
+
+  AlgorithmProviderInstance()
+  {
+    NTSTATUS status = BCryptOpenAlgorithmProvider(
+        &Handle, BCRYPT_SHA256_ALGORITHM, nullptr, BCRYPT_ALG_HANDLE_HMAC_FLAG);
+    if (!BCRYPT_SUCCESS(status))
+    {
+      throw std::runtime_error("BCryptOpenAlgorithmProvider failed");
+    }
+    DWORD objectLength = 0;
+    DWORD dataLength = 0;
+    status = BCryptGetProperty(
+        Handle,
+        BCRYPT_OBJECT_LENGTH,
+        reinterpret_cast<PBYTE>(&objectLength),
+        sizeof(objectLength),
+        &dataLength,
+        0);
+    if (!BCRYPT_SUCCESS(status))
+    {
+      throw std::runtime_error("BCryptGetProperty failed");
+    }
+    ContextSize = objectLength;
+    DWORD hashLength = 0;
+    status = BCryptGetProperty(
+        Handle,
+        BCRYPT_HASH_LENGTH,
+        reinterpret_cast<PBYTE>(&hashLength),
+        sizeof(hashLength),
+        &dataLength,
+        0);
+    if (!BCRYPT_SUCCESS(status))
+    {
+      throw std::runtime_error("BCryptGetProperty failed");
+    }
+    HashLength = hashLength;
+  }
+
+  ~AlgorithmProviderInstance() { BCryptCloseAlgorithmProvider(Handle, 0); }
+};
+
+const AlgorithmProviderInstance& GetAlgorithmProvider()
+{
+  static AlgorithmProviderInstance AlgorithmProvider;
+  return AlgorithmProvider;
+}
+
+void DuplicateHash(BCRYPT_HASH_HANDLE source, BCRYPT_HASH_HANDLE& target, std::string& buffer)
+{
+  buffer.resize(GetAlgorithmProvider().ContextSize);
+  NTSTATUS status = BCryptDuplicateHash(
+      source, &target, reinterpret_cast<PUCHAR>(&buffer[0]), static_cast<ULONG>(buffer.size()), 0);
+  if (!BCRYPT_SUCCESS(status))
+  {
+    throw std::runtime_error("BCryptDuplicateHash failed");
+  }
+}
+} // namespace
+
+// The hash object created with the key is duplicated to restart, so the key isn't processed
+// again.
+struct HmacSha256::Impl final
+{
+  std::string KeyedBuffer;
+  BCRYPT_HASH_HANDLE KeyedHandle = nullptr;
+  std::string Buffer;
+  BCRYPT_HASH_HANDLE Handle = nullptr;
+
+  Impl() {}
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+
+  ~Impl()
+  {
+    if (Handle != nullptr)
+    {
+      BCryptDestroyHash(Handle);
+    }
+    if (KeyedHandle != nullptr)
+    {
+      BCryptDestroyHash(KeyedHandle);
+    }
+  }
+};
+
+HmacSha256::HmacSha256(const uint8_t* key, size_t keyLength) : m_impl(std::make_unique<Impl>())
+{
+  _azure_ASSERT_MSG(keyLength <= (std::numeric_limits<ULONG>::max)(), "Key size is too big.");
+
+  const auto& algorithmProvider = GetAlgorithmProvider();
+  m_impl->KeyedBuffer.resize(algorithmProvider.ContextSize);
+  NTSTATUS status = BCryptCreateHash(
+      algorithmProvider.Handle,
+      &m_impl->KeyedHandle,
+      reinterpret_cast<PUCHAR>(&m_impl->KeyedBuffer[0]),
+      static_cast<ULONG>(m_impl->KeyedBuffer.size()),
+      reinterpret_cast<PUCHAR>(const_cast<uint8_t*>(key)),
+      static_cast<ULONG>(keyLength),
+      0);
+  if (!BCRYPT_SUCCESS(status))
+  {
+    throw std::runtime_error("BCryptCreateHash failed");
+  }
+  Reset();
+}
+
+HmacSha256::HmacSha256(const HmacSha256& other)
+    : m_impl(std::make_unique<Impl>()), m_isDone(other.m_isDone)
+{
+  DuplicateHash(other.m_impl->KeyedHandle, m_impl->KeyedHandle, m_impl->KeyedBuffer);
+  DuplicateHash(other.m_impl->Handle, m_impl->Handle, m_impl->Buffer);
+}
+
+HmacSha256::~HmacSha256() {}
+
+void HmacSha256::Append(const uint8_t* data, size_t length)
+{
+  _azure_ASSERT_MSG(!m_isDone, "Cannot call Append after calling Final().");
+  _azure_ASSERT_MSG(length <= (std::numeric_limits<ULONG>::max)(), "Data size is too big.");
+  NTSTATUS status = BCryptHashData(
+      m_impl->Handle,
+      reinterpret_cast<PBYTE>(const_cast<uint8_t*>(data)),
+      static_cast<ULONG>(length),
+      0);
+  if (!BCRYPT_SUCCESS(status))
+  {
+    throw std::runtime_error("BCryptHashData failed");
+  }
+}
+
+std::vector<uint8_t> HmacSha256::Final(const uint8_t* data, size_t length)
+{
+  Append(data, length);
+  m_isDone = true;
+
+  std::vector<uint8_t> hash;
+  hash.resize(GetAlgorithmProvider().HashLength);
+  NTSTATUS status = BCryptFinishHash(
+      m_impl->Handle, reinterpret_cast<PUCHAR>(&hash[0]), static_cast<ULONG>(hash.size()), 0);
+  if (!BCRYPT_SUCCESS(status))
+  {
+    throw std::runtime_error("BCryptFinishHash failed");
+  }
+  return hash;
+}
+
+void HmacSha256::Reset()
+{
+  if (m_impl->Handle != nullptr)
+  {
+    BCryptDestroyHash(m_impl->Handle);
+    m_impl->Handle = nullptr;
+  }
+  DuplicateHash(m_impl->KeyedHandle, m_impl->Handle, m_impl->Buffer);
+  m_isDone = false;
+}
+
+#endif
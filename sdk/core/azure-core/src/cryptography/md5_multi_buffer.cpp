@@ -0,0 +1,519 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/internal/cryptography/md5_multi_buffer.hpp"
+
+#include "azure/core/cryptography/hash.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+// The buffers are hashed together on x86 when the CPU supports AVX2 at runtime, each buffer is
+// hashed on its own everywhere else.
+#define AZ_CORE_MD5_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(AZ_CORE_MD5_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#define AZ_CORE_MD5_TARGET(features) __attribute__((target(features)))
+#else
+#define AZ_CORE_MD5_TARGET(features)
+#endif
+
+using Azure::Core::Cryptography::Md5Hash;
+
+namespace {
+
+struct Md5Job final
+{
+  const uint8_t* Data;
+  size_t Length;
+  std::vector<uint8_t> Hash;
+  bool Done = false;
+};
+
+#if defined(AZ_CORE_MD5_AVX2)
+#if defined(_MSC_VER)
+AZ_CORE_MD5_TARGET("xsave") bool IsAvx2Supported()
+{
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+  {
+    return false;
+  }
+
+  // AVX2 can only be used when the OS saves the YMM registers on context switches.
+  __cpuid(info, 1);
+  int const osxsaveAndAvx = (1 << 27) | (1 << 28);
+  if ((info[2] & osxsaveAndAvx) != osxsaveAndAvx || (_xgetbv(0) & 0x6) != 0x6)
+  {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+}
+#else
+bool IsAvx2Supported() { return __builtin_cpu_supports("avx2"); }
+#endif
+
+bool UseAvx2()
+{
+  static const bool useAvx2 = IsAvx2Supported();
+  return useAvx2;
+}
+
+constexpr size_t LaneCount = 8;
+constexpr size_t BlockSize = 64;
+// Smaller buffers are hashed on their own, they would mostly wait for the others.
+constexpr size_t MinMultiBufferLength = 16 * 1024;
+// The lanes are refilled with the buffers waiting to be hashed at least every 64 KiB.
+constexpr size_t MaxBlocksPerRound = 1024;
+
+alignas(32) const uint8_t ZeroBlock[BlockSize] = {};
+
+// The state of the MD5 of a buffer hashed in one of the lanes. The last bytes of the buffer and
+// the padding are copied in Tail, so that every block is read as a whole.
+struct Md5Lane final
+{
+  Md5Job* Job = nullptr;
+  size_t FullBlocks = 0;
+  size_t Blocks = 0;
+  size_t NextBlock = 0;
+  uint32_t State[4] = {};
+  uint8_t Tail[2 * BlockSize] = {};
+
+  void Start(Md5Job* job)
+  {
+    Job = job;
+    FullBlocks = job->Length / BlockSize;
+    const size_t tailLength = job->Length % BlockSize;
+    // The padding is 0x80, zeros, and the length in bits, which takes one more block when the
+    // tail doesn't leave room for the 9 bytes.
+    Blocks = FullBlocks + (tailLength + 9 <= BlockSize ? 1 : 2);
+    NextBlock = 0;
+    State[0] = 0x67452301;
+    State[1] = 0xefcdab89;
+    State[2] = 0x98badcfe;
+    State[3] = 0x10325476;
+
+    std::memset(Tail, 0, sizeof(Tail));
+    if (tailLength != 0)
+    {
+      std::memcpy(Tail, job->Data + FullBlocks * BlockSize, tailLength);
+    }
+    Tail[tailLength] = 0x80;
+    uint64_t bitLength = static_cast<uint64_t>(job->Length) * 8;
+    uint8_t* lengthBytes = Tail + (Blocks - FullBlocks) * BlockSize - 8;
+    for (int i = 0; i < 8; ++i)
+    {
+      lengthBytes[i] = static_cast<uint8_t>(bitLength >> (8 * i));
+    }
+  }
+
+  const uint8_t* Block(size_t index) const
+  {
+    return index < FullBlocks ? Job->Data + index * BlockSize
+                              : Tail + (index - FullBlocks) * BlockSize;
+  }
+
+  std::vector<uint8_t> Digest() const
+  {
+    std::vector<uint8_t> hash(16);
+    for (size_t i = 0; i < 16; ++i)
+    {
+      hash[i] = static_cast<uint8_t>(State[i / 4] >> (8 * (i % 4)));
+    }
+    return hash;
+  }
+};
+
+#define AZ_CORE_MD5_SCALAR_F(b, c, d) (d ^ (b & (c ^ d)))
+#define AZ_CORE_MD5_SCALAR_G(b, c, d) (c ^ (d & (b ^ c)))
+#define AZ_CORE_MD5_SCALAR_H(b, c, d) (b ^ c ^ d)
+#define AZ_CORE_MD5_SCALAR_I(b, c, d) (c ^ (b | ~d))
+#define AZ_CORE_MD5_SCALAR_STEP(f, a, b, c, d, word, k, s) \
+  a += AZ_CORE_MD5_SCALAR_##f(b, c, d) + word + k; \
+  a = b + ((a << s) | (a >> (32 - s)))
+
+// Hashes the next count blocks of the buffer of a lane on its own, faster than in the lanes when
+// no other buffer is hashed at the same time.
+void HashBlocks(Md5Lane& lane, size_t count)
+{
+  uint32_t a = lane.State[0];
+  uint32_t b = lane.State[1];
+  uint32_t c = lane.State[2];
+  uint32_t d = lane.State[3];
+  for (size_t n = 0; n < count; ++n)
+  {
+    // x86 is little-endian, like MD5.
+    uint32_t w[16];
+    std::memcpy(w, lane.Block(lane.NextBlock + n), BlockSize);
+
+    const uint32_t previousA = a;
+    const uint32_t previousB = b;
+    const uint32_t previousC = c;
+    const uint32_t previousD = d;
+
+    AZ_CORE_MD5_SCALAR_STEP(F, a, b, c, d, w[0], 0xd76aa478, 7);
+    AZ_CORE_MD5_SCALAR_STEP(F, d, a, b, c, w[1], 0xe8c7b756, 12);
+    AZ_CORE_MD5_SCALAR_STEP(F, c, d, a, b, w[2], 0x242070db, 17);
+    AZ_CORE_MD5_SCALAR_STEP(F, b, c, d, a, w[3], 0xc1bdceee, 22);
+    AZ_CORE_MD5_SCALAR_STEP(F, a, b, c, d, w[4], 0xf57c0faf, 7);
+    AZ_CORE_MD5_SCALAR_STEP(F, d, a, b, c, w[5], 0x4787c62a, 12);
+    AZ_CORE_MD5_SCALAR_STEP(F, c, d, a, b, w[6], 0xa8304613, 17);
+    AZ_CORE_MD5_SCALAR_STEP(F, b, c, d, a, w[7], 0xfd469501, 22);
+    AZ_CORE_MD5_SCALAR_STEP(F, a, b, c, d, w[8], 0x698098d8, 7);
+    AZ_CORE_MD5_SCALAR_STEP(F, d, a, b, c, w[9], 0x8b44f7af, 12);
+    AZ_CORE_MD5_SCALAR_STEP(F, c, d, a, b, w[10], 0xffff5bb1, 17);
+    AZ_CORE_MD5_SCALAR_STEP(F, b, c, d, a, w[11], 0x895cd7be, 22);
+    AZ_CORE_MD5_SCALAR_STEP(F, a, b, c, d, w[12], 0x6b901122, 7);
+    AZ_CORE_MD5_SCALAR_STEP(F, d, a, b, c, w[13], 0xfd987193, 12);
+    AZ_CORE_MD5_SCALAR_STEP(F, c, d, a, b, w[14], 0xa679438e, 17);
+    AZ_CORE_MD5_SCALAR_STEP(F, b, c, d, a, w[15], 0x49b40821, 22);
+    AZ_CORE_MD5_SCALAR_STEP(G, a, b, c, d, w[1], 0xf61e2562, 5);
+    AZ_CORE_MD5_SCALAR_STEP(G, d, a, b, c, w[6], 0xc040b340, 9);
+    AZ_CORE_MD5_SCALAR_STEP(G, c, d, a, b, w[11], 0x265e5a51, 14);
+    AZ_CORE_MD5_SCALAR_STEP(G, b, c, d, a, w[0], 0xe9b6c7aa, 20);
+    AZ_CORE_MD5_SCALAR_STEP(G, a, b, c, d, w[5], 0xd62f105d, 5);
+    AZ_CORE_MD5_SCALAR_STEP(G, d, a, b, c, w[10], 0x02441453, 9);
+    AZ_CORE_MD5_SCALAR_STEP(G, c, d, a, b, w[15], 0xd8a1e681, 14);
+    AZ_CORE_MD5_SCALAR_STEP(G, b, c, d, a, w[4], 0xe7d3fbc8, 20);
+    AZ_CORE_MD5_SCALAR_STEP(G, a, b, c, d, w[9], 0x21e1cde6, 5);
+    AZ_CORE_MD5_SCALAR_STEP(G, d, a, b, c, w[14], 0xc33707d6, 9);
+    AZ_CORE_MD5_SCALAR_STEP(G, c, d, a, b, w[3], 0xf4d50d87, 14);
+    AZ_CORE_MD5_SCALAR_STEP(G, b, c, d, a, w[8], 0x455a14ed, 20);
+    AZ_CORE_MD5_SCALAR_STEP(G, a, b, c, d, w[13], 0xa9e3e905, 5);
+    AZ_CORE_MD5_SCALAR_STEP(G, d, a, b, c, w[2], 0xfcefa3f8, 9);
+    AZ_CORE_MD5_SCALAR_STEP(G, c, d, a, b, w[7], 0x676f02d9, 14);
+    AZ_CORE_MD5_SCALAR_STEP(G, b, c, d, a, w[12], 0x8d2a4c8a, 20);
+    AZ_CORE_MD5_SCALAR_STEP(H, a, b, c, d, w[5], 0xfffa3942, 4);
+    AZ_CORE_MD5_SCALAR_STEP(H, d, a, b, c, w[8], 0x8771f681, 11);
+    AZ_CORE_MD5_SCALAR_STEP(H, c, d, a, b, w[11], 0x6d9d6122, 16);
+    AZ_CORE_MD5_SCALAR_STEP(H, b, c, d, a, w[14], 0xfde5380c, 23);
+    AZ_CORE_MD5_SCALAR_STEP(H, a, b, c, d, w[1], 0xa4beea44, 4);
+    AZ_CORE_MD5_SCALAR_STEP(H, d, a, b, c, w[4], 0x4bdecfa9, 11);
+    AZ_CORE_MD5_SCALAR_STEP(H, c, d, a, b, w[7], 0xf6bb4b60, 16);
+    AZ_CORE_MD5_SCALAR_STEP(H, b, c, d, a, w[10], 0xbebfbc70, 23);
+    AZ_CORE_MD5_SCALAR_STEP(H, a, b, c, d, w[13], 0x289b7ec6, 4);
+    AZ_CORE_MD5_SCALAR_STEP(H, d, a, b, c, w[0], 0xeaa127fa, 11);
+    AZ_CORE_MD5_SCALAR_STEP(H, c, d, a, b, w[3], 0xd4ef3085, 16);
+    AZ_CORE_MD5_SCALAR_STEP(H, b, c, d, a, w[6], 0x04881d05, 23);
+    AZ_CORE_MD5_SCALAR_STEP(H, a, b, c, d, w[9], 0xd9d4d039, 4);
+    AZ_CORE_MD5_SCALAR_STEP(H, d, a, b, c, w[12], 0xe6db99e5, 11);
+    AZ_CORE_MD5_SCALAR_STEP(H, c, d, a, b, w[15], 0x1fa27cf8, 16);
+    AZ_CORE_MD5_SCALAR_STEP(H, b, c, d, a, w[2], 0xc4ac5665, 23);
+    AZ_CORE_MD5_SCALAR_STEP(I, a, b, c, d, w[0], 0xf4292244, 6);
+    AZ_CORE_MD5_SCALAR_STEP(I, d, a, b, c, w[7], 0x432aff97, 10);
+    AZ_CORE_MD5_SCALAR_STEP(I, c, d, a, b, w[14], 0xab9423a7, 15);
+    AZ_CORE_MD5_SCALAR_STEP(I, b, c, d, a, w[5], 0xfc93a039, 21);
+    AZ_CORE_MD5_SCALAR_STEP(I, a, b, c, d, w[12], 0x655b59c3, 6);
+    AZ_CORE_MD5_SCALAR_STEP(I, d, a, b, c, w[3], 0x8f0ccc92, 10);
+    AZ_CORE_MD5_SCALAR_STEP(I, c, d, a, b, w[10], 0xffeff47d, 15);
+    AZ_CORE_MD5_SCALAR_STEP(I, b, c, d, a, w[1], 0x85845dd1, 21);
+    AZ_CORE_MD5_SCALAR_STEP(I, a, b, c, d, w[8], 0x6fa87e4f, 6);
+    AZ_CORE_MD5_SCALAR_STEP(I, d, a, b, c, w[15], 0xfe2ce6e0, 10);
+    AZ_CORE_MD5_SCALAR_STEP(I, c, d, a, b, w[6], 0xa3014314, 15);
+    AZ_CORE_MD5_SCALAR_STEP(I, b, c, d, a, w[13], 0x4e0811a1, 21);
+    AZ_CORE_MD5_SCALAR_STEP(I, a, b, c, d, w[4], 0xf7537e82, 6);
+    AZ_CORE_MD5_SCALAR_STEP(I, d, a, b, c, w[11], 0xbd3af235, 10);
+    AZ_CORE_MD5_SCALAR_STEP(I, c, d, a, b, w[2], 0x2ad7d2bb, 15);
+    AZ_CORE_MD5_SCALAR_STEP(I, b, c, d, a, w[9], 0xeb86d391, 21);
+
+    a += previousA;
+    b += previousB;
+    c += previousC;
+    d += previousD;
+  }
+  lane.State[0] = a;
+  lane.State[1] = b;
+  lane.State[2] = c;
+  lane.State[3] = d;
+  lane.NextBlock += count;
+}
+
+#undef AZ_CORE_MD5_SCALAR_STEP
+#undef AZ_CORE_MD5_SCALAR_I
+#undef AZ_CORE_MD5_SCALAR_H
+#undef AZ_CORE_MD5_SCALAR_G
+#undef AZ_CORE_MD5_SCALAR_F
+
+// Loads 8 words at the same offset of the 8 blocks, and transposes them so that words[i] holds
+// the word i of each block.
+AZ_CORE_MD5_TARGET("avx2")
+inline void LoadWords(const uint8_t* const* blocks, size_t offset, __m256i* words)
+{
+  __m256i rows[LaneCount];
+  for (size_t lane = 0; lane < LaneCount; ++lane)
+  {
+    rows[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks[lane] + offset));
+  }
+  __m256i pairs[LaneCount];
+  for (size_t i = 0; i < LaneCount; i += 4)
+  {
+    pairs[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+    pairs[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+    pairs[i + 2] = _mm256_unpacklo_epi32(rows[i + 2], rows[i + 3]);
+    pairs[i + 3] = _mm256_unpackhi_epi32(rows[i + 2], rows[i + 3]);
+  }
+  __m256i quads[LaneCount];
+  for (size_t i = 0; i < LaneCount; i += 4)
+  {
+    quads[i] = _mm256_unpacklo_epi64(pairs[i], pairs[i + 2]);
+    quads[i + 1] = _mm256_unpackhi_epi64(pairs[i], pairs[i + 2]);
+    quads[i + 2] = _mm256_unpacklo_epi64(pairs[i + 1], pairs[i + 3]);
+    quads[i + 3] = _mm256_unpackhi_epi64(pairs[i + 1], pairs[i + 3]);
+  }
+  for (size_t i = 0; i < 4; ++i)
+  {
+    words[i] = _mm256_permute2x128_si256(quads[i], quads[i + 4], 0x20);
+    words[i + 4] = _mm256_permute2x128_si256(quads[i], quads[i + 4], 0x31);
+  }
+}
+
+#define AZ_CORE_MD5_F(b, c, d) _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)))
+#define AZ_CORE_MD5_G(b, c, d) _mm256_xor_si256(c, _mm256_and_si256(d, _mm256_xor_si256(b, c)))
+#define AZ_CORE_MD5_H(b, c, d) _mm256_xor_si256(_mm256_xor_si256(b, c), d)
+#define AZ_CORE_MD5_I(b, c, d) _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, ones)))
+#define AZ_CORE_MD5_STEP(f, a, b, c, d, word, k, s) \
+  a = _mm256_add_epi32( \
+      _mm256_add_epi32(a, AZ_CORE_MD5_##f(b, c, d)), \
+      _mm256_add_epi32(word, _mm256_set1_epi32(static_cast<int>(k)))); \
+  a = _mm256_add_epi32(b, _mm256_or_si256(_mm256_slli_epi32(a, s), _mm256_srli_epi32(a, 32 - s)))
+
+// Hashes the next count blocks of the buffer of each lane, the lanes without a buffer hash zeros.
+AZ_CORE_MD5_TARGET("avx2") void HashBlocks(Md5Lane* lanes, size_t count)
+{
+  alignas(32) uint32_t state[4][LaneCount];
+  for (size_t lane = 0; lane < LaneCount; ++lane)
+  {
+    for (size_t i = 0; i < 4; ++i)
+    {
+      state[i][lane] = lanes[lane].State[i];
+    }
+  }
+  __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[0]));
+  __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[1]));
+  __m256i c = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[2]));
+  __m256i d = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[3]));
+  const __m256i ones = _mm256_set1_epi32(-1);
+
+  for (size_t n = 0; n < count; ++n)
+  {
+    const uint8_t* blocks[LaneCount];
+    for (size_t lane = 0; lane < LaneCount; ++lane)
+    {
+      blocks[lane] = lanes[lane].Job != nullptr ? lanes[lane].Block(lanes[lane].NextBlock + n)
+                                                : ZeroBlock;
+    }
+    __m256i w[16];
+    LoadWords(blocks, 0, w);
+    LoadWords(blocks, 32, w + 8);
+
+    const __m256i previousA = a;
+    const __m256i previousB = b;
+    const __m256i previousC = c;
+    const __m256i previousD = d;
+
+    AZ_CORE_MD5_STEP(F, a, b, c, d, w[0], 0xd76aa478, 7);
+    AZ_CORE_MD5_STEP(F, d, a, b, c, w[1], 0xe8c7b756, 12);
+    AZ_CORE_MD5_STEP(F, c, d, a, b, w[2], 0x242070db, 17);
+    AZ_CORE_MD5_STEP(F, b, c, d, a, w[3], 0xc1bdceee, 22);
+    AZ_CORE_MD5_STEP(F, a, b, c, d, w[4], 0xf57c0faf, 7);
+    AZ_CORE_MD5_STEP(F, d, a, b, c, w[5], 0x4787c62a, 12);
+    AZ_CORE_MD5_STEP(F, c, d, a, b, w[6], 0xa8304613, 17);
+    AZ_CORE_MD5_STEP(F, b, c, d, a, w[7], 0xfd469501, 22);
+    AZ_CORE_MD5_STEP(F, a, b, c, d, w[8], 0x698098d8, 7);
+    AZ_CORE_MD5_STEP(F, d, a, b, c, w[9], 0x8b44f7af, 12);
+    AZ_CORE_MD5_STEP(F, c, d, a, b, w[10], 0xffff5bb1, 17);
+    AZ_CORE_MD5_STEP(F, b, c, d, a, w[11], 0x895cd7be, 22);
+    AZ_CORE_MD5_STEP(F, a, b, c, d, w[12], 0x6b901122, 7);
+    AZ_CORE_MD5_STEP(F, d, a, b, c, w[13], 0xfd987193, 12);
+    AZ_CORE_MD5_STEP(F, c, d, a, b, w[14], 0xa679438e, 17);
+    AZ_CORE_MD5_STEP(F, b, c, d, a, w[15], 0x49b40821, 22);
+    AZ_CORE_MD5_STEP(G, a, b, c, d, w[1], 0xf61e2562, 5);
+    AZ_CORE_MD5_STEP(G, d, a, b, c, w[6], 0xc040b340, 9);
+    AZ_CORE_MD5_STEP(G, c, d, a, b, w[11], 0x265e5a51, 14);
+    AZ_CORE_MD5_STEP(G, b, c, d, a, w[0], 0xe9b6c7aa, 20);
+    AZ_CORE_MD5_STEP(G, a, b, c, d, w[5], 0xd62f105d, 5);
+    AZ_CORE_MD5_STEP(G, d, a, b, c, w[10], 0x02441453, 9);
+    AZ_CORE_MD5_STEP(G, c, d, a, b, w[15], 0xd8a1e681, 14);
+    AZ_CORE_MD5_STEP(G, b, c, d, a, w[4], 0xe7d3fbc8, 20);
+    AZ_CORE_MD5_STEP(G, a, b, c, d, w[9], 0x21e1cde6, 5);
+    AZ_CORE_MD5_STEP(G, d, a, b, c, w[14], 0xc33707d6, 9);
+    AZ_CORE_MD5_STEP(G, c, d, a, b, w[3], 0xf4d50d87, 14);
+    AZ_CORE_MD5_STEP(G, b, c, d, a, w[8], 0x455a14ed, 20);
+    AZ_CORE_MD5_STEP(G, a, b, c, d, w[13], 0xa9e3e905, 5);
+    AZ_CORE_MD5_STEP(G, d, a, b, c, w[2], 0xfcefa3f8, 9);
+    AZ_CORE_MD5_STEP(G, c, d, a, b, w[7], 0x676f02d9, 14);
+    AZ_CORE_MD5_STEP(G, b, c, d, a, w[12], 0x8d2a4c8a, 20);
+    AZ_CORE_MD5_STEP(H, a, b, c, d, w[5], 0xfffa3942, 4);
+    AZ_CORE_MD5_STEP(H, d, a, b, c, w[8], 0x8771f681, 11);
+    AZ_CORE_MD5_STEP(H, c, d, a, b, w[11], 0x6d9d6122, 16);
+    AZ_CORE_MD5_STEP(H, b, c, d, a, w[14], 0xfde5380c, 23);
+    AZ_CORE_MD5_STEP(H, a, b, c, d, w[1], 0xa4beea44, 4);
+    AZ_CORE_MD5_STEP(H, d, a, b, c, w[4], 0x4bdecfa9, 11);
+    AZ_CORE_MD5_STEP(H, c, d, a, b, w[7], 0xf6bb4b60, 16);
+    AZ_CORE_MD5_STEP(H, b, c, d, a, w[10], 0xbebfbc70, 23);
+    AZ_CORE_MD5_STEP(H, a, b, c, d, w[13], 0x289b7ec6, 4);
+    AZ_CORE_MD5_STEP(H, d, a, b, c, w[0], 0xeaa127fa, 11);
+    AZ_CORE_MD5_STEP(H, c, d, a, b, w[3], 0xd4ef3085, 16);
+    AZ_CORE_MD5_STEP(H, b, c, d, a, w[6], 0x04881d05, 23);
+    AZ_CORE_MD5_STEP(H, a, b, c, d, w[9], 0xd9d4d039, 4);
+    AZ_CORE_MD5_STEP(H, d, a, b, c, w[12], 0xe6db99e5, 11);
+    AZ_CORE_MD5_STEP(H, c, d, a, b, w[15], 0x1fa27cf8, 16);
+    AZ_CORE_MD5_STEP(H, b, c, d, a, w[2], 0xc4ac5665, 23);
+    AZ_CORE_MD5_STEP(I, a, b, c, d, w[0], 0xf4292244, 6);
+    AZ_CORE_MD5_STEP(I, d, a, b, c, w[7], 0x432aff97, 10);
+    AZ_CORE_MD5_STEP(I, c, d, a, b, w[14], 0xab9423a7, 15);
+    AZ_CORE_MD5_STEP(I, b, c, d, a, w[5], 0xfc93a039, 21);
+    AZ_CORE_MD5_STEP(I, a, b, c, d, w[12], 0x655b59c3, 6);
+    AZ_CORE_MD5_STEP(I, d, a, b, c, w[3], 0x8f0ccc92, 10);
+    AZ_CORE_MD5_STEP(I, c, d, a, b, w[10], 0xffeff47d, 15);
+    AZ_CORE_MD5_STEP(I, b, c, d, a, w[1], 0x85845dd1, 21);
+    AZ_CORE_MD5_STEP(I, a, b, c, d, w[8], 0x6fa87e4f, 6);
+    AZ_CORE_MD5_STEP(I, d, a, b, c, w[15], 0xfe2ce6e0, 10);
+    AZ_CORE_MD5_STEP(I, c, d, a, b, w[6], 0xa3014314, 15);
+    AZ_CORE_MD5_STEP(I, b, c, d, a, w[13], 0x4e0811a1, 21);
+    AZ_CORE_MD5_STEP(I, a, b, c, d, w[4], 0xf7537e82, 6);
+    AZ_CORE_MD5_STEP(I, d, a, b, c, w[11], 0xbd3af235, 10);
+    AZ_CORE_MD5_STEP(I, c, d, a, b, w[2], 0x2ad7d2bb, 15);
+    AZ_CORE_MD5_STEP(I, b, c, d, a, w[9], 0xeb86d391, 21);
+
+    a = _mm256_add_epi32(a, previousA);
+    b = _mm256_add_epi32(b, previousB);
+    c = _mm256_add_epi32(c, previousC);
+    d = _mm256_add_epi32(d, previousD);
+  }
+
+  _mm256_store_si256(reinterpret_cast<__m256i*>(state[0]), a);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(state[1]), b);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(state[2]), c);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(state[3]), d);
+  for (size_t lane = 0; lane < LaneCount; ++lane)
+  {
+    if (lanes[lane].Job != nullptr)
+    {
+      for (size_t i = 0; i < 4; ++i)
+      {
+        lanes[lane].State[i] = state[i][lane];
+      }
+      lanes[lane].NextBlock += count;
+    }
+  }
+}
+
+#undef AZ_CORE_MD5_STEP
+#undef AZ_CORE_MD5_I
+#undef AZ_CORE_MD5_H
+#undef AZ_CORE_MD5_G
+#undef AZ_CORE_MD5_F
+
+// Hashes the buffers of the threads calling Hash() at the same time in the lanes. One of the
+// threads at a time hashes, the others wait.
+class Md5MultiBufferHasher final {
+public:
+  void Hash(Md5Job& job)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_pending.push_back(&job);
+    while (!job.Done)
+    {
+      if (m_hashing)
+      {
+        m_jobDone.wait(lock);
+        continue;
+      }
+
+      // The lanes are only used by the hashing thread, they're kept for the next one when it
+      // leaves.
+      m_hashing = true;
+      while (!job.Done)
+      {
+        size_t blocks = MaxBlocksPerRound;
+        Md5Lane* activeLane = nullptr;
+        size_t activeLanes = 0;
+        for (auto& lane : m_lanes)
+        {
+          if (lane.Job == nullptr && !m_pending.empty())
+          {
+            lane.Start(m_pending.front());
+            m_pending.pop_front();
+          }
+          if (lane.Job != nullptr)
+          {
+            blocks = (std::min)(blocks, lane.Blocks - lane.NextBlock);
+            activeLane = &lane;
+            ++activeLanes;
+          }
+        }
+
+        lock.unlock();
+        if (activeLanes == 1)
+        {
+          HashBlocks(*activeLane, blocks);
+        }
+        else
+        {
+          HashBlocks(m_lanes, blocks);
+        }
+        lock.lock();
+
+        bool anyDone = false;
+        for (auto& lane : m_lanes)
+        {
+          if (lane.Job != nullptr && lane.NextBlock == lane.Blocks)
+          {
+            lane.Job->Hash = lane.Digest();
+            lane.Job->Done = true;
+            lane.Job = nullptr;
+            anyDone = true;
+          }
+        }
+        if (anyDone)
+        {
+          m_jobDone.notify_all();
+        }
+      }
+      m_hashing = false;
+      // One of the threads still waiting takes over.
+      m_jobDone.notify_all();
+    }
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_jobDone;
+  std::deque<Md5Job*> m_pending;
+  bool m_hashing = false;
+  Md5Lane m_lanes[LaneCount];
+};
+#endif
+
+} // namespace
+
+namespace Azure { namespace Core { namespace Cryptography { namespace _internal {
+
+  std::vector<uint8_t> ComputeMd5MultiBuffer(const uint8_t* data, size_t length)
+  {
+#if defined(AZ_CORE_MD5_AVX2)
+    if (length >= MinMultiBufferLength && UseAvx2())
+    {
+      static Md5MultiBufferHasher hasher;
+      Md5Job job{data, length, {}};
+      hasher.Hash(job);
+      return std::move(job.Hash);
+    }
+#endif
+    return Md5Hash().Final(data, length);
+  }
+
+}}}} // namespace Azure::Core::Cryptography::_internal
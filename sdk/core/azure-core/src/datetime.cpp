@@ -7,9 +7,7 @@
 #include <algorithm>
 #include <cctype>
 #include <ctime>
-#include <iomanip>
 #include <limits>
-#include <sstream>
 #include <stdexcept>
 
 using namespace Azure;
@@ -384,6 +382,134 @@ void ParseSingleOptionalChar(
     IncreaseAndCheckMinLength(minLength, actualLength, 1);
   }
 }
+
+// The date and time parts parsed by the fixed layout parsers.
+struct DateTimeParts final
+{
+  int16_t Year;
+  int8_t Month;
+  int8_t Day;
+  int8_t Hour;
+  int8_t Minute;
+  int8_t Second;
+  int32_t FracSec;
+  int8_t DayOfWeek;
+};
+
+// Returns the value of the digits, or -1 if any of the chars isn't a digit.
+int32_t ParseDigits(char const* str, size_t count)
+{
+  int32_t value = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto const digit = static_cast<unsigned char>(str[i]) - static_cast<unsigned>('0');
+    if (digit > 9)
+    {
+      return -1;
+    }
+    value = (value * 10) + static_cast<int32_t>(digit);
+  }
+  return value;
+}
+
+template <int8_t N> int8_t FindName(char const* str, std::string const (&names)[N])
+{
+  for (int8_t i = 0; i < static_cast<int8_t>(N); ++i)
+  {
+    if (str[0] == names[i][0] && str[1] == names[i][1] && str[2] == names[i][2])
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Parses the layout of RFC1123 used by HTTP, "Sun, 06 Nov 1994 08:49:37 GMT", without allocating.
+// Returns false for any other layout, which is left to the generic parser.
+bool TryParseRfc1123FixedLayout(char const* str, size_t length, DateTimeParts* parts)
+{
+  if (length != 29 || str[3] != ',' || str[4] != ' ' || str[7] != ' ' || str[11] != ' '
+      || str[16] != ' ' || str[19] != ':' || str[22] != ':' || str[25] != ' ' || str[26] != 'G'
+      || str[27] != 'M' || str[28] != 'T')
+  {
+    return false;
+  }
+
+  auto const dayOfWeek = FindName(str, DayNames);
+  auto const month = FindName(str + 8, MonthNames);
+  auto const day = ParseDigits(str + 5, 2);
+  auto const year = ParseDigits(str + 12, 4);
+  auto const hour = ParseDigits(str + 17, 2);
+  auto const minute = ParseDigits(str + 20, 2);
+  auto const second = ParseDigits(str + 23, 2);
+  if (dayOfWeek < 0 || month < 0 || day < 0 || year < 0 || hour < 0 || minute < 0 || second < 0)
+  {
+    return false;
+  }
+
+  *parts = {
+      static_cast<int16_t>(year),
+      static_cast<int8_t>(month + 1),
+      static_cast<int8_t>(day),
+      static_cast<int8_t>(hour),
+      static_cast<int8_t>(minute),
+      static_cast<int8_t>(second),
+      0,
+      dayOfWeek};
+  return true;
+}
+
+// Parses the layout of RFC3339 used by the services, "2021-01-01T08:49:37.1234567Z" with 0 to 7
+// fractional second digits, without allocating. Returns false for any other layout, which is left to
+// the generic parser.
+bool TryParseRfc3339FixedLayout(char const* str, size_t length, DateTimeParts* parts)
+{
+  if (length < 20 || length > 28 || length == 21 || str[4] != '-' || str[7] != '-'
+      || (str[10] != 'T' && str[10] != 't') || str[13] != ':' || str[16] != ':'
+      || str[length - 1] != 'Z' || (length > 20 && str[19] != '.'))
+  {
+    return false;
+  }
+
+  auto const year = ParseDigits(str, 4);
+  auto const month = ParseDigits(str + 5, 2);
+  auto const day = ParseDigits(str + 8, 2);
+  auto const hour = ParseDigits(str + 11, 2);
+  auto const minute = ParseDigits(str + 14, 2);
+  auto const second = ParseDigits(str + 17, 2);
+  auto const fracSecDigits = length > 20 ? length - 21 : 0;
+  auto fracSec = ParseDigits(str + 20, fracSecDigits);
+  if (year < 0 || month < 0 || day < 0 || hour < 0 || minute < 0 || second < 0 || fracSec < 0)
+  {
+    return false;
+  }
+  for (auto i = fracSecDigits; i < 7; ++i)
+  {
+    fracSec *= 10;
+  }
+
+  *parts = {
+      static_cast<int16_t>(year),
+      static_cast<int8_t>(month),
+      static_cast<int8_t>(day),
+      static_cast<int8_t>(hour),
+      static_cast<int8_t>(minute),
+      static_cast<int8_t>(second),
+      fracSec,
+      -1};
+  return true;
+}
+
+// Writes the value with the number of digits, padded with zeros.
+char* WriteDigits(char* out, int32_t value, int count)
+{
+  for (auto i = count - 1; i >= 0; --i)
+  {
+    out[i] = static_cast<char>('0' + (value % 10));
+    value /= 10;
+  }
+  return out + count;
+}
 } // namespace
 
 DateTime const DateTime::SystemClockEpoch = GetSystemClockEpoch();
@@ -449,6 +575,29 @@ DateTime::operator std::chrono::system_clock::time_point() const
 
 DateTime DateTime::Parse(std::string const& dateTime, DateFormat format)
 {
+  {
+    // The layouts sent by the services are parsed without the generic parser.
+    DateTimeParts parts;
+    if ((format == DateFormat::Rfc1123
+         && TryParseRfc1123FixedLayout(dateTime.data(), dateTime.size(), &parts))
+        || (format == DateFormat::Rfc3339
+            && TryParseRfc3339FixedLayout(dateTime.data(), dateTime.size(), &parts)))
+    {
+      return DateTime(
+          parts.Year,
+          parts.Month,
+          parts.Day,
+          parts.Hour,
+          parts.Minute,
+          parts.Second,
+          parts.FracSec,
+          parts.DayOfWeek,
+          0,
+          0,
+          false);
+    }
+  }
+
   // The values that are not supposed to be read before they are written are set to -123... to avoid
   // warnings on some compilers, yet provide a clearly bad value to make it obvious if things don't
   // work as expected.
@@ -834,15 +983,28 @@ std::string DateTime::ToStringRfc1123() const
 
   GetDateTimeParts(&year, &month, &day, &hour, &minute, &second, &fracSec, &dayOfWeek);
 
-  std::ostringstream dateString;
-
-  dateString << DayNames[dayOfWeek] << ", " << std::setfill('0') << std::setw(2)
-             << static_cast<int>(day) << ' ' << MonthNames[month - 1] << ' ' << std::setw(4)
-             << static_cast<int>(year) << ' ' << std::setw(2) << static_cast<int>(hour) << ':'
-             << std::setw(2) << static_cast<int>(minute) << ':' << std::setw(2)
-             << static_cast<int>(second) << " GMT";
-
-  return dateString.str();
+  // "Sun, 06 Nov 1994 08:49:37 GMT"
+  char dateString[29];
+  auto out = std::copy(DayNames[dayOfWeek].begin(), DayNames[dayOfWeek].end(), dateString);
+  *out++ = ',';
+  *out++ = ' ';
+  out = WriteDigits(out, day, 2);
+  *out++ = ' ';
+  out = std::copy(MonthNames[month - 1].begin(), MonthNames[month - 1].end(), out);
+  *out++ = ' ';
+  out = WriteDigits(out, year, 4);
+  *out++ = ' ';
+  out = WriteDigits(out, hour, 2);
+  *out++ = ':';
+  out = WriteDigits(out, minute, 2);
+  *out++ = ':';
+  out = WriteDigits(out, second, 2);
+  *out++ = ' ';
+  *out++ = 'G';
+  *out++ = 'M';
+  *out++ = 'T';
+
+  return std::string(dateString, out);
 }
 
 std::string DateTime::ToString(DateFormat format) const
@@ -879,37 +1041,42 @@ std::string DateTime::ToString(DateFormat format, TimeFractionFormat fractionFor
 
   GetDateTimeParts(&year, &month, &day, &hour, &minute, &second, &fracSec, &dayOfWeek);
 
-  std::ostringstream dateString;
-
-  dateString << std::setfill('0') << std::setw(4) << static_cast<int>(year) << '-' << std::setw(2)
-             << static_cast<int>(month) << '-' << std::setw(2) << static_cast<int>(day) << 'T'
-             << std::setw(2) << static_cast<int>(hour) << ':' << std::setw(2)
-             << static_cast<int>(minute) << ':' << std::setw(2) << static_cast<int>(second);
+  // "2021-01-01T08:49:37.1234567Z"
+  char dateString[28];
+  auto out = WriteDigits(dateString, year, 4);
+  *out++ = '-';
+  out = WriteDigits(out, month, 2);
+  *out++ = '-';
+  out = WriteDigits(out, day, 2);
+  *out++ = 'T';
+  out = WriteDigits(out, hour, 2);
+  *out++ = ':';
+  out = WriteDigits(out, minute, 2);
+  *out++ = ':';
+  out = WriteDigits(out, second, 2);
 
   if (fractionFormat == TimeFractionFormat::AllDigits)
   {
-    dateString << '.' << std::setw(7) << static_cast<int>(fracSec);
+    *out++ = '.';
+    out = WriteDigits(out, fracSec, 7);
   }
   else if (fracSec != 0 && fractionFormat != TimeFractionFormat::Truncate)
   {
     // Append fractional second, which is a 7-digit value with no trailing zeros
     // This way, '0001200' becomes '00012'
-    auto setw = 1;
+    auto digits = 7;
     auto frac = fracSec;
-    for (auto div = 1000000; div >= 1; div /= 10)
+    while ((frac % 10) == 0)
     {
-      if ((fracSec % div) == 0)
-      {
-        frac /= div;
-        break;
-      }
-      ++setw;
+      frac /= 10;
+      --digits;
     }
 
-    dateString << '.' << std::setw(setw) << static_cast<int>(frac);
+    *out++ = '.';
+    out = WriteDigits(out, frac, digits);
   }
 
-  dateString << 'Z';
+  *out++ = 'Z';
 
-  return dateString.str();
+  return std::string(dateString, out);
 }
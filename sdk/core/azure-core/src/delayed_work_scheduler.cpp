@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/delayed_work_scheduler.hpp"
+
+#include <utility>
+
+using Azure::Core::Context;
+using Azure::Core::_detail::ContextCancellationRegistration;
+using Azure::Core::_detail::DelayedWorkScheduler;
+
+DelayedWorkScheduler::DelayedWorkScheduler()
+{
+  // Started once all the members are constructed, the timer hands work to the workers.
+  m_timer = std::thread([this]() { RunTimer(); });
+}
+
+DelayedWorkScheduler& DelayedWorkScheduler::GetInstance()
+{
+  static DelayedWorkScheduler scheduler;
+  return scheduler;
+}
+
+DelayedWorkScheduler::~DelayedWorkScheduler()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopRequested = true;
+  }
+  m_condition.notify_all();
+  m_timer.join();
+
+  {
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    m_workersStopRequested = true;
+  }
+  m_workAdded.notify_all();
+  for (auto& worker : m_workers)
+  {
+    worker.join();
+  }
+
+  // The work still waiting is dropped, its registrations are released without holding m_mutex.
+  m_scheduledById.clear();
+  m_scheduled.clear();
+}
+
+void DelayedWorkScheduler::OnContextCancelled() noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancellationNotified = true;
+  }
+  m_condition.notify_all();
+}
+
+DelayedWorkScheduler::WorkId DelayedWorkScheduler::Add(
+    std::chrono::milliseconds delay,
+    std::unique_ptr<Context> context,
+    std::function<void()> work)
+{
+  std::unique_ptr<ContextCancellationRegistration> registration;
+  if (context)
+  {
+    registration = std::make_unique<ContextCancellationRegistration>(*context, this);
+  }
+
+  WorkId id;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // A context cancelled before the registration doesn't notify the scheduler.
+    auto const now = std::chrono::steady_clock::now();
+    auto const due = context && context->IsCancelled() ? now : now + delay;
+    id = m_nextId++;
+    auto const scheduled = m_scheduled.emplace(
+        due, ScheduledWork{id, std::move(context), std::move(work), std::move(registration)});
+    m_scheduledById.emplace(id, scheduled);
+  }
+  m_condition.notify_all();
+  return id;
+}
+
+DelayedWorkScheduler::WorkId DelayedWorkScheduler::Schedule(
+    std::chrono::milliseconds delay,
+    Context const& context,
+    std::function<void()> work)
+{
+  return Add(delay, std::make_unique<Context>(context), std::move(work));
+}
+
+DelayedWorkScheduler::WorkId DelayedWorkScheduler::Schedule(
+    std::chrono::milliseconds delay,
+    std::function<void()> work)
+{
+  return Add(delay, nullptr, std::move(work));
+}
+
+bool DelayedWorkScheduler::Unschedule(WorkId id)
+{
+  ScheduledWork removed{};
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const scheduled = m_scheduledById.find(id);
+    if (scheduled == m_scheduledById.end())
+    {
+      return false;
+    }
+    removed = std::move(scheduled->second->second);
+    m_scheduled.erase(scheduled->second);
+    m_scheduledById.erase(scheduled);
+  }
+  // The registration of the removed work is released here, without holding m_mutex.
+  return true;
+}
+
+void DelayedWorkScheduler::RunTimer()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stopRequested)
+  {
+    // The work whose delay has elapsed, or whose context was cancelled.
+    std::vector<ScheduledWork> due;
+    auto const now = std::chrono::steady_clock::now();
+    bool const cancellationNotified = m_cancellationNotified;
+    m_cancellationNotified = false;
+    for (auto scheduled = m_scheduled.begin(); scheduled != m_scheduled.end();)
+    {
+      auto const& workContext = scheduled->second.WorkContext;
+      if (scheduled->first <= now
+          || (cancellationNotified && workContext && workContext->IsCancelled()))
+      {
+        m_scheduledById.erase(scheduled->second.Id);
+        due.emplace_back(std::move(scheduled->second));
+        scheduled = m_scheduled.erase(scheduled);
+      }
+      else if (!cancellationNotified)
+      {
+        break;
+      }
+      else
+      {
+        ++scheduled;
+      }
+    }
+
+    if (!due.empty())
+    {
+      lock.unlock();
+      Dispatch(std::move(due));
+      lock.lock();
+      continue;
+    }
+
+    if (m_scheduled.empty())
+    {
+      m_condition.wait(lock);
+    }
+    else
+    {
+      m_condition.wait_until(lock, m_scheduled.begin()->first);
+    }
+  }
+}
+
+void DelayedWorkScheduler::Dispatch(std::vector<ScheduledWork> due)
+{
+  for (auto& scheduled : due)
+  {
+    scheduled.Registration.reset();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    for (auto& scheduled : due)
+    {
+      m_work.emplace_back(std::move(scheduled.Work));
+    }
+    // Each piece of work gets a worker of its own while there are fewer than MaxWorkers.
+    while (m_idleWorkers < m_work.size() && m_workers.size() < MaxWorkers)
+    {
+      m_workers.emplace_back([this]() { RunWorker(); });
+      m_idleWorkers += 1;
+    }
+  }
+  m_workAdded.notify_all();
+}
+
+void DelayedWorkScheduler::RunWorker()
+{
+  std::unique_lock<std::mutex> lock(m_workersMutex);
+  for (;;)
+  {
+    m_workAdded.wait(lock, [this]() { return m_workersStopRequested || !m_work.empty(); });
+    if (m_workersStopRequested)
+    {
+      break;
+    }
+    auto work = std::move(m_work.front());
+    m_work.pop_front();
+    m_idleWorkers -= 1;
+    lock.unlock();
+
+    work();
+    // The work is released before the worker is idle again, it may hold resources of its caller.
+    work = nullptr;
+
+    lock.lock();
+    m_idleWorkers += 1;
+  }
+}
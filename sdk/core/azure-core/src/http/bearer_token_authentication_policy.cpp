@@ -3,29 +3,225 @@
 
 #include "azure/core/http/policies/policy.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <iterator>
+#include <map>
+#include <shared_mutex>
+#include <thread>
 
 using Azure::Core::Context;
 using namespace Azure::Core::Http;
 using namespace Azure::Core::Http::Policies;
 using namespace Azure::Core::Http::Policies::_internal;
+using Azure::Core::Credentials::AccessToken;
+using Azure::Core::Credentials::TokenCredential;
+using Azure::Core::Credentials::TokenRequestContext;
 
-std::unique_ptr<RawResponse> BearerTokenAuthenticationPolicy::Send(
-    Request& request,
-    NextHttpPolicy nextPolicy,
-    Context const& context) const
+namespace Azure { namespace Core { namespace Http { namespace Policies { namespace _detail {
+  struct CachedAccessToken final
+  {
+    // Held shared to read Token, and exclusively to replace it.
+    std::shared_timed_mutex TokenMutex;
+    AccessToken Token;
+
+    // Held while getting a token on the request path, so concurrent requests with no valid token
+    // wait for a single call to the credential.
+    std::mutex RefreshMutex;
+    std::atomic<bool> BackgroundRefreshing{false};
+
+    // Refreshes the token before it expires, while the requests keep using it. The thread is
+    // started by a request and joined when the cached token is destroyed, or before starting the
+    // next refresh. RefreshThreadMutex guards RefreshThread.
+    std::mutex RefreshThreadMutex;
+    std::thread RefreshThread;
+    Context RefreshContext;
+
+    ~CachedAccessToken()
+    {
+      // The token isn't used anymore, there is no point in waiting for the refresh.
+      RefreshContext.Cancel();
+      if (RefreshThread.joinable())
+      {
+        RefreshThread.join();
+      }
+    }
+
+    void SetToken(AccessToken token)
+    {
+      std::unique_lock<std::shared_timed_mutex> lock(TokenMutex);
+      // A refresh which started earlier may complete later with an older token.
+      if (token.ExpiresOn > Token.ExpiresOn)
+      {
+        Token = std::move(token);
+      }
+    }
+  };
+}}}}} // namespace Azure::Core::Http::Policies::_detail
+
+using Azure::Core::Http::Policies::_detail::CachedAccessToken;
+
+namespace {
+// The requests don't use a token expiring in less than this, they get a new one.
+constexpr auto TokenRefreshMargin = std::chrono::minutes(2);
+// A token expiring in less than this gets refreshed in the background, while it is still used.
+constexpr auto TokenBackgroundRefreshMargin = std::chrono::minutes(3);
+
+struct TokenCacheKey final
+{
+  std::weak_ptr<TokenCredential const> Credential;
+  std::string Scopes;
+};
+
+struct TokenCacheKeyLess final
 {
+  bool operator()(TokenCacheKey const& lhs, TokenCacheKey const& rhs) const
   {
-    std::lock_guard<std::mutex> lock(m_accessTokenMutex);
+    // The credentials are ordered by ownership, so a credential allocated where a destroyed one was
+    // doesn't get its tokens.
+    if (lhs.Credential.owner_before(rhs.Credential))
+    {
+      return true;
+    }
+    if (rhs.Credential.owner_before(lhs.Credential))
+    {
+      return false;
+    }
+    return lhs.Scopes < rhs.Scopes;
+  }
+};
+
+std::shared_ptr<CachedAccessToken> GetCachedAccessToken(
+    std::shared_ptr<TokenCredential const> const& credential,
+    TokenRequestContext const& tokenRequestContext)
+{
+  // The cache is kept in function statics, so policies can be created during static
+  // initialization.
+  static std::mutex cacheMutex;
+  static std::map<TokenCacheKey, std::shared_ptr<CachedAccessToken>, TokenCacheKeyLess> cache;
+
+  std::string scopes;
+  for (auto const& scope : tokenRequestContext.Scopes)
+  {
+    // Scopes don't contain spaces, the list is sent space-separated to the identity provider.
+    scopes += scope + ' ';
+  }
 
-    // Refresh the token in 2 or less minutes before the actual expiration.
-    if (std::chrono::system_clock::now() > (m_accessToken.ExpiresOn - std::chrono::minutes(2)))
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto& cachedAccessToken = cache[TokenCacheKey{credential, std::move(scopes)}];
+  if (!cachedAccessToken)
+  {
+    // The tokens of the destroyed credentials can't be used anymore.
+    for (auto entry = cache.begin(); entry != cache.end();)
     {
-      m_accessToken = m_credential->GetToken(m_tokenRequestContext, context);
+      entry = entry->first.Credential.expired() ? cache.erase(entry) : std::next(entry);
     }
+    cachedAccessToken = std::make_shared<CachedAccessToken>();
+  }
+  return cachedAccessToken;
+}
 
-    request.SetHeader("authorization", "Bearer " + m_accessToken.Token);
+void StartBackgroundRefresh(
+    CachedAccessToken& cachedAccessToken,
+    std::shared_ptr<TokenCredential const> const& credential,
+    TokenRequestContext const& tokenRequestContext)
+{
+  if (cachedAccessToken.BackgroundRefreshing.exchange(true))
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(cachedAccessToken.RefreshThreadMutex);
+  if (cachedAccessToken.RefreshThread.joinable())
+  {
+    // The previous refresh is done, its thread is only ending.
+    cachedAccessToken.RefreshThread.join();
   }
 
+  // The cached token joins the thread before it is destroyed. The thread owns the credential,
+  // the policy may be destroyed before the refresh completes.
+  cachedAccessToken.RefreshThread
+      = std::thread([&cachedAccessToken, credential, tokenRequestContext]() {
+          try
+          {
+            cachedAccessToken.SetToken(
+                credential->GetToken(tokenRequestContext, cachedAccessToken.RefreshContext));
+          }
+          catch (...)
+          {
+            // The token is still valid. If refreshing keeps failing, the requests get the error
+            // when the token is about to expire and they refresh it themselves.
+          }
+          cachedAccessToken.BackgroundRefreshing = false;
+        });
+}
+} // namespace
+
+BearerTokenAuthenticationPolicy::BearerTokenAuthenticationPolicy(
+    std::shared_ptr<TokenCredential const> credential,
+    TokenRequestContext tokenRequestContext)
+    : m_credential(std::move(credential)), m_tokenRequestContext(std::move(tokenRequestContext)),
+      m_cachedAccessToken(GetCachedAccessToken(m_credential, m_tokenRequestContext))
+{
+}
+
+void BearerTokenAuthenticationPolicy::AuthorizeRequest(Request& request, Context const& context)
+    const
+{
+  auto& cachedAccessToken = *m_cachedAccessToken;
+
+  AccessToken accessToken;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(cachedAccessToken.TokenMutex);
+    accessToken = cachedAccessToken.Token;
+  }
+
+  auto const now = std::chrono::system_clock::now();
+  if (now > (accessToken.ExpiresOn - TokenRefreshMargin))
+  {
+    std::lock_guard<std::mutex> refreshLock(cachedAccessToken.RefreshMutex);
+    {
+      // Another request may have got a token while this one was waiting.
+      std::shared_lock<std::shared_timed_mutex> lock(cachedAccessToken.TokenMutex);
+      accessToken = cachedAccessToken.Token;
+    }
+    if (std::chrono::system_clock::now() > (accessToken.ExpiresOn - TokenRefreshMargin))
+    {
+      accessToken = m_credential->GetToken(m_tokenRequestContext, context);
+      cachedAccessToken.SetToken(accessToken);
+    }
+  }
+  else if (now > (accessToken.ExpiresOn - TokenBackgroundRefreshMargin))
+  {
+    StartBackgroundRefresh(cachedAccessToken, m_credential, m_tokenRequestContext);
+  }
+
+  request.SetHeader("authorization", "Bearer " + accessToken.Token);
+}
+
+std::unique_ptr<RawResponse> BearerTokenAuthenticationPolicy::Send(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context) const
+{
+  AuthorizeRequest(request, context);
   return nextPolicy.Send(request, context);
 }
+
+void BearerTokenAuthenticationPolicy::SendAsync(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context,
+    ResponseCallback callback) const
+{
+  try
+  {
+    AuthorizeRequest(request, context);
+  }
+  catch (...)
+  {
+    callback(nullptr, std::current_exception());
+    return;
+  }
+  nextPolicy.SendAsync(request, context, std::move(callback));
+}
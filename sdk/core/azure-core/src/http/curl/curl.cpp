@@ -4,18 +4,27 @@
 #include "azure/core/http/curl_transport.hpp"
 #include "azure/core/http/http.hpp"
 #include "azure/core/http/policies/policy.hpp"
+#include "azure/core/http/traffic_class.hpp"
 #include "azure/core/http/transport.hpp"
 #include "azure/core/internal/diagnostics/log.hpp"
 #include "azure/core/platform.hpp"
 
 // Private include
+#include "../../private/context_cancellation.hpp"
 #include "curl_connection_pool_private.hpp"
 #include "curl_connection_private.hpp"
 #include "curl_session_private.hpp"
 
 #if defined(AZ_PLATFORM_POSIX)
+#include <cerrno>
+#include <arpa/inet.h> // for inet_ntop()
+#include <fcntl.h> // for fcntl()
+#include <netdb.h> // for getaddrinfo()
+#include <netinet/in.h>
+#include <netinet/tcp.h> // for TCP_CONGESTION
 #include <poll.h> // for poll()
 #include <sys/socket.h> // for socket shutdown
+#include <unistd.h> // for pipe()
 #elif defined(AZ_PLATFORM_WINDOWS)
 #if !defined(WIN32_LEAN_AND_MEAN)
 #define WIN32_LEAN_AND_MEAN
@@ -24,15 +33,33 @@
 #define NOMINMAX
 #endif
 #include <winsock2.h> // for WSAPoll();
+#include <ws2tcpip.h> // for getaddrinfo()
 #endif
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <limits>
 #include <string>
 #include <thread>
 
 namespace {
 std::string const LogMsgPrefix = "[CURL Transport Adapter]: ";
 
+// Writes a verbose message of the transport. The message is only built when verbose logging is
+// enabled, so sending a request doesn't allocate the log strings otherwise.
+inline void WriteVerboseLog(char const* message)
+{
+  using Azure::Core::Diagnostics::Logger;
+  using Azure::Core::Diagnostics::_internal::Log;
+  if (Log::ShouldWrite(Logger::Level::Verbose))
+  {
+    Log::Write(Logger::Level::Verbose, LogMsgPrefix + message);
+  }
+}
+
 template <typename T>
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -54,6 +81,66 @@ enum class PollSocketDirection
   Write = 2,
 };
 
+#if defined(AZ_PLATFORM_POSIX)
+/**
+ * @brief A pipe which becomes readable when a context is cancelled, so a thread waiting on poll()
+ * wakes up right away.
+ *
+ * @remark Each thread creates one the first time it waits on a socket and keeps it until it ends.
+ */
+class PollCancellationPipe final : public Azure::Core::_detail::ContextCancellationListener {
+private:
+  int m_fileDescriptors[2] = {-1, -1};
+
+public:
+  PollCancellationPipe()
+  {
+    if (pipe(m_fileDescriptors) != 0)
+    {
+      m_fileDescriptors[0] = m_fileDescriptors[1] = -1;
+      return;
+    }
+    for (auto fileDescriptor : m_fileDescriptors)
+    {
+      fcntl(fileDescriptor, F_SETFL, fcntl(fileDescriptor, F_GETFL) | O_NONBLOCK);
+      fcntl(fileDescriptor, F_SETFD, FD_CLOEXEC);
+    }
+  }
+
+  ~PollCancellationPipe()
+  {
+    if (m_fileDescriptors[0] >= 0)
+    {
+      close(m_fileDescriptors[0]);
+      close(m_fileDescriptors[1]);
+    }
+  }
+
+  PollCancellationPipe(PollCancellationPipe const&) = delete;
+  PollCancellationPipe& operator=(PollCancellationPipe const&) = delete;
+
+  // -1 when the pipe could not be created.
+  int GetReadFileDescriptor() const { return m_fileDescriptors[0]; }
+
+  // Discards the notifications received before the thread starts waiting.
+  void Drain()
+  {
+    char buffer[64];
+    while (read(m_fileDescriptors[0], buffer, sizeof(buffer)) > 0)
+    {
+    }
+  }
+
+  void OnContextCancelled() noexcept override
+  {
+    // When the pipe is full, the waiting thread is already being woken up.
+    char const notification = 0;
+    auto const written = write(m_fileDescriptors[1], &notification, 1);
+    static_cast<void>(written);
+  }
+};
+#endif
+
 /**
  * @brief Use poll from OS to check if socket is ready to be read or written.
  *
@@ -64,6 +151,8 @@ enum class PollSocketDirection
  *
  * @return int with negative 1 upon any error, 0 on timeout or greater than zero if events were
  * detected (socket ready to be written/read)
+ *
+ * @throw #Azure::Core::OperationCancelledException if \p context is cancelled while waiting.
  */
 int pollSocketUntilEventOrTimeout(
     Azure::Core::Context const& context,
@@ -89,6 +178,60 @@ int pollSocketUntilEventOrTimeout(
     poller.events = POLLOUT;
   }
 
+#if defined(AZ_PLATFORM_POSIX)
+  // Poll the socket together with a pipe which is written when a context is cancelled, so the
+  // cancellation is noticed right away instead of on the next poll() interval.
+  thread_local PollCancellationPipe cancellationPipe;
+  if (cancellationPipe.GetReadFileDescriptor() >= 0)
+  {
+    using std::chrono::milliseconds;
+    Azure::Core::_detail::ContextCancellationRegistration registration(
+        context, &cancellationPipe);
+
+    struct pollfd pollers[2] = {poller, {}};
+    pollers[1].fd = cancellationPipe.GetReadFileDescriptor();
+    pollers[1].events = POLLIN;
+
+    auto const end = std::chrono::steady_clock::now() + milliseconds(timeout);
+    for (;;)
+    {
+      // The registration is done before draining, so a cancellation happening from now on either
+      // shows up in the check below or makes the pipe readable.
+      cancellationPipe.Drain();
+      context.ThrowIfCancelled();
+
+      auto const now = std::chrono::steady_clock::now();
+      if (now >= end)
+      {
+        return 0;
+      }
+      // Round up, so a remaining time below a millisecond doesn't become a busy loop.
+      auto wait = std::chrono::duration_cast<milliseconds>(end - now) + milliseconds(1);
+
+      // A context also gets cancelled when its deadline passes, that doesn't notify the pipe.
+      auto const deadline = context.GetDeadline();
+      auto const systemNow = std::chrono::system_clock::now();
+      if (deadline < systemNow + wait)
+      {
+        wait = std::chrono::duration_cast<milliseconds>(
+                   static_cast<std::chrono::system_clock::time_point>(deadline) - systemNow)
+            + milliseconds(1);
+      }
+
+      auto const result = poll(pollers, 2, static_cast<int>(wait.count()));
+      if (result < 0 && errno != EINTR)
+      {
+        return result;
+      }
+      if (result > 0 && pollers[0].revents != 0)
+      {
+        return 1;
+      }
+      // Woken up by a cancellation, a deadline or a signal. Check again.
+    }
+  }
+#endif
+
   // Call poll with the poller struct. Poll can handle multiple file descriptors by making an
   // pollfd array and passing the size of it as the second arg. Since we are only passing one fd,
   // we use 1 as arg.
@@ -155,117 +298,48 @@ void static inline SetHeader(Azure::Core::Http::RawResponse& response, std::stri
       reinterpret_cast<uint8_t const*>(header.data() + header.size()));
 }
 
-static inline std::string GetHeadersAsString(Azure::Core::Http::Request const& request)
-{
-  std::string requestHeaderString;
-
-  for (auto const& header : request.GetHeaders())
-  {
-    requestHeaderString += header.first; // string (key)
-    requestHeaderString += ": ";
-    requestHeaderString += header.second; // string's value
-    requestHeaderString += "\r\n";
-  }
-  requestHeaderString += "\r\n";
-
-  return requestHeaderString;
-}
-
 // Writes an HTTP request with RFC 7230 without the body (head line and headers)
 // https://tools.ietf.org/html/rfc7230#section-3.1.1
 static inline std::string GetHTTPMessagePreBody(Azure::Core::Http::Request const& request)
 {
-  std::string httpRequest(request.GetMethod().ToString());
-  // HTTP version hardcoded to 1.1
+  using Azure::Core::Http::_detail::RequestHelpers;
+
+  auto const& method = request.GetMethod().ToString();
   auto const url = request.GetUrl().GetRelativeUrl();
-  httpRequest += " /" + url + " HTTP/1.1\r\n";
+  constexpr char const Version[] = " HTTP/1.1\r\n";
+
+  // The size of the message is computed first so it is written with a single allocation.
+  auto size = method.size() + 2 + url.size() + sizeof(Version) - 1 + 2;
+  RequestHelpers::ForEachHeader(
+      request, [&size](std::string const& name, std::string const& value) {
+        size += name.size() + 2 + value.size() + 2;
+      });
+
+  std::string httpRequest;
+  httpRequest.reserve(size);
+  httpRequest += method;
+  // HTTP version hardcoded to 1.1
+  httpRequest += " /";
+  httpRequest += url;
+  httpRequest += Version;
 
   // headers
-  httpRequest += GetHeadersAsString(request);
+  RequestHelpers::ForEachHeader(
+      request, [&httpRequest](std::string const& name, std::string const& value) {
+        httpRequest += name; // string (key)
+        httpRequest += ": ";
+        httpRequest += value; // string's value
+        httpRequest += "\r\n";
+      });
+  httpRequest += "\r\n";
 
   return httpRequest;
 }
-
-static void CleanupThread()
-{
-  using namespace Azure::Core::Http::_detail;
-  for (;;)
-  {
-    Log::Write(Logger::Level::Verbose, "Clean pool check now...");
-    // Won't continue until the ConnectionPoolMutex is released from MoveConnectionBackToPool
-    std::unique_lock<std::mutex> lockForPoolCleaning(
-        CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
-    Log::Write(Logger::Level::Verbose, "Clean pool sleep");
-    // Wait for the default time OR to the signal from the conditional variable.
-    // wait_for releases the mutex lock when it goes to sleep and it takes the lock again when it
-    // wakes up (or it's cancelled).
-    if (CurlConnectionPool::g_curlConnectionPool.ConditionalVariableForCleanThread.wait_for(
-            lockForPoolCleaning,
-            std::chrono::milliseconds(DefaultCleanerIntervalMilliseconds),
-            []() {
-              return CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.size() == 0;
-            }))
-    {
-      // Cancelled by another thead or no connections on wakeup
-      Log::Write(
-          Logger::Level::Verbose,
-          "Clean pool - no connections on wake - return *************************");
-      CurlConnectionPool::g_curlConnectionPool.IsCleanThreadRunning = false;
-      break;
-    }
-
-    decltype(CurlConnectionPool::g_curlConnectionPool
-                 .ConnectionPoolIndex)::mapped_type connectionsToBeCleaned;
-
-    Log::Write(Logger::Level::Verbose, "Clean pool - inspect pool");
-    // loop the connection pool index - Note: lock is re-taken for the mutex
-    // Notes: The size of each host-index is always expected to be greater than 0 because the
-    // host-index is removed anytime it becomes empty.
-    for (auto index = CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.begin();
-         index != CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.end();)
-    {
-      // Each pool index behaves as a Last-in-First-out (connections are added to the pool with
-      // push_front). The last connection moved to the pool will be the first to be re-used. Because
-      // of this, the oldest connection in the pool can be found at the end of the list. Looping the
-      // connection pool backwards until a connection that is not expired is found or until all
-      // connections are removed.
-      auto& connectionList = index->second;
-      auto connectionIter = connectionList.end();
-      while (connectionIter != connectionList.begin())
-      {
-        --connectionIter;
-        if ((*connectionIter)->IsExpired())
-        {
-          // remove connection from the pool and update the connection to the next one
-          // which is going to be list.end()
-          connectionsToBeCleaned.emplace_back(std::move(*connectionIter));
-          connectionIter = connectionList.erase(connectionIter);
-        }
-        else
-        {
-          break;
-        }
-      }
-
-      if (connectionList.empty())
-      {
-        Log::Write(Logger::Level::Verbose, "Clean pool - remove index " + index->first);
-        index = CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.erase(index);
-      }
-      else
-      {
-        ++index;
-      }
-    }
-
-    lockForPoolCleaning.unlock();
-    // Do actual connections release work here, without holding the mutex.
-  }
-}
 } // namespace
 
 using Azure::Core::Context;
 using Azure::Core::Http::CurlConnection;
+using Azure::Core::Http::CurlConnectionPoolEvictionPolicy;
 using Azure::Core::Http::CurlNetworkConnection;
 using Azure::Core::Http::CurlSession;
 using Azure::Core::Http::CurlTransport;
@@ -275,19 +349,102 @@ using Azure::Core::Http::RawResponse;
 using Azure::Core::Http::Request;
 using Azure::Core::Http::TransportException;
 using Azure::Core::Http::_detail::CurlConnectionPool;
+using Azure::Core::Http::_detail::CurlConnectionPoolHostStatistics;
+using Azure::Core::Http::_detail::CurlConnectionPoolOptions;
 
 Azure::Core::Http::_detail::CurlConnectionPool
     Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool;
 
+void Azure::Core::Http::_detail::EnsureCurlGlobalInit()
+{
+  CurlConnectionPool::g_curlConnectionPool.EnsureGlobalInit();
+}
+
+void CurlConnectionPool::GlobalInit()
+{
+  if (m_isIsolated)
+  {
+    g_curlConnectionPool.EnsureGlobalInit();
+  }
+  else
+  {
+    curl_global_init(CURL_GLOBAL_ALL);
+  }
+
+  // The connections can still be created without the share handle, each one doing its own DNS
+  // resolution and full TLS handshake.
+  m_shareHandle = curl_share_init();
+  if (m_shareHandle == nullptr)
+  {
+    return;
+  }
+  if (curl_share_setopt(m_shareHandle, CURLSHOPT_LOCKFUNC, LockShare) != CURLSHE_OK
+      || curl_share_setopt(m_shareHandle, CURLSHOPT_UNLOCKFUNC, UnlockShare) != CURLSHE_OK
+      || curl_share_setopt(m_shareHandle, CURLSHOPT_USERDATA, this) != CURLSHE_OK
+      || curl_share_setopt(m_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION)
+          != CURLSHE_OK
+      || curl_share_setopt(m_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) != CURLSHE_OK)
+  {
+    curl_share_cleanup(m_shareHandle);
+    m_shareHandle = nullptr;
+  }
+}
+
+void CurlConnectionPool::LockShare(CURL*, curl_lock_data data, curl_lock_access, void* userPointer)
+{
+  static_cast<CurlConnectionPool*>(userPointer)->m_shareMutexes[data].lock();
+}
+
+void CurlConnectionPool::UnlockShare(CURL*, curl_lock_data data, void* userPointer)
+{
+  static_cast<CurlConnectionPool*>(userPointer)->m_shareMutexes[data].unlock();
+}
+
+CurlTransport::CurlTransport(CurlTransportOptions const& options) : m_options(options)
+{
+  if (options.IsolatedConnectionPool)
+  {
+    m_connectionPool = CurlConnectionPool::CreateIsolatedPool();
+  }
+}
+
+void CurlTransport::WarmUp(Azure::Core::Url const& url, size_t connectionCount)
+{
+  auto& connectionPool
+      = m_connectionPool ? *m_connectionPool : CurlConnectionPool::g_curlConnectionPool;
+  connectionPool.WarmUp(url, m_options, connectionCount);
+}
+
+Azure::Core::Http::ConnectionPoolStatistics CurlTransport::GetConnectionPoolStatistics() const
+{
+  auto& connectionPool
+      = m_connectionPool ? *m_connectionPool : CurlConnectionPool::g_curlConnectionPool;
+  return connectionPool.GetConnectionPoolStatistics();
+}
+
 std::unique_ptr<RawResponse> CurlTransport::Send(Request& request, Context const& context)
 {
+  // The metrics policy asks for the metrics of the connection used by the request.
+  Diagnostics::_detail::TransferMetrics* transferMetrics = nullptr;
+  context.TryGetValue(Diagnostics::_detail::TransferMetrics::ContextKey, transferMetrics);
+  auto const trafficClass = GetTrafficClass(context).ValueOr(TrafficClass::Interactive);
+  auto& connectionPool
+      = m_connectionPool ? *m_connectionPool : CurlConnectionPool::g_curlConnectionPool;
+  auto const createSession = [&](bool resetPool) {
+    auto connection = connectionPool.ExtractOrCreateCurlConnection(
+        request, m_options, resetPool, trafficClass);
+    if (transferMetrics != nullptr)
+    {
+      connection->GetTransferMetrics(*transferMetrics);
+    }
+    return std::make_unique<CurlSession>(
+        request, std::move(connection), m_options, m_connectionPool);
+  };
+
   // Create CurlSession to perform request
-  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Creating a new session.");
+  WriteVerboseLog("Creating a new session.");
 
-  auto session = std::make_unique<CurlSession>(
-      request,
-      CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(request, m_options),
-      m_options.HttpKeepAlive);
+  auto session = createSession(false);
 
   CURLcode performing;
 
@@ -309,13 +466,8 @@ std::unique_ptr<RawResponse> CurlTransport::Send(Request& request, Context const
     // clean (remove connections) and create a new one. This is because, keep getting connections
     // that fail to perform means a general network disconnection where all connections in the pool
     // won't be no longer valid.
-    session = std::make_unique<CurlSession>(
-        request,
-        CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(
-            request,
-            m_options,
-            getConnectionOpenIntent + 1 >= _detail::RequestPoolResetAfterConnectionFailed),
-        m_options.HttpKeepAlive);
+    session = createSession(
+        getConnectionOpenIntent + 1 >= _detail::RequestPoolResetAfterConnectionFailed);
   }
 
   if (performing != CURLE_OK)
@@ -324,9 +476,7 @@ std::unique_ptr<RawResponse> CurlTransport::Send(Request& request, Context const
         "Error while sending request. " + std::string(curl_easy_strerror(performing)));
   }
 
-  Log::Write(
-      Logger::Level::Verbose,
-      LogMsgPrefix + "Request completed. Moving response out of session and session to response.");
+  WriteVerboseLog("Request completed. Moving response out of session and session to response.");
 
   // Move Response out of the session
   auto response = session->ExtractResponse();
@@ -342,81 +492,101 @@ CURLcode CurlSession::Perform(Context const& context)
 
   // libcurl settings after connection is open (headers)
   {
-    auto headers = this->m_request.GetHeaders();
-    auto hostHeader = headers.find("Host");
-    if (hostHeader == headers.end())
+    using Azure::Core::Http::_detail::RequestHelpers;
+    if (RequestHelpers::FindHeader(this->m_request, "Host") == nullptr)
     {
-      Log::Write(Logger::Level::Verbose, LogMsgPrefix + "No Host in request headers. Adding it");
+      WriteVerboseLog("No Host in request headers. Adding it");
       this->m_request.SetHeader("Host", this->m_request.GetUrl().GetHost());
     }
-    auto isContentLengthHeaderInRequest = headers.find("content-length");
-    if (isContentLengthHeaderInRequest == headers.end())
+    if (RequestHelpers::FindHeader(this->m_request, "content-length") == nullptr)
     {
-      Log::Write(Logger::Level::Verbose, LogMsgPrefix + "No content-length in headers. Adding it");
-      this->m_request.SetHeader(
-          "content-length", std::to_string(this->m_request.GetBodyStream()->Length()));
+      auto const length = this->m_request.GetBodyStream()->Length();
+      // A body whose length isn't known up front is sent in chunks, as it is read.
+      if (length < 0)
+      {
+        WriteVerboseLog("Unknown body length. Using chunked transfer-encoding");
+        this->m_request.SetHeader("transfer-encoding", "chunked");
+        m_isChunkedRequestType = true;
+      }
+      else
+      {
+        WriteVerboseLog("No content-length in headers. Adding it");
+        this->m_request.SetHeader("content-length", std::to_string(length));
+      }
     }
   }
 
-  // use expect:100 for PUT requests. Server will decide if it can take our request
-  if (this->m_request.GetMethod() == HttpMethod::Put)
+  // Large uploads ask the server to accept the request before the body is sent, so a request the
+  // server rejects, for example because its credentials expired, doesn't cost the upload. A body
+  // of unknown length is treated as a large one.
+  auto const bodyLength = this->m_request.GetBodyStream()->Length();
+  bool const expectContinue = this->m_expectContinueThreshold >= 0
+      && (m_isChunkedRequestType
+          || (bodyLength > 0 && bodyLength >= this->m_expectContinueThreshold));
+  if (expectContinue)
   {
-    Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Using 100-continue for PUT request");
+    WriteVerboseLog("Using 100-continue for large request body");
     this->m_request.SetHeader("expect", "100-continue");
   }
 
   // Send request. If the connection assigned to this curlSession is closed or the socket is
   // somehow lost, libcurl will return CURLE_UNSUPPORTED_PROTOCOL
   // (https://curl.haxx.se/libcurl/c/curl_easy_send.html). Return the error back.
-  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Send request without payload");
+  WriteVerboseLog(expectContinue ? "Send request without payload" : "Send request");
 
-  auto result = SendRawHttp(context);
+  auto result = SendRawHttp(context, expectContinue);
   if (result != CURLE_OK)
   {
     return result;
   }
 
-  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Parse server response");
-  ReadStatusLineAndHeadersFromRawResponse(context);
-
-  // non-PUT request are ready to be stream at this point. Only PUT request would start an uploading
-  // transfer where we want to maintain the `PERFORM` state.
-  if (this->m_request.GetMethod() != HttpMethod::Put)
+  if (expectContinue)
   {
-    m_sessionState = SessionState::STREAMING;
-    return result;
-  }
+    // Some servers never answer before the body is sent, so the body is sent anyway after a short
+    // wait, as RFC 7231 recommends.
+    WriteVerboseLog("Check server response before upload starts");
+    if (m_connection->WaitForResponse(this->m_expectContinueTimeout, context))
+    {
+      ReadStatusLineAndHeadersFromRawResponse(context);
+      // This help to prevent us from start uploading data when Server can't handle it
+      if (this->m_lastStatusCode != HttpStatusCode::Continue)
+      {
+        WriteVerboseLog("Server rejected the upload request");
+        m_sessionState = SessionState::STREAMING;
+        return result; // Won't upload.
+      }
 
-  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Check server response before upload starts");
-  // Check server response from Expect:100-continue for PUT;
-  // This help to prevent us from start uploading data when Server can't handle it
-  if (this->m_lastStatusCode != HttpStatusCode::Continue)
-  {
-    Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Server rejected the upload request");
-    m_sessionState = SessionState::STREAMING;
-    return result; // Won't upload.
-  }
+      if (this->m_bodyStartInBuffer < this->m_innerBufferSize)
+      {
+        // If internal buffer has more data after the 100-continue means Server return an error.
+        // We don't need to upload body, just parse the response from Server and return
+        ReadStatusLineAndHeadersFromRawResponse(context, true);
+        m_sessionState = SessionState::STREAMING;
+        return result;
+      }
+    }
+    else
+    {
+      WriteVerboseLog("No response to 100-continue in time");
+    }
 
-  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Upload payload");
-  if (this->m_bodyStartInBuffer < this->m_innerBufferSize)
-  {
-    // If internal buffer has more data after the 100-continue means Server return an error.
-    // We don't need to upload body, just parse the response from Server and return
-    ReadStatusLineAndHeadersFromRawResponse(context, true);
-    m_sessionState = SessionState::STREAMING;
-    return result;
+    WriteVerboseLog("Upload payload");
+    result = this->UploadBody(context);
+    if (result != CURLE_OK)
+    {
+      m_sessionState = SessionState::STREAMING;
+      return result; // will throw transport exception before trying to read
+    }
   }
 
-  // Start upload
-  result = this->UploadBody(context);
-  if (result != CURLE_OK)
+  WriteVerboseLog("Parse server response");
+  ReadStatusLineAndHeadersFromRawResponse(context);
+  // The server may accept the request after the body started to be sent without waiting for it.
+  while (this->m_lastStatusCode == HttpStatusCode::Continue)
   {
-    m_sessionState = SessionState::STREAMING;
-    return result; // will throw transport exception before trying to read
+    ReadStatusLineAndHeadersFromRawResponse(
+        context, this->m_bodyStartInBuffer < this->m_innerBufferSize);
   }
-
-  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Upload completed. Parse server response");
-  ReadStatusLineAndHeadersFromRawResponse(context);
   // If no throw at this point, the request is ready to stream.
   // If any throw happened before this point, the state will remain as PERFORM.
   m_sessionState = SessionState::STREAMING;
@@ -523,35 +693,121 @@ CURLcode CurlConnection::SendBuffer(
   return CURLE_OK;
 }
 
+namespace {
+// The size line of a chunk, `<size in hex>\r\n`, is at most 16 digits and the line break.
+constexpr size_t MaxChunkSizeLineLength = 18;
+
+// Writes the size line of a chunk of \p size bytes so it ends right before \p end, and returns
+// its length.
+size_t WriteChunkSizeLine(size_t size, uint8_t* end)
+{
+  constexpr char HexDigits[] = "0123456789abcdef";
+  auto begin = end;
+  *--begin = '\n';
+  *--begin = '\r';
+  do
+  {
+    *--begin = static_cast<uint8_t>(HexDigits[size & 0xf]);
+    size >>= 4;
+  } while (size != 0);
+  return static_cast<size_t>(end - begin);
+}
+} // namespace
+
+CURLcode CurlSession::SendBodyChunk(uint8_t const* data, size_t size, Context const& context)
+{
+  if (!m_isChunkedRequestType)
+  {
+    return m_connection->SendBuffer(data, size, context);
+  }
+
+  // The last chunk is empty, and it is followed by the empty line ending the body.
+  uint8_t sizeLine[MaxChunkSizeLineLength];
+  auto const sizeLineLength = WriteChunkSizeLine(size, sizeLine + sizeof(sizeLine));
+  auto sendResult = m_connection->SendBuffer(
+      sizeLine + sizeof(sizeLine) - sizeLineLength, sizeLineLength, context);
+  if (sendResult == CURLE_OK && size > 0)
+  {
+    sendResult = m_connection->SendBuffer(data, size, context);
+  }
+  if (sendResult == CURLE_OK)
+  {
+    sendResult = m_connection->SendBuffer(reinterpret_cast<uint8_t const*>("\r\n"), 2, context);
+  }
+  return sendResult;
+}
+
 CURLcode CurlSession::UploadBody(Context const& context)
 {
-  // Send body UploadStreamPageSize at a time (libcurl default)
-  // NOTE: if stream is on top a contiguous memory, we can avoid allocating this copying buffer
   auto streamBody = this->m_request.GetBodyStream();
   CURLcode sendResult = CURLE_OK;
 
-  auto unique_buffer
-      = std::make_unique<uint8_t[]>(static_cast<size_t>(_detail::DefaultUploadChunkSize));
+  // When the stream is on top of a contiguous memory, send straight from it, without allocating
+  // the copying buffer.
+  if (streamBody->SupportsContiguousRead())
+  {
+    while (true)
+    {
+      uint8_t const* data = nullptr;
+      size_t rawRequestLen
+          = streamBody->ReadContiguous(&data, (std::numeric_limits<size_t>::max)(), context);
+      if (rawRequestLen == 0)
+      {
+        break;
+      }
+      sendResult = SendBodyChunk(data, rawRequestLen, context);
+      if (sendResult != CURLE_OK)
+      {
+        return sendResult;
+      }
+    }
+    return m_isChunkedRequestType ? SendBodyChunk(nullptr, 0, context) : sendResult;
+  }
+
+  // Requests without a body, like most GET requests, don't need the copying buffer either.
+  if (streamBody->Length() == 0)
+  {
+    return sendResult;
+  }
+
+  // Send body UploadStreamPageSize at a time (libcurl default). A chunked body is read after room
+  // for the size line of the chunk, and followed by its line break, so each chunk is sent at once.
+  size_t const chunkPrefixLength = m_isChunkedRequestType ? MaxChunkSizeLineLength : 0;
+  size_t const chunkSuffixLength = m_isChunkedRequestType ? 2 : 0;
+  auto unique_buffer = std::make_unique<uint8_t[]>(
+      chunkPrefixLength + static_cast<size_t>(_detail::DefaultUploadChunkSize)
+      + chunkSuffixLength);
+  uint8_t* const readBuffer = unique_buffer.get() + chunkPrefixLength;
 
   while (true)
   {
-    size_t rawRequestLen
-        = streamBody->Read(unique_buffer.get(), _detail::DefaultUploadChunkSize, context);
+    size_t rawRequestLen = streamBody->Read(readBuffer, _detail::DefaultUploadChunkSize, context);
     if (rawRequestLen == 0)
     {
       break;
     }
-    sendResult = m_connection->SendBuffer(unique_buffer.get(), rawRequestLen, context);
+    if (m_isChunkedRequestType)
+    {
+      auto const sizeLineLength = WriteChunkSizeLine(rawRequestLen, readBuffer);
+      readBuffer[rawRequestLen] = '\r';
+      readBuffer[rawRequestLen + 1] = '\n';
+      sendResult = m_connection->SendBuffer(
+          readBuffer - sizeLineLength, sizeLineLength + rawRequestLen + 2, context);
+    }
+    else
+    {
+      sendResult = m_connection->SendBuffer(readBuffer, rawRequestLen, context);
+    }
     if (sendResult != CURLE_OK)
     {
       return sendResult;
     }
   }
-  return sendResult;
+  return m_isChunkedRequestType ? SendBodyChunk(nullptr, 0, context) : sendResult;
 }
 
 // custom sending to wire an HTTP request
-CURLcode CurlSession::SendRawHttp(Context const& context)
+CURLcode CurlSession::SendRawHttp(Context const& context, bool expectContinue)
 {
   // something like GET /path HTTP1.0 \r\nheaders\r\n
   auto rawRequest = GetHTTPMessagePreBody(this->m_request);
@@ -562,7 +818,7 @@ CURLcode CurlSession::SendRawHttp(Context const& context)
       static_cast<size_t>(rawRequestLen),
       context);
 
-  if (sendResult != CURLE_OK || this->m_request.GetMethod() == HttpMethod::Put)
+  if (sendResult != CURLE_OK || expectContinue)
   {
     return sendResult;
   }
@@ -622,7 +878,7 @@ void CurlSession::ParseChunkSize(Context const& context)
            * indicate the the next read call should read from the inner buffer start.
            */
           this->m_innerBufferSize = m_connection->ReadFromSocket(
-              this->m_readBuffer, _detail::DefaultLibcurlReaderSize, context);
+              this->m_readBuffer.data(), this->m_readBuffer.size(), context);
           this->m_bodyStartInBuffer = 0;
         }
         else
@@ -642,7 +898,7 @@ void CurlSession::ParseChunkSize(Context const& context)
     if (keepPolling)
     { // Read all internal buffer and \n was not found, pull from wire
       this->m_innerBufferSize = m_connection->ReadFromSocket(
-          this->m_readBuffer, _detail::DefaultLibcurlReaderSize, context);
+          this->m_readBuffer.data(), this->m_readBuffer.size(), context);
       this->m_bodyStartInBuffer = 0;
     }
   }
@@ -665,19 +921,24 @@ void CurlSession::ReadStatusLineAndHeadersFromRawResponse(
     {
       // parse from internal buffer. This means previous read from server got more than one
       // response. This happens when Server returns a 100-continue plus an error code
+      // The data left is moved to the start of the buffer, where the positions are counted from.
       bufferSize = this->m_innerBufferSize - this->m_bodyStartInBuffer;
-      bytesParsed = parser.Parse(this->m_readBuffer + this->m_bodyStartInBuffer, bufferSize);
+      std::memmove(
+          this->m_readBuffer.data(),
+          this->m_readBuffer.data() + this->m_bodyStartInBuffer,
+          bufferSize);
+      bytesParsed = parser.Parse(this->m_readBuffer.data(), bufferSize);
       // if parsing from internal buffer is not enough, do next read from wire
       reuseInternalBuffer = false;
       // reset body start
-      this->m_bodyStartInBuffer = _detail::DefaultLibcurlReaderSize;
+      this->m_bodyStartInBuffer = this->m_readBuffer.size();
     }
     else
     {
       // Try to fill internal buffer from socket.
       // If response is smaller than buffer, we will get back the size of the response
       bufferSize = m_connection->ReadFromSocket(
-          this->m_readBuffer, _detail::DefaultLibcurlReaderSize, context);
+          this->m_readBuffer.data(), this->m_readBuffer.size(), context);
       if (bufferSize == 0)
       {
         // closed connection, prevent application from keep trying to pull more bytes from the wire
@@ -685,13 +946,12 @@ void CurlSession::ReadStatusLineAndHeadersFromRawResponse(
             "Connection was closed by the server while trying to read a response");
       }
       // returns the number of bytes parsed up to the body Start
-      bytesParsed = parser.Parse(this->m_readBuffer, bufferSize);
+      bytesParsed = parser.Parse(this->m_readBuffer.data(), bufferSize);
     }
 
-    if (bytesParsed < bufferSize)
-    {
-      this->m_bodyStartInBuffer = bytesParsed; // Body Start
-    }
+    // Body Start, or no data left in the buffer.
+    this->m_bodyStartInBuffer
+        = bytesParsed < bufferSize ? bytesParsed : this->m_readBuffer.size();
   }
 
   this->m_response = parser.ExtractResponse();
@@ -708,7 +968,7 @@ void CurlSession::ReadStatusLineAndHeadersFromRawResponse(
       || this->m_lastStatusCode == HttpStatusCode::NotModified)
   {
     this->m_contentLength = 0;
-    this->m_bodyStartInBuffer = _detail::DefaultLibcurlReaderSize;
+    this->m_bodyStartInBuffer = this->m_readBuffer.size();
     return;
   }
 
@@ -754,7 +1014,7 @@ void CurlSession::ReadStatusLineAndHeadersFromRawResponse(
       if (this->m_bodyStartInBuffer >= this->m_innerBufferSize)
       { // if nothing on inner buffer, pull from wire
         this->m_innerBufferSize = m_connection->ReadFromSocket(
-            this->m_readBuffer, _detail::DefaultLibcurlReaderSize, context);
+            this->m_readBuffer.data(), this->m_readBuffer.size(), context);
         if (this->m_innerBufferSize == 0)
         {
           // closed connection, prevent application from keep trying to pull more bytes from the
@@ -790,7 +1050,7 @@ void CurlSession::ReadExpected(uint8_t expected, Context const& context)
   {
     // end of buffer, pull data from wire
     this->m_innerBufferSize = m_connection->ReadFromSocket(
-        this->m_readBuffer, _detail::DefaultLibcurlReaderSize, context);
+        this->m_readBuffer.data(), this->m_readBuffer.size(), context);
     if (this->m_innerBufferSize == 0)
     {
       // closed connection, prevent application from keep trying to pull more bytes from the wire
@@ -815,6 +1075,80 @@ void CurlSession::ReadCRLF(Context const& context)
   ReadExpected('\n', context);
 }
 
+size_t CurlSession::FillInnerBuffer(size_t maxSize, Context const& context)
+{
+  // Grow the buffer only when the previous read from the socket filled it completely, which means
+  // more data was likely waiting on the socket.
+  if (this->m_adaptiveReadBuffer && this->m_innerBufferSize == this->m_readBuffer.size()
+      && this->m_readBuffer.size() < _detail::DefaultMaxAdaptiveReaderSize)
+  {
+    this->m_readBuffer.resize(
+        (std::min)(this->m_readBuffer.size() * 2, _detail::DefaultMaxAdaptiveReaderSize));
+  }
+
+  this->m_innerBufferSize = m_connection->ReadFromSocket(
+      this->m_readBuffer.data(), (std::min)(maxSize, this->m_readBuffer.size()), context);
+  this->m_bodyStartInBuffer = 0;
+  return this->m_innerBufferSize;
+}
+
+size_t CurlSession::ReadBodyFromSocket(
+    std::function<size_t(Context const&)> const& read,
+    Context const& context)
+{
+  if (this->m_minimumReadThroughput == 0)
+  {
+    return read(context);
+  }
+  if (this->m_readThroughputTooLow)
+  {
+    throw TransportException(
+        "The response body was received at less than "
+        + std::to_string(this->m_minimumReadThroughput) + " bytes per second over "
+        + std::to_string(this->m_readThroughputWindow.count()) + " ms.");
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  size_t readBytes = 0;
+  try
+  {
+    // Receiving nothing for the whole window is too slow already.
+    readBytes = read(context.WithDeadline(
+        std::chrono::system_clock::now() + this->m_readThroughputWindow));
+  }
+  catch (Azure::Core::OperationCancelledException const&)
+  {
+    if (context.IsCancelled())
+    {
+      throw;
+    }
+    throw TransportException(
+        "No data was received from the socket for "
+        + std::to_string(this->m_readThroughputWindow.count()) + " ms.");
+  }
+  auto const duration = std::chrono::steady_clock::now() - start;
+
+  // Keep the reads of the last window only.
+  this->m_bodyReads.emplace_back(duration, readBytes);
+  this->m_bodyReadDuration += duration;
+  this->m_bodyReadBytes += readBytes;
+  while (this->m_bodyReadDuration - this->m_bodyReads.front().first
+         >= this->m_readThroughputWindow)
+  {
+    this->m_bodyReadDuration -= this->m_bodyReads.front().first;
+    this->m_bodyReadBytes -= this->m_bodyReads.front().second;
+    this->m_bodyReads.pop_front();
+  }
+  if (this->m_bodyReadDuration >= this->m_readThroughputWindow
+      && static_cast<double>(this->m_bodyReadBytes)
+          < static_cast<double>(this->m_minimumReadThroughput)
+              * std::chrono::duration<double>(this->m_bodyReadDuration).count())
+  {
+    this->m_readThroughputTooLow = true;
+  }
+  return readBytes;
+}
+
 // Read from curl session
 size_t CurlSession::OnRead(uint8_t* buffer, size_t count, Context const& context)
 {
@@ -863,7 +1197,7 @@ size_t CurlSession::OnRead(uint8_t* buffer, size_t count, Context const& context
   {
     // still have data to take from innerbuffer
     Azure::Core::IO::MemoryBodyStream innerBufferMemoryStream(
-        this->m_readBuffer + this->m_bodyStartInBuffer,
+        this->m_readBuffer.data() + this->m_bodyStartInBuffer,
         this->m_innerBufferSize - this->m_bodyStartInBuffer);
 
     // From code inspection, it is guaranteed that the readRequestLength will fit within size_t
@@ -882,9 +1216,40 @@ size_t CurlSession::OnRead(uint8_t* buffer, size_t count, Context const& context
     return 0;
   }
 
-  // Read from socket when no more data on internal buffer
-  // For chunk request, read a chunk based on chunk size
-  totalRead = m_connection->ReadFromSocket(buffer, static_cast<size_t>(readRequestLength), context);
+  // A read asking for the whole rest of a body with content-length, such as `ReadToCount()` into
+  // the destination of a download, receives straight into the caller's buffer: no later read could
+  // be served from the inner buffer. Only the start of the body received with the headers is
+  // copied.
+  bool const readsRestOfBody = this->m_contentLength > 0
+      && readRequestLength
+          == static_cast<size_t>(this->m_contentLength) - this->m_sessionTotalRead;
+  if (readRequestLength < this->m_readBuffer.size() && !readsRestOfBody)
+  {
+    // Small reads are served from the inner buffer so the next reads don't need to go to the
+    // socket. For responses with content-length, don't read beyond the end of the body.
+    auto fillSize = this->m_contentLength > 0
+        ? static_cast<size_t>(this->m_contentLength) - this->m_sessionTotalRead
+        : (std::numeric_limits<size_t>::max)();
+    totalRead = (std::min)(
+        ReadBodyFromSocket(
+            [this, fillSize](Context const& readContext) {
+              return FillInnerBuffer(fillSize, readContext);
+            },
+            context),
+        readRequestLength);
+    std::memcpy(buffer, this->m_readBuffer.data(), totalRead);
+    this->m_bodyStartInBuffer = totalRead;
+  }
+  else
+  {
+    // Read from socket when no more data on internal buffer
+    // For chunk request, read a chunk based on chunk size
+    totalRead = ReadBodyFromSocket(
+        [this, buffer, readRequestLength](Context const& readContext) {
+          return m_connection->ReadFromSocket(buffer, readRequestLength, readContext);
+        },
+        context);
+  }
   this->m_sessionTotalRead += totalRead;
 
   // Reading 0 bytes means closed connection.
@@ -908,6 +1273,35 @@ size_t CurlSession::OnRead(uint8_t* buffer, size_t count, Context const& context
   return totalRead;
 }
 
+void CurlConnection::GetTransferMetrics(Diagnostics::_detail::TransferMetrics& metrics) const
+{
+  metrics.IsConnectionReused = m_isReused;
+  if (m_isReused)
+  {
+    return;
+  }
+
+  // The times are counted from the start of the transfer which opened the connection, the last
+  // one performed with the handle.
+  curl_off_t nameLookup = 0;
+  curl_off_t connect = 0;
+  curl_off_t tlsHandshake = 0;
+  if (curl_easy_getinfo(m_handle, CURLINFO_NAMELOOKUP_TIME_T, &nameLookup) != CURLE_OK
+      || curl_easy_getinfo(m_handle, CURLINFO_CONNECT_TIME_T, &connect) != CURLE_OK
+      || curl_easy_getinfo(m_handle, CURLINFO_APPCONNECT_TIME_T, &tlsHandshake) != CURLE_OK)
+  {
+    return;
+  }
+  metrics.NameLookup = std::chrono::microseconds(nameLookup);
+  metrics.Connect = std::chrono::microseconds((std::max)(connect - nameLookup, curl_off_t(0)));
+  // Only HTTPS connections have a TLS handshake.
+  if (tlsHandshake != 0)
+  {
+    metrics.TlsHandshake
+        = std::chrono::microseconds((std::max)(tlsHandshake - connect, curl_off_t(0)));
+  }
+}
+
 void CurlConnection::Shutdown()
 {
 #if defined(AZ_PLATFORM_POSIX)
@@ -918,17 +1312,58 @@ void CurlConnection::Shutdown()
   m_isShutDown = true;
 }
 
-// Read from socket and return the number of bytes taken from socket
-size_t CurlConnection::ReadFromSocket(uint8_t* buffer, size_t bufferSize, Context const& context)
+bool CurlConnection::WaitForResponse(std::chrono::milliseconds timeout, Context const& context)
 {
-  // loop until read result is not CURLE_AGAIN
-  // Next loop is expected to be called at most 2 times:
-  // The first time it calls `curl_easy_recv()`, if it returns CURLE_AGAIN it would call
-  // `pollSocketUntilEventOrTimeout` and wait for socket to be ready to read.
-  // `pollSocketUntilEventOrTimeout` will then handle cancelation token.
-  // If socket is not ready before the timeout, Exception is thrown.
-  // When socket is ready, it calls curl_easy_recv() again (second loop iteration). It is
-  // not expected to return CURLE_AGAIN (since socket is ready), so, a chuck of data will be
+  auto const pollResult = pollSocketUntilEventOrTimeout(
+      context, m_curlSocket, PollSocketDirection::Read, static_cast<long>(timeout.count()));
+  if (pollResult < 0)
+  {
+    throw TransportException("Error while polling for socket ready read");
+  }
+  return pollResult > 0;
+}
+
+bool CurlConnection::IsClosedByPeer()
+{
+  struct pollfd poller;
+  poller.fd = m_curlSocket;
+  poller.events = POLLIN;
+  poller.revents = 0;
+#if defined(AZ_PLATFORM_POSIX)
+  if (poll(&poller, 1, 0) <= 0)
+  {
+    return false;
+  }
+  // An idle connection can still be readable, for instance with the session tickets a TLS 1.3
+  // server sends after the handshake. Only the end of the stream, or an error, means it's closed.
+  char byte;
+  auto const received = recv(m_curlSocket, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+  return received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+#elif defined(AZ_PLATFORM_WINDOWS)
+  if (WSAPoll(&poller, 1, 0) <= 0)
+  {
+    return false;
+  }
+  // See above. The socket is readable, so peeking doesn't block.
+  char byte;
+  auto const received = recv(m_curlSocket, &byte, 1, MSG_PEEK);
+  return received == 0 || (received < 0 && WSAGetLastError() != WSAEWOULDBLOCK);
+#else
+  return false;
+#endif
+}
+
+// Read from socket and return the number of bytes taken from socket
+size_t CurlConnection::ReadFromSocket(uint8_t* buffer, size_t bufferSize, Context const& context)
+{
+  // loop until read result is not CURLE_AGAIN
+  // Next loop is expected to be called at most 2 times:
+  // The first time it calls `curl_easy_recv()`, if it returns CURLE_AGAIN it would call
+  // `pollSocketUntilEventOrTimeout` and wait for socket to be ready to read.
+  // `pollSocketUntilEventOrTimeout` will then handle cancelation token.
+  // If socket is not ready before the timeout, Exception is thrown.
+  // When socket is ready, it calls curl_easy_recv() again (second loop iteration). It is
+  // not expected to return CURLE_AGAIN (since socket is ready), so, a chuck of data will be
   // downloaded and result will be CURLE_OK which breaks the loop. Also, getting other than
   // CURLE_OK or CURLE_AGAIN throws.
   size_t readBytes = 0;
@@ -978,329 +1413,412 @@ size_t CurlSession::ResponseBufferParser::Parse(
     uint8_t const* const buffer,
     size_t const bufferSize)
 {
-  if (this->m_parseCompleted)
+  if (this->m_parseCompleted || bufferSize == 0)
   {
     return 0;
   }
 
-  // Read all buffer until \r\n is found
-  size_t start = 0, index = 0;
-  for (; index < bufferSize; index++)
+  if (this->m_delimiterStartInPrevPosition && buffer[0] != '\n')
+  {
+    // unlikely. But this means a case with buffers like [xx\r], [xxxx]
+    // \r is not delimiter and in previous call it was omitted, so adding it now
+    this->m_internalBuffer.append("\r");
+    this->m_delimiterStartInPrevPosition = false;
+  }
+
+  // Tokens end with \r\n. Looking for the \n with memchr, which the C runtime implements with
+  // vector instructions, is much faster than checking the buffer byte by byte. Complete tokens are
+  // parsed in place from the buffer, only a token split across buffers gets copied.
+  size_t start = 0;
+  size_t searchStart = 0;
+  while (searchStart < bufferSize)
   {
-    if (buffer[index] == '\r')
+    auto const lineFeed = static_cast<uint8_t const*>(
+        std::memchr(buffer + searchStart, '\n', bufferSize - searchStart));
+    if (lineFeed == nullptr)
+    {
+      break;
+    }
+    size_t const index = lineFeed - buffer;
+    searchStart = index + 1;
+
+    bool const isDelimiter
+        = index == 0 ? this->m_delimiterStartInPrevPosition : buffer[index - 1] == '\r';
+    if (!isDelimiter)
     {
-      this->m_delimiterStartInPrevPosition = true;
+      // \n in the response without \r before it. keep parsing
       continue;
     }
+    this->m_delimiterStartInPrevPosition = false;
 
-    if (buffer[index] == '\n' && this->m_delimiterStartInPrevPosition)
+    // found end of delimiter
+    if (this->m_internalBuffer.size() > 0) // Check internal buffer
     {
-      // found end of delimiter
-      if (this->m_internalBuffer.size() > 0) // Check internal buffer
+      // Only append more when buffer is like [xxx\r\n yyyy], not when it is [\r\nxxx] or
+      // [\nxxx]
+      if (index > 1)
       {
-        // At this point, we are reading to append more to internal buffer.
-        // Only append more if index is greater than 1, meaning not when buffer is [\r\nxxx]
-        // only on buffer like [xxx\r\n yyyy], append xxx
-        if (index > 1)
-        {
-          // Previously appended something
-          this->m_internalBuffer.append(buffer + start, buffer + index - 1); // minus 1 to remove \r
-        }
-        if (this->state == ResponseParserState::StatusLine)
-        {
-          // Create Response
-          this->m_response = CreateHTTPResponse(this->m_internalBuffer);
-          // Set state to headers
-          this->state = ResponseParserState::Headers;
-          this->m_delimiterStartInPrevPosition = false;
-          start = index + 1; // jump \n
-        }
-        else if (this->state == ResponseParserState::Headers)
-        {
-          // will throw if header is invalid
-          SetHeader(*this->m_response, this->m_internalBuffer);
-          this->m_delimiterStartInPrevPosition = false;
-          start = index + 1; // jump \n
-        }
-        else
-        {
-          // Should never happen that parser is not statusLIne or Headers and we still try
-          // to parse more.
-          _azure_UNREACHABLE_CODE();
-        }
-        // clean internal buffer
-        this->m_internalBuffer.clear();
+        this->m_internalBuffer.append(buffer + start, buffer + index - 1); // minus 1 to remove \r
+      }
+      if (this->state == ResponseParserState::StatusLine)
+      {
+        // Create Response
+        this->m_response = CreateHTTPResponse(this->m_internalBuffer);
+        // Set state to headers
+        this->state = ResponseParserState::Headers;
+      }
+      else if (this->state == ResponseParserState::Headers)
+      {
+        // will throw if header is invalid
+        SetHeader(*this->m_response, this->m_internalBuffer);
       }
       else
       {
-        // Nothing at internal buffer. Add directly from internal buffer
-        if (this->state == ResponseParserState::StatusLine)
-        {
-          // Create Response
-          this->m_response = CreateHTTPResponse(buffer + start, buffer + index - 1);
-          // Set state to headers
-          this->state = ResponseParserState::Headers;
-          this->m_delimiterStartInPrevPosition = false;
-          start = index + 1; // jump \n
-        }
-        else if (this->state == ResponseParserState::Headers)
-        {
-          // Check if this is end of headers delimiter
-          // 1) internal buffer is empty and \n is the first char on buffer [\nBody...]
-          // 2) index == start + 1. No header data after last \r\n [header\r\n\r\n]
-          if (index == 0 || index == start + 1)
-          {
-            this->m_parseCompleted = true;
-            return index + 1; // plus 1 to advance the \n. If we were at buffer end.
-          }
-
-          // will throw if header is invalid
-          Azure::Core::Http::_detail::RawResponseHelpers::SetHeader(
-              *this->m_response, buffer + start, buffer + index - 1);
-          this->m_delimiterStartInPrevPosition = false;
-          start = index + 1; // jump \n
-        }
-        else
-        {
-          // Should never happen that parser is not statusLIne or Headers and we still try
-          // to parse more.
-          _azure_UNREACHABLE_CODE();
-        }
+        // Should never happen that parser is not statusLIne or Headers and we still try
+        // to parse more.
+        _azure_UNREACHABLE_CODE();
       }
+      // clean internal buffer
+      this->m_internalBuffer.clear();
     }
-    else
+    else if (this->state == ResponseParserState::StatusLine)
+    {
+      // Nothing at internal buffer. Create Response directly from buffer
+      this->m_response = CreateHTTPResponse(buffer + start, buffer + index - 1);
+      // Set state to headers
+      this->state = ResponseParserState::Headers;
+    }
+    else if (this->state == ResponseParserState::Headers)
     {
-      if (index == 0 && this->m_internalBuffer.size() > 0 && this->m_delimiterStartInPrevPosition)
+      // Check if this is end of headers delimiter
+      // 1) internal buffer is empty and \n is the first char on buffer [\nBody...]
+      // 2) index == start + 1. No header data after last \r\n [header\r\n\r\n]
+      if (index == 0 || index == start + 1)
       {
-        // unlikely. But this means a case with buffers like [xx\r], [xxxx]
-        // \r is not delimiter and in previous loop it was omitted, so adding it now
-        this->m_internalBuffer.append("\r");
+        this->m_parseCompleted = true;
+        return index + 1; // plus 1 to advance the \n. If we were at buffer end.
       }
-      // \r in the response without \n after it. keep parsing
-      this->m_delimiterStartInPrevPosition = false;
+
+      // will throw if header is invalid
+      Azure::Core::Http::_detail::RawResponseHelpers::SetHeader(
+          *this->m_response, buffer + start, buffer + index - 1);
     }
+    else
+    {
+      // Should never happen that parser is not statusLIne or Headers and we still try
+      // to parse more.
+      _azure_UNREACHABLE_CODE();
+    }
+    start = index + 1; // jump \n
   }
 
   if (start < bufferSize)
   {
     // didn't find the end of delimiter yet, save at internal buffer
-    // If this->m_delimiterStartInPrevPosition is true, buffer ends in \r [xxxx\r]
-    // Don't add \r. IF next char is not \n, we will append \r then on next loop
+    // If the buffer ends in \r [xxxx\r], don't add \r. IF next char is not \n, we will append
+    // \r then on next call
+    this->m_delimiterStartInPrevPosition = buffer[bufferSize - 1] == '\r';
     this->m_internalBuffer.append(
         buffer + start, buffer + bufferSize - (this->m_delimiterStartInPrevPosition ? 1 : 0));
   }
 
-  return index;
+  return bufferSize;
 }
 
-// Finds delimiter '\r' as the end of the
-size_t CurlSession::ResponseBufferParser::BuildStatusCode(
-    uint8_t const* const buffer,
-    size_t const bufferSize)
+namespace {
+inline std::string GetConnectionKey(std::string const& host, CurlTransportOptions const& options)
 {
-  if (this->state != ResponseParserState::StatusLine)
+  std::string key(host);
+  key.append(!options.CAInfo.empty() ? options.CAInfo : "0");
+  key.append(!options.Proxy.empty() ? options.Proxy : "0");
+  key.append(!options.SslOptions.EnableCertificateRevocationListCheck ? "1" : "0");
+  key.append(options.SslVerifyPeer ? "1" : "0");
+  key.append(options.NoSignal ? "1" : "0");
+  // using DefaultConnectionTimeout or 0 result in the same setting
+  key.append(
+      (options.ConnectionTimeout == Azure::Core::Http::_detail::DefaultConnectionTimeout
+       || options.ConnectionTimeout == std::chrono::milliseconds(0))
+          ? "0"
+          : std::to_string(options.ConnectionTimeout.count()));
+  // The socket settings are only part of the key when they are not the default ones.
+  if (!options.TcpNoDelay || options.SocketSendBufferSize != 0
+      || options.SocketReceiveBufferSize != 0 || !options.TcpCongestionControl.empty())
   {
-    return 0; // Wrong internal state to call this method.
+    key.append(options.TcpNoDelay ? "s1" : "s0");
+    key.append("," + std::to_string(options.SocketSendBufferSize));
+    key.append("," + std::to_string(options.SocketReceiveBufferSize));
+    key.append("," + options.TcpCongestionControl);
   }
-
-  uint8_t endOfStatusLine = '\r';
-  auto endOfBuffer = buffer + bufferSize;
-
-  // Look for the end of status line in buffer
-  auto indexOfEndOfStatusLine = std::find(buffer, endOfBuffer, endOfStatusLine);
-
-  if (indexOfEndOfStatusLine == endOfBuffer)
+  if (options.TcpKeepAlive)
   {
-    // did not find the delimiter yet, copy to internal buffer
-    this->m_internalBuffer.append(buffer, endOfBuffer);
-    return bufferSize; // all buffer read and requesting for more
+    key.append("k" + std::to_string(options.TcpKeepAliveIdleTime.count()));
+    key.append("," + std::to_string(options.TcpKeepAliveInterval.count()));
   }
 
-  // Delimiter found, check if there is data in the internal buffer
-  if (this->m_internalBuffer.size() > 0)
+  // The connection pool settings are only part of the key when they are not the default ones.
+  CurlConnectionPoolOptions const poolOptions(options);
+  if (!(poolOptions == CurlConnectionPoolOptions()))
   {
-    // If the index is same as buffer it means delimiter is at position 0, meaning that
-    // internalBuffer contains the status line and we don't need to add anything else
-    if (indexOfEndOfStatusLine > buffer)
+    key.append("p" + std::to_string(poolOptions.MaxConnectionsPerHost));
+    key.append("," + std::to_string(poolOptions.MaxConnections));
+    key.append("," + std::to_string(poolOptions.IdleTimeout.count()));
+    key.append("," + std::to_string(poolOptions.CleanerInterval.count()));
+    key.append(
+        poolOptions.EvictionPolicy == CurlConnectionPoolEvictionPolicy::FirstInFirstOut ? ",1"
+                                                                                        : ",0");
+    if (poolOptions.MaxConnectionsPerAddress != 0)
     {
-      // Append and build response minus the delimiter
-      this->m_internalBuffer.append(buffer, indexOfEndOfStatusLine);
+      key.append(",a" + std::to_string(poolOptions.MaxConnectionsPerAddress));
     }
-    this->m_response = CreateHTTPResponse(this->m_internalBuffer);
-  }
-  else
-  {
-    // Internal Buffer was not required, create response directly from buffer
-    this->m_response = CreateHTTPResponse(std::string(buffer, indexOfEndOfStatusLine));
   }
 
-  // update control
-  this->state = ResponseParserState::Headers;
-  this->m_internalBuffer.clear();
+  return key;
+}
+
+inline std::string GetConnectionHost(Azure::Core::Url const& url)
+{
+  uint16_t port = url.GetPort();
+  return url.GetScheme() + url.GetHost() + (port != 0 ? std::to_string(port) : "");
+}
 
-  // Return the index of the next char to read after delimiter
-  // No need to advance one more char ('\n') (since we might be at the end of the array)
-  // Parsing Headers will make sure to move one possition
-  return indexOfEndOfStatusLine + 1 - buffer;
+// The host of the url as reported by the statistics of the pool, like
+// `https://account.blob.core.windows.net:443`.
+std::string GetStatisticsHost(Azure::Core::Url const& url)
+{
+  uint16_t const port = url.GetPort();
+  return url.GetScheme() + "://" + url.GetHost() + ":"
+      + std::to_string(port != 0 ? port : (url.GetScheme() == "https" ? 443 : 80));
 }
 
-// Finds delimiter '\r' as the end of the
-size_t CurlSession::ResponseBufferParser::BuildHeader(
-    uint8_t const* const buffer,
-    size_t const bufferSize)
+// Sets the socket options of CurlTransportOptions libcurl has no option for, before the socket
+// connects. The options are best effort, a socket the system refuses one for is still used.
+int SetSocketOptions(void* userPointer, curl_socket_t socket, curlsocktype purpose)
 {
-  if (this->state != ResponseParserState::Headers)
+  auto const& options = *static_cast<CurlTransportOptions const*>(userPointer);
+  if (purpose != CURLSOCKTYPE_IPCXN)
   {
-    return 0; // can't run this if state is not Headers.
+    return CURL_SOCKOPT_OK;
   }
-
-  uint8_t delimiter = '\r';
-  auto start = buffer;
-  auto endOfBuffer = buffer + bufferSize;
-
-  if (bufferSize == 1 && buffer[0] == '\n')
+  if (options.SocketSendBufferSize != 0)
   {
-    // rare case of using buffer of size 1 to read. In this case, if the char is next value
-    // after headers or previous header, just consider it as read and return
-    return bufferSize;
+    int const size = static_cast<int>(
+        (std::min)(options.SocketSendBufferSize, size_t((std::numeric_limits<int>::max)())));
+    setsockopt(socket, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char const*>(&size), sizeof(size));
   }
-  else if (bufferSize > 1 && this->m_internalBuffer.size() == 0) // only if nothing in
-                                                                 // buffer, advance
+  if (options.SocketReceiveBufferSize != 0)
   {
-    // move offset one possition. This is because readStatusLine and readHeader will read up
-    // to
-    // '\r' then next delimiter is '\n' and we don't care
-    start = buffer + 1;
+    int const size = static_cast<int>(
+        (std::min)(options.SocketReceiveBufferSize, size_t((std::numeric_limits<int>::max)())));
+    setsockopt(socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char const*>(&size), sizeof(size));
   }
-
-  // Look for the end of status line in buffer
-  auto indexOfEndOfStatusLine = std::find(start, endOfBuffer, delimiter);
-
-  if (indexOfEndOfStatusLine == start && this->m_internalBuffer.size() == 0)
+#if defined(TCP_CONGESTION)
+  if (!options.TcpCongestionControl.empty())
   {
-    // \r found at the start means the end of headers
-    this->m_internalBuffer.clear();
-    this->m_parseCompleted = true;
-    return 1; // can't return more than the found delimiter. On read remaining we need to
-              // also remove first char
+    setsockopt(
+        socket,
+        IPPROTO_TCP,
+        TCP_CONGESTION,
+        options.TcpCongestionControl.c_str(),
+        static_cast<socklen_t>(options.TcpCongestionControl.size()));
   }
+#endif
+  return CURL_SOCKOPT_OK;
+}
 
-  if (indexOfEndOfStatusLine == endOfBuffer)
-  {
-    // did not find the delimiter yet, copy to internal buffer
-    this->m_internalBuffer.append(start, endOfBuffer);
-    return bufferSize; // all buffer read and requesting for more
+// Resolves the host name to the addresses libcurl would connect to, in the order of the resolver.
+std::vector<std::string> ResolveHost(std::string const& host, uint16_t port)
+{
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* result = nullptr;
+  std::vector<std::string> addresses;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0)
+  {
+    return addresses;
+  }
+  for (auto info = result; info != nullptr; info = info->ai_next)
+  {
+    char address[INET6_ADDRSTRLEN] = {};
+    void* const rawAddress = info->ai_family == AF_INET6
+        ? static_cast<void*>(&reinterpret_cast<sockaddr_in6*>(info->ai_addr)->sin6_addr)
+        : static_cast<void*>(&reinterpret_cast<sockaddr_in*>(info->ai_addr)->sin_addr);
+    if ((info->ai_family == AF_INET || info->ai_family == AF_INET6)
+        && inet_ntop(info->ai_family, rawAddress, address, sizeof(address)) != nullptr
+        && std::find(addresses.begin(), addresses.end(), address) == addresses.end())
+    {
+      addresses.emplace_back(address);
+    }
   }
+  freeaddrinfo(result);
+  return addresses;
+}
+} // namespace
 
-  // Delimiter found, check if there is data in the internal buffer
-  if (this->m_internalBuffer.size() > 0)
-  {
-    // If the index is same as buffer it means delimiter is at position 0, meaning that
-    // internalBuffer contains the status line and we don't need to add anything else
-    if (indexOfEndOfStatusLine > buffer)
+std::shared_ptr<void> CurlConnectionPool::LeaseAddress(
+    std::string const& host,
+    uint16_t port,
+    std::chrono::seconds dnsCacheTimeout,
+    std::string& address)
+{
+  auto const hostKey = host + ":" + std::to_string(port);
+  auto const now = std::chrono::steady_clock::now();
+  std::vector<std::string> addresses;
+  {
+    std::lock_guard<std::mutex> lock(m_addressState->Mutex);
+    auto resolvedHost = m_addressState->ResolvedHosts.find(hostKey);
+    if (resolvedHost != m_addressState->ResolvedHosts.end()
+        && now < resolvedHost->second.ExpiryTime)
     {
-      // Append and build response minus the delimiter
-      this->m_internalBuffer.append(start, indexOfEndOfStatusLine);
+      addresses = resolvedHost->second.Addresses;
     }
-    // will throw if header is invalid
-    SetHeader(*m_response, this->m_internalBuffer);
   }
-  else
+
+  if (addresses.empty())
   {
-    // Internal Buffer was not required, create response directly from buffer
-    std::string header(std::string(start, indexOfEndOfStatusLine));
-    // will throw if header is invalid
-    SetHeader(*this->m_response, header);
+    // The resolution is done without holding the mutex. Threads racing for an expired host all
+    // resolve it, the last one to finish updates the cache.
+    addresses = ResolveHost(host, port);
+    if (addresses.empty())
+    {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_addressState->Mutex);
+    auto& resolvedHost = m_addressState->ResolvedHosts[hostKey];
+    resolvedHost.Addresses = addresses;
+    resolvedHost.ExpiryTime = now + dnsCacheTimeout;
   }
 
-  // reuse buffer
-  this->m_internalBuffer.clear();
-
-  // Return the index of the next char to read after delimiter
-  // No need to advance one more char ('\n') (since we might be at the end of the array)
-  // Parsing Headers will make sure to move one position
-  return indexOfEndOfStatusLine + 1 - buffer;
-}
-
-namespace {
-inline std::string GetConnectionKey(std::string const& host, CurlTransportOptions const& options)
-{
-  std::string key(host);
-  key.append(!options.CAInfo.empty() ? options.CAInfo : "0");
-  key.append(!options.Proxy.empty() ? options.Proxy : "0");
-  key.append(!options.SslOptions.EnableCertificateRevocationListCheck ? "1" : "0");
-  key.append(options.SslVerifyPeer ? "1" : "0");
-  key.append(options.NoSignal ? "1" : "0");
-  // using DefaultConnectionTimeout or 0 result in the same setting
-  key.append(
-      (options.ConnectionTimeout == Azure::Core::Http::_detail::DefaultConnectionTimeout
-       || options.ConnectionTimeout == std::chrono::milliseconds(0))
-          ? "0"
-          : std::to_string(options.ConnectionTimeout.count()));
+  std::string leaseKey;
+  {
+    std::lock_guard<std::mutex> lock(m_addressState->Mutex);
+    size_t fewestConnections = (std::numeric_limits<size_t>::max)();
+    for (auto const& candidate : addresses)
+    {
+      auto const openConnections = m_addressState->OpenConnections.find(host + "/" + candidate);
+      size_t const connections = openConnections == m_addressState->OpenConnections.end()
+          ? 0
+          : openConnections->second;
+      if (connections < fewestConnections)
+      {
+        fewestConnections = connections;
+        address = candidate;
+      }
+    }
+    leaseKey = host + "/" + address;
+    m_addressState->OpenConnections[leaseKey] += 1;
+  }
 
-  return key;
+  auto addressState = m_addressState;
+  return std::shared_ptr<void>(addressState.get(), [addressState, leaseKey](void*) {
+    std::lock_guard<std::mutex> lock(addressState->Mutex);
+    auto openConnections = addressState->OpenConnections.find(leaseKey);
+    if (openConnections != addressState->OpenConnections.end() && --openConnections->second == 0)
+    {
+      addressState->OpenConnections.erase(openConnections);
+    }
+  });
 }
-} // namespace
 
 std::unique_ptr<CurlNetworkConnection> CurlConnectionPool::ExtractOrCreateCurlConnection(
     Request& request,
     CurlTransportOptions const& options,
-    bool resetPool)
+    bool resetPool,
+    TrafficClass trafficClass)
 {
-  uint16_t port = request.GetUrl().GetPort();
-  std::string const& host = request.GetUrl().GetScheme() + request.GetUrl().GetHost()
-      + (port != 0 ? std::to_string(port) : "");
-  std::string const connectionKey = GetConnectionKey(host, options);
+  std::string const connectionKey
+      = GetConnectionKey(GetConnectionHost(request.GetUrl()), options);
 
+  auto& shard = GetShard(connectionKey);
   {
-    decltype(CurlConnectionPool::g_curlConnectionPool
-                 .ConnectionPoolIndex)::mapped_type connectionsToBeReset;
+    std::list<PooledConnection> connectionsToBeReset;
 
-    // Critical section. Needs to own ConnectionPoolMutex before executing
+    // Critical section. Needs to own the shard mutex before executing
     // Lock mutex to access connection pool. mutex is unlock as soon as lock is out of scope
-    std::unique_lock<std::mutex> lock(CurlConnectionPool::ConnectionPoolMutex);
-
-    // get a ref to the pool from the map of pools
-    auto hostPoolIndex = g_curlConnectionPool.ConnectionPoolIndex.find(connectionKey);
+    auto lock = LockShard(shard);
 
-    if (hostPoolIndex != g_curlConnectionPool.ConnectionPoolIndex.end()
-        && hostPoolIndex->second.size() > 0)
+    // The pool of the key is only created with the first connection, by CreateCurlConnection().
+    auto const hostPoolIterator = shard.Index.find(connectionKey);
+    if (hostPoolIterator != shard.Index.end())
     {
+      auto& hostPool = hostPoolIterator->second;
+      if (hostPool.Host.empty())
+      {
+        hostPool.Host = GetStatisticsHost(request.GetUrl());
+      }
+
       if (resetPool)
       {
-        connectionsToBeReset = std::move(hostPoolIndex->second);
+        connectionsToBeReset = std::move(hostPool.Connections);
         // clean the pool-index as requested in the call. Typically to force a new connection to be
         // created and to discard all current connections in the pool for the host-index. A caller
         // might request this after getting broken/closed connections multiple-times.
-        hostPoolIndex->second.clear();
-        Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Reset connection pool requested.");
+        hostPool.Connections.clear();
+        hostPool.Statistics.RemovedConnections += connectionsToBeReset.size();
+        m_connectionCount -= connectionsToBeReset.size();
+        WriteVerboseLog("Reset connection pool requested.");
       }
       else
       {
-        // get ref to first connection
-        auto fistConnectionIterator = hostPoolIndex->second.begin();
-        // move the connection ref to temp ref
-        auto connection = std::move(*fistConnectionIterator);
-        // Remove the connection ref from list
-        hostPoolIndex->second.erase(fistConnectionIterator);
-
-        // Remove index if there are no more connections
-        if (hostPoolIndex->second.size() == 0)
+        auto const now = std::chrono::steady_clock::now();
+        // A bulk request leaves the last idle connections to the interactive requests, and opens
+        // a new connection instead.
+        size_t const reservedConnections = trafficClass == TrafficClass::Bulk
+            ? options.ReservedInteractiveConnections
+            : 0;
+        while (hostPool.Connections.size() > reservedConnections)
         {
-          g_curlConnectionPool.ConnectionPoolIndex.erase(hostPoolIndex);
-        }
+          auto connectionIterator
+              = hostPool.Options.EvictionPolicy == CurlConnectionPoolEvictionPolicy::FirstInFirstOut
+              ? --hostPool.Connections.end()
+              : hostPool.Connections.begin();
+          bool const isExpired
+              = now - connectionIterator->ReturnedTime >= hostPool.Options.IdleTimeout;
+          m_connectionCount -= 1;
+          // An expired connection that the clean thread didn't remove yet is never re-used, nor a
+          // connection the server closed while it was idle, which would fail the request after
+          // it's sent.
+          if (isExpired || connectionIterator->Connection->IsClosedByPeer())
+          {
+            if (!isExpired)
+            {
+              WriteVerboseLog("Discarding a pooled connection closed by the server.");
+            }
+            connectionsToBeReset.splice(
+                connectionsToBeReset.end(), hostPool.Connections, connectionIterator);
+            hostPool.Statistics.RemovedConnections += 1;
+            continue;
+          }
+
+          auto connection = std::move(connectionIterator->Connection);
+          hostPool.Connections.erase(connectionIterator);
+          hostPool.Statistics.ReusedConnections += 1;
+          connection->SetReused();
 
-        Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Re-using connection from the pool.");
-        // return connection ref
-        return connection;
+          WriteVerboseLog("Re-using connection from the pool.");
+          return connection;
+        }
       }
     }
     lock.unlock();
+    // The connections to be reset are closed here, without holding the mutex.
   }
 
   // Creating a new connection is thread safe. No need to lock mutex here.
   // No available connection for the pool for the required host. Create one
-  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Spawn new connection.");
+  return CreateCurlConnection(request.GetUrl(), connectionKey, options);
+}
+
+std::unique_ptr<CurlNetworkConnection> CurlConnectionPool::CreateCurlConnection(
+    Azure::Core::Url const& url,
+    std::string const& connectionKey,
+    CurlTransportOptions const& options)
+{
+  uint16_t port = url.GetPort();
+  std::string const host = GetConnectionHost(url);
+
+  WriteVerboseLog("Spawn new connection.");
+  EnsureGlobalInit();
   CURL* newHandle = curl_easy_init();
   if (!newHandle)
   {
@@ -1311,7 +1829,7 @@ std::unique_ptr<CurlNetworkConnection> CurlConnectionPool::ExtractOrCreateCurlCo
   CURLcode result;
 
   // Libcurl setup before open connection (url, connect_only, timeout)
-  if (!SetLibcurlOption(newHandle, CURLOPT_URL, request.GetUrl().GetAbsoluteUrl().data(), &result))
+  if (!SetLibcurlOption(newHandle, CURLOPT_URL, url.GetAbsoluteUrl().data(), &result))
   {
     throw Azure::Core::Http::TransportException(
         _detail::DefaultFailedToGetNewConnectionTemplate + host + ". "
@@ -1332,6 +1850,99 @@ std::unique_ptr<CurlNetworkConnection> CurlConnectionPool::ExtractOrCreateCurlCo
         + std::string(curl_easy_strerror(result)));
   }
 
+  long const dnsCacheTimeout = static_cast<long>(
+      options.DnsCacheTimeout == std::chrono::seconds(0) ? _detail::DefaultDnsCacheTimeout.count()
+                                                         : options.DnsCacheTimeout.count());
+  if (!SetLibcurlOption(newHandle, CURLOPT_DNS_CACHE_TIMEOUT, dnsCacheTimeout, &result))
+  {
+    throw Azure::Core::Http::TransportException(
+        _detail::DefaultFailedToGetNewConnectionTemplate + host
+        + ". Failed to set DNS cache timeout. " + std::string(curl_easy_strerror(result)));
+  }
+
+  if (!SetLibcurlOption(newHandle, CURLOPT_TCP_NODELAY, options.TcpNoDelay ? 1L : 0L, &result))
+  {
+    throw Azure::Core::Http::TransportException(
+        _detail::DefaultFailedToGetNewConnectionTemplate + host + ". Failed to set TCP_NODELAY. "
+        + std::string(curl_easy_strerror(result)));
+  }
+
+  if (options.TcpKeepAlive)
+  {
+    auto const keepAliveTime = [](std::chrono::seconds time) {
+      return static_cast<long>(
+          time == std::chrono::seconds(0) ? _detail::DefaultTcpKeepAliveTime.count()
+                                          : time.count());
+    };
+    if (!SetLibcurlOption(newHandle, CURLOPT_TCP_KEEPALIVE, 1L, &result)
+        || !SetLibcurlOption(
+            newHandle, CURLOPT_TCP_KEEPIDLE, keepAliveTime(options.TcpKeepAliveIdleTime), &result)
+        || !SetLibcurlOption(
+            newHandle,
+            CURLOPT_TCP_KEEPINTVL,
+            keepAliveTime(options.TcpKeepAliveInterval),
+            &result))
+    {
+      throw Azure::Core::Http::TransportException(
+          _detail::DefaultFailedToGetNewConnectionTemplate + host
+          + ". Failed to set TCP keepalive. " + std::string(curl_easy_strerror(result)));
+    }
+  }
+
+  // The callback reads the options, so it is only set while connecting in curl_easy_perform().
+  bool const setsSocketOptions = options.SocketSendBufferSize != 0
+      || options.SocketReceiveBufferSize != 0 || !options.TcpCongestionControl.empty();
+  if (setsSocketOptions
+      && (!SetLibcurlOption(newHandle, CURLOPT_SOCKOPTFUNCTION, SetSocketOptions, &result)
+          || !SetLibcurlOption(
+              newHandle,
+              CURLOPT_SOCKOPTDATA,
+              static_cast<void*>(const_cast<CurlTransportOptions*>(&options)),
+              &result)))
+  {
+    throw Azure::Core::Http::TransportException(
+        _detail::DefaultFailedToGetNewConnectionTemplate + host + ". Failed to set socket options. "
+        + std::string(curl_easy_strerror(result)));
+  }
+
+  // The connection is made to the address picked for it, while the TLS handshake still verifies
+  // the host name.
+  std::shared_ptr<void> addressLease;
+  std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> connectTo(
+      nullptr, curl_slist_free_all);
+  if (options.SpreadConnectionsAcrossAddresses && options.Proxy.empty())
+  {
+    uint16_t const defaultPort = url.GetScheme() == "https" ? 443 : 80;
+    std::string address;
+    addressLease = LeaseAddress(
+        url.GetHost(),
+        port != 0 ? port : defaultPort,
+        std::chrono::seconds(dnsCacheTimeout),
+        address);
+    if (addressLease)
+    {
+      std::string const connectToEntry
+          = "::" + (address.find(':') != std::string::npos ? "[" + address + "]" : address) + ":";
+      connectTo.reset(curl_slist_append(nullptr, connectToEntry.c_str()));
+      if (!connectTo || !SetLibcurlOption(newHandle, CURLOPT_CONNECT_TO, connectTo.get(), &result))
+      {
+        throw Azure::Core::Http::TransportException(
+            _detail::DefaultFailedToGetNewConnectionTemplate + host
+            + ". Failed to set the address to connect to: " + address + ".");
+      }
+    }
+  }
+
+  // libcurl only resumes a TLS session cached by another handle when both use the same TLS
+  // settings, so all the connections can use the same share handle.
+  if (m_shareHandle != nullptr
+      && !SetLibcurlOption(newHandle, CURLOPT_SHARE, m_shareHandle, &result))
+  {
+    throw Azure::Core::Http::TransportException(
+        _detail::DefaultFailedToGetNewConnectionTemplate + host + ". "
+        + std::string(curl_easy_strerror(result)));
+  }
+
   // Set timeout to 24h. Libcurl will fail uploading on windows if timeout is:
   // timeout >= 25 days. Fails as soon as trying to upload any data
   // 25 days < timeout > 1 days. Fail on huge uploads ( > 1GB)
@@ -1423,6 +2034,17 @@ std::unique_ptr<CurlNetworkConnection> CurlConnectionPool::ExtractOrCreateCurlCo
   }
 
   auto performResult = curl_easy_perform(newHandle);
+  if (connectTo)
+  {
+    // The list is only used to connect.
+    curl_easy_setopt(newHandle, CURLOPT_CONNECT_TO, static_cast<curl_slist*>(nullptr));
+  }
+  if (setsSocketOptions)
+  {
+    curl_easy_setopt(newHandle, CURLOPT_SOCKOPTDATA, static_cast<void*>(nullptr));
+    curl_easy_setopt(
+        newHandle, CURLOPT_SOCKOPTFUNCTION, static_cast<curl_sockopt_callback>(nullptr));
+  }
   if (performResult != CURLE_OK)
   {
     throw Http::TransportException(
@@ -1430,11 +2052,129 @@ std::unique_ptr<CurlNetworkConnection> CurlConnectionPool::ExtractOrCreateCurlCo
         + std::string(curl_easy_strerror(performResult)));
   }
 
-  return std::make_unique<CurlConnection>(newHandle, connectionKey);
+  curl_off_t handshakeTime = 0;
+  if (curl_easy_getinfo(newHandle, CURLINFO_APPCONNECT_TIME_T, &handshakeTime) != CURLE_OK
+      || handshakeTime == 0)
+  {
+    // Without TLS, the connection is open once the TCP handshake is done.
+    curl_easy_getinfo(newHandle, CURLINFO_CONNECT_TIME_T, &handshakeTime);
+  }
+  // The connection counts as open until it is destroyed, and releases its address lease with it.
+  // It is counted before the pool of its key is created, so the pool isn't erased meanwhile.
+  auto openConnectionState = m_openConnectionState;
+  {
+    std::lock_guard<std::mutex> lock(openConnectionState->Mutex);
+    openConnectionState->OpenConnections[connectionKey] += 1;
+  }
+  std::shared_ptr<void> connectionLease(
+      openConnectionState.get(),
+      [openConnectionState, connectionKey, addressLease](void*) {
+        std::lock_guard<std::mutex> lock(openConnectionState->Mutex);
+        auto openConnections = openConnectionState->OpenConnections.find(connectionKey);
+        if (openConnections != openConnectionState->OpenConnections.end()
+            && --openConnections->second == 0)
+        {
+          openConnectionState->OpenConnections.erase(openConnections);
+        }
+      });
+
+  {
+    auto& shard = GetShard(connectionKey);
+    auto lock = LockShard(shard);
+    auto& hostPool = shard.Index[connectionKey];
+    if (hostPool.Host.empty())
+    {
+      hostPool.Host = GetStatisticsHost(url);
+    }
+    hostPool.Statistics.CreatedConnections += 1;
+    hostPool.Statistics.HandshakeTime += std::chrono::microseconds(handshakeTime);
+  }
+
+  return std::make_unique<CurlConnection>(
+      newHandle, connectionKey, CurlConnectionPoolOptions(options), std::move(connectionLease));
 }
 
-// Move the connection back to the connection pool. Push it to the front so it becomes the
-// first connection to be picked next time some one ask for a connection to the pool (LIFO)
+void CurlConnectionPool::WarmUp(
+    Azure::Core::Url const& url,
+    CurlTransportOptions const& options,
+    size_t connectionCount)
+{
+  std::string const connectionKey = GetConnectionKey(GetConnectionHost(url), options);
+  // Opening more connections than the pool can hold would only close the extra ones.
+  connectionCount = (std::min)(
+      connectionCount, CurlConnectionPoolOptions(options).MaxConnectionsPerHost);
+  auto const connectionsOnPool = ConnectionsOnPool(connectionKey);
+  if (connectionsOnPool >= connectionCount)
+  {
+    return;
+  }
+
+  // Connections are opened concurrently, by up to MaxWarmUpConcurrency threads, so the warm up
+  // takes a few handshakes no matter how many connections are requested. The threads stop opening
+  // connections after the first failure, so an unreachable host fails the warm up in about one
+  // connection timeout.
+  auto const missingConnections = connectionCount - connectionsOnPool;
+  std::atomic<size_t> nextConnection{0};
+  std::atomic<size_t> createdConnections{0};
+  std::atomic<bool> failed{false};
+  std::mutex errorMutex;
+  std::exception_ptr firstError;
+  auto const openConnections = [&]() {
+    while (!failed && nextConnection++ < missingConnections)
+    {
+      try
+      {
+        MoveConnectionBackToPool(
+            CreateCurlConnection(url, connectionKey, options), HttpStatusCode::Ok);
+        createdConnections++;
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!firstError)
+        {
+          firstError = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  // The calling thread opens connections too.
+  std::vector<std::future<void>> workers;
+  auto const workerCount = (std::min)(missingConnections, MaxWarmUpConcurrency);
+  workers.reserve(workerCount - 1);
+  for (size_t worker = 1; worker < workerCount; worker++)
+  {
+    workers.emplace_back(std::async(std::launch::async, openConnections));
+  }
+  openConnections();
+  for (auto& worker : workers)
+  {
+    worker.get();
+  }
+
+  if (createdConnections > 0)
+  {
+    // Warming up is not a connection coming back from a request.
+    auto& shard = GetShard(connectionKey);
+    auto lock = LockShard(shard);
+    auto const hostPool = shard.Index.find(connectionKey);
+    if (hostPool != shard.Index.end())
+    {
+      hostPool->second.Statistics.ReturnedConnections -= createdConnections.load();
+    }
+  }
+
+  if (firstError)
+  {
+    std::rethrow_exception(firstError);
+  }
+}
+
+// Move the connection back to the connection pool. Push it to the front, so it becomes the first
+// connection to be picked next time some one ask for a connection to the pool (LIFO) or the last
+// one (FIFO).
 void CurlConnectionPool::MoveConnectionBackToPool(
     std::unique_ptr<CurlNetworkConnection> connection,
     HttpStatusCode lastStatusCode)
@@ -1453,46 +2193,427 @@ void CurlConnectionPool::MoveConnectionBackToPool(
     return;
   }
 
-  Log::Write(Logger::Level::Verbose, "Moving connection to pool...");
+  if (Log::ShouldWrite(Logger::Level::Verbose))
+  {
+    Log::Write(Logger::Level::Verbose, "Moving connection to pool...");
+  }
 
-  decltype(CurlConnectionPool::g_curlConnectionPool
-               .ConnectionPoolIndex)::mapped_type::value_type connectionToBeRemoved;
+  auto const poolOptions = connection->GetPoolOptions();
+  auto const now = std::chrono::steady_clock::now();
+  std::list<PooledConnection> connectionsToBeRemoved;
+  std::unique_ptr<CurlNetworkConnection> connectionNotPooled;
+  auto& shard = GetShard(connection->GetConnectionKey());
+  {
+    // Lock mutex to access connection pool. mutex is unlock as soon as lock is out of scope
+    auto lock = LockShard(shard);
+    auto const hostPoolIterator
+        = shard.Index.emplace(connection->GetConnectionKey(), HostPool()).first;
+    auto& hostPool = hostPoolIterator->second;
+    hostPool.Options = poolOptions;
+
+    // The total number of connections is shared by all the shards, so the limit for all the hosts
+    // might be exceeded by a few connections while several threads move connections back at once.
+    auto const isPoolFull = [&]() {
+      return poolOptions.MaxConnections != 0 && m_connectionCount >= poolOptions.MaxConnections;
+    };
+    // The connection at the end of the list is the one waiting for the longest time, which makes
+    // it the least recently used one and also the first one in the queue.
+    while (!hostPool.Connections.empty()
+           && (hostPool.Connections.size() >= poolOptions.MaxConnectionsPerHost || isPoolFull()))
+    {
+      connectionsToBeRemoved.splice(
+          connectionsToBeRemoved.end(), hostPool.Connections, --hostPool.Connections.end());
+      hostPool.Statistics.RemovedConnections += 1;
+      m_connectionCount -= 1;
+    }
 
-  // Lock mutex to access connection pool. mutex is unlock as soon as lock is out of scope
-  std::unique_lock<std::mutex> lock(CurlConnectionPool::ConnectionPoolMutex);
-  auto& poolId = connection->GetConnectionKey();
-  auto& hostPool = g_curlConnectionPool.ConnectionPoolIndex[poolId];
+    // Likewise for the connections to the same address, when they are limited.
+    auto const& remoteAddress = connection->GetRemoteAddress();
+    if (poolOptions.MaxConnectionsPerAddress != 0 && !remoteAddress.empty())
+    {
+      size_t connectionsToAddress = 0;
+      auto oldestToAddress = hostPool.Connections.end();
+      for (auto pooled = hostPool.Connections.begin(); pooled != hostPool.Connections.end();
+           ++pooled)
+      {
+        if (pooled->Connection->GetRemoteAddress() == remoteAddress)
+        {
+          connectionsToAddress += 1;
+          oldestToAddress = pooled;
+        }
+      }
+      if (connectionsToAddress >= poolOptions.MaxConnectionsPerAddress)
+      {
+        connectionsToBeRemoved.splice(
+            connectionsToBeRemoved.end(), hostPool.Connections, oldestToAddress);
+        hostPool.Statistics.RemovedConnections += 1;
+        m_connectionCount -= 1;
+      }
+    }
 
-  if (hostPool.size() >= _detail::MaxConnectionsPerIndex && !hostPool.empty())
+    hostPool.Statistics.ReturnedConnections += 1;
+    if (isPoolFull())
+    {
+      // The pool is full of connections to other hosts.
+      hostPool.Statistics.RemovedConnections += 1;
+      connectionNotPooled = std::move(connection);
+      EraseUnusedHostPool(shard, hostPoolIterator, connectionsToBeRemoved.size() + 1);
+    }
+    else
+    {
+      // update the time when connection was moved back to pool
+      connection->UpdateLastUsageTime();
+      hostPool.Connections.push_front(PooledConnection{std::move(connection), now});
+      m_connectionCount += 1;
+    }
+  }
+
+  if (connectionNotPooled)
+  {
+    return;
+  }
+
+  // Cleanup will start a background thread which will close abandoned connections from the pool.
+  // This will free-up resources from the app
+  ScheduleClean(now + poolOptions.IdleTimeout);
+  if (!m_isCleanThreadRunning)
+  {
+    StartCleanThread();
+  }
+}
+
+void CurlConnectionPool::ScheduleClean(std::chrono::steady_clock::time_point cleanTime)
+{
+  auto const cleanTimeTicks = cleanTime.time_since_epoch().count();
+  auto nextCleanTime = m_nextCleanTime.load();
+  while (cleanTimeTicks < nextCleanTime)
   {
-    // Remove the last connection from the pool to insert this one.
-    auto lastConnection = --hostPool.end();
-    connectionToBeRemoved = std::move(*lastConnection);
-    hostPool.erase(lastConnection);
+    if (m_nextCleanTime.compare_exchange_weak(nextCleanTime, cleanTimeTicks))
+    {
+      // Taking the mutex makes sure the clean thread is either waiting, and gets the signal, or it
+      // has not read the next clean time yet.
+      {
+        std::lock_guard<std::mutex> lock(m_cleanThreadMutex);
+      }
+      m_cleanThreadWakeUp.notify_one();
+      return;
+    }
   }
+}
 
-  // update the time when connection was moved back to pool
-  connection->UpdateLastUsageTime();
-  hostPool.push_front(std::move(connection));
+void CurlConnectionPool::StartCleanThread()
+{
+  std::lock_guard<std::mutex> lock(m_cleanThreadMutex);
+  if (m_isCleanThreadRunning || m_isShuttingDown)
+  {
+    if (Log::ShouldWrite(Logger::Level::Verbose))
+    {
+      Log::Write(Logger::Level::Verbose, "Clean thread running. Won't start a new one.");
+    }
+    return;
+  }
 
-  if (m_cleanThread.joinable() && !IsCleanThreadRunning)
+  if (m_cleanThread.joinable())
   {
     // Clean thread was running before but it's finished, join it to finalize
     m_cleanThread.join();
   }
 
-  // Cleanup will start a background thread which will close abandoned connections from the pool.
-  // This will free-up resources from the app
-  // This is the only call to cleanup.
-  if (!m_cleanThread.joinable())
+  Log::Write(Logger::Level::Verbose, "Start clean thread");
+  m_isCleanThreadRunning = true;
+  m_cleanThread = std::thread([this]() { CleanupThread(); });
+}
+
+void CurlConnectionPool::CleanupThread()
+{
+  using std::chrono::steady_clock;
+  auto lastCleanTime = steady_clock::now();
+  auto cleanInterval = std::chrono::milliseconds(0);
+  for (;;)
+  {
+    {
+      Log::Write(Logger::Level::Verbose, "Clean pool sleep");
+      std::unique_lock<std::mutex> lock(m_cleanThreadMutex);
+      // Sleep until a connection might have expired, but not sooner than the clean interval after
+      // the last inspection. The thread is woken up when a connection which expires sooner is moved
+      // to the pool or when the application finishes. The condition variable releases the mutex
+      // while waiting and takes it again when it wakes up.
+      for (;;)
+      {
+        if (m_isShuttingDown)
+        {
+          // Cancelled by another thead
+          return;
+        }
+        if (m_connectionCount == 0)
+        {
+          // A connection might be moved to the pool while the thread is stopping. Clearing the flag
+          // before checking again makes sure that either this thread sees the new connection or
+          // the thread moving the connection sees the flag and starts a new clean thread.
+          m_isCleanThreadRunning = false;
+          if (m_connectionCount == 0)
+          {
+            Log::Write(
+                Logger::Level::Verbose,
+                "Clean pool - no connections on wake - return *************************");
+            return;
+          }
+          m_isCleanThreadRunning = true;
+        }
+
+        auto const nextCleanTime
+            = steady_clock::time_point(steady_clock::duration(m_nextCleanTime.load()));
+        auto const wakeUpTime = (std::max)(nextCleanTime, lastCleanTime + cleanInterval);
+        if (wakeUpTime <= steady_clock::now())
+        {
+          break;
+        }
+        if (nextCleanTime == (steady_clock::time_point::max)())
+        {
+          m_cleanThreadWakeUp.wait(lock);
+        }
+        else
+        {
+          m_cleanThreadWakeUp.wait_until(lock, wakeUpTime);
+        }
+      }
+    }
+
+    Log::Write(Logger::Level::Verbose, "Clean pool - inspect pool");
+    // Connections moved to the pool from now on schedule the next inspection by themselves.
+    m_nextCleanTime = (steady_clock::time_point::max)().time_since_epoch().count();
+    lastCleanTime = steady_clock::now();
+    auto nextExpiryTime = (steady_clock::time_point::max)();
+    cleanInterval = (std::chrono::milliseconds::max)();
+    for (auto& shard : m_shards)
+    {
+      std::list<PooledConnection> connectionsToBeCleaned;
+      {
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        for (auto index = shard.Index.begin(); index != shard.Index.end();)
+        {
+          // The oldest connection in the pool can be found at the end of the list. Looping the
+          // connection pool backwards until a connection that is not expired is found or until all
+          // connections are removed.
+          auto& hostPool = index->second;
+          size_t expiredConnections = 0;
+          while (!hostPool.Connections.empty()
+                 && lastCleanTime - hostPool.Connections.back().ReturnedTime
+                     >= hostPool.Options.IdleTimeout)
+          {
+            connectionsToBeCleaned.splice(
+                connectionsToBeCleaned.end(), hostPool.Connections, --hostPool.Connections.end());
+            hostPool.Statistics.RemovedConnections += 1;
+            m_connectionCount -= 1;
+            expiredConnections += 1;
+          }
+          if (!hostPool.Connections.empty())
+          {
+            nextExpiryTime = (std::min)(
+                nextExpiryTime,
+                hostPool.Connections.back().ReturnedTime + hostPool.Options.IdleTimeout);
+            cleanInterval = (std::min)(cleanInterval, hostPool.Options.CleanerInterval);
+          }
+          index = EraseUnusedHostPool(shard, index, expiredConnections);
+        }
+      }
+      // Do actual connections release work here, without holding the mutex.
+    }
+
+    if (nextExpiryTime == (steady_clock::time_point::max)())
+    {
+      cleanInterval = std::chrono::milliseconds(0);
+    }
+    else
+    {
+      ScheduleClean(nextExpiryTime);
+    }
+  }
+}
+
+void CurlConnectionPool::RemoveAllConnections()
+{
+  for (auto& shard : m_shards)
   {
-    Log::Write(Logger::Level::Verbose, "Start clean thread");
-    IsCleanThreadRunning = true;
-    m_cleanThread = std::thread(CleanupThread);
+    std::map<std::string, HostPool> connectionsToBeRemoved;
+    {
+      std::lock_guard<std::mutex> lock(shard.Mutex);
+      for (auto& index : shard.Index)
+      {
+        m_connectionCount -= index.second.Connections.size();
+      }
+      connectionsToBeRemoved = std::move(shard.Index);
+      shard.Index.clear();
+    }
   }
-  else
+}
+
+size_t CurlConnectionPool::ConnectionsOnPool(std::string const& connectionKey)
+{
+  auto& shard = GetShard(connectionKey);
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+  auto hostPool = shard.Index.find(connectionKey);
+  return hostPool == shard.Index.end() ? 0 : hostPool->second.Connections.size();
+}
+
+size_t CurlConnectionPool::HostsOnPool()
+{
+  size_t hosts = 0;
+  for (auto& shard : m_shards)
   {
-    Log::Write(Logger::Level::Verbose, "Clean thread running. Won't start a new one.");
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    for (auto const& index : shard.Index)
+    {
+      if (!index.second.Connections.empty())
+      {
+        hosts += 1;
+      }
+    }
   }
-  lock.unlock();
+  return hosts;
+}
+
+CurlConnectionPoolHostStatistics CurlConnectionPool::GetHostStatistics(
+    std::string const& connectionKey)
+{
+  auto& shard = GetShard(connectionKey);
+  std::lock_guard<std::mutex> lock(shard.Mutex);
+  auto hostPool = shard.Index.find(connectionKey);
+  if (hostPool == shard.Index.end())
+  {
+    return CurlConnectionPoolHostStatistics();
+  }
+  auto statistics = hostPool->second.Statistics;
+  statistics.AvailableConnections = hostPool->second.Connections.size();
+  return statistics;
+}
+
+CurlConnectionPoolHostStatistics CurlConnectionPool::GetStatistics()
+{
+  CurlConnectionPoolHostStatistics statistics;
+  for (auto& shard : m_shards)
+  {
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    statistics.ReusedConnections += shard.RetiredStatistics.ReusedConnections;
+    statistics.CreatedConnections += shard.RetiredStatistics.CreatedConnections;
+    statistics.ReturnedConnections += shard.RetiredStatistics.ReturnedConnections;
+    statistics.RemovedConnections += shard.RetiredStatistics.RemovedConnections;
+    for (auto const& index : shard.Index)
+    {
+      auto const& hostStatistics = index.second.Statistics;
+      statistics.AvailableConnections += index.second.Connections.size();
+      statistics.ReusedConnections += hostStatistics.ReusedConnections;
+      statistics.CreatedConnections += hostStatistics.CreatedConnections;
+      statistics.ReturnedConnections += hostStatistics.ReturnedConnections;
+      statistics.RemovedConnections += hostStatistics.RemovedConnections;
+    }
+  }
+  return statistics;
+}
+
+Azure::Core::Http::ConnectionPoolStatistics CurlConnectionPool::GetConnectionPoolStatistics()
+{
+  // The open connections are counted first, a connection returned to the pool meanwhile is
+  // counted as idle and not as active.
+  std::map<std::string, size_t> openConnections;
+  {
+    std::lock_guard<std::mutex> lock(m_openConnectionState->Mutex);
+    openConnections = m_openConnectionState->OpenConnections;
+  }
+
+  Azure::Core::Http::ConnectionPoolStatistics result;
+  for (auto& shard : m_shards)
+  {
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    for (auto const& index : shard.Index)
+    {
+      auto const& hostPool = index.second;
+      // Several connection keys, with different TLS or socket settings, can be open to a host.
+      auto& hostStatistics = result.Hosts[hostPool.Host.empty() ? index.first : hostPool.Host];
+      size_t const idleConnections = hostPool.Connections.size();
+      auto const open = openConnections.find(index.first);
+      if (open != openConnections.end() && open->second > idleConnections)
+      {
+        hostStatistics.ActiveConnections += open->second - idleConnections;
+      }
+      hostStatistics.IdleConnections += idleConnections;
+      hostStatistics.ReusedConnections += hostPool.Statistics.ReusedConnections;
+      hostStatistics.CreatedConnections += hostPool.Statistics.CreatedConnections;
+      hostStatistics.EvictedConnections += hostPool.Statistics.RemovedConnections;
+      hostStatistics.HandshakeTime += hostPool.Statistics.HandshakeTime;
+    }
+  }
+  result.LockWaitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::nanoseconds(m_lockWaitTime.load()));
+  return result;
+}
+
+std::unique_lock<std::mutex> CurlConnectionPool::LockShard(Shard& shard)
+{
+  std::unique_lock<std::mutex> lock(shard.Mutex, std::try_to_lock);
+  if (!lock.owns_lock())
+  {
+    // The clock is only read when the shard is contended.
+    auto const waitStart = std::chrono::steady_clock::now();
+    lock.lock();
+    m_lockWaitTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - waitStart)
+                          .count();
+  }
+  return lock;
+}
+
+std::map<std::string, CurlConnectionPool::HostPool>::iterator
+CurlConnectionPool::EraseUnusedHostPool(
+    Shard& shard,
+    std::map<std::string, HostPool>::iterator hostPool,
+    size_t closingConnections)
+{
+  if (!hostPool->second.Connections.empty())
+  {
+    return ++hostPool;
+  }
+  {
+    // The connections used by requests keep the counters of their key until they are destroyed.
+    std::lock_guard<std::mutex> lock(m_openConnectionState->Mutex);
+    auto const openConnections = m_openConnectionState->OpenConnections.find(hostPool->first);
+    if (openConnections != m_openConnectionState->OpenConnections.end()
+        && openConnections->second > closingConnections)
+    {
+      return ++hostPool;
+    }
+  }
+
+  auto const& statistics = hostPool->second.Statistics;
+  shard.RetiredStatistics.ReusedConnections += statistics.ReusedConnections;
+  shard.RetiredStatistics.CreatedConnections += statistics.CreatedConnections;
+  shard.RetiredStatistics.ReturnedConnections += statistics.ReturnedConnections;
+  shard.RetiredStatistics.RemovedConnections += statistics.RemovedConnections;
+  return shard.Index.erase(hostPool);
+}
+
+namespace {
+Azure::Core::Http::_internal::CurlConnectionPoolStatistics GetPoolStatistics(
+    CurlConnectionPool& connectionPool)
+{
+  auto const statistics = connectionPool.GetStatistics();
+  Azure::Core::Http::_internal::CurlConnectionPoolStatistics result;
+  result.CreatedConnections = statistics.CreatedConnections;
+  result.ReusedConnections = statistics.ReusedConnections;
+  return result;
+}
+} // namespace
+
+Azure::Core::Http::_internal::CurlConnectionPoolStatistics
+Azure::Core::Http::_internal::GetCurlConnectionPoolStatistics()
+{
+  return GetPoolStatistics(CurlConnectionPool::g_curlConnectionPool);
+}
+
+Azure::Core::Http::_internal::CurlConnectionPoolStatistics
+Azure::Core::Http::_internal::GetCurlConnectionPoolStatistics(CurlTransport const& transport)
+{
+  return GetPoolStatistics(
+      transport.m_connectionPool ? *transport.m_connectionPool
+                                 : CurlConnectionPool::g_curlConnectionPool);
 }
@@ -11,17 +11,24 @@
 
 #include "azure/core/dll_import_export.hpp"
 #include "azure/core/http/http.hpp"
+#include "azure/core/http/traffic_class.hpp"
+#include "azure/core/http/transport.hpp"
 
 #include "curl_connection_private.hpp"
 
 #include <atomic>
 #include <azure/core/http/curl_transport.hpp>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 #if defined(TESTING_BUILD)
 // Define the class name that reads from ConnectionPool private members
@@ -29,17 +36,67 @@ namespace Azure { namespace Core { namespace Test {
   class CurlConnectionPool_connectionPoolTest_Test;
   class CurlConnectionPool_uniquePort_Test;
   class CurlConnectionPool_connectionClose_Test;
+  class CurlConnectionPool_leaseAddress_Test;
 }}} // namespace Azure::Core::Test
 #endif
 
 namespace Azure { namespace Core { namespace Http { namespace _detail {
 
+  /**
+   * @brief Usage counters of the connection pool for one connection key.
+   *
+   */
+  struct CurlConnectionPoolHostStatistics final
+  {
+    /**
+     * @brief Number of connections currently in the pool, ready to be re-used.
+     *
+     */
+    size_t AvailableConnections = 0;
+
+    /**
+     * @brief Number of times a connection was taken from the pool instead of creating a new one.
+     *
+     */
+    uint64_t ReusedConnections = 0;
+
+    /**
+     * @brief Number of connections created because the pool had none to re-use.
+     *
+     */
+    uint64_t CreatedConnections = 0;
+
+    /**
+     * @brief Number of connections moved back to the pool.
+     *
+     */
+    uint64_t ReturnedConnections = 0;
+
+    /**
+     * @brief Number of connections removed from the pool because they expired, the pool was
+     * full or a reset was requested.
+     *
+     */
+    uint64_t RemovedConnections = 0;
+
+    /**
+     * @brief Time spent opening the connections created, up to the end of the TLS handshake.
+     *
+     */
+    std::chrono::microseconds HandshakeTime{0};
+  };
+
   /**
    * @brief CURL HTTP connection pool makes it possible to re-use one curl connection to perform
    * more than one request. Use this component when connections are not re-used by default.
    *
-   * This pool offers static methods and it is allocated statically. There can be only one
-   * connection pool per application.
+   * The pool shared by the transports is allocated statically, #g_curlConnectionPool. A transport
+   * created with #Azure::Core::Http::CurlTransportOptions::IsolatedConnectionPool owns a pool of
+   * its own instead, created by #CreateIsolatedPool(), with its own clean thread and share handle.
+   *
+   * @remark The pool is split into #DefaultConnectionPoolShardCount shards, each one with its own
+   * mutex. A connection key always maps to the same shard, so threads getting or returning
+   * connections for different hosts rarely wait on each other.
    */
   class CurlConnectionPool final {
 #if defined(TESTING_BUILD)
@@ -47,25 +104,234 @@ namespace Azure { namespace Core { namespace Http { namespace _detail {
     friend class Azure::Core::Test::CurlConnectionPool_connectionPoolTest_Test;
     friend class Azure::Core::Test::CurlConnectionPool_uniquePort_Test;
     friend class Azure::Core::Test::CurlConnectionPool_connectionClose_Test;
+    friend class Azure::Core::Test::CurlConnectionPool_leaseAddress_Test;
 #endif
 
+  private:
+    /**
+     * @brief A connection waiting in the pool to be re-used.
+     *
+     */
+    struct PooledConnection final
+    {
+      std::unique_ptr<CurlNetworkConnection> Connection;
+      // When the connection was moved back to the pool.
+      std::chrono::steady_clock::time_point ReturnedTime;
+    };
+
+    /**
+     * @brief The connections for one connection key.
+     *
+     * @remark Connections are added to the front of the list, so the connection waiting for the
+     * longest time is at the end. Depending on the eviction policy, connections are re-used from
+     * the front (Last-in-First-out) or from the end (First-in-First-out).
+     */
+    struct HostPool final
+    {
+      std::list<PooledConnection> Connections;
+      // The scheme, host name and port the connections are open to, as reported by
+      // GetConnectionPoolStatistics().
+      std::string Host;
+      CurlConnectionPoolOptions Options;
+      CurlConnectionPoolHostStatistics Statistics;
+    };
+
+    /**
+     * @brief A slice of the pool guarded by its own mutex.
+     *
+     * @details Keeps a unique key for each host and a pool of connections for each key. This way
+     * getting a connection for a specific host can be done in O(1) instead of looping a single
+     * connection list to find the first connection for the required host. The pool of a key is
+     * created with its first connection and erased once it has no connection left, idle or open,
+     * so the index doesn't grow with every host ever connected to.
+     */
+    struct Shard final
+    {
+      std::mutex Mutex;
+      std::map<std::string, HostPool> Index;
+      // The counters of the pools erased from the index, still part of GetStatistics().
+      CurlConnectionPoolHostStatistics RetiredStatistics;
+    };
+
+    Shard m_shards[DefaultConnectionPoolShardCount];
+
+    // Total time, in nanoseconds, the requests waited for another thread to release a shard.
+    std::atomic<std::chrono::nanoseconds::rep> m_lockWaitTime{0};
+
+    // Locks the mutex of the shard, adding the time waited for it to m_lockWaitTime.
+    std::unique_lock<std::mutex> LockShard(Shard& shard);
+
+    // Erases the pool of a connection key from the index of its shard if it has no idle
+    // connection and no open one but the closingConnections just removed from it. Called with the
+    // mutex of the shard. Returns the pool following the one passed.
+    std::map<std::string, HostPool>::iterator EraseUnusedHostPool(
+        Shard& shard,
+        std::map<std::string, HostPool>::iterator hostPool,
+        size_t closingConnections);
+
+    // Total number of connections in all the shards. The clean thread is stopped when it gets to
+    // zero.
+    std::atomic<size_t> m_connectionCount{0};
+
+    // Guards the start and stop of the clean thread.
+    std::mutex m_cleanThreadMutex;
+    // This is used to put the cleaning pool thread to sleep and yet to be able to wake it if the
+    // application finishes.
+    std::condition_variable m_cleanThreadWakeUp;
+    std::atomic<bool> m_isCleanThreadRunning{false};
+    bool m_isShuttingDown = false;
+    std::thread m_cleanThread;
+    // The earliest time, in steady clock ticks, when a connection in the pool expires. The clean
+    // thread sleeps until then, and it is woken up when a returned connection expires sooner.
+    std::atomic<std::chrono::steady_clock::rep> m_nextCleanTime{
+        (std::chrono::steady_clock::time_point::max)().time_since_epoch().count()};
+
+    // Shared by all the handles created by the pool, so a new connection can resume a TLS session
+    // and skip the DNS resolution of an earlier connection to the same host.
+    CURLSH* m_shareHandle = nullptr;
+    // One mutex for each kind of data in the share handle.
+    std::mutex m_shareMutexes[CURL_LOCK_DATA_LAST];
+
+    static void LockShare(CURL*, curl_lock_data data, curl_lock_access, void* userPointer);
+    static void UnlockShare(CURL*, curl_lock_data data, void* userPointer);
+
+    /**
+     * @brief The addresses the hosts resolve to, and the connections open to each of them, for
+     * spreading the connections to a host over its addresses.
+     *
+     * @remark It is shared with the address leases of the connections, which may outlive the pool
+     * at the end of the program.
+     */
+    struct AddressState final
+    {
+      struct ResolvedHost final
+      {
+        std::vector<std::string> Addresses;
+        std::chrono::steady_clock::time_point ExpiryTime;
+      };
+
+      std::mutex Mutex;
+      // By host name and port.
+      std::map<std::string, ResolvedHost> ResolvedHosts;
+      // By host name and address. Addresses without open connections are removed.
+      std::map<std::string, size_t> OpenConnections;
+    };
+
+    std::shared_ptr<AddressState> m_addressState = std::make_shared<AddressState>();
+
+    /**
+     * @brief The connections open for each connection key, either idle in the pool or used by a
+     * request.
+     *
+     * @remark Like the address state, it is shared with the connections, which decrement their
+     * count when they are destroyed.
+     */
+    struct OpenConnectionState final
+    {
+      std::mutex Mutex;
+      // Connection keys without open connections are removed.
+      std::map<std::string, size_t> OpenConnections;
+    };
+
+    std::shared_ptr<OpenConnectionState> m_openConnectionState
+        = std::make_shared<OpenConnectionState>();
+
+    // Picks the address of the host with the fewest open connections and sets \p address to it.
+    // Returns a lease counting a connection to the address until it is released, or null if the
+    // host can't be resolved, in which case libcurl resolves it when connecting.
+    std::shared_ptr<void> LeaseAddress(
+        std::string const& host,
+        uint16_t port,
+        std::chrono::seconds dnsCacheTimeout,
+        std::string& address);
+
+    // The pools are either g_curlConnectionPool or created by CreateIsolatedPool(). libcurl is
+    // initialized on first use, see EnsureGlobalInit().
+    CurlConnectionPool() = default;
+
+    // An isolated pool leaves the initialization and the cleanup of libcurl to
+    // g_curlConnectionPool, which lives until the end of the program.
+    bool m_isIsolated = false;
+
+    // Initializes libcurl and creates the share handle, once.
+    void GlobalInit();
+
+    std::once_flag m_globalInitFlag;
+    std::atomic<bool> m_isGlobalInitDone{false};
+
+    Shard& GetShard(std::string const& connectionKey)
+    {
+      return m_shards[std::hash<std::string>()(connectionKey) % DefaultConnectionPoolShardCount];
+    }
+
+    // Opens a new connection to the host of the url.
+    std::unique_ptr<CurlNetworkConnection> CreateCurlConnection(
+        Azure::Core::Url const& url,
+        std::string const& connectionKey,
+        CurlTransportOptions const& options);
+
+    // Starts the clean thread if it is not running.
+    void StartCleanThread();
+
+    // Removes the expired connections from the pool, until the pool gets empty.
+    void CleanupThread();
+
+    // Makes the clean thread wake up no later than the given time.
+    void ScheduleClean(std::chrono::steady_clock::time_point cleanTime);
+
   public:
     ~CurlConnectionPool()
     {
-      using namespace Azure::Core::Http::_detail;
       if (m_cleanThread.joinable())
       {
         {
-          std::unique_lock<std::mutex> lock(ConnectionPoolMutex);
-          // Remove all connections
-          g_curlConnectionPool.ConnectionPoolIndex.clear();
+          std::lock_guard<std::mutex> lock(m_cleanThreadMutex);
+          m_isShuttingDown = true;
         }
         // Signal clean thread to wake up
-        ConditionalVariableForCleanThread.notify_one();
+        m_cleanThreadWakeUp.notify_one();
         // join thread
         m_cleanThread.join();
       }
-      curl_global_cleanup();
+      // Remove all connections
+      RemoveAllConnections();
+      // The share handle can only be cleaned up once no handle uses it.
+      if (m_shareHandle != nullptr)
+      {
+        curl_share_cleanup(m_shareHandle);
+      }
+      if (m_isGlobalInitDone && !m_isIsolated)
+      {
+        curl_global_cleanup();
+      }
+    }
+
+    /**
+     * @brief Creates a connection pool separate from #g_curlConnectionPool, whose connections,
+     * limits and statistics aren't shared with the other transports.
+     *
+     */
+    static std::shared_ptr<CurlConnectionPool> CreateIsolatedPool()
+    {
+      std::shared_ptr<CurlConnectionPool> pool(new CurlConnectionPool());
+      pool->m_isIsolated = true;
+      return pool;
+    }
+
+    /**
+     * @brief Initializes libcurl the first time it's called, from any thread. It's called before
+     * creating libcurl handles rather than when the pool is constructed, at static initialization.
+     *
+     */
+    void EnsureGlobalInit()
+    {
+      if (!m_isGlobalInitDone.load(std::memory_order_acquire))
+      {
+        std::call_once(m_globalInitFlag, [this]() {
+          GlobalInit();
+          m_isGlobalInitDone.store(true, std::memory_order_release);
+        });
+      }
     }
 
     /**
@@ -77,13 +343,17 @@ namespace Azure { namespace Core { namespace Http { namespace _detail {
      * configuration.
      * @param resetPool Request the pool to remove all current connections for the provided
      * options to force the creation of a new connection.
+     * @param trafficClass The traffic class of \p request. A bulk request doesn't re-use the
+     * connections reserved for the interactive requests by
+     * #Azure::Core::Http::CurlTransportOptions::ReservedInteractiveConnections.
      *
      * @return #Azure::Core::Http::CurlNetworkConnection to use.
      */
     std::unique_ptr<CurlNetworkConnection> ExtractOrCreateCurlConnection(
         Request& request,
         CurlTransportOptions const& options,
-        bool resetPool = false);
+        bool resetPool = false,
+        TrafficClass trafficClass = TrafficClass::Interactive);
 
     /**
      * @brief Moves a connection back to the pool to be re-used.
@@ -96,34 +366,61 @@ namespace Azure { namespace Core { namespace Http { namespace _detail {
         HttpStatusCode lastStatusCode);
 
     /**
-     * @brief Keeps a unique key for each host and creates a connection pool for each key.
+     * @brief Opens connections ahead of time until the pool holds \p connectionCount connections
+     * for the host of \p url.
      *
-     * @details This way getting a connection for a specific host can be done in O(1) instead of
-     * looping a single connection list to find the first connection for the required host.
+     * @param url The URL of the host to connect to.
+     * @param options The connection settings used for the connections.
+     * @param connectionCount The number of connections the pool should hold for the host.
      *
-     * @remark There might be multiple connections for each host.
+     * @throw #Azure::Core::Http::TransportException if a connection cannot be opened. The
+     * connections opened successfully are still added to the pool.
      */
-    std::map<std::string, std::list<std::unique_ptr<CurlNetworkConnection>>> ConnectionPoolIndex;
+    void WarmUp(
+        Azure::Core::Url const& url,
+        CurlTransportOptions const& options,
+        size_t connectionCount);
 
-    std::mutex ConnectionPoolMutex;
+    /**
+     * @brief Closes all the connections in the pool.
+     *
+     */
+    void RemoveAllConnections();
 
-    // This is used to put the cleaning pool thread to sleep and yet to be able to wake it if the
-    // application finishes.
-    std::condition_variable ConditionalVariableForCleanThread;
+    /**
+     * @brief Gets the number of connections in the pool for a connection key.
+     *
+     * @param connectionKey The key of the connections to count.
+     */
+    size_t ConnectionsOnPool(std::string const& connectionKey);
 
-    AZ_CORE_DLLEXPORT static Azure::Core::Http::_detail::CurlConnectionPool g_curlConnectionPool;
+    /**
+     * @brief Gets the number of connection keys with at least one connection in the pool.
+     *
+     */
+    size_t HostsOnPool();
 
-    bool IsCleanThreadRunning = false;
+    /**
+     * @brief Gets the usage counters of the pool for a connection key.
+     *
+     * @param connectionKey The key of the connections to get the counters for.
+     */
+    CurlConnectionPoolHostStatistics GetHostStatistics(std::string const& connectionKey);
 
-  private:
-    // private constructor to keep this as singleton.
-    CurlConnectionPool() { curl_global_init(CURL_GLOBAL_ALL); }
+    /**
+     * @brief Gets the sum of the usage counters of the pool for all the connection keys.
+     *
+     */
+    CurlConnectionPoolHostStatistics GetStatistics();
 
-    // Makes possible to know the number of current connections in the connection pool for an
-    // index
-    size_t ConnectionsOnPool(std::string const& host) { return ConnectionPoolIndex[host].size(); }
+    /**
+     * @brief Gets a snapshot of the connections of the pool and of their usage counters, for each
+     * host.
+     *
+     */
+    Azure::Core::Http::ConnectionPoolStatistics GetConnectionPoolStatistics();
 
-    std::thread m_cleanThread;
+    AZ_CORE_DLLEXPORT static Azure::Core::Http::_detail::CurlConnectionPool g_curlConnectionPool;
   };
 
 }}}} // namespace Azure::Core::Http::_detail
@@ -9,9 +9,13 @@
 
 #pragma once
 
+#include "azure/core/http/curl_transport.hpp"
 #include "azure/core/http/http.hpp"
 
+#include "../../private/transfer_metrics.hpp"
+
 #include <chrono>
+#include <memory>
 #include <string>
 
 #if defined(_MSC_VER)
@@ -32,7 +36,6 @@ namespace Azure { namespace Core { namespace Http {
     // libcurl CURL_MAX_WRITE_SIZE is 64k. Using same value for default uploading chunk size.
     // This can be customizable in the HttpRequest
     constexpr static size_t DefaultUploadChunkSize = 1024 * 64;
-    constexpr static size_t DefaultLibcurlReaderSize = 1024;
     // Run time error template
     constexpr static const char* DefaultFailedToGetNewConnectionTemplate
         = "Fail to get a new connection for: ";
@@ -40,13 +43,66 @@ namespace Azure { namespace Core { namespace Http {
     // After 3 connections are received from the pool and failed to send a request, the next
     // connections would ask the pool to be clean and spawn new connection.
     constexpr static int32_t RequestPoolResetAfterConnectionFailed = 3;
-    // 90 sec -> cleaner wait time before next clean routine
-    constexpr static int32_t DefaultCleanerIntervalMilliseconds = 1000 * 90;
-    // 60 sec -> expired connection is when it waits for 60 sec or more and it's not re-used
-    constexpr static int32_t DefaultConnectionExpiredMilliseconds = 1000 * 60;
-    // Define the maximun allowed connections per host-index in the pool. If this number is reached
-    // for the host-index, next connections trying to be added to the pool will be ignored.
-    constexpr static int32_t MaxConnectionsPerIndex = 1024;
+    // Number of independently locked shards of the connection pool. Connection keys are spread
+    // across the shards by hash.
+    constexpr static size_t DefaultConnectionPoolShardCount = 16;
+    // Most connections opened at the same time by a warm up, by as many threads.
+    constexpr static size_t MaxWarmUpConcurrency = 16;
+
+    /**
+     * @brief The connection pool settings of a #Azure::Core::Http::CurlTransportOptions, with the
+     * default values already applied.
+     *
+     */
+    struct CurlConnectionPoolOptions final
+    {
+      size_t MaxConnectionsPerHost = DefaultMaxConnectionsPerHost;
+      // `0` means no limit.
+      size_t MaxConnections = 0;
+      std::chrono::milliseconds IdleTimeout = DefaultConnectionIdleTimeout;
+      std::chrono::milliseconds CleanerInterval = DefaultConnectionPoolCleanerInterval;
+      CurlConnectionPoolEvictionPolicy EvictionPolicy
+          = CurlConnectionPoolEvictionPolicy::LeastRecentlyUsed;
+      // `0` means no limit.
+      size_t MaxConnectionsPerAddress = 0;
+
+      CurlConnectionPoolOptions() = default;
+
+      explicit CurlConnectionPoolOptions(CurlTransportOptions const& options)
+          : MaxConnectionsPerHost(
+              options.MaxConnectionsPerHost == 0 ? DefaultMaxConnectionsPerHost
+                                                 : options.MaxConnectionsPerHost),
+            MaxConnections(options.MaxConnections),
+            IdleTimeout(
+                options.ConnectionIdleTimeout == std::chrono::milliseconds(0)
+                    ? DefaultConnectionIdleTimeout
+                    : options.ConnectionIdleTimeout),
+            CleanerInterval(
+                options.ConnectionPoolCleanerInterval == std::chrono::milliseconds(0)
+                    ? DefaultConnectionPoolCleanerInterval
+                    : options.ConnectionPoolCleanerInterval),
+            EvictionPolicy(options.EvictionPolicy),
+            MaxConnectionsPerAddress(options.MaxConnectionsPerAddress)
+      {
+      }
+
+      bool operator==(CurlConnectionPoolOptions const& other) const
+      {
+        return MaxConnectionsPerHost == other.MaxConnectionsPerHost
+            && MaxConnections == other.MaxConnections && IdleTimeout == other.IdleTimeout
+            && CleanerInterval == other.CleanerInterval && EvictionPolicy == other.EvictionPolicy
+            && MaxConnectionsPerAddress == other.MaxConnectionsPerAddress;
+      }
+    };
+
+    /**
+     * @brief Initializes libcurl, and the TLS library it uses, the first time it's called.
+     *
+     * @remark libcurl is cleaned up with the connection pool, when the process exits. It's called
+     * before creating libcurl handles, so that a process which never sends a request doesn't
+     * initialize libcurl.
+     */
+    void EnsureCurlGlobalInit();
   } // namespace _detail
 
   /**
@@ -59,6 +115,9 @@ namespace Azure { namespace Core { namespace Http {
   class CurlNetworkConnection {
   protected:
     bool m_isShutDown = false;
+    bool m_isReused = false;
+    _detail::CurlConnectionPoolOptions m_poolOptions;
+    std::string m_remoteAddress;
 
   public:
     /**
@@ -85,6 +144,13 @@ namespace Azure { namespace Core { namespace Http {
      */
     virtual bool IsExpired() = 0;
 
+    /**
+     * @brief Checks without blocking whether the server closed or reset this idle connection.
+     *
+     * @return `true` if the connection can't be re-used; otherwise, `false`.
+     */
+    virtual bool IsClosedByPeer() { return false; }
+
     /**
      * @brief This function is used when working with streams to pull more data from the wire.
      * Function will try to keep pulling data from socket until the buffer is all written or until
@@ -100,6 +166,18 @@ namespace Azure { namespace Core { namespace Http {
     virtual CURLcode SendBuffer(uint8_t const* buffer, size_t bufferSize, Context const& context)
         = 0;
 
+    /**
+     * @brief Waits until the server sent data to read, for at most \p timeout.
+     *
+     * @return `true` when there is data to read; `false` if the timeout expired first.
+     */
+    virtual bool WaitForResponse(std::chrono::milliseconds timeout, Context const& context)
+    {
+      (void)timeout;
+      (void)context;
+      return true;
+    }
+
     /**
      * @brief Set the connection into an invalid and unusable state.
      *
@@ -114,6 +192,37 @@ namespace Azure { namespace Core { namespace Http {
      * @return `true` is the connection was shut it down; otherwise, `false`.
      */
     bool IsShutdown() const { return m_isShutDown; }
+
+    /**
+     * @brief Marks the connection as taken from the connection pool, so it doesn't count as
+     * opened for the request using it.
+     *
+     */
+    void SetReused() { m_isReused = true; }
+
+    /**
+     * @brief Fills \p metrics with whether the connection is reused, and with the time taken to
+     * open it otherwise.
+     *
+     */
+    virtual void GetTransferMetrics(Diagnostics::_detail::TransferMetrics& metrics) const
+    {
+      metrics.IsConnectionReused = m_isReused;
+    }
+
+    /**
+     * @brief Get the settings of the connection pool the connection goes back to once it is no
+     * longer used.
+     *
+     */
+    _detail::CurlConnectionPoolOptions const& GetPoolOptions() const { return m_poolOptions; }
+
+    /**
+     * @brief Get the IP address of the host the connection is connected to, or an empty string if
+     * it is unknown.
+     *
+     */
+    std::string const& GetRemoteAddress() const { return m_remoteAddress; }
   };
 
   /**
@@ -126,6 +235,9 @@ namespace Azure { namespace Core { namespace Http {
     curl_socket_t m_curlSocket;
     std::chrono::steady_clock::time_point m_lastUseTime;
     std::string m_connectionKey;
+    // Counts the connection as open while it exists, for the statistics of the pool and to its
+    // address when the connections to the host are spread over its addresses.
+    std::shared_ptr<void> m_lease;
 
   public:
     /**
@@ -134,10 +246,21 @@ namespace Azure { namespace Core { namespace Http {
      * @param handle CURL handle.
      *
      * @param connectionPropertiesKey CURL connection properties key
+     *
+     * @param poolOptions The settings of the connection pool for the connection.
+     *
+     * @param lease Released when the connection is destroyed.
      */
-    CurlConnection(CURL* handle, std::string connectionPropertiesKey)
-        : m_handle(handle), m_connectionKey(std::move(connectionPropertiesKey))
+    CurlConnection(
+        CURL* handle,
+        std::string connectionPropertiesKey,
+        _detail::CurlConnectionPoolOptions const& poolOptions
+        = _detail::CurlConnectionPoolOptions(),
+        std::shared_ptr<void> lease = nullptr)
+        : m_handle(handle), m_connectionKey(std::move(connectionPropertiesKey)),
+          m_lease(std::move(lease))
     {
+      m_poolOptions = poolOptions;
       // Get the socket that libcurl is using from handle. Will use this to wait while
       // reading/writing
       // into wire
@@ -156,6 +279,13 @@ namespace Azure { namespace Core { namespace Http {
               "Broken connection. Couldn't get the active sockect for it."
               + std::string(curl_easy_strerror(result)));
         }
+
+        char* remoteAddress = nullptr;
+        if (curl_easy_getinfo(m_handle, CURLINFO_PRIMARY_IP, &remoteAddress) == CURLE_OK
+            && remoteAddress != nullptr)
+        {
+          m_remoteAddress = remoteAddress;
+        }
       }
 
       /**
@@ -183,7 +313,7 @@ namespace Azure { namespace Core { namespace Http {
       {
         auto connectionOnWaitingTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - this->m_lastUseTime);
-        return connectionOnWaitingTimeMs.count() >= _detail::DefaultConnectionExpiredMilliseconds;
+        return connectionOnWaitingTimeMs >= m_poolOptions.IdleTimeout;
       }
 
       /**
@@ -212,6 +342,26 @@ namespace Azure { namespace Core { namespace Http {
       CURLcode SendBuffer(uint8_t const* buffer, size_t bufferSize, Context const& context)
           override;
 
+      /**
+       * @brief Polls the socket until the server sent data to read, for at most \p timeout.
+       *
+       * @param timeout The maximum time to wait.
+       * @param context A context to control the request lifetime.
+       * @return `true` when there is data to read; `false` if the timeout expired first.
+       */
+      bool WaitForResponse(std::chrono::milliseconds timeout, Context const& context) override;
+
+      /**
+       * @brief Polls the socket of the idle connection without waiting. Nothing is sent to an idle
+       * connection, so it is readable only once the server closed it, reset it, or sent data no
+       * request asked for, such as a TLS close_notify alert.
+       *
+       * @return `true` if the socket is readable or in error; otherwise, `false`.
+       */
+      bool IsClosedByPeer() override;
+
+      void GetTransferMetrics(Diagnostics::_detail::TransferMetrics& metrics) const override;
+
       void Shutdown() override;
     };
 }}} // namespace Azure::Core::Http
@@ -0,0 +1,1022 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/http/curl_transport.hpp"
+#include "azure/core/http/http.hpp"
+#include "azure/core/internal/diagnostics/log.hpp"
+#include "azure/core/internal/strings.hpp"
+
+// Private include
+#include "../../private/context_cancellation.hpp"
+#include "curl_multi_private.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <vector>
+
+using Azure::Core::Context;
+using Azure::Core::Diagnostics::Logger;
+using Azure::Core::Diagnostics::_internal::Log;
+using Azure::Core::Http::CurlMultiTransport;
+using Azure::Core::Http::CurlMultiTransportOptions;
+using Azure::Core::Http::CurlTransportOptions;
+using Azure::Core::Http::HttpMethod;
+using Azure::Core::Http::HttpStatusCode;
+using Azure::Core::Http::RawResponse;
+using Azure::Core::Http::Request;
+using Azure::Core::Http::TransportException;
+using Azure::Core::Http::_detail::CurlEventLoop;
+using Azure::Core::Http::_detail::CurlMultiBodyStream;
+using Azure::Core::Http::_detail::CurlMultiTransfer;
+
+namespace {
+std::string const LogMsgPrefix = "[CURL Multi Transport Adapter]: ";
+
+constexpr static const char* FailedToSetupTransferTemplate = "Fail to set up a transfer for: ";
+
+template <typename T>
+#if defined(_MSC_VER)
+#pragma warning(push)
+// C26812: The enum type 'CURLoption' is un-scoped. Prefer 'enum class' over 'enum' (Enum.3)
+#pragma warning(disable : 26812)
+#endif
+inline void SetMultiLibcurlOption(
+    CURL* handle,
+    CURLoption option,
+    T value,
+    std::string const& host,
+    char const* description)
+{
+  auto result = curl_easy_setopt(handle, option, value);
+  if (result != CURLE_OK)
+  {
+    throw TransportException(
+        FailedToSetupTransferTemplate + host + ". Failed to set " + description + ". "
+        + std::string(curl_easy_strerror(result)));
+  }
+}
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+// Parses a status line like `HTTP/1.1 200 OK`. libcurl reports HTTP/2 responses as `HTTP/2 200`.
+std::unique_ptr<RawResponse> CreateHTTPResponse(char const* const begin, char const* const last)
+{
+  auto start = begin + 5; // HTTP = 4, / = 1, moving to 5th place for version
+  auto end = std::find_if(start, last, [](char c) { return c == '.' || c == ' '; });
+  auto majorVersion = std::stoi(std::string(start, end));
+  auto minorVersion = 0;
+  if (end != last && *end == '.')
+  {
+    start = end + 1;
+    end = std::find(start, last, ' ');
+    minorVersion = std::stoi(std::string(start, end));
+  }
+
+  start = end + 1; // start of status code
+  end = std::find_if(start, last, [](char c) { return c == ' ' || c == '\r'; });
+  auto statusCode = std::stoi(std::string(start, end));
+
+  std::string reasonPhrase;
+  if (end != last && *end == ' ')
+  {
+    start = end + 1; // start of reason phrase
+    end = std::find(start, last, '\r');
+    reasonPhrase = std::string(start, end); // remove \r
+  }
+
+  return std::make_unique<RawResponse>(
+      static_cast<uint16_t>(majorVersion),
+      static_cast<uint16_t>(minorVersion),
+      HttpStatusCode(statusCode),
+      reasonPhrase);
+}
+
+bool IsInformationalResponse(RawResponse const& response)
+{
+  auto code = static_cast<std::underlying_type<HttpStatusCode>::type>(response.GetStatusCode());
+  return code >= 100 && code < 200;
+}
+
+// The length of the body of the response from its headers, or -1 if it isn't known.
+int64_t GetResponseContentLength(HttpMethod const& method, RawResponse const& response)
+{
+  auto const statusCode = response.GetStatusCode();
+  if (method == HttpMethod::Head || statusCode == HttpStatusCode::NoContent
+      || statusCode == HttpStatusCode::NotModified)
+  {
+    return 0;
+  }
+
+  auto const& headers = response.GetHeaders();
+  auto contentLengthHeader = headers.find("content-length");
+  if (contentLengthHeader != headers.end())
+  {
+    return static_cast<int64_t>(std::stoull(contentLengthHeader->second));
+  }
+  return -1;
+}
+
+void CallResponseCallback(
+    Azure::Core::Http::ResponseCallback const& callback,
+    std::unique_ptr<RawResponse> response,
+    std::exception_ptr error)
+{
+  try
+  {
+    callback(std::move(response), std::move(error));
+  }
+  catch (std::exception const& e)
+  {
+    // Exceptions can't go through the event loop.
+    Log::Write(
+        Logger::Level::Error,
+        LogMsgPrefix + "The callback of an asynchronous request threw: " + e.what());
+  }
+  catch (...)
+  {
+    Log::Write(
+        Logger::Level::Error, LogMsgPrefix + "The callback of an asynchronous request threw.");
+  }
+}
+} // namespace
+
+/************************************* CurlMultiTransfer ********************************/
+
+CurlMultiTransfer::CurlMultiTransfer(
+    Request& request,
+    CurlMultiTransportOptions const& multiOptions,
+    Context context)
+    : m_handle(nullptr), m_request(&request), m_context(std::move(context))
+{
+  Azure::Core::Http::_detail::EnsureCurlGlobalInit();
+  m_handle = curl_easy_init();
+  try
+  {
+    ConfigureHandle(request, multiOptions);
+  }
+  catch (...)
+  {
+    // The destructor won't run for a constructor which throws.
+    if (m_handle)
+    {
+      curl_easy_cleanup(m_handle);
+    }
+    if (m_headerList)
+    {
+      curl_slist_free_all(m_headerList);
+    }
+    throw;
+  }
+}
+
+void CurlMultiTransfer::ConfigureHandle(
+    Request& request,
+    CurlMultiTransportOptions const& multiOptions)
+{
+  auto const& options = multiOptions.TransportOptions;
+  auto const& url = request.GetUrl();
+  uint16_t port = url.GetPort();
+  std::string const host
+      = url.GetScheme() + url.GetHost() + (port != 0 ? std::to_string(port) : "");
+
+  if (!m_handle)
+  {
+    throw TransportException(
+        FailedToSetupTransferTemplate + host + ". " + std::string("curl_easy_init returned Null"));
+  }
+
+  SetMultiLibcurlOption(m_handle, CURLOPT_URL, url.GetAbsoluteUrl().data(), host, "url");
+  if (port != 0)
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_PORT, port, host, "port");
+  }
+
+  if (multiOptions.EnableHttp2)
+  {
+    // HTTP/2 is negotiated with ALPN, so it is only used over TLS. Waiting for the connection
+    // being established lets the request be multiplexed on it instead of opening another one.
+    SetMultiLibcurlOption(
+        m_handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS, host, "libcurl HTTP/2");
+    SetMultiLibcurlOption(m_handle, CURLOPT_PIPEWAIT, 1L, host, "wait for multiplexing");
+  }
+  else
+  {
+    // Same as the libcurl transport, only HTTP/1.1 is supported.
+    SetMultiLibcurlOption(
+        m_handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1, host, "libcurl HTTP/1.1");
+  }
+
+  if (options.ConnectionTimeout != Azure::Core::Http::_detail::DefaultConnectionTimeout)
+  {
+    SetMultiLibcurlOption(
+        m_handle,
+        CURLOPT_CONNECTTIMEOUT_MS,
+        static_cast<long>(options.ConnectionTimeout.count()),
+        host,
+        "connect timeout");
+  }
+
+  if (options.DnsCacheTimeout != std::chrono::seconds(0)
+      && options.DnsCacheTimeout != Azure::Core::Http::_detail::DefaultDnsCacheTimeout)
+  {
+    SetMultiLibcurlOption(
+        m_handle,
+        CURLOPT_DNS_CACHE_TIMEOUT,
+        static_cast<long>(options.DnsCacheTimeout.count()),
+        host,
+        "DNS cache timeout");
+  }
+
+  if (!options.Proxy.empty())
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_PROXY, options.Proxy.c_str(), host, "proxy");
+  }
+
+  if (!options.CAInfo.empty())
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_CAINFO, options.CAInfo.c_str(), host, "CA cert");
+  }
+
+  long sslOption = 0;
+  if (!options.SslOptions.EnableCertificateRevocationListCheck)
+  {
+    sslOption |= CURLSSLOPT_NO_REVOKE;
+  }
+  SetMultiLibcurlOption(m_handle, CURLOPT_SSL_OPTIONS, sslOption, host, "ssl options");
+
+  if (!options.SslVerifyPeer)
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_SSL_VERIFYPEER, 0L, host, "ssl verify peer");
+  }
+
+  if (options.NoSignal)
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_NOSIGNAL, 1L, host, "NOSIGNAL option");
+  }
+
+  if (!options.HttpKeepAlive)
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_FORBID_REUSE, 1L, host, "forbid connection re-use");
+  }
+
+  // Callbacks. They are all invoked from the event loop thread.
+  SetMultiLibcurlOption(m_handle, CURLOPT_HEADERFUNCTION, OnHeader, host, "headers callback");
+  SetMultiLibcurlOption(
+      m_handle, CURLOPT_HEADERDATA, static_cast<void*>(this), host, "headers data");
+  SetMultiLibcurlOption(m_handle, CURLOPT_WRITEFUNCTION, OnWrite, host, "data callback");
+  SetMultiLibcurlOption(m_handle, CURLOPT_WRITEDATA, static_cast<void*>(this), host, "write data");
+  SetMultiLibcurlOption(m_handle, CURLOPT_NOPROGRESS, 0L, host, "progress");
+  SetMultiLibcurlOption(m_handle, CURLOPT_XFERINFOFUNCTION, OnProgress, host, "progress callback");
+  SetMultiLibcurlOption(
+      m_handle, CURLOPT_XFERINFODATA, static_cast<void*>(this), host, "progress data");
+
+  // Method
+  auto const& method = request.GetMethod();
+  auto bodyStream = request.GetBodyStream();
+  if (method == HttpMethod::Get)
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_HTTPGET, 1L, host, "GET Method");
+  }
+  else if (method == HttpMethod::Head)
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_NOBODY, 1L, host, "HEAD Method");
+  }
+  else
+  {
+    SetMultiLibcurlOption(
+        m_handle, CURLOPT_CUSTOMREQUEST, method.ToString().c_str(), host, "custom Method");
+
+    auto const bodyLength = bodyStream->Length();
+    if (bodyLength != 0 || method == HttpMethod::Put || method == HttpMethod::Post
+        || method == HttpMethod::Patch)
+    {
+      SetMultiLibcurlOption(m_handle, CURLOPT_UPLOAD, 1L, host, "upload mode");
+      SetMultiLibcurlOption(m_handle, CURLOPT_READFUNCTION, OnUpload, host, "upload callback");
+      SetMultiLibcurlOption(
+          m_handle, CURLOPT_READDATA, static_cast<void*>(this), host, "upload data");
+      // An unknown length (-1) makes libcurl use a chunked request.
+      if (bodyLength >= 0)
+      {
+        SetMultiLibcurlOption(
+            m_handle,
+            CURLOPT_INFILESIZE_LARGE,
+            static_cast<curl_off_t>(bodyLength),
+            host,
+            "upload body size");
+      }
+    }
+  }
+
+  // Headers. An empty value is sent as `name;` (libcurl would drop `name:`).
+  Azure::Core::Http::_detail::RequestHelpers::ForEachHeader(
+      request, [this, &host](std::string const& name, std::string const& value) {
+        auto const line = value.empty() ? name + ";" : name + ": " + value;
+        auto newList = curl_slist_append(m_headerList, line.c_str());
+        if (newList == nullptr)
+        {
+          throw TransportException(
+              FailedToSetupTransferTemplate + host + ". Failed to add header.");
+        }
+        m_headerList = newList;
+      });
+  if (m_headerList != nullptr)
+  {
+    SetMultiLibcurlOption(m_handle, CURLOPT_HTTPHEADER, m_headerList, host, "headers");
+  }
+}
+
+CurlMultiTransfer::~CurlMultiTransfer()
+{
+  // The event loop removes the handle from the multi handle before releasing the transfer.
+  if (m_handle)
+  {
+    curl_easy_cleanup(m_handle);
+  }
+  if (m_headerList)
+  {
+    curl_slist_free_all(m_headerList);
+  }
+}
+
+size_t CurlMultiTransfer::OnHeader(char* contents, size_t size, size_t nitems, void* userData)
+{
+  size_t const expectedSize = size * nitems;
+  auto transfer = static_cast<CurlMultiTransfer*>(userData);
+  char const* const last = contents + expectedSize;
+
+  // Set when the headers of an asynchronous transfer streaming its response body were received.
+  Azure::Core::Http::ResponseCallback callback;
+  std::unique_ptr<RawResponse> response;
+  int64_t contentLength = -1;
+
+  std::unique_lock<std::mutex> lock(transfer->m_mutex);
+  try
+  {
+    if (expectedSize >= 5 && std::equal(contents, contents + 5, "HTTP/"))
+    {
+      // A new status line. Anything received before belongs to an informational response (like
+      // `100 Continue`) and is discarded.
+      transfer->m_response = CreateHTTPResponse(contents, last);
+    }
+    else if (expectedSize <= 2 && (expectedSize == 0 || contents[0] == '\r' || contents[0] == '\n'))
+    {
+      // End of headers
+      if (transfer->m_response != nullptr && !IsInformationalResponse(*transfer->m_response))
+      {
+        transfer->m_headersCompleted = true;
+        transfer->m_stateChanged.notify_all();
+
+        if (transfer->m_responseCallback)
+        {
+          auto const statusCode = static_cast<std::underlying_type<HttpStatusCode>::type>(
+              transfer->m_response->GetStatusCode());
+          if (transfer->m_request->ShouldBufferResponse() || statusCode >= 300)
+          {
+            // The response is returned once all its body is received.
+            transfer->m_bufferBody = true;
+          }
+          else
+          {
+            contentLength = GetResponseContentLength(
+                transfer->m_request->GetMethod(), *transfer->m_response);
+            callback = std::move(transfer->m_responseCallback);
+            transfer->m_responseCallback = nullptr;
+            response = std::move(transfer->m_response);
+            transfer->m_requestDetached = true;
+          }
+        }
+      }
+    }
+    else if (transfer->m_response != nullptr)
+    {
+      Azure::Core::Http::_detail::RawResponseHelpers::SetHeader(
+          *transfer->m_response,
+          reinterpret_cast<uint8_t const*>(contents),
+          reinterpret_cast<uint8_t const*>(last));
+    }
+  }
+  catch (...)
+  {
+    // Exceptions can't go through libcurl. Returning a different size fails the transfer.
+    transfer->m_callbackException = std::current_exception();
+    return 0;
+  }
+
+  if (callback)
+  {
+    lock.unlock();
+    response->SetBodyStream(
+        std::make_unique<CurlMultiBodyStream>(transfer->shared_from_this(), contentLength));
+    CallResponseCallback(callback, std::move(response), nullptr);
+  }
+
+  // This callback needs to return the response size or curl will consider it as it failed
+  return expectedSize;
+}
+
+size_t CurlMultiTransfer::OnWrite(char* contents, size_t size, size_t nmemb, void* userData)
+{
+  size_t const expectedSize = size * nmemb;
+  auto transfer = static_cast<CurlMultiTransfer*>(userData);
+
+  std::lock_guard<std::mutex> lock(transfer->m_mutex);
+  if (!transfer->m_bufferBody
+      && transfer->m_bufferedBytes >= _detail::DefaultMultiTransferMaxBufferedBytes)
+  {
+    // The reader is slower than the network. libcurl delivers the same data again once the
+    // transfer is resumed.
+    transfer->m_paused = true;
+    return CURL_WRITEFUNC_PAUSE;
+  }
+
+  auto data = reinterpret_cast<uint8_t const*>(contents);
+  transfer->m_bodyChunks.emplace_back(data, data + expectedSize);
+  transfer->m_bufferedBytes += expectedSize;
+  transfer->m_stateChanged.notify_all();
+
+  return expectedSize;
+}
+
+size_t CurlMultiTransfer::OnUpload(char* destination, size_t size, size_t nitems, void* userData)
+{
+  auto transfer = static_cast<CurlMultiTransfer*>(userData);
+
+  std::lock_guard<std::mutex> lock(transfer->m_mutex);
+  if (transfer->m_requestDetached)
+  {
+    // The response was already returned to the caller, which might have released the request.
+    return CURL_READFUNC_ABORT;
+  }
+
+  try
+  {
+    return transfer->m_request->GetBodyStream()->Read(
+        reinterpret_cast<uint8_t*>(destination), size * nitems, transfer->m_context);
+  }
+  catch (...)
+  {
+    transfer->m_callbackException = std::current_exception();
+    return CURL_READFUNC_ABORT;
+  }
+}
+
+int CurlMultiTransfer::OnProgress(void* userData, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+{
+  auto transfer = static_cast<CurlMultiTransfer*>(userData);
+  // Returning non-zero aborts the transfer with CURLE_ABORTED_BY_CALLBACK.
+  return transfer->m_context.IsCancelled() ? 1 : 0;
+}
+
+void CurlMultiTransfer::Complete(CURLcode result)
+{
+  Azure::Core::Http::ResponseCallback callback;
+  std::unique_ptr<RawResponse> response;
+  std::vector<uint8_t> body;
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_transferCompleted = true;
+    m_result = result;
+    m_stateChanged.notify_all();
+
+    // Nothing else to do unless the transfer is asynchronous and its response is still expected.
+    if (!m_responseCallback)
+    {
+      return;
+    }
+    callback = std::move(m_responseCallback);
+    m_responseCallback = nullptr;
+    m_requestDetached = true;
+    if (result == CURLE_OK && m_headersCompleted)
+    {
+      response = std::move(m_response);
+      body.reserve(m_bufferedBytes);
+      for (auto const& chunk : m_bodyChunks)
+      {
+        body.insert(body.end(), chunk.begin(), chunk.end());
+      }
+      m_bodyChunks.clear();
+      m_bufferedBytes = 0;
+    }
+    else
+    {
+      error = GetTransferError();
+    }
+  }
+
+  if (response)
+  {
+    response->SetBody(std::move(body));
+  }
+  CallResponseCallback(callback, std::move(response), std::move(error));
+}
+
+std::exception_ptr CurlMultiTransfer::GetTransferError() const
+{
+  if (m_callbackException)
+  {
+    return m_callbackException;
+  }
+  if ((!m_transferCompleted || m_result == CURLE_ABORTED_BY_CALLBACK) && m_context.IsCancelled())
+  {
+    // Cancelled. The event loop stops the transfer as soon as the progress callback runs again.
+    try
+    {
+      m_context.ThrowIfCancelled();
+    }
+    catch (...)
+    {
+      return std::current_exception();
+    }
+  }
+  return std::make_exception_ptr(TransportException(
+      "Error while sending request. " + std::string(curl_easy_strerror(m_result))));
+}
+
+/**
+ * @remark The listener takes the mutex of the transfer, so the registration must be made and
+ * released without holding it.
+ */
+class CurlMultiTransfer::WaitCancellationListener final
+    : public Azure::Core::_detail::ContextCancellationListener {
+private:
+  CurlMultiTransfer& m_transfer;
+
+public:
+  explicit WaitCancellationListener(CurlMultiTransfer& transfer) : m_transfer(transfer) {}
+
+  void OnContextCancelled() noexcept override
+  {
+    std::shared_ptr<CurlEventLoop> eventLoop;
+    {
+      // Taking the mutex orders the notification after the waiting thread checked its context.
+      std::lock_guard<std::mutex> lock(m_transfer.m_mutex);
+      m_transfer.m_stateChanged.notify_all();
+      if (m_transfer.m_transferCompleted)
+      {
+        return;
+      }
+      eventLoop = m_transfer.m_eventLoop.lock();
+    }
+
+    // The response is no longer awaited. Removing the transfer wakes up the event loop with
+    // curl_multi_wakeup(), so the transfer is stopped right away too.
+    if (eventLoop)
+    {
+      try
+      {
+        eventLoop->RemoveTransfer(m_transfer.shared_from_this());
+      }
+      catch (...)
+      {
+        // The transfer is stopped by the progress callback instead.
+      }
+    }
+  }
+};
+
+std::unique_ptr<RawResponse> CurlMultiTransfer::WaitForHeaders()
+{
+  WaitCancellationListener listener(*this);
+  Azure::Core::_detail::ContextCancellationRegistration registration(m_context, &listener);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_headersCompleted && !m_transferCompleted)
+  {
+    if (m_context.IsCancelled())
+    {
+      m_requestDetached = true;
+      break;
+    }
+    m_stateChanged.wait(lock);
+  }
+  m_requestDetached = true;
+
+  if (m_headersCompleted)
+  {
+    return std::move(m_response);
+  }
+
+  auto error = GetTransferError();
+  lock.unlock();
+  std::rethrow_exception(error);
+}
+
+void CurlMultiTransfer::SetResponseCallback(Azure::Core::Http::ResponseCallback callback)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_responseCallback = std::move(callback);
+}
+
+void CurlMultiTransfer::Fail(std::exception_ptr error)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callbackException = std::move(error);
+  }
+  Complete(CURLE_FAILED_INIT);
+}
+
+/************************************* CurlMultiBodyStream ********************************/
+
+CurlMultiBodyStream::~CurlMultiBodyStream()
+{
+  bool transferCompleted;
+  {
+    std::lock_guard<std::mutex> lock(m_transfer->m_mutex);
+    transferCompleted = m_transfer->m_transferCompleted;
+  }
+
+  if (!transferCompleted)
+  {
+    // The response was not read to the end. Abort the transfer, so the connection is not re-used.
+    if (auto eventLoop = m_transfer->m_eventLoop.lock())
+    {
+      eventLoop->RemoveTransfer(m_transfer);
+    }
+  }
+}
+
+size_t CurlMultiBodyStream::OnRead(uint8_t* buffer, size_t count, Context const& context)
+{
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  auto& transfer = *m_transfer;
+  CurlMultiTransfer::WaitCancellationListener listener(transfer);
+  Azure::Core::_detail::ContextCancellationRegistration registration(context, &listener);
+
+  std::unique_lock<std::mutex> lock(transfer.m_mutex);
+  while (transfer.m_bufferedBytes == 0 && !transfer.m_transferCompleted)
+  {
+    if (context.IsCancelled())
+    {
+      lock.unlock();
+      context.ThrowIfCancelled();
+    }
+    transfer.m_stateChanged.wait(lock);
+  }
+
+  if (transfer.m_bufferedBytes == 0)
+  {
+    // Transfer completed and all the data was read.
+    if (transfer.m_result != CURLE_OK)
+    {
+      auto callbackException = transfer.m_callbackException;
+      auto result = transfer.m_result;
+      lock.unlock();
+      if (callbackException)
+      {
+        std::rethrow_exception(callbackException);
+      }
+      throw TransportException(
+          "Error while reading from network socket. " + std::string(curl_easy_strerror(result)));
+    }
+    return 0;
+  }
+
+  size_t totalRead = 0;
+  while (totalRead < count && !transfer.m_bodyChunks.empty())
+  {
+    auto& chunk = transfer.m_bodyChunks.front();
+    auto const toCopy = (std::min)(count - totalRead, chunk.size() - transfer.m_bodyChunkOffset);
+    std::copy(
+        chunk.begin() + transfer.m_bodyChunkOffset,
+        chunk.begin() + transfer.m_bodyChunkOffset + toCopy,
+        buffer + totalRead);
+    totalRead += toCopy;
+    transfer.m_bodyChunkOffset += toCopy;
+    if (transfer.m_bodyChunkOffset == chunk.size())
+    {
+      transfer.m_bodyChunks.pop_front();
+      transfer.m_bodyChunkOffset = 0;
+    }
+  }
+  transfer.m_bufferedBytes -= totalRead;
+
+  bool const resume = transfer.m_paused && !transfer.m_resumePosted
+      && transfer.m_bufferedBytes < _detail::DefaultMultiTransferResumeBufferedBytes;
+  if (resume)
+  {
+    transfer.m_resumePosted = true;
+  }
+  lock.unlock();
+
+  if (resume)
+  {
+    if (auto eventLoop = transfer.m_eventLoop.lock())
+    {
+      eventLoop->ResumeTransfer(m_transfer);
+    }
+  }
+
+  return totalRead;
+}
+
+/************************************* CurlEventLoop ********************************/
+
+CurlEventLoop::CurlEventLoop()
+{
+  Azure::Core::Http::_detail::EnsureCurlGlobalInit();
+  m_multiHandle = curl_multi_init();
+  if (!m_multiHandle)
+  {
+    throw TransportException("Failed to create the libcurl multi handle.");
+  }
+  // Only transfers using HTTP/2 can be multiplexed.
+  if (curl_multi_setopt(m_multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX) != CURLM_OK)
+  {
+    curl_multi_cleanup(m_multiHandle);
+    throw TransportException("Failed to enable multiplexing on the libcurl multi handle.");
+  }
+}
+
+CurlEventLoop::~CurlEventLoop()
+{
+  Stop();
+  curl_multi_cleanup(m_multiHandle);
+}
+
+void CurlEventLoop::Start()
+{
+  m_thread = std::thread([this]() { Run(); });
+}
+
+void CurlEventLoop::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_commandsMutex);
+    m_stopRequested = true;
+  }
+  Wakeup();
+  if (m_thread.joinable())
+  {
+    m_thread.join();
+  }
+
+  // The event loop thread is gone. Fail everything it was still driving.
+  for (auto& activeTransfer : m_activeTransfers)
+  {
+    curl_multi_remove_handle(m_multiHandle, activeTransfer.first);
+    activeTransfer.second->Complete(CURLE_ABORTED_BY_CALLBACK);
+  }
+  m_activeTransfers.clear();
+
+  std::vector<Command> commands;
+  {
+    std::lock_guard<std::mutex> lock(m_commandsMutex);
+    commands.swap(m_commands);
+  }
+  for (auto& command : commands)
+  {
+    if (command.Type == CommandType::Add)
+    {
+      command.Transfer->Complete(CURLE_ABORTED_BY_CALLBACK);
+    }
+  }
+}
+
+void CurlEventLoop::Wakeup()
+{
+  m_commandsPosted.notify_one();
+#if LIBCURL_VERSION_NUM >= 0x074400 // 7.68.0
+  curl_multi_wakeup(m_multiHandle);
+#endif
+}
+
+void CurlEventLoop::AddTransfer(std::shared_ptr<CurlMultiTransfer> transfer)
+{
+  {
+    std::lock_guard<std::mutex> transferLock(transfer->m_mutex);
+    transfer->m_eventLoop = shared_from_this();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_commandsMutex);
+    if (m_stopRequested)
+    {
+      throw TransportException("Error while sending request. The transport was stopped.");
+    }
+    m_commands.emplace_back(Command{CommandType::Add, std::move(transfer)});
+  }
+  Wakeup();
+}
+
+void CurlEventLoop::ResumeTransfer(std::shared_ptr<CurlMultiTransfer> transfer)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_commandsMutex);
+    m_commands.emplace_back(Command{CommandType::Resume, std::move(transfer)});
+  }
+  Wakeup();
+}
+
+void CurlEventLoop::RemoveTransfer(std::shared_ptr<CurlMultiTransfer> transfer)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_commandsMutex);
+    m_commands.emplace_back(Command{CommandType::Remove, std::move(transfer)});
+  }
+  Wakeup();
+}
+
+void CurlEventLoop::ProcessCommands()
+{
+  std::vector<Command> commands;
+  {
+    std::lock_guard<std::mutex> lock(m_commandsMutex);
+    commands.swap(m_commands);
+  }
+
+  for (auto& command : commands)
+  {
+    auto handle = command.Transfer->m_handle;
+    switch (command.Type)
+    {
+      case CommandType::Add: {
+        auto result = curl_multi_add_handle(m_multiHandle, handle);
+        if (result != CURLM_OK)
+        {
+          Log::Write(
+              Logger::Level::Error,
+              LogMsgPrefix + "Failed to add transfer. " + curl_multi_strerror(result));
+          command.Transfer->Complete(CURLE_FAILED_INIT);
+          break;
+        }
+        m_activeTransfers.emplace(handle, std::move(command.Transfer));
+        break;
+      }
+      case CommandType::Resume: {
+        if (m_activeTransfers.find(handle) == m_activeTransfers.end())
+        {
+          break;
+        }
+        {
+          std::lock_guard<std::mutex> lock(command.Transfer->m_mutex);
+          command.Transfer->m_paused = false;
+          command.Transfer->m_resumePosted = false;
+        }
+        // Can't hold the transfer mutex here, libcurl might call the write callback right away.
+        curl_easy_pause(handle, CURLPAUSE_CONT);
+        break;
+      }
+      case CommandType::Remove: {
+        auto activeTransfer = m_activeTransfers.find(handle);
+        if (activeTransfer == m_activeTransfers.end())
+        {
+          break;
+        }
+        curl_multi_remove_handle(m_multiHandle, handle);
+        command.Transfer->Complete(CURLE_ABORTED_BY_CALLBACK);
+        m_activeTransfers.erase(activeTransfer);
+        break;
+      }
+    }
+  }
+}
+
+void CurlEventLoop::ProcessCompletedTransfers()
+{
+  int messagesInQueue = 0;
+  while (auto message = curl_multi_info_read(m_multiHandle, &messagesInQueue))
+  {
+    if (message->msg != CURLMSG_DONE)
+    {
+      continue;
+    }
+    // The message is not valid after removing the handle.
+    auto handle = message->easy_handle;
+    auto result = message->data.result;
+
+    auto activeTransfer = m_activeTransfers.find(handle);
+    if (activeTransfer == m_activeTransfers.end())
+    {
+      continue;
+    }
+    curl_multi_remove_handle(m_multiHandle, handle);
+    activeTransfer->second->Complete(result);
+    m_activeTransfers.erase(activeTransfer);
+  }
+}
+
+void CurlEventLoop::Run()
+{
+  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Event loop started.");
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_commandsMutex);
+      if (m_activeTransfers.empty())
+      {
+        // Nothing to drive. Sleep until there is a new command.
+        m_commandsPosted.wait(lock, [this]() { return m_stopRequested || !m_commands.empty(); });
+      }
+      if (m_stopRequested)
+      {
+        break;
+      }
+    }
+
+    ProcessCommands();
+
+    int runningTransfers = 0;
+    auto result = curl_multi_perform(m_multiHandle, &runningTransfers);
+    if (result != CURLM_OK)
+    {
+      Log::Write(
+          Logger::Level::Error,
+          LogMsgPrefix + "curl_multi_perform failed. " + curl_multi_strerror(result));
+    }
+
+    ProcessCompletedTransfers();
+
+    if (!m_activeTransfers.empty())
+    {
+#if LIBCURL_VERSION_NUM >= 0x074400 // 7.68.0
+      // Returns as soon as any socket is ready, a libcurl timer expires or Wakeup() is called.
+      curl_multi_poll(
+          m_multiHandle, nullptr, 0, _detail::DefaultEventLoopMaxWaitMilliseconds, nullptr);
+#else
+      // There is no way to wake this call up, so keep the wait short so new commands are picked.
+      curl_multi_wait(m_multiHandle, nullptr, 0, 10, nullptr);
+#endif
+    }
+  }
+  Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Event loop stopped.");
+}
+
+/************************************* CurlMultiTransport ********************************/
+
+CurlMultiTransport::CurlMultiTransport(CurlMultiTransportOptions const& options)
+    : m_options(options)
+{
+  auto const eventLoopCount = m_options.EventLoopCount == 0 ? 1 : m_options.EventLoopCount;
+  m_eventLoops.reserve(eventLoopCount);
+  for (size_t index = 0; index < eventLoopCount; index++)
+  {
+    auto eventLoop = std::make_shared<CurlEventLoop>();
+    eventLoop->Start();
+    m_eventLoops.emplace_back(std::move(eventLoop));
+  }
+}
+
+CurlMultiTransport::~CurlMultiTransport()
+{
+  // Response body streams might still reference the event loops, make sure the threads are gone.
+  for (auto& eventLoop : m_eventLoops)
+  {
+    eventLoop->Stop();
+  }
+}
+
+std::unique_ptr<RawResponse> CurlMultiTransport::Send(Request& request, Context const& context)
+{
+  context.ThrowIfCancelled();
+
+  auto transfer = std::make_shared<CurlMultiTransfer>(request, m_options, context);
+  auto const& eventLoop = m_eventLoops[m_nextEventLoop++ % m_eventLoops.size()];
+  eventLoop->AddTransfer(transfer);
+
+  auto response = transfer->WaitForHeaders();
+
+  auto const contentLength = GetResponseContentLength(request.GetMethod(), *response);
+
+  if (Log::ShouldWrite(Logger::Level::Verbose))
+  {
+    Log::Write(Logger::Level::Verbose, LogMsgPrefix + "Response headers received.");
+  }
+  response->SetBodyStream(std::make_unique<CurlMultiBodyStream>(transfer, contentLength));
+  return response;
+}
+
+void CurlMultiTransport::SendAsync(
+    Request& request,
+    Context const& context,
+    Azure::Core::Http::ResponseCallback callback)
+{
+  std::shared_ptr<CurlMultiTransfer> transfer;
+  try
+  {
+    context.ThrowIfCancelled();
+    transfer = std::make_shared<CurlMultiTransfer>(request, m_options, context);
+  }
+  catch (...)
+  {
+    callback(nullptr, std::current_exception());
+    return;
+  }
+  transfer->SetResponseCallback(std::move(callback));
+
+  auto const& eventLoop = m_eventLoops[m_nextEventLoop++ % m_eventLoops.size()];
+  try
+  {
+    eventLoop->AddTransfer(transfer);
+  }
+  catch (...)
+  {
+    transfer->Fail(std::current_exception());
+  }
+}
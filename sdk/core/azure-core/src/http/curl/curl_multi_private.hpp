@@ -0,0 +1,259 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief The curl event loop drives many HTTP transfers from a single thread using the libcurl
+ * multi interface.
+ *
+ * @remark Every libcurl call for a handle added to the multi handle is done from the event loop
+ * thread. Other threads talk to the loop by posting commands, which wakes the loop up.
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/http/curl_transport.hpp"
+#include "azure/core/http/http.hpp"
+#include "azure/core/io/body_stream.hpp"
+
+#include "curl_connection_private.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Core { namespace Http { namespace _detail {
+
+  class CurlEventLoop;
+
+  // When the response body buffered for a transfer grows over this size, the transfer is paused
+  // until the reader consumes it.
+  constexpr static size_t DefaultMultiTransferMaxBufferedBytes = 1024 * 1024;
+  // A paused transfer is resumed once the buffered response body shrinks under this size.
+  constexpr static size_t DefaultMultiTransferResumeBufferedBytes = 256 * 1024;
+  // Maximum time the event loop waits on the sockets before checking posted commands again. The
+  // loop is woken up earlier by any posted command.
+  constexpr static int DefaultEventLoopMaxWaitMilliseconds = 1000;
+
+  /**
+   * @brief The state of an HTTP request being sent by a #CurlEventLoop.
+   *
+   * @remark The transfer is shared between the event loop (which drives it) and the caller thread
+   * (which waits for the response and then reads the body). All the members below `m_mutex` are
+   * guarded by it. A transfer sent asynchronously has a callback instead, which the event loop
+   * calls with the response.
+   */
+  class CurlMultiTransfer final : public std::enable_shared_from_this<CurlMultiTransfer> {
+    friend class CurlEventLoop;
+    friend class CurlMultiBodyStream;
+
+  private:
+    CURL* m_handle;
+    struct curl_slist* m_headerList = nullptr;
+    Request* m_request;
+    Context m_context;
+    std::weak_ptr<CurlEventLoop> m_eventLoop;
+
+    std::mutex m_mutex;
+    std::condition_variable m_stateChanged;
+
+    // The response is created by the header callback on the event loop thread and moved out to the
+    // caller once all the headers were received.
+    std::unique_ptr<RawResponse> m_response;
+    bool m_headersCompleted = false;
+    bool m_transferCompleted = false;
+    // Set when the caller no longer owns the request, so the body stream must not be read.
+    bool m_requestDetached = false;
+    bool m_paused = false;
+    bool m_resumePosted = false;
+    CURLcode m_result = CURLE_OK;
+    std::exception_ptr m_callbackException;
+    // Set for a transfer sent asynchronously until it is called, once, by the event loop.
+    ResponseCallback m_responseCallback;
+    // Set when an asynchronous transfer returns the response with its whole body, which is then
+    // never paused.
+    bool m_bufferBody = false;
+    // Response body received from the network and not yet read by the body stream.
+    std::deque<std::vector<uint8_t>> m_bodyChunks;
+    size_t m_bodyChunkOffset = 0;
+    size_t m_bufferedBytes = 0;
+
+    // Wakes up a thread waiting on the transfer as soon as the context it waits with is cancelled.
+    class WaitCancellationListener;
+
+    static size_t OnHeader(char* contents, size_t size, size_t nitems, void* userData);
+    static size_t OnWrite(char* contents, size_t size, size_t nmemb, void* userData);
+    static size_t OnUpload(char* destination, size_t size, size_t nitems, void* userData);
+    static int OnProgress(
+        void* userData,
+        curl_off_t downloadTotal,
+        curl_off_t downloadNow,
+        curl_off_t uploadTotal,
+        curl_off_t uploadNow);
+
+    void ConfigureHandle(Request& request, CurlMultiTransportOptions const& options);
+
+    // Called from the event loop thread once libcurl has finished with the handle.
+    void Complete(CURLcode result);
+
+    // The exception the transfer failed with, called with m_mutex held.
+    std::exception_ptr GetTransferError() const;
+
+  public:
+    /**
+     * @brief Creates a transfer for the \p request, configuring a new libcurl easy handle.
+     *
+     * @param request The HTTP request to send. It must stay alive until
+     * #Azure::Core::Http::_detail::CurlMultiTransfer::WaitForHeaders returns.
+     * @param options The libcurl settings for the connection.
+     * @param context A context to control the request lifetime.
+     *
+     * @throw #Azure::Core::Http::TransportException if the handle cannot be configured.
+     */
+    CurlMultiTransfer(Request& request, CurlMultiTransportOptions const& options, Context context);
+
+    ~CurlMultiTransfer();
+
+    CurlMultiTransfer(CurlMultiTransfer const&) = delete;
+    CurlMultiTransfer& operator=(CurlMultiTransfer const&) = delete;
+
+    /**
+     * @brief Blocks until the status line and all the headers of the final response were received,
+     * then detaches the transfer from the request.
+     *
+     * @throw #Azure::Core::Http::TransportException if the transfer failed before getting the
+     * response headers.
+     * @throw #Azure::Core::OperationCancelledException if the context was cancelled.
+     */
+    std::unique_ptr<RawResponse> WaitForHeaders();
+
+    /**
+     * @brief Makes the transfer asynchronous: \p callback is called from the event loop with the
+     * response, instead of being waited for with
+     * #Azure::Core::Http::_detail::CurlMultiTransfer::WaitForHeaders.
+     *
+     * @remark The response body is received before \p callback is called, unless the request
+     * doesn't buffer its response and the status code is under 300.
+     */
+    void SetResponseCallback(ResponseCallback callback);
+
+    /**
+     * @brief Completes a transfer which couldn't be handed to an event loop with \p error.
+     *
+     */
+    void Fail(std::exception_ptr error);
+  };
+
+  /**
+   * @brief A body stream that reads the response body that a #CurlEventLoop receives for a
+   * transfer.
+   */
+  class CurlMultiBodyStream final : public Azure::Core::IO::BodyStream {
+  private:
+    std::shared_ptr<CurlMultiTransfer> m_transfer;
+    int64_t m_contentLength;
+
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+
+  public:
+    /**
+     * @brief Construct the body stream for a transfer which has already received the headers.
+     *
+     * @param transfer The transfer to read the body from.
+     * @param contentLength The value from the `content-length` response header or `-1` if the
+     * length is unknown.
+     */
+    CurlMultiBodyStream(std::shared_ptr<CurlMultiTransfer> transfer, int64_t contentLength)
+        : m_transfer(std::move(transfer)), m_contentLength(contentLength)
+    {
+    }
+
+    ~CurlMultiBodyStream() override;
+
+    int64_t Length() const override { return m_contentLength; }
+  };
+
+  /**
+   * @brief A thread driving a libcurl multi handle which performs many transfers concurrently.
+   *
+   * @remark libcurl keeps a connection cache for each multi handle, so connections are re-used
+   * across the transfers driven by the same event loop.
+   */
+  class CurlEventLoop final : public std::enable_shared_from_this<CurlEventLoop> {
+  private:
+    enum class CommandType
+    {
+      Add,
+      Resume,
+      Remove,
+    };
+
+    struct Command final
+    {
+      CommandType Type;
+      std::shared_ptr<CurlMultiTransfer> Transfer;
+    };
+
+    CURLM* m_multiHandle;
+    std::thread m_thread;
+
+    std::mutex m_commandsMutex;
+    // Used to put the event loop to sleep while there are no transfers in progress.
+    std::condition_variable m_commandsPosted;
+    std::vector<Command> m_commands;
+    bool m_stopRequested = false;
+
+    // Owned by the event loop thread only.
+    std::map<CURL*, std::shared_ptr<CurlMultiTransfer>> m_activeTransfers;
+
+    void Run();
+    void ProcessCommands();
+    void ProcessCompletedTransfers();
+    void Wakeup();
+
+  public:
+    CurlEventLoop();
+    ~CurlEventLoop();
+
+    CurlEventLoop(CurlEventLoop const&) = delete;
+    CurlEventLoop& operator=(CurlEventLoop const&) = delete;
+
+    /**
+     * @brief Starts the event loop thread.
+     *
+     */
+    void Start();
+
+    /**
+     * @brief Stops the event loop thread and fails every transfer which has not completed yet.
+     *
+     */
+    void Stop();
+
+    /**
+     * @brief Hands a new transfer to the event loop.
+     *
+     */
+    void AddTransfer(std::shared_ptr<CurlMultiTransfer> transfer);
+
+    /**
+     * @brief Resumes a transfer that was paused because its response body buffer was full.
+     *
+     */
+    void ResumeTransfer(std::shared_ptr<CurlMultiTransfer> transfer);
+
+    /**
+     * @brief Aborts a transfer whose response is no longer needed.
+     *
+     */
+    void RemoveTransfer(std::shared_ptr<CurlMultiTransfer> transfer);
+  };
+
+}}}} // namespace Azure::Core::Http::_detail
@@ -16,8 +16,13 @@
 #include "curl_connection_pool_private.hpp"
 #include "curl_connection_private.hpp"
 
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef TESTING_BUILD
 // Define the class name that reads from ConnectionPool private members
@@ -90,8 +95,9 @@ namespace Azure { namespace Core { namespace Http {
      * @brief stateful component used to read and parse a buffer to construct a valid HTTP
      * RawResponse.
      *
-     * @remark It uses an internal string as a buffer to accumulate a response token (version, code,
-     * header, etc.) until the next delimiter is found. Then it uses this string to keep building
+     * @remark Tokens (status line and headers) found complete in the parsed buffer are read in
+     * place. It only uses an internal string as a buffer to accumulate a response token split
+     * across buffers until the next delimiter is found. Then it uses this string to keep building
      * the HTTP RawResponse.
      *
      * @remark Only status line and headers are parsed and built. Body is ignored by this
@@ -134,33 +140,6 @@ namespace Azure { namespace Core { namespace Http {
        */
       std::string m_internalBuffer;
 
-      /**
-       * @brief This method is invoked by the Parsing process if the internal state is set to
-       * status code. Function will get the status-line expected tokens until finding the end of
-       * status line delimiter.
-       *
-       * @remark When the end of status line delimiter is found, this method will create the HTTP
-       * RawResponse. The HTTP RawResponse is constructed by default with body type as Stream.
-       *
-       * @param buffer Points to a memory address with all or some part of a HTTP status line.
-       * @param bufferSize Indicates the size of the buffer.
-       * @return Returns the index of the last parsed position from buffer.
-       */
-      size_t BuildStatusCode(uint8_t const* const buffer, size_t const bufferSize);
-
-      /**
-       * @brief This method is invoked by the Parsing process if the internal state is set to
-       * headers. Function will keep adding headers to the HTTP RawResponse created before while
-       * parsing an status line.
-       *
-       * @param buffer Points to a memory address with all or some part of a HTTP header.
-       * @param bufferSize Indicates the size of the buffer.
-       * @return Returns the index of the last parsed position from buffer. When the returned
-       * value is smaller than the body size, means there is part of the body response in the
-       * buffer.
-       */
-      size_t BuildHeader(uint8_t const* const buffer, size_t const bufferSize);
-
     public:
       /**
        * @brief Construct a new RawResponse Buffer Parser object.
@@ -254,6 +233,10 @@ namespace Azure { namespace Core { namespace Http {
 
     bool m_isChunkedResponseType = false;
 
+    // Set when the body of the request has an unknown length, in which case it is sent with
+    // chunked transfer-encoding.
+    bool m_isChunkedRequestType = false;
+
     /**
      * @brief This is a copy of the value of an HTTP response header `content-length`. The value
      * is received as string and parsed to size_t. This field avoid parsing the string header
@@ -275,23 +258,110 @@ namespace Azure { namespace Core { namespace Http {
     size_t m_sessionTotalRead = 0;
 
     /**
-     * @brief Internal buffer from a session used to read bytes from a socket. This buffer is only
-     * used while constructing an HTTP RawResponse without adding a body to it. Customers would
-     * provide their own buffer to copy from socket when reading the HTTP body using streams.
+     * @brief Internal buffer from a session used to read bytes from a socket. This buffer is used
+     * while constructing an HTTP RawResponse without adding a body to it, and to serve body reads
+     * smaller than the buffer. Customers would provide their own buffer to copy from socket when
+     * reading large parts of the HTTP body using streams.
+     *
+     * @remark The buffer never shrinks, so its size is always a valid value for the "no data"
+     * sentinel of #m_bodyStartInBuffer.
+     *
+     */
+    std::vector<uint8_t> m_readBuffer;
+
+    /**
+     * @brief When true, the read buffer is doubled, up to
+     * #Azure::Core::Http::_detail::DefaultMaxAdaptiveReaderSize, every time a read from the socket
+     * fills it completely.
+     *
+     */
+    bool m_adaptiveReadBuffer;
+
+    /**
+     * @brief Fills the inner buffer from the socket with up to \p maxSize bytes of the response
+     * body.
+     *
+     * @param maxSize The maximum number of bytes to read from the socket.
+     * @param context A context to control the request lifetime.
+     * @return The number of bytes read into the inner buffer. `0` means the connection is closed.
+     */
+    size_t FillInnerBuffer(size_t maxSize, Context const& context);
+
+    /**
+     * @brief The minimum throughput of the response body, in bytes per second, or `0` when it isn't
+     * checked, and the time spent reading the body over which it is measured.
+     *
+     */
+    size_t m_minimumReadThroughput;
+    std::chrono::milliseconds m_readThroughputWindow;
+
+    /**
+     * @brief The duration and the size of the reads of the body from the socket during the last
+     * #m_readThroughputWindow of time spent reading, and their totals.
      *
      */
-    uint8_t m_readBuffer[_detail::DefaultLibcurlReaderSize]
-        = {0}; // to work with libcurl custom read.
+    std::deque<std::pair<std::chrono::steady_clock::duration, size_t>> m_bodyReads;
+    std::chrono::steady_clock::duration m_bodyReadDuration{};
+    size_t m_bodyReadBytes = 0;
+
+    /**
+     * @brief Set once the body was received slower than #m_minimumReadThroughput. The next read
+     * throws, the bytes already read are returned first.
+     *
+     */
+    bool m_readThroughputTooLow = false;
+
+    /**
+     * @brief The body size from which requests are sent with an `Expect: 100-continue` header, or
+     * a negative value when they never are, and the time waited for the server to accept them.
+     *
+     */
+    int64_t m_expectContinueThreshold;
+    std::chrono::milliseconds m_expectContinueTimeout;
+
+    /**
+     * @brief Reads the response body from the socket with \p read, checking that it is received
+     * at #m_minimumReadThroughput at least.
+     *
+     * @param read Reads from the socket with the context it is given.
+     * @param context A context to control the request lifetime.
+     * @return The number of bytes read by \p read.
+     */
+    size_t ReadBodyFromSocket(
+        std::function<size_t(Context const&)> const& read,
+        Context const& context);
+
+    CurlSession(
+        Request& request,
+        std::unique_ptr<CurlNetworkConnection> connection,
+        bool keepAlive,
+        CurlTransportOptions const& options)
+        : m_connection(std::move(connection)), m_request(request),
+          m_readBuffer(
+              options.ReadBufferSize == 0 ? _detail::DefaultLibcurlReaderSize
+                                          : options.ReadBufferSize),
+          m_adaptiveReadBuffer(options.AdaptiveReadBuffer),
+          m_minimumReadThroughput(options.MinimumReadThroughput),
+          m_readThroughputWindow(
+              options.ReadThroughputWindow == std::chrono::milliseconds(0)
+                  ? _detail::DefaultReadThroughputWindow
+                  : options.ReadThroughputWindow),
+          m_expectContinueThreshold(options.ExpectContinueThreshold),
+          m_expectContinueTimeout(options.ExpectContinueTimeout), m_keepAlive(keepAlive)
+    {
+    }
 
     /**
      * @brief Function used when working with Streams to manually write from the HTTP Request to
      * the wire.
      *
      * @param context A context to control the request lifetime.
+     * @param expectContinue Whether the request is sent with an `Expect: 100-continue` header, in
+     * which case its body is left to be uploaded once the server accepted the request.
      *
      * @return CURL_OK when response is sent successfully.
      */
-    CURLcode SendRawHttp(Context const& context);
+    CURLcode SendRawHttp(Context const& context, bool expectContinue);
 
     /**
      * @brief Upload body.
@@ -302,6 +372,17 @@ namespace Azure { namespace Core { namespace Http {
      */
     CURLcode UploadBody(Context const& context);
 
+    /**
+     * @brief Sends a piece of the body of a request, as a chunk when the request is chunked.
+     *
+     * @param data The data to send. An empty piece ends a chunked body.
+     * @param size The number of bytes in \p data.
+     * @param context A context to control the request lifetime.
+     *
+     * @return Curl code.
+     */
+    CURLcode SendBodyChunk(uint8_t const* data, size_t size, Context const& context);
+
     /**
      * @brief This function is used after sending an HTTP request to the server to read the HTTP
      * RawResponse from wire until the end of headers only.
@@ -358,6 +439,14 @@ namespace Azure { namespace Core { namespace Http {
      */
     bool m_keepAlive = true;
 
+    /**
+     * @brief The isolated connection pool the connection goes back to, or null for the connection
+     * pool shared by the transports. It's kept alive by the session, which may outlive the
+     * transport.
+     *
+     */
+    std::shared_ptr<_detail::CurlConnectionPool> m_connectionPool;
+
     /**
      * @brief Implement #Azure::Core::IO::BodyStream::OnRead(). Calling this function pulls data
      * from the wire.
@@ -376,8 +465,27 @@ namespace Azure { namespace Core { namespace Http {
      * @param request reference to an HTTP Request.
      */
     CurlSession(Request& request, std::unique_ptr<CurlNetworkConnection> connection, bool keepAlive)
-        : m_connection(std::move(connection)), m_request(request), m_keepAlive(keepAlive)
+        : CurlSession(request, std::move(connection), keepAlive, CurlTransportOptions())
+    {
+    }
+
+    /**
+     * @brief Construct a new Curl Session object using the read buffer settings from \p options.
+     *
+     * @param request reference to an HTTP Request.
+     * @param connection The connection used to send the request.
+     * @param options The transport options for the read buffer and keep alive settings.
+     * @param connectionPool The isolated connection pool \p connection was taken from, or null
+     * for the connection pool shared by the transports.
+     */
+    CurlSession(
+        Request& request,
+        std::unique_ptr<CurlNetworkConnection> connection,
+        CurlTransportOptions const& options,
+        std::shared_ptr<_detail::CurlConnectionPool> connectionPool = nullptr)
+        : CurlSession(request, std::move(connection), options.HttpKeepAlive, options)
     {
+      m_connectionPool = std::move(connectionPool);
     }
 
     ~CurlSession() override
@@ -390,9 +498,12 @@ namespace Azure { namespace Core { namespace Http {
       // IsEOF will also handle a connection that fail to complete an upload request.
       if (IsEOF() && m_keepAlive)
       {
-        _detail::CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
-            std::move(m_connection), m_lastStatusCode);
+        auto& connectionPool = m_connectionPool ? *m_connectionPool
+                                                : _detail::CurlConnectionPool::g_curlConnectionPool;
+        connectionPool.MoveConnectionBackToPool(std::move(m_connection), m_lastStatusCode);
       }
+      // A connection which isn't re-used is closed before the pool whose share handle it uses.
+      m_connection.reset();
     }
 
     /**
@@ -4,6 +4,7 @@
 #include "azure/core/http/policies/policy.hpp"
 #include "azure/core/internal/diagnostics/log.hpp"
 
+#include "curl_connection_private.hpp"
 #include "static_curl_transport.hpp"
 
 #include <memory>
@@ -207,6 +208,7 @@ public:
     // ******************************************************************
     // ***************************************************  INIT ******
     // ******************************************************************
+    Azure::Core::Http::_detail::EnsureCurlGlobalInit();
     m_libcurlHandle = curl_easy_init();
     if (!m_libcurlHandle)
     {
@@ -0,0 +1,214 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/http/policies/policy.hpp"
+#include "azure/core/internal/diagnostics/log.hpp"
+
+#include "../private/delayed_work_scheduler.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using Azure::Core::Context;
+using namespace Azure::Core::Http;
+using namespace Azure::Core::Http::Policies;
+using namespace Azure::Core::Http::Policies::_internal;
+
+namespace {
+// The number of recent response times the hedging delay is computed from, the number of them
+// needed before it is computed, and how often it is computed again.
+constexpr size_t MaxResponseTimes = 1000;
+constexpr size_t MinResponseTimes = 20;
+constexpr size_t DelayUpdateInterval = 16;
+
+bool IsHedgeable(Request& request)
+{
+  auto const method = request.GetMethod();
+  auto const bodyStream = request.GetBodyStream();
+  return (method == HttpMethod::Get || method == HttpMethod::Head)
+      && (bodyStream == nullptr || bodyStream->Length() == 0);
+}
+} // namespace
+
+// The recent response times of the requests, in a ring buffer, and the hedging delay computed from
+// them.
+class HedgingPolicy::ResponseTimes final {
+private:
+  std::mutex m_mutex;
+  std::vector<std::chrono::steady_clock::duration> m_responseTimes;
+  size_t m_next = 0;
+  size_t m_addedSinceUpdate = 0;
+  std::chrono::milliseconds m_delay;
+
+public:
+  explicit ResponseTimes(std::chrono::milliseconds maxDelay) : m_delay(maxDelay)
+  {
+    m_responseTimes.reserve(MaxResponseTimes);
+  }
+
+  std::chrono::milliseconds Delay()
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_delay;
+  }
+
+  void Add(std::chrono::steady_clock::duration responseTime, HedgingOptions const& options)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_responseTimes.size() < MaxResponseTimes)
+    {
+      m_responseTimes.push_back(responseTime);
+    }
+    else
+    {
+      m_responseTimes[m_next] = responseTime;
+      m_next = (m_next + 1) % MaxResponseTimes;
+    }
+    if (m_responseTimes.size() < MinResponseTimes || ++m_addedSinceUpdate < DelayUpdateInterval)
+    {
+      return;
+    }
+    m_addedSinceUpdate = 0;
+
+    auto responseTimes = m_responseTimes;
+    auto const percentile = (std::min)(100.0, (std::max)(0.0, options.DelayPercentile));
+    auto const nth = responseTimes.begin()
+        + static_cast<std::ptrdiff_t>(
+            static_cast<double>(responseTimes.size() - 1) * percentile / 100.0);
+    std::nth_element(responseTimes.begin(), nth, responseTimes.end());
+    m_delay = (std::min)(
+        options.MaxDelay,
+        (std::max)(
+            options.MinDelay, std::chrono::duration_cast<std::chrono::milliseconds>(*nth)));
+  }
+};
+
+HedgingPolicy::HedgingPolicy(HedgingOptions options)
+    : m_hedgingOptions(std::move(options)),
+      m_responseTimes(std::make_shared<ResponseTimes>(m_hedgingOptions.MaxDelay))
+{
+}
+
+std::unique_ptr<RawResponse> HedgingPolicy::Send(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context) const
+{
+  using Azure::Core::Diagnostics::Logger;
+  using Azure::Core::Diagnostics::_internal::Log;
+
+  if (!IsHedgeable(request))
+  {
+    return nextPolicy.Send(request, context);
+  }
+
+  // The request is sent from this thread, the duplicate from a worker of the scheduler once the
+  // delay has elapsed. No thread is involved for the requests answered before. The request which
+  // loses is cancelled through its own context.
+  struct
+  {
+    std::mutex Mutex;
+    std::condition_variable StateChanged;
+    bool PrimaryDone = false;
+    bool PrimaryAnswered = false;
+    bool HedgeDone = false;
+    std::unique_ptr<RawResponse> HedgeResponse;
+  } state;
+  auto primaryContext = context.WithDeadline((DateTime::max)());
+  auto hedgeContext = context.WithDeadline((DateTime::max)());
+  // Copied before the next policies update the request.
+  Request hedgeRequest(request);
+  auto const delay = m_responseTimes->Delay();
+  auto const start = std::chrono::steady_clock::now();
+
+  auto& scheduler = Azure::Core::_detail::DelayedWorkScheduler::GetInstance();
+  auto const hedge = scheduler.Schedule(delay, [&]() {
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    if (state.PrimaryDone)
+    {
+      state.HedgeDone = true;
+      lock.unlock();
+      state.StateChanged.notify_all();
+      return;
+    }
+    lock.unlock();
+
+    if (Log::ShouldWrite(Logger::Level::Informational))
+    {
+      std::ostringstream log;
+      log << "HTTP request not answered after " << delay.count()
+          << "ms, sending a hedged request.";
+      Log::Write(Logger::Level::Informational, log.str());
+    }
+    auto const hedgeStart = std::chrono::steady_clock::now();
+    std::unique_ptr<RawResponse> response;
+    try
+    {
+      response = nextPolicy.Send(hedgeRequest, hedgeContext);
+    }
+    catch (...)
+    {
+    }
+
+    lock.lock();
+    state.HedgeDone = true;
+    if (response && !state.PrimaryAnswered)
+    {
+      if (!state.PrimaryDone)
+      {
+        primaryContext.Cancel();
+      }
+      m_responseTimes->Add(std::chrono::steady_clock::now() - hedgeStart, m_hedgingOptions);
+      state.HedgeResponse = std::move(response);
+    }
+    lock.unlock();
+    state.StateChanged.notify_all();
+  });
+
+  std::unique_ptr<RawResponse> response;
+  std::exception_ptr exception;
+  try
+  {
+    response = nextPolicy.Send(request, primaryContext);
+  }
+  catch (...)
+  {
+    exception = std::current_exception();
+  }
+
+  // Once handed to a worker, the duplicate uses the state of this call until it's done.
+  bool const hedgeDispatched = !scheduler.Unschedule(hedge);
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  state.PrimaryDone = true;
+  if (!state.HedgeResponse && response)
+  {
+    // The answered request is the one used, the duplicate is cancelled.
+    state.PrimaryAnswered = true;
+    hedgeContext.Cancel();
+  }
+  if (hedgeDispatched)
+  {
+    // When the request failed, the duplicate may still be answered.
+    state.StateChanged.wait(lock, [&state]() { return state.HedgeDone; });
+  }
+  lock.unlock();
+
+  if (state.HedgeResponse)
+  {
+    // The time of the request which lost is still recorded, so that the delay doesn't shrink as
+    // the slow requests get hedged.
+    m_responseTimes->Add(std::chrono::steady_clock::now() - start, m_hedgingOptions);
+    return std::move(state.HedgeResponse);
+  }
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+  m_responseTimes->Add(std::chrono::steady_clock::now() - start, m_hedgingOptions);
+  return response;
+}
@@ -27,8 +27,8 @@ const HttpMethod HttpMethod::Patch("PATCH");
 
 void Azure::Core::Http::_detail::RawResponseHelpers::InsertHeaderWithValidation(
     Azure::Core::CaseInsensitiveMap& headers,
-    std::string const& headerName,
-    std::string const& headerValue)
+    std::string headerName,
+    std::string headerValue)
 {
   // Static table for validating header names. It is created just once for the program and reused
   // each time SetHeader is called
@@ -173,7 +173,7 @@ void Azure::Core::Http::_detail::RawResponseHelpers::InsertHeaderWithValidation(
     }
   }
   // insert (override if duplicated)
-  headers[headerName] = headerValue;
+  headers[std::move(headerName)] = std::move(headerValue);
 }
 
 Request::Request(HttpMethod httpMethod, Url url, bool shouldBufferResponse)
@@ -54,7 +54,10 @@ inline void LogUrlWithoutQuery(std::ostringstream& log, Url const& url)
   }
 }
 
-inline std::string GetRequestLogMessage(LogOptions const& options, Request const& request)
+inline std::string GetRequestLogMessage(
+    LogOptions const& options,
+    std::set<std::string> const& encodedAllowedQueryParams,
+    Request const& request)
 {
   auto const& requestUrl = request.GetUrl();
 
@@ -63,36 +66,28 @@ inline std::string GetRequestLogMessage(LogOptions const& options, Request const
   LogUrlWithoutQuery(log, requestUrl);
 
   {
-    auto encodedRequestQueryParams = requestUrl.GetQueryParameters();
+    auto const& encodedRequestQueryParams = requestUrl.GetQueryParametersView();
 
+    // The parameters are sorted by name, and are logged in the same order.
     std::remove_const<std::remove_reference<decltype(encodedRequestQueryParams)>::type>::type
         loggedQueryParams;
+    loggedQueryParams.reserve(encodedRequestQueryParams.size());
 
     if (!encodedRequestQueryParams.empty())
     {
-      auto const& unencodedAllowedQueryParams = options.AllowedHttpQueryParameters;
-      if (!unencodedAllowedQueryParams.empty())
+      if (!encodedAllowedQueryParams.empty())
       {
-        std::remove_const<std::remove_reference<decltype(unencodedAllowedQueryParams)>::type>::type
-            encodedAllowedQueryParams;
-        std::transform(
-            unencodedAllowedQueryParams.begin(),
-            unencodedAllowedQueryParams.end(),
-            std::inserter(encodedAllowedQueryParams, encodedAllowedQueryParams.begin()),
-            [](std::string const& s) { return Url::Encode(s); });
-
         for (auto const& encodedRequestQueryParam : encodedRequestQueryParams)
         {
           if (encodedRequestQueryParam.second.empty()
               || (encodedAllowedQueryParams.find(encodedRequestQueryParam.first)
                   != encodedAllowedQueryParams.end()))
           {
-            loggedQueryParams.insert(encodedRequestQueryParam);
+            loggedQueryParams.push_back(encodedRequestQueryParam);
           }
           else
           {
-            loggedQueryParams.insert(
-                std::make_pair(encodedRequestQueryParam.first, RedactedPlaceholder));
+            loggedQueryParams.emplace_back(encodedRequestQueryParam.first, RedactedPlaceholder);
           }
         }
       }
@@ -100,8 +95,7 @@ inline std::string GetRequestLogMessage(LogOptions const& options, Request const
       {
         for (auto const& encodedRequestQueryParam : encodedRequestQueryParams)
         {
-          loggedQueryParams.insert(
-              std::make_pair(encodedRequestQueryParam.first, RedactedPlaceholder));
+          loggedQueryParams.emplace_back(encodedRequestQueryParam.first, RedactedPlaceholder);
         }
       }
 
@@ -155,6 +149,16 @@ Azure::Core::CaseInsensitiveSet const
        "Transfer-Encoding",
        "User-Agent"};
 
+LogPolicy::LogPolicy(LogOptions options) : m_options(std::move(options))
+{
+  std::transform(
+      m_options.AllowedHttpQueryParameters.begin(),
+      m_options.AllowedHttpQueryParameters.end(),
+      std::inserter(
+          m_encodedAllowedHttpQueryParameters, m_encodedAllowedHttpQueryParameters.begin()),
+      [](std::string const& s) { return Url::Encode(s); });
+}
+
 std::unique_ptr<RawResponse> LogPolicy::Send(
     Request& request,
     NextHttpPolicy nextPolicy,
@@ -165,7 +169,9 @@ std::unique_ptr<RawResponse> LogPolicy::Send(
 
   if (Log::ShouldWrite(Logger::Level::Verbose))
   {
-    Log::Write(Logger::Level::Informational, GetRequestLogMessage(m_options, request));
+    Log::Write(
+        Logger::Level::Informational,
+        GetRequestLogMessage(m_options, m_encodedAllowedHttpQueryParameters, request));
   }
   else
   {
@@ -181,3 +187,54 @@ std::unique_ptr<RawResponse> LogPolicy::Send(
 
   return response;
 }
+
+void LogPolicy::SendAsync(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context,
+    ResponseCallback callback) const
+{
+  using Azure::Core::Diagnostics::Logger;
+  using Azure::Core::Diagnostics::_internal::Log;
+
+  if (!Log::ShouldWrite(Logger::Level::Verbose))
+  {
+    nextPolicy.SendAsync(request, context, std::move(callback));
+    return;
+  }
+
+  try
+  {
+    Log::Write(
+        Logger::Level::Informational,
+        GetRequestLogMessage(m_options, m_encodedAllowedHttpQueryParameters, request));
+  }
+  catch (...)
+  {
+    callback(nullptr, std::current_exception());
+    return;
+  }
+
+  auto const start = std::chrono::system_clock::now();
+  nextPolicy.SendAsync(
+      request,
+      context,
+      [this, start, callback](std::unique_ptr<RawResponse> response, std::exception_ptr error) {
+        if (response)
+        {
+          auto const end = std::chrono::system_clock::now();
+          try
+          {
+            Log::Write(
+                Logger::Level::Informational,
+                GetResponseLogMessage(m_options, *response, end - start));
+          }
+          catch (...)
+          {
+            callback(nullptr, std::current_exception());
+            return;
+          }
+        }
+        callback(std::move(response), std::move(error));
+      });
+}
@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/diagnostics/metrics.hpp"
+#include "azure/core/http/policies/policy.hpp"
+
+#include "../private/transfer_metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <mutex>
+
+using Azure::Core::Context;
+using Azure::Core::Diagnostics::RequestMetrics;
+using Azure::Core::Diagnostics::_detail::TransferMetrics;
+using namespace Azure::Core::Http;
+using namespace Azure::Core::Http::Policies;
+using namespace Azure::Core::Http::Policies::_internal;
+
+namespace {
+// The metrics of a request, the tries of a hedged request may write them concurrently.
+struct MetricsState final
+{
+  std::mutex Mutex;
+  RequestMetrics Metrics;
+};
+
+Context::Key const MetricsStateKey;
+Context::Key const OperationNameKey;
+
+std::chrono::microseconds ElapsedSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+} // namespace
+
+Context::Key const TransferMetrics::ContextKey;
+
+Context Azure::Core::Diagnostics::_internal::OperationName::With(
+    Context const& context,
+    char const* operationName)
+{
+  return context.WithValue(OperationNameKey, operationName);
+}
+
+char const* Azure::Core::Diagnostics::_internal::OperationName::Get(Context const& context)
+{
+  char const* operationName = nullptr;
+  context.TryGetValue(OperationNameKey, operationName);
+  return operationName;
+}
+
+std::unique_ptr<RawResponse> MetricsPolicy::Send(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context) const
+{
+  MetricsState state;
+  auto const start = std::chrono::steady_clock::now();
+
+  std::unique_ptr<RawResponse> response;
+  std::exception_ptr error;
+  try
+  {
+    response = nextPolicy.Send(request, context.WithValue(MetricsStateKey, &state));
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    auto& metrics = state.Metrics;
+    metrics.Duration = ElapsedSince(start);
+    metrics.ClientName = m_clientName;
+    auto const operationName = Azure::Core::Diagnostics::_internal::OperationName::Get(context);
+    metrics.OperationName
+        = operationName != nullptr ? operationName : request.GetMethod().ToString();
+    if (response)
+    {
+      metrics.StatusCode = response->GetStatusCode();
+    }
+
+    try
+    {
+      m_options.Listener(metrics);
+    }
+    catch (...)
+    {
+    }
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+  return response;
+}
+
+std::unique_ptr<RawResponse> TransferMetricsPolicy::Send(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context) const
+{
+  MetricsState* state = nullptr;
+  if (!context.TryGetValue(MetricsStateKey, state))
+  {
+    return nextPolicy.Send(request, context);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state->Mutex);
+    state->Metrics.RetryCount = (std::max)(0, RetryPolicy::GetRetryCount(context));
+  }
+
+  TransferMetrics transferMetrics;
+  auto const start = std::chrono::steady_clock::now();
+  auto response
+      = nextPolicy.Send(request, context.WithValue(TransferMetrics::ContextKey, &transferMetrics));
+  auto const timeToFirstByte = ElapsedSince(start);
+
+  std::lock_guard<std::mutex> lock(state->Mutex);
+  auto& metrics = state->Metrics;
+  metrics.TimeToFirstByte = timeToFirstByte;
+  metrics.IsConnectionReused = transferMetrics.IsConnectionReused;
+  metrics.NameLookup = transferMetrics.NameLookup;
+  metrics.Connect = transferMetrics.Connect;
+  metrics.TlsHandshake = transferMetrics.TlsHandshake;
+
+  auto const bodyStream = request.GetBodyStream();
+  metrics.BytesSent = bodyStream != nullptr ? (std::max)(int64_t(0), bodyStream->Length()) : 0;
+
+  // The body of the response is either left to be streamed, or buffered by the transport policy.
+  auto responseBodyStream = response->ExtractBodyStream();
+  if (responseBodyStream)
+  {
+    metrics.BytesReceived = (std::max)(int64_t(0), responseBodyStream->Length());
+    response->SetBodyStream(std::move(responseBodyStream));
+  }
+  else
+  {
+    metrics.BytesReceived = static_cast<int64_t>(response->GetBody().size());
+  }
+  return response;
+}
@@ -24,15 +24,21 @@ static Azure::Core::CaseInsensitiveMap MergeMaps(
 
 void Request::SetHeader(std::string const& name, std::string const& value)
 {
-  auto headerNameLowerCase = Azure::Core::_internal::StringExtensions::ToLower(name);
-  return this->m_retryModeEnabled ? _detail::RawResponseHelpers::InsertHeaderWithValidation(
-             this->m_retryHeaders, headerNameLowerCase, value)
-                                  : _detail::RawResponseHelpers::InsertHeaderWithValidation(
-                                      this->m_headers, headerNameLowerCase, value);
+  return _detail::RawResponseHelpers::InsertHeaderWithValidation(
+      this->m_retryModeEnabled ? this->m_retryHeaders : this->m_headers,
+      Azure::Core::_internal::StringExtensions::ToLower(name),
+      value);
 }
 
 void Request::RemoveHeader(std::string const& name)
 {
+  if (this->m_staticHeaders && this->m_staticHeaders->count(name) != 0)
+  {
+    // The static headers are shared with the other requests of the pipeline, so they are copied
+    // into the headers of this request to remove one of them.
+    this->m_headers.insert(this->m_staticHeaders->begin(), this->m_staticHeaders->end());
+    this->m_staticHeaders.reset();
+  }
   this->m_headers.erase(name);
   this->m_retryHeaders.erase(name);
 }
@@ -54,7 +60,16 @@ HttpMethod Request::GetMethod() const { return this->m_method; }
 
 Azure::Core::CaseInsensitiveMap Request::GetHeaders() const
 {
+  if (this->m_retryHeaders.empty() && !this->m_staticHeaders)
+  {
+    return this->m_headers;
+  }
   // create map with retry headers which are the most important and we don't want
   // to override them with any duplicate header
-  return MergeMaps(this->m_retryHeaders, this->m_headers);
+  auto headers = MergeMaps(this->m_retryHeaders, this->m_headers);
+  if (this->m_staticHeaders)
+  {
+    headers.insert(this->m_staticHeaders->begin(), this->m_staticHeaders->end());
+  }
+  return headers;
 }
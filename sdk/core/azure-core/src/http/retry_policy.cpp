@@ -4,19 +4,32 @@
 #include "azure/core/http/policies/policy.hpp"
 #include "azure/core/internal/diagnostics/log.hpp"
 
+#include "../private/delayed_work_scheduler.hpp"
+#include "../private/retry_delay.hpp"
+
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdlib>
+#include <exception>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 using Azure::Core::Context;
+using Azure::Core::Http::_detail::RequestHelpers;
 using namespace Azure::Core::Http;
 using namespace Azure::Core::Http::Policies;
 using namespace Azure::Core::Http::Policies::_internal;
 
-namespace {
-bool GetResponseHeaderBasedDelay(RawResponse const& response, std::chrono::milliseconds& retryAfter)
+bool Azure::Core::_detail::GetResponseHeaderBasedDelay(
+    RawResponse const& response,
+    std::chrono::milliseconds& retryAfter)
 {
   // Try to find retry-after headers. There are several of them possible.
   auto const& responseHeaders = response.GetHeaders();
@@ -53,6 +66,8 @@ bool GetResponseHeaderBasedDelay(RawResponse const& response, std::chrono::milli
   return false;
 }
 
+namespace {
+
 std::chrono::milliseconds CalculateExponentialDelay(
     RetryOptions const& retryOptions,
     int32_t attempt,
@@ -88,9 +103,264 @@ bool WasLastAttempt(RetryOptions const& retryOptions, int32_t attempt)
   return attempt > retryOptions.MaxRetries;
 }
 
+// Parses the digits of value from position, returns false if there are none or too many.
+bool ParseRangeBound(std::string const& value, size_t& position, int64_t& bound)
+{
+  size_t const start = position;
+  bound = 0;
+  while (position < value.size() && value[position] >= '0' && value[position] <= '9')
+  {
+    if (position - start == 18)
+    {
+      return false;
+    }
+    bound = bound * 10 + (value[position++] - '0');
+  }
+  return position != start;
+}
+
+// The size of the body of the request, and of the byte range it asks for, zero when unknown.
+int64_t GetExpectedTransferSize(Request& request)
+{
+  int64_t size = 0;
+  auto const* bodyStream = request.GetBodyStream();
+  if (bodyStream != nullptr && bodyStream->Length() > 0)
+  {
+    size += bodyStream->Length();
+  }
+  auto const* range = RequestHelpers::FindHeader(request, "x-ms-range");
+  if (range == nullptr)
+  {
+    range = RequestHelpers::FindHeader(request, "range");
+  }
+  // Only a closed range, such as "bytes=0-1023", has a known size.
+  std::string const prefix = "bytes=";
+  if (range != nullptr && range->compare(0, prefix.size(), prefix) == 0)
+  {
+    auto const& value = *range;
+    size_t position = prefix.size();
+    int64_t first = 0;
+    int64_t last = 0;
+    if (ParseRangeBound(value, position, first) && position < value.size()
+        && value[position++] == '-' && ParseRangeBound(value, position, last)
+        && position == value.size() && last >= first)
+    {
+      size += last - first + 1;
+    }
+  }
+  return size;
+}
+
+// The time a try of the request can take, zero when it isn't limited.
+std::chrono::milliseconds GetTryTimeout(RetryOptions const& retryOptions, Request& request)
+{
+  auto tryTimeout = retryOptions.TryTimeout;
+  if (tryTimeout.count() <= 0)
+  {
+    return std::chrono::milliseconds();
+  }
+  if (retryOptions.MinimumTryThroughput > 0)
+  {
+    tryTimeout += std::chrono::milliseconds(static_cast<int64_t>(
+        static_cast<double>(GetExpectedTransferSize(request)) * 1000
+        / static_cast<double>(retryOptions.MinimumTryThroughput)));
+  }
+  return tryTimeout;
+}
+
+// The number of buckets the window of a retry budget is split into. The requests and retries of
+// the oldest bucket leave the window together.
+constexpr int32_t RetryBudgetBuckets = 10;
+
 Context::Key const RetryKey;
 } // namespace
 
+struct RetryBudget::State final
+{
+  double RetryRatio;
+  int32_t MinRetries;
+  std::chrono::steady_clock::duration BucketDuration;
+
+  std::mutex Mutex;
+  // The requests and retries of the buckets of the window, in a ring buffer.
+  std::array<std::pair<int64_t, int64_t>, RetryBudgetBuckets> Buckets{};
+  int64_t CurrentBucket = 0;
+  int64_t WindowRequests = 0;
+  int64_t WindowRetries = 0;
+
+  std::atomic<int64_t> Requests{0};
+  std::atomic<int64_t> Retries{0};
+  std::atomic<int64_t> RejectedRetries{0};
+
+  // Moves the window to now, under the lock.
+  std::pair<int64_t, int64_t>& UpdateWindow()
+  {
+    int64_t const bucket = std::chrono::steady_clock::now().time_since_epoch() / BucketDuration;
+    for (int64_t i = 0; i < RetryBudgetBuckets && CurrentBucket < bucket; ++i)
+    {
+      ++CurrentBucket;
+      auto& expired = Buckets[static_cast<size_t>(CurrentBucket % RetryBudgetBuckets)];
+      WindowRequests -= expired.first;
+      WindowRetries -= expired.second;
+      expired = {0, 0};
+    }
+    CurrentBucket = bucket;
+    return Buckets[static_cast<size_t>(CurrentBucket % RetryBudgetBuckets)];
+  }
+};
+
+RetryBudget::RetryBudget(double retryRatio, int32_t minRetries, std::chrono::milliseconds window)
+    : m_state(std::make_unique<State>())
+{
+  if (retryRatio < 0 || minRetries < 0 || window <= std::chrono::milliseconds(0))
+  {
+    throw std::invalid_argument(
+        "The retry ratio and the minimum retries can't be negative, the window must be positive.");
+  }
+  m_state->RetryRatio = retryRatio;
+  m_state->MinRetries = minRetries;
+  m_state->BucketDuration = (std::max)(
+      std::chrono::steady_clock::duration(1),
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(window)
+          / RetryBudgetBuckets);
+  m_state->CurrentBucket
+      = std::chrono::steady_clock::now().time_since_epoch() / m_state->BucketDuration;
+}
+
+RetryBudget::~RetryBudget() = default;
+
+int64_t RetryBudget::Requests() const { return m_state->Requests; }
+
+int64_t RetryBudget::Retries() const { return m_state->Retries; }
+
+int64_t RetryBudget::RejectedRetries() const { return m_state->RejectedRetries; }
+
+void RetryBudget::OnRequest()
+{
+  ++m_state->Requests;
+  std::lock_guard<std::mutex> guard(m_state->Mutex);
+  ++m_state->UpdateWindow().first;
+  ++m_state->WindowRequests;
+}
+
+bool RetryBudget::TryRetry()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    auto& bucket = m_state->UpdateWindow();
+    if (static_cast<double>(m_state->WindowRetries)
+        < m_state->MinRetries
+            + m_state->RetryRatio * static_cast<double>(m_state->WindowRequests))
+    {
+      ++bucket.second;
+      ++m_state->WindowRetries;
+      ++m_state->Retries;
+      return true;
+    }
+  }
+  ++m_state->RejectedRetries;
+  return false;
+}
+
+struct CircuitBreaker::State final
+{
+  struct Host final
+  {
+    int32_t ConsecutiveFailures = 0;
+    bool Open = false;
+    std::chrono::steady_clock::time_point OpenUntil;
+    // Set while the single request sent after the cool-down period is in flight.
+    bool Probing = false;
+  };
+
+  int32_t FailureThreshold;
+  std::chrono::milliseconds CoolDown;
+
+  mutable std::mutex Mutex;
+  std::map<std::string, Host> Hosts;
+
+  std::atomic<int64_t> TimesOpened{0};
+  std::atomic<int64_t> RejectedRequests{0};
+};
+
+CircuitBreaker::CircuitBreaker(int32_t failureThreshold, std::chrono::milliseconds coolDown)
+    : m_state(std::make_unique<State>())
+{
+  if (failureThreshold <= 0 || coolDown <= std::chrono::milliseconds(0))
+  {
+    throw std::invalid_argument("The failure threshold and the cool-down must be positive.");
+  }
+  m_state->FailureThreshold = failureThreshold;
+  m_state->CoolDown = coolDown;
+}
+
+CircuitBreaker::~CircuitBreaker() = default;
+
+bool CircuitBreaker::IsOpen(std::string const& host) const
+{
+  std::lock_guard<std::mutex> guard(m_state->Mutex);
+  auto const found = m_state->Hosts.find(host);
+  return found != m_state->Hosts.end() && found->second.Open
+      && (found->second.Probing || std::chrono::steady_clock::now() < found->second.OpenUntil);
+}
+
+int64_t CircuitBreaker::TimesOpened() const { return m_state->TimesOpened; }
+
+int64_t CircuitBreaker::RejectedRequests() const { return m_state->RejectedRequests; }
+
+bool CircuitBreaker::TryAcquire(std::string const& host)
+{
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    auto const found = m_state->Hosts.find(host);
+    if (found == m_state->Hosts.end() || !found->second.Open)
+    {
+      return true;
+    }
+    auto& hostState = found->second;
+    if (!hostState.Probing && std::chrono::steady_clock::now() >= hostState.OpenUntil)
+    {
+      hostState.Probing = true;
+      return true;
+    }
+  }
+  ++m_state->RejectedRequests;
+  return false;
+}
+
+void CircuitBreaker::OnTryCompleted(std::string const& host, bool succeeded)
+{
+  std::lock_guard<std::mutex> guard(m_state->Mutex);
+  if (succeeded)
+  {
+    // The hosts are only tracked while their tries fail.
+    m_state->Hosts.erase(host);
+    return;
+  }
+  auto& hostState = m_state->Hosts[host];
+  ++hostState.ConsecutiveFailures;
+  if (hostState.Probing
+      || (!hostState.Open && hostState.ConsecutiveFailures >= m_state->FailureThreshold))
+  {
+    hostState.Open = true;
+    hostState.Probing = false;
+    hostState.OpenUntil = std::chrono::steady_clock::now() + m_state->CoolDown;
+    ++m_state->TimesOpened;
+  }
+}
+
+void CircuitBreaker::OnTryAbandoned(std::string const& host)
+{
+  // A try ending with another error, such as a cancellation, says nothing about the host, but it
+  // mustn't keep the circuit open forever if it was the single request sent after the cool-down.
+  std::lock_guard<std::mutex> guard(m_state->Mutex);
+  auto const found = m_state->Hosts.find(host);
+  if (found != m_state->Hosts.end())
+  {
+    found->second.Probing = false;
+  }
+}
+
 int32_t RetryPolicy::GetRetryCount(Context const& context)
 {
   int32_t number = -1;
@@ -106,74 +376,311 @@ int32_t RetryPolicy::GetRetryCount(Context const& context)
   return *ptr;
 }
 
-std::unique_ptr<RawResponse> RetryPolicy::Send(
-    Request& request,
-    NextHttpPolicy nextPolicy,
-    Context const& context) const
+struct RetryPolicy::RequestState final
 {
-  using Azure::Core::Diagnostics::Logger;
-  using Azure::Core::Diagnostics::_internal::Log;
+  Request* HttpRequest;
+  Context RequestContext;
   // retryCount needs to be apart from RetryNumber attempt.
-  int32_t retryCount = 0;
-  auto retryContext = context.WithValue(RetryKey, &retryCount);
+  int32_t RetryCount = 0;
+  Context RetryContext;
+  int32_t Attempt = 1;
+  // The host doesn't change between the tries, the policies changing it come after this one.
+  std::string Host;
+  std::chrono::milliseconds TryTimeout;
+  // The query parameters of the request, restored before each retry.
+  std::map<std::string, std::string> OriginalQueryParameters;
+
+  RequestState(Request& request, Context const& context, RetryOptions const& retryOptions)
+      : HttpRequest(&request), RequestContext(context),
+        RetryContext(context.WithValue(RetryKey, &RetryCount)),
+        Host(retryOptions.CircuitBreaker ? request.GetUrl().GetHost() : std::string()),
+        TryTimeout(GetTryTimeout(retryOptions, request))
+  {
+    if (retryOptions.Budget)
+    {
+      retryOptions.Budget->OnRequest();
+    }
+  }
 
-  for (int32_t attempt = 1;; ++attempt)
+  RequestState(RequestState const&) = delete;
+  RequestState& operator=(RequestState const&) = delete;
+
+  Context GetTryContext() const
   {
-    std::chrono::milliseconds retryAfter{};
-    request.StartTry();
-    // creates a copy of original query parameters from request
-    auto originalQueryParameters = request.GetUrl().GetQueryParameters();
+    return TryTimeout.count() > 0
+        ? RetryContext.WithDeadline(std::chrono::system_clock::now() + TryTimeout)
+        : RetryContext;
+  }
 
-    try
+  void LogRetry(std::chrono::milliseconds retryAfter) const
+  {
+    using Azure::Core::Diagnostics::Logger;
+    using Azure::Core::Diagnostics::_internal::Log;
+    if (Log::ShouldWrite(Logger::Level::Informational))
     {
-      auto response = nextPolicy.Send(request, retryContext);
+      std::ostringstream log;
 
-      // If we are out of retry attempts, if a response is non-retriable (or simply 200 OK, i.e
-      // doesn't need to be retried), then ShouldRetry returns false.
-      if (!ShouldRetryOnResponse(*response.get(), m_retryOptions, attempt, retryAfter))
-      {
-        // If this is the second attempt and StartTry was called, we need to stop it. Otherwise
-        // trying to perform same request would use last retry query/headers
-        return response;
-      }
+      log << "HTTP Retry attempt #" << Attempt << " will be made in "
+          << std::chrono::duration_cast<std::chrono::milliseconds>(retryAfter).count() << "ms.";
+
+      Log::Write(Logger::Level::Informational, log.str());
     }
-    catch (const TransportException& e)
+  }
+
+  // Gets the request ready for the next try, once the delay before it has elapsed.
+  void PrepareRetry()
+  {
+    // Restore the original query parameters before next retry
+    HttpRequest->GetUrl().SetQueryParameters(std::move(OriginalQueryParameters));
+
+    // Update retry number
+    RetryCount += 1;
+    Attempt += 1;
+  }
+};
+
+namespace {
+std::string const RetryDeadlineMessage
+    = "Request was cancelled by context, its deadline is before the next retry.";
+} // namespace
+
+void RetryPolicy::StartTry(RequestState& state) const
+{
+  state.HttpRequest->StartTry();
+  // creates a copy of original query parameters from request
+  state.OriginalQueryParameters = state.HttpRequest->GetUrl().GetQueryParameters();
+
+  auto const& circuitBreaker = m_retryOptions.CircuitBreaker;
+  if (circuitBreaker && !circuitBreaker->TryAcquire(state.Host))
+  {
+    throw TransportException(
+        "The requests to " + state.Host + " fail right away, the previous ones kept failing.");
+  }
+}
+
+bool RetryPolicy::ShouldRetryTry(
+    RequestState& state,
+    RawResponse const* response,
+    std::exception_ptr const& error,
+    std::chrono::milliseconds& retryAfter) const
+{
+  using Azure::Core::Diagnostics::Logger;
+  using Azure::Core::Diagnostics::_internal::Log;
+
+  auto const& budget = m_retryOptions.Budget;
+  auto const& circuitBreaker = m_retryOptions.CircuitBreaker;
+  auto const& host = state.Host;
+  auto const attempt = state.Attempt;
+  auto const tryTimeout = state.TryTimeout;
+  // Returns false if the retry would exceed the budget.
+  auto const tryRetry = [&budget]() {
+    if (!budget || budget->TryRetry())
     {
-      if (Log::ShouldWrite(Logger::Level::Warning))
+      return true;
+    }
+    if (Log::ShouldWrite(Logger::Level::Warning))
+    {
+      Log::Write(Logger::Level::Warning, "HTTP retry not made, the retry budget is exhausted.");
+    }
+    return false;
+  };
+
+  try
+  {
+    if (!error)
+    {
+      if (circuitBreaker)
       {
-        Log::Write(Logger::Level::Warning, std::string("HTTP Transport error: ") + e.what());
+        auto const& statusCodes = m_retryOptions.StatusCodes;
+        circuitBreaker->OnTryCompleted(
+            host, statusCodes.find(response->GetStatusCode()) == statusCodes.end());
       }
 
-      if (!ShouldRetryOnTransportFailure(m_retryOptions, attempt, retryAfter))
+      // If we are out of retry attempts, if a response is non-retriable (or simply 200 OK, i.e
+      // doesn't need to be retried), then ShouldRetry returns false.
+      return ShouldRetryOnResponse(*response, m_retryOptions, attempt, retryAfter) && tryRetry();
+    }
+    std::rethrow_exception(error);
+  }
+  catch (const TransportException& e)
+  {
+    if (circuitBreaker)
+    {
+      circuitBreaker->OnTryCompleted(host, false);
+    }
+    if (Log::ShouldWrite(Logger::Level::Warning))
+    {
+      Log::Write(Logger::Level::Warning, std::string("HTTP Transport error: ") + e.what());
+    }
+
+    if (!ShouldRetryOnTransportFailure(m_retryOptions, attempt, retryAfter) || !tryRetry())
+    {
+      throw;
+    }
+  }
+  catch (Azure::Core::OperationCancelledException const&)
+  {
+    if (tryTimeout.count() <= 0 || state.RequestContext.IsCancelled())
+    {
+      if (circuitBreaker)
       {
-        throw;
+        circuitBreaker->OnTryAbandoned(host);
       }
+      throw;
+    }
+    // The try timed out but the request still has time left, the try fails like a transport
+    // failure. Its connection isn't reused, since its response wasn't read to the end.
+    if (circuitBreaker)
+    {
+      circuitBreaker->OnTryCompleted(host, false);
+    }
+    std::string const message
+        = "HTTP try timed out after " + std::to_string(tryTimeout.count()) + "ms.";
+    if (Log::ShouldWrite(Logger::Level::Warning))
+    {
+      Log::Write(Logger::Level::Warning, message);
     }
 
-    if (Log::ShouldWrite(Logger::Level::Informational))
+    if (!ShouldRetryOnTransportFailure(m_retryOptions, attempt, retryAfter) || !tryRetry())
     {
-      std::ostringstream log;
+      throw TransportException(message);
+    }
+  }
+  catch (...)
+  {
+    if (circuitBreaker)
+    {
+      circuitBreaker->OnTryAbandoned(host);
+    }
+    throw;
+  }
+  return true;
+}
 
-      log << "HTTP Retry attempt #" << attempt << " will be made in "
-          << std::chrono::duration_cast<std::chrono::milliseconds>(retryAfter).count() << "ms.";
+std::unique_ptr<RawResponse> RetryPolicy::Send(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context) const
+{
+  RequestState state(request, context, m_retryOptions);
+  for (;;)
+  {
+    StartTry(state);
 
-      Log::Write(Logger::Level::Informational, log.str());
+    std::unique_ptr<RawResponse> response;
+    std::exception_ptr error;
+    try
+    {
+      response = nextPolicy.Send(request, state.GetTryContext());
+    }
+    catch (...)
+    {
+      error = std::current_exception();
     }
 
-    // Sleep(0) behavior is implementation-defined: it may yield, or may do nothing. Let's make sure
-    // we proceed immediately if it is 0.
+    std::chrono::milliseconds retryAfter{};
+    if (!ShouldRetryTry(state, response.get(), error, retryAfter))
+    {
+      // If this is the second attempt and StartTry was called, we need to stop it. Otherwise
+      // trying to perform same request would use last retry query/headers
+      return response;
+    }
+    response.reset();
+    state.LogRetry(retryAfter);
+
+    // Proceed immediately if the delay is 0, there is nothing to wait for.
     if (retryAfter.count() > 0)
     {
-      context.ThrowIfCancelled();
-      std::this_thread::sleep_for(retryAfter);
+      Azure::Core::_detail::RetryDelayWaiter().Wait(context, retryAfter, RetryDeadlineMessage);
     }
+    state.PrepareRetry();
+  }
+}
 
-    // Restore the original query parameters before next retry
-    request.GetUrl().SetQueryParameters(std::move(originalQueryParameters));
+void RetryPolicy::SendAsync(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context,
+    ResponseCallback callback) const
+{
+  std::shared_ptr<RequestState> state;
+  try
+  {
+    state = std::make_shared<RequestState>(request, context, m_retryOptions);
+  }
+  catch (...)
+  {
+    callback(nullptr, std::current_exception());
+    return;
+  }
+  SendTryAsync(std::move(state), nextPolicy, std::move(callback));
+}
 
-    // Update retry number
-    retryCount += 1;
+void RetryPolicy::SendTryAsync(
+    std::shared_ptr<RequestState> state,
+    NextHttpPolicy nextPolicy,
+    ResponseCallback callback) const
+{
+  Context tryContext;
+  try
+  {
+    StartTry(*state);
+    tryContext = state->GetTryContext();
   }
+  catch (...)
+  {
+    callback(nullptr, std::current_exception());
+    return;
+  }
+
+  auto& request = *state->HttpRequest;
+  nextPolicy.SendAsync(
+      request,
+      tryContext,
+      [this, state, nextPolicy, callback](
+          std::unique_ptr<RawResponse> response, std::exception_ptr error) {
+        std::chrono::milliseconds retryAfter{};
+        try
+        {
+          if (!ShouldRetryTry(*state, response.get(), error, retryAfter))
+          {
+            callback(std::move(response), nullptr);
+            return;
+          }
+          response.reset();
+          state->LogRetry(retryAfter);
+
+          auto const& context = state->RequestContext;
+          context.ThrowIfCancelled();
+          if (retryAfter.count() > 0
+              && context.GetDeadline() < std::chrono::system_clock::now() + retryAfter)
+          {
+            throw Azure::Core::OperationCancelledException(RetryDeadlineMessage);
+          }
+        }
+        catch (...)
+        {
+          callback(nullptr, std::current_exception());
+          return;
+        }
+
+        // The retry is never sent from the thread completing the try, which may be driving the
+        // transfers of a transport, but from a worker of the scheduler.
+        Azure::Core::_detail::DelayedWorkScheduler::GetInstance().Schedule(
+            retryAfter, state->RequestContext, [this, state, nextPolicy, callback]() {
+              try
+              {
+                state->RequestContext.ThrowIfCancelled();
+              }
+              catch (...)
+              {
+                callback(nullptr, std::current_exception());
+                return;
+              }
+              state->PrepareRetry();
+              SendTryAsync(state, nextPolicy, callback);
+            });
+      });
 }
 
 bool RetryPolicy::ShouldRetryOnTransportFailure(
@@ -233,7 +740,7 @@ bool RetryPolicy::ShouldRetryOnResponse(
     }
   }
 
-  if (!GetResponseHeaderBasedDelay(response, retryAfter))
+  if (!Azure::Core::_detail::GetResponseHeaderBasedDelay(response, retryAfter))
   {
     retryAfter = CalculateExponentialDelay(retryOptions, attempt, jitterFactor);
   }
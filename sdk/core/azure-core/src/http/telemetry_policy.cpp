@@ -165,3 +165,13 @@ std::unique_ptr<RawResponse> TelemetryPolicy::Send(
   request.SetHeader("User-Agent", m_telemetryId);
   return nextPolicy.Send(request, context);
 }
+
+void TelemetryPolicy::SendAsync(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context,
+    ResponseCallback callback) const
+{
+  request.SetHeader("User-Agent", m_telemetryId);
+  nextPolicy.SendAsync(request, context, std::move(callback));
+}
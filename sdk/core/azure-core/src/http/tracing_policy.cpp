@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/http/policies/policy.hpp"
+
+using Azure::Core::Http::HttpMethod;
+
+// The span names are string literals, so a span doesn't copy its name.
+char const* Azure::Core::Http::Policies::_detail::GetSpanName(HttpMethod const& method)
+{
+  if (method == HttpMethod::Get)
+  {
+    return "HTTP GET";
+  }
+  if (method == HttpMethod::Put)
+  {
+    return "HTTP PUT";
+  }
+  if (method == HttpMethod::Head)
+  {
+    return "HTTP HEAD";
+  }
+  if (method == HttpMethod::Post)
+  {
+    return "HTTP POST";
+  }
+  if (method == HttpMethod::Delete)
+  {
+    return "HTTP DELETE";
+  }
+  if (method == HttpMethod::Patch)
+  {
+    return "HTTP PATCH";
+  }
+  return "HTTP";
+}
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/http/traffic_class.hpp"
+
+using Azure::Core::Context;
+using Azure::Core::Http::TrafficClass;
+
+namespace {
+Context::Key const TrafficClassKey;
+} // namespace
+
+Context Azure::Core::Http::WithTrafficClass(Context const& context, TrafficClass trafficClass)
+{
+  return context.WithValue(TrafficClassKey, trafficClass);
+}
+
+Azure::Nullable<TrafficClass> Azure::Core::Http::GetTrafficClass(Context const& context)
+{
+  TrafficClass trafficClass = TrafficClass::Interactive;
+  if (!context.TryGetValue(TrafficClassKey, trafficClass))
+  {
+    return Azure::Nullable<TrafficClass>();
+  }
+  return trafficClass;
+}
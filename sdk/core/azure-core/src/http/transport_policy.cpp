@@ -38,6 +38,64 @@ std::unique_ptr<RawResponse> TransportPolicy::Send(
     Context const& context) const
 {
   (void)nextPolicy;
+  return SendToTransport(request, context);
+}
+
+namespace {
+// Reads the body of the response to its buffer, unless the request streams the body of its
+// successful responses.
+void BufferResponseBody(Request& request, RawResponse& response, Context const& context)
+{
+  auto statusCode = static_cast<typename std::underlying_type<HttpStatusCode>::type>(
+      response.GetStatusCode());
+
+  // special case to return a response with BodyStream to read directly from socket
+  // Return only if response did not fail.
+  if (!request.ShouldBufferResponse() && statusCode < 300)
+  {
+    return;
+  }
+
+  // At this point, either the request is `shouldBufferResponse` or it return with an error code.
+  // The entire payload needs must be downloaded to the response's buffer.
+  auto bodyStream = response.ExtractBodyStream();
+  response.SetBody(bodyStream->ReadToEnd(context));
+
+  // BodyStream is moved out of response. This makes transport implementation to clean any active
+  // session with sockets or internal state.
+}
+} // namespace
+
+void HttpTransport::SendAsync(Request& request, Context const& context, ResponseCallback callback)
+{
+  std::unique_ptr<RawResponse> response;
+  try
+  {
+    response = Send(request, context);
+    BufferResponseBody(request, *response, context);
+  }
+  catch (...)
+  {
+    callback(nullptr, std::current_exception());
+    return;
+  }
+  callback(std::move(response), nullptr);
+}
+
+void TransportPolicy::SendAsync(
+    Request& request,
+    NextHttpPolicy nextPolicy,
+    Context const& context,
+    ResponseCallback callback) const
+{
+  (void)nextPolicy;
+  SendToTransportAsync(request, context, std::move(callback));
+}
+
+std::unique_ptr<RawResponse> TransportPolicy::SendToTransport(
+    Request& request,
+    Context const& context) const
+{
   context.ThrowIfCancelled();
 
   /*
@@ -58,22 +116,28 @@ std::unique_ptr<RawResponse> TransportPolicy::Send(
    *
    */
   auto response = m_options.Transport->Send(request, context);
-  auto statusCode = static_cast<typename std::underlying_type<Http::HttpStatusCode>::type>(
-      response->GetStatusCode());
+  BufferResponseBody(request, *response, context);
+  return response;
+}
 
-  // special case to return a response with BodyStream to read directly from socket
-  // Return only if response did not fail.
-  if (!request.ShouldBufferResponse() && statusCode < 300)
+void TransportPolicy::SendToTransportAsync(
+    Request& request,
+    Context const& context,
+    ResponseCallback callback) const
+{
+  if (context.IsCancelled())
   {
-    return response;
+    try
+    {
+      context.ThrowIfCancelled();
+    }
+    catch (...)
+    {
+      callback(nullptr, std::current_exception());
+    }
+    return;
   }
 
-  // At this point, either the request is `shouldBufferResponse` or it return with an error code.
-  // The entire payload needs must be downloaded to the response's buffer.
-  auto bodyStream = response->ExtractBodyStream();
-  response->SetBody(bodyStream->ReadToEnd(context));
-
-  // BodyStream is moved out of response. This makes transport implementation to clean any active
-  // session with sockets or internal state.
-  return response;
+  // The transport buffers the response like SendToTransport() does.
+  m_options.Transport->SendAsync(request, context, std::move(callback));
 }
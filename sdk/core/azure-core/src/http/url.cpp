@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <stdexcept>
@@ -76,46 +77,102 @@ Url::Url(const std::string& url)
   }
 }
 
+namespace {
+struct CharTable final
+{
+  int8_t Values[256];
+};
+
+// The value of each hexadecimal digit, -1 for the other chars.
+constexpr CharTable MakeHexTable()
+{
+  CharTable table{};
+  for (int c = 0; c < 256; ++c)
+  {
+    if (c >= '0' && c <= '9')
+    {
+      table.Values[c] = static_cast<int8_t>(c - '0');
+    }
+    else if (c >= 'A' && c <= 'F')
+    {
+      table.Values[c] = static_cast<int8_t>(c - 'A' + 10);
+    }
+    else if (c >= 'a' && c <= 'f')
+    {
+      table.Values[c] = static_cast<int8_t>(c - 'a' + 10);
+    }
+    else
+    {
+      table.Values[c] = -1;
+    }
+  }
+  return table;
+}
+
+// 1 for the unreserved chars, which are never URL-encoded, 0 for the other chars.
+constexpr CharTable MakeUnreservedTable()
+{
+  CharTable table{};
+  for (int c = 0; c < 256; ++c)
+  {
+    table.Values[c] = ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                       || c == '-' || c == '.' || c == '_' || c == '~')
+        ? 1
+        : 0;
+  }
+  return table;
+}
+
+constexpr CharTable HexTable = MakeHexTable();
+constexpr CharTable UnreservedTable = MakeUnreservedTable();
+} // namespace
+
 std::string Url::Decode(const std::string& value)
 {
-  const static std::vector<int> hexTable = []() {
-    std::vector<int> t(256, -1);
-    for (int i = 0; i < 10; ++i)
+  // The size of the decoded value is computed first, and the value is returned as is when there is
+  // nothing to decode.
+  size_t decodedSize = value.size();
+  bool hasPlus = false;
+  for (size_t i = 0; i < value.size(); ++i)
+  {
+    if (value[i] == '%')
     {
-      t[static_cast<size_t>('0') + i] = i;
+      if (i + 2 >= value.size()
+          || HexTable.Values[static_cast<unsigned char>(value[i + 1])] < 0
+          || HexTable.Values[static_cast<unsigned char>(value[i + 2])] < 0)
+      {
+        throw std::runtime_error("failed when decoding URL component");
+      }
+      decodedSize -= 2;
+      i += 2;
     }
-    for (int i = 10; i < 16; ++i)
+    else if (value[i] == '+')
     {
-      t[static_cast<size_t>('A') + i - 10] = i;
-      t[static_cast<size_t>('a') + i - 10] = i;
+      hasPlus = true;
     }
-    return t;
-  }();
+  }
+  if (decodedSize == value.size() && !hasPlus)
+  {
+    return value;
+  }
 
-  std::string decodedValue;
-  for (size_t i = 0; i < value.size();)
+  std::string decodedValue(decodedSize, '\0');
+  size_t decodedIndex = 0;
+  for (size_t i = 0; i < value.size(); ++i)
   {
     char c = value[i];
     if (c == '+')
     {
-      decodedValue += ' ';
-      ++i;
+      c = ' ';
     }
     else if (c == '%')
     {
-      if (i + 2 >= value.size() || hexTable[value[i + 1]] < 0 || hexTable[value[i + 2]] < 0)
-      {
-        throw std::runtime_error("failed when decoding URL component");
-      }
-      int v = (hexTable[value[i + 1]] << 4) + hexTable[value[i + 2]];
-      decodedValue += static_cast<std::string::value_type>(v);
-      i += 3;
-    }
-    else
-    {
-      decodedValue += value[i];
-      ++i;
+      c = static_cast<char>(
+          (HexTable.Values[static_cast<unsigned char>(value[i + 1])] << 4)
+          + HexTable.Values[static_cast<unsigned char>(value[i + 2])]);
+      i += 2;
     }
+    decodedValue[decodedIndex++] = c;
   }
   return decodedValue;
 }
@@ -123,25 +180,43 @@ std::string Url::Decode(const std::string& value)
 std::string Url::Encode(const std::string& value, const std::string& doNotEncodeSymbols)
 {
   const char* hex = "0123456789ABCDEF";
-  std::unordered_set<unsigned char> noEncodingSymbolsSet(
-      doNotEncodeSymbols.begin(), doNotEncodeSymbols.end());
 
-  std::string encoded;
+  // The chars which are not encoded are the unreserved ones and the ones from the user input.
+  CharTable notEncoded = UnreservedTable;
+  for (char c : doNotEncodeSymbols)
+  {
+    notEncoded.Values[static_cast<unsigned char>(c)] = 1;
+  }
+
+  // The size of the encoded value is computed first, and the value is returned as is when there is
+  // nothing to encode.
+  size_t encodedSize = value.size();
+  for (char c : value)
+  {
+    if (notEncoded.Values[static_cast<unsigned char>(c)] == 0)
+    {
+      encodedSize += 2;
+    }
+  }
+  if (encodedSize == value.size())
+  {
+    return value;
+  }
+
+  std::string encoded(encodedSize, '\0');
+  size_t encodedIndex = 0;
   for (char c : value)
   {
     unsigned char uc = c;
-    // encode if char is not in the default non-encoding set AND if it is NOT in chars to ignore
-    // from user input
-    if (defaultNonUrlEncodeChars.find(uc) == defaultNonUrlEncodeChars.end()
-        && noEncodingSymbolsSet.find(uc) == noEncodingSymbolsSet.end())
+    if (notEncoded.Values[uc] == 0)
     {
-      encoded += '%';
-      encoded += hex[(uc >> 4) & 0x0f];
-      encoded += hex[uc & 0x0f];
+      encoded[encodedIndex++] = '%';
+      encoded[encodedIndex++] = hex[(uc >> 4) & 0x0f];
+      encoded[encodedIndex++] = hex[uc & 0x0f];
     }
     else
     {
-      encoded += c;
+      encoded[encodedIndex++] = c;
     }
   }
   return encoded;
@@ -174,24 +249,86 @@ void Url::AppendQueryParameters(const std::string& query)
     {
       ++cur;
     }
-    m_encodedQueryParameters[std::move(query_key)] = std::move(query_value);
+    SetEncodedQueryParameter(std::move(query_key), std::move(query_value));
+  }
+}
+
+void Url::SetEncodedQueryParameter(std::string encodedKey, std::string encodedValue)
+{
+  auto parameter = std::lower_bound(
+      m_encodedQueryParameters.begin(),
+      m_encodedQueryParameters.end(),
+      encodedKey,
+      [](const std::pair<std::string, std::string>& p, const std::string& key) {
+        return p.first < key;
+      });
+  if (parameter != m_encodedQueryParameters.end() && parameter->first == encodedKey)
+  {
+    parameter->second = std::move(encodedValue);
   }
+  else
+  {
+    m_encodedQueryParameters.emplace(parameter, std::move(encodedKey), std::move(encodedValue));
+  }
+}
+
+void Url::SetQueryParameters(std::map<std::string, std::string> queryParameters)
+{
+  // creates a copy and discard previous
+  m_encodedQueryParameters.assign(
+      std::make_move_iterator(queryParameters.begin()),
+      std::make_move_iterator(queryParameters.end()));
+}
+
+void Url::AppendQueryParameter(const std::string& encodedKey, const std::string& encodedValue)
+{
+  SetEncodedQueryParameter(encodedKey, encodedValue);
 }
 
-std::string Url::GetUrlWithoutQuery(bool relative) const
+void Url::RemoveQueryParameter(const std::string& encodedKey)
 {
+  auto parameter = std::lower_bound(
+      m_encodedQueryParameters.begin(),
+      m_encodedQueryParameters.end(),
+      encodedKey,
+      [](const std::pair<std::string, std::string>& p, const std::string& key) {
+        return p.first < key;
+      });
+  if (parameter != m_encodedQueryParameters.end() && parameter->first == encodedKey)
+  {
+    m_encodedQueryParameters.erase(parameter);
+  }
+}
+
+std::string Url::GetUrl(bool relative) const
+{
+  // The size is computed first, so the URL is built without reallocating.
+  const std::string port = (!relative && m_port != 0) ? std::to_string(m_port) : std::string();
+  size_t size = m_encodedPath.size() + 1;
+  if (!relative)
+  {
+    size += m_scheme.size() + 3 + m_host.size() + port.size() + 1;
+  }
+  for (const auto& q : m_encodedQueryParameters)
+  {
+    size += q.first.size() + q.second.size() + 2;
+  }
+
   std::string url;
+  url.reserve(size);
 
   if (!relative)
   {
     if (!m_scheme.empty())
     {
-      url += m_scheme + "://";
+      url += m_scheme;
+      url += "://";
     }
     url += m_host;
-    if (m_port != 0)
+    if (!port.empty())
     {
-      url += ":" + std::to_string(m_port);
+      url += ':';
+      url += port;
     }
   }
 
@@ -199,29 +336,25 @@ std::string Url::GetUrlWithoutQuery(bool relative) const
   {
     if (!relative)
     {
-      url += "/";
+      url += '/';
     }
 
     url += m_encodedPath;
   }
 
-  return url;
-}
+  auto separator = '?';
+  for (const auto& q : m_encodedQueryParameters)
+  {
+    url += separator;
+    url += q.first;
+    url += '=';
+    url += q.second;
+    separator = '&';
+  }
 
-std::string Url::GetRelativeUrl() const
-{
-  return GetUrlWithoutQuery(true)
-      + _detail::FormatEncodedUrlQueryParameters(m_encodedQueryParameters);
+  return url;
 }
 
-std::string Url::GetAbsoluteUrl() const
-{
-  return GetUrlWithoutQuery(false)
-      + _detail::FormatEncodedUrlQueryParameters(m_encodedQueryParameters);
-}
+std::string Url::GetRelativeUrl() const { return GetUrl(true); }
 
-const std::unordered_set<unsigned char> Url::defaultNonUrlEncodeChars
-    = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q',
-       'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H',
-       'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y',
-       'Z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '.', '_', '~'};
+std::string Url::GetAbsoluteUrl() const { return GetUrl(false); }
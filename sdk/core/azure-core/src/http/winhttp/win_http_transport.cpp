@@ -11,6 +11,11 @@
 
 #include <Windows.h>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <winhttp.h>
 
@@ -205,25 +210,150 @@ void GetErrorAndThrow(const std::string& exceptionMessage)
       exceptionMessage + " Error Code: " + std::to_string(error) + ".");
 }
 
-void WinHttpTransport::CreateSessionHandle(std::unique_ptr<_detail::HandleManager>& handleManager)
+namespace Azure { namespace Core { namespace Http { namespace _detail {
+  struct WinHttpAsyncState final
+  {
+    std::mutex Mutex;
+    // Notified when the operation completes.
+    std::condition_variable Completed;
+    bool Done = true;
+    DWORD Error = ERROR_SUCCESS;
+    DWORD BytesRead = 0;
+
+    // Called before an operation is started on the request handle.
+    void Start()
+    {
+      std::lock_guard<std::mutex> guard(Mutex);
+      Done = false;
+      Error = ERROR_SUCCESS;
+      BytesRead = 0;
+    }
+
+    void Complete(DWORD error, DWORD bytesRead)
+    {
+      {
+        std::lock_guard<std::mutex> guard(Mutex);
+        if (Done)
+        {
+          return;
+        }
+        Done = true;
+        Error = error;
+        BytesRead = bytesRead;
+      }
+      Completed.notify_all();
+    }
+  };
+}}}} // namespace Azure::Core::Http::_detail
+
+namespace {
+// Waits are split so that a cancelled context is noticed quickly.
+constexpr std::chrono::milliseconds MaxWaitDuration(100);
+
+// Called by the WinHTTP thread pool. The context value of a request handle is a reference to its
+// asynchronous state, released when the handle is closed.
+void CALLBACK WinHttpStatusCallback(
+    HINTERNET,
+    DWORD_PTR contextValue,
+    DWORD status,
+    LPVOID statusInformation,
+    DWORD statusInformationLength)
+{
+  if (contextValue == 0)
+  {
+    // A session or connection handle.
+    return;
+  }
+  auto asyncState = reinterpret_cast<std::shared_ptr<_detail::WinHttpAsyncState>*>(contextValue);
+  switch (status)
+  {
+    case WINHTTP_CALLBACK_STATUS_SENDREQUEST_COMPLETE:
+    case WINHTTP_CALLBACK_STATUS_WRITE_COMPLETE:
+    case WINHTTP_CALLBACK_STATUS_HEADERS_AVAILABLE:
+      (*asyncState)->Complete(ERROR_SUCCESS, 0);
+      break;
+    case WINHTTP_CALLBACK_STATUS_READ_COMPLETE:
+      (*asyncState)->Complete(ERROR_SUCCESS, statusInformationLength);
+      break;
+    case WINHTTP_CALLBACK_STATUS_REQUEST_ERROR:
+      (*asyncState)->Complete(
+          static_cast<WINHTTP_ASYNC_RESULT*>(statusInformation)->dwError, 0);
+      break;
+    case WINHTTP_CALLBACK_STATUS_HANDLE_CLOSING:
+      // The last callback for the handle, the operation in progress can't complete anymore.
+      (*asyncState)->Complete(ERROR_WINHTTP_OPERATION_CANCELLED, 0);
+      delete asyncState;
+      break;
+    default:
+      break;
+  }
+}
+
+// Waits for the asynchronous operation started on the request handle, and returns the number of
+// bytes read for a read. The request handle is closed when the context is cancelled, which
+// completes the operation.
+DWORD WaitForCompletion(
+    _detail::HandleManager& handleManager,
+    Context const& context,
+    std::string const& exceptionMessage)
+{
+  auto& asyncState = *handleManager.m_asyncState;
+  std::unique_lock<std::mutex> lock(asyncState.Mutex);
+  while (!asyncState.Done)
+  {
+    if (handleManager.m_requestHandle && context.IsCancelled())
+    {
+      lock.unlock();
+      WinHttpCloseHandle(handleManager.m_requestHandle);
+      handleManager.m_requestHandle = NULL;
+      lock.lock();
+      continue;
+    }
+    asyncState.Completed.wait_for(lock, MaxWaitDuration);
+  }
+  context.ThrowIfCancelled();
+  if (asyncState.Error != ERROR_SUCCESS)
+  {
+    throw Azure::Core::Http::TransportException(
+        exceptionMessage + " Error Code: " + std::to_string(asyncState.Error) + ".");
+  }
+  return asyncState.BytesRead;
+}
+} // namespace
+
+std::shared_ptr<_detail::WinHttpSharedHandle> WinHttpTransport::CreateSessionHandle()
 {
   // Use WinHttpOpen to obtain a session handle.
-  // The dwFlags is set to 0 - all WinHTTP functions are performed synchronously.
-  handleManager->m_sessionHandle = WinHttpOpen(
+  // Unless the asynchronous mode is enabled, the dwFlags is set to 0 - all WinHTTP functions are
+  // performed synchronously.
+  HINTERNET sessionHandle = WinHttpOpen(
       NULL, // Do not use a fallback user-agent string, and only rely on the header within the
             // request itself.
       WINHTTP_ACCESS_TYPE_NO_PROXY,
       WINHTTP_NO_PROXY_NAME,
       WINHTTP_NO_PROXY_BYPASS,
-      0);
+      m_options.EnableAsync ? WINHTTP_FLAG_ASYNC : 0);
 
-  if (!handleManager->m_sessionHandle)
+  if (!sessionHandle)
   {
     // Errors include:
     // ERROR_WINHTTP_INTERNAL_ERROR
     // ERROR_NOT_ENOUGH_MEMORY
     GetErrorAndThrow("Error while getting a session handle.");
   }
+  auto session = std::make_shared<_detail::WinHttpSharedHandle>(sessionHandle);
+
+  // The callback is inherited by the connection and request handles.
+  if (m_options.EnableAsync
+      && WinHttpSetStatusCallback(
+             sessionHandle,
+             WinHttpStatusCallback,
+             WINHTTP_CALLBACK_FLAG_ALL_COMPLETIONS | WINHTTP_CALLBACK_FLAG_HANDLES,
+             0)
+          == WINHTTP_INVALID_STATUS_CALLBACK)
+  {
+    GetErrorAndThrow("Error while setting the status callback.");
+  }
 
 // These options are only available starting from Windows 10 Version 2004, starting 06/09/2020.
 // These are primarily round trip time (RTT) performance optimizations, and hence if they don't get
@@ -232,39 +362,65 @@ void WinHttpTransport::CreateSessionHandle(std::unique_ptr<_detail::HandleManage
 #ifdef WINHTTP_OPTION_TCP_FAST_OPEN
   BOOL tcp_fast_open = TRUE;
   WinHttpSetOption(
-      handleManager->m_sessionHandle,
-      WINHTTP_OPTION_TCP_FAST_OPEN,
-      &tcp_fast_open,
-      sizeof(tcp_fast_open));
+      sessionHandle, WINHTTP_OPTION_TCP_FAST_OPEN, &tcp_fast_open, sizeof(tcp_fast_open));
 #endif
 
 #ifdef WINHTTP_OPTION_TLS_FALSE_START
   BOOL tcp_false_start = TRUE;
   WinHttpSetOption(
-      handleManager->m_sessionHandle,
-      WINHTTP_OPTION_TLS_FALSE_START,
-      &tcp_false_start,
-      sizeof(tcp_false_start));
+      sessionHandle, WINHTTP_OPTION_TLS_FALSE_START, &tcp_false_start, sizeof(tcp_false_start));
 #endif
+
+  return session;
 }
 
 void WinHttpTransport::CreateConnectionHandle(
     std::unique_ptr<_detail::HandleManager>& handleManager)
 {
+  auto const& url = handleManager->m_request.GetUrl();
   // If port is 0, i.e. INTERNET_DEFAULT_PORT, it uses port 80 for HTTP and port 443 for HTTPS.
-  uint16_t port = handleManager->m_request.GetUrl().GetPort();
+  uint16_t port = url.GetPort();
 
   handleManager->m_context.ThrowIfCancelled();
 
+  // The session and the connection handles are reused by the next requests, so that WinHTTP keeps
+  // the connections alive and resumes the TLS sessions.
+  std::unique_lock<std::mutex> guard(m_handlesMutex, std::try_to_lock);
+  if (!guard.owns_lock())
+  {
+    auto const waitStart = std::chrono::steady_clock::now();
+    guard.lock();
+    m_statistics->LockWaitTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now() - waitStart)
+                                      .count();
+  }
+  for (auto cached = m_connectionHandles.begin(); cached != m_connectionHandles.end(); ++cached)
+  {
+    if (cached->Port == port && cached->Host == url.GetHost()
+        && Azure::Core::_internal::StringExtensions::LocaleInvariantCaseInsensitiveEqual(
+            cached->Scheme, url.GetScheme()))
+    {
+      m_connectionHandles.splice(m_connectionHandles.begin(), m_connectionHandles, cached);
+      handleManager->m_connection = cached->Handle;
+      handleManager->m_connectionHandle = cached->Handle->Get();
+      return;
+    }
+  }
+
+  if (!m_sessionHandle)
+  {
+    m_sessionHandle = CreateSessionHandle();
+  }
+
   // Specify an HTTP server.
   // This function always operates synchronously.
-  handleManager->m_connectionHandle = WinHttpConnect(
-      handleManager->m_sessionHandle,
-      StringToWideString(handleManager->m_request.GetUrl().GetHost()).c_str(),
+  HINTERNET connectionHandle = WinHttpConnect(
+      m_sessionHandle->Get(),
+      StringToWideString(url.GetHost()).c_str(),
       port == 0 ? INTERNET_DEFAULT_PORT : port,
       0);
 
-  if (!handleManager->m_connectionHandle)
+  if (!connectionHandle)
   {
     // Errors include:
     // ERROR_WINHTTP_INCORRECT_HANDLE_TYPE
@@ -276,6 +432,17 @@ void WinHttpTransport::CreateConnectionHandle(
     // ERROR_NOT_ENOUGH_MEMORY
     GetErrorAndThrow("Error while getting a connection handle.");
   }
+
+  // The requests still using a dropped connection handle close it.
+  handleManager->m_connection
+      = std::make_shared<_detail::WinHttpSharedHandle>(connectionHandle, m_sessionHandle);
+  handleManager->m_connectionHandle = connectionHandle;
+  m_connectionHandles.push_front(
+      {url.GetScheme(), url.GetHost(), port, handleManager->m_connection});
+  while (m_connectionHandles.size() > std::max<size_t>(m_options.MaxConnectionHandles, 1))
+  {
+    m_connectionHandles.pop_back();
+  }
 }
 
 void WinHttpTransport::CreateRequestHandle(std::unique_ptr<_detail::HandleManager>& handleManager)
@@ -309,43 +476,173 @@ void WinHttpTransport::CreateRequestHandle(std::unique_ptr<_detail::HandleManage
     // ERROR_NOT_ENOUGH_MEMORY
     GetErrorAndThrow("Error while getting a request handle.");
   }
+
+  if (m_options.EnableAsync)
+  {
+    handleManager->m_asyncState = std::make_shared<_detail::WinHttpAsyncState>();
+    // Released by the status callback when the request handle is closed.
+    auto contextValue
+        = new std::shared_ptr<_detail::WinHttpAsyncState>(handleManager->m_asyncState);
+    if (!WinHttpSetOption(
+            handleManager->m_requestHandle,
+            WINHTTP_OPTION_CONTEXT_VALUE,
+            &contextValue,
+            sizeof(contextValue)))
+    {
+      delete contextValue;
+      GetErrorAndThrow("Error while setting the request context.");
+    }
+  }
+}
+
+void WinHttpTransport::WriteData(
+    std::unique_ptr<_detail::HandleManager>& handleManager,
+    uint8_t const* data,
+    size_t length)
+{
+  DWORD dwBytesWritten = 0;
+
+  handleManager->m_context.ThrowIfCancelled();
+
+  if (handleManager->m_asyncState)
+  {
+    handleManager->m_asyncState->Start();
+  }
+  // Write data to the server.
+  if (!WinHttpWriteData(
+          handleManager->m_requestHandle,
+          data,
+          static_cast<DWORD>(length),
+          handleManager->m_asyncState ? NULL : &dwBytesWritten))
+  {
+    GetErrorAndThrow("Error while uploading/sending data.");
+  }
+  if (handleManager->m_asyncState)
+  {
+    WaitForCompletion(
+        *handleManager, handleManager->m_context, "Error while uploading/sending data.");
+  }
+}
+
+void WinHttpTransport::WriteChunk(
+    std::unique_ptr<_detail::HandleManager>& handleManager,
+    uint8_t const* data,
+    size_t length)
+{
+  // WinHTTP sends the body as it is written, so the chunks are framed here. The last chunk is
+  // empty, and it is followed by the empty line ending the body.
+  constexpr char HexDigits[] = "0123456789abcdef";
+  std::string sizeLine;
+  for (auto remaining = length; sizeLine.empty() || remaining != 0; remaining >>= 4)
+  {
+    sizeLine.insert(sizeLine.begin(), HexDigits[remaining & 0xf]);
+  }
+  sizeLine += "\r\n";
+  WriteData(
+      handleManager, reinterpret_cast<uint8_t const*>(sizeLine.data()), sizeLine.size());
+  if (length > 0)
+  {
+    WriteData(handleManager, data, length);
+  }
+  WriteData(handleManager, reinterpret_cast<uint8_t const*>("\r\n"), 2);
 }
 
 // For PUT/POST requests, send additional data using WinHttpWriteData.
-void WinHttpTransport::Upload(std::unique_ptr<_detail::HandleManager>& handleManager)
+void WinHttpTransport::Upload(
+    std::unique_ptr<_detail::HandleManager>& handleManager,
+    bool isChunked)
 {
   auto streamBody = handleManager->m_request.GetBodyStream();
+  // A single write is limited to what a DWORD can hold.
+  const size_t uploadChunkSize = (std::max)(
+      size_t(1),
+      (std::min)(
+          m_options.UploadChunkSize,
+          static_cast<size_t>((std::numeric_limits<DWORD>::max)())));
+
+  // When the stream is on top of a contiguous memory, write straight from it.
+  if (streamBody->SupportsContiguousRead())
+  {
+    while (true)
+    {
+      uint8_t const* data = nullptr;
+      size_t rawRequestLen
+          = streamBody->ReadContiguous(&data, uploadChunkSize, handleManager->m_context);
+      if (rawRequestLen == 0)
+      {
+        break;
+      }
+      if (isChunked)
+      {
+        WriteChunk(handleManager, data, rawRequestLen);
+      }
+      else
+      {
+        WriteData(handleManager, data, rawRequestLen);
+      }
+    }
+    if (isChunked)
+    {
+      WriteChunk(handleManager, nullptr, 0);
+    }
+    return;
+  }
+
   int64_t streamLength = streamBody->Length();
+  if (streamLength == 0)
+  {
+    return;
+  }
 
-  // Consider using `MaximumUploadChunkSize` here, after some perf measurements
-  size_t uploadChunkSize = _detail::DefaultUploadChunkSize;
-  if (streamLength < _detail::MaximumUploadChunkSize)
+  // The bodies smaller than a chunk get a buffer of their size, the other ones share the buffers
+  // kept by the transport.
+  const bool usePooledBuffer
+      = streamLength < 0 || static_cast<uint64_t>(streamLength) >= uploadChunkSize;
+  const size_t bufferSize = usePooledBuffer ? uploadChunkSize : static_cast<size_t>(streamLength);
+  std::unique_ptr<uint8_t[]> unique_buffer;
+  if (usePooledBuffer)
+  {
+    std::lock_guard<std::mutex> guard(m_uploadBuffersMutex);
+    if (!m_uploadBuffers.empty())
+    {
+      unique_buffer = std::move(m_uploadBuffers.back());
+      m_uploadBuffers.pop_back();
+    }
+  }
+  if (!unique_buffer)
   {
-    uploadChunkSize = static_cast<size_t>(streamLength);
+    unique_buffer = std::make_unique<uint8_t[]>(bufferSize);
   }
-  auto unique_buffer = std::make_unique<uint8_t[]>(uploadChunkSize);
 
   while (true)
   {
     size_t rawRequestLen
-        = streamBody->Read(unique_buffer.get(), uploadChunkSize, handleManager->m_context);
+        = streamBody->Read(unique_buffer.get(), bufferSize, handleManager->m_context);
     if (rawRequestLen == 0)
     {
       break;
     }
+    if (isChunked)
+    {
+      WriteChunk(handleManager, unique_buffer.get(), rawRequestLen);
+    }
+    else
+    {
+      WriteData(handleManager, unique_buffer.get(), rawRequestLen);
+    }
+  }
+  if (isChunked)
+  {
+    WriteChunk(handleManager, nullptr, 0);
+  }
 
-    DWORD dwBytesWritten = 0;
-
-    handleManager->m_context.ThrowIfCancelled();
-
-    // Write data to the server.
-    if (!WinHttpWriteData(
-            handleManager->m_requestHandle,
-            unique_buffer.get(),
-            static_cast<DWORD>(rawRequestLen),
-            &dwBytesWritten))
+  // The buffer isn't returned when the upload fails, the next request allocates another one.
+  if (usePooledBuffer)
+  {
+    std::lock_guard<std::mutex> guard(m_uploadBuffersMutex);
+    if (m_uploadBuffers.size() < _detail::MaxPooledUploadBuffers)
     {
-      GetErrorAndThrow("Error while uploading/sending data.");
+      m_uploadBuffers.push_back(std::move(unique_buffer));
     }
   }
 }
@@ -355,6 +652,16 @@ void WinHttpTransport::SendRequest(std::unique_ptr<_detail::HandleManager>& hand
   std::wstring encodedHeaders;
   int encodedHeadersLength = 0;
 
+  int64_t streamLength = handleManager->m_request.GetBodyStream()->Length();
+  // A body whose length isn't known up front is sent in chunks, as it is read.
+  bool const isChunked = streamLength < 0
+      && _detail::RequestHelpers::FindHeader(handleManager->m_request, "content-length")
+          == nullptr;
+  if (isChunked)
+  {
+    handleManager->m_request.SetHeader("transfer-encoding", "chunked");
+  }
+
   auto requestHeaders = handleManager->m_request.GetHeaders();
   if (requestHeaders.size() != 0)
   {
@@ -366,10 +673,12 @@ void WinHttpTransport::SendRequest(std::unique_ptr<_detail::HandleManager>& hand
     encodedHeaders = StringToWideString(requestHeaderString);
   }
 
-  int64_t streamLength = handleManager->m_request.GetBodyStream()->Length();
-
   handleManager->m_context.ThrowIfCancelled();
 
+  if (handleManager->m_asyncState)
+  {
+    handleManager->m_asyncState->Start();
+  }
   // Send a request.
   if (!WinHttpSendRequest(
           handleManager->m_requestHandle,
@@ -377,7 +686,8 @@ void WinHttpTransport::SendRequest(std::unique_ptr<_detail::HandleManager>& hand
           encodedHeadersLength,
           WINHTTP_NO_REQUEST_DATA,
           0,
-          streamLength > 0 ? static_cast<DWORD>(streamLength) : 0,
+          isChunked ? WINHTTP_IGNORE_REQUEST_TOTAL_LENGTH
+                    : (streamLength > 0 ? static_cast<DWORD>(streamLength) : 0),
           0))
   {
     // Errors include:
@@ -401,17 +711,14 @@ void WinHttpTransport::SendRequest(std::unique_ptr<_detail::HandleManager>& hand
     // ERROR_WINHTTP_RESEND_REQUEST
     GetErrorAndThrow("Error while sending a request.");
   }
-
-  // Chunked transfer encoding is not supported and the content length needs to be known up front.
-  if (streamLength == -1)
+  if (handleManager->m_asyncState)
   {
-    throw Azure::Core::Http::TransportException(
-        "When uploading data, the body stream must have a known length.");
+    WaitForCompletion(*handleManager, handleManager->m_context, "Error while sending a request.");
   }
 
-  if (streamLength > 0)
+  if (streamLength > 0 || isChunked)
   {
-    Upload(handleManager);
+    Upload(handleManager, isChunked);
   }
 }
 
@@ -422,6 +729,10 @@ void WinHttpTransport::ReceiveResponse(std::unique_ptr<_detail::HandleManager>&
   // Wait to receive the response to the HTTP request initiated by WinHttpSendRequest.
   // When WinHttpReceiveResponse completes successfully, the status code and response headers have
   // been received.
+  if (handleManager->m_asyncState)
+  {
+    handleManager->m_asyncState->Start();
+  }
   if (!WinHttpReceiveResponse(handleManager->m_requestHandle, NULL))
   {
     // Errors include:
@@ -434,6 +745,11 @@ void WinHttpTransport::ReceiveResponse(std::unique_ptr<_detail::HandleManager>&
     // ERROR_NOT_ENOUGH_MEMORY
     GetErrorAndThrow("Error while receiving a response.");
   }
+  if (handleManager->m_asyncState)
+  {
+    WaitForCompletion(
+        *handleManager, handleManager->m_context, "Error while receiving a response.");
+  }
 }
 
 int64_t WinHttpTransport::GetContentLength(
@@ -593,17 +909,118 @@ std::unique_ptr<RawResponse> WinHttpTransport::SendRequestAndGetResponse(
   return rawResponse;
 }
 
+namespace {
+// The host of the url as reported by the connection statistics, like
+// `https://account.blob.core.windows.net:443`.
+std::string GetStatisticsHost(Azure::Core::Url const& url)
+{
+  uint16_t const port = url.GetPort();
+  return url.GetScheme() + "://" + url.GetHost() + ":"
+      + std::to_string(port != 0 ? port : (url.GetScheme() == "https" ? 443 : 80));
+}
+} // namespace
+
+void WinHttpTransport::LeaseActiveConnection(
+    std::unique_ptr<_detail::HandleManager>& handleManager)
+{
+  auto const host = GetStatisticsHost(handleManager->m_request.GetUrl());
+  auto statistics = m_statistics;
+  {
+    std::lock_guard<std::mutex> lock(statistics->Mutex);
+    statistics->Hosts[host].ActiveConnections += 1;
+  }
+  handleManager->m_activeConnectionLease
+      = std::shared_ptr<void>(statistics.get(), [statistics, host](void*) {
+          std::lock_guard<std::mutex> lock(statistics->Mutex);
+          statistics->Hosts[host].ActiveConnections -= 1;
+        });
+}
+
+void WinHttpTransport::UpdateConnectionStatistics(
+    std::unique_ptr<_detail::HandleManager>& handleManager)
+{
+#if defined(WINHTTP_OPTION_REQUEST_STATS) && defined(WINHTTP_OPTION_REQUEST_TIMES)
+  // Older versions of Windows fail to query the statistics, the request isn't counted then.
+  WINHTTP_REQUEST_STATS requestStats = {};
+  DWORD requestStatsSize = sizeof(requestStats);
+  if (!WinHttpQueryOption(
+          handleManager->m_requestHandle,
+          WINHTTP_OPTION_REQUEST_STATS,
+          &requestStats,
+          &requestStatsSize))
+  {
+    return;
+  }
+  bool const isNewConnection
+      = (requestStats.ullFlags & WINHTTP_REQUEST_STAT_FLAG_FIRST_REQUEST) != 0;
+
+  // The times are performance counter values.
+  std::chrono::microseconds handshakeTime{0};
+  WINHTTP_REQUEST_TIMES requestTimes = {};
+  DWORD requestTimesSize = sizeof(requestTimes);
+  LARGE_INTEGER frequency = {};
+  if (isNewConnection
+      && WinHttpQueryOption(
+          handleManager->m_requestHandle,
+          WINHTTP_OPTION_REQUEST_TIMES,
+          &requestTimes,
+          &requestTimesSize)
+      && QueryPerformanceFrequency(&frequency) && frequency.QuadPart > 0)
+  {
+    auto const start = requestTimes.rgullTimes[WinHttpNameResolutionStart] != 0
+        ? requestTimes.rgullTimes[WinHttpNameResolutionStart]
+        : requestTimes.rgullTimes[WinHttpConnectionEstablishmentStart];
+    auto const end = (std::max)(
+        requestTimes.rgullTimes[WinHttpConnectionEstablishmentEnd],
+        requestTimes.rgullTimes[WinHttpTlsHandshakeClientLeg3End]);
+    if (start != 0 && end > start)
+    {
+      handshakeTime = std::chrono::microseconds(
+          static_cast<int64_t>((end - start) * 1000000 / frequency.QuadPart));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_statistics->Mutex);
+  auto& hostStatistics
+      = m_statistics->Hosts[GetStatisticsHost(handleManager->m_request.GetUrl())];
+  if (isNewConnection)
+  {
+    hostStatistics.CreatedConnections += 1;
+    hostStatistics.HandshakeTime += handshakeTime;
+  }
+  else
+  {
+    hostStatistics.ReusedConnections += 1;
+  }
+#else
+  (void)handleManager;
+#endif
+}
+
+ConnectionPoolStatistics WinHttpTransport::GetConnectionPoolStatistics() const
+{
+  ConnectionPoolStatistics result;
+  {
+    std::lock_guard<std::mutex> lock(m_statistics->Mutex);
+    result.Hosts = m_statistics->Hosts;
+  }
+  result.LockWaitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::nanoseconds(m_statistics->LockWaitTime.load()));
+  return result;
+}
+
 std::unique_ptr<RawResponse> WinHttpTransport::Send(Request& request, Context const& context)
 {
   auto handleManager = std::make_unique<_detail::HandleManager>(request, context);
 
-  CreateSessionHandle(handleManager);
   CreateConnectionHandle(handleManager);
   CreateRequestHandle(handleManager);
+  LeaseActiveConnection(handleManager);
 
   SendRequest(handleManager);
 
   ReceiveResponse(handleManager);
+  UpdateConnectionStatistics(handleManager);
 
   return SendRequestAndGetResponse(std::move(handleManager), request.GetMethod());
 }
@@ -618,15 +1035,17 @@ size_t _detail::WinHttpStream::OnRead(uint8_t* buffer, size_t count, Context con
 
   // No need to check for context cancellation before the first I/O because the base class
   // BodyStream::Read already does that.
-  (void)context;
-
   DWORD numberOfBytesRead = 0;
 
+  if (this->m_handleManager->m_asyncState)
+  {
+    this->m_handleManager->m_asyncState->Start();
+  }
   if (!WinHttpReadData(
           this->m_handleManager->m_requestHandle,
           (LPVOID)(buffer),
           static_cast<DWORD>(count),
-          &numberOfBytesRead))
+          this->m_handleManager->m_asyncState ? NULL : &numberOfBytesRead))
   {
     // Errors include:
     // ERROR_WINHTTP_CONNECTION_ERROR
@@ -643,6 +1062,11 @@ size_t _detail::WinHttpStream::OnRead(uint8_t* buffer, size_t count, Context con
         "Error while reading available data from the wire. Error Code: " + std::to_string(error)
         + ".");
   }
+  if (this->m_handleManager->m_asyncState)
+  {
+    numberOfBytesRead = WaitForCompletion(
+        *this->m_handleManager, context, "Error while reading available data from the wire.");
+  }
 
   this->m_streamTotalRead += numberOfBytesRead;
 
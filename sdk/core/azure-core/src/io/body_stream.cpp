@@ -27,6 +27,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <vector>
@@ -59,22 +60,80 @@ size_t BodyStream::ReadToCount(uint8_t* buffer, size_t count, Context const& con
   }
 }
 
+size_t BodyStream::OnReadV(ReadBuffer const* buffers, size_t bufferCount, Context const& context)
+{
+  size_t totalRead = 0;
+  for (size_t i = 0; i < bufferCount; ++i)
+  {
+    auto const readBytes = this->OnRead(buffers[i].Data, buffers[i].Count, context);
+    totalRead += readBytes;
+    // Reading more could wait for data, when some was already read.
+    if (readBytes < buffers[i].Count)
+    {
+      return totalRead;
+    }
+  }
+  return totalRead;
+}
+
+namespace {
+// A length above this isn't allocated up front, in case the stream is shorter than it says.
+constexpr int64_t MaxPresizedLength = int64_t(64) * 1024 * 1024;
+} // namespace
+
 std::vector<uint8_t> BodyStream::ReadToEnd(Context const& context)
 {
   constexpr size_t chunkSize = 1024 * 8;
-  auto buffer = std::vector<uint8_t>();
+  std::vector<uint8_t> buffer;
+
+  // With a known length, the body is read in a single allocation.
+  auto const length = this->Length();
+  auto const presizedLength
+      = length > 0 ? static_cast<size_t>((std::min)(length, MaxPresizedLength)) : chunkSize;
 
-  for (auto chunkNumber = 0;; chunkNumber++)
+  // The data in memory is copied once, without zero-filling the buffer first.
+  if (this->SupportsContiguousRead())
   {
-    buffer.resize((static_cast<decltype(buffer)::size_type>(chunkNumber) + 1) * chunkSize);
-    size_t readBytes
-        = this->ReadToCount(buffer.data() + (chunkNumber * chunkSize), chunkSize, context);
+    buffer.reserve(presizedLength);
+    for (;;)
+    {
+      uint8_t const* data = nullptr;
+      auto const readBytes
+          = this->ReadContiguous(&data, (std::numeric_limits<size_t>::max)(), context);
+      if (readBytes == 0)
+      {
+        return buffer;
+      }
+      buffer.insert(buffer.end(), data, data + readBytes);
+    }
+  }
 
-    if (readBytes < chunkSize)
+  buffer.resize(presizedLength);
+
+  size_t totalRead = 0;
+  for (;;)
+  {
+    totalRead += this->ReadToCount(buffer.data() + totalRead, buffer.size() - totalRead, context);
+    if (totalRead < buffer.size())
     {
-      buffer.resize(static_cast<size_t>((chunkNumber * chunkSize) + readBytes));
+      buffer.resize(totalRead);
       return buffer;
     }
+
+    // The buffer is full, the stream may still have data. It is read into a chunk first, so a
+    // buffer of the right size isn't grown.
+    uint8_t chunk[chunkSize];
+    auto const chunkRead = this->ReadToCount(chunk, chunkSize, context);
+    buffer.insert(buffer.end(), chunk, chunk + chunkRead);
+    totalRead += chunkRead;
+    if (chunkRead < chunkSize)
+    {
+      return buffer;
+    }
+
+    // Growing geometrically rather than by a chunk at a time, so the data is copied and
+    // zero-filled a bounded number of times.
+    buffer.resize(buffer.size() * 2);
   }
 }
 
@@ -90,6 +149,20 @@ size_t MemoryBodyStream::OnRead(uint8_t* buffer, size_t count, Context const& co
   return copy_length;
 }
 
+size_t MemoryBodyStream::OnReadContiguous(
+    uint8_t const** data,
+    size_t count,
+    Context const& context)
+{
+  (void)context;
+  size_t read_length = std::min(count, this->m_length - this->m_offset);
+  *data = this->m_data + m_offset;
+  // move position
+  m_offset += read_length;
+
+  return read_length;
+}
+
 FileBodyStream::FileBodyStream(const std::string& filename)
 {
   _azure_ASSERT_MSG(filename.size() > 0, "The file name must not be an empty string.");
@@ -218,8 +291,116 @@ size_t ProgressBodyStream::OnRead(
   return read;
 }
 
+size_t ProgressBodyStream::OnReadV(
+    ReadBuffer const* buffers,
+    size_t bufferCount,
+    Azure::Core::Context const& context)
+{
+  size_t read = m_bodyStream->ReadV(buffers, bufferCount, context);
+  m_bytesTransferred += read;
+  m_callback(m_bytesTransferred);
+
+  return read;
+}
+
 int64_t ProgressBodyStream::Length() const { return m_bodyStream->Length(); }
 
+RewindableBodyStream::RewindableBodyStream(BodyStream& bodyStream, size_t maxMemoryBufferSize)
+    : m_bodyStream(&bodyStream), m_maxMemoryBufferSize(maxMemoryBufferSize)
+{
+}
+
+RewindableBodyStream::~RewindableBodyStream()
+{
+  if (m_file)
+  {
+    // The temporary file is removed once closed.
+    std::fclose(m_file);
+  }
+}
+
+void RewindableBodyStream::Rewind()
+{
+  m_offset = 0;
+  if (m_file)
+  {
+    std::rewind(m_file);
+    m_isFileRead = true;
+  }
+}
+
+size_t RewindableBodyStream::OnRead(
+    uint8_t* buffer,
+    size_t count,
+    Azure::Core::Context const& context)
+{
+  // The data kept is read again, from memory and then from the file, after a rewind.
+  auto const memoryLength = static_cast<int64_t>(m_memoryBuffer.size());
+  if (m_offset < memoryLength)
+  {
+    auto const readBytes = static_cast<size_t>(
+        (std::min)(static_cast<int64_t>(count), memoryLength - m_offset));
+    std::memcpy(buffer, m_memoryBuffer.data() + m_offset, readBytes);
+    m_offset += readBytes;
+    return readBytes;
+  }
+  if (m_offset < memoryLength + m_fileLength)
+  {
+    auto const readBytes = std::fread(
+        buffer,
+        1,
+        static_cast<size_t>(
+            (std::min)(static_cast<int64_t>(count), memoryLength + m_fileLength - m_offset)),
+        m_file);
+    if (readBytes == 0)
+    {
+      throw std::runtime_error("Failed to read the data kept in a temporary file.");
+    }
+    m_isFileRead = true;
+    m_offset += readBytes;
+    return readBytes;
+  }
+
+  size_t const readBytes = m_bodyStream->Read(buffer, count, context);
+  if (m_memoryBuffer.capacity() == 0 && readBytes > 0)
+  {
+    auto const length = m_bodyStream->Length();
+    m_memoryBuffer.reserve(
+        length > 0 ? static_cast<size_t>((std::min)(
+            static_cast<uint64_t>(length), static_cast<uint64_t>(m_maxMemoryBufferSize)))
+                   : (std::min)(readBytes, m_maxMemoryBufferSize));
+  }
+  size_t const memoryBytes = (std::min)(readBytes, m_maxMemoryBufferSize - m_memoryBuffer.size());
+  m_memoryBuffer.insert(m_memoryBuffer.end(), buffer, buffer + memoryBytes);
+
+  if (readBytes > memoryBytes)
+  {
+    if (!m_file)
+    {
+      m_file = std::tmpfile();
+      if (!m_file)
+      {
+        throw std::runtime_error("Failed to create a temporary file to keep the data read.");
+      }
+    }
+    else if (m_isFileRead)
+    {
+      // Switching from reading to writing needs the file to be positioned.
+      std::fseek(m_file, 0, SEEK_CUR);
+    }
+    m_isFileRead = false;
+
+    size_t const fileBytes = readBytes - memoryBytes;
+    if (std::fwrite(buffer + memoryBytes, 1, fileBytes, m_file) != fileBytes)
+    {
+      throw std::runtime_error("Failed to keep the data read in a temporary file.");
+    }
+    m_fileLength += fileBytes;
+  }
+  m_offset += readBytes;
+  return readBytes;
+}
+
 using Azure::Core::IO::_internal::NullBodyStream;
 
 NullBodyStream* NullBodyStream::GetNullBodyStream()
@@ -5,6 +5,7 @@
 
 #if defined(AZ_PLATFORM_POSIX)
 #include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 #elif defined(AZ_PLATFORM_WINDOWS)
 #if !defined(WIN32_LEAN_AND_MEAN)
@@ -19,6 +20,7 @@
 #include "azure/core/context.hpp"
 #include "azure/core/io/body_stream.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -26,6 +28,42 @@
 using Azure::Core::Context;
 using namespace Azure::Core::IO::_internal;
 
+namespace {
+// How far ahead of the reads the operating system is asked to read the file.
+constexpr int64_t ReadAheadLength = 4 * 1024 * 1024;
+} // namespace
+
+void RandomAccessFileBodyStream::ReadAhead()
+{
+  // The next part of the file is read ahead once the reads are past the middle of the part read
+  // ahead before, so that the disk reads overlap with the sends of the data already read.
+  if (this->m_offset + ReadAheadLength / 2 < this->m_readAheadOffset
+      || this->m_readAheadOffset >= this->m_length)
+  {
+    return;
+  }
+  int64_t const offset = (std::max)(this->m_offset, this->m_readAheadOffset);
+  int64_t const length = (std::min)(this->m_offset + ReadAheadLength, this->m_length) - offset;
+  this->m_readAheadOffset = offset + length;
+
+  // The advice is a hint, reading still works where it fails.
+#if defined(POSIX_FADV_WILLNEED)
+  posix_fadvise(
+      this->m_fileDescriptor,
+      static_cast<off_t>(this->m_baseOffset + offset),
+      static_cast<off_t>(length),
+      POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+  radvisory advice;
+  advice.ra_offset = static_cast<off_t>(this->m_baseOffset + offset);
+  advice.ra_count = static_cast<int>(length);
+  fcntl(this->m_fileDescriptor, F_RDADVISE, &advice);
+#else
+  (void)offset;
+  (void)length;
+#endif
+}
+
 size_t RandomAccessFileBodyStream::OnRead(
     uint8_t* buffer,
     size_t count,
@@ -34,6 +72,8 @@ size_t RandomAccessFileBodyStream::OnRead(
 
 #if defined(AZ_PLATFORM_POSIX)
 
+  ReadAhead();
+
   // Returning ssize_t from pread as a size_t is fine since we do a `< 0` check below and throw.
   auto numberOfBytesRead = pread(
       this->m_fileDescriptor,
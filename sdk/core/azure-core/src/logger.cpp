@@ -4,8 +4,13 @@
 #include "azure/core/diagnostics/logger.hpp"
 #include "azure/core/internal/diagnostics/log.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <mutex>
-#include <shared_mutex>
+#include <thread>
+#include <utility>
 
 #include "private/environment_log_level_listener.hpp"
 
@@ -13,9 +18,56 @@ using namespace Azure::Core::Diagnostics;
 using namespace Azure::Core::Diagnostics::_internal;
 
 namespace {
-static std::shared_timed_mutex g_logListenerMutex;
-static std::function<void(Logger::Level level, std::string const& message)> g_logListener(
-    _detail::EnvironmentLogLevelListener::GetLogListener());
+using LogListener = std::function<void(Logger::Level level, std::string const& message)>;
+
+LogListener const* MakeLogListener(LogListener listener)
+{
+  return listener ? new LogListener const(std::move(listener)) : nullptr;
+}
+
+// The threads writing a message count themselves in one of these stripes, picked by thread, so
+// they don't share a cache line with each other. Each stripe counts the writers of the current
+// epoch apart from the ones of the previous epoch, so SetListener() waits for the writers which
+// may use the previous listener without waiting for the new ones.
+struct alignas(64) ListenerReaders final
+{
+  std::atomic<uint32_t> Count[2];
+};
+
+constexpr size_t ListenerReadersStripes = 16;
+static ListenerReaders g_listenerReaders[ListenerReadersStripes] = {};
+static std::atomic<uint32_t> g_listenerEpoch(0);
+
+// Only serializes the calls to SetListener().
+static std::mutex g_setLogListenerMutex;
+// Deleted by SetListener() once no thread uses it anymore.
+static std::atomic<LogListener const*> g_logListener(
+    MakeLogListener(_detail::EnvironmentLogLevelListener::GetLogListener()));
+
+ListenerReaders& GetListenerReaders()
+{
+  static thread_local size_t const stripe
+      = std::hash<std::thread::id>()(std::this_thread::get_id()) % ListenerReadersStripes;
+  return g_listenerReaders[stripe];
+}
+
+// Counts the thread among the writers of the current epoch while it uses the listener.
+class ListenerReadGuard final {
+private:
+  std::atomic<uint32_t>& m_count;
+
+public:
+  ListenerReadGuard()
+      : m_count(GetListenerReaders().Count[g_listenerEpoch.load() % 2])
+  {
+    m_count.fetch_add(1);
+  }
+
+  ~ListenerReadGuard() { m_count.fetch_sub(1, std::memory_order_release); }
+
+  ListenerReadGuard(ListenerReadGuard const&) = delete;
+  ListenerReadGuard& operator=(ListenerReadGuard const&) = delete;
+};
 } // namespace
 
 std::atomic<bool> Log::g_isLoggingEnabled(
@@ -32,10 +84,13 @@ void Log::Write(Logger::Level level, std::string const& message)
 {
   if (ShouldWrite(level))
   {
-    std::shared_lock<std::shared_timed_mutex> loggerLock(g_logListenerMutex);
-    if (g_logListener)
+    // The listener is loaded once the thread is counted, so either SetListener() waits for this
+    // call, or this call sees the new listener.
+    ListenerReadGuard const readGuard;
+    auto const listener = g_logListener.load();
+    if (listener)
     {
-      g_logListener(level, message);
+      (*listener)(level, message);
     }
   }
 }
@@ -43,9 +98,28 @@ void Log::Write(Logger::Level level, std::string const& message)
 void Logger::SetListener(
     std::function<void(Logger::Level level, std::string const& message)> listener)
 {
-  std::unique_lock<std::shared_timed_mutex> loggerLock(g_logListenerMutex);
-  g_logListener = std::move(listener);
-  Log::EnableLogging(g_logListener != nullptr);
+  auto const newListener = MakeLogListener(std::move(listener));
+
+  std::lock_guard<std::mutex> setListenerLock(g_setLogListenerMutex);
+  auto const previousListener = g_logListener.exchange(newListener);
+  Log::EnableLogging(newListener != nullptr);
+
+  // Waits for the writers counted in the previous epoch, which may still be calling the previous
+  // listener. A writer may read the epoch before it changes and count itself after the wait, it
+  // then sees the new listener. Since it's counted in the epoch before, the epoch changes twice,
+  // like the next call would, so the counters of both epochs get drained once.
+  for (int phase = 0; phase < 2; ++phase)
+  {
+    auto const previousEpoch = g_listenerEpoch.fetch_add(1) % 2;
+    for (auto& readers : g_listenerReaders)
+    {
+      while (readers.Count[previousEpoch].load(std::memory_order_acquire) != 0)
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+  delete previousListener;
 }
 
 void Logger::SetLevel(Logger::Level level) { Log::SetLogLevel(level); }
@@ -0,0 +1,219 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/diagnostics/metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+using Azure::Core::Diagnostics::LatencyHistogram;
+using Azure::Core::Diagnostics::MetricsAggregator;
+using Azure::Core::Diagnostics::OperationMetrics;
+using Azure::Core::Diagnostics::RequestMetrics;
+
+namespace {
+constexpr int SubBucketBits = LatencyHistogram::SubBucketBits;
+constexpr uint64_t SubBucketCount = LatencyHistogram::SubBucketCount;
+
+// The values below SubBucketCount have a bucket each. Above, the bucket of a value is given by its
+// highest bit set and the SubBucketBits bits following it.
+size_t GetBucketIndex(uint64_t value)
+{
+  if (value < SubBucketCount)
+  {
+    return static_cast<size_t>(value);
+  }
+
+  int highestBit = 0;
+  for (int bits = 32; bits > 0; bits /= 2)
+  {
+    if ((value >> (highestBit + bits)) != 0)
+    {
+      highestBit += bits;
+    }
+  }
+  auto const shift = highestBit - SubBucketBits;
+  return static_cast<size_t>((shift + 1) * SubBucketCount + ((value >> shift) - SubBucketCount));
+}
+
+uint64_t GetBucketUpperBound(size_t index)
+{
+  if (index < SubBucketCount)
+  {
+    return index;
+  }
+
+  auto const shift = index / SubBucketCount - 1;
+  auto const subBucket = index % SubBucketCount + SubBucketCount;
+  return ((subBucket + 1) << shift) - 1;
+}
+
+bool IsFailed(RequestMetrics const& metrics)
+{
+  return !metrics.StatusCode.HasValue()
+      || static_cast<int>(metrics.StatusCode.Value()) >= 400;
+}
+} // namespace
+
+LatencyHistogram::LatencyHistogram() noexcept
+{
+  for (auto& bucket : m_buckets)
+  {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::Record(std::chrono::microseconds duration) noexcept
+{
+  auto const value = (std::max)(static_cast<int64_t>(duration.count()), int64_t(0));
+  m_buckets[GetBucketIndex(static_cast<uint64_t>(value))].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(value, std::memory_order_relaxed);
+
+  auto max = m_max.load(std::memory_order_relaxed);
+  while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const& other) noexcept
+{
+  for (size_t i = 0; i < BucketCount; ++i)
+  {
+    auto const count = other.m_buckets[i].load(std::memory_order_relaxed);
+    if (count != 0)
+    {
+      m_buckets[i].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+  m_count.fetch_add(other.GetCount(), std::memory_order_relaxed);
+  m_sum.fetch_add(other.GetSum().count(), std::memory_order_relaxed);
+
+  auto const value = other.GetMax().count();
+  auto max = m_max.load(std::memory_order_relaxed);
+  while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+std::chrono::microseconds LatencyHistogram::GetPercentile(double percentile) const noexcept
+{
+  // The durations may be recorded meanwhile, so the count is the one of the buckets read.
+  int64_t counts[BucketCount];
+  int64_t count = 0;
+  for (size_t i = 0; i < BucketCount; ++i)
+  {
+    counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    count += counts[i];
+  }
+  if (count == 0)
+  {
+    return std::chrono::microseconds(0);
+  }
+
+  percentile = (std::min)(100.0, (std::max)(0.0, percentile));
+  auto const rank = (std::max)(
+      int64_t(1), static_cast<int64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count))));
+  int64_t seen = 0;
+  for (size_t i = 0; i < BucketCount; ++i)
+  {
+    seen += counts[i];
+    if (seen >= rank)
+    {
+      auto const upperBound = static_cast<int64_t>(GetBucketUpperBound(i));
+      return std::chrono::microseconds((std::min)(upperBound, GetMax().count()));
+    }
+  }
+  return GetMax();
+}
+
+struct MetricsAggregator::State final
+{
+  std::shared_timed_mutex Mutex;
+  // The metrics are never removed, so they can be updated without holding the mutex.
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<OperationMetrics>> Operations;
+
+  OperationMetrics& GetOperationMetrics(RequestMetrics const& metrics)
+  {
+    auto key = std::make_pair(metrics.ClientName, metrics.OperationName);
+    {
+      std::shared_lock<std::shared_timed_mutex> lock(Mutex);
+      auto const found = Operations.find(key);
+      if (found != Operations.end())
+      {
+        return *found->second;
+      }
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock(Mutex);
+    auto& operation = Operations[std::move(key)];
+    if (!operation)
+    {
+      operation = std::make_unique<OperationMetrics>();
+    }
+    return *operation;
+  }
+
+  void Record(RequestMetrics const& metrics)
+  {
+    auto& operation = GetOperationMetrics(metrics);
+    operation.Duration.Record(metrics.Duration);
+    if (metrics.TimeToFirstByte.HasValue())
+    {
+      operation.TimeToFirstByte.Record(metrics.TimeToFirstByte.Value());
+    }
+    operation.RequestCount.fetch_add(1, std::memory_order_relaxed);
+    if (IsFailed(metrics))
+    {
+      operation.FailedRequestCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    operation.RetryCount.fetch_add(metrics.RetryCount, std::memory_order_relaxed);
+    if (metrics.IsConnectionReused.HasValue())
+    {
+      (metrics.IsConnectionReused.Value() ? operation.ReusedConnectionCount
+                                          : operation.NewConnectionCount)
+          .fetch_add(1, std::memory_order_relaxed);
+    }
+    operation.BytesSent.fetch_add(metrics.BytesSent, std::memory_order_relaxed);
+    operation.BytesReceived.fetch_add(metrics.BytesReceived, std::memory_order_relaxed);
+  }
+};
+
+MetricsAggregator::MetricsAggregator() : m_state(std::make_shared<State>()) {}
+
+void MetricsAggregator::Record(RequestMetrics const& metrics) { m_state->Record(metrics); }
+
+std::function<void(RequestMetrics const& metrics)> MetricsAggregator::GetListener() const
+{
+  auto const state = m_state;
+  return [state](RequestMetrics const& metrics) { state->Record(metrics); };
+}
+
+void MetricsAggregator::Export(std::function<void(
+                                   std::string const& clientName,
+                                   std::string const& operationName,
+                                   OperationMetrics const& metrics)> const& exporter) const
+{
+  // The exporter is called without holding the mutex, so it doesn't block the requests recording
+  // metrics for a new operation.
+  std::vector<std::pair<std::pair<std::string, std::string> const*, OperationMetrics const*>>
+      operations;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(m_state->Mutex);
+    operations.reserve(m_state->Operations.size());
+    for (auto const& operation : m_state->Operations)
+    {
+      operations.emplace_back(&operation.first, operation.second.get());
+    }
+  }
+
+  for (auto const& operation : operations)
+  {
+    exporter(operation.first->first, operation.first->second, *operation.second);
+  }
+}
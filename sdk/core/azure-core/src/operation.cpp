@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/operation.hpp"
+
+#include "private/retry_delay.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Azure { namespace Core { namespace _internal {
+
+  std::chrono::milliseconds GetPollDelay(
+      Http::RawResponse const* response,
+      std::chrono::milliseconds period,
+      int32_t pollCount)
+  {
+    if (response != nullptr)
+    {
+      std::chrono::milliseconds retryAfter{};
+      try
+      {
+        if (_detail::GetResponseHeaderBasedDelay(*response, retryAfter)
+            && retryAfter >= std::chrono::milliseconds::zero())
+        {
+          return retryAfter;
+        }
+      }
+      catch (std::logic_error const&)
+      {
+        // A header which isn't a number of seconds or milliseconds is ignored.
+      }
+    }
+
+    const std::chrono::milliseconds maxPeriod = (std::max)(period, MaxPollPeriod);
+    std::chrono::milliseconds delay = period;
+    for (int32_t poll = 1; poll < pollCount && delay < maxPeriod; ++poll)
+    {
+      delay *= 2;
+    }
+    return (std::min)(delay, maxPeriod);
+  }
+
+  void WaitForPollDelay(std::chrono::milliseconds delay, Context const& context)
+  {
+    _detail::RetryDelayWaiter().Wait(
+        context,
+        delay,
+        "Operation was cancelled by context, its deadline is before the next poll.");
+  }
+
+}}} // namespace Azure::Core::_internal
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Notifications sent when an #Azure::Core::Context is cancelled.
+ *
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+
+namespace Azure { namespace Core { namespace _detail {
+
+  /**
+   * @brief Gets notified when #Azure::Core::Context::Cancel() is called on the context it is
+   * registered with, or on one of its parents.
+   *
+   * @remark A listener registered with several contexts must check
+   * #Azure::Core::Context::IsCancelled() to know which one was cancelled.
+   */
+  class ContextCancellationListener {
+  protected:
+    ~ContextCancellationListener() = default;
+
+  public:
+    /**
+     * @brief Called from the thread cancelling a context. It must not block.
+     *
+     */
+    virtual void OnContextCancelled() noexcept = 0;
+  };
+
+  /**
+   * @brief Keeps a #ContextCancellationListener registered with a context for the lifetime of
+   * this object.
+   *
+   * @remark Only the context waited on knows about the registration, so the registrations of
+   * different requests don't contend with each other, even when they wait on the same parent.
+   * Cancelling a context looks for the registrations made on it or on the contexts created from
+   * it. The registrations are kept by shards, each with its own mutex held while notifying the
+   * listeners, so the registrations must not be created or destroyed while holding a lock the
+   * listener takes.
+   */
+  class ContextCancellationRegistration final {
+  private:
+    Context m_context;
+    ContextCancellationListener* m_listener;
+
+    friend class Azure::Core::Context;
+
+  public:
+    /**
+     * @brief Starts notifying \p listener when \p context or one of its parents is cancelled.
+     *
+     * @remark A context cancelled before the registration doesn't notify the listener, so the
+     * listener must check #Azure::Core::Context::IsCancelled() once registered.
+     *
+     * @param context The context to wait on.
+     * @param listener The listener to notify. It must outlive this object.
+     */
+    explicit ContextCancellationRegistration(
+        Context const& context,
+        ContextCancellationListener* listener);
+
+    ContextCancellationRegistration(ContextCancellationRegistration const&) = delete;
+    ContextCancellationRegistration& operator=(ContextCancellationRegistration const&) = delete;
+
+    /**
+     * @brief Stops notifying the listener.
+     *
+     */
+    ~ContextCancellationRegistration();
+  };
+
+}}} // namespace Azure::Core::_detail
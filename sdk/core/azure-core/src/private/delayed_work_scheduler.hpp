@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Runs work after a delay, such as the retries of the requests sent asynchronously.
+ *
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+
+#include "context_cancellation.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Core { namespace _detail {
+
+  /**
+   * @brief Runs work on a pool of worker threads once its delay has elapsed.
+   *
+   * @remark A single thread keeps the time for all the work waiting, and hands the work that is
+   * due to the workers, so that a slow piece of work, such as a request sent through a synchronous
+   * transport, doesn't hold up the others. Workers are started when there is work and none of them
+   * is idle, up to #MaxWorkers.
+   *
+   * The scheduler is registered with the context of the work waiting on one, the registrations
+   * are only created and destroyed without holding m_mutex, which OnContextCancelled() takes.
+   */
+  class DelayedWorkScheduler final : public ContextCancellationListener {
+  public:
+    /**
+     * @brief Identifies scheduled work, to unschedule it.
+     *
+     */
+    using WorkId = uint64_t;
+
+    /**
+     * @brief The maximum number of worker threads. More work than that waits for a worker.
+     *
+     */
+    static constexpr size_t MaxWorkers = 64;
+
+  private:
+    struct ScheduledWork final
+    {
+      WorkId Id;
+      // Work that has no context is only run once its delay has elapsed.
+      std::unique_ptr<Context> WorkContext;
+      std::function<void()> Work;
+      std::unique_ptr<ContextCancellationRegistration> Registration;
+    };
+
+    using ScheduledWorkMap = std::multimap<std::chrono::steady_clock::time_point, ScheduledWork>;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    ScheduledWorkMap m_scheduled;
+    std::map<WorkId, ScheduledWorkMap::iterator> m_scheduledById;
+    WorkId m_nextId = 0;
+    bool m_cancellationNotified = false;
+    bool m_stopRequested = false;
+    std::thread m_timer;
+
+    std::mutex m_workersMutex;
+    std::condition_variable m_workAdded;
+    std::deque<std::function<void()>> m_work;
+    std::vector<std::thread> m_workers;
+    size_t m_idleWorkers = 0;
+    bool m_workersStopRequested = false;
+
+    DelayedWorkScheduler();
+
+    WorkId Add(
+        std::chrono::milliseconds delay,
+        std::unique_ptr<Context> context,
+        std::function<void()> work);
+    void RunTimer();
+    void RunWorker();
+    void Dispatch(std::vector<ScheduledWork> due);
+
+  public:
+    /**
+     * @brief Gets the scheduler of the process. Its threads are started on first use, so they
+     * only exist in the processes scheduling work.
+     *
+     */
+    static DelayedWorkScheduler& GetInstance();
+
+    ~DelayedWorkScheduler();
+
+    DelayedWorkScheduler(DelayedWorkScheduler const&) = delete;
+    DelayedWorkScheduler& operator=(DelayedWorkScheduler const&) = delete;
+
+    void OnContextCancelled() noexcept override;
+
+    /**
+     * @brief Runs \p work on a worker after \p delay, or as soon as \p context is cancelled.
+     *
+     * @remark The work must not throw.
+     */
+    WorkId Schedule(
+        std::chrono::milliseconds delay,
+        Context const& context,
+        std::function<void()> work);
+
+    /**
+     * @brief Runs \p work on a worker after \p delay.
+     *
+     * @remark The work must not throw.
+     */
+    WorkId Schedule(std::chrono::milliseconds delay, std::function<void()> work);
+
+    /**
+     * @brief Removes work that was not handed to a worker yet.
+     *
+     * @return `true` if the work was removed and won't run; `false` if it's running, about to
+     * run or done.
+     */
+    bool Unschedule(WorkId id);
+  };
+
+}}} // namespace Azure::Core::_detail
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Delays before retrying a request or polling an operation again.
+ *
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/http/raw_response.hpp"
+
+#include "context_cancellation.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+namespace Azure { namespace Core { namespace _detail {
+
+  /**
+   * @brief Gets the delay asked for by the service through the `retry-after-ms`,
+   * `x-ms-retry-after-ms` or `retry-after` headers of a response.
+   *
+   * @return `true` if the response has one of the headers.
+   */
+  bool GetResponseHeaderBasedDelay(
+      Azure::Core::Http::RawResponse const& response,
+      std::chrono::milliseconds& retryAfter);
+
+  /**
+   * @brief Waits for a delay, waking up as soon as the context is cancelled so that a shutdown
+   * doesn't wait out the delay.
+   *
+   */
+  class RetryDelayWaiter final : public ContextCancellationListener {
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_notified = false;
+
+  public:
+    void OnContextCancelled() noexcept override
+    {
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_notified = true;
+      }
+      m_condition.notify_all();
+    }
+
+    // Throws OperationCancelledException if the context is cancelled before the delay has
+    // elapsed, or with deadlineMessage if its deadline is before the end of the delay.
+    void Wait(
+        Context const& context,
+        std::chrono::milliseconds delay,
+        std::string const& deadlineMessage)
+    {
+      // The registration is done before checking the context, so a cancellation happening from
+      // now on either shows up in the check or sets m_notified.
+      ContextCancellationRegistration registration(context, this);
+      context.ThrowIfCancelled();
+
+      // A context also gets cancelled when its deadline passes, that doesn't notify the
+      // listeners. There is no point in waiting for what would be done after the deadline.
+      if (context.GetDeadline() < std::chrono::system_clock::now() + delay)
+      {
+        throw Azure::Core::OperationCancelledException(deadlineMessage);
+      }
+
+      auto const end = std::chrono::steady_clock::now() + delay;
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (m_condition.wait_until(lock, end, [this]() { return m_notified; }))
+      {
+        context.ThrowIfCancelled();
+      }
+    }
+  };
+
+}}} // namespace Azure::Core::_detail
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Metrics of a try of a request, filled by the transport.
+ *
+ */
+
+#pragma once
+
+#include "azure/core/context.hpp"
+#include "azure/core/nullable.hpp"
+
+#include <chrono>
+
+namespace Azure { namespace Core { namespace Diagnostics { namespace _detail {
+
+  /**
+   * @brief The metrics of a try of a request only the transport knows.
+   *
+   * @remark The metrics policy puts a pointer to it in the context of the try, under
+   * #TransferMetrics::ContextKey, when the client collects metrics. A transport which doesn't look
+   * for it leaves the metrics null.
+   */
+  struct TransferMetrics final
+  {
+    /**
+     * @brief The context key of the `TransferMetrics*` of the try.
+     *
+     */
+    static Context::Key const ContextKey;
+
+    Azure::Nullable<bool> IsConnectionReused;
+    Azure::Nullable<std::chrono::microseconds> NameLookup;
+    Azure::Nullable<std::chrono::microseconds> Connect;
+    Azure::Nullable<std::chrono::microseconds> TlsHandshake;
+  };
+
+}}}} // namespace Azure::Core::Diagnostics::_detail
@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/diagnostics/tracing.hpp"
+#include "azure/core/internal/diagnostics/span.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+
+using namespace Azure::Core::Diagnostics;
+using Azure::Core::Context;
+using Azure::Core::Diagnostics::_internal::Span;
+
+namespace {
+using SpanExporter = std::function<void(SpanData const& span)>;
+
+constexpr char HexDigits[] = "0123456789abcdef";
+
+// Only serializes the calls to SetExporter().
+std::mutex g_setExporterMutex;
+// Swapped atomically, so ending a span doesn't take a lock shared with the other threads.
+std::shared_ptr<SpanExporter const> g_exporter;
+// The sampling ratio scaled to the range of the random numbers, so sampling is an integer
+// comparison.
+std::atomic<uint64_t> g_samplingThreshold((std::numeric_limits<uint64_t>::max)());
+
+Context::Key const SpanContextKey;
+
+uint64_t NextRandom()
+{
+  thread_local std::mt19937_64 generator(std::random_device{}());
+  return generator();
+}
+
+template <size_t Size> void FillRandom(std::array<uint8_t, Size>& bytes)
+{
+  for (size_t i = 0; i < Size; i += 8)
+  {
+    auto random = NextRandom();
+    for (size_t j = i; j < (std::min)(i + 8, Size); ++j, random >>= 8)
+    {
+      bytes[j] = static_cast<uint8_t>(random);
+    }
+  }
+}
+
+template <size_t Size> bool IsZero(std::array<uint8_t, Size> const& bytes)
+{
+  return std::all_of(bytes.begin(), bytes.end(), [](uint8_t byte) { return byte == 0; });
+}
+
+template <size_t Size> char* WriteHex(std::array<uint8_t, Size> const& bytes, char* output)
+{
+  for (auto byte : bytes)
+  {
+    *output++ = HexDigits[byte >> 4];
+    *output++ = HexDigits[byte & 0x0f];
+  }
+  return output;
+}
+
+int ParseHexDigit(char digit)
+{
+  if (digit >= '0' && digit <= '9')
+  {
+    return digit - '0';
+  }
+  // The trace context only allows lowercase hex digits.
+  if (digit >= 'a' && digit <= 'f')
+  {
+    return digit - 'a' + 10;
+  }
+  return -1;
+}
+
+bool ParseHex(char const* input, size_t size, uint8_t* output)
+{
+  for (size_t i = 0; i < size; ++i)
+  {
+    auto const high = ParseHexDigit(input[2 * i]);
+    auto const low = ParseHexDigit(input[2 * i + 1]);
+    if (high < 0 || low < 0)
+    {
+      return false;
+    }
+    output[i] = static_cast<uint8_t>((high << 4) | low);
+  }
+  return true;
+}
+
+int GetUncaughtExceptions()
+{
+#if defined(__cpp_lib_uncaught_exceptions)
+  return std::uncaught_exceptions();
+#else
+  return std::uncaught_exception() ? 1 : 0;
+#endif
+}
+} // namespace
+
+std::atomic<bool> Span::g_isTracingEnabled(false);
+
+bool SpanContext::IsValid() const { return !IsZero(TraceId) && !IsZero(SpanId); }
+
+std::string SpanContext::ToTraceParent() const
+{
+  // version-traceid-spanid-flags
+  char traceParent[2 + 1 + 32 + 1 + 16 + 1 + 2];
+  auto output = traceParent;
+  *output++ = '0';
+  *output++ = '0';
+  *output++ = '-';
+  output = WriteHex(TraceId, output);
+  *output++ = '-';
+  output = WriteHex(SpanId, output);
+  *output++ = '-';
+  *output++ = '0';
+  *output++ = IsSampled ? '1' : '0';
+  return std::string(traceParent, sizeof(traceParent));
+}
+
+Azure::Nullable<SpanContext> SpanContext::FromTraceParent(std::string const& traceParent)
+{
+  // Later versions may append fields, but start with the same ones.
+  constexpr size_t Size = 55;
+  uint8_t version = 0;
+  uint8_t flags = 0;
+  SpanContext spanContext;
+  if (traceParent.size() < Size || traceParent[2] != '-' || traceParent[35] != '-'
+      || traceParent[52] != '-' || !ParseHex(traceParent.data(), 1, &version) || version == 0xff
+      || (version == 0 && traceParent.size() != Size)
+      || (traceParent.size() > Size && traceParent[Size] != '-')
+      || !ParseHex(traceParent.data() + 3, spanContext.TraceId.size(), spanContext.TraceId.data())
+      || !ParseHex(traceParent.data() + 36, spanContext.SpanId.size(), spanContext.SpanId.data())
+      || !ParseHex(traceParent.data() + 53, 1, &flags) || !spanContext.IsValid())
+  {
+    return Azure::Nullable<SpanContext>();
+  }
+  spanContext.IsSampled = (flags & 0x01) != 0;
+  return spanContext;
+}
+
+void Tracer::SetExporter(std::function<void(SpanData const& span)> exporter)
+{
+  auto newExporter
+      = exporter ? std::make_shared<SpanExporter const>(std::move(exporter)) : nullptr;
+  auto const isEnabled = newExporter != nullptr;
+
+  std::lock_guard<std::mutex> setExporterLock(g_setExporterMutex);
+  std::atomic_store_explicit(&g_exporter, std::move(newExporter), std::memory_order_release);
+  Span::g_isTracingEnabled = isEnabled;
+}
+
+void Tracer::SetSamplingRatio(double ratio)
+{
+  ratio = (std::min)(1.0, (std::max)(0.0, ratio));
+  g_samplingThreshold = ratio >= 1.0
+      ? (std::numeric_limits<uint64_t>::max)()
+      : static_cast<uint64_t>(ratio * static_cast<double>((std::numeric_limits<uint64_t>::max)()));
+}
+
+Context Tracer::WithParent(Context const& context, SpanContext const& parent)
+{
+  return context.WithValue(SpanContextKey, parent);
+}
+
+Azure::Nullable<SpanContext> Tracer::GetSpanContext(Context const& context)
+{
+  SpanContext spanContext;
+  if (!context.TryGetValue(SpanContextKey, spanContext))
+  {
+    return Azure::Nullable<SpanContext>();
+  }
+  return spanContext;
+}
+
+void Span::Start()
+{
+  m_isStarted = true;
+  SpanContext parent;
+  if (m_parentContext.TryGetValue(SpanContextKey, parent))
+  {
+    m_data.Context.TraceId = parent.TraceId;
+    m_data.Context.IsSampled = parent.IsSampled;
+    m_data.ParentSpanId = parent.SpanId;
+  }
+  else
+  {
+    // The root span of a trace decides whether the whole trace is sampled.
+    FillRandom(m_data.Context.TraceId);
+    auto const threshold = g_samplingThreshold.load(std::memory_order_relaxed);
+    m_data.Context.IsSampled
+        = threshold == (std::numeric_limits<uint64_t>::max)() || NextRandom() < threshold;
+  }
+  do
+  {
+    FillRandom(m_data.Context.SpanId);
+  } while (IsZero(m_data.Context.SpanId));
+
+  m_isRecording = m_data.Context.IsSampled;
+  if (m_isRecording)
+  {
+    m_data.StartTime = std::chrono::system_clock::now();
+    m_start = std::chrono::steady_clock::now();
+    m_uncaughtExceptions = GetUncaughtExceptions();
+  }
+}
+
+Context const& Span::CreateContext()
+{
+  // The span context is propagated even when the span isn't sampled, so its children aren't.
+  return m_context.Emplace(m_parentContext.WithValue(SpanContextKey, m_data.Context));
+}
+
+void Span::Export()
+{
+  m_isRecording = false;
+  m_data.Duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - m_start);
+  if (GetUncaughtExceptions() > m_uncaughtExceptions)
+  {
+    m_data.Status = SpanStatus::Error;
+  }
+
+  auto const exporter = std::atomic_load_explicit(&g_exporter, std::memory_order_acquire);
+  if (exporter)
+  {
+    try
+    {
+      (*exporter)(m_data);
+    }
+    catch (...)
+    {
+    }
+  }
+}
@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the Base64 encoding performance.
+ *
+ */
+
+#pragma once
+
+#include <azure/core.hpp>
+#include <azure/perf.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Core { namespace Test {
+
+  /**
+   * @brief Measure encoding a buffer in Base64 and decoding it back.
+   */
+  class Base64Test : public Azure::Perf::PerfTest {
+  private:
+    std::vector<uint8_t> m_data;
+
+  public:
+    /**
+     * @brief Construct a new Base64 test.
+     *
+     * @param options The test options.
+     */
+    Base64Test(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Fill the buffer with the size from the options.
+     *
+     */
+    void Setup() override
+    {
+      m_data.resize(m_options.GetOptionOrDefault<size_t>("Size", 1024));
+      for (size_t i = 0; i < m_data.size(); i++)
+      {
+        m_data[i] = static_cast<uint8_t>(i * 31);
+      }
+    }
+
+    /**
+     * @brief Encode the buffer and decode it back.
+     *
+     */
+    void Run(Azure::Core::Context const&) override
+    {
+      Azure::Core::Convert::Base64Decode(Azure::Core::Convert::Base64Encode(m_data));
+    }
+
+    /**
+     * @brief The bytes encoded by each run.
+     *
+     */
+    int64_t GetBytesPerOperation() override { return static_cast<int64_t>(m_data.size()); }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {{"Size", {"-s", "--size"}, "The number of bytes to encode, 1024 by default.", 1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "Base64Test",
+          "Measures encoding a buffer in Base64 and decoding it back",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Core::Test::Base64Test>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Core::Test
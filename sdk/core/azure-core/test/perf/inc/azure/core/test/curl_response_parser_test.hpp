@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the performance of parsing HTTP responses in the libcurl transport.
+ *
+ */
+
+#pragma once
+
+#include <azure/core.hpp>
+#include <azure/core/http/curl_transport.hpp>
+#include <azure/perf.hpp>
+
+#include <http/curl/curl_connection_private.hpp>
+#include <http/curl/curl_session_private.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Core { namespace Test {
+
+  namespace _detail {
+    /**
+     * @brief A network connection which returns the same HTTP response from memory.
+     *
+     */
+    class InMemoryCurlNetworkConnection final : public Azure::Core::Http::CurlNetworkConnection {
+    private:
+      std::string const& m_response;
+      size_t m_readSize;
+      size_t m_offset = 0;
+      std::string m_connectionKey = "in-memory";
+
+    public:
+      InMemoryCurlNetworkConnection(std::string const& response, size_t readSize)
+          : m_response(response), m_readSize(readSize)
+      {
+      }
+
+      std::string const& GetConnectionKey() const override { return m_connectionKey; }
+
+      void UpdateLastUsageTime() override {}
+
+      bool IsExpired() override { return false; }
+
+      size_t ReadFromSocket(uint8_t* buffer, size_t bufferSize, Azure::Core::Context const&)
+          override
+      {
+        auto const count = (std::min)({bufferSize, m_readSize, m_response.size() - m_offset});
+        std::copy(m_response.data() + m_offset, m_response.data() + m_offset + count, buffer);
+        m_offset += count;
+        return count;
+      }
+
+      CURLcode SendBuffer(uint8_t const*, size_t, Azure::Core::Context const&) override
+      {
+        return CURLE_OK;
+      }
+    };
+  } // namespace _detail
+
+  /**
+   * @brief Measure the time to parse the status line and headers of a response.
+   *
+   * @remark The response is read from memory, so the test measures the parser and not the network.
+   */
+  class CurlResponseParserTest : public Azure::Perf::PerfTest {
+  private:
+    std::string m_response;
+    size_t m_readSize = 0;
+
+  public:
+    /**
+     * @brief Construct a new response parser test.
+     *
+     * @param options The test options.
+     */
+    CurlResponseParserTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Build the response with the number of headers from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const headers = m_options.GetOptionOrDefault<int>("headers", 20);
+      m_readSize = m_options.GetOptionOrDefault<size_t>(
+          "readSize", Azure::Core::Http::_detail::DefaultLibcurlReaderSize);
+
+      m_response = "HTTP/1.1 200 OK\r\n";
+      for (auto count = 0; count < headers; count++)
+      {
+        m_response += "x-ms-header-" + std::to_string(count)
+            + ": 0x8D9C2A1B3E4F5A6, Thu, 13 Jan 2022 21:37:52 GMT\r\n";
+      }
+      m_response += "content-length: 0\r\n\r\n";
+    }
+
+    /**
+     * @brief Send a request and parse the response.
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      Azure::Core::Http::Request request(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("http://localhost"));
+      Azure::Core::Http::CurlSession session(
+          request,
+          std::make_unique<_detail::InMemoryCurlNetworkConnection>(m_response, m_readSize),
+          false);
+      session.Perform(context);
+      session.ExtractResponse();
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"headers", {"-n", "--headers"}, "The number of headers in the response.", 1, false},
+          {"readSize",
+           {"-s", "--readSize"},
+           "The maximum number of bytes returned by each read from the connection.",
+           1,
+           false}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "CurlResponseParserTest",
+          "Measures parsing the status line and headers of an HTTP response",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Core::Test::CurlResponseParserTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Core::Test
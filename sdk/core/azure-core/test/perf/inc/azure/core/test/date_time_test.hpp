@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the DateTime parsing and formatting performance.
+ *
+ */
+
+#pragma once
+
+#include <azure/core.hpp>
+#include <azure/perf.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace Azure { namespace Core { namespace Test {
+
+  /**
+   * @brief Measure parsing a date and time, as in the headers and bodies of the responses, and
+   * formatting it back.
+   */
+  class DateTimeTest : public Azure::Perf::PerfTest {
+  private:
+    Azure::DateTime::DateFormat m_format = Azure::DateTime::DateFormat::Rfc1123;
+    std::string m_value;
+
+  public:
+    /**
+     * @brief Construct a new DateTime test.
+     *
+     * @param options The test options.
+     */
+    DateTimeTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Define the value to parse, in the format from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const format = m_options.GetOptionOrDefault<std::string>("Format", "rfc1123");
+      if (format == "rfc1123")
+      {
+        m_format = Azure::DateTime::DateFormat::Rfc1123;
+        m_value = "Thu, 13 Jan 2022 21:37:52 GMT";
+      }
+      else if (format == "rfc3339")
+      {
+        m_format = Azure::DateTime::DateFormat::Rfc3339;
+        m_value = "2022-01-13T21:37:52.1234567Z";
+      }
+      else
+      {
+        throw std::invalid_argument("The format must be rfc1123 or rfc3339.");
+      }
+    }
+
+    /**
+     * @brief Parse the value and format it back.
+     *
+     */
+    void Run(Azure::Core::Context const&) override
+    {
+      Azure::DateTime::Parse(m_value, m_format).ToString(m_format);
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Format",
+           {"-f", "--format"},
+           "The format of the value, rfc1123 (by default) or rfc3339.",
+           1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "DateTimeTest",
+          "Measures parsing a date and time and formatting it back",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Core::Test::DateTimeTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Core::Test
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the MD5 hash performance.
+ *
+ */
+
+#pragma once
+
+#include <azure/core.hpp>
+#include <azure/perf.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Azure { namespace Core { namespace Test {
+
+  /**
+   * @brief Measure hashing a buffer with MD5, appended in blocks of a given size.
+   */
+  class Md5Test : public Azure::Perf::PerfTest {
+  private:
+    std::vector<uint8_t> m_data;
+    size_t m_blockSize = 0;
+
+  public:
+    /**
+     * @brief Construct a new MD5 test.
+     *
+     * @param options The test options.
+     */
+    Md5Test(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Fill the buffer with the size from the options.
+     *
+     */
+    void Setup() override
+    {
+      m_data.resize(m_options.GetOptionOrDefault<size_t>("Size", 4 * 1024 * 1024));
+      m_blockSize = m_options.GetOptionOrDefault<size_t>("BlockSize", m_data.size());
+      for (size_t i = 0; i < m_data.size(); i++)
+      {
+        m_data[i] = static_cast<uint8_t>(i * 31);
+      }
+    }
+
+    /**
+     * @brief Hash the buffer.
+     *
+     */
+    void Run(Azure::Core::Context const&) override
+    {
+      Azure::Core::Cryptography::Md5Hash hash;
+      for (size_t offset = 0; offset < m_data.size(); offset += m_blockSize)
+      {
+        hash.Append(m_data.data() + offset, (std::min)(m_blockSize, m_data.size() - offset));
+      }
+      hash.Final();
+    }
+
+    /**
+     * @brief The bytes hashed by each run.
+     *
+     */
+    int64_t GetBytesPerOperation() override { return static_cast<int64_t>(m_data.size()); }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Size", {"-s", "--size"}, "The number of bytes to hash, 4 MiB by default.", 1},
+          {"BlockSize",
+           {"-b", "--blockSize"},
+           "The number of bytes appended to the hash at a time, the whole buffer by default.",
+           1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "Md5Test",
+          "Measures hashing a buffer with MD5",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Core::Test::Md5Test>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Core::Test
@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the performance of sending a request through the HTTP pipeline policies.
+ *
+ */
+
+#pragma once
+
+#include <azure/core.hpp>
+#include <azure/core/internal/client_options.hpp>
+#include <azure/core/internal/http/pipeline.hpp>
+#include <azure/perf.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Core { namespace Test {
+
+  /**
+   * @brief Measure sending a request through the default policies of the pipeline, and reading
+   * the response body.
+   *
+   * @remark The response comes from a #Azure::Perf::CannedResponseTransport, so the test measures
+   * the policies and the body streaming and not the network.
+   */
+  class PipelineTest : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    std::vector<uint8_t> m_buffer;
+    bool m_bufferResponse = false;
+
+  public:
+    /**
+     * @brief Construct a new pipeline test.
+     *
+     * @param options The test options.
+     */
+    PipelineTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the pipeline with a response of the size and number of headers from the
+     * options.
+     *
+     */
+    void Setup() override
+    {
+      auto const size = m_options.GetOptionOrDefault<size_t>("Size", 1024);
+      auto const headers = m_options.GetOptionOrDefault<int>("Headers", 20);
+      m_bufferResponse = m_options.GetOptionOrDefault<bool>("Buffer", false);
+
+      Azure::Perf::CannedResponse response;
+      for (auto count = 0; count < headers; count++)
+      {
+        response.Headers.emplace_back(
+            "x-ms-header-" + std::to_string(count),
+            "0x8D9C2A1B3E4F5A6, Thu, 13 Jan 2022 21:37:52 GMT");
+      }
+      response.Body.resize(size);
+      m_buffer.resize(64 * 1024);
+
+      Azure::Core::_internal::ClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_pipeline = std::make_unique<Azure::Core::Http::_internal::HttpPipeline>(
+          options,
+          "perfTest",
+          "x.x",
+          std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>(),
+          std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>());
+    }
+
+    /**
+     * @brief Send a request and read the response body.
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      Azure::Core::Http::Request request(
+          Azure::Core::Http::HttpMethod::Get,
+          Azure::Core::Url("https://account.test/container/blob"),
+          m_bufferResponse);
+      auto response = m_pipeline->Send(request, context);
+      if (!m_bufferResponse)
+      {
+        auto bodyStream = response->ExtractBodyStream();
+        while (bodyStream->Read(m_buffer.data(), m_buffer.size(), context) != 0)
+        {
+        }
+      }
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Size", {"--size"}, "The size of the response body (in bytes).", 1, false},
+          {"Headers", {"-n", "--headers"}, "The number of headers in the response.", 1, false},
+          {"Buffer",
+           {"--buffer"},
+           "Whether the transport policy buffers the response body.",
+           1,
+           false}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "PipelineTest",
+          "Measures sending a request through the pipeline policies, without the network",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Core::Test::PipelineTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Core::Test
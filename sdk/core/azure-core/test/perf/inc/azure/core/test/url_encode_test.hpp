@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the Url encoding performance.
+ *
+ */
+
+#pragma once
+
+#include <azure/core.hpp>
+#include <azure/perf.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Core { namespace Test {
+
+  /**
+   * @brief Measure the performance of encoding and decoding URL components.
+   */
+  class UrlEncodeTest : public Azure::Perf::PerfTest {
+  private:
+    std::string m_value;
+
+  public:
+    /**
+     * @brief Construct a new Url encoding test.
+     *
+     * @param options The test options.
+     */
+    UrlEncodeTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Define the value to encode, with the number of chars to escape from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const escaped = m_options.GetOptionOrDefault<int>("escaped", 0);
+      m_value = "folder/sub-folder/blob_name.0123456789.txt";
+      for (auto count = 0; count < escaped; count++)
+      {
+        m_value += " #";
+      }
+    }
+
+    /**
+     * @brief Encode the value and decode it back.
+     *
+     */
+    void Run(Azure::Core::Context const&) override
+    {
+      auto const total = m_options.GetMandatoryOption<int>("count");
+      for (auto count = 0; count < total; count++)
+      {
+        Azure::Core::Url::Decode(Azure::Core::Url::Encode(m_value, "/"));
+      }
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"count", {"-c"}, "The number of values to be encoded and decoded.", 1, true},
+          {"escaped", {"-e"}, "The number of pairs of chars to escape in the value.", 1, false}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "UrlEncodeTest",
+          "Measures the overhead of encoding and decoding URL components",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Core::Test::UrlEncodeTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Core::Test
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the Url parsing performance.
+ *
+ */
+
+#pragma once
+
+#include <azure/core.hpp>
+#include <azure/perf.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Core { namespace Test {
+
+  /**
+   * @brief Measure parsing a URL and building it back, as for every request of a client.
+   */
+  class UrlParseTest : public Azure::Perf::PerfTest {
+  private:
+    std::string m_value;
+
+  public:
+    /**
+     * @brief Construct a new Url parsing test.
+     *
+     * @param options The test options.
+     */
+    UrlParseTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Define the URL to parse, with the number of query parameters from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const parameters = m_options.GetOptionOrDefault<int>("parameters", 4);
+      m_value = "https://account.blob.core.windows.net/container/folder/blob%20name.txt";
+      for (auto count = 0; count < parameters; count++)
+      {
+        m_value += (count == 0 ? "?" : "&");
+        m_value += "parameter" + std::to_string(count) + "=value%2F" + std::to_string(count);
+      }
+    }
+
+    /**
+     * @brief Parse the URL and build it back.
+     *
+     */
+    void Run(Azure::Core::Context const&) override
+    {
+      Azure::Core::Url(m_value).GetAbsoluteUrl();
+    }
+
+    /**
+     * @brief The bytes of URL parsed by each run.
+     *
+     */
+    int64_t GetBytesPerOperation() override { return static_cast<int64_t>(m_value.size()); }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"parameters",
+           {"--parameters"},
+           "The number of query parameters of the URL, 4 by default.",
+           1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "UrlParseTest",
+          "Measures parsing a URL and building it back",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Core::Test::UrlParseTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Core::Test
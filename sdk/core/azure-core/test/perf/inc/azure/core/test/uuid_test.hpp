@@ -12,6 +12,7 @@
 #include <azure/core.hpp>
 #include <azure/perf.hpp>
 
+#include <algorithm>
 #include <memory>
 
 namespace Azure { namespace Core { namespace Test {
@@ -29,12 +30,22 @@ namespace Azure { namespace Core { namespace Test {
     UuidTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
 
     /**
-     * @brief Use Uuid to assign and read.
+     * @brief Use Uuid to assign and read, one at a time or in batches.
      *
      */
     void Run(Azure::Core::Context const&) override
     {
       auto const total = m_options.GetMandatoryOption<int>("count");
+      auto const batch = m_options.GetOptionOrDefault<int>("batch", 0);
+      if (batch > 0)
+      {
+        for (auto count = 0; count < total; count += batch)
+        {
+          Azure::Core::Uuid::CreateUuids(static_cast<size_t>((std::min)(batch, total - count)));
+        }
+        return;
+      }
+
       for (auto count = 0; count < total; count++)
       {
         Azure::Core::Uuid::CreateUuid();
@@ -48,7 +59,14 @@ namespace Azure { namespace Core { namespace Test {
      */
     std::vector<Azure::Perf::TestOption> GetTestOptions() override
     {
-      return {{"count", {"-c"}, "The number of uuid objects to be created.", 1, true}};
+      return {
+          {"count", {"-c"}, "The number of uuid objects to be created.", 1, true},
+          {"batch",
+           {"-b"},
+           "The number of uuid objects created by each call to CreateUuids, or 0 to call "
+           "CreateUuid for each of them.",
+           1,
+           false}};
     }
 
     /**
@@ -3,7 +3,16 @@
 
 #include <azure/perf.hpp>
 
+#include "azure/core/test/base64_test.hpp"
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+#include "azure/core/test/curl_response_parser_test.hpp"
+#endif
+#include "azure/core/test/date_time_test.hpp"
+#include "azure/core/test/md5_test.hpp"
 #include "azure/core/test/nullable_test.hpp"
+#include "azure/core/test/pipeline_test.hpp"
+#include "azure/core/test/url_encode_test.hpp"
+#include "azure/core/test/url_parse_test.hpp"
 #include "azure/core/test/uuid_test.hpp"
 
 #include <vector>
@@ -13,8 +22,17 @@ int main(int argc, char** argv)
 
   // Create the test list
   std::vector<Azure::Perf::TestMetadata> tests{
+      Azure::Core::Test::Base64Test::GetTestMetadata(),
+      Azure::Core::Test::DateTimeTest::GetTestMetadata(),
+      Azure::Core::Test::Md5Test::GetTestMetadata(),
       Azure::Core::Test::NullableTest::GetTestMetadata(),
+      Azure::Core::Test::PipelineTest::GetTestMetadata(),
+      Azure::Core::Test::UrlEncodeTest::GetTestMetadata(),
+      Azure::Core::Test::UrlParseTest::GetTestMetadata(),
       Azure::Core::Test::UuidTest::GetTestMetadata()};
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+  tests.emplace_back(Azure::Core::Test::CurlResponseParserTest::GetTestMetadata());
+#endif
 
   Azure::Perf::Program::Run(Azure::Core::Context::ApplicationContext, tests, argc, argv);
 
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/diagnostics/async_log_listener.hpp>
+#include <azure/core/internal/diagnostics/log.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Azure::Core::Diagnostics::AsyncLogListener;
+using Azure::Core::Diagnostics::AsyncLogListenerOptions;
+using Azure::Core::Diagnostics::AsyncLogOverflowPolicy;
+using Azure::Core::Diagnostics::Logger;
+using Azure::Core::Diagnostics::_internal::Log;
+
+TEST(AsyncLogListener, InOrderFromBackgroundThread)
+{
+  std::vector<std::string> messages;
+  std::thread::id listenerThread;
+  AsyncLogListener asyncListener([&](Logger::Level level, std::string const& message) {
+    EXPECT_EQ(level, Logger::Level::Warning);
+    listenerThread = std::this_thread::get_id();
+    messages.push_back(message);
+  });
+
+  auto const listener = asyncListener.GetListener();
+  for (auto i = 0; i < 100; ++i)
+  {
+    listener(Logger::Level::Warning, std::to_string(i));
+  }
+  asyncListener.Flush();
+
+  ASSERT_EQ(messages.size(), 100U);
+  for (auto i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(messages[i], std::to_string(i));
+  }
+  EXPECT_NE(listenerThread, std::this_thread::get_id());
+  EXPECT_EQ(asyncListener.GetDroppedMessageCount(), 0);
+}
+
+TEST(AsyncLogListener, UsedByLogger)
+{
+  std::atomic<int> count(0);
+  {
+    AsyncLogListener asyncListener([&](Logger::Level, std::string const&) { ++count; });
+    Logger::SetListener(asyncListener.GetListener());
+    Logger::SetLevel(Logger::Level::Verbose);
+
+    std::vector<std::thread> writers;
+    for (auto i = 0; i < 4; ++i)
+    {
+      writers.emplace_back([]() {
+        for (auto j = 0; j < 1000; ++j)
+        {
+          Log::Write(Logger::Level::Verbose, "Verbose");
+        }
+      });
+    }
+    for (auto& writer : writers)
+    {
+      writer.join();
+    }
+
+    Logger::SetListener(nullptr);
+    Logger::SetLevel(Logger::Level::Warning);
+
+    asyncListener.Flush();
+    EXPECT_EQ(count, 4000);
+    EXPECT_EQ(asyncListener.GetDroppedMessageCount(), 0);
+
+    Log::Write(Logger::Level::Error, "Error");
+    asyncListener.GetListener()(Logger::Level::Error, "Error");
+  }
+
+  // The destructor passes the queued messages to the listener.
+  EXPECT_EQ(count, 4001);
+}
+
+TEST(AsyncLogListener, DropWhenFull)
+{
+  std::mutex blockListener;
+  std::unique_lock<std::mutex> blockListenerLock(blockListener);
+  std::atomic<int> count(0);
+
+  AsyncLogListenerOptions options;
+  options.QueueCapacity = 4;
+  AsyncLogListener asyncListener(
+      [&](Logger::Level, std::string const&) {
+        std::lock_guard<std::mutex> lock(blockListener);
+        ++count;
+      },
+      options);
+
+  auto const listener = asyncListener.GetListener();
+  for (auto i = 0; i < 10; ++i)
+  {
+    listener(Logger::Level::Warning, "Warning");
+  }
+
+  // The listener blocks the background thread on one of the messages, the other ones are either
+  // queued or dropped.
+  auto const dropped = asyncListener.GetDroppedMessageCount();
+  EXPECT_GE(dropped, 10 - 5);
+
+  blockListenerLock.unlock();
+  asyncListener.Flush();
+  EXPECT_EQ(count + dropped, 10);
+}
+
+TEST(AsyncLogListener, BlockWhenFull)
+{
+  std::atomic<int> count(0);
+
+  AsyncLogListenerOptions options;
+  options.QueueCapacity = 4;
+  options.OverflowPolicy = AsyncLogOverflowPolicy::Block;
+  AsyncLogListener asyncListener(
+      [&](Logger::Level, std::string const&) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++count;
+      },
+      options);
+
+  auto const listener = asyncListener.GetListener();
+  for (auto i = 0; i < 100; ++i)
+  {
+    listener(Logger::Level::Warning, "Warning");
+  }
+  asyncListener.Flush();
+
+  EXPECT_EQ(count, 100);
+  EXPECT_EQ(asyncListener.GetDroppedMessageCount(), 0);
+}
+
+TEST(AsyncLogListener, RateLimit)
+{
+  std::atomic<int> count(0);
+
+  AsyncLogListenerOptions options;
+  options.MaxMessagesPerSecond = 10;
+  AsyncLogListener asyncListener([&](Logger::Level, std::string const&) { ++count; }, options);
+
+  auto const listener = asyncListener.GetListener();
+  for (auto i = 0; i < 100; ++i)
+  {
+    listener(Logger::Level::Warning, "Warning");
+  }
+  asyncListener.Flush();
+
+  // The messages may have been written over two different seconds.
+  EXPECT_GE(count, 10);
+  EXPECT_LE(count, 20);
+  EXPECT_EQ(count + asyncListener.GetDroppedMessageCount(), 100);
+}
+
+TEST(AsyncLogListener, ListenerExceptionsIgnored)
+{
+  std::atomic<int> count(0);
+  AsyncLogListener asyncListener([&](Logger::Level, std::string const&) {
+    ++count;
+    throw std::runtime_error("Listener error");
+  });
+
+  auto const listener = asyncListener.GetListener();
+  listener(Logger::Level::Warning, "Warning");
+  listener(Logger::Level::Warning, "Warning");
+  asyncListener.Flush();
+
+  EXPECT_EQ(count, 2);
+}
@@ -49,8 +49,7 @@ namespace Azure { namespace Core { namespace Test {
     }
     // Check that after the connection is gone, it is moved back to the pool
     EXPECT_EQ(
-        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-            .size(),
+        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
         1);
   }
 }}} // namespace Azure::Core::Test
@@ -3,6 +3,7 @@
 
 #include <azure/core/base64.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <random>
 #include <string>
 #include <vector>
@@ -125,3 +126,73 @@ TEST(Base64, Roundtrip)
     EXPECT_EQ(Convert::Base64Decode(Convert::Base64Encode(data)), data);
   }
 }
+
+TEST(Base64, LongText)
+{
+  // Long enough to be encoded and decoded in blocks, with every possible remainder.
+  std::string text;
+  std::vector<uint8_t> data;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    data.push_back(static_cast<uint8_t>(i * 0x4B));
+    text = Convert::Base64Encode(data);
+    ASSERT_EQ(text.size(), _internal::Base64::EncodedLength(data.size()));
+    EXPECT_EQ(Convert::Base64Decode(text), data);
+
+    std::vector<uint8_t> decoded(_internal::Base64::DecodedLength(text.data(), text.size()));
+    EXPECT_EQ(_internal::Base64::Decode(text.data(), text.size(), decoded.data()), data.size());
+    EXPECT_EQ(decoded, data);
+  }
+  EXPECT_EQ(
+      text.substr(0, 44),
+      "AEuW4Sx3wg1Yo+45hM8aZbD7RpHcJ3K9CFOe6TR/yhVg"); // cspell:disable-line
+
+  // Characters which are not in the alphabet are not rejected.
+  for (char c : {'=', '-', '\0', '\x80', '\xFF'})
+  {
+    std::string invalid = text;
+    invalid[100] = c;
+    EXPECT_EQ(Convert::Base64Decode(invalid).size(), data.size());
+  }
+}
+
+TEST(Base64, EncodeToBuffer)
+{
+  std::vector<uint8_t> const data = {0xFB, 0xFF, 0xBF, 0x01};
+  std::string text(_internal::Base64::EncodedLength(data.size()) + 1, '#');
+  _internal::Base64::Encode(data.data(), data.size(), &text[0]);
+  EXPECT_EQ(text, "+/+/AQ==#");
+
+  std::vector<uint8_t> decoded(3, 0);
+  EXPECT_EQ(_internal::Base64::Decode("+/+/AQ==", 6, decoded.data()), size_t(3));
+  EXPECT_EQ(decoded, std::vector<uint8_t>({0xFB, 0xFF, 0xBF}));
+  EXPECT_EQ(_internal::Base64::DecodedLength("+/+/AQ==", 8), size_t(4));
+  EXPECT_EQ(_internal::Base64::DecodedLength("+/+/AQ", 6), size_t(3));
+  EXPECT_EQ(_internal::Base64::DecodedLength("+/+", 3), size_t(0));
+}
+
+TEST(Base64, Base64Url)
+{
+  std::vector<uint8_t> data;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    data.push_back(static_cast<uint8_t>(0xFF - i * 0x4B));
+    std::string base64 = Convert::Base64Encode(data);
+    base64.erase(base64.find_last_not_of('=') + 1);
+    std::replace(base64.begin(), base64.end(), '+', '-');
+    std::replace(base64.begin(), base64.end(), '/', '_');
+
+    std::string const base64url = _internal::Base64Url::Base64UrlEncode(data);
+    ASSERT_EQ(base64url, base64);
+    EXPECT_EQ(base64url.size(), _internal::Base64Url::EncodedLength(data.size()));
+    EXPECT_EQ(_internal::Base64Url::Base64UrlDecode(base64url), data);
+  }
+
+  EXPECT_EQ(_internal::Base64Url::Base64UrlEncode({0xFB, 0xFF, 0xBF, 0x01}), "-_-_AQ");
+  // Padding and the standard alphabet are accepted.
+  EXPECT_EQ(
+      _internal::Base64Url::Base64UrlDecode("-_+/AQ=="),
+      std::vector<uint8_t>({0xFB, 0xFF, 0xBF, 0x01}));
+  EXPECT_THROW(_internal::Base64Url::Base64UrlDecode("-_-_A"), std::invalid_argument);
+  EXPECT_THROW(_internal::Base64Url::DecodedLength("A", 1), std::invalid_argument);
+}
@@ -6,6 +6,10 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace {
 class TestTokenCredential final : public Azure::Core::Credentials::TokenCredential {
 private:
@@ -26,6 +30,42 @@ public:
   }
 };
 
+// Counts the calls to GetToken(), and can be updated while tokens are got from other threads.
+class CountingTokenCredential final : public Azure::Core::Credentials::TokenCredential {
+private:
+  mutable std::mutex m_mutex;
+  Azure::Core::Credentials::AccessToken m_accessToken;
+  mutable std::atomic<int> m_calls{0};
+
+public:
+  void SetToken(Azure::Core::Credentials::AccessToken accessToken)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_accessToken = std::move(accessToken);
+  }
+
+  int GetCalls() const { return m_calls; }
+
+  Azure::Core::Credentials::AccessToken GetToken(
+      Azure::Core::Credentials::TokenRequestContext const&,
+      Azure::Core::Context const&) const override
+  {
+    ++m_calls;
+    // Gives the concurrent requests time to wait for this call.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_accessToken;
+  }
+};
+
+std::string GetAuthorizationHeader(Azure::Core::Http::_internal::HttpPipeline const& pipeline)
+{
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  pipeline.Send(request, Azure::Core::Context());
+  return request.GetHeaders().at("authorization");
+}
+
 class TestTransportPolicy final : public Azure::Core::Http::Policies::HttpPolicy {
 public:
   std::unique_ptr<Azure::Core::Http::RawResponse> Send(
@@ -202,3 +242,74 @@ TEST(BearerTokenAuthenticationPolicy, RefreshAfterExpiry)
     }
   }
 }
+
+TEST(BearerTokenAuthenticationPolicy, SharedBetweenPolicies)
+{
+  using namespace std::chrono_literals;
+  auto credential = std::make_shared<CountingTokenCredential>();
+  credential->SetToken({"ACCESSTOKEN1", std::chrono::system_clock::now() + 1h});
+
+  auto const createPipeline = [&credential](std::string const& scope) {
+    std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> policies;
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
+            credential, Azure::Core::Credentials::TokenRequestContext{{scope}}));
+    policies.emplace_back(std::make_unique<TestTransportPolicy>());
+    return Azure::Core::Http::_internal::HttpPipeline(policies);
+  };
+  auto const pipeline1 = createPipeline("https://microsoft.com/.default");
+  auto const pipeline2 = createPipeline("https://microsoft.com/.default");
+  auto const otherScopePipeline = createPipeline("https://azure.com/.default");
+
+  // The concurrent requests with no token wait for a single call to the credential.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&]() {
+      EXPECT_EQ(GetAuthorizationHeader(pipeline1), "Bearer ACCESSTOKEN1");
+      EXPECT_EQ(GetAuthorizationHeader(pipeline2), "Bearer ACCESSTOKEN1");
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_EQ(credential->GetCalls(), 1);
+
+  EXPECT_EQ(GetAuthorizationHeader(otherScopePipeline), "Bearer ACCESSTOKEN1");
+  EXPECT_EQ(credential->GetCalls(), 2);
+}
+
+TEST(BearerTokenAuthenticationPolicy, BackgroundRefresh)
+{
+  using namespace std::chrono_literals;
+  auto credential = std::make_shared<CountingTokenCredential>();
+
+  std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> policies;
+  policies.emplace_back(
+      std::make_unique<Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
+          credential,
+          Azure::Core::Credentials::TokenRequestContext{{"https://microsoft.com/.default"}}));
+  policies.emplace_back(std::make_unique<TestTransportPolicy>());
+  Azure::Core::Http::_internal::HttpPipeline pipeline(policies);
+
+  credential->SetToken({"ACCESSTOKEN1", std::chrono::system_clock::now() + 150s});
+  EXPECT_EQ(GetAuthorizationHeader(pipeline), "Bearer ACCESSTOKEN1");
+
+  // The token expires soon, it is still used while a new one is got in the background.
+  credential->SetToken({"ACCESSTOKEN2", std::chrono::system_clock::now() + 1h});
+  EXPECT_EQ(GetAuthorizationHeader(pipeline), "Bearer ACCESSTOKEN1");
+
+  for (int i = 0; i < 100 && credential->GetCalls() < 2; ++i)
+  {
+    std::this_thread::sleep_for(10ms);
+  }
+  std::string header;
+  for (int i = 0; i < 100 && (header = GetAuthorizationHeader(pipeline)) != "Bearer ACCESSTOKEN2";
+       ++i)
+  {
+    std::this_thread::sleep_for(10ms);
+  }
+  EXPECT_EQ(header, "Bearer ACCESSTOKEN2");
+  EXPECT_EQ(credential->GetCalls(), 2);
+}
@@ -3,7 +3,13 @@
 
 #include <azure/core/platform.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #if defined(AZ_PLATFORM_POSIX)
 #include <fcntl.h>
@@ -72,6 +78,185 @@ TEST(BodyStream, BadInput)
 
 TEST(MemoryBodyStream, BadInput) { ASSERT_DEATH(MemoryBodyStream(NULL, 1), ""); }
 
+TEST(MemoryBodyStream, ReadContiguous)
+{
+  std::vector<uint8_t> data = {1, 2, 3, 4, 5};
+  MemoryBodyStream ms(data);
+  EXPECT_TRUE(ms.SupportsContiguousRead());
+
+  uint8_t const* read = nullptr;
+  EXPECT_EQ(ms.ReadContiguous(&read, 3), 3);
+  EXPECT_EQ(read, data.data());
+  EXPECT_EQ(ms.ReadContiguous(&read, 3), 2);
+  EXPECT_EQ(read, data.data() + 3);
+  EXPECT_EQ(ms.ReadContiguous(&read, 3), 0);
+
+  ms.Rewind();
+  EXPECT_EQ(ms.ReadContiguous(&read, data.size()), data.size());
+  EXPECT_EQ(read, data.data());
+}
+
+TEST(BodyStream, ReadContiguousNotSupported)
+{
+  TestBodyStream tb;
+  EXPECT_FALSE(tb.SupportsContiguousRead());
+
+  uint8_t const* read = nullptr;
+  ASSERT_DEATH(tb.ReadContiguous(nullptr, 1), "");
+#if defined(NDEBUG)
+  // Release build won't provide assert msg
+  ASSERT_DEATH(tb.ReadContiguous(&read, 1), "");
+#else
+  ASSERT_DEATH(
+      tb.ReadContiguous(&read, 1),
+      "The specified BodyStream doesn't support reading from contiguous memory.");
+#endif
+}
+
+namespace {
+// Returns its data a few bytes at a time, with a length which may not be the one of the data.
+class ChunkedBodyStream final : public BodyStream {
+  std::vector<uint8_t> m_data;
+  int64_t m_length;
+  size_t m_offset = 0;
+
+  size_t OnRead(uint8_t* buffer, size_t count, Context const&) override
+  {
+    auto const readBytes = (std::min)({count, size_t(1000), m_data.size() - m_offset});
+    std::copy_n(m_data.begin() + m_offset, readBytes, buffer);
+    m_offset += readBytes;
+    return readBytes;
+  }
+
+public:
+  ChunkedBodyStream(std::vector<uint8_t> data, int64_t length)
+      : m_data(std::move(data)), m_length(length)
+  {
+  }
+
+  int64_t Length() const override { return m_length; }
+};
+
+std::vector<uint8_t> CreateData(size_t size)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  return data;
+}
+} // namespace
+
+TEST(BodyStream, ReadToEnd)
+{
+  auto const data = CreateData(100000);
+
+  {
+    // The buffer is allocated once from the length.
+    ChunkedBodyStream stream(data, static_cast<int64_t>(data.size()));
+    auto const read = stream.ReadToEnd();
+    EXPECT_EQ(read, data);
+    EXPECT_EQ(read.capacity(), data.size());
+  }
+
+  // Unknown, shorter and longer lengths.
+  for (int64_t const length : {int64_t(-1), int64_t(10), int64_t(8192), int64_t(200000)})
+  {
+    ChunkedBodyStream stream(data, length);
+    EXPECT_EQ(stream.ReadToEnd(), data);
+  }
+
+  {
+    ChunkedBodyStream stream({}, 0);
+    EXPECT_TRUE(stream.ReadToEnd().empty());
+  }
+
+  {
+    MemoryBodyStream stream(data);
+    auto const read = stream.ReadToEnd();
+    EXPECT_EQ(read, data);
+    EXPECT_EQ(read.capacity(), data.size());
+  }
+}
+
+TEST(BodyStream, ReadV)
+{
+  auto const data = CreateData(10);
+  MemoryBodyStream stream(data);
+
+  uint8_t first[4] = {};
+  uint8_t second[3] = {};
+  uint8_t third[8] = {};
+  ReadBuffer const buffers[] = {{first, sizeof(first)}, {second, sizeof(second)}, {third, 8}};
+
+  // The buffers are filled in order, until the end of the stream.
+  EXPECT_EQ(stream.ReadV(buffers, 3), 10U);
+  EXPECT_TRUE(std::equal(first, first + 4, data.begin()));
+  EXPECT_TRUE(std::equal(second, second + 3, data.begin() + 4));
+  EXPECT_TRUE(std::equal(third, third + 3, data.begin() + 7));
+  EXPECT_EQ(stream.ReadV(buffers, 3), 0U);
+
+  // A wrapping stream forwards the buffers at once.
+  stream.Rewind();
+  int32_t callbacks = 0;
+  ProgressBodyStream progress(stream, [&callbacks](int64_t bytesTransferred) {
+    ++callbacks;
+    EXPECT_EQ(bytesTransferred, 7);
+  });
+  EXPECT_EQ(progress.ReadV(buffers, 2), 7U);
+  EXPECT_EQ(callbacks, 1);
+}
+
+TEST(MemoryBodyStream, SharedOwnership)
+{
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(CreateData(100));
+  auto const data = *buffer;
+  MemoryBodyStream stream(buffer);
+  auto slice = stream.Slice(10, 20);
+  auto sliceOfSlice = slice.Slice(5, 10);
+
+  // The streams keep the data alive, without copying it.
+  auto const* const bufferData = buffer->data();
+  buffer.reset();
+  uint8_t const* read = nullptr;
+  EXPECT_EQ(slice.ReadContiguous(&read, 100), 20U);
+  EXPECT_EQ(read, bufferData + 10);
+
+  EXPECT_EQ(stream.ReadToEnd(), data);
+  EXPECT_EQ(sliceOfSlice.Length(), 10);
+  EXPECT_EQ(
+      sliceOfSlice.ReadToEnd(), std::vector<uint8_t>(data.begin() + 15, data.begin() + 25));
+
+  std::shared_ptr<const uint8_t> array(new uint8_t[3]{1, 2, 3}, std::default_delete<uint8_t[]>());
+  MemoryBodyStream arrayStream(std::move(array), 3);
+  EXPECT_EQ(arrayStream.Slice(1, 2).ReadToEnd(), std::vector<uint8_t>({2, 3}));
+}
+
+TEST(RewindableBodyStream, Rewind)
+{
+  auto const data = CreateData(10000);
+
+  // Kept in memory only, or spilling to a temporary file.
+  for (size_t const maxMemoryBufferSize : {size_t(20000), size_t(2500), size_t(0)})
+  {
+    ChunkedBodyStream forwardOnly(data, static_cast<int64_t>(data.size()));
+    RewindableBodyStream stream(forwardOnly, maxMemoryBufferSize);
+    EXPECT_EQ(stream.Length(), 10000);
+
+    // Rewinds in the middle of the kept data, then after reading all of it.
+    std::vector<uint8_t> buffer(4321);
+    EXPECT_EQ(stream.ReadToCount(buffer.data(), buffer.size()), buffer.size());
+    EXPECT_EQ(buffer, std::vector<uint8_t>(data.begin(), data.begin() + 4321));
+    stream.Rewind();
+    EXPECT_EQ(stream.ReadToCount(buffer.data(), 1234), 1234U);
+    stream.Rewind();
+    EXPECT_EQ(stream.ReadToEnd(), data);
+    stream.Rewind();
+    EXPECT_EQ(stream.ReadToEnd(), data);
+  }
+}
+
 TEST(FileBodyStream, BadInput)
 {
 #if defined(NDEBUG)
@@ -146,6 +331,32 @@ TEST(FileBodyStream, Read)
   EXPECT_EQ(buffer[FileSize], 0);
 }
 
+TEST(FileBodyStream, ReadAhead)
+{
+  // Read in small parts across several read-ahead windows.
+  auto const data = CreateData(10 * 1024 * 1024 + 123);
+  std::string const fileName = "file_body_stream_read_ahead_test";
+  {
+    std::ofstream file(fileName, std::ios::binary);
+    file.write(reinterpret_cast<char const*>(data.data()), data.size());
+  }
+  {
+    FileBodyStream stream(fileName);
+    std::vector<uint8_t> read(data.size());
+    size_t offset = 0;
+    while (size_t const readBytes
+           = stream.Read(read.data() + offset, (std::min)(size_t(100000), read.size() - offset)))
+    {
+      offset += readBytes;
+    }
+    EXPECT_EQ(offset, data.size());
+    EXPECT_EQ(read, data);
+    stream.Rewind();
+    EXPECT_EQ(stream.ReadToEnd(), data);
+  }
+  std::remove(fileName.c_str());
+}
+
 TEST(ProgressBodyStream, Init)
 {
   int64_t bytesTransferred = -1;
@@ -31,3 +31,20 @@ TEST(CaseInsensitiveMap, Modify)
   EXPECT_EQ(pos->second, "Y");
   EXPECT_EQ(pos->first, "Content-Length");
 }
+
+TEST(CaseInsensitiveMap, FindCString)
+{
+  CaseInsensitiveMap imap;
+
+  imap["X-Ms-Request-Server-Encrypted"] = "true";
+  imap["x-ms-version"] = "2020-02-10";
+
+  char const* name = "x-ms-request-server-encrypted";
+  auto pos = imap.find(name);
+  EXPECT_NE(pos, imap.end());
+  EXPECT_EQ(pos->second, "true");
+  EXPECT_EQ(imap.count("X-MS-VERSION"), size_t(1));
+  EXPECT_EQ(imap.find("x-ms-versio"), imap.end());
+  EXPECT_EQ(imap.find("x-ms-versions"), imap.end());
+  EXPECT_EQ(imap.lower_bound("X-MS-"), imap.find("x-ms-request-server-encrypted"));
+}
@@ -69,6 +69,7 @@ TEST(ClientOptions, copyWithOperator)
   // client Options defines its own copy constructor which clones policies
   ClientOptions options;
   options.Retry.MaxRetries = 1;
+  options.Hedging.Enabled = true;
   options.Telemetry.ApplicationId = "pleaseCopyMe";
   options.Transport.Transport = std::make_shared<FakeTransport>();
   options.PerOperationPolicies.emplace_back(std::make_unique<PerCallPolicy>());
@@ -79,6 +80,7 @@ TEST(ClientOptions, copyWithOperator)
 
   // Compare
   EXPECT_EQ(1, copyOptions.Retry.MaxRetries);
+  EXPECT_TRUE(copyOptions.Hedging.Enabled);
   EXPECT_EQ(std::string("pleaseCopyMe"), copyOptions.Telemetry.ApplicationId);
   Request r(HttpMethod::Get, Url(""));
   auto result = copyOptions.Transport.Transport->Send(r, Context::ApplicationContext);
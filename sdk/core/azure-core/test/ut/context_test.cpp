@@ -5,6 +5,8 @@
 
 #include <azure/core/context.hpp>
 
+#include <private/context_cancellation.hpp>
+
 #include <chrono>
 #include <memory>
 #include <string>
@@ -509,3 +511,94 @@ TEST(Context, KeyTypePairPrecondition)
   EXPECT_TRUE(c3.TryGetValue<std::string>(key, strValue));
   EXPECT_TRUE(strValue == s);
 }
+
+TEST(Context, CancellationListener)
+{
+  struct CountingListener final : public Azure::Core::_detail::ContextCancellationListener
+  {
+    int Notifications = 0;
+    void OnContextCancelled() noexcept override { ++Notifications; }
+  } listener;
+
+  Context parent;
+  auto child = parent.WithValue(Context::Key(), 1);
+  auto sibling = parent.WithValue(Context::Key(), 2);
+  {
+    Azure::Core::_detail::ContextCancellationRegistration registration(child, &listener);
+
+    // Only the contexts the listener waits on notify it.
+    sibling.Cancel();
+    Context().Cancel();
+    EXPECT_EQ(listener.Notifications, 0);
+
+    child.Cancel();
+    EXPECT_EQ(listener.Notifications, 1);
+    parent.Cancel();
+    EXPECT_EQ(listener.Notifications, 2);
+  }
+
+  // Not notified once the registration is gone.
+  parent.Cancel();
+  child.Cancel();
+  EXPECT_EQ(listener.Notifications, 2);
+}
+
+TEST(Context, CancellationListenersOfDescendants)
+{
+  struct CountingListener final : public Azure::Core::_detail::ContextCancellationListener
+  {
+    int Notifications = 0;
+    void OnContextCancelled() noexcept override { ++Notifications; }
+  };
+
+  // Each registration is only made on the context waited on, cancelling a parent finds them all.
+  Context parent;
+  std::vector<Context> contexts;
+  for (int i = 0; i < 64; ++i)
+  {
+    auto child = parent.WithValue(Context::Key(), i);
+    contexts.push_back(i % 2 == 0 ? child : child.WithDeadline((Azure::DateTime::max)()));
+  }
+  std::vector<CountingListener> listeners(contexts.size());
+  std::vector<std::unique_ptr<Azure::Core::_detail::ContextCancellationRegistration>>
+      registrations;
+  for (size_t i = 0; i < contexts.size(); ++i)
+  {
+    registrations.push_back(
+        std::make_unique<Azure::Core::_detail::ContextCancellationRegistration>(
+            contexts[i], &listeners[i]));
+  }
+
+  parent.Cancel();
+  for (auto const& listener : listeners)
+  {
+    EXPECT_EQ(listener.Notifications, 1);
+  }
+}
+
+TEST(Context, CancelParentAfterCheckingChild)
+{
+  Context root;
+  Context::Key const key;
+  auto parent = root.WithValue(key, 1);
+  auto child = parent.WithDeadline((Azure::DateTime::max)()).WithValue(key, 2);
+
+  // The first checks remember that no context in the chain has a deadline.
+  EXPECT_FALSE(child.IsCancelled());
+  EXPECT_FALSE(child.IsCancelled());
+  EXPECT_EQ(child.GetDeadline(), (Azure::DateTime::max)());
+
+  // Cancelling a parent after that is still seen by the child, and by the contexts created from it.
+  root.Cancel();
+  EXPECT_TRUE(child.IsCancelled());
+  EXPECT_TRUE(child.WithValue(key, 3).IsCancelled());
+  EXPECT_EQ(child.GetDeadline(), (Azure::DateTime::min)());
+  EXPECT_TRUE(parent.IsCancelled());
+
+  // A deadline in the past cancels the context without calling Cancel().
+  Context other;
+  auto expired = other.WithDeadline(Azure::DateTime(std::chrono::system_clock::now())
+                                    - std::chrono::seconds(1));
+  EXPECT_FALSE(other.IsCancelled());
+  EXPECT_TRUE(expired.IsCancelled());
+}
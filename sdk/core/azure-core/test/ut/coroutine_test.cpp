@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+// Built as C++20 by an executable of its own, see CMakeLists.txt.
+
+#include <azure/core/coroutine.hpp>
+#include <azure/core/internal/client_options.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Azure::Core::Http;
+
+namespace {
+// A coroutine which starts right away and sets a future when it returns.
+template <class T> struct Task
+{
+  struct promise_type
+  {
+    std::promise<T> Promise;
+
+    Task get_return_object() { return Task{Promise.get_future()}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_value(T value) { Promise.set_value(std::move(value)); }
+    void unhandled_exception() { Promise.set_exception(std::current_exception()); }
+  };
+
+  std::future<T> Result;
+};
+
+std::unique_ptr<RawResponse> CreateResponse(HttpStatusCode statusCode)
+{
+  auto response = std::make_unique<RawResponse>(1, 1, statusCode, "");
+  response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(nullptr, 0));
+  return response;
+}
+
+// Completes the requests sent asynchronously from a single thread, like CurlMultiTransport.
+class EventLoopTransport final : public HttpTransport {
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<ResponseCallback> m_callbacks;
+  bool m_completing = false;
+  std::thread m_thread;
+
+public:
+  std::thread::id ThreadId;
+
+  EventLoopTransport()
+  {
+    m_thread = std::thread([this]() {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_completing; });
+      auto callbacks = std::move(m_callbacks);
+      lock.unlock();
+      for (auto& callback : callbacks)
+      {
+        callback(CreateResponse(HttpStatusCode::Ok), nullptr);
+      }
+    });
+    ThreadId = m_thread.get_id();
+  }
+
+  ~EventLoopTransport() override
+  {
+    Complete();
+    m_thread.join();
+  }
+
+  // Completes the requests sent so far, all at once.
+  void Complete()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completing = true;
+    m_condition.notify_all();
+  }
+
+  std::unique_ptr<RawResponse> Send(Request&, Azure::Core::Context const&) override
+  {
+    throw std::logic_error("The requests are sent asynchronously.");
+  }
+
+  void SendAsync(Request&, Azure::Core::Context const&, ResponseCallback callback) override
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callbacks.push_back(std::move(callback));
+  }
+};
+
+// An executor running the work on a thread of its own.
+class WorkerThread final {
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<std::function<void()>> m_work;
+  bool m_stopping = false;
+  std::thread m_thread;
+
+public:
+  std::thread::id ThreadId;
+  std::atomic<int> Submitted{0};
+
+  WorkerThread()
+  {
+    m_thread = std::thread([this]() {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (true)
+      {
+        m_condition.wait(lock, [this]() { return m_stopping || !m_work.empty(); });
+        if (m_work.empty())
+        {
+          return;
+        }
+        auto work = std::move(m_work.front());
+        m_work.pop_front();
+        lock.unlock();
+        work();
+        lock.lock();
+      }
+    });
+    ThreadId = m_thread.get_id();
+  }
+
+  ~WorkerThread()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+      m_condition.notify_all();
+    }
+    m_thread.join();
+  }
+
+  Azure::Core::CoroutineExecutor GetExecutor()
+  {
+    return [this](std::function<void()> work) {
+      ++Submitted;
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_work.push_back(std::move(work));
+      m_condition.notify_all();
+    };
+  }
+};
+
+// Answers the requests synchronously, so the awaiting coroutines are never suspended.
+class SynchronousTransport final : public HttpTransport {
+public:
+  std::unique_ptr<RawResponse> Send(Request&, Azure::Core::Context const&) override
+  {
+    return CreateResponse(HttpStatusCode::Accepted);
+  }
+};
+
+Azure::Core::Http::_internal::HttpPipeline CreatePipeline(std::shared_ptr<HttpTransport> transport)
+{
+  Azure::Core::_internal::ClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  return Azure::Core::Http::_internal::HttpPipeline(options, "test-client", "1.0.0", {}, {});
+}
+
+struct ResumedResponse final
+{
+  HttpStatusCode StatusCode;
+  std::thread::id ResumedOn;
+};
+
+Task<ResumedResponse> Send(
+    Azure::Core::Http::_internal::HttpPipeline const& pipeline,
+    Azure::Core::CoroutineExecutor executor = Azure::Core::CoroutineExecutor())
+{
+  Request request(HttpMethod::Get, Azure::Core::Url("https://account.test/path"));
+  auto const response = co_await Azure::Core::Http::_internal::SendAwaitable(
+      pipeline, request, Azure::Core::Context(), std::move(executor));
+  co_return ResumedResponse{response->GetStatusCode(), std::this_thread::get_id()};
+}
+
+Task<std::string> Download(Azure::Core::CoroutineExecutor executor, std::thread::id* resumedOn)
+{
+  auto const value = co_await Azure::Core::MakeAwaitable(
+      []() { return std::string("content"); }, std::move(executor));
+  *resumedOn = std::this_thread::get_id();
+  co_return value;
+}
+
+Task<int> Fail(Azure::Core::CoroutineExecutor executor)
+{
+  co_await Azure::Core::MakeAwaitable(
+      []() { throw std::runtime_error("failed"); }, std::move(executor));
+  co_return 0;
+}
+} // namespace
+
+TEST(Coroutine, ResumedByTransport)
+{
+  // All the requests are in flight at the same time, without a thread waiting for any of them.
+  constexpr size_t RequestCount = 100;
+  auto const transport = std::make_shared<EventLoopTransport>();
+  auto const pipeline = CreatePipeline(transport);
+  std::vector<Task<ResumedResponse>> tasks;
+  for (size_t i = 0; i < RequestCount; ++i)
+  {
+    tasks.push_back(Send(pipeline));
+  }
+  for (auto& task : tasks)
+  {
+    EXPECT_EQ(task.Result.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+  }
+  transport->Complete();
+  for (auto& task : tasks)
+  {
+    auto const response = task.Result.get();
+    EXPECT_EQ(response.StatusCode, HttpStatusCode::Ok);
+    EXPECT_EQ(response.ResumedOn, transport->ThreadId);
+  }
+}
+
+TEST(Coroutine, ResumedOnExecutor)
+{
+  WorkerThread worker;
+  auto const transport = std::make_shared<EventLoopTransport>();
+  auto const pipeline = CreatePipeline(transport);
+  auto task = Send(pipeline, worker.GetExecutor());
+  transport->Complete();
+  auto const response = task.Result.get();
+  EXPECT_EQ(response.StatusCode, HttpStatusCode::Ok);
+  EXPECT_EQ(response.ResumedOn, worker.ThreadId);
+  EXPECT_EQ(worker.Submitted, 1);
+}
+
+TEST(Coroutine, CompletedWhileSent)
+{
+  // The default SendAsync() of the transport calls back before it returns.
+  auto const pipeline = CreatePipeline(std::make_shared<SynchronousTransport>());
+  auto task = Send(pipeline);
+  ASSERT_EQ(task.Result.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  auto const response = task.Result.get();
+  EXPECT_EQ(response.StatusCode, HttpStatusCode::Accepted);
+  EXPECT_EQ(response.ResumedOn, std::this_thread::get_id());
+}
+
+TEST(Coroutine, SynchronousOperationOnExecutor)
+{
+  WorkerThread worker;
+  std::thread::id resumedOn;
+  auto task = Download(worker.GetExecutor(), &resumedOn);
+  EXPECT_EQ(task.Result.get(), "content");
+  EXPECT_EQ(worker.Submitted, 1);
+  EXPECT_EQ(resumedOn, worker.ThreadId);
+}
+
+TEST(Coroutine, SynchronousOperationRequiresExecutor)
+{
+  std::thread::id resumedOn;
+  auto task = Download(Azure::Core::CoroutineExecutor(), &resumedOn);
+  EXPECT_THROW(task.Result.get(), std::invalid_argument);
+}
+
+TEST(Coroutine, RethrowsException)
+{
+  auto task = Fail([](std::function<void()> work) { work(); });
+  EXPECT_THROW(task.Result.get(), std::runtime_error);
+}
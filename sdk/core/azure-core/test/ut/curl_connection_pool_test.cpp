@@ -10,9 +10,18 @@
 #include "azure/core/http/curl_transport.hpp"
 #endif
 
+#if defined(AZ_PLATFORM_POSIX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <thread>
+#include <vector>
 
 // The next includes are from Azure Core private headers.
 // They are included to test the connection pool from the libcurl transport adapter implementation.
@@ -34,11 +43,9 @@ namespace Azure { namespace Core { namespace Test {
     TEST(CurlConnectionPool, connectionPoolTest)
     {
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
-        CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.clear();
+        CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
         // Make sure there are nothing in the pool
-        EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.size(), 0);
+        EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.HostsOnPool(), 0);
       }
 
       // Use the same request for all connections.
@@ -63,18 +70,13 @@ namespace Azure { namespace Core { namespace Test {
       }
       // Check that after the connection is gone, it is moved back to the pool
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
+            1);
+        EXPECT_EQ(
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(expectedConnectionKey),
             1);
-        auto connectionFromPool
-            = Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                  .ConnectionPoolIndex.begin()
-                  ->second.begin()
-                  ->get();
-        EXPECT_EQ(connectionFromPool->GetConnectionKey(), expectedConnectionKey);
       }
 
       // Test that asking a connection with same config will re-use the same connection
@@ -86,8 +88,7 @@ namespace Azure { namespace Core { namespace Test {
 
         // There was just one connection in the pool, it should be empty now
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             0);
         // And the connection key for the connection we got is the expected
         EXPECT_EQ(connection->GetConnectionKey(), expectedConnectionKey);
@@ -99,17 +100,14 @@ namespace Azure { namespace Core { namespace Test {
         session->m_sessionState = Azure::Core::Http::CurlSession::SessionState::STREAMING;
       }
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         // Check that after the connection is gone, it is moved back to the pool
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
+            1);
+        EXPECT_EQ(
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(expectedConnectionKey),
             1);
-        auto values = Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                          .ConnectionPoolIndex.begin();
-        EXPECT_EQ(values->second.size(), 1);
-        EXPECT_EQ(values->second.begin()->get()->GetConnectionKey(), expectedConnectionKey);
       }
 
       // Now test that using a different connection config won't re-use the same connection
@@ -126,16 +124,12 @@ namespace Azure { namespace Core { namespace Test {
         // One connection still in the pool after getting a new connection and with first expected
         // key
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             1);
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .begin()
-                ->second.begin()
-                ->get()
-                ->GetConnectionKey(),
-            expectedConnectionKey);
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(expectedConnectionKey),
+            1);
 
         auto session = std::make_unique<Azure::Core::Http::CurlSession>(
             req, std::move(connection), options.HttpKeepAlive);
@@ -146,19 +140,17 @@ namespace Azure { namespace Core { namespace Test {
 
       // Now there should be 2 index wit one connection each
       EXPECT_EQ(
-          Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-              .size(),
+          Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
           2);
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
-        auto values = Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                          .ConnectionPoolIndex.begin();
-        EXPECT_EQ(values->second.size(), 1);
-        EXPECT_EQ(values->second.begin()->get()->GetConnectionKey(), secondExpectedKey);
-        values++;
-        EXPECT_EQ(values->second.size(), 1);
-        EXPECT_EQ(values->second.begin()->get()->GetConnectionKey(), expectedConnectionKey);
+        EXPECT_EQ(
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(secondExpectedKey),
+            1);
+        EXPECT_EQ(
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(expectedConnectionKey),
+            1);
       }
 
       // Test re-using same custom config
@@ -171,16 +163,12 @@ namespace Azure { namespace Core { namespace Test {
         // One connection still in the pool after getting a new connection and with first expected
         // key
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             1);
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .begin()
-                ->second.begin()
-                ->get()
-                ->GetConnectionKey(),
-            secondExpectedKey);
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(secondExpectedKey),
+            1);
 
         auto session = std::make_unique<Azure::Core::Http::CurlSession>(
             req, std::move(connection), options.HttpKeepAlive);
@@ -190,36 +178,43 @@ namespace Azure { namespace Core { namespace Test {
       }
       // Now there should be 2 index wit one connection each
       EXPECT_EQ(
-          Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-              .size(),
+          Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
           2);
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
-        auto values = Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                          .ConnectionPoolIndex.begin();
-        EXPECT_EQ(values->second.size(), 1);
-        EXPECT_EQ(values->second.begin()->get()->GetConnectionKey(), secondExpectedKey);
-        values++;
-        EXPECT_EQ(values->second.size(), 1);
-        EXPECT_EQ(values->second.begin()->get()->GetConnectionKey(), expectedConnectionKey);
+        EXPECT_EQ(
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(secondExpectedKey),
+            1);
+        EXPECT_EQ(
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                .ConnectionsOnPool(expectedConnectionKey),
+            1);
+      }
+      {
+        // The pool keeps counting the connections for each key.
+        auto statistics = Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
+                              .GetHostStatistics(expectedConnectionKey);
+        EXPECT_EQ(statistics.AvailableConnections, 1);
+        EXPECT_EQ(statistics.CreatedConnections, 1);
+        EXPECT_EQ(statistics.ReusedConnections, 2);
+        EXPECT_EQ(statistics.ReturnedConnections, 3);
+
+        // The totals of the pool add up the counters of all the connection keys.
+        auto const totals = Azure::Core::Http::_internal::GetCurlConnectionPoolStatistics();
+        EXPECT_GE(totals.CreatedConnections, statistics.CreatedConnections);
+        EXPECT_GE(totals.ReusedConnections, statistics.ReusedConnections);
       }
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         // clean the pool
-        CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.clear();
+        CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
       }
 
 #ifdef RUN_LONG_UNIT_TESTS
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         // clean the pool
-        CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.clear();
+        CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             0);
       }
 
@@ -246,16 +241,12 @@ namespace Azure { namespace Core { namespace Test {
       }
 
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             1);
         EXPECT_EQ(
             Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                .ConnectionPoolIndex[expectedConnectionKey]
-                .size(),
+                .ConnectionsOnPool(expectedConnectionKey),
             5);
       }
 
@@ -274,10 +265,8 @@ namespace Azure { namespace Core { namespace Test {
           std::this_thread::sleep_for(10ms);
           // If test wakes while clean pool is running, it will wait until lock is released by
           // the clean pool thread.
-          std::lock_guard<std::mutex> lock(
-              CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
           poolIsEmpty = Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                            .ConnectionPoolIndex.size()
+                            .HostsOnPool()
               == 0;
         }
         EXPECT_TRUE(poolIsEmpty);
@@ -292,10 +281,8 @@ namespace Azure { namespace Core { namespace Test {
       //     using ::testing::ReturnRef;
 
       //     {
-      //       std::lock_guard<std::mutex> lock(
-      //           CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
       //       // clean the pool
-      //       CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.clear();
+      //       CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
       //     }
 
       //     std::string hostKey("key");
@@ -352,7 +339,7 @@ namespace Azure { namespace Core { namespace Test {
 
       //       EXPECT_EQ(
       //           Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-      //               .ConnectionPoolIndex.size(),
+      //               .HostsOnPool(),
       //           2);
       //       EXPECT_EQ(
       //           Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
@@ -367,10 +354,8 @@ namespace Azure { namespace Core { namespace Test {
       //           Azure::Core::Http::_detail::MaxConnectionsPerIndex);
       //     }
       //     {
-      //       std::lock_guard<std::mutex> lock(
-      //           CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
       //       // clean the pool
-      //       CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.clear();
+      //       CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
       //     }
       //   }
     }
@@ -378,14 +363,10 @@ namespace Azure { namespace Core { namespace Test {
     TEST(CurlConnectionPool, uniquePort)
     {
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
-        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-            .clear();
+        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
         // Make sure there is nothing in the pool
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             0);
       }
 
@@ -402,11 +383,9 @@ namespace Azure { namespace Core { namespace Test {
                               .ExtractOrCreateCurlConnection(req, {});
 
         {
-          std::lock_guard<std::mutex> lock(
-              CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
           EXPECT_EQ(
               Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                  .ConnectionPoolIndex.size(),
+                  .HostsOnPool(),
               0);
           EXPECT_EQ(connection->GetConnectionKey(), expectedConnectionKey);
         }
@@ -416,12 +395,9 @@ namespace Azure { namespace Core { namespace Test {
       }
 
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         // Test connection was moved to the pool
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             1);
       }
 
@@ -439,12 +415,10 @@ namespace Azure { namespace Core { namespace Test {
 
         EXPECT_EQ(connection->GetConnectionKey(), expectedConnectionKey);
         {
-          std::lock_guard<std::mutex> lock(
-              CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
           // Check connection in pool is not re-used because the port is different
           EXPECT_EQ(
               Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                  .ConnectionPoolIndex.size(),
+                  .HostsOnPool(),
               1);
         }
         // move connection back to the pool
@@ -452,12 +426,9 @@ namespace Azure { namespace Core { namespace Test {
             .MoveConnectionBackToPool(std::move(connection), Azure::Core::Http::HttpStatusCode::Ok);
       }
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         // Check 2 connections in the pool
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             2);
       }
 
@@ -475,11 +446,9 @@ namespace Azure { namespace Core { namespace Test {
                               .ExtractOrCreateCurlConnection(req, {});
 
         {
-          std::lock_guard<std::mutex> lock(
-              CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
           EXPECT_EQ(
               Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                  .ConnectionPoolIndex.size(),
+                  .HostsOnPool(),
               1);
         }
         EXPECT_EQ(connection->GetConnectionKey(), expectedConnectionKey);
@@ -490,11 +459,8 @@ namespace Azure { namespace Core { namespace Test {
 
       {
         // Make sure there is nothing in the pool
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             2);
       }
       {
@@ -511,12 +477,10 @@ namespace Azure { namespace Core { namespace Test {
 
         EXPECT_EQ(connection->GetConnectionKey(), expectedConnectionKey);
         {
-          std::lock_guard<std::mutex> lock(
-              CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
           // Check connection in pool is not re-used because the port is different
           EXPECT_EQ(
               Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                  .ConnectionPoolIndex.size(),
+                  .HostsOnPool(),
               1);
         }
         // move connection back to the pool
@@ -524,14 +488,10 @@ namespace Azure { namespace Core { namespace Test {
             .MoveConnectionBackToPool(std::move(connection), Azure::Core::Http::HttpStatusCode::Ok);
       }
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             2);
-        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-            .clear();
+        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
       }
     }
 
@@ -560,11 +520,9 @@ namespace Azure { namespace Core { namespace Test {
       /// When getting the header connection: close from an HTTP response, the connection should not
       /// be moved back to the pool.
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
-        CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.clear();
+        CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
         // Make sure there are nothing in the pool
-        EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex.size(), 0);
+        EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.HostsOnPool(), 0);
       }
 
       // Use the same request for all connections.
@@ -587,13 +545,497 @@ namespace Azure { namespace Core { namespace Test {
 
       // Check that after the connection is gone, it is moved back to the pool
       {
-        std::lock_guard<std::mutex> lock(
-            CurlConnectionPool::g_curlConnectionPool.ConnectionPoolMutex);
         EXPECT_EQ(
-            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-                .size(),
+            Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
             0);
       }
     }
+
+    TEST(CurlConnectionPool, warmUp)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Url const url(AzureSdkHttpbinServer::Get());
+      std::string const expectedConnectionKey
+          = AzureSdkHttpbinServer::Schema() + AzureSdkHttpbinServer::Host() + "001100";
+
+      Azure::Core::Http::CurlTransport transport;
+      transport.WarmUp(url, 3);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(expectedConnectionKey), 3);
+      auto statistics
+          = CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(expectedConnectionKey);
+      EXPECT_EQ(statistics.CreatedConnections, 3);
+      EXPECT_EQ(statistics.ReturnedConnections, 0);
+
+      // Only the missing connections are opened.
+      transport.WarmUp(url, 4);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(expectedConnectionKey), 4);
+      transport.WarmUp(url, 2);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(expectedConnectionKey), 4);
+
+      // The first request takes a warm connection from the pool.
+      Azure::Core::Http::Request req(Azure::Core::Http::HttpMethod::Get, url);
+      auto response = transport.Send(req, Azure::Core::Context::ApplicationContext);
+      EXPECT_EQ(response->GetStatusCode(), Azure::Core::Http::HttpStatusCode::Ok);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(expectedConnectionKey)
+              .ReusedConnections,
+          1);
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+    }
+
+    TEST(CurlConnectionPool, warmUpUnreachableHost)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      options.ConnectionTimeout = 1s;
+      Azure::Core::Http::CurlTransport transport(options);
+      EXPECT_THROW(
+          transport.WarmUp(Azure::Core::Url("http://localhost:1"), 2),
+          Azure::Core::Http::TransportException);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.HostsOnPool(), 0);
+    }
+
+    TEST(CurlConnectionPool, concurrentMoveAndExtract)
+    {
+      using ::testing::ReturnRef;
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::Request req(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://sharded.pool.test"));
+      std::string const connectionKey("httpssharded.pool.test001100");
+      constexpr int threadCount = 8;
+      constexpr int iterations = 100;
+
+      // Every thread moves a connection to the pool and takes one back, so the pool always has a
+      // connection to give and no real connection gets created.
+      std::vector<std::thread> threads;
+      for (int t = 0; t < threadCount; t++)
+      {
+        threads.emplace_back([&]() {
+          for (int i = 0; i < iterations; i++)
+          {
+            auto connection = std::make_unique<MockCurlNetworkConnection>();
+            EXPECT_CALL(*connection, GetConnectionKey()).WillRepeatedly(ReturnRef(connectionKey));
+            EXPECT_CALL(*connection, UpdateLastUsageTime());
+            EXPECT_CALL(*connection, DestructObj());
+            CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+                std::move(connection), Azure::Core::Http::HttpStatusCode::Ok);
+
+            auto fromPool
+                = CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(req, {});
+            EXPECT_EQ(fromPool->GetConnectionKey(), connectionKey);
+          }
+        });
+      }
+      for (auto& thread : threads)
+      {
+        thread.join();
+      }
+
+      auto statistics = CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(connectionKey);
+      EXPECT_EQ(statistics.AvailableConnections, 0);
+      EXPECT_EQ(statistics.CreatedConnections, 0);
+      EXPECT_EQ(statistics.ReturnedConnections, threadCount * iterations);
+      EXPECT_EQ(statistics.ReusedConnections, threadCount * iterations);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.HostsOnPool(), 0);
+    }
+
+    namespace {
+      std::unique_ptr<MockCurlNetworkConnection> CreatePooledMock(
+          std::string const& connectionKey,
+          Azure::Core::Http::CurlTransportOptions const& options)
+      {
+        using ::testing::ReturnRef;
+        auto connection = std::make_unique<MockCurlNetworkConnection>(
+            Azure::Core::Http::_detail::CurlConnectionPoolOptions(options));
+        EXPECT_CALL(*connection, GetConnectionKey()).WillRepeatedly(ReturnRef(connectionKey));
+        EXPECT_CALL(*connection, UpdateLastUsageTime()).Times(::testing::AtMost(1));
+        EXPECT_CALL(*connection, IsClosedByPeer()).WillRepeatedly(::testing::Return(false));
+        EXPECT_CALL(*connection, DestructObj());
+        return connection;
+      }
+    } // namespace
+
+    TEST(CurlConnectionPool, maxConnectionsPerHost)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      options.MaxConnectionsPerHost = 2;
+      std::string const connectionKey("httpslimits.pool.test001100p2,0,60000,90000,0");
+      Azure::Core::Http::Request req(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://limits.pool.test"));
+
+      auto oldest = CreatePooledMock(connectionKey, options);
+      auto const oldestPtr = oldest.get();
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          std::move(oldest), Azure::Core::Http::HttpStatusCode::Ok);
+      for (int i = 0; i < 2; i++)
+      {
+        CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+            CreatePooledMock(connectionKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      }
+
+      auto statistics = CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(connectionKey);
+      EXPECT_EQ(statistics.AvailableConnections, 2);
+      EXPECT_EQ(statistics.RemovedConnections, 1);
+
+      // The least recently used connection was evicted.
+      for (int i = 0; i < 2; i++)
+      {
+        auto connection
+            = CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(req, options);
+        EXPECT_NE(connection.get(), oldestPtr);
+      }
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.HostsOnPool(), 0);
+    }
+
+    TEST(CurlConnectionPool, maxConnections)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      options.MaxConnections = 2;
+      std::string const firstKey("httpsfirst.pool.test001100p1024,2,60000,90000,0");
+      std::string const secondKey("httpssecond.pool.test001100p1024,2,60000,90000,0");
+
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          CreatePooledMock(firstKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          CreatePooledMock(firstKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      // The pool is full. The connection evicts one for the same host.
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          CreatePooledMock(firstKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(firstKey), 2);
+
+      // There is no connection to the second host to evict, so the connection is closed. The
+      // second host is then forgotten, but the pool keeps counting its connection.
+      auto const totals = CurlConnectionPool::g_curlConnectionPool.GetStatistics();
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          CreatePooledMock(secondKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(secondKey), 0);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(secondKey)
+              .ReturnedConnections,
+          0);
+      auto const statistics = CurlConnectionPool::g_curlConnectionPool.GetStatistics();
+      EXPECT_EQ(statistics.ReturnedConnections, totals.ReturnedConnections + 1);
+      EXPECT_EQ(statistics.RemovedConnections, totals.RemovedConnections + 1);
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+    }
+
+    TEST(CurlConnectionPool, maxConnectionsPerAddress)
+    {
+      using ::testing::ReturnRef;
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      options.MaxConnectionsPerAddress = 1;
+      std::string const connectionKey("httpsaddress.pool.test001100p1024,0,60000,90000,0,a1");
+      auto const createMock = [&](std::string const& address) {
+        auto connection = std::make_unique<MockCurlNetworkConnection>(
+            Azure::Core::Http::_detail::CurlConnectionPoolOptions(options), address);
+        EXPECT_CALL(*connection, GetConnectionKey()).WillRepeatedly(ReturnRef(connectionKey));
+        EXPECT_CALL(*connection, UpdateLastUsageTime());
+        EXPECT_CALL(*connection, DestructObj());
+        return connection;
+      };
+
+      // The second connection to the first address evicts the first one, the connection to the
+      // other address is kept.
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          createMock("10.0.0.1"), Azure::Core::Http::HttpStatusCode::Ok);
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          createMock("10.0.0.2"), Azure::Core::Http::HttpStatusCode::Ok);
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          createMock("10.0.0.1"), Azure::Core::Http::HttpStatusCode::Ok);
+      auto statistics = CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(connectionKey);
+      EXPECT_EQ(statistics.AvailableConnections, 2);
+      EXPECT_EQ(statistics.RemovedConnections, 1);
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+    }
+
+    TEST(CurlConnectionPool, leaseAddress)
+    {
+      auto& pool = CurlConnectionPool::g_curlConnectionPool;
+      std::string first;
+      auto firstLease = pool.LeaseAddress("localhost", 80, 60s, first);
+      ASSERT_NE(firstLease, nullptr);
+      EXPECT_FALSE(first.empty());
+
+      // While the first lease is held, another address is picked if the host has several.
+      std::string second;
+      auto secondLease = pool.LeaseAddress("localhost", 80, 60s, second);
+      ASSERT_NE(secondLease, nullptr);
+      auto const addresses = pool.m_addressState->ResolvedHosts["localhost:80"].Addresses;
+      EXPECT_EQ(first, addresses.front());
+      EXPECT_EQ(second, addresses.size() > 1 ? addresses[1] : first);
+
+      firstLease.reset();
+      secondLease.reset();
+      EXPECT_EQ(pool.m_addressState->OpenConnections.count("localhost/" + first), 0);
+
+      std::string unresolved;
+      EXPECT_EQ(pool.LeaseAddress("host.invalid", 80, 60s, unresolved), nullptr);
+    }
+
+    TEST(CurlConnectionPool, evictionPolicy)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::Request req(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://policy.pool.test"));
+      for (auto policy :
+           {Azure::Core::Http::CurlConnectionPoolEvictionPolicy::LeastRecentlyUsed,
+            Azure::Core::Http::CurlConnectionPoolEvictionPolicy::FirstInFirstOut})
+      {
+        Azure::Core::Http::CurlTransportOptions options;
+        options.EvictionPolicy = policy;
+        bool const isFifo
+            = policy == Azure::Core::Http::CurlConnectionPoolEvictionPolicy::FirstInFirstOut;
+        std::string const connectionKey(
+            std::string("httpspolicy.pool.test001100")
+            + (isFifo ? "p1024,0,60000,90000,1" : ""));
+
+        auto first = CreatePooledMock(connectionKey, options);
+        auto second = CreatePooledMock(connectionKey, options);
+        auto const firstPtr = first.get();
+        auto const secondPtr = second.get();
+        CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+            std::move(first), Azure::Core::Http::HttpStatusCode::Ok);
+        CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+            std::move(second), Azure::Core::Http::HttpStatusCode::Ok);
+
+        auto connection
+            = CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(req, options);
+        EXPECT_EQ(connection.get(), isFifo ? firstPtr : secondPtr);
+      }
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+    }
+
+    TEST(CurlConnectionPool, isolatedPool)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      std::string const connectionKey("httpsisolated.pool.test001100");
+      Azure::Core::Http::Request req(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://isolated.pool.test"));
+
+      // The connections returned to an isolated pool are only re-used from it.
+      auto isolatedPool = CurlConnectionPool::CreateIsolatedPool();
+      auto pooled = CreatePooledMock(connectionKey, options);
+      auto const pooledPtr = pooled.get();
+      isolatedPool->MoveConnectionBackToPool(
+          std::move(pooled), Azure::Core::Http::HttpStatusCode::Ok);
+      EXPECT_EQ(isolatedPool->ConnectionsOnPool(connectionKey), 1);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.HostsOnPool(), 0);
+
+      auto connection = isolatedPool->ExtractOrCreateCurlConnection(req, options);
+      EXPECT_EQ(connection.get(), pooledPtr);
+      EXPECT_EQ(isolatedPool->GetStatistics().ReusedConnections, 1);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(connectionKey)
+              .ReusedConnections,
+          0);
+      connection.reset();
+
+      // A transport asking for an isolated pool counts its connections apart from the others.
+      options.IsolatedConnectionPool = true;
+      Azure::Core::Http::CurlTransport transport(options);
+      auto const statistics
+          = Azure::Core::Http::_internal::GetCurlConnectionPoolStatistics(transport);
+      EXPECT_EQ(statistics.CreatedConnections, 0);
+      EXPECT_EQ(statistics.ReusedConnections, 0);
+    }
+
+    TEST(CurlConnectionPool, closedByPeer)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      std::string const connectionKey("httpsclosed.pool.test001100");
+      Azure::Core::Http::Request req(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://closed.pool.test"));
+
+      auto alive = CreatePooledMock(connectionKey, options);
+      auto const alivePtr = alive.get();
+      auto closed = CreatePooledMock(connectionKey, options);
+      EXPECT_CALL(*closed, IsClosedByPeer()).WillRepeatedly(::testing::Return(true));
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          std::move(alive), Azure::Core::Http::HttpStatusCode::Ok);
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          std::move(closed), Azure::Core::Http::HttpStatusCode::Ok);
+
+      // The most recently used connection was closed by the server, it's discarded.
+      auto connection
+          = CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(req, options);
+      EXPECT_EQ(connection.get(), alivePtr);
+      auto const statistics
+          = CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(connectionKey);
+      EXPECT_EQ(statistics.RemovedConnections, 1);
+      EXPECT_EQ(statistics.ReusedConnections, 1);
+      EXPECT_EQ(statistics.AvailableConnections, 0);
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+    }
+
+#if defined(AZ_PLATFORM_POSIX)
+    TEST(CurlConnectionPool, readableConnectionNotClosedByPeer)
+    {
+      auto const server = socket(AF_INET, SOCK_STREAM, 0);
+      ASSERT_GE(server, 0);
+      sockaddr_in address = {};
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t addressSize = sizeof(address);
+      ASSERT_EQ(bind(server, reinterpret_cast<sockaddr*>(&address), addressSize), 0);
+      ASSERT_EQ(listen(server, 2), 0);
+      ASSERT_EQ(getsockname(server, reinterpret_cast<sockaddr*>(&address), &addressSize), 0);
+      Azure::Core::Url const url("http://127.0.0.1:" + std::to_string(ntohs(address.sin_port)));
+      Azure::Core::Http::Request req(Azure::Core::Http::HttpMethod::Get, url);
+      Azure::Core::Http::CurlTransportOptions options;
+      auto pool = CurlConnectionPool::CreateIsolatedPool();
+
+      // The server sends data the idle connection never reads, like the session tickets of TLS
+      // 1.3, but keeps the connection open.
+      pool->WarmUp(url, options, 1);
+      auto const open = accept(server, nullptr, nullptr);
+      ASSERT_GE(open, 0);
+      ASSERT_EQ(send(open, "x", 1, 0), 1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      pool->ExtractOrCreateCurlConnection(req, options);
+      auto statistics = pool->GetConnectionPoolStatistics().Hosts.begin()->second;
+      EXPECT_EQ(statistics.ReusedConnections, 1);
+      EXPECT_EQ(statistics.EvictedConnections, 0);
+
+      // The server closes the connection.
+      pool->WarmUp(url, options, 1);
+      auto const closed = accept(server, nullptr, nullptr);
+      ASSERT_GE(closed, 0);
+      close(closed);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      pool->ExtractOrCreateCurlConnection(req, options);
+      statistics = pool->GetConnectionPoolStatistics().Hosts.begin()->second;
+      EXPECT_EQ(statistics.ReusedConnections, 1);
+      EXPECT_EQ(statistics.EvictedConnections, 1);
+
+      close(open);
+      close(server);
+    }
+#endif
+
+    TEST(CurlConnectionPool, connectionPoolStatistics)
+    {
+      Azure::Core::Http::CurlTransportOptions options;
+      std::string const connectionKey("httpsstatistics.pool.test001100");
+      Azure::Core::Http::Request req(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://statistics.pool.test"));
+
+      auto pool = CurlConnectionPool::CreateIsolatedPool();
+      auto closed = CreatePooledMock(connectionKey, options);
+      EXPECT_CALL(*closed, IsClosedByPeer()).WillRepeatedly(::testing::Return(true));
+      pool->MoveConnectionBackToPool(
+          CreatePooledMock(connectionKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      pool->MoveConnectionBackToPool(
+          CreatePooledMock(connectionKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      pool->MoveConnectionBackToPool(std::move(closed), Azure::Core::Http::HttpStatusCode::Ok);
+
+      // The connection closed by the server is evicted, the next one is re-used.
+      auto connection = pool->ExtractOrCreateCurlConnection(req, options);
+
+      auto const statistics = pool->GetConnectionPoolStatistics();
+      ASSERT_EQ(statistics.Hosts.size(), 1);
+      auto const& hostStatistics = statistics.Hosts.begin()->second;
+      EXPECT_EQ(statistics.Hosts.begin()->first, "https://statistics.pool.test:443");
+      EXPECT_EQ(hostStatistics.IdleConnections, 1);
+      EXPECT_EQ(hostStatistics.ReusedConnections, 1);
+      EXPECT_EQ(hostStatistics.CreatedConnections, 0);
+      EXPECT_EQ(hostStatistics.EvictedConnections, 1);
+      EXPECT_EQ(hostStatistics.HandshakeTime.count(), 0);
+    }
+
+    TEST(CurlConnectionPool, reservedInteractiveConnections)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      options.ReservedInteractiveConnections = 1;
+      std::string const connectionKey("httpsreserve.pool.test001100");
+      Azure::Core::Http::Request req(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://reserve.pool.test"));
+      for (int i = 0; i < 2; i++)
+      {
+        CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+            CreatePooledMock(connectionKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      }
+
+      // A bulk request takes the idle connections above the reserve, then opens a new one, which
+      // fails for the test host.
+      auto bulk = CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(
+          req, options, false, Azure::Core::Http::TrafficClass::Bulk);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(connectionKey), 1);
+      EXPECT_THROW(
+          CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(
+              req, options, false, Azure::Core::Http::TrafficClass::Bulk),
+          Azure::Core::Http::TransportException);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(connectionKey), 1);
+
+      // The reserved connection goes to the interactive requests.
+      auto interactive
+          = CurlConnectionPool::g_curlConnectionPool.ExtractOrCreateCurlConnection(req, options);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(connectionKey), 0);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(connectionKey)
+              .ReusedConnections,
+          2);
+
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+    }
+
+    TEST(CurlConnectionPool, idleTimeout)
+    {
+      CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+      Azure::Core::Http::CurlTransportOptions options;
+      options.ConnectionIdleTimeout = 50ms;
+      options.ConnectionPoolCleanerInterval = 10ms;
+      std::string const connectionKey("httpsidle.pool.test001100p1024,0,50,10,0");
+
+      auto const totals = CurlConnectionPool::g_curlConnectionPool.GetStatistics();
+      CurlConnectionPool::g_curlConnectionPool.MoveConnectionBackToPool(
+          CreatePooledMock(connectionKey, options), Azure::Core::Http::HttpStatusCode::Ok);
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(connectionKey), 1);
+
+      // The clean thread wakes up when the connection expires, long before the default interval.
+      for (int i = 0; i < 100
+           && CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(connectionKey) != 0;
+           i++)
+      {
+        std::this_thread::sleep_for(20ms);
+      }
+      EXPECT_EQ(CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(connectionKey), 0);
+
+      // The key without connections left is erased from the index, and its counters are kept in
+      // the totals of the pool.
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.GetHostStatistics(connectionKey)
+              .ReturnedConnections,
+          0);
+      EXPECT_EQ(
+          CurlConnectionPool::g_curlConnectionPool.GetStatistics().RemovedConnections,
+          totals.RemovedConnections + 1);
+    }
 #endif
 }}} // namespace Azure::Core::Test
@@ -19,6 +19,13 @@
 
 #include "transport_adapter_base_test.hpp"
 
+#if defined(AZ_PLATFORM_POSIX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 #include <string>
 #include <vector>
 
@@ -89,7 +96,7 @@ namespace Azure { namespace Core { namespace Test {
     // Clean the connection from the pool *Windows fails to clean if we leave to be clean upon
     // app-destruction
     EXPECT_NO_THROW(Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                        .ConnectionPoolIndex.clear());
+                        .RemoveAllConnections());
   }
 
   /*
@@ -207,7 +214,7 @@ namespace Azure { namespace Core { namespace Test {
     // Clean the connection from the pool *Windows fails to clean if we leave to be clean upon
     // app-destruction
     EXPECT_NO_THROW(Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                        .ConnectionPoolIndex.clear());
+                        .RemoveAllConnections());
   }
 
   TEST(CurlTransportOptions, httpsDefault)
@@ -239,7 +246,7 @@ namespace Azure { namespace Core { namespace Test {
     // Clean the connection from the pool *Windows fails to clean if we leave to be clean upon
     // app-destruction
     EXPECT_NO_THROW(Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool
-                        .ConnectionPoolIndex.clear());
+                        .RemoveAllConnections());
   }
 
   TEST(CurlTransportOptions, disableKeepAlive)
@@ -275,9 +282,51 @@ namespace Azure { namespace Core { namespace Test {
     }
     // Make sure there are no connections in the pool
     EXPECT_EQ(
-        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-            .size(),
+        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
         0);
   }
 
+#if defined(AZ_PLATFORM_POSIX)
+  TEST(CurlTransportOptions, socketOptions)
+  {
+    using Azure::Core::Http::_detail::CurlConnectionPool;
+    CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+
+    // A server whose connections are only accepted by the listen backlog.
+    auto const server = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(server, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressSize = sizeof(address);
+    ASSERT_EQ(bind(server, reinterpret_cast<sockaddr*>(&address), addressSize), 0);
+    ASSERT_EQ(listen(server, 4), 0);
+    ASSERT_EQ(getsockname(server, reinterpret_cast<sockaddr*>(&address), &addressSize), 0);
+    auto const port = std::to_string(ntohs(address.sin_port));
+    Azure::Core::Url const url("http://127.0.0.1:" + port);
+
+    // The connections with other socket settings aren't re-used for each other.
+    Azure::Core::Http::CurlTransportOptions curlOptions;
+    curlOptions.TcpNoDelay = false;
+    curlOptions.SocketSendBufferSize = 128 * 1024;
+    curlOptions.SocketReceiveBufferSize = 256 * 1024;
+    curlOptions.TcpKeepAlive = true;
+    curlOptions.TcpKeepAliveIdleTime = std::chrono::seconds(30);
+    curlOptions.TcpCongestionControl = "reno";
+    Azure::Core::Http::CurlTransport(curlOptions).WarmUp(url, 1);
+    Azure::Core::Http::CurlTransport().WarmUp(url, 1);
+    EXPECT_EQ(
+        CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(
+            "http127.0.0.1" + port + "001100s0,131072,262144,renok30,60"),
+        1);
+    EXPECT_EQ(
+        CurlConnectionPool::g_curlConnectionPool.ConnectionsOnPool(
+            "http127.0.0.1" + port + "001100"),
+        1);
+
+    CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+    close(server);
+  }
+#endif
+
 }}} // namespace Azure::Core::Test
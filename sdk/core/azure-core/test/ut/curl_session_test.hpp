@@ -36,9 +36,26 @@ namespace Azure { namespace Core { namespace Test {
    */
   class MockCurlNetworkConnection final : public Azure::Core::Http::CurlNetworkConnection {
   public:
+    MockCurlNetworkConnection() = default;
+
+    explicit MockCurlNetworkConnection(
+        Azure::Core::Http::_detail::CurlConnectionPoolOptions const& poolOptions)
+    {
+      m_poolOptions = poolOptions;
+    }
+
+    explicit MockCurlNetworkConnection(
+        Azure::Core::Http::_detail::CurlConnectionPoolOptions const& poolOptions,
+        std::string remoteAddress)
+    {
+      m_poolOptions = poolOptions;
+      m_remoteAddress = std::move(remoteAddress);
+    }
+
     MOCK_METHOD(std::string const&, GetConnectionKey, (), (const, override));
     MOCK_METHOD(void, UpdateLastUsageTime, (), (override));
     MOCK_METHOD(bool, IsExpired, (), (override));
+    MOCK_METHOD(bool, IsClosedByPeer, (), (override));
     MOCK_METHOD(
         size_t,
         ReadFromSocket,
@@ -49,6 +66,11 @@ namespace Azure { namespace Core { namespace Test {
         SendBuffer,
         (uint8_t const* buffer, size_t bufferSize, Context const& context),
         (override));
+    MOCK_METHOD(
+        bool,
+        WaitForResponse,
+        (std::chrono::milliseconds timeout, Context const& context),
+        (override));
 
     /* This is a way to test we are calling the destructor
      *  Adding an extra mock method that is called from the destructor
@@ -5,12 +5,27 @@
 
 #include <azure/core/http/curl_transport.hpp>
 #include <azure/core/http/http.hpp>
+#include <azure/core/io/body_stream.hpp>
 
 #include <http/curl/curl_connection_private.hpp>
 #include <http/curl/curl_session_private.hpp>
 
+#if defined(AZ_PLATFORM_POSIX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
 using ::testing::_;
 using ::testing::DoAll;
+using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::SetArrayArgument;
@@ -81,8 +96,7 @@ namespace Azure { namespace Core { namespace Test {
       EXPECT_NO_THROW(session->Perform(Azure::Core::Context::ApplicationContext));
     }
     // Clear the connections from the pool to invoke clean routine
-    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-        .clear();
+    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
   }
 
   TEST_F(CurlSession, chunkBadFormatResponse)
@@ -132,8 +146,7 @@ namespace Azure { namespace Core { namespace Test {
           Azure::Core::Http::TransportException);
     }
     // Clear the connections from the pool to invoke clean routine
-    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-        .clear();
+    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
   }
 
   TEST_F(CurlSession, invalidHeader)
@@ -304,14 +317,12 @@ namespace Azure { namespace Core { namespace Test {
       EXPECT_NO_THROW(bodyS->ReadToEnd(Azure::Core::Context::ApplicationContext));
     }
     // Clear the connections from the pool to invoke clean routine
-    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-        .clear();
+    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
   }
 
   TEST_F(CurlSession, DoNotReuseConnectionIfDownloadFail)
   {
-    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-        .clear();
+    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
     // Can't mock the curlMock directly from a unique ptr, heap allocate it first and then make a
     // unique ptr for it
     MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
@@ -336,8 +347,540 @@ namespace Azure { namespace Core { namespace Test {
     }
     // Check connection pool is empty (connection was not moved to the pool)
     EXPECT_EQ(
-        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.ConnectionPoolIndex
-            .size(),
+        Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.HostsOnPool(),
         0);
   }
+
+  TEST_F(CurlSession, smallReadsFromInnerBuffer)
+  {
+    std::string response("HTTP/1.1 200 Ok\r\ncontent-length: 10\r\n\r\n");
+    std::string response2("0123456789");
+    std::string connectionKey("connection-key");
+    int32_t const payloadSize = static_cast<int32_t>(response.size());
+    int32_t const payloadSize2 = static_cast<int32_t>(response2.size());
+
+    // Can't mock the curMock directly from a unique ptr, heap allocate it first and then make a
+    // unique ptr for it
+    MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
+    EXPECT_CALL(*curlMock, SendBuffer(_, _, _)).WillOnce(Return(CURLE_OK));
+    // The whole body is pulled from the wire with a single read even if it is read byte by byte.
+    EXPECT_CALL(*curlMock, ReadFromSocket(_, _, _))
+        .WillOnce(DoAll(
+            SetArrayArgument<0>(response.data(), response.data() + payloadSize),
+            Return(payloadSize)))
+        .WillOnce(DoAll(
+            SetArrayArgument<0>(response2.data(), response2.data() + payloadSize2),
+            Return(payloadSize2)));
+    EXPECT_CALL(*curlMock, GetConnectionKey()).WillRepeatedly(ReturnRef(connectionKey));
+    EXPECT_CALL(*curlMock, UpdateLastUsageTime());
+    EXPECT_CALL(*curlMock, DestructObj());
+
+    // Create the unique ptr to take care about memory free at the end
+    std::unique_ptr<MockCurlNetworkConnection> uniqueCurlMock(curlMock);
+
+    // Simulate a request to be sent
+    Azure::Core::Url url("http://microsoft.com");
+    Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Get, url);
+
+    {
+      // Create the session inside scope so it is released and the connection is moved to the pool
+      auto session = std::make_unique<Azure::Core::Http::CurlSession>(
+          request, std::move(uniqueCurlMock), true);
+
+      EXPECT_NO_THROW(session->Perform(Azure::Core::Context::ApplicationContext));
+      auto r = session->ExtractResponse();
+      r->SetBodyStream(std::move(session));
+      auto bodyS = r->ExtractBodyStream();
+
+      std::string body;
+      uint8_t data = 0;
+      while (bodyS->Read(&data, 1, Azure::Core::Context::ApplicationContext) == 1)
+      {
+        body.push_back(static_cast<char>(data));
+      }
+      EXPECT_EQ(body, response2);
+    }
+    // Clear the connections from the pool to invoke clean routine
+    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+  }
+
+  TEST_F(CurlSession, readRestOfBodyIntoCallerBuffer)
+  {
+    std::string response("HTTP/1.1 200 Ok\r\ncontent-length: 10\r\n\r\n");
+    std::string response2("0123456789");
+    std::string connectionKey("connection-key");
+    int32_t const payloadSize = static_cast<int32_t>(response.size());
+
+    // Can't mock the curMock directly from a unique ptr, heap allocate it first and then make a
+    // unique ptr for it
+    MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
+    EXPECT_CALL(*curlMock, SendBuffer(_, _, _)).WillOnce(Return(CURLE_OK));
+    EXPECT_CALL(*curlMock, ReadFromSocket(_, _, _))
+        .WillOnce(DoAll(
+            SetArrayArgument<0>(response.data(), response.data() + payloadSize),
+            Return(payloadSize)));
+    // Reading the whole rest of the body asks the socket for exactly the rest of it, received in
+    // two parts, instead of filling the inner buffer.
+    EXPECT_CALL(*curlMock, ReadFromSocket(_, 10, _))
+        .WillOnce(DoAll(SetArrayArgument<0>(response2.data(), response2.data() + 4), Return(4)));
+    EXPECT_CALL(*curlMock, ReadFromSocket(_, 6, _))
+        .WillOnce(
+            DoAll(SetArrayArgument<0>(response2.data() + 4, response2.data() + 10), Return(6)));
+    EXPECT_CALL(*curlMock, GetConnectionKey()).WillRepeatedly(ReturnRef(connectionKey));
+    EXPECT_CALL(*curlMock, UpdateLastUsageTime());
+    EXPECT_CALL(*curlMock, DestructObj());
+
+    // Create the unique ptr to take care about memory free at the end
+    std::unique_ptr<MockCurlNetworkConnection> uniqueCurlMock(curlMock);
+
+    // Simulate a request to be sent
+    Azure::Core::Url url("http://microsoft.com");
+    Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Get, url);
+
+    {
+      // Create the session inside scope so it is released and the connection is moved to the pool
+      auto session = std::make_unique<Azure::Core::Http::CurlSession>(
+          request, std::move(uniqueCurlMock), true);
+
+      EXPECT_NO_THROW(session->Perform(Azure::Core::Context::ApplicationContext));
+      auto r = session->ExtractResponse();
+      r->SetBodyStream(std::move(session));
+      auto bodyS = r->ExtractBodyStream();
+
+      std::vector<uint8_t> body(10);
+      EXPECT_EQ(
+          bodyS->ReadToCount(body.data(), body.size(), Azure::Core::Context::ApplicationContext),
+          10);
+      EXPECT_EQ(std::string(body.begin(), body.end()), response2);
+    }
+    // Clear the connections from the pool to invoke clean routine
+    Azure::Core::Http::_detail::CurlConnectionPool::g_curlConnectionPool.RemoveAllConnections();
+  }
+
+  TEST_F(CurlSession, adaptiveReadBuffer)
+  {
+    // The first read fills the 64 bytes buffer with the headers and the start of the body.
+    std::string response("HTTP/1.1 200 Ok\r\ncontent-length: 1000\r\n\r\n");
+    response.append(64 - response.size(), 'a');
+    std::string response2(128, 'b');
+    int32_t const payloadSize = static_cast<int32_t>(response.size());
+    int32_t const payloadSize2 = static_cast<int32_t>(response2.size());
+
+    // Can't mock the curMock directly from a unique ptr, heap allocate it first and then make a
+    // unique ptr for it
+    MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
+    EXPECT_CALL(*curlMock, SendBuffer(_, _, _)).WillOnce(Return(CURLE_OK));
+    EXPECT_CALL(*curlMock, ReadFromSocket(_, 64, _))
+        .WillOnce(DoAll(
+            SetArrayArgument<0>(response.data(), response.data() + payloadSize),
+            Return(payloadSize)));
+    // The previous read filled the buffer, so it is doubled for the next one.
+    EXPECT_CALL(*curlMock, ReadFromSocket(_, 128, _))
+        .WillOnce(DoAll(
+            SetArrayArgument<0>(response2.data(), response2.data() + payloadSize2),
+            Return(payloadSize2)));
+
+    // Create the unique ptr to take care about memory free at the end
+    std::unique_ptr<MockCurlNetworkConnection> uniqueCurlMock(curlMock);
+
+    // Simulate a request to be sent
+    Azure::Core::Url url("http://microsoft.com");
+    Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Get, url);
+
+    Azure::Core::Http::CurlTransportOptions options;
+    options.ReadBufferSize = 64;
+    options.AdaptiveReadBuffer = true;
+    auto session = std::make_unique<Azure::Core::Http::CurlSession>(
+        request, std::move(uniqueCurlMock), options);
+
+    EXPECT_NO_THROW(session->Perform(Azure::Core::Context::ApplicationContext));
+    auto r = session->ExtractResponse();
+    r->SetBodyStream(std::move(session));
+    auto bodyS = r->ExtractBodyStream();
+
+    // Consume what is left from the first read, then read past it to pull more from the wire.
+    std::vector<uint8_t> buffer(10);
+    auto const bodyInFirstRead = 64 - (response.find("\r\n\r\n") + 4);
+    for (size_t read = 0; read < bodyInFirstRead;)
+    {
+      read += bodyS->Read(buffer.data(), buffer.size(), Azure::Core::Context::ApplicationContext);
+    }
+    EXPECT_EQ(
+        bodyS->Read(buffer.data(), buffer.size(), Azure::Core::Context::ApplicationContext), 10);
+    EXPECT_EQ(buffer[0], 'b');
+  }
+
+  TEST_F(CurlSession, headersSplitAcrossReads)
+  {
+    std::string const response("HTTP/1.1 200 OK\r\nx-ms-first: 1\r\nx-ms-empty:\r\n"
+                               "X-Ms-Mixed-Case:  value with spaces\r\ncontent-length: 4\r\n\r\n"
+                               "body");
+    std::string connectionKey("connection-key");
+
+    // Every split of the status line, the headers and the delimiters must produce the same
+    // response.
+    for (size_t chunkSize = 1; chunkSize <= response.size(); chunkSize++)
+    {
+      size_t offset = 0;
+      MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
+      EXPECT_CALL(*curlMock, SendBuffer(_, _, _)).WillOnce(Return(CURLE_OK));
+      EXPECT_CALL(*curlMock, ReadFromSocket(_, _, _))
+          .WillRepeatedly(Invoke([&](uint8_t* buffer, size_t bufferSize, Context const&) {
+            auto const count = (std::min)({chunkSize, bufferSize, response.size() - offset});
+            std::copy(response.data() + offset, response.data() + offset + count, buffer);
+            offset += count;
+            return count;
+          }));
+      EXPECT_CALL(*curlMock, GetConnectionKey()).WillRepeatedly(ReturnRef(connectionKey));
+      EXPECT_CALL(*curlMock, DestructObj());
+
+      std::unique_ptr<MockCurlNetworkConnection> uniqueCurlMock(curlMock);
+      Azure::Core::Http::Request request(
+          Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("http://microsoft.com"));
+      auto session = std::make_unique<Azure::Core::Http::CurlSession>(
+          request, std::move(uniqueCurlMock), false);
+
+      EXPECT_NO_THROW(session->Perform(Azure::Core::Context::ApplicationContext));
+      auto r = session->ExtractResponse();
+      EXPECT_EQ(r->GetStatusCode(), Azure::Core::Http::HttpStatusCode::Ok);
+      EXPECT_EQ(r->GetReasonPhrase(), "OK");
+      auto const& headers = r->GetHeaders();
+      EXPECT_EQ(headers.size(), 4U);
+      EXPECT_EQ(headers.at("x-ms-first"), "1");
+      EXPECT_EQ(headers.at("x-ms-empty"), "");
+      EXPECT_EQ(headers.at("x-ms-mixed-case"), "value with spaces");
+      EXPECT_EQ(headers.at("content-length"), "4");
+
+      r->SetBodyStream(std::move(session));
+      auto body = r->ExtractBodyStream()->ReadToEnd(Azure::Core::Context::ApplicationContext);
+      EXPECT_EQ(std::string(body.begin(), body.end()), "body");
+    }
+  }
+
+  TEST_F(CurlSession, minimumReadThroughput)
+  {
+    std::string const headers("HTTP/1.1 200 OK\r\ncontent-length: 1000\r\n\r\n");
+    Azure::Core::Http::CurlTransportOptions options;
+    options.MinimumReadThroughput = 1000;
+    options.ReadThroughputWindow = std::chrono::milliseconds(100);
+
+    // Creates a session whose body is received with bodyRead.
+    auto const makeBody
+        = [&](std::function<size_t(uint8_t*, size_t, Context const&)> bodyRead,
+              Azure::Core::Http::Request& request) {
+            MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
+            EXPECT_CALL(*curlMock, SendBuffer(_, _, _)).WillOnce(Return(CURLE_OK));
+            EXPECT_CALL(*curlMock, ReadFromSocket(_, _, _))
+                .WillOnce(DoAll(
+                    SetArrayArgument<0>(headers.data(), headers.data() + headers.size()),
+                    Return(headers.size())))
+                .WillRepeatedly(Invoke(bodyRead));
+            EXPECT_CALL(*curlMock, DestructObj());
+
+            std::unique_ptr<MockCurlNetworkConnection> uniqueCurlMock(curlMock);
+            auto session = std::make_unique<Azure::Core::Http::CurlSession>(
+                request, std::move(uniqueCurlMock), options);
+            EXPECT_NO_THROW(session->Perform(Azure::Core::Context::ApplicationContext));
+            auto r = session->ExtractResponse();
+            r->SetBodyStream(std::move(session));
+            return r->ExtractBodyStream();
+          };
+    Azure::Core::Http::Request request(
+        Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("http://microsoft.com"));
+    std::vector<uint8_t> buffer(100);
+
+    // A body trickling at 50 bytes per second is abandoned once a window was spent reading it.
+    {
+      auto body = makeBody(
+          [](uint8_t* data, size_t, Context const&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            data[0] = 'a';
+            return size_t(1);
+          },
+          request);
+      int reads = 0;
+      EXPECT_THROW(
+          {
+            for (; reads < 100; ++reads)
+            {
+              body->Read(buffer.data(), buffer.size(), Azure::Core::Context::ApplicationContext);
+            }
+          },
+          Azure::Core::Http::TransportException);
+      EXPECT_GE(reads, 5);
+      EXPECT_LT(reads, 20);
+    }
+
+    // A read receiving nothing is abandoned after the window, unless the context is cancelled.
+    auto const waitForCancellation = [](uint8_t*, size_t, Context const& context) {
+      while (!context.IsCancelled())
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+      context.ThrowIfCancelled();
+      return size_t(0);
+    };
+    {
+      auto body = makeBody(waitForCancellation, request);
+      EXPECT_THROW(
+          body->Read(buffer.data(), buffer.size(), Azure::Core::Context::ApplicationContext),
+          Azure::Core::Http::TransportException);
+    }
+    {
+      auto body = makeBody(waitForCancellation, request);
+      Azure::Core::Context context;
+      context.Cancel();
+      EXPECT_THROW(
+          body->Read(buffer.data(), buffer.size(), context),
+          Azure::Core::OperationCancelledException);
+    }
+  }
+
+  TEST_F(CurlSession, expectContinue)
+  {
+    std::string const body(100, 'x');
+    Azure::Core::Http::CurlTransportOptions options;
+    options.HttpKeepAlive = false;
+
+    // Sends a PUT request with the body, expecting it to wait for the server to accept it or not,
+    // and receiving the responses. Returns the status code and what was sent.
+    auto const put = [&](bool expectContinue,
+                         bool responseReady,
+                         std::vector<std::string> responses,
+                         std::string& sent) {
+      MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
+      EXPECT_CALL(*curlMock, SendBuffer(_, _, _))
+          .WillRepeatedly(Invoke([&sent](uint8_t const* buffer, size_t bufferSize, Context const&) {
+            sent.append(reinterpret_cast<char const*>(buffer), bufferSize);
+            return CURLE_OK;
+          }));
+      if (expectContinue)
+      {
+        EXPECT_CALL(*curlMock, WaitForResponse(options.ExpectContinueTimeout, _))
+            .WillOnce(Return(responseReady));
+      }
+      else
+      {
+        EXPECT_CALL(*curlMock, WaitForResponse(_, _)).Times(0);
+      }
+      size_t next = 0;
+      EXPECT_CALL(*curlMock, ReadFromSocket(_, _, _))
+          .WillRepeatedly(Invoke([&](uint8_t* buffer, size_t, Context const&) {
+            auto const& response = responses.at(next++);
+            std::copy(response.begin(), response.end(), buffer);
+            return response.size();
+          }));
+      EXPECT_CALL(*curlMock, DestructObj());
+
+      std::unique_ptr<MockCurlNetworkConnection> uniqueCurlMock(curlMock);
+      Azure::Core::IO::MemoryBodyStream bodyStream(
+          reinterpret_cast<uint8_t const*>(body.data()), body.size());
+      Azure::Core::Http::Request request(
+          Azure::Core::Http::HttpMethod::Put,
+          Azure::Core::Url("http://microsoft.com"),
+          &bodyStream);
+      Azure::Core::Http::CurlSession session(request, std::move(uniqueCurlMock), options);
+      EXPECT_EQ(session.Perform(Azure::Core::Context::ApplicationContext), CURLE_OK);
+      return session.ExtractResponse()->GetStatusCode();
+    };
+    auto const endsWithBody = [&body](std::string const& sent) {
+      return sent.size() > body.size()
+          && sent.compare(sent.size() - body.size(), body.size(), body) == 0;
+    };
+    std::string const created("HTTP/1.1 201 Created\r\ncontent-length: 0\r\n\r\n");
+    std::string const continued("HTTP/1.1 100 Continue\r\n\r\n");
+
+    // Bodies smaller than the threshold are sent right after the headers.
+    {
+      std::string sent;
+      EXPECT_EQ(put(false, true, {created}, sent), Azure::Core::Http::HttpStatusCode::Created);
+      EXPECT_EQ(sent.find("expect"), std::string::npos);
+      EXPECT_TRUE(endsWithBody(sent));
+    }
+
+    options.ExpectContinueThreshold = 100;
+    // The body is sent once the server accepted the request.
+    {
+      std::string sent;
+      EXPECT_EQ(
+          put(true, true, {continued, created}, sent), Azure::Core::Http::HttpStatusCode::Created);
+      EXPECT_NE(sent.find("expect: 100-continue\r\n"), std::string::npos);
+      EXPECT_TRUE(endsWithBody(sent));
+    }
+    // A rejected request doesn't send the body, whether the rejection comes alone or after the
+    // acceptance.
+    {
+      std::string sent;
+      std::string const unauthorized("HTTP/1.1 401 Unauthorized\r\ncontent-length: 0\r\n\r\n");
+      EXPECT_EQ(
+          put(true, true, {unauthorized}, sent), Azure::Core::Http::HttpStatusCode::Unauthorized);
+      EXPECT_FALSE(endsWithBody(sent));
+      sent.clear();
+      EXPECT_EQ(
+          put(true, true, {continued + unauthorized}, sent),
+          Azure::Core::Http::HttpStatusCode::Unauthorized);
+      EXPECT_FALSE(endsWithBody(sent));
+    }
+    // The body is sent when the server doesn't answer in time, and an acceptance arriving late is
+    // skipped.
+    {
+      std::string sent;
+      EXPECT_EQ(
+          put(true, false, {continued + created}, sent),
+          Azure::Core::Http::HttpStatusCode::Created);
+      EXPECT_TRUE(endsWithBody(sent));
+      sent.clear();
+      EXPECT_EQ(
+          put(true, false, {continued, created}, sent), Azure::Core::Http::HttpStatusCode::Created);
+      EXPECT_TRUE(endsWithBody(sent));
+    }
+
+    options.ExpectContinueThreshold = -1;
+    {
+      std::string sent;
+      EXPECT_EQ(put(false, true, {created}, sent), Azure::Core::Http::HttpStatusCode::Created);
+      EXPECT_EQ(sent.find("expect"), std::string::npos);
+      EXPECT_TRUE(endsWithBody(sent));
+    }
+  }
+
+  namespace {
+    // A stream of generated data, whose length isn't known until it is read to the end.
+    class GeneratedBodyStream final : public Azure::Core::IO::BodyStream {
+      std::vector<std::string> m_pieces;
+      size_t m_next = 0;
+
+      size_t OnRead(uint8_t* buffer, size_t count, Context const&) override
+      {
+        if (m_next == m_pieces.size())
+        {
+          return 0;
+        }
+        auto const& piece = m_pieces[m_next++];
+        EXPECT_LE(piece.size(), count);
+        std::copy(piece.begin(), piece.end(), buffer);
+        return piece.size();
+      }
+
+    public:
+      explicit GeneratedBodyStream(std::vector<std::string> pieces) : m_pieces(std::move(pieces))
+      {
+      }
+
+      int64_t Length() const override { return -1; }
+      void Rewind() override { m_next = 0; }
+    };
+  } // namespace
+
+  TEST_F(CurlSession, chunkedRequest)
+  {
+    Azure::Core::Http::CurlTransportOptions options;
+    options.HttpKeepAlive = false;
+    options.ExpectContinueThreshold = -1;
+
+    std::string sent;
+    MockCurlNetworkConnection* curlMock = new MockCurlNetworkConnection();
+    EXPECT_CALL(*curlMock, SendBuffer(_, _, _))
+        .WillRepeatedly(Invoke([&sent](uint8_t const* buffer, size_t bufferSize, Context const&) {
+          sent.append(reinterpret_cast<char const*>(buffer), bufferSize);
+          return CURLE_OK;
+        }));
+    std::string const response("HTTP/1.1 201 Created\r\ncontent-length: 0\r\n\r\n");
+    EXPECT_CALL(*curlMock, ReadFromSocket(_, _, _))
+        .WillOnce(Invoke([&](uint8_t* buffer, size_t, Context const&) {
+          std::copy(response.begin(), response.end(), buffer);
+          return response.size();
+        }));
+    EXPECT_CALL(*curlMock, DestructObj());
+
+    std::unique_ptr<MockCurlNetworkConnection> uniqueCurlMock(curlMock);
+    GeneratedBodyStream bodyStream({"first piece", std::string(26, 'x')});
+    Azure::Core::Http::Request request(
+        Azure::Core::Http::HttpMethod::Put, Azure::Core::Url("http://microsoft.com"), &bodyStream);
+    Azure::Core::Http::CurlSession session(request, std::move(uniqueCurlMock), options);
+    EXPECT_EQ(session.Perform(Azure::Core::Context::ApplicationContext), CURLE_OK);
+    EXPECT_EQ(
+        session.ExtractResponse()->GetStatusCode(), Azure::Core::Http::HttpStatusCode::Created);
+
+    // The body is sent in one chunk for each read, after headers without a content-length.
+    EXPECT_NE(sent.find("transfer-encoding: chunked\r\n"), std::string::npos);
+    EXPECT_EQ(sent.find("content-length"), std::string::npos);
+    std::string const body("b\r\nfirst piece\r\n1a\r\n" + std::string(26, 'x') + "\r\n0\r\n\r\n");
+    auto const headersEnd = sent.find("\r\n\r\n");
+    ASSERT_NE(headersEnd, std::string::npos);
+    EXPECT_EQ(sent.substr(headersEnd + 4), body);
+  }
+
+#if defined(AZ_PLATFORM_POSIX)
+  TEST_F(CurlSession, cancelWhileWaitingForResponse)
+  {
+    // A server which accepts the connection, from the listen backlog, but never responds.
+    auto const server = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(server, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressSize = sizeof(address);
+    ASSERT_EQ(bind(server, reinterpret_cast<sockaddr*>(&address), addressSize), 0);
+    ASSERT_EQ(listen(server, 1), 0);
+    ASSERT_EQ(getsockname(server, reinterpret_cast<sockaddr*>(&address), &addressSize), 0);
+
+    Azure::Core::Http::CurlTransport transport;
+    Azure::Core::Http::Request request(
+        Azure::Core::Http::HttpMethod::Get,
+        Azure::Core::Url("http://127.0.0.1:" + std::to_string(ntohs(address.sin_port))));
+    Azure::Core::Context context;
+
+    std::thread canceller([&context]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      context.Cancel();
+    });
+    auto const start = std::chrono::steady_clock::now();
+    EXPECT_THROW(transport.Send(request, context), Azure::Core::OperationCancelledException);
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+    close(server);
+
+    // The wait for the response used to notice the cancellation only every second.
+    EXPECT_LT(elapsed, std::chrono::milliseconds(800));
+  }
+
+  TEST_F(CurlSession, multiCancelWhileWaitingForResponse)
+  {
+    // A server which accepts the connection, from the listen backlog, but never responds.
+    auto const server = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(server, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressSize = sizeof(address);
+    ASSERT_EQ(bind(server, reinterpret_cast<sockaddr*>(&address), addressSize), 0);
+    ASSERT_EQ(listen(server, 1), 0);
+    ASSERT_EQ(getsockname(server, reinterpret_cast<sockaddr*>(&address), &addressSize), 0);
+
+    Azure::Core::Http::CurlMultiTransport transport;
+    Azure::Core::Http::Request request(
+        Azure::Core::Http::HttpMethod::Get,
+        Azure::Core::Url("http://127.0.0.1:" + std::to_string(ntohs(address.sin_port))));
+    Azure::Core::Context context;
+
+    std::atomic<std::chrono::steady_clock::rep> cancelledAt{0};
+    std::thread canceller([&context, &cancelledAt]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      cancelledAt = std::chrono::steady_clock::now().time_since_epoch().count();
+      context.Cancel();
+    });
+    EXPECT_THROW(transport.Send(request, context), Azure::Core::OperationCancelledException);
+    auto const thrownAt = std::chrono::steady_clock::now();
+    canceller.join();
+    close(server);
+
+    // The wait for the headers used to check the context only every 100 milliseconds.
+    EXPECT_LT(
+        thrownAt
+            - std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(cancelledAt.load())),
+        std::chrono::milliseconds(50));
+  }
+#endif
 }}} // namespace Azure::Core::Test
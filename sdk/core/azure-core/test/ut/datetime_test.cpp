@@ -802,3 +802,44 @@ TEST(DateTime, TimeRoundtrip)
   TestDateTimeRoundtrip<DateTime::TimeFractionFormat::AllDigits>("2021-02-05T10:00:00.0000000Z");
   TestDateTimeRoundtrip<DateTime::TimeFractionFormat::AllDigits>("2021-02-05T20:00:00.0000000Z");
 }
+
+TEST(DateTime, ServiceLayouts)
+{
+  // The layouts sent by the services are parsed like the other layouts of the same date.
+  DateTime const expected = DateTime(2021, 2, 5, 8, 9, 10) + std::chrono::microseconds(123400);
+  EXPECT_EQ(
+      DateTime::Parse("Fri, 05 Feb 2021 08:09:10 GMT", DateTime::DateFormat::Rfc1123),
+      DateTime::Parse("5 Feb 2021 08:09:10 +0000", DateTime::DateFormat::Rfc1123));
+  EXPECT_EQ(
+      DateTime::Parse("2021-02-05T08:09:10.1234Z", DateTime::DateFormat::Rfc3339), expected);
+  EXPECT_EQ(
+      DateTime::Parse("2021-02-05T08:09:10.1234000Z", DateTime::DateFormat::Rfc3339), expected);
+  EXPECT_EQ(
+      DateTime::Parse("2021-02-05T08:09:10.12340000Z", DateTime::DateFormat::Rfc3339), expected);
+  EXPECT_EQ(
+      DateTime::Parse("2021-02-05T08:09:10Z", DateTime::DateFormat::Rfc3339),
+      DateTime(2021, 2, 5, 8, 9, 10));
+
+  EXPECT_THROW(
+      DateTime::Parse("Sat, 05 Feb 2021 08:09:10 GMT", DateTime::DateFormat::Rfc1123),
+      std::invalid_argument);
+  EXPECT_THROW(
+      DateTime::Parse("Fri, 05 Feb 2021 24:09:10 GMT", DateTime::DateFormat::Rfc1123),
+      std::invalid_argument);
+  EXPECT_THROW(
+      DateTime::Parse("2021-02-30T08:09:10.1234Z", DateTime::DateFormat::Rfc3339),
+      std::invalid_argument);
+  EXPECT_THROW(
+      DateTime::Parse("2021-02-05T08:09:1a.1234Z", DateTime::DateFormat::Rfc3339),
+      std::invalid_argument);
+
+  EXPECT_EQ(expected.ToString(DateTime::DateFormat::Rfc1123), "Fri, 05 Feb 2021 08:09:10 GMT");
+  EXPECT_EQ(expected.ToString(DateTime::DateFormat::Rfc3339), "2021-02-05T08:09:10.1234Z");
+  EXPECT_EQ(
+      expected.ToString(
+          DateTime::DateFormat::Rfc3339, DateTime::TimeFractionFormat::AllDigits),
+      "2021-02-05T08:09:10.1234000Z");
+  EXPECT_EQ(
+      expected.ToString(DateTime::DateFormat::Rfc3339, DateTime::TimeFractionFormat::Truncate),
+      "2021-02-05T08:09:10Z");
+}
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/core/http/policies/policy.hpp"
+#include "azure/core/internal/http/pipeline.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+using namespace Azure::Core::Http;
+using namespace Azure::Core::Http::Policies;
+using namespace Azure::Core::Http::Policies::_internal;
+
+namespace {
+class TestTransportPolicy final : public HttpPolicy {
+private:
+  std::function<std::unique_ptr<RawResponse>(Azure::Core::Context const&)> m_send;
+
+public:
+  TestTransportPolicy(
+      std::function<std::unique_ptr<RawResponse>(Azure::Core::Context const&)> send)
+      : m_send(send)
+  {
+  }
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Request&,
+      NextHttpPolicy,
+      Azure::Core::Context const& context) const override
+  {
+    return m_send(context);
+  }
+
+  std::unique_ptr<HttpPolicy> Clone() const override
+  {
+    return std::make_unique<TestTransportPolicy>(*this);
+  }
+};
+
+Azure::Core::Http::_internal::HttpPipeline CreatePipeline(
+    HedgingOptions const& options,
+    std::function<std::unique_ptr<RawResponse>(Azure::Core::Context const&)> send)
+{
+  std::vector<std::unique_ptr<HttpPolicy>> policies;
+  policies.emplace_back(std::make_unique<HedgingPolicy>(options));
+  policies.emplace_back(std::make_unique<TestTransportPolicy>(send));
+  return Azure::Core::Http::_internal::HttpPipeline(policies);
+}
+
+std::unique_ptr<RawResponse> WaitUntilCancelled(Azure::Core::Context const& context)
+{
+  while (!context.IsCancelled())
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  context.ThrowIfCancelled();
+  return nullptr;
+}
+} // namespace
+
+TEST(HedgingPolicy, HedgeSlowRequest)
+{
+  HedgingOptions options;
+  options.Enabled = true;
+  options.MaxDelay = std::chrono::milliseconds(50);
+  std::atomic<int> sends{0};
+  std::atomic<bool> cancelled{false};
+  auto pipeline = CreatePipeline(options, [&](Azure::Core::Context const& context) {
+    if (sends++ == 0)
+    {
+      try
+      {
+        return WaitUntilCancelled(context);
+      }
+      catch (Azure::Core::OperationCancelledException const&)
+      {
+        cancelled = true;
+        throw;
+      }
+    }
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Accepted, "Accepted");
+  });
+
+  // The duplicate is answered first, the slow request is cancelled.
+  Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+  auto const start = std::chrono::steady_clock::now();
+  auto response = pipeline.Send(request, Azure::Core::Context::ApplicationContext);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+  EXPECT_EQ(response->GetStatusCode(), HttpStatusCode::Accepted);
+  EXPECT_EQ(sends, 2);
+  EXPECT_TRUE(cancelled);
+
+  // A request which fails after the duplicate was sent doesn't fail the call.
+  sends = 0;
+  auto failingPipeline = CreatePipeline(options, [&](Azure::Core::Context const&) {
+    if (sends++ == 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      throw TransportException("Connection reset.");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Accepted, "Accepted");
+  });
+  EXPECT_EQ(
+      failingPipeline.Send(request, Azure::Core::Context::ApplicationContext)->GetStatusCode(),
+      HttpStatusCode::Accepted);
+  EXPECT_EQ(sends, 2);
+
+  // The duplicate is cancelled if the caller's context is cancelled.
+  sends = 0;
+  auto blockingPipeline = CreatePipeline(options, WaitUntilCancelled);
+  Azure::Core::Context context;
+  std::thread canceller([&context]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    context.Cancel();
+  });
+  EXPECT_THROW(blockingPipeline.Send(request, context), Azure::Core::OperationCancelledException);
+  canceller.join();
+}
+
+TEST(HedgingPolicy, NotHedged)
+{
+  HedgingOptions options;
+  options.Enabled = true;
+  options.MaxDelay = std::chrono::milliseconds(10);
+  std::atomic<int> sends{0};
+  auto pipeline = CreatePipeline(options, [&](Azure::Core::Context const&) {
+    ++sends;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "OK");
+  });
+
+  // Only the requests without side effects are sent twice.
+  Request request(HttpMethod::Post, Azure::Core::Url("http://www.bing.com"));
+  EXPECT_EQ(
+      pipeline.Send(request, Azure::Core::Context::ApplicationContext)->GetStatusCode(),
+      HttpStatusCode::Ok);
+  EXPECT_EQ(sends, 1);
+
+  Request getRequest(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+  EXPECT_EQ(
+      pipeline.Send(getRequest, Azure::Core::Context::ApplicationContext)->GetStatusCode(),
+      HttpStatusCode::Ok);
+  EXPECT_EQ(sends, 3);
+
+  // A request answered before the delay never sends the duplicate, even once the delay elapsed.
+  options.MaxDelay = std::chrono::milliseconds(50);
+  sends = 0;
+  auto fastPipeline = CreatePipeline(options, [&](Azure::Core::Context const&) {
+    ++sends;
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "OK");
+  });
+  for (int i = 0; i < 10; ++i)
+  {
+    EXPECT_EQ(
+        fastPipeline.Send(getRequest, Azure::Core::Context::ApplicationContext)->GetStatusCode(),
+        HttpStatusCode::Ok);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(sends, 10);
+}
+
+TEST(HedgingPolicy, DelayFromResponseTimes)
+{
+  HedgingOptions options;
+  options.Enabled = true;
+  options.DelayPercentile = 50;
+  options.MinDelay = std::chrono::milliseconds(100);
+  options.MaxDelay = std::chrono::seconds(10);
+  std::atomic<int> sends{0};
+  std::atomic<bool> slow{false};
+  auto pipeline = CreatePipeline(options, [&](Azure::Core::Context const& context) {
+    ++sends;
+    if (slow.exchange(false))
+    {
+      return WaitUntilCancelled(context);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "OK");
+  });
+
+  Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+  for (int i = 0; i < 40; ++i)
+  {
+    pipeline.Send(request, Azure::Core::Context::ApplicationContext);
+  }
+  EXPECT_EQ(sends, 40);
+
+  // The duplicate is sent after the median of the response times, raised to MinDelay, instead of
+  // MaxDelay.
+  slow = true;
+  auto const start = std::chrono::steady_clock::now();
+  EXPECT_EQ(
+      pipeline.Send(request, Azure::Core::Context::ApplicationContext)->GetStatusCode(),
+      HttpStatusCode::Ok);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+  EXPECT_EQ(sends, 42);
+}
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "gtest/gtest.h"
+
+#include "azure/core/internal/cryptography/hmac.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace Azure::Core::Cryptography::_internal;
+
+namespace {
+std::vector<uint8_t> ToBinary(const std::string& text)
+{
+  return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+std::string ToHex(const std::vector<uint8_t>& data)
+{
+  static const char Digits[] = "0123456789abcdef";
+  std::string hex;
+  for (auto const byte : data)
+  {
+    hex += Digits[byte >> 4];
+    hex += Digits[byte & 0x0F];
+  }
+  return hex;
+}
+} // namespace
+
+TEST(HmacSha256, Final)
+{
+  // RFC 4231, test case 2.
+  HmacSha256 hmac(ToBinary("Jefe"));
+  auto const data = ToBinary("what do ya want for nothing?");
+  EXPECT_EQ(
+      ToHex(hmac.Final(data.data(), data.size())),
+      "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+  HmacSha256 emptyKey(std::vector<uint8_t>{});
+  EXPECT_EQ(
+      ToHex(emptyKey.Final()), "b613679a0814d9ec772f95d778c35fc5ff1697c493715653c6c712144292c5ad");
+}
+
+TEST(HmacSha256, Append)
+{
+  HmacSha256 hmac(ToBinary("Jefe"));
+  auto const data = ToBinary("what do ya want for nothing?");
+  hmac.Append(data.data(), 4);
+  hmac.Append(data.data() + 4, 0);
+  hmac.Append(data.data() + 4, 10);
+  EXPECT_EQ(
+      ToHex(hmac.Final(data.data() + 14, data.size() - 14)),
+      "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+}
+
+TEST(HmacSha256, Reset)
+{
+  HmacSha256 hmac(ToBinary("Jefe"));
+  auto const data = ToBinary("what do ya want for nothing?");
+  auto const other = ToBinary("something else");
+
+  hmac.Append(other.data(), other.size());
+  hmac.Reset();
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_EQ(
+        ToHex(hmac.Final(data.data(), data.size())),
+        "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    hmac.Reset();
+  }
+}
+
+TEST(HmacSha256, Copy)
+{
+  HmacSha256 hmac(ToBinary("Jefe"));
+  auto const data = ToBinary("what do ya want for nothing?");
+  hmac.Append(data.data(), 10);
+
+  HmacSha256 copy(hmac);
+  EXPECT_EQ(
+      ToHex(copy.Final(data.data() + 10, data.size() - 10)),
+      "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+  // The copy keeps the key after being reset.
+  copy.Reset();
+  EXPECT_EQ(
+      copy.Final(data.data(), data.size()), hmac.Final(data.data() + 10, data.size() - 10));
+}
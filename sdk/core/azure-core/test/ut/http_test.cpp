@@ -219,4 +219,82 @@ namespace Azure { namespace Core { namespace Test {
     }
   }
 
+  TEST(TestHttp, RequestHelpers)
+  {
+    using Azure::Core::Http::_detail::RequestHelpers;
+
+    Http::Request req(Http::HttpMethod::Get, Url("http://test.com"));
+    req.SetHeader("b", "original");
+    req.SetHeader("D", "original");
+    req.SetHeader("f", "original");
+
+    req.StartTry();
+    req.SetHeader("a", "retry");
+    req.SetHeader("d", "retry");
+    req.SetHeader("g", "retry");
+
+    std::vector<std::pair<std::string, std::string>> visited;
+    auto const visit = [&visited](std::string const& name, std::string const& value) {
+      visited.emplace_back(name, value);
+    };
+    RequestHelpers::ForEachHeader(req, visit);
+    auto const headers = req.GetHeaders();
+    std::vector<std::pair<std::string, std::string>> expected(headers.begin(), headers.end());
+    EXPECT_EQ(visited, expected);
+    EXPECT_EQ(visited.size(), 5U);
+
+    ASSERT_NE(RequestHelpers::FindHeader(req, "D"), nullptr);
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "D"), "retry");
+    ASSERT_NE(RequestHelpers::FindHeader(req, "f"), nullptr);
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "f"), "original");
+    EXPECT_EQ(RequestHelpers::FindHeader(req, "c"), nullptr);
+
+    // A new try drops the headers of the previous one.
+    req.StartTry();
+    visited.clear();
+    RequestHelpers::ForEachHeader(req, visit);
+    EXPECT_EQ(visited.size(), 3U);
+    ASSERT_NE(RequestHelpers::FindHeader(req, "d"), nullptr);
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "d"), "original");
+  }
+
+  TEST(TestHttp, RequestStaticHeaders)
+  {
+    using Azure::Core::Http::_detail::RequestHelpers;
+    auto const staticHeaders = std::make_shared<CaseInsensitiveMap const>(
+        CaseInsensitiveMap{{"a", "static"}, {"c", "static"}, {"e", "static"}});
+
+    Http::Request req(Http::HttpMethod::Get, Url("http://test.com"));
+    RequestHelpers::SetStaticHeaders(req, staticHeaders);
+    req.SetHeader("C", "original");
+    req.SetHeader("d", "original");
+    req.StartTry();
+    req.SetHeader("e", "retry");
+
+    std::vector<std::pair<std::string, std::string>> visited;
+    RequestHelpers::ForEachHeader(
+        req, [&visited](std::string const& name, std::string const& value) {
+          visited.emplace_back(name, value);
+        });
+    auto const headers = req.GetHeaders();
+    std::vector<std::pair<std::string, std::string>> expected(headers.begin(), headers.end());
+    EXPECT_EQ(visited, expected);
+    EXPECT_EQ(
+        visited,
+        (std::vector<std::pair<std::string, std::string>>{
+            {"a", "static"}, {"c", "original"}, {"d", "original"}, {"e", "retry"}}));
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "A"), "static");
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "c"), "original");
+
+    // Removing a static header keeps the other ones, and doesn't change the shared headers.
+    req.RemoveHeader("a");
+    EXPECT_EQ(RequestHelpers::FindHeader(req, "a"), nullptr);
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "c"), "original");
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "e"), "retry");
+    req.StartTry();
+    EXPECT_EQ(*RequestHelpers::FindHeader(req, "e"), "static");
+    EXPECT_EQ(req.GetHeaders().size(), 3U);
+    EXPECT_EQ(staticHeaders->size(), 3U);
+  }
+
 }}} // namespace Azure::Core::Test
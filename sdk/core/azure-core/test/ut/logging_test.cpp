@@ -4,6 +4,13 @@
 #include <azure/core/internal/diagnostics/log.hpp>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
 using Azure::Core::Diagnostics::Logger;
 using Azure::Core::Diagnostics::_internal::Log;
 
@@ -201,3 +208,78 @@ TEST(Logger, Message)
     throw;
   }
 }
+
+TEST(Logger, ListenerReplacedWhileWriting)
+{
+  std::atomic<int> firstCount(0);
+  std::atomic<int> secondCount(0);
+  Logger::SetLevel(Logger::Level::Verbose);
+  Logger::SetListener([&](auto, auto) { ++firstCount; });
+
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> writers;
+  for (auto i = 0; i < 4; ++i)
+  {
+    writers.emplace_back([&]() {
+      while (!stop)
+      {
+        Log::Write(Logger::Level::Verbose, "Verbose");
+      }
+    });
+  }
+
+  for (auto i = 0; i < 1000; ++i)
+  {
+    Logger::SetListener([&](auto, auto) { ++secondCount; });
+    Logger::SetListener(nullptr);
+    Logger::SetListener([&](auto, auto) { ++firstCount; });
+  }
+  stop = true;
+  for (auto& writer : writers)
+  {
+    writer.join();
+  }
+
+  auto const count = firstCount + secondCount;
+  Log::Write(Logger::Level::Verbose, "Verbose");
+  EXPECT_EQ(firstCount + secondCount, count + 1);
+
+  Logger::SetListener(nullptr);
+  Logger::SetLevel(Logger::Level::Warning);
+  Log::Write(Logger::Level::Error, "Error");
+  EXPECT_EQ(firstCount + secondCount, count + 1);
+}
+
+TEST(Logger, SetListenerWaitsForListenerCalls)
+{
+  std::promise<void> called;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::atomic<bool> returned(false);
+  Logger::SetLevel(Logger::Level::Verbose);
+  {
+    // The state of the listener is gone once SetListener() returns.
+    std::string const scoped("scoped");
+    Logger::SetListener([&, released](auto, auto) {
+      called.set_value();
+      released.wait();
+      EXPECT_EQ(scoped, "scoped");
+      EXPECT_FALSE(returned);
+    });
+
+    std::thread writer([]() { Log::Write(Logger::Level::Verbose, "Verbose"); });
+    called.get_future().wait();
+    std::thread setter([&]() {
+      Logger::SetListener(nullptr);
+      returned = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(returned);
+    release.set_value();
+    setter.join();
+    writer.join();
+    EXPECT_TRUE(returned);
+  }
+  Logger::SetLevel(Logger::Level::Warning);
+}
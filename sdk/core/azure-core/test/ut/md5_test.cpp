@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <azure/core/base64.hpp>
 #include <azure/core/cryptography/hash.hpp>
+#include <azure/core/internal/cryptography/md5_multi_buffer.hpp>
 #include <chrono>
 #include <gtest/gtest.h>
 #include <random>
@@ -157,3 +158,46 @@ TEST(Md5Hash, multiThread)
     pool[counter].join();
   }
 }
+
+TEST(Md5Hash, MultiBuffer)
+{
+  using Azure::Core::Cryptography::_internal::ComputeMd5MultiBuffer;
+
+  EXPECT_EQ(
+      Azure::Core::Convert::Base64Encode(ComputeMd5MultiBuffer(nullptr, 0)),
+      "1B2M2Y8AsgTpgAmY7PhCfg==");
+
+  // Lengths around the block size and around the room left for the padding, small ones hashed on
+  // their own, and large ones hashed across several rounds of the lanes.
+  auto data = RandomBuffer(static_cast<size_t>(4194304 + 128));
+  std::vector<size_t> lengths = {0, 1, 55, 56, 63, 64, 1000};
+  for (size_t base : {16384, 65536, 100000, 1048576, 4194304})
+  {
+    for (size_t delta : {0, 1, 55, 56, 63, 64})
+    {
+      lengths.push_back(base + delta);
+    }
+  }
+
+  // A buffer hashed while no other one is.
+  EXPECT_EQ(ComputeMd5MultiBuffer(data.data(), 100000), Md5Hash().Final(data.data(), 100000));
+
+  // The threads start together so that their buffers are hashed in the same lanes.
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 16; ++i)
+  {
+    threads.emplace_back([&data, &lengths, i]() {
+      for (size_t j = 0; j < lengths.size(); ++j)
+      {
+        const size_t length = lengths[(i + j) % lengths.size()];
+        const uint8_t* buffer = data.data() + i;
+        EXPECT_EQ(ComputeMd5MultiBuffer(buffer, length), Md5Hash().Final(buffer, length))
+            << length;
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+}
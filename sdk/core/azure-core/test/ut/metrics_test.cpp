@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/diagnostics/metrics.hpp>
+#include <azure/core/http/policies/policy.hpp>
+#include <azure/core/http/transport.hpp>
+#include <azure/core/internal/client_options.hpp>
+#include <azure/core/internal/http/pipeline.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Azure::Core::Context;
+using Azure::Core::Diagnostics::LatencyHistogram;
+using Azure::Core::Diagnostics::MetricsAggregator;
+using Azure::Core::Diagnostics::OperationMetrics;
+using Azure::Core::Diagnostics::RequestMetrics;
+using Azure::Core::Diagnostics::_internal::OperationName;
+using namespace Azure::Core::Http;
+
+namespace {
+class TestTransport final : public HttpTransport {
+private:
+  std::function<std::unique_ptr<RawResponse>(Request&)> m_send;
+
+public:
+  explicit TestTransport(std::function<std::unique_ptr<RawResponse>(Request&)> send)
+      : m_send(std::move(send))
+  {
+  }
+
+  std::unique_ptr<RawResponse> Send(Request& request, Context const&) override
+  {
+    return m_send(request);
+  }
+};
+
+std::unique_ptr<RawResponse> CreateResponse(HttpStatusCode statusCode, std::string const& body)
+{
+  static std::vector<std::string> bodies;
+  bodies.push_back(body);
+  auto response = std::make_unique<RawResponse>(1, 1, statusCode, "");
+  response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+      reinterpret_cast<uint8_t const*>(bodies.back().data()), bodies.back().size()));
+  return response;
+}
+
+Azure::Core::Http::_internal::HttpPipeline CreatePipeline(
+    std::function<void(RequestMetrics const&)> listener,
+    std::function<std::unique_ptr<RawResponse>(Request&)> send)
+{
+  Azure::Core::_internal::ClientOptions options;
+  options.Retry.RetryDelay = std::chrono::milliseconds(1);
+  options.Retry.MaxRetryDelay = std::chrono::milliseconds(1);
+  options.Metrics.Listener = std::move(listener);
+  options.Transport.Transport = std::make_shared<TestTransport>(std::move(send));
+  return Azure::Core::Http::_internal::HttpPipeline(options, "test-client", "1.0.0", {}, {});
+}
+} // namespace
+
+TEST(LatencyHistogram, Percentiles)
+{
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetPercentile(50).count(), 0);
+
+  for (auto i = 1; i <= 1000; ++i)
+  {
+    histogram.Record(std::chrono::microseconds(i));
+  }
+  EXPECT_EQ(histogram.GetCount(), 1000);
+  EXPECT_EQ(histogram.GetSum().count(), 500500);
+  EXPECT_EQ(histogram.GetMax().count(), 1000);
+  EXPECT_EQ(histogram.GetPercentile(0).count(), 1);
+  EXPECT_EQ(histogram.GetPercentile(100).count(), 1000);
+
+  for (auto percentile : {10.0, 50.0, 90.0, 99.0})
+  {
+    auto const value = static_cast<double>(histogram.GetPercentile(percentile).count());
+    EXPECT_GE(value, percentile * 10);
+    EXPECT_LE(value, percentile * 10 * 1.0625);
+  }
+
+  histogram.Record(std::chrono::microseconds(-1));
+  histogram.Record(std::chrono::hours(24 * 365));
+  EXPECT_EQ(histogram.GetCount(), 1002);
+  EXPECT_EQ(histogram.GetPercentile(0).count(), 0);
+  EXPECT_EQ(histogram.GetPercentile(100), std::chrono::hours(24 * 365));
+}
+
+TEST(LatencyHistogram, RecordConcurrently)
+{
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&histogram]() {
+      for (auto j = 0; j < 10000; ++j)
+      {
+        histogram.Record(std::chrono::microseconds(j));
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(histogram.GetCount(), 40000);
+  EXPECT_EQ(histogram.GetMax().count(), 9999);
+}
+
+TEST(LatencyHistogram, Merge)
+{
+  LatencyHistogram first;
+  LatencyHistogram second;
+  for (auto i = 1; i <= 100; ++i)
+  {
+    first.Record(std::chrono::microseconds(i));
+    second.Record(std::chrono::microseconds(i + 100));
+  }
+
+  first.Merge(second);
+  EXPECT_EQ(first.GetCount(), 200);
+  EXPECT_EQ(first.GetSum().count(), 20100);
+  EXPECT_EQ(first.GetMax().count(), 200);
+  EXPECT_EQ(first.GetPercentile(0).count(), 1);
+  EXPECT_GE(first.GetPercentile(75).count(), 150);
+  EXPECT_EQ(second.GetCount(), 100);
+}
+
+TEST(MetricsPolicy, RequestWithRetry)
+{
+  std::vector<RequestMetrics> recorded;
+  auto sends = 0;
+  auto pipeline = CreatePipeline(
+      [&](RequestMetrics const& metrics) { recorded.push_back(metrics); },
+      [&](Request&) {
+        return ++sends == 1 ? CreateResponse(HttpStatusCode::ServiceUnavailable, "")
+                            : CreateResponse(HttpStatusCode::Ok, "response");
+      });
+
+  std::vector<uint8_t> const body(10);
+  Azure::Core::IO::MemoryBodyStream bodyStream(body);
+  Request request(HttpMethod::Put, Azure::Core::Url("https://account.test/path"), &bodyStream);
+  auto response = pipeline.Send(request, OperationName::With(Context(), "Upload"));
+  EXPECT_EQ(response->GetStatusCode(), HttpStatusCode::Ok);
+
+  ASSERT_EQ(recorded.size(), 1U);
+  auto const& metrics = recorded[0];
+  EXPECT_EQ(metrics.ClientName, "test-client");
+  EXPECT_EQ(metrics.OperationName, "Upload");
+  EXPECT_EQ(metrics.StatusCode.Value(), HttpStatusCode::Ok);
+  EXPECT_EQ(metrics.RetryCount, 1);
+  EXPECT_TRUE(metrics.TimeToFirstByte.HasValue());
+  EXPECT_GE(metrics.Duration, metrics.TimeToFirstByte.Value());
+  EXPECT_EQ(metrics.BytesSent, 10);
+  EXPECT_EQ(metrics.BytesReceived, 8);
+  // The test transport doesn't tell about its connections.
+  EXPECT_FALSE(metrics.IsConnectionReused.HasValue());
+  EXPECT_FALSE(metrics.NameLookup.HasValue());
+}
+
+TEST(MetricsPolicy, FailedRequest)
+{
+  std::vector<RequestMetrics> recorded;
+  auto pipeline = CreatePipeline(
+      [&](RequestMetrics const& metrics) {
+        recorded.push_back(metrics);
+        throw std::runtime_error("Listener error");
+      },
+      [](Request&) -> std::unique_ptr<RawResponse> {
+        throw TransportException("Connection refused");
+      });
+
+  Request request(HttpMethod::Get, Azure::Core::Url("https://account.test/path"));
+  EXPECT_THROW(pipeline.Send(request, Context()), TransportException);
+
+  ASSERT_EQ(recorded.size(), 1U);
+  EXPECT_EQ(recorded[0].OperationName, "GET");
+  EXPECT_FALSE(recorded[0].StatusCode.HasValue());
+  EXPECT_EQ(recorded[0].RetryCount, 3);
+  EXPECT_FALSE(recorded[0].TimeToFirstByte.HasValue());
+}
+
+TEST(MetricsPolicy, DisabledWithoutListener)
+{
+  auto sends = 0;
+  auto pipeline = CreatePipeline(nullptr, [&](Request&) {
+    ++sends;
+    return CreateResponse(HttpStatusCode::Ok, "");
+  });
+
+  Request request(HttpMethod::Get, Azure::Core::Url("https://account.test/path"));
+  EXPECT_EQ(pipeline.Send(request, Context())->GetStatusCode(), HttpStatusCode::Ok);
+  EXPECT_EQ(sends, 1);
+}
+
+TEST(MetricsAggregator, ByClientAndOperation)
+{
+  MetricsAggregator aggregator;
+  auto const listener = aggregator.GetListener();
+
+  RequestMetrics metrics;
+  metrics.ClientName = "blob";
+  metrics.OperationName = "Download";
+  metrics.StatusCode = HttpStatusCode::Ok;
+  metrics.Duration = std::chrono::milliseconds(10);
+  metrics.TimeToFirstByte = std::chrono::milliseconds(5);
+  metrics.IsConnectionReused = true;
+  metrics.BytesReceived = 100;
+  listener(metrics);
+  listener(metrics);
+
+  metrics.StatusCode = HttpStatusCode::NotFound;
+  metrics.IsConnectionReused = false;
+  metrics.RetryCount = 2;
+  listener(metrics);
+
+  metrics.OperationName = "Upload";
+  metrics.StatusCode.Reset();
+  metrics.TimeToFirstByte.Reset();
+  metrics.BytesSent = 50;
+  aggregator.Record(metrics);
+
+  std::vector<std::string> operations;
+  aggregator.Export([&](std::string const& clientName,
+                        std::string const& operationName,
+                        OperationMetrics const& operation) {
+    EXPECT_EQ(clientName, "blob");
+    operations.push_back(operationName);
+    if (operationName == "Download")
+    {
+      EXPECT_EQ(operation.RequestCount, 3);
+      EXPECT_EQ(operation.FailedRequestCount, 1);
+      EXPECT_EQ(operation.RetryCount, 2);
+      EXPECT_EQ(operation.ReusedConnectionCount, 2);
+      EXPECT_EQ(operation.NewConnectionCount, 1);
+      EXPECT_EQ(operation.BytesReceived, 300);
+      EXPECT_EQ(operation.Duration.GetCount(), 3);
+      EXPECT_EQ(operation.TimeToFirstByte.GetMax(), std::chrono::milliseconds(5));
+    }
+    else
+    {
+      EXPECT_EQ(operation.RequestCount, 1);
+      EXPECT_EQ(operation.FailedRequestCount, 1);
+      EXPECT_EQ(operation.BytesSent, 50);
+      EXPECT_EQ(operation.TimeToFirstByte.GetCount(), 0);
+    }
+  });
+  EXPECT_EQ(operations, (std::vector<std::string>{"Download", "Upload"}));
+}
@@ -216,6 +216,17 @@ TEST(Nullable, Operator)
   EXPECT_EQ(*val1, "12345aaaa");
 }
 
+TEST(Nullable, Emplace)
+{
+  Nullable<std::string> val;
+  EXPECT_EQ(val.Emplace(3, 'a'), "aaa");
+  EXPECT_TRUE(val.HasValue());
+  EXPECT_EQ(val.Value(), "aaa");
+
+  val.Emplace("b");
+  EXPECT_EQ(val.Value(), "b");
+}
+
 TEST(Nullable, Move)
 {
   Nullable<std::unique_ptr<int>> val(std::make_unique<int>(123));
@@ -10,6 +10,7 @@
 #include <azure/core/operation_status.hpp>
 
 #include <chrono>
+#include <thread>
 
 using namespace Azure::Core;
 using namespace Azure::Core::Test;
@@ -107,3 +108,40 @@ TEST(Operation, ResumeToken)
     }
   }
 }
+
+TEST(Operation, PollDelay)
+{
+  // The period doubles after each poll, up to the maximum.
+  EXPECT_EQ(_internal::GetPollDelay(nullptr, 1s, 1), 1s);
+  EXPECT_EQ(_internal::GetPollDelay(nullptr, 1s, 2), 2s);
+  EXPECT_EQ(_internal::GetPollDelay(nullptr, 1s, 4), 8s);
+  EXPECT_EQ(_internal::GetPollDelay(nullptr, 1s, 100), _internal::MaxPollPeriod);
+  EXPECT_EQ(_internal::GetPollDelay(nullptr, 60s, 3), 60s);
+
+  // The delay asked for by the service is used as is.
+  Http::RawResponse response(1, 1, Http::HttpStatusCode::Accepted, "Accepted");
+  EXPECT_EQ(_internal::GetPollDelay(&response, 1s, 3), 4s);
+  response.SetHeader("retry-after", "10");
+  EXPECT_EQ(_internal::GetPollDelay(&response, 1s, 3), 10s);
+  response.SetHeader("retry-after-ms", "50");
+  EXPECT_EQ(_internal::GetPollDelay(&response, 1s, 3), 50ms);
+
+  // A date isn't supported, the period backs off.
+  Http::RawResponse dateResponse(1, 1, Http::HttpStatusCode::Accepted, "Accepted");
+  dateResponse.SetHeader("retry-after", "Fri, 31 Dec 1999 23:59:59 GMT");
+  EXPECT_EQ(_internal::GetPollDelay(&dateResponse, 1s, 2), 2s);
+}
+
+TEST(Operation, PollDelayCancelled)
+{
+  auto context = Context::ApplicationContext.WithDeadline(Azure::DateTime::clock::now() + 1h);
+  std::thread cancelThread([&context]() {
+    std::this_thread::sleep_for(100ms);
+    context.Cancel();
+  });
+
+  auto const start = std::chrono::steady_clock::now();
+  EXPECT_THROW(_internal::WaitForPollDelay(10s, context), OperationCancelledException);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  cancelThread.join();
+}
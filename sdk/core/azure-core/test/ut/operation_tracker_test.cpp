@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/context.hpp>
+#include <azure/core/operation_tracker.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Azure::Core;
+using namespace std::literals;
+
+namespace {
+struct PollCounters final
+{
+  std::atomic<int32_t> Polls{0};
+  std::atomic<int32_t> InFlight{0};
+  std::atomic<int32_t> MaxInFlight{0};
+};
+
+// Succeeds with its id after a number of polls, or fails when the id is negative.
+class CountingOperation final : public Operation<int32_t> {
+private:
+  int32_t m_id;
+  int32_t m_pollsLeft;
+  PollCounters& m_counters;
+
+  std::unique_ptr<Http::RawResponse> PollInternal(Context const&) override
+  {
+    ++m_counters.Polls;
+    const int32_t inFlight = ++m_counters.InFlight;
+    int32_t maxInFlight = m_counters.MaxInFlight;
+    while (inFlight > maxInFlight
+           && !m_counters.MaxInFlight.compare_exchange_weak(maxInFlight, inFlight))
+    {
+    }
+    std::this_thread::sleep_for(5ms);
+    --m_counters.InFlight;
+
+    auto response = std::make_unique<Http::RawResponse>(1, 1, Http::HttpStatusCode::Ok, "OK");
+    if (--m_pollsLeft == 0)
+    {
+      m_status = m_id < 0 ? OperationStatus::Failed : OperationStatus::Succeeded;
+    }
+    else
+    {
+      // The service asks for the next poll soon.
+      response->SetHeader("retry-after-ms", "10");
+    }
+    return response;
+  }
+
+  Azure::Response<int32_t> PollUntilDoneInternal(std::chrono::milliseconds, Context&) override
+  {
+    throw std::logic_error("Not used by the tracker.");
+  }
+
+  Http::RawResponse const& GetRawResponseInternal() const override { return *m_rawResponse; }
+
+public:
+  CountingOperation(int32_t id, int32_t polls, PollCounters& counters)
+      : m_id(id), m_pollsLeft(polls), m_counters(counters)
+  {
+    m_status = OperationStatus::Running;
+  }
+
+  std::string GetResumeToken() const override { return std::to_string(m_id); }
+
+  int32_t Value() const override { return m_id; }
+};
+} // namespace
+
+TEST(OperationTracker, CompletesTheOperations)
+{
+  PollCounters counters;
+  OperationTrackerOptions options;
+  options.PollPeriod = 10ms;
+  options.MaxConcurrentPolls = 4;
+  OperationTracker<int32_t> tracker(options);
+
+  std::vector<std::future<int32_t>> results;
+  for (int32_t i = 0; i < 50; ++i)
+  {
+    results.push_back(tracker.Track(std::make_unique<CountingOperation>(i, 3, counters)));
+  }
+  auto failed = tracker.Track(std::make_unique<CountingOperation>(-1, 1, counters));
+
+  for (int32_t i = 0; i < 50; ++i)
+  {
+    EXPECT_EQ(results[i].get(), i);
+  }
+  EXPECT_THROW(failed.get(), RequestFailedException);
+  EXPECT_EQ(counters.Polls, 151);
+  EXPECT_GT(counters.MaxInFlight, 1);
+  EXPECT_LE(counters.MaxInFlight, 4);
+  EXPECT_EQ(tracker.PendingOperations(), 0U);
+}
+
+TEST(OperationTracker, CallsTheCallbacks)
+{
+  PollCounters counters;
+  OperationTrackerOptions options;
+  options.PollPeriod = 10ms;
+  std::atomic<int32_t> completed{0};
+  std::atomic<int32_t> cancelled{0};
+  {
+    OperationTracker<int32_t> tracker(options);
+    auto const onCompleted = [&](Operation<int32_t>& operation, std::exception_ptr error) {
+      if (error)
+      {
+        EXPECT_THROW(std::rethrow_exception(error), OperationCancelledException);
+        ++cancelled;
+        return;
+      }
+      EXPECT_TRUE(operation.HasValue());
+      ++completed;
+    };
+    tracker.Track(std::make_unique<CountingOperation>(1, 2, counters), onCompleted);
+
+    // Never done, cancelled when the tracker is destroyed.
+    tracker.Track(std::make_unique<CountingOperation>(2, 1000, counters), onCompleted);
+
+    // Cancelled by its context.
+    auto context = Context::ApplicationContext.WithDeadline(Azure::DateTime::clock::now() + 1h);
+    tracker.Track(std::make_unique<CountingOperation>(3, 1000, counters), onCompleted, context);
+    context.Cancel();
+
+    while (tracker.PendingOperations() > 1)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+  EXPECT_EQ(completed, 1);
+  EXPECT_EQ(cancelled, 2);
+}
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/paged_response.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+// Pages of the numbers from 0 to PageCount * 2 - 1, two per page. The token of a page is its
+// index.
+struct PagedNumbersSource
+{
+  int PageCount = 0;
+  std::atomic<int> FetchCount{0};
+  std::atomic<int> FailingPage{-1};
+  std::chrono::milliseconds FetchDelay{0};
+};
+
+class PagedNumbers final : public Azure::Core::PagedResponse<PagedNumbers> {
+public:
+  std::vector<int> Numbers;
+
+  explicit PagedNumbers(std::shared_ptr<PagedNumbersSource> source) : m_source(std::move(source))
+  {
+    Load(0);
+  }
+
+private:
+  void Load(int page)
+  {
+    Numbers = {page * 2, page * 2 + 1};
+    CurrentPageToken = std::to_string(page);
+    NextPageToken = page + 1 < m_source->PageCount ? std::to_string(page + 1) : std::string();
+  }
+
+  void OnNextPage(const Azure::Core::Context& context)
+  {
+    context.ThrowIfCancelled();
+    std::this_thread::sleep_for(m_source->FetchDelay);
+    const int page = std::stoi(NextPageToken.Value());
+    ++m_source->FetchCount;
+    if (page == m_source->FailingPage)
+    {
+      m_source->FailingPage = -1;
+      throw std::runtime_error("Failed to fetch the page.");
+    }
+    Load(page);
+  }
+
+  std::shared_ptr<PagedNumbersSource> m_source;
+
+  friend class Azure::Core::PagedResponse<PagedNumbers>;
+};
+} // namespace
+
+TEST(PagedResponse, MoveToNextPage)
+{
+  auto source = std::make_shared<PagedNumbersSource>();
+  source->PageCount = 3;
+  std::vector<int> numbers;
+  for (PagedNumbers page(source); page.HasPage(); page.MoveToNextPage())
+  {
+    numbers.insert(numbers.end(), page.Numbers.begin(), page.Numbers.end());
+  }
+  EXPECT_EQ(numbers, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(source->FetchCount, 2);
+}
+
+TEST(PagedResponse, Prefetch)
+{
+  auto source = std::make_shared<PagedNumbersSource>();
+  source->PageCount = 4;
+  source->FetchDelay = std::chrono::milliseconds(50);
+  std::vector<int> numbers;
+  PagedNumbers page(source);
+  page.EnablePrefetch();
+  for (; page.HasPage(); page.MoveToNextPage())
+  {
+    // The next page is fetched while the current one is processed.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(source->FetchCount, std::min(std::stoi(page.CurrentPageToken) + 1, 3));
+    numbers.insert(numbers.end(), page.Numbers.begin(), page.Numbers.end());
+    // Changing the current page doesn't change the next one.
+    page.Numbers.clear();
+  }
+  EXPECT_EQ(numbers, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+  EXPECT_EQ(source->FetchCount, 3);
+}
+
+TEST(PagedResponse, PrefetchFailure)
+{
+  auto source = std::make_shared<PagedNumbersSource>();
+  source->PageCount = 3;
+  source->FailingPage = 1;
+  PagedNumbers page(source);
+  page.EnablePrefetch();
+  EXPECT_THROW(page.MoveToNextPage(), std::runtime_error);
+  // The current page is kept, and the next page is fetched again.
+  EXPECT_EQ(page.CurrentPageToken, "0");
+  EXPECT_EQ(page.Numbers, (std::vector<int>{0, 1}));
+  page.MoveToNextPage();
+  EXPECT_EQ(page.CurrentPageToken, "1");
+  page.MoveToNextPage();
+  EXPECT_EQ(page.CurrentPageToken, "2");
+  page.MoveToNextPage();
+  EXPECT_FALSE(page.HasPage());
+}
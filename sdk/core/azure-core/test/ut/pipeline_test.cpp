@@ -2,11 +2,141 @@
 // SPDX-License-Identifier: MIT
 
 #include <azure/core/http/policies/policy.hpp>
+#include <azure/core/http/traffic_class.hpp>
 #include <azure/core/internal/http/pipeline.hpp>
+#include <azure/core/io/body_stream.hpp>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <stdexcept>
 #include <vector>
 
+namespace {
+// A transport which completes the requests sent asynchronously when the test asks it to, like a
+// transport driving its requests from its own threads.
+class DeferredTransport final : public Azure::Core::Http::HttpTransport {
+  std::mutex m_mutex;
+  std::condition_variable m_requestSent;
+  std::deque<Azure::Core::Http::ResponseCallback> m_callbacks;
+
+public:
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request&,
+      Azure::Core::Context const&) override
+  {
+    throw std::logic_error("The requests must be sent asynchronously.");
+  }
+
+  void SendAsync(
+      Azure::Core::Http::Request&,
+      Azure::Core::Context const&,
+      Azure::Core::Http::ResponseCallback callback) override
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_callbacks.push_back(std::move(callback));
+    }
+    m_requestSent.notify_all();
+  }
+
+  // Waits for the next request sent, and returns the callback completing it.
+  Azure::Core::Http::ResponseCallback WaitForRequest()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_requestSent.wait_for(
+            lock, std::chrono::seconds(10), [this]() { return !m_callbacks.empty(); }))
+    {
+      throw std::runtime_error("No request was sent.");
+    }
+    auto callback = std::move(m_callbacks.front());
+    m_callbacks.pop_front();
+    return callback;
+  }
+};
+
+std::unique_ptr<Azure::Core::Http::_internal::HttpPipeline> CreateDeferredPipeline(
+    std::shared_ptr<DeferredTransport> transport)
+{
+  Azure::Core::_internal::ClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  options.Retry.RetryDelay = std::chrono::milliseconds(1);
+  return std::make_unique<Azure::Core::Http::_internal::HttpPipeline>(
+      options,
+      "test",
+      "1.0",
+      std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>(),
+      std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>());
+}
+
+class TestTransportPolicy final : public Azure::Core::Http::Policies::HttpPolicy {
+public:
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Http::Policies::NextHttpPolicy,
+      Azure::Core::Context const& context) const override
+  {
+    context.ThrowIfCancelled();
+    if (request.GetUrl().GetHost() == "fail")
+    {
+      throw std::runtime_error("transport failed");
+    }
+    return std::make_unique<Azure::Core::Http::RawResponse>(
+        1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+  }
+
+  std::unique_ptr<HttpPolicy> Clone() const override
+  {
+    return std::make_unique<TestTransportPolicy>(*this);
+  }
+};
+
+class HeaderCapturePolicy final : public Azure::Core::Http::Policies::HttpPolicy {
+public:
+  std::shared_ptr<Azure::Core::CaseInsensitiveMap> Headers
+      = std::make_shared<Azure::Core::CaseInsensitiveMap>();
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Http::Policies::NextHttpPolicy nextPolicy,
+      Azure::Core::Context const& context) const override
+  {
+    *Headers = request.GetHeaders();
+    return nextPolicy.Send(request, context);
+  }
+
+  std::unique_ptr<HttpPolicy> Clone() const override
+  {
+    return std::make_unique<HeaderCapturePolicy>(*this);
+  }
+};
+
+// Captures the traffic class of the context of the last request.
+class TrafficClassCapturePolicy final : public Azure::Core::Http::Policies::HttpPolicy {
+public:
+  std::shared_ptr<Azure::Nullable<Azure::Core::Http::TrafficClass>> TrafficClass
+      = std::make_shared<Azure::Nullable<Azure::Core::Http::TrafficClass>>();
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Http::Policies::NextHttpPolicy nextPolicy,
+      Azure::Core::Context const& context) const override
+  {
+    *TrafficClass = Azure::Core::Http::GetTrafficClass(context);
+    return nextPolicy.Send(request, context);
+  }
+
+  std::unique_ptr<HttpPolicy> Clone() const override
+  {
+    return std::make_unique<TrafficClassCapturePolicy>(*this);
+  }
+};
+} // namespace
+
 TEST(Pipeline, createPipeline)
 {
   // Construct pipeline without exception
@@ -51,3 +181,300 @@ TEST(Pipeline, refrefEmptyPipeline)
           std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>(0)),
       std::invalid_argument);
 }
+
+TEST(Pipeline, sendAsync)
+{
+  std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> policies;
+  policies.push_back(
+      std::make_unique<Azure::Core::Http::Policies::_internal::TelemetryPolicy>("test", "test"));
+  policies.push_back(std::make_unique<TestTransportPolicy>());
+  Azure::Core::Http::_internal::HttpPipeline pipeline(policies);
+
+  std::vector<std::unique_ptr<Azure::Core::Http::Request>> requests;
+  for (int i = 0; i < 4; i++)
+  {
+    requests.emplace_back(std::make_unique<Azure::Core::Http::Request>(
+        Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com")));
+  }
+
+  std::vector<std::future<std::unique_ptr<Azure::Core::Http::RawResponse>>> responses;
+  for (auto& request : requests)
+  {
+    responses.emplace_back(pipeline.SendAsync(*request, Azure::Core::Context()));
+  }
+
+  for (auto& response : responses)
+  {
+    EXPECT_EQ(response.get()->GetStatusCode(), Azure::Core::Http::HttpStatusCode::Ok);
+  }
+  // The policies ran on the request sent asynchronously.
+  EXPECT_EQ(requests[0]->GetHeaders().count("user-agent"), 1U);
+}
+
+TEST(Pipeline, sendAsyncException)
+{
+  std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> policies;
+  policies.push_back(std::make_unique<TestTransportPolicy>());
+  Azure::Core::Http::_internal::HttpPipeline pipeline(policies);
+
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://fail"));
+  auto response = pipeline.SendAsync(request, Azure::Core::Context());
+  EXPECT_THROW(response.get(), std::runtime_error);
+
+  Azure::Core::Http::Request cancelledRequest(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  auto context = Azure::Core::Context::ApplicationContext.WithDeadline(
+      std::chrono::system_clock::now() - std::chrono::hours(1));
+  auto cancelledResponse = pipeline.SendAsync(cancelledRequest, context);
+  EXPECT_THROW(cancelledResponse.get(), Azure::Core::OperationCancelledException);
+}
+
+TEST(Pipeline, sendAsyncRetry)
+{
+  auto transport = std::make_shared<DeferredTransport>();
+  auto pipeline = CreateDeferredPipeline(transport);
+
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  auto response = pipeline->SendAsync(request, Azure::Core::Context());
+
+  // No thread waits for the response, the future is completed by the transport.
+  auto firstTry = transport->WaitForRequest();
+  EXPECT_EQ(response.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+  firstTry(
+      std::make_unique<Azure::Core::Http::RawResponse>(
+          1, 1, Azure::Core::Http::HttpStatusCode::ServiceUnavailable, "Unavailable"),
+      nullptr);
+
+  // The retry is sent once its delay has elapsed.
+  auto secondTry = transport->WaitForRequest();
+  EXPECT_EQ(response.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+  secondTry(
+      std::make_unique<Azure::Core::Http::RawResponse>(
+          1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK"),
+      nullptr);
+
+  EXPECT_EQ(response.get()->GetStatusCode(), Azure::Core::Http::HttpStatusCode::Ok);
+  EXPECT_EQ(request.GetHeaders().count("x-ms-client-request-id"), 1U);
+}
+
+TEST(Pipeline, sendAsyncTransportError)
+{
+  auto transport = std::make_shared<DeferredTransport>();
+  auto pipeline = CreateDeferredPipeline(transport);
+
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  std::mutex mutex;
+  std::condition_variable completed;
+  int callbacks = 0;
+  std::exception_ptr error;
+  pipeline->SendAsync(
+      request,
+      Azure::Core::Context(),
+      [&](std::unique_ptr<Azure::Core::Http::RawResponse> response, std::exception_ptr e) {
+        EXPECT_EQ(response, nullptr);
+        std::lock_guard<std::mutex> lock(mutex);
+        ++callbacks;
+        error = e;
+        completed.notify_all();
+      });
+
+  // The transport errors are retried, the error of the last try is returned.
+  for (int32_t attempt = 0; attempt <= Azure::Core::Http::Policies::RetryOptions().MaxRetries;
+       ++attempt)
+  {
+    transport->WaitForRequest()(
+        nullptr,
+        std::make_exception_ptr(Azure::Core::Http::TransportException("connection reset")));
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  completed.wait(lock, [&]() { return callbacks != 0; });
+  EXPECT_EQ(callbacks, 1);
+  EXPECT_THROW(std::rethrow_exception(error), Azure::Core::Http::TransportException);
+}
+
+TEST(Pipeline, sendAsyncCancelledRetry)
+{
+  auto transport = std::make_shared<DeferredTransport>();
+  Azure::Core::_internal::ClientOptions options;
+  options.Transport.Transport = transport;
+  options.Retry.RetryDelay = std::chrono::hours(1);
+  options.Retry.MaxRetryDelay = std::chrono::hours(1);
+  Azure::Core::Http::_internal::HttpPipeline pipeline(
+      options,
+      "test",
+      "1.0",
+      std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>(),
+      std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>());
+
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  Azure::Core::Context context;
+  auto response = pipeline.SendAsync(request, context);
+  transport->WaitForRequest()(
+      std::make_unique<Azure::Core::Http::RawResponse>(
+          1, 1, Azure::Core::Http::HttpStatusCode::ServiceUnavailable, "Unavailable"),
+      nullptr);
+
+  // The request waits an hour for its retry, cancelling it fails it right away.
+  EXPECT_EQ(response.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+  context.Cancel();
+  EXPECT_EQ(response.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  EXPECT_THROW(response.get(), Azure::Core::OperationCancelledException);
+}
+
+TEST(Pipeline, sendAsyncSlowRetry)
+{
+  // A synchronous transport failing the first try of each host, whose retry to the slow host
+  // blocks until it is released.
+  class SlowHostTransport final : public Azure::Core::Http::HttpTransport {
+    std::mutex m_mutex;
+    std::map<std::string, int> m_tries;
+
+    static std::unique_ptr<Azure::Core::Http::RawResponse> CreateResponse(
+        Azure::Core::Http::HttpStatusCode statusCode)
+    {
+      auto response = std::make_unique<Azure::Core::Http::RawResponse>(1, 1, statusCode, "");
+      response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(nullptr, 0));
+      return response;
+    }
+
+  public:
+    std::promise<void> SlowRetryStarted;
+    std::promise<void> Release;
+
+    std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+        Azure::Core::Http::Request& request,
+        Azure::Core::Context const&) override
+    {
+      auto const host = request.GetUrl().GetHost();
+      int tries;
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        tries = ++m_tries[host];
+      }
+      if (tries == 1)
+      {
+        return CreateResponse(Azure::Core::Http::HttpStatusCode::ServiceUnavailable);
+      }
+      if (host == "slow.azure.com")
+      {
+        SlowRetryStarted.set_value();
+        Release.get_future().wait();
+      }
+      return CreateResponse(Azure::Core::Http::HttpStatusCode::Ok);
+    }
+  };
+
+  auto transport = std::make_shared<SlowHostTransport>();
+  Azure::Core::_internal::ClientOptions options;
+  options.Transport.Transport = transport;
+  options.Retry.RetryDelay = std::chrono::milliseconds(1);
+  options.Retry.MaxRetryDelay = std::chrono::milliseconds(1);
+  Azure::Core::Http::_internal::HttpPipeline pipeline(
+      options,
+      "test",
+      "1.0",
+      std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>(),
+      std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>>());
+
+  Azure::Core::Http::Request slowRequest(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://slow.azure.com"));
+  auto slowResponse = pipeline.SendAsync(slowRequest, Azure::Core::Context());
+  transport->SlowRetryStarted.get_future().wait();
+
+  // The retry of another request isn't held up by the slow one.
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  auto response = pipeline.SendAsync(request, Azure::Core::Context());
+  ASSERT_EQ(response.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  EXPECT_EQ(response.get()->GetStatusCode(), Azure::Core::Http::HttpStatusCode::Ok);
+  EXPECT_EQ(slowResponse.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+  transport->Release.set_value();
+  EXPECT_EQ(slowResponse.get()->GetStatusCode(), Azure::Core::Http::HttpStatusCode::Ok);
+}
+
+TEST(Pipeline, staticHeaders)
+{
+  auto capture = std::make_unique<HeaderCapturePolicy>();
+  auto headers = capture->Headers;
+  std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
+  perRetryPolicies.push_back(std::move(capture));
+  perRetryPolicies.push_back(std::make_unique<TestTransportPolicy>());
+  Azure::Core::_internal::ClientOptions options;
+  options.Telemetry.ApplicationId = "app";
+  Azure::Core::Http::_internal::HttpPipeline pipeline(
+      options,
+      "test",
+      "1.0.0",
+      std::move(perRetryPolicies),
+      {},
+      Azure::Core::CaseInsensitiveMap{{"X-Ms-Version", "2020-02-10"}});
+
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  pipeline.Send(request, Azure::Core::Context());
+  EXPECT_EQ(headers->at("x-ms-version"), "2020-02-10");
+  EXPECT_EQ(
+      headers->at("user-agent"),
+      Azure::Core::Http::Policies::_internal::TelemetryPolicy::BuildTelemetryId(
+          "test", "1.0.0", "app"));
+  // The static headers keep the lowercase names of the headers set on requests.
+  EXPECT_EQ(headers->find("x-ms-version")->first, "x-ms-version");
+
+  // A header set on the request replaces the static one.
+  Azure::Core::Http::Request overridden(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  overridden.SetHeader("x-ms-version", "2021-04-10");
+  pipeline.Send(overridden, Azure::Core::Context());
+  EXPECT_EQ(headers->at("x-ms-version"), "2021-04-10");
+
+  EXPECT_THROW(
+      Azure::Core::Http::_internal::HttpPipeline(
+          options, "test", "1.0.0", {}, {}, Azure::Core::CaseInsensitiveMap{{"bad\nname", "x"}}),
+      std::invalid_argument);
+}
+
+TEST(Pipeline, trafficClass)
+{
+  using Azure::Core::Http::TrafficClass;
+
+  auto capture = std::make_unique<TrafficClassCapturePolicy>();
+  auto trafficClass = capture->TrafficClass;
+  std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
+  perRetryPolicies.push_back(std::move(capture));
+  perRetryPolicies.push_back(std::make_unique<TestTransportPolicy>());
+  Azure::Core::_internal::ClientOptions options;
+  Azure::Core::Http::_internal::HttpPipeline interactivePipeline(
+      options, "test", "1.0.0", std::move(perRetryPolicies), {});
+
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.azure.com"));
+  interactivePipeline.Send(request, Azure::Core::Context());
+  EXPECT_FALSE(trafficClass->HasValue());
+  interactivePipeline.Send(
+      request, Azure::Core::Http::WithTrafficClass(Azure::Core::Context(), TrafficClass::Bulk));
+  EXPECT_EQ(trafficClass->Value(), TrafficClass::Bulk);
+
+  // The traffic class of the client options applies to the contexts which have none.
+  options.TrafficClass = TrafficClass::Bulk;
+  perRetryPolicies.clear();
+  capture = std::make_unique<TrafficClassCapturePolicy>();
+  trafficClass = capture->TrafficClass;
+  perRetryPolicies.push_back(std::move(capture));
+  perRetryPolicies.push_back(std::make_unique<TestTransportPolicy>());
+  Azure::Core::Http::_internal::HttpPipeline bulkPipeline(
+      options, "test", "1.0.0", std::move(perRetryPolicies), {});
+  bulkPipeline.Send(request, Azure::Core::Context());
+  EXPECT_EQ(trafficClass->Value(), TrafficClass::Bulk);
+  Azure::Core::Http::_internal::HttpPipeline(bulkPipeline).Send(request, Azure::Core::Context());
+  EXPECT_EQ(trafficClass->Value(), TrafficClass::Bulk);
+  bulkPipeline.Send(
+      request,
+      Azure::Core::Http::WithTrafficClass(Azure::Core::Context(), TrafficClass::Interactive));
+  EXPECT_EQ(trafficClass->Value(), TrafficClass::Interactive);
+}
@@ -98,8 +98,116 @@ public:
   }
 };
 
+// A policy composable at compile time, which records the order the policies are applied in.
+class AppendHeaderPolicy final : public Azure::Core::Http::Policies::HttpPolicy {
+private:
+  std::string m_value;
+
+public:
+  explicit AppendHeaderPolicy(std::string value) : m_value(std::move(value)) {}
+
+  std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> Clone() const override
+  {
+    return std::make_unique<AppendHeaderPolicy>(*this);
+  }
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Http::Policies::NextHttpPolicy nextPolicy,
+      Azure::Core::Context const& context) const override
+  {
+    return SendWith(request, nextPolicy, context);
+  }
+
+  template <class NextPolicy>
+  std::unique_ptr<Azure::Core::Http::RawResponse> SendWith(
+      Azure::Core::Http::Request& request,
+      NextPolicy nextPolicy,
+      Azure::Core::Context const& context) const
+  {
+    auto const headers = request.GetHeaders();
+    auto const order = headers.find("order");
+    request.SetHeader("order", (order != headers.end() ? order->second : "") + m_value);
+    return nextPolicy.Send(request, context);
+  }
+
+  void SendAsync(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Http::Policies::NextHttpPolicy nextPolicy,
+      Azure::Core::Context const& context,
+      Azure::Core::Http::ResponseCallback callback) const override
+  {
+    SendAsyncWith(request, nextPolicy, context, std::move(callback));
+  }
+
+  template <class NextPolicy>
+  void SendAsyncWith(
+      Azure::Core::Http::Request& request,
+      NextPolicy nextPolicy,
+      Azure::Core::Context const& context,
+      Azure::Core::Http::ResponseCallback callback) const
+  {
+    auto const headers = request.GetHeaders();
+    auto const order = headers.find("order");
+    request.SetHeader("order", (order != headers.end() ? order->second : "") + m_value);
+    nextPolicy.SendAsync(request, context, std::move(callback));
+  }
+};
+
+class RespondWithHeaderPolicy final : public Azure::Core::Http::Policies::HttpPolicy {
+public:
+  std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> Clone() const override
+  {
+    return std::make_unique<RespondWithHeaderPolicy>(*this);
+  }
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Http::Policies::NextHttpPolicy,
+      Azure::Core::Context const&) const override
+  {
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(
+        1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+    response->SetHeader("order", request.GetHeaders().at("order"));
+    return response;
+  }
+};
+
 } // namespace
 
+TEST(Policy, ComposedHttpPolicy)
+{
+  using ComposedPolicy = Azure::Core::Http::Policies::_internal::
+      ComposedHttpPolicy<AppendHeaderPolicy, AppendHeaderPolicy, AppendHeaderPolicy>;
+
+  // The composed policies run in order, between the policies around them in the pipeline.
+  std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> policies;
+  policies.push_back(std::make_unique<AppendHeaderPolicy>("a"));
+  policies.push_back(std::make_unique<ComposedPolicy>(
+      AppendHeaderPolicy("b"), AppendHeaderPolicy("c"), AppendHeaderPolicy("d")));
+  policies.push_back(std::make_unique<AppendHeaderPolicy>("e"));
+  policies.push_back(std::make_unique<RespondWithHeaderPolicy>());
+
+  Azure::Core::Http::_internal::HttpPipeline pipeline(policies);
+  Azure::Core::Http::Request request(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.microsoft.com"));
+  auto response = pipeline.Send(request, Azure::Core::Context::ApplicationContext);
+  EXPECT_EQ(response->GetHeaders().at("order"), "abcde");
+
+  // The copy of a pipeline clones the composed policy.
+  Azure::Core::Http::_internal::HttpPipeline copy(pipeline);
+  Azure::Core::Http::Request otherRequest(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.microsoft.com"));
+  response = copy.Send(otherRequest, Azure::Core::Context::ApplicationContext);
+  EXPECT_EQ(response->GetHeaders().at("order"), "abcde");
+
+  // The asynchronous send runs the composed policies in the same order.
+  Azure::Core::Http::Request asyncRequest(
+      Azure::Core::Http::HttpMethod::Get, Azure::Core::Url("https://www.microsoft.com"));
+  response = pipeline.SendAsync(asyncRequest, Azure::Core::Context::ApplicationContext).get();
+  EXPECT_EQ(response->GetHeaders().at("order"), "abcde");
+}
+
 TEST(Policy, throwWhenNoTransportPolicy)
 {
   // Construct pipeline without exception
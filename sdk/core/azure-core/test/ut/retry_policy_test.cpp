@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 
 #include <functional>
+#include <thread>
 
 using namespace Azure::Core::Http;
 using namespace Azure::Core::Http::Policies;
@@ -89,12 +90,12 @@ protected:
 TEST(RetryPolicy, ShouldRetryOnResponse)
 {
   using namespace std::chrono_literals;
-  RetryOptions const retryOptions{5, 10s, 5min, {HttpStatusCode::Ok}};
+  RetryOptions const retryOptions{5, 10s, 5min, {HttpStatusCode::Ok}, nullptr, nullptr};
 
   RawResponse const* responsePtrSent = nullptr;
 
   RawResponse const* responsePtrReceived = nullptr;
-  RetryOptions retryOptionsReceived{0, 0ms, 0ms, {}};
+  RetryOptions retryOptionsReceived{0, 0ms, 0ms, {}, nullptr, nullptr};
   int32_t attemptReceived = -1234;
   double jitterReceived = -5678;
 
@@ -155,7 +156,7 @@ TEST(RetryPolicy, ShouldRetryOnResponse)
   responsePtrSent = nullptr;
 
   responsePtrReceived = nullptr;
-  retryOptionsReceived = RetryOptions{0, 0ms, 0ms, {}};
+  retryOptionsReceived = RetryOptions{0, 0ms, 0ms, {}, nullptr, nullptr};
   attemptReceived = -1234;
   jitterReceived = -5678;
 
@@ -217,9 +218,9 @@ TEST(RetryPolicy, ShouldRetryOnResponse)
 TEST(RetryPolicy, ShouldRetryOnTransportFailure)
 {
   using namespace std::chrono_literals;
-  RetryOptions const retryOptions{5, 10s, 5min, {HttpStatusCode::Ok}};
+  RetryOptions const retryOptions{5, 10s, 5min, {HttpStatusCode::Ok}, nullptr, nullptr};
 
-  RetryOptions retryOptionsReceived{0, 0ms, 0ms, {}};
+  RetryOptions retryOptionsReceived{0, 0ms, 0ms, {}, nullptr, nullptr};
   int32_t attemptReceived = -1234;
   double jitterReceived = -5678;
 
@@ -268,7 +269,7 @@ TEST(RetryPolicy, ShouldRetryOnTransportFailure)
   EXPECT_EQ(jitterReceived, -1);
 
   // 3 attempts
-  retryOptionsReceived = RetryOptions{0, 0ms, 0ms, {}};
+  retryOptionsReceived = RetryOptions{0, 0ms, 0ms, {}, nullptr, nullptr};
   attemptReceived = -1234;
   jitterReceived = -5678;
 
@@ -355,7 +356,7 @@ TEST(RetryPolicy, Exponential)
 {
   using namespace std::chrono_literals;
 
-  RetryOptions const options{3, 1s, 2min, {}};
+  RetryOptions const options{3, 1s, 2min, {}, nullptr, nullptr};
 
   {
     std::chrono::milliseconds retryAfter{};
@@ -399,8 +400,8 @@ TEST(RetryPolicy, LessThan2Retries)
 
   {
     std::chrono::milliseconds retryAfter{};
-    bool const shouldRetry
-        = RetryLogic::TestShouldRetryOnTransportFailure({1, 1s, 2min, {}}, 1, retryAfter, 1.0);
+    bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
+        {1, 1s, 2min, {}, nullptr, nullptr}, 1, retryAfter, 1.0);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 1s);
@@ -408,16 +409,16 @@ TEST(RetryPolicy, LessThan2Retries)
 
   {
     std::chrono::milliseconds retryAfter{};
-    bool const shouldRetry
-        = RetryLogic::TestShouldRetryOnTransportFailure({0, 1s, 2min, {}}, 1, retryAfter, 1.0);
+    bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
+        {0, 1s, 2min, {}, nullptr, nullptr}, 1, retryAfter, 1.0);
 
     EXPECT_EQ(shouldRetry, false);
   }
 
   {
     std::chrono::milliseconds retryAfter{};
-    bool const shouldRetry
-        = RetryLogic::TestShouldRetryOnTransportFailure({-1, 1s, 2min, {}}, 1, retryAfter, 1.0);
+    bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
+        {-1, 1s, 2min, {}, nullptr, nullptr}, 1, retryAfter, 1.0);
 
     EXPECT_EQ(shouldRetry, false);
   }
@@ -427,7 +428,7 @@ TEST(RetryPolicy, NotExceedingMaxRetryDelay)
 {
   using namespace std::chrono_literals;
 
-  RetryOptions const options{7, 1s, 20s, {}};
+  RetryOptions const options{7, 1s, 20s, {}, nullptr, nullptr};
 
   {
     std::chrono::milliseconds retryAfter{};
@@ -497,7 +498,7 @@ TEST(RetryPolicy, NotExceedingInt32Max)
 {
   using namespace std::chrono_literals;
 
-  RetryOptions const options{35, 1s, 9999999999999s, {}};
+  RetryOptions const options{35, 1s, 9999999999999s, {}, nullptr, nullptr};
 
   {
     std::chrono::milliseconds retryAfter{};
@@ -540,7 +541,7 @@ TEST(RetryPolicy, Jitter)
 {
   using namespace std::chrono_literals;
 
-  RetryOptions const options{3, 10s, 20min, {}};
+  RetryOptions const options{3, 10s, 20min, {}, nullptr, nullptr};
 
   {
     std::chrono::milliseconds retryAfter{};
@@ -585,8 +586,8 @@ TEST(RetryPolicy, JitterExtremes)
 
   {
     std::chrono::milliseconds retryAfter{};
-    bool const shouldRetry
-        = RetryLogic::TestShouldRetryOnTransportFailure({3, 1ms, 2min, {}}, 1, retryAfter, 0.8);
+    bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
+        {3, 1ms, 2min, {}, nullptr, nullptr}, 1, retryAfter, 0.8);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 0ms);
@@ -594,8 +595,8 @@ TEST(RetryPolicy, JitterExtremes)
 
   {
     std::chrono::milliseconds retryAfter{};
-    bool const shouldRetry
-        = RetryLogic::TestShouldRetryOnTransportFailure({3, 2ms, 2min, {}}, 1, retryAfter, 0.8);
+    bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
+        {3, 2ms, 2min, {}, nullptr, nullptr}, 1, retryAfter, 0.8);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 1ms);
@@ -603,8 +604,8 @@ TEST(RetryPolicy, JitterExtremes)
 
   {
     std::chrono::milliseconds retryAfter{};
-    bool const shouldRetry
-        = RetryLogic::TestShouldRetryOnTransportFailure({3, 10s, 21s, {}}, 2, retryAfter, 1.3);
+    bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
+        {3, 10s, 21s, {}, nullptr, nullptr}, 2, retryAfter, 1.3);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 21s);
@@ -612,8 +613,8 @@ TEST(RetryPolicy, JitterExtremes)
 
   {
     std::chrono::milliseconds retryAfter{};
-    bool const shouldRetry
-        = RetryLogic::TestShouldRetryOnTransportFailure({3, 10s, 21s, {}}, 3, retryAfter, 1.3);
+    bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
+        {3, 10s, 21s, {}, nullptr, nullptr}, 3, retryAfter, 1.3);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 21s);
@@ -622,7 +623,7 @@ TEST(RetryPolicy, JitterExtremes)
   {
     std::chrono::milliseconds retryAfter{};
     bool const shouldRetry = RetryLogic::TestShouldRetryOnTransportFailure(
-        {35, 1s, 9999999999999s, {}}, 33, retryAfter, 1.3);
+        {35, 1s, 9999999999999s, {}, nullptr, nullptr}, 33, retryAfter, 1.3);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 2791728741100ms);
@@ -637,7 +638,7 @@ TEST(RetryPolicy, HttpStatusCode)
     std::chrono::milliseconds retryAfter{};
     bool const shouldRetry = RetryLogic::TestShouldRetryOnResponse(
         RawResponse(1, 1, HttpStatusCode::RequestTimeout, ""),
-        {3, 3210s, 3h, {HttpStatusCode::RequestTimeout}},
+        {3, 3210s, 3h, {HttpStatusCode::RequestTimeout}, nullptr, nullptr},
         1,
         retryAfter,
         1.0);
@@ -650,7 +651,7 @@ TEST(RetryPolicy, HttpStatusCode)
     std::chrono::milliseconds retryAfter{};
     bool const shouldRetry = RetryLogic::TestShouldRetryOnResponse(
         RawResponse(1, 1, HttpStatusCode::RequestTimeout, ""),
-        {3, 654s, 3h, {HttpStatusCode::Ok}},
+        {3, 654s, 3h, {HttpStatusCode::Ok}, nullptr, nullptr},
         1,
         retryAfter,
         1.0);
@@ -662,7 +663,7 @@ TEST(RetryPolicy, HttpStatusCode)
     std::chrono::milliseconds retryAfter{};
     bool const shouldRetry = RetryLogic::TestShouldRetryOnResponse(
         RawResponse(1, 1, HttpStatusCode::Ok, ""),
-        {3, 987s, 3h, {HttpStatusCode::Ok}},
+        {3, 987s, 3h, {HttpStatusCode::Ok}, nullptr, nullptr},
         1,
         retryAfter,
         1.0);
@@ -682,7 +683,11 @@ TEST(RetryPolicy, RetryAfterMs)
 
     std::chrono::milliseconds retryAfter{};
     bool const shouldRetry = RetryLogic::TestShouldRetryOnResponse(
-        response, {3, 1s, 2min, {HttpStatusCode::RequestTimeout}}, 1, retryAfter, 1.3);
+        response,
+        {3, 1s, 2min, {HttpStatusCode::RequestTimeout}, nullptr, nullptr},
+        1,
+        retryAfter,
+        1.3);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 1234ms);
@@ -694,7 +699,11 @@ TEST(RetryPolicy, RetryAfterMs)
 
     std::chrono::milliseconds retryAfter{};
     bool const shouldRetry = RetryLogic::TestShouldRetryOnResponse(
-        response, {3, 1s, 2min, {HttpStatusCode::RequestTimeout}}, 1, retryAfter, 0.8);
+        response,
+        {3, 1s, 2min, {HttpStatusCode::RequestTimeout}, nullptr, nullptr},
+        1,
+        retryAfter,
+        0.8);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 5678ms);
@@ -711,9 +720,331 @@ TEST(RetryPolicy, RetryAfter)
 
     std::chrono::milliseconds retryAfter{};
     bool const shouldRetry = RetryLogic::TestShouldRetryOnResponse(
-        response, {3, 1s, 2min, {HttpStatusCode::RequestTimeout}}, 1, retryAfter, 1.1);
+        response,
+        {3, 1s, 2min, {HttpStatusCode::RequestTimeout}, nullptr, nullptr},
+        1,
+        retryAfter,
+        1.1);
 
     EXPECT_EQ(shouldRetry, true);
     EXPECT_EQ(retryAfter, 90s);
   }
 }
+
+namespace {
+class TestHostTransportPolicy final : public HttpPolicy {
+private:
+  std::function<std::unique_ptr<RawResponse>(std::string const&)> m_send;
+
+public:
+  TestHostTransportPolicy(std::function<std::unique_ptr<RawResponse>(std::string const&)> send)
+      : m_send(send)
+  {
+  }
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Request& request,
+      NextHttpPolicy,
+      Azure::Core::Context const&) const override
+  {
+    return m_send(request.GetUrl().GetHost());
+  }
+
+  std::unique_ptr<HttpPolicy> Clone() const override
+  {
+    return std::make_unique<TestHostTransportPolicy>(*this);
+  }
+};
+
+Azure::Core::Http::_internal::HttpPipeline CreateRetryPipeline(
+    RetryOptions const& retryOptions,
+    std::function<std::unique_ptr<RawResponse>(std::string const&)> send)
+{
+  std::vector<std::unique_ptr<HttpPolicy>> policies;
+  policies.emplace_back(std::make_unique<RetryPolicy>(retryOptions));
+  policies.emplace_back(std::make_unique<TestHostTransportPolicy>(send));
+  return Azure::Core::Http::_internal::HttpPipeline(policies);
+}
+} // namespace
+
+TEST(RetryPolicy, RetryBudget)
+{
+  using namespace std::chrono_literals;
+  RetryOptions options;
+  options.MaxRetries = 3;
+  options.RetryDelay = 1ms;
+  options.Budget = std::make_shared<RetryBudget>(0.5, 2, 10s);
+  int sends = 0;
+  auto pipeline = CreateRetryPipeline(options, [&](std::string const&) {
+    ++sends;
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::ServiceUnavailable, "");
+  });
+
+  // The retries are limited to 2 plus half of the requests: 3 for the first request, which is its
+  // maximum, none for the second, 1 for the third and none for the fourth.
+  for (int i = 0; i < 4; ++i)
+  {
+    Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+    EXPECT_EQ(
+        pipeline.Send(request, Azure::Core::Context::ApplicationContext)->GetStatusCode(),
+        HttpStatusCode::ServiceUnavailable);
+  }
+  EXPECT_EQ(sends, 8);
+  EXPECT_EQ(options.Budget->Requests(), 4);
+  EXPECT_EQ(options.Budget->Retries(), 4);
+  EXPECT_EQ(options.Budget->RejectedRetries(), 3);
+
+  EXPECT_THROW(RetryBudget(-1), std::invalid_argument);
+  EXPECT_THROW(RetryBudget(0.1, 10, 0ms), std::invalid_argument);
+}
+
+TEST(RetryPolicy, CircuitBreaker)
+{
+  using namespace std::chrono_literals;
+  RetryOptions options;
+  options.MaxRetries = 1;
+  options.RetryDelay = 1ms;
+  options.CircuitBreaker = std::make_shared<CircuitBreaker>(3, 200ms);
+  int sends = 0;
+  bool failing = true;
+  auto pipeline = CreateRetryPipeline(options, [&](std::string const& host) {
+    ++sends;
+    if (failing && host == "failing.bing.com")
+    {
+      throw TransportException("Connection reset.");
+    }
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "");
+  });
+  auto const send = [&pipeline](std::string const& host) {
+    Request request(HttpMethod::Get, Azure::Core::Url("http://" + host));
+    return pipeline.Send(request, Azure::Core::Context::ApplicationContext);
+  };
+
+  // The third failed try opens the circuit, the retry of the second request fails right away.
+  EXPECT_THROW(send("failing.bing.com"), TransportException);
+  EXPECT_FALSE(options.CircuitBreaker->IsOpen("failing.bing.com"));
+  EXPECT_THROW(send("failing.bing.com"), TransportException);
+  EXPECT_EQ(sends, 3);
+  EXPECT_TRUE(options.CircuitBreaker->IsOpen("failing.bing.com"));
+  EXPECT_EQ(options.CircuitBreaker->TimesOpened(), 1);
+  EXPECT_EQ(options.CircuitBreaker->RejectedRequests(), 1);
+
+  EXPECT_THROW(send("failing.bing.com"), TransportException);
+  EXPECT_EQ(sends, 3);
+  EXPECT_EQ(options.CircuitBreaker->RejectedRequests(), 2);
+  // The other hosts aren't affected.
+  EXPECT_EQ(send("www.bing.com")->GetStatusCode(), HttpStatusCode::Ok);
+  EXPECT_EQ(sends, 4);
+
+  // After the cool-down, a failed request opens the circuit again and a successful one closes it.
+  std::this_thread::sleep_for(250ms);
+  EXPECT_FALSE(options.CircuitBreaker->IsOpen("failing.bing.com"));
+  EXPECT_THROW(send("failing.bing.com"), TransportException);
+  EXPECT_EQ(sends, 5);
+  EXPECT_TRUE(options.CircuitBreaker->IsOpen("failing.bing.com"));
+  EXPECT_EQ(options.CircuitBreaker->TimesOpened(), 2);
+
+  std::this_thread::sleep_for(250ms);
+  failing = false;
+  EXPECT_EQ(send("failing.bing.com")->GetStatusCode(), HttpStatusCode::Ok);
+  EXPECT_FALSE(options.CircuitBreaker->IsOpen("failing.bing.com"));
+}
+
+TEST(RetryPolicy, CancelledDuringRetryDelay)
+{
+  using namespace std::chrono_literals;
+  RetryOptions options;
+  options.MaxRetries = 3;
+  options.RetryDelay = 1min;
+  int sends = 0;
+  auto pipeline = CreateRetryPipeline(options, [&](std::string const&) {
+    ++sends;
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::ServiceUnavailable, "");
+  });
+
+  // The cancellation wakes up the backoff instead of waiting for the retry delay.
+  auto context = Azure::Core::Context::ApplicationContext.WithDeadline(
+      Azure::DateTime(std::chrono::system_clock::now() + 1h));
+  std::thread cancelThread([context]() mutable {
+    std::this_thread::sleep_for(100ms);
+    context.Cancel();
+  });
+  auto const start = std::chrono::steady_clock::now();
+  Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+  EXPECT_THROW(pipeline.Send(request, context), Azure::Core::OperationCancelledException);
+  cancelThread.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 30s);
+  EXPECT_EQ(sends, 1);
+}
+
+TEST(RetryPolicy, DeadlineBeforeRetry)
+{
+  using namespace std::chrono_literals;
+  RetryOptions options;
+  options.MaxRetries = 3;
+  options.RetryDelay = 1min;
+  int sends = 0;
+  auto pipeline = CreateRetryPipeline(options, [&](std::string const&) {
+    ++sends;
+    throw TransportException("Connection reset.");
+    return std::unique_ptr<RawResponse>();
+  });
+
+  // The retry would be made after the deadline, so the request fails without waiting.
+  auto const context = Azure::Core::Context::ApplicationContext.WithDeadline(
+      Azure::DateTime(std::chrono::system_clock::now() + 10s));
+  auto const start = std::chrono::steady_clock::now();
+  Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+  EXPECT_THROW(pipeline.Send(request, context), Azure::Core::OperationCancelledException);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  EXPECT_EQ(sends, 1);
+}
+
+namespace {
+class TestContextTransportPolicy final : public HttpPolicy {
+private:
+  std::function<std::unique_ptr<RawResponse>(Request&, Azure::Core::Context const&)> m_send;
+
+public:
+  TestContextTransportPolicy(
+      std::function<std::unique_ptr<RawResponse>(Request&, Azure::Core::Context const&)> send)
+      : m_send(send)
+  {
+  }
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Request& request,
+      NextHttpPolicy,
+      Azure::Core::Context const& context) const override
+  {
+    return m_send(request, context);
+  }
+
+  std::unique_ptr<HttpPolicy> Clone() const override
+  {
+    return std::make_unique<TestContextTransportPolicy>(*this);
+  }
+};
+
+Azure::Core::Http::_internal::HttpPipeline CreateTryTimeoutPipeline(
+    RetryOptions const& retryOptions,
+    std::function<std::unique_ptr<RawResponse>(Request&, Azure::Core::Context const&)> send)
+{
+  std::vector<std::unique_ptr<HttpPolicy>> policies;
+  policies.emplace_back(std::make_unique<RetryPolicy>(retryOptions));
+  policies.emplace_back(std::make_unique<TestContextTransportPolicy>(send));
+  return Azure::Core::Http::_internal::HttpPipeline(policies);
+}
+
+// Waits until the context of the try is cancelled, as a transport waiting for a hung connection.
+std::unique_ptr<RawResponse> Hang(Azure::Core::Context const& context)
+{
+  using namespace std::chrono_literals;
+  auto const giveUp = std::chrono::steady_clock::now() + 30s;
+  while (!context.IsCancelled() && std::chrono::steady_clock::now() < giveUp)
+  {
+    std::this_thread::sleep_for(5ms);
+  }
+  context.ThrowIfCancelled();
+  return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "");
+}
+} // namespace
+
+TEST(RetryPolicy, TryTimeout)
+{
+  using namespace std::chrono_literals;
+  RetryOptions options;
+  options.MaxRetries = 3;
+  options.RetryDelay = 1ms;
+  options.TryTimeout = 100ms;
+  int sends = 0;
+  int hangingSends = 2;
+  auto pipeline = CreateTryTimeoutPipeline(options, [&](Request&, Azure::Core::Context const& c) {
+    if (++sends <= hangingSends)
+    {
+      return Hang(c);
+    }
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "");
+  });
+
+  // The hung tries are aborted and retried well before the deadline of the request.
+  auto const context = Azure::Core::Context::ApplicationContext.WithDeadline(
+      Azure::DateTime(std::chrono::system_clock::now() + 1h));
+  auto start = std::chrono::steady_clock::now();
+  {
+    Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+    EXPECT_EQ(pipeline.Send(request, context)->GetStatusCode(), HttpStatusCode::Ok);
+  }
+  EXPECT_EQ(sends, 3);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 200ms);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 20s);
+
+  // When the last try times out too, the request fails like a transport failure.
+  sends = 0;
+  hangingSends = 4;
+  {
+    Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+    EXPECT_THROW(pipeline.Send(request, context), TransportException);
+  }
+  EXPECT_EQ(sends, 4);
+
+  // The cancellation of the request itself isn't retried.
+  options.TryTimeout = 10min;
+  auto hangingPipeline
+      = CreateTryTimeoutPipeline(options, [&](Request&, Azure::Core::Context const& c) {
+          ++sends;
+          return Hang(c);
+        });
+  sends = 0;
+  start = std::chrono::steady_clock::now();
+  {
+    Request request(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+    EXPECT_THROW(
+        hangingPipeline.Send(
+            request,
+            Azure::Core::Context::ApplicationContext.WithDeadline(
+                Azure::DateTime(std::chrono::system_clock::now() + 100ms))),
+        Azure::Core::OperationCancelledException);
+  }
+  EXPECT_EQ(sends, 1);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 20s);
+}
+
+TEST(RetryPolicy, TryTimeoutMinimumThroughput)
+{
+  using namespace std::chrono_literals;
+  RetryOptions options;
+  options.TryTimeout = 1s;
+  options.MinimumTryThroughput = 1000;
+  std::chrono::system_clock::duration tryTimeout{};
+  auto pipeline = CreateTryTimeoutPipeline(options, [&](Request&, Azure::Core::Context const& c) {
+    tryTimeout = static_cast<std::chrono::system_clock::time_point>(c.GetDeadline())
+        - std::chrono::system_clock::now();
+    return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "");
+  });
+  auto const send = [&](Request& request) {
+    pipeline.Send(request, Azure::Core::Context::ApplicationContext);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(tryTimeout);
+  };
+
+  // The try timeout is extended by the time to transfer the body and the range at 1000 B/s.
+  std::vector<uint8_t> body(500);
+  Azure::Core::IO::MemoryBodyStream bodyStream(body);
+  Request upload(HttpMethod::Put, Azure::Core::Url("http://www.bing.com"), &bodyStream);
+  auto timeout = send(upload);
+  EXPECT_GT(timeout, 1400ms);
+  EXPECT_LE(timeout, 1500ms);
+
+  Request download(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+  download.SetHeader("x-ms-range", "bytes=1000-2999");
+  timeout = send(download);
+  EXPECT_GT(timeout, 2900ms);
+  EXPECT_LE(timeout, 3000ms);
+
+  // An open range has no known size.
+  Request openRange(HttpMethod::Get, Azure::Core::Url("http://www.bing.com"));
+  openRange.SetHeader("range", "bytes=1000-");
+  timeout = send(openRange);
+  EXPECT_GT(timeout, 900ms);
+  EXPECT_LE(timeout, 1000ms);
+}
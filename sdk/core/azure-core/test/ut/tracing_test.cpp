@@ -0,0 +1,300 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/diagnostics/tracing.hpp>
+#include <azure/core/http/policies/policy.hpp>
+#include <azure/core/http/transport.hpp>
+#include <azure/core/internal/client_options.hpp>
+#include <azure/core/internal/diagnostics/span.hpp>
+#include <azure/core/internal/http/pipeline.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Azure::Core::Context;
+using Azure::Core::Diagnostics::SpanContext;
+using Azure::Core::Diagnostics::SpanData;
+using Azure::Core::Diagnostics::SpanKind;
+using Azure::Core::Diagnostics::SpanStatus;
+using Azure::Core::Diagnostics::Tracer;
+using Azure::Core::Diagnostics::_internal::Span;
+using namespace Azure::Core::Http;
+
+namespace {
+class TestTransport final : public HttpTransport {
+private:
+  std::function<std::unique_ptr<RawResponse>(Request&)> m_send;
+
+public:
+  explicit TestTransport(std::function<std::unique_ptr<RawResponse>(Request&)> send)
+      : m_send(std::move(send))
+  {
+  }
+
+  std::unique_ptr<RawResponse> Send(Request& request, Context const&) override
+  {
+    return m_send(request);
+  }
+};
+
+std::unique_ptr<RawResponse> CreateResponse(HttpStatusCode statusCode)
+{
+  auto response = std::make_unique<RawResponse>(1, 1, statusCode, "");
+  response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(nullptr, 0));
+  return response;
+}
+
+Azure::Core::Http::_internal::HttpPipeline CreatePipeline(
+    std::function<std::unique_ptr<RawResponse>(Request&)> send)
+{
+  Azure::Core::_internal::ClientOptions options;
+  options.Retry.RetryDelay = std::chrono::milliseconds(1);
+  options.Retry.MaxRetryDelay = std::chrono::milliseconds(1);
+  options.Transport.Transport = std::make_shared<TestTransport>(std::move(send));
+  return Azure::Core::Http::_internal::HttpPipeline(options, "test-client", "1.0.0", {}, {});
+}
+
+// Enables tracing for a test, and disables it when the test ends.
+class TracingTest : public testing::Test {
+protected:
+  std::vector<SpanData> m_spans;
+
+  void SetUp() override
+  {
+    Tracer::SetExporter([this](SpanData const& span) { m_spans.push_back(span); });
+  }
+
+  void TearDown() override
+  {
+    Tracer::SetExporter(nullptr);
+    Tracer::SetSamplingRatio(1);
+  }
+};
+} // namespace
+
+TEST(SpanContext, TraceParent)
+{
+  std::string const traceParent = "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01";
+  auto const spanContext = SpanContext::FromTraceParent(traceParent);
+  ASSERT_TRUE(spanContext.HasValue());
+  EXPECT_TRUE(spanContext.Value().IsSampled);
+  EXPECT_EQ(spanContext.Value().TraceId[0], 0x4b);
+  EXPECT_EQ(spanContext.Value().SpanId[7], 0xb7);
+  EXPECT_EQ(spanContext.Value().ToTraceParent(), traceParent);
+
+  auto const notSampled
+      = SpanContext::FromTraceParent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00");
+  ASSERT_TRUE(notSampled.HasValue());
+  EXPECT_FALSE(notSampled.Value().IsSampled);
+
+  // A later version may append fields.
+  EXPECT_TRUE(SpanContext::FromTraceParent(
+                  "01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-extra")
+                  .HasValue());
+}
+
+TEST(SpanContext, InvalidTraceParent)
+{
+  for (auto const traceParent : {
+           "",
+           "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7",
+           "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01-extra",
+           "ff-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01",
+           "00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01",
+           "00-00000000000000000000000000000000-00f067aa0ba902b7-01",
+           "00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01",
+           "00_4bf92f3577b34da6a3ce929d0e0e4736_00f067aa0ba902b7_01",
+           "00-4bf92f3577b34da6a3ce929d0e0e473x-00f067aa0ba902b7-01",
+       })
+  {
+    EXPECT_FALSE(SpanContext::FromTraceParent(traceParent).HasValue()) << traceParent;
+  }
+}
+
+TEST(Span, DisabledWithoutExporter)
+{
+  Context const context;
+  Span span("Operation", context);
+  EXPECT_FALSE(span.IsRecording());
+  EXPECT_FALSE(span.GetSpanContext().IsValid());
+  EXPECT_EQ(&span.GetContext(), &context);
+  EXPECT_FALSE(Tracer::GetSpanContext(span.GetContext()).HasValue());
+}
+
+TEST_F(TracingTest, ParentAndChildSpans)
+{
+  auto const parent = SpanContext::FromTraceParent(
+                          "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01")
+                          .Value();
+  auto const context = Tracer::WithParent(Context(), parent);
+  {
+    Span operation("Operation", context);
+    EXPECT_TRUE(operation.IsRecording());
+    {
+      Span child("Child", operation.GetContext(), SpanKind::Client);
+      child.SetStatusCode(HttpStatusCode::NotFound);
+    }
+    EXPECT_EQ(
+        Tracer::GetSpanContext(operation.GetContext()).Value().SpanId,
+        operation.GetSpanContext().SpanId);
+  }
+
+  ASSERT_EQ(m_spans.size(), 2U);
+  auto const& child = m_spans[0];
+  auto const& operation = m_spans[1];
+  EXPECT_STREQ(operation.Name, "Operation");
+  EXPECT_EQ(operation.Context.TraceId, parent.TraceId);
+  EXPECT_EQ(operation.ParentSpanId, parent.SpanId);
+  EXPECT_EQ(operation.Status, SpanStatus::Ok);
+  EXPECT_STREQ(child.Name, "Child");
+  EXPECT_EQ(child.Kind, SpanKind::Client);
+  EXPECT_EQ(child.Context.TraceId, parent.TraceId);
+  EXPECT_EQ(child.ParentSpanId, operation.Context.SpanId);
+  EXPECT_EQ(child.Status, SpanStatus::Error);
+  EXPECT_EQ(child.StatusCode.Value(), HttpStatusCode::NotFound);
+  EXPECT_LE(child.Duration, operation.Duration);
+}
+
+TEST_F(TracingTest, SpanEndedByException)
+{
+  try
+  {
+    Context const context;
+    Span span("Operation", context);
+    throw std::runtime_error("Operation failed");
+  }
+  catch (std::runtime_error const&)
+  {
+  }
+
+  ASSERT_EQ(m_spans.size(), 1U);
+  EXPECT_EQ(m_spans[0].Status, SpanStatus::Error);
+  EXPECT_TRUE(m_spans[0].Context.IsValid());
+  EXPECT_EQ(m_spans[0].ParentSpanId, decltype(m_spans[0].ParentSpanId){});
+}
+
+TEST_F(TracingTest, Sampling)
+{
+  Tracer::SetSamplingRatio(0);
+  Context const context;
+  {
+    Span root("Operation", context);
+    EXPECT_FALSE(root.IsRecording());
+    // The span context is still propagated, so the children aren't sampled either.
+    EXPECT_TRUE(root.GetSpanContext().IsValid());
+    Span child("Child", root.GetContext());
+    EXPECT_FALSE(child.IsRecording());
+    EXPECT_EQ(child.GetSpanContext().TraceId, root.GetSpanContext().TraceId);
+  }
+  EXPECT_TRUE(m_spans.empty());
+
+  // A sampled parent decides for its children.
+  auto const parent = SpanContext::FromTraceParent(
+                          "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01")
+                          .Value();
+  auto const parentContext = Tracer::WithParent(context, parent);
+  {
+    Span span("Operation", parentContext);
+    EXPECT_TRUE(span.IsRecording());
+  }
+  EXPECT_EQ(m_spans.size(), 1U);
+}
+
+TEST_F(TracingTest, PipelineSpans)
+{
+  std::vector<std::string> traceParents;
+  auto pipeline = CreatePipeline([&](Request& request) {
+    traceParents.push_back(request.GetHeaders().at("traceparent"));
+    return CreateResponse(
+        traceParents.size() == 1 ? HttpStatusCode::ServiceUnavailable : HttpStatusCode::Ok);
+  });
+
+  Request request(HttpMethod::Get, Azure::Core::Url("https://account.test/path"));
+  Context const context;
+  {
+    Span operation("Client.Operation", context);
+    auto response = pipeline.Send(request, operation.GetContext());
+    EXPECT_EQ(response->GetStatusCode(), HttpStatusCode::Ok);
+  }
+
+  // Two tries, the request, and the operation.
+  ASSERT_EQ(traceParents.size(), 2U);
+  ASSERT_EQ(m_spans.size(), 4U);
+  auto const& firstTry = m_spans[0];
+  auto const& secondTry = m_spans[1];
+  auto const& httpRequest = m_spans[2];
+  auto const& operation = m_spans[3];
+
+  EXPECT_STREQ(operation.Name, "Client.Operation");
+  EXPECT_STREQ(httpRequest.Name, "HTTP GET");
+  EXPECT_EQ(httpRequest.ParentSpanId, operation.Context.SpanId);
+  EXPECT_EQ(httpRequest.StatusCode.Value(), HttpStatusCode::Ok);
+  EXPECT_EQ(httpRequest.Status, SpanStatus::Ok);
+
+  EXPECT_EQ(firstTry.Kind, SpanKind::Client);
+  EXPECT_EQ(firstTry.ParentSpanId, httpRequest.Context.SpanId);
+  EXPECT_EQ(firstTry.RetryCount, 0);
+  EXPECT_EQ(firstTry.Status, SpanStatus::Error);
+  EXPECT_EQ(firstTry.Context.ToTraceParent(), traceParents[0]);
+  EXPECT_EQ(secondTry.ParentSpanId, httpRequest.Context.SpanId);
+  EXPECT_EQ(secondTry.RetryCount, 1);
+  EXPECT_EQ(secondTry.Status, SpanStatus::Ok);
+  EXPECT_EQ(secondTry.Context.ToTraceParent(), traceParents[1]);
+  EXPECT_EQ(secondTry.Context.TraceId, operation.Context.TraceId);
+}
+
+TEST_F(TracingTest, PipelineSpansWhenTransportThrows)
+{
+  auto tries = 0;
+  auto pipeline = CreatePipeline([&](Request&) -> std::unique_ptr<RawResponse> {
+    ++tries;
+    throw TransportException("Connection failed");
+  });
+
+  Request request(HttpMethod::Get, Azure::Core::Url("https://account.test/path"));
+  Context const context;
+  {
+    Span operation("Client.Operation", context);
+    EXPECT_THROW(pipeline.Send(request, operation.GetContext()), TransportException);
+  }
+
+  // Every try, the request, and the operation are ended and exported despite the exception.
+  ASSERT_GT(tries, 1);
+  ASSERT_EQ(m_spans.size(), static_cast<size_t>(tries) + 2);
+  auto const& httpRequest = m_spans[tries];
+  auto const& operation = m_spans[tries + 1];
+
+  EXPECT_STREQ(operation.Name, "Client.Operation");
+  EXPECT_STREQ(httpRequest.Name, "HTTP GET");
+  EXPECT_EQ(httpRequest.ParentSpanId, operation.Context.SpanId);
+  EXPECT_EQ(httpRequest.Status, SpanStatus::Error);
+  EXPECT_FALSE(httpRequest.StatusCode.HasValue());
+
+  for (auto i = 0; i < tries; ++i)
+  {
+    EXPECT_EQ(m_spans[i].Kind, SpanKind::Client);
+    EXPECT_EQ(m_spans[i].ParentSpanId, httpRequest.Context.SpanId);
+    EXPECT_EQ(m_spans[i].RetryCount, i);
+    EXPECT_EQ(m_spans[i].Status, SpanStatus::Error);
+    EXPECT_FALSE(m_spans[i].StatusCode.HasValue());
+  }
+}
+
+TEST(TracingPolicy, NoHeaderWhenDisabled)
+{
+  auto hasTraceParent = true;
+  auto pipeline = CreatePipeline([&](Request& request) {
+    hasTraceParent = request.GetHeaders().count("traceparent") != 0;
+    return CreateResponse(HttpStatusCode::Ok);
+  });
+
+  Request request(HttpMethod::Get, Azure::Core::Url("https://account.test/path"));
+  EXPECT_EQ(pipeline.Send(request, Context())->GetStatusCode(), HttpStatusCode::Ok);
+  EXPECT_FALSE(hasTraceParent);
+}
@@ -170,6 +170,28 @@ namespace Azure { namespace Core { namespace Test {
     }
   }
 
+  TEST_P(TransportAdapter, getAsync)
+  {
+    Azure::Core::Url host(AzureSdkHttpbinServer::Get());
+
+    auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Get, host);
+    auto response
+        = m_pipeline->SendAsync(request, Azure::Core::Context::ApplicationContext).get();
+    checkResponseCode(response->GetStatusCode());
+    auto expectedResponseBodySize = std::stoull(response->GetHeaders().at("content-length"));
+    CheckBodyFromBuffer(*response, expectedResponseBodySize);
+
+    // An error response is buffered even for a request streaming its response. A PUT to a GET
+    // url returns an error code from the server.
+    auto requestBodyVector = std::vector<uint8_t>(10, 'x');
+    auto bodyRequest = Azure::Core::IO::MemoryBodyStream(requestBodyVector);
+    request = Azure::Core::Http::Request(
+        Azure::Core::Http::HttpMethod::Put, host, &bodyRequest, false);
+    response = m_pipeline->SendAsync(request, Azure::Core::Context::ApplicationContext).get();
+    EXPECT_GE(static_cast<int>(response->GetStatusCode()), 400);
+    EXPECT_EQ(response->ExtractBodyStream(), nullptr);
+  }
+
   // **********************
   // ***Same tests but getting stream to pull from socket, simulating the Download Op
   // **********************
@@ -193,6 +215,18 @@ namespace Azure { namespace Core { namespace Test {
     CheckBodyFromStream(*response, expectedResponseBodySize + 6 + 13);
   }
 
+  TEST_P(TransportAdapter, getWithStreamAsync)
+  {
+    Azure::Core::Url host(AzureSdkHttpbinServer::Get());
+
+    auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Get, host, false);
+    auto response
+        = m_pipeline->SendAsync(request, Azure::Core::Context::ApplicationContext).get();
+    checkResponseCode(response->GetStatusCode());
+    auto expectedResponseBodySize = std::stoull(response->GetHeaders().at("content-length"));
+    CheckBodyFromStream(*response, expectedResponseBodySize);
+  }
+
   TEST_P(TransportAdapter, getLoopWithStream)
   {
     Azure::Core::Url host(AzureSdkHttpbinServer::Get());
@@ -33,6 +33,15 @@ namespace Azure { namespace Core { namespace Test {
       return TransportAdaptersTestParameter(std::move(suffix), options);
     }
 
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+    static std::shared_ptr<Azure::Core::Http::HttpTransport> CreateCurlMultiHttp2Transport()
+    {
+      Azure::Core::Http::CurlMultiTransportOptions options;
+      options.EnableHttp2 = true;
+      return std::make_shared<Azure::Core::Http::CurlMultiTransport>(options);
+    }
+#endif
+
     // When adding more than one parameter, this function should return a unique string.
     static std::string GetSuffix(const testing::TestParamInfo<TransportAdapter::ParamType>& info)
     {
@@ -54,7 +63,10 @@ namespace Azure { namespace Core { namespace Test {
       TransportAdapter,
       testing::Values(
           GetTransportOptions("winHttp", std::make_shared<Azure::Core::Http::WinHttpTransport>()),
-          GetTransportOptions("libCurl", std::make_shared<Azure::Core::Http::CurlTransport>())),
+          GetTransportOptions("libCurl", std::make_shared<Azure::Core::Http::CurlTransport>()),
+          GetTransportOptions(
+              "libCurlMulti", std::make_shared<Azure::Core::Http::CurlMultiTransport>()),
+          GetTransportOptions("libCurlMultiHttp2", CreateCurlMultiHttp2Transport())),
       GetSuffix);
 
 #elif defined(BUILD_TRANSPORT_WINHTTP_ADAPTER)
@@ -72,7 +84,10 @@ namespace Azure { namespace Core { namespace Test {
       Test,
       TransportAdapter,
       testing::Values(
-          GetTransportOptions("libCurl", std::make_shared<Azure::Core::Http::CurlTransport>())),
+          GetTransportOptions("libCurl", std::make_shared<Azure::Core::Http::CurlTransport>()),
+          GetTransportOptions(
+              "libCurlMulti", std::make_shared<Azure::Core::Http::CurlMultiTransport>()),
+          GetTransportOptions("libCurlMultiHttp2", CreateCurlMultiHttp2Transport())),
       GetSuffix);
 #else
   /* Custom adapter. Not adding tests */
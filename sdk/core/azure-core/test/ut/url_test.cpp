@@ -312,4 +312,43 @@ namespace Azure { namespace Core { namespace Test {
     EXPECT_EQ(url1.GetPath(), "x/y");
     EXPECT_EQ(url2.GetPath(), "x/y");
   }
+
+  TEST(URL, QueryParametersSorted)
+  {
+    Core::Url url("http://test.com/path?c=3&a=1&b=2&a=4");
+    url.AppendQueryParameter("d", "5");
+    url.AppendQueryParameter("b", "6");
+    url.RemoveQueryParameter("c");
+    url.RemoveQueryParameter("e");
+
+    std::vector<std::pair<std::string, std::string>> const expected{
+        {"a", "4"}, {"b", "6"}, {"d", "5"}};
+    EXPECT_EQ(url.GetQueryParametersView(), expected);
+    EXPECT_EQ(
+        url.GetQueryParameters(),
+        (std::map<std::string, std::string>(expected.begin(), expected.end())));
+    EXPECT_EQ(url.GetAbsoluteUrl(), "http://test.com/path?a=4&b=6&d=5");
+    EXPECT_EQ(url.GetRelativeUrl(), "path?a=4&b=6&d=5");
+
+    url.SetQueryParameters({{"z", "1"}, {"y", "2"}});
+    EXPECT_EQ(url.GetAbsoluteUrl(), "http://test.com/path?y=2&z=1");
+    url.SetQueryParameters({});
+    EXPECT_TRUE(url.GetQueryParametersView().empty());
+    EXPECT_EQ(url.GetAbsoluteUrl(), "http://test.com/path");
+  }
+
+  TEST(URL, EncodeDecode)
+  {
+    EXPECT_EQ(Core::Url::Encode("abc-XYZ_0.9~"), "abc-XYZ_0.9~");
+    EXPECT_EQ(Core::Url::Encode("a/b c\xff"), "a%2Fb%20c%FF");
+    EXPECT_EQ(Core::Url::Encode("a/b c", "/"), "a/b%20c");
+    EXPECT_EQ(Core::Url::Encode(""), "");
+
+    EXPECT_EQ(Core::Url::Decode("abc"), "abc");
+    EXPECT_EQ(Core::Url::Decode("a%2Fb%20c%ff+d"), "a/b c\xff d");
+    EXPECT_EQ(Core::Url::Decode(""), "");
+    EXPECT_THROW(Core::Url::Decode("a%2"), std::runtime_error);
+    EXPECT_THROW(Core::Url::Decode("a%G0"), std::runtime_error);
+    EXPECT_THROW(Core::Url::Decode("a%\xff" "0"), std::runtime_error);
+  }
 }}} // namespace Azure::Core::Test
@@ -70,3 +70,22 @@ TEST(Uuid, validChars)
       uuidKey,
       4);
 }
+
+TEST(Uuid, CreateUuids)
+{
+  EXPECT_TRUE(Uuid::CreateUuids(0).empty());
+
+  const size_t size = 100000;
+  auto const created = Uuid::CreateUuids(size);
+  EXPECT_EQ(created.size(), size);
+
+  std::set<std::string> uuids;
+  for (auto uuid : created)
+  {
+    auto const uuidKey = uuid.ToString();
+    // version 4
+    EXPECT_EQ(uuidKey[14], '4');
+    uuids.insert(uuidKey);
+  }
+  EXPECT_EQ(uuids.size(), size);
+}
@@ -11,6 +11,7 @@
 
 #include "azure/perf/argagg.hpp"
 #include "azure/perf/base_test.hpp"
+#include "azure/perf/canned_response_transport.hpp"
 #include "azure/perf/dynamic_test_options.hpp"
 #include "azure/perf/options.hpp"
 #include "azure/perf/program.hpp"
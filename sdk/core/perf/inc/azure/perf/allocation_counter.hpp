@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Counts the memory allocations of the performance tests.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Azure { namespace Perf {
+
+  /**
+   * @brief Counts the allocations made with the global `operator new`, which the performance
+   * framework replaces.
+   *
+   * @remark The allocations are only counted between #Start() and #Stop(), so the other runs pay
+   * a relaxed load per allocation. The allocations made with `malloc()` by C libraries, such as
+   * libcurl or OpenSSL, aren't counted.
+   */
+  class AllocationCounter final {
+  public:
+    /**
+     * @brief Starts counting the allocations of all the threads.
+     *
+     */
+    static void Start() noexcept { g_isCounting.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Stops counting the allocations.
+     *
+     */
+    static void Stop() noexcept { g_isCounting.store(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the number of allocations counted since the process started.
+     *
+     */
+    static uint64_t GetAllocationCount() noexcept;
+
+    /**
+     * @brief Gets the number of bytes allocated by the allocations counted since the process
+     * started.
+     *
+     */
+    static uint64_t GetAllocatedBytes() noexcept;
+
+    /**
+     * @brief Checks whether the allocations are being counted.
+     *
+     */
+    static bool IsCounting() noexcept { return g_isCounting.load(std::memory_order_relaxed); }
+
+  private:
+    static std::atomic<bool> g_isCounting;
+
+    AllocationCounter() = delete;
+    ~AllocationCounter() = delete;
+  };
+
+}} // namespace Azure::Perf
@@ -13,6 +13,7 @@
 
 #include "azure/perf/test_options.hpp"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -65,6 +66,16 @@ namespace Azure { namespace Perf {
      */
     virtual void Run(Azure::Core::Context const& cancellationToken) = 0;
 
+    /**
+     * @brief Get the number of bytes transferred by each run of the main test case.
+     *
+     * @remark When it isn't zero, the results also report the throughput in MB/s and the CPU time
+     * per GB transferred.
+     *
+     * @return The number of bytes, zero when the test doesn't transfer data.
+     */
+    virtual int64_t GetBytesPerOperation() { return 0; }
+
     /**
      * @brief Run one per test thread once that the main test loop finishes.
      *
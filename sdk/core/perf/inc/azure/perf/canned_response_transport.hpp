@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief An HTTP transport returning the same response from memory, to measure the SDK without
+ * the network.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/http/http.hpp>
+#include <azure/core/http/raw_response.hpp>
+#include <azure/core/http/transport.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Azure { namespace Perf {
+
+  /**
+   * @brief The response returned by a #CannedResponseTransport.
+   *
+   */
+  struct CannedResponse final
+  {
+    /**
+     * @brief The status code of the response.
+     *
+     */
+    Azure::Core::Http::HttpStatusCode StatusCode = Azure::Core::Http::HttpStatusCode::Ok;
+
+    /**
+     * @brief The reason phrase of the response.
+     *
+     */
+    std::string ReasonPhrase = "OK";
+
+    /**
+     * @brief The headers of the response. A `content-length` header with the size of the body is
+     * added when there is none.
+     *
+     */
+    std::vector<std::pair<std::string, std::string>> Headers;
+
+    /**
+     * @brief The body of the response.
+     *
+     */
+    std::vector<uint8_t> Body;
+  };
+
+  /**
+   * @brief An HTTP transport which returns the same response to every request.
+   *
+   * @details The request body is read, as a transport sending it would, and the response body is
+   * returned as a stream over the canned body, so that the SDK still reads it from a stream. The
+   * CPU time of a request sent with this transport is the cost of the SDK layers: the policies,
+   * the serialization of the request, and the deserialization of the response.
+   *
+   * @remark The transport can be shared by the test threads.
+   */
+  class CannedResponseTransport final : public Azure::Core::Http::HttpTransport {
+  private:
+    CannedResponse m_response;
+
+  public:
+    /**
+     * @brief Construct a transport returning \p response.
+     *
+     * @param response The response to return.
+     */
+    explicit CannedResponseTransport(CannedResponse response);
+
+    /**
+     * @brief Read the body of \p request and return the canned response.
+     *
+     * @param request The request to send.
+     * @param context A context to control the request lifetime.
+     */
+    std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+        Azure::Core::Http::Request& request,
+        Azure::Core::Context const& context) override;
+  };
+
+}} // namespace Azure::Perf
@@ -28,6 +28,13 @@ namespace Azure { namespace Perf {
    */
   struct GlobalTestOptions
   {
+    /**
+     * @brief Comma-separated results files, in JSON, of processes which ran the same test, to
+     * aggregate into one report instead of running the test.
+     *
+     */
+    std::string Aggregate;
+
     /**
      * @brief Define the duration of test in seconds
      *
@@ -84,18 +91,72 @@ namespace Azure { namespace Perf {
      */
     Azure::Nullable<int> Port;
 
+    /**
+     * @brief Number of processes running the test, started by this one and aggregated into one
+     * report.
+     *
+     */
+    int Processes = 1;
+
+    /**
+     * @brief Track and print the CPU time, context switches and allocations per operation.
+     *
+     */
+    bool Profile = false;
+
+    /**
+     * @brief File to write `enable` to before each test iteration and `disable` after it, e.g. the
+     * control FIFO of `perf record --control=fifo:<path>`.
+     *
+     */
+    std::string ProfilerControl;
+
     /**
      * @brief Target throughput (ops/sec).
      *
      */
     Azure::Nullable<int> Rate;
 
+    /**
+     * @brief File to write the results to, as CSV if its extension is `.csv` and JSON otherwise.
+     *
+     * @remark No results file is written when empty.
+     *
+     */
+    std::string ResultsFile;
+
+    /**
+     * @brief Time, in RFC 3339 format, to wait for after the set up before starting the warmup,
+     * to start the processes of a distributed run together.
+     *
+     * @remark The processes on different hosts need synchronized clocks.
+     *
+     */
+    std::string StartAt;
+
+    /**
+     * @brief Seconds between starting the processes and the start of their tests, for their set
+     * up.
+     *
+     */
+    int StartDelay = 10;
+
     /**
      * @brief Duration of warmup in seconds.
      *
      */
     int Warmup = 5;
 
+    /**
+     * @brief Percent of variation of the throughput from one second to the next under which the
+     * warmup is steady, then stopped before #Warmup seconds.
+     *
+     * @remark Zero for a warmup of #Warmup seconds. A second which opened new connections isn't
+     * steady, so the connection pool is full before the test starts.
+     *
+     */
+    int WarmupTolerance = 0;
+
     /**
      * @brief Create an array of the performance framework options.
      *
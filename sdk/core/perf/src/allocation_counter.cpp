@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/perf/allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+using Azure::Perf::AllocationCounter;
+
+namespace {
+// The threads count into different slots, so that they don't contend on a single cache line.
+constexpr size_t SlotCount = 16;
+
+struct alignas(64) Slot final
+{
+  std::atomic<uint64_t> Allocations{0};
+  std::atomic<uint64_t> Bytes{0};
+};
+
+Slot g_slots[SlotCount];
+std::atomic<size_t> g_nextSlot{0};
+
+Slot& GetThreadSlot() noexcept
+{
+  thread_local size_t const slot = g_nextSlot.fetch_add(1, std::memory_order_relaxed) % SlotCount;
+  return g_slots[slot];
+}
+
+void* Allocate(std::size_t size)
+{
+  if (AllocationCounter::IsCounting())
+  {
+    auto& slot = GetThreadSlot();
+    slot.Allocations.fetch_add(1, std::memory_order_relaxed);
+    slot.Bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  for (;;)
+  {
+    if (auto allocation = std::malloc(size == 0 ? 1 : size))
+    {
+      return allocation;
+    }
+    auto const handler = std::get_new_handler();
+    if (handler == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void* AllocateNoThrow(std::size_t size) noexcept
+{
+  try
+  {
+    return Allocate(size);
+  }
+  catch (std::bad_alloc const&)
+  {
+    return nullptr;
+  }
+}
+} // namespace
+
+std::atomic<bool> AllocationCounter::g_isCounting(false);
+
+uint64_t AllocationCounter::GetAllocationCount() noexcept
+{
+  uint64_t count = 0;
+  for (auto const& slot : g_slots)
+  {
+    count += slot.Allocations.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t AllocationCounter::GetAllocatedBytes() noexcept
+{
+  uint64_t bytes = 0;
+  for (auto const& slot : g_slots)
+  {
+    bytes += slot.Bytes.load(std::memory_order_relaxed);
+  }
+  return bytes;
+}
+
+// The replaceable allocation functions, see [new.delete]. The aligned overloads aren't replaced,
+// the default ones allocate and free their memory together.
+void* operator new(std::size_t size) { return Allocate(size); }
+
+void* operator new[](std::size_t size) { return Allocate(size); }
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+  return AllocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+  return AllocateNoThrow(size);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::nothrow_t const&) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer, std::nothrow_t const&) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
@@ -49,6 +49,10 @@ Azure::Perf::GlobalTestOptions Azure::Perf::Program::ArgParser::Parse(
     argagg::parser_results const& parsedArgs)
 {
   Azure::Perf::GlobalTestOptions options;
+  if (parsedArgs["Aggregate"])
+  {
+    options.Aggregate = parsedArgs["Aggregate"].as<std::string>();
+  }
   if (parsedArgs["Duration"])
   {
     options.Duration = parsedArgs["Duration"];
@@ -85,14 +89,42 @@ Azure::Perf::GlobalTestOptions Azure::Perf::Program::ArgParser::Parse(
   {
     options.Port = parsedArgs["Port"];
   }
+  if (parsedArgs["Processes"])
+  {
+    options.Processes = parsedArgs["Processes"];
+  }
+  if (parsedArgs["Profile"])
+  {
+    options.Profile = parsedArgs["Profile"].as<bool>();
+  }
+  if (parsedArgs["ProfilerControl"])
+  {
+    options.ProfilerControl = parsedArgs["ProfilerControl"].as<std::string>();
+  }
   if (parsedArgs["Rate"])
   {
     options.Rate = parsedArgs["Rate"];
   }
+  if (parsedArgs["ResultsFile"])
+  {
+    options.ResultsFile = parsedArgs["ResultsFile"].as<std::string>();
+  }
+  if (parsedArgs["StartAt"])
+  {
+    options.StartAt = parsedArgs["StartAt"].as<std::string>();
+  }
+  if (parsedArgs["StartDelay"])
+  {
+    options.StartDelay = parsedArgs["StartDelay"];
+  }
   if (parsedArgs["Warmup"])
   {
     options.Warmup = parsedArgs["Warmup"];
   }
+  if (parsedArgs["WarmupTolerance"])
+  {
+    options.WarmupTolerance = parsedArgs["WarmupTolerance"];
+  }
 
   return options;
 }
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/perf/canned_response_transport.hpp"
+
+#include <azure/core/io/body_stream.hpp>
+
+using Azure::Core::Context;
+using Azure::Core::Http::RawResponse;
+using Azure::Core::Http::Request;
+using Azure::Perf::CannedResponseTransport;
+
+namespace {
+constexpr size_t RequestBodyChunkSize = 64 * 1024;
+} // namespace
+
+CannedResponseTransport::CannedResponseTransport(CannedResponse response)
+    : m_response(std::move(response))
+{
+}
+
+std::unique_ptr<RawResponse> CannedResponseTransport::Send(
+    Request& request,
+    Context const& context)
+{
+  if (auto const bodyStream = request.GetBodyStream())
+  {
+    thread_local std::vector<uint8_t> buffer(RequestBodyChunkSize);
+    while (bodyStream->Read(buffer.data(), buffer.size(), context) != 0)
+    {
+    }
+  }
+
+  auto response = std::make_unique<RawResponse>(
+      1, 1, m_response.StatusCode, m_response.ReasonPhrase);
+  for (auto const& header : m_response.Headers)
+  {
+    response->SetHeader(header.first, header.second);
+  }
+  if (response->GetHeaders().count("content-length") == 0)
+  {
+    response->SetHeader("content-length", std::to_string(m_response.Body.size()));
+  }
+  response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+      m_response.Body.data(), m_response.Body.size()));
+  return response;
+}
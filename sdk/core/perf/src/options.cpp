@@ -8,6 +8,7 @@
 void Azure::Perf::to_json(Azure::Core::Json::_internal::json& j, const GlobalTestOptions& p)
 {
   j = Azure::Core::Json::_internal::json{
+      {"Aggregate", p.Aggregate},
       {"Duration", p.Duration},
       {"Host", p.Host},
       {"Insecure", p.Insecure},
@@ -16,7 +17,14 @@ void Azure::Perf::to_json(Azure::Core::Json::_internal::json& j, const GlobalTes
       {"Latency", p.Latency},
       {"NoCleanup", p.NoCleanup},
       {"Parallel", p.Parallel},
-      {"Warmup", p.Warmup}};
+      {"Processes", p.Processes},
+      {"Profile", p.Profile},
+      {"ProfilerControl", p.ProfilerControl},
+      {"ResultsFile", p.ResultsFile},
+      {"StartAt", p.StartAt},
+      {"StartDelay", p.StartDelay},
+      {"Warmup", p.Warmup},
+      {"WarmupTolerance", p.WarmupTolerance}};
   if (p.Port)
   {
     j["Port"] = p.Port.Value();
@@ -48,10 +56,16 @@ std::vector<Azure::Perf::TestOption> Azure::Perf::GlobalTestOptions::GetOptionMe
     [Option('p', "parallel", Default = 1, HelpText = "Number of operations to execute in parallel")]
     [Option("port", HelpText = "Port to redirect HTTP requests")]
     [Option('r', "rate", HelpText = "Target throughput (ops/sec)")]
+    [Option("results-file", HelpText = "File to write the results to")]
     [Option("sync", HelpText = "Runs sync version of test")]  -- Not supported
     [Option('w', "warmup", Default = 5, HelpText = "Duration of warmup in seconds")]
   */
   return {
+      {"Aggregate",
+       {"--aggregate"},
+       "Comma-separated JSON results files of processes which ran the same test, to aggregate "
+       "instead of running the test.",
+       1},
       {"Duration",
        {"-d", "--duration"},
        "Duration of the test in seconds. Default to 10 seconds.",
@@ -73,7 +87,39 @@ std::vector<Azure::Perf::TestOption> Azure::Perf::GlobalTestOptions::GetOptionMe
        "Number of operations to execute in parallel. Default to 1.",
        1},
       {"Port", {"--port"}, "Port to redirect HTTP requests. Default to no redirection.", 1},
+      {"Processes",
+       {"--processes"},
+       "Number of processes running the test, with aggregated results. Default to 1.",
+       1},
+      {"Profile",
+       {"--profile"},
+       "Track and print the CPU time, context switches and allocations per operation. Default to "
+       "false.",
+       1},
+      {"ProfilerControl",
+       {"--profiler-control"},
+       "File to write enable and disable to around the test iterations, e.g. the control FIFO of "
+       "perf record. No file by default.",
+       1},
       {"Rate", {"-r", "--rate"}, "Target throughput (ops/sec). Default to no throughput.", 1},
+      {"ResultsFile",
+       {"--results-file"},
+       "File to write the results to, as CSV if its extension is .csv and JSON otherwise. No file "
+       "by default.",
+       1},
+      {"StartAt",
+       {"--start-at"},
+       "Time (RFC 3339) to start the warmup at, after the set up. Default to no wait.",
+       1},
+      {"StartDelay",
+       {"--start-delay"},
+       "Seconds from starting the processes to starting their tests. Default to 10 seconds.",
+       1},
       {"Warmup", {"-w", "--warmup"}, "Duration of warmup in seconds. Default to 5 seconds.", 1},
+      {"WarmupTolerance",
+       {"--warmup-tolerance"},
+       "Percent of variation of the throughput between two seconds under which the warmup stops "
+       "early, once no new connection is opened. Default to 0, the whole warmup.",
+       1},
       {"help", {"-h", "--help"}, "Display help information.", 0}};
 }
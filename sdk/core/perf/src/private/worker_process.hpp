@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief A process started to run a test of a distributed run.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/platform.hpp>
+
+#if defined(AZ_PLATFORM_POSIX)
+#include <sys/types.h>
+#endif
+
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Perf { namespace _detail {
+
+  /**
+   * @brief A child process, with its standard output and error written to a file.
+   *
+   * @remark The destructor waits for the process if #Wait() wasn't called, so that it doesn't
+   * outlive the program which started it.
+   */
+  class WorkerProcess final {
+  private:
+#if defined(AZ_PLATFORM_WINDOWS)
+    void* m_process = nullptr;
+#else
+    pid_t m_pid = -1;
+#endif
+    bool m_isWaited = false;
+    int m_exitCode = -1;
+
+  public:
+    /**
+     * @brief Starts a process.
+     *
+     * @param executable The path of the program to run.
+     * @param arguments The arguments of the program, without the program name.
+     * @param outputPath The file to write the output of the process to.
+     *
+     * @throw std::runtime_error The process couldn't be started.
+     */
+    WorkerProcess(
+        std::string const& executable,
+        std::vector<std::string> const& arguments,
+        std::string const& outputPath);
+
+    WorkerProcess(WorkerProcess const&) = delete;
+    WorkerProcess& operator=(WorkerProcess const&) = delete;
+
+    ~WorkerProcess();
+
+    /**
+     * @brief Waits for the process to exit.
+     *
+     * @return The exit code of the process, -1 if it was ended by a signal.
+     */
+    int Wait();
+
+    /**
+     * @brief Gets the path of the running program, to start copies of it.
+     *
+     * @param argv0 The first command line argument of the program.
+     */
+    static std::string GetExecutablePath(char const* argv0);
+  };
+
+}}} // namespace Azure::Perf::_detail
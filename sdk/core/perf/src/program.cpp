@@ -2,13 +2,47 @@
 // SPDX-License-Identifier: MIT
 
 #include "azure/perf/program.hpp"
+#include "azure/perf/allocation_counter.hpp"
 #include "azure/perf/argagg.hpp"
+#include "private/worker_process.hpp"
 
+#include <azure/core/datetime.hpp>
+#include <azure/core/diagnostics/metrics.hpp>
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+#include <azure/core/http/curl_transport.hpp>
+#endif
 #include <azure/core/internal/json/json.hpp>
 #include <azure/core/internal/strings.hpp>
+#include <azure/core/platform.hpp>
+#include <azure/core/uuid.hpp>
 
+#if defined(AZ_PLATFORM_WINDOWS)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+
+#include <psapi.h>
+#elif defined(AZ_PLATFORM_POSIX)
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
 
 namespace {
@@ -64,10 +98,42 @@ inline std::string ReplaceAll(
   return src;
 }
 
-inline void PrintOptions(
-    Azure::Perf::GlobalTestOptions const& options,
+inline Azure::Core::Json::_internal::json GetTestOptions(
     std::vector<Azure::Perf::TestOption> const& testOptions,
     argagg::parser_results const& parsedArgs)
+{
+  Azure::Core::Json::_internal::json optionsAsJson = Azure::Core::Json::_internal::json::object();
+  for (auto option : testOptions)
+  {
+    try
+    {
+      optionsAsJson[option.Name]
+          = option.sensitiveData ? "***" : parsedArgs[option.Name].as<std::string>();
+    }
+    catch (std::out_of_range const&)
+    {
+      if (!option.required)
+      {
+        // arg was not parsed
+        optionsAsJson[option.Name] = "default value";
+      }
+      else
+      {
+        // re-throw
+        throw std::invalid_argument("Missing mandatory parameter: " + option.Name);
+      }
+    }
+    catch (std::exception const&)
+    {
+      throw;
+    }
+  }
+  return optionsAsJson;
+}
+
+inline void PrintOptions(
+    Azure::Perf::GlobalTestOptions const& options,
+    Azure::Core::Json::_internal::json const& testOptions)
 {
   {
     std::cout << std::endl << "=== Global Options ===" << std::endl;
@@ -78,51 +144,87 @@ inline void PrintOptions(
   if (testOptions.size() > 0)
   {
     std::cout << std::endl << "=== Test Options ===" << std::endl;
-    Azure::Core::Json::_internal::json optionsAsJson;
-    for (auto option : testOptions)
+    std::cout << ReplaceAll(testOptions.dump(), ",", ",\n") << std::endl << std::endl;
+  }
+}
+
+// The progress of a parallel task. It is only written by its task, and read by the progress
+// reporter. The padding before the counters keeps those of two tasks at least a cache line apart
+// wherever the vector is allocated, so that the tasks don't invalidate each other's cache line.
+struct TaskCounters final
+{
+  char Padding[64];
+  std::atomic<uint64_t> CompletedOperations{0};
+  std::atomic<std::chrono::nanoseconds> LastCompletionTime{std::chrono::nanoseconds(0)};
+};
+
+// Waits until the scheduled start of the next operation, returns false if cancelled meanwhile.
+inline bool WaitUntil(
+    std::chrono::steady_clock::time_point scheduledStart,
+    std::atomic<bool> const& isCancelled)
+{
+  // The wait is split so that a rate of a few operations per second doesn't outlast the test.
+  constexpr std::chrono::milliseconds MaxWait(100);
+  for (auto now = std::chrono::steady_clock::now(); now < scheduledStart;
+       now = std::chrono::steady_clock::now())
+  {
+    if (isCancelled.load(std::memory_order_relaxed))
     {
-      try
-      {
-        optionsAsJson[option.Name]
-            = option.sensitiveData ? "***" : parsedArgs[option.Name].as<std::string>();
-      }
-      catch (std::out_of_range const&)
-      {
-        if (!option.required)
-        {
-          // arg was not parsed
-          optionsAsJson[option.Name] = "default value";
-        }
-        else
-        {
-          // re-throw
-          throw std::invalid_argument("Missing mandatory parameter: " + option.Name);
-        }
-      }
-      catch (std::exception const&)
-      {
-        throw;
-      }
+      return false;
     }
-    std::cout << ReplaceAll(optionsAsJson.dump(), ",", ",\n") << std::endl << std::endl;
+    std::this_thread::sleep_for((std::min)(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(MaxWait),
+        scheduledStart - now));
   }
+  return true;
 }
 
 inline void RunLoop(
     Azure::Core::Context const& context,
     Azure::Perf::PerfTest& test,
-    uint64_t& completedOperations,
-    std::chrono::nanoseconds& lastCompletionTimes,
-    bool latency,
-    bool& isCancelled)
+    TaskCounters& counters,
+    std::chrono::system_clock::time_point start,
+    Azure::Core::Diagnostics::LatencyHistogram* latency,
+    Azure::Nullable<std::chrono::nanoseconds> const& operationInterval,
+    std::chrono::nanoseconds firstOperationDelay,
+    std::atomic<bool> const& isCancelled)
 {
-  (void)latency;
-  auto start = std::chrono::system_clock::now();
-  while (!isCancelled)
+  // With a target rate, the operations start at fixed times whether or not the previous ones are
+  // done, and their latency is measured from the time they were scheduled to start. Otherwise a
+  // slow operation would delay the next ones and hide how long they waited.
+  auto scheduledStart = std::chrono::steady_clock::now()
+      + std::chrono::duration_cast<std::chrono::steady_clock::duration>(firstOperationDelay);
+  uint64_t completedOperations = 0;
+  while (!isCancelled.load(std::memory_order_relaxed))
   {
-    test.Run(context);
-    completedOperations += 1;
-    lastCompletionTimes = std::chrono::system_clock::now() - start;
+    if (!operationInterval.HasValue() && latency == nullptr)
+    {
+      test.Run(context);
+    }
+    else
+    {
+      auto operationStart = std::chrono::steady_clock::now();
+      if (operationInterval.HasValue())
+      {
+        if (!WaitUntil(scheduledStart, isCancelled))
+        {
+          break;
+        }
+        operationStart = scheduledStart;
+        scheduledStart += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            operationInterval.Value());
+      }
+      test.Run(context);
+      if (latency != nullptr)
+      {
+        latency->Record(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - operationStart));
+      }
+    }
+    // Relaxed stores are plain moves, the counters don't order any other memory.
+    counters.CompletedOperations.store(++completedOperations, std::memory_order_relaxed);
+    counters.LastCompletionTime.store(
+        std::chrono::system_clock::now() - start, std::memory_order_relaxed);
   }
 }
 
@@ -159,104 +261,439 @@ template <class T> inline std::string FormatNumber(T const& number, bool showDec
   return numberString;
 }
 
-template <class T> inline T Sum(std::vector<T> const& array)
+inline uint64_t SumOperations(std::vector<TaskCounters> const& counters)
 {
-  T s = 0;
-  for (T item : array)
+  uint64_t s = 0;
+  for (auto const& item : counters)
   {
-    s += item;
+    s += item.CompletedOperations.load(std::memory_order_relaxed);
   }
   return s;
 }
 
-inline std::vector<double> ZipAvg(
-    std::vector<uint64_t> const& operations,
-    std::vector<std::chrono::nanoseconds> const& timeResults)
+inline double SumOperationsPerSecond(std::vector<TaskCounters> const& counters)
 {
-  auto size = operations.size();
-  std::vector<double> s(size);
-  for (size_t index = 0; index != operations.size(); index++)
+  double s = 0;
+  for (auto const& item : counters)
   {
-    s[index] = operations[index] / std::chrono::duration<double>(timeResults[index]).count();
+    auto const operations = item.CompletedOperations.load(std::memory_order_relaxed);
+    auto const time = item.LastCompletionTime.load(std::memory_order_relaxed);
+    // A task may complete no operation, e.g. with a target rate below the number of tasks.
+    if (operations != 0)
+    {
+      s += operations / std::chrono::duration<double>(time).count();
+    }
   }
   return s;
 }
 
-inline void RunTests(
+// The connections opened by the transports since the start of the program, zero without the
+// curl transport, whose connection pool is the only one counting its connections.
+inline uint64_t GetCreatedConnections()
+{
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+  return Azure::Core::Http::_internal::GetCurlConnectionPoolStatistics().CreatedConnections;
+#else
+  return 0;
+#endif
+}
+
+// Waits until the deadline, or until the last second of operations is steady: its throughput is
+// within the tolerance of the second before, and it didn't open any new connection.
+inline void WaitUntilSteady(
+    std::vector<TaskCounters> const& counters,
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point deadline,
+    int tolerancePercent)
+{
+  uint64_t lastOperations = 0;
+  uint64_t lastSecondOperations = 0;
+  auto lastConnections = GetCreatedConnections();
+  for (auto secondEnd = start + std::chrono::seconds(1); secondEnd < deadline;
+       secondEnd += std::chrono::seconds(1))
+  {
+    std::this_thread::sleep_until(secondEnd);
+    auto const operations = SumOperations(counters);
+    auto const secondOperations = operations - lastOperations;
+    auto const connections = GetCreatedConnections();
+    auto const variation = static_cast<double>(
+        secondOperations > lastSecondOperations ? secondOperations - lastSecondOperations
+                                                : lastSecondOperations - secondOperations);
+    if (lastSecondOperations != 0 && connections == lastConnections
+        && variation * 100 <= static_cast<double>(tolerancePercent * lastSecondOperations))
+    {
+      std::cout << "Steady after "
+                << std::chrono::duration_cast<std::chrono::seconds>(secondEnd - start).count()
+                << "s" << std::endl;
+      return;
+    }
+    lastOperations = operations;
+    lastSecondOperations = secondOperations;
+    lastConnections = connections;
+  }
+  std::this_thread::sleep_until(deadline);
+}
+
+// The percentiles printed and written to the results file.
+constexpr double LatencyPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+inline std::string FormatMilliseconds(std::chrono::microseconds duration)
+{
+  std::ostringstream formatted;
+  formatted << std::fixed << std::setprecision(3)
+            << std::chrono::duration<double, std::milli>(duration).count() << " ms";
+  return formatted.str();
+}
+
+inline void PrintLatencyDistribution(Azure::Core::Diagnostics::LatencyHistogram const& latency)
+{
+  std::cout << "=== Latency Distribution ===" << std::endl;
+  if (latency.GetCount() == 0)
+  {
+    std::cout << "No operation completed." << std::endl << std::endl;
+    return;
+  }
+  for (auto percentile : LatencyPercentiles)
+  {
+    std::ostringstream label;
+    label << "p" << percentile;
+    std::cout << label.str() << "\t\t" << FormatMilliseconds(latency.GetPercentile(percentile))
+              << std::endl;
+  }
+  std::cout << "max\t\t" << FormatMilliseconds(latency.GetMax()) << std::endl
+            << "mean\t\t" << FormatMilliseconds(latency.GetSum() / latency.GetCount())
+            << std::endl
+            << std::endl;
+}
+
+struct ResourceUsage final
+{
+  std::chrono::microseconds UserCpuTime{0};
+  std::chrono::microseconds SystemCpuTime{0};
+  // Zero when the platform doesn't tell.
+  int64_t PeakResidentSetBytes = 0;
+  int64_t VoluntaryContextSwitches = 0;
+  int64_t InvoluntaryContextSwitches = 0;
+};
+
+inline ResourceUsage GetResourceUsage()
+{
+  ResourceUsage usage;
+#if defined(AZ_PLATFORM_WINDOWS)
+  FILETIME creationTime{};
+  FILETIME exitTime{};
+  FILETIME kernelTime{};
+  FILETIME userTime{};
+  if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+  {
+    auto const toMicroseconds = [](FILETIME const& time) {
+      // FILETIME counts 100 nanoseconds.
+      return std::chrono::microseconds(
+          ((static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10);
+    };
+    usage.UserCpuTime = toMicroseconds(userTime);
+    usage.SystemCpuTime = toMicroseconds(kernelTime);
+  }
+  PROCESS_MEMORY_COUNTERS memoryCounters{};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+  {
+    usage.PeakResidentSetBytes = static_cast<int64_t>(memoryCounters.PeakWorkingSetSize);
+  }
+#elif defined(AZ_PLATFORM_POSIX)
+  rusage resourceUsage{};
+  if (getrusage(RUSAGE_SELF, &resourceUsage) == 0)
+  {
+    auto const toMicroseconds = [](timeval const& time) {
+      return std::chrono::seconds(time.tv_sec) + std::chrono::microseconds(time.tv_usec);
+    };
+    usage.UserCpuTime = toMicroseconds(resourceUsage.ru_utime);
+    usage.SystemCpuTime = toMicroseconds(resourceUsage.ru_stime);
+    usage.VoluntaryContextSwitches = static_cast<int64_t>(resourceUsage.ru_nvcsw);
+    usage.InvoluntaryContextSwitches = static_cast<int64_t>(resourceUsage.ru_nivcsw);
+#if defined(__APPLE__)
+    usage.PeakResidentSetBytes = static_cast<int64_t>(resourceUsage.ru_maxrss);
+#else
+    // Linux counts kilobytes.
+    usage.PeakResidentSetBytes = static_cast<int64_t>(resourceUsage.ru_maxrss) * 1024;
+#endif
+  }
+#endif
+  return usage;
+}
+
+// The resources used by an operation of a test, on average.
+struct ProfileResult final
+{
+  double UserCpuMicroseconds = 0;
+  double SystemCpuMicroseconds = 0;
+  double VoluntaryContextSwitches = 0;
+  double InvoluntaryContextSwitches = 0;
+  double Allocations = 0;
+  double AllocatedBytes = 0;
+};
+
+inline void PrintProfile(ProfileResult const& profile)
+{
+  std::ostringstream output;
+  output << std::fixed << std::setprecision(3) << "=== Profile (per operation) ===" << std::endl
+         << "User CPU\t\t" << profile.UserCpuMicroseconds << " us" << std::endl
+         << "System CPU\t\t" << profile.SystemCpuMicroseconds << " us" << std::endl
+#if defined(AZ_PLATFORM_POSIX)
+         << "Context switches\t" << profile.VoluntaryContextSwitches << " voluntary, "
+         << profile.InvoluntaryContextSwitches << " involuntary" << std::endl
+#endif
+         << "Allocations\t\t" << profile.Allocations << " (" << profile.AllocatedBytes
+         << " bytes)" << std::endl
+         << std::endl;
+  std::cout << output.str();
+}
+
+inline Azure::Core::Json::_internal::json GetEnvironment()
+{
+  Azure::Core::Json::_internal::json environment;
+
+#if defined(AZ_PLATFORM_WINDOWS)
+  char hostName[MAX_COMPUTERNAME_LENGTH + 1] = {};
+  DWORD hostNameSize = sizeof(hostName);
+  environment["host"] = GetComputerNameA(hostName, &hostNameSize) ? hostName : "";
+  environment["os"] = "Windows";
+#elif defined(AZ_PLATFORM_POSIX)
+  char hostName[256] = {};
+  environment["host"] = gethostname(hostName, sizeof(hostName) - 1) == 0 ? hostName : "";
+  utsname systemName{};
+  environment["os"] = uname(&systemName) == 0 ? std::string(systemName.sysname) + " "
+          + systemName.release + " " + systemName.machine
+                                              : std::string();
+#endif
+  environment["cpuCount"] = std::thread::hardware_concurrency();
+
+#if defined(__clang__)
+  environment["compiler"] = "clang " __clang_version__;
+#elif defined(__GNUC__)
+  environment["compiler"] = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  environment["compiler"] = "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+  environment["compiler"] = "unknown";
+#endif
+#if defined(NDEBUG)
+  environment["buildType"] = "Release";
+#else
+  environment["buildType"] = "Debug";
+#endif
+
+  auto transports = Azure::Core::Json::_internal::json::array();
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+  transports.push_back("curl");
+#endif
+#if defined(BUILD_TRANSPORT_WINHTTP_ADAPTER)
+  transports.push_back("winhttp");
+#endif
+  environment["transports"] = transports;
+  return environment;
+}
+
+inline std::string EscapeCsv(std::string const& value)
+{
+  if (value.find_first_of(",\"\r\n") == std::string::npos)
+  {
+    return value;
+  }
+  return "\"" + ReplaceAll(value, "\"", "\"\"") + "\"";
+}
+
+inline std::string ToCsvValue(Azure::Core::Json::_internal::json const& value)
+{
+  if (value.is_null())
+  {
+    return "";
+  }
+  return EscapeCsv(value.is_string() ? value.get<std::string>() : value.dump());
+}
+
+// One row per iteration, appended to the file so that the runs of a test accumulate in it.
+inline void WriteCsvResults(
+    std::string const& path,
+    Azure::Core::Json::_internal::json const& results)
+{
+  bool const hasHeader = std::ifstream(path).peek() != std::ifstream::traits_type::eof();
+  std::ofstream file(path, std::ios::app);
+  if (!hasHeader)
+  {
+    file << "test,startTime,iteration,operations,operationsPerSecond,secondsPerOperation,"
+            "cpuSeconds,peakResidentSetBytes,megabytesPerSecond,cpuSecondsPerGigabyte,"
+            "connectionsOpened,p50Milliseconds,p90Milliseconds,p99Milliseconds,p99.9Milliseconds,maxMilliseconds,"
+            "meanMilliseconds,host,os,cpuCount,compiler,buildType,transports,options,"
+            "testOptions\n";
+  }
+
+  auto const& environment = results["environment"];
+  for (auto const& iteration : results["iterations"])
+  {
+    file << ToCsvValue(results["test"]) << "," << ToCsvValue(results["startTime"]) << ","
+         << ToCsvValue(iteration["name"]) << "," << ToCsvValue(iteration["operations"]) << ","
+         << ToCsvValue(iteration["operationsPerSecond"]) << ","
+         << ToCsvValue(iteration["secondsPerOperation"]) << ","
+         << ToCsvValue(iteration["cpuSeconds"]) << ","
+         << ToCsvValue(iteration["peakResidentSetBytes"]);
+    for (auto const* name :
+         {"megabytesPerSecond", "cpuSecondsPerGigabyte", "connectionsOpened"})
+    {
+      auto const value = iteration.find(name);
+      file << "," << (value == iteration.end() ? "" : ToCsvValue(*value));
+    }
+    auto const latency = iteration.find("latencyMilliseconds");
+    for (auto const* name : {"p50", "p90", "p99", "p99.9", "max", "mean"})
+    {
+      file << "," << (latency == iteration.end() ? "" : ToCsvValue((*latency)[name]));
+    }
+    file << "," << ToCsvValue(environment["host"]) << "," << ToCsvValue(environment["os"]) << ","
+         << ToCsvValue(environment["cpuCount"]) << "," << ToCsvValue(environment["compiler"])
+         << "," << ToCsvValue(environment["buildType"]) << ","
+         << ToCsvValue(environment["transports"]) << "," << ToCsvValue(results["options"]) << ","
+         << ToCsvValue(results["testOptions"]) << "\n";
+  }
+}
+
+inline void WriteResults(std::string const& path, Azure::Core::Json::_internal::json const& results)
+{
+  auto const extension = path.size() >= 4 ? path.substr(path.size() - 4) : std::string();
+  if (Azure::Core::_internal::StringExtensions::LocaleInvariantCaseInsensitiveEqual(
+          extension, ".csv"))
+  {
+    WriteCsvResults(path, results);
+  }
+  else
+  {
+    std::ofstream(path) << results.dump(2) << std::endl;
+  }
+}
+
+inline Azure::Core::Json::_internal::json RunTests(
     Azure::Core::Context const& context,
     std::vector<std::unique_ptr<Azure::Perf::PerfTest>> const& tests,
     Azure::Perf::GlobalTestOptions const& options,
     std::string const& title,
+    std::ostream* profilerControl,
     bool warmup = false)
 {
   (void)title;
   auto parallelTestsCount = options.Parallel;
   auto durationInSeconds = warmup ? options.Warmup : options.Duration;
   // auto jobStatistics = warmup ? false : options.JobStatistics;
-  // auto latency = warmup ? false : options.Latency;
+  auto latency = warmup ? false : options.Latency;
 
-  std::vector<uint64_t> completedOperations(parallelTestsCount);
-  std::vector<std::chrono::nanoseconds> lastCompletionTimes(parallelTestsCount);
+  std::vector<TaskCounters> counters(parallelTestsCount);
+  std::vector<Azure::Core::Diagnostics::LatencyHistogram> latencies(
+      latency ? parallelTestsCount : 0);
+  // The target rate is shared by the parallel tasks, each of them starting an operation every
+  // operationInterval, offset from each other so that the operations are evenly spread.
+  Azure::Nullable<std::chrono::nanoseconds> operationInterval;
+  std::chrono::nanoseconds rateUnit(0);
+  if (options.Rate.HasValue())
+  {
+    rateUnit = std::chrono::nanoseconds(std::chrono::seconds(1)) / options.Rate.Value();
+    operationInterval = rateUnit * parallelTestsCount;
+  }
 
   /********************* Progress Reporter ******************************/
   Azure::Core::Context progresToken;
   uint64_t lastCompleted = 0;
   auto progressThread = std::thread(
-      [&title, &completedOperations, &lastCompletionTimes, &lastCompleted, &progresToken]() {
+      [&title, &counters, &lastCompleted, &progresToken]() {
         std::cout << "=== " << title << " ===" << std::endl
                   << "Current\t\tTotal\t\tAverage" << std::endl;
         while (!progresToken.IsCancelled())
         {
           using namespace std::chrono_literals;
           std::this_thread::sleep_for(1000ms);
-          auto total = Sum(completedOperations);
+          auto total = SumOperations(counters);
           auto current = total - lastCompleted;
-          auto avg = Sum(ZipAvg(completedOperations, lastCompletionTimes));
+          auto avg = SumOperationsPerSecond(counters);
           lastCompleted = total;
           std::cout << current << "\t\t" << total << "\t\t" << avg << std::endl;
         }
       });
 
+  // The section measured by the profilers, whose resource usage is reported.
+  bool const profile = !warmup && options.Profile;
+  if (profilerControl != nullptr && !warmup)
+  {
+    *profilerControl << "enable" << std::endl;
+  }
+  auto const usageBefore = GetResourceUsage();
+  auto const connectionsBefore = GetCreatedConnections();
+  auto const allocationsBefore = Azure::Perf::AllocationCounter::GetAllocationCount();
+  auto const allocatedBytesBefore = Azure::Perf::AllocationCounter::GetAllocatedBytes();
+  if (profile)
+  {
+    Azure::Perf::AllocationCounter::Start();
+  }
+
   /********************* parallel test creation ******************************/
+  // Azure::Context is not good performer for checking cancellation inside the test loop, so the
+  // tasks check a flag set once the duration is over by this thread, as the timer of them all.
+  // The tasks also share the start time, so that their rates are measured over the same duration
+  // even when the last ones are created well after the first ones.
+  std::atomic<bool> isCancelled(false);
+  auto const start = std::chrono::system_clock::now();
   std::vector<std::thread> tasks(tests.size());
-  auto deadLineSeconds = std::chrono::seconds(durationInSeconds);
   for (size_t index = 0; index != tests.size(); index++)
   {
-    tasks[index] = std::thread(
-        [index, &tests, &completedOperations, &lastCompletionTimes, &deadLineSeconds, &context]() {
-          bool isCancelled = false;
-          // Azure::Context is not good performer for checking cancellation inside the test loop
-          auto manualCancellation = std::thread([&deadLineSeconds, &isCancelled] {
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(deadLineSeconds);
-            isCancelled = true;
-          });
-
-          RunLoop(
-              context,
-              *tests[index],
-              completedOperations[index],
-              lastCompletionTimes[index],
-              false,
-              isCancelled);
-
-          manualCancellation.join();
-        });
-  }
-  // Wait for all tests to complete setUp
+    tasks[index] = std::thread([index,
+                                &tests,
+                                &counters,
+                                &latencies,
+                                &operationInterval,
+                                rateUnit,
+                                start,
+                                &isCancelled,
+                                &context]() {
+      RunLoop(
+          context,
+          *tests[index],
+          counters[index],
+          start,
+          latencies.empty() ? nullptr : &latencies[index],
+          operationInterval,
+          rateUnit * static_cast<int64_t>(index),
+          isCancelled);
+    });
+  }
+  auto const deadline = start + std::chrono::seconds(durationInSeconds);
+  if (warmup && options.WarmupTolerance > 0)
+  {
+    WaitUntilSteady(counters, start, deadline, options.WarmupTolerance);
+  }
+  else
+  {
+    std::this_thread::sleep_until(deadline);
+  }
+  isCancelled = true;
   for (auto& t : tasks)
   {
     t.join();
   }
 
+  if (profile)
+  {
+    Azure::Perf::AllocationCounter::Stop();
+  }
+  auto const usageAfter = GetResourceUsage();
+  auto const connectionsOpened = GetCreatedConnections() - connectionsBefore;
+  if (profilerControl != nullptr && !warmup)
+  {
+    *profilerControl << "disable" << std::endl;
+  }
+
   // Stop progress
   progresToken.Cancel();
   progressThread.join();
 
   std::cout << std::endl << "=== Results ===";
 
-  auto totalOperations = Sum(completedOperations);
-  auto operationsPerSecond = Sum(ZipAvg(completedOperations, lastCompletionTimes));
+  auto totalOperations = SumOperations(counters);
+  auto operationsPerSecond = SumOperationsPerSecond(counters);
   auto secondsPerOperation = 1 / operationsPerSecond;
   auto weightedAverageSeconds = totalOperations / operationsPerSecond;
 
@@ -267,6 +704,404 @@ inline void RunTests(
             << FormatNumber(operationsPerSecond) << " ops/s, " << secondsPerOperation << " s/op)"
             << std::endl
             << std::endl;
+
+  Azure::Core::Json::_internal::json result;
+  result["name"] = title;
+  result["operations"] = totalOperations;
+  result["operationsPerSecond"] = operationsPerSecond;
+  result["secondsPerOperation"] = secondsPerOperation;
+  auto const userCpuTime = usageAfter.UserCpuTime - usageBefore.UserCpuTime;
+  auto const systemCpuTime = usageAfter.SystemCpuTime - usageBefore.SystemCpuTime;
+  result["cpuSeconds"] = std::chrono::duration<double>(userCpuTime + systemCpuTime).count();
+  result["peakResidentSetBytes"] = usageAfter.PeakResidentSetBytes;
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+  result["connectionsOpened"] = connectionsOpened;
+#endif
+  if (connectionsOpened != 0)
+  {
+    std::cout << "Connections opened: " << FormatNumber(connectionsOpened, false) << std::endl
+              << std::endl;
+  }
+
+  auto const bytesPerOperation = tests.front()->GetBytesPerOperation();
+  if (bytesPerOperation != 0 && totalOperations != 0)
+  {
+    auto const megabytesPerSecond
+        = operationsPerSecond * static_cast<double>(bytesPerOperation) / 1e6;
+    auto const cpuSecondsPerGigabyte = result["cpuSeconds"].get<double>()
+        / (static_cast<double>(totalOperations) * static_cast<double>(bytesPerOperation)
+           / 1e9);
+    std::cout << "Throughput: " << FormatNumber(megabytesPerSecond) << " MB/s, "
+              << cpuSecondsPerGigabyte << " CPU s/GB" << std::endl
+              << std::endl;
+    result["megabytesPerSecond"] = megabytesPerSecond;
+    result["cpuSecondsPerGigabyte"] = cpuSecondsPerGigabyte;
+  }
+
+  if (profile)
+  {
+    ProfileResult profileResult;
+    auto const operations = static_cast<double>((std::max)(totalOperations, uint64_t(1)));
+    profileResult.UserCpuMicroseconds = static_cast<double>(userCpuTime.count()) / operations;
+    profileResult.SystemCpuMicroseconds = static_cast<double>(systemCpuTime.count()) / operations;
+    profileResult.VoluntaryContextSwitches = static_cast<double>(
+                                                 usageAfter.VoluntaryContextSwitches
+                                                 - usageBefore.VoluntaryContextSwitches)
+        / operations;
+    profileResult.InvoluntaryContextSwitches = static_cast<double>(
+                                                   usageAfter.InvoluntaryContextSwitches
+                                                   - usageBefore.InvoluntaryContextSwitches)
+        / operations;
+    profileResult.Allocations = static_cast<double>(
+                                    Azure::Perf::AllocationCounter::GetAllocationCount()
+                                    - allocationsBefore)
+        / operations;
+    profileResult.AllocatedBytes = static_cast<double>(
+                                       Azure::Perf::AllocationCounter::GetAllocatedBytes()
+                                       - allocatedBytesBefore)
+        / operations;
+    PrintProfile(profileResult);
+
+    auto& profileJson = result["profilePerOperation"];
+    profileJson["userCpuMicroseconds"] = profileResult.UserCpuMicroseconds;
+    profileJson["systemCpuMicroseconds"] = profileResult.SystemCpuMicroseconds;
+    profileJson["voluntaryContextSwitches"] = profileResult.VoluntaryContextSwitches;
+    profileJson["involuntaryContextSwitches"] = profileResult.InvoluntaryContextSwitches;
+    profileJson["allocations"] = profileResult.Allocations;
+    profileJson["allocatedBytes"] = profileResult.AllocatedBytes;
+  }
+
+  if (latency)
+  {
+    // Each thread recorded into its own histogram, so the operations didn't contend on one.
+    Azure::Core::Diagnostics::LatencyHistogram mergedLatency;
+    for (auto const& threadLatency : latencies)
+    {
+      mergedLatency.Merge(threadLatency);
+    }
+    PrintLatencyDistribution(mergedLatency);
+
+    if (mergedLatency.GetCount() != 0)
+    {
+      auto const toMilliseconds = [](std::chrono::microseconds duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+      };
+      auto& latencyResult = result["latencyMilliseconds"];
+      for (auto percentile : LatencyPercentiles)
+      {
+        std::ostringstream name;
+        name << "p" << percentile;
+        latencyResult[name.str()] = toMilliseconds(mergedLatency.GetPercentile(percentile));
+      }
+      latencyResult["max"] = toMilliseconds(mergedLatency.GetMax());
+      latencyResult["mean"]
+          = toMilliseconds(mergedLatency.GetSum() / mergedLatency.GetCount());
+    }
+  }
+  return result;
+}
+
+
+// The options which a coordinator sets itself for its processes, with the value which follows.
+constexpr char const* CoordinatorOptions[]
+    = {"--processes", "--profiler-control", "--results-file", "--start-at", "--start-delay"};
+
+inline std::vector<std::string> GetProcessArguments(int argc, char** argv)
+{
+  std::vector<std::string> arguments;
+  for (int index = 1; index < argc; index++)
+  {
+    std::string const argument = argv[index];
+    auto const isCoordinatorOption = [&argument](char const* option) {
+      auto const length = std::strlen(option);
+      return argument.compare(0, length, option) == 0
+          && (argument.size() == length || argument[length] == '=');
+    };
+    auto const option = std::find_if(
+        std::begin(CoordinatorOptions), std::end(CoordinatorOptions), isCoordinatorOption);
+    if (option == std::end(CoordinatorOptions))
+    {
+      arguments.push_back(argument);
+    }
+    else if (argument.size() == std::strlen(*option))
+    {
+      // The value is the next argument.
+      index++;
+    }
+  }
+  return arguments;
+}
+
+inline Azure::Core::Json::_internal::json ReadResults(std::string const& path)
+{
+  std::ifstream file(path);
+  if (!file)
+  {
+    throw std::invalid_argument("Unable to open the results file " + path);
+  }
+  try
+  {
+    return Azure::Core::Json::_internal::json::parse(file);
+  }
+  catch (std::exception const& error)
+  {
+    throw std::invalid_argument("Unable to parse the results file " + path + ": " + error.what());
+  }
+}
+
+// Sums the throughput of the iterations of the processes. Their latency percentiles can't be
+// merged, so the aggregate takes the highest of each, an upper bound of the actual percentile.
+inline Azure::Core::Json::_internal::json AggregateIterations(
+    std::vector<Azure::Core::Json::_internal::json const*> const& iterations)
+{
+  using Azure::Core::Json::_internal::json;
+  json result;
+  result["name"] = (*iterations.front())["name"];
+  uint64_t operations = 0;
+  double operationsPerSecond = 0;
+  double cpuSeconds = 0;
+  int64_t peakResidentSetBytes = 0;
+  double megabytesPerSecond = 0;
+  double gigabytes = 0;
+  bool hasThroughput = true;
+  uint64_t connectionsOpened = 0;
+  bool hasConnections = true;
+  bool hasLatency = true;
+  bool hasProfile = true;
+  json perProcess = json::array();
+  for (auto const* iteration : iterations)
+  {
+    operations += (*iteration)["operations"].get<uint64_t>();
+    operationsPerSecond += (*iteration)["operationsPerSecond"].get<double>();
+    cpuSeconds += (*iteration)["cpuSeconds"].get<double>();
+    peakResidentSetBytes
+        = (std::max)(peakResidentSetBytes, (*iteration)["peakResidentSetBytes"].get<int64_t>());
+    perProcess.push_back((*iteration)["operationsPerSecond"]);
+    if (iteration->contains("megabytesPerSecond"))
+    {
+      megabytesPerSecond += (*iteration)["megabytesPerSecond"].get<double>();
+      gigabytes += (*iteration)["cpuSeconds"].get<double>()
+          / (*iteration)["cpuSecondsPerGigabyte"].get<double>();
+    }
+    else
+    {
+      hasThroughput = false;
+    }
+    if (iteration->contains("connectionsOpened"))
+    {
+      connectionsOpened += (*iteration)["connectionsOpened"].get<uint64_t>();
+    }
+    else
+    {
+      hasConnections = false;
+    }
+    hasLatency = hasLatency && iteration->contains("latencyMilliseconds");
+    hasProfile = hasProfile && iteration->contains("profilePerOperation");
+  }
+  result["operations"] = operations;
+  result["operationsPerSecond"] = operationsPerSecond;
+  result["secondsPerOperation"] = 1 / operationsPerSecond;
+  result["cpuSeconds"] = cpuSeconds;
+  result["peakResidentSetBytes"] = peakResidentSetBytes;
+  result["processOperationsPerSecond"] = perProcess;
+  if (hasThroughput)
+  {
+    result["megabytesPerSecond"] = megabytesPerSecond;
+    result["cpuSecondsPerGigabyte"] = cpuSeconds / gigabytes;
+  }
+  if (hasConnections)
+  {
+    result["connectionsOpened"] = connectionsOpened;
+  }
+
+  // The means are weighted by the operations of each process.
+  auto const weightedMean = [&iterations, operations](char const* object, std::string const& name) {
+    double sum = 0;
+    for (auto const* iteration : iterations)
+    {
+      sum += (*iteration)[object][name].get<double>()
+          * static_cast<double>((*iteration)["operations"].get<uint64_t>());
+    }
+    return operations == 0 ? 0 : sum / static_cast<double>(operations);
+  };
+  if (hasLatency)
+  {
+    auto& latency = result["latencyMilliseconds"];
+    for (auto const& item : (*iterations.front())["latencyMilliseconds"].items())
+    {
+      if (item.key() == "mean")
+      {
+        latency["mean"] = weightedMean("latencyMilliseconds", "mean");
+        continue;
+      }
+      double highest = 0;
+      for (auto const* iteration : iterations)
+      {
+        highest
+            = (std::max)(highest, (*iteration)["latencyMilliseconds"][item.key()].get<double>());
+      }
+      latency[item.key()] = highest;
+    }
+  }
+  if (hasProfile)
+  {
+    auto& profile = result["profilePerOperation"];
+    for (auto const& item : (*iterations.front())["profilePerOperation"].items())
+    {
+      profile[item.key()] = weightedMean("profilePerOperation", item.key());
+    }
+  }
+  return result;
+}
+
+inline Azure::Core::Json::_internal::json AggregateResults(
+    std::vector<Azure::Core::Json::_internal::json> const& processResults)
+{
+  using Azure::Core::Json::_internal::json;
+  auto const& first = processResults.front();
+  json results;
+  results["test"] = first["test"];
+  results["processes"] = processResults.size();
+  results["environment"] = first["environment"];
+  results["options"] = first["options"];
+  results["testOptions"] = first["testOptions"];
+  results["hosts"] = json::array();
+  results["startTime"] = first["startTime"];
+  size_t iterationCount = first["iterations"].size();
+  for (auto const& processResult : processResults)
+  {
+    if (processResult["test"] != first["test"])
+    {
+      throw std::invalid_argument(
+          "The results are of different tests, " + first["test"].get<std::string>() + " and "
+          + processResult["test"].get<std::string>() + ".");
+    }
+    results["hosts"].push_back(processResult["environment"]["host"]);
+    // The RFC 3339 times of the results are in UTC with the same precision, so they sort.
+    if (processResult["startTime"].get<std::string>() < results["startTime"].get<std::string>())
+    {
+      results["startTime"] = processResult["startTime"];
+    }
+    iterationCount = (std::min)(iterationCount, processResult["iterations"].size());
+  }
+
+  results["iterations"] = json::array();
+  for (size_t index = 0; index != iterationCount; index++)
+  {
+    std::vector<json const*> iterations;
+    for (auto const& processResult : processResults)
+    {
+      iterations.push_back(&processResult["iterations"][index]);
+    }
+    results["iterations"].push_back(AggregateIterations(iterations));
+  }
+  return results;
+}
+
+inline void PrintAggregatedResults(Azure::Core::Json::_internal::json const& results)
+{
+  std::cout << std::endl
+            << "=== Aggregated results of " << results["processes"].get<size_t>()
+            << " processes ===" << std::endl;
+  for (auto const& iteration : results["iterations"])
+  {
+    auto const operationsPerSecond = iteration["operationsPerSecond"].get<double>();
+    std::cout << iteration["name"].get<std::string>() << ": completed "
+              << FormatNumber(iteration["operations"].get<uint64_t>(), false) << " operations ("
+              << FormatNumber(operationsPerSecond) << " ops/s, " << 1 / operationsPerSecond
+              << " s/op)" << std::endl;
+    if (iteration.contains("megabytesPerSecond"))
+    {
+      std::cout << "Throughput: " << FormatNumber(iteration["megabytesPerSecond"].get<double>())
+                << " MB/s, " << iteration["cpuSecondsPerGigabyte"].get<double>() << " CPU s/GB"
+                << std::endl;
+    }
+    if (iteration.contains("latencyMilliseconds"))
+    {
+      std::cout << "Latency (ms, highest of the processes):";
+      for (auto const& item : iteration["latencyMilliseconds"].items())
+      {
+        std::cout << " " << item.key() << " " << item.value().get<double>();
+      }
+      std::cout << std::endl;
+    }
+  }
+  std::cout << std::endl;
+}
+
+inline void WriteAggregatedResults(
+    Azure::Perf::GlobalTestOptions const& options,
+    std::vector<Azure::Core::Json::_internal::json> const& processResults)
+{
+  auto const results = AggregateResults(processResults);
+  PrintAggregatedResults(results);
+  if (!options.ResultsFile.empty())
+  {
+    WriteResults(options.ResultsFile, results);
+    std::cout << "Results written to " << options.ResultsFile << std::endl;
+  }
+}
+
+// Runs the test in options.Processes copies of this program, whose tests start together once
+// they are all set up, and aggregates their results.
+inline void RunProcesses(
+    Azure::Perf::GlobalTestOptions const& options,
+    std::string const& testName,
+    int argc,
+    char** argv)
+{
+  auto const executable = Azure::Perf::_detail::WorkerProcess::GetExecutablePath(argv[0]);
+  auto const startAt
+      = Azure::DateTime(std::chrono::system_clock::now() + std::chrono::seconds(options.StartDelay))
+            .ToString(Azure::DateTime::DateFormat::Rfc3339);
+  auto const filePrefix = "perf-" + testName + "-" + Azure::Core::Uuid::CreateUuid().ToString();
+  std::cout << std::endl
+            << "Starting " << options.Processes << " processes, whose tests start at " << startAt
+            << "." << std::endl;
+
+  std::vector<std::string> resultsFiles;
+  std::vector<std::string> outputFiles;
+  std::vector<std::unique_ptr<Azure::Perf::_detail::WorkerProcess>> processes;
+  for (int index = 0; index < options.Processes; index++)
+  {
+    resultsFiles.push_back(filePrefix + "-" + std::to_string(index) + ".json");
+    outputFiles.push_back(filePrefix + "-" + std::to_string(index) + ".log");
+    auto arguments = GetProcessArguments(argc, argv);
+    arguments.insert(
+        arguments.end(), {"--start-at", startAt, "--results-file", resultsFiles.back()});
+    processes.push_back(std::make_unique<Azure::Perf::_detail::WorkerProcess>(
+        executable, arguments, outputFiles.back()));
+  }
+
+  std::vector<Azure::Core::Json::_internal::json> processResults;
+  for (size_t index = 0; index != processes.size(); index++)
+  {
+    auto const exitCode = processes[index]->Wait();
+    try
+    {
+      auto result = ReadResults(resultsFiles[index]);
+      if (exitCode != 0 || result.contains("error"))
+      {
+        throw std::runtime_error(
+            result.contains("error") ? result["error"].get<std::string>()
+                                     : "exit code " + std::to_string(exitCode));
+      }
+      processResults.push_back(std::move(result));
+      std::remove(resultsFiles[index].c_str());
+      std::remove(outputFiles[index].c_str());
+    }
+    catch (std::exception const& error)
+    {
+      std::cout << "Error: Process " << index << " failed: " << error.what() << ". See "
+                << outputFiles[index] << " for its output." << std::endl;
+    }
+  }
+
+  if (processResults.empty())
+  {
+    throw std::runtime_error("All the processes failed.");
+  }
+  WriteAggregatedResults(options, processResults);
 }
 
 } // namespace
@@ -294,6 +1129,26 @@ void Azure::Perf::Program::Run(
   // ReCreate Test with parsed results
   test = testGenerator(Azure::Perf::TestOptions(argResults));
   auto options = Azure::Perf::Program::ArgParser::Parse(argResults);
+  if (options.Rate.HasValue() && options.Rate.Value() <= 0)
+  {
+    throw std::invalid_argument("The rate must be a positive number of operations per second.");
+  }
+  if (options.Processes < 1)
+  {
+    throw std::invalid_argument("The number of processes must be a positive number.");
+  }
+
+  if (!options.Aggregate.empty())
+  {
+    std::vector<Azure::Core::Json::_internal::json> processResults;
+    std::istringstream paths(options.Aggregate);
+    for (std::string path; std::getline(paths, path, ',');)
+    {
+      processResults.push_back(ReadResults(path));
+    }
+    WriteAggregatedResults(options, processResults);
+    return;
+  }
 
   if (options.JobStatistics)
   {
@@ -305,7 +1160,27 @@ void Azure::Perf::Program::Run(
   std::cout << std::endl << "Description: " << testMetadata->Description << std::endl;
 
   // Print options
-  PrintOptions(options, testOptions, argResults);
+  auto const testOptionsAsJson = GetTestOptions(testOptions, argResults);
+  PrintOptions(options, testOptionsAsJson);
+
+  if (options.Processes > 1)
+  {
+    RunProcesses(options, testMetadata->Name, argc, argv);
+    return;
+  }
+
+  // The results written to the results file, with what is needed to compare them across runs.
+  Azure::Core::Json::_internal::json results;
+  if (!options.ResultsFile.empty())
+  {
+    results["test"] = testMetadata->Name;
+    results["startTime"] = Azure::DateTime(std::chrono::system_clock::now())
+                               .ToString(Azure::DateTime::DateFormat::Rfc3339);
+    results["environment"] = GetEnvironment();
+    results["options"] = options;
+    results["testOptions"] = testOptionsAsJson;
+    results["iterations"] = Azure::Core::Json::_internal::json::array();
+  }
 
   // Create parallel pool of tests
   int const parallelTasks = options.Parallel;
@@ -332,28 +1207,79 @@ void Azure::Perf::Program::Run(
     }
   }
 
-  /******************** WarmUp ******************************/
-  if (options.Warmup)
+  // E.g. the control FIFO of `perf record --control=fifo:<path>`, to only profile the tests.
+  std::ofstream profilerControl;
+  if (!options.ProfilerControl.empty())
   {
-    RunTests(context, parallelTest, options, "Warmup", true);
+    profilerControl.open(options.ProfilerControl);
+    if (!profilerControl)
+    {
+      throw std::invalid_argument("Unable to open the profiler control " + options.ProfilerControl);
+    }
   }
-
-  /******************** Tests ******************************/
   std::string iterationInfo;
   try
   {
+    // The processes of a distributed run wait for each other here, after their set up.
+    if (!options.StartAt.empty())
+    {
+      auto const startAt = static_cast<std::chrono::system_clock::time_point>(
+          Azure::DateTime::Parse(options.StartAt, Azure::DateTime::DateFormat::Rfc3339));
+      if (startAt < std::chrono::system_clock::now())
+      {
+        throw std::runtime_error(
+            "The set up finished after the start time " + options.StartAt
+            + ", a longer --start-delay is needed");
+      }
+      std::this_thread::sleep_until(startAt);
+    }
+
+    /******************** WarmUp ******************************/
+    if (options.Warmup)
+    {
+      RunTests(context, parallelTest, options, "Warmup", nullptr, true);
+    }
+
+    /******************** Tests ******************************/
     for (int iteration = 0; iteration < options.Iterations; iteration++)
     {
       if (iteration > 0)
       {
-        iterationInfo.append(FormatNumber(iteration));
+        iterationInfo = FormatNumber(iteration);
+      }
+      auto iterationResult = RunTests(
+          context,
+          parallelTest,
+          options,
+          "Test" + iterationInfo,
+          profilerControl.is_open() ? &profilerControl : nullptr);
+      if (!options.ResultsFile.empty())
+      {
+        results["iterations"].push_back(std::move(iterationResult));
       }
-      RunTests(context, parallelTest, options, "Test" + iterationInfo);
     }
   }
   catch (std::exception const& error)
   {
     std::cout << "Error: " << error.what();
+    if (!options.ResultsFile.empty())
+    {
+      results["error"] = error.what();
+    }
+  }
+
+  if (!options.ResultsFile.empty())
+  {
+    try
+    {
+      WriteResults(options.ResultsFile, results);
+      std::cout << "Results written to " << options.ResultsFile << std::endl;
+    }
+    catch (std::exception const& error)
+    {
+      std::cout << "Error: Unable to write the results to " << options.ResultsFile << ": "
+                << error.what() << std::endl;
+    }
   }
 
   /******************** Clean up ******************************/
@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/worker_process.hpp"
+
+#if defined(AZ_PLATFORM_WINDOWS)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+#elif defined(AZ_PLATFORM_POSIX)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+#include <stdexcept>
+
+using Azure::Perf::_detail::WorkerProcess;
+
+#if defined(AZ_PLATFORM_WINDOWS)
+namespace {
+// Quotes an argument the way CommandLineToArgvW splits them.
+void AppendQuotedArgument(std::string& commandLine, std::string const& argument)
+{
+  commandLine += " \"";
+  size_t backslashes = 0;
+  for (auto const character : argument)
+  {
+    if (character == '\\')
+    {
+      backslashes++;
+      continue;
+    }
+    // The backslashes before a quote escape each other, and the last one escapes the quote.
+    commandLine.append(character == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+    backslashes = 0;
+    commandLine += character;
+  }
+  commandLine.append(backslashes * 2, '\\');
+  commandLine += '"';
+}
+} // namespace
+
+WorkerProcess::WorkerProcess(
+    std::string const& executable,
+    std::vector<std::string> const& arguments,
+    std::string const& outputPath)
+{
+  SECURITY_ATTRIBUTES inheritable = {};
+  inheritable.nLength = sizeof(inheritable);
+  inheritable.bInheritHandle = TRUE;
+  HANDLE const output = CreateFileA(
+      outputPath.c_str(),
+      GENERIC_WRITE,
+      FILE_SHARE_READ,
+      &inheritable,
+      CREATE_ALWAYS,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (output == INVALID_HANDLE_VALUE)
+  {
+    throw std::runtime_error("Unable to create " + outputPath);
+  }
+
+  std::string commandLine = "\"" + executable + "\"";
+  for (auto const& argument : arguments)
+  {
+    AppendQuotedArgument(commandLine, argument);
+  }
+
+  STARTUPINFOA startupInfo = {};
+  startupInfo.cb = sizeof(startupInfo);
+  startupInfo.dwFlags = STARTF_USESTDHANDLES;
+  startupInfo.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+  startupInfo.hStdOutput = output;
+  startupInfo.hStdError = output;
+  PROCESS_INFORMATION processInfo = {};
+  auto const isCreated = CreateProcessA(
+      executable.c_str(),
+      &commandLine[0],
+      nullptr,
+      nullptr,
+      TRUE,
+      0,
+      nullptr,
+      nullptr,
+      &startupInfo,
+      &processInfo);
+  CloseHandle(output);
+  if (!isCreated)
+  {
+    throw std::runtime_error(
+        "Unable to start " + executable + ", error " + std::to_string(GetLastError()));
+  }
+  CloseHandle(processInfo.hThread);
+  m_process = processInfo.hProcess;
+}
+
+WorkerProcess::~WorkerProcess()
+{
+  Wait();
+  CloseHandle(m_process);
+}
+
+int WorkerProcess::Wait()
+{
+  if (!m_isWaited)
+  {
+    WaitForSingleObject(m_process, INFINITE);
+    DWORD exitCode = 0;
+    GetExitCodeProcess(m_process, &exitCode);
+    m_exitCode = static_cast<int>(exitCode);
+    m_isWaited = true;
+  }
+  return m_exitCode;
+}
+
+std::string WorkerProcess::GetExecutablePath(char const*)
+{
+  char path[MAX_PATH];
+  auto const length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+  return std::string(path, length);
+}
+#else
+WorkerProcess::WorkerProcess(
+    std::string const& executable,
+    std::vector<std::string> const& arguments,
+    std::string const& outputPath)
+{
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>(executable.c_str()));
+  for (auto const& argument : arguments)
+  {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  posix_spawn_file_actions_t fileActions;
+  posix_spawn_file_actions_init(&fileActions);
+  posix_spawn_file_actions_addopen(
+      &fileActions, STDOUT_FILENO, outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  posix_spawn_file_actions_adddup2(&fileActions, STDOUT_FILENO, STDERR_FILENO);
+  auto const result
+      = posix_spawnp(&m_pid, executable.c_str(), &fileActions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&fileActions);
+  if (result != 0)
+  {
+    throw std::runtime_error("Unable to start " + executable + ": " + std::strerror(result));
+  }
+}
+
+WorkerProcess::~WorkerProcess() { Wait(); }
+
+int WorkerProcess::Wait()
+{
+  if (!m_isWaited)
+  {
+    int status = 0;
+    while (waitpid(m_pid, &status, 0) == -1 && errno == EINTR)
+    {
+    }
+    m_exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    m_isWaited = true;
+  }
+  return m_exitCode;
+}
+
+std::string WorkerProcess::GetExecutablePath(char const* argv0)
+{
+#if defined(__linux__)
+  char path[4096];
+  auto const length = readlink("/proc/self/exe", path, sizeof(path));
+  if (length > 0 && static_cast<size_t>(length) < sizeof(path))
+  {
+    return std::string(path, static_cast<size_t>(length));
+  }
+#endif
+  // Found by the same search of the PATH as when the program was started.
+  return argv0;
+}
+#endif
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/perf/allocation_counter.hpp>
+#include <new>
+
+using Azure::Perf::AllocationCounter;
+
+TEST(AllocationCounter, CountsWhileStarted)
+{
+  auto const allocations = AllocationCounter::GetAllocationCount();
+  auto const bytes = AllocationCounter::GetAllocatedBytes();
+  AllocationCounter::Start();
+  EXPECT_TRUE(AllocationCounter::IsCounting());
+  // Called directly, as the compiler may elide the allocations of new expressions.
+  ::operator delete(::operator new(sizeof(int64_t)));
+  ::operator delete[](::operator new[](1000));
+  AllocationCounter::Stop();
+  EXPECT_FALSE(AllocationCounter::IsCounting());
+
+  EXPECT_EQ(AllocationCounter::GetAllocationCount() - allocations, 2U);
+  EXPECT_EQ(AllocationCounter::GetAllocatedBytes() - bytes, sizeof(int64_t) + 1000U);
+
+  // Nothing is counted once stopped.
+  ::operator delete(::operator new(sizeof(int64_t)));
+  EXPECT_EQ(AllocationCounter::GetAllocationCount() - allocations, 2U);
+}
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/io/body_stream.hpp>
+#include <azure/perf/canned_response_transport.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace Azure::Core::Http;
+
+TEST(CannedResponseTransport, Send)
+{
+  Azure::Perf::CannedResponse cannedResponse;
+  cannedResponse.StatusCode = HttpStatusCode::Created;
+  cannedResponse.ReasonPhrase = "Created";
+  cannedResponse.Headers = {{"ETag", "\"0x8D9C2A1B3E4F5A6\""}};
+  cannedResponse.Body = {'b', 'o', 'd', 'y'};
+  Azure::Perf::CannedResponseTransport transport(cannedResponse);
+
+  std::vector<uint8_t> requestBody(100 * 1024, 'a');
+  Azure::Core::IO::MemoryBodyStream requestStream(requestBody);
+  Request request(HttpMethod::Put, Azure::Core::Url("https://account.test/path"), &requestStream);
+
+  for (auto count = 0; count < 2; count++)
+  {
+    requestStream.Rewind();
+    auto response = transport.Send(request, Azure::Core::Context::ApplicationContext);
+    // The request body was sent.
+    EXPECT_EQ(
+        requestStream.Read(requestBody.data(), 1, Azure::Core::Context::ApplicationContext), 0U);
+
+    EXPECT_EQ(response->GetStatusCode(), HttpStatusCode::Created);
+    EXPECT_EQ(response->GetReasonPhrase(), "Created");
+    EXPECT_EQ(response->GetHeaders().at("etag"), "\"0x8D9C2A1B3E4F5A6\"");
+    EXPECT_EQ(response->GetHeaders().at("content-length"), "4");
+    auto const body = response->ExtractBodyStream()->ReadToEnd(
+        Azure::Core::Context::ApplicationContext);
+    EXPECT_EQ(std::string(body.begin(), body.end()), "body");
+  }
+}
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "azure/identity/chained_token_credential.hpp"
 #include "azure/identity/client_secret_credential.hpp"
 #include "azure/identity/dll_import_export.hpp"
 #include "azure/identity/environment_credential.hpp"
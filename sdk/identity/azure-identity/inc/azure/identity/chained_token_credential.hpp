@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Chained Token Credential gets a token from the first of its sources able to provide one.
+ */
+
+#pragma once
+
+#include <azure/core/credentials/credentials.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Azure { namespace Identity {
+  /**
+   * @brief Chained Token Credential gets a token from the first of its sources, in the order they
+   * are given, able to provide one.
+   *
+   * @remark The first token request probes all the sources at the same time, so a source failing
+   * slowly doesn't delay the sources after it. The first source, in order, to provide a token is
+   * then used for all the later token requests.
+   *
+   */
+  class ChainedTokenCredential final : public Core::Credentials::TokenCredential {
+  public:
+    /**
+     * @brief A container type to store the ordered chain of credentials.
+     *
+     */
+    using Sources = std::vector<std::shared_ptr<Core::Credentials::TokenCredential>>;
+
+  private:
+    Sources m_sources;
+
+    // The index of the source providing the tokens, once it is known.
+    mutable std::atomic<size_t> m_selectedSource;
+
+    Core::Credentials::AccessToken ProbeSources(
+        Core::Credentials::TokenRequestContext const& tokenRequestContext,
+        Core::Context const& context) const;
+
+  public:
+    /**
+     * @brief Constructs a Chained Token Credential.
+     *
+     * @param sources The credentials to get a token from, by order of priority.
+     */
+    explicit ChainedTokenCredential(Sources sources);
+
+    /**
+     * @brief Destructs `%ChainedTokenCredential`.
+     *
+     */
+    ~ChainedTokenCredential() override;
+
+    /**
+     * @brief Gets an authentication token.
+     *
+     * @param tokenRequestContext A context to get the token in.
+     * @param context A context to control the request lifetime.
+     *
+     * @throw Azure::Core::Credentials::AuthenticationException None of the sources provided a
+     * token, or the source providing the tokens failed.
+     */
+    Core::Credentials::AccessToken GetToken(
+        Core::Credentials::TokenRequestContext const& tokenRequestContext,
+        Core::Context const& context) const override;
+  };
+
+}} // namespace Azure::Identity
@@ -19,6 +19,7 @@
 
 namespace Azure { namespace Identity {
   namespace _detail {
+    class TokenCache;
     class TokenCredentialImpl;
     AZ_IDENTITY_DLLEXPORT extern std::string const g_aadGlobalAuthority;
   } // namespace _detail
@@ -49,9 +50,13 @@ namespace Azure { namespace Identity {
   class ClientSecretCredential final : public Core::Credentials::TokenCredential {
   private:
     std::unique_ptr<_detail::TokenCredentialImpl> m_tokenCredentialImpl;
+    std::string m_authorityHost;
+    std::string m_tenantId;
     Core::Url m_requestUrl;
     std::string m_requestBody;
     bool m_isAdfs;
+    // Destroyed first, its background refresh uses the other members.
+    std::unique_ptr<_detail::TokenCache> m_tokenCache;
 
     ClientSecretCredential(
         std::string const& tenantId,
@@ -60,6 +65,8 @@ namespace Azure { namespace Identity {
         std::string const& authorityHost,
         Core::Credentials::TokenCredentialOptions const& options);
 
+    Core::Url GetRequestUrl(std::string const& tenantId) const;
+
   public:
     /**
      * @brief Constructs a Client Secret Credential.
@@ -110,7 +117,8 @@ namespace Azure { namespace Identity {
     /**
      * @brief Gets an authentication token.
      *
-     * @param tokenRequestContext A context to get the token in.
+     * @param tokenRequestContext A context to get the token in. The token is got from its tenant
+     * when it has one.
      * @param context A context to control the request lifetime.
      *
      * @throw Azure::Core::Credentials::AuthenticationException Authentication error occurred.
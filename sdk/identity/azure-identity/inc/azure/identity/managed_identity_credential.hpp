@@ -17,6 +17,7 @@
 namespace Azure { namespace Identity {
   namespace _detail {
     class ManagedIdentitySource;
+    class TokenCache;
   }
 
   /**
@@ -26,6 +27,8 @@ namespace Azure { namespace Identity {
   class ManagedIdentityCredential final : public Core::Credentials::TokenCredential {
   private:
     std::unique_ptr<_detail::ManagedIdentitySource> m_managedIdentitySource;
+    // Destroyed first, its background refresh uses the managed identity source.
+    std::unique_ptr<_detail::TokenCache> m_tokenCache;
 
   public:
     /**
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/identity/chained_token_credential.hpp"
+
+#include <exception>
+#include <future>
+#include <limits>
+#include <string>
+#include <utility>
+
+using namespace Azure::Identity;
+using Azure::Core::Context;
+using Azure::Core::Credentials::AccessToken;
+using Azure::Core::Credentials::AuthenticationException;
+using Azure::Core::Credentials::TokenCredential;
+using Azure::Core::Credentials::TokenRequestContext;
+
+namespace {
+constexpr size_t NoSelectedSource = (std::numeric_limits<size_t>::max)();
+} // namespace
+
+ChainedTokenCredential::ChainedTokenCredential(ChainedTokenCredential::Sources sources)
+    : m_sources(std::move(sources)), m_selectedSource(NoSelectedSource)
+{
+}
+
+ChainedTokenCredential::~ChainedTokenCredential() = default;
+
+AccessToken ChainedTokenCredential::ProbeSources(
+    TokenRequestContext const& tokenRequestContext,
+    Context const& context) const
+{
+  // The sources after the one providing the token are cancelled, so the probe doesn't wait for
+  // them any longer than they take to notice it.
+  auto probeContext = context.WithDeadline((Azure::DateTime::max)());
+
+  std::vector<std::future<AccessToken>> tokens;
+  tokens.reserve(m_sources.size());
+  for (auto const& source : m_sources)
+  {
+    tokens.push_back(
+        std::async(std::launch::async, [&source, &tokenRequestContext, probeContext]() {
+          return source->GetToken(tokenRequestContext, probeContext);
+        }));
+  }
+
+  std::string errors;
+  for (size_t i = 0; i < tokens.size(); ++i)
+  {
+    try
+    {
+      auto token = tokens[i].get();
+      m_selectedSource = i;
+
+      // The remaining futures wait for their sources when destroyed.
+      probeContext.Cancel();
+      return token;
+    }
+    catch (std::exception const& e)
+    {
+      errors += ' ';
+      errors += e.what();
+    }
+  }
+
+  context.ThrowIfCancelled();
+  throw AuthenticationException(
+      "ChainedTokenCredential authentication failed, none of its sources provided a token:"
+      + errors);
+}
+
+AccessToken ChainedTokenCredential::GetToken(
+    TokenRequestContext const& tokenRequestContext,
+    Context const& context) const
+{
+  auto const selectedSource = m_selectedSource.load();
+  if (selectedSource != NoSelectedSource)
+  {
+    return m_sources[selectedSource]->GetToken(tokenRequestContext, context);
+  }
+
+  if (m_sources.empty())
+  {
+    throw AuthenticationException(
+        "ChainedTokenCredential authentication failed, it has no sources.");
+  }
+
+  return ProbeSources(tokenRequestContext, context);
+}
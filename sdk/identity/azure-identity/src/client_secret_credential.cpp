@@ -3,33 +3,60 @@
 
 #include "azure/identity/client_secret_credential.hpp"
 
+#include "private/token_cache.hpp"
 #include "private/token_credential_impl.hpp"
 
-#include <sstream>
+#include <azure/core/base64.hpp>
+#include <azure/core/internal/cryptography/sha_hash.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
 
 using namespace Azure::Identity;
 
 std::string const Azure::Identity::_detail::g_aadGlobalAuthority
     = "https://login.microsoftonline.com/";
 
+Azure::Core::Url ClientSecretCredential::GetRequestUrl(std::string const& tenantId) const
+{
+  Azure::Core::Url requestUrl(m_authorityHost);
+  requestUrl.AppendPath(tenantId);
+  requestUrl.AppendPath(m_isAdfs ? "oauth2/token" : "oauth2/v2.0/token");
+  return requestUrl;
+}
+
 ClientSecretCredential::ClientSecretCredential(
     std::string const& tenantId,
     std::string const& clientId,
     std::string const& clientSecret,
     std::string const& authorityHost,
     Azure::Core::Credentials::TokenCredentialOptions const& options)
-    : m_tokenCredentialImpl(new _detail::TokenCredentialImpl(options)), m_isAdfs(tenantId == "adfs")
+    : m_tokenCredentialImpl(new _detail::TokenCredentialImpl(options)),
+      m_authorityHost(authorityHost), m_tenantId(tenantId), m_isAdfs(tenantId == "adfs")
 {
   using Azure::Core::Url;
-  m_requestUrl = Url(authorityHost);
-  m_requestUrl.AppendPath(tenantId);
-  m_requestUrl.AppendPath(m_isAdfs ? "oauth2/token" : "oauth2/v2.0/token");
+  m_requestUrl = GetRequestUrl(tenantId);
 
-  std::ostringstream body;
-  body << "grant_type=client_credentials&client_id=" << Url::Encode(clientId)
-       << "&client_secret=" << Url::Encode(clientSecret);
+  std::unique_ptr<_detail::PersistentTokenCache const> persistentCache;
+  if (!options.PersistentTokenCachePath.empty())
+  {
+    // The URL has the authority and the tenant. The hash of the secret keeps the tokens of a
+    // credential from being used by one with another secret, e.g. after it's rotated.
+    auto const secretHash = Azure::Core::Cryptography::_internal::Sha256Hash().Final(
+        reinterpret_cast<uint8_t const*>(clientSecret.data()), clientSecret.size());
+    persistentCache = std::make_unique<_detail::PersistentTokenCache>(
+        options.PersistentTokenCachePath,
+        "ClientSecretCredential " + m_requestUrl.GetAbsoluteUrl() + " " + clientId + " "
+            + Azure::Core::Convert::Base64Encode(secretHash));
+  }
+  m_tokenCache = std::make_unique<_detail::TokenCache>(
+      options.TokenRefreshLifetimeFraction, std::move(persistentCache));
 
-  m_requestBody = body.str();
+  m_requestBody = "grant_type=client_credentials&client_id=";
+  m_requestBody += Url::Encode(clientId);
+  m_requestBody += "&client_secret=";
+  m_requestBody += Url::Encode(clientSecret);
 }
 
 ClientSecretCredential::~ClientSecretCredential() = default;
@@ -38,28 +65,60 @@ Azure::Core::Credentials::AccessToken ClientSecretCredential::GetToken(
     Azure::Core::Credentials::TokenRequestContext const& tokenRequestContext,
     Azure::Core::Context const& context) const
 {
-  return m_tokenCredentialImpl->GetToken(context, [&]() {
-    using _detail::TokenCredentialImpl;
-    using Azure::Core::Http::HttpMethod;
-
-    std::ostringstream body;
-    body << m_requestBody;
-    {
-      auto const& scopes = tokenRequestContext.Scopes;
-      if (!scopes.empty())
+  auto const& tenantId = tokenRequestContext.TenantId;
+  bool const isOtherTenant = !tenantId.empty() && tenantId != m_tenantId;
+  if (isOtherTenant && m_isAdfs)
+  {
+    throw Azure::Core::Credentials::AuthenticationException(
+        "ClientSecretCredential authenticating with ADFS can't get a token for another tenant.");
+  }
+
+  // Naming the tenant of the credential gets the same tokens as not naming any.
+  if (!isOtherTenant && !tenantId.empty())
+  {
+    auto defaultTenantContext = tokenRequestContext;
+    defaultTenantContext.TenantId.clear();
+    return GetToken(defaultTenantContext, context);
+  }
+
+  // The cache keeps the function to refresh the token, so it doesn't capture references.
+  auto getNewToken = [this,
+                      tokenRequestContext,
+                      requestUrl = isOtherTenant ? GetRequestUrl(tenantId) : m_requestUrl](
+                         Azure::Core::Context const& tokenContext) {
+    return m_tokenCredentialImpl->GetToken(tokenContext, [&]() {
+      using _detail::TokenCredentialImpl;
+      using Azure::Core::Http::HttpMethod;
+
+      std::string body;
       {
-        body << "&scope=" << TokenCredentialImpl::FormatScopes(scopes, m_isAdfs);
+        auto const& scopes = tokenRequestContext.Scopes;
+        if (scopes.empty())
+        {
+          body = m_requestBody;
+        }
+        else
+        {
+          auto const formattedScopes = TokenCredentialImpl::FormatScopes(scopes, m_isAdfs);
+          constexpr char scopeParameter[] = "&scope=";
+          body.reserve(m_requestBody.size() + sizeof(scopeParameter) - 1 + formattedScopes.size());
+          body += m_requestBody;
+          body += scopeParameter;
+          body += formattedScopes;
+        }
       }
-    }
 
-    auto request = std::make_unique<TokenCredentialImpl::TokenRequest>(
-        HttpMethod::Post, m_requestUrl, body.str());
+      auto request = std::make_unique<TokenCredentialImpl::TokenRequest>(
+          HttpMethod::Post, requestUrl, std::move(body));
+
+      if (m_isAdfs)
+      {
+        request->HttpRequest.SetHeader("Host", requestUrl.GetHost());
+      }
 
-    if (m_isAdfs)
-    {
-      request->HttpRequest.SetHeader("Host", m_requestUrl.GetHost());
-    }
+      return request;
+    });
+  };
 
-    return request;
-  });
+  return m_tokenCache->GetToken(tokenRequestContext, context, std::move(getNewToken));
 }
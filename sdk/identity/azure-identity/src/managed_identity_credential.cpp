@@ -3,6 +3,9 @@
 
 #include "azure/identity/managed_identity_credential.hpp"
 #include "private/managed_identity_source.hpp"
+#include "private/token_cache.hpp"
+
+#include <utility>
 
 using namespace Azure::Identity;
 
@@ -40,11 +43,25 @@ ManagedIdentityCredential::ManagedIdentityCredential(
     Azure::Core::Credentials::TokenCredentialOptions const& options)
     : m_managedIdentitySource(CreateManagedIdentitySource(clientId, options))
 {
+  std::unique_ptr<_detail::PersistentTokenCache const> persistentCache;
+  if (!options.PersistentTokenCachePath.empty())
+  {
+    // The identity has no secret of its own to tell its tokens apart, the host issues them.
+    persistentCache = std::make_unique<_detail::PersistentTokenCache>(
+        options.PersistentTokenCachePath, "ManagedIdentityCredential " + clientId);
+  }
+  m_tokenCache = std::make_unique<_detail::TokenCache>(
+      options.TokenRefreshLifetimeFraction, std::move(persistentCache));
 }
 
 Azure::Core::Credentials::AccessToken ManagedIdentityCredential::GetToken(
     Azure::Core::Credentials::TokenRequestContext const& tokenRequestContext,
     Azure::Core::Context const& context) const
 {
-  return m_managedIdentitySource->GetToken(tokenRequestContext, context);
+  // The cache keeps the function to refresh the token, so it doesn't capture references.
+  auto getNewToken = [this, tokenRequestContext](Azure::Core::Context const& tokenContext) {
+    return m_managedIdentitySource->GetToken(tokenRequestContext, tokenContext);
+  };
+
+  return m_tokenCache->GetToken(tokenRequestContext, context, std::move(getNewToken));
 }
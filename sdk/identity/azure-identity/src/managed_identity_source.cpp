@@ -5,6 +5,11 @@
 
 #include "private/environment.hpp"
 
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+#include <azure/core/http/curl_transport.hpp>
+#endif
+
+#include <chrono>
 #include <fstream>
 #include <iterator>
 #include <stdexcept>
@@ -12,6 +17,26 @@
 
 using namespace Azure::Identity::_detail;
 
+namespace {
+// IMDS and the Azure Arc endpoint are on the machine or link-local, they either answer within
+// milliseconds or aren't there.
+constexpr std::chrono::milliseconds LocalEndpointConnectionTimeout = std::chrono::seconds(1);
+constexpr std::chrono::milliseconds LocalEndpointRetryDelay = std::chrono::milliseconds(100);
+constexpr std::chrono::milliseconds LocalEndpointMaxRetryDelay = std::chrono::seconds(1);
+constexpr int32_t LocalEndpointMaxRetries = 5;
+
+// Until IMDS answered once, it may not be there at all, the time waiting for it is bounded.
+constexpr std::chrono::milliseconds ImdsProbeTimeout = std::chrono::seconds(1);
+
+bool IsDefaultRetry(Azure::Core::Http::Policies::RetryOptions const& retry)
+{
+  Azure::Core::Http::Policies::RetryOptions const defaultRetry;
+  return retry.MaxRetries == defaultRetry.MaxRetries && retry.RetryDelay == defaultRetry.RetryDelay
+      && retry.MaxRetryDelay == defaultRetry.MaxRetryDelay
+      && retry.StatusCodes == defaultRetry.StatusCodes;
+}
+} // namespace
+
 Azure::Core::Url ManagedIdentitySource::ParseEndpointUrl(
     std::string const& url,
     char const* envVarName)
@@ -34,6 +59,37 @@ Azure::Core::Url ManagedIdentitySource::ParseEndpointUrl(
       std::string("The environment variable ") + envVarName + " contains an invalid URL.");
 }
 
+Azure::Core::Credentials::TokenCredentialOptions ManagedIdentitySource::GetLocalEndpointOptions(
+    Azure::Core::Credentials::TokenCredentialOptions options,
+    std::set<Azure::Core::Http::HttpStatusCode> const& retryStatusCodes)
+{
+  // The default retries wait seconds, to let a remote service recover.
+  if (IsDefaultRetry(options.Retry))
+  {
+    options.Retry.MaxRetries = LocalEndpointMaxRetries;
+    options.Retry.RetryDelay = LocalEndpointRetryDelay;
+    options.Retry.MaxRetryDelay = LocalEndpointMaxRetryDelay;
+    options.Retry.StatusCodes.insert(retryStatusCodes.begin(), retryStatusCodes.end());
+  }
+
+#if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
+  // The default transport waits minutes to connect. The local endpoint transport is shared by the
+  // credentials, so that they reuse the kept alive connections.
+  if (dynamic_cast<Azure::Core::Http::CurlTransport*>(options.Transport.Transport.get()) != nullptr)
+  {
+    static std::shared_ptr<Azure::Core::Http::HttpTransport> const localEndpointTransport = []() {
+      Azure::Core::Http::CurlTransportOptions transportOptions;
+      transportOptions.ConnectionTimeout = LocalEndpointConnectionTimeout;
+      transportOptions.HttpKeepAlive = true;
+      return std::make_shared<Azure::Core::Http::CurlTransport>(transportOptions);
+    }();
+    options.Transport.Transport = localEndpointTransport;
+  }
+#endif
+
+  return options;
+}
+
 std::unique_ptr<ManagedIdentitySource> AppServiceManagedIdentitySource::Create(
     std::string const& clientId,
     Azure::Core::Credentials::TokenCredentialOptions const& options)
@@ -172,9 +228,8 @@ std::unique_ptr<ManagedIdentitySource> AzureArcManagedIdentitySource::Create(
 AzureArcManagedIdentitySource::AzureArcManagedIdentitySource(
     Azure::Core::Credentials::TokenCredentialOptions const& options,
     Azure::Core::Url endpointUrl)
-    : ManagedIdentitySource(options), m_url(std::move(endpointUrl))
+    : ManagedIdentitySource(GetLocalEndpointOptions(options, {})), m_url(std::move(endpointUrl))
 {
-
   m_url.AppendQueryParameter("api-version", "2019-11-01");
 }
 
@@ -256,7 +311,12 @@ std::unique_ptr<ManagedIdentitySource> ImdsManagedIdentitySource::Create(
 ImdsManagedIdentitySource::ImdsManagedIdentitySource(
     std::string const& clientId,
     Azure::Core::Credentials::TokenCredentialOptions const& options)
-    : ManagedIdentitySource(options),
+    : ManagedIdentitySource(GetLocalEndpointOptions(
+        options,
+        // IMDS answers these while the identity is being assigned or updated, or when throttling.
+        {Azure::Core::Http::HttpStatusCode::NotFound,
+         Azure::Core::Http::HttpStatusCode::Gone,
+         Azure::Core::Http::HttpStatusCode::TooManyRequests})),
       m_request(
           Azure::Core::Http::HttpMethod::Get,
           Azure::Core::Url("http://169.254.169.254/metadata/identity/oauth2/token"))
@@ -280,7 +340,7 @@ Azure::Core::Credentials::AccessToken ImdsManagedIdentitySource::GetToken(
     Azure::Core::Credentials::TokenRequestContext const& tokenRequestContext,
     Azure::Core::Context const& context) const
 {
-  return TokenCredentialImpl::GetToken(context, [&]() {
+  auto const createRequest = [&]() {
     auto request = std::make_unique<TokenRequest>(m_request);
     {
       auto const& scopes = tokenRequestContext.Scopes;
@@ -291,5 +351,33 @@ Azure::Core::Credentials::AccessToken ImdsManagedIdentitySource::GetToken(
     }
 
     return request;
-  });
+  };
+
+  if (m_isAvailable.load())
+  {
+    return TokenCredentialImpl::GetToken(context, createRequest);
+  }
+
+  auto const probeDeadline = std::chrono::system_clock::now() + ImdsProbeTimeout;
+  auto const probeContext = context.GetDeadline() < probeDeadline
+      ? context
+      : context.WithDeadline(Azure::DateTime(probeDeadline));
+  try
+  {
+    auto token = TokenCredentialImpl::GetToken(probeContext, createRequest);
+    m_isAvailable = true;
+    return token;
+  }
+  catch (Azure::Core::Credentials::AuthenticationException const& e)
+  {
+    if (context.IsCancelled() || !probeContext.IsCancelled())
+    {
+      throw;
+    }
+
+    throw Azure::Core::Credentials::AuthenticationException(
+        std::string("ManagedIdentityCredential authentication unavailable. "
+                    "The Azure Instance Metadata Service didn't answer: ")
+        + e.what());
+  }
 }
@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/persistent_token_cache.hpp"
+
+#include "azure/core/platform.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(AZ_PLATFORM_WINDOWS)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+
+#include <wincrypt.h>
+#elif defined(AZ_PLATFORM_POSIX)
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using Azure::DateTime;
+using Azure::Core::Credentials::AccessToken;
+using Azure::Identity::_detail::PersistentTokenCache;
+
+namespace {
+// Keys and tokens don't contain these, the file has one token per line:
+// <credential key> <scopes>\t<expiration in seconds since 1970>\t<token>\n
+constexpr char FieldSeparator = '\t';
+constexpr char EntrySeparator = '\n';
+constexpr char Separators[] = {FieldSeparator, EntrySeparator, '\0'};
+
+// Locks the file next to the cache until destroyed, shared for reading or exclusive for writing.
+class FileLock final {
+private:
+#if defined(AZ_PLATFORM_WINDOWS)
+  HANDLE m_handle = INVALID_HANDLE_VALUE;
+#elif defined(AZ_PLATFORM_POSIX)
+  int m_fileDescriptor = -1;
+#endif
+  bool m_locked = false;
+
+public:
+  explicit FileLock(std::string const& path, bool exclusive)
+  {
+#if defined(AZ_PLATFORM_WINDOWS)
+    m_handle = CreateFileA(
+        path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (m_handle != INVALID_HANDLE_VALUE)
+    {
+      OVERLAPPED overlapped = {};
+      m_locked = LockFileEx(
+                     m_handle,
+                     exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0,
+                     0,
+                     MAXDWORD,
+                     MAXDWORD,
+                     &overlapped)
+          != FALSE;
+    }
+#elif defined(AZ_PLATFORM_POSIX)
+    m_fileDescriptor = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (m_fileDescriptor >= 0)
+    {
+      m_locked = flock(m_fileDescriptor, exclusive ? LOCK_EX : LOCK_SH) == 0;
+    }
+#else
+    static_cast<void>(path);
+    static_cast<void>(exclusive);
+#endif
+  }
+
+  FileLock(FileLock const&) = delete;
+  FileLock& operator=(FileLock const&) = delete;
+
+  ~FileLock()
+  {
+    // Closing the file releases the lock.
+#if defined(AZ_PLATFORM_WINDOWS)
+    if (m_handle != INVALID_HANDLE_VALUE)
+    {
+      CloseHandle(m_handle);
+    }
+#elif defined(AZ_PLATFORM_POSIX)
+    if (m_fileDescriptor >= 0)
+    {
+      close(m_fileDescriptor);
+    }
+#endif
+  }
+
+  bool IsLocked() const { return m_locked; }
+};
+
+#if defined(AZ_PLATFORM_WINDOWS)
+// Encrypts or decrypts the content of the file for the current user.
+bool TransformContent(std::string& content, bool encrypt)
+{
+  DATA_BLOB input = {static_cast<DWORD>(content.size()), reinterpret_cast<BYTE*>(&content[0])};
+  DATA_BLOB output = {};
+  auto const succeeded = encrypt
+      ? CryptProtectData(
+          &input, nullptr, nullptr, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &output)
+      : CryptUnprotectData(
+          &input, nullptr, nullptr, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &output);
+  if (!succeeded)
+  {
+    return false;
+  }
+
+  content.assign(reinterpret_cast<char const*>(output.pbData), output.cbData);
+  LocalFree(output.pbData);
+  return true;
+}
+#endif
+
+std::map<std::string, std::pair<int64_t, std::string>> ReadEntries(std::string const& path)
+{
+  std::map<std::string, std::pair<int64_t, std::string>> entries;
+
+  std::ifstream file(path, std::ios::binary);
+  std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+#if defined(AZ_PLATFORM_WINDOWS)
+  if (content.empty() || !TransformContent(content, false))
+  {
+    return entries;
+  }
+#endif
+
+  std::istringstream lines(content);
+  for (std::string line; std::getline(lines, line, EntrySeparator);)
+  {
+    auto const expiresOnBegin = line.find(FieldSeparator);
+    auto const tokenBegin = line.find(FieldSeparator, expiresOnBegin + 1);
+    if (expiresOnBegin == std::string::npos || tokenBegin == std::string::npos)
+    {
+      continue;
+    }
+
+    try
+    {
+      entries[line.substr(0, expiresOnBegin)] = {
+          std::stoll(line.substr(expiresOnBegin + 1, tokenBegin - expiresOnBegin - 1)),
+          line.substr(tokenBegin + 1)};
+    }
+    catch (std::exception const&)
+    {
+      // The entries which can't be parsed are dropped.
+    }
+  }
+
+  return entries;
+}
+
+bool WriteEntries(
+    std::string const& path,
+    std::map<std::string, std::pair<int64_t, std::string>> const& entries)
+{
+  std::string content;
+  for (auto const& entry : entries)
+  {
+    content += entry.first + FieldSeparator + std::to_string(entry.second.first) + FieldSeparator
+        + entry.second.second + EntrySeparator;
+  }
+
+  // The file is replaced at once, so it is never seen partially written.
+  auto const temporaryPath = path + ".tmp";
+#if defined(AZ_PLATFORM_WINDOWS)
+  if (!TransformContent(content, true))
+  {
+    return false;
+  }
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.write(content.data(), content.size()))
+    {
+      return false;
+    }
+  }
+  return MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+#elif defined(AZ_PLATFORM_POSIX)
+  // Only the current user can read the file.
+  auto const fileDescriptor = open(
+      temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fileDescriptor < 0)
+  {
+    return false;
+  }
+  size_t written = 0;
+  while (written < content.size())
+  {
+    auto const result = write(fileDescriptor, content.data() + written, content.size() - written);
+    if (result <= 0)
+    {
+      break;
+    }
+    written += static_cast<size_t>(result);
+  }
+  close(fileDescriptor);
+  return written == content.size() && std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#else
+  static_cast<void>(temporaryPath);
+  return false;
+#endif
+}
+
+int64_t ToSecondsSinceEpoch(DateTime const& dateTime)
+{
+  return std::chrono::duration_cast<std::chrono::seconds>(dateTime - DateTime(1970)).count();
+}
+} // namespace
+
+PersistentTokenCache::PersistentTokenCache(std::string path, std::string credentialKey)
+    : m_path(std::move(path)), m_credentialKey(std::move(credentialKey))
+{
+}
+
+bool PersistentTokenCache::TryGetToken(std::string const& scopes, AccessToken& token) const
+{
+  auto const key = m_credentialKey + ' ' + scopes;
+  if (key.find_first_of(Separators) != std::string::npos)
+  {
+    return false;
+  }
+
+  FileLock const lock(m_path + ".lock", false);
+  if (!lock.IsLocked())
+  {
+    return false;
+  }
+
+  auto const entries = ReadEntries(m_path);
+  auto const entry = entries.find(key);
+  if (entry == entries.end())
+  {
+    return false;
+  }
+
+  token.Token = entry->second.second;
+  token.ExpiresOn = DateTime(1970) + std::chrono::seconds(entry->second.first);
+  return true;
+}
+
+void PersistentTokenCache::SetToken(std::string const& scopes, AccessToken const& token) const
+{
+  auto const key = m_credentialKey + ' ' + scopes;
+  if (key.find_first_of(Separators) != std::string::npos
+      || token.Token.find_first_of(Separators) != std::string::npos)
+  {
+    return;
+  }
+
+  FileLock const lock(m_path + ".lock", true);
+  if (!lock.IsLocked())
+  {
+    return;
+  }
+
+  auto entries = ReadEntries(m_path);
+
+  // The tokens of all the credentials using the file which have expired are dropped.
+  auto const now = ToSecondsSinceEpoch(std::chrono::system_clock::now());
+  for (auto entry = entries.begin(); entry != entries.end();)
+  {
+    entry = entry->second.first <= now ? entries.erase(entry) : std::next(entry);
+  }
+
+  entries[key] = {ToSecondsSinceEpoch(token.ExpiresOn), token.Token};
+  WriteEntries(m_path, entries);
+}
@@ -9,7 +9,9 @@
 
 #include "token_credential_impl.hpp"
 
+#include <atomic>
 #include <memory>
+#include <set>
 #include <string>
 
 namespace Azure { namespace Identity { namespace _detail {
@@ -22,6 +24,13 @@ namespace Azure { namespace Identity { namespace _detail {
   protected:
     static Core::Url ParseEndpointUrl(std::string const& url, char const* envVarName);
 
+    // Tunes the retries and the transport for an endpoint on the machine or link-local, unless
+    // they were customized: the retries are faster and also retry on retryStatusCodes, and the
+    // connections fail fast and are kept alive.
+    static Core::Credentials::TokenCredentialOptions GetLocalEndpointOptions(
+        Core::Credentials::TokenCredentialOptions options,
+        std::set<Core::Http::HttpStatusCode> const& retryStatusCodes);
+
     explicit ManagedIdentitySource(Core::Credentials::TokenCredentialOptions const& options)
         : TokenCredentialImpl(options)
     {
@@ -90,6 +99,10 @@ namespace Azure { namespace Identity { namespace _detail {
   private:
     Core::Http::Request m_request;
 
+    // Set once IMDS answered, the requests before are bounded by a probe timeout so that a
+    // machine without IMDS fails fast.
+    mutable std::atomic<bool> m_isAvailable{false};
+
     explicit ImdsManagedIdentitySource(
         std::string const& clientId,
         Core::Credentials::TokenCredentialOptions const& options);
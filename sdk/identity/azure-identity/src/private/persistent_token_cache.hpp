@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief File where the tokens of the credentials are kept between processes.
+ */
+
+#pragma once
+
+#include <azure/core/credentials/credentials.hpp>
+
+#include <string>
+
+namespace Azure { namespace Identity { namespace _detail {
+  /**
+   * @brief Keeps the tokens of a credential in a file shared by the processes of the user, so a
+   * new process doesn't have to get a token from the network.
+   *
+   * @details The file is locked while it is read or written, and it is replaced atomically, so
+   * several processes can use it at the same time. On Windows, its content is encrypted for the
+   * current user with DPAPI. On other platforms, only the current user can read or write it.
+   *
+   * @remark The file is a cache: when it can't be read or written, the tokens are got from the
+   * network as if it didn't exist.
+   */
+  class PersistentTokenCache final {
+  private:
+    std::string m_path;
+    std::string m_credentialKey;
+
+  public:
+    /**
+     * @brief Constructs `%PersistentTokenCache`.
+     *
+     * @param path The path of the file. The file is created when a token is first written.
+     * @param credentialKey Identifies the credential, e.g. by its tenant, its client and a hash of
+     * its secret, in the file shared with the other credentials.
+     */
+    explicit PersistentTokenCache(std::string path, std::string credentialKey);
+
+    /**
+     * @brief Reads the token of the credential for \p scopes.
+     *
+     * @param scopes The scopes of the token.
+     * @param token The token read, left unmodified if there is none.
+     *
+     * @return `true` if the file has a token for \p scopes; otherwise, `false`.
+     */
+    bool TryGetToken(std::string const& scopes, Core::Credentials::AccessToken& token) const;
+
+    /**
+     * @brief Writes the token of the credential for \p scopes, replacing the one in the file.
+     *
+     * @param scopes The scopes of the token.
+     * @param token The token to write.
+     */
+    void SetToken(std::string const& scopes, Core::Credentials::AccessToken const& token) const;
+  };
+}}} // namespace Azure::Identity::_detail
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Token cache used by the credentials which get tokens from the network.
+ */
+
+#pragma once
+
+#include <azure/core/context.hpp>
+#include <azure/core/credentials/credentials.hpp>
+
+#include "persistent_token_cache.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace Azure { namespace Identity { namespace _detail {
+  /**
+   * @brief The default maximum number of tokens cached by a credential.
+   *
+   */
+  constexpr size_t DefaultMaxCachedTokens = 1024;
+
+  /**
+   * @brief Caches the tokens of a credential by tenant and set of scopes, and refreshes them in
+   * the background before they expire.
+   *
+   */
+  class TokenCache final {
+  public:
+    /**
+     * @brief A function getting a new token from the network.
+     *
+     */
+    using NewTokenGetter = std::function<Core::Credentials::AccessToken(Core::Context const&)>;
+
+  private:
+    struct CacheEntry;
+
+    double m_refreshLifetimeFraction;
+    std::unique_ptr<PersistentTokenCache const> m_persistentCache;
+    size_t m_maxEntries;
+
+    // Guards the entries, the fields of the entries and m_stopping.
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::unordered_map<std::string, std::shared_ptr<CacheEntry>> m_entries;
+    bool m_stopping = false;
+
+    // Cancelled when the cache is destroyed, so the background refresh doesn't delay it.
+    Core::Context m_refreshContext;
+    std::thread m_refreshThread;
+
+    void RefreshInBackground();
+
+    // Removes an entry when there are more than m_maxEntries: an expired one if any, or else the
+    // least recently used. Called with m_mutex held.
+    void EvictEntry(std::string const& keptKey);
+
+  public:
+    /**
+     * @brief Constructs `%TokenCache`.
+     *
+     * @param refreshLifetimeFraction The fraction of the lifetime of a token after which it is
+     * refreshed in the background. A value of `1` or more disables the background refresh.
+     * @param persistentCache Where the tokens are read from before getting new ones, and written
+     * to after, to share them with the other processes. `nullptr` to only keep them in memory.
+     * @param maxEntries The maximum number of tokens kept in memory.
+     */
+    explicit TokenCache(
+        double refreshLifetimeFraction,
+        std::unique_ptr<PersistentTokenCache const> persistentCache = nullptr,
+        size_t maxEntries = DefaultMaxCachedTokens);
+
+    TokenCache(TokenCache const&) = delete;
+    TokenCache& operator=(TokenCache const&) = delete;
+
+    /**
+     * @brief Destructs `%TokenCache`, cancelling the background refresh.
+     *
+     */
+    ~TokenCache();
+
+    /**
+     * @brief Gets the cached token for \p tokenRequestContext, or a new one when there is no
+     * cached token or it is about to expire.
+     *
+     * @details The tokens are cached by tenant and set of scopes, in any order. The concurrent
+     * calls for the same tenant and scopes wait for a single call to \p getNewToken, which is only
+     * made when the persistent cache has no usable token either. When \p getNewToken throws and
+     * the cached token hasn't expired yet, the cached token is returned.
+     *
+     * @param tokenRequestContext A context to get the token in.
+     * @param context A context to control the request lifetime.
+     * @param getNewToken Gets a new token. It is kept to refresh the token in the background, so it
+     * must stay valid for the lifetime of the cache.
+     *
+     * @throw Azure::Core::Credentials::AuthenticationException Authentication error occurred.
+     */
+    Core::Credentials::AccessToken GetToken(
+        Core::Credentials::TokenRequestContext const& tokenRequestContext,
+        Core::Context const& context,
+        NewTokenGetter getNewToken);
+  };
+}}} // namespace Azure::Identity::_detail
@@ -15,6 +15,7 @@
 #include <azure/core/internal/http/pipeline.hpp>
 #include <azure/core/io/body_stream.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -55,6 +56,19 @@ namespace Azure { namespace Identity { namespace _detail {
      */
     static std::string FormatScopes(std::vector<std::string> const& scopes, bool asResource);
 
+    /**
+     * @brief Parses the access token out of the JSON body of a token response, in a single pass
+     * and without building a JSON document.
+     *
+     * @param responseBody The body of the token response.
+     *
+     * @return The access token, expiring after `expires_in` seconds, or else on `expires_on`.
+     *
+     * @throw Azure::Core::Credentials::AuthenticationException The body is not a JSON object, or
+     * is missing the token or its expiration.
+     */
+    static Core::Credentials::AccessToken ParseToken(std::vector<uint8_t> const& responseBody);
+
     /**
      * @brief Holds `#Azure::Core::Http::Request` and all the associated resources for the HTTP
      * request body, so that the lifetime for all the resources needed for the request aligns with
@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/token_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using Azure::Core::Context;
+using Azure::Core::Credentials::AccessToken;
+using Azure::Core::Credentials::TokenRequestContext;
+using Azure::Identity::_detail::TokenCache;
+
+namespace {
+using std::chrono::system_clock;
+
+// The cached tokens expiring in less than this aren't returned, a new token is got instead.
+constexpr auto TokenExpirationMargin = std::chrono::minutes(5);
+// When refreshing a token in the background fails, it is tried again after this much time, or
+// after half of the remaining lifetime of the token when that is shorter.
+constexpr auto BackgroundRefreshRetryDelay = std::chrono::seconds(30);
+
+// The remaining lifetime of a default token is too long for system_clock::duration.
+Azure::DateTime::duration GetRemainingLifetime(
+    AccessToken const& token,
+    system_clock::time_point now)
+{
+  return token.ExpiresOn - Azure::DateTime(now);
+}
+
+// The scopes are sorted, the same set of scopes in another order gets the same token.
+std::string GetKey(TokenRequestContext const& tokenRequestContext)
+{
+  std::vector<std::string const*> scopes;
+  scopes.reserve(tokenRequestContext.Scopes.size());
+  size_t length = tokenRequestContext.TenantId.size() + 1;
+  for (auto const& scope : tokenRequestContext.Scopes)
+  {
+    scopes.push_back(&scope);
+    length += scope.size() + 1;
+  }
+  std::sort(scopes.begin(), scopes.end(), [](std::string const* left, std::string const* right) {
+    return *left < *right;
+  });
+
+  // The tokens of the tenant of the credential are keyed by their scopes only.
+  std::string key;
+  key.reserve(length);
+  if (!tokenRequestContext.TenantId.empty())
+  {
+    key += tokenRequestContext.TenantId;
+    key += '\n';
+  }
+  for (auto const* scope : scopes)
+  {
+    key += *scope;
+    key += ' ';
+  }
+  return key;
+}
+} // namespace
+
+struct TokenCache::CacheEntry final
+{
+  AccessToken Token;
+  system_clock::time_point ObtainedOn;
+  system_clock::time_point LastUsedOn;
+  // system_clock::time_point::max() when the token isn't refreshed in the background.
+  system_clock::time_point RefreshOn = (system_clock::time_point::max)();
+  NewTokenGetter GetNewToken;
+
+  // Held while getting a new token, so the concurrent calls wait for a single one.
+  std::mutex GetNewTokenMutex;
+
+  bool IsUsable(system_clock::time_point now) const
+  {
+    return GetRemainingLifetime(Token, now) > TokenExpirationMargin;
+  }
+};
+
+TokenCache::TokenCache(
+    double refreshLifetimeFraction,
+    std::unique_ptr<PersistentTokenCache const> persistentCache,
+    size_t maxEntries)
+    : m_refreshLifetimeFraction(refreshLifetimeFraction),
+      m_persistentCache(std::move(persistentCache)), m_maxEntries(maxEntries)
+{
+}
+
+TokenCache::~TokenCache()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_condition.notify_all();
+  m_refreshContext.Cancel();
+
+  if (m_refreshThread.joinable())
+  {
+    m_refreshThread.join();
+  }
+}
+
+AccessToken TokenCache::GetToken(
+    TokenRequestContext const& tokenRequestContext,
+    Context const& context,
+    NewTokenGetter getNewToken)
+{
+  auto const key = GetKey(tokenRequestContext);
+
+  std::shared_ptr<CacheEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& cacheEntry = m_entries[key];
+    if (!cacheEntry)
+    {
+      cacheEntry = std::make_shared<CacheEntry>();
+      if (m_entries.size() > m_maxEntries)
+      {
+        EvictEntry(key);
+      }
+    }
+    entry = cacheEntry;
+
+    auto const now = system_clock::now();
+    if (entry->IsUsable(now))
+    {
+      entry->LastUsedOn = now;
+      return entry->Token;
+    }
+  }
+
+  std::lock_guard<std::mutex> getNewTokenLock(entry->GetNewTokenMutex);
+  {
+    // Another call may have got a token while this one was waiting.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const now = system_clock::now();
+    if (entry->IsUsable(now))
+    {
+      entry->LastUsedOn = now;
+      return entry->Token;
+    }
+  }
+
+  // Another process may have got a token, or this one in a previous run.
+  AccessToken token;
+  if (!m_persistentCache || !m_persistentCache->TryGetToken(key, token)
+      || GetRemainingLifetime(token, system_clock::now()) <= TokenExpirationMargin)
+  {
+    try
+    {
+      token = getNewToken(context);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (GetRemainingLifetime(entry->Token, system_clock::now()).count() > 0)
+      {
+        return entry->Token;
+      }
+      throw;
+    }
+
+    if (m_persistentCache)
+    {
+      m_persistentCache->SetToken(key, token);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto const now = system_clock::now();
+  entry->Token = token;
+  entry->ObtainedOn = now;
+  entry->LastUsedOn = now;
+  entry->GetNewToken = std::move(getNewToken);
+  if (m_refreshLifetimeFraction < 1)
+  {
+    entry->RefreshOn = now
+        + std::chrono::duration_cast<system_clock::duration>(
+            GetRemainingLifetime(token, now) * m_refreshLifetimeFraction);
+    if (!m_refreshThread.joinable())
+    {
+      m_refreshThread = std::thread([this]() { RefreshInBackground(); });
+    }
+    m_condition.notify_all();
+  }
+
+  return token;
+}
+
+void TokenCache::EvictEntry(std::string const& keptKey)
+{
+  auto const now = system_clock::now();
+  auto evicted = m_entries.end();
+  for (auto entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+  {
+    if (entry->first == keptKey)
+    {
+      continue;
+    }
+    if (GetRemainingLifetime(entry->second->Token, now).count() <= 0)
+    {
+      evicted = entry;
+      break;
+    }
+    if (evicted == m_entries.end() || entry->second->LastUsedOn < evicted->second->LastUsedOn)
+    {
+      evicted = entry;
+    }
+  }
+
+  // The calls getting a token for the evicted entry keep it, they are just not cached anymore.
+  if (evicted != m_entries.end())
+  {
+    m_entries.erase(evicted);
+  }
+}
+
+void TokenCache::RefreshInBackground()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stopping)
+  {
+    auto next = m_entries.end();
+    for (auto entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+    {
+      if (next == m_entries.end() || entry->second->RefreshOn < next->second->RefreshOn)
+      {
+        next = entry;
+      }
+    }
+
+    if (next == m_entries.end() || next->second->RefreshOn == (system_clock::time_point::max)())
+    {
+      m_condition.wait(lock);
+      continue;
+    }
+
+    auto const entry = next->second;
+    if (system_clock::now() < entry->RefreshOn)
+    {
+      m_condition.wait_until(lock, entry->RefreshOn);
+      continue;
+    }
+
+    // A token which wasn't used since it was obtained isn't refreshed anymore, the next call
+    // gets a new one.
+    if (entry->LastUsedOn < entry->ObtainedOn)
+    {
+      m_entries.erase(next);
+      continue;
+    }
+
+    // The calls for this tenant and these scopes keep using the cached token while it is being
+    // refreshed.
+    entry->RefreshOn = (system_clock::time_point::max)();
+    auto const getNewToken = entry->GetNewToken;
+    auto const key = next->first;
+    lock.unlock();
+
+    bool refreshed = false;
+    {
+      std::lock_guard<std::mutex> getNewTokenLock(entry->GetNewTokenMutex);
+      try
+      {
+        auto token = getNewToken(m_refreshContext);
+        if (m_persistentCache)
+        {
+          m_persistentCache->SetToken(key, token);
+        }
+        lock.lock();
+        auto const now = system_clock::now();
+        entry->Token = std::move(token);
+        entry->ObtainedOn = now;
+        entry->RefreshOn = now
+            + std::chrono::duration_cast<system_clock::duration>(
+                GetRemainingLifetime(entry->Token, now) * m_refreshLifetimeFraction);
+        refreshed = true;
+      }
+      catch (...)
+      {
+        lock.lock();
+      }
+    }
+
+    if (!refreshed && !m_stopping)
+    {
+      // The cached token keeps being returned until it is about to expire.
+      auto const now = system_clock::now();
+      auto const remaining = GetRemainingLifetime(entry->Token, now);
+      if (remaining.count() > 0)
+      {
+        entry->RefreshOn = now
+            + std::chrono::duration_cast<system_clock::duration>((std::min)(
+                std::chrono::duration_cast<Azure::DateTime::duration>(BackgroundRefreshRetryDelay),
+                remaining / 2));
+      }
+    }
+  }
+}
@@ -8,10 +8,268 @@
 #include "private/package_version.hpp"
 
 #include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <sstream>
+#include <string>
+#include <vector>
 
 using namespace Azure::Identity::_detail;
 
+namespace {
+std::string const ErrorMsgPrefix("GetToken: ");
+
+// Reads the members of the JSON object of a token response, in a single pass over the body.
+class TokenResponseReader final {
+private:
+  char const* m_position;
+  char const* m_end;
+
+  [[noreturn]] static void ThrowInvalid()
+  {
+    throw Azure::Core::Credentials::AuthenticationException(
+        ErrorMsgPrefix + "response is not a valid JSON object.");
+  }
+
+  static void AppendUtf8(std::string& text, uint32_t codePoint)
+  {
+    if (codePoint < 0x80)
+    {
+      text.push_back(static_cast<char>(codePoint));
+    }
+    else if (codePoint < 0x800)
+    {
+      text.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+      text.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+    else
+    {
+      text.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+      text.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+      text.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+  }
+
+  uint32_t ReadHex4()
+  {
+    if (m_end - m_position < 4)
+    {
+      ThrowInvalid();
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+      auto const c = *m_position++;
+      value <<= 4;
+      if (c >= '0' && c <= '9')
+      {
+        value |= static_cast<uint32_t>(c - '0');
+      }
+      else if (c >= 'a' && c <= 'f')
+      {
+        value |= static_cast<uint32_t>(c - 'a' + 10);
+      }
+      else if (c >= 'A' && c <= 'F')
+      {
+        value |= static_cast<uint32_t>(c - 'A' + 10);
+      }
+      else
+      {
+        ThrowInvalid();
+      }
+    }
+    return value;
+  }
+
+public:
+  explicit TokenResponseReader(std::vector<uint8_t> const& body)
+      : m_position(reinterpret_cast<char const*>(body.data())),
+        m_end(reinterpret_cast<char const*>(body.data()) + body.size())
+  {
+  }
+
+  void SkipWhitespace()
+  {
+    while (m_position != m_end
+           && (*m_position == ' ' || *m_position == '\t' || *m_position == '\n'
+               || *m_position == '\r'))
+    {
+      ++m_position;
+    }
+  }
+
+  // Skips the whitespace, and the character if it's the next one.
+  bool Consume(char c)
+  {
+    SkipWhitespace();
+    if (m_position != m_end && *m_position == c)
+    {
+      ++m_position;
+      return true;
+    }
+    return false;
+  }
+
+  void Expect(char c)
+  {
+    if (!Consume(c))
+    {
+      ThrowInvalid();
+    }
+  }
+
+  bool IsStringNext()
+  {
+    SkipWhitespace();
+    return m_position != m_end && *m_position == '"';
+  }
+
+  // Reads a string, and appends its characters to value unless it's null.
+  void ReadString(std::string* value)
+  {
+    Expect('"');
+    while (true)
+    {
+      if (m_position == m_end)
+      {
+        ThrowInvalid();
+      }
+      auto const c = *m_position++;
+      if (c == '"')
+      {
+        return;
+      }
+      if (c != '\\')
+      {
+        if (value != nullptr)
+        {
+          value->push_back(c);
+        }
+        continue;
+      }
+      if (m_position == m_end)
+      {
+        ThrowInvalid();
+      }
+      auto const escaped = *m_position++;
+      char unescaped = escaped;
+      switch (escaped)
+      {
+        case '"':
+        case '\\':
+        case '/':
+          break;
+        case 'b':
+          unescaped = '\b';
+          break;
+        case 'f':
+          unescaped = '\f';
+          break;
+        case 'n':
+          unescaped = '\n';
+          break;
+        case 'r':
+          unescaped = '\r';
+          break;
+        case 't':
+          unescaped = '\t';
+          break;
+        case 'u': {
+          auto const codePoint = ReadHex4();
+          if (value != nullptr)
+          {
+            AppendUtf8(*value, codePoint);
+          }
+          continue;
+        }
+        default:
+          ThrowInvalid();
+      }
+      if (value != nullptr)
+      {
+        value->push_back(unescaped);
+      }
+    }
+  }
+
+  // Reads a number of seconds, which may be in a string. The fraction of a second, if any, is
+  // ignored.
+  bool ReadSeconds(long long& seconds)
+  {
+    if (IsStringNext())
+    {
+      std::string text;
+      ReadString(&text);
+      return ParseSeconds(text.data(), text.data() + text.size(), seconds);
+    }
+    char const* const start = m_position;
+    SkipValue();
+    return ParseSeconds(start, m_position, seconds);
+  }
+
+  static bool ParseSeconds(char const* begin, char const* end, long long& seconds)
+  {
+    seconds = 0;
+    char const* digit = begin;
+    for (; digit != end && *digit >= '0' && *digit <= '9'; ++digit)
+    {
+      seconds = (seconds * 10) + (*digit - '0');
+    }
+    return digit != begin;
+  }
+
+  // Skips a value, nested objects and arrays included.
+  void SkipValue()
+  {
+    size_t depth = 0;
+    do
+    {
+      SkipWhitespace();
+      if (m_position == m_end)
+      {
+        ThrowInvalid();
+      }
+      auto const c = *m_position;
+      if (c == '"')
+      {
+        ReadString(nullptr);
+        continue;
+      }
+      ++m_position;
+      if (c == '{' || c == '[')
+      {
+        ++depth;
+      }
+      else if (c == '}' || c == ']')
+      {
+        if (depth == 0)
+        {
+          ThrowInvalid();
+        }
+        --depth;
+      }
+      else if (c == ',' || c == ':')
+      {
+        if (depth == 0)
+        {
+          ThrowInvalid();
+        }
+      }
+      else
+      {
+        // A number or a literal.
+        while (m_position != m_end && *m_position != ',' && *m_position != '}'
+               && *m_position != ']' && *m_position != ' ' && *m_position != '\n'
+               && *m_position != '\r' && *m_position != '\t')
+        {
+          ++m_position;
+        }
+      }
+    } while (depth > 0);
+  }
+};
+} // namespace
+
 TokenCredentialImpl::TokenCredentialImpl(Core::Credentials::TokenCredentialOptions const& options)
     : m_httpPipeline(options, "identity", PackageVersion::ToString(), {}, {})
 {
@@ -40,18 +298,97 @@ std::string TokenCredentialImpl::FormatScopes(
     return Url::Encode(resource);
   }
 
-  auto scopesIter = scopes.begin();
-  auto scopesStr = Azure::Core::Url::Encode(*scopesIter);
+  std::string scopesStr;
+  {
+    // The encoded scopes are at least as long as the scopes.
+    size_t length = scopes.size() - 1;
+    for (auto const& scope : scopes)
+    {
+      length += scope.size();
+    }
+    scopesStr.reserve(length);
+  }
 
-  auto const scopesEnd = scopes.end();
-  for (++scopesIter; scopesIter != scopesEnd; ++scopesIter)
+  scopesStr += Url::Encode(scopes.front());
+  for (auto scopesIter = scopes.begin() + 1; scopesIter != scopes.end(); ++scopesIter)
   {
-    scopesStr += std::string(" ") + Url::Encode(*scopesIter);
+    scopesStr += ' ';
+    scopesStr += Url::Encode(*scopesIter);
   }
 
   return scopesStr;
 }
 
+Azure::Core::Credentials::AccessToken TokenCredentialImpl::ParseToken(
+    std::vector<uint8_t> const& responseBody)
+{
+  using Azure::Core::Credentials::AuthenticationException;
+
+  static std::string const jsonAccessToken = "access_token";
+  static std::string const jsonExpiresIn = "expires_in";
+  static std::string const jsonExpiresOn = "expires_on";
+
+  std::string accessToken;
+  bool hasAccessToken = false;
+  long long expiresIn = 0;
+  bool hasExpiresIn = false;
+  long long expiresOn = 0;
+  bool hasExpiresOn = false;
+
+  // Only the members of the object are read, the values of the other ones are skipped.
+  TokenResponseReader reader(responseBody);
+  reader.Expect('{');
+  if (!reader.Consume('}'))
+  {
+    std::string name;
+    do
+    {
+      name.clear();
+      reader.ReadString(&name);
+      reader.Expect(':');
+      if (name == jsonAccessToken && reader.IsStringNext())
+      {
+        accessToken.clear();
+        reader.ReadString(&accessToken);
+        hasAccessToken = true;
+      }
+      else if (name == jsonExpiresIn)
+      {
+        hasExpiresIn = reader.ReadSeconds(expiresIn);
+      }
+      else if (name == jsonExpiresOn)
+      {
+        hasExpiresOn = reader.ReadSeconds(expiresOn);
+      }
+      else
+      {
+        reader.SkipValue();
+      }
+    } while (reader.Consume(','));
+    reader.Expect('}');
+  }
+
+  if (!hasExpiresIn && !hasExpiresOn)
+  {
+    throw AuthenticationException(
+        ErrorMsgPrefix + "response json: \'" + jsonExpiresIn + "\' not found.");
+  }
+  if (!hasAccessToken)
+  {
+    throw AuthenticationException(
+        ErrorMsgPrefix + "response json: \'" + jsonAccessToken + "\' not found.");
+  }
+
+  // The managed identity endpoints may only return the time the token expires on, in seconds
+  // since the epoch.
+  return {
+      std::move(accessToken),
+      hasExpiresIn ? std::chrono::system_clock::now() + std::chrono::seconds(expiresIn)
+                   : Azure::DateTime(std::chrono::system_clock::from_time_t(
+                       static_cast<std::time_t>(expiresOn))),
+  };
+}
+
 Azure::Core::Credentials::AccessToken TokenCredentialImpl::GetToken(
     Core::Context const& context,
     std::function<std::unique_ptr<TokenCredentialImpl::TokenRequest>()> const& createRequest,
@@ -63,8 +400,6 @@ Azure::Core::Credentials::AccessToken TokenCredentialImpl::GetToken(
   using Azure::Core::Http::HttpStatusCode;
   using Azure::Core::Http::RawResponse;
 
-  static std::string const errorMsgPrefix("GetToken: ");
-
   try
   {
     std::unique_ptr<RawResponse> response;
@@ -75,7 +410,7 @@ Azure::Core::Credentials::AccessToken TokenCredentialImpl::GetToken(
         response = m_httpPipeline.Send(request->HttpRequest, context);
         if (!response)
         {
-          throw AuthenticationException(errorMsgPrefix + "null response");
+          throw AuthenticationException(ErrorMsgPrefix + "null response");
         }
 
         auto const statusCode = response->GetStatusCode();
@@ -88,7 +423,7 @@ Azure::Core::Credentials::AccessToken TokenCredentialImpl::GetToken(
         if (request == nullptr)
         {
           std::ostringstream errorMsg;
-          errorMsg << errorMsgPrefix << "error response: "
+          errorMsg << ErrorMsgPrefix << "error response: "
                    << static_cast<std::underlying_type<HttpStatusCode>::type>(statusCode) << " "
                    << response->GetReasonPhrase();
 
@@ -99,80 +434,7 @@ Azure::Core::Credentials::AccessToken TokenCredentialImpl::GetToken(
       }
     }
 
-    auto const& responseBodyVector = response->GetBody();
-    std::string responseBody(responseBodyVector.begin(), responseBodyVector.end());
-
-    // TODO: use JSON parser.
-    auto const responseBodySize = responseBody.size();
-
-    static std::string const jsonExpiresIn = "expires_in";
-    static std::string const jsonAccessToken = "access_token";
-
-    auto responseBodyPos = responseBody.find(':', responseBody.find(jsonExpiresIn));
-    if (responseBodyPos == std::string::npos)
-    {
-      std::ostringstream errorMsg;
-      errorMsg << errorMsgPrefix << "response json: \'" << jsonExpiresIn << "\' not found.";
-
-      throw AuthenticationException(errorMsg.str());
-    }
-
-    for (; responseBodyPos < responseBodySize; ++responseBodyPos)
-    {
-      auto c = responseBody[responseBodyPos];
-      if (c != ':' && c != ' ' && c != '\"' && c != '\'')
-      {
-        break;
-      }
-    }
-
-    long long expiresInSeconds = 0;
-    for (; responseBodyPos < responseBodySize; ++responseBodyPos)
-    {
-      auto c = responseBody[responseBodyPos];
-      if (c < '0' || c > '9')
-      {
-        break;
-      }
-
-      expiresInSeconds = (expiresInSeconds * 10) + (static_cast<long long>(c) - '0');
-    }
-
-    responseBodyPos = responseBody.find(':', responseBody.find(jsonAccessToken));
-    if (responseBodyPos == std::string::npos)
-    {
-      std::ostringstream errorMsg;
-      errorMsg << errorMsgPrefix << "response json: \'" << jsonAccessToken << "\' not found.";
-
-      throw AuthenticationException(errorMsg.str());
-    }
-
-    for (; responseBodyPos < responseBodySize; ++responseBodyPos)
-    {
-      auto c = responseBody[responseBodyPos];
-      if (c != ':' && c != ' ' && c != '\"' && c != '\'')
-      {
-        break;
-      }
-    }
-
-    auto const tokenBegin = responseBodyPos;
-    for (; responseBodyPos < responseBodySize; ++responseBodyPos)
-    {
-      auto c = responseBody[responseBodyPos];
-      if (c == '\"' || c == '\'')
-      {
-        break;
-      }
-    }
-    auto const tokenEnd = responseBodyPos;
-
-    auto const responseBodyBegin = responseBody.begin();
-
-    return {
-        std::string(responseBodyBegin + tokenBegin, responseBodyBegin + tokenEnd),
-        std::chrono::system_clock::now() + std::chrono::seconds(expiresInSeconds),
-    };
+    return ParseToken(response->GetBody());
   }
   catch (AuthenticationException const&)
   {
@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of authenticating with a managed identity.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include <azure/identity.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Identity { namespace Test {
+
+  /**
+   * @brief A test to measure getting a token of a managed identity.
+   *
+   * @remark It must run on an Azure host with a managed identity. By default the credential is
+   * reused, so the runs after the first one get the token from its cache. With `--cache 0` each
+   * run creates a new credential, so it requests a new token from the managed identity endpoint.
+   */
+  class ManagedIdentityCredentialTest : public Azure::Perf::PerfTest {
+  private:
+    std::string m_clientId;
+    bool m_isCached = true;
+    Core::Credentials::TokenRequestContext m_tokenRequestContext;
+    std::unique_ptr<Azure::Identity::ManagedIdentityCredential> m_credential;
+
+  public:
+    /**
+     * @brief Create the credential.
+     *
+     */
+    void Setup() override
+    {
+      m_clientId = m_options.GetOptionOrDefault<std::string>("ClientId", "");
+      m_isCached = m_options.GetOptionOrDefault<bool>("Cache", true);
+      m_tokenRequestContext.Scopes.push_back(m_options.GetMandatoryOption<std::string>("Scope"));
+      m_credential = std::make_unique<Azure::Identity::ManagedIdentityCredential>(m_clientId);
+    }
+
+    /**
+     * @brief Construct a new ManagedIdentityCredentialTest test.
+     *
+     * @param options The test options.
+     */
+    ManagedIdentityCredentialTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Define the test
+     *
+     * @param context The cancellation token.
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      if (m_isCached)
+      {
+        auto t = m_credential->GetToken(m_tokenRequestContext, context);
+      }
+      else
+      {
+        auto t = Azure::Identity::ManagedIdentityCredential(m_clientId)
+                     .GetToken(m_tokenRequestContext, context);
+      }
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"ClientId",
+           {"--clientId"},
+           "The client Id of a user-assigned identity, the system-assigned one by default.",
+           1,
+           false},
+          {"Scope", {"--scope"}, "One scope to request access to.", 1, true},
+          {"Cache",
+           {"--cache"},
+           "Whether the credential and its cached token are reused by the runs, 1 by default.",
+           1,
+           false}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "ManagedIdentityCredential",
+          "Get a token using a managed identity token credential.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Identity::Test::ManagedIdentityCredentialTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Identity::Test
@@ -3,6 +3,7 @@
 
 #include <azure/perf.hpp>
 
+#include "azure/identity/test/managed_identity_credential_test.hpp"
 #include "azure/identity/test/secret_credential_test.hpp"
 
 int main(int argc, char** argv)
@@ -10,7 +11,8 @@ int main(int argc, char** argv)
 
   // Create the test list
   std::vector<Azure::Perf::TestMetadata> tests{
-      Azure::Identity::Test::SecretCredentialTest::GetTestMetadata()};
+      Azure::Identity::Test::SecretCredentialTest::GetTestMetadata(),
+      Azure::Identity::Test::ManagedIdentityCredentialTest::GetTestMetadata()};
 
   Azure::Perf::Program::Run(Azure::Core::Context::ApplicationContext, tests, argc, argv);
 
@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/identity/chained_token_credential.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using Azure::Core::Context;
+using Azure::Core::Credentials::AccessToken;
+using Azure::Core::Credentials::AuthenticationException;
+using Azure::Core::Credentials::TokenCredential;
+using Azure::Core::Credentials::TokenRequestContext;
+using Azure::Identity::ChainedTokenCredential;
+
+namespace {
+// Provides its token, or fails, after a delay, unless its context is cancelled before.
+class TestCredential final : public TokenCredential {
+private:
+  std::string m_token;
+  std::chrono::milliseconds m_delay;
+
+public:
+  mutable std::atomic<int> Calls{0};
+  mutable std::atomic<bool> Cancelled{false};
+
+  TestCredential(std::string token, std::chrono::milliseconds delay)
+      : m_token(std::move(token)), m_delay(delay)
+  {
+  }
+
+  AccessToken GetToken(TokenRequestContext const&, Context const& context) const override
+  {
+    ++Calls;
+    auto const end = std::chrono::steady_clock::now() + m_delay;
+    while (std::chrono::steady_clock::now() < end)
+    {
+      if (context.IsCancelled())
+      {
+        Cancelled = true;
+        throw AuthenticationException("Cancelled.");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (m_token.empty())
+    {
+      throw AuthenticationException("Unavailable.");
+    }
+    return {m_token, std::chrono::system_clock::now() + std::chrono::hours(1)};
+  }
+};
+} // namespace
+
+TEST(ChainedTokenCredential, ProbesConcurrently)
+{
+  using namespace std::chrono_literals;
+  auto const slowFailure = std::make_shared<TestCredential>("", 300ms);
+  auto const slowSuccess = std::make_shared<TestCredential>("SLOW", 300ms);
+  auto const fastSuccess = std::make_shared<TestCredential>("FAST", 10ms);
+  auto const slowest = std::make_shared<TestCredential>("SLOWEST", 5s);
+
+  ChainedTokenCredential const credential({slowFailure, slowSuccess, fastSuccess, slowest});
+  TokenRequestContext const tokenRequestContext{{"https://azure.com/.default"}};
+
+  // The first source to succeed, in order, provides the token, without waiting for the others.
+  auto const start = std::chrono::steady_clock::now();
+  EXPECT_EQ(credential.GetToken(tokenRequestContext, Context()).Token, "SLOW");
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 2s);
+  EXPECT_TRUE(slowest->Cancelled);
+
+  // It keeps providing the tokens.
+  EXPECT_EQ(credential.GetToken(tokenRequestContext, Context()).Token, "SLOW");
+  EXPECT_EQ(slowFailure->Calls, 1);
+  EXPECT_EQ(slowSuccess->Calls, 2);
+  EXPECT_EQ(fastSuccess->Calls, 1);
+  EXPECT_EQ(slowest->Calls, 1);
+}
+
+TEST(ChainedTokenCredential, AllSourcesFail)
+{
+  using namespace std::chrono_literals;
+  ChainedTokenCredential const credential(
+      {std::make_shared<TestCredential>("", 10ms), std::make_shared<TestCredential>("", 1ms)});
+  TokenRequestContext const tokenRequestContext{{"https://azure.com/.default"}};
+
+  EXPECT_THROW(credential.GetToken(tokenRequestContext, Context()), AuthenticationException);
+
+  ChainedTokenCredential const empty({});
+  EXPECT_THROW(empty.GetToken(tokenRequestContext, Context()), AuthenticationException);
+}
@@ -5,6 +5,9 @@
 
 #include "credential_test_helper.hpp"
 
+#include <cstdio>
+#include <string>
+
 #include <gtest/gtest.h>
 
 using Azure::Core::Http::HttpMethod;
@@ -249,3 +252,80 @@ TEST(ClientSecretCredential, Authority)
   EXPECT_GE(response2.AccessToken.ExpiresOn, response2.EarliestExpiration + 7200s);
   EXPECT_LE(response2.AccessToken.ExpiresOn, response2.LatestExpiration + 7200s);
 }
+
+TEST(ClientSecretCredential, TenantId)
+{
+  auto const actual = CredentialTestHelper::SimulateTokenRequest(
+      [](auto transport) {
+        ClientSecretCredentialOptions options;
+        options.Transport.Transport = transport;
+
+        return std::make_unique<ClientSecretCredential>(
+            "01234567-89ab-cdef-fedc-ba8976543210",
+            "fedcba98-7654-3210-0123-456789abcdef",
+            "CLIENTSECRET",
+            options);
+      },
+      {{{"https://azure.com/.default"}, "76543210-fedc-ba98-cdef-0123456789ab"},
+       {{"https://azure.com/.default"}, "01234567-89ab-cdef-fedc-ba8976543210"},
+       {{"https://azure.com/.default"}, "76543210-fedc-ba98-cdef-0123456789ab"}},
+      std::vector<std::string>{
+          "{\"expires_in\":3600, \"access_token\":\"ACCESSTOKEN1\"}",
+          "{\"expires_in\":3600, \"access_token\":\"ACCESSTOKEN2\"}"});
+
+  // The token of each tenant is got once.
+  EXPECT_EQ(actual.Requests.size(), 2U);
+  EXPECT_EQ(actual.Responses.size(), 3U);
+
+  EXPECT_EQ(
+      actual.Requests.at(0).AbsoluteUrl,
+      "https://login.microsoftonline.com/76543210-fedc-ba98-cdef-0123456789ab/oauth2/v2.0/token");
+
+  EXPECT_EQ(
+      actual.Requests.at(1).AbsoluteUrl,
+      "https://login.microsoftonline.com/01234567-89ab-cdef-fedc-ba8976543210/oauth2/v2.0/token");
+
+  EXPECT_EQ(actual.Responses.at(0).AccessToken.Token, "ACCESSTOKEN1");
+  EXPECT_EQ(actual.Responses.at(1).AccessToken.Token, "ACCESSTOKEN2");
+  EXPECT_EQ(actual.Responses.at(2).AccessToken.Token, "ACCESSTOKEN1");
+}
+
+TEST(ClientSecretCredential, PersistentTokenCacheKeyedBySecret)
+{
+  std::string const path = "client_secret_credential_test.cache";
+  std::remove(path.c_str());
+
+  auto const getToken = [&path](std::string const& clientSecret) {
+    return CredentialTestHelper::SimulateTokenRequest(
+        [&](auto transport) {
+          ClientSecretCredentialOptions options;
+          options.Transport.Transport = transport;
+          options.PersistentTokenCachePath = path;
+
+          return std::make_unique<ClientSecretCredential>(
+              "01234567-89ab-cdef-fedc-ba8976543210",
+              "fedcba98-7654-3210-0123-456789abcdef",
+              clientSecret,
+              options);
+        },
+        {{{"https://azure.com/.default"}}},
+        std::vector<std::string>{"{\"expires_in\":3600, \"access_token\":\"" + clientSecret
+                                 + "TOKEN\"}"});
+  };
+
+  auto const actual1 = getToken("CLIENTSECRET1");
+  EXPECT_EQ(actual1.Requests.size(), 1U);
+  EXPECT_EQ(actual1.Responses.at(0).AccessToken.Token, "CLIENTSECRET1TOKEN");
+
+  // The token is read from the file by a credential with the same secret only.
+  auto const actual2 = getToken("CLIENTSECRET1");
+  EXPECT_EQ(actual2.Requests.size(), 0U);
+  EXPECT_EQ(actual2.Responses.at(0).AccessToken.Token, "CLIENTSECRET1TOKEN");
+
+  auto const actual3 = getToken("CLIENTSECRET2");
+  EXPECT_EQ(actual3.Requests.size(), 1U);
+  EXPECT_EQ(actual3.Responses.at(0).AccessToken.Token, "CLIENTSECRET2TOKEN");
+
+  std::remove(path.c_str());
+  std::remove((path + ".lock").c_str());
+}
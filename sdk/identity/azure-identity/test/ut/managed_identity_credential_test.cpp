@@ -5,6 +5,7 @@
 
 #include "credential_test_helper.hpp"
 
+#include <chrono>
 #include <fstream>
 
 #include <gtest/gtest.h>
@@ -966,6 +967,36 @@ TEST(ManagedIdentityCredential, ImdsClientId)
   EXPECT_LE(response2.AccessToken.ExpiresOn, response2.LatestExpiration + 9999s);
 }
 
+TEST(ManagedIdentityCredential, ImdsRetry)
+{
+  auto const start = std::chrono::steady_clock::now();
+  auto const actual = CredentialTestHelper::SimulateTokenRequest(
+      [](auto transport) {
+        TokenCredentialOptions options;
+        options.Transport.Transport = transport;
+
+        CredentialTestHelper::EnvironmentOverride const env({
+            {"MSI_ENDPOINT", ""},
+            {"MSI_SECRET", ""},
+            {"IDENTITY_ENDPOINT", ""},
+            {"IMDS_ENDPOINT", ""},
+            {"IDENTITY_HEADER", ""},
+            {"IDENTITY_SERVER_THUMBPRINT", ""},
+        });
+
+        return std::make_unique<ManagedIdentityCredential>(options);
+      },
+      {{{"https://azure.com/.default"}}},
+      {{HttpStatusCode::Gone, "", {}},
+       {HttpStatusCode::Ok, "{\"expires_in\":3600, \"access_token\":\"ACCESSTOKEN1\"}", {}}});
+
+  // IMDS is retried on its own status codes, and sooner than a remote service.
+  EXPECT_EQ(actual.Requests.size(), 2U);
+  EXPECT_EQ(actual.Responses.size(), 1U);
+  EXPECT_EQ(actual.Responses.at(0).AccessToken.Token, "ACCESSTOKEN1");
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
 TEST(ManagedIdentityCredential, ImdsCreation)
 {
   auto const actual1 = CredentialTestHelper::SimulateTokenRequest(
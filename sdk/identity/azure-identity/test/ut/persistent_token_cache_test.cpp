@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/persistent_token_cache.hpp"
+#include "private/token_cache.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using Azure::Core::Context;
+using Azure::Core::Credentials::AccessToken;
+using Azure::Identity::_detail::PersistentTokenCache;
+using Azure::Identity::_detail::TokenCache;
+
+namespace {
+class PersistentTokenCacheTest : public ::testing::Test {
+protected:
+  std::string const m_path = "persistent_token_cache_test.cache";
+
+  void SetUp() override { TearDown(); }
+
+  void TearDown() override
+  {
+    std::remove(m_path.c_str());
+    std::remove((m_path + ".lock").c_str());
+  }
+};
+} // namespace
+
+TEST_F(PersistentTokenCacheTest, SharedBetweenInstances)
+{
+  using namespace std::chrono_literals;
+  PersistentTokenCache const writer(m_path, "ClientSecretCredential TENANT1 CLIENT1");
+  PersistentTokenCache const reader(m_path, "ClientSecretCredential TENANT1 CLIENT1");
+
+  AccessToken token;
+  EXPECT_FALSE(reader.TryGetToken("https://azure.com/.default ", token));
+
+  auto const expiresOn = Azure::DateTime(2030, 1, 2, 3, 4, 5);
+  writer.SetToken("https://azure.com/.default ", {"ACCESSTOKEN1", expiresOn});
+  writer.SetToken("https://outlook.com/.default ", {"ACCESSTOKEN2", expiresOn});
+  writer.SetToken("https://outlook.com/.default ", {"ACCESSTOKEN3", expiresOn});
+
+  EXPECT_TRUE(reader.TryGetToken("https://azure.com/.default ", token));
+  EXPECT_EQ(token.Token, "ACCESSTOKEN1");
+  EXPECT_EQ(token.ExpiresOn, expiresOn);
+
+  EXPECT_TRUE(reader.TryGetToken("https://outlook.com/.default ", token));
+  EXPECT_EQ(token.Token, "ACCESSTOKEN3");
+}
+
+TEST_F(PersistentTokenCacheTest, SplitByCredential)
+{
+  using namespace std::chrono_literals;
+  PersistentTokenCache const client1(m_path, "ClientSecretCredential TENANT1 CLIENT1");
+  PersistentTokenCache const client2(m_path, "ClientSecretCredential TENANT1 CLIENT2");
+
+  client1.SetToken("https://azure.com/.default ", {"ACCESSTOKEN1", Azure::DateTime(2030)});
+
+  AccessToken token;
+  EXPECT_FALSE(client2.TryGetToken("https://azure.com/.default ", token));
+  client2.SetToken("https://azure.com/.default ", {"ACCESSTOKEN2", Azure::DateTime(2030)});
+
+  EXPECT_TRUE(client1.TryGetToken("https://azure.com/.default ", token));
+  EXPECT_EQ(token.Token, "ACCESSTOKEN1");
+  EXPECT_TRUE(client2.TryGetToken("https://azure.com/.default ", token));
+  EXPECT_EQ(token.Token, "ACCESSTOKEN2");
+}
+
+TEST_F(PersistentTokenCacheTest, ExpiredTokensDropped)
+{
+  PersistentTokenCache const cache(m_path, "ManagedIdentityCredential ");
+
+  cache.SetToken("https://azure.com/.default ", {"ACCESSTOKEN1", Azure::DateTime(2020)});
+  cache.SetToken("https://outlook.com/.default ", {"ACCESSTOKEN2", Azure::DateTime(2030)});
+
+  AccessToken token;
+  EXPECT_FALSE(cache.TryGetToken("https://azure.com/.default ", token));
+  EXPECT_TRUE(cache.TryGetToken("https://outlook.com/.default ", token));
+  EXPECT_EQ(token.Token, "ACCESSTOKEN2");
+}
+
+TEST_F(PersistentTokenCacheTest, UsedByTokenCache)
+{
+  using namespace std::chrono_literals;
+  int calls = 0;
+  auto const getNewToken = [&calls](Context const&) {
+    ++calls;
+    return AccessToken{"ACCESSTOKEN1", std::chrono::system_clock::now() + 1h};
+  };
+  Azure::Core::Credentials::TokenRequestContext const tokenRequestContext{
+      {"https://azure.com/.default"}};
+
+  {
+    TokenCache cache(1, std::make_unique<PersistentTokenCache>(m_path, "CREDENTIAL"));
+    EXPECT_EQ(
+        cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  }
+
+  // The next process gets the token from the file.
+  TokenCache cache(1, std::make_unique<PersistentTokenCache>(m_path, "CREDENTIAL"));
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(calls, 1);
+}
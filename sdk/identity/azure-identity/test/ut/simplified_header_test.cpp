@@ -19,6 +19,7 @@ TEST(SimplifiedHeader, identity)
 {
   using namespace Azure::Identity;
 
+  EXPECT_NO_THROW(ChainedTokenCredential chainedTokenCredential({}));
   EXPECT_NO_THROW(ClientSecretCredential clientSecretCredential("", "", ""));
   EXPECT_NO_THROW(EnvironmentCredential environmentCredential);
   EXPECT_NO_THROW(static_cast<void>(static_cast<ManagedIdentityCredential const*>(nullptr)));
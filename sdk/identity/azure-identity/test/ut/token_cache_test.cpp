@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/token_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using Azure::Core::Context;
+using Azure::Core::Credentials::AccessToken;
+using Azure::Core::Credentials::AuthenticationException;
+using Azure::Core::Credentials::TokenRequestContext;
+using Azure::Identity::_detail::TokenCache;
+
+namespace {
+AccessToken CreateToken(std::string token, std::chrono::system_clock::duration lifetime)
+{
+  return {std::move(token), std::chrono::system_clock::now() + lifetime};
+}
+
+// Waits up to 5 seconds for a background refresh to complete.
+void WaitForCalls(std::atomic<int> const& calls, int expected)
+{
+  for (int i = 0; i < 500 && calls < expected; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+} // namespace
+
+TEST(TokenCache, ReuseWhileValid)
+{
+  using namespace std::chrono_literals;
+  TokenCache cache(1);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    return CreateToken("ACCESSTOKEN" + std::to_string(++calls), 1h);
+  };
+
+  TokenRequestContext const azure{{"https://azure.com/.default"}};
+  TokenRequestContext const outlook{{"https://outlook.com/.default"}};
+
+  EXPECT_EQ(cache.GetToken(azure, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(cache.GetToken(azure, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(cache.GetToken(outlook, Context(), getNewToken).Token, "ACCESSTOKEN2");
+  EXPECT_EQ(cache.GetToken(outlook, Context(), getNewToken).Token, "ACCESSTOKEN2");
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(TokenCache, TenantsAndScopes)
+{
+  using namespace std::chrono_literals;
+  TokenCache cache(1);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    return CreateToken("ACCESSTOKEN" + std::to_string(++calls), 1h);
+  };
+
+  TokenRequestContext const azureOutlook{
+      {"https://azure.com/.default", "https://outlook.com/.default"}};
+  TokenRequestContext const outlookAzure{
+      {"https://outlook.com/.default", "https://azure.com/.default"}};
+  TokenRequestContext otherTenant = azureOutlook;
+  otherTenant.TenantId = "01234567-89ab-cdef-fedc-ba8976543210";
+
+  EXPECT_EQ(cache.GetToken(azureOutlook, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(cache.GetToken(otherTenant, Context(), getNewToken).Token, "ACCESSTOKEN2");
+  EXPECT_EQ(cache.GetToken(outlookAzure, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(cache.GetToken(otherTenant, Context(), getNewToken).Token, "ACCESSTOKEN2");
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(TokenCache, Eviction)
+{
+  using namespace std::chrono_literals;
+  TokenCache cache(1, nullptr, 2);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    return CreateToken("ACCESSTOKEN" + std::to_string(++calls), 1h);
+  };
+
+  TokenRequestContext const azure{{"https://azure.com/.default"}};
+  TokenRequestContext const outlook{{"https://outlook.com/.default"}};
+  TokenRequestContext const xbox{{"https://xbox.com/.default"}};
+
+  EXPECT_EQ(cache.GetToken(azure, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(cache.GetToken(outlook, Context(), getNewToken).Token, "ACCESSTOKEN2");
+  std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(cache.GetToken(azure, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  std::this_thread::sleep_for(10ms);
+
+  // The least recently used token is evicted.
+  EXPECT_EQ(cache.GetToken(xbox, Context(), getNewToken).Token, "ACCESSTOKEN3");
+  EXPECT_EQ(cache.GetToken(azure, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(cache.GetToken(outlook, Context(), getNewToken).Token, "ACCESSTOKEN4");
+  EXPECT_EQ(calls, 4);
+}
+
+TEST(TokenCache, RefreshNearExpiry)
+{
+  using namespace std::chrono_literals;
+  TokenCache cache(1);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    return CreateToken("ACCESSTOKEN" + std::to_string(++calls), 4min);
+  };
+
+  TokenRequestContext const tokenRequestContext{{"https://azure.com/.default"}};
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN2");
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(TokenCache, SingleFlight)
+{
+  using namespace std::chrono_literals;
+  TokenCache cache(1);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    ++calls;
+    std::this_thread::sleep_for(50ms);
+    return CreateToken("ACCESSTOKEN", 1h);
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&]() {
+      EXPECT_EQ(
+          cache.GetToken({{"https://azure.com/.default"}}, Context(), getNewToken).Token,
+          "ACCESSTOKEN");
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(TokenCache, FallBackToValidToken)
+{
+  using namespace std::chrono_literals;
+  TokenCache cache(1);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    if (++calls > 1)
+    {
+      throw AuthenticationException("GetToken: error response: 500 Internal Server Error");
+    }
+    return CreateToken("ACCESSTOKEN1", 4min);
+  };
+
+  TokenRequestContext const tokenRequestContext{{"https://azure.com/.default"}};
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+
+  // The token is about to expire, but it is still valid when getting a new one fails.
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+  EXPECT_EQ(calls, 2);
+
+  EXPECT_THROW(
+      cache.GetToken({{"https://outlook.com/.default"}}, Context(), getNewToken),
+      AuthenticationException);
+}
+
+TEST(TokenCache, BackgroundRefresh)
+{
+  using namespace std::chrono_literals;
+  // Refreshes the 10 minute tokens after 0.6 seconds.
+  TokenCache cache(0.001);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    return CreateToken("ACCESSTOKEN" + std::to_string(++calls), 10min);
+  };
+
+  TokenRequestContext const tokenRequestContext{{"https://azure.com/.default"}};
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+
+  WaitForCalls(calls, 2);
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN2");
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(TokenCache, BackgroundRefreshFailure)
+{
+  using namespace std::chrono_literals;
+  TokenCache cache(0.001);
+  std::atomic<int> calls{0};
+  auto const getNewToken = [&calls](Context const&) {
+    if (++calls > 1)
+    {
+      throw AuthenticationException("GetToken: error response: 500 Internal Server Error");
+    }
+    return CreateToken("ACCESSTOKEN1", 10min);
+  };
+
+  TokenRequestContext const tokenRequestContext{{"https://azure.com/.default"}};
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+
+  // The cached token keeps being used after the background refresh failed.
+  WaitForCalls(calls, 2);
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(cache.GetToken(tokenRequestContext, Context(), getNewToken).Token, "ACCESSTOKEN1");
+}
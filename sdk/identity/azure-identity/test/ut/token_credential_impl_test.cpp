@@ -5,8 +5,11 @@
 
 #include "credential_test_helper.hpp"
 
+#include <chrono>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -336,70 +339,41 @@ TEST(TokenCredentialImpl, NoToken)
       }));
 }
 
-TEST(TokenCredentialImpl, CurrentJsonParserQuirksAndLimitations)
+TEST(TokenCredentialImpl, ParseToken)
 {
-  // This test case is to cover all the current behavior in the JSON parsing code.
-  // It is to verify the edge cases to define limitations. A better behavior is possible, and it
-  // won't be a breaking change to update it. This parsing is internal. At some point, we will
-  // update the code to use the real JSON parser, instead of parsing ourselves. If when that
-  // happens, at any point, this test case gets broken, it is ok to drop/update this test case - it
-  // is likely that the proper JSON parser has better behavior.
-
-  auto const actual = CredentialTestHelper::SimulateTokenRequest(
-      [](auto transport) {
-        TokenCredentialOptions options;
-        options.Transport.Transport = transport;
-
-        return std::make_unique<TokenCredentialImplTester>(
-            HttpMethod::Delete, Url("https://microsoft.com/"), options);
-      },
-      {{{"https://azure.com/.default"}}, {{"https://azure.com/.default"}}},
-      std::vector<std::string>{
-          {"{\"access_token\":\'ACCESSTOKEN\', \"expires_in\": \"\'"},
-          {"{\"expires_in\": 3600, \"access_token\": \"\'"}});
-
-  EXPECT_EQ(actual.Requests.size(), 2U);
-  EXPECT_EQ(actual.Responses.size(), 2U);
-
-  auto const& request0 = actual.Requests.at(0);
-  auto const& request1 = actual.Requests.at(1);
-
-  auto const& response0 = actual.Responses.at(0);
-  auto const& response1 = actual.Responses.at(1);
-
-  EXPECT_EQ(request0.HttpMethod, HttpMethod::Delete);
-  EXPECT_EQ(request1.HttpMethod, HttpMethod::Delete);
+  using namespace std::chrono_literals;
 
-  EXPECT_EQ(request0.AbsoluteUrl, "https://microsoft.com");
-  EXPECT_EQ(request1.AbsoluteUrl, "https://microsoft.com");
+  auto const parse = [](std::string const& json) {
+    return TokenCredentialImpl::ParseToken(std::vector<uint8_t>(json.begin(), json.end()));
+  };
 
   {
-    constexpr char expectedBody[] = "https://azure.com/.default ";
-    EXPECT_EQ(request0.Body, expectedBody);
-    EXPECT_EQ(request1.Body, expectedBody);
-
-    EXPECT_NE(request0.Headers.find("Content-Length"), request0.Headers.end());
-    EXPECT_EQ(request0.Headers.at("Content-Length"), std::to_string(sizeof(expectedBody) - 1));
-
-    EXPECT_NE(request1.Headers.find("Content-Length"), request1.Headers.end());
-    EXPECT_EQ(request1.Headers.at("Content-Length"), std::to_string(sizeof(expectedBody) - 1));
+    auto const before = std::chrono::system_clock::now();
+    auto const token = parse(
+        "{ \"token_type\": \"Bearer\", \"scope\": [\"a\", {\"expires_in\": 1}],"
+        " \"ext\": {\"access_token\": \"NESTED\"}, \"expires_in\": \"3600\","
+        " \"access_token\": \"A\\\"B\\\\C\\/D\\u00e9\" }");
+    auto const after = std::chrono::system_clock::now();
+
+    EXPECT_EQ(token.Token, "A\"B\\C/D\xc3\xa9");
+    EXPECT_GE(token.ExpiresOn, before + 3600s);
+    EXPECT_LE(token.ExpiresOn, after + 3600s);
   }
 
-  EXPECT_NE(request0.Headers.find("Content-Type"), request0.Headers.end());
-  EXPECT_EQ(request0.Headers.at("Content-Type"), "application/x-www-form-urlencoded");
-
-  EXPECT_NE(request1.Headers.find("Content-Type"), request1.Headers.end());
-  EXPECT_EQ(request1.Headers.at("Content-Type"), "application/x-www-form-urlencoded");
-
-  EXPECT_EQ(response0.AccessToken.Token, "ACCESSTOKEN");
-  EXPECT_EQ(response1.AccessToken.Token, std::string());
-
-  using namespace std::chrono_literals;
-  EXPECT_GE(response0.AccessToken.ExpiresOn, response0.EarliestExpiration + 0s);
-  EXPECT_LE(response0.AccessToken.ExpiresOn, response0.LatestExpiration + 0s);
+  {
+    // Managed identity responses may only have the time the token expires on.
+    auto const token = parse("{\"access_token\":\"ACCESSTOKEN\",\"expires_on\":\"1700000000\"}");
+    EXPECT_EQ(token.Token, "ACCESSTOKEN");
+    EXPECT_EQ(
+        token.ExpiresOn, Azure::DateTime(std::chrono::system_clock::from_time_t(1700000000)));
+  }
 
-  EXPECT_GE(response1.AccessToken.ExpiresOn, response1.EarliestExpiration + 3600s);
-  EXPECT_LE(response1.AccessToken.ExpiresOn, response1.LatestExpiration + 3600s);
+  EXPECT_THROW(parse(""), AuthenticationException);
+  EXPECT_THROW(
+      parse("{\"access_token\":'ACCESSTOKEN', \"expires_in\": 1}"), AuthenticationException);
+  EXPECT_THROW(parse("{\"expires_in\": 3600, \"access_token\": \"'"), AuthenticationException);
+  EXPECT_THROW(parse("{\"expires_in\": 3600}"), AuthenticationException);
+  EXPECT_THROW(parse("{\"access_token\": \"ACCESSTOKEN\"}"), AuthenticationException);
 }
 
 TEST(TokenCredentialImpl, NullResponse)
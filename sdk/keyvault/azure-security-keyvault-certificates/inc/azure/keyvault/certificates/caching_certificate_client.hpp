@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Defines the Key Vault Certificates caching client.
+ *
+ */
+
+#pragma once
+
+#include "azure/keyvault/certificates/certificate_client.hpp"
+#include "azure/keyvault/certificates/certificate_client_models.hpp"
+#include "azure/keyvault/certificates/certificate_client_options.hpp"
+#include <azure/core/context.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Certificates {
+
+  /**
+   * @brief The CachingCertificateClient serves the certificates of a #CertificateClient from an
+   * in-memory cache, so that the certificates read over and over aren't each fetched and
+   * deserialized again.
+   *
+   * @remark The certificates are shared by the callers, which must not modify them. A version of
+   * a certificate never changes, so it is cached without expiring. The latest version is fetched
+   * again once the revalidation interval has passed; the cached certificate is kept when the
+   * version and the last updates of the certificate and its policy fetched are the same.
+   * Meanwhile, the concurrent callers are served the cached certificate. The requests are sent
+   * through the pipeline of the certificate client.
+   */
+  class CachingCertificateClient final {
+  public:
+    /**
+     * @brief Construct a new CachingCertificateClient object.
+     *
+     * @param certificateClient The client fetching the certificates, its pipeline is shared.
+     * @param options The options to customize the cache.
+     */
+    explicit CachingCertificateClient(
+        CertificateClient const& certificateClient,
+        CachingCertificateClientOptions const& options = CachingCertificateClientOptions());
+
+    /**
+     * @brief Destructor.
+     *
+     */
+    ~CachingCertificateClient();
+
+    CachingCertificateClient(CachingCertificateClient const&) = delete;
+    CachingCertificateClient& operator=(CachingCertificateClient const&) = delete;
+
+    /**
+     * @brief Get the latest version of a certificate along with its policy from the cache, or
+     * from the Key Vault if it's not cached or it's due for revalidation.
+     *
+     * @param certificateName The name of the certificate.
+     * @param context The context for the operation can be used for request cancellation.
+     * @return The certificate and its policy, shared with the cache.
+     */
+    std::shared_ptr<const KeyVaultCertificateWithPolicy> GetCertificate(
+        std::string const& certificateName,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Get a specific version of a certificate from the cache, or from the Key Vault if
+     * it's not cached.
+     *
+     * @param certificateName The name of the certificate.
+     * @param certificateVersion The version of the certificate.
+     * @param context The context for the operation can be used for request cancellation.
+     * @return The certificate, shared with the cache.
+     */
+    std::shared_ptr<const KeyVaultCertificate> GetCertificateVersion(
+        std::string const& certificateName,
+        std::string const& certificateVersion,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Remove a certificate from the cache, all its versions included. It is fetched at the
+     * next call.
+     *
+     * @param certificateName The name of the certificate.
+     */
+    void Invalidate(std::string const& certificateName);
+
+  private:
+    struct State;
+
+    std::unique_ptr<State> m_state;
+  };
+
+}}}} // namespace Azure::Security::KeyVault::Certificates
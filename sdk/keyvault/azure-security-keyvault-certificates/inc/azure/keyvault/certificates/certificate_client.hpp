@@ -363,6 +363,42 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Certificat
         std::vector<uint8_t> const& certificateBackup,
         Azure::Core::Context const& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Backs up the specified certificate to a file.
+     *
+     * @details The backup is decoded straight from the response into the file. Unlike
+     * #BackupCertificate(), it's never held in memory as a whole: the response is read and
+     * decoded by blocks of up to 64 KiB, so several certificates can be backed up at the same
+     * time from different threads with a bounded amount of memory each.
+     *
+     * @remark This operation requires the certificates/backup permission.
+     *
+     * @param certificateName The name of the certificate.
+     * @param fileName The file to write the backup to. It's overwritten if it exists.
+     * @param context The context for the operation can be used for request cancellation.
+     * @return The number of bytes of the backup written to the file.
+     */
+    Azure::Response<int64_t> BackupCertificateTo(
+        std::string const& certificateName,
+        std::string const& fileName,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Restores a certificate from a backup file written by #BackupCertificateTo().
+     *
+     * @details The backup is read from the file and encoded into the request by blocks of
+     * 48 KiB, it's never held in memory as a whole.
+     *
+     * @remark This operation requires the certificates/restore permission.
+     *
+     * @param fileName The file to read the backup from.
+     * @param context The context for the operation can be used for request cancellation.
+     * @return The restored certificate.
+     */
+    Azure::Response<KeyVaultCertificateWithPolicy> RestoreCertificateBackupFrom(
+        std::string const& fileName,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
     /**
      * @brief List certificates in a specified key vault.
      *
@@ -513,7 +549,8 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Certificat
     Azure::Core::Http::Request CreateRequest(
         Azure::Core::Http::HttpMethod method,
         std::vector<std::string> const& path = {},
-        Azure::Core::IO::BodyStream* content = nullptr) const;
+        Azure::Core::IO::BodyStream* content = nullptr,
+        bool shouldBufferResponse = true) const;
 
     Azure::Core::Http::Request ContinuationTokenRequest(
         std::vector<std::string> const& path,
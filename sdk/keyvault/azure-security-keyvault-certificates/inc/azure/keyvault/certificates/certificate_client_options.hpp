@@ -13,6 +13,7 @@
 
 #include "azure/keyvault/certificates/certificate_client_models.hpp"
 #include "azure/keyvault/certificates/dll_import_export.hpp"
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -73,4 +74,18 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Certificat
     }
   };
 
+  /**
+   * @brief Define the options to create a #CachingCertificateClient.
+   *
+   */
+  struct CachingCertificateClientOptions final
+  {
+    /**
+     * @brief How long the latest version of a certificate is served from the cache before it is
+     * fetched again, to find out whether it was renewed or its policy updated.
+     *
+     */
+    std::chrono::milliseconds RevalidationInterval = std::chrono::minutes(5);
+  };
+
 }}}} // namespace Azure::Security::KeyVault::Certificates
@@ -10,6 +10,7 @@
 
 #include "azure/keyvault/certificates/dll_import_export.hpp"
 
+#include "azure/keyvault/certificates/caching_certificate_client.hpp"
 #include "azure/keyvault/certificates/certificate_client.hpp"
 #include "azure/keyvault/certificates/certificate_client_models.hpp"
 #include "azure/keyvault/certificates/certificate_client_operations.hpp"
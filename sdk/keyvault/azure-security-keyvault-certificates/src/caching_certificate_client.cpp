@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/keyvault/certificates/caching_certificate_client.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+using namespace Azure::Security::KeyVault::Certificates;
+
+namespace {
+// Waits are split so that a cancelled context is noticed quickly.
+constexpr std::chrono::milliseconds MaxWaitDuration(100);
+
+bool IsSameTime(
+    Azure::Nullable<Azure::DateTime> const& cached,
+    Azure::Nullable<Azure::DateTime> const& fetched)
+{
+  return cached.HasValue() == fetched.HasValue()
+      && (!cached.HasValue() || cached.Value() == fetched.Value());
+}
+
+// Whether a certificate fetched again is the one cached, the service doesn't return entity tags.
+bool IsSameCertificate(
+    KeyVaultCertificateWithPolicy const& cached,
+    KeyVaultCertificateWithPolicy const& fetched)
+{
+  return cached.Properties.IdUrl == fetched.Properties.IdUrl
+      && IsSameTime(cached.Properties.UpdatedOn, fetched.Properties.UpdatedOn)
+      && IsSameTime(cached.Policy.UpdatedOn, fetched.Policy.UpdatedOn);
+}
+} // namespace
+
+struct CachingCertificateClient::State final
+{
+  State(CertificateClient const& certificateClient, CachingCertificateClientOptions const& options)
+      : Client(certificateClient), Options(options)
+  {
+  }
+
+  // The name and the version of a certificate, the version is empty for the latest one.
+  using CertificateName = std::pair<std::string, std::string>;
+
+  struct Entry final
+  {
+    // Along with its policy for the latest version.
+    std::shared_ptr<const KeyVaultCertificate> Certificate;
+    std::chrono::steady_clock::time_point RevalidateOn;
+    // Only one request is sent for a certificate at a time.
+    bool Fetching = false;
+  };
+
+  CertificateClient Client;
+  CachingCertificateClientOptions Options;
+
+  std::mutex Mutex;
+  // Notified when a certificate is fetched or fails to be.
+  std::condition_variable Changed;
+  std::map<CertificateName, Entry> Entries;
+
+  // Returns the cached certificate, or the one fetched by the caller.
+  template <class FetchFunction>
+  std::shared_ptr<const KeyVaultCertificate> GetCertificate(
+      CertificateName const& name,
+      Azure::Core::Context const& context,
+      FetchFunction fetch);
+};
+
+template <class FetchFunction>
+std::shared_ptr<const KeyVaultCertificate> CachingCertificateClient::State::GetCertificate(
+    CertificateName const& name,
+    Azure::Core::Context const& context,
+    FetchFunction fetch)
+{
+  std::unique_lock<std::mutex> lock(Mutex);
+  while (true)
+  {
+    auto& entry = Entries[name];
+    if (entry.Certificate && std::chrono::steady_clock::now() < entry.RevalidateOn)
+    {
+      return entry.Certificate;
+    }
+    if (!entry.Fetching)
+    {
+      entry.Fetching = true;
+      break;
+    }
+    // The certificate being revalidated is served meanwhile.
+    if (entry.Certificate)
+    {
+      return entry.Certificate;
+    }
+    // The request in progress is awaited, a failed one is sent again by one of the callers.
+    context.ThrowIfCancelled();
+    Changed.wait_for(lock, MaxWaitDuration);
+  }
+  lock.unlock();
+
+  std::shared_ptr<const KeyVaultCertificate> certificate;
+  try
+  {
+    certificate = fetch();
+  }
+  catch (...)
+  {
+    lock.lock();
+    auto entry = Entries.find(name);
+    if (entry != Entries.end())
+    {
+      entry->second.Fetching = false;
+    }
+    Changed.notify_all();
+    throw;
+  }
+  lock.lock();
+  auto entry = Entries.find(name);
+  // The certificate fetched isn't cached if it was invalidated meanwhile, it may be outdated.
+  if (entry != Entries.end())
+  {
+    entry->second.Fetching = false;
+    if (name.second.empty())
+    {
+      // The latest version is the only one cached with its policy.
+      if (!entry->second.Certificate
+          || !IsSameCertificate(
+              static_cast<KeyVaultCertificateWithPolicy const&>(*entry->second.Certificate),
+              static_cast<KeyVaultCertificateWithPolicy const&>(*certificate)))
+      {
+        entry->second.Certificate = certificate;
+      }
+      entry->second.RevalidateOn = std::chrono::steady_clock::now() + Options.RevalidationInterval;
+      // The latest version is also served to the callers requesting it by its version.
+      auto& versionEntry
+          = Entries[CertificateName(name.first, entry->second.Certificate->Properties.Version)];
+      if (!versionEntry.Certificate)
+      {
+        versionEntry.Certificate = entry->second.Certificate;
+        versionEntry.RevalidateOn = std::chrono::steady_clock::time_point::max();
+      }
+    }
+    else
+    {
+      // A version of a certificate never changes.
+      entry->second.Certificate = certificate;
+      entry->second.RevalidateOn = std::chrono::steady_clock::time_point::max();
+    }
+    certificate = entry->second.Certificate;
+  }
+  Changed.notify_all();
+  return certificate;
+}
+
+CachingCertificateClient::CachingCertificateClient(
+    CertificateClient const& certificateClient,
+    CachingCertificateClientOptions const& options)
+    : m_state(std::make_unique<State>(certificateClient, options))
+{
+}
+
+CachingCertificateClient::~CachingCertificateClient() = default;
+
+std::shared_ptr<const KeyVaultCertificateWithPolicy> CachingCertificateClient::GetCertificate(
+    std::string const& certificateName,
+    Azure::Core::Context const& context) const
+{
+  State& state = *m_state;
+  auto certificate = state.GetCertificate(
+      State::CertificateName(certificateName, std::string()), context, [&]() {
+        return std::make_shared<const KeyVaultCertificateWithPolicy>(
+            state.Client.GetCertificate(certificateName, context).Value);
+      });
+  return std::static_pointer_cast<const KeyVaultCertificateWithPolicy>(certificate);
+}
+
+std::shared_ptr<const KeyVaultCertificate> CachingCertificateClient::GetCertificateVersion(
+    std::string const& certificateName,
+    std::string const& certificateVersion,
+    Azure::Core::Context const& context) const
+{
+  State& state = *m_state;
+  return state.GetCertificate(
+      State::CertificateName(certificateName, certificateVersion), context, [&]() {
+        return std::make_shared<const KeyVaultCertificate>(
+            state.Client.GetCertificateVersion(certificateName, certificateVersion, context)
+                .Value);
+      });
+}
+
+void CachingCertificateClient::Invalidate(std::string const& certificateName)
+{
+  std::lock_guard<std::mutex> guard(m_state->Mutex);
+  auto entry = m_state->Entries.lower_bound(State::CertificateName(certificateName, std::string()));
+  while (entry != m_state->Entries.end() && entry->first.first == certificateName)
+  {
+    entry = m_state->Entries.erase(entry);
+  }
+}
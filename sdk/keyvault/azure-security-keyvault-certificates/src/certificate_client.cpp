@@ -8,6 +8,7 @@
 #include "private/keyvault_certificates_common_request.hpp"
 #include "private/package_version.hpp"
 #include <azure/core/base64.hpp>
+#include <azure/keyvault/shared/keyvault_backup_stream.hpp>
 #include <azure/keyvault/shared/keyvault_shared.hpp>
 
 #include <azure/core/credentials/credentials.hpp>
@@ -42,10 +43,11 @@ std::unique_ptr<RawResponse> CertificateClient::SendRequest(
 Request CertificateClient::CreateRequest(
     HttpMethod method,
     std::vector<std::string> const& path,
-    Azure::Core::IO::BodyStream* content) const
+    Azure::Core::IO::BodyStream* content,
+    bool shouldBufferResponse) const
 {
   return KeyVaultCertificatesCommonRequest::CreateRequest(
-      m_vaultUrl, m_apiVersion, method, path, content);
+      m_vaultUrl, m_apiVersion, method, path, content, shouldBufferResponse);
 }
 
 Request CertificateClient::ContinuationTokenRequest(
@@ -377,6 +379,36 @@ Azure::Response<KeyVaultCertificateWithPolicy> CertificateClient::RestoreCertifi
   auto value = KeyVaultCertificateSerializer::Deserialize("", *rawResponse);
   return Azure::Response<KeyVaultCertificateWithPolicy>(std::move(value), std::move(rawResponse));
 }
+Azure::Response<int64_t> CertificateClient::BackupCertificateTo(
+    std::string const& certificateName,
+    std::string const& fileName,
+    Azure::Core::Context const& context) const
+{
+  // The response isn't buffered, the backup is decoded from the body stream into the file.
+  auto request = CreateRequest(
+      HttpMethod::Post, {CertificatesPath, certificateName, BackupPath}, nullptr, false);
+  auto rawResponse = SendRequest(request, context);
+
+  auto const length = Azure::Security::KeyVault::_internal::WriteBackupToFile(
+      *rawResponse, fileName, context);
+  return Azure::Response<int64_t>(length, std::move(rawResponse));
+}
+
+Azure::Response<KeyVaultCertificateWithPolicy> CertificateClient::RestoreCertificateBackupFrom(
+    std::string const& fileName,
+    Azure::Core::Context const& context) const
+{
+  // The payload encodes the backup as it's read from the file.
+  Azure::Core::IO::FileBodyStream backupStream(fileName);
+  Azure::Security::KeyVault::_internal::BackupPayloadStream payloadStream(backupStream);
+
+  auto request = CreateRequest(HttpMethod::Post, {CertificatesPath, RestorePath}, &payloadStream);
+
+  auto rawResponse = SendRequest(request, context);
+  auto value = KeyVaultCertificateSerializer::Deserialize("", *rawResponse);
+  return Azure::Response<KeyVaultCertificateWithPolicy>(std::move(value), std::move(rawResponse));
+}
+
 CertificatePropertiesPagedResponse CertificateClient::GetPropertiesOfCertificates(
     GetPropertiesOfCertificatesOptions const& options,
     Azure::Core::Context const& context) const
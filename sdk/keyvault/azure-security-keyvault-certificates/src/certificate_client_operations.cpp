@@ -5,7 +5,6 @@
 #include "azure/keyvault/certificates/certificate_client_models.hpp"
 #include "private/certificate_constants.hpp"
 #include "private/certificate_serializers.hpp"
-#include <thread>
 
 using namespace Azure::Security::KeyVault::Certificates;
 
@@ -13,14 +12,16 @@ Azure::Response<KeyVaultCertificateWithPolicy> CreateCertificateOperation::PollU
     std::chrono::milliseconds period,
     Azure::Core::Context& context)
 {
+  int32_t pollCount = 0;
   while (true)
   {
+    ++pollCount;
     Poll(context);
     if (IsDone() && IsCompleted())
     {
       break;
     }
-    std::this_thread::sleep_for(period);
+    WaitBeforeNextPoll(period, pollCount, context);
   }
 
   if (!m_properties.Error)
@@ -144,14 +145,16 @@ Azure::Response<DeletedCertificate> DeleteCertificateOperation::PollUntilDoneInt
     std::chrono::milliseconds period,
     Azure::Core::Context& context)
 {
+  int32_t pollCount = 0;
   while (true)
   {
+    ++pollCount;
     Poll(context);
     if (IsDone())
     {
       break;
     }
-    std::this_thread::sleep_for(period);
+    WaitBeforeNextPoll(period, pollCount, context);
   }
 
   return Azure::Response<DeletedCertificate>(
@@ -230,14 +233,16 @@ DeleteCertificateOperation DeleteCertificateOperation::CreateFromResumeToken(
 Azure::Response<KeyVaultCertificateWithPolicy> RecoverDeletedCertificateOperation::
     PollUntilDoneInternal(std::chrono::milliseconds period, Azure::Core::Context& context)
 {
+  int32_t pollCount = 0;
   while (true)
   {
+    ++pollCount;
     Poll(context);
     if (IsDone())
     {
       break;
     }
-    std::this_thread::sleep_for(period);
+    WaitBeforeNextPoll(period, pollCount, context);
   }
 
   return Azure::Response<KeyVaultCertificateWithPolicy>(
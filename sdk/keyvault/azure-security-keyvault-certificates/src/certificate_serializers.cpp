@@ -6,6 +6,8 @@
 #include <azure/core/internal/json/json_optional.hpp>
 #include <azure/core/internal/json/json_serializable.hpp>
 #include <azure/core/url.hpp>
+#include <azure/keyvault/shared/keyvault_flat_json.hpp>
+#include <azure/keyvault/shared/keyvault_paged_json.hpp>
 
 #include "azure/keyvault/certificates/certificate_client_models.hpp"
 #include "private/certificate_constants.hpp"
@@ -18,6 +20,7 @@ using namespace Azure::Core::Json::_internal;
 using namespace Azure::Core::_internal;
 
 using Azure::Core::_internal::PosixTimeConverter;
+using Azure::Security::KeyVault::_internal::PagedJsonParser;
 
 void _detail::KeyVaultCertificateSerializer::Deserialize(
     KeyVaultCertificateWithPolicy& certificate,
@@ -655,20 +658,22 @@ DeletedCertificate DeletedCertificateSerializer::Deserialize(
 BackupCertificateResult BackupCertificateSerializer::Deserialize(
     Azure::Core::Http::RawResponse const& rawResponse)
 {
-  auto const& body = rawResponse.GetBody();
-  auto jsonParser = json::parse(body);
-  auto encodedResult = jsonParser[ValuePropertyName].get<std::string>();
+  // The backup is decoded straight from the body, without building a JSON document.
+  Azure::Security::KeyVault::_internal::FlatJsonReader reader(rawResponse.GetBody());
   BackupCertificateResult data;
-  data.Certificate = Base64Url::Base64UrlDecode(encodedResult);
+  data.Certificate = reader.GetBase64Url(_detail::ValuePropertyName);
 
   return data;
 }
 
 std::string BackupCertificateSerializer::Serialize(std::vector<uint8_t> const& backup)
 {
-  json payload;
-  payload[_detail::ValuePropertyName] = Base64Url::Base64UrlEncode(backup);
-  return payload.dump();
+  // The backup is encoded straight into the payload, sized up front.
+  using Azure::Security::KeyVault::_internal::FlatJsonWriter;
+  FlatJsonWriter payload(
+      FlatJsonWriter::Base64UrlPropertyLength(_detail::ValuePropertyName, backup));
+  payload.WriteBase64Url(_detail::ValuePropertyName, backup);
+  return payload.Finish();
 }
 
 CertificatePropertiesPagedResponse CertificatePropertiesPagedResponseSerializer::Deserialize(
@@ -677,14 +682,9 @@ CertificatePropertiesPagedResponse CertificatePropertiesPagedResponseSerializer:
   CertificatePropertiesPagedResponse response;
 
   auto const& body = rawResponse.GetBody();
-  auto jsonResponse = json::parse(body);
-
-  JsonOptional::SetIfExists(response.NextPageToken, jsonResponse, NextLinkPropertyName);
-
-  auto certificatePropertiesJson = jsonResponse[ValuePropertyName];
 
-  for (auto const& certificate : certificatePropertiesJson)
-  {
+  // Certificate properties, deserialized one at a time as they are parsed
+  auto jsonResponse = PagedJsonParser::Parse(body, [&response](json const& certificate) {
     CertificateProperties properties;
     // Parse URL for the name, vaultUrl and version
     _detail::KeyVaultCertificateSerializer::ParseKeyUrl(
@@ -703,12 +703,14 @@ CertificatePropertiesPagedResponse CertificatePropertiesPagedResponseSerializer:
     // "Attributes"
     if (certificate.contains(AttributesPropertyName))
     {
-      auto attributes = certificate[AttributesPropertyName];
+      auto const& attributes = certificate[AttributesPropertyName];
       CertificatePropertiesSerializer::Deserialize(properties, attributes);
     }
 
-    response.Items.emplace_back(properties);
-  }
+    response.Items.emplace_back(std::move(properties));
+  });
+
+  JsonOptional::SetIfExists(response.NextPageToken, jsonResponse, NextLinkPropertyName);
 
   return response;
 }
@@ -718,20 +720,17 @@ IssuerPropertiesPagedResponse IssuerPropertiesPagedResponseSerializer::Deseriali
 {
   IssuerPropertiesPagedResponse response;
   auto const& body = rawResponse.GetBody();
-  auto jsonResponse = json::parse(body);
-  std::string data = jsonResponse.dump();
-  JsonOptional::SetIfExists(response.NextPageToken, jsonResponse, NextLinkPropertyName);
 
-  auto issuersPropertiesJson = jsonResponse[ValuePropertyName];
-
-  for (auto const& oneIssuer : issuersPropertiesJson)
-  {
+  // Issuers, deserialized one at a time as they are parsed
+  auto jsonResponse = PagedJsonParser::Parse(body, [&response](json const& oneIssuer) {
     CertificateIssuerItem issuer;
     issuer.IdUrl = oneIssuer[IdName].get<std::string>();
     issuer.Provider = oneIssuer[ProviderPropertyValue].get<std::string>();
     ParseIdUrl(issuer, issuer.IdUrl);
-    response.Items.emplace_back(issuer);
-  }
+    response.Items.emplace_back(std::move(issuer));
+  });
+
+  JsonOptional::SetIfExists(response.NextPageToken, jsonResponse, NextLinkPropertyName);
 
   return response;
 }
@@ -741,24 +740,22 @@ DeletedCertificatesPagedResponse DeletedCertificatesPagedResponseSerializer::Des
 {
   DeletedCertificatesPagedResponse response;
   auto const& body = rawResponse.GetBody();
-  auto jsonResponse = json::parse(body);
 
-  JsonOptional::SetIfExists(response.NextPageToken, jsonResponse, NextLinkPropertyName);
-  auto deletedCertificates = jsonResponse[ValuePropertyName];
-
-  for (auto const& oneDeleted : deletedCertificates)
-  {
+  // Deleted certificates, deserialized one at a time as they are parsed
+  auto jsonResponse = PagedJsonParser::Parse(body, [&response](json const& oneDeleted) {
     std::string deletedString = oneDeleted.dump();
     std::vector<uint8_t> vec(deletedString.begin(), deletedString.end());
 
     Azure::Core::Http::RawResponse fakeResponse(
         1, 1, Azure::Core::Http::HttpStatusCode::Ok, "Success");
-    fakeResponse.SetBody(vec);
+    fakeResponse.SetBody(std::move(vec));
 
     auto deserializedDeletedCert = DeletedCertificateSerializer::Deserialize("", fakeResponse);
 
-    response.Items.emplace_back(deserializedDeletedCert);
-  }
+    response.Items.emplace_back(std::move(deserializedDeletedCert));
+  });
+
+  JsonOptional::SetIfExists(response.NextPageToken, jsonResponse, NextLinkPropertyName);
 
   return response;
 }
@@ -6,6 +6,7 @@
 
 #include <azure/core/exception.hpp>
 #include <azure/core/http/http.hpp>
+#include <azure/keyvault/shared/keyvault_backup_stream.hpp>
 #include <memory>
 
 using namespace Azure::Security::KeyVault;
@@ -30,6 +31,7 @@ _detail::KeyVaultCertificatesCommonRequest::SendRequest(
     case Azure::Core::Http::HttpStatusCode::NoContent:
       break;
     default:
+      Azure::Security::KeyVault::_internal::BufferErrorResponse(*response, context);
       throw Azure::Core::RequestFailedException(response);
   }
   return response;
@@ -40,10 +42,12 @@ Azure::Core::Http::Request _detail::KeyVaultCertificatesCommonRequest::CreateReq
     std::string const& apiVersion,
     Azure::Core::Http::HttpMethod method,
     std::vector<std::string> const& path,
-    Azure::Core::IO::BodyStream* content)
+    Azure::Core::IO::BodyStream* content,
+    bool shouldBufferResponse)
 {
   using namespace Azure::Core::Http;
-  Request request = content == nullptr ? Request(method, url) : Request(method, url, content);
+  Request request = content == nullptr ? Request(method, url, shouldBufferResponse)
+                                       : Request(method, url, content, shouldBufferResponse);
 
   request.SetHeader(ContentHeaderName, ApplicationJsonValue);
   request.GetUrl().AppendQueryParameter(ApiVersionQueryParamName, apiVersion);
@@ -33,7 +33,8 @@ namespace Azure { namespace Security { namespace KeyVault { namespace _detail {
         std::string const& apiVersion,
         Azure::Core::Http::HttpMethod method,
         std::vector<std::string> const& path,
-        Azure::Core::IO::BodyStream* content);
+        Azure::Core::IO::BodyStream* content,
+        bool shouldBufferResponse = true);
 
     static std::unique_ptr<Azure::Core::Http::RawResponse> SendRequest(
         Azure::Core::Http::_internal::HttpPipeline const& pipeline,
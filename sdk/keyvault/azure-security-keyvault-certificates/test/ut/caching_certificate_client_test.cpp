@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/http/transport.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/keyvault/keyvault_certificates.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::Certificates;
+
+namespace {
+class NonExpiringCredential final : public Azure::Core::Credentials::TokenCredential {
+public:
+  Azure::Core::Credentials::AccessToken GetToken(
+      Azure::Core::Credentials::TokenRequestContext const&,
+      Azure::Core::Context const&) const override
+  {
+    return {"magicToken", Azure::DateTime::clock::now() + std::chrono::hours(24)};
+  }
+};
+
+// Returns the certificate requested, the latest version is "v1" and comes with its policy.
+class MockCertificateTransport final : public Azure::Core::Http::HttpTransport {
+public:
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Context const&) override
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    // The path is certificates/{name}/{version}, the version is empty for the latest one.
+    const std::string path = request.GetUrl().GetPath();
+    Requests.push_back(request.GetMethod().ToString() + " " + path);
+    const size_t versionStart = path.find('/', std::strlen("certificates/"));
+    const std::string version
+        = versionStart == std::string::npos ? "v1" : path.substr(versionStart + 1);
+    std::string body = "{\"id\":\"https://vault.vault.azure.net/certificates/cert/" + version
+        + "\",\"x5t\":\"AAAA\",\"cer\":\"AAAA\",\"attributes\":{\"updated\":1493938410}";
+    if (versionStart == std::string::npos)
+    {
+      body += ",\"policy\":{\"key_props\":{},\"secret_props\":{},"
+              "\"x509_props\":{\"subject\":\"CN=xyz\"},\"issuer\":{},\"attributes\":{\"updated\":"
+          + std::to_string(PolicyUpdatedOn) + "},\"lifetime_actions\":[]}";
+    }
+    body += "}";
+
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(
+        1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+    response->SetHeader("content-type", "application/json");
+    // The bodies outlive the responses streaming them.
+    m_bodies.emplace_back(body.begin(), body.end());
+    response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+        m_bodies.back().data(), m_bodies.back().size()));
+    return response;
+  }
+
+  int64_t PolicyUpdatedOn = 1493938410;
+  std::vector<std::string> Requests;
+
+private:
+  std::mutex m_mutex;
+  std::deque<std::vector<uint8_t>> m_bodies;
+};
+
+std::unique_ptr<CertificateClient> CreateCertificateClient(
+    std::shared_ptr<MockCertificateTransport> transport)
+{
+  CertificateClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  options.Retry.MaxRetries = 0;
+  return std::make_unique<CertificateClient>(
+      "https://vault.vault.azure.net", std::make_shared<NonExpiringCredential>(), options);
+}
+} // namespace
+
+TEST(CachingCertificateClient, RevalidatesTheLatestVersions)
+{
+  auto transport = std::make_shared<MockCertificateTransport>();
+  CachingCertificateClientOptions options;
+  options.RevalidationInterval = std::chrono::milliseconds(100);
+  CachingCertificateClient client(*CreateCertificateClient(transport), options);
+
+  auto certificate = client.GetCertificate("cert");
+  EXPECT_EQ(certificate->Properties.Version, "v1");
+  EXPECT_EQ(certificate->Policy.Subject, "CN=xyz");
+  EXPECT_EQ(client.GetCertificate("cert"), certificate);
+  EXPECT_EQ(client.GetCertificateVersion("cert", "v1").get(), certificate.get());
+  EXPECT_EQ(transport->Requests, std::vector<std::string>{"GET certificates/cert"});
+
+  // The certificate unchanged is kept.
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  EXPECT_EQ(client.GetCertificate("cert"), certificate);
+  EXPECT_EQ(transport->Requests.size(), 2U);
+
+  transport->PolicyUpdatedOn = 1493938500;
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  auto updatedCertificate = client.GetCertificate("cert");
+  EXPECT_NE(updatedCertificate, certificate);
+  EXPECT_EQ(updatedCertificate->Properties.Version, "v1");
+  EXPECT_EQ(client.GetCertificateVersion("cert", "v1").get(), certificate.get());
+  EXPECT_EQ(transport->Requests.size(), 3U);
+}
+
+TEST(CachingCertificateClient, CachesVersionsWithoutExpiring)
+{
+  auto transport = std::make_shared<MockCertificateTransport>();
+  CachingCertificateClientOptions options;
+  options.RevalidationInterval = std::chrono::milliseconds(0);
+  CachingCertificateClient client(*CreateCertificateClient(transport), options);
+
+  auto certificate = client.GetCertificateVersion("cert", "v0");
+  EXPECT_EQ(certificate->Properties.Version, "v0");
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(client.GetCertificateVersion("cert", "v0"), certificate);
+  EXPECT_EQ(transport->Requests, std::vector<std::string>{"GET certificates/cert/v0"});
+
+  client.Invalidate("cert");
+  EXPECT_NE(client.GetCertificateVersion("cert", "v0"), certificate);
+  EXPECT_EQ(transport->Requests.size(), 2U);
+}
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Defines the Key Vault Keys caching client.
+ *
+ */
+
+#pragma once
+
+#include "azure/keyvault/keys/cryptography/cryptography_client.hpp"
+#include "azure/keyvault/keys/key_client.hpp"
+#include "azure/keyvault/keys/key_client_models.hpp"
+#include "azure/keyvault/keys/key_client_options.hpp"
+
+#include <azure/core/context.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
+
+  /**
+   * @brief The CachingKeyClient serves the keys of a #KeyClient from an in-memory cache, so that
+   * the keys read over and over aren't each fetched and deserialized again.
+   *
+   * @remark The keys are shared by the callers, which must not modify them. A version of a key
+   * never changes, so it is cached without expiring. The latest version is fetched again once the
+   * revalidation interval has passed; the cached key is kept when the version and the last update
+   * fetched are the same. Meanwhile, the concurrent callers are served the cached key. The
+   * requests are sent through the pipeline of the key client.
+   */
+  class CachingKeyClient final {
+  public:
+    /**
+     * @brief Construct a new CachingKeyClient object.
+     *
+     * @param keyClient The client fetching the keys, its pipeline is shared.
+     * @param options The options to customize the cache.
+     */
+    explicit CachingKeyClient(
+        KeyClient const& keyClient,
+        CachingKeyClientOptions const& options = CachingKeyClientOptions());
+
+    /**
+     * @brief Destructor.
+     *
+     */
+    ~CachingKeyClient();
+
+    CachingKeyClient(CachingKeyClient const&) = delete;
+    CachingKeyClient& operator=(CachingKeyClient const&) = delete;
+
+    /**
+     * @brief Get the public part of a key from the cache, or from the Key Vault if it's not cached
+     * or it's due for revalidation.
+     *
+     * @param name The name of the key.
+     * @param options Optional parameters for this operation.
+     * @param context The context for the operation can be used for request cancellation.
+     * @return The key, shared with the cache.
+     */
+    std::shared_ptr<const KeyVaultKey> GetKey(
+        std::string const& name,
+        GetKeyOptions const& options = GetKeyOptions(),
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Get a CryptographyClient for the version of a key served by the cache.
+     *
+     * @details The returned client uses the pipeline of the key client, and performs the public
+     * key operations locally with the cached key, which isn't fetched again. The clients created
+     * for the same version of a key share the key.
+     *
+     * @param name The name of the key used to perform cryptographic operations.
+     * @param version Optional version of the key, the latest one if it's empty.
+     * @param context The context for the operation can be used for request cancellation.
+     * @return Cryptography::CryptographyClient for the version of the key.
+     */
+    Cryptography::CryptographyClient GetCryptographyClient(
+        std::string const& name,
+        std::string const& version = std::string(),
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Remove a key from the cache, all its versions included. It is fetched at the next
+     * call.
+     *
+     * @param name The name of the key.
+     */
+    void Invalidate(std::string const& name);
+
+  private:
+    struct State;
+
+    std::unique_ptr<State> m_state;
+  };
+
+}}}} // namespace Azure::Security::KeyVault::Keys
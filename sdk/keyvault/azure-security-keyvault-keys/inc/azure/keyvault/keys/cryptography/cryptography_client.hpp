@@ -35,6 +35,9 @@ namespace Azure {
      *
      */
     class CryptoClientInternalAccess;
+    class LocalCryptographyProvider;
+    struct LocalCryptographyCache;
+    struct CryptographyRequestUrls;
   } // namespace _detail
 
   /**
@@ -48,19 +51,23 @@ namespace Azure {
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
 
   private:
+    // Null unless the public key operations are performed locally, shared by the copies.
+    std::shared_ptr<_detail::LocalCryptographyCache> m_localCryptography;
+    // The URLs of the operations, shared by the copies.
+    std::shared_ptr<_detail::CryptographyRequestUrls const> m_requestUrls;
+
     // Provide private-access to the internal layer
     friend class Azure::Security::KeyVault::Keys::Cryptography::_detail::CryptoClientInternalAccess;
 
-    Azure::Core::Http::Request CreateRequest(
-        Azure::Core::Http::HttpMethod method,
-        std::vector<std::string> const& path = {},
-        Azure::Core::IO::BodyStream* content = nullptr) const;
-
     std::unique_ptr<Azure::Core::Http::RawResponse> SendCryptoRequest(
-        std::vector<std::string> const& path,
+        Azure::Core::Url const& url,
         std::string const& payload,
         Azure::Core::Context const& context) const;
 
+    // Fetches the key once, returns null when the operations are all performed by the service.
+    _detail::LocalCryptographyProvider const* GetLocalCryptographyProvider(
+        Azure::Core::Context const& context);
+
     /**
      * @brief Construct a new Cryptography client that re-uses a pre-existing pipeline.
      *
@@ -76,15 +83,16 @@ namespace Azure {
     explicit CryptographyClient(
         Azure::Core::Url keyId,
         std::string const& apiVersion,
-        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline)
-        : m_keyId(keyId), m_apiVersion(apiVersion), m_pipeline(pipeline)
-    {
-    }
+        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline);
 
   public:
     /**
      * @brief Initializes a new instance of the #CryptographyClient class.
      *
+     * @remark Each client constructed this way builds its own pipeline. To use many keys of a
+     * vault, get their clients with #KeyClient::GetCryptographyClient instead, which share the
+     * pipeline of the key client.
+     *
      * @param keyId The key identifier of the #KeyVaultKey which will be used for cryptographic
      * operations.
      * @param credential A #TokenCredential used to authenticate requests to the vault, like
@@ -158,6 +166,21 @@ namespace Azure {
         std::vector<uint8_t> const& encryptedKey,
         Azure::Core::Context const& context = Azure::Core::Context());
 
+    /**
+     * @brief Decrypts the specified encrypted keys, with concurrent requests.
+     *
+     * @param algorithm The #KeyWrapAlgorithm to use.
+     * @param encryptedKeys The encrypted keys.
+     * @param options Options for the batch.
+     * @param context A #Azure::Core::Context to cancel the operations.
+     * @return The result of the unwrap operation of every encrypted key, in the same order.
+     */
+    std::vector<BatchOperationResult<UnwrapResult>> UnwrapKeys(
+        KeyWrapAlgorithm algorithm,
+        std::vector<std::vector<uint8_t>> const& encryptedKeys,
+        CryptographyBatchOptions const& options = CryptographyBatchOptions(),
+        Azure::Core::Context const& context = Azure::Core::Context());
+
     /**
      * @brief Signs the specified digest.
      *
@@ -174,9 +197,27 @@ namespace Azure {
         std::vector<uint8_t> const& digest,
         Azure::Core::Context const& context = Azure::Core::Context());
 
+    /**
+     * @brief Signs the specified digests, with concurrent requests.
+     *
+     * @param algorithm The #SignatureAlgorithm to use.
+     * @param digests The pre-hashed digests to sign.
+     * @param options Options for the batch.
+     * @param context A #Azure::Core::Context to cancel the operations.
+     * @return The result of the sign operation of every digest, in the same order.
+     */
+    std::vector<BatchOperationResult<SignResult>> SignMany(
+        SignatureAlgorithm algorithm,
+        std::vector<std::vector<uint8_t>> const& digests,
+        CryptographyBatchOptions const& options = CryptographyBatchOptions(),
+        Azure::Core::Context const& context = Azure::Core::Context());
+
     /**
      * @brief Signs the specified data.
      *
+     * @remark The data is hashed as it is read, in blocks of 4 MiB, so it isn't loaded in memory.
+     * The next block is read while the last one is hashed.
+     *
      * @param algorithm The #SignatureAlgorithm to use.
      * @param data The data to sign.
      * @param context A #Azure::Core::Context to cancel the operation.
@@ -204,6 +245,24 @@ namespace Azure {
         std::vector<uint8_t> const& data,
         Azure::Core::Context const& context = Azure::Core::Context());
 
+    /**
+     * @brief Signs the content of the specified file.
+     *
+     * @remark The file is hashed as it is read, like a #Azure::Core::IO::BodyStream passed to
+     * #SignData, so it isn't loaded in memory.
+     *
+     * @param algorithm The #SignatureAlgorithm to use.
+     * @param fileName The name of the file to sign.
+     * @param context A #Azure::Core::Context to cancel the operation.
+     * @return The result of the sign operation. The returned #SignResult contains the signature
+     * along with all other information needed to verify it. This information should be stored
+     * with the signature.
+     */
+    Azure::Response<SignResult> SignFile(
+        SignatureAlgorithm algorithm,
+        std::string const& fileName,
+        Azure::Core::Context const& context = Azure::Core::Context());
+
     /**
      * @brief Verifies the specified signature.
      *
@@ -222,9 +281,31 @@ namespace Azure {
         std::vector<uint8_t> const& signature,
         Azure::Core::Context const& context = Azure::Core::Context());
 
+    /**
+     * @brief Verifies the specified signatures, with concurrent requests.
+     *
+     * @param algorithm The #SignatureAlgorithm to use.
+     * @param digests The pre-hashed digests corresponding to the signatures.
+     * @param signatures The signatures to verify, one for every digest.
+     * @param options Options for the batch.
+     * @param context A #Azure::Core::Context to cancel the operations.
+     * @return The result of the verify operation of every signature, in the same order.
+     *
+     * @throw std::invalid_argument when the number of signatures isn't the number of digests.
+     */
+    std::vector<BatchOperationResult<VerifyResult>> VerifyMany(
+        SignatureAlgorithm algorithm,
+        std::vector<std::vector<uint8_t>> const& digests,
+        std::vector<std::vector<uint8_t>> const& signatures,
+        CryptographyBatchOptions const& options = CryptographyBatchOptions(),
+        Azure::Core::Context const& context = Azure::Core::Context());
+
     /**
      * @brief Verifies the specified signature.
      *
+     * @remark The data is hashed as it is read, in blocks of 4 MiB, so it isn't loaded in memory.
+     * The next block is read while the last one is hashed.
+     *
      * @param algorithm The #SignatureAlgorithm to use. This must be the same algorithm used to
      * sign the data.
      * @param data The data corresponding to the signature.
@@ -255,6 +336,26 @@ namespace Azure {
         std::vector<uint8_t> const& data,
         std::vector<uint8_t> const& signature,
         Azure::Core::Context const& context = Azure::Core::Context());
+
+    /**
+     * @brief Verifies the signature of the content of the specified file.
+     *
+     * @remark The file is hashed as it is read, like a #Azure::Core::IO::BodyStream passed to
+     * #VerifyData, so it isn't loaded in memory.
+     *
+     * @param algorithm The #SignatureAlgorithm to use. This must be the same algorithm used to
+     * sign the file.
+     * @param fileName The name of the file corresponding to the signature.
+     * @param signature The signature to verify.
+     * @param context A #Azure::Core::Context to cancel the operation.
+     * @return The result of the verify operation. If the signature is valid the
+     * #VerifyResult.IsValid property of the returned #VerifyResult will be set to true.
+     */
+    Azure::Response<VerifyResult> VerifyFile(
+        SignatureAlgorithm algorithm,
+        std::string const& fileName,
+        std::vector<uint8_t> const& signature,
+        Azure::Core::Context const& context = Azure::Core::Context());
   };
 
 }}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography
@@ -10,9 +10,11 @@
 #pragma once
 
 #include <azure/core/cryptography/hash.hpp>
+#include <azure/core/nullable.hpp>
 
 #include "azure/keyvault/keys/dll_import_export.hpp"
 
+#include <exception>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -1101,4 +1103,24 @@ namespace Azure {
     }
   };
 
+  /**
+   * @brief Represents the outcome of an operation of a batch, which fails or succeeds on its own.
+   *
+   * @tparam T The result of the operation.
+   */
+  template <class T> struct BatchOperationResult final
+  {
+    /**
+     * @brief The result of the operation, null when it failed.
+     *
+     */
+    Azure::Nullable<T> Value;
+
+    /**
+     * @brief The exception thrown by the operation, null when it succeeded.
+     *
+     */
+    std::exception_ptr Error;
+  };
+
 }}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography
@@ -71,6 +71,18 @@ namespace Azure {
      */
     ServiceVersion Version;
 
+    /**
+     * @brief Performs the public key operations locally when possible.
+     *
+     * @details The key is fetched once, with the keys/get permission, and the RSA encryptions,
+     * the RSA key wrappings and the RSA and EC signature verifications are then performed
+     * in-process without sending requests to Key Vault. The raw response of an operation
+     * performed locally is an empty `200 OK` one. The other operations, and all of them when the
+     * key can't be fetched, are performed by the service.
+     *
+     */
+    bool LocalPublicKeyOperations = false;
+
     /**
      * @brief Construct a new Key Client Options object.
      *
@@ -81,4 +93,19 @@ namespace Azure {
     {
     }
   };
+
+  /**
+   * @brief Options for the batches of operations of the #CryptographyClient.
+   *
+   */
+  struct CryptographyBatchOptions final
+  {
+    /**
+     * @brief The maximum number of requests sent concurrently.
+     *
+     * @remark The whole batch pauses for the delay requested by the service when a request is
+     * throttled, the throttled operation is then attempted again.
+     */
+    int32_t Concurrency = 16;
+  };
 }}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography
@@ -75,7 +75,9 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
      * @brief Get a CryptographyClient for the given key.
      *
      * @details The returned client uses the same options and pipeline as the key client which
-     * creates it.
+     * creates it. Creating it is cheap: no pipeline is built, and the clients of all the keys share
+     * the connections and the tokens of the key client. The other clients of the vault, such as a
+     * SecretClient, share the tokens too when they are given the same credential instance.
      *
      * @param name The name of the key used to perform cryptographic operations.
      * @param version Optional version of the key used to perform cryptographic operations.
@@ -369,6 +371,38 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
         std::vector<uint8_t> const& backup,
         Azure::Core::Context const& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Backs up a key to a file, decoding the backup straight from the response.
+     *
+     * @remark Unlike #BackupKey(), the backup is never held in memory as a whole. The response
+     * is read and decoded by blocks of up to 64 KiB, so several keys can be backed up at the
+     * same time from different threads with a bounded amount of memory each. This operation
+     * requires the key/backup permission.
+     *
+     * @param name The name of the key.
+     * @param fileName The file to write the backup to. It's overwritten if it exists.
+     * @param context A #Azure::Core::Context controlling the request lifetime.
+     * @return The number of bytes of the backup written to the file.
+     */
+    Azure::Response<int64_t> BackupKeyTo(
+        std::string const& name,
+        std::string const& fileName,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Restores a key from a backup file written by #BackupKeyTo().
+     *
+     * @remark Unlike #RestoreKeyBackup(), the backup is never held in memory as a whole. It's
+     * read from the file and encoded into the request by blocks of 48 KiB. This operation
+     * requires the keys/restore permission.
+     *
+     * @param fileName The file to read the backup from.
+     * @param context A #Azure::Core::Context controlling the request lifetime.
+     */
+    Azure::Response<KeyVaultKey> RestoreKeyBackupFrom(
+        std::string const& fileName,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
     /**
      * @brief Imports an externally created ket, stores it, and returns jey parameters and
      * attributes to the client.
@@ -418,7 +452,8 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
     Azure::Core::Http::Request CreateRequest(
         Azure::Core::Http::HttpMethod method,
         std::vector<std::string> const& path = {},
-        Azure::Core::IO::BodyStream* content = nullptr) const;
+        Azure::Core::IO::BodyStream* content = nullptr,
+        bool shouldBufferResponse = true) const;
 
     Azure::Core::Http::Request ContinuationTokenRequest(
         std::vector<std::string> const& path,
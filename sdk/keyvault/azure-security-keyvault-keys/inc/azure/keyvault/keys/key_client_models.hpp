@@ -722,15 +722,17 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
         std::chrono::milliseconds period,
         Azure::Core::Context& context) override
     {
+      int32_t pollCount = 0;
       while (true)
       {
         // Poll will update the raw response.
+        ++pollCount;
         Poll(context);
         if (IsDone())
         {
           break;
         }
-        std::this_thread::sleep_for(period);
+        WaitBeforeNextPoll(period, pollCount, context);
       }
 
       return Azure::Response<Azure::Security::KeyVault::Keys::DeletedKey>(
@@ -821,15 +823,17 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
         std::chrono::milliseconds period,
         Azure::Core::Context& context) override
     {
+      int32_t pollCount = 0;
       while (true)
       {
         // Poll will update the raw response.
+        ++pollCount;
         Poll(context);
         if (IsDone())
         {
           break;
         }
-        std::this_thread::sleep_for(period);
+        WaitBeforeNextPoll(period, pollCount, context);
       }
 
       return Azure::Response<Azure::Security::KeyVault::Keys::KeyVaultKey>(
@@ -14,6 +14,8 @@
 #include "azure/keyvault/keys/dll_import_export.hpp"
 #include "azure/keyvault/keys/key_client_models.hpp"
 
+#include <chrono>
+
 namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
 
   /**
@@ -395,4 +397,18 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Keys {
     std::string const& Name() const { return Properties.Name; }
   };
 
+  /**
+   * @brief Define the options to create a #CachingKeyClient.
+   *
+   */
+  struct CachingKeyClientOptions final
+  {
+    /**
+     * @brief How long the latest version of a key is served from the cache before it is fetched
+     * again, to find out whether a new version was created.
+     *
+     */
+    std::chrono::milliseconds RevalidationInterval = std::chrono::minutes(5);
+  };
+
 }}}} // namespace Azure::Security::KeyVault::Keys
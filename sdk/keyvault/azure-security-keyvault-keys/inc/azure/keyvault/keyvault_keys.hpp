@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "azure/keyvault/keys/caching_key_client.hpp"
 #include "azure/keyvault/keys/cryptography/cryptography_client.hpp"
 #include "azure/keyvault/keys/cryptography/cryptography_client_models.hpp"
 #include "azure/keyvault/keys/cryptography/cryptography_client_options.hpp"
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @brief Keyvault Keys caching client definition.
+ *
+ */
+
+#include "azure/keyvault/keys/caching_key_client.hpp"
+
+#include "private/cryptography_internal_access.hpp"
+#include "private/local_cryptography_provider.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+using namespace Azure::Security::KeyVault::Keys;
+using Azure::Security::KeyVault::Keys::Cryptography::_detail::CryptoClientInternalAccess;
+using Azure::Security::KeyVault::Keys::Cryptography::_detail::LocalCryptographyCache;
+using Azure::Security::KeyVault::Keys::Cryptography::_detail::LocalCryptographyProvider;
+
+namespace {
+// Waits are split so that a cancelled context is noticed quickly.
+constexpr std::chrono::milliseconds MaxWaitDuration(100);
+
+// Whether a key fetched again is the one cached, the service doesn't return entity tags.
+bool IsSameKey(KeyVaultKey const& cached, KeyVaultKey const& fetched)
+{
+  return cached.Id() == fetched.Id()
+      && cached.Properties.UpdatedOn.HasValue() == fetched.Properties.UpdatedOn.HasValue()
+      && (!cached.Properties.UpdatedOn.HasValue()
+          || cached.Properties.UpdatedOn.Value() == fetched.Properties.UpdatedOn.Value());
+}
+} // namespace
+
+struct CachingKeyClient::State final
+{
+  State(KeyClient const& keyClient, CachingKeyClientOptions const& options)
+      : Client(keyClient), Options(options)
+  {
+  }
+
+  // The name and the version of a key, the version is empty for the latest one.
+  using KeyName = std::pair<std::string, std::string>;
+
+  struct Entry final
+  {
+    std::shared_ptr<const KeyVaultKey> Key;
+    std::chrono::steady_clock::time_point RevalidateOn;
+    // Only one request is sent for a key at a time.
+    bool Fetching = false;
+  };
+
+  KeyClient Client;
+  CachingKeyClientOptions Options;
+
+  std::mutex Mutex;
+  // Notified when a key is fetched or fails to be.
+  std::condition_variable Changed;
+  std::map<KeyName, Entry> Entries;
+  // The local cryptography of the versions of the keys, shared by the cryptography clients.
+  std::map<KeyName, std::shared_ptr<LocalCryptographyCache>> LocalCryptography;
+};
+
+CachingKeyClient::CachingKeyClient(
+    KeyClient const& keyClient,
+    CachingKeyClientOptions const& options)
+    : m_state(std::make_unique<State>(keyClient, options))
+{
+}
+
+CachingKeyClient::~CachingKeyClient() = default;
+
+std::shared_ptr<const KeyVaultKey> CachingKeyClient::GetKey(
+    std::string const& name,
+    GetKeyOptions const& options,
+    Azure::Core::Context const& context) const
+{
+  State& state = *m_state;
+  const State::KeyName keyName(name, options.Version);
+
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  while (true)
+  {
+    auto& entry = state.Entries[keyName];
+    if (entry.Key && std::chrono::steady_clock::now() < entry.RevalidateOn)
+    {
+      return entry.Key;
+    }
+    if (!entry.Fetching)
+    {
+      entry.Fetching = true;
+      break;
+    }
+    // The key being revalidated is served meanwhile.
+    if (entry.Key)
+    {
+      return entry.Key;
+    }
+    // The request in progress is awaited, a failed one is sent again by one of the callers.
+    context.ThrowIfCancelled();
+    state.Changed.wait_for(lock, MaxWaitDuration);
+  }
+  lock.unlock();
+
+  std::shared_ptr<const KeyVaultKey> key;
+  try
+  {
+    key = std::make_shared<const KeyVaultKey>(state.Client.GetKey(name, options, context).Value);
+  }
+  catch (...)
+  {
+    lock.lock();
+    auto entry = state.Entries.find(keyName);
+    if (entry != state.Entries.end())
+    {
+      entry->second.Fetching = false;
+    }
+    state.Changed.notify_all();
+    throw;
+  }
+  lock.lock();
+  auto entry = state.Entries.find(keyName);
+  // The key fetched isn't cached if it was invalidated meanwhile, it may be outdated.
+  if (entry != state.Entries.end())
+  {
+    entry->second.Fetching = false;
+    if (!entry->second.Key || !IsSameKey(*entry->second.Key, *key))
+    {
+      entry->second.Key = key;
+    }
+    if (keyName.second.empty())
+    {
+      entry->second.RevalidateOn
+          = std::chrono::steady_clock::now() + state.Options.RevalidationInterval;
+      // The latest version is also served to the callers requesting it by its version.
+      auto& versionEntry = state.Entries[State::KeyName(name, key->Properties.Version)];
+      if (!versionEntry.Key)
+      {
+        versionEntry.Key = entry->second.Key;
+        versionEntry.RevalidateOn = std::chrono::steady_clock::time_point::max();
+      }
+    }
+    else
+    {
+      // A version of a key never changes.
+      entry->second.RevalidateOn = std::chrono::steady_clock::time_point::max();
+    }
+    key = entry->second.Key;
+  }
+  state.Changed.notify_all();
+  return key;
+}
+
+Cryptography::CryptographyClient CachingKeyClient::GetCryptographyClient(
+    std::string const& name,
+    std::string const& version,
+    Azure::Core::Context const& context) const
+{
+  GetKeyOptions options;
+  options.Version = version;
+  auto key = GetKey(name, options, context);
+
+  State& state = *m_state;
+  auto client = state.Client.GetCryptographyClient(name, key->Properties.Version);
+  std::shared_ptr<LocalCryptographyCache> localCryptography;
+  {
+    std::lock_guard<std::mutex> guard(state.Mutex);
+    auto& cachedLocalCryptography
+        = state.LocalCryptography[State::KeyName(name, key->Properties.Version)];
+    if (!cachedLocalCryptography)
+    {
+      cachedLocalCryptography = std::make_shared<LocalCryptographyCache>();
+      cachedLocalCryptography->Provider = LocalCryptographyProvider::Create(*key);
+      cachedLocalCryptography->Fetched = true;
+    }
+    localCryptography = cachedLocalCryptography;
+  }
+  CryptoClientInternalAccess::SetLocalCryptography(client, std::move(localCryptography));
+  return client;
+}
+
+void CachingKeyClient::Invalidate(std::string const& name)
+{
+  std::lock_guard<std::mutex> guard(m_state->Mutex);
+  auto entry = m_state->Entries.lower_bound(State::KeyName(name, std::string()));
+  while (entry != m_state->Entries.end() && entry->first.first == name)
+  {
+    entry = m_state->Entries.erase(entry);
+  }
+  auto localCryptography
+      = m_state->LocalCryptography.lower_bound(State::KeyName(name, std::string()));
+  while (localCryptography != m_state->LocalCryptography.end()
+         && localCryptography->first.first == name)
+  {
+    localCryptography = m_state->LocalCryptography.erase(localCryptography);
+  }
+}
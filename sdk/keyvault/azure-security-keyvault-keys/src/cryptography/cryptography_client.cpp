@@ -18,11 +18,20 @@
 #include "../private/key_verify_parameters.hpp"
 #include "../private/key_wrap_parameters.hpp"
 #include "../private/keyvault_protocol.hpp"
+#include "../private/local_cryptography_provider.hpp"
 #include "../private/package_version.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 using namespace Azure::Security::KeyVault::Keys::Cryptography;
@@ -33,24 +42,93 @@ using namespace Azure::Core::Http::Policies;
 using namespace Azure::Core::Http::Policies::_internal;
 using namespace Azure::Core::Http::_internal;
 
+namespace Azure {
+  namespace Security {
+    namespace KeyVault {
+      namespace Keys {
+        namespace Cryptography {
+  namespace _detail {
+    // The URLs of the key and of its operations, with the API version, encoded once for a client
+    // and its copies instead of for every request.
+    struct CryptographyRequestUrls final
+    {
+      CryptographyRequestUrls(Azure::Core::Url const& keyId, std::string const& apiVersion)
+          : Key(CreateUrl(keyId, apiVersion, std::string())),
+            Encrypt(CreateUrl(keyId, apiVersion, EncryptValue)),
+            Decrypt(CreateUrl(keyId, apiVersion, DecryptValue)),
+            WrapKey(CreateUrl(keyId, apiVersion, WrapKeyValue)),
+            UnwrapKey(CreateUrl(keyId, apiVersion, UnwrapKeyValue)),
+            Sign(CreateUrl(keyId, apiVersion, SignValue)),
+            Verify(CreateUrl(keyId, apiVersion, VerifyValue))
+      {
+      }
+
+      Azure::Core::Url Key;
+      Azure::Core::Url Encrypt;
+      Azure::Core::Url Decrypt;
+      Azure::Core::Url WrapKey;
+      Azure::Core::Url UnwrapKey;
+      Azure::Core::Url Sign;
+      Azure::Core::Url Verify;
+
+    private:
+      static Azure::Core::Url CreateUrl(
+          Azure::Core::Url const& keyId,
+          std::string const& apiVersion,
+          std::string const& operation)
+      {
+        Azure::Core::Url url(keyId);
+        if (!operation.empty())
+        {
+          url.AppendPath(operation);
+        }
+        url.AppendQueryParameter(ApiVersionValue, apiVersion);
+        return url;
+      }
+    };
+}}}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography::_detail
+
 namespace {
-// 1Mb at a time
-const size_t DefaultStreamDigestReadSize = 1024 * 1024;
+// 4Mb at a time
+const size_t DefaultStreamDigestReadSize = 4 * 1024 * 1024;
 
+// Hashes a stream without loading it in memory. The next block is read by another thread while
+// the last one is hashed, so reading a file or a network stream and hashing it overlap.
 inline std::vector<uint8_t> CreateDigest(
     SignatureAlgorithm algorithm,
-    Azure::Core::IO::BodyStream& data)
+    Azure::Core::IO::BodyStream& data,
+    Azure::Core::Context const& context)
 {
-  // Use heap for the reading buffer.
-  auto heapBuffer = std::make_unique<std::vector<uint8_t>>(DefaultStreamDigestReadSize);
-  auto* buffer = heapBuffer.get()->data();
   auto hashAlgorithm = algorithm.GetHashAlgorithm();
-  for (size_t read = data.Read(buffer, DefaultStreamDigestReadSize); read > 0;
-       read = data.Read(buffer, DefaultStreamDigestReadSize))
+  // Use heap for the reading buffers.
+  std::vector<uint8_t> buffers[2]
+      = {std::vector<uint8_t>(DefaultStreamDigestReadSize),
+         std::vector<uint8_t>(DefaultStreamDigestReadSize)};
+  auto readBlock = [&](std::vector<uint8_t>& buffer) {
+    return data.ReadToCount(buffer.data(), buffer.size(), context);
+  };
+
+  size_t read = readBlock(buffers[0]);
+  // A stream shorter than a block is hashed without starting a thread.
+  for (size_t current = 0; read == DefaultStreamDigestReadSize; current ^= 1)
   {
-    hashAlgorithm->Append(buffer, read);
+    auto nextRead = std::async(std::launch::async, readBlock, std::ref(buffers[current ^ 1]));
+    try
+    {
+      hashAlgorithm->Append(buffers[current].data(), read);
+    }
+    catch (...)
+    {
+      nextRead.wait();
+      throw;
+    }
+    read = nextRead.get();
+    if (read != DefaultStreamDigestReadSize)
+    {
+      return hashAlgorithm->Final(buffers[current ^ 1].data(), read);
+    }
   }
-  return hashAlgorithm->Final();
+  return hashAlgorithm->Final(buffers[0].data(), read);
 }
 
 inline std::vector<uint8_t> CreateDigest(
@@ -61,19 +139,134 @@ inline std::vector<uint8_t> CreateDigest(
   return hashAlgorithm->Final(data.data(), data.size());
 }
 
-} // namespace
+// The raw response of an operation performed locally.
+inline std::unique_ptr<RawResponse> CreateLocalOperationResponse()
+{
+  return std::make_unique<RawResponse>(1, 1, HttpStatusCode::Ok, "OK");
+}
+
+// The number of times an operation of a batch throttled by the service is attempted again, once
+// the retries of the pipeline are exhausted.
+constexpr int32_t MaxThrottledRetries = 3;
+// Waits are split so that a cancelled context is noticed quickly.
+constexpr std::chrono::milliseconds MaxWaitDuration(100);
 
-Request CryptographyClient::CreateRequest(
-    HttpMethod method,
-    std::vector<std::string> const& path,
-    Azure::Core::IO::BodyStream* content) const
+// The delay requested by the service for a throttled request.
+std::chrono::milliseconds GetThrottlingDelay(RawResponse const* response)
 {
-  return Azure::Security::KeyVault::_detail::KeyVaultKeysCommonRequest::CreateRequest(
-      m_keyId, m_apiVersion, method, path, content);
+  if (response != nullptr)
+  {
+    auto const& headers = response->GetHeaders();
+    try
+    {
+      auto header = headers.find("retry-after-ms");
+      if (header != headers.end()
+          || (header = headers.find("x-ms-retry-after-ms")) != headers.end())
+      {
+        return std::chrono::milliseconds(std::stoi(header->second));
+      }
+      header = headers.find("retry-after");
+      if (header != headers.end())
+      {
+        return std::chrono::seconds(std::stoi(header->second));
+      }
+    }
+    catch (std::exception const&)
+    {
+      // The HTTP dates of the retry-after header aren't parsed, like in the retry policy.
+    }
+  }
+  return std::chrono::seconds(1);
 }
 
+// Runs the operations of a batch on the calling thread and up to Concurrency - 1 other threads.
+// A throttled operation pauses all of them for the delay requested by the service.
+template <class T, class Operation>
+std::vector<BatchOperationResult<T>> RunBatch(
+    size_t count,
+    CryptographyBatchOptions const& options,
+    Azure::Core::Context const& context,
+    Operation const& operation)
+{
+  std::vector<BatchOperationResult<T>> results(count);
+  std::mutex mutex;
+  size_t nextIndex = 0;
+  std::chrono::steady_clock::time_point pausedUntil;
+
+  auto runOperations = [&]() {
+    while (true)
+    {
+      size_t index = 0;
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (nextIndex == count)
+        {
+          return;
+        }
+        index = nextIndex++;
+      }
+      for (int32_t retry = 0;; ++retry)
+      {
+        try
+        {
+          while (true)
+          {
+            context.ThrowIfCancelled();
+            std::chrono::steady_clock::time_point resumeAt;
+            {
+              std::lock_guard<std::mutex> guard(mutex);
+              resumeAt = pausedUntil;
+            }
+            auto const now = std::chrono::steady_clock::now();
+            if (now >= resumeAt)
+            {
+              break;
+            }
+            std::this_thread::sleep_for(
+                std::min<std::chrono::steady_clock::duration>(resumeAt - now, MaxWaitDuration));
+          }
+          results[index].Value = operation(index).Value;
+        }
+        catch (Azure::Core::RequestFailedException const& e)
+        {
+          if (e.StatusCode == HttpStatusCode::TooManyRequests && retry < MaxThrottledRetries)
+          {
+            auto const resumeAt
+                = std::chrono::steady_clock::now() + GetThrottlingDelay(e.RawResponse.get());
+            std::lock_guard<std::mutex> guard(mutex);
+            pausedUntil = std::max(pausedUntil, resumeAt);
+            continue;
+          }
+          results[index].Error = std::current_exception();
+        }
+        catch (...)
+        {
+          results[index].Error = std::current_exception();
+        }
+        break;
+      }
+    }
+  };
+
+  size_t const threadCount
+      = std::min(count, static_cast<size_t>(std::max(options.Concurrency, int32_t(1))));
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < threadCount; ++i)
+  {
+    threads.emplace_back(runOperations);
+  }
+  runOperations();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  return results;
+}
+
+} // namespace
+
 std::unique_ptr<Azure::Core::Http::RawResponse> CryptographyClient::SendCryptoRequest(
-    std::vector<std::string> const& path,
+    Azure::Core::Url const& url,
     std::string const& payload,
     Azure::Core::Context const& context) const
 {
@@ -82,7 +275,7 @@ std::unique_ptr<Azure::Core::Http::RawResponse> CryptographyClient::SendCryptoRe
       reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
 
   // Request and settings
-  auto request = CreateRequest(HttpMethod::Post, path, &payloadStream);
+  Request request(HttpMethod::Post, url, &payloadStream);
   request.SetHeader(HttpShared::ContentType, HttpShared::ApplicationJson);
   request.SetHeader(HttpShared::Accept, HttpShared::ApplicationJson);
 
@@ -91,14 +284,56 @@ std::unique_ptr<Azure::Core::Http::RawResponse> CryptographyClient::SendCryptoRe
       *m_pipeline, request, context);
 }
 
+LocalCryptographyProvider const* CryptographyClient::GetLocalCryptographyProvider(
+    Azure::Core::Context const& context)
+{
+  if (!m_localCryptography)
+  {
+    return nullptr;
+  }
+  // The concurrent operations wait for the key fetched by the first one.
+  std::lock_guard<std::mutex> guard(m_localCryptography->Mutex);
+  if (!m_localCryptography->Fetched)
+  {
+    try
+    {
+      Request request(HttpMethod::Get, m_requestUrls->Key);
+      auto rawResponse = Azure::Security::KeyVault::_detail::KeyVaultKeysCommonRequest::SendRequest(
+          *m_pipeline, request, context);
+      m_localCryptography->Provider = LocalCryptographyProvider::Create(
+          KeyVaultKeySerializer::KeyVaultKeyDeserialize(*rawResponse));
+    }
+    catch (Azure::Core::RequestFailedException const&)
+    {
+      // Without the permission to get the key, the operations are all performed by the service.
+    }
+    m_localCryptography->Fetched = true;
+  }
+  return m_localCryptography->Provider.get();
+}
+
 CryptographyClient::~CryptographyClient() = default;
 
+CryptographyClient::CryptographyClient(
+    Azure::Core::Url keyId,
+    std::string const& apiVersion,
+    std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline)
+    : m_keyId(std::move(keyId)), m_apiVersion(apiVersion), m_pipeline(std::move(pipeline)),
+      m_requestUrls(std::make_shared<CryptographyRequestUrls>(m_keyId, m_apiVersion))
+{
+}
+
 CryptographyClient::CryptographyClient(
     std::string const& keyId,
     std::shared_ptr<Core::Credentials::TokenCredential const> credential,
     CryptographyClientOptions const& options)
-    : m_keyId(Azure::Core::Url(keyId)), m_apiVersion(options.Version.ToString())
+    : m_keyId(Azure::Core::Url(keyId)), m_apiVersion(options.Version.ToString()),
+      m_requestUrls(std::make_shared<CryptographyRequestUrls>(m_keyId, m_apiVersion))
 {
+  if (options.LocalPublicKeyOperations)
+  {
+    m_localCryptography = std::make_shared<LocalCryptographyCache>();
+  }
   std::vector<std::unique_ptr<HttpPolicy>> perRetrypolicies;
   {
     Azure::Core::Credentials::TokenRequestContext const tokenContext
@@ -121,9 +356,24 @@ Azure::Response<EncryptResult> CryptographyClient::Encrypt(
     EncryptParameters const& parameters,
     Azure::Core::Context const& context)
 {
+  auto const* localProvider = GetLocalCryptographyProvider(context);
+  if (localProvider != nullptr
+      && localProvider->SupportsEncrypt(
+          parameters.Algorithm.ToString(), Azure::Security::KeyVault::Keys::KeyOperation::Encrypt))
+  {
+    EncryptResult value;
+    value.KeyId = localProvider->KeyId();
+    value.Ciphertext
+        = localProvider->Encrypt(parameters.Algorithm.ToString(), parameters.Plaintext);
+    value.Algorithm = parameters.Algorithm;
+    return Azure::Response<EncryptResult>(std::move(value), CreateLocalOperationResponse());
+  }
+
   // Send and parse respone
   auto rawResponse = SendCryptoRequest(
-      {EncryptValue}, EncryptParametersSerializer::EncryptParametersSerialize(parameters), context);
+      m_requestUrls->Encrypt,
+      EncryptParametersSerializer::EncryptParametersSerialize(parameters),
+      context);
   auto value = EncryptResultSerializer::EncryptResultDeserialize(*rawResponse);
   value.Algorithm = parameters.Algorithm;
   return Azure::Response<EncryptResult>(std::move(value), std::move(rawResponse));
@@ -135,7 +385,9 @@ Azure::Response<DecryptResult> CryptographyClient::Decrypt(
 {
   // Send and parse respone
   auto rawResponse = SendCryptoRequest(
-      {DecryptValue}, DecryptParametersSerializer::DecryptParametersSerialize(parameters), context);
+      m_requestUrls->Decrypt,
+      DecryptParametersSerializer::DecryptParametersSerialize(parameters),
+      context);
   auto value = DecryptResultSerializer::DecryptResultDeserialize(*rawResponse);
   value.Algorithm = parameters.Algorithm;
   return Azure::Response<DecryptResult>(std::move(value), std::move(rawResponse));
@@ -146,9 +398,21 @@ Azure::Response<WrapResult> CryptographyClient::WrapKey(
     std::vector<uint8_t> const& key,
     Azure::Core::Context const& context)
 {
+  auto const* localProvider = GetLocalCryptographyProvider(context);
+  if (localProvider != nullptr
+      && localProvider->SupportsEncrypt(
+          algorithm.ToString(), Azure::Security::KeyVault::Keys::KeyOperation::WrapKey))
+  {
+    WrapResult value;
+    value.KeyId = localProvider->KeyId();
+    value.EncryptedKey = localProvider->Encrypt(algorithm.ToString(), key);
+    value.Algorithm = algorithm;
+    return Azure::Response<WrapResult>(std::move(value), CreateLocalOperationResponse());
+  }
+
   // Send and parse respone
   auto rawResponse = SendCryptoRequest(
-      {WrapKeyValue},
+      m_requestUrls->WrapKey,
       KeyWrapParametersSerializer::KeyWrapParametersSerialize(
           KeyWrapParameters(algorithm.ToString(), key)),
       context);
@@ -164,7 +428,7 @@ Azure::Response<UnwrapResult> CryptographyClient::UnwrapKey(
 {
   // Send and parse respone
   auto rawResponse = SendCryptoRequest(
-      {UnwrapKeyValue},
+      m_requestUrls->UnwrapKey,
       KeyWrapParametersSerializer::KeyWrapParametersSerialize(
           KeyWrapParameters(algorithm.ToString(), encryptedKey)),
       context);
@@ -173,6 +437,17 @@ Azure::Response<UnwrapResult> CryptographyClient::UnwrapKey(
   return Azure::Response<UnwrapResult>(std::move(value), std::move(rawResponse));
 }
 
+std::vector<BatchOperationResult<UnwrapResult>> CryptographyClient::UnwrapKeys(
+    KeyWrapAlgorithm algorithm,
+    std::vector<std::vector<uint8_t>> const& encryptedKeys,
+    CryptographyBatchOptions const& options,
+    Azure::Core::Context const& context)
+{
+  return RunBatch<UnwrapResult>(encryptedKeys.size(), options, context, [&](size_t index) {
+    return UnwrapKey(algorithm, encryptedKeys[index], context);
+  });
+}
+
 Azure::Response<SignResult> CryptographyClient::Sign(
     SignatureAlgorithm algorithm,
     std::vector<uint8_t> const& digest,
@@ -180,7 +455,7 @@ Azure::Response<SignResult> CryptographyClient::Sign(
 {
   // Send and parse respone
   auto rawResponse = SendCryptoRequest(
-      {SignValue},
+      m_requestUrls->Sign,
       KeySignParametersSerializer::KeySignParametersSerialize(
           KeySignParameters(algorithm.ToString(), digest)),
       context);
@@ -189,12 +464,23 @@ Azure::Response<SignResult> CryptographyClient::Sign(
   return Azure::Response<SignResult>(std::move(value), std::move(rawResponse));
 }
 
+std::vector<BatchOperationResult<SignResult>> CryptographyClient::SignMany(
+    SignatureAlgorithm algorithm,
+    std::vector<std::vector<uint8_t>> const& digests,
+    CryptographyBatchOptions const& options,
+    Azure::Core::Context const& context)
+{
+  return RunBatch<SignResult>(digests.size(), options, context, [&](size_t index) {
+    return Sign(algorithm, digests[index], context);
+  });
+}
+
 Azure::Response<SignResult> CryptographyClient::SignData(
     SignatureAlgorithm algorithm,
     Azure::Core::IO::BodyStream& data,
     Azure::Core::Context const& context)
 {
-  return Sign(algorithm, CreateDigest(algorithm, data), context);
+  return Sign(algorithm, CreateDigest(algorithm, data, context), context);
 }
 
 Azure::Response<SignResult> CryptographyClient::SignData(
@@ -211,9 +497,19 @@ Azure::Response<VerifyResult> CryptographyClient::Verify(
     std::vector<uint8_t> const& signature,
     Azure::Core::Context const& context)
 {
+  auto const* localProvider = GetLocalCryptographyProvider(context);
+  if (localProvider != nullptr && localProvider->SupportsVerify(algorithm, digest.size()))
+  {
+    VerifyResult value;
+    value.IsValid = localProvider->Verify(algorithm, digest, signature);
+    value.Algorithm = algorithm;
+    value.KeyId = this->m_keyId.GetAbsoluteUrl();
+    return Azure::Response<VerifyResult>(std::move(value), CreateLocalOperationResponse());
+  }
+
   // Send and parse respone
   auto rawResponse = SendCryptoRequest(
-      {VerifyValue},
+      m_requestUrls->Verify,
       KeyVerifyParametersSerializer::KeyVerifyParametersSerialize(
           KeyVerifyParameters(algorithm.ToString(), digest, signature)),
       context);
@@ -223,13 +519,29 @@ Azure::Response<VerifyResult> CryptographyClient::Verify(
   return Azure::Response<VerifyResult>(std::move(value), std::move(rawResponse));
 }
 
+std::vector<BatchOperationResult<VerifyResult>> CryptographyClient::VerifyMany(
+    SignatureAlgorithm algorithm,
+    std::vector<std::vector<uint8_t>> const& digests,
+    std::vector<std::vector<uint8_t>> const& signatures,
+    CryptographyBatchOptions const& options,
+    Azure::Core::Context const& context)
+{
+  if (signatures.size() != digests.size())
+  {
+    throw std::invalid_argument("There must be a signature for every digest.");
+  }
+  return RunBatch<VerifyResult>(digests.size(), options, context, [&](size_t index) {
+    return Verify(algorithm, digests[index], signatures[index], context);
+  });
+}
+
 Azure::Response<VerifyResult> CryptographyClient::VerifyData(
     SignatureAlgorithm algorithm,
     Azure::Core::IO::BodyStream& data,
     std::vector<uint8_t> const& signature,
     Azure::Core::Context const& context)
 {
-  return Verify(algorithm, CreateDigest(algorithm, data), signature, context);
+  return Verify(algorithm, CreateDigest(algorithm, data, context), signature, context);
 }
 
 Azure::Response<VerifyResult> CryptographyClient::VerifyData(
@@ -240,3 +552,22 @@ Azure::Response<VerifyResult> CryptographyClient::VerifyData(
 {
   return Verify(algorithm, CreateDigest(algorithm, data), signature, context);
 }
+
+Azure::Response<SignResult> CryptographyClient::SignFile(
+    SignatureAlgorithm algorithm,
+    std::string const& fileName,
+    Azure::Core::Context const& context)
+{
+  Azure::Core::IO::FileBodyStream data(fileName);
+  return SignData(algorithm, data, context);
+}
+
+Azure::Response<VerifyResult> CryptographyClient::VerifyFile(
+    SignatureAlgorithm algorithm,
+    std::string const& fileName,
+    std::vector<uint8_t> const& signature,
+    Azure::Core::Context const& context)
+{
+  Azure::Core::IO::FileBodyStream data(fileName);
+  return VerifyData(algorithm, data, signature, context);
+}
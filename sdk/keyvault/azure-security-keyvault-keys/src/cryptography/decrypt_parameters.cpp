@@ -19,30 +19,36 @@ namespace Azure {
   std::string _detail::DecryptParametersSerializer::DecryptParametersSerialize(
       DecryptParameters const& parameters)
   {
-    Azure::Core::Json::_internal::json payload;
-
     using namespace Azure::Security::KeyVault::Keys::_detail;
-    using namespace Azure::Core::_internal;
-    payload[AlgorithmValue] = parameters.Algorithm.ToString();
-    payload[ValueParameterValue] = Base64Url::Base64UrlEncode(parameters.Ciphertext);
+    using Azure::Security::KeyVault::_internal::FlatJsonWriter;
+    auto const algorithm = parameters.Algorithm.ToString();
     auto& iv = parameters.GetIv();
 
+    FlatJsonWriter payload(
+        FlatJsonWriter::StringPropertyLength(AlgorithmValue, algorithm)
+        + FlatJsonWriter::Base64UrlPropertyLength(ValueParameterValue, parameters.Ciphertext)
+        + FlatJsonWriter::Base64UrlPropertyLength(IvValue, iv)
+        + FlatJsonWriter::Base64UrlPropertyLength(
+            AdditionalAuthenticatedValue, parameters.AdditionalAuthenticatedData)
+        + FlatJsonWriter::Base64UrlPropertyLength(TagsPropertyName, parameters.AuthenticationTag));
+    payload.WriteString(AlgorithmValue, algorithm);
+    payload.WriteBase64Url(ValueParameterValue, parameters.Ciphertext);
+
     if (iv.size() > 0)
     {
-      payload[IvValue] = Base64Url::Base64UrlEncode(iv);
+      payload.WriteBase64Url(IvValue, iv);
     }
 
     if (parameters.AdditionalAuthenticatedData.size() > 0)
     {
-      payload[AdditionalAuthenticatedValue]
-          = Base64Url::Base64UrlEncode(parameters.AdditionalAuthenticatedData);
+      payload.WriteBase64Url(AdditionalAuthenticatedValue, parameters.AdditionalAuthenticatedData);
     }
 
     if (parameters.AuthenticationTag.size() > 0)
     {
-      payload[TagsPropertyName] = Base64Url::Base64UrlEncode(parameters.AuthenticationTag);
+      payload.WriteBase64Url(TagsPropertyName, parameters.AuthenticationTag);
     }
 
-    return payload.dump();
+    return payload.Finish();
   }
 }}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography
@@ -1,9 +1,6 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
-#include <azure/core/base64.hpp>
-#include <azure/core/internal/json/json.hpp>
-
 #include "../private/cryptography_serializers.hpp"
 #include "../private/key_constants.hpp"
 #include "azure/keyvault/keys/cryptography/cryptography_client_models.hpp"
@@ -11,9 +8,7 @@
 #include <string>
 #include <vector>
 
-using namespace Azure::Core::_internal;
-using namespace Azure::Core::Json::_internal;
-using namespace Azure::Security::KeyVault::Keys::_detail;
+using Azure::Security::KeyVault::_internal::FlatJsonReader;
 
 namespace Azure {
   namespace Security {
@@ -24,13 +19,11 @@ namespace Azure {
   DecryptResult _detail::DecryptResultSerializer::DecryptResultDeserialize(
       Azure::Core::Http::RawResponse const& rawResponse)
   {
-    auto const& body = rawResponse.GetBody();
-    auto jsonParser = json::parse(body);
+    FlatJsonReader const jsonReader(rawResponse.GetBody());
 
     DecryptResult result;
-    result.KeyId = jsonParser[KeyIdPropertyName].get<std::string>();
-    result.Plaintext
-        = Base64Url::Base64UrlDecode(jsonParser[ValueParameterValue].get<std::string>());
+    result.KeyId = jsonReader.GetString(KeyIdKey);
+    result.Plaintext = jsonReader.GetBase64Url(ValueKey);
 
     return result;
   }
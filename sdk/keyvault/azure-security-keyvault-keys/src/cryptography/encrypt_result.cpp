@@ -1,9 +1,6 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
-#include <azure/core/base64.hpp>
-#include <azure/core/internal/json/json.hpp>
-
 #include "../private/cryptography_serializers.hpp"
 #include "../private/key_constants.hpp"
 #include "azure/keyvault/keys/cryptography/cryptography_client_models.hpp"
@@ -11,9 +8,7 @@
 #include <string>
 #include <vector>
 
-using namespace Azure::Core::_internal;
-using namespace Azure::Core::Json::_internal;
-using namespace Azure::Security::KeyVault::Keys::_detail;
+using Azure::Security::KeyVault::_internal::FlatJsonReader;
 
 namespace Azure {
   namespace Security {
@@ -24,31 +19,25 @@ namespace Azure {
   EncryptResult _detail::EncryptResultSerializer::EncryptResultDeserialize(
       Azure::Core::Http::RawResponse const& rawResponse)
   {
-    auto const& body = rawResponse.GetBody();
-    auto jsonParser = json::parse(body);
+    FlatJsonReader const jsonReader(rawResponse.GetBody());
 
     EncryptResult result;
-    result.KeyId = jsonParser[KeyIdPropertyName].get<std::string>();
-    result.Ciphertext
-        = Base64Url::Base64UrlDecode(jsonParser[ValueParameterValue].get<std::string>());
+    result.KeyId = jsonReader.GetString(KeyIdKey);
+    result.Ciphertext = jsonReader.GetBase64Url(ValueKey);
 
-    if (jsonParser.contains(IvValue) && !jsonParser[IvValue].is_null())
+    if (jsonReader.Contains(IvKey))
     {
-      result.Iv = Base64Url::Base64UrlDecode(jsonParser[IvValue].get<std::string>());
+      result.Iv = jsonReader.GetBase64Url(IvKey);
     }
 
-    if (jsonParser.contains(AdditionalAuthenticatedValue)
-        && !jsonParser[AdditionalAuthenticatedValue].is_null())
+    if (jsonReader.Contains(AdditionalAuthenticatedKey))
     {
-      result.AdditionalAuthenticatedData
-          = Base64Url::Base64UrlDecode(jsonParser[AdditionalAuthenticatedValue].get<std::string>());
+      result.AdditionalAuthenticatedData = jsonReader.GetBase64Url(AdditionalAuthenticatedKey);
     }
 
-    if (jsonParser.contains(AuthenticationTagValue)
-        && !jsonParser[AuthenticationTagValue].is_null())
+    if (jsonReader.Contains(AuthenticationTagKey))
     {
-      result.AuthenticationTag
-          = Base64Url::Base64UrlDecode(jsonParser[AuthenticationTagValue].get<std::string>());
+      result.AuthenticationTag = jsonReader.GetBase64Url(AuthenticationTagKey);
     }
 
     return result;
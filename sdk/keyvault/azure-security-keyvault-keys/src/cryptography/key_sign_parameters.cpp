@@ -20,13 +20,14 @@ namespace Azure {
     std::string KeySignParametersSerializer::KeySignParametersSerialize(
         KeySignParameters const& parameters)
     {
-      Azure::Core::Json::_internal::json payload;
-
       using namespace Azure::Security::KeyVault::Keys::_detail;
-      using namespace Azure::Core::_internal;
-      payload[AlgorithmValue] = parameters.Algorithm;
-      payload[ValueParameterValue] = Base64Url::Base64UrlEncode(parameters.Digest);
+      using Azure::Security::KeyVault::_internal::FlatJsonWriter;
+      FlatJsonWriter payload(
+          FlatJsonWriter::StringPropertyLength(AlgorithmValue, parameters.Algorithm)
+          + FlatJsonWriter::Base64UrlPropertyLength(ValueParameterValue, parameters.Digest));
+      payload.WriteString(AlgorithmValue, parameters.Algorithm);
+      payload.WriteBase64Url(ValueParameterValue, parameters.Digest);
 
-      return payload.dump();
+      return payload.Finish();
     }
 }}}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography::_detail
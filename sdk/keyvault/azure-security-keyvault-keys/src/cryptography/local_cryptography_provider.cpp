@@ -0,0 +1,417 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/datetime.hpp>
+#include <azure/core/platform.hpp>
+
+#if defined(AZ_PLATFORM_POSIX)
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+#endif
+
+#include "../private/key_constants.hpp"
+#include "../private/local_cryptography_provider.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Azure {
+  namespace Security {
+    namespace KeyVault {
+      namespace Keys {
+        namespace Cryptography {
+  namespace _detail {
+
+    namespace {
+      // The size of the digests signed with an algorithm, 0 for an unknown algorithm.
+      size_t GetDigestSize(SignatureAlgorithm const& algorithm)
+      {
+        if (algorithm == SignatureAlgorithm::RS256 || algorithm == SignatureAlgorithm::PS256
+            || algorithm == SignatureAlgorithm::ES256 || algorithm == SignatureAlgorithm::ES256K)
+        {
+          return 32;
+        }
+        if (algorithm == SignatureAlgorithm::RS384 || algorithm == SignatureAlgorithm::PS384
+            || algorithm == SignatureAlgorithm::ES384)
+        {
+          return 48;
+        }
+        if (algorithm == SignatureAlgorithm::RS512 || algorithm == SignatureAlgorithm::PS512
+            || algorithm == SignatureAlgorithm::ES512)
+        {
+          return 64;
+        }
+        return 0;
+      }
+
+      bool IsRsaKey(JsonWebKey const& key)
+      {
+        return key.KeyType == KeyVaultKeyType::Rsa || key.KeyType == KeyVaultKeyType::RsaHsm;
+      }
+
+      bool IsEcKey(JsonWebKey const& key)
+      {
+        return key.KeyType == KeyVaultKeyType::Ec || key.KeyType == KeyVaultKeyType::EcHsm;
+      }
+
+#if defined(AZ_PLATFORM_POSIX)
+      // The public keys are decoded by OpenSSL from their DER encoded SubjectPublicKeyInfo, which
+      // is built here from the parameters of the JsonWebKey.
+      constexpr uint8_t DerInteger = 0x02;
+      constexpr uint8_t DerBitString = 0x03;
+      constexpr uint8_t DerNull = 0x05;
+      constexpr uint8_t DerObjectIdentifier = 0x06;
+      constexpr uint8_t DerSequence = 0x30;
+
+      const std::vector<uint8_t> RsaEncryptionOid{
+          0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x01};
+      const std::vector<uint8_t> EcPublicKeyOid{0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01};
+      const std::vector<uint8_t> P256Oid{0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07};
+      const std::vector<uint8_t> P256KOid{0x2B, 0x81, 0x04, 0x00, 0x0A};
+      const std::vector<uint8_t> P384Oid{0x2B, 0x81, 0x04, 0x00, 0x22};
+      const std::vector<uint8_t> P521Oid{0x2B, 0x81, 0x04, 0x00, 0x23};
+
+      void AppendDerElement(
+          std::vector<uint8_t>& der,
+          uint8_t tag,
+          std::vector<uint8_t> const& content)
+      {
+        der.push_back(tag);
+        if (content.size() < 0x80)
+        {
+          der.push_back(static_cast<uint8_t>(content.size()));
+        }
+        else
+        {
+          std::vector<uint8_t> lengthBytes;
+          for (size_t length = content.size(); length > 0; length >>= 8)
+          {
+            lengthBytes.insert(lengthBytes.begin(), static_cast<uint8_t>(length & 0xFF));
+          }
+          der.push_back(static_cast<uint8_t>(0x80 | lengthBytes.size()));
+          der.insert(der.end(), lengthBytes.begin(), lengthBytes.end());
+        }
+        der.insert(der.end(), content.begin(), content.end());
+      }
+
+      // Appends an unsigned big-endian integer.
+      void AppendDerInteger(std::vector<uint8_t>& der, uint8_t const* bytes, size_t size)
+      {
+        while (size > 1 && bytes[0] == 0)
+        {
+          ++bytes;
+          --size;
+        }
+        std::vector<uint8_t> content;
+        if (size == 0 || (bytes[0] & 0x80) != 0)
+        {
+          content.push_back(0);
+        }
+        content.insert(content.end(), bytes, bytes + size);
+        AppendDerElement(der, DerInteger, content);
+      }
+
+      std::vector<uint8_t> EncodePublicKeyInfo(
+          std::vector<uint8_t> const& algorithmIdentifier,
+          std::vector<uint8_t> const& publicKey)
+      {
+        std::vector<uint8_t> algorithm;
+        AppendDerElement(algorithm, DerSequence, algorithmIdentifier);
+        std::vector<uint8_t> bitString{0};
+        bitString.insert(bitString.end(), publicKey.begin(), publicKey.end());
+        AppendDerElement(algorithm, DerBitString, bitString);
+        std::vector<uint8_t> publicKeyInfo;
+        AppendDerElement(publicKeyInfo, DerSequence, algorithm);
+        return publicKeyInfo;
+      }
+
+      std::vector<uint8_t> EncodeRsaPublicKeyInfo(JsonWebKey const& key)
+      {
+        std::vector<uint8_t> algorithmIdentifier;
+        AppendDerElement(algorithmIdentifier, DerObjectIdentifier, RsaEncryptionOid);
+        AppendDerElement(algorithmIdentifier, DerNull, {});
+        std::vector<uint8_t> integers;
+        AppendDerInteger(integers, key.N.data(), key.N.size());
+        AppendDerInteger(integers, key.E.data(), key.E.size());
+        std::vector<uint8_t> rsaPublicKey;
+        AppendDerElement(rsaPublicKey, DerSequence, integers);
+        return EncodePublicKeyInfo(algorithmIdentifier, rsaPublicKey);
+      }
+
+      // Returns an empty vector for an unknown curve.
+      std::vector<uint8_t> EncodeEcPublicKeyInfo(JsonWebKey const& key, size_t& coordinateSize)
+      {
+        std::vector<uint8_t> const* curveOid = nullptr;
+        if (!key.CurveName.HasValue())
+        {
+          return {};
+        }
+        if (key.CurveName.Value() == KeyCurveName::P256)
+        {
+          curveOid = &P256Oid;
+          coordinateSize = 32;
+        }
+        else if (key.CurveName.Value() == KeyCurveName::P256K)
+        {
+          curveOid = &P256KOid;
+          coordinateSize = 32;
+        }
+        else if (key.CurveName.Value() == KeyCurveName::P384)
+        {
+          curveOid = &P384Oid;
+          coordinateSize = 48;
+        }
+        else if (key.CurveName.Value() == KeyCurveName::P521)
+        {
+          curveOid = &P521Oid;
+          coordinateSize = 66;
+        }
+        if (curveOid == nullptr || key.X.size() > coordinateSize || key.Y.size() > coordinateSize)
+        {
+          return {};
+        }
+        std::vector<uint8_t> algorithmIdentifier;
+        AppendDerElement(algorithmIdentifier, DerObjectIdentifier, EcPublicKeyOid);
+        AppendDerElement(algorithmIdentifier, DerObjectIdentifier, *curveOid);
+        // The uncompressed point, with its coordinates padded to the size of the curve.
+        std::vector<uint8_t> point{0x04};
+        point.insert(point.end(), coordinateSize - key.X.size(), 0);
+        point.insert(point.end(), key.X.begin(), key.X.end());
+        point.insert(point.end(), coordinateSize - key.Y.size(), 0);
+        point.insert(point.end(), key.Y.begin(), key.Y.end());
+        return EncodePublicKeyInfo(algorithmIdentifier, point);
+      }
+
+      EVP_MD const* GetDigestAlgorithm(SignatureAlgorithm const& algorithm)
+      {
+        switch (GetDigestSize(algorithm))
+        {
+          case 32:
+            return EVP_sha256();
+          case 48:
+            return EVP_sha384();
+          default:
+            return EVP_sha512();
+        }
+      }
+
+      using PublicKeyContext = std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)>;
+#endif
+    } // namespace
+
+#if defined(AZ_PLATFORM_POSIX)
+    struct LocalCryptographyProvider::PublicKey final
+    {
+      explicit PublicKey(EVP_PKEY* key, size_t coordinateSize)
+          : Key(key), CoordinateSize(coordinateSize)
+      {
+      }
+      ~PublicKey() { EVP_PKEY_free(Key); }
+
+      EVP_PKEY* Key;
+      // The size of a coordinate of the curve of an EC key, 0 for an RSA key.
+      size_t CoordinateSize;
+    };
+#else
+    struct LocalCryptographyProvider::PublicKey final
+    {
+    };
+#endif
+
+    LocalCryptographyProvider::LocalCryptographyProvider(
+        KeyVaultKey const& key,
+        std::unique_ptr<PublicKey> publicKey)
+        : m_key(key), m_publicKey(std::move(publicKey))
+    {
+    }
+
+    LocalCryptographyProvider::~LocalCryptographyProvider() = default;
+
+    std::unique_ptr<LocalCryptographyProvider> LocalCryptographyProvider::Create(
+        KeyVaultKey const& key)
+    {
+#if defined(AZ_PLATFORM_POSIX)
+      std::vector<uint8_t> publicKeyInfo;
+      size_t coordinateSize = 0;
+      if (IsRsaKey(key.Key) && !key.Key.N.empty() && !key.Key.E.empty())
+      {
+        publicKeyInfo = EncodeRsaPublicKeyInfo(key.Key);
+      }
+      else if (IsEcKey(key.Key))
+      {
+        publicKeyInfo = EncodeEcPublicKeyInfo(key.Key, coordinateSize);
+      }
+      if (publicKeyInfo.empty())
+      {
+        return nullptr;
+      }
+      unsigned char const* data = publicKeyInfo.data();
+      EVP_PKEY* evpKey = d2i_PUBKEY(nullptr, &data, static_cast<long>(publicKeyInfo.size()));
+      if (evpKey == nullptr)
+      {
+        return nullptr;
+      }
+      auto publicKey = std::make_unique<PublicKey>(evpKey, coordinateSize);
+      return std::unique_ptr<LocalCryptographyProvider>(
+          new LocalCryptographyProvider(key, std::move(publicKey)));
+#else
+      // The local operations are only implemented with OpenSSL.
+      (void)key;
+      return nullptr;
+#endif
+    }
+
+    bool LocalCryptographyProvider::SupportsEncrypt(
+        std::string const& algorithm,
+        KeyOperation const& operation) const
+    {
+      if (!IsRsaKey(m_key.Key) || !m_key.Key.SupportsOperation(operation)
+          || (algorithm != Keys::_detail::Rsa15Value && algorithm != Keys::_detail::RsaOaepValue
+              && algorithm != Keys::_detail::RsaOaep256Value))
+      {
+        return false;
+      }
+      // The service reports the keys disabled or used out of their validity period.
+      auto const now = Azure::DateTime::clock::now();
+      KeyProperties const& properties = m_key.Properties;
+      return !(properties.Enabled.HasValue() && !properties.Enabled.Value())
+          && !(properties.NotBefore.HasValue() && now < properties.NotBefore.Value())
+          && !(properties.ExpiresOn.HasValue() && properties.ExpiresOn.Value() <= now);
+    }
+
+    bool LocalCryptographyProvider::SupportsVerify(
+        SignatureAlgorithm const& algorithm,
+        size_t digestSize) const
+    {
+      if (!m_key.Key.SupportsOperation(KeyOperation::Verify)
+          || digestSize != GetDigestSize(algorithm))
+      {
+        return false;
+      }
+      if (IsRsaKey(m_key.Key))
+      {
+        return algorithm.ToString()[0] == 'R' || algorithm.ToString()[0] == 'P';
+      }
+      if (!IsEcKey(m_key.Key) || !m_key.Key.CurveName.HasValue())
+      {
+        return false;
+      }
+      auto const& curveName = m_key.Key.CurveName.Value();
+      return (algorithm == SignatureAlgorithm::ES256 && curveName == KeyCurveName::P256)
+          || (algorithm == SignatureAlgorithm::ES256K && curveName == KeyCurveName::P256K)
+          || (algorithm == SignatureAlgorithm::ES384 && curveName == KeyCurveName::P384)
+          || (algorithm == SignatureAlgorithm::ES512 && curveName == KeyCurveName::P521);
+    }
+
+#if defined(AZ_PLATFORM_POSIX)
+    std::vector<uint8_t> LocalCryptographyProvider::Encrypt(
+        std::string const& algorithm,
+        std::vector<uint8_t> const& plaintext) const
+    {
+      PublicKeyContext context(EVP_PKEY_CTX_new(m_publicKey->Key, nullptr), EVP_PKEY_CTX_free);
+      if (!context || EVP_PKEY_encrypt_init(context.get()) != 1)
+      {
+        throw std::runtime_error("Crypto error while initializing the encryption.");
+      }
+      if (algorithm == Keys::_detail::Rsa15Value)
+      {
+        if (EVP_PKEY_CTX_set_rsa_padding(context.get(), RSA_PKCS1_PADDING) != 1)
+        {
+          throw std::runtime_error("Crypto error while setting the encryption padding.");
+        }
+      }
+      else
+      {
+        EVP_MD const* digestAlgorithm
+            = algorithm == Keys::_detail::RsaOaep256Value ? EVP_sha256() : EVP_sha1();
+        if (EVP_PKEY_CTX_set_rsa_padding(context.get(), RSA_PKCS1_OAEP_PADDING) != 1
+            || EVP_PKEY_CTX_set_rsa_oaep_md(context.get(), digestAlgorithm) != 1
+            || EVP_PKEY_CTX_set_rsa_mgf1_md(context.get(), digestAlgorithm) != 1)
+        {
+          throw std::runtime_error("Crypto error while setting the encryption padding.");
+        }
+      }
+      size_t size = 0;
+      if (EVP_PKEY_encrypt(context.get(), nullptr, &size, plaintext.data(), plaintext.size()) != 1)
+      {
+        throw std::runtime_error("Crypto error while encrypting.");
+      }
+      std::vector<uint8_t> ciphertext(size);
+      if (EVP_PKEY_encrypt(
+              context.get(), ciphertext.data(), &size, plaintext.data(), plaintext.size())
+          != 1)
+      {
+        throw std::runtime_error("Crypto error while encrypting, the plaintext may be too long.");
+      }
+      ciphertext.resize(size);
+      return ciphertext;
+    }
+
+    bool LocalCryptographyProvider::Verify(
+        SignatureAlgorithm const& algorithm,
+        std::vector<uint8_t> const& digest,
+        std::vector<uint8_t> const& signature) const
+    {
+      PublicKeyContext context(EVP_PKEY_CTX_new(m_publicKey->Key, nullptr), EVP_PKEY_CTX_free);
+      if (!context || EVP_PKEY_verify_init(context.get()) != 1)
+      {
+        throw std::runtime_error("Crypto error while initializing the verification.");
+      }
+      std::vector<uint8_t> derSignature;
+      if (m_publicKey->CoordinateSize == 0)
+      {
+        const bool pss = algorithm.ToString()[0] == 'P';
+        if (EVP_PKEY_CTX_set_rsa_padding(
+                context.get(), pss ? RSA_PKCS1_PSS_PADDING : RSA_PKCS1_PADDING)
+                != 1
+            || EVP_PKEY_CTX_set_signature_md(context.get(), GetDigestAlgorithm(algorithm)) != 1
+            || (pss
+                && EVP_PKEY_CTX_set_rsa_pss_saltlen(context.get(), RSA_PSS_SALTLEN_DIGEST) != 1))
+        {
+          throw std::runtime_error("Crypto error while setting the verification padding.");
+        }
+        derSignature = signature;
+      }
+      else
+      {
+        // The signatures of Key Vault are the concatenated R and S values, OpenSSL verifies the
+        // DER encoded ones.
+        if (signature.size() != 2 * m_publicKey->CoordinateSize)
+        {
+          return false;
+        }
+        std::vector<uint8_t> integers;
+        AppendDerInteger(integers, signature.data(), m_publicKey->CoordinateSize);
+        AppendDerInteger(
+            integers, signature.data() + m_publicKey->CoordinateSize, m_publicKey->CoordinateSize);
+        AppendDerElement(derSignature, DerSequence, integers);
+      }
+      return EVP_PKEY_verify(
+                 context.get(),
+                 derSignature.data(),
+                 derSignature.size(),
+                 digest.data(),
+                 digest.size())
+          == 1;
+    }
+#else
+    std::vector<uint8_t> LocalCryptographyProvider::Encrypt(
+        std::string const&,
+        std::vector<uint8_t> const&) const
+    {
+      throw std::runtime_error("The local cryptography isn't supported on this platform.");
+    }
+
+    bool LocalCryptographyProvider::Verify(
+        SignatureAlgorithm const&,
+        std::vector<uint8_t> const&,
+        std::vector<uint8_t> const&) const
+    {
+      throw std::runtime_error("The local cryptography isn't supported on this platform.");
+    }
+#endif
+
+}}}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography::_detail
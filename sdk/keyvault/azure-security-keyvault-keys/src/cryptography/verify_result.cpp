@@ -1,8 +1,6 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
-#include <azure/core/internal/json/json.hpp>
-
 #include "../private/cryptography_serializers.hpp"
 #include "../private/key_constants.hpp"
 #include "azure/keyvault/keys/cryptography/cryptography_client_models.hpp"
@@ -10,8 +8,7 @@
 #include <string>
 #include <vector>
 
-using namespace Azure::Core::Json::_internal;
-using namespace Azure::Security::KeyVault::Keys::_detail;
+using Azure::Security::KeyVault::_internal::FlatJsonReader;
 
 namespace Azure {
   namespace Security {
@@ -22,11 +19,10 @@ namespace Azure {
   VerifyResult _detail::VerifyResultSerializer::VerifyResultDeserialize(
       Azure::Core::Http::RawResponse const& rawResponse)
   {
-    auto const& body = rawResponse.GetBody();
-    auto jsonParser = json::parse(body);
+    FlatJsonReader const jsonReader(rawResponse.GetBody());
 
     VerifyResult result;
-    result.IsValid = jsonParser[ValueParameterValue].get<bool>();
+    result.IsValid = jsonReader.GetBool(ValueKey);
 
     return result;
   }
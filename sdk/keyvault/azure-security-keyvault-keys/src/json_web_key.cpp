@@ -48,7 +48,7 @@ static inline void WriteJsonIfVectorHasData(
       [](std::vector<uint8_t> const& value) { return value.size() > 0; },
       jsonKey,
       keyName,
-      Base64Url::Base64UrlEncode);
+      [](std::vector<uint8_t> const& value) { return Base64Url::Base64UrlEncode(value); });
 }
 } // namespace
 
@@ -1,9 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
-#include <azure/core/base64.hpp>
-#include <azure/core/internal/json/json.hpp>
-#include <azure/core/internal/json/json_optional.hpp>
+#include <azure/keyvault/shared/keyvault_flat_json.hpp>
 
 #include "private/key_backup.hpp"
 #include "private/key_constants.hpp"
@@ -11,27 +9,25 @@
 #include <string>
 
 using namespace Azure::Security::KeyVault::Keys::_detail;
-using namespace Azure::Core::_internal;
-using namespace Azure::Core::Json::_internal;
+using Azure::Security::KeyVault::_internal::FlatJsonReader;
+using Azure::Security::KeyVault::_internal::FlatJsonWriter;
 
 std::string KeyBackup::Serialize() const
 {
-  Azure::Core::Json::_internal::json payload;
-
-  payload["value"] = Base64Url::Base64UrlEncode(Value);
-
-  // release_policy
-  return payload.dump();
+  // The backup is encoded straight into the payload, sized up front.
+  FlatJsonWriter payload(FlatJsonWriter::Base64UrlPropertyLength(ValueParameterValue, Value));
+  payload.WriteBase64Url(ValueParameterValue, Value);
+  return payload.Finish();
 }
 
 KeyBackup KeyBackup::Deserialize(Azure::Core::Http::RawResponse const& rawResponse)
 {
-  auto const& body = rawResponse.GetBody();
-  auto jsonParser = json::parse(body);
+  // The backup is decoded straight from the body, without building a JSON document.
+  FlatJsonReader reader(rawResponse.GetBody());
   KeyBackup keyBackup;
-  JsonOptional::SetIfExists<std::string, std::vector<uint8_t>>(
-      keyBackup.Value, jsonParser, "value", [](std::string const& value) {
-        return Base64Url::Base64UrlDecode(value);
-      });
+  if (reader.Contains(ValueParameterValue))
+  {
+    keyBackup.Value = reader.GetBase64Url(ValueParameterValue);
+  }
   return keyBackup;
 }
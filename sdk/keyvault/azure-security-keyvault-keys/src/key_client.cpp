@@ -6,6 +6,7 @@
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/core/internal/http/pipeline.hpp>
 
+#include <azure/keyvault/shared/keyvault_backup_stream.hpp>
 #include <azure/keyvault/shared/keyvault_shared.hpp>
 
 #include "azure/keyvault/keys/key_client.hpp"
@@ -45,10 +46,11 @@ std::unique_ptr<RawResponse> KeyClient::SendRequest(
 Request KeyClient::CreateRequest(
     HttpMethod method,
     std::vector<std::string> const& path,
-    Azure::Core::IO::BodyStream* content) const
+    Azure::Core::IO::BodyStream* content,
+    bool shouldBufferResponse) const
 {
   return Azure::Security::KeyVault::_detail::KeyVaultKeysCommonRequest::CreateRequest(
-      m_vaultUrl, m_apiVersion, method, path, content);
+      m_vaultUrl, m_apiVersion, method, path, content, shouldBufferResponse);
 }
 
 Request KeyClient::ContinuationTokenRequest(
@@ -351,6 +353,36 @@ Azure::Response<KeyVaultKey> KeyClient::RestoreKeyBackup(
   return Azure::Response<KeyVaultKey>(std::move(value), std::move(rawResponse));
 }
 
+Azure::Response<int64_t> KeyClient::BackupKeyTo(
+    std::string const& name,
+    std::string const& fileName,
+    Azure::Core::Context const& context) const
+{
+  // The response isn't buffered, the backup is decoded from the body stream into the file.
+  auto request
+      = CreateRequest(HttpMethod::Post, {_detail::KeysPath, name, "backup"}, nullptr, false);
+  auto rawResponse = SendRequest(request, context);
+  auto const length = Azure::Security::KeyVault::_internal::WriteBackupToFile(
+      *rawResponse, fileName, context);
+  return Azure::Response<int64_t>(length, std::move(rawResponse));
+}
+
+Azure::Response<KeyVaultKey> KeyClient::RestoreKeyBackupFrom(
+    std::string const& fileName,
+    Azure::Core::Context const& context) const
+{
+  // The payload encodes the backup as it's read from the file.
+  Azure::Core::IO::FileBodyStream backupStream(fileName);
+  Azure::Security::KeyVault::_internal::BackupPayloadStream payloadStream(backupStream);
+
+  auto request = CreateRequest(HttpMethod::Post, {_detail::KeysPath, "restore"}, &payloadStream);
+  request.SetHeader(HttpShared::ContentType, HttpShared::ApplicationJson);
+
+  auto rawResponse = SendRequest(request, context);
+  auto value = _detail::KeyVaultKeySerializer::KeyVaultKeyDeserialize(*rawResponse);
+  return Azure::Response<KeyVaultKey>(std::move(value), std::move(rawResponse));
+}
+
 Azure::Response<KeyVaultKey> KeyClient::ImportKey(
     std::string const& name,
     JsonWebKey const& keyMaterial,
@@ -10,9 +10,11 @@
 #include <azure/core/internal/json/json_optional.hpp>
 #include <azure/core/internal/json/json_serializable.hpp>
 #include <azure/core/url.hpp>
+#include <azure/keyvault/shared/keyvault_paged_json.hpp>
 
 using namespace Azure::Security::KeyVault::Keys;
 using namespace Azure::Core::Json::_internal;
+using Azure::Security::KeyVault::_internal::PagedJsonParser;
 
 KeyPropertiesPagedResponse
 _detail::KeyPropertiesPagedResultSerializer::KeyPropertiesPagedResultDeserialize(
@@ -22,21 +24,16 @@ _detail::KeyPropertiesPagedResultSerializer::KeyPropertiesPagedResultDeserialize
 
   KeyPropertiesPagedResponse result;
   auto const& body = rawResponse.GetBody();
-  auto jsonParser = json::parse(body);
 
-  JsonOptional::SetIfExists(result.NextPageToken, jsonParser, "nextLink");
-
-  // Key properties
-  auto keyPropertiesJson = jsonParser["value"];
-  for (auto const& key : keyPropertiesJson)
-  {
+  // Key properties, deserialized one at a time as they are parsed
+  auto jsonParser = PagedJsonParser::Parse(body, [&result](json const& key) {
     KeyProperties keyProperties;
     keyProperties.Id = key[_detail::KeyIdPropertyName].get<std::string>();
     _detail::KeyVaultKeySerializer::ParseKeyUrl(keyProperties, keyProperties.Id);
     // "Attributes"
     if (key.contains(_detail::AttributesPropertyName))
     {
-      auto attributes = key[_detail::AttributesPropertyName];
+      auto const& attributes = key[_detail::AttributesPropertyName];
 
       JsonOptional::SetIfExists(keyProperties.Enabled, attributes, _detail::EnabledPropertyName);
       JsonOptional::SetIfExists<int64_t, Azure::DateTime>(
@@ -77,8 +74,10 @@ _detail::KeyPropertiesPagedResultSerializer::KeyPropertiesPagedResultDeserialize
       keyProperties.Managed = key[_detail::ManagedPropertyName].get<bool>();
     }
 
-    result.Items.emplace_back(keyProperties);
-  }
+    result.Items.emplace_back(std::move(keyProperties));
+  });
+
+  JsonOptional::SetIfExists(result.NextPageToken, jsonParser, "nextLink");
 
   return result;
 }
@@ -90,15 +89,11 @@ _detail::KeyPropertiesPagedResultSerializer::DeletedKeyPagedResultDeserialize(
   using Azure::Core::_internal::PosixTimeConverter;
 
   auto const& body = rawResponse.GetBody();
-  auto jsonParser = Azure::Core::Json::_internal::json::parse(body);
 
   DeletedKeyPagedResponse deletedKeyPagedResult;
 
-  JsonOptional::SetIfExists(deletedKeyPagedResult.NextPageToken, jsonParser, "nextLink");
-
-  auto deletedKeys = jsonParser["value"];
-  for (auto const& key : deletedKeys)
-  {
+  // Deleted keys, deserialized one at a time as they are parsed
+  auto jsonParser = PagedJsonParser::Parse(body, [&deletedKeyPagedResult](json const& key) {
     DeletedKey deletedKey;
     deletedKey.Properties.Id = key[_detail::KeyIdPropertyName].get<std::string>();
     _detail::KeyVaultKeySerializer::ParseKeyUrl(deletedKey.Properties, deletedKey.Properties.Id);
@@ -124,8 +119,10 @@ _detail::KeyPropertiesPagedResultSerializer::DeletedKeyPagedResultDeserialize(
         _detail::ScheduledPurgeDatePropertyName,
         PosixTimeConverter::PosixTimeToDateTime);
 
-    deletedKeyPagedResult.Items.emplace_back(deletedKey);
-  }
+    deletedKeyPagedResult.Items.emplace_back(std::move(deletedKey));
+  });
+
+  JsonOptional::SetIfExists(deletedKeyPagedResult.NextPageToken, jsonParser, "nextLink");
 
   return deletedKeyPagedResult;
 }
@@ -7,6 +7,7 @@
 
 #include <azure/core/exception.hpp>
 #include <azure/core/http/http.hpp>
+#include <azure/keyvault/shared/keyvault_backup_stream.hpp>
 
 using namespace Azure::Security::KeyVault;
 using namespace Azure::Core::Http::_internal;
@@ -29,6 +30,7 @@ std::unique_ptr<Azure::Core::Http::RawResponse> _detail::KeyVaultKeysCommonReque
     case Azure::Core::Http::HttpStatusCode::NoContent:
       break;
     default:
+      Azure::Security::KeyVault::_internal::BufferErrorResponse(*response, context);
       throw Azure::Core::RequestFailedException(response);
   }
   return response;
@@ -39,10 +41,12 @@ Azure::Core::Http::Request _detail::KeyVaultKeysCommonRequest::CreateRequest(
     std::string const& apiVersion,
     Azure::Core::Http::HttpMethod method,
     std::vector<std::string> const& path,
-    Azure::Core::IO::BodyStream* content)
+    Azure::Core::IO::BodyStream* content,
+    bool shouldBufferResponse)
 {
   using namespace Azure::Core::Http;
-  Request request = content == nullptr ? Request(method, url) : Request(method, url, content);
+  Request request = content == nullptr ? Request(method, url, shouldBufferResponse)
+                                       : Request(method, url, content, shouldBufferResponse);
 
   request.GetUrl().AppendQueryParameter(ApiVersionValue, apiVersion);
 
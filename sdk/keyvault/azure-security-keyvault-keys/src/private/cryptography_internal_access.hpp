@@ -13,7 +13,9 @@
 
 #include "azure/keyvault/keys/cryptography/cryptography_client.hpp"
 
+#include <memory>
 #include <string>
+#include <utility>
 
 namespace Azure {
   namespace Security {
@@ -33,6 +35,14 @@ namespace Azure {
       {
         return CryptographyClient(keyId, apiVersion, pipeline);
       }
+
+      // Performs the public key operations of the client locally, with a key already fetched.
+      static void SetLocalCryptography(
+          CryptographyClient& client,
+          std::shared_ptr<LocalCryptographyCache> localCryptography)
+      {
+        client.m_localCryptography = std::move(localCryptography);
+      }
     };
 
 }}}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography::_detail
@@ -12,9 +12,11 @@
 
 #include <azure/core/http/http.hpp>
 #include <azure/core/internal/json/json.hpp>
+#include <azure/keyvault/shared/keyvault_flat_json.hpp>
 
 #include "azure/keyvault/keys/cryptography/cryptography_client_models.hpp"
 
+#include "key_constants.hpp"
 #include "key_sign_parameters.hpp"
 #include "key_verify_parameters.hpp"
 #include "key_wrap_parameters.hpp"
@@ -28,6 +30,18 @@ namespace Azure {
         namespace Cryptography {
   namespace _detail {
 
+    /***************** Result Properties *****************/
+    // The properties read from the results of the operations, hashed at compile time.
+    constexpr static Azure::Security::KeyVault::_internal::JsonKey KeyIdKey(
+        Keys::_detail::KeyIdPropertyName);
+    constexpr static Azure::Security::KeyVault::_internal::JsonKey ValueKey(
+        Keys::_detail::ValueParameterValue);
+    constexpr static Azure::Security::KeyVault::_internal::JsonKey IvKey(Keys::_detail::IvValue);
+    constexpr static Azure::Security::KeyVault::_internal::JsonKey AdditionalAuthenticatedKey(
+        Keys::_detail::AdditionalAuthenticatedValue);
+    constexpr static Azure::Security::KeyVault::_internal::JsonKey AuthenticationTagKey(
+        Keys::_detail::AuthenticationTagValue);
+
     /***************** Encrypt Result *****************/
     class EncryptResultSerializer final {
     public:
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Performs the public key operations of a Key Vault key in-process.
+ *
+ */
+
+#pragma once
+
+#include "azure/keyvault/keys/cryptography/cryptography_client_models.hpp"
+#include "azure/keyvault/keys/key_client_models.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Azure {
+  namespace Security {
+    namespace KeyVault {
+      namespace Keys {
+        namespace Cryptography {
+  namespace _detail {
+
+    class LocalCryptographyProvider final {
+    public:
+      // Returns nullptr when the type of the key, or the platform, isn't supported.
+      static std::unique_ptr<LocalCryptographyProvider> Create(KeyVaultKey const& key);
+
+      ~LocalCryptographyProvider();
+
+      // The identifier of the version of the key, returned with the results.
+      std::string const& KeyId() const { return m_key.Key.Id; }
+
+      // Returns false when the encryption, or the wrapping with the operation WrapKey, has to be
+      // performed by the service. Only the RSA algorithms are performed locally, with a key
+      // enabled and not expired.
+      bool SupportsEncrypt(std::string const& algorithm, KeyOperation const& operation) const;
+
+      std::vector<uint8_t> Encrypt(
+          std::string const& algorithm,
+          std::vector<uint8_t> const& plaintext) const;
+
+      // Returns false when the verification has to be performed by the service, which reports
+      // the digests of the wrong size.
+      bool SupportsVerify(SignatureAlgorithm const& algorithm, size_t digestSize) const;
+
+      bool Verify(
+          SignatureAlgorithm const& algorithm,
+          std::vector<uint8_t> const& digest,
+          std::vector<uint8_t> const& signature) const;
+
+    private:
+      struct PublicKey;
+
+      LocalCryptographyProvider(KeyVaultKey const& key, std::unique_ptr<PublicKey> publicKey);
+
+      KeyVaultKey m_key;
+      std::unique_ptr<PublicKey> m_publicKey;
+    };
+
+    // The key fetched once for the local operations of a cryptography client and its copies.
+    struct LocalCryptographyCache final
+    {
+      std::mutex Mutex;
+      bool Fetched = false;
+      // Null when the key couldn't be fetched or can't be used locally.
+      std::unique_ptr<LocalCryptographyProvider> Provider;
+    };
+
+}}}}}} // namespace Azure::Security::KeyVault::Keys::Cryptography::_detail
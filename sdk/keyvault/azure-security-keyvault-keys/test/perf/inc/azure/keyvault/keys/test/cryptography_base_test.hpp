@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Define the base behavior of the tests using a cryptography client.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include <azure/identity.hpp>
+#include <azure/keyvault/keyvault_keys.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Keys { namespace Test {
+
+  /**
+   * @brief A base test that creates a cryptography client for an RSA key.
+   *
+   * @remark The operations are done by the key vault, so each run is one request. The access
+   * token is cached by the client after the first request.
+   */
+  class CryptographyTest : public Azure::Perf::PerfTest {
+  protected:
+    std::unique_ptr<Azure::Security::KeyVault::Keys::Cryptography::CryptographyClient> m_client;
+
+    /**
+     * @brief The SHA-256 digest to sign, or the key to wrap.
+     *
+     */
+    std::vector<uint8_t> m_digest = std::vector<uint8_t>(32, 0x5A);
+
+  public:
+    /**
+     * @brief Create the cryptography client.
+     *
+     */
+    void Setup() override
+    {
+      auto credential = std::make_shared<Azure::Identity::ClientSecretCredential>(
+          m_options.GetMandatoryOption<std::string>("TenantId"),
+          m_options.GetMandatoryOption<std::string>("ClientId"),
+          m_options.GetMandatoryOption<std::string>("Secret"));
+      m_client = std::make_unique<Cryptography::CryptographyClient>(
+          m_options.GetMandatoryOption<std::string>("keyId"), credential);
+    }
+
+    /**
+     * @brief Construct a new CryptographyTest test.
+     *
+     * @param options The test options.
+     */
+    CryptographyTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"keyId",
+           {"--keyId"},
+           "The identifier of an RSA key, like https://myvault.vault.azure.net/keys/myKey/version.",
+           1,
+           true},
+          {"TenantId", {"--tenantId"}, "The tenant Id for the authentication.", 1, true},
+          {"ClientId", {"--clientId"}, "The client Id for the authentication.", 1, true},
+          {"Secret", {"--secret"}, "The secret for authentication.", 1, true, true}};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Keys::Test
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of encrypting with a key vault key.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include "azure/keyvault/keys/test/cryptography_base_test.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Keys { namespace Test {
+
+  /**
+   * @brief A test to measure encrypting 32 bytes with RSA-OAEP.
+   *
+   */
+  class Encrypt : public Azure::Security::KeyVault::Keys::Test::CryptographyTest {
+  public:
+    /**
+     * @brief Construct a new Encrypt test.
+     *
+     * @param options The test options.
+     */
+    Encrypt(Azure::Perf::TestOptions options) : CryptographyTest(options) {}
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      auto result = m_client->Encrypt(
+          Azure::Security::KeyVault::Keys::Cryptography::EncryptParameters::RsaOaepParameters(
+              m_digest),
+          context);
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {"Encrypt", "Encrypt a small payload", [](Azure::Perf::TestOptions options) {
+                return std::make_unique<Azure::Security::KeyVault::Keys::Test::Encrypt>(options);
+              }};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Keys::Test
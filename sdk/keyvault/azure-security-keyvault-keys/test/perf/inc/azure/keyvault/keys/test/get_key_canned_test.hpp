@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of the SDK layers when getting a key, without the network.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include <azure/keyvault/keyvault_keys.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Keys { namespace Test {
+
+  namespace _detail {
+    /**
+     * @brief A credential returning a token which doesn't expire, without the network.
+     *
+     */
+    class NonExpiringCredential final : public Azure::Core::Credentials::TokenCredential {
+    public:
+      Azure::Core::Credentials::AccessToken GetToken(
+          Azure::Core::Credentials::TokenRequestContext const&,
+          Azure::Core::Context const&) const override
+      {
+        return {"magicToken", Azure::DateTime::clock::now() + std::chrono::hours(24)};
+      }
+    };
+  } // namespace _detail
+
+  /**
+   * @brief A test to measure getting a key with a transport returning a canned response.
+   *
+   * @remark The request goes through all the policies of the client, and the JSON of the key is
+   * deserialized. Only the network is left out, so no key vault is needed.
+   */
+  class GetKeyCanned : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Security::KeyVault::Keys::KeyClient> m_client;
+
+  public:
+    /**
+     * @brief Construct a new GetKeyCanned test.
+     *
+     * @param options The test options.
+     */
+    GetKeyCanned(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the key client with a canned RSA key.
+     *
+     */
+    void Setup() override
+    {
+      // The modulus of a 2048 bits key, base64url encoded.
+      std::string const modulus(342, 'A');
+
+      std::string const body
+          = "{\"key\":{\"kid\":\"https://vault.vault.azure.net/keys/perfKey/"
+            "78deebed173b48e48f55abf87ed4cf71\",\"kty\":\"RSA\",\"key_ops\":[\"encrypt\","
+            "\"decrypt\",\"sign\",\"verify\",\"wrapKey\",\"unwrapKey\"],\"n\":\""
+          + modulus
+          + "\",\"e\":\"AQAB\"},\"attributes\":{\"enabled\":true,\"created\":1642109872,"
+            "\"updated\":1642109872,\"recoveryLevel\":\"Recoverable+Purgeable\","
+            "\"recoverableDays\":90},\"tags\":{\"purpose\":\"perf\"}}";
+
+      Azure::Perf::CannedResponse response;
+      response.Headers = {
+          {"content-type", "application/json; charset=utf-8"},
+          {"x-ms-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000"},
+          {"x-ms-keyvault-service-version", "1.9.264.2"},
+          {"date", "Thu, 13 Jan 2022 21:37:53 GMT"},
+      };
+      response.Body.assign(body.begin(), body.end());
+
+      Azure::Security::KeyVault::Keys::KeyClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_client = std::make_unique<Azure::Security::KeyVault::Keys::KeyClient>(
+          "https://vault.vault.azure.net",
+          std::make_shared<_detail::NonExpiringCredential>(),
+          options);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      auto key = m_client->GetKey("perfKey", {}, context);
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "GetKeyCanned",
+          "Get a canned key. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Security::KeyVault::Keys::Test::GetKeyCanned>(options);
+          }};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Keys::Test
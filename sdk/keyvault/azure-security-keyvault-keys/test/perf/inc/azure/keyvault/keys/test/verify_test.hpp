@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of verifying a signature with a key vault key.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include "azure/keyvault/keys/test/cryptography_base_test.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Keys { namespace Test {
+
+  /**
+   * @brief A test to measure verifying an RS256 signature of a SHA-256 digest.
+   *
+   */
+  class Verify : public Azure::Security::KeyVault::Keys::Test::CryptographyTest {
+  private:
+    std::vector<uint8_t> m_signature;
+
+  public:
+    /**
+     * @brief Construct a new Verify test.
+     *
+     * @param options The test options.
+     */
+    Verify(Azure::Perf::TestOptions options) : CryptographyTest(options) {}
+
+    /**
+     * @brief Sign the digest to verify.
+     *
+     */
+    void Setup() override
+    {
+      CryptographyTest::Setup();
+      m_signature = m_client->Sign(Cryptography::SignatureAlgorithm::RS256, m_digest)
+                        .Value.Signature;
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      auto result = m_client->Verify(
+          Azure::Security::KeyVault::Keys::Cryptography::SignatureAlgorithm::RS256,
+          m_digest,
+          m_signature,
+          context);
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {"Verify", "Verify a signature", [](Azure::Perf::TestOptions options) {
+                return std::make_unique<Azure::Security::KeyVault::Keys::Test::Verify>(options);
+              }};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Keys::Test
@@ -3,14 +3,24 @@
 
 #include <azure/perf.hpp>
 
+#include "azure/keyvault/keys/test/encrypt_test.hpp"
+#include "azure/keyvault/keys/test/get_key_canned_test.hpp"
 #include "azure/keyvault/keys/test/get_key_test.hpp"
+#include "azure/keyvault/keys/test/sign_test.hpp"
+#include "azure/keyvault/keys/test/verify_test.hpp"
+#include "azure/keyvault/keys/test/wrap_key_test.hpp"
 
 int main(int argc, char** argv)
 {
 
   // Create the test list
   std::vector<Azure::Perf::TestMetadata> tests{
-      Azure::Security::KeyVault::Keys::Test::GetKey::GetTestMetadata()};
+      Azure::Security::KeyVault::Keys::Test::GetKey::GetTestMetadata(),
+      Azure::Security::KeyVault::Keys::Test::GetKeyCanned::GetTestMetadata(),
+      Azure::Security::KeyVault::Keys::Test::Sign::GetTestMetadata(),
+      Azure::Security::KeyVault::Keys::Test::Verify::GetTestMetadata(),
+      Azure::Security::KeyVault::Keys::Test::Encrypt::GetTestMetadata(),
+      Azure::Security::KeyVault::Keys::Test::WrapKey::GetTestMetadata()};
 
   Azure::Perf::Program::Run(Azure::Core::Context::ApplicationContext, tests, argc, argv);
 
@@ -0,0 +1,223 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include "mocked_transport_adapter_test.hpp"
+
+#include <azure/core/base64.hpp>
+#include <azure/core/internal/json/json.hpp>
+#include <azure/keyvault/shared/keyvault_backup_stream.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::_internal;
+using Azure::Core::Json::_internal::json;
+
+namespace {
+std::vector<uint8_t> CreateBackup(size_t size, uint8_t seed)
+{
+  std::vector<uint8_t> backup(size);
+  for (size_t i = 0; i < backup.size(); ++i)
+  {
+    backup[i] = static_cast<uint8_t>(i * 31 + i / 256 + seed);
+  }
+  return backup;
+}
+
+// Decodes the text written in pieces of pieceSize characters.
+std::vector<uint8_t> Decode(std::string const& text, size_t pieceSize, size_t* maxSinkLength)
+{
+  std::vector<uint8_t> backup;
+  BackupValueDecoder decoder([&](uint8_t const* data, size_t length) {
+    backup.insert(backup.end(), data, data + length);
+    *maxSinkLength = std::max(*maxSinkLength, length);
+  });
+  for (size_t i = 0; i < text.size(); i += pieceSize)
+  {
+    decoder.Write(text.data() + i, std::min(pieceSize, text.size() - i));
+  }
+  EXPECT_EQ(decoder.Finish(), static_cast<int64_t>(backup.size()));
+  return backup;
+}
+
+std::vector<uint8_t> Decode(std::string const& text)
+{
+  size_t maxSinkLength = 0;
+  return Decode(text, 3, &maxSinkLength);
+}
+
+std::vector<uint8_t> ReadFile(std::string const& fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// Answers the backup requests with the backup of the key named in the path, without buffering
+// the body, and the restore requests with a key, keeping their payload.
+class BackupTransport final : public Azure::Core::Http::HttpTransport {
+  std::mutex m_mutex;
+
+public:
+  std::vector<bool> ShouldBufferResponses;
+  std::vector<std::string> RestorePayloads;
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Context const& context) override
+  {
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(
+        1, 1, Azure::Core::Http::HttpStatusCode::Ok, "Ok");
+    auto const path = request.GetUrl().GetPath();
+    std::string body;
+    if (path.find("/backup") != std::string::npos)
+    {
+      // keys/<seed>/backup
+      auto const seed = static_cast<uint8_t>(path[path.find('/') + 1] - '0');
+      body = "{\"value\":\""
+          + Azure::Core::_internal::Base64Url::Base64UrlEncode(CreateBackup(300000, seed))
+          + "\"}";
+    }
+    else
+    {
+      auto payload = request.GetBodyStream()->ReadToEnd(context);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      RestorePayloads.emplace_back(payload.begin(), payload.end());
+      body = Azure::Security::KeyVault::Keys::Test::_detail::FakeKey;
+      body.replace(body.find("%s"), 2, "RSA");
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      ShouldBufferResponses.push_back(request.ShouldBufferResponse());
+    }
+    response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+        std::make_shared<const std::vector<uint8_t>>(body.begin(), body.end())));
+    return response;
+  }
+};
+} // namespace
+
+TEST(BackupValueDecoder, DecodesInPieces)
+{
+  auto const backup = CreateBackup(300000, 0);
+  std::string const text
+      = "{\"value\":\"" + Azure::Core::_internal::Base64Url::Base64UrlEncode(backup) + "\"}";
+
+  for (size_t pieceSize : {size_t(1), size_t(7), size_t(4096), size_t(65536), text.size()})
+  {
+    size_t maxSinkLength = 0;
+    EXPECT_EQ(Decode(text, pieceSize, &maxSinkLength), backup) << pieceSize;
+    // The backup is decoded by blocks of up to 48 KiB.
+    EXPECT_LE(maxSinkLength, size_t(48 * 1024)) << pieceSize;
+  }
+}
+
+TEST(BackupValueDecoder, SkipsOtherProperties)
+{
+  EXPECT_EQ(
+      Decode(" { \"a\" : {\"b\":[\"}\", 1, {}]}, \"n\":-1.5e3, \"t\":true, \"s\":\"x\\\"y\","
+             " \"valu\\u0065\":\"AA\", \"value\" : \"AAEC-vv8_Q\" , \"z\":null } "),
+      (std::vector<uint8_t>{0, 1, 2, 250, 251, 252, 253}));
+  EXPECT_TRUE(Decode("{\"value\":\"\"}").empty());
+}
+
+TEST(BackupValueDecoder, Invalid)
+{
+  for (auto const text : {
+           "",
+           "[]",
+           "{}",
+           "{\"other\":\"AAEC\"}",
+           "{\"value\":\"AAEC\"",
+           "{\"value\":\"AA\\u0045C\"}",
+           "{\"value\":\"AAEC\"}}",
+           "{\"value\":\"AAEC\" \"other\":1}",
+           "{\"value\":,\"other\":1}",
+           "{\"value\":null}",
+       })
+  {
+    EXPECT_THROW(Decode(text), std::invalid_argument) << text;
+  }
+}
+
+TEST(BackupPayloadStream, EncodesInBlocks)
+{
+  for (size_t size : {size_t(0), size_t(1), size_t(2), size_t(49152), size_t(300000)})
+  {
+    auto const backup = CreateBackup(size, 1);
+    Azure::Core::IO::MemoryBodyStream backupStream(backup);
+    BackupPayloadStream payloadStream(backupStream);
+
+    auto payload = payloadStream.ReadToEnd();
+    EXPECT_EQ(payloadStream.Length(), static_cast<int64_t>(payload.size())) << size;
+    auto const document = json::parse(payload);
+    EXPECT_EQ(
+        document["value"].get<std::string>(),
+        Azure::Core::_internal::Base64Url::Base64UrlEncode(backup))
+        << size;
+    EXPECT_EQ(Decode(std::string(payload.begin(), payload.end())), backup) << size;
+
+    // The payload is read again when the request is retried.
+    payloadStream.Rewind();
+    EXPECT_EQ(payloadStream.ReadToEnd(), payload) << size;
+  }
+}
+
+TEST(BackupStream, BackupAndRestoreKeysConcurrently)
+{
+  auto const transport = std::make_shared<BackupTransport>();
+  Azure::Security::KeyVault::Keys::KeyClientOptions options;
+  options.Transport.Transport = transport;
+  Azure::Security::KeyVault::Keys::Test::KeyClientWithNoAuthenticationPolicy const client(
+      "https://myvault.vault.azure.net", options);
+
+  // The backups are streamed to files, each with a bounded amount of memory.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&client, i]() {
+      auto const fileName = "backup_stream_test_" + std::to_string(i);
+      auto const response = client.BackupKeyTo(std::to_string(i), fileName);
+      EXPECT_EQ(response.Value, 300000);
+      EXPECT_EQ(ReadFile(fileName), CreateBackup(300000, static_cast<uint8_t>(i)));
+
+      auto const key = client.RestoreKeyBackupFrom(fileName);
+      EXPECT_EQ(key.Value.Name(), "CreateSoftKeyTest");
+      std::remove(fileName.c_str());
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  ASSERT_EQ(transport->ShouldBufferResponses.size(), size_t(8));
+  EXPECT_EQ(std::count(
+                transport->ShouldBufferResponses.begin(),
+                transport->ShouldBufferResponses.end(),
+                false),
+            4);
+  ASSERT_EQ(transport->RestorePayloads.size(), size_t(4));
+  std::vector<std::vector<uint8_t>> restored;
+  for (auto const& payload : transport->RestorePayloads)
+  {
+    restored.push_back(Decode(payload));
+  }
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_NE(
+        std::find(
+            restored.begin(), restored.end(), CreateBackup(300000, static_cast<uint8_t>(i))),
+        restored.end())
+        << i;
+  }
+}
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/http/transport.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/keyvault/keyvault_keys.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::Keys;
+
+namespace {
+// The modulus of a 2048 bits RSA key.
+const std::string Modulus
+    = "qRol77YCESm8v2-SwMZVaTN1mQ-Vax24HhMhoZnohsX3MnQXuzV8tVd7sqgtxjQGYpjmcMJMrcRhcM3B19Zkbs0iepIL"
+      "3VLhU0rQf0rOP78yxz4OyxpQAMq4hug6RB5nWGDvox7Pf3BWPMoGxGUal2z-IgShdc3W3DCZWnmIu7Bu_PgJWt-FWdj5"
+      "Z0kdp7EnfvlPARi9p2jU_LBrzxjQE11rB97Zvb8kxQ1dEVM9yKspCGVyYlC_W9ahjstRBcXFigriHJFi-u1aCGazwT4J"
+      "Hj_Q9BbI2ovoN891p4Xq4ifD5fboLGTUhMufqfiC6yoM4e2jnuQkYx8K7moDcivWuQ";
+
+class NonExpiringCredential final : public Azure::Core::Credentials::TokenCredential {
+public:
+  Azure::Core::Credentials::AccessToken GetToken(
+      Azure::Core::Credentials::TokenRequestContext const&,
+      Azure::Core::Context const&) const override
+  {
+    ++TokenCount;
+    return {"magicToken", Azure::DateTime::clock::now() + std::chrono::hours(24)};
+  }
+
+  mutable std::atomic<int> TokenCount{0};
+};
+
+// Returns the current version of the key "key", and the results of the operations sent to the
+// service.
+class MockKeyTransport final : public Azure::Core::Http::HttpTransport {
+public:
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Context const&) override
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    Requests.push_back(request.GetMethod().ToString() + " " + request.GetUrl().GetPath());
+    const std::string keyId = "https://vault.vault.azure.net/keys/key/" + CurrentVersion;
+    std::string body;
+    if (request.GetMethod() == Azure::Core::Http::HttpMethod::Get)
+    {
+      body = "{\"key\":{\"kid\":\"" + keyId
+          + "\",\"kty\":\"RSA\",\"key_ops\":[\"wrapKey\",\"unwrapKey\"],\"n\":\"" + Modulus
+          + "\",\"e\":\"AQAB\"},\"attributes\":{\"enabled\":true,\"updated\":1493938410}}";
+    }
+    else
+    {
+      body = "{\"kid\":\"" + keyId + "\",\"value\":\"AAAA\"}";
+    }
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(
+        1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+    response->SetHeader("content-type", "application/json");
+    // The bodies outlive the responses streaming them.
+    m_bodies.emplace_back(body.begin(), body.end());
+    response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+        m_bodies.back().data(), m_bodies.back().size()));
+    return response;
+  }
+
+  std::string CurrentVersion = "v1";
+  std::vector<std::string> Requests;
+
+private:
+  std::mutex m_mutex;
+  std::deque<std::vector<uint8_t>> m_bodies;
+};
+
+std::unique_ptr<KeyClient> CreateKeyClient(
+    std::shared_ptr<MockKeyTransport> transport,
+    std::shared_ptr<NonExpiringCredential> credential = std::make_shared<NonExpiringCredential>())
+{
+  KeyClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  options.Retry.MaxRetries = 0;
+  return std::make_unique<KeyClient>(
+      "https://vault.vault.azure.net", std::move(credential), options);
+}
+} // namespace
+
+TEST(CachingKeyClient, RevalidatesTheLatestVersions)
+{
+  auto transport = std::make_shared<MockKeyTransport>();
+  CachingKeyClientOptions options;
+  options.RevalidationInterval = std::chrono::milliseconds(100);
+  CachingKeyClient client(*CreateKeyClient(transport), options);
+
+  auto key = client.GetKey("key");
+  EXPECT_EQ(key->Properties.Version, "v1");
+  EXPECT_EQ(client.GetKey("key"), key);
+  GetKeyOptions versionOptions;
+  versionOptions.Version = "v1";
+  EXPECT_EQ(client.GetKey("key", versionOptions), key);
+  EXPECT_EQ(transport->Requests, std::vector<std::string>{"GET keys/key"});
+
+  // The key unchanged is kept.
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  EXPECT_EQ(client.GetKey("key"), key);
+  EXPECT_EQ(transport->Requests.size(), 2U);
+
+  transport->CurrentVersion = "v2";
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  auto newKey = client.GetKey("key");
+  EXPECT_EQ(newKey->Properties.Version, "v2");
+  EXPECT_EQ(client.GetKey("key", versionOptions), key);
+  EXPECT_EQ(transport->Requests.size(), 3U);
+
+  client.Invalidate("key");
+  client.GetKey("key", versionOptions);
+  EXPECT_EQ(transport->Requests.back(), "GET keys/key/v1");
+}
+
+TEST(CachingKeyClient, CreatesCryptographyClientsWithTheCachedKeys)
+{
+  auto transport = std::make_shared<MockKeyTransport>();
+  CachingKeyClient client(*CreateKeyClient(transport));
+  const std::vector<uint8_t> key(32, 'a');
+
+  auto cryptographyClient = client.GetCryptographyClient("key");
+  auto wrapped = cryptographyClient.WrapKey(Cryptography::KeyWrapAlgorithm::RsaOaep, key).Value;
+  EXPECT_EQ(wrapped.KeyId, "https://vault.vault.azure.net/keys/key/v1");
+  EXPECT_EQ(wrapped.EncryptedKey.size(), 256U);
+  client.GetCryptographyClient("key", "v1")
+      .WrapKey(Cryptography::KeyWrapAlgorithm::RsaOaep256, key);
+  EXPECT_EQ(transport->Requests, std::vector<std::string>{"GET keys/key"});
+
+  // The private key operations are performed by the service, with the version cached.
+  cryptographyClient.UnwrapKey(Cryptography::KeyWrapAlgorithm::RsaOaep, wrapped.EncryptedKey);
+  EXPECT_EQ(
+      transport->Requests,
+      (std::vector<std::string>{"GET keys/key", "POST keys/key/v1/unwrapKey"}));
+}
+
+TEST(CachingKeyClient, CryptographyClientsShareTheTokenOfTheKeyClient)
+{
+  auto transport = std::make_shared<MockKeyTransport>();
+  auto credential = std::make_shared<NonExpiringCredential>();
+  auto keyClient = CreateKeyClient(transport, credential);
+
+  for (int i = 0; i < 200; ++i)
+  {
+    auto client = keyClient->GetCryptographyClient("key" + std::to_string(i));
+    client.Sign(Cryptography::SignatureAlgorithm::RS256, std::vector<uint8_t>(32));
+  }
+  Cryptography::CryptographyClientOptions options;
+  options.Transport.Transport = transport;
+  Cryptography::CryptographyClient client(
+      "https://vault.vault.azure.net/keys/other", credential, options);
+  client.Sign(Cryptography::SignatureAlgorithm::RS256, std::vector<uint8_t>(32));
+
+  EXPECT_EQ(credential->TokenCount, 1);
+  ASSERT_EQ(transport->Requests.size(), 201U);
+  EXPECT_EQ(transport->Requests[199], "POST keys/key199/sign");
+  EXPECT_EQ(transport->Requests[200], "POST keys/other/sign");
+}
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/base64.hpp>
+#include <azure/core/exception.hpp>
+#include <azure/core/http/transport.hpp>
+#include <azure/core/internal/json/json.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/keyvault/keyvault_keys.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::Keys::Cryptography;
+
+namespace {
+const std::string KeyId = "https://vault.vault.azure.net/keys/key/version";
+
+class NonExpiringCredential final : public Azure::Core::Credentials::TokenCredential {
+public:
+  Azure::Core::Credentials::AccessToken GetToken(
+      Azure::Core::Credentials::TokenRequestContext const&,
+      Azure::Core::Context const&) const override
+  {
+    return {"magicToken", Azure::DateTime::clock::now() + std::chrono::hours(24)};
+  }
+};
+
+// Echoes the value of the operations after a delay. The value "throttled" is throttled once, and
+// the value "invalid" is rejected.
+class MockBatchTransport final : public Azure::Core::Http::HttpTransport {
+public:
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Context const& context) override
+  {
+    const int32_t inFlight = ++m_inFlight;
+    int32_t maxInFlight = MaxInFlight;
+    while (inFlight > maxInFlight && !MaxInFlight.compare_exchange_weak(maxInFlight, inFlight))
+    {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    --m_inFlight;
+
+    const auto payload = request.GetBodyStream()->ReadToEnd(context);
+    const std::string value
+        = Azure::Core::Json::_internal::json::parse(payload)["value"].get<std::string>();
+    const std::string decodedValue = [&value]() {
+      auto bytes = Azure::Core::_internal::Base64Url::Base64UrlDecode(value);
+      return std::string(bytes.begin(), bytes.end());
+    }();
+    auto status = Azure::Core::Http::HttpStatusCode::Ok;
+    std::string body = "{\"kid\":\"" + KeyId + "\",\"value\":\"" + value + "\"}";
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++RequestCount;
+    if (decodedValue == "throttled" && ThrottledValues.insert(decodedValue).second)
+    {
+      status = Azure::Core::Http::HttpStatusCode::TooManyRequests;
+      body = "{}";
+    }
+    else if (decodedValue == "invalid")
+    {
+      status = Azure::Core::Http::HttpStatusCode::BadRequest;
+      body = "{}";
+    }
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(1, 1, status, "");
+    response->SetHeader("content-type", "application/json");
+    if (status == Azure::Core::Http::HttpStatusCode::TooManyRequests)
+    {
+      response->SetHeader("retry-after-ms", "200");
+    }
+    // The bodies outlive the responses streaming them.
+    m_bodies.emplace_back(body.begin(), body.end());
+    response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+        m_bodies.back().data(), m_bodies.back().size()));
+    return response;
+  }
+
+  std::atomic<int32_t> MaxInFlight{0};
+  int32_t RequestCount = 0;
+  std::set<std::string> ThrottledValues;
+
+private:
+  std::atomic<int32_t> m_inFlight{0};
+  std::mutex m_mutex;
+  std::deque<std::vector<uint8_t>> m_bodies;
+};
+
+CryptographyClient CreateCryptographyClient(std::shared_ptr<MockBatchTransport> transport)
+{
+  CryptographyClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  options.Retry.MaxRetries = 0;
+  return CryptographyClient(KeyId, std::make_shared<NonExpiringCredential>(), options);
+}
+
+std::vector<uint8_t> ToBytes(std::string const& text)
+{
+  return std::vector<uint8_t>(text.begin(), text.end());
+}
+} // namespace
+
+TEST(CryptographyBatch, UnwrapsKeysConcurrently)
+{
+  auto transport = std::make_shared<MockBatchTransport>();
+  auto client = CreateCryptographyClient(transport);
+  std::vector<std::vector<uint8_t>> encryptedKeys;
+  for (int i = 0; i < 40; ++i)
+  {
+    encryptedKeys.push_back(ToBytes("key" + std::to_string(i)));
+  }
+  encryptedKeys[7] = ToBytes("invalid");
+  CryptographyBatchOptions options;
+  options.Concurrency = 8;
+
+  auto results = client.UnwrapKeys(KeyWrapAlgorithm::RsaOaep, encryptedKeys, options);
+
+  ASSERT_EQ(results.size(), encryptedKeys.size());
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    if (i == 7)
+    {
+      EXPECT_FALSE(results[i].Value.HasValue());
+      EXPECT_THROW(std::rethrow_exception(results[i].Error), Azure::Core::RequestFailedException);
+      continue;
+    }
+    ASSERT_TRUE(results[i].Value.HasValue());
+    EXPECT_FALSE(results[i].Error);
+    EXPECT_EQ(results[i].Value.Value().Key, encryptedKeys[i]);
+    EXPECT_EQ(results[i].Value.Value().Algorithm, KeyWrapAlgorithm::RsaOaep);
+  }
+  EXPECT_GT(transport->MaxInFlight, 1);
+  EXPECT_LE(transport->MaxInFlight, 8);
+}
+
+TEST(CryptographyBatch, PausesWhenThrottled)
+{
+  auto transport = std::make_shared<MockBatchTransport>();
+  auto client = CreateCryptographyClient(transport);
+  std::vector<std::vector<uint8_t>> digests(12, ToBytes("digest"));
+  digests[2] = ToBytes("throttled");
+  CryptographyBatchOptions options;
+  options.Concurrency = 2;
+
+  const auto start = std::chrono::steady_clock::now();
+  auto signResults = client.SignMany(SignatureAlgorithm::RS256, digests, options);
+  ASSERT_EQ(signResults.size(), digests.size());
+  for (size_t i = 0; i < signResults.size(); ++i)
+  {
+    ASSERT_TRUE(signResults[i].Value.HasValue());
+    EXPECT_EQ(signResults[i].Value.Value().Signature, digests[i]);
+  }
+  // The throttled operation is attempted again, and the batch pauses for the delay requested
+  // meanwhile. The requests alone take about 140 ms.
+  EXPECT_EQ(transport->RequestCount, 13);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(250));
+
+  EXPECT_THROW(
+      client.VerifyMany(SignatureAlgorithm::RS256, digests, {}, options), std::invalid_argument);
+}
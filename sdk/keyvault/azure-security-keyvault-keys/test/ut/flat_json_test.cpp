@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/internal/json/json.hpp>
+#include <azure/keyvault/shared/keyvault_flat_json.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::_internal;
+using Azure::Core::Json::_internal::json;
+
+namespace {
+constexpr static const char AlgorithmName[] = "alg";
+constexpr static const char ValueName[] = "value";
+constexpr static JsonKey AlgorithmKey(AlgorithmName);
+constexpr static JsonKey ValueKey(ValueName);
+
+std::vector<uint8_t> ToBody(std::string const& text) { return {text.begin(), text.end()}; }
+} // namespace
+
+TEST(FlatJson, WritesTheSameJsonAsTheDocument)
+{
+  static_assert(AlgorithmKey.Hash == JsonKey::ComputeHash("alg", 3), "hashed at compile time");
+
+  const std::string algorithm = "RS\"256\\\n";
+  const std::vector<uint8_t> value{0, 1, 2, 250, 251, 252, 253};
+  FlatJsonWriter writer(
+      FlatJsonWriter::StringPropertyLength(AlgorithmName, algorithm)
+      + FlatJsonWriter::Base64UrlPropertyLength(ValueName, value));
+  writer.WriteString(AlgorithmName, algorithm);
+  writer.WriteBase64Url(ValueName, value);
+  const std::string text = writer.Finish();
+
+  EXPECT_EQ(text, "{\"alg\":\"RS\\\"256\\\\\\u000a\",\"value\":\"AAEC-vv8_Q\"}");
+  auto const document = json::parse(text);
+  EXPECT_EQ(document["alg"].get<std::string>(), algorithm);
+  EXPECT_EQ(document["value"].get<std::string>(), "AAEC-vv8_Q");
+}
+
+TEST(FlatJson, ReadsTheProperties)
+{
+  const auto body = ToBody(
+      " { \"kid\" : \"https:\\/\\/vault\\u00e9\\ud83d\\ude00\", "
+      "\"nested\": {\"value\": [1, \"}\"]}, \"number\": -1.5e3, "
+      "\"value\":\"AAEC-vv8_Q\", \"valid\": true, \"iv\": null } ");
+  const FlatJsonReader reader(body);
+
+  EXPECT_EQ(reader.GetString(JsonKey("kid", 3)), "https://vault\xc3\xa9\xf0\x9f\x98\x80");
+  EXPECT_EQ(reader.GetBase64Url(ValueKey), (std::vector<uint8_t>{0, 1, 2, 250, 251, 252, 253}));
+  EXPECT_TRUE(reader.GetBool(JsonKey("valid", 5)));
+  EXPECT_TRUE(reader.Contains(ValueKey));
+  EXPECT_FALSE(reader.Contains(JsonKey("iv", 2)));
+  EXPECT_FALSE(reader.Contains(AlgorithmKey));
+  EXPECT_THROW(reader.GetString(AlgorithmKey), std::invalid_argument);
+  EXPECT_THROW(reader.GetBool(ValueKey), std::invalid_argument);
+}
+
+TEST(FlatJson, RejectsInvalidJson)
+{
+  for (auto const& text :
+       {"", "[]", "{\"value\":\"abc}", "{\"value\":tru}", "{\"value\":{\"a\":1}", "{\"a\" 1}"})
+  {
+    const auto body = ToBody(text);
+    EXPECT_THROW(FlatJsonReader{body}, std::invalid_argument) << text;
+  }
+  const auto body = ToBody("{}");
+  EXPECT_NO_THROW(FlatJsonReader{body});
+}
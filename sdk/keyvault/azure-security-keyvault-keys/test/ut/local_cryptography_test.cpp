@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/base64.hpp>
+#include <azure/core/http/transport.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/keyvault/keyvault_keys.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::Keys::Cryptography;
+using Azure::Core::_internal::Base64Url;
+
+namespace {
+const std::string KeyId = "https://vault.vault.azure.net/keys/key/version";
+
+// A 2048 bits RSA key, and an EC key on the P-256 curve.
+const std::string RsaKey = "{\"key\":{\"kid\":\"" + KeyId
+    + "\",\"kty\":\"RSA\",\"key_ops\":[\"encrypt\",\"verify\",\"wrapKey\"],\"n\":\""
+      "qRol77YCESm8v2-SwMZVaTN1mQ-Vax24HhMhoZnohsX3MnQXuzV8tVd7sqgtxjQGYpjmcMJMrcRhcM3B19Zkbs0iepIL"
+      "3VLhU0rQf0rOP78yxz4OyxpQAMq4hug6RB5nWGDvox7Pf3BWPMoGxGUal2z-IgShdc3W3DCZWnmIu7Bu_PgJWt-FWdj5"
+      "Z0kdp7EnfvlPARi9p2jU_LBrzxjQE11rB97Zvb8kxQ1dEVM9yKspCGVyYlC_W9ahjstRBcXFigriHJFi-u1aCGazwT4J"
+      "Hj_Q9BbI2ovoN891p4Xq4ifD5fboLGTUhMufqfiC6yoM4e2jnuQkYx8K7moDcivWuQ\",\"e\":\"AQAB\"},"
+      "\"attributes\":{\"enabled\":true}}";
+const std::string EcKey = "{\"key\":{\"kid\":\"" + KeyId
+    + "\",\"kty\":\"EC\",\"key_ops\":[\"sign\",\"verify\"],\"crv\":\"P-256\","
+      "\"x\":\"tGJax-7EnfHCmXiyK1rqrPVyCi8TafcZyY9aqGyCgag\","
+      "\"y\":\"h_HDQmEJlh1suadTTHyfSorKRCizrqMgf-WtmUnc0Ek\"},\"attributes\":{\"enabled\":true}}";
+
+// The data signed, and its signatures with the keys.
+const std::string SignedData = "local cryptography";
+const std::string Rs256Signature
+    = "ftntx3tcPut7zz4AGNKGEhuwrftd3v9ptjk4_y6qtnCbseH-dc8oBwJNBqTdDXvf1mFCfDtO6vbC_oSHDdlwpccz"
+      "AkTT-MWSsIh1t1cDoVTe2UyIujdkeK2R_up3rfvPo3X_ElEoAIyxVroTNyTz-5swopjedCerw_Idz3VHuBOIlfro"
+      "adAgjgzx0OuUPLtUcmNjZmumhem7mdbxBVe7KMhQm3h6qPgx6bJ-kvDCX_kmHkVGUlXpXc9VNhzuGy_kfeYg4ie8"
+      "WX7QzorwX4kSUvEGiyWN0ihPdPkaaylQuGnSz2a_IlWgR2nEJv4TUnA7TLGs6ABYY-IBH9oglxb74w";
+const std::string Ps256Signature
+    = "Nh6XZG_C-6R0Le_LMDTkzELtx8uquDpiklwc3jNNrD11u8NfLX6vfHlOEMxS0C55SNmfzDriR--nsp-LW5zLKSH0"
+      "mqzM6b9Yq3D5y00RZinUbxm8yJql1b9JQzFKtkNcWRtmToa41_Ocs45RygTlQTCiDXxXW3h0WZRM4Dpl_jS8qukQ"
+      "Rl9glrCL3v58VL8ycFew23-racICTSjZZ_gcR-Y9jI5RzHRGmlGZuW9aUw8_MXkN0W2RS2sPTq8pXNuslyNVdi4T"
+      "Olje1JYkwB6ZU70IGS73FGoL39Z4ll4f-AYbrsKSZRfUh-l9hpsu3InQDKYcsshIA-twOXJ2NyyM3A";
+const std::string Es256Signature
+    = "mhy6HyFFTwFzfIaBN_iLRQrI2e5qtnO9ffPvuPBTwqiQqXJhlJMzddmdz9wjX7VzHUgN97x5Eej6Pnr08w4v4g";
+
+class NonExpiringCredential final : public Azure::Core::Credentials::TokenCredential {
+public:
+  Azure::Core::Credentials::AccessToken GetToken(
+      Azure::Core::Credentials::TokenRequestContext const&,
+      Azure::Core::Context const&) const override
+  {
+    return {"magicToken", Azure::DateTime::clock::now() + std::chrono::hours(24)};
+  }
+};
+
+// Returns the key, or 403 when it's empty, and the results of the operations sent to the service.
+class MockKeyTransport final : public Azure::Core::Http::HttpTransport {
+public:
+  explicit MockKeyTransport(std::string key) : m_key(std::move(key)) {}
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Context const& context) override
+  {
+    const std::string path = request.GetUrl().GetPath();
+    auto requestBody = request.GetBodyStream()->ReadToEnd(context);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    Requests.push_back(request.GetMethod().ToString() + " " + path);
+    RequestBodies.emplace_back(requestBody.begin(), requestBody.end());
+    auto status = Azure::Core::Http::HttpStatusCode::Ok;
+    std::string body;
+    if (request.GetMethod() == Azure::Core::Http::HttpMethod::Get && m_key.empty())
+    {
+      status = Azure::Core::Http::HttpStatusCode::Forbidden;
+      body = "{}";
+    }
+    else if (request.GetMethod() == Azure::Core::Http::HttpMethod::Get)
+    {
+      body = m_key;
+    }
+    else if (path.find("/verify") != std::string::npos)
+    {
+      body = "{\"value\":true}";
+    }
+    else
+    {
+      body = "{\"kid\":\"" + KeyId + "\",\"value\":\"AAAA\"}";
+    }
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(1, 1, status, "");
+    response->SetHeader("content-type", "application/json");
+    // The bodies outlive the responses streaming them.
+    m_bodies.emplace_back(body.begin(), body.end());
+    response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+        m_bodies.back().data(), m_bodies.back().size()));
+    return response;
+  }
+
+  std::vector<std::string> Requests;
+  std::vector<std::string> RequestBodies;
+
+private:
+  std::string m_key;
+  std::mutex m_mutex;
+  std::deque<std::vector<uint8_t>> m_bodies;
+};
+
+CryptographyClient CreateLocalCryptographyClient(std::shared_ptr<MockKeyTransport> transport)
+{
+  CryptographyClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  options.Retry.MaxRetries = 0;
+  options.LocalPublicKeyOperations = true;
+  return CryptographyClient(KeyId, std::make_shared<NonExpiringCredential>(), options);
+}
+} // namespace
+
+TEST(LocalCryptography, VerifiesRsaSignaturesWithTheCachedKey)
+{
+  auto transport = std::make_shared<MockKeyTransport>(RsaKey);
+  auto client = CreateLocalCryptographyClient(transport);
+  const std::vector<uint8_t> data(SignedData.begin(), SignedData.end());
+
+  auto result = client.VerifyData(
+      SignatureAlgorithm::RS256, data, Base64Url::Base64UrlDecode(Rs256Signature));
+  EXPECT_TRUE(result.Value.IsValid);
+  EXPECT_EQ(result.Value.KeyId, KeyId);
+  EXPECT_TRUE(client
+                  .VerifyData(
+                      SignatureAlgorithm::PS256, data, Base64Url::Base64UrlDecode(Ps256Signature))
+                  .Value.IsValid);
+  auto tamperedSignature = Base64Url::Base64UrlDecode(Rs256Signature);
+  tamperedSignature[10] ^= 1;
+  EXPECT_FALSE(client.VerifyData(SignatureAlgorithm::RS256, data, tamperedSignature).Value.IsValid);
+  EXPECT_FALSE(client
+                   .VerifyData(
+                       SignatureAlgorithm::PS256, data, Base64Url::Base64UrlDecode(Rs256Signature))
+                   .Value.IsValid);
+
+  // The key is only fetched once.
+  EXPECT_EQ(transport->Requests, std::vector<std::string>{"GET keys/key/version"});
+}
+
+TEST(LocalCryptography, EncryptsAndWrapsWithRsaKeys)
+{
+  auto transport = std::make_shared<MockKeyTransport>(RsaKey);
+  auto client = CreateLocalCryptographyClient(transport);
+  const std::vector<uint8_t> plaintext(32, 'a');
+
+  auto encrypted = client.Encrypt(EncryptParameters::RsaOaep256Parameters(plaintext)).Value;
+  EXPECT_EQ(encrypted.KeyId, KeyId);
+  EXPECT_EQ(encrypted.Algorithm, EncryptionAlgorithm::RsaOaep256);
+  EXPECT_EQ(encrypted.Ciphertext.size(), 256U);
+  // OAEP is randomized.
+  EXPECT_NE(
+      client.Encrypt(EncryptParameters::RsaOaep256Parameters(plaintext)).Value.Ciphertext,
+      encrypted.Ciphertext);
+  EXPECT_EQ(
+      client.Encrypt(EncryptParameters::Rsa15Parameters(plaintext)).Value.Ciphertext.size(), 256U);
+
+  auto wrapped = client.WrapKey(KeyWrapAlgorithm::RsaOaep, plaintext).Value;
+  EXPECT_EQ(wrapped.KeyId, KeyId);
+  EXPECT_EQ(wrapped.EncryptedKey.size(), 256U);
+  EXPECT_EQ(transport->Requests, std::vector<std::string>{"GET keys/key/version"});
+
+  // The private key operations are performed by the service.
+  client.UnwrapKey(KeyWrapAlgorithm::RsaOaep, wrapped.EncryptedKey);
+  EXPECT_EQ(
+      transport->Requests,
+      (std::vector<std::string>{"GET keys/key/version", "POST keys/key/version/unwrapKey"}));
+}
+
+TEST(LocalCryptography, VerifiesEcSignatures)
+{
+  auto transport = std::make_shared<MockKeyTransport>(EcKey);
+  auto client = CreateLocalCryptographyClient(transport);
+  const std::vector<uint8_t> data(SignedData.begin(), SignedData.end());
+  auto signature = Base64Url::Base64UrlDecode(Es256Signature);
+
+  EXPECT_TRUE(client.VerifyData(SignatureAlgorithm::ES256, data, signature).Value.IsValid);
+  signature[40] ^= 1;
+  EXPECT_FALSE(client.VerifyData(SignatureAlgorithm::ES256, data, signature).Value.IsValid);
+  EXPECT_EQ(transport->Requests, std::vector<std::string>{"GET keys/key/version"});
+
+  // The algorithms of other curves, and the encryptions, are left to the service.
+  client.VerifyData(SignatureAlgorithm::ES384, data, signature);
+  client.WrapKey(KeyWrapAlgorithm::RsaOaep, data);
+  EXPECT_EQ(
+      transport->Requests,
+      (std::vector<std::string>{
+          "GET keys/key/version",
+          "POST keys/key/version/verify",
+          "POST keys/key/version/wrapKey"}));
+}
+
+TEST(LocalCryptography, FallsBackToTheServiceWithoutTheKey)
+{
+  auto transport = std::make_shared<MockKeyTransport>(std::string());
+  auto client = CreateLocalCryptographyClient(transport);
+  const std::vector<uint8_t> data(SignedData.begin(), SignedData.end());
+
+  EXPECT_TRUE(client.VerifyData(SignatureAlgorithm::RS256, data, std::vector<uint8_t>(256))
+                  .Value.IsValid);
+  EXPECT_TRUE(client.VerifyData(SignatureAlgorithm::RS256, data, std::vector<uint8_t>(256))
+                  .Value.IsValid);
+  EXPECT_EQ(
+      transport->Requests,
+      (std::vector<std::string>{
+          "GET keys/key/version",
+          "POST keys/key/version/verify",
+          "POST keys/key/version/verify"}));
+}
+
+TEST(LocalCryptography, SignsAndVerifiesStreamsAndFiles)
+{
+  auto transport = std::make_shared<MockKeyTransport>(RsaKey);
+  auto client = CreateLocalCryptographyClient(transport);
+
+  // A stream of several blocks is hashed like the same data in memory. The digests are signed by
+  // the service, the key is only fetched to verify.
+  std::vector<uint8_t> data(9 * 1024 * 1024 + 3);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    data[i] = static_cast<uint8_t>(i * 7 + i / 4096);
+  }
+  client.SignData(SignatureAlgorithm::RS256, data);
+  Azure::Core::IO::MemoryBodyStream stream(data);
+  client.SignData(SignatureAlgorithm::RS256, stream);
+  const std::vector<uint8_t> block(data.begin(), data.begin() + 4 * 1024 * 1024);
+  client.SignData(SignatureAlgorithm::RS256, block);
+  Azure::Core::IO::MemoryBodyStream blockStream(block);
+  client.SignData(SignatureAlgorithm::RS256, blockStream);
+  ASSERT_EQ(transport->RequestBodies.size(), size_t(4));
+  EXPECT_EQ(transport->RequestBodies[0], transport->RequestBodies[1]);
+  EXPECT_EQ(transport->RequestBodies[2], transport->RequestBodies[3]);
+  EXPECT_NE(transport->RequestBodies[0], transport->RequestBodies[2]);
+
+  const std::string fileName = "local_cryptography_signed_data";
+  {
+    std::ofstream file(fileName, std::ios::binary);
+    file << SignedData;
+  }
+  client.SignFile(SignatureAlgorithm::RS256, fileName);
+  client.SignData(
+      SignatureAlgorithm::RS256, std::vector<uint8_t>(SignedData.begin(), SignedData.end()));
+  ASSERT_EQ(transport->RequestBodies.size(), size_t(6));
+  EXPECT_EQ(transport->RequestBodies[4], transport->RequestBodies[5]);
+
+  EXPECT_TRUE(client
+                  .VerifyFile(
+                      SignatureAlgorithm::RS256,
+                      fileName,
+                      Base64Url::Base64UrlDecode(Rs256Signature))
+                  .Value.IsValid);
+  EXPECT_FALSE(client
+                   .VerifyFile(
+                       SignatureAlgorithm::PS256,
+                       fileName,
+                       Base64Url::Base64UrlDecode(Rs256Signature))
+                   .Value.IsValid);
+  std::remove(fileName.c_str());
+  EXPECT_THROW(
+      client.VerifyFile(
+          SignatureAlgorithm::RS256, fileName, Base64Url::Base64UrlDecode(Rs256Signature)),
+      std::runtime_error);
+}
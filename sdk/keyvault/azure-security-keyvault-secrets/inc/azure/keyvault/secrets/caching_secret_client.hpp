@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+/**
+ * @file
+ * @brief Defines the Key Vault Secret caching client.
+ *
+ */
+
+#pragma once
+
+#include "azure/keyvault/secrets/keyvault_options.hpp"
+#include "azure/keyvault/secrets/keyvault_secret.hpp"
+#include "azure/keyvault/secrets/secret_client.hpp"
+#include <azure/core/context.hpp>
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Secrets {
+
+  /**
+   * @brief The CachingSecretClient serves the secrets of a #SecretClient from an in-memory cache,
+   * so that the secrets read over and over don't each cost a request to the Key Vault.
+   *
+   * @remark A secret is fetched again once its time to live has passed. During the stale period
+   * that follows, the cached secret is still returned and a background thread fetches it again.
+   * The concurrent calls missing the same secret wait for a single request. The secrets of a
+   * specific version never change, so they are cached without expiring. The requests are sent
+   * through the pipeline of the secret client.
+   */
+  class CachingSecretClient final {
+  public:
+    /**
+     * @brief Construct a new CachingSecretClient object, and start its background refresh.
+     *
+     * @param secretClient The client fetching the secrets, its pipeline is shared.
+     * @param options The options to customize the cache.
+     */
+    explicit CachingSecretClient(
+        SecretClient const& secretClient,
+        CachingSecretClientOptions const& options = CachingSecretClientOptions());
+
+    /**
+     * @brief Stop the background refresh, cancelling the request in progress.
+     *
+     */
+    ~CachingSecretClient();
+
+    CachingSecretClient(CachingSecretClient const&) = delete;
+    CachingSecretClient& operator=(CachingSecretClient const&) = delete;
+
+    /**
+     * @brief Get a secret from the cache, or from the Key Vault if it's not cached or expired.
+     *
+     * @param name The name of the secret.
+     * @param options The optional parameters for this request.
+     * @param context The context for the operation can be used for request cancellation.
+     * @return The Secret.
+     */
+    KeyVaultSecret GetSecret(
+        std::string const& name,
+        GetSecretOptions const& options = GetSecretOptions(),
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Remove a secret from the cache, all its versions included. It is fetched at the next
+     * call.
+     *
+     * @param name The name of the secret.
+     */
+    void Invalidate(std::string const& name);
+
+  private:
+    struct State;
+
+    std::unique_ptr<State> m_state;
+  };
+
+}}}} // namespace Azure::Security::KeyVault::Secrets
@@ -9,6 +9,10 @@
 #include "azure/keyvault/secrets/dll_import_export.hpp"
 #include <azure/core/internal/client_options.hpp>
 
+#include <chrono>
+#include <map>
+#include <string>
+
 namespace Azure { namespace Security { namespace KeyVault { namespace Secrets {
 
   class ServiceVersion final {
@@ -114,4 +118,59 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Secrets {
   {
     Azure::Nullable<std::string> NextPageToken;
   };
+
+  /**
+   * @brief Define the options to create a #CachingSecretClient.
+   *
+   */
+  struct CachingSecretClientOptions final
+  {
+    /**
+     * @brief How long a secret is served from the cache before it is fetched again.
+     *
+     */
+    std::chrono::milliseconds TimeToLive = std::chrono::minutes(5);
+
+    /**
+     * @brief The time to live of specific secrets, by name, overriding #TimeToLive.
+     *
+     */
+    std::map<std::string, std::chrono::milliseconds> SecretTimeToLives;
+
+    /**
+     * @brief How long an expired secret is still served while it is fetched again in the
+     * background. Once it has passed, the secret is fetched before being returned.
+     *
+     */
+    std::chrono::milliseconds StaleWhileRevalidate = std::chrono::minutes(1);
+
+    /**
+     * @brief The version of specific secrets, by name, which is returned when no version is
+     * requested.
+     *
+     */
+    std::map<std::string, std::string> PinnedVersions;
+  };
+
+  /**
+   * @brief The options for calling an operation #SecretClient::ExportSecrets.
+   *
+   */
+  struct ExportSecretsOptions final
+  {
+    /**
+     * @brief The maximum number of secrets fetched concurrently.
+     *
+     * @remark All the fetches pause for the delay requested by the service when a request is
+     * throttled, the throttled secret is then fetched again.
+     */
+    int32_t Concurrency = 16;
+
+    /**
+     * @brief The maximum number of secrets fetched per second, to stay below the limits of the
+     * Key Vault. Not limited when it's 0.
+     *
+     */
+    int32_t MaxRequestsPerSecond = 0;
+  };
 }}}} // namespace Azure::Security::KeyVault::Secrets
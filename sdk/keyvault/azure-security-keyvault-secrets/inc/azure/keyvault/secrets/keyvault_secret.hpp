@@ -8,6 +8,9 @@
 
 #pragma once
 #include "azure/keyvault/secrets/keyvault_secret_properties.hpp"
+#include <azure/core/nullable.hpp>
+
+#include <exception>
 
 namespace Azure { namespace Security { namespace KeyVault { namespace Secrets {
   struct KeyVaultSecret
@@ -74,4 +77,29 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Secrets {
     friend struct DeletedSecret;
   };
 
+  /**
+   * @brief A secret listed by #SecretClient::ExportSecrets, along with its value.
+   *
+   */
+  struct ExportedSecret final
+  {
+    /**
+     * @brief The properties of the secret, as listed.
+     *
+     */
+    SecretProperties Properties;
+
+    /**
+     * @brief The secret fetched, null when it is disabled or couldn't be fetched.
+     *
+     */
+    Azure::Nullable<KeyVaultSecret> Secret;
+
+    /**
+     * @brief The error raised fetching the secret, null when it was fetched.
+     *
+     */
+    std::exception_ptr Error;
+  };
+
 }}}} // namespace Azure::Security::KeyVault::Secrets
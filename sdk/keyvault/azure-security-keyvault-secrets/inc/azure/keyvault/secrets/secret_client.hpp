@@ -18,6 +18,7 @@
 #include <azure/core/http/http.hpp>
 #include <azure/core/internal/http/pipeline.hpp>
 #include <azure/core/response.hpp>
+#include <functional>
 #include <stdint.h>
 #include <string>
 
@@ -178,6 +179,40 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Secrets {
         BackupSecretResult const& backup,
         Azure::Core::Context const& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Back up the specified secret to a file.
+     * The backup is decoded straight from the response into the file. Unlike #BackupSecret(),
+     * it's never held in memory as a whole: the response is read and decoded by blocks of up to
+     * 64 KiB, so several secrets can be backed up at the same time from different threads with a
+     * bounded amount of memory each.
+     * This operation requires the secrets/backup permission.
+     *
+     * @param name The name of the secret.
+     * @param fileName The file to write the backup to. It's overwritten if it exists.
+     * @param context The context for the operation can be used for request cancellation.
+     *
+     * @return The number of bytes of the backup written to the file.
+     */
+    Azure::Response<int64_t> BackupSecretTo(
+        std::string const& name,
+        std::string const& fileName,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Restore a secret from a backup file written by #BackupSecretTo().
+     * The backup is read from the file and encoded into the request by blocks of 48 KiB, it's
+     * never held in memory as a whole.
+     * This operation requires the secrets/restore permission.
+     *
+     * @param fileName The file to read the backup from.
+     * @param context The context for the operation can be used for request cancellation.
+     *
+     * @return The Secret wrapped in the Response.
+     */
+    Azure::Response<KeyVaultSecret> RestoreSecretBackupFrom(
+        std::string const& fileName,
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
     /**
      * @brief Permanently deletes the specified secret.
      * The purge deleted secret operation removes the secret permanently, without the possibility of
@@ -271,6 +306,23 @@ namespace Azure { namespace Security { namespace KeyVault { namespace Secrets {
         GetDeletedSecretsOptions const& options = GetDeletedSecretsOptions(),
         Azure::Core::Context const& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Fetches the latest version of all the secrets in the vault.
+     * The pages of secrets are listed while the secrets of the previous ones are fetched
+     * concurrently. This operation requires the secrets/list and secrets/get permissions.
+     *
+     * @remark The callback is called once for every secret listed, from the threads fetching
+     * them, one call at a time. Its first exception stops the export and is thrown.
+     *
+     * @param onSecret The callback receiving the secrets fetched, along with the errors.
+     * @param options The optional parameters for this request.
+     * @param context The context for the operation can be used for request cancellation.
+     */
+    void ExportSecrets(
+        std::function<void(ExportedSecret const&)> const& onSecret,
+        ExportSecretsOptions const& options = ExportSecretsOptions(),
+        Azure::Core::Context const& context = Azure::Core::Context()) const;
+
     /**
      * @brief Gets the secret client's primary URL endpoint.
      *
@@ -0,0 +1,228 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @brief Keyvault Secrets caching client definition.
+ *
+ */
+
+#include "azure/keyvault/secrets/caching_secret_client.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+using namespace Azure::Security::KeyVault::Secrets;
+
+namespace {
+// Waits are split so that a cancelled context is noticed quickly.
+constexpr std::chrono::milliseconds MaxWaitDuration(100);
+} // namespace
+
+struct CachingSecretClient::State final
+{
+  State(SecretClient const& secretClient, CachingSecretClientOptions const& options)
+      : Client(secretClient), Options(options)
+  {
+  }
+
+  // The name and the version of a secret, the version is empty for the latest one.
+  using SecretKey = std::pair<std::string, std::string>;
+
+  struct Entry final
+  {
+    Azure::Nullable<KeyVaultSecret> Secret;
+    std::chrono::steady_clock::time_point ExpiresOn;
+    // Only one request is sent for a secret at a time.
+    bool Fetching = false;
+  };
+
+  SecretClient Client;
+  CachingSecretClientOptions Options;
+  // Cancelled when the client is destroyed.
+  Azure::Core::Context RefreshContext;
+
+  std::mutex Mutex;
+  // Notified when a secret is fetched or fails to be, when a refresh is requested and when the
+  // client is destroyed.
+  std::condition_variable Changed;
+  std::map<SecretKey, Entry> Entries;
+  // The secrets served stale, to fetch again in the background.
+  std::deque<SecretKey> PendingRefreshes;
+  bool Stopping = false;
+
+  std::thread RefreshThread;
+
+  void RefreshSecrets();
+  // Caches a secret fetched. The mutex must be held.
+  void StoreSecret(SecretKey const& key, KeyVaultSecret secret);
+};
+
+void CachingSecretClient::State::RefreshSecrets()
+{
+  std::unique_lock<std::mutex> lock(Mutex);
+  while (!Stopping)
+  {
+    if (PendingRefreshes.empty())
+    {
+      Changed.wait(lock);
+      continue;
+    }
+    SecretKey key = std::move(PendingRefreshes.front());
+    PendingRefreshes.pop_front();
+    lock.unlock();
+    Azure::Nullable<KeyVaultSecret> secret;
+    try
+    {
+      GetSecretOptions options;
+      options.Version = key.second;
+      secret = Client.GetSecret(key.first, options, RefreshContext).Value;
+    }
+    catch (...)
+    {
+      // The stale secret is served until the stale period passes, then it is fetched by the
+      // caller, which gets the error if it persists.
+    }
+    lock.lock();
+    auto entry = Entries.find(key);
+    // The secret may have been invalidated meanwhile.
+    if (entry != Entries.end())
+    {
+      entry->second.Fetching = false;
+      if (secret.HasValue())
+      {
+        StoreSecret(key, std::move(secret.Value()));
+      }
+    }
+    Changed.notify_all();
+  }
+}
+
+void CachingSecretClient::State::StoreSecret(SecretKey const& key, KeyVaultSecret secret)
+{
+  auto& entry = Entries[key];
+  entry.Secret = std::move(secret);
+  if (key.second.empty())
+  {
+    auto timeToLive = Options.SecretTimeToLives.find(key.first);
+    entry.ExpiresOn = std::chrono::steady_clock::now()
+        + (timeToLive == Options.SecretTimeToLives.end() ? Options.TimeToLive
+                                                         : timeToLive->second);
+  }
+  else
+  {
+    // A version of a secret never changes.
+    entry.ExpiresOn = std::chrono::steady_clock::time_point::max();
+  }
+}
+
+CachingSecretClient::CachingSecretClient(
+    SecretClient const& secretClient,
+    CachingSecretClientOptions const& options)
+    : m_state(std::make_unique<State>(secretClient, options))
+{
+  State* state = m_state.get();
+  m_state->RefreshThread = std::thread([state]() { state->RefreshSecrets(); });
+}
+
+CachingSecretClient::~CachingSecretClient()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    m_state->Stopping = true;
+  }
+  m_state->RefreshContext.Cancel();
+  m_state->Changed.notify_all();
+  m_state->RefreshThread.join();
+}
+
+KeyVaultSecret CachingSecretClient::GetSecret(
+    std::string const& name,
+    GetSecretOptions const& options,
+    Azure::Core::Context const& context) const
+{
+  State& state = *m_state;
+  State::SecretKey key(name, options.Version);
+  if (key.second.empty())
+  {
+    auto pinnedVersion = state.Options.PinnedVersions.find(name);
+    if (pinnedVersion != state.Options.PinnedVersions.end())
+    {
+      key.second = pinnedVersion->second;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  while (true)
+  {
+    auto& entry = state.Entries[key];
+    const auto now = std::chrono::steady_clock::now();
+    if (entry.Secret.HasValue() && now < entry.ExpiresOn)
+    {
+      return entry.Secret.Value();
+    }
+    if (entry.Secret.HasValue() && now - entry.ExpiresOn < state.Options.StaleWhileRevalidate)
+    {
+      if (!entry.Fetching)
+      {
+        entry.Fetching = true;
+        state.PendingRefreshes.push_back(key);
+        state.Changed.notify_all();
+      }
+      return entry.Secret.Value();
+    }
+    if (!entry.Fetching)
+    {
+      entry.Fetching = true;
+      break;
+    }
+    // The request in progress is awaited, a failed one is sent again by one of the callers.
+    context.ThrowIfCancelled();
+    state.Changed.wait_for(lock, MaxWaitDuration);
+  }
+  lock.unlock();
+
+  KeyVaultSecret secret;
+  try
+  {
+    GetSecretOptions getOptions;
+    getOptions.Version = key.second;
+    secret = state.Client.GetSecret(name, getOptions, context).Value;
+  }
+  catch (...)
+  {
+    lock.lock();
+    auto entry = state.Entries.find(key);
+    if (entry != state.Entries.end())
+    {
+      entry->second.Fetching = false;
+    }
+    state.Changed.notify_all();
+    throw;
+  }
+  lock.lock();
+  auto entry = state.Entries.find(key);
+  // The secret fetched isn't cached if it was invalidated meanwhile, it may be outdated.
+  if (entry != state.Entries.end())
+  {
+    entry->second.Fetching = false;
+    state.StoreSecret(key, secret);
+  }
+  state.Changed.notify_all();
+  return secret;
+}
+
+void CachingSecretClient::Invalidate(std::string const& name)
+{
+  std::lock_guard<std::mutex> guard(m_state->Mutex);
+  auto entry = m_state->Entries.lower_bound(State::SecretKey(name, std::string()));
+  while (entry != m_state->Entries.end() && entry->first.first == name)
+  {
+    entry = m_state->Entries.erase(entry);
+  }
+}
@@ -14,15 +14,17 @@ Azure::Response<SecretProperties> RecoverDeletedSecretOperation::PollUntilDoneIn
     std::chrono::milliseconds period,
     Azure::Core::Context& context)
 {
+  int32_t pollCount = 0;
   while (true)
   {
     // Poll will update the raw response.
+    ++pollCount;
     Poll(context);
     if (IsDone())
     {
       break;
     }
-    std::this_thread::sleep_for(period);
+    WaitBeforeNextPoll(period, pollCount, context);
   }
 
   return Azure::Response<SecretProperties>(
@@ -106,14 +108,16 @@ Azure::Response<DeletedSecret> DeleteSecretOperation::PollUntilDoneInternal(
     std::chrono::milliseconds period,
     Azure::Core::Context& context)
 {
+  int32_t pollCount = 0;
   while (true)
   {
+    ++pollCount;
     Poll(context);
     if (IsDone())
     {
       break;
     }
-    std::this_thread::sleep_for(period);
+    WaitBeforeNextPoll(period, pollCount, context);
   }
 
   return Azure::Response<DeletedSecret>(
@@ -5,6 +5,7 @@
 #include "private/secret_constants.hpp"
 #include <azure/core/exception.hpp>
 #include <azure/core/http/http.hpp>
+#include <azure/keyvault/shared/keyvault_backup_stream.hpp>
 
 using namespace Azure::Security::KeyVault;
 using namespace Azure::Core::Http::_internal;
@@ -12,11 +13,12 @@ using namespace Azure::Core::Http::_internal;
 Azure::Core::Http::Request _detail::KeyVaultProtocolClient::CreateRequest(
     Azure::Core::Http::HttpMethod method,
     Azure::Core::IO::BodyStream* content,
-    std::vector<std::string> const& path) const
+    std::vector<std::string> const& path,
+    bool shouldBufferResponse) const
 {
   Azure::Core::Http::Request request = content == nullptr
-      ? Azure::Core::Http::Request(method, m_vaultUrl)
-      : Azure::Core::Http::Request(method, m_vaultUrl, content);
+      ? Azure::Core::Http::Request(method, m_vaultUrl, shouldBufferResponse)
+      : Azure::Core::Http::Request(method, m_vaultUrl, content, shouldBufferResponse);
 
   request.SetHeader(HttpShared::ContentType, HttpShared::ApplicationJson);
   request.SetHeader(HttpShared::Accept, HttpShared::ApplicationJson);
@@ -57,6 +59,7 @@ std::unique_ptr<Azure::Core::Http::RawResponse> _detail::KeyVaultProtocolClient:
     case Azure::Core::Http::HttpStatusCode::NoContent:
       break;
     default:
+      Azure::Security::KeyVault::_internal::BufferErrorResponse(*response, context);
       throw Azure::Core::RequestFailedException(response);
   }
   return response;
@@ -48,12 +48,14 @@ namespace Azure { namespace Security { namespace KeyVault { namespace _detail {
      * @param method The HTTP method.
      * @param content The HTTP payload.
      * @param path The HTTP request path.
+     * @param shouldBufferResponse Whether the body of the response is buffered.
      * @return A constructed request.
      */
     Azure::Core::Http::Request CreateRequest(
         Azure::Core::Http::HttpMethod method,
         Azure::Core::IO::BodyStream* content,
-        std::vector<std::string> const& path) const;
+        std::vector<std::string> const& path,
+        bool shouldBufferResponse = true) const;
 
     /**
      * @brief Start the HTTP transfer based on the \p request.
@@ -167,6 +169,51 @@ namespace Azure { namespace Security { namespace KeyVault { namespace _detail {
       return Azure::Response<T>(value, std::move(response));
     }
 
+    /**
+     * @brief Create and send the HTTP request with a payload stream. Uses the \p factoryFn
+     * function to create the response type.
+     *
+     * @param context The context for per-operation options or cancellation.
+     * @param method The method for the request.
+     * @param content The HTTP payload, read as the request is sent.
+     * @param factoryFn The function to deserialize and produce T from the raw response.
+     * @param path A path for the request represented as a vector of strings.
+     * @return The object produced by the \p factoryFn and the raw response from the network.
+     */
+    template <class T>
+    Azure::Response<T> SendRequest(
+        Azure::Core::Context const& context,
+        Azure::Core::Http::HttpMethod method,
+        Azure::Core::IO::BodyStream& content,
+        std::function<T(Azure::Core::Http::RawResponse const& rawResponse)> factoryFn,
+        std::vector<std::string> const& path)
+    {
+      auto request = CreateRequest(method, &content, path);
+      auto response = SendRequest(context, request);
+      // Saving the value in a local is required before passing it in to Response<T> to avoid
+      // compiler optimizations re-ordering the `factoryFn` function call and the RawResponse move.
+      T value = factoryFn(*response);
+      return Azure::Response<T>(std::move(value), std::move(response));
+    }
+
+    /**
+     * @brief Create and send the HTTP request without buffering the response, checking the
+     * response code.
+     *
+     * @param context The context for per-operation options or cancellation.
+     * @param method The HTTP method for the request.
+     * @param path The path for the request.
+     * @return The raw response, the body of which is read from its body stream.
+     */
+    std::unique_ptr<Azure::Core::Http::RawResponse> SendStreamingRequest(
+        Azure::Core::Context const& context,
+        Azure::Core::Http::HttpMethod method,
+        std::vector<std::string> const& path) const
+    {
+      auto request = CreateRequest(method, nullptr, path, false);
+      return SendRequest(context, request);
+    }
+
     /**
      * @brief Create a key vault request and send it using the Azure Core pipeline directly to avoid
      * checking the respone code.
@@ -13,14 +13,24 @@
 #include "private/secret_constants.hpp"
 #include "private/secret_serializers.hpp"
 
+#include <azure/keyvault/shared/keyvault_backup_stream.hpp>
 #include <azure/keyvault/shared/keyvault_shared.hpp>
 
 #include <azure/core/credentials/credentials.hpp>
+#include <azure/core/exception.hpp>
 #include <azure/core/http/http.hpp>
 #include <azure/core/http/policies/policy.hpp>
+#include <azure/core/internal/diagnostics/span.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace Azure::Security::KeyVault::Secrets;
 using namespace Azure::Core::Http::Policies;
@@ -56,6 +66,57 @@ static inline RequestWithContinuationToken BuildRequestFromContinuationToken(
   return request;
 }
 
+// The number of times a secret throttled by the service is fetched again, once the retries of the
+// pipeline are exhausted.
+constexpr int32_t MaxThrottledRetries = 3;
+// Waits are split so that a cancelled context is noticed quickly.
+constexpr std::chrono::milliseconds MaxWaitDuration(100);
+
+// The delay requested by the service for a throttled request.
+std::chrono::milliseconds GetThrottlingDelay(Azure::Core::Http::RawResponse const* response)
+{
+  if (response != nullptr)
+  {
+    auto const& headers = response->GetHeaders();
+    try
+    {
+      auto header = headers.find("retry-after-ms");
+      if (header != headers.end()
+          || (header = headers.find("x-ms-retry-after-ms")) != headers.end())
+      {
+        return std::chrono::milliseconds(std::stoi(header->second));
+      }
+      header = headers.find("retry-after");
+      if (header != headers.end())
+      {
+        return std::chrono::seconds(std::stoi(header->second));
+      }
+    }
+    catch (std::exception const&)
+    {
+      // The HTTP dates of the retry-after header aren't parsed, like in the retry policy.
+    }
+  }
+  return std::chrono::seconds(1);
+}
+
+// The secrets listed by an export and not fetched yet, shared by its threads.
+struct ExportState final
+{
+  std::mutex Mutex;
+  // Notified when a secret is listed or taken, and when the export stops.
+  std::condition_variable Changed;
+  std::deque<SecretProperties> Pending;
+  bool ListingDone = false;
+  bool Stopping = false;
+  // Delayed by the rate limit, and by the service when a request is throttled.
+  std::chrono::steady_clock::time_point NextRequestAt;
+  std::exception_ptr CallbackError;
+
+  // The callback is called one secret at a time.
+  std::mutex CallbackMutex;
+};
+
 } // namespace
 
 const ServiceVersion ServiceVersion::V7_2("7.2");
@@ -89,8 +150,9 @@ Azure::Response<KeyVaultSecret> SecretClient::GetSecret(
     GetSecretOptions const& options,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.GetSecret", context);
   return m_protocolClient->SendRequest<KeyVaultSecret>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Get,
       [&name](Azure::Core::Http::RawResponse const& rawResponse) {
         return _detail::SecretSerializer::Deserialize(name, rawResponse);
@@ -102,8 +164,9 @@ Azure::Response<DeletedSecret> SecretClient::GetDeletedSecret(
     std::string const& name,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.GetDeletedSecret", context);
   return m_protocolClient->SendRequest<DeletedSecret>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Get,
       [&name](Azure::Core::Http::RawResponse const& rawResponse) {
         return _detail::DeletedSecretSerializer::Deserialize(name, rawResponse);
@@ -125,8 +188,9 @@ Azure::Response<KeyVaultSecret> SecretClient::SetSecret(
     KeyVaultSecret const& secret,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.SetSecret", context);
   return m_protocolClient->SendRequest<KeyVaultSecret>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Put,
       [&secret]() { return _detail::SecretSerializer::Serialize(secret); },
       [&name](Azure::Core::Http::RawResponse const& rawResponse) {
@@ -139,8 +203,9 @@ Azure::Response<KeyVaultSecret> SecretClient::UpdateSecretProperties(
     SecretProperties const& properties,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.UpdateSecretProperties", context);
   return m_protocolClient->SendRequest<KeyVaultSecret>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Patch,
       [&properties]() { return _detail::SecretPropertiesSerializer::Serialize(properties); },
       [&properties](Azure::Core::Http::RawResponse const& rawResponse) {
@@ -153,8 +218,9 @@ Azure::Response<BackupSecretResult> SecretClient::BackupSecret(
     std::string const& name,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.BackupSecret", context);
   return m_protocolClient->SendRequest<BackupSecretResult>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Post,
       [](Azure::Core::Http::RawResponse const& rawResponse) {
         return _detail::BackupSecretSerializer::Deserialize(rawResponse);
@@ -166,8 +232,9 @@ Azure::Response<KeyVaultSecret> SecretClient::RestoreSecretBackup(
     BackupSecretResult const& backup,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.RestoreSecretBackup", context);
   return m_protocolClient->SendRequest<KeyVaultSecret>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Post,
       [&backup]() { return _detail::RestoreSecretSerializer::Serialize(backup.Secret); },
       [](Azure::Core::Http::RawResponse const& rawResponse) {
@@ -176,12 +243,47 @@ Azure::Response<KeyVaultSecret> SecretClient::RestoreSecretBackup(
       {_detail::SecretPath, _detail::RestoreSecretPath});
 }
 
+Azure::Response<int64_t> SecretClient::BackupSecretTo(
+    std::string const& name,
+    std::string const& fileName,
+    Azure::Core::Context const& context) const
+{
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.BackupSecretTo", context);
+  // The response isn't buffered, the backup is decoded from the body stream into the file.
+  auto rawResponse = m_protocolClient->SendStreamingRequest(
+      span.GetContext(),
+      Azure::Core::Http::HttpMethod::Post,
+      {_detail::SecretPath, name, _detail::BackupSecretPath});
+  auto const length = Azure::Security::KeyVault::_internal::WriteBackupToFile(
+      *rawResponse, fileName, span.GetContext());
+  return Azure::Response<int64_t>(length, std::move(rawResponse));
+}
+
+Azure::Response<KeyVaultSecret> SecretClient::RestoreSecretBackupFrom(
+    std::string const& fileName,
+    Azure::Core::Context const& context) const
+{
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.RestoreSecretBackupFrom", context);
+  // The payload encodes the backup as it's read from the file.
+  Azure::Core::IO::FileBodyStream backupStream(fileName);
+  Azure::Security::KeyVault::_internal::BackupPayloadStream payloadStream(backupStream);
+  return m_protocolClient->SendRequest<KeyVaultSecret>(
+      span.GetContext(),
+      Azure::Core::Http::HttpMethod::Post,
+      payloadStream,
+      [](Azure::Core::Http::RawResponse const& rawResponse) {
+        return _detail::SecretSerializer::Deserialize(rawResponse);
+      },
+      {_detail::SecretPath, _detail::RestoreSecretPath});
+}
+
 Azure::Response<PurgedSecret> SecretClient::PurgeDeletedSecret(
     std::string const& name,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.PurgeDeletedSecret", context);
   return m_protocolClient->SendRequest<PurgedSecret>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Delete,
       [](Azure::Core::Http::RawResponse const&) { return PurgedSecret(); },
       {_detail::DeletedSecretPath, name});
@@ -191,10 +293,11 @@ Azure::Security::KeyVault::Secrets::DeleteSecretOperation SecretClient::StartDel
     std::string const& name,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.StartDeleteSecret", context);
   return Azure::Security::KeyVault::Secrets::DeleteSecretOperation(
       std::make_shared<SecretClient>(*this),
       m_protocolClient->SendRequest<DeletedSecret>(
-          context,
+          span.GetContext(),
           Azure::Core::Http::HttpMethod::Delete,
           [&name](Azure::Core::Http::RawResponse const& rawResponse) {
             return _detail::DeletedSecretSerializer::Deserialize(name, rawResponse);
@@ -205,10 +308,11 @@ Azure::Security::KeyVault::Secrets::DeleteSecretOperation SecretClient::StartDel
 Azure::Security::KeyVault::Secrets::RecoverDeletedSecretOperation SecretClient::
     StartRecoverDeletedSecret(std::string const& name, Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.StartRecoverDeletedSecret", context);
   return Azure::Security::KeyVault::Secrets::RecoverDeletedSecretOperation(
       std::make_shared<SecretClient>(*this),
       m_protocolClient->SendRequest<SecretProperties>(
-          context,
+          span.GetContext(),
           Azure::Core::Http::HttpMethod::Post,
           [&name](Azure::Core::Http::RawResponse const& rawResponse) {
             auto parsedResponse = _detail::SecretSerializer::Deserialize(name, rawResponse);
@@ -221,11 +325,12 @@ SecretPropertiesPagedResponse SecretClient::GetPropertiesOfSecrets(
     GetPropertiesOfSecretsOptions const& options,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.GetPropertiesOfSecrets", context);
   auto const request
       = BuildRequestFromContinuationToken(options.NextPageToken, {_detail::SecretPath});
 
   auto response = m_protocolClient->SendRequest<SecretPropertiesPagedResponse>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Get,
       [](Azure::Core::Http::RawResponse const& rawResponse) {
         return _detail::SecretPropertiesPagedResultSerializer::Deserialize(rawResponse);
@@ -244,11 +349,13 @@ SecretPropertiesPagedResponse SecretClient::GetPropertiesOfSecretsVersions(
     GetPropertiesOfSecretVersionsOptions const& options,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span(
+      "SecretClient.GetPropertiesOfSecretsVersions", context);
   auto const request = BuildRequestFromContinuationToken(
       options.NextPageToken, {_detail::SecretPath, name, _detail::VersionsName});
 
   auto response = m_protocolClient->SendRequest<SecretPropertiesPagedResponse>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Get,
       [](Azure::Core::Http::RawResponse const& rawResponse) {
         return _detail::SecretPropertiesPagedResultSerializer::Deserialize(rawResponse);
@@ -267,11 +374,12 @@ DeletedSecretPagedResponse SecretClient::GetDeletedSecrets(
     GetDeletedSecretsOptions const& options,
     Azure::Core::Context const& context) const
 {
+  Azure::Core::Diagnostics::_internal::Span span("SecretClient.GetDeletedSecrets", context);
   auto const request
       = BuildRequestFromContinuationToken(options.NextPageToken, {_detail::DeletedSecretPath});
 
   auto response = m_protocolClient->SendRequest<DeletedSecretPagedResponse>(
-      context,
+      span.GetContext(),
       Azure::Core::Http::HttpMethod::Get,
       [](Azure::Core::Http::RawResponse const& rawResponse) {
         return _detail::DeletedSecretPagedResultSerializer::Deserialize(rawResponse);
@@ -285,4 +393,180 @@ DeletedSecretPagedResponse SecretClient::GetDeletedSecrets(
       std::make_unique<SecretClient>(*this));
 }
 
+void SecretClient::ExportSecrets(
+    std::function<void(ExportedSecret const&)> const& onSecret,
+    ExportSecretsOptions const& options,
+    Azure::Core::Context const& context) const
+{
+  ExportState state;
+  size_t const threadCount = static_cast<size_t>(std::max(options.Concurrency, int32_t(1)));
+  // The secrets listed ahead of the fetches, the next page being prefetched meanwhile.
+  size_t const maxPending = threadCount * 2;
+  auto const requestInterval = options.MaxRequestsPerSecond > 0
+      ? std::chrono::steady_clock::duration(std::chrono::seconds(1)) / options.MaxRequestsPerSecond
+      : std::chrono::steady_clock::duration::zero();
+
+  // Returns false when the export stops before the request can be sent.
+  auto waitForRequest = [&]() {
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    while (!state.Stopping && !context.IsCancelled())
+    {
+      auto const now = std::chrono::steady_clock::now();
+      if (now >= state.NextRequestAt)
+      {
+        state.NextRequestAt = now + requestInterval;
+        return true;
+      }
+      state.Changed.wait_for(
+          lock,
+          std::min<std::chrono::steady_clock::duration>(
+              state.NextRequestAt - now, MaxWaitDuration));
+    }
+    return false;
+  };
+
+  auto fetchSecrets = [&]() {
+    while (true)
+    {
+      ExportedSecret exported;
+      {
+        std::unique_lock<std::mutex> lock(state.Mutex);
+        while (!state.Stopping && state.Pending.empty() && !state.ListingDone
+               && !context.IsCancelled())
+        {
+          state.Changed.wait_for(lock, MaxWaitDuration);
+        }
+        if (state.Stopping || state.Pending.empty() || context.IsCancelled())
+        {
+          return;
+        }
+        exported.Properties = std::move(state.Pending.front());
+        state.Pending.pop_front();
+        state.Changed.notify_all();
+      }
+
+      // The value of a disabled secret can't be fetched.
+      for (int32_t retry = 0; exported.Properties.Enabled.ValueOr(true); ++retry)
+      {
+        if (!waitForRequest())
+        {
+          return;
+        }
+        try
+        {
+          exported.Secret = GetSecret(exported.Properties.Name, GetSecretOptions(), context).Value;
+        }
+        catch (Azure::Core::RequestFailedException const& e)
+        {
+          if (e.StatusCode == Azure::Core::Http::HttpStatusCode::TooManyRequests
+              && retry < MaxThrottledRetries)
+          {
+            auto const resumeAt
+                = std::chrono::steady_clock::now() + GetThrottlingDelay(e.RawResponse.get());
+            std::lock_guard<std::mutex> guard(state.Mutex);
+            state.NextRequestAt = std::max(state.NextRequestAt, resumeAt);
+            continue;
+          }
+          exported.Error = std::current_exception();
+        }
+        catch (...)
+        {
+          exported.Error = std::current_exception();
+        }
+        break;
+      }
+      if (context.IsCancelled())
+      {
+        return;
+      }
+
+      std::lock_guard<std::mutex> callbackGuard(state.CallbackMutex);
+      {
+        std::lock_guard<std::mutex> guard(state.Mutex);
+        if (state.Stopping)
+        {
+          return;
+        }
+      }
+      try
+      {
+        onSecret(exported);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> guard(state.Mutex);
+        state.CallbackError = std::current_exception();
+        state.Stopping = true;
+        state.Changed.notify_all();
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < threadCount; ++i)
+  {
+    threads.emplace_back(fetchSecrets);
+  }
+
+  std::exception_ptr listingError;
+  try
+  {
+    auto page = GetPropertiesOfSecrets(GetPropertiesOfSecretsOptions(), context);
+    page.EnablePrefetch(context);
+    bool stopping = false;
+    while (page.HasPage() && !stopping)
+    {
+      for (auto& item : page.Items)
+      {
+        std::unique_lock<std::mutex> lock(state.Mutex);
+        while (!state.Stopping && state.Pending.size() >= maxPending)
+        {
+          context.ThrowIfCancelled();
+          state.Changed.wait_for(lock, MaxWaitDuration);
+        }
+        stopping = state.Stopping;
+        if (stopping)
+        {
+          break;
+        }
+        state.Pending.push_back(std::move(item));
+        state.Changed.notify_all();
+      }
+      if (!stopping)
+      {
+        page.MoveToNextPage(context);
+      }
+    }
+  }
+  catch (...)
+  {
+    listingError = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(state.Mutex);
+    state.ListingDone = true;
+    if (listingError)
+    {
+      state.Stopping = true;
+    }
+  }
+  state.Changed.notify_all();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  if (listingError)
+  {
+    std::rethrow_exception(listingError);
+  }
+  if (state.CallbackError)
+  {
+    std::rethrow_exception(state.CallbackError);
+  }
+  context.ThrowIfCancelled();
+}
+
 std::string SecretClient::GetUrl() const { return m_protocolClient->GetUrl().GetAbsoluteUrl(); }
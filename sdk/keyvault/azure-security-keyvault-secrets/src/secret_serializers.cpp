@@ -12,12 +12,15 @@
 #include <azure/core/internal/json/json.hpp>
 #include <azure/core/internal/json/json_optional.hpp>
 #include <azure/core/internal/json/json_serializable.hpp>
+#include <azure/keyvault/shared/keyvault_flat_json.hpp>
+#include <azure/keyvault/shared/keyvault_paged_json.hpp>
 
 using namespace Azure::Core::_internal;
 using namespace Azure::Core::Json::_internal;
 using Azure::Core::_internal::PosixTimeConverter;
 using namespace Azure::Security::KeyVault::Secrets;
 using namespace Azure::Security::KeyVault::Secrets::_detail;
+using Azure::Security::KeyVault::_internal::PagedJsonParser;
 
 // Creates a new key based on a name and an HTTP raw response.
 KeyVaultSecret SecretSerializer::Deserialize(
@@ -237,20 +240,22 @@ std::string SecretPropertiesSerializer::Serialize(SecretProperties const& proper
 BackupSecretResult BackupSecretSerializer::Deserialize(
     Azure::Core::Http::RawResponse const& rawResponse)
 {
-  auto const& body = rawResponse.GetBody();
-  auto jsonParser = json::parse(body);
-  auto encodedResult = jsonParser[_detail::ValuePropertyName].get<std::string>();
+  // The backup is decoded straight from the body, without building a JSON document.
+  Azure::Security::KeyVault::_internal::FlatJsonReader reader(rawResponse.GetBody());
   BackupSecretResult data;
-  data.Secret = Base64Url::Base64UrlDecode(encodedResult);
+  data.Secret = reader.GetBase64Url(_detail::ValuePropertyName);
 
   return data;
 }
 
 std::string RestoreSecretSerializer::Serialize(std::vector<uint8_t> const& backup)
 {
-  json payload;
-  payload[_detail::ValuePropertyName] = Base64Url::Base64UrlEncode(backup);
-  return payload.dump();
+  // The backup is encoded straight into the payload, sized up front.
+  using Azure::Security::KeyVault::_internal::FlatJsonWriter;
+  FlatJsonWriter payload(
+      FlatJsonWriter::Base64UrlPropertyLength(_detail::ValuePropertyName, backup));
+  payload.WriteBase64Url(_detail::ValuePropertyName, backup);
+  return payload.Finish();
 }
 
 SecretPropertiesPagedResponse SecretPropertiesPagedResultSerializer::Deserialize(
@@ -258,22 +263,16 @@ SecretPropertiesPagedResponse SecretPropertiesPagedResultSerializer::Deserialize
 {
   SecretPropertiesPagedResponse result;
   auto const& body = rawResponse.GetBody();
-  auto jsonParser = json::parse(body);
 
-  JsonOptional::SetIfExists(result.NextPageToken, jsonParser, "nextLink");
-
-  // Key properties
-  auto secretsPropertiesJson = jsonParser["value"];
-
-  for (auto const& secretProperties : secretsPropertiesJson)
-  {
+  // Secret properties, deserialized one at a time as they are parsed
+  auto jsonParser = PagedJsonParser::Parse(body, [&result](json const& secretProperties) {
     SecretProperties item;
     item.Id = secretProperties[_detail::IdPropertyName].get<std::string>();
     _detail::SecretSerializer::ParseIDUrl(item, item.Id);
     // Parse URL for the various attributes
     if (secretProperties.contains(_detail::AttributesPropertyName))
     {
-      auto attributes = secretProperties[_detail::AttributesPropertyName];
+      auto const& attributes = secretProperties[_detail::AttributesPropertyName];
 
       JsonOptional::SetIfExists(item.Enabled, attributes, _detail::EnabledPropertyName);
 
@@ -324,8 +323,10 @@ SecretPropertiesPagedResponse SecretPropertiesPagedResultSerializer::Deserialize
     // content type
     JsonOptional::SetIfExists<std::string>(
         item.ContentType, secretProperties, _detail::ContentTypePropertyName);
-    result.Items.emplace_back(item);
-  }
+    result.Items.emplace_back(std::move(item));
+  });
+
+  JsonOptional::SetIfExists(result.NextPageToken, jsonParser, "nextLink");
 
   return result;
 }
@@ -336,15 +337,9 @@ DeletedSecretPagedResponse DeletedSecretPagedResultSerializer::Deserialize(
 
   DeletedSecretPagedResponse result;
   auto const& body = rawResponse.GetBody();
-  auto jsonParser = json::parse(body);
-  auto string = jsonParser.dump();
-  JsonOptional::SetIfExists(result.NextPageToken, jsonParser, "nextLink");
-
-  // Key properties
-  auto secretsPropertiesJson = jsonParser["value"];
 
-  for (auto const& secretProperties : secretsPropertiesJson)
-  {
+  // Deleted secrets, deserialized one at a time as they are parsed
+  auto jsonParser = PagedJsonParser::Parse(body, [&result](json const& secretProperties) {
     DeletedSecret item;
     item.Id = secretProperties[_detail::IdPropertyName].get<std::string>();
     _detail::SecretSerializer::ParseIDUrl(item.Properties, item.Id);
@@ -352,7 +347,7 @@ DeletedSecretPagedResponse DeletedSecretPagedResultSerializer::Deserialize(
     // Parse URL for the various attributes
     if (secretProperties.contains(_detail::AttributesPropertyName))
     {
-      auto attributes = secretProperties[_detail::AttributesPropertyName];
+      auto const& attributes = secretProperties[_detail::AttributesPropertyName];
 
       JsonOptional::SetIfExists(item.Properties.Enabled, attributes, _detail::EnabledPropertyName);
 
@@ -410,8 +405,10 @@ DeletedSecretPagedResponse DeletedSecretPagedResultSerializer::Deserialize(
     item.DeletedOn = PosixTimeConverter::PosixTimeToDateTime(
         secretProperties[_detail::DeletedDatePropertyName]);
 
-    result.Items.emplace_back(item);
-  }
+    result.Items.emplace_back(std::move(item));
+  });
+
+  JsonOptional::SetIfExists(result.NextPageToken, jsonParser, "nextLink");
 
   return result;
 }
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of deserializing a list of secrets, without the network.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include <azure/keyvault/keyvault_secrets.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Secrets { namespace Test {
+
+  namespace _detail {
+    /**
+     * @brief A credential returning the same token, which never expires.
+     *
+     */
+    class StaticTokenCredential final : public Azure::Core::Credentials::TokenCredential {
+    public:
+      Azure::Core::Credentials::AccessToken GetToken(
+          Azure::Core::Credentials::TokenRequestContext const&,
+          Azure::Core::Context const&) const override
+      {
+        Azure::Core::Credentials::AccessToken token;
+        token.Token = "token";
+        token.ExpiresOn = Azure::DateTime::Parse(
+            "9999-12-31T23:59:59Z", Azure::DateTime::DateFormat::Rfc3339);
+        return token;
+      }
+    };
+  } // namespace _detail
+
+  /**
+   * @brief A test to measure listing secrets with a transport returning a canned page of secrets.
+   *
+   * @remark Most of the time of the test is spent parsing the JSON of the page.
+   */
+  class GetPropertiesOfSecretsCanned : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Security::KeyVault::Secrets::SecretClient> m_client;
+    int64_t m_bodySize = 0;
+
+  public:
+    /**
+     * @brief Construct a new GetPropertiesOfSecretsCanned test.
+     *
+     * @param options The test options.
+     */
+    GetPropertiesOfSecretsCanned(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the secret client with a page of the number of secrets from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const count = m_options.GetOptionOrDefault<int>("Count", 25);
+
+      std::string body = "{\"value\":[";
+      for (auto secret = 0; secret < count; secret++)
+      {
+        body += std::string(secret == 0 ? "" : ",")
+            + "{\"id\":\"https://vault.vault.azure.net/secrets/perfListSecret"
+            + std::to_string(secret)
+            + "\",\"attributes\":{\"enabled\":true,\"created\":1642109872,"
+              "\"updated\":1642109872,\"recoveryLevel\":\"Recoverable+Purgeable\","
+              "\"recoverableDays\":90},\"contentType\":\"text/plain\","
+              "\"tags\":{\"owner\":\"perf\"}}";
+      }
+      body += "],\"nextLink\":null}";
+      m_bodySize = static_cast<int64_t>(body.size());
+
+      Azure::Perf::CannedResponse response;
+      response.Headers = {
+          {"content-type", "application/json; charset=utf-8"},
+          {"x-ms-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000"},
+          {"date", "Thu, 13 Jan 2022 21:37:53 GMT"},
+      };
+      response.Body.assign(body.begin(), body.end());
+
+      Azure::Security::KeyVault::Secrets::SecretClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_client = std::make_unique<Azure::Security::KeyVault::Secrets::SecretClient>(
+          "https://vault.vault.azure.net",
+          std::make_shared<_detail::StaticTokenCredential>(),
+          options);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      auto page = m_client->GetPropertiesOfSecrets({}, context);
+      for (auto const& secret : page.Items)
+      {
+        (void)secret;
+      }
+    }
+
+    /**
+     * @brief The bytes of JSON parsed by each run.
+     *
+     */
+    int64_t GetBytesPerOperation() override { return m_bodySize; }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {{"Count", {"--count"}, "Number of secrets in the page, 25 by default.", 1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "GetPropertiesOfSecretsCanned",
+          "List a canned page of secrets. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<
+                Azure::Security::KeyVault::Secrets::Test::GetPropertiesOfSecretsCanned>(options);
+          }};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Secrets::Test
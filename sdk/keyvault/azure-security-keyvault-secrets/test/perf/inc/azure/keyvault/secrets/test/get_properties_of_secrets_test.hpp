@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of listing the secrets of a key vault.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include "azure/keyvault/secrets/test/secret_base_test.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Secrets { namespace Test {
+
+  /**
+   * @brief A test to measure listing the properties of all the secrets, page by page.
+   *
+   * @remark With `--count`, the global setup sets that many secrets first, so that the vault has
+   * several pages to list. They are named `perfListSecret<N>` and kept, since a deleted secret
+   * must also be purged before its name can be reused.
+   */
+  class GetPropertiesOfSecrets : public Azure::Security::KeyVault::Secrets::Test::SecretsTest {
+  public:
+    /**
+     * @brief Construct a new GetPropertiesOfSecrets test.
+     *
+     * @param options The test options.
+     */
+    GetPropertiesOfSecrets(Azure::Perf::TestOptions options) : SecretsTest(options) {}
+
+    /**
+     * @brief Set the secrets to list.
+     *
+     */
+    void GlobalSetup() override
+    {
+      auto const count = m_options.GetOptionOrDefault<int>("Count", 0);
+      auto const client = CreateClient();
+      for (int i = 0; i < count; i++)
+      {
+        client->SetSecret("perfListSecret" + std::to_string(i), "perfValue");
+      }
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      for (auto page = m_client->GetPropertiesOfSecrets({}, context); page.HasPage();
+           page.MoveToNextPage(context))
+      {
+      }
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      auto options = SecretsTest::GetTestOptions();
+      options.push_back(
+          {"Count", {"--count"}, "The number of secrets to set before listing them.", 1, false});
+      return options;
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "GetPropertiesOfSecrets",
+          "List the properties of the secrets of a vault",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<
+                Azure::Security::KeyVault::Secrets::Test::GetPropertiesOfSecrets>(options);
+          }};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Secrets::Test
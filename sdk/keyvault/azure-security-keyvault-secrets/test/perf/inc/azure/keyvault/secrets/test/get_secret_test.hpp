@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of getting a secret.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include "azure/keyvault/secrets/test/secret_base_test.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Secrets { namespace Test {
+
+  /**
+   * @brief A test to measure getting a secret, with or without the client caching.
+   *
+   * @remark By default the client and its access token are reused, so each run is one request.
+   * With `--cache 0` each run creates a new credential and client, so it also gets a new token,
+   * which is the cost of an application creating a client per call.
+   */
+  class GetSecret : public Azure::Security::KeyVault::Secrets::Test::SecretsTest {
+  private:
+    std::string m_secretName;
+    bool m_isCached = true;
+
+  public:
+    /**
+     * @brief Construct a new GetSecret test.
+     *
+     * @param options The test options.
+     */
+    GetSecret(Azure::Perf::TestOptions options) : SecretsTest(options) {}
+
+    /**
+     * @brief Get the secret name and the caching option.
+     *
+     */
+    void Setup() override
+    {
+      SecretsTest::Setup();
+      m_secretName = m_options.GetMandatoryOption<std::string>("secretName");
+      m_isCached = m_options.GetOptionOrDefault<bool>("Cache", true);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      if (m_isCached)
+      {
+        auto secret = m_client->GetSecret(m_secretName, {}, context);
+      }
+      else
+      {
+        auto secret = CreateClient()->GetSecret(m_secretName, {}, context);
+      }
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      auto options = SecretsTest::GetTestOptions();
+      options.push_back({"secretName", {"--secretName"}, "The secret name to get.", 1, true});
+      options.push_back(
+          {"Cache",
+           {"--cache"},
+           "Whether the client and its access token are reused by the runs, 1 by default.",
+           1,
+           false});
+      return options;
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {"GetSecret", "Get a secret", [](Azure::Perf::TestOptions options) {
+                return std::make_unique<Azure::Security::KeyVault::Secrets::Test::GetSecret>(
+                    options);
+              }};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Secrets::Test
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Define the base behavior of the tests using a secret client.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+
+#include <azure/identity.hpp>
+#include <azure/keyvault/keyvault_secrets.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace Secrets { namespace Test {
+
+  /**
+   * @brief A base test that creates a secret client for a key vault.
+   *
+   */
+  class SecretsTest : public Azure::Perf::PerfTest {
+  protected:
+    std::unique_ptr<Azure::Security::KeyVault::Secrets::SecretClient> m_client;
+
+    /**
+     * @brief Create a secret client with a new credential, so without any cached token.
+     *
+     */
+    std::unique_ptr<Azure::Security::KeyVault::Secrets::SecretClient> CreateClient()
+    {
+      auto credential = std::make_shared<Azure::Identity::ClientSecretCredential>(
+          m_options.GetMandatoryOption<std::string>("TenantId"),
+          m_options.GetMandatoryOption<std::string>("ClientId"),
+          m_options.GetMandatoryOption<std::string>("Secret"));
+      return std::make_unique<Azure::Security::KeyVault::Secrets::SecretClient>(
+          m_options.GetMandatoryOption<std::string>("vaultUrl"), credential);
+    }
+
+  public:
+    /**
+     * @brief Create the secret client.
+     *
+     */
+    void Setup() override { m_client = CreateClient(); }
+
+    /**
+     * @brief Construct a new SecretsTest test.
+     *
+     * @param options The test options.
+     */
+    SecretsTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"vaultUrl", {"--vaultUrl"}, "The Key Vault Account.", 1, true},
+          {"TenantId", {"--tenantId"}, "The tenant Id for the authentication.", 1, true},
+          {"ClientId", {"--clientId"}, "The client Id for the authentication.", 1, true},
+          {"Secret", {"--secret"}, "The secret for authentication.", 1, true, true}};
+    }
+  };
+
+}}}}} // namespace Azure::Security::KeyVault::Secrets::Test
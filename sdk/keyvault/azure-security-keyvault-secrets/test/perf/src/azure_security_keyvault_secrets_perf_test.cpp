@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/perf.hpp>
+
+#include "azure/keyvault/secrets/test/get_properties_of_secrets_canned_test.hpp"
+#include "azure/keyvault/secrets/test/get_properties_of_secrets_test.hpp"
+#include "azure/keyvault/secrets/test/get_secret_test.hpp"
+
+int main(int argc, char** argv)
+{
+
+  // Create the test list
+  std::vector<Azure::Perf::TestMetadata> tests{
+      Azure::Security::KeyVault::Secrets::Test::GetSecret::GetTestMetadata(),
+      Azure::Security::KeyVault::Secrets::Test::GetPropertiesOfSecrets::GetTestMetadata(),
+      Azure::Security::KeyVault::Secrets::Test::GetPropertiesOfSecretsCanned::GetTestMetadata()};
+
+  Azure::Perf::Program::Run(Azure::Core::Context::ApplicationContext, tests, argc, argv);
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/http/transport.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/keyvault/keyvault_secrets.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::Secrets;
+
+namespace {
+class NonExpiringCredential final : public Azure::Core::Credentials::TokenCredential {
+public:
+  Azure::Core::Credentials::AccessToken GetToken(
+      Azure::Core::Credentials::TokenRequestContext const&,
+      Azure::Core::Context const&) const override
+  {
+    return {"magicToken", Azure::DateTime::clock::now() + std::chrono::hours(24)};
+  }
+};
+
+// Returns a new value of the secret requested for every request, after a delay.
+class MockSecretTransport final : public Azure::Core::Http::HttpTransport {
+public:
+  explicit MockSecretTransport(std::chrono::milliseconds delay) : m_delay(delay) {}
+
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Context const&) override
+  {
+    std::this_thread::sleep_for(m_delay);
+    // The path is secrets/{name}/{version}, the version is empty for the latest one.
+    const std::string path = request.GetUrl().GetPath();
+    const size_t versionStart = path.find('/', std::strlen("secrets/"));
+    std::string version
+        = versionStart == std::string::npos ? std::string() : path.substr(versionStart + 1);
+    if (version.empty())
+    {
+      version = "latest";
+    }
+    const int32_t requestCount = ++RequestCount;
+    const std::string body = "{\"value\":\"" + version + std::to_string(requestCount)
+        + "\",\"id\":\"https://vault.vault.azure.net/" + path
+        + "\",\"attributes\":{\"enabled\":true,\"created\":1493938410,\"updated\":1493938410}}";
+
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(
+        1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+    response->SetHeader("content-type", "application/json");
+    std::lock_guard<std::mutex> guard(m_mutex);
+    // The bodies outlive the responses streaming them.
+    m_bodies.emplace_back(body.begin(), body.end());
+    response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+        m_bodies.back().data(), m_bodies.back().size()));
+    return response;
+  }
+
+  std::atomic<int32_t> RequestCount{0};
+
+private:
+  std::chrono::milliseconds m_delay;
+  std::mutex m_mutex;
+  std::deque<std::vector<uint8_t>> m_bodies;
+};
+
+std::unique_ptr<SecretClient> CreateSecretClient(std::shared_ptr<MockSecretTransport> transport)
+{
+  SecretClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  options.Retry.MaxRetries = 0;
+  return std::make_unique<SecretClient>(
+      "https://vault.vault.azure.net", std::make_shared<NonExpiringCredential>(), options);
+}
+} // namespace
+
+TEST(CachingSecretClient, CachesUntilTheTimeToLive)
+{
+  auto transport = std::make_shared<MockSecretTransport>(std::chrono::milliseconds(0));
+  CachingSecretClientOptions options;
+  options.TimeToLive = std::chrono::milliseconds(200);
+  options.StaleWhileRevalidate = std::chrono::milliseconds(0);
+  CachingSecretClient client(*CreateSecretClient(transport), options);
+
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest1");
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest1");
+  EXPECT_EQ(transport->RequestCount, 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest2");
+  EXPECT_EQ(transport->RequestCount, 2);
+
+  client.Invalidate("secret");
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest3");
+}
+
+TEST(CachingSecretClient, ServesStaleSecretsWhileRefreshingThem)
+{
+  auto transport = std::make_shared<MockSecretTransport>(std::chrono::milliseconds(50));
+  CachingSecretClientOptions options;
+  options.TimeToLive = std::chrono::milliseconds(0);
+  options.SecretTimeToLives["secret"] = std::chrono::milliseconds(100);
+  options.StaleWhileRevalidate = std::chrono::minutes(1);
+  CachingSecretClient client(*CreateSecretClient(transport), options);
+
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest1");
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  // Returned without waiting for the refresh.
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest1");
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest1");
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+  while (transport->RequestCount < 2)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "latest2");
+  EXPECT_EQ(transport->RequestCount, 2);
+}
+
+TEST(CachingSecretClient, SendsOneRequestForConcurrentMisses)
+{
+  auto transport = std::make_shared<MockSecretTransport>(std::chrono::milliseconds(100));
+  CachingSecretClient client(*CreateSecretClient(transport));
+
+  std::vector<std::thread> threads;
+  std::vector<std::string> values(8);
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    threads.emplace_back(
+        [&client, &values, i]() { values[i] = client.GetSecret("secret").Value.Value(); });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(transport->RequestCount, 1);
+  for (const auto& value : values)
+  {
+    EXPECT_EQ(value, "latest1");
+  }
+}
+
+TEST(CachingSecretClient, CachesVersionsWithoutExpiring)
+{
+  auto transport = std::make_shared<MockSecretTransport>(std::chrono::milliseconds(0));
+  CachingSecretClientOptions options;
+  options.TimeToLive = std::chrono::milliseconds(0);
+  options.StaleWhileRevalidate = std::chrono::milliseconds(0);
+  options.PinnedVersions["secret"] = "pinned";
+  CachingSecretClient client(*CreateSecretClient(transport), options);
+
+  GetSecretOptions getOptions;
+  getOptions.Version = "version";
+  EXPECT_EQ(client.GetSecret("secret", getOptions).Value.Value(), "version1");
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "pinned2");
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(client.GetSecret("secret", getOptions).Value.Value(), "version1");
+  EXPECT_EQ(client.GetSecret("secret").Value.Value(), "pinned2");
+  EXPECT_EQ(client.GetSecret("other").Value.Value(), "latest3");
+  EXPECT_EQ(client.GetSecret("other").Value.Value(), "latest4");
+  EXPECT_EQ(transport->RequestCount, 4);
+}
@@ -52,3 +52,19 @@ TEST(RestoreSecretSerializer, SomeValue)
   // cspell: disable-next-line
   EXPECT_EQ(jsonParser["value"], "bXkgbmFtZSBpcw");
 }
+
+TEST(RestoreSecretSerializer, RoundTrip)
+{
+  std::vector<uint8_t> data(100000);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    data[i] = static_cast<uint8_t>(i * 31 + i / 256);
+  }
+  auto payload = _detail::RestoreSecretSerializer::Serialize(data);
+  EXPECT_EQ(json::parse(payload)["value"].get<std::string>().size(), size_t(133334));
+
+  auto response
+      = Azure::Core::Http::RawResponse(1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+  response.SetBody(std::vector<uint8_t>(payload.begin(), payload.end()));
+  EXPECT_EQ(_detail::BackupSecretSerializer::Deserialize(response).Secret, data);
+}
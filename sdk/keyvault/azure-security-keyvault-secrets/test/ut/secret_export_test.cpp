@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include <azure/core/exception.hpp>
+#include <azure/core/http/transport.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/keyvault/keyvault_secrets.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Azure::Security::KeyVault::Secrets;
+
+namespace {
+class NonExpiringCredential final : public Azure::Core::Credentials::TokenCredential {
+public:
+  Azure::Core::Credentials::AccessToken GetToken(
+      Azure::Core::Credentials::TokenRequestContext const&,
+      Azure::Core::Context const&) const override
+  {
+    return {"magicToken", Azure::DateTime::clock::now() + std::chrono::hours(24)};
+  }
+};
+
+// Lists the secrets s0 to s19 in two pages, and returns their values after a delay. The secret s3
+// is disabled, s5 is forbidden and s7 is throttled once.
+class MockExportTransport final : public Azure::Core::Http::HttpTransport {
+public:
+  std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+      Azure::Core::Http::Request& request,
+      Azure::Core::Context const&) override
+  {
+    auto status = Azure::Core::Http::HttpStatusCode::Ok;
+    std::string body;
+    // The path is secrets for the pages, and secrets/{name} for the secrets.
+    const std::string path = request.GetUrl().GetPath();
+    if (path == "secrets")
+    {
+      const bool isSecondPage = request.GetUrl().GetQueryParameters().count("$skiptoken") != 0;
+      body = "{\"value\":[";
+      for (int i = isSecondPage ? 10 : 0; i < (isSecondPage ? 20 : 10); ++i)
+      {
+        body += std::string(i % 10 == 0 ? "" : ",") + "{\"id\":\"https://vault.vault.azure.net/"
+            + "secrets/s" + std::to_string(i) + "\",\"attributes\":{\"enabled\":"
+            + (i == 3 ? "false" : "true") + "}}";
+      }
+      body += isSecondPage ? "]}"
+                           : "],\"nextLink\":\"https://vault.vault.azure.net/secrets?"
+                             "api-version=7.2&$skiptoken=page2\"}";
+    }
+    else
+    {
+      const std::string name = path.substr(std::strlen("secrets/"));
+      const int32_t inFlight = ++m_inFlight;
+      int32_t maxInFlight = MaxInFlight;
+      while (inFlight > maxInFlight && !MaxInFlight.compare_exchange_weak(maxInFlight, inFlight))
+      {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      --m_inFlight;
+
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (name == "s5")
+      {
+        status = Azure::Core::Http::HttpStatusCode::Forbidden;
+        body = "{}";
+      }
+      else if (name == "s7" && SecretRequests[name] == 0)
+      {
+        status = Azure::Core::Http::HttpStatusCode::TooManyRequests;
+        body = "{}";
+      }
+      else
+      {
+        body = "{\"value\":\"value-" + name + "\",\"id\":\"https://vault.vault.azure.net/secrets/"
+            + name + "/version\"}";
+      }
+      ++SecretRequests[name];
+    }
+
+    auto response = std::make_unique<Azure::Core::Http::RawResponse>(1, 1, status, "");
+    response->SetHeader("content-type", "application/json");
+    if (status == Azure::Core::Http::HttpStatusCode::TooManyRequests)
+    {
+      response->SetHeader("retry-after-ms", "200");
+    }
+    std::lock_guard<std::mutex> guard(m_mutex);
+    // The bodies outlive the responses streaming them.
+    m_bodies.emplace_back(body.begin(), body.end());
+    response->SetBodyStream(std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+        m_bodies.back().data(), m_bodies.back().size()));
+    return response;
+  }
+
+  std::atomic<int32_t> MaxInFlight{0};
+  std::map<std::string, int32_t> SecretRequests;
+
+private:
+  std::atomic<int32_t> m_inFlight{0};
+  std::mutex m_mutex;
+  std::deque<std::vector<uint8_t>> m_bodies;
+};
+
+std::unique_ptr<SecretClient> CreateSecretClient(std::shared_ptr<MockExportTransport> transport)
+{
+  SecretClientOptions options;
+  options.Transport.Transport = std::move(transport);
+  options.Retry.MaxRetries = 0;
+  return std::make_unique<SecretClient>(
+      "https://vault.vault.azure.net", std::make_shared<NonExpiringCredential>(), options);
+}
+} // namespace
+
+TEST(SecretExport, FetchesTheSecretsConcurrently)
+{
+  auto transport = std::make_shared<MockExportTransport>();
+  auto client = CreateSecretClient(transport);
+  ExportSecretsOptions options;
+  options.Concurrency = 4;
+
+  std::map<std::string, ExportedSecret> secrets;
+  client->ExportSecrets(
+      [&secrets](ExportedSecret const& secret) {
+        EXPECT_TRUE(secrets.emplace(secret.Properties.Name, secret).second);
+      },
+      options);
+
+  ASSERT_EQ(secrets.size(), 20U);
+  for (auto const& secret : secrets)
+  {
+    if (secret.first == "s3")
+    {
+      EXPECT_FALSE(secret.second.Secret.HasValue());
+      EXPECT_FALSE(secret.second.Error);
+    }
+    else if (secret.first == "s5")
+    {
+      EXPECT_FALSE(secret.second.Secret.HasValue());
+      EXPECT_THROW(
+          std::rethrow_exception(secret.second.Error), Azure::Core::RequestFailedException);
+    }
+    else
+    {
+      ASSERT_TRUE(secret.second.Secret.HasValue());
+      EXPECT_FALSE(secret.second.Error);
+      EXPECT_EQ(secret.second.Secret.Value().Value.Value(), "value-" + secret.first);
+    }
+  }
+  // The disabled secret isn't fetched, and the throttled one is fetched again.
+  EXPECT_EQ(transport->SecretRequests.size(), 19U);
+  EXPECT_EQ(transport->SecretRequests["s7"], 2);
+  EXPECT_GT(transport->MaxInFlight, 1);
+  EXPECT_LE(transport->MaxInFlight, 4);
+}
+
+TEST(SecretExport, LimitsTheRequestRate)
+{
+  auto transport = std::make_shared<MockExportTransport>();
+  auto client = CreateSecretClient(transport);
+  ExportSecretsOptions options;
+  options.MaxRequestsPerSecond = 50;
+
+  const auto start = std::chrono::steady_clock::now();
+  size_t count = 0;
+  client->ExportSecrets([&count](ExportedSecret const&) { ++count; }, options);
+  EXPECT_EQ(count, 20U);
+  // The 19 requests for the enabled secrets are sent 20 ms apart at least.
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(360));
+}
+
+TEST(SecretExport, StopsWhenTheCallbackThrows)
+{
+  auto transport = std::make_shared<MockExportTransport>();
+  auto client = CreateSecretClient(transport);
+
+  size_t count = 0;
+  EXPECT_THROW(
+      client->ExportSecrets([&count](ExportedSecret const&) {
+        ++count;
+        throw std::runtime_error("stop");
+      }),
+      std::runtime_error);
+  EXPECT_EQ(count, 1U);
+}
@@ -79,6 +79,37 @@ TEST(SecretPropertiesPagedResponse, NoneNoNext)
   EXPECT_EQ(result.NextPageToken.HasValue(), false);
 }
 
+TEST(SecretPropertiesPagedResponse, NextAfterItems)
+{
+  auto response = Azure::Core::Http::RawResponse(1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+  std::string const body = R"json({
+    "value": [
+      {"id": "https://myvault.vault.azure.net/secrets/first", "tags": {"value": "tag"},
+       "attributes": {"enabled": true}, "contentType": "text"},
+      {"id": "https://myvault.vault.azure.net/secrets/second", "managed": true}
+    ],
+    "other": {"value": [1, 2]},
+    "nextLink": "next"
+  })json";
+  response.SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+
+  auto result = _detail::SecretPropertiesPagedResultSerializer::Deserialize(response);
+
+  EXPECT_EQ(result.NextPageToken.Value(), "next");
+  ASSERT_EQ(result.Items.size(), size_t(2));
+  EXPECT_EQ(result.Items[0].Name, "first");
+  EXPECT_EQ(result.Items[0].Tags.at("value"), "tag");
+  EXPECT_EQ(result.Items[0].Enabled.Value(), true);
+  EXPECT_EQ(result.Items[0].ContentType.Value(), "text");
+  EXPECT_EQ(result.Items[1].Name, "second");
+  EXPECT_EQ(result.Items[1].Managed, true);
+
+  std::string const invalidBody = R"json({"value": [{"id": "https://myvault.vault.azure.net/)json";
+  response.SetBody(std::vector<uint8_t>(invalidBody.begin(), invalidBody.end()));
+  EXPECT_THROW(
+      _detail::SecretPropertiesPagedResultSerializer::Deserialize(response), json::parse_error);
+}
+
 TEST(DeletedSecretPagedResultSerializer, SingleWithNext)
 {
   auto response = _test::PagedHelpers::GetDeletedFirstResponse();
@@ -0,0 +1,509 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Streams the backups of the Key Vault keys, secrets and certificates, with buffers of a
+ * bounded size.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/base64.hpp>
+#include <azure/core/context.hpp>
+#include <azure/core/http/raw_response.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace _internal {
+
+  /**
+   * @brief Decodes the Base64URL `value` property of a backup response, the JSON text of which
+   * is written in pieces, into a sink, without holding the whole backup in memory.
+   *
+   * @remark The backups of keys, secrets and certificates are all the `value` property. The
+   * other properties, if any, are skipped. The text is decoded by blocks of up to 64 KiB.
+   */
+  class BackupValueDecoder final {
+  public:
+    /**
+     * @brief Receives the bytes of the backup decoded, in order.
+     *
+     */
+    using SinkFunc = std::function<void(uint8_t const* data, size_t length)>;
+
+  private:
+    enum class State
+    {
+      Object,
+      KeyStart,
+      Key,
+      KeyEscape,
+      Colon,
+      Value,
+      String,
+      StringEscape,
+      Backup,
+      Nested,
+      NestedString,
+      NestedStringEscape,
+      Literal,
+      Comma,
+      End,
+    };
+
+    // A multiple of 4, so that only the last block may be padded.
+    constexpr static size_t EncodedBlockSize = 64 * 1024;
+
+    SinkFunc m_sink;
+    State m_state = State::Object;
+    // The name of the property being read, up to a character more than "value".
+    char m_key[6];
+    size_t m_keyLength = 0;
+    bool m_isFirstKey = true;
+    size_t m_depth = 0;
+    bool m_found = false;
+    std::vector<char> m_encoded;
+    std::vector<uint8_t> m_decoded;
+    int64_t m_length = 0;
+
+    [[noreturn]] static void ThrowInvalid()
+    {
+      throw std::invalid_argument("The response body is not a valid JSON object.");
+    }
+
+    static bool IsWhitespace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    void DecodeBlock()
+    {
+      if (m_encoded.empty())
+      {
+        return;
+      }
+      const size_t length = Azure::Core::_internal::Base64Url::Base64UrlDecode(
+          m_encoded.data(), m_encoded.size(), m_decoded.data());
+      m_encoded.clear();
+      m_sink(m_decoded.data(), length);
+      m_length += static_cast<int64_t>(length);
+    }
+
+    // Reads the Base64URL text up to its closing quote, returns the number of characters read.
+    size_t ReadBackup(char const* text, size_t length)
+    {
+      size_t read = 0;
+      while (read != length)
+      {
+        const size_t count = std::min(length - read, EncodedBlockSize - m_encoded.size());
+        char const* const blockEnd = text + read + count;
+        char const* const end = std::find_if(
+            text + read, blockEnd, [](char c) { return c == '"' || c == '\\'; });
+        m_encoded.insert(m_encoded.end(), text + read, end);
+        read = static_cast<size_t>(end - text);
+        if (end != blockEnd && *end == '"')
+        {
+          DecodeBlock();
+          m_state = State::Comma;
+          return read + 1;
+        }
+        if (end != blockEnd)
+        {
+          // Base64URL text never has escaped characters.
+          ThrowInvalid();
+        }
+        if (m_encoded.size() == EncodedBlockSize)
+        {
+          DecodeBlock();
+        }
+      }
+      return read;
+    }
+
+    void ReadValue(char c)
+    {
+      switch (c)
+      {
+        case '"':
+          if (m_keyLength == 5 && std::memcmp(m_key, "value", 5) == 0 && !m_found)
+          {
+            m_found = true;
+            m_state = State::Backup;
+          }
+          else
+          {
+            m_state = State::String;
+          }
+          break;
+        case '{':
+        case '[':
+          m_depth = 1;
+          m_state = State::Nested;
+          break;
+        default:
+          if (IsWhitespace(c))
+          {
+            break;
+          }
+          if (c == ',' || c == '}' || c == ']' || c == ':')
+          {
+            ThrowInvalid();
+          }
+          // A number, true, false or null.
+          m_state = State::Literal;
+          break;
+      }
+    }
+
+  public:
+    /**
+     * @brief Constructs a decoder writing to \p sink.
+     *
+     */
+    explicit BackupValueDecoder(SinkFunc sink) : m_sink(std::move(sink))
+    {
+      m_encoded.reserve(EncodedBlockSize);
+      m_decoded.resize(EncodedBlockSize / 4 * 3);
+    }
+
+    /**
+     * @brief Reads the next piece of the JSON text of the response.
+     *
+     * @throw std::invalid_argument when the text is not a JSON object.
+     */
+    void Write(char const* text, size_t length)
+    {
+      size_t i = 0;
+      while (i != length)
+      {
+        if (m_state == State::Backup)
+        {
+          i += ReadBackup(text + i, length - i);
+          continue;
+        }
+        const char c = text[i++];
+        switch (m_state)
+        {
+          case State::Object:
+            if (c == '{')
+            {
+              m_state = State::KeyStart;
+            }
+            else if (!IsWhitespace(c))
+            {
+              ThrowInvalid();
+            }
+            break;
+          case State::KeyStart:
+            if (c == '"')
+            {
+              m_keyLength = 0;
+              m_state = State::Key;
+            }
+            else if (c == '}' && m_isFirstKey)
+            {
+              m_state = State::End;
+            }
+            else if (!IsWhitespace(c))
+            {
+              ThrowInvalid();
+            }
+            break;
+          case State::Key:
+            if (c == '"')
+            {
+              m_state = State::Colon;
+            }
+            else if (c == '\\')
+            {
+              m_state = State::KeyEscape;
+            }
+            else if (m_keyLength < sizeof(m_key))
+            {
+              m_key[m_keyLength++] = c;
+            }
+            break;
+          case State::KeyEscape:
+            // The name looked up is never escaped, an escaped name never matches it.
+            m_keyLength = sizeof(m_key);
+            m_state = State::Key;
+            break;
+          case State::Colon:
+            if (c == ':')
+            {
+              m_state = State::Value;
+            }
+            else if (!IsWhitespace(c))
+            {
+              ThrowInvalid();
+            }
+            break;
+          case State::Value:
+            ReadValue(c);
+            break;
+          case State::String:
+            if (c == '"')
+            {
+              m_state = State::Comma;
+            }
+            else if (c == '\\')
+            {
+              m_state = State::StringEscape;
+            }
+            break;
+          case State::StringEscape:
+            m_state = State::String;
+            break;
+          case State::Nested:
+            if (c == '"')
+            {
+              m_state = State::NestedString;
+            }
+            else if (c == '{' || c == '[')
+            {
+              ++m_depth;
+            }
+            else if ((c == '}' || c == ']') && --m_depth == 0)
+            {
+              m_state = State::Comma;
+            }
+            break;
+          case State::NestedString:
+            if (c == '"')
+            {
+              m_state = State::Nested;
+            }
+            else if (c == '\\')
+            {
+              m_state = State::NestedStringEscape;
+            }
+            break;
+          case State::NestedStringEscape:
+            m_state = State::NestedString;
+            break;
+          case State::Literal:
+            if (c != ',' && c != '}' && !IsWhitespace(c))
+            {
+              break;
+            }
+            m_state = State::Comma;
+            --i;
+            break;
+          case State::Comma:
+            if (c == ',')
+            {
+              m_state = State::KeyStart;
+              m_isFirstKey = false;
+            }
+            else if (c == '}')
+            {
+              m_state = State::End;
+            }
+            else if (!IsWhitespace(c))
+            {
+              ThrowInvalid();
+            }
+            break;
+          case State::End:
+            if (!IsWhitespace(c))
+            {
+              ThrowInvalid();
+            }
+            break;
+          case State::Backup:
+            break;
+        }
+      }
+    }
+
+    /**
+     * @brief Ends the JSON text of the response.
+     *
+     * @return The number of bytes of the backup written to the sink.
+     *
+     * @throw std::invalid_argument when the text is not a JSON object with a `value` string.
+     */
+    int64_t Finish()
+    {
+      if (m_state != State::End)
+      {
+        ThrowInvalid();
+      }
+      if (!m_found)
+      {
+        throw std::invalid_argument("The property 'value' is not a string.");
+      }
+      return m_length;
+    }
+
+    /**
+     * @brief Decodes the backup of a response body into a sink, reading the body by blocks of
+     * up to 64 KiB.
+     *
+     * @return The number of bytes of the backup written to the sink.
+     */
+    static int64_t Decode(
+        Azure::Core::IO::BodyStream& body,
+        SinkFunc sink,
+        Azure::Core::Context const& context)
+    {
+      BackupValueDecoder decoder(std::move(sink));
+      std::vector<uint8_t> buffer(EncodedBlockSize);
+      size_t read;
+      while ((read = body.Read(buffer.data(), buffer.size(), context)) != 0)
+      {
+        decoder.Write(reinterpret_cast<char const*>(buffer.data()), read);
+      }
+      return decoder.Finish();
+    }
+  };
+
+  /**
+   * @brief The payload of a restore request, `{"value":"..."}`, encoding the backup read from
+   * another body stream by blocks of 48 KiB, without holding the whole backup in memory.
+   *
+   */
+  class BackupPayloadStream final : public Azure::Core::IO::BodyStream {
+  private:
+    // A multiple of 3, so that only the last block may have a partial group of characters.
+    constexpr static size_t BackupBlockSize = 48 * 1024;
+    static std::string Prefix() { return "{\"value\":\""; }
+    static std::string Suffix() { return "\"}"; }
+
+    Azure::Core::IO::BodyStream& m_backup;
+    int64_t m_length;
+    std::vector<uint8_t> m_block;
+    // The text read next: the prefix, the encoded blocks one after the other, then the suffix.
+    std::string m_text;
+    size_t m_textOffset = 0;
+    bool m_backupEnded = false;
+    bool m_suffixRead = false;
+
+    // Gets the next text to read, returns false once the suffix has been read.
+    bool ReadNextText(Azure::Core::Context const& context)
+    {
+      m_text.clear();
+      m_textOffset = 0;
+      if (m_suffixRead)
+      {
+        return false;
+      }
+      if (!m_backupEnded)
+      {
+        const size_t read = m_backup.ReadToCount(m_block.data(), m_block.size(), context);
+        m_backupEnded = read != m_block.size();
+        if (read != 0)
+        {
+          m_text.resize(Azure::Core::_internal::Base64Url::EncodedLength(read));
+          Azure::Core::_internal::Base64Url::Base64UrlEncode(m_block.data(), read, &m_text[0]);
+          return true;
+        }
+      }
+      m_text = Suffix();
+      m_suffixRead = true;
+      return true;
+    }
+
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override
+    {
+      while (m_textOffset == m_text.size())
+      {
+        if (!ReadNextText(context))
+        {
+          return 0;
+        }
+      }
+      const size_t read = std::min(count, m_text.size() - m_textOffset);
+      std::memcpy(buffer, m_text.data() + m_textOffset, read);
+      m_textOffset += read;
+      return read;
+    }
+
+  public:
+    /**
+     * @brief Constructs the payload of the backup read from \p backup, which must outlive it.
+     *
+     */
+    explicit BackupPayloadStream(Azure::Core::IO::BodyStream& backup)
+        : m_backup(backup),
+          m_length(static_cast<int64_t>(
+              Prefix().size()
+              + Azure::Core::_internal::Base64Url::EncodedLength(
+                  static_cast<size_t>(backup.Length()))
+              + Suffix().size())),
+          m_block(BackupBlockSize), m_text(Prefix())
+    {
+    }
+
+    int64_t Length() const override { return m_length; }
+
+    void Rewind() override
+    {
+      m_backup.Rewind();
+      m_text = Prefix();
+      m_textOffset = 0;
+      m_backupEnded = false;
+      m_suffixRead = false;
+    }
+  };
+
+  /**
+   * @brief Decodes the backup of a response, the body of which isn't buffered, into a file.
+   *
+   * @return The number of bytes of the backup written to the file.
+   *
+   * @throw std::runtime_error when the file can't be written.
+   */
+  inline int64_t WriteBackupToFile(
+      Azure::Core::Http::RawResponse& rawResponse,
+      std::string const& fileName,
+      Azure::Core::Context const& context)
+  {
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+      throw std::runtime_error("Failed to open " + fileName + " for writing.");
+    }
+    auto const write = [&file, &fileName](uint8_t const* data, size_t length) {
+      file.write(reinterpret_cast<char const*>(data), static_cast<std::streamsize>(length));
+      if (!file)
+      {
+        throw std::runtime_error("Failed to write to " + fileName + ".");
+      }
+    };
+    auto bodyStream = rawResponse.ExtractBodyStream();
+    if (bodyStream == nullptr)
+    {
+      // The response was buffered.
+      auto const& body = rawResponse.GetBody();
+      Azure::Core::IO::MemoryBodyStream memoryStream(body);
+      return BackupValueDecoder::Decode(memoryStream, write, context);
+    }
+    return BackupValueDecoder::Decode(*bodyStream, write, context);
+  }
+
+  /**
+   * @brief Reads the body of an error response which isn't buffered, so that the exception
+   * thrown for it has the details of the error.
+   *
+   */
+  inline void BufferErrorResponse(
+      Azure::Core::Http::RawResponse& rawResponse,
+      Azure::Core::Context const& context)
+  {
+    auto bodyStream = rawResponse.ExtractBodyStream();
+    if (bodyStream != nullptr)
+    {
+      rawResponse.SetBody(bodyStream->ReadToEnd(context));
+    }
+  }
+
+}}}} // namespace Azure::Security::KeyVault::_internal
@@ -0,0 +1,581 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Writes and reads the flat JSON objects of the Key Vault cryptographic operations.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/base64.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace _internal {
+
+  /**
+   * @brief The name of a JSON property along with its hash, computed at compile time when the
+   * name is a constant.
+   *
+   */
+  struct JsonKey final
+  {
+    char const* Name;
+    size_t Length;
+    uint64_t Hash;
+
+    // FNV-1a.
+    static constexpr uint64_t ComputeHash(char const* name, size_t length)
+    {
+      uint64_t hash = 14695981039346656037ULL;
+      for (size_t i = 0; i < length; ++i)
+      {
+        hash = (hash ^ static_cast<uint8_t>(name[i])) * 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    template <size_t N>
+    constexpr JsonKey(char const (&name)[N])
+        : Name(name), Length(N - 1), Hash(ComputeHash(name, N - 1))
+    {
+    }
+
+    constexpr JsonKey(char const* name, size_t length)
+        : Name(name), Length(length), Hash(ComputeHash(name, length))
+    {
+    }
+  };
+
+  /**
+   * @brief Writes a JSON object of string properties straight into a string sized up front,
+   * without building a JSON document.
+   *
+   */
+  class FlatJsonWriter final {
+  private:
+    std::string m_json;
+
+    void WriteKey(JsonKey const& key)
+    {
+      if (m_json.size() > 1)
+      {
+        m_json.push_back(',');
+      }
+      m_json.push_back('"');
+      m_json.append(key.Name, key.Length);
+      m_json.append("\":\"", 3);
+    }
+
+  public:
+    /**
+     * @brief Gets the number of characters of a string property, not counting the characters
+     * escaped.
+     *
+     */
+    static size_t StringPropertyLength(JsonKey const& key, std::string const& value)
+    {
+      return key.Length + value.size() + 6;
+    }
+
+    /**
+     * @brief Gets the number of characters of a binary property encoded as Base64URL.
+     *
+     */
+    static size_t Base64UrlPropertyLength(JsonKey const& key, std::vector<uint8_t> const& value)
+    {
+      return key.Length + Azure::Core::_internal::Base64Url::EncodedLength(value.size()) + 6;
+    }
+
+    /**
+     * @brief Starts a JSON object.
+     *
+     * @param length The number of characters of the properties written, as returned by
+     * #StringPropertyLength() and #Base64UrlPropertyLength().
+     */
+    explicit FlatJsonWriter(size_t length)
+    {
+      m_json.reserve(length + 2);
+      m_json.push_back('{');
+    }
+
+    /**
+     * @brief Writes a string property, escaping its value.
+     *
+     */
+    void WriteString(JsonKey const& key, std::string const& value)
+    {
+      WriteKey(key);
+      for (char const c : value)
+      {
+        if (c == '"' || c == '\\')
+        {
+          m_json.push_back('\\');
+          m_json.push_back(c);
+        }
+        else if (static_cast<uint8_t>(c) < 0x20)
+        {
+          constexpr static char HexDigits[] = "0123456789abcdef";
+          m_json.append("\\u00", 4);
+          m_json.push_back(HexDigits[static_cast<uint8_t>(c) >> 4]);
+          m_json.push_back(HexDigits[static_cast<uint8_t>(c) & 0xf]);
+        }
+        else
+        {
+          m_json.push_back(c);
+        }
+      }
+      m_json.push_back('"');
+    }
+
+    /**
+     * @brief Writes a binary property, encoded as Base64URL straight into the JSON text.
+     *
+     */
+    void WriteBase64Url(JsonKey const& key, std::vector<uint8_t> const& value)
+    {
+      WriteKey(key);
+      const size_t start = m_json.size();
+      m_json.resize(start + Azure::Core::_internal::Base64Url::EncodedLength(value.size()));
+      if (!value.empty())
+      {
+        Azure::Core::_internal::Base64Url::Base64UrlEncode(
+            value.data(), value.size(), &m_json[start]);
+      }
+      m_json.push_back('"');
+    }
+
+    /**
+     * @brief Ends the JSON object and returns its text.
+     *
+     */
+    std::string Finish()
+    {
+      m_json.push_back('}');
+      return std::move(m_json);
+    }
+  };
+
+  /**
+   * @brief Reads the properties of a JSON object, looking them up by the hash of their name,
+   * without building a JSON document.
+   *
+   * @remark The nested objects and arrays are skipped. The strings without escaped characters,
+   * like the Base64URL values, are read straight from the body, which must outlive the reader.
+   */
+  class FlatJsonReader final {
+  private:
+    enum class ValueKind
+    {
+      String,
+      True,
+      False,
+      Null,
+      Other,
+    };
+
+    struct Property final
+    {
+      uint64_t Hash;
+      char const* Name;
+      size_t NameLength;
+      ValueKind Kind;
+      // The text of a string, between its quotes.
+      char const* Value;
+      size_t ValueLength;
+      bool IsEscaped;
+    };
+
+    char const* m_position;
+    char const* m_end;
+    std::vector<Property> m_properties;
+
+    [[noreturn]] static void ThrowInvalid()
+    {
+      throw std::invalid_argument("The response body is not a valid JSON object.");
+    }
+
+    void SkipWhitespace()
+    {
+      while (m_position != m_end
+             && (*m_position == ' ' || *m_position == '\t' || *m_position == '\n'
+                 || *m_position == '\r'))
+      {
+        ++m_position;
+      }
+    }
+
+    void Expect(char c)
+    {
+      SkipWhitespace();
+      if (m_position == m_end || *m_position != c)
+      {
+        ThrowInvalid();
+      }
+      ++m_position;
+    }
+
+    // Reads a string after its opening quote, returns whether it has escaped characters.
+    bool ReadString(char const*& text, size_t& length)
+    {
+      text = m_position;
+      bool isEscaped = false;
+      while (m_position != m_end && *m_position != '"')
+      {
+        if (*m_position == '\\')
+        {
+          isEscaped = true;
+          if (++m_position == m_end)
+          {
+            ThrowInvalid();
+          }
+        }
+        ++m_position;
+      }
+      if (m_position == m_end)
+      {
+        ThrowInvalid();
+      }
+      length = static_cast<size_t>(m_position - text);
+      ++m_position;
+      return isEscaped;
+    }
+
+    void SkipLiteral(char const* literal)
+    {
+      const size_t length = std::strlen(literal);
+      if (static_cast<size_t>(m_end - m_position) < length
+          || std::memcmp(m_position, literal, length) != 0)
+      {
+        ThrowInvalid();
+      }
+      m_position += length;
+    }
+
+    // Skips a number, or a nested object or array.
+    void SkipValue()
+    {
+      SkipWhitespace();
+      if (m_position == m_end)
+      {
+        ThrowInvalid();
+      }
+      if (*m_position == '{' || *m_position == '[')
+      {
+        size_t depth = 0;
+        while (m_position != m_end)
+        {
+          const char c = *m_position++;
+          if (c == '"')
+          {
+            char const* text;
+            size_t length;
+            ReadString(text, length);
+          }
+          else if (c == '{' || c == '[')
+          {
+            ++depth;
+          }
+          else if ((c == '}' || c == ']') && --depth == 0)
+          {
+            return;
+          }
+        }
+        ThrowInvalid();
+      }
+      char const* start = m_position;
+      while (m_position != m_end && std::strchr("+-.0123456789eE", *m_position) != nullptr
+             && *m_position != '\0')
+      {
+        ++m_position;
+      }
+      if (m_position == start)
+      {
+        ThrowInvalid();
+      }
+    }
+
+    static void AppendUtf8(std::string& text, uint32_t codePoint)
+    {
+      if (codePoint < 0x80)
+      {
+        text.push_back(static_cast<char>(codePoint));
+      }
+      else if (codePoint < 0x800)
+      {
+        text.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+        text.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+      }
+      else if (codePoint < 0x10000)
+      {
+        text.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        text.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+      }
+      else
+      {
+        text.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+        text.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        text.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+      }
+    }
+
+    static uint32_t ReadHex4(char const*& position, char const* end)
+    {
+      if (end - position < 4)
+      {
+        ThrowInvalid();
+      }
+      uint32_t value = 0;
+      for (int i = 0; i < 4; ++i)
+      {
+        const char c = *position++;
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+        {
+          value |= static_cast<uint32_t>(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+          value |= static_cast<uint32_t>(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+          value |= static_cast<uint32_t>(c - 'A' + 10);
+        }
+        else
+        {
+          ThrowInvalid();
+        }
+      }
+      return value;
+    }
+
+    static std::string Unescape(char const* text, size_t length)
+    {
+      std::string value;
+      value.reserve(length);
+      char const* const end = text + length;
+      while (text != end)
+      {
+        const char c = *text++;
+        if (c != '\\')
+        {
+          value.push_back(c);
+          continue;
+        }
+        switch (*text++)
+        {
+          case '"':
+            value.push_back('"');
+            break;
+          case '\\':
+            value.push_back('\\');
+            break;
+          case '/':
+            value.push_back('/');
+            break;
+          case 'b':
+            value.push_back('\b');
+            break;
+          case 'f':
+            value.push_back('\f');
+            break;
+          case 'n':
+            value.push_back('\n');
+            break;
+          case 'r':
+            value.push_back('\r');
+            break;
+          case 't':
+            value.push_back('\t');
+            break;
+          case 'u': {
+            uint32_t codePoint = ReadHex4(text, end);
+            // A character beyond the basic plane is escaped as a surrogate pair.
+            if (codePoint >= 0xd800 && codePoint < 0xdc00 && end - text >= 6 && text[0] == '\\'
+                && text[1] == 'u')
+            {
+              text += 2;
+              const uint32_t low = ReadHex4(text, end);
+              codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+            }
+            AppendUtf8(value, codePoint);
+            break;
+          }
+          default:
+            ThrowInvalid();
+        }
+      }
+      return value;
+    }
+
+    Property const* Find(JsonKey const& key) const
+    {
+      for (auto const& property : m_properties)
+      {
+        if (property.Hash == key.Hash && property.NameLength == key.Length
+            && std::memcmp(property.Name, key.Name, key.Length) == 0)
+        {
+          return &property;
+        }
+      }
+      return nullptr;
+    }
+
+    Property const& FindString(JsonKey const& key) const
+    {
+      auto const property = Find(key);
+      if (property == nullptr || property->Kind != ValueKind::String)
+      {
+        throw std::invalid_argument(
+            "The property '" + std::string(key.Name, key.Length) + "' is not a string.");
+      }
+      return *property;
+    }
+
+  public:
+    /**
+     * @brief Reads the properties of a JSON object.
+     *
+     * @param body The JSON text of the object.
+     *
+     * @throw std::invalid_argument when the body is not a JSON object.
+     */
+    explicit FlatJsonReader(std::vector<uint8_t> const& body)
+        : m_position(reinterpret_cast<char const*>(body.data())),
+          m_end(reinterpret_cast<char const*>(body.data()) + body.size())
+    {
+      Expect('{');
+      SkipWhitespace();
+      if (m_position != m_end && *m_position == '}')
+      {
+        ++m_position;
+        return;
+      }
+      while (true)
+      {
+        Property property{};
+        Expect('"');
+        if (ReadString(property.Name, property.NameLength))
+        {
+          // The names of the properties looked up are never escaped.
+          property.Name = nullptr;
+          property.NameLength = 0;
+        }
+        property.Hash = JsonKey::ComputeHash(property.Name, property.NameLength);
+        Expect(':');
+        SkipWhitespace();
+        if (m_position == m_end)
+        {
+          ThrowInvalid();
+        }
+        switch (*m_position)
+        {
+          case '"':
+            ++m_position;
+            property.Kind = ValueKind::String;
+            property.IsEscaped = ReadString(property.Value, property.ValueLength);
+            break;
+          case 't':
+            property.Kind = ValueKind::True;
+            SkipLiteral("true");
+            break;
+          case 'f':
+            property.Kind = ValueKind::False;
+            SkipLiteral("false");
+            break;
+          case 'n':
+            property.Kind = ValueKind::Null;
+            SkipLiteral("null");
+            break;
+          default:
+            property.Kind = ValueKind::Other;
+            SkipValue();
+            break;
+        }
+        m_properties.push_back(property);
+
+        SkipWhitespace();
+        if (m_position != m_end && *m_position == ',')
+        {
+          ++m_position;
+          continue;
+        }
+        Expect('}');
+        return;
+      }
+    }
+
+    // The reader points into the body.
+    explicit FlatJsonReader(std::vector<uint8_t>&&) = delete;
+
+    /**
+     * @brief Checks if the object has a property which is not null.
+     *
+     */
+    bool Contains(JsonKey const& key) const
+    {
+      auto const property = Find(key);
+      return property != nullptr && property->Kind != ValueKind::Null;
+    }
+
+    /**
+     * @brief Gets a string property.
+     *
+     * @throw std::invalid_argument when the property is missing or not a string.
+     */
+    std::string GetString(JsonKey const& key) const
+    {
+      auto const& property = FindString(key);
+      return property.IsEscaped ? Unescape(property.Value, property.ValueLength)
+                                : std::string(property.Value, property.ValueLength);
+    }
+
+    /**
+     * @brief Gets a binary property encoded as Base64URL, decoded straight from the body.
+     *
+     * @throw std::invalid_argument when the property is missing or not Base64URL text.
+     */
+    std::vector<uint8_t> GetBase64Url(JsonKey const& key) const
+    {
+      auto const& property = FindString(key);
+      if (property.IsEscaped)
+      {
+        const std::string text = Unescape(property.Value, property.ValueLength);
+        return Azure::Core::_internal::Base64Url::Base64UrlDecode(text);
+      }
+      std::vector<uint8_t> value(Azure::Core::_internal::Base64Url::DecodedLength(
+          property.Value, property.ValueLength));
+      Azure::Core::_internal::Base64Url::Base64UrlDecode(
+          property.Value, property.ValueLength, value.data());
+      return value;
+    }
+
+    /**
+     * @brief Gets a boolean property.
+     *
+     * @throw std::invalid_argument when the property is missing or not a boolean.
+     */
+    bool GetBool(JsonKey const& key) const
+    {
+      auto const property = Find(key);
+      if (property == nullptr
+          || (property->Kind != ValueKind::True && property->Kind != ValueKind::False))
+      {
+        throw std::invalid_argument(
+            "The property '" + std::string(key.Name, key.Length) + "' is not a boolean.");
+      }
+      return property->Kind == ValueKind::True;
+    }
+  };
+
+}}}} // namespace Azure::Security::KeyVault::_internal
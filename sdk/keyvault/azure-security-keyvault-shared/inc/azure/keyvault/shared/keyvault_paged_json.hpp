@@ -0,0 +1,219 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Parses the JSON pages returned by the Key Vault list operations.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/internal/json/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Azure { namespace Security { namespace KeyVault { namespace _internal {
+
+  /**
+   * @brief Parses a page of items, such as `{"value": [...], "nextLink": "..."}`, one item at a
+   * time.
+   *
+   * @remark Parsing the whole page into a JSON document keeps every item in memory, several times
+   * the size of the body, until the page is deserialized. The page is parsed with the SAX
+   * interface of the JSON library instead, and each element of the `value` array is handed out
+   * as soon as it is parsed, so only one item is in memory at a time.
+   */
+  class PagedJsonParser final {
+    PagedJsonParser() = delete;
+
+    using json = Azure::Core::Json::_internal::json;
+
+    template <class OnItem> class SaxHandler final {
+    private:
+      using DomParser = Azure::Core::Json::_internal::detail::json_sax_dom_parser<json>;
+
+      OnItem& m_onItem;
+      DomParser m_page;
+      // The item being parsed, if any, and the depth of its containers.
+      json m_item;
+      std::unique_ptr<DomParser> m_itemParser;
+      size_t m_itemDepth = 0;
+      // The depth of the containers of the page, the page object itself is depth one.
+      size_t m_depth = 0;
+      bool m_lastKeyIsValue = false;
+      bool m_inValueArray = false;
+
+      bool IsItemStart() const { return !m_itemParser && m_inValueArray && m_depth == 2; }
+
+      void StartItem()
+      {
+        m_item = json();
+        m_itemParser = std::make_unique<DomParser>(m_item);
+        m_itemDepth = 0;
+      }
+
+      void EndItem()
+      {
+        m_itemParser.reset();
+        m_onItem(static_cast<json const&>(m_item));
+      }
+
+      // Values which are not containers are complete items by themselves.
+      template <class Function> bool Value(Function const& function)
+      {
+        if (m_itemParser)
+        {
+          return function(*m_itemParser);
+        }
+        if (IsItemStart())
+        {
+          StartItem();
+          auto const result = function(*m_itemParser);
+          EndItem();
+          return result;
+        }
+        return function(m_page);
+      }
+
+      template <class Function> bool StartContainer(bool isArray, Function const& function)
+      {
+        if (IsItemStart())
+        {
+          StartItem();
+        }
+        if (m_itemParser)
+        {
+          ++m_itemDepth;
+          return function(*m_itemParser);
+        }
+
+        m_inValueArray = isArray && m_depth == 1 && m_lastKeyIsValue;
+        ++m_depth;
+        return function(m_page);
+      }
+
+      template <class Function> bool EndContainer(Function const& function)
+      {
+        if (m_itemParser)
+        {
+          auto const result = function(*m_itemParser);
+          if (--m_itemDepth == 0)
+          {
+            EndItem();
+          }
+          return result;
+        }
+
+        m_inValueArray = false;
+        --m_depth;
+        return function(m_page);
+      }
+
+    public:
+      using number_integer_t = json::number_integer_t;
+      using number_unsigned_t = json::number_unsigned_t;
+      using number_float_t = json::number_float_t;
+      using string_t = json::string_t;
+      using binary_t = json::binary_t;
+
+      SaxHandler(json& page, OnItem& onItem) : m_onItem(onItem), m_page(page) {}
+
+      bool null()
+      {
+        return Value([](DomParser& parser) { return parser.null(); });
+      }
+
+      bool boolean(bool val)
+      {
+        return Value([val](DomParser& parser) { return parser.boolean(val); });
+      }
+
+      bool number_integer(number_integer_t val)
+      {
+        return Value([val](DomParser& parser) { return parser.number_integer(val); });
+      }
+
+      bool number_unsigned(number_unsigned_t val)
+      {
+        return Value([val](DomParser& parser) { return parser.number_unsigned(val); });
+      }
+
+      bool number_float(number_float_t val, string_t const& text)
+      {
+        return Value([val, &text](DomParser& parser) { return parser.number_float(val, text); });
+      }
+
+      bool string(string_t& val)
+      {
+        return Value([&val](DomParser& parser) { return parser.string(val); });
+      }
+
+      bool binary(binary_t& val)
+      {
+        return Value([&val](DomParser& parser) { return parser.binary(val); });
+      }
+
+      bool key(string_t& val)
+      {
+        if (m_itemParser)
+        {
+          return m_itemParser->key(val);
+        }
+        m_lastKeyIsValue = m_depth == 1 && val == "value";
+        return m_page.key(val);
+      }
+
+      bool start_object(std::size_t len)
+      {
+        return StartContainer(false, [len](DomParser& parser) { return parser.start_object(len); });
+      }
+
+      bool end_object()
+      {
+        return EndContainer([](DomParser& parser) { return parser.end_object(); });
+      }
+
+      bool start_array(std::size_t len)
+      {
+        return StartContainer(true, [len](DomParser& parser) { return parser.start_array(len); });
+      }
+
+      bool end_array()
+      {
+        return EndContainer([](DomParser& parser) { return parser.end_array(); });
+      }
+
+      template <class Exception>
+      bool parse_error(std::size_t position, std::string const& lastToken, Exception const& ex)
+      {
+        return m_page.parse_error(position, lastToken, ex);
+      }
+    };
+
+  public:
+    /**
+     * @brief Parses a page, calling \p onItem with each element of its `value` array.
+     *
+     * @param body The JSON body of the page.
+     * @param onItem Called with the JSON value of each item, which is only valid during the call.
+     *
+     * @return The page without the items of its `value` array, which is left empty.
+     *
+     * @throw Azure::Core::Json::_internal::json::parse_error when the body is not valid JSON.
+     */
+    template <class OnItem> static json Parse(std::vector<uint8_t> const& body, OnItem onItem)
+    {
+      json page;
+      SaxHandler<OnItem> handler(page, onItem);
+      json::sax_parse(body, &handler);
+      return page;
+    }
+  };
+
+}}}} // namespace Azure::Security::KeyVault::_internal
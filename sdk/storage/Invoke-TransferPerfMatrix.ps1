@@ -0,0 +1,54 @@
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+# Runs a storage transfer performance test over every combination of the blob size, the
+# concurrency and the chunk size, and appends the results to a CSV file. The tests are
+# UploadBlobFrom and DownloadBlobTo of azure-storage-blobs-perf, and UploadFileFrom and
+# DownloadFileTo of azure-storage-files-shares-perf and azure-storage-files-datalake-perf.
+#
+# The STORAGE_CONNECTION_STRING environment variable must be set. The sizes below the chunk size
+# are transferred in one request, so they are only run once, with the smallest chunk size and
+# concurrency.
+#
+# Example:
+#   ./Invoke-TransferPerfMatrix.ps1 -PerfExecutable build/sdk/storage/azure-storage-blobs/test/perf/azure-storage-blobs-perf -Test DownloadBlobTo
+
+[CmdletBinding()]
+param (
+    [Parameter(Mandatory = $true)]
+    [string] $PerfExecutable,
+    [Parameter(Mandatory = $true)]
+    [string] $Test,
+    [long[]] $Sizes = @(1KB, 1MB, 16MB, 256MB, 1GB, 10GB),
+    [int[]] $Concurrency = @(1, 2, 4, 8, 16, 32, 64),
+    [long[]] $ChunkSizes = @(1MB, 4MB, 16MB, 64MB),
+    [int] $Duration = 30,
+    [int] $Warmup = 5,
+    [string] $ResultsFile = "$Test.csv"
+)
+
+$ErrorActionPreference = 'Stop'
+$smallestChunkSize = ($ChunkSizes | Measure-Object -Minimum).Minimum
+$smallestConcurrency = ($Concurrency | Measure-Object -Minimum).Minimum
+
+foreach ($size in $Sizes) {
+    foreach ($chunkSize in $ChunkSizes) {
+        if ($size -le $smallestChunkSize -and $chunkSize -ne $smallestChunkSize) {
+            continue
+        }
+        $threadCounts = if ($size -le $smallestChunkSize) { @($smallestConcurrency) } else { $Concurrency }
+        foreach ($threads in $threadCounts) {
+            Write-Host "$Test size=$size concurrency=$threads chunk-size=$chunkSize"
+            & $PerfExecutable $Test `
+                --size $size `
+                --concurrency $threads `
+                --chunk-size $chunkSize `
+                -d $Duration `
+                -w $Warmup `
+                --results-file $ResultsFile
+            if ($LASTEXITCODE -ne 0) {
+                Write-Error "$Test failed with exit code $LASTEXITCODE."
+            }
+        }
+    }
+}
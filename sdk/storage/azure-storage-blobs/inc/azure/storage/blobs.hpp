@@ -9,11 +9,20 @@
 #pragma once
 
 #include "azure/storage/blobs/append_blob_client.hpp"
+#include "azure/storage/blobs/append_blob_writer.hpp"
+#include "azure/storage/blobs/blob_batch_client.hpp"
+#include "azure/storage/blobs/blob_change_feed_client.hpp"
 #include "azure/storage/blobs/blob_client.hpp"
+#include "azure/storage/blobs/blob_client_side_encryption.hpp"
 #include "azure/storage/blobs/blob_container_client.hpp"
+#include "azure/storage/blobs/blob_download_cache.hpp"
 #include "azure/storage/blobs/blob_lease_client.hpp"
+#include "azure/storage/blobs/blob_lease_manager.hpp"
+#include "azure/storage/blobs/blob_read_stream.hpp"
 #include "azure/storage/blobs/blob_sas_builder.hpp"
 #include "azure/storage/blobs/blob_service_client.hpp"
 #include "azure/storage/blobs/block_blob_client.hpp"
 #include "azure/storage/blobs/dll_import_export.hpp"
 #include "azure/storage/blobs/page_blob_client.hpp"
+#include "azure/storage/blobs/page_blob_writer.hpp"
+#include "azure/storage/blobs/striped_blob_container_client.hpp"
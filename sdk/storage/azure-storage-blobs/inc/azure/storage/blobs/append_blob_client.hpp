@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 
+#include "azure/storage/blobs/append_blob_writer.hpp"
 #include "azure/storage/blobs/blob_client.hpp"
 
 namespace Azure { namespace Storage { namespace Blobs {
@@ -159,6 +160,19 @@ namespace Azure { namespace Storage { namespace Blobs {
         const AppendBlockFromUriOptions& options = AppendBlockFromUriOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Opens a writer appending the data written to it to this append blob, by blocks
+     * grouping many writes instead of a request per write.
+     *
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations. Cancelling it also fails the
+     * appends of the writer.
+     * @return An AppendBlobWriter appending to the blob from its current end.
+     */
+    std::unique_ptr<AppendBlobWriter> OpenWrite(
+        const OpenWriteAppendBlobOptions& options = OpenWriteAppendBlobOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Seals the append blob, making it read only. Any subsequent appends will fail.
      *
@@ -173,6 +187,7 @@ namespace Azure { namespace Storage { namespace Blobs {
   private:
     explicit AppendBlobClient(BlobClient blobClient);
     friend class BlobClient;
+    friend class BlobContainerClient;
   };
 
 }}} // namespace Azure::Storage::Blobs
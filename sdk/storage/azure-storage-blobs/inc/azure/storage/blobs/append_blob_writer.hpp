@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <azure/core/context.hpp>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  class AppendBlobClient;
+  struct OpenWriteAppendBlobOptions;
+
+  /**
+   * @brief A writer appending to an append blob, returned by
+   * #Azure::Storage::Blobs::AppendBlobClient::OpenWrite.
+   *
+   * @remark The data written is buffered in memory and appended in the background by blocks of up
+   * to the block size of the options, as soon as a block is full or once its data has waited for
+   * the flush interval of the options. The blocks are appended one at a time and in order, each
+   * at the position the previous one ended at, so that the data appended to the blob by another
+   * client in between fails the writer instead of being interleaved with its data. Writes wait
+   * while the writer buffers the maximum buffered size of the options. The writer is thread-safe,
+   * the data is appended in the order it is written.
+   */
+  class AppendBlobWriter final {
+  public:
+    /**
+     * @brief Appends the data written and not appended yet, ignoring failures, and stops the
+     * background appends. Call Flush() first to know whether the data was appended.
+     */
+    ~AppendBlobWriter();
+
+    /**
+     * @brief Writes data to the blob. The data is copied, and appended later.
+     *
+     * @param data The data to append.
+     * @param length The number of bytes of data.
+     * @param context Context for cancelling the wait for the buffer to have room for the data.
+     *
+     * @throw Azure::Storage::StorageException A previous append failed, the data wasn't written.
+     */
+    void Write(
+        const uint8_t* data,
+        size_t length,
+        const Azure::Core::Context& context = Azure::Core::Context());
+
+    /**
+     * @brief Appends all the data written so far, without waiting for the block size or the flush
+     * interval, and waits for it to be appended. The flushes of several threads at the same time
+     * share the same appends.
+     *
+     * @param context Context for cancelling the wait for the data to be appended.
+     *
+     * @throw Azure::Storage::StorageException An append failed. All the following writes and
+     * flushes fail too.
+     */
+    void Flush(const Azure::Core::Context& context = Azure::Core::Context());
+
+    /**
+     * @brief Gets the size of the blob after the data appended by the writer so far.
+     *
+     * @return The append position of the next block.
+     */
+    int64_t GetCommittedSize() const;
+
+  private:
+    struct State;
+
+    explicit AppendBlobWriter(
+        const AppendBlobClient& client,
+        const OpenWriteAppendBlobOptions& options,
+        int64_t blobSize,
+        const Azure::Core::Context& context);
+
+    std::unique_ptr<State> m_state;
+
+    friend class AppendBlobClient;
+  };
+
+}}} // namespace Azure::Storage::Blobs
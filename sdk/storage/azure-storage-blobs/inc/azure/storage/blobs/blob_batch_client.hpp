@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <azure/core/credentials/credentials.hpp>
+#include <azure/core/http/http.hpp>
+#include <azure/storage/common/storage_credential.hpp>
+
+#include "azure/storage/blobs/blob_options.hpp"
+#include "azure/storage/blobs/blob_responses.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  class BlobBatchClient;
+
+  /**
+   * @brief A batch of operations on blobs, sent to the service in a single request by
+   * #Azure::Storage::Blobs::BlobBatchClient::SubmitBatch.
+   *
+   * @remark A batch holds up to 256 operations, all of them deletes or all of them access tier
+   * changes.
+   */
+  class BlobBatch final {
+  public:
+    /**
+     * @brief Adds the deletion of a blob to the batch.
+     *
+     * @param blobContainerName The name of the container of the blob.
+     * @param blobName The name of the blob to delete.
+     * @param options Optional parameters of the deletion.
+     * @return The index of the result of the operation in
+     * #Azure::Storage::Blobs::Models::SubmitBlobBatchResult::OperationResults.
+     *
+     * @throw std::invalid_argument The batch is full or holds other operations than deletes.
+     */
+    int32_t DeleteBlob(
+        const std::string& blobContainerName,
+        const std::string& blobName,
+        const DeleteBlobOptions& options = DeleteBlobOptions());
+
+    /**
+     * @brief Adds the change of the access tier of a blob to the batch.
+     *
+     * @param blobContainerName The name of the container of the blob.
+     * @param blobName The name of the blob.
+     * @param tier The new access tier of the blob.
+     * @param options Optional parameters of the change.
+     * @return The index of the result of the operation in
+     * #Azure::Storage::Blobs::Models::SubmitBlobBatchResult::OperationResults.
+     *
+     * @throw std::invalid_argument The batch is full or holds other operations than access tier
+     * changes.
+     */
+    int32_t SetBlobAccessTier(
+        const std::string& blobContainerName,
+        const std::string& blobName,
+        Models::AccessTier tier,
+        const SetBlobAccessTierOptions& options = SetBlobAccessTierOptions());
+
+    /**
+     * @brief Gets the number of operations in the batch.
+     *
+     * @return The number of operations added to the batch.
+     */
+    int32_t GetOperationCount() const { return static_cast<int32_t>(m_subRequests.size()); }
+
+  private:
+    enum class OperationType
+    {
+      None,
+      Delete,
+      SetAccessTier,
+    };
+
+    explicit BlobBatch(Azure::Core::Url serviceUrl) : m_serviceUrl(std::move(serviceUrl)) {}
+
+    Azure::Core::Url GetBlobUrl(const std::string& blobContainerName, const std::string& blobName)
+        const;
+    int32_t AddSubRequest(OperationType operationType, Azure::Core::Http::Request subRequest);
+
+    Azure::Core::Url m_serviceUrl;
+    OperationType m_operationType = OperationType::None;
+    std::vector<Azure::Core::Http::Request> m_subRequests;
+
+    friend class BlobBatchClient;
+  };
+
+  /**
+   * The BlobBatchClient sends batches of blob operations to the Blob service, each of them in a
+   * single `multipart/mixed` request, instead of a request per operation.
+   */
+  class BlobBatchClient final {
+  public:
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param connectionString A connection string includes the authentication information required
+     * for your application to access data in an Azure Storage account at runtime.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     * @return A new BlobBatchClient instance.
+     */
+    static BlobBatchClient CreateFromConnectionString(
+        const std::string& connectionString,
+        const BlobClientOptions& options = BlobClientOptions());
+
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param serviceUrl A URL referencing the blob service that includes the name of the account.
+     * @param credential The shared key credential used to sign the batch and its operations.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     */
+    explicit BlobBatchClient(
+        const std::string& serviceUrl,
+        std::shared_ptr<StorageSharedKeyCredential> credential,
+        const BlobClientOptions& options = BlobClientOptions());
+
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param serviceUrl A URL referencing the blob service that includes the name of the account.
+     * @param credential The token credential used to sign the batch and its operations.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     */
+    explicit BlobBatchClient(
+        const std::string& serviceUrl,
+        std::shared_ptr<Core::Credentials::TokenCredential> credential,
+        const BlobClientOptions& options = BlobClientOptions());
+
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param serviceUrl A URL referencing the blob service that includes the name of the account,
+     * and possibly also a SAS token.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     */
+    explicit BlobBatchClient(
+        const std::string& serviceUrl,
+        const BlobClientOptions& options = BlobClientOptions());
+
+    /**
+     * @brief Creates an empty batch of operations on the blobs of this account.
+     *
+     * @return A new BlobBatch instance.
+     */
+    BlobBatch CreateBatch() const { return BlobBatch(m_serviceUrl); }
+
+    /**
+     * @brief Sends the operations of a batch in a single request.
+     *
+     * @remark The request succeeds even when some of its operations fail, the result of each
+     * operation has its own status code.
+     *
+     * @param batch The batch of operations to send.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A SubmitBlobBatchResult with the results of the operations, in the order they
+     * were added to the batch.
+     *
+     * @throw std::invalid_argument The batch is empty.
+     * @throw Azure::Storage::StorageException The batch request failed.
+     */
+    Azure::Response<Models::SubmitBlobBatchResult> SubmitBatch(
+        const BlobBatch& batch,
+        const SubmitBlobBatchOptions& options = SubmitBlobBatchOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Sends several batches at the same time, on different connections.
+     *
+     * @param batches The batches of operations to send.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return The results of the batches, in the order of \p batches.
+     *
+     * @throw std::invalid_argument A batch is empty.
+     * @throw Azure::Storage::StorageException A batch request failed. The other batches started
+     * are still sent.
+     */
+    std::vector<Models::SubmitBlobBatchResult> SubmitBatches(
+        const std::vector<BlobBatch>& batches,
+        const SubmitBlobBatchesOptions& options = SubmitBlobBatchesOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+  private:
+    explicit BlobBatchClient(
+        const std::string& serviceUrl,
+        std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> authenticationPolicy,
+        const BlobClientOptions& options);
+
+    Azure::Core::Url m_serviceUrl;
+    std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    // Signs the operations of the batches, without sending them.
+    std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_subRequestPipeline;
+    std::shared_ptr<TransferExecutor> m_transferExecutor;
+  };
+
+}}} // namespace Azure::Storage::Blobs
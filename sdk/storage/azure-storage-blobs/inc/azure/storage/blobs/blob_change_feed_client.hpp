@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "azure/storage/blobs/blob_container_client.hpp"
+#include "azure/storage/blobs/blob_service_client.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  /**
+   * The BlobChangeFeedClient reads the change feed of a storage account, the log of the changes
+   * to its blobs kept by the service in the `$blobchangefeed` container, so that the changes are
+   * found without listing the blobs.
+   *
+   * @remark The change feed is split in segments of about an hour, and the events of a segment
+   * in shards. The segments are read in order, the shards of a segment at the same time. The
+   * events of a blob are in the same shard, in order.
+   */
+  class BlobChangeFeedClient final {
+  public:
+    /**
+     * @brief Initialize a new instance of BlobChangeFeedClient.
+     *
+     * @param serviceClient The storage account whose change feed is read.
+     */
+    explicit BlobChangeFeedClient(const BlobServiceClient& serviceClient);
+
+    /**
+     * @brief Reads the events of the change feed which can be read, up to the time of the last
+     * consumable events published by the service.
+     *
+     * @remark The events are passed to \p onEvents in pages, from several threads at the same
+     * time, one for each shard read at the same time. Each page comes with a cursor, which reads
+     * the events following the page and the pages of the other shards passed before, so that a
+     * read which is interrupted can be resumed from the cursor of the last page handled. A
+     * resumed read may pass some events again, the events of the pages of the other shards which
+     * were being handled at the same time.
+     *
+     * @param onEvents Called with the events of each page and its cursor. It must be safe to
+     * call it from several threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return The cursor following all the events read, to read the events published later.
+     *
+     * @throw std::invalid_argument The cursor of the options isn't valid.
+     */
+    std::string ReadEvents(
+        const std::function<void(std::vector<Models::BlobChangeFeedEvent>, const std::string&)>&
+            onEvents,
+        const ReadBlobChangeFeedOptions& options = ReadBlobChangeFeedOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+  private:
+    BlobContainerClient m_containerClient;
+  };
+
+}}} // namespace Azure::Storage::Blobs
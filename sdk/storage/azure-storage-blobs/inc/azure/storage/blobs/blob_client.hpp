@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -12,6 +13,7 @@
 #include <azure/storage/common/storage_credential.hpp>
 
 #include "azure/storage/blobs/blob_options.hpp"
+#include "azure/storage/blobs/blob_read_stream.hpp"
 #include "azure/storage/blobs/blob_responses.hpp"
 #include "azure/storage/blobs/protocol/blob_rest_client.hpp"
 
@@ -295,6 +297,66 @@ namespace Azure { namespace Storage { namespace Blobs {
         const DownloadBlobToOptions& options = DownloadBlobToOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Downloads a blob or a blob range from the service using parallel requests, and
+     * passes its content to a sink in order as it is downloaded, such as to forward it to a pipe
+     * or a socket.
+     *
+     * @remark The chunks following the one passed to the sink are downloaded in the background,
+     * up to the concurrency of the options, into buffers taken from the buffer pool of the
+     * client. The downloads wait while the sink is busy with an earlier chunk, so at most that
+     * many chunks are held in memory. The first request is of ChunkSize bytes rather than
+     * InitialChunkSize. The sink is called by the calling thread only, and the download stops
+     * if it throws. The content is passed as it's stored, blobs compressed or encrypted by
+     * `BlockBlobClient::UploadFrom()` aren't decompressed or decrypted.
+     *
+     * @param sink Called with the data and the length of each chunk, in order.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A DownloadBlobToResult describing the downloaded blob.
+     */
+    Azure::Response<Models::DownloadBlobToResult> DownloadTo(
+        const std::function<void(const uint8_t*, size_t)>& sink,
+        const DownloadBlobToOptions& options = DownloadBlobToOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Downloads a blob or a blob range from the service using parallel requests, and
+     * passes each chunk to a handler as soon as it's received, in no particular order, such as to
+     * hash or index the chunks.
+     *
+     * @remark The handler is called by the thread which downloaded the chunk, from several
+     * threads at the same time, with the chunk in a buffer taken from the buffer pool of the
+     * client, which is given back once the handler returns. The first chunk is downloaded before
+     * the others to get the size of the blob. The download stops if the handler throws. The
+     * content is passed as it's stored, blobs compressed or encrypted by
+     * `BlockBlobClient::UploadFrom()` aren't decompressed or decrypted.
+     *
+     * @param onChunk Called with the offset of each chunk in the blob, its data and its length.
+     * It must be safe to call it from several threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A DownloadBlobToResult describing the downloaded blob.
+     */
+    Azure::Response<Models::DownloadBlobToResult> DownloadConcurrently(
+        const std::function<void(int64_t, const uint8_t*, size_t)>& onChunk,
+        const DownloadBlobConcurrentlyOptions& options = DownloadBlobConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Opens a stream reading a blob or a blob range, which downloads the ranges following
+     * its position in the background while they are read.
+     *
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations. Cancelling it cancels the
+     * downloads of the stream.
+     * @return A BlobReadStream reading the blob. It fails to read if the blob is modified after the
+     * stream is opened.
+     */
+    std::unique_ptr<BlobReadStream> OpenRead(
+        const OpenReadOptions& options = OpenReadOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Creates a read-only snapshot of a blob.
      *
@@ -372,16 +434,21 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
     Azure::Nullable<EncryptionKey> m_customerProvidedKey;
     Azure::Nullable<std::string> m_encryptionScope;
+    std::shared_ptr<TransferExecutor> m_transferExecutor;
+    std::shared_ptr<BufferPool> m_bufferPool;
 
   private:
     explicit BlobClient(
         Azure::Core::Url blobUrl,
         std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline,
         Azure::Nullable<EncryptionKey> customerProvidedKey = Azure::Nullable<EncryptionKey>(),
-        Azure::Nullable<std::string> encryptionScope = Azure::Nullable<std::string>())
+        Azure::Nullable<std::string> encryptionScope = Azure::Nullable<std::string>(),
+        std::shared_ptr<TransferExecutor> transferExecutor = nullptr,
+        std::shared_ptr<BufferPool> bufferPool = nullptr)
         : m_blobUrl(std::move(blobUrl)), m_pipeline(std::move(pipeline)),
           m_customerProvidedKey(std::move(customerProvidedKey)),
-          m_encryptionScope(std::move(encryptionScope))
+          m_encryptionScope(std::move(encryptionScope)),
+          m_transferExecutor(std::move(transferExecutor)), m_bufferPool(std::move(bufferPool))
     {
     }
 
@@ -390,5 +457,6 @@ namespace Azure { namespace Storage { namespace Blobs {
     friend class Files::DataLake::DataLakeDirectoryClient;
     friend class Files::DataLake::DataLakeFileClient;
     friend class BlobLeaseClient;
+    friend class BlobReadStream;
   };
 }}} // namespace Azure::Storage::Blobs
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <azure/core/context.hpp>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace _detail {
+    struct BlobClientSideEncryptionState;
+    class ClientSideEncryptor;
+  } // namespace _detail
+
+  /**
+   * @brief A key encryption key, which wraps the content keys encrypting the blobs on the client
+   * side.
+   *
+   * @remark It's usually a key of Azure Key Vault, whose functions call `WrapKey()` and
+   * `UnwrapKey()` of a `CryptographyClient` of the key.
+   */
+  class KeyEncryptionKey {
+  public:
+    /**
+     * @brief Destructs the KeyEncryptionKey.
+     */
+    virtual ~KeyEncryptionKey() {}
+
+    /**
+     * @brief Gets the identifier of the key, recorded with the content keys it wraps.
+     *
+     * @return The identifier of the key.
+     */
+    virtual std::string GetKeyId() const = 0;
+
+    /**
+     * @brief Wraps a content key.
+     *
+     * @param algorithm The key wrap algorithm.
+     * @param key The content key.
+     * @param context Context for cancelling long running operations.
+     * @return The wrapped content key.
+     */
+    virtual std::vector<uint8_t> WrapKey(
+        const std::string& algorithm,
+        const std::vector<uint8_t>& key,
+        const Azure::Core::Context& context) const = 0;
+
+    /**
+     * @brief Unwraps a content key wrapped by #WrapKey.
+     *
+     * @param algorithm The key wrap algorithm.
+     * @param wrappedKey The wrapped content key.
+     * @param context Context for cancelling long running operations.
+     * @return The content key.
+     */
+    virtual std::vector<uint8_t> UnwrapKey(
+        const std::string& algorithm,
+        const std::vector<uint8_t>& wrappedKey,
+        const Azure::Core::Context& context) const = 0;
+  };
+
+  /**
+   * @brief Encrypts the blobs uploaded by `BlockBlobClient::UploadFrom()` and decrypts the blobs
+   * downloaded by `BlobClient::DownloadTo()` on the client side.
+   *
+   * @remark The content is encrypted with AES-256-GCM in regions of 4 MiB, each with a random
+   * nonce, in the format of version 2.0 of the client-side encryption of Azure Storage. The
+   * content key and its wrapped form are kept in the metadata `encryptiondata` of the blob. A
+   * content key is generated and wrapped by the first upload, and shared by the other uploads
+   * with the same BlobClientSideEncryption, so that the key encryption key is called once.
+   * Create another BlobClientSideEncryption to rotate the content key. The content keys
+   * unwrapped by the downloads are kept too, so that each is unwrapped once.
+   */
+  class BlobClientSideEncryption final {
+  public:
+    /**
+     * @brief Initializes a new instance of the BlobClientSideEncryption.
+     *
+     * @param keyEncryptionKey The key encryption key wrapping the content keys.
+     * @param keyWrapAlgorithm The key wrap algorithm, for example `RSA-OAEP`.
+     */
+    explicit BlobClientSideEncryption(
+        std::shared_ptr<KeyEncryptionKey> keyEncryptionKey,
+        std::string keyWrapAlgorithm);
+
+    BlobClientSideEncryption(const BlobClientSideEncryption&) = delete;
+    BlobClientSideEncryption& operator=(const BlobClientSideEncryption&) = delete;
+
+    /**
+     * @brief Destructs the BlobClientSideEncryption.
+     */
+    ~BlobClientSideEncryption();
+
+    /**
+     * @brief Gets the key encryption key wrapping the content keys.
+     *
+     * @return The key encryption key.
+     */
+    const std::shared_ptr<KeyEncryptionKey>& GetKeyEncryptionKey() const
+    {
+      return m_keyEncryptionKey;
+    }
+
+    /**
+     * @brief Gets the key wrap algorithm.
+     *
+     * @return The key wrap algorithm.
+     */
+    const std::string& GetKeyWrapAlgorithm() const { return m_keyWrapAlgorithm; }
+
+  private:
+    std::shared_ptr<KeyEncryptionKey> m_keyEncryptionKey;
+    std::string m_keyWrapAlgorithm;
+    std::shared_ptr<_detail::BlobClientSideEncryptionState> m_state;
+
+    friend class _detail::ClientSideEncryptor;
+  };
+
+}}} // namespace Azure::Storage::Blobs
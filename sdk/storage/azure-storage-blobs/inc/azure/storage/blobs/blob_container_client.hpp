@@ -4,8 +4,10 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "azure/storage/blobs/blob_client.hpp"
 
@@ -83,6 +85,10 @@ namespace Azure { namespace Storage { namespace Blobs {
      * @brief Create a new BlobClient object by appending blobName to the end of URL. The
      * new BlobClient uses the same request policy pipeline as this BlobContainerClient.
      *
+     * @remark The pipeline is shared rather than built again, so creating a client for each blob
+     * only costs appending its name to the URL. The same holds for the block, append and page
+     * blob clients.
+     *
      * @param blobName The name of the blob.
      * @return A new BlobClient instance.
      */
@@ -228,6 +234,153 @@ namespace Azure { namespace Storage { namespace Blobs {
         const ListBlobsOptions& options = ListBlobsOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Lists the blobs of this container with several requests at the same time, one for
+     * each partition of the names of the blobs. The partitions are the prefixes of the options,
+     * split further at the virtual directories found with the delimiter of the options.
+     *
+     * @remark The pages of blobs are passed to \p onBlobs once they are received, from several
+     * threads at the same time, so that at most one page per partition listed at the same time is
+     * held in memory. The pages aren't ordered.
+     *
+     * @param onBlobs Called with the blobs of each page. It must be safe to call it from several
+     * threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     */
+    void ListBlobsConcurrently(
+        const std::function<void(std::vector<Models::BlobItem>)>& onBlobs,
+        const ListBlobsConcurrentlyOptions& options = ListBlobsConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Gets the properties of several blobs of this container, with up to the concurrency
+     * of the options requests in flight at the same time over the pooled connections of the
+     * client.
+     *
+     * @remark The properties are passed to \p onProperties once they are received, from several
+     * threads at the same time, in no particular order. A name given more than once is requested
+     * and passed to \p onProperties once.
+     *
+     * @param blobNames The names of the blobs.
+     * @param onProperties Called with the name and the properties of each blob, or null
+     * properties if the blob doesn't exist. It must be safe to call it from several threads at the
+     * same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     *
+     * @throw Azure::Storage::StorageException A request failed for another reason than the blob
+     * not existing. It is thrown once the requests in flight are done.
+     */
+    void GetBlobsProperties(
+        const std::vector<std::string>& blobNames,
+        const std::function<void(const std::string&, Azure::Nullable<Models::BlobProperties>)>&
+            onProperties,
+        const GetBlobsPropertiesOptions& options = GetBlobsPropertiesOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Gets the tags of several blobs of this container, with up to the concurrency of the
+     * options requests in flight at the same time over the pooled connections of the client.
+     *
+     * @remark The tags are passed to \p onTags once they are received, from several threads at
+     * the same time, in no particular order. A name given more than once is requested and passed
+     * to \p onTags once.
+     *
+     * @param blobNames The names of the blobs.
+     * @param onTags Called with the name and the tags of each blob, or null tags if the blob
+     * doesn't exist. It must be safe to call it from several threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     *
+     * @throw Azure::Storage::StorageException A request failed for another reason than the blob
+     * not existing. It is thrown once the requests in flight are done.
+     */
+    void GetBlobsTags(
+        const std::vector<std::string>& blobNames,
+        const std::function<
+            void(const std::string&, Azure::Nullable<std::map<std::string, std::string>>)>& onTags,
+        const GetBlobsTagsOptions& options = GetBlobsTagsOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Downloads several small blobs of this container, with up to the concurrency of the
+     * options downloads in flight at the same time over the pooled connections of the client.
+     *
+     * @remark Each blob is downloaded into memory with a single request, whatever its size, so
+     * it's meant for many small blobs. The contents are passed to \p onContent once they are
+     * received, from several threads at the same time, in no particular order. A name given more
+     * than once is downloaded and passed to \p onContent once.
+     *
+     * @param blobNames The names of the blobs.
+     * @param onContent Called with the name and the content of each blob, or null content if the
+     * blob doesn't exist. It must be safe to call it from several threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A DownloadBlobsResult with the number of blobs and bytes downloaded, and the time
+     * they took.
+     *
+     * @throw Azure::Storage::StorageException A download failed for another reason than the blob
+     * not existing. It is thrown once the downloads in flight are done.
+     */
+    Models::DownloadBlobsResult DownloadBlobs(
+        const std::vector<std::string>& blobNames,
+        const std::function<void(const std::string&, Azure::Nullable<std::vector<uint8_t>>)>&
+            onContent,
+        const DownloadBlobsOptions& options = DownloadBlobsOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Uploads the files of a local directory and its subdirectories as block blobs of this
+     * container, named after their paths relative to the directory.
+     *
+     * @remark The small files and the blocks of the large ones are uploaded on the same workers,
+     * up to the concurrency of the options for all of them together. The blocks of a file are
+     * committed once they are all uploaded.
+     *
+     * @param directory The path of the local directory.
+     * @param blobPrefix The prefix of the names of the blobs, such as "dir/", prepended to the
+     * relative paths of the files.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return An UploadBlobDirectoryResult with the number of files and bytes uploaded.
+     *
+     * @throw std::runtime_error The directory couldn't be listed or a file couldn't be read.
+     * @throw Azure::Storage::StorageException An upload failed. The files done are recorded in
+     * the journal.
+     */
+    Models::UploadBlobDirectoryResult UploadDirectory(
+        const std::string& directory,
+        const std::string& blobPrefix,
+        const UploadBlobDirectoryOptions& options = UploadBlobDirectoryOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Downloads the blobs of this container whose names start with a prefix to the files
+     * of a local directory, named after the rest of their names. The missing subdirectories are
+     * created.
+     *
+     * @remark The small blobs and the chunks of the large ones are downloaded on the same
+     * workers, up to the concurrency of the options for all of them together. Each chunk is
+     * downloaded on the condition that the blob hasn't changed since it was listed.
+     *
+     * @param blobPrefix The prefix of the names of the blobs to download, such as "dir/".
+     * @param directory The path of the local directory.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A DownloadBlobDirectoryResult with the number of blobs and bytes downloaded.
+     *
+     * @throw std::runtime_error A file couldn't be written, or the name of a blob would put its
+     * file outside of the directory.
+     * @throw Azure::Storage::StorageException A download failed. The blobs done are recorded in
+     * the journal.
+     */
+    Models::DownloadBlobDirectoryResult DownloadDirectory(
+        const std::string& blobPrefix,
+        const std::string& directory,
+        const DownloadBlobDirectoryOptions& options = DownloadBlobDirectoryOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Gets the permissions for this container. The permissions indicate whether
      * container data may be accessed publicly.
@@ -289,20 +442,26 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
     Azure::Nullable<EncryptionKey> m_customerProvidedKey;
     Azure::Nullable<std::string> m_encryptionScope;
+    std::shared_ptr<TransferExecutor> m_transferExecutor;
+    std::shared_ptr<BufferPool> m_bufferPool;
 
     explicit BlobContainerClient(
         Azure::Core::Url blobContainerUrl,
         std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline,
         Azure::Nullable<EncryptionKey> customerProvidedKey,
-        Azure::Nullable<std::string> encryptionScope)
+        Azure::Nullable<std::string> encryptionScope,
+        std::shared_ptr<TransferExecutor> transferExecutor,
+        std::shared_ptr<BufferPool> bufferPool)
         : m_blobContainerUrl(std::move(blobContainerUrl)), m_pipeline(std::move(pipeline)),
           m_customerProvidedKey(std::move(customerProvidedKey)),
-          m_encryptionScope(std::move(encryptionScope))
+          m_encryptionScope(std::move(encryptionScope)),
+          m_transferExecutor(std::move(transferExecutor)), m_bufferPool(std::move(bufferPool))
     {
     }
 
     friend class BlobServiceClient;
     friend class BlobLeaseClient;
+    friend class Files::DataLake::DataLakeFileSystemClient;
   };
 
 }}} // namespace Azure::Storage::Blobs
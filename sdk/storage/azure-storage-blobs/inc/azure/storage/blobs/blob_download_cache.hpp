@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace _detail {
+    struct BlobDownloadCacheState;
+    class BlobDownloadCachePolicy;
+  } // namespace _detail
+
+  /**
+   * @brief Keeps the content of the blobs downloaded by the clients sharing it in memory, so that
+   * downloading them again only transfers their content when they have changed.
+   *
+   * @remark Only the downloads of whole blobs, without a range, access conditions or a
+   * customer-provided key, are cached. A cached blob is downloaded again with an `If-None-Match`
+   * condition on its ETag, and the cached content is returned when the service answers `304 Not
+   * Modified`. The blobs are keyed by their URL without the SAS token, and the least recently
+   * downloaded ones are evicted when the cache is full.
+   */
+  class BlobDownloadCache final {
+  public:
+    /**
+     * @brief Initializes a new instance of the BlobDownloadCache.
+     *
+     * @param capacity The maximum total size in bytes of the cached blobs.
+     * @param maxBlobSize The maximum size in bytes of a cached blob, larger blobs are never
+     * cached.
+     *
+     * @throw std::invalid_argument if capacity or maxBlobSize is negative, or if maxBlobSize is
+     * greater than capacity.
+     */
+    explicit BlobDownloadCache(int64_t capacity, int64_t maxBlobSize);
+
+    BlobDownloadCache(const BlobDownloadCache&) = delete;
+    BlobDownloadCache& operator=(const BlobDownloadCache&) = delete;
+
+    /**
+     * @brief Destructs the BlobDownloadCache.
+     */
+    ~BlobDownloadCache();
+
+    /**
+     * @brief Gets the maximum total size of the cached blobs.
+     *
+     * @return The maximum total size in bytes.
+     */
+    int64_t Capacity() const { return m_capacity; }
+
+    /**
+     * @brief Gets the maximum size of a cached blob.
+     *
+     * @return The maximum size in bytes of a cached blob.
+     */
+    int64_t MaxBlobSize() const { return m_maxBlobSize; }
+
+    /**
+     * @brief Gets the total size of the blobs currently cached.
+     *
+     * @return The total size in bytes of the cached blobs.
+     */
+    int64_t Size() const;
+
+    /**
+     * @brief Removes all the blobs from the cache.
+     */
+    void Clear();
+
+  private:
+    int64_t m_capacity;
+    int64_t m_maxBlobSize;
+    std::shared_ptr<_detail::BlobDownloadCacheState> m_state;
+
+    friend class _detail::BlobDownloadCachePolicy;
+  };
+
+}}} // namespace Azure::Storage::Blobs
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "azure/storage/blobs/blob_options.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  /**
+   * @brief Renews many blob and container leases in the background, so that they are held until
+   * they are removed from the manager.
+   *
+   * @remark The renewals of all the leases are scheduled in a single queue ordered by time, and
+   * sent by the few threads of the manager, at most the concurrency of the options at the same
+   * time. A lease is renewed once about half of its duration has elapsed, minus a random jitter
+   * of up to a tenth of its duration, so that the renewals of leases acquired together are spread
+   * over time. A renewal which fails for another reason than the lease being lost is tried again
+   * every second, until the lease expires. The manager is thread-safe.
+   */
+  class BlobLeaseManager final {
+  public:
+    /**
+     * @brief Initializes a new instance of the BlobLeaseManager and starts its threads.
+     *
+     * @param options Optional parameters of the manager.
+     *
+     * @throw std::invalid_argument if the concurrency of the options is less than 1.
+     */
+    explicit BlobLeaseManager(const BlobLeaseManagerOptions& options = BlobLeaseManagerOptions());
+
+    BlobLeaseManager(const BlobLeaseManager&) = delete;
+    BlobLeaseManager& operator=(const BlobLeaseManager&) = delete;
+
+    /**
+     * @brief Stops renewing the leases, without releasing them, and stops the threads of the
+     * manager.
+     */
+    ~BlobLeaseManager();
+
+    /**
+     * @brief Starts renewing a lease.
+     *
+     * @param leaseClient The lease client of the lease, which has just been acquired or renewed.
+     * @param duration The duration the lease was acquired for, between 15 and 60 seconds.
+     *
+     * @throw std::invalid_argument if duration isn't positive, such as the duration of an
+     * infinite lease, which doesn't need to be renewed.
+     */
+    void Add(std::shared_ptr<BlobLeaseClient> leaseClient, std::chrono::seconds duration);
+
+    /**
+     * @brief Stops renewing a lease, without releasing it. A renewal in progress still finishes.
+     *
+     * @param leaseClient The lease client given to Add().
+     * @return True if the lease was renewed by the manager.
+     */
+    bool Remove(const std::shared_ptr<BlobLeaseClient>& leaseClient);
+
+    /**
+     * @brief Gets the number of leases renewed by the manager.
+     *
+     * @return The number of leases added and neither removed nor lost.
+     */
+    size_t GetLeaseCount() const;
+
+  private:
+    struct State;
+
+    std::unique_ptr<State> m_state;
+  };
+
+}}} // namespace Azure::Storage::Blobs
@@ -5,6 +5,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -13,7 +14,14 @@
 #include <azure/core/match_conditions.hpp>
 #include <azure/core/modified_conditions.hpp>
 #include <azure/storage/common/access_conditions.hpp>
-
+#include <azure/storage/common/buffer_pool.hpp>
+#include <azure/storage/common/congestion_controller.hpp>
+#include <azure/storage/common/rate_limiter.hpp>
+#include <azure/storage/common/secondary_read_balancer.hpp>
+#include <azure/storage/common/transfer_executor.hpp>
+
+#include "azure/storage/blobs/blob_client_side_encryption.hpp"
+#include "azure/storage/blobs/blob_download_cache.hpp"
 #include "azure/storage/blobs/protocol/blob_rest_client.hpp"
 
 namespace Azure { namespace Storage { namespace Blobs {
@@ -152,10 +160,52 @@ namespace Azure { namespace Storage { namespace Blobs {
      */
     std::string SecondaryHostForRetryReads;
 
+    /**
+     * @brief Spreads the first tries of the reads between the primary host and
+     * SecondaryHostForRetryReads, instead of only sending the retries to the secondary host. The
+     * same balancer can be shared by several clients. `BlobServiceClient::GetStatistics()` sets
+     * the last sync time of the balancer. If null, or if SecondaryHostForRetryReads is "", the
+     * reads go to the primary host first.
+     */
+    std::shared_ptr<Azure::Storage::SecondaryReadBalancer> SecondaryReadBalancer;
+
     /**
      * API version used by this client.
      */
     std::string ApiVersion = _detail::ApiVersion;
+
+    /**
+     * @brief The executor on which the chunks of concurrent uploads and downloads are
+     * transferred. If null, the default executor shared by all the clients is used.
+     */
+    std::shared_ptr<Azure::Storage::TransferExecutor> TransferExecutor;
+
+    /**
+     * @brief The pool of the buffers through which the chunks of concurrent uploads and downloads
+     * are transferred, which limits their memory. If null, the default pool shared by all the
+     * clients is used.
+     */
+    std::shared_ptr<Azure::Storage::BufferPool> BufferPool;
+
+    /**
+     * @brief Limits the bandwidth and the rate of the requests of the client. The same limiter
+     * can be shared by several clients. If null, there is no limit.
+     */
+    std::shared_ptr<Azure::Storage::RateLimiter> RateLimiter;
+
+    /**
+     * @brief Limits the number of requests of the client in flight to each account, adjusting
+     * the limits when the accounts throttle the requests. The same controller can be shared by
+     * several clients. If null, the requests in flight aren't limited.
+     */
+    std::shared_ptr<Azure::Storage::CongestionController> CongestionController;
+
+    /**
+     * @brief Keeps the content of the downloaded blobs, so that downloading them again only
+     * transfers the ones which have changed. The same cache can be shared by several clients. If
+     * null, nothing is cached.
+     */
+    std::shared_ptr<BlobDownloadCache> DownloadCache;
   };
 
   /**
@@ -249,6 +299,23 @@ namespace Azure { namespace Storage { namespace Blobs {
     Azure::Nullable<int32_t> PageSizeHint;
   };
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Blobs::BlobServiceClient::FindBlobsByTagsConcurrently.
+   */
+  struct FindBlobsByTagsConcurrentlyOptions final
+  {
+    /**
+     * @brief The maximum number of blobs processed at the same time.
+     */
+    int32_t Concurrency = 8;
+
+    /**
+     * @brief Specifies the maximum number of blobs to return in each page.
+     */
+    Azure::Nullable<int32_t> PageSizeHint;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::BlobContainerClient::Create.
    */
@@ -357,6 +424,149 @@ namespace Azure { namespace Storage { namespace Blobs {
     Models::ListBlobsIncludeFlags Include = Models::ListBlobsIncludeFlags::None;
   };
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Blobs::BlobContainerClient::ListBlobsConcurrently.
+   */
+  struct ListBlobsConcurrentlyOptions final
+  {
+    /**
+     * @brief The prefixes of the names of the blobs to list, each of them listed as a partition of
+     * its own. The prefixes must not overlap, such as "a" and "ab". All the blobs of the container
+     * are listed when it's empty.
+     */
+    std::vector<std::string> Prefixes;
+
+    /**
+     * @brief Splits the partitions at the virtual directories found with this delimiter while
+     * they are listed, and lists the directories as partitions of their own. The partitions
+     * aren't split when it's empty.
+     */
+    std::string Delimiter = "/";
+
+    /**
+     * @brief The maximum number of partitions listed at the same time.
+     */
+    int32_t Concurrency = 8;
+
+    /**
+     * @brief Specifies the maximum number of blobs to return in each page.
+     */
+    Azure::Nullable<int32_t> PageSizeHint;
+
+    /**
+     * @brief Specifies one or more datasets to include in the response.
+     */
+    Models::ListBlobsIncludeFlags Include = Models::ListBlobsIncludeFlags::None;
+  };
+
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Blobs::BlobContainerClient::GetBlobsProperties.
+   */
+  struct GetBlobsPropertiesOptions final
+  {
+    /**
+     * @brief The maximum number of requests in flight at the same time.
+     */
+    int32_t Concurrency = 16;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobContainerClient::GetBlobsTags.
+   */
+  struct GetBlobsTagsOptions final
+  {
+    /**
+     * @brief The maximum number of requests in flight at the same time.
+     */
+    int32_t Concurrency = 16;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobContainerClient::DownloadBlobs.
+   */
+  struct DownloadBlobsOptions final
+  {
+    /**
+     * @brief The maximum number of blobs downloaded at the same time.
+     */
+    int32_t Concurrency = 16;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobContainerClient::UploadDirectory.
+   */
+  struct UploadBlobDirectoryOptions final
+  {
+    /**
+     * @brief Indicates the tier to be set on the blobs.
+     */
+    Azure::Nullable<Models::AccessTier> AccessTier;
+
+    /**
+     * @brief The path of a journal file in which the uploaded files are recorded as they are
+     * done. The files it already records, with the same size, are skipped, so that an interrupted
+     * upload started again resumes where it stopped. No journal is kept when it's empty.
+     */
+    std::string JournalPath;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief Files smaller than this are uploaded with a single upload operation, the others
+       * are uploaded in blocks. This value cannot be larger than 5000 MiB.
+       */
+      int64_t SingleUploadThreshold = 256 * 1024 * 1024;
+
+      /**
+       * @brief The size of the blocks of the files uploaded in blocks. This value cannot be
+       * larger than 4000 MiB.
+       */
+      int64_t ChunkSize = 8 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of files and blocks uploaded at the same time, by all the files
+       * together.
+       */
+      int32_t Concurrency = 16;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobContainerClient::DownloadDirectory.
+   */
+  struct DownloadBlobDirectoryOptions final
+  {
+    /**
+     * @brief The path of a journal file in which the downloaded blobs are recorded as they are
+     * done. The blobs it already records, with the same ETag, are skipped, so that an interrupted
+     * download started again resumes where it stopped. No journal is kept when it's empty.
+     */
+    std::string JournalPath;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief Blobs up to this size are downloaded with a single download operation, the others
+       * are downloaded in chunks of this size.
+       */
+      int64_t ChunkSize = 8 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of blobs and chunks downloaded at the same time, by all the
+       * blobs together.
+       */
+      int32_t Concurrency = 16;
+    } TransferOptions;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::BlobContainerClient::GetAccessPolicy.
    */
@@ -586,6 +796,23 @@ namespace Azure { namespace Storage { namespace Blobs {
      */
     Azure::Nullable<Core::Http::HttpRange> Range;
 
+    /**
+     * @brief The size of the blob, if already known, such as from a listing or `GetProperties()`.
+     * When it's set with ETag and the range to download is larger than ChunkSize, all the chunks
+     * of the range are requested concurrently right away, with an If-Match condition on ETag,
+     * instead of after a first request of InitialChunkSize bytes returning the size of the blob.
+     *
+     * @remark The download fails with 412 Precondition Failed if the blob was modified since.
+     * Ignored with ClientSideEncryption. A compressed blob is detected from the responses and
+     * downloaded again the regular way.
+     */
+    Azure::Nullable<int64_t> BlobSize;
+
+    /**
+     * @brief The ETag of the blob whose size is BlobSize.
+     */
+    Azure::ETag ETag;
+
     /**
      * @brief Options for parallel transfer.
      */
@@ -607,7 +834,168 @@ namespace Azure { namespace Storage { namespace Blobs {
        * @brief The maximum number of threads that may be used in a parallel transfer.
        */
       int32_t Concurrency = 5;
+
+      /**
+       * @brief If true, the chunk size and the concurrency are tuned while the blob is downloaded
+       * from the measured throughput, between 1 MiB and ChunkSize and between 1 and Concurrency.
+       * They start small and grow until the throughput stops improving, and shrink when it drops.
+       */
+      bool AutoTune = false;
+
+      /**
+       * @brief If true, the file downloaded to by `DownloadTo(fileName)` is mapped in memory and
+       * the chunks are received into the mapped pages, instead of being written through a buffer.
+       * The disk space of the whole file is allocated before the chunks are downloaded. Ignored
+       * if the file can't be mapped.
+       */
+      bool MemoryMapFile = false;
+
+      /**
+       * @brief If true, the file downloaded to by `DownloadTo(fileName)` is written bypassing the
+       * page cache of the operating system where the file system supports it, so that large
+       * downloads don't evict other data from the cache. The parts of the chunks which aren't
+       * aligned to the block size of the file system are still written through the cache. Takes
+       * precedence over MemoryMapFile.
+       */
+      bool UnbufferedIo = false;
+
+      /**
+       * @brief If true, the file downloaded to by `DownloadTo(fileName)` is written asynchronously
+       * through io_uring on Linux, so that a chunk is received while its previous data is
+       * written. Ignored on other platforms and where io_uring isn't available, or with
+       * MemoryMapFile.
+       */
+      bool AsyncFileIo = false;
+
+      /**
+       * @brief Called with the number of bytes of the range downloaded so far, at most
+       * MaxProgressReportsPerSecond times per second, and once more when the download is done.
+       * The handler is called by the threads of the transfer, one at a time. Not called for the
+       * blobs which are decompressed or decrypted.
+       */
+      std::function<void(int64_t)> ProgressHandler;
+
+      /**
+       * @brief The maximum number of times per second ProgressHandler is called. Every read is
+       * reported if it's not positive.
+       */
+      int32_t MaxProgressReportsPerSecond = 10;
+    } TransferOptions;
+
+    /**
+     * @brief If true, the CRC64 of every range is requested from the service and compared with the
+     * CRC64 of the data received, which is computed while the data is downloaded. The CRC64 of the
+     * whole downloaded range is returned in
+     * #Azure::Storage::Blobs::Models::DownloadBlobToResult::TransactionalContentHash.
+     *
+     * @remark The service only returns the CRC64 of ranges of up to 4 MiB, so larger values of
+     * InitialChunkSize and ChunkSize are reduced to 4 MiB.
+     */
+    bool ValidateContentCrc64 = false;
+
+    /**
+     * @brief If true, a blob compressed by `BlockBlobClient::UploadFrom()` with a
+     * CompressionCodec is decompressed while it's downloaded, its blocks in parallel, unless a
+     * Range is set. The compressed blocks are checked by the checksums of the codec instead of
+     * ValidateContentCrc64. If false, or if the blob isn't compressed, the content is downloaded
+     * as is.
+     */
+    bool DecompressContent = true;
+
+    /**
+     * @brief If set, a blob encrypted by `BlockBlobClient::UploadFrom()` with a
+     * ClientSideEncryption is decrypted while it's downloaded, its regions in parallel. Each region
+     * is authenticated before it's written, the download fails if one doesn't match. A Range is
+     * of the decrypted content. The blob must be encrypted with the same key encryption key. If
+     * the blob isn't encrypted, the content is downloaded as is.
+     */
+    std::shared_ptr<BlobClientSideEncryption> ClientSideEncryption;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobClient::DownloadConcurrently.
+   */
+  struct DownloadBlobConcurrentlyOptions final
+  {
+    /**
+     * @brief Downloads only the bytes of the blob in the specified range.
+     */
+    Azure::Nullable<Core::Http::HttpRange> Range;
+
+    /**
+     * @brief Optional conditions that must be met to download the blob. The chunks after the
+     * first one are downloaded with an If-Match condition on the ETag returned with the first
+     * one.
+     */
+    BlobAccessConditions AccessConditions;
+
+    /**
+     * @brief The maximum number of bytes in a single request, and of the chunks passed to the
+     * handler.
+     */
+    int64_t ChunkSize = 4 * 1024 * 1024;
+
+    /**
+     * @brief The maximum number of chunks downloaded at the same time.
+     */
+    int32_t Concurrency = 5;
+
+    /**
+     * @brief If true, the chunk size and the concurrency are tuned while the blob is downloaded
+     * from the measured throughput, between 1 MiB and ChunkSize and between 1 and Concurrency.
+     */
+    bool AutoTune = false;
+
+    /**
+     * @brief If true, the CRC64 of every chunk is requested from the service and compared with the
+     * CRC64 of the data received before the chunk is passed to the handler. The CRC64 of the whole
+     * downloaded range is returned in
+     * #Azure::Storage::Blobs::Models::DownloadBlobToResult::TransactionalContentHash. ChunkSize is
+     * reduced to 4 MiB.
+     */
+    bool ValidateContentCrc64 = false;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobClient::OpenRead.
+   */
+  struct OpenReadOptions final
+  {
+    /**
+     * @brief Reads only the bytes of the blob in the specified range.
+     */
+    Azure::Nullable<Core::Http::HttpRange> Range;
+
+    /**
+     * @brief Optional conditions that must be met to read the blob. The ETag of the blob when the
+     * stream is opened is also required by the reads of the stream, which fail if the blob is
+     * modified while it is read.
+     */
+    BlobAccessConditions AccessConditions;
+
+    /**
+     * @brief Options for the ranges read ahead by the stream.
+     */
+    struct
+    {
+      /**
+       * @brief The number of bytes downloaded by every request of the stream.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of ranges of ChunkSize bytes downloaded ahead of the position
+       * of the stream at the same time.
+       */
+      int32_t Concurrency = 5;
     } TransferOptions;
+
+    /**
+     * @brief The maximum number of bytes of the ranges kept in memory by the stream after they're
+     * read, so that reading them again, after seeking back to them, doesn't download them again.
+     * Zero disables the cache.
+     */
+    int64_t CacheSize = 16 * 1024 * 1024;
   };
 
   /**
@@ -647,6 +1035,24 @@ namespace Azure { namespace Storage { namespace Blobs {
     BlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobBatchClient::SubmitBatch.
+   */
+  struct SubmitBlobBatchOptions final
+  {
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobBatchClient::SubmitBatches.
+   */
+  struct SubmitBlobBatchesOptions final
+  {
+    /**
+     * @brief The maximum number of batches sent at the same time.
+     */
+    int32_t Concurrency = 5;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::BlobClient::Undelete.
    */
@@ -718,6 +1124,56 @@ namespace Azure { namespace Storage { namespace Blobs {
     LeaseBlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobChangeFeedClient::ReadEvents.
+   */
+  struct ReadBlobChangeFeedOptions final
+  {
+    /**
+     * @brief A cursor returned by a previous read, or passed with the events it read, to read the
+     * events following it. When it's empty, the events are read from the start of the change
+     * feed, or from StartsOn.
+     */
+    std::string Cursor;
+
+    /**
+     * @brief The events before this time are skipped. Ignored when Cursor isn't empty.
+     */
+    Azure::Nullable<Azure::DateTime> StartsOn;
+
+    /**
+     * @brief The events from this time are skipped, and the read stops at the first segment
+     * starting from it.
+     */
+    Azure::Nullable<Azure::DateTime> EndsOn;
+
+    /**
+     * @brief The maximum number of shards of a segment read at the same time.
+     */
+    int32_t Concurrency = 8;
+  };
+
+  class BlobLeaseClient;
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlobLeaseManager.
+   */
+  struct BlobLeaseManagerOptions final
+  {
+    /**
+     * @brief The maximum number of renew requests in flight at the same time, which is also the
+     * number of threads of the manager.
+     */
+    int32_t Concurrency = 4;
+
+    /**
+     * @brief Called with the lease client of a lease which is lost, because the service rejected
+     * its renewal or because it couldn't be renewed before it expired. The manager stops renewing
+     * the lease. It is called from the threads of the manager.
+     */
+    std::function<void(const std::shared_ptr<BlobLeaseClient>&)> OnLeaseLost;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::BlobClient::SetTags.
    */
@@ -803,6 +1259,24 @@ namespace Azure { namespace Storage { namespace Blobs {
      */
     Azure::Nullable<Models::AccessTier> AccessTier;
 
+    /**
+     * @brief If set, the content is compressed with this codec before it's uploaded. Each block is
+     * compressed on its own, in parallel, and the blob is a concatenation of compressed streams
+     * with the codec in its Content-Encoding. The codec and the size of the blocks before they are
+     * compressed are recorded in the metadata of the blob, so that `DownloadTo()` decompresses
+     * the blocks in parallel. The blob is always uploaded in blocks, and can't be resumable.
+     */
+    Azure::Nullable<Models::BlobCompressionCodec> CompressionCodec;
+
+    /**
+     * @brief If set, the content is encrypted on the client side before it's uploaded, in regions
+     * of 4 MiB authenticated with AES-256-GCM, in parallel. The wrapped content key is recorded in
+     * the metadata of the blob, so that `DownloadTo()` decrypts it with the same
+     * ClientSideEncryption. The blob is always uploaded in blocks of whole regions, and can't be
+     * compressed or resumable.
+     */
+    std::shared_ptr<BlobClientSideEncryption> ClientSideEncryption;
+
     /**
      * @brief Options for parallel transfer.
      */
@@ -824,11 +1298,187 @@ namespace Azure { namespace Storage { namespace Blobs {
        * @brief The maximum number of threads that may be used in a parallel transfer.
        */
       int32_t Concurrency = 5;
-    } TransferOptions;
-  };
 
-  /**
-   * @brief Optional parameters for #Azure::Storage::Blobs::BlockBlobClient::StageBlock.
+      /**
+       * @brief If true, the chunk size and the concurrency are tuned while the blob is uploaded
+       * from the measured throughput, between 1 MiB and ChunkSize, or 64 MiB if ChunkSize isn't
+       * set, and between 1 and Concurrency. They start small and grow until the throughput stops
+       * improving, and shrink when it drops. The chunks are never small enough for the blob to
+       * need more than 50000 blocks.
+       */
+      bool AutoTune = false;
+
+      /**
+       * @brief If true, the file uploaded by `UploadFrom(fileName)` is mapped in memory and the
+       * blocks are sent from the mapped pages, instead of being read through a buffer. Ignored if
+       * the file can't be mapped.
+       */
+      bool MemoryMapFile = false;
+
+      /**
+       * @brief If true, the file uploaded by `UploadFrom(fileName)` is read bypassing the page
+       * cache of the operating system where the file system supports it, so that large uploads
+       * don't evict other data from the cache. Takes precedence over MemoryMapFile.
+       */
+      bool UnbufferedIo = false;
+
+      /**
+       * @brief If true, the blocks already staged by an interrupted upload of the same content to
+       * this blob are reused instead of being uploaded again. The uncommitted blocks of the blob
+       * are listed first, and a block is skipped if one of them has its ID and its size. The
+       * interrupted upload must have used the same ChunkSize and VerifyResumedBlocks. AutoTune is
+       * ignored so that the blocks are cut at the same offsets.
+       */
+      bool Resumable = false;
+
+      /**
+       * @brief If true, the ID of each block staged by a resumable upload includes the CRC64 of
+       * its content, so that an uncommitted block is only reused if its content hasn't changed,
+       * and the CRC64 is checked by the service when the block is staged. The content of the
+       * reused blocks is still read to compute it.
+       */
+      bool VerifyResumedBlocks = false;
+
+      /**
+       * @brief If true, each block staged is sent with the MD5 of its content, which the service
+       * checks. The MD5s of the blocks staged at the same time are computed together, several at
+       * once where the CPU supports AVX2. The content of the blocks of `UploadFrom(fileName)` is
+       * read in memory to hash it unless the file is mapped. Ignored when the blob is uploaded
+       * with a single request, compressed or encrypted, and by resumable uploads with
+       * VerifyResumedBlocks, whose blocks are sent with their CRC64.
+       */
+      bool ComputeTransactionalMd5 = false;
+
+      /**
+       * @brief Called with the number of bytes of the content uploaded so far, at most
+       * MaxProgressReportsPerSecond times per second, and once more when the upload is done.
+       * The handler is called by the threads of the transfer, one at a time. The bytes sent
+       * again by a retry are only counted once, and the blocks reused by a resumable upload are
+       * counted as uploaded.
+       */
+      std::function<void(int64_t)> ProgressHandler;
+
+      /**
+       * @brief The maximum number of times per second ProgressHandler is called. Every read is
+       * reported if it's not positive.
+       */
+      int32_t MaxProgressReportsPerSecond = 10;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Blobs::BlockBlobClient::CopyFromUriParallel.
+   */
+  struct CopyBlobFromUriParallelOptions final
+  {
+    /**
+     * @brief The size of the source blob. The properties of the source blob are fetched to get
+     * its size if it isn't set.
+     */
+    Azure::Nullable<int64_t> SourceLength;
+
+    /**
+     * @brief The standard HTTP header system properties to set. They aren't copied from the
+     * source blob.
+     */
+    Models::BlobHttpHeaders HttpHeaders;
+
+    /**
+     * @brief Name-value pairs associated with the blob as metadata. They aren't copied from the
+     * source blob.
+     */
+    Storage::Metadata Metadata;
+
+    /**
+     * @brief The tags to set for this blob.
+     */
+    std::map<std::string, std::string> Tags;
+
+    /**
+     * @brief Indicates the tier to be set on blob.
+     */
+    Azure::Nullable<Models::AccessTier> AccessTier;
+
+    /**
+     * @brief Optional conditions that the source must meet to perform this operation. When the
+     * properties of the source blob are fetched, the blocks are only copied while the source has
+     * the same ETag if IfMatch isn't set.
+     */
+    struct : public Azure::ModifiedConditions, public Azure::MatchConditions
+    {
+    } SourceAccessConditions;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The size of the ranges of the source blob copied as a block each. This value cannot
+       * be larger than 100 MiB.
+       */
+      Azure::Nullable<int64_t> ChunkSize;
+
+      /**
+       * @brief The maximum number of ranges copied at the same time.
+       */
+      int32_t Concurrency = 5;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlockBlobClient::SyncFrom.
+   */
+  struct SyncBlockBlobFromOptions final
+  {
+    /**
+     * @brief The standard HTTP header system properties to set.
+     */
+    Models::BlobHttpHeaders HttpHeaders;
+
+    /**
+     * @brief Name-value pairs associated with the blob as metadata.
+     */
+    Storage::Metadata Metadata;
+
+    /**
+     * @brief The tags to set for this blob.
+     */
+    std::map<std::string, std::string> Tags;
+
+    /**
+     * @brief Indicates the tier to be set on blob.
+     */
+    Azure::Nullable<Models::AccessTier> AccessTier;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The size of the blocks the file is cut into. This value cannot be larger than 4000
+       * MiB. The blocks of the blob are only reused if it was synchronized or uploaded with the
+       * same size.
+       */
+      Azure::Nullable<int64_t> ChunkSize;
+
+      /**
+       * @brief The maximum number of threads that may be used in a parallel transfer.
+       */
+      int32_t Concurrency = 5;
+
+      /**
+       * @brief If true, the file is mapped in memory and the blocks are hashed and sent from the
+       * mapped pages, instead of being read through a buffer. Ignored if the file can't be mapped.
+       */
+      bool MemoryMapFile = false;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlockBlobClient::StageBlock.
    */
   struct StageBlockOptions final
   {
@@ -925,6 +1575,175 @@ namespace Azure { namespace Storage { namespace Blobs {
     } AccessConditions;
   };
 
+  /**
+   * @brief The format of the content of a blob queried with
+   * #Azure::Storage::Blobs::BlockBlobClient::Query.
+   */
+  class BlobQueryInputTextOptions final {
+  public:
+    /**
+     * @brief Creates the options of CSV content.
+     *
+     * @param recordSeparator The string separating the records.
+     * @param columnSeparator The string separating the columns of a record.
+     * @param quotationCharacter The character quoting the fields.
+     * @param escapeCharacter The character escaping the special characters.
+     * @param hasHeaders True if the first record holds the names of the columns.
+     * @return The options of CSV content. The separators and characters left empty take the
+     * default values of the service.
+     */
+    static BlobQueryInputTextOptions CreateCsvTextOptions(
+        const std::string& recordSeparator = std::string(),
+        const std::string& columnSeparator = std::string(),
+        const std::string& quotationCharacter = std::string(),
+        const std::string& escapeCharacter = std::string(),
+        bool hasHeaders = false)
+    {
+      BlobQueryInputTextOptions options;
+      options.m_serialization.Type = "delimited";
+      options.m_serialization.RecordSeparator = recordSeparator;
+      options.m_serialization.ColumnSeparator = columnSeparator;
+      options.m_serialization.FieldQuote = quotationCharacter;
+      options.m_serialization.EscapeChar = escapeCharacter;
+      options.m_serialization.HasHeaders = hasHeaders;
+      return options;
+    }
+
+    /**
+     * @brief Creates the options of JSON content.
+     *
+     * @param recordSeparator The string separating the records.
+     * @return The options of JSON content.
+     */
+    static BlobQueryInputTextOptions CreateJsonTextOptions(
+        const std::string& recordSeparator = std::string())
+    {
+      BlobQueryInputTextOptions options;
+      options.m_serialization.Type = "json";
+      options.m_serialization.RecordSeparator = recordSeparator;
+      return options;
+    }
+
+    /**
+     * @brief Creates the options of Apache Parquet content.
+     *
+     * @return The options of Apache Parquet content.
+     */
+    static BlobQueryInputTextOptions CreateParquetTextOptions()
+    {
+      BlobQueryInputTextOptions options;
+      options.m_serialization.Type = "parquet";
+      return options;
+    }
+
+  private:
+    _detail::BlobRestClient::BlockBlob::QuerySerialization m_serialization;
+
+    friend class BlockBlobClient;
+  };
+
+  /**
+   * @brief The format of the result of #Azure::Storage::Blobs::BlockBlobClient::Query.
+   */
+  class BlobQueryOutputTextOptions final {
+  public:
+    /**
+     * @brief Creates the options of a CSV result.
+     *
+     * @param recordSeparator The string separating the records.
+     * @param columnSeparator The string separating the columns of a record.
+     * @param quotationCharacter The character quoting the fields.
+     * @param escapeCharacter The character escaping the special characters.
+     * @param hasHeaders True if the first record holds the names of the columns.
+     * @return The options of a CSV result. The separators and characters left empty take the
+     * default values of the service.
+     */
+    static BlobQueryOutputTextOptions CreateCsvTextOptions(
+        const std::string& recordSeparator = std::string(),
+        const std::string& columnSeparator = std::string(),
+        const std::string& quotationCharacter = std::string(),
+        const std::string& escapeCharacter = std::string(),
+        bool hasHeaders = false)
+    {
+      BlobQueryOutputTextOptions options;
+      options.m_serialization.Type = "delimited";
+      options.m_serialization.RecordSeparator = recordSeparator;
+      options.m_serialization.ColumnSeparator = columnSeparator;
+      options.m_serialization.FieldQuote = quotationCharacter;
+      options.m_serialization.EscapeChar = escapeCharacter;
+      options.m_serialization.HasHeaders = hasHeaders;
+      return options;
+    }
+
+    /**
+     * @brief Creates the options of a JSON result.
+     *
+     * @param recordSeparator The string separating the records.
+     * @return The options of a JSON result.
+     */
+    static BlobQueryOutputTextOptions CreateJsonTextOptions(
+        const std::string& recordSeparator = std::string())
+    {
+      BlobQueryOutputTextOptions options;
+      options.m_serialization.Type = "json";
+      options.m_serialization.RecordSeparator = recordSeparator;
+      return options;
+    }
+
+    /**
+     * @brief Creates the options of an Apache Arrow result.
+     *
+     * @param schema The fields of the records of the result.
+     * @return The options of an Apache Arrow result.
+     */
+    static BlobQueryOutputTextOptions CreateArrowTextOptions(
+        std::vector<Models::BlobQueryArrowField> schema)
+    {
+      BlobQueryOutputTextOptions options;
+      options.m_serialization.Type = "arrow";
+      options.m_serialization.ArrowSchema = std::move(schema);
+      return options;
+    }
+
+  private:
+    _detail::BlobRestClient::BlockBlob::QuerySerialization m_serialization;
+
+    friend class BlockBlobClient;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::BlockBlobClient::Query.
+   */
+  struct QueryBlobOptions final
+  {
+    /**
+     * @brief The format of the content of the blob. CSV by default.
+     */
+    BlobQueryInputTextOptions InputTextConfiguration;
+
+    /**
+     * @brief The format of the result. The same as the content of the blob by default.
+     */
+    BlobQueryOutputTextOptions OutputTextConfiguration;
+
+    /**
+     * @brief Called with the errors reported by the service while the result is read. If null,
+     * a fatal error throws a StorageException and the other errors are ignored.
+     */
+    std::function<void(Models::BlobQueryError)> ErrorHandler;
+
+    /**
+     * @brief Called while the result is read with the number of bytes of the blob scanned so far
+     * and the size of the blob.
+     */
+    std::function<void(int64_t, int64_t)> ProgressHandler;
+
+    /**
+     * @brief Optional conditions that must be met to perform this operation.
+     */
+    BlobAccessConditions AccessConditions;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::AppendBlobClient::Create.
    */
@@ -1003,6 +1822,35 @@ namespace Azure { namespace Storage { namespace Blobs {
     AppendBlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::AppendBlobClient::OpenWrite.
+   */
+  struct OpenWriteAppendBlobOptions final
+  {
+    /**
+     * @brief Optional conditions that must be met to open the writer and to perform every append.
+     * The append position is set by the writer.
+     */
+    AppendBlobAccessConditions AccessConditions;
+
+    /**
+     * @brief The maximum number of bytes appended by a single request. This value cannot be larger
+     * than 4 MiB.
+     */
+    int64_t BlockSize = 4 * 1024 * 1024;
+
+    /**
+     * @brief The time after which the data written is appended even if it doesn't fill a block.
+     */
+    std::chrono::milliseconds FlushInterval = std::chrono::seconds(1);
+
+    /**
+     * @brief The maximum number of bytes written which aren't appended yet. Writes wait while the
+     * writer buffers this many bytes.
+     */
+    int64_t MaxBufferedSize = 16 * 1024 * 1024;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::Create.
    */
@@ -1040,6 +1888,49 @@ namespace Azure { namespace Storage { namespace Blobs {
     BlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::UploadFrom.
+   */
+  struct UploadPageBlobFromOptions final
+  {
+    /**
+     * @brief The standard HTTP header system properties to set.
+     */
+    Models::BlobHttpHeaders HttpHeaders;
+
+    /**
+     * @brief Name-value pairs associated with the blob as metadata.
+     */
+    Storage::Metadata Metadata;
+
+    /**
+     * @brief The tags to set for this blob.
+     */
+    std::map<std::string, std::string> Tags;
+
+    /**
+     * @brief Indicates the tier to be set on blob.
+     */
+    Azure::Nullable<Models::AccessTier> AccessTier;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The maximum number of bytes in a single request. This value must be a multiple of
+       * 512 and cannot be larger than 4 MiB.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of threads that may be used in a parallel transfer.
+       */
+      int32_t Concurrency = 5;
+    } TransferOptions;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::UploadPages.
    */
@@ -1083,6 +1974,34 @@ namespace Azure { namespace Storage { namespace Blobs {
     } SourceAccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::OpenWrite.
+   */
+  struct OpenWritePageBlobOptions final
+  {
+    /**
+     * @brief Optional conditions that must be met to perform every upload, and every read of the
+     * pages partly written. Every upload changes the ETag of the blob.
+     */
+    PageBlobAccessConditions AccessConditions;
+
+    /**
+     * @brief The maximum number of bytes uploaded by a single request. This value must be a
+     * multiple of 512 and cannot be larger than 4 MiB.
+     */
+    int64_t RangeSize = 4 * 1024 * 1024;
+
+    /**
+     * @brief The maximum number of ranges uploaded at the same time.
+     */
+    int32_t Concurrency = 5;
+
+    /**
+     * @brief The number of bytes written which makes the writer upload the data buffered.
+     */
+    int64_t MaxBufferedSize = 16 * 1024 * 1024;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::ClearPages.
    */
@@ -1138,6 +2057,62 @@ namespace Azure { namespace Storage { namespace Blobs {
     BlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::DownloadSparseTo.
+   */
+  struct DownloadPageBlobSparseToOptions final
+  {
+    /**
+     * @brief Optional conditions that must be met to perform this operation.
+     */
+    BlobAccessConditions AccessConditions;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The maximum number of bytes in a single request. Valid page ranges larger than this
+       * are downloaded in several requests.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of threads that may be used in a parallel transfer.
+       */
+      int32_t Concurrency = 5;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::DownloadDiffTo.
+   */
+  struct DownloadPageBlobDiffToOptions final
+  {
+    /**
+     * @brief Optional conditions that must be met to perform this operation.
+     */
+    BlobAccessConditions AccessConditions;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The maximum number of bytes in a single request. Changed page ranges larger than
+       * this are downloaded in several requests.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of threads that may be used in a parallel transfer.
+       */
+      int32_t Concurrency = 5;
+    } TransferOptions;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Blobs::PageBlobClient::StartCopyIncremental.
    */
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <azure/core/context.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  class BlobClient;
+  struct OpenReadOptions;
+
+  /**
+   * @brief A stream reading a blob or a blob range, returned by
+   * #Azure::Storage::Blobs::BlobClient::OpenRead.
+   *
+   * @remark The ranges following the position of the stream are downloaded in the background, up
+   * to the concurrency of the options at the same time, so that they are ready when they are
+   * read. After Seek() moves the position out of the ranges read ahead, they are dropped and only
+   * one range is read ahead at first; the number of ranges read ahead doubles with every range
+   * read to its end, back up to the concurrency. The stream isn't thread-safe.
+   *
+   * The ranges are aligned to the chunk size of the options. The ranges which have been read, or
+   * dropped after being downloaded, are kept in a cache of up to the cache size of the options,
+   * from which seeking back to them reads them again; the least recently used ranges are evicted
+   * first. The ranges needed by a read which aren't cached or downloading yet are downloaded with
+   * a single request.
+   */
+  class BlobReadStream final : public Azure::Core::IO::BodyStream {
+  public:
+    /**
+     * @brief Cancels the downloads of the ranges read ahead and waits for them to stop.
+     */
+    ~BlobReadStream() override;
+
+    /**
+     * @brief Gets the number of bytes of the blob or blob range read by the stream.
+     *
+     * @return The length of the stream.
+     */
+    int64_t Length() const override;
+
+    /**
+     * @brief Moves the position of the stream back to its beginning.
+     */
+    void Rewind() override { Seek(0); }
+
+    /**
+     * @brief Moves the position of the stream.
+     *
+     * @param position The new position, between 0 and Length().
+     *
+     * @throw std::out_of_range if position is negative or greater than Length().
+     */
+    void Seek(int64_t position);
+
+    /**
+     * @brief Gets the position of the stream.
+     *
+     * @return The number of bytes from the beginning of the stream to its position.
+     */
+    int64_t Position() const;
+
+  private:
+    struct State;
+    struct Chunk;
+
+    explicit BlobReadStream(
+        const BlobClient& client,
+        const OpenReadOptions& options,
+        int64_t offset,
+        int64_t length,
+        const Azure::Core::Context& context);
+
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+
+    // Moves the ranges read ahead to the cache. The next read only downloads the ranges it reads,
+    // the ranges read ahead grow back as the reads go on.
+    void DropChunks();
+
+    // Takes the ranges from the position to readEnd, and the ranges read ahead after them, from
+    // the cache or starts downloading them. The ranges before readEnd are downloaded by the read.
+    void Prefetch(int64_t readEnd, const Azure::Core::Context& context);
+
+    std::unique_ptr<State> m_state;
+
+    friend class BlobClient;
+  };
+
+}}} // namespace Azure::Storage::Blobs
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <thread>
@@ -163,6 +164,339 @@ namespace Azure { namespace Storage {
         std::string LeaseId;
       };
 
+      /**
+       * @brief The result of an operation of a batch sent by
+       * #Azure::Storage::Blobs::BlobBatchClient::SubmitBatch.
+       */
+      struct BlobBatchOperationResult final
+      {
+        /**
+         * The HTTP status code of the operation.
+         */
+        Azure::Core::Http::HttpStatusCode StatusCode = Azure::Core::Http::HttpStatusCode::None;
+
+        /**
+         * The request ID of the operation, which can be used to find the operation in the logs
+         * of the service.
+         */
+        std::string RequestId;
+
+        /**
+         * The error code of a failed operation, empty when the operation succeeded.
+         */
+        std::string ErrorCode;
+
+        /**
+         * The error message of a failed operation, empty when the operation succeeded.
+         */
+        std::string Message;
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::BlobBatchClient::SubmitBatch.
+       */
+      struct SubmitBlobBatchResult final
+      {
+        /**
+         * The results of the operations, in the order they were added to the batch.
+         */
+        std::vector<BlobBatchOperationResult> OperationResults;
+      };
+
+      /**
+       * @brief The details of the change to a blob of a change feed event.
+       */
+      struct BlobChangeFeedEventData final
+      {
+        /**
+         * The operation that triggered the event, such as PutBlob or DeleteBlob.
+         */
+        std::string Api;
+
+        /**
+         * The request ID provided by the client for the operation.
+         */
+        std::string ClientRequestId;
+
+        /**
+         * The request ID of the operation, generated by the service.
+         */
+        std::string RequestId;
+
+        /**
+         * The ETag of the blob after the operation.
+         */
+        Azure::ETag ETag;
+
+        /**
+         * The content type of the blob.
+         */
+        std::string ContentType;
+
+        /**
+         * The size of the blob, in bytes.
+         */
+        int64_t ContentLength = 0;
+
+        /**
+         * The type of the blob.
+         */
+        Models::BlobType BlobType;
+
+        /**
+         * The URL of the blob.
+         */
+        std::string Url;
+
+        /**
+         * An opaque value ordering the events of a blob.
+         */
+        std::string Sequencer;
+      };
+
+      /**
+       * @brief An event of the change feed of an account, read by
+       * #Azure::Storage::Blobs::BlobChangeFeedClient::ReadEvents.
+       */
+      struct BlobChangeFeedEvent final
+      {
+        /**
+         * The resource path of the account.
+         */
+        std::string Topic;
+
+        /**
+         * The resource path of the blob, such as /blobServices/default/containers/c/blobs/b.
+         */
+        std::string Subject;
+
+        /**
+         * The type of the event, such as BlobCreated or BlobDeleted.
+         */
+        std::string EventType;
+
+        /**
+         * When the event was generated.
+         */
+        Azure::DateTime EventTime;
+
+        /**
+         * The unique ID of the event.
+         */
+        std::string Id;
+
+        /**
+         * The details of the change.
+         */
+        BlobChangeFeedEventData Data;
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::PageBlobClient::DownloadSparseTo.
+       */
+      struct DownloadPageBlobSparseToResult final
+      {
+        /**
+         * The ETag of the downloaded version of the blob.
+         */
+        Azure::ETag ETag;
+
+        /**
+         * The date/time that the blob was last modified. The date format follows RFC 1123.
+         */
+        Azure::DateTime LastModified;
+
+        /**
+         * Size of the blob, and of the file written.
+         */
+        int64_t BlobSize = 0;
+
+        /**
+         * The number of bytes downloaded, the size of the valid page ranges of the blob.
+         */
+        int64_t DownloadedSize = 0;
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::PageBlobClient::UploadFrom.
+       *
+       * @remark The ETag isn't returned, the pages are uploaded concurrently and each upload
+       * changes it.
+       */
+      struct UploadPageBlobFromResult final
+      {
+        /**
+         * A string value that uniquely identifies the created blob.
+         */
+        Azure::Nullable<std::string> VersionId;
+
+        /**
+         * True if the blob data and metadata are completely encrypted using the specified
+         * algorithm. Otherwise, the value is set to false.
+         */
+        bool IsServerEncrypted = false;
+
+        /**
+         * The SHA-256 hash of the encryption key used to encrypt the blob data and metadata.
+         */
+        Azure::Nullable<std::vector<uint8_t>> EncryptionKeySha256;
+
+        /**
+         * The name of the encryption scope under which the blob is encrypted.
+         */
+        Azure::Nullable<std::string> EncryptionScope;
+
+        /**
+         * The number of bytes uploaded. The pages of zeros aren't uploaded, a new page blob reads
+         * as zeros.
+         */
+        int64_t UploadedSize = 0;
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::PageBlobClient::DownloadDiffTo.
+       */
+      struct DownloadPageBlobDiffToResult final
+      {
+        /**
+         * The ETag of the downloaded version of the blob.
+         */
+        Azure::ETag ETag;
+
+        /**
+         * The date/time that the blob was last modified. The date format follows RFC 1123.
+         */
+        Azure::DateTime LastModified;
+
+        /**
+         * Size of the blob, and of the file written.
+         */
+        int64_t BlobSize = 0;
+
+        /**
+         * The number of bytes downloaded, the size of the page ranges updated since the previous
+         * snapshot.
+         */
+        int64_t DownloadedSize = 0;
+
+        /**
+         * The number of bytes zeroed in the file, the size of the page ranges cleared since the
+         * previous snapshot.
+         */
+        int64_t ClearedSize = 0;
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::BlobContainerClient::UploadDirectory.
+       */
+      struct UploadBlobDirectoryResult final
+      {
+        /**
+         * The number of files uploaded.
+         */
+        int64_t TransferredFileCount = 0;
+
+        /**
+         * The number of files skipped because the journal records them as already uploaded.
+         */
+        int64_t SkippedFileCount = 0;
+
+        /**
+         * The number of bytes uploaded.
+         */
+        int64_t TransferredSize = 0;
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::BlobContainerClient::DownloadDirectory.
+       */
+      struct DownloadBlobDirectoryResult final
+      {
+        /**
+         * The number of blobs downloaded.
+         */
+        int64_t TransferredFileCount = 0;
+
+        /**
+         * The number of blobs skipped because the journal records them as already downloaded.
+         */
+        int64_t SkippedFileCount = 0;
+
+        /**
+         * The number of bytes downloaded.
+         */
+        int64_t TransferredSize = 0;
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::BlobContainerClient::DownloadBlobs.
+       */
+      struct DownloadBlobsResult final
+      {
+        /**
+         * The number of blobs downloaded, not counting the ones that don't exist.
+         */
+        int64_t TransferredBlobCount = 0;
+
+        /**
+         * The number of bytes downloaded.
+         */
+        int64_t TransferredSize = 0;
+
+        /**
+         * The time taken by the downloads, from the first request to the last content passed to
+         * the callback. The throughput is TransferredSize divided by it.
+         */
+        std::chrono::microseconds Elapsed{0};
+      };
+
+      /**
+       * @brief Response type for #Azure::Storage::Blobs::BlockBlobClient::SyncFrom.
+       */
+      struct SyncBlockBlobFromResult final
+      {
+        /**
+         * The ETag contains a value that you can use to perform operations conditionally.
+         */
+        Azure::ETag ETag;
+
+        /**
+         * The date and time the blob was last modified.
+         */
+        Azure::DateTime LastModified;
+
+        /**
+         * A string value that uniquely identifies the updated blob.
+         */
+        Azure::Nullable<std::string> VersionId;
+
+        /**
+         * True if the blob data and metadata are completely encrypted using the specified
+         * algorithm. Otherwise, the value is set to false.
+         */
+        bool IsServerEncrypted = false;
+
+        /**
+         * The SHA-256 hash of the encryption key used to encrypt the blob data and metadata.
+         */
+        Azure::Nullable<std::vector<uint8_t>> EncryptionKeySha256;
+
+        /**
+         * The name of the encryption scope under which the blob is encrypted.
+         */
+        Azure::Nullable<std::string> EncryptionScope;
+
+        /**
+         * The number of bytes uploaded, the size of the blocks that changed.
+         */
+        int64_t UploadedSize = 0;
+
+        /**
+         * The number of bytes of the committed blocks reused without being uploaded again.
+         */
+        int64_t ReusedSize = 0;
+      };
+
     } // namespace Models
 
     /**
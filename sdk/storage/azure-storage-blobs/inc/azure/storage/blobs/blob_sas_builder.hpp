@@ -3,14 +3,23 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <azure/storage/common/account_sas_builder.hpp>
 
 #include "azure/storage/blobs/blob_responses.hpp"
 
+namespace Azure { namespace Storage {
+  namespace _internal {
+    class SasTokenTemplate;
+  } // namespace _internal
+}} // namespace Azure::Storage
+
 namespace Azure { namespace Storage { namespace Sas {
 
+  class BlobSasTokenGenerator;
+
   /**
    * @brief Specifies which resources are accessible via the shared access signature.
    */
@@ -303,7 +312,56 @@ namespace Azure { namespace Storage { namespace Sas {
         const std::string& accountName);
 
   private:
+    friend class BlobSasTokenGenerator;
     std::string Permissions;
   };
 
+  /**
+   * @brief BlobSasTokenGenerator is used to generate the Shared Access Signatures (SAS) of many
+   * blobs of a container, which only differ by the blob name.
+   *
+   * @details The parts of the SAS which are the same for all the blobs, such as the permissions
+   * and the expiry, are formatted and signed once when the generator is constructed, so
+   * generating the SAS of a blob only signs its name. The tokens are the same as the ones of
+   * BlobSasBuilder with the blob name.
+   */
+  class BlobSasTokenGenerator final {
+  public:
+    /**
+     * @brief Constructs a generator signing the SAS with a StorageSharedKeyCredential.
+     *
+     * @param builder The properties of the SAS. Its resource must be a blob, a blob snapshot or a
+     * blob version. Its blob name is ignored.
+     * @param credential The storage account's shared key credential.
+     */
+    explicit BlobSasTokenGenerator(
+        const BlobSasBuilder& builder,
+        const StorageSharedKeyCredential& credential);
+
+    /**
+     * @brief Constructs a generator signing the SAS with an account's user delegation key.
+     *
+     * @param builder The properties of the SAS. Its resource must be a blob, a blob snapshot or a
+     * blob version. Its blob name is ignored.
+     * @param userDelegationKey UserDelegationKey returned from
+     * BlobServiceClient.GetUserDelegationKey.
+     * @param accountName The name of the storage account.
+     */
+    explicit BlobSasTokenGenerator(
+        const BlobSasBuilder& builder,
+        const Blobs::Models::UserDelegationKey& userDelegationKey,
+        const std::string& accountName);
+
+    /**
+     * @brief Generates the SAS of a blob. Can be called concurrently.
+     *
+     * @param blobName The name of the blob being made accessible.
+     * @return The SAS query parameters used for authenticating requests.
+     */
+    std::string GenerateSasToken(const std::string& blobName) const;
+
+  private:
+    std::shared_ptr<const _internal::SasTokenTemplate> m_template;
+  };
+
 }}} // namespace Azure::Storage::Sas
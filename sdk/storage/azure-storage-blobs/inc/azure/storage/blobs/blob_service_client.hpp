@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -186,6 +187,35 @@ namespace Azure { namespace Storage { namespace Blobs {
         const FindBlobsByTagsOptions& options = FindBlobsByTagsOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Finds the blobs whose tags match an expression and processes each of them, such as
+     * downloading it or getting its properties, on several threads while the next pages of the
+     * blobs found are still being fetched.
+     *
+     * @remark The next page is fetched in the background as soon as the current one is received.
+     * The blobs found are passed to \p onBlob from up to the concurrency of the options threads at
+     * the same time, so that at most that many blobs and one page ahead are held in memory. The
+     * blobs aren't processed in order.
+     *
+     * @param tagFilterSqlExpression The where parameter enables the caller to query blobs whose
+     * tags match a given expression. The given expression must evaluate to true for a blob to be
+     * returned in the results. The [OData - ABNF] filter syntax rule defines the formal grammar
+     * for the value of the where query parameter, however, only a subset of the OData filter
+     * syntax is supported in the Blob service.
+     * @param onBlob Called with each blob found and a client of the blob. It must be safe to call
+     * it from several threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     *
+     * @throw Azure::Storage::StorageException Fetching a page failed. The first exception thrown
+     * by \p onBlob or by fetching a page is rethrown once the blobs being processed are done.
+     */
+    void FindBlobsByTagsConcurrently(
+        const std::string& tagFilterSqlExpression,
+        const std::function<void(const Models::TaggedBlobItem&, const BlobClient&)>& onBlob,
+        const FindBlobsByTagsConcurrentlyOptions& options = FindBlobsByTagsConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Creates a new blob container under the specified account. If the container with the
      * same name already exists, the operation fails.
@@ -234,5 +264,8 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
     Azure::Nullable<EncryptionKey> m_customerProvidedKey;
     Azure::Nullable<std::string> m_encryptionScope;
+    std::shared_ptr<TransferExecutor> m_transferExecutor;
+    std::shared_ptr<BufferPool> m_bufferPool;
+    std::shared_ptr<SecondaryReadBalancer> m_secondaryReadBalancer;
   };
 }}} // namespace Azure::Storage::Blobs
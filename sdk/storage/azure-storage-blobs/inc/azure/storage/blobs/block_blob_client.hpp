@@ -157,6 +157,52 @@ namespace Azure { namespace Storage { namespace Blobs {
         const UploadBlockBlobFromOptions& options = UploadBlockBlobFromOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Creates a new block blob, or updates the content of an existing block blob, from a
+     * stream read once from its current position to its end, whose length doesn't need to be
+     * known, such as a pipe. Updating an existing block blob overwrites any existing metadata on
+     * the blob.
+     *
+     * @remark The stream is read in blocks of ChunkSize bytes, 8 MiB by default, which are staged
+     * concurrently and committed once the stream ends. At most Concurrency blocks are held in
+     * memory, in buffers of the BufferPool of the client. A stream which ends within its first
+     * block and within SingleUploadThreshold is uploaded with a single upload operation. AutoTune,
+     * MemoryMapFile and UnbufferedIo are ignored. A stream can have up to 50000 blocks.
+     *
+     * @param stream The stream containing the content to upload.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A UploadBlockBlobFromResult describing the state of the updated block blob.
+     */
+    Azure::Response<Models::UploadBlockBlobFromResult> UploadFromStream(
+        Azure::Core::IO::BodyStream& stream,
+        const UploadBlockBlobFromOptions& options = UploadBlockBlobFromOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Updates a block blob to the content of a file by uploading only the blocks that
+     * changed, and committing them with the unchanged blocks of the blob.
+     *
+     * @remark The file is cut into blocks of ChunkSize bytes, 4 MiB by default, whose IDs include
+     * their CRC64. A block whose ID is in the committed block list of the blob is reused, the
+     * other ones are staged concurrently. The IDs are the ones of a resumable
+     * #Azure::Storage::Blobs::BlockBlobClient::UploadFrom that verifies the resumed blocks, so a
+     * blob uploaded this way can be synchronized. The blocks are hashed at fixed offsets, and the
+     * blocks after data inserted in or removed from the middle of the file are uploaded again. The
+     * commit fails if the blob was changed since its block list was read. Updating the blob
+     * overwrites any existing metadata on it.
+     *
+     * @param fileName A file containing the content to upload.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A SyncBlockBlobFromResult describing the state of the updated block blob and the
+     * size of the data uploaded.
+     */
+    Azure::Response<Models::SyncBlockBlobFromResult> SyncFrom(
+        const std::string& fileName,
+        const SyncBlockBlobFromOptions& options = SyncBlockBlobFromOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Creates a new block as part of a block blob's staging area to be eventually
      * committed via the CommitBlockList operation.
@@ -194,6 +240,25 @@ namespace Azure { namespace Storage { namespace Blobs {
         const StageBlockFromUriOptions& options = StageBlockFromUriOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Copies a blob into this block blob on the service side, staging the ranges of the
+     * source blob as blocks concurrently with StageBlockFromUri, then committing them. The data
+     * of the blob isn't transferred through the client.
+     *
+     * @param sourceUri Specifies the URL of the source blob. The value may be a URL of up to 2 KB
+     * in length that specifies a blob. The value should be URL-encoded as it would appear in a
+     * request URI. The source blob must either be public or must be authorized via a shared access
+     * signature. If the source blob is public, no authentication is required to perform the
+     * operation.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A UploadBlockBlobFromResult describing the state of the copied block blob.
+     */
+    Azure::Response<Models::UploadBlockBlobFromResult> CopyFromUriParallel(
+        const std::string& sourceUri,
+        const CopyBlobFromUriParallelOptions& options = CopyBlobFromUriParallelOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Writes a blob by specifying the list of block IDs that make up the blob. In order to
      * be written as part of a blob, a block must have been successfully written to the server in a
@@ -228,9 +293,30 @@ namespace Azure { namespace Storage { namespace Blobs {
         const GetBlockListOptions& options = GetBlockListOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Runs a SQL query on the content of the blob on the service side, and returns only
+     * its result.
+     *
+     * @remark The service sends the result in Avro records, which are decoded as the returned
+     * body stream is read. The progress and the errors of the query are reported through the
+     * handlers of the options while the result is read, so reading it may throw. The length of
+     * the body stream isn't known and is reported as -1.
+     *
+     * @param querySqlExpression The query expression in SQL, for example `SELECT * from BlobStorage
+     * WHERE _2 > 100`.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A QueryBlobResult holding the result of the query.
+     */
+    Azure::Response<Models::QueryBlobResult> Query(
+        const std::string& querySqlExpression,
+        const QueryBlobOptions& options = QueryBlobOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
   private:
     explicit BlockBlobClient(BlobClient blobClient);
     friend class BlobClient;
+    friend class BlobContainerClient;
     friend class Files::DataLake::DataLakeFileClient;
   };
 
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "azure/storage/blobs/blob_client.hpp"
+#include "azure/storage/blobs/page_blob_writer.hpp"
 
 namespace Azure { namespace Storage { namespace Blobs {
 
@@ -136,6 +137,39 @@ namespace Azure { namespace Storage { namespace Blobs {
         const CreatePageBlobOptions& options = CreatePageBlobOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Creates a new page blob with the content of a buffer, uploading its pages
+     * concurrently. The pages of zeros aren't uploaded, which saves most of the transfer of a
+     * sparse content such as a virtual machine disk.
+     *
+     * @param buffer A memory buffer containing the content to upload.
+     * @param bufferSize Size of the memory buffer, which must be a multiple of 512.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A UploadPageBlobFromResult describing the state of the created page blob.
+     */
+    Azure::Response<Models::UploadPageBlobFromResult> UploadFrom(
+        const uint8_t* buffer,
+        size_t bufferSize,
+        const UploadPageBlobFromOptions& options = UploadPageBlobFromOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Creates a new page blob with the content of a file, uploading its pages
+     * concurrently. The pages of zeros aren't uploaded, which saves most of the transfer of a
+     * sparse content such as a virtual machine disk.
+     *
+     * @param fileName A file containing the content to upload, whose size must be a multiple of
+     * 512.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A UploadPageBlobFromResult describing the state of the created page blob.
+     */
+    Azure::Response<Models::UploadPageBlobFromResult> UploadFrom(
+        const std::string& fileName,
+        const UploadPageBlobFromOptions& options = UploadPageBlobFromOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Writes content to a range of pages in a page blob, starting at offset.
      *
@@ -153,6 +187,17 @@ namespace Azure { namespace Storage { namespace Blobs {
         const UploadPagesOptions& options = UploadPagesOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Opens a writer writing to this page blob at random offsets, which merges the
+     * adjacent and overlapping writes and uploads them by ranges of pages, concurrently, instead
+     * of a request per write.
+     *
+     * @param options Optional parameters to execute this function.
+     * @return A PageBlobWriter writing to the blob.
+     */
+    std::unique_ptr<PageBlobWriter> OpenWrite(
+        const OpenWritePageBlobOptions& options = OpenWritePageBlobOptions()) const;
+
     /**
      * @brief Writes a range of pages to a page blob where the contents are read from a
      * uri.
@@ -232,6 +277,45 @@ namespace Azure { namespace Storage { namespace Blobs {
         const GetPageRangesOptions& options = GetPageRangesOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Downloads the valid page ranges of this page blob to a file, concurrently. The
+     * rest of the file is left as holes reading as zeros, so that the clear pages of a mostly
+     * empty blob, such as a virtual machine disk, are neither downloaded nor written to the disk.
+     *
+     * @remark The file is only sparse on file systems which support sparse files, elsewhere the
+     * holes take disk space but are still not downloaded.
+     *
+     * @param fileName A file path to write the downloaded content to.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A DownloadPageBlobSparseToResult describing the downloaded blob.
+     */
+    Azure::Response<Models::DownloadPageBlobSparseToResult> DownloadSparseTo(
+        const std::string& fileName,
+        const DownloadPageBlobSparseToOptions& options = DownloadPageBlobSparseToOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Brings a file holding a copy of a previous snapshot of this page blob up to date,
+     * downloading only the pages changed since the snapshot. The updated page ranges are
+     * downloaded concurrently and the cleared ones are zeroed in the file, as holes on file
+     * systems which support sparse files.
+     *
+     * @remark The file is resized to the size of the blob, it is created if it doesn't exist.
+     *
+     * @param previousSnapshot The snapshot the file is a copy of, which must be older than this
+     * blob or snapshot.
+     * @param fileName The path of the copy of the previous snapshot.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A DownloadPageBlobDiffToResult describing the downloaded blob.
+     */
+    Azure::Response<Models::DownloadPageBlobDiffToResult> DownloadDiffTo(
+        const std::string& previousSnapshot,
+        const std::string& fileName,
+        const DownloadPageBlobDiffToOptions& options = DownloadPageBlobDiffToOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Returns the list of page ranges that differ between a previous snapshot and this page
      * blob. Changes include both updated and cleared pages.
@@ -289,6 +373,7 @@ namespace Azure { namespace Storage { namespace Blobs {
     explicit PageBlobClient(BlobClient blobClient);
 
     friend class BlobClient;
+    friend class BlobContainerClient;
   };
 
 }}} // namespace Azure::Storage::Blobs
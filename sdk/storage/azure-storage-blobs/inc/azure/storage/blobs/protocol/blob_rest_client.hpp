@@ -732,6 +732,115 @@ namespace Azure { namespace Storage { namespace Blobs {
       std::string ContentDisposition;
     }; // struct BlobHttpHeaders
 
+    /**
+     * @brief Extensible enum used to identify the type of a field of the Apache Arrow schema of
+     * the result of a query.
+     */
+    class BlobQueryArrowFieldType final {
+    public:
+      BlobQueryArrowFieldType() = default;
+      explicit BlobQueryArrowFieldType(std::string value) : m_value(std::move(value)) {}
+      bool operator==(const BlobQueryArrowFieldType& other) const
+      {
+        return m_value == other.m_value;
+      }
+      bool operator!=(const BlobQueryArrowFieldType& other) const { return !(*this == other); }
+      const std::string& ToString() const { return m_value; }
+      /**
+       * 64-bit integer.
+       */
+      AZ_STORAGE_BLOBS_DLLEXPORT const static BlobQueryArrowFieldType Int64;
+      /**
+       * Boolean.
+       */
+      AZ_STORAGE_BLOBS_DLLEXPORT const static BlobQueryArrowFieldType Bool;
+      /**
+       * Timestamp in milliseconds.
+       */
+      AZ_STORAGE_BLOBS_DLLEXPORT const static BlobQueryArrowFieldType Timestamp;
+      /**
+       * String.
+       */
+      AZ_STORAGE_BLOBS_DLLEXPORT const static BlobQueryArrowFieldType String;
+      /**
+       * Double precision floating point number.
+       */
+      AZ_STORAGE_BLOBS_DLLEXPORT const static BlobQueryArrowFieldType Double;
+      /**
+       * Decimal number of the given precision and scale.
+       */
+      AZ_STORAGE_BLOBS_DLLEXPORT const static BlobQueryArrowFieldType Decimal;
+
+    private:
+      std::string m_value;
+    }; // extensible enum BlobQueryArrowFieldType
+
+    /**
+     * @brief A field of the Apache Arrow schema of the result of a query.
+     */
+    struct BlobQueryArrowField final
+    {
+      /**
+       * The type of the field.
+       */
+      BlobQueryArrowFieldType Type;
+      /**
+       * The name of the field.
+       */
+      Azure::Nullable<std::string> Name;
+      /**
+       * The precision of a decimal field.
+       */
+      Azure::Nullable<int32_t> Precision;
+      /**
+       * The scale of a decimal field.
+       */
+      Azure::Nullable<int32_t> Scale;
+    }; // struct BlobQueryArrowField
+
+    /**
+     * @brief An error reported by the service while it runs a query.
+     */
+    struct BlobQueryError final
+    {
+      /**
+       * The name of the error.
+       */
+      std::string Name;
+      /**
+       * A description of the error.
+       */
+      std::string Description;
+      /**
+       * True if the query stops because of the error, false if the record in error is skipped.
+       */
+      bool IsFatal = false;
+      /**
+       * The position in bytes in the blob where the error occurred.
+       */
+      int64_t Position = 0;
+    }; // struct BlobQueryError
+
+    /**
+     * @brief Extensible enum used to identify the codec compressing the content of a blob on the
+     * client side.
+     */
+    class BlobCompressionCodec final {
+    public:
+      BlobCompressionCodec() = default;
+      explicit BlobCompressionCodec(std::string value) : m_value(std::move(value)) {}
+      bool operator==(const BlobCompressionCodec& other) const { return m_value == other.m_value; }
+      bool operator!=(const BlobCompressionCodec& other) const { return !(*this == other); }
+      const std::string& ToString() const { return m_value; }
+      /**
+       * Gzip.
+       */
+      AZ_STORAGE_BLOBS_DLLEXPORT const static BlobCompressionCodec Gzip;
+
+    private:
+      std::string m_value;
+    }; // extensible enum BlobCompressionCodec
+
     /**
      * @brief Extensible enum used to identify blob type.
      */
@@ -2052,6 +2161,50 @@ namespace Azure { namespace Storage { namespace Blobs {
       return lhs;
     }
 
+    /**
+     * @brief Response type for #Azure::Storage::Blobs::BlockBlobClient::Query.
+     */
+    struct QueryBlobResult final
+    {
+      /**
+       * The result of the query.
+       */
+      std::unique_ptr<Azure::Core::IO::BodyStream> BodyStream;
+      /**
+       * The ETag contains a value that you can use to perform operations conditionally.
+       */
+      Azure::ETag ETag;
+      /**
+       * The date and time the blob was last modified.
+       */
+      Azure::DateTime LastModified;
+      /**
+       * When a blob is leased, specifies whether the lease is of infinite or fixed duration.
+       */
+      Azure::Nullable<LeaseDurationType> LeaseDuration;
+      /**
+       * Lease state of the blob.
+       */
+      Models::LeaseState LeaseState = Models::LeaseState::Available;
+      /**
+       * The current lease status of the blob.
+       */
+      Models::LeaseStatus LeaseStatus = Models::LeaseStatus::Unlocked;
+      /**
+       * True if the blob data and metadata are completely encrypted using the specified
+       * algorithm. Otherwise, the value is set to false.
+       */
+      bool IsServerEncrypted = false;
+      /**
+       * The SHA-256 hash of the encryption key used to encrypt the blob data and metadata.
+       */
+      Azure::Nullable<std::vector<uint8_t>> EncryptionKeySha256;
+      /**
+       * The name of the encryption scope under which the blob is encrypted.
+       */
+      Azure::Nullable<std::string> EncryptionScope;
+    }; // struct QueryBlobResult
+
     /**
      * @brief Response type for Azure::Storage::Blobs::PageBlobClient::Resize.
      */
@@ -4717,11 +4870,9 @@ namespace Azure { namespace Storage { namespace Blobs {
           Azure::Nullable<bool> PreventEncryptionScopeOverride;
         }; // struct CreateBlobContainerOptions
 
-        static Azure::Response<CreateBlobContainerResult> Create(
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+        static Azure::Core::Http::Request CreateCreateMessage(
             const Azure::Core::Url& url,
-            const CreateBlobContainerOptions& options,
-            const Azure::Core::Context& context)
+            const CreateBlobContainerOptions& options)
         {
           auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Put, url);
           request.SetHeader("Content-Length", "0");
@@ -4751,7 +4902,14 @@ namespace Azure { namespace Storage { namespace Blobs {
                 "x-ms-deny-encryption-scope-override",
                 options.PreventEncryptionScopeOverride.Value() ? "true" : "false");
           }
-          auto pHttpResponse = pipeline.Send(request, context);
+          return request;
+        }
+
+        static Azure::Response<CreateBlobContainerResult> CreateCreateResponse(
+            std::unique_ptr<Azure::Core::Http::RawResponse> pHttpResponse,
+            const Azure::Core::Context& context)
+        {
+          (void)context;
           Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
           CreateBlobContainerResult response;
           auto http_status_code = httpResponse.GetStatusCode();
@@ -4766,6 +4924,17 @@ namespace Azure { namespace Storage { namespace Blobs {
               std::move(response), std::move(pHttpResponse));
         }
 
+        static Azure::Response<CreateBlobContainerResult> Create(
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            const Azure::Core::Url& url,
+            const CreateBlobContainerOptions& options,
+            const Azure::Core::Context& context)
+        {
+          auto request = CreateCreateMessage(url, options);
+          auto pHttpResponse = pipeline.Send(request, context);
+          return CreateCreateResponse(std::move(pHttpResponse), context);
+        }
+
         struct DeleteBlobContainerOptions final
         {
           Azure::Nullable<int32_t> Timeout;
@@ -4774,11 +4943,9 @@ namespace Azure { namespace Storage { namespace Blobs {
           Azure::Nullable<Azure::DateTime> IfUnmodifiedSince;
         }; // struct DeleteBlobContainerOptions
 
-        static Azure::Response<DeleteBlobContainerResult> Delete(
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+        static Azure::Core::Http::Request DeleteCreateMessage(
             const Azure::Core::Url& url,
-            const DeleteBlobContainerOptions& options,
-            const Azure::Core::Context& context)
+            const DeleteBlobContainerOptions& options)
         {
           auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Delete, url);
           request.GetUrl().AppendQueryParameter("restype", "container");
@@ -4804,7 +4971,14 @@ namespace Azure { namespace Storage { namespace Blobs {
                 "If-Unmodified-Since",
                 options.IfUnmodifiedSince.Value().ToString(Azure::DateTime::DateFormat::Rfc1123));
           }
-          auto pHttpResponse = pipeline.Send(request, context);
+          return request;
+        }
+
+        static Azure::Response<DeleteBlobContainerResult> DeleteCreateResponse(
+            std::unique_ptr<Azure::Core::Http::RawResponse> pHttpResponse,
+            const Azure::Core::Context& context)
+        {
+          (void)context;
           Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
           DeleteBlobContainerResult response;
           auto http_status_code = httpResponse.GetStatusCode();
@@ -4816,6 +4990,17 @@ namespace Azure { namespace Storage { namespace Blobs {
               std::move(response), std::move(pHttpResponse));
         }
 
+        static Azure::Response<DeleteBlobContainerResult> Delete(
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            const Azure::Core::Url& url,
+            const DeleteBlobContainerOptions& options,
+            const Azure::Core::Context& context)
+        {
+          auto request = DeleteCreateMessage(url, options);
+          auto pHttpResponse = pipeline.Send(request, context);
+          return DeleteCreateResponse(std::move(pHttpResponse), context);
+        }
+
         struct UndeleteBlobContainerOptions final
         {
           Azure::Nullable<int32_t> Timeout;
@@ -4996,7 +5181,8 @@ namespace Azure { namespace Storage { namespace Blobs {
             const ListBlobsOptions& options,
             const Azure::Core::Context& context)
         {
-          auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Get, url);
+          auto request
+              = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Get, url, false);
           request.SetHeader("x-ms-version", "2020-02-10");
           if (options.Timeout.HasValue())
           {
@@ -5026,22 +5212,35 @@ namespace Azure { namespace Storage { namespace Blobs {
             request.GetUrl().AppendQueryParameter(
                 "include", _internal::UrlEncodeQueryParameter(list_blobs_include_flags));
           }
-          auto pHttpResponse = pipeline.Send(request, context);
-          Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
-          Models::_detail::ListBlobsResult response;
-          auto http_status_code = httpResponse.GetStatusCode();
-          if (http_status_code != Azure::Core::Http::HttpStatusCode::Ok)
-          {
-            throw StorageException::CreateFromResponse(std::move(pHttpResponse));
-          }
+          // The page is parsed while it is downloaded. A page whose body fails to be read is
+          // requested again, like the body of a download is read again.
+          for (int retry = 0;; ++retry)
           {
-            const auto& httpResponseBody = httpResponse.GetBody();
-            _internal::XmlReader reader(
-                reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
-            response = ListBlobsResultInternalFromXml(reader);
+            auto pHttpResponse = pipeline.Send(request, context);
+            Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
+            Models::_detail::ListBlobsResult response;
+            auto http_status_code = httpResponse.GetStatusCode();
+            if (http_status_code != Azure::Core::Http::HttpStatusCode::Ok)
+            {
+              throw StorageException::CreateFromResponse(std::move(pHttpResponse));
+            }
+            try
+            {
+              auto httpResponseBodyStream = httpResponse.ExtractBodyStream();
+              _internal::XmlReader reader(*httpResponseBodyStream, context);
+              response = ListBlobsResultInternalFromXml(reader);
+            }
+            catch (Azure::Core::Http::TransportException const&)
+            {
+              if (retry == _internal::ReliableStreamRetryCount)
+              {
+                throw;
+              }
+              continue;
+            }
+            return Azure::Response<Models::_detail::ListBlobsResult>(
+                std::move(response), std::move(pHttpResponse));
           }
-          return Azure::Response<Models::_detail::ListBlobsResult>(
-              std::move(response), std::move(pHttpResponse));
         }
 
         struct ListBlobsByHierarchyOptions final
@@ -5060,7 +5259,8 @@ namespace Azure { namespace Storage { namespace Blobs {
             const ListBlobsByHierarchyOptions& options,
             const Azure::Core::Context& context)
         {
-          auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Get, url);
+          auto request
+              = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Get, url, false);
           request.SetHeader("x-ms-version", "2020-02-10");
           if (options.Timeout.HasValue())
           {
@@ -5095,22 +5295,35 @@ namespace Azure { namespace Storage { namespace Blobs {
             request.GetUrl().AppendQueryParameter(
                 "include", _internal::UrlEncodeQueryParameter(list_blobs_include_flags));
           }
-          auto pHttpResponse = pipeline.Send(request, context);
-          Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
-          Models::_detail::ListBlobsByHierarchyResult response;
-          auto http_status_code = httpResponse.GetStatusCode();
-          if (http_status_code != Azure::Core::Http::HttpStatusCode::Ok)
-          {
-            throw StorageException::CreateFromResponse(std::move(pHttpResponse));
-          }
+          // The page is parsed while it is downloaded. A page whose body fails to be read is
+          // requested again, like the body of a download is read again.
+          for (int retry = 0;; ++retry)
           {
-            const auto& httpResponseBody = httpResponse.GetBody();
-            _internal::XmlReader reader(
-                reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
-            response = ListBlobsByHierarchyResultInternalFromXml(reader);
+            auto pHttpResponse = pipeline.Send(request, context);
+            Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
+            Models::_detail::ListBlobsByHierarchyResult response;
+            auto http_status_code = httpResponse.GetStatusCode();
+            if (http_status_code != Azure::Core::Http::HttpStatusCode::Ok)
+            {
+              throw StorageException::CreateFromResponse(std::move(pHttpResponse));
+            }
+            try
+            {
+              auto httpResponseBodyStream = httpResponse.ExtractBodyStream();
+              _internal::XmlReader reader(*httpResponseBodyStream, context);
+              response = ListBlobsByHierarchyResultInternalFromXml(reader);
+            }
+            catch (Azure::Core::Http::TransportException const&)
+            {
+              if (retry == _internal::ReliableStreamRetryCount)
+              {
+                throw;
+              }
+              continue;
+            }
+            return Azure::Response<Models::_detail::ListBlobsByHierarchyResult>(
+                std::move(response), std::move(pHttpResponse));
           }
-          return Azure::Response<Models::_detail::ListBlobsByHierarchyResult>(
-              std::move(response), std::move(pHttpResponse));
         }
 
         struct GetBlobContainerAccessPolicyOptions final
@@ -9126,7 +9339,7 @@ namespace Azure { namespace Storage { namespace Blobs {
                   options.SourceRange.Value().Offset + options.SourceRange.Value().Length.Value()
                   - 1);
             }
-            request.SetHeader("x-ms-source_range", std::move(headerValue));
+            request.SetHeader("x-ms-source-range", std::move(headerValue));
           }
           if (options.TransactionalContentHash.HasValue())
           {
@@ -9478,6 +9691,153 @@ namespace Azure { namespace Storage { namespace Blobs {
           return Azure::Response<GetBlockListResult>(std::move(response), std::move(pHttpResponse));
         }
 
+        struct QuerySerialization final
+        {
+          std::string Type;
+          std::string RecordSeparator;
+          std::string ColumnSeparator;
+          std::string FieldQuote;
+          std::string EscapeChar;
+          bool HasHeaders = false;
+          std::vector<BlobQueryArrowField> ArrowSchema;
+        }; // struct QuerySerialization
+
+        struct QueryBlobOptions final
+        {
+          Azure::Nullable<int32_t> Timeout;
+          std::string Expression;
+          QuerySerialization InputSerialization;
+          QuerySerialization OutputSerialization;
+          Azure::Nullable<std::string> LeaseId;
+          Azure::Nullable<std::string> EncryptionKey;
+          Azure::Nullable<std::vector<uint8_t>> EncryptionKeySha256;
+          Azure::Nullable<EncryptionAlgorithmType> EncryptionAlgorithm;
+          Azure::Nullable<Azure::DateTime> IfModifiedSince;
+          Azure::Nullable<Azure::DateTime> IfUnmodifiedSince;
+          Azure::ETag IfMatch;
+          Azure::ETag IfNoneMatch;
+          Azure::Nullable<std::string> IfTags;
+        }; // struct QueryBlobOptions
+
+        static Azure::Response<QueryBlobResult> Query(
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            const Azure::Core::Url& url,
+            const QueryBlobOptions& options,
+            const Azure::Core::Context& context)
+        {
+          std::string xml_body;
+          {
+            _internal::XmlWriter writer;
+            QueryBlobOptionsToXml(writer, options);
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::End});
+            xml_body = writer.GetDocument();
+          }
+          Azure::Core::IO::MemoryBodyStream xml_body_stream(
+              reinterpret_cast<const uint8_t*>(xml_body.data()), xml_body.length());
+          auto request = Azure::Core::Http::Request(
+              Azure::Core::Http::HttpMethod::Post, url, &xml_body_stream, false);
+          request.SetHeader("Content-Length", std::to_string(xml_body_stream.Length()));
+          request.GetUrl().AppendQueryParameter("comp", "query");
+          request.SetHeader("x-ms-version", "2020-02-10");
+          if (options.Timeout.HasValue())
+          {
+            request.GetUrl().AppendQueryParameter(
+                "timeout", std::to_string(options.Timeout.Value()));
+          }
+          if (options.LeaseId.HasValue())
+          {
+            request.SetHeader("x-ms-lease-id", options.LeaseId.Value());
+          }
+          if (options.EncryptionKey.HasValue())
+          {
+            request.SetHeader("x-ms-encryption-key", options.EncryptionKey.Value());
+          }
+          if (options.EncryptionKeySha256.HasValue())
+          {
+            request.SetHeader(
+                "x-ms-encryption-key-sha256",
+                Azure::Core::Convert::Base64Encode(options.EncryptionKeySha256.Value()));
+          }
+          if (options.EncryptionAlgorithm.HasValue())
+          {
+            request.SetHeader(
+                "x-ms-encryption-algorithm", options.EncryptionAlgorithm.Value().ToString());
+          }
+          if (options.IfModifiedSince.HasValue())
+          {
+            request.SetHeader(
+                "If-Modified-Since",
+                options.IfModifiedSince.Value().ToString(Azure::DateTime::DateFormat::Rfc1123));
+          }
+          if (options.IfUnmodifiedSince.HasValue())
+          {
+            request.SetHeader(
+                "If-Unmodified-Since",
+                options.IfUnmodifiedSince.Value().ToString(Azure::DateTime::DateFormat::Rfc1123));
+          }
+          if (options.IfMatch.HasValue() && !options.IfMatch.ToString().empty())
+          {
+            request.SetHeader("If-Match", options.IfMatch.ToString());
+          }
+          if (options.IfNoneMatch.HasValue() && !options.IfNoneMatch.ToString().empty())
+          {
+            request.SetHeader("If-None-Match", options.IfNoneMatch.ToString());
+          }
+          if (options.IfTags.HasValue())
+          {
+            request.SetHeader("x-ms-if-tags", options.IfTags.Value());
+          }
+          auto pHttpResponse = pipeline.Send(request, context);
+          Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
+          QueryBlobResult response;
+          auto http_status_code = httpResponse.GetStatusCode();
+          if (!(http_status_code == Azure::Core::Http::HttpStatusCode::Ok
+                || http_status_code == Azure::Core::Http::HttpStatusCode::PartialContent))
+          {
+            throw StorageException::CreateFromResponse(std::move(pHttpResponse));
+          }
+          response.BodyStream = httpResponse.ExtractBodyStream();
+          response.ETag = Azure::ETag(httpResponse.GetHeaders().at("etag"));
+          response.LastModified = Azure::DateTime::Parse(
+              httpResponse.GetHeaders().at("last-modified"), Azure::DateTime::DateFormat::Rfc1123);
+          auto x_ms_lease_duration__iterator
+              = httpResponse.GetHeaders().find("x-ms-lease-duration");
+          if (x_ms_lease_duration__iterator != httpResponse.GetHeaders().end())
+          {
+            response.LeaseDuration = LeaseDurationType(x_ms_lease_duration__iterator->second);
+          }
+          auto x_ms_lease_state__iterator = httpResponse.GetHeaders().find("x-ms-lease-state");
+          if (x_ms_lease_state__iterator != httpResponse.GetHeaders().end())
+          {
+            response.LeaseState = LeaseState(x_ms_lease_state__iterator->second);
+          }
+          auto x_ms_lease_status__iterator = httpResponse.GetHeaders().find("x-ms-lease-status");
+          if (x_ms_lease_status__iterator != httpResponse.GetHeaders().end())
+          {
+            response.LeaseStatus = LeaseStatus(x_ms_lease_status__iterator->second);
+          }
+          auto x_ms_server_encrypted__iterator
+              = httpResponse.GetHeaders().find("x-ms-server-encrypted");
+          if (x_ms_server_encrypted__iterator != httpResponse.GetHeaders().end())
+          {
+            response.IsServerEncrypted = x_ms_server_encrypted__iterator->second == "true";
+          }
+          auto x_ms_encryption_key_sha256__iterator
+              = httpResponse.GetHeaders().find("x-ms-encryption-key-sha256");
+          if (x_ms_encryption_key_sha256__iterator != httpResponse.GetHeaders().end())
+          {
+            response.EncryptionKeySha256
+                = Azure::Core::Convert::Base64Decode(x_ms_encryption_key_sha256__iterator->second);
+          }
+          auto x_ms_encryption_scope__iterator
+              = httpResponse.GetHeaders().find("x-ms-encryption-scope");
+          if (x_ms_encryption_scope__iterator != httpResponse.GetHeaders().end())
+          {
+            response.EncryptionScope = x_ms_encryption_scope__iterator->second;
+          }
+          return Azure::Response<QueryBlobResult>(std::move(response), std::move(pHttpResponse));
+        }
+
       private:
         static GetBlockListResult GetBlockListResultFromXml(_internal::XmlReader& reader)
         {
@@ -9623,6 +9983,114 @@ namespace Azure { namespace Storage { namespace Blobs {
           writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
         }
 
+        static void QueryBlobOptionsToXml(
+            _internal::XmlWriter& writer,
+            const QueryBlobOptions& options)
+        {
+          writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "QueryRequest"});
+          writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "QueryType", "SQL"});
+          writer.Write(_internal::XmlNode{
+              _internal::XmlNodeType::StartTag, "Expression", options.Expression});
+          if (!options.InputSerialization.Type.empty())
+          {
+            writer.Write(
+                _internal::XmlNode{_internal::XmlNodeType::StartTag, "InputSerialization"});
+            QuerySerializationToXml(writer, options.InputSerialization);
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+          }
+          if (!options.OutputSerialization.Type.empty())
+          {
+            writer.Write(
+                _internal::XmlNode{_internal::XmlNodeType::StartTag, "OutputSerialization"});
+            QuerySerializationToXml(writer, options.OutputSerialization);
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+          }
+          writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+        }
+
+        static void QuerySerializationToXml(
+            _internal::XmlWriter& writer,
+            const QuerySerialization& options)
+        {
+          writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Format"});
+          writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Type", options.Type});
+          if (options.Type == "delimited")
+          {
+            writer.Write(
+                _internal::XmlNode{_internal::XmlNodeType::StartTag, "DelimitedTextConfiguration"});
+            // The empty separators and characters are left out, the service uses its defaults.
+            if (!options.ColumnSeparator.empty())
+            {
+              writer.Write(_internal::XmlNode{
+                  _internal::XmlNodeType::StartTag, "ColumnSeparator", options.ColumnSeparator});
+            }
+            if (!options.FieldQuote.empty())
+            {
+              writer.Write(_internal::XmlNode{
+                  _internal::XmlNodeType::StartTag, "FieldQuote", options.FieldQuote});
+            }
+            if (!options.RecordSeparator.empty())
+            {
+              writer.Write(_internal::XmlNode{
+                  _internal::XmlNodeType::StartTag, "RecordSeparator", options.RecordSeparator});
+            }
+            if (!options.EscapeChar.empty())
+            {
+              writer.Write(_internal::XmlNode{
+                  _internal::XmlNodeType::StartTag, "EscapeChar", options.EscapeChar});
+            }
+            writer.Write(_internal::XmlNode{
+                _internal::XmlNodeType::StartTag,
+                "HasHeaders",
+                options.HasHeaders ? "true" : "false"});
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+          }
+          else if (options.Type == "json")
+          {
+            writer.Write(
+                _internal::XmlNode{_internal::XmlNodeType::StartTag, "JsonTextConfiguration"});
+            if (!options.RecordSeparator.empty())
+            {
+              writer.Write(_internal::XmlNode{
+                  _internal::XmlNodeType::StartTag, "RecordSeparator", options.RecordSeparator});
+            }
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+          }
+          else if (options.Type == "arrow")
+          {
+            writer.Write(
+                _internal::XmlNode{_internal::XmlNodeType::StartTag, "ArrowConfiguration"});
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Schema"});
+            for (const auto& i : options.ArrowSchema)
+            {
+              writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Field"});
+              writer.Write(_internal::XmlNode{
+                  _internal::XmlNodeType::StartTag, "Type", i.Type.ToString()});
+              if (i.Name.HasValue() && !i.Name.Value().empty())
+              {
+                writer.Write(_internal::XmlNode{
+                    _internal::XmlNodeType::StartTag, "Name", i.Name.Value()});
+              }
+              if (i.Precision.HasValue())
+              {
+                writer.Write(_internal::XmlNode{
+                    _internal::XmlNodeType::StartTag,
+                    "Precision",
+                    std::to_string(i.Precision.Value())});
+              }
+              if (i.Scale.HasValue())
+              {
+                writer.Write(_internal::XmlNode{
+                    _internal::XmlNodeType::StartTag, "Scale", std::to_string(i.Scale.Value())});
+              }
+              writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+            }
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+            writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+          }
+          writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+        }
+
       }; // class BlockBlob
 
       class PageBlob final {
@@ -9648,11 +10116,9 @@ namespace Azure { namespace Storage { namespace Blobs {
           std::map<std::string, std::string> Tags;
         }; // struct CreatePageBlobOptions
 
-        static Azure::Response<CreatePageBlobResult> Create(
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+        static Azure::Core::Http::Request CreateCreateMessage(
             const Azure::Core::Url& url,
-            const CreatePageBlobOptions& options,
-            const Azure::Core::Context& context)
+            const CreatePageBlobOptions& options)
         {
           auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Put, url);
           request.SetHeader("Content-Length", "0");
@@ -9765,7 +10231,14 @@ namespace Azure { namespace Storage { namespace Blobs {
           {
             request.SetHeader("x-ms-if-tags", options.IfTags.Value());
           }
-          auto pHttpResponse = pipeline.Send(request, context);
+          return request;
+        }
+
+        static Azure::Response<CreatePageBlobResult> CreateCreateResponse(
+            std::unique_ptr<Azure::Core::Http::RawResponse> pHttpResponse,
+            const Azure::Core::Context& context)
+        {
+          (void)context;
           Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
           CreatePageBlobResult response;
           auto http_status_code = httpResponse.GetStatusCode();
@@ -9800,6 +10273,17 @@ namespace Azure { namespace Storage { namespace Blobs {
               std::move(response), std::move(pHttpResponse));
         }
 
+        static Azure::Response<CreatePageBlobResult> Create(
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            const Azure::Core::Url& url,
+            const CreatePageBlobOptions& options,
+            const Azure::Core::Context& context)
+        {
+          auto request = CreateCreateMessage(url, options);
+          auto pHttpResponse = pipeline.Send(request, context);
+          return CreateCreateResponse(std::move(pHttpResponse), context);
+        }
+
         struct UploadPageBlobPagesOptions final
         {
           Azure::Nullable<int32_t> Timeout;
@@ -10838,11 +11322,9 @@ namespace Azure { namespace Storage { namespace Blobs {
           Azure::Nullable<std::string> IfTags;
         }; // struct CreateAppendBlobOptions
 
-        static Azure::Response<CreateAppendBlobResult> Create(
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+        static Azure::Core::Http::Request CreateCreateMessage(
             const Azure::Core::Url& url,
-            const CreateAppendBlobOptions& options,
-            const Azure::Core::Context& context)
+            const CreateAppendBlobOptions& options)
         {
           auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Put, url);
           request.SetHeader("Content-Length", "0");
@@ -10945,7 +11427,14 @@ namespace Azure { namespace Storage { namespace Blobs {
           {
             request.SetHeader("x-ms-if-tags", options.IfTags.Value());
           }
-          auto pHttpResponse = pipeline.Send(request, context);
+          return request;
+        }
+
+        static Azure::Response<CreateAppendBlobResult> CreateCreateResponse(
+            std::unique_ptr<Azure::Core::Http::RawResponse> pHttpResponse,
+            const Azure::Core::Context& context)
+        {
+          (void)context;
           Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
           CreateAppendBlobResult response;
           auto http_status_code = httpResponse.GetStatusCode();
@@ -10980,6 +11469,17 @@ namespace Azure { namespace Storage { namespace Blobs {
               std::move(response), std::move(pHttpResponse));
         }
 
+        static Azure::Response<CreateAppendBlobResult> Create(
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            const Azure::Core::Url& url,
+            const CreateAppendBlobOptions& options,
+            const Azure::Core::Context& context)
+        {
+          auto request = CreateCreateMessage(url, options);
+          auto pHttpResponse = pipeline.Send(request, context);
+          return CreateCreateResponse(std::move(pHttpResponse), context);
+        }
+
         struct AppendBlockOptions final
         {
           Azure::Nullable<int32_t> Timeout;
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "azure/storage/blobs/blob_container_client.hpp"
+#include "azure/storage/blobs/blob_service_client.hpp"
+#include "azure/storage/blobs/block_blob_client.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  /**
+   * The StripedBlobContainerClient spreads the blobs of a container over the containers of several
+   * storage accounts, so that the throughput and the request rate of an application aren't capped
+   * by the limits of a single account.
+   *
+   * @remark Each blob is stored in one of the containers, picked from the name of the blob with
+   * rendezvous hashing on the URLs of the containers. The container of a blob doesn't depend on
+   * the order of the containers, and adding a container moves only the blobs picking the new
+   * container.
+   */
+  class StripedBlobContainerClient final {
+  public:
+    /**
+     * @brief Initialize a new instance of StripedBlobContainerClient.
+     *
+     * @param containerClients The containers to spread the blobs over, one for each storage
+     * account.
+     *
+     * @throw std::invalid_argument \p containerClients is empty.
+     */
+    explicit StripedBlobContainerClient(std::vector<BlobContainerClient> containerClients);
+
+    /**
+     * @brief Initialize a new instance of StripedBlobContainerClient.
+     *
+     * @param serviceClients The storage accounts to spread the blobs over.
+     * @param blobContainerName The name of the container, the same in all the accounts.
+     *
+     * @throw std::invalid_argument \p serviceClients is empty.
+     */
+    explicit StripedBlobContainerClient(
+        const std::vector<BlobServiceClient>& serviceClients,
+        const std::string& blobContainerName);
+
+    /**
+     * @brief Gets the containers the blobs are spread over.
+     *
+     * @return The containers, in the order they were given.
+     */
+    const std::vector<BlobContainerClient>& GetContainerClients() const
+    {
+      return m_containerClients;
+    }
+
+    /**
+     * @brief Gets the index of the container of a blob in GetContainerClients().
+     *
+     * @param blobName The name of the blob.
+     * @return The index of the container storing the blob.
+     */
+    size_t GetContainerIndex(const std::string& blobName) const;
+
+    /**
+     * @brief Gets the container of a blob.
+     *
+     * @param blobName The name of the blob.
+     * @return The container storing the blob.
+     */
+    const BlobContainerClient& GetContainerClient(const std::string& blobName) const
+    {
+      return m_containerClients[GetContainerIndex(blobName)];
+    }
+
+    /**
+     * @brief Create a new BlobClient object for a blob, in the container storing it.
+     *
+     * @param blobName The name of the blob.
+     * @return A new BlobClient instance.
+     */
+    BlobClient GetBlobClient(const std::string& blobName) const
+    {
+      return GetContainerClient(blobName).GetBlobClient(blobName);
+    }
+
+    /**
+     * @brief Create a new BlockBlobClient object for a blob, in the container storing it.
+     *
+     * @param blobName The name of the blob.
+     * @return A new BlockBlobClient instance.
+     */
+    BlockBlobClient GetBlockBlobClient(const std::string& blobName) const
+    {
+      return GetContainerClient(blobName).GetBlockBlobClient(blobName);
+    }
+
+    /**
+     * @brief Lists the blobs of all the containers, each container with
+     * #Azure::Storage::Blobs::BlobContainerClient::ListBlobsConcurrently.
+     *
+     * @remark The pages of blobs are passed to \p onBlobs once they are received, from several
+     * threads at the same time. The pages aren't ordered.
+     *
+     * @param onBlobs Called with the blobs of each page. It must be safe to call it from several
+     * threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     */
+    void ListBlobsConcurrently(
+        const std::function<void(std::vector<Models::BlobItem>)>& onBlobs,
+        const ListBlobsConcurrentlyOptions& options = ListBlobsConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+  private:
+    std::vector<BlobContainerClient> m_containerClients;
+    // The hashes of the URLs of the containers, combined with the hash of a blob name to rank the
+    // containers for the blob.
+    std::vector<uint64_t> m_containerHashes;
+  };
+
+}}} // namespace Azure::Storage::Blobs
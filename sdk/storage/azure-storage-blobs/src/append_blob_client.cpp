@@ -3,11 +3,41 @@
 
 #include "azure/storage/blobs/append_blob_client.hpp"
 
+#include <azure/core/internal/diagnostics/span.hpp>
 #include <azure/storage/common/internal/constants.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    constexpr int64_t MaxAppendBlockSize = 4 * 1024 * 1024;
+
+    _detail::BlobRestClient::AppendBlob::CreateAppendBlobOptions GetCreateProtocolLayerOptions(
+        const CreateAppendBlobOptions& options,
+        const Azure::Nullable<EncryptionKey>& customerProvidedKey,
+        const Azure::Nullable<std::string>& encryptionScope)
+    {
+      _detail::BlobRestClient::AppendBlob::CreateAppendBlobOptions protocolLayerOptions;
+      protocolLayerOptions.HttpHeaders = options.HttpHeaders;
+      protocolLayerOptions.Metadata = options.Metadata;
+      protocolLayerOptions.Tags = options.Tags;
+      protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+      protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
+      protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
+      protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
+      protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+      protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
+      if (customerProvidedKey.HasValue())
+      {
+        protocolLayerOptions.EncryptionKey = customerProvidedKey.Value().Key;
+        protocolLayerOptions.EncryptionKeySha256 = customerProvidedKey.Value().KeyHash;
+        protocolLayerOptions.EncryptionAlgorithm = customerProvidedKey.Value().Algorithm;
+      }
+      protocolLayerOptions.EncryptionScope = encryptionScope;
+      return protocolLayerOptions;
+    }
+  } // namespace
+
   AppendBlobClient AppendBlobClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& blobContainerName,
@@ -76,25 +106,11 @@ namespace Azure { namespace Storage { namespace Blobs {
       const CreateAppendBlobOptions& options,
       const Azure::Core::Context& context) const
   {
-    _detail::BlobRestClient::AppendBlob::CreateAppendBlobOptions protocolLayerOptions;
-    protocolLayerOptions.HttpHeaders = options.HttpHeaders;
-    protocolLayerOptions.Metadata = options.Metadata;
-    protocolLayerOptions.Tags = options.Tags;
-    protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
-    protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
-    protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
-    protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
-    protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
-    protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
-    if (m_customerProvidedKey.HasValue())
-    {
-      protocolLayerOptions.EncryptionKey = m_customerProvidedKey.Value().Key;
-      protocolLayerOptions.EncryptionKeySha256 = m_customerProvidedKey.Value().KeyHash;
-      protocolLayerOptions.EncryptionAlgorithm = m_customerProvidedKey.Value().Algorithm;
-    }
-    protocolLayerOptions.EncryptionScope = m_encryptionScope;
     return _detail::BlobRestClient::AppendBlob::Create(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline,
+        m_blobUrl,
+        GetCreateProtocolLayerOptions(options, m_customerProvidedKey, m_encryptionScope),
+        context);
   }
 
   Azure::Response<Models::CreateAppendBlobResult> AppendBlobClient::CreateIfNotExists(
@@ -103,22 +119,19 @@ namespace Azure { namespace Storage { namespace Blobs {
   {
     auto optionsCopy = options;
     optionsCopy.AccessConditions.IfNoneMatch = Azure::ETag::Any();
-    try
+    auto request = _detail::BlobRestClient::AppendBlob::CreateCreateMessage(
+        m_blobUrl,
+        GetCreateProtocolLayerOptions(optionsCopy, m_customerProvidedKey, m_encryptionScope));
+    auto response = m_pipeline->Send(request, context);
+    // An existing blob is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response, Core::Http::HttpStatusCode::Conflict, {"BlobAlreadyExists"}))
     {
-      return Create(optionsCopy, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.StatusCode == Core::Http::HttpStatusCode::Conflict
-          && e.ErrorCode == "BlobAlreadyExists")
-      {
-        Models::CreateAppendBlobResult ret;
-        ret.Created = false;
-        return Azure::Response<Models::CreateAppendBlobResult>(
-            std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::CreateAppendBlobResult ret;
+      ret.Created = false;
+      return Azure::Response<Models::CreateAppendBlobResult>(std::move(ret), std::move(response));
     }
+    return _detail::BlobRestClient::AppendBlob::CreateCreateResponse(std::move(response), context);
   }
 
   Azure::Response<Models::AppendBlockResult> AppendBlobClient::AppendBlock(
@@ -175,6 +188,24 @@ namespace Azure { namespace Storage { namespace Blobs {
         *m_pipeline, m_blobUrl, protocolLayerOptions, context);
   }
 
+  std::unique_ptr<AppendBlobWriter> AppendBlobClient::OpenWrite(
+      const OpenWriteAppendBlobOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    Azure::Core::Diagnostics::_internal::Span span("AppendBlobClient.OpenWrite", context);
+    if (options.BlockSize <= 0 || options.BlockSize > MaxAppendBlockSize)
+    {
+      throw Azure::Core::RequestFailedException(
+          "Block size must be positive and cannot be larger than 4 MiB.");
+    }
+
+    GetBlobPropertiesOptions propertiesOptions;
+    propertiesOptions.AccessConditions = options.AccessConditions;
+    auto properties = GetProperties(propertiesOptions, span.GetContext());
+    return std::unique_ptr<AppendBlobWriter>(
+        new AppendBlobWriter(*this, options, properties.Value.BlobSize, context));
+  }
+
   Azure::Response<Models::SealAppendBlobResult> AppendBlobClient::Seal(
       const SealAppendBlobOptions& options,
       const Azure::Core::Context& context) const
@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/append_blob_writer.hpp"
+
+#include <azure/core/io/body_stream.hpp>
+
+#include "azure/storage/blobs/append_blob_client.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    // Waits are split so that a cancelled context is noticed quickly.
+    constexpr std::chrono::milliseconds MaxWaitDuration(100);
+  } // namespace
+
+  struct AppendBlobWriter::State final
+  {
+    explicit State(const AppendBlobClient& client) : Client(client) {}
+
+    struct Block final
+    {
+      std::vector<uint8_t> Data;
+      // When the first byte of the block was written.
+      std::chrono::steady_clock::time_point FirstWriteTime;
+    };
+
+    AppendBlobClient Client;
+    AppendBlobAccessConditions AccessConditions;
+    size_t BlockSize = 0;
+    std::chrono::milliseconds FlushInterval{0};
+    size_t MaxBufferedSize = 0;
+    Azure::Core::Context Context;
+
+    std::mutex Mutex;
+    // Notified when data is written, flushed or appended, and when the writer fails or stops.
+    std::condition_variable Changed;
+    // The data written and not appended yet, in blocks of up to BlockSize bytes. Only the last
+    // block is written to, the first one is taken out while it is appended.
+    std::deque<Block> Blocks;
+    // The bytes written and not appended yet, including those of the block being appended.
+    size_t BufferedSize = 0;
+    // The size of the blob after the data appended, and after all the data written.
+    int64_t CommittedSize = 0;
+    int64_t WrittenSize = 0;
+    // The size of the blob requested by the flushes, the blocks are appended without waiting for
+    // them to be full until it is reached.
+    int64_t FlushedSize = 0;
+    bool Stopping = false;
+    std::exception_ptr Exception;
+
+    std::thread AppendThread;
+
+    // Appends the blocks once they are ready, one at a time, until the writer is stopped or an
+    // append fails.
+    void AppendBlocks();
+    void ThrowIfFailed() const
+    {
+      if (Exception)
+      {
+        std::rethrow_exception(Exception);
+      }
+    }
+  };
+
+  void AppendBlobWriter::State::AppendBlocks()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (true)
+    {
+      if (Blocks.empty())
+      {
+        if (Stopping)
+        {
+          return;
+        }
+        Changed.wait(lock);
+        continue;
+      }
+      const auto flushTime = Blocks.front().FirstWriteTime + FlushInterval;
+      if (Blocks.size() == 1 && Blocks.front().Data.size() < BlockSize && !Stopping
+          && FlushedSize <= CommittedSize && std::chrono::steady_clock::now() < flushTime)
+      {
+        Changed.wait_until(lock, flushTime);
+        continue;
+      }
+
+      // The writes go to a new block while this one is appended.
+      std::vector<uint8_t> block = std::move(Blocks.front().Data);
+      Blocks.pop_front();
+      const int64_t appendPosition = CommittedSize;
+      lock.unlock();
+      try
+      {
+        Azure::Core::IO::MemoryBodyStream content(block.data(), block.size());
+        AppendBlockOptions options;
+        options.AccessConditions = AccessConditions;
+        options.AccessConditions.IfAppendPositionEqual = appendPosition;
+        Client.AppendBlock(content, options, Context);
+      }
+      catch (...)
+      {
+        lock.lock();
+        Exception = std::current_exception();
+        Changed.notify_all();
+        return;
+      }
+      lock.lock();
+      CommittedSize += static_cast<int64_t>(block.size());
+      BufferedSize -= block.size();
+      Changed.notify_all();
+    }
+  }
+
+  AppendBlobWriter::AppendBlobWriter(
+      const AppendBlobClient& client,
+      const OpenWriteAppendBlobOptions& options,
+      int64_t blobSize,
+      const Azure::Core::Context& context)
+      : m_state(std::make_unique<State>(client))
+  {
+    m_state->AccessConditions = options.AccessConditions;
+    m_state->BlockSize = static_cast<size_t>(options.BlockSize);
+    m_state->FlushInterval = options.FlushInterval;
+    m_state->MaxBufferedSize
+        = static_cast<size_t>(std::max(options.MaxBufferedSize, options.BlockSize));
+    m_state->Context = context;
+    m_state->CommittedSize = blobSize;
+    m_state->WrittenSize = blobSize;
+    m_state->FlushedSize = blobSize;
+    m_state->AppendThread = std::thread([this]() { m_state->AppendBlocks(); });
+  }
+
+  AppendBlobWriter::~AppendBlobWriter()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_state->Mutex);
+      m_state->Stopping = true;
+    }
+    m_state->Changed.notify_all();
+    m_state->AppendThread.join();
+  }
+
+  void AppendBlobWriter::Write(
+      const uint8_t* data,
+      size_t length,
+      const Azure::Core::Context& context)
+  {
+    State& state = *m_state;
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    while (length > 0)
+    {
+      state.ThrowIfFailed();
+      if (state.BufferedSize >= state.MaxBufferedSize)
+      {
+        context.ThrowIfCancelled();
+        state.Changed.wait_for(lock, MaxWaitDuration);
+        continue;
+      }
+      if (state.Blocks.empty() || state.Blocks.back().Data.size() == state.BlockSize)
+      {
+        state.Blocks.emplace_back();
+        state.Blocks.back().FirstWriteTime = std::chrono::steady_clock::now();
+      }
+      auto& block = state.Blocks.back().Data;
+      const size_t writeSize = std::min(
+          {length, state.BlockSize - block.size(), state.MaxBufferedSize - state.BufferedSize});
+      block.insert(block.end(), data, data + writeSize);
+      data += writeSize;
+      length -= writeSize;
+      state.BufferedSize += writeSize;
+      state.WrittenSize += static_cast<int64_t>(writeSize);
+      state.Changed.notify_all();
+    }
+  }
+
+  void AppendBlobWriter::Flush(const Azure::Core::Context& context)
+  {
+    State& state = *m_state;
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    const int64_t flushedSize = state.WrittenSize;
+    state.FlushedSize = std::max(state.FlushedSize, flushedSize);
+    state.Changed.notify_all();
+    while (state.CommittedSize < flushedSize)
+    {
+      state.ThrowIfFailed();
+      context.ThrowIfCancelled();
+      state.Changed.wait_for(lock, MaxWaitDuration);
+    }
+  }
+
+  int64_t AppendBlobWriter::GetCommittedSize() const
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    return m_state->CommittedSize;
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -0,0 +1,426 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/avro_parser.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <azure/core/internal/json/json.hpp>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace _detail {
+
+  namespace {
+    using Azure::Core::Json::_internal::json;
+
+    constexpr size_t StreamBufferSize = 64 * 1024;
+
+    // Parses the schemas of the values of an Avro file from its JSON, and keeps them alive.
+    class AvroSchemaParser final {
+    public:
+      explicit AvroSchemaParser(std::vector<std::unique_ptr<AvroSchema>>& schemas)
+          : m_schemas(schemas)
+      {
+      }
+
+      const AvroSchema* Parse(const json& schemaJson, const std::string& enclosingNamespace)
+      {
+        if (schemaJson.is_array())
+        {
+          AvroSchema* schema = AddSchema(AvroDatumType::Union);
+          for (const auto& branch : schemaJson)
+          {
+            schema->Children.push_back(Parse(branch, enclosingNamespace));
+          }
+          return schema;
+        }
+        if (schemaJson.is_string())
+        {
+          return ParseTypeName(schemaJson.get<std::string>(), enclosingNamespace);
+        }
+        if (!schemaJson.is_object() || schemaJson.find("type") == schemaJson.end())
+        {
+          throw std::runtime_error("Invalid Avro schema.");
+        }
+
+        const auto& typeJson = schemaJson["type"];
+        if (!typeJson.is_string())
+        {
+          return Parse(typeJson, enclosingNamespace);
+        }
+        const std::string type = typeJson.get<std::string>();
+        if (type == "record" || type == "error")
+        {
+          AvroSchema* schema
+              = AddNamedSchema(AvroDatumType::Record, schemaJson, enclosingNamespace);
+          const std::string recordNamespace = GetNamespace(schema->Name);
+          for (const auto& field : schemaJson.at("fields"))
+          {
+            schema->FieldNames.push_back(field.at("name").get<std::string>());
+            schema->Children.push_back(Parse(field.at("type"), recordNamespace));
+          }
+          return schema;
+        }
+        if (type == "enum")
+        {
+          AvroSchema* schema = AddNamedSchema(AvroDatumType::Enum, schemaJson, enclosingNamespace);
+          for (const auto& symbol : schemaJson.at("symbols"))
+          {
+            schema->FieldNames.push_back(symbol.get<std::string>());
+          }
+          return schema;
+        }
+        if (type == "fixed")
+        {
+          AvroSchema* schema = AddNamedSchema(AvroDatumType::Fixed, schemaJson, enclosingNamespace);
+          schema->Size = schemaJson.at("size").get<size_t>();
+          return schema;
+        }
+        if (type == "array" || type == "map")
+        {
+          AvroSchema* schema
+              = AddSchema(type == "array" ? AvroDatumType::Array : AvroDatumType::Map);
+          schema->Children.push_back(
+              Parse(schemaJson.at(type == "array" ? "items" : "values"), enclosingNamespace));
+          return schema;
+        }
+        // A primitive type, possibly with a logical type which doesn't change its encoding.
+        return ParseTypeName(type, enclosingNamespace);
+      }
+
+    private:
+      static std::string GetNamespace(const std::string& fullName)
+      {
+        const size_t dotPosition = fullName.rfind('.');
+        return dotPosition == std::string::npos ? std::string() : fullName.substr(0, dotPosition);
+      }
+
+      AvroSchema* AddSchema(AvroDatumType type)
+      {
+        m_schemas.push_back(std::make_unique<AvroSchema>());
+        m_schemas.back()->Type = type;
+        return m_schemas.back().get();
+      }
+
+      // Adds a record, an enum or a fixed, which later schemas can reference by name.
+      AvroSchema* AddNamedSchema(
+          AvroDatumType type,
+          const json& schemaJson,
+          const std::string& enclosingNamespace)
+      {
+        AvroSchema* schema = AddSchema(type);
+        schema->Name = schemaJson.at("name").get<std::string>();
+        if (schema->Name.find('.') == std::string::npos)
+        {
+          std::string schemaNamespace = enclosingNamespace;
+          auto namespaceJson = schemaJson.find("namespace");
+          if (namespaceJson != schemaJson.end() && namespaceJson->is_string())
+          {
+            schemaNamespace = namespaceJson->get<std::string>();
+          }
+          if (!schemaNamespace.empty())
+          {
+            schema->Name = schemaNamespace + "." + schema->Name;
+          }
+        }
+        m_namedSchemas[schema->Name] = schema;
+        return schema;
+      }
+
+      const AvroSchema* ParseTypeName(
+          const std::string& name,
+          const std::string& enclosingNamespace)
+      {
+        static const std::map<std::string, AvroDatumType> PrimitiveTypes = {
+            {"null", AvroDatumType::Null},
+            {"boolean", AvroDatumType::Boolean},
+            {"int", AvroDatumType::Int},
+            {"long", AvroDatumType::Long},
+            {"float", AvroDatumType::Float},
+            {"double", AvroDatumType::Double},
+            {"bytes", AvroDatumType::Bytes},
+            {"string", AvroDatumType::String},
+        };
+        auto primitiveType = PrimitiveTypes.find(name);
+        if (primitiveType != PrimitiveTypes.end())
+        {
+          return AddSchema(primitiveType->second);
+        }
+        auto namedSchema = m_namedSchemas.find(name);
+        if (namedSchema == m_namedSchemas.end() && name.find('.') == std::string::npos)
+        {
+          namedSchema = m_namedSchemas.find(enclosingNamespace + "." + name);
+        }
+        if (namedSchema == m_namedSchemas.end())
+        {
+          throw std::runtime_error("Unknown Avro type " + name + ".");
+        }
+        return namedSchema->second;
+      }
+
+      std::vector<std::unique_ptr<AvroSchema>>& m_schemas;
+      std::map<std::string, const AvroSchema*> m_namedSchemas;
+    };
+  } // namespace
+
+  const AvroDatum& AvroDatum::Field(const std::string& name) const
+  {
+    if (Schema != nullptr && Schema->Type == AvroDatumType::Record)
+    {
+      auto ite = std::find(Schema->FieldNames.begin(), Schema->FieldNames.end(), name);
+      if (ite != Schema->FieldNames.end())
+      {
+        return Items[static_cast<size_t>(ite - Schema->FieldNames.begin())];
+      }
+    }
+    throw std::runtime_error("Avro record has no field " + name + ".");
+  }
+
+  AvroObjectContainerReader::AvroObjectContainerReader(
+      std::unique_ptr<Azure::Core::IO::BodyStream> stream)
+      : m_stream(std::move(stream)), m_buffer(StreamBufferSize)
+  {
+  }
+
+  bool AvroObjectContainerReader::Next(AvroDatum& datum, const Azure::Core::Context& context)
+  {
+    if (!m_headerRead)
+    {
+      ReadHeader(context);
+      m_headerRead = true;
+    }
+    while (m_remainingBlockObjects == 0)
+    {
+      if (!FillBuffer(context))
+      {
+        return false;
+      }
+      m_remainingBlockObjects = ReadLong(context);
+      // The size in bytes of the block, the objects are decoded as they are read.
+      ReadLong(context);
+      if (m_remainingBlockObjects < 0)
+      {
+        throw std::runtime_error("Invalid Avro block.");
+      }
+      if (m_remainingBlockObjects == 0)
+      {
+        std::array<uint8_t, 16> syncMarker;
+        ReadBytes(syncMarker.data(), syncMarker.size(), context);
+      }
+    }
+
+    datum = AvroDatum();
+    ReadDatum(*m_schema, datum, context);
+    if (--m_remainingBlockObjects == 0)
+    {
+      std::array<uint8_t, 16> syncMarker;
+      ReadBytes(syncMarker.data(), syncMarker.size(), context);
+      if (syncMarker != m_syncMarker)
+      {
+        throw std::runtime_error("Avro sync marker mismatch.");
+      }
+    }
+    return true;
+  }
+
+  void AvroObjectContainerReader::ReadHeader(const Azure::Core::Context& context)
+  {
+    std::array<uint8_t, 4> magic;
+    ReadBytes(magic.data(), magic.size(), context);
+    if (std::memcmp(magic.data(), "Obj\x01", magic.size()) != 0)
+    {
+      throw std::runtime_error("Invalid Avro object container file.");
+    }
+
+    // The metadata is a map of bytes.
+    std::map<std::string, std::string> metadata;
+    for (int64_t count = ReadLong(context); count != 0; count = ReadLong(context))
+    {
+      if (count < 0)
+      {
+        count = -count;
+        ReadLong(context);
+      }
+      for (int64_t i = 0; i < count; ++i)
+      {
+        std::string key = ReadString(context);
+        metadata[std::move(key)] = ReadString(context);
+      }
+    }
+    ReadBytes(m_syncMarker.data(), m_syncMarker.size(), context);
+
+    auto codec = metadata.find("avro.codec");
+    if (codec != metadata.end() && codec->second != "null")
+    {
+      throw std::runtime_error("Unsupported Avro codec " + codec->second + ".");
+    }
+    auto schema = metadata.find("avro.schema");
+    if (schema == metadata.end())
+    {
+      throw std::runtime_error("Avro object container file has no schema.");
+    }
+    m_schema = AvroSchemaParser(m_schemas).Parse(json::parse(schema->second), std::string());
+  }
+
+  bool AvroObjectContainerReader::FillBuffer(const Azure::Core::Context& context)
+  {
+    if (m_bufferOffset == m_bufferLength)
+    {
+      m_bufferOffset = 0;
+      m_bufferLength = m_stream->Read(m_buffer.data(), m_buffer.size(), context);
+    }
+    return m_bufferOffset != m_bufferLength;
+  }
+
+  uint8_t AvroObjectContainerReader::ReadByte(const Azure::Core::Context& context)
+  {
+    if (!FillBuffer(context))
+    {
+      throw std::runtime_error("Unexpected end of Avro data.");
+    }
+    return m_buffer[m_bufferOffset++];
+  }
+
+  void AvroObjectContainerReader::ReadBytes(
+      uint8_t* buffer,
+      size_t count,
+      const Azure::Core::Context& context)
+  {
+    while (count != 0)
+    {
+      if (!FillBuffer(context))
+      {
+        throw std::runtime_error("Unexpected end of Avro data.");
+      }
+      const size_t length = std::min(count, m_bufferLength - m_bufferOffset);
+      std::memcpy(buffer, m_buffer.data() + m_bufferOffset, length);
+      m_bufferOffset += length;
+      buffer += length;
+      count -= length;
+    }
+  }
+
+  int64_t AvroObjectContainerReader::ReadLong(const Azure::Core::Context& context)
+  {
+    // A zig-zag encoded variable-length integer.
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7)
+    {
+      if (shift >= 64)
+      {
+        throw std::runtime_error("Invalid Avro long.");
+      }
+      const uint8_t byte = ReadByte(context);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+      {
+        break;
+      }
+    }
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  std::string AvroObjectContainerReader::ReadString(const Azure::Core::Context& context)
+  {
+    const int64_t length = ReadLong(context);
+    if (length < 0)
+    {
+      throw std::runtime_error("Invalid Avro string.");
+    }
+    std::string value(static_cast<size_t>(length), '\0');
+    ReadBytes(reinterpret_cast<uint8_t*>(&value[0]), value.length(), context);
+    return value;
+  }
+
+  void AvroObjectContainerReader::ReadDatum(
+      const AvroSchema& schema,
+      AvroDatum& datum,
+      const Azure::Core::Context& context)
+  {
+    datum.Schema = &schema;
+    switch (schema.Type)
+    {
+      case AvroDatumType::Null:
+        break;
+      case AvroDatumType::Boolean:
+        datum.Boolean = ReadByte(context) != 0;
+        break;
+      case AvroDatumType::Int:
+      case AvroDatumType::Long:
+      case AvroDatumType::Enum:
+        datum.Long = ReadLong(context);
+        break;
+      case AvroDatumType::Float: {
+        uint8_t bytes[4];
+        ReadBytes(bytes, sizeof(bytes), context);
+        uint32_t bits = 0;
+        for (int i = 3; i >= 0; --i)
+        {
+          bits = (bits << 8) | bytes[i];
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        datum.Double = value;
+        break;
+      }
+      case AvroDatumType::Double: {
+        uint8_t bytes[8];
+        ReadBytes(bytes, sizeof(bytes), context);
+        uint64_t bits = 0;
+        for (int i = 7; i >= 0; --i)
+        {
+          bits = (bits << 8) | bytes[i];
+        }
+        std::memcpy(&datum.Double, &bits, sizeof(datum.Double));
+        break;
+      }
+      case AvroDatumType::Bytes:
+      case AvroDatumType::String:
+        datum.String = ReadString(context);
+        break;
+      case AvroDatumType::Fixed:
+        datum.String.resize(schema.Size);
+        ReadBytes(reinterpret_cast<uint8_t*>(&datum.String[0]), schema.Size, context);
+        break;
+      case AvroDatumType::Record:
+        datum.Items.resize(schema.Children.size());
+        for (size_t i = 0; i < schema.Children.size(); ++i)
+        {
+          ReadDatum(*schema.Children[i], datum.Items[i], context);
+        }
+        break;
+      case AvroDatumType::Array:
+      case AvroDatumType::Map:
+        // The items are written in blocks, a negative count is followed by the size of the block.
+        for (int64_t count = ReadLong(context); count != 0; count = ReadLong(context))
+        {
+          if (count < 0)
+          {
+            count = -count;
+            ReadLong(context);
+          }
+          for (int64_t i = 0; i < count; ++i)
+          {
+            if (schema.Type == AvroDatumType::Map)
+            {
+              datum.Keys.push_back(ReadString(context));
+            }
+            datum.Items.emplace_back();
+            ReadDatum(*schema.Children[0], datum.Items.back(), context);
+          }
+        }
+        break;
+      case AvroDatumType::Union: {
+        const int64_t branch = ReadLong(context);
+        if (branch < 0 || static_cast<size_t>(branch) >= schema.Children.size())
+        {
+          throw std::runtime_error("Invalid Avro union branch.");
+        }
+        ReadDatum(*schema.Children[static_cast<size_t>(branch)], datum, context);
+        break;
+      }
+    }
+  }
+
+}}}} // namespace Azure::Storage::Blobs::_detail
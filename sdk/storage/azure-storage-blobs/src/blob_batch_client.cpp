@@ -0,0 +1,425 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/blob_batch_client.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <azure/core/internal/diagnostics/span.hpp>
+#include <azure/core/http/policies/policy.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/core/uuid.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
+#include <azure/storage/common/internal/constants.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
+#include <azure/storage/common/internal/shared_key_policy.hpp>
+#include <azure/storage/common/internal/storage_per_retry_policy.hpp>
+#include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
+#include <azure/storage/common/storage_common.hpp>
+#include <azure/storage/common/storage_exception.hpp>
+
+#include "private/package_version.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    constexpr int32_t MaxBatchOperations = 256;
+    constexpr const char* BatchBoundaryPrefix = "batch_";
+    constexpr const char* LineFeed = "\r\n";
+
+    // Ends the pipeline signing the operations of a batch: the signed request is kept, and isn't
+    // sent on its own.
+    class SignOnlyTransportPolicy final : public Azure::Core::Http::Policies::HttpPolicy {
+    public:
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<SignOnlyTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+          Azure::Core::Http::Request&,
+          Azure::Core::Http::Policies::NextHttpPolicy,
+          const Azure::Core::Context&) const override
+      {
+        return std::make_unique<Azure::Core::Http::RawResponse>(
+            1, 1, Azure::Core::Http::HttpStatusCode::Accepted, "Accepted");
+      }
+    };
+
+    std::string GetLine(const std::string& text, size_t& position)
+    {
+      auto end = text.find(LineFeed, position);
+      if (end == std::string::npos)
+      {
+        end = text.length();
+      }
+      std::string line = text.substr(position, end - position);
+      position = std::min(end + 2, text.length());
+      return line;
+    }
+
+    // Parses the headers of a part until the empty line ending them.
+    Azure::Core::CaseInsensitiveMap ParseHeaders(const std::string& text, size_t& position)
+    {
+      Azure::Core::CaseInsensitiveMap headers;
+      while (position < text.length())
+      {
+        const std::string line = GetLine(text, position);
+        if (line.empty())
+        {
+          break;
+        }
+        const auto colon = line.find(':');
+        if (colon == std::string::npos)
+        {
+          continue;
+        }
+        const auto valueStart = line.find_first_not_of(' ', colon + 1);
+        headers[line.substr(0, colon)]
+            = valueStart == std::string::npos ? std::string() : line.substr(valueStart);
+      }
+      return headers;
+    }
+
+    Models::BlobBatchOperationResult ParseOperationResult(const std::string& part)
+    {
+      size_t position = 0;
+      // The MIME headers of the part, then the HTTP response of the operation.
+      ParseHeaders(part, position);
+      const std::string statusLine = GetLine(part, position);
+      const auto statusStart = statusLine.find(' ');
+      if (statusStart == std::string::npos)
+      {
+        throw std::runtime_error("Failed to parse the response of the blob batch.");
+      }
+      const auto reasonStart = statusLine.find(' ', statusStart + 1);
+      const auto statusCode = static_cast<Azure::Core::Http::HttpStatusCode>(
+          std::atoi(statusLine.substr(statusStart + 1, reasonStart - statusStart - 1).c_str()));
+      const std::string reasonPhrase
+          = reasonStart == std::string::npos ? std::string() : statusLine.substr(reasonStart + 1);
+
+      auto response = std::make_unique<Azure::Core::Http::RawResponse>(
+          1, 1, statusCode, reasonPhrase);
+      for (const auto& header : ParseHeaders(part, position))
+      {
+        response->SetHeader(header.first, header.second);
+      }
+
+      Models::BlobBatchOperationResult result;
+      result.StatusCode = statusCode;
+      const auto requestId = response->GetHeaders().find(_internal::HttpHeaderRequestId);
+      if (requestId != response->GetHeaders().end())
+      {
+        result.RequestId = requestId->second;
+      }
+      if (static_cast<int>(statusCode) >= 300)
+      {
+        response->SetBody(std::vector<uint8_t>(part.begin() + position, part.end()));
+        auto exception = StorageException::CreateFromResponse(std::move(response));
+        result.ErrorCode = std::move(exception.ErrorCode);
+        result.Message = std::move(exception.Message);
+      }
+      return result;
+    }
+
+    // Splits the multipart/mixed response of a batch into the results of its operations.
+    std::vector<Models::BlobBatchOperationResult> ParseBatchResponse(
+        const std::string& contentType,
+        const std::vector<uint8_t>& body,
+        size_t operationCount)
+    {
+      const auto boundaryStart = contentType.find("boundary=");
+      if (boundaryStart == std::string::npos)
+      {
+        throw std::runtime_error("Failed to parse the response of the blob batch.");
+      }
+      const std::string delimiter
+          = "--" + contentType.substr(boundaryStart + std::string("boundary=").length());
+      const std::string text(body.begin(), body.end());
+
+      std::vector<Models::BlobBatchOperationResult> results(operationCount);
+      size_t partIndex = 0;
+      auto partStart = text.find(delimiter);
+      while (partStart != std::string::npos)
+      {
+        partStart += delimiter.length();
+        if (text.compare(partStart, 2, "--") == 0)
+        {
+          break;
+        }
+        partStart = std::min(partStart + 2, text.length());
+        const auto partEnd = text.find(delimiter, partStart);
+        const std::string part = text.substr(
+            partStart, (partEnd == std::string::npos ? text.length() : partEnd) - partStart);
+
+        size_t position = 0;
+        const auto partHeaders = ParseHeaders(part, position);
+        // The service may not return the parts in order, their ID is the index of the operation.
+        size_t operationIndex = partIndex;
+        const auto contentId = partHeaders.find("Content-ID");
+        if (contentId != partHeaders.end())
+        {
+          operationIndex
+              = static_cast<size_t>(std::strtoul(contentId->second.c_str(), nullptr, 10));
+        }
+        if (operationIndex < results.size())
+        {
+          results[operationIndex] = ParseOperationResult(part);
+        }
+        ++partIndex;
+        partStart = partEnd;
+      }
+      return results;
+    }
+  } // namespace
+
+  Azure::Core::Url BlobBatch::GetBlobUrl(
+      const std::string& blobContainerName,
+      const std::string& blobName) const
+  {
+    auto blobUrl = m_serviceUrl;
+    blobUrl.AppendPath(_internal::UrlEncodePath(blobContainerName));
+    blobUrl.AppendPath(_internal::UrlEncodePath(blobName));
+    return blobUrl;
+  }
+
+  int32_t BlobBatch::AddSubRequest(
+      OperationType operationType,
+      Azure::Core::Http::Request subRequest)
+  {
+    if (m_operationType != OperationType::None && m_operationType != operationType)
+    {
+      throw std::invalid_argument("A blob batch cannot mix different types of operations.");
+    }
+    if (GetOperationCount() >= MaxBatchOperations)
+    {
+      throw std::invalid_argument(
+          "A blob batch cannot have more than " + std::to_string(MaxBatchOperations)
+          + " operations.");
+    }
+    m_operationType = operationType;
+    m_subRequests.push_back(std::move(subRequest));
+    return GetOperationCount() - 1;
+  }
+
+  int32_t BlobBatch::DeleteBlob(
+      const std::string& blobContainerName,
+      const std::string& blobName,
+      const DeleteBlobOptions& options)
+  {
+    _detail::BlobRestClient::Blob::DeleteBlobOptions protocolLayerOptions;
+    protocolLayerOptions.DeleteSnapshots = options.DeleteSnapshots;
+    protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+    protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
+    protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
+    protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
+    protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+    protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
+    return AddSubRequest(
+        OperationType::Delete,
+        _detail::BlobRestClient::Blob::DeleteCreateMessage(
+            GetBlobUrl(blobContainerName, blobName), protocolLayerOptions));
+  }
+
+  int32_t BlobBatch::SetBlobAccessTier(
+      const std::string& blobContainerName,
+      const std::string& blobName,
+      Models::AccessTier tier,
+      const SetBlobAccessTierOptions& options)
+  {
+    _detail::BlobRestClient::Blob::SetBlobAccessTierOptions protocolLayerOptions;
+    protocolLayerOptions.AccessTier = tier;
+    protocolLayerOptions.RehydratePriority = options.RehydratePriority;
+    protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+    protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
+    return AddSubRequest(
+        OperationType::SetAccessTier,
+        _detail::BlobRestClient::Blob::SetAccessTierCreateMessage(
+            GetBlobUrl(blobContainerName, blobName), protocolLayerOptions));
+  }
+
+  BlobBatchClient BlobBatchClient::CreateFromConnectionString(
+      const std::string& connectionString,
+      const BlobClientOptions& options)
+  {
+    auto parsedConnectionString = _internal::ParseConnectionString(connectionString);
+    auto serviceUrl = std::move(parsedConnectionString.BlobServiceUrl);
+
+    if (parsedConnectionString.KeyCredential)
+    {
+      return BlobBatchClient(
+          serviceUrl.GetAbsoluteUrl(), parsedConnectionString.KeyCredential, options);
+    }
+    else
+    {
+      return BlobBatchClient(serviceUrl.GetAbsoluteUrl(), options);
+    }
+  }
+
+  BlobBatchClient::BlobBatchClient(
+      const std::string& serviceUrl,
+      std::shared_ptr<StorageSharedKeyCredential> credential,
+      const BlobClientOptions& options)
+      : BlobBatchClient(
+          serviceUrl,
+          std::make_unique<_internal::SharedKeyPolicy>(credential),
+          options)
+  {
+  }
+
+  BlobBatchClient::BlobBatchClient(
+      const std::string& serviceUrl,
+      std::shared_ptr<Core::Credentials::TokenCredential> credential,
+      const BlobClientOptions& options)
+      : BlobBatchClient(
+          serviceUrl,
+          [&credential]() {
+            Azure::Core::Credentials::TokenRequestContext tokenContext;
+            tokenContext.Scopes.emplace_back(_internal::StorageScope);
+            return std::make_unique<
+                Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
+                credential, tokenContext);
+          }(),
+          options)
+  {
+  }
+
+  BlobBatchClient::BlobBatchClient(const std::string& serviceUrl, const BlobClientOptions& options)
+      : BlobBatchClient(
+          serviceUrl, std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>(), options)
+  {
+  }
+
+  BlobBatchClient::BlobBatchClient(
+      const std::string& serviceUrl,
+      std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> authenticationPolicy,
+      const BlobClientOptions& options)
+      : m_serviceUrl(serviceUrl), m_transferExecutor(options.TransferExecutor)
+  {
+    // The operations are signed like the requests they would be on their own, the service
+    // checks them one by one.
+    std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> subRequestPolicies;
+    subRequestPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
+    if (authenticationPolicy)
+    {
+      subRequestPolicies.emplace_back(authenticationPolicy->Clone());
+    }
+    subRequestPolicies.emplace_back(std::make_unique<SignOnlyTransportPolicy>());
+    m_subRequestPipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
+        std::move(subRequestPolicies));
+
+    std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
+    std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
+    perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
+        m_serviceUrl.GetHost(),
+        options.SecondaryHostForRetryReads,
+        options.SecondaryReadBalancer));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
+    perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
+    if (authenticationPolicy)
+    {
+      perRetryPolicies.emplace_back(std::move(authenticationPolicy));
+    }
+    m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
+        options,
+        _internal::BlobServicePackageName,
+        _detail::PackageVersion::ToString(),
+        std::move(perRetryPolicies),
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
+  }
+
+  Azure::Response<Models::SubmitBlobBatchResult> BlobBatchClient::SubmitBatch(
+      const BlobBatch& batch,
+      const SubmitBlobBatchOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    if (batch.m_subRequests.empty())
+    {
+      throw std::invalid_argument("A blob batch must have at least one operation.");
+    }
+    Azure::Core::Diagnostics::_internal::Span span("BlobBatchClient.SubmitBatch", context);
+    (void)options;
+
+    const std::string boundary = BatchBoundaryPrefix + Azure::Core::Uuid::CreateUuid().ToString();
+    std::string body;
+    for (size_t i = 0; i < batch.m_subRequests.size(); ++i)
+    {
+      // The operations are signed now, so that their date is the date the batch is sent.
+      auto subRequest = batch.m_subRequests[i];
+      subRequest.SetHeader("Content-Length", "0");
+      m_subRequestPipeline->Send(subRequest, span.GetContext());
+
+      body += "--" + boundary + LineFeed;
+      body += std::string("Content-Type: application/http") + LineFeed;
+      body += std::string("Content-Transfer-Encoding: binary") + LineFeed;
+      body += "Content-ID: " + std::to_string(i) + LineFeed;
+      body += LineFeed;
+      body += subRequest.GetMethod().ToString() + " /" + subRequest.GetUrl().GetRelativeUrl()
+          + " HTTP/1.1" + LineFeed;
+      for (const auto& header : subRequest.GetHeaders())
+      {
+        body += header.first + ": " + header.second + LineFeed;
+      }
+      body += LineFeed;
+    }
+    body += "--" + boundary + "--" + LineFeed;
+
+    Azure::Core::IO::MemoryBodyStream bodyStream(
+        reinterpret_cast<const uint8_t*>(body.data()), body.length());
+    _detail::BlobRestClient::BlobBatch::SubmitBlobBatchOptions protocolLayerOptions;
+    protocolLayerOptions.ContentType = "multipart/mixed; boundary=" + boundary;
+    auto response = _detail::BlobRestClient::BlobBatch::SubmitBatch(
+        *m_pipeline, m_serviceUrl, bodyStream, protocolLayerOptions, span.GetContext());
+
+    Models::SubmitBlobBatchResult ret;
+    ret.OperationResults = ParseBatchResponse(
+        response.Value.ContentType,
+        response.RawResponse->GetBody(),
+        batch.m_subRequests.size());
+    return Azure::Response<Models::SubmitBlobBatchResult>(
+        std::move(ret), std::move(response.RawResponse));
+  }
+
+  std::vector<Models::SubmitBlobBatchResult> BlobBatchClient::SubmitBatches(
+      const std::vector<BlobBatch>& batches,
+      const SubmitBlobBatchesOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    std::vector<Models::SubmitBlobBatchResult> results(batches.size());
+    if (batches.empty())
+    {
+      return results;
+    }
+    Azure::Core::Diagnostics::_internal::Span span("BlobBatchClient.SubmitBatches", context);
+
+    // Each batch is a chunk of length one.
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.Concurrency;
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(batches.size()),
+        transferOptions,
+        [&](int64_t offset, int64_t, int64_t) {
+          const auto i = static_cast<size_t>(offset);
+          results[i]
+              = SubmitBatch(batches[i], SubmitBlobBatchOptions(), span.GetContext()).Value;
+        },
+        m_transferExecutor);
+    return results;
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -0,0 +1,341 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/blob_change_feed_client.hpp"
+
+#include <azure/core/internal/json/json.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+
+#include "private/avro_parser.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    using Azure::Core::Json::_internal::json;
+
+    constexpr const char* ChangeFeedContainerName = "$blobchangefeed";
+    constexpr const char* SegmentsMetaBlobName = "meta/segments.json";
+    constexpr const char* SegmentsPrefix = "idx/segments/";
+    constexpr const char* SegmentMetaSuffix = "/meta.json";
+    constexpr const char* FinalizedStatus = "Finalized";
+    constexpr int CursorVersion = 1;
+    constexpr size_t MaxEventsPerPage = 1000;
+
+    // Where the read of a shard is, the events read from a chunk of the shard.
+    struct ShardCursor final
+    {
+      std::string ChunkName;
+      int64_t EventCount = 0;
+    };
+
+    // Where the read of the change feed is. Once a finalized segment is read entirely, the shards
+    // of the segment are dropped, and the segment is skipped by the reads resumed from the cursor.
+    struct ChangeFeedCursor final
+    {
+      std::string SegmentName;
+      bool IsSegmentDone = false;
+      std::map<std::string, ShardCursor> Shards;
+    };
+
+    std::string SerializeCursor(const ChangeFeedCursor& cursor)
+    {
+      json cursorJson;
+      cursorJson["version"] = CursorVersion;
+      cursorJson["segment"] = cursor.SegmentName;
+      cursorJson["segmentDone"] = cursor.IsSegmentDone;
+      cursorJson["shards"] = json::object();
+      for (const auto& shard : cursor.Shards)
+      {
+        cursorJson["shards"][shard.first]
+            = {{"chunk", shard.second.ChunkName}, {"events", shard.second.EventCount}};
+      }
+      return cursorJson.dump();
+    }
+
+    ChangeFeedCursor ParseCursor(const std::string& cursorString)
+    {
+      ChangeFeedCursor cursor;
+      try
+      {
+        const json cursorJson = json::parse(cursorString);
+        if (cursorJson.at("version").get<int>() != CursorVersion)
+        {
+          throw std::invalid_argument("The version of the change feed cursor isn't supported.");
+        }
+        cursor.SegmentName = cursorJson.at("segment").get<std::string>();
+        cursor.IsSegmentDone = cursorJson.at("segmentDone").get<bool>();
+        for (const auto& shard : cursorJson.at("shards").items())
+        {
+          auto& shardCursor = cursor.Shards[shard.key()];
+          shardCursor.ChunkName = shard.value().at("chunk").get<std::string>();
+          shardCursor.EventCount = shard.value().at("events").get<int64_t>();
+        }
+      }
+      catch (json::exception&)
+      {
+        throw std::invalid_argument("The change feed cursor isn't valid.");
+      }
+      return cursor;
+    }
+
+    json DownloadJson(
+        const BlobContainerClient& containerClient,
+        const std::string& blobName,
+        const Azure::Core::Context& context)
+    {
+      auto response
+          = containerClient.GetBlobClient(blobName).Download(DownloadBlobOptions(), context);
+      const auto content = response.Value.BodyStream->ReadToEnd(context);
+      return json::parse(content.begin(), content.end());
+    }
+
+    std::vector<std::string> ListBlobNames(
+        const BlobContainerClient& containerClient,
+        const std::string& prefix,
+        const Azure::Core::Context& context)
+    {
+      std::vector<std::string> blobNames;
+      ListBlobsOptions listOptions;
+      listOptions.Prefix = prefix;
+      for (auto page = containerClient.ListBlobs(listOptions, context); page.HasPage();
+           page.MoveToNextPage(context))
+      {
+        for (auto& blob : page.Blobs)
+        {
+          blobNames.push_back(std::move(blob.Name));
+        }
+      }
+      std::sort(blobNames.begin(), blobNames.end());
+      return blobNames;
+    }
+
+    // The start of a segment, from its name like idx/segments/2019/02/22/1800/meta.json.
+    Azure::DateTime GetSegmentTime(const std::string& segmentName)
+    {
+      const std::string time = segmentName.substr(std::char_traits<char>::length(SegmentsPrefix));
+      return Azure::DateTime(
+          static_cast<int16_t>(std::stoi(time.substr(0, 4))),
+          static_cast<int8_t>(std::stoi(time.substr(5, 2))),
+          static_cast<int8_t>(std::stoi(time.substr(8, 2))),
+          static_cast<int8_t>(std::stoi(time.substr(11, 2))),
+          static_cast<int8_t>(std::stoi(time.substr(13, 2))));
+    }
+
+    // Gets a field of a record, or null if the record has no such field or if it's null.
+    const _detail::AvroDatum* FindField(const _detail::AvroDatum& record, const char* name)
+    {
+      const auto& fieldNames = record.Schema->FieldNames;
+      const auto field = std::find(fieldNames.begin(), fieldNames.end(), name);
+      if (field == fieldNames.end())
+      {
+        return nullptr;
+      }
+      const auto& datum = record.Items[static_cast<size_t>(field - fieldNames.begin())];
+      return datum.Schema->Type == _detail::AvroDatumType::Null ? nullptr : &datum;
+    }
+
+    std::string GetString(const _detail::AvroDatum& record, const char* name)
+    {
+      const auto field = FindField(record, name);
+      return field ? field->String : std::string();
+    }
+
+    Models::BlobChangeFeedEvent ParseEvent(const _detail::AvroDatum& record)
+    {
+      Models::BlobChangeFeedEvent event;
+      event.Topic = GetString(record, "topic");
+      event.Subject = GetString(record, "subject");
+      event.EventType = GetString(record, "eventType");
+      event.EventTime = Azure::DateTime::Parse(
+          GetString(record, "eventTime"), Azure::DateTime::DateFormat::Rfc3339);
+      event.Id = GetString(record, "id");
+      const auto data = FindField(record, "data");
+      if (data && data->Schema->Type == _detail::AvroDatumType::Record)
+      {
+        event.Data.Api = GetString(*data, "api");
+        event.Data.ClientRequestId = GetString(*data, "clientRequestId");
+        event.Data.RequestId = GetString(*data, "requestId");
+        event.Data.ETag = Azure::ETag(GetString(*data, "etag"));
+        event.Data.ContentType = GetString(*data, "contentType");
+        const auto contentLength = FindField(*data, "contentLength");
+        event.Data.ContentLength = contentLength ? contentLength->Long : 0;
+        event.Data.BlobType = Models::BlobType(GetString(*data, "blobType"));
+        event.Data.Url = GetString(*data, "url");
+        event.Data.Sequencer = GetString(*data, "sequencer");
+      }
+      return event;
+    }
+  } // namespace
+
+  BlobChangeFeedClient::BlobChangeFeedClient(const BlobServiceClient& serviceClient)
+      : m_containerClient(serviceClient.GetBlobContainerClient(ChangeFeedContainerName))
+  {
+  }
+
+  std::string BlobChangeFeedClient::ReadEvents(
+      const std::function<void(std::vector<Models::BlobChangeFeedEvent>, const std::string&)>&
+          onEvents,
+      const ReadBlobChangeFeedOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    ChangeFeedCursor cursor;
+    if (!options.Cursor.empty())
+    {
+      cursor = ParseCursor(options.Cursor);
+    }
+    const auto lastConsumable = Azure::DateTime::Parse(
+        DownloadJson(m_containerClient, SegmentsMetaBlobName, context)
+            .at("lastConsumable")
+            .get<std::string>(),
+        Azure::DateTime::DateFormat::Rfc3339);
+
+    std::vector<std::string> segmentNames;
+    for (auto& blobName : ListBlobNames(m_containerClient, SegmentsPrefix, context))
+    {
+      if (blobName.length() > std::char_traits<char>::length(SegmentMetaSuffix)
+          && blobName.compare(
+                 blobName.length() - std::char_traits<char>::length(SegmentMetaSuffix),
+                 std::string::npos,
+                 SegmentMetaSuffix)
+              == 0
+          && blobName >= cursor.SegmentName
+          && !(cursor.IsSegmentDone && blobName == cursor.SegmentName))
+      {
+        segmentNames.push_back(std::move(blobName));
+      }
+    }
+
+    std::mutex cursorMutex;
+    for (size_t i = 0; i < segmentNames.size(); ++i)
+    {
+      const std::string& segmentName = segmentNames[i];
+      const auto segmentTime = GetSegmentTime(segmentName);
+      if (segmentTime >= lastConsumable
+          || (options.EndsOn.HasValue() && segmentTime >= options.EndsOn.Value()))
+      {
+        break;
+      }
+      // The segments ending before the start time are skipped.
+      if (options.Cursor.empty() && options.StartsOn.HasValue() && i + 1 < segmentNames.size()
+          && GetSegmentTime(segmentNames[i + 1]) <= options.StartsOn.Value())
+      {
+        continue;
+      }
+
+      const json segment = DownloadJson(m_containerClient, segmentName, context);
+      std::vector<std::string> shardNames;
+      for (const auto& chunkFilePath : segment.at("chunkFilePaths"))
+      {
+        std::string shardName = chunkFilePath.get<std::string>();
+        const std::string containerPrefix = std::string(ChangeFeedContainerName) + "/";
+        if (shardName.compare(0, containerPrefix.length(), containerPrefix) == 0)
+        {
+          shardName = shardName.substr(containerPrefix.length());
+        }
+        shardNames.push_back(std::move(shardName));
+      }
+      if (segmentName != cursor.SegmentName)
+      {
+        cursor.SegmentName = segmentName;
+        cursor.Shards.clear();
+      }
+      cursor.IsSegmentDone = false;
+
+      auto readShard = [&](int64_t offset, int64_t, int64_t) {
+        const std::string& shardName = shardNames[static_cast<size_t>(offset)];
+        ShardCursor shardCursor;
+        {
+          std::lock_guard<std::mutex> guard(cursorMutex);
+          auto shard = cursor.Shards.find(shardName);
+          if (shard != cursor.Shards.end())
+          {
+            shardCursor = shard->second;
+          }
+        }
+        // Passes the events read so far, and moves the cursor of the shard after them once they
+        // are handled.
+        std::vector<Models::BlobChangeFeedEvent> page;
+        auto passPage = [&]() {
+          std::string pageCursor;
+          {
+            std::lock_guard<std::mutex> guard(cursorMutex);
+            ChangeFeedCursor nextCursor = cursor;
+            nextCursor.Shards[shardName] = shardCursor;
+            pageCursor = SerializeCursor(nextCursor);
+          }
+          if (!page.empty())
+          {
+            onEvents(std::move(page), pageCursor);
+            page.clear();
+          }
+          std::lock_guard<std::mutex> guard(cursorMutex);
+          cursor.Shards[shardName] = shardCursor;
+        };
+
+        for (const auto& chunkName : ListBlobNames(m_containerClient, shardName, context))
+        {
+          if (chunkName < shardCursor.ChunkName)
+          {
+            continue;
+          }
+          int64_t skippedEvents = 0;
+          if (chunkName == shardCursor.ChunkName)
+          {
+            skippedEvents = shardCursor.EventCount;
+          }
+          shardCursor.ChunkName = chunkName;
+          shardCursor.EventCount = 0;
+          _detail::AvroObjectContainerReader reader(
+              m_containerClient.GetBlobClient(chunkName)
+                  .Download(DownloadBlobOptions(), context)
+                  .Value.BodyStream);
+          _detail::AvroDatum record;
+          while (reader.Next(record, context))
+          {
+            if (shardCursor.EventCount++ < skippedEvents)
+            {
+              continue;
+            }
+            auto event = ParseEvent(record);
+            if ((options.Cursor.empty() && options.StartsOn.HasValue()
+                 && event.EventTime < options.StartsOn.Value())
+                || (options.EndsOn.HasValue() && event.EventTime >= options.EndsOn.Value()))
+            {
+              continue;
+            }
+            page.push_back(std::move(event));
+            if (page.size() == MaxEventsPerPage)
+            {
+              passPage();
+            }
+          }
+          passPage();
+        }
+      };
+      if (!shardNames.empty())
+      {
+        _internal::ConcurrentTransferOptions transferOptions;
+        transferOptions.ChunkSize = 1;
+        transferOptions.Concurrency = options.Concurrency;
+        _internal::ConcurrentTransfer(
+            0, static_cast<int64_t>(shardNames.size()), transferOptions, readShard, nullptr);
+      }
+
+      // Events may still be added to the shards of a segment which isn't finalized, it's read
+      // again from the cursor next time.
+      if (segment.at("status").get<std::string>() != FinalizedStatus)
+      {
+        break;
+      }
+      cursor.IsSegmentDone = true;
+      cursor.Shards.clear();
+    }
+    return SerializeCursor(cursor);
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -5,26 +5,584 @@
 
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/core/internal/azure_assert.hpp>
+#include <azure/core/internal/diagnostics/span.hpp>
+#include <azure/storage/common/crypt.hpp>
 #include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
 #include <azure/storage/common/internal/constants.hpp>
 #include <azure/storage/common/internal/file_io.hpp>
+#include <azure/storage/common/internal/hashing_stream.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/reliable_stream.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
+#include <azure/storage/common/internal/transfer_progress.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
 #include "azure/storage/blobs/append_blob_client.hpp"
 #include "azure/storage/blobs/block_blob_client.hpp"
 #include "azure/storage/blobs/page_blob_client.hpp"
 
+#include "private/blob_compression.hpp"
+#include "private/blob_download_cache_policy.hpp"
+#include "private/client_side_encryptor.hpp"
 #include "private/package_version.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
 
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    // The service only returns the hash of ranges of up to 4 MiB.
+    constexpr int64_t MaxRangeHashLength = 4 * 1024 * 1024;
+
+    // Downloads the first chunk of a DownloadTo(). When the first chunk of a blob without a range
+    // is requested with a range, such as to validate its CRC64, an empty blob doesn't have it.
+    Azure::Response<Models::DownloadBlobResult> DownloadFirstChunk(
+        const BlobClient& client,
+        DownloadBlobOptions& firstChunkOptions,
+        const DownloadBlobToOptions& options,
+        const Azure::Core::Context& context)
+    {
+      try
+      {
+        return client.Download(firstChunkOptions, context);
+      }
+      catch (StorageException& e)
+      {
+        if (!firstChunkOptions.Range.HasValue() || options.Range.HasValue()
+            || e.StatusCode != Core::Http::HttpStatusCode::RangeNotSatisfiable)
+        {
+          throw;
+        }
+      }
+      firstChunkOptions.Range.Reset();
+      firstChunkOptions.RangeHashAlgorithm.Reset();
+      return client.Download(firstChunkOptions, context);
+    }
+
+    // Reads the body of a downloaded chunk with readBody, adding the data read to progress. When
+    // crc64 isn't null, the data is appended to it while it is read, then it is finalized and
+    // compared with the CRC64 returned by the service.
+    template <class ReadBody>
+    void ReadChunk(
+        Models::DownloadBlobResult& chunk,
+        Crc64Hash* crc64,
+        _internal::TransferProgress& progress,
+        ReadBody readBody)
+    {
+      auto readWithProgress = [&progress, &readBody](Azure::Core::IO::BodyStream& bodyStream) {
+        if (!progress.IsEnabled())
+        {
+          readBody(bodyStream);
+          return;
+        }
+        _internal::TransferProgressStream progressStream(bodyStream, progress);
+        readBody(progressStream);
+      };
+      if (crc64 == nullptr)
+      {
+        readWithProgress(*chunk.BodyStream);
+        return;
+      }
+
+      _internal::HashingStream hashingStream(*chunk.BodyStream, *crc64);
+      readWithProgress(hashingStream);
+      if (chunk.BlobSize == 0 && !chunk.TransactionalContentHash.HasValue())
+      {
+        // An empty blob is downloaded without a range, so the service doesn't return its CRC64.
+        return;
+      }
+      if (!chunk.TransactionalContentHash.HasValue()
+          || chunk.TransactionalContentHash.Value().Algorithm != HashAlgorithm::Crc64
+          || crc64->Final() != chunk.TransactionalContentHash.Value().Value)
+      {
+        throw Azure::Core::RequestFailedException(
+            "CRC64 of the downloaded data doesn't match the one returned by the service.");
+      }
+    }
+
+    // Combines the CRC64 of the chunks, in order.
+    ContentHash ConcatenateCrc64(
+        const Crc64Hash& firstChunkCrc64,
+        const std::map<int64_t, Crc64Hash>& chunks)
+    {
+      Crc64Hash crc64;
+      crc64.Concatenate(firstChunkCrc64);
+      for (const auto& chunkCrc64 : chunks)
+      {
+        crc64.Concatenate(chunkCrc64.second);
+      }
+      ContentHash hash;
+      hash.Algorithm = HashAlgorithm::Crc64;
+      hash.Value = crc64.Final();
+      return hash;
+    }
+
+    // The compression of a blob compressed by BlockBlobClient::UploadFrom(), read from its
+    // metadata.
+    struct BlobCompression final
+    {
+      int64_t BlockSize = 0;
+      int64_t UncompressedSize = 0;
+    };
+
+    // Returns true if a DownloadTo() with options decompresses the blob whose first chunk is
+    // downloaded, in which case compression is set.
+    bool GetBlobCompression(
+        const Models::DownloadBlobResult& firstChunk,
+        const DownloadBlobToOptions& options,
+        BlobCompression& compression)
+    {
+      const auto& metadata = firstChunk.Details.Metadata;
+      auto codec = metadata.find(_detail::CompressionCodecMetadataName);
+      if (!options.DecompressContent || options.Range.HasValue() || codec == metadata.end())
+      {
+        return false;
+      }
+      if (codec->second != Models::BlobCompressionCodec::Gzip.ToString())
+      {
+        throw Azure::Core::RequestFailedException(
+            "The blob is compressed with unsupported codec " + codec->second + ".");
+      }
+      auto blockSize = metadata.find(_detail::CompressionBlockSizeMetadataName);
+      auto uncompressedSize = metadata.find(_detail::UncompressedSizeMetadataName);
+      if (blockSize != metadata.end() && uncompressedSize != metadata.end())
+      {
+        compression.BlockSize = std::stoll(blockSize->second);
+        compression.UncompressedSize = std::stoll(uncompressedSize->second);
+      }
+      if (compression.BlockSize <= 0 || compression.UncompressedSize < 0)
+      {
+        throw Azure::Core::RequestFailedException(
+            "The compression metadata of the blob is invalid.");
+      }
+      return true;
+    }
+
+    // Downloads the blocks of a blob compressed by BlockBlobClient::UploadFrom() and decompresses
+    // them, each by the thread downloading it. The blocks wholly in the first chunk, whose
+    // firstChunkLength bytes are already received, are decompressed first. The content is
+    // decompressed in output, or written with fileWriter if output is null.
+    void DownloadCompressedBlocks(
+        const BlobClient& client,
+        Azure::Core::Http::_internal::HttpPipeline& pipeline,
+        const Azure::Core::Url& blobUrl,
+        Models::DownloadBlobResult& firstChunk,
+        int64_t firstChunkLength,
+        const BlobCompression& compression,
+        const DownloadBlobToOptions& options,
+        uint8_t* output,
+        _internal::FileWriter* fileWriter,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      // The committed blocks are the compressed streams, in order.
+      auto blockList = _detail::BlobRestClient::BlockBlob::GetBlockList(
+          pipeline,
+          blobUrl,
+          _detail::BlobRestClient::BlockBlob::GetBlockListOptions(),
+          context);
+      const Azure::ETag eTag = firstChunk.Details.ETag;
+      if (blockList.Value.ETag != eTag)
+      {
+        throw Azure::Core::RequestFailedException(
+            "The blob was modified while it was downloaded.");
+      }
+      const auto& blocks = blockList.Value.CommittedBlocks;
+      std::vector<int64_t> blockOffsets(blocks.size() + 1, 0);
+      for (size_t i = 0; i < blocks.size(); ++i)
+      {
+        blockOffsets[i + 1] = blockOffsets[i] + blocks[i].Size;
+      }
+      const int64_t numBlocks
+          = (compression.UncompressedSize + compression.BlockSize - 1) / compression.BlockSize;
+      if (static_cast<int64_t>(blocks.size()) != numBlocks
+          || blockOffsets.back() != firstChunk.BlobSize)
+      {
+        throw Azure::Core::RequestFailedException(
+            "The blocks of the blob don't match its compression metadata.");
+      }
+
+      auto decompressBlock = [&](size_t blockIndex, Azure::Core::IO::BodyStream& bodyStream) {
+        const size_t compressedLength = static_cast<size_t>(blocks[blockIndex].Size);
+        std::vector<uint8_t> compressed(compressedLength);
+        if (bodyStream.ReadToCount(compressed.data(), compressedLength, context)
+            != compressedLength)
+        {
+          throw Azure::Core::RequestFailedException("Error when reading body stream.");
+        }
+        const int64_t offset = static_cast<int64_t>(blockIndex) * compression.BlockSize;
+        const size_t length = static_cast<size_t>(
+            std::min(compression.BlockSize, compression.UncompressedSize - offset));
+        if (output != nullptr)
+        {
+          _detail::GzipDecompress(
+              compressed.data(), compressedLength, output + offset, length);
+          return;
+        }
+        std::vector<uint8_t> content(length);
+        _detail::GzipDecompress(compressed.data(), compressedLength, content.data(), length);
+        fileWriter->Write(content.data(), length, offset);
+      };
+
+      size_t firstRemainingBlock = 0;
+      while (firstRemainingBlock < blocks.size()
+             && blockOffsets[firstRemainingBlock + 1] <= firstChunkLength)
+      {
+        decompressBlock(firstRemainingBlock, *firstChunk.BodyStream);
+        ++firstRemainingBlock;
+      }
+      firstChunk.BodyStream.reset();
+
+      auto downloadBlockFunc = [&](int64_t blockIndex, int64_t, int64_t) {
+        const size_t index = static_cast<size_t>(blockIndex);
+        DownloadBlobOptions blockOptions;
+        blockOptions.Range = Core::Http::HttpRange();
+        blockOptions.Range.Value().Offset = blockOffsets[index];
+        blockOptions.Range.Value().Length = blocks[index].Size;
+        blockOptions.AccessConditions.IfMatch = eTag;
+        auto block = client.Download(blockOptions, context);
+        decompressBlock(index, *block.Value.BodyStream);
+      };
+      // Each block is a chunk of the transfer.
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = 1;
+      transferOptions.Concurrency = options.TransferOptions.Concurrency;
+      _internal::ConcurrentTransfer(
+          static_cast<int64_t>(firstRemainingBlock),
+          numBlocks - static_cast<int64_t>(firstRemainingBlock),
+          transferOptions,
+          downloadBlockFunc,
+          transferExecutor);
+    }
+
+    // Gets the result of a DownloadTo() which decompressed the blob.
+    Azure::Response<Models::DownloadBlobToResult> GetDecompressedDownloadResult(
+        Azure::Response<Models::DownloadBlobResult>& firstChunk,
+        const BlobCompression& compression)
+    {
+      Models::DownloadBlobToResult ret;
+      ret.BlobType = std::move(firstChunk.Value.BlobType);
+      ret.ContentRange.Offset = 0;
+      ret.ContentRange.Length = compression.UncompressedSize;
+      ret.BlobSize = compression.UncompressedSize;
+      ret.Details = std::move(firstChunk.Value.Details);
+      return Azure::Response<Models::DownloadBlobToResult>(
+          std::move(ret), std::move(firstChunk.RawResponse));
+    }
+
+    // Downloads the range of a blob encrypted by BlockBlobClient::UploadFrom() and decrypts it,
+    // each region by the thread downloading it. getOutput is called with the size of the
+    // decrypted range and returns where it's decrypted, or null if it's written with fileWriter.
+    template <class GetOutput>
+    Azure::Response<Models::DownloadBlobToResult> DownloadEncryptedRegions(
+        const BlobClient& client,
+        const Models::BlobProperties& properties,
+        const DownloadBlobToOptions& options,
+        GetOutput getOutput,
+        _internal::FileWriter* fileWriter,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      const auto key = _detail::ClientSideEncryptor::GetDownloadKey(
+          *options.ClientSideEncryption,
+          properties.Metadata.at(_detail::EncryptionDataMetadataName),
+          context);
+      const int64_t regionLength = key.RegionLength;
+      const int64_t encryptedRegionLength
+          = regionLength + _detail::ClientSideEncryptor::RegionOverhead;
+      const int64_t encryptedSize = properties.BlobSize;
+      const int64_t blobSize
+          = _detail::ClientSideEncryptor::GetDecryptedLength(encryptedSize, regionLength);
+
+      const int64_t rangeOffset = options.Range.HasValue() ? options.Range.Value().Offset : 0;
+      if (rangeOffset < 0 || rangeOffset > blobSize)
+      {
+        throw Azure::Core::RequestFailedException(
+            "The range is beyond the end of the blob, blob size is " + std::to_string(blobSize)
+            + ".");
+      }
+      int64_t rangeLength = blobSize - rangeOffset;
+      if (options.Range.HasValue() && options.Range.Value().Length.HasValue())
+      {
+        rangeLength = std::min(rangeLength, options.Range.Value().Length.Value());
+      }
+      uint8_t* const output = getOutput(rangeLength);
+
+      // Writes the part of a decrypted region in the range.
+      auto writeRegion = [&](const uint8_t* data, int64_t regionOffset, int64_t length) {
+        const int64_t begin = std::max(regionOffset, rangeOffset);
+        const int64_t end = std::min(regionOffset + length, rangeOffset + rangeLength);
+        if (output != nullptr)
+        {
+          std::copy(
+              data + (begin - regionOffset),
+              data + (end - regionOffset),
+              output + (begin - rangeOffset));
+          return;
+        }
+        fileWriter->Write(
+            data + (begin - regionOffset), static_cast<size_t>(end - begin), begin - rangeOffset);
+      };
+
+      std::unique_ptr<Azure::Response<Models::DownloadBlobResult>> firstChunk;
+      auto downloadChunkFunc = [&](int64_t firstRegion, int64_t numRegions, int64_t chunkId) {
+        DownloadBlobOptions chunkOptions;
+        chunkOptions.Range = Core::Http::HttpRange();
+        chunkOptions.Range.Value().Offset = firstRegion * encryptedRegionLength;
+        chunkOptions.Range.Value().Length = std::min(
+            numRegions * encryptedRegionLength,
+            encryptedSize - chunkOptions.Range.Value().Offset);
+        chunkOptions.AccessConditions.IfMatch = properties.ETag;
+        auto chunk = client.Download(chunkOptions, context);
+        std::vector<uint8_t> encrypted(
+            static_cast<size_t>(chunkOptions.Range.Value().Length.Value()));
+        if (chunk.Value.BodyStream->ReadToCount(encrypted.data(), encrypted.size(), context)
+            != encrypted.size())
+        {
+          throw Azure::Core::RequestFailedException("Error when reading body stream.");
+        }
+        chunk.Value.BodyStream.reset();
+
+        std::vector<uint8_t> decrypted;
+        for (int64_t i = 0; i < numRegions; ++i)
+        {
+          const int64_t encryptedOffset = i * encryptedRegionLength;
+          const int64_t encryptedLength = std::min(
+              encryptedRegionLength, static_cast<int64_t>(encrypted.size()) - encryptedOffset);
+          const int64_t length = encryptedLength - _detail::ClientSideEncryptor::RegionOverhead;
+          const int64_t regionOffset = (firstRegion + i) * regionLength;
+          // The regions wholly in the range are decrypted right into the output.
+          if (output != nullptr && regionOffset >= rangeOffset
+              && regionOffset + length <= rangeOffset + rangeLength)
+          {
+            _detail::ClientSideEncryptor::DecryptRegion(
+                *key.Key,
+                encrypted.data() + encryptedOffset,
+                static_cast<size_t>(encryptedLength),
+                output + (regionOffset - rangeOffset));
+            continue;
+          }
+          decrypted.resize(static_cast<size_t>(std::max<int64_t>(length, 0)));
+          _detail::ClientSideEncryptor::DecryptRegion(
+              *key.Key,
+              encrypted.data() + encryptedOffset,
+              static_cast<size_t>(encryptedLength),
+              decrypted.data());
+          writeRegion(decrypted.data(), regionOffset, length);
+        }
+        if (chunkId == 0)
+        {
+          firstChunk = std::make_unique<Azure::Response<Models::DownloadBlobResult>>(
+              std::move(chunk));
+        }
+      };
+
+      // Each chunk is a number of whole regions.
+      const int64_t firstRegion = rangeOffset / regionLength;
+      const int64_t numRegions
+          = rangeLength == 0 ? 0 : (rangeOffset + rangeLength - 1) / regionLength + 1 - firstRegion;
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize
+          = std::max<int64_t>(1, options.TransferOptions.ChunkSize / regionLength);
+      transferOptions.Concurrency = options.TransferOptions.Concurrency;
+      _internal::ConcurrentTransfer(
+          firstRegion, numRegions, transferOptions, downloadChunkFunc, transferExecutor);
+      if (!firstChunk)
+      {
+        // Nothing was decrypted, the details of the blob are downloaded on their own.
+        DownloadBlobOptions detailsOptions;
+        if (encryptedSize != 0)
+        {
+          detailsOptions.Range = Core::Http::HttpRange();
+          detailsOptions.Range.Value().Offset = 0;
+          detailsOptions.Range.Value().Length = 1;
+        }
+        detailsOptions.AccessConditions.IfMatch = properties.ETag;
+        firstChunk = std::make_unique<Azure::Response<Models::DownloadBlobResult>>(
+            client.Download(detailsOptions, context));
+      }
+
+      Models::DownloadBlobToResult ret;
+      ret.BlobType = std::move(firstChunk->Value.BlobType);
+      ret.ContentRange.Offset = rangeOffset;
+      ret.ContentRange.Length = rangeLength;
+      ret.BlobSize = blobSize;
+      ret.Details = std::move(firstChunk->Value.Details);
+      return Azure::Response<Models::DownloadBlobToResult>(
+          std::move(ret), std::move(firstChunk->RawResponse));
+    }
+
+    // Gets the properties of the blob a DownloadTo() with options downloads if it decrypts the
+    // blob, or null if the blob isn't encrypted or the download doesn't decrypt it.
+    std::unique_ptr<Models::BlobProperties> GetEncryptedBlobProperties(
+        const BlobClient& client,
+        const DownloadBlobToOptions& options,
+        const Azure::Core::Context& context)
+    {
+      if (!options.ClientSideEncryption)
+      {
+        return nullptr;
+      }
+      auto properties = std::make_unique<Models::BlobProperties>(
+          client.GetProperties(GetBlobPropertiesOptions(), context).Value);
+      if (properties->Metadata.find(_detail::EncryptionDataMetadataName)
+          == properties->Metadata.end())
+      {
+        return nullptr;
+      }
+      return properties;
+    }
+
+    // Returns the length of the range a DownloadTo() with options downloads with all its chunks
+    // requested at once, because the size and the ETag of the blob are given, or 0 if the range
+    // is downloaded the regular way. A range of a single chunk gains nothing from it.
+    int64_t GetKnownRangeLength(const DownloadBlobToOptions& options)
+    {
+      if (!options.BlobSize.HasValue() || !options.ETag.HasValue() || options.ClientSideEncryption)
+      {
+        return 0;
+      }
+      const int64_t rangeOffset = options.Range.HasValue() ? options.Range.Value().Offset : 0;
+      int64_t rangeLength = options.BlobSize.Value() - rangeOffset;
+      if (options.Range.HasValue() && options.Range.Value().Length.HasValue())
+      {
+        rangeLength = std::min(rangeLength, options.Range.Value().Length.Value());
+      }
+      int64_t chunkSize = options.TransferOptions.ChunkSize;
+      if (options.ValidateContentCrc64)
+      {
+        chunkSize = std::min(chunkSize, MaxRangeHashLength);
+      }
+      return rangeLength > chunkSize ? rangeLength : 0;
+    }
+
+    // Downloads the rangeLength bytes of the range of a DownloadTo() with options, whose blob size
+    // and ETag are known, with all the chunks requested concurrently under an If-Match condition
+    // on the ETag. writeChunk is called with the body of each chunk, its offset from the start of
+    // the range and its length. Returns null if the responses show that the blob is compressed, in
+    // which case it has to be downloaded the regular way to be decompressed.
+    Azure::Nullable<Azure::Response<Models::DownloadBlobToResult>> DownloadKnownRange(
+        const BlobClient& client,
+        const DownloadBlobToOptions& options,
+        int64_t rangeLength,
+        const std::function<void(Azure::Core::IO::BodyStream&, int64_t, int64_t)>& writeChunk,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      const int64_t rangeOffset = options.Range.HasValue() ? options.Range.Value().Offset : 0;
+      int64_t chunkSize = options.TransferOptions.ChunkSize;
+      if (options.ValidateContentCrc64)
+      {
+        chunkSize = std::min(chunkSize, MaxRangeHashLength);
+      }
+      _internal::TransferProgress progress(
+          options.TransferOptions.ProgressHandler,
+          options.TransferOptions.MaxProgressReportsPerSecond);
+
+      Azure::Nullable<Azure::Response<Models::DownloadBlobToResult>> ret;
+      std::map<int64_t, Crc64Hash> chunkCrc64s;
+      std::mutex chunkCrc64sMutex;
+      // Every response has the metadata of the blob, the chunks left are skipped once one of
+      // them shows that the blob is compressed.
+      std::atomic<bool> compressed(false);
+
+      auto downloadChunkFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
+        if (compressed.load(std::memory_order_relaxed))
+        {
+          return;
+        }
+        DownloadBlobOptions chunkOptions;
+        chunkOptions.Range = Core::Http::HttpRange();
+        chunkOptions.Range.Value().Offset = offset;
+        chunkOptions.Range.Value().Length = length;
+        chunkOptions.AccessConditions.IfMatch = options.ETag;
+        if (options.ValidateContentCrc64)
+        {
+          chunkOptions.RangeHashAlgorithm = HashAlgorithm::Crc64;
+        }
+        auto chunk = client.Download(chunkOptions, context);
+        BlobCompression compression;
+        if (GetBlobCompression(chunk.Value, options, compression))
+        {
+          compressed.store(true, std::memory_order_relaxed);
+          return;
+        }
+        Crc64Hash* chunkCrc64 = nullptr;
+        if (options.ValidateContentCrc64)
+        {
+          std::lock_guard<std::mutex> guard(chunkCrc64sMutex);
+          chunkCrc64 = &chunkCrc64s[chunkId];
+        }
+        ReadChunk(chunk.Value, chunkCrc64, progress, [&](Azure::Core::IO::BodyStream& bodyStream) {
+          writeChunk(bodyStream, offset - rangeOffset, length);
+        });
+
+        if (offset + length == rangeOffset + rangeLength)
+        {
+          Models::DownloadBlobToResult result;
+          result.BlobType = std::move(chunk.Value.BlobType);
+          result.BlobSize = chunk.Value.BlobSize;
+          result.Details = std::move(chunk.Value.Details);
+          ret = Azure::Response<Models::DownloadBlobToResult>(
+              std::move(result), std::move(chunk.RawResponse));
+        }
+      };
+
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = chunkSize;
+      transferOptions.Concurrency = options.TransferOptions.Concurrency;
+      transferOptions.AutoTune = options.TransferOptions.AutoTune;
+      _internal::ConcurrentTransfer(
+          rangeOffset, rangeLength, transferOptions, downloadChunkFunc, transferExecutor);
+      if (compressed.load(std::memory_order_relaxed))
+      {
+        return Azure::Nullable<Azure::Response<Models::DownloadBlobToResult>>();
+      }
+      progress.Complete();
+      ret.Value().Value.ContentRange.Offset = rangeOffset;
+      ret.Value().Value.ContentRange.Length = rangeLength;
+      if (options.ValidateContentCrc64)
+      {
+        Crc64Hash crc64;
+        for (const auto& chunkCrc64 : chunkCrc64s)
+        {
+          crc64.Concatenate(chunkCrc64.second);
+        }
+        ContentHash hash;
+        hash.Algorithm = HashAlgorithm::Crc64;
+        hash.Value = crc64.Final();
+        ret.Value().Value.TransactionalContentHash = std::move(hash);
+      }
+      return ret;
+    }
+
+    _detail::BlobRestClient::Blob::DeleteBlobOptions GetDeleteProtocolLayerOptions(
+        const DeleteBlobOptions& options)
+    {
+      _detail::BlobRestClient::Blob::DeleteBlobOptions protocolLayerOptions;
+      protocolLayerOptions.DeleteSnapshots = options.DeleteSnapshots;
+      protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+      protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
+      protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
+      protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
+      protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+      protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
+      return protocolLayerOptions;
+    }
+  } // namespace
+
   BlobClient BlobClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& blobContainerName,
@@ -59,16 +617,32 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_blobUrl.GetHost(), newOptions.SecondaryHostForRetryReads));
+        m_blobUrl.GetHost(),
+        newOptions.SecondaryHostForRetryReads,
+        newOptions.SecondaryReadBalancer));
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion));
+    if (newOptions.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(newOptions.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, newOptions.ApiVersion}});
   }
 
   BlobClient::BlobClient(
@@ -80,7 +654,19 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_blobUrl.GetHost(), options.SecondaryHostForRetryReads));
+        m_blobUrl.GetHost(),
+        options.SecondaryHostForRetryReads,
+        options.SecondaryReadBalancer));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
     {
       Azure::Core::Credentials::TokenRequestContext tokenContext;
@@ -89,33 +675,54 @@ namespace Azure { namespace Storage { namespace Blobs {
           std::make_unique<Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
               credential, tokenContext));
     }
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
+    if (options.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(options.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   BlobClient::BlobClient(const std::string& blobUrl, const BlobClientOptions& options)
       : m_blobUrl(blobUrl), m_customerProvidedKey(options.CustomerProvidedKey),
-        m_encryptionScope(options.EncryptionScope)
+        m_encryptionScope(options.EncryptionScope), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_blobUrl.GetHost(), options.SecondaryHostForRetryReads));
+        m_blobUrl.GetHost(),
+        options.SecondaryHostForRetryReads,
+        options.SecondaryReadBalancer));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
+    if (options.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(options.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   BlockBlobClient BlobClient::AsBlockBlobClient() const { return BlockBlobClient(*this); }
@@ -158,6 +765,7 @@ namespace Azure { namespace Storage { namespace Blobs {
       const DownloadBlobOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.Download", context);
     _detail::BlobRestClient::Blob::DownloadBlobOptions protocolLayerOptions;
     protocolLayerOptions.Range = options.Range;
     protocolLayerOptions.RangeHashAlgorithm = options.RangeHashAlgorithm;
@@ -175,7 +783,10 @@ namespace Azure { namespace Storage { namespace Blobs {
     }
 
     auto downloadResponse = _detail::BlobRestClient::Blob::Download(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, _internal::WithReplicaStatus(context));
+        *m_pipeline,
+        m_blobUrl,
+        protocolLayerOptions,
+        _internal::WithReplicaStatus(span.GetContext()));
 
     {
       // In case network failure during reading the body
@@ -198,6 +809,11 @@ namespace Azure { namespace Storage { namespace Blobs {
 
       _internal::ReliableStreamOptions reliableStreamOptions;
       reliableStreamOptions.MaxRetryRequests = _internal::ReliableStreamRetryCount;
+      reliableStreamOptions.RetryDelay = _internal::ReliableStreamRetryDelay;
+      reliableStreamOptions.MaxRetryDelay = _internal::ReliableStreamMaxRetryDelay;
+      reliableStreamOptions.StallTimeout = _internal::ReliableStreamStallTimeout;
+      reliableStreamOptions.MinimumThroughput = _internal::ReliableStreamMinimumThroughput;
+      reliableStreamOptions.ThroughputWindow = _internal::ReliableStreamThroughputWindow;
       downloadResponse.Value.BodyStream = std::make_unique<_internal::ReliableStream>(
           std::move(downloadResponse.Value.BodyStream), reliableStreamOptions, retryFunction);
     }
@@ -220,6 +836,53 @@ namespace Azure { namespace Storage { namespace Blobs {
       const DownloadBlobToOptions& options,
       const Azure::Core::Context& context) const
   {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.DownloadTo", bulkContext);
+    auto encryptedProperties = GetEncryptedBlobProperties(*this, options, span.GetContext());
+    if (encryptedProperties)
+    {
+      auto getOutput = [buffer, bufferSize](int64_t rangeLength) {
+        if (static_cast<uint64_t>(rangeLength) > bufferSize)
+        {
+          throw Azure::Core::RequestFailedException(
+              "Buffer is not big enough, blob range size is " + std::to_string(rangeLength)
+              + ".");
+        }
+        return buffer;
+      };
+      return DownloadEncryptedRegions(
+          *this,
+          *encryptedProperties,
+          options,
+          getOutput,
+          nullptr,
+          m_transferExecutor,
+          span.GetContext());
+    }
+    // A buffer too small for the range is left to the regular download, which may decompress
+    // the blob into it, or fails.
+    const int64_t knownRangeLength = GetKnownRangeLength(options);
+    if (knownRangeLength != 0 && static_cast<uint64_t>(knownRangeLength) <= bufferSize)
+    {
+      auto ret = DownloadKnownRange(
+          *this,
+          options,
+          knownRangeLength,
+          [buffer, &span](Azure::Core::IO::BodyStream& bodyStream, int64_t offset, int64_t length) {
+            int64_t bytesRead = bodyStream.ReadToCount(
+                buffer + offset, static_cast<size_t>(length), span.GetContext());
+            if (bytesRead != length)
+            {
+              throw Azure::Core::RequestFailedException("Error when reading body stream.");
+            }
+          },
+          m_transferExecutor,
+          span.GetContext());
+      if (ret.HasValue())
+      {
+        return std::move(ret.Value());
+      }
+    }
     // Just start downloading using an initial chunk. If it's a small blob, we'll get the whole
     // thing in one shot. If it's a large blob, we'll get its full size in Content-Range and can
     // keep downloading it in chunks.
@@ -230,17 +893,52 @@ namespace Azure { namespace Storage { namespace Blobs {
       firstChunkLength = std::min(firstChunkLength, options.Range.Value().Length.Value());
     }
 
+    int64_t chunkSize = options.TransferOptions.ChunkSize;
+
     DownloadBlobOptions firstChunkOptions;
     firstChunkOptions.Range = options.Range;
+    if (options.ValidateContentCrc64)
+    {
+      firstChunkLength = std::min(firstChunkLength, MaxRangeHashLength);
+      chunkSize = std::min(chunkSize, MaxRangeHashLength);
+      if (!firstChunkOptions.Range.HasValue())
+      {
+        firstChunkOptions.Range = Core::Http::HttpRange();
+      }
+      firstChunkOptions.RangeHashAlgorithm = HashAlgorithm::Crc64;
+    }
     if (firstChunkOptions.Range.HasValue())
     {
       firstChunkOptions.Range.Value().Length = firstChunkLength;
     }
 
-    auto firstChunk = Download(firstChunkOptions, context);
+    auto firstChunk = DownloadFirstChunk(*this, firstChunkOptions, options, span.GetContext());
     const Azure::ETag eTag = firstChunk.Value.Details.ETag;
 
     const int64_t blobSize = firstChunk.Value.BlobSize;
+    BlobCompression compression;
+    if (GetBlobCompression(firstChunk.Value, options, compression))
+    {
+      if (static_cast<uint64_t>(compression.UncompressedSize) > bufferSize)
+      {
+        throw Azure::Core::RequestFailedException(
+            "Buffer is not big enough, blob size is "
+            + std::to_string(compression.UncompressedSize) + ".");
+      }
+      DownloadCompressedBlocks(
+          *this,
+          *m_pipeline,
+          m_blobUrl,
+          firstChunk.Value,
+          std::min(firstChunkLength, blobSize),
+          compression,
+          options,
+          buffer,
+          nullptr,
+          m_transferExecutor,
+          span.GetContext());
+      return GetDecompressedDownloadResult(firstChunk, compression);
+    }
     int64_t blobRangeSize;
     if (firstChunkOptions.Range.HasValue())
     {
@@ -255,6 +953,9 @@ namespace Azure { namespace Storage { namespace Blobs {
       blobRangeSize = blobSize;
     }
     firstChunkLength = std::min(firstChunkLength, blobRangeSize);
+    _internal::TransferProgress progress(
+        options.TransferOptions.ProgressHandler,
+        options.TransferOptions.MaxProgressReportsPerSecond);
 
     if (static_cast<uint64_t>(blobRangeSize) > std::numeric_limits<size_t>::max()
         || static_cast<size_t>(blobRangeSize) > bufferSize)
@@ -263,12 +964,19 @@ namespace Azure { namespace Storage { namespace Blobs {
           "Buffer is not big enough, blob range size is " + std::to_string(blobRangeSize) + ".");
     }
 
-    int64_t bytesRead = firstChunk.Value.BodyStream->ReadToCount(
-        buffer, static_cast<size_t>(firstChunkLength), context);
-    if (bytesRead != firstChunkLength)
-    {
-      throw Azure::Core::RequestFailedException("Error when reading body stream.");
-    }
+    Crc64Hash firstChunkCrc64;
+    ReadChunk(
+        firstChunk.Value,
+        options.ValidateContentCrc64 ? &firstChunkCrc64 : nullptr,
+        progress,
+        [&](Azure::Core::IO::BodyStream& bodyStream) {
+          int64_t bytesRead = bodyStream.ReadToCount(
+              buffer, static_cast<size_t>(firstChunkLength), span.GetContext());
+          if (bytesRead != firstChunkLength)
+          {
+            throw Azure::Core::RequestFailedException("Error when reading body stream.");
+          }
+        });
     firstChunk.Value.BodyStream.reset();
 
     auto returnTypeConverter = [](Azure::Response<Models::DownloadBlobResult>& response) {
@@ -283,42 +991,64 @@ namespace Azure { namespace Storage { namespace Blobs {
     };
     auto ret = returnTypeConverter(firstChunk);
 
+    int64_t remainingOffset = firstChunkOffset + firstChunkLength;
+    int64_t remainingSize = blobRangeSize - firstChunkLength;
+    // The CRC64 of each chunk by chunk ID, to be concatenated in order once they are all
+    // downloaded.
+    std::map<int64_t, Crc64Hash> chunkCrc64s;
+    std::mutex chunkCrc64sMutex;
+
     // Keep downloading the remaining in parallel
     auto downloadChunkFunc
-        = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+        = [&](int64_t offset, int64_t length, int64_t chunkId) {
             DownloadBlobOptions chunkOptions;
             chunkOptions.Range = Core::Http::HttpRange();
             chunkOptions.Range.Value().Offset = offset;
             chunkOptions.Range.Value().Length = length;
             chunkOptions.AccessConditions.IfMatch = eTag;
-            auto chunk = Download(chunkOptions, context);
-            int64_t bytesRead = chunk.Value.BodyStream->ReadToCount(
-                buffer + (offset - firstChunkOffset),
-                static_cast<size_t>(chunkOptions.Range.Value().Length.Value()),
-                context);
-            if (bytesRead != chunkOptions.Range.Value().Length.Value())
+            chunkOptions.RangeHashAlgorithm = firstChunkOptions.RangeHashAlgorithm;
+            auto chunk = Download(chunkOptions, span.GetContext());
+            Crc64Hash* chunkCrc64 = nullptr;
+            if (options.ValidateContentCrc64)
             {
-              throw Azure::Core::RequestFailedException("Error when reading body stream.");
+              std::lock_guard<std::mutex> guard(chunkCrc64sMutex);
+              chunkCrc64 = &chunkCrc64s[chunkId];
             }
+            ReadChunk(
+                chunk.Value,
+                chunkCrc64,
+                progress,
+                [&](Azure::Core::IO::BodyStream& bodyStream) {
+                  int64_t bytesRead = bodyStream.ReadToCount(
+                      buffer + (offset - firstChunkOffset),
+                      static_cast<size_t>(length),
+                      span.GetContext());
+                  if (bytesRead != length)
+                  {
+                    throw Azure::Core::RequestFailedException("Error when reading body stream.");
+                  }
+                });
 
-            if (chunkId == numChunks - 1)
+            if (offset + length == remainingOffset + remainingSize)
             {
               ret = returnTypeConverter(chunk);
               ret.Value.TransactionalContentHash.Reset();
             }
           };
 
-    int64_t remainingOffset = firstChunkOffset + firstChunkLength;
-    int64_t remainingSize = blobRangeSize - firstChunkLength;
-
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = chunkSize;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    transferOptions.AutoTune = options.TransferOptions.AutoTune;
     _internal::ConcurrentTransfer(
-        remainingOffset,
-        remainingSize,
-        options.TransferOptions.ChunkSize,
-        options.TransferOptions.Concurrency,
-        downloadChunkFunc);
+        remainingOffset, remainingSize, transferOptions, downloadChunkFunc, m_transferExecutor);
+    progress.Complete();
     ret.Value.ContentRange.Offset = firstChunkOffset;
     ret.Value.ContentRange.Length = blobRangeSize;
+    if (options.ValidateContentCrc64)
+    {
+      ret.Value.TransactionalContentHash = ConcatenateCrc64(firstChunkCrc64, chunkCrc64s);
+    }
     return ret;
   }
 
@@ -327,6 +1057,8 @@ namespace Azure { namespace Storage { namespace Blobs {
       const DownloadBlobToOptions& options,
       const Azure::Core::Context& context) const
   {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.DownloadTo", bulkContext);
     // Just start downloading using an initial chunk. If it's a small blob, we'll get the whole
     // thing in one shot. If it's a large blob, we'll get its full size in Content-Range and can
     // keep downloading it in chunks.
@@ -337,19 +1069,172 @@ namespace Azure { namespace Storage { namespace Blobs {
       firstChunkLength = std::min(firstChunkLength, options.Range.Value().Length.Value());
     }
 
+    int64_t chunkSize = options.TransferOptions.ChunkSize;
+
     DownloadBlobOptions firstChunkOptions;
     firstChunkOptions.Range = options.Range;
+    if (options.ValidateContentCrc64)
+    {
+      firstChunkLength = std::min(firstChunkLength, MaxRangeHashLength);
+      chunkSize = std::min(chunkSize, MaxRangeHashLength);
+      if (!firstChunkOptions.Range.HasValue())
+      {
+        firstChunkOptions.Range = Core::Http::HttpRange();
+      }
+      firstChunkOptions.RangeHashAlgorithm = HashAlgorithm::Crc64;
+    }
     if (firstChunkOptions.Range.HasValue())
     {
       firstChunkOptions.Range.Value().Length = firstChunkLength;
     }
 
-    _internal::FileWriter fileWriter(fileName);
+    const auto fileIoMode = options.TransferOptions.UnbufferedIo
+        ? _internal::FileIoMode::Unbuffered
+        : options.TransferOptions.MemoryMapFile ? _internal::FileIoMode::MemoryMapped
+                                                : _internal::FileIoMode::Buffered;
+
+    const bool asyncFileIo = options.TransferOptions.AsyncFileIo;
+    // The chunks are received right into mappedData if the file is mapped.
+    auto bodyStreamToFile = [this, asyncFileIo](
+                                Azure::Core::IO::BodyStream& stream,
+                                _internal::FileWriter& fileWriter,
+                                uint8_t* mappedData,
+                                int64_t offset,
+                                int64_t length,
+                                const Azure::Core::Context& bulkContext) {
+      if (mappedData != nullptr)
+      {
+        int64_t bytesRead
+            = stream.ReadToCount(mappedData + offset, static_cast<size_t>(length), bulkContext);
+        if (bytesRead != length)
+        {
+          throw Azure::Core::RequestFailedException("Error when reading body stream.");
+        }
+        return;
+      }
+
+      constexpr size_t bufferSize = 4 * 1024 * 1024;
+      _internal::IoRing* ring = asyncFileIo ? _internal::IoRing::GetThreadRing() : nullptr;
+      if (ring != nullptr && length > static_cast<int64_t>(bufferSize))
+      {
+        // The data is received into one half of the buffer while the other half is written. A
+        // single buffer is taken, so that chunks don't wait for each other's second buffer.
+        _internal::PooledBuffer buffer(m_bufferPool, bufferSize * 2, bulkContext);
+        uint8_t* const halves[2] = {buffer.Data(), buffer.Data() + bufferSize};
+        uint64_t writeIds[2] = {0, 0};
+        size_t skew = static_cast<size_t>(offset % _internal::UnbufferedIoAlignment);
+        try
+        {
+          for (size_t i = 0; length > 0; i ^= 1)
+          {
+            ring->Wait(writeIds[i]);
+            size_t readSize = static_cast<size_t>(std::min<int64_t>(bufferSize - skew, length));
+            size_t bytesRead = stream.ReadToCount(halves[i] + skew, readSize, bulkContext);
+            if (bytesRead != readSize)
+            {
+              throw Azure::Core::RequestFailedException("Error when reading body stream.");
+            }
+            writeIds[i] = fileWriter.QueueWrite(*ring, halves[i] + skew, bytesRead, offset);
+            ring->Submit();
+            length -= bytesRead;
+            offset += bytesRead;
+            skew = 0;
+          }
+          ring->Wait();
+        }
+        catch (...)
+        {
+          // The buffer is only released once the kernel is done with it.
+          try
+          {
+            ring->Wait();
+          }
+          catch (...)
+          {
+          }
+          throw;
+        }
+        return;
+      }
 
-    auto firstChunk = Download(firstChunkOptions, context);
+      // The data is placed in the aligned buffer at the same alignment as in the file, so that
+      // most of it can be written bypassing the page cache in unbuffered mode.
+      _internal::PooledBuffer buffer(m_bufferPool, bufferSize, bulkContext);
+      size_t skew = static_cast<size_t>(offset % _internal::UnbufferedIoAlignment);
+      while (length > 0)
+      {
+        size_t readSize = static_cast<size_t>(std::min<int64_t>(bufferSize - skew, length));
+        size_t bytesRead = stream.ReadToCount(buffer.Data() + skew, readSize, bulkContext);
+        if (bytesRead != readSize)
+        {
+          throw Azure::Core::RequestFailedException("Error when reading body stream.");
+        }
+        fileWriter.Write(buffer.Data() + skew, bytesRead, offset);
+        length -= bytesRead;
+        offset += bytesRead;
+        skew = 0;
+      }
+    };
+
+    const int64_t knownRangeLength = GetKnownRangeLength(options);
+    if (knownRangeLength != 0)
+    {
+      // The file is written by its own writer, so that it's emptied again by the writer of the
+      // regular download if the blob turns out to be compressed.
+      _internal::FileWriter knownRangeWriter(fileName, fileIoMode);
+      uint8_t* const knownRangeData = knownRangeWriter.Map(knownRangeLength);
+      auto ret = DownloadKnownRange(
+          *this,
+          options,
+          knownRangeLength,
+          [&](Azure::Core::IO::BodyStream& bodyStream, int64_t offset, int64_t length) {
+            bodyStreamToFile(
+                bodyStream, knownRangeWriter, knownRangeData, offset, length, span.GetContext());
+          },
+          m_transferExecutor,
+          span.GetContext());
+      if (ret.HasValue())
+      {
+        return std::move(ret.Value());
+      }
+    }
+
+    _internal::FileWriter fileWriter(fileName, fileIoMode);
+
+    auto encryptedProperties = GetEncryptedBlobProperties(*this, options, span.GetContext());
+    if (encryptedProperties)
+    {
+      return DownloadEncryptedRegions(
+          *this,
+          *encryptedProperties,
+          options,
+          [&fileWriter](int64_t rangeLength) { return fileWriter.Map(rangeLength); },
+          &fileWriter,
+          m_transferExecutor,
+          span.GetContext());
+    }
+
+    auto firstChunk = DownloadFirstChunk(*this, firstChunkOptions, options, span.GetContext());
     const Azure::ETag eTag = firstChunk.Value.Details.ETag;
 
     const int64_t blobSize = firstChunk.Value.BlobSize;
+    BlobCompression compression;
+    if (GetBlobCompression(firstChunk.Value, options, compression))
+    {
+      DownloadCompressedBlocks(
+          *this,
+          *m_pipeline,
+          m_blobUrl,
+          firstChunk.Value,
+          std::min(firstChunkLength, blobSize),
+          compression,
+          options,
+          fileWriter.Map(compression.UncompressedSize),
+          &fileWriter,
+          m_transferExecutor,
+          span.GetContext());
+      return GetDecompressedDownloadResult(firstChunk, compression);
+    }
     int64_t blobRangeSize;
     if (firstChunkOptions.Range.HasValue())
     {
@@ -364,29 +1249,22 @@ namespace Azure { namespace Storage { namespace Blobs {
       blobRangeSize = blobSize;
     }
     firstChunkLength = std::min(firstChunkLength, blobRangeSize);
+    _internal::TransferProgress progress(
+        options.TransferOptions.ProgressHandler,
+        options.TransferOptions.MaxProgressReportsPerSecond);
 
-    auto bodyStreamToFile = [](Azure::Core::IO::BodyStream& stream,
-                               _internal::FileWriter& fileWriter,
-                               int64_t offset,
-                               int64_t length,
-                               const Azure::Core::Context& context) {
-      constexpr size_t bufferSize = 4 * 1024 * 1024;
-      std::vector<uint8_t> buffer(bufferSize);
-      while (length > 0)
-      {
-        size_t readSize = static_cast<size_t>(std::min<int64_t>(bufferSize, length));
-        size_t bytesRead = stream.ReadToCount(buffer.data(), readSize, context);
-        if (bytesRead != readSize)
-        {
-          throw Azure::Core::RequestFailedException("Error when reading body stream.");
-        }
-        fileWriter.Write(buffer.data(), bytesRead, offset);
-        length -= bytesRead;
-        offset += bytesRead;
-      }
-    };
+    // The chunks are received right into the file if it can be mapped.
+    uint8_t* const mappedData = fileWriter.Map(blobRangeSize);
 
-    bodyStreamToFile(*(firstChunk.Value.BodyStream), fileWriter, 0, firstChunkLength, context);
+    Crc64Hash firstChunkCrc64;
+    ReadChunk(
+        firstChunk.Value,
+        options.ValidateContentCrc64 ? &firstChunkCrc64 : nullptr,
+        progress,
+        [&](Azure::Core::IO::BodyStream& bodyStream) {
+          bodyStreamToFile(
+              bodyStream, fileWriter, mappedData, 0, firstChunkLength, span.GetContext());
+        });
     firstChunk.Value.BodyStream.reset();
 
     auto returnTypeConverter = [](Azure::Response<Models::DownloadBlobResult>& response) {
@@ -401,47 +1279,423 @@ namespace Azure { namespace Storage { namespace Blobs {
     };
     auto ret = returnTypeConverter(firstChunk);
 
+    int64_t remainingOffset = firstChunkOffset + firstChunkLength;
+    int64_t remainingSize = blobRangeSize - firstChunkLength;
+    // The CRC64 of each chunk by chunk ID, to be concatenated in order once they are all
+    // downloaded.
+    std::map<int64_t, Crc64Hash> chunkCrc64s;
+    std::mutex chunkCrc64sMutex;
+
     // Keep downloading the remaining in parallel
     auto downloadChunkFunc
-        = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+        = [&](int64_t offset, int64_t length, int64_t chunkId) {
             DownloadBlobOptions chunkOptions;
             chunkOptions.Range = Core::Http::HttpRange();
             chunkOptions.Range.Value().Offset = offset;
             chunkOptions.Range.Value().Length = length;
             chunkOptions.AccessConditions.IfMatch = eTag;
-            auto chunk = Download(chunkOptions, context);
-            bodyStreamToFile(
-                *(chunk.Value.BodyStream),
-                fileWriter,
-                offset - firstChunkOffset,
-                chunkOptions.Range.Value().Length.Value(),
-                context);
+            chunkOptions.RangeHashAlgorithm = firstChunkOptions.RangeHashAlgorithm;
+            auto chunk = Download(chunkOptions, span.GetContext());
+            Crc64Hash* chunkCrc64 = nullptr;
+            if (options.ValidateContentCrc64)
+            {
+              std::lock_guard<std::mutex> guard(chunkCrc64sMutex);
+              chunkCrc64 = &chunkCrc64s[chunkId];
+            }
+            ReadChunk(
+                chunk.Value,
+                chunkCrc64,
+                progress,
+                [&](Azure::Core::IO::BodyStream& bodyStream) {
+                  bodyStreamToFile(
+                      bodyStream,
+                      fileWriter,
+                      mappedData,
+                      offset - firstChunkOffset,
+                      length,
+                      span.GetContext());
+                });
 
-            if (chunkId == numChunks - 1)
+            if (offset + length == remainingOffset + remainingSize)
             {
               ret = returnTypeConverter(chunk);
               ret.Value.TransactionalContentHash.Reset();
             }
           };
 
-    int64_t remainingOffset = firstChunkOffset + firstChunkLength;
-    int64_t remainingSize = blobRangeSize - firstChunkLength;
-
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = chunkSize;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    transferOptions.AutoTune = options.TransferOptions.AutoTune;
     _internal::ConcurrentTransfer(
-        remainingOffset,
-        remainingSize,
-        options.TransferOptions.ChunkSize,
-        options.TransferOptions.Concurrency,
-        downloadChunkFunc);
+        remainingOffset, remainingSize, transferOptions, downloadChunkFunc, m_transferExecutor);
+    progress.Complete();
     ret.Value.ContentRange.Offset = firstChunkOffset;
     ret.Value.ContentRange.Length = blobRangeSize;
+    if (options.ValidateContentCrc64)
+    {
+      ret.Value.TransactionalContentHash = ConcatenateCrc64(firstChunkCrc64, chunkCrc64s);
+    }
     return ret;
   }
 
+  Azure::Response<Models::DownloadBlobToResult> BlobClient::DownloadTo(
+      const std::function<void(const uint8_t*, size_t)>& sink,
+      const DownloadBlobToOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.DownloadTo", bulkContext);
+    // The first chunk is of the size of the others, so that they are downloaded while it's passed
+    // to the sink.
+    int64_t chunkSize = options.TransferOptions.ChunkSize;
+    if (options.ValidateContentCrc64)
+    {
+      chunkSize = std::min(chunkSize, MaxRangeHashLength);
+    }
+    const int64_t firstChunkOffset = options.Range.HasValue() ? options.Range.Value().Offset : 0;
+    int64_t firstChunkLength = chunkSize;
+    if (options.Range.HasValue() && options.Range.Value().Length.HasValue())
+    {
+      firstChunkLength = std::min(firstChunkLength, options.Range.Value().Length.Value());
+    }
+
+    DownloadBlobOptions firstChunkOptions;
+    firstChunkOptions.Range = Core::Http::HttpRange();
+    firstChunkOptions.Range.Value().Offset = firstChunkOffset;
+    firstChunkOptions.Range.Value().Length = firstChunkLength;
+    if (options.ValidateContentCrc64)
+    {
+      firstChunkOptions.RangeHashAlgorithm = HashAlgorithm::Crc64;
+    }
+    auto firstChunk = DownloadFirstChunk(*this, firstChunkOptions, options, span.GetContext());
+    const Azure::ETag eTag = firstChunk.Value.Details.ETag;
+
+    int64_t blobRangeSize = firstChunk.Value.BlobSize;
+    if (firstChunkOptions.Range.HasValue())
+    {
+      blobRangeSize -= firstChunkOffset;
+      if (options.Range.HasValue() && options.Range.Value().Length.HasValue())
+      {
+        blobRangeSize = std::min(blobRangeSize, options.Range.Value().Length.Value());
+      }
+    }
+    firstChunkLength = std::min(firstChunkLength, blobRangeSize);
+    _internal::TransferProgress progress(
+        options.TransferOptions.ProgressHandler,
+        options.TransferOptions.MaxProgressReportsPerSecond);
+
+    struct SinkChunk final
+    {
+      int64_t Offset = 0;
+      size_t Length = 0;
+      _internal::PooledBuffer Buffer;
+      Crc64Hash Crc64;
+      // The response of the last chunk, which describes the blob in the result.
+      std::unique_ptr<Azure::Response<Models::DownloadBlobResult>> Response;
+      // Guarded by mutex.
+      bool Done = false;
+      std::exception_ptr Exception;
+    };
+    std::mutex mutex;
+    std::condition_variable chunkDone;
+    int pendingTasks = 0;
+    // Cancels the chunks downloading in the background when the download stops.
+    Azure::Core::Context chunksContext = span.GetContext().WithDeadline((Azure::DateTime::max)());
+
+    // The chunks downloading or waiting to be passed to the sink, in order.
+    std::deque<std::shared_ptr<SinkChunk>> chunks;
+    const int64_t rangeEnd = firstChunkOffset + blobRangeSize;
+    int64_t nextOffset = firstChunkOffset + firstChunkLength;
+    auto submitChunks = [&]() {
+      while (static_cast<int>(chunks.size()) < options.TransferOptions.Concurrency
+             && nextOffset < rangeEnd)
+      {
+        auto chunk = std::make_shared<SinkChunk>();
+        chunk->Offset = nextOffset;
+        chunk->Length = static_cast<size_t>(std::min(chunkSize, rangeEnd - nextOffset));
+        // Only the chunk passed to the sink next waits for a buffer, the buffers of the pool may
+        // be held by the chunks waiting for the sink.
+        chunk->Buffer = chunks.empty()
+            ? _internal::PooledBuffer(m_bufferPool, chunk->Length, chunksContext)
+            : _internal::PooledBuffer::TryTake(m_bufferPool, chunk->Length);
+        if (!chunk->Buffer.Data())
+        {
+          break;
+        }
+        chunks.push_back(chunk);
+        nextOffset += static_cast<int64_t>(chunk->Length);
+        {
+          std::lock_guard<std::mutex> guard(mutex);
+          ++pendingTasks;
+        }
+        const bool isLastChunk = nextOffset == rangeEnd;
+        _internal::SubmitTransferTask(m_transferExecutor, [&, chunk, isLastChunk]() {
+          std::exception_ptr exception;
+          try
+          {
+            DownloadBlobOptions chunkOptions;
+            chunkOptions.Range = Core::Http::HttpRange();
+            chunkOptions.Range.Value().Offset = chunk->Offset;
+            chunkOptions.Range.Value().Length = static_cast<int64_t>(chunk->Length);
+            chunkOptions.AccessConditions.IfMatch = eTag;
+            chunkOptions.RangeHashAlgorithm = firstChunkOptions.RangeHashAlgorithm;
+            auto response = Download(chunkOptions, chunksContext);
+            ReadChunk(
+                response.Value,
+                options.ValidateContentCrc64 ? &chunk->Crc64 : nullptr,
+                progress,
+                [&](Azure::Core::IO::BodyStream& bodyStream) {
+                  if (bodyStream.ReadToCount(chunk->Buffer.Data(), chunk->Length, chunksContext)
+                      != chunk->Length)
+                  {
+                    throw Azure::Core::RequestFailedException("Error when reading body stream.");
+                  }
+                });
+            if (isLastChunk)
+            {
+              response.Value.BodyStream.reset();
+              chunk->Response = std::make_unique<Azure::Response<Models::DownloadBlobResult>>(
+                  std::move(response));
+            }
+          }
+          catch (...)
+          {
+            exception = std::current_exception();
+          }
+          // The download may return as soon as the mutex is unlocked.
+          std::lock_guard<std::mutex> guard(mutex);
+          chunk->Done = true;
+          chunk->Exception = std::move(exception);
+          --pendingTasks;
+          chunkDone.notify_all();
+        });
+      }
+    };
+    auto waitForTasks = [&]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      chunkDone.wait(lock, [&]() { return pendingTasks == 0; });
+    };
+
+    Crc64Hash crc64;
+    try
+    {
+      // The first chunk is read after the next ones are started.
+      _internal::PooledBuffer firstChunkBuffer;
+      if (firstChunkLength > 0)
+      {
+        firstChunkBuffer = _internal::PooledBuffer(
+            m_bufferPool, static_cast<size_t>(firstChunkLength), span.GetContext());
+      }
+      submitChunks();
+      Crc64Hash firstChunkCrc64;
+      ReadChunk(
+          firstChunk.Value,
+          options.ValidateContentCrc64 ? &firstChunkCrc64 : nullptr,
+          progress,
+          [&](Azure::Core::IO::BodyStream& bodyStream) {
+            const size_t length = static_cast<size_t>(firstChunkLength);
+            if (bodyStream.ReadToCount(firstChunkBuffer.Data(), length, span.GetContext())
+                != length)
+            {
+              throw Azure::Core::RequestFailedException("Error when reading body stream.");
+            }
+          });
+      firstChunk.Value.BodyStream.reset();
+      if (firstChunkLength > 0)
+      {
+        sink(firstChunkBuffer.Data(), static_cast<size_t>(firstChunkLength));
+      }
+      crc64.Concatenate(firstChunkCrc64);
+      firstChunkBuffer = _internal::PooledBuffer();
+
+      while (!chunks.empty())
+      {
+        submitChunks();
+        const std::shared_ptr<SinkChunk> chunk = chunks.front();
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          while (!chunk->Done)
+          {
+            span.GetContext().ThrowIfCancelled();
+            chunkDone.wait_for(lock, std::chrono::milliseconds(100));
+          }
+        }
+        if (chunk->Exception)
+        {
+          std::rethrow_exception(chunk->Exception);
+        }
+        sink(chunk->Buffer.Data(), chunk->Length);
+        crc64.Concatenate(chunk->Crc64);
+        if (chunk->Response)
+        {
+          firstChunk = std::move(*chunk->Response);
+        }
+        chunks.pop_front();
+      }
+    }
+    catch (...)
+    {
+      chunksContext.Cancel();
+      chunks.clear();
+      waitForTasks();
+      throw;
+    }
+    waitForTasks();
+    progress.Complete();
+
+    Models::DownloadBlobToResult ret;
+    ret.BlobType = std::move(firstChunk.Value.BlobType);
+    ret.ContentRange.Offset = firstChunkOffset;
+    ret.ContentRange.Length = blobRangeSize;
+    ret.BlobSize = firstChunk.Value.BlobSize;
+    ret.Details = std::move(firstChunk.Value.Details);
+    if (options.ValidateContentCrc64)
+    {
+      ContentHash hash;
+      hash.Algorithm = HashAlgorithm::Crc64;
+      hash.Value = crc64.Final();
+      ret.TransactionalContentHash = std::move(hash);
+    }
+    return Azure::Response<Models::DownloadBlobToResult>(
+        std::move(ret), std::move(firstChunk.RawResponse));
+  }
+
+  Azure::Response<Models::DownloadBlobToResult> BlobClient::DownloadConcurrently(
+      const std::function<void(int64_t, const uint8_t*, size_t)>& onChunk,
+      const DownloadBlobConcurrentlyOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.DownloadConcurrently", bulkContext);
+    int64_t chunkSize = options.ChunkSize;
+    if (options.ValidateContentCrc64)
+    {
+      chunkSize = std::min(chunkSize, MaxRangeHashLength);
+    }
+    const int64_t rangeOffset = options.Range.HasValue() ? options.Range.Value().Offset : 0;
+    int64_t firstChunkLength = chunkSize;
+    if (options.Range.HasValue() && options.Range.Value().Length.HasValue())
+    {
+      firstChunkLength = std::min(firstChunkLength, options.Range.Value().Length.Value());
+    }
+
+    DownloadBlobOptions firstChunkOptions;
+    firstChunkOptions.Range = Core::Http::HttpRange();
+    firstChunkOptions.Range.Value().Offset = rangeOffset;
+    firstChunkOptions.Range.Value().Length = firstChunkLength;
+    firstChunkOptions.AccessConditions = options.AccessConditions;
+    if (options.ValidateContentCrc64)
+    {
+      firstChunkOptions.RangeHashAlgorithm = HashAlgorithm::Crc64;
+    }
+    Azure::Nullable<Azure::Response<Models::DownloadBlobResult>> firstChunk;
+    try
+    {
+      firstChunk = Download(firstChunkOptions, span.GetContext());
+    }
+    catch (StorageException& e)
+    {
+      // An empty blob doesn't have the range of the first chunk.
+      if (options.Range.HasValue()
+          || e.StatusCode != Core::Http::HttpStatusCode::RangeNotSatisfiable)
+      {
+        throw;
+      }
+      firstChunkOptions.Range.Reset();
+      firstChunkOptions.RangeHashAlgorithm.Reset();
+      firstChunk = Download(firstChunkOptions, span.GetContext());
+    }
+    const Azure::ETag eTag = firstChunk.Value().Value.Details.ETag;
+
+    int64_t rangeLength = firstChunk.Value().Value.BlobSize - rangeOffset;
+    if (options.Range.HasValue() && options.Range.Value().Length.HasValue())
+    {
+      rangeLength = std::min(rangeLength, options.Range.Value().Length.Value());
+    }
+    rangeLength = std::max<int64_t>(rangeLength, 0);
+    firstChunkLength = std::min(firstChunkLength, rangeLength);
+    _internal::TransferProgress progress(nullptr, 0);
+
+    // Reads the body of a chunk into a pooled buffer, and passes it to the handler.
+    auto readChunk = [&](Models::DownloadBlobResult& chunk,
+                         int64_t offset,
+                         int64_t length,
+                         Crc64Hash* chunkCrc64) {
+      if (length == 0)
+      {
+        ReadChunk(chunk, chunkCrc64, progress, [](Azure::Core::IO::BodyStream&) {});
+        return;
+      }
+      _internal::PooledBuffer buffer(
+          m_bufferPool, static_cast<size_t>(length), span.GetContext());
+      ReadChunk(chunk, chunkCrc64, progress, [&](Azure::Core::IO::BodyStream& bodyStream) {
+        if (bodyStream.ReadToCount(buffer.Data(), buffer.Size(), span.GetContext())
+            != buffer.Size())
+        {
+          throw Azure::Core::RequestFailedException("Error when reading body stream.");
+        }
+      });
+      chunk.BodyStream.reset();
+      onChunk(offset, buffer.Data(), buffer.Size());
+    };
+    Crc64Hash firstChunkCrc64;
+    readChunk(
+        firstChunk.Value().Value,
+        rangeOffset,
+        firstChunkLength,
+        options.ValidateContentCrc64 ? &firstChunkCrc64 : nullptr);
+
+    // The CRC64 of each chunk by chunk ID, to be concatenated in order once they are all
+    // downloaded.
+    std::map<int64_t, Crc64Hash> chunkCrc64s;
+    std::mutex chunkCrc64sMutex;
+    auto downloadChunkFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
+      DownloadBlobOptions chunkOptions;
+      chunkOptions.Range = Core::Http::HttpRange();
+      chunkOptions.Range.Value().Offset = offset;
+      chunkOptions.Range.Value().Length = length;
+      chunkOptions.AccessConditions.IfMatch = eTag;
+      chunkOptions.RangeHashAlgorithm = firstChunkOptions.RangeHashAlgorithm;
+      auto chunk = Download(chunkOptions, span.GetContext());
+      Crc64Hash* chunkCrc64 = nullptr;
+      if (options.ValidateContentCrc64)
+      {
+        std::lock_guard<std::mutex> guard(chunkCrc64sMutex);
+        chunkCrc64 = &chunkCrc64s[chunkId];
+      }
+      readChunk(chunk.Value, offset, length, chunkCrc64);
+    };
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = chunkSize;
+    transferOptions.Concurrency = options.Concurrency;
+    transferOptions.AutoTune = options.AutoTune;
+    _internal::ConcurrentTransfer(
+        rangeOffset + firstChunkLength,
+        rangeLength - firstChunkLength,
+        transferOptions,
+        downloadChunkFunc,
+        m_transferExecutor);
+
+    Models::DownloadBlobToResult ret;
+    ret.BlobType = std::move(firstChunk.Value().Value.BlobType);
+    ret.ContentRange.Offset = rangeOffset;
+    ret.ContentRange.Length = rangeLength;
+    ret.BlobSize = firstChunk.Value().Value.BlobSize;
+    ret.Details = std::move(firstChunk.Value().Value.Details);
+    if (options.ValidateContentCrc64)
+    {
+      ret.TransactionalContentHash = ConcatenateCrc64(firstChunkCrc64, chunkCrc64s);
+    }
+    return Azure::Response<Models::DownloadBlobToResult>(
+        std::move(ret), std::move(firstChunk.Value().RawResponse));
+  }
+
   Azure::Response<Models::BlobProperties> BlobClient::GetProperties(
       const GetBlobPropertiesOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.GetProperties", context);
     _detail::BlobRestClient::Blob::GetBlobPropertiesOptions protocolLayerOptions;
     protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
     protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
@@ -456,7 +1710,10 @@ namespace Azure { namespace Storage { namespace Blobs {
       protocolLayerOptions.EncryptionAlgorithm = m_customerProvidedKey.Value().Algorithm;
     }
     auto response = _detail::BlobRestClient::Blob::GetProperties(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, _internal::WithReplicaStatus(context));
+        *m_pipeline,
+        m_blobUrl,
+        protocolLayerOptions,
+        _internal::WithReplicaStatus(span.GetContext()));
     if (response.Value.AccessTier.HasValue() && !response.Value.IsAccessTierInferred.HasValue())
     {
       response.Value.IsAccessTierInferred = false;
@@ -482,6 +1739,7 @@ namespace Azure { namespace Storage { namespace Blobs {
       const SetBlobHttpHeadersOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.SetHttpHeaders", context);
     _detail::BlobRestClient::Blob::SetBlobHttpHeadersOptions protocolLayerOptions;
     protocolLayerOptions.HttpHeaders = std::move(httpHeaders);
     protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
@@ -491,7 +1749,7 @@ namespace Azure { namespace Storage { namespace Blobs {
     protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
     protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
     return _detail::BlobRestClient::Blob::SetHttpHeaders(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::SetBlobMetadataResult> BlobClient::SetMetadata(
@@ -499,6 +1757,7 @@ namespace Azure { namespace Storage { namespace Blobs {
       const SetBlobMetadataOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.SetMetadata", context);
     _detail::BlobRestClient::Blob::SetBlobMetadataOptions protocolLayerOptions;
     protocolLayerOptions.Metadata = std::move(metadata);
     protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
@@ -515,7 +1774,7 @@ namespace Azure { namespace Storage { namespace Blobs {
     }
     protocolLayerOptions.EncryptionScope = m_encryptionScope;
     return _detail::BlobRestClient::Blob::SetMetadata(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::SetBlobAccessTierResult> BlobClient::SetAccessTier(
@@ -523,13 +1782,14 @@ namespace Azure { namespace Storage { namespace Blobs {
       const SetBlobAccessTierOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.SetAccessTier", context);
     _detail::BlobRestClient::Blob::SetBlobAccessTierOptions protocolLayerOptions;
     protocolLayerOptions.AccessTier = tier;
     protocolLayerOptions.RehydratePriority = options.RehydratePriority;
     protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
     protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
     return _detail::BlobRestClient::Blob::SetAccessTier(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::CopyBlobFromUriResult> BlobClient::CopyFromUri(
@@ -537,6 +1797,7 @@ namespace Azure { namespace Storage { namespace Blobs {
       const CopyBlobFromUriOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.CopyFromUri", context);
     _detail::BlobRestClient::Blob::CopyBlobFromUriOptions protocolLayerOptions;
     protocolLayerOptions.Metadata = options.Metadata;
     protocolLayerOptions.Tags = options.Tags;
@@ -561,7 +1822,7 @@ namespace Azure { namespace Storage { namespace Blobs {
     }
 
     return _detail::BlobRestClient::Blob::CopyFromUri(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
   }
 
   StartBlobCopyOperation BlobClient::StartCopyFromUri(
@@ -569,6 +1830,7 @@ namespace Azure { namespace Storage { namespace Blobs {
       const StartBlobCopyFromUriOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.StartCopyFromUri", context);
     _detail::BlobRestClient::Blob::StartBlobCopyFromUriOptions protocolLayerOptions;
     protocolLayerOptions.Metadata = options.Metadata;
     protocolLayerOptions.Tags = options.Tags;
@@ -590,7 +1852,7 @@ namespace Azure { namespace Storage { namespace Blobs {
     protocolLayerOptions.SourceIfTags = options.SourceAccessConditions.TagConditions;
 
     auto response = _detail::BlobRestClient::Blob::StartCopyFromUri(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
     StartBlobCopyOperation res;
     res.m_rawResponse = std::move(response.RawResponse);
     res.m_blobClient = std::make_shared<BlobClient>(*this);
@@ -602,17 +1864,57 @@ namespace Azure { namespace Storage { namespace Blobs {
       const AbortBlobCopyFromUriOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.AbortCopyFromUri", context);
     _detail::BlobRestClient::Blob::AbortBlobCopyFromUriOptions protocolLayerOptions;
     protocolLayerOptions.CopyId = copyId;
     protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
     return _detail::BlobRestClient::Blob::AbortCopyFromUri(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
+  }
+
+  std::unique_ptr<BlobReadStream> BlobClient::OpenRead(
+      const OpenReadOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.OpenRead", context);
+    if (options.TransferOptions.ChunkSize <= 0)
+    {
+      throw Azure::Core::RequestFailedException("Chunk size must be positive.");
+    }
+    if (options.TransferOptions.Concurrency <= 0)
+    {
+      throw Azure::Core::RequestFailedException("Concurrency must be positive.");
+    }
+
+    GetBlobPropertiesOptions propertiesOptions;
+    propertiesOptions.AccessConditions = options.AccessConditions;
+    auto properties = GetProperties(propertiesOptions, span.GetContext());
+
+    const int64_t blobSize = properties.Value.BlobSize;
+    int64_t offset = 0;
+    int64_t length = blobSize;
+    if (options.Range.HasValue())
+    {
+      offset = std::min(options.Range.Value().Offset, blobSize);
+      length = blobSize - offset;
+      if (options.Range.Value().Length.HasValue())
+      {
+        length = std::min(length, options.Range.Value().Length.Value());
+      }
+    }
+
+    // The ranges are read from the version of the blob the stream is opened on.
+    OpenReadOptions streamOptions = options;
+    streamOptions.AccessConditions.IfMatch = properties.Value.ETag;
+    return std::unique_ptr<BlobReadStream>(
+        new BlobReadStream(*this, streamOptions, offset, length, span.GetContext()));
   }
 
   Azure::Response<Models::CreateBlobSnapshotResult> BlobClient::CreateSnapshot(
       const CreateBlobSnapshotOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.CreateSnapshot", context);
     _detail::BlobRestClient::Blob::CreateBlobSnapshotOptions protocolLayerOptions;
     protocolLayerOptions.Metadata = options.Metadata;
     protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
@@ -629,54 +1931,49 @@ namespace Azure { namespace Storage { namespace Blobs {
     }
     protocolLayerOptions.EncryptionScope = m_encryptionScope;
     return _detail::BlobRestClient::Blob::CreateSnapshot(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::DeleteBlobResult> BlobClient::Delete(
       const DeleteBlobOptions& options,
       const Azure::Core::Context& context) const
   {
-    _detail::BlobRestClient::Blob::DeleteBlobOptions protocolLayerOptions;
-    protocolLayerOptions.DeleteSnapshots = options.DeleteSnapshots;
-    protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
-    protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
-    protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
-    protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
-    protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
-    protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.Delete", context);
     return _detail::BlobRestClient::Blob::Delete(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, GetDeleteProtocolLayerOptions(options), span.GetContext());
   }
 
   Azure::Response<Models::DeleteBlobResult> BlobClient::DeleteIfExists(
       const DeleteBlobOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.DeleteIfExists", context);
+    auto request = _detail::BlobRestClient::Blob::DeleteCreateMessage(
+        m_blobUrl, GetDeleteProtocolLayerOptions(options));
+    auto response = m_pipeline->Send(request, span.GetContext());
+    // A missing blob is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response,
+            Core::Http::HttpStatusCode::NotFound,
+            {"BlobNotFound", "ContainerNotFound"}))
     {
-      return Delete(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.StatusCode == Core::Http::HttpStatusCode::NotFound
-          && (e.ErrorCode == "BlobNotFound" || e.ErrorCode == "ContainerNotFound"))
-      {
-        Models::DeleteBlobResult ret;
-        ret.Deleted = false;
-        return Azure::Response<Models::DeleteBlobResult>(std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::DeleteBlobResult ret;
+      ret.Deleted = false;
+      return Azure::Response<Models::DeleteBlobResult>(std::move(ret), std::move(response));
     }
+    return _detail::BlobRestClient::Blob::DeleteCreateResponse(
+        std::move(response), span.GetContext());
   }
 
   Azure::Response<Models::UndeleteBlobResult> BlobClient::Undelete(
       const UndeleteBlobOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.Undelete", context);
     (void)options;
     _detail::BlobRestClient::Blob::UndeleteBlobOptions protocolLayerOptions;
     return _detail::BlobRestClient::Blob::Undelete(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::SetBlobTagsResult> BlobClient::SetTags(
@@ -684,21 +1981,26 @@ namespace Azure { namespace Storage { namespace Blobs {
       const SetBlobTagsOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.SetTags", context);
     _detail::BlobRestClient::Blob::SetBlobTagsOptions protocolLayerOptions;
     protocolLayerOptions.Tags = std::move(tags);
     protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
     return _detail::BlobRestClient::Blob::SetTags(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<std::map<std::string, std::string>> BlobClient::GetTags(
       const GetBlobTagsOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("BlobClient.GetTags", context);
     _detail::BlobRestClient::Blob::GetBlobTagsOptions protocolLayerOptions;
     protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
     auto response = _detail::BlobRestClient::Blob::GetTags(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, _internal::WithReplicaStatus(context));
+        *m_pipeline,
+        m_blobUrl,
+        protocolLayerOptions,
+        _internal::WithReplicaStatus(span.GetContext()));
     return Azure::Response<std::map<std::string, std::string>>(
         std::move(response.Value.Tags), std::move(response.RawResponse));
   }
@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/blob_client_side_encryption.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include <azure/core/base64.hpp>
+#include <azure/core/exception.hpp>
+#include <azure/core/internal/json/json.hpp>
+
+#include "private/client_side_encryptor.hpp"
+#include "private/package_version.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace _detail {
+
+    using Azure::Core::Json::_internal::json;
+
+    struct BlobClientSideEncryptionState final
+    {
+      std::mutex Mutex;
+      std::shared_ptr<const ContentEncryptionKey> UploadKey;
+      // The unwrapped content keys, by their wrapped form.
+      std::map<std::string, std::shared_ptr<const Storage::_internal::AesGcmKey>> DownloadKeys;
+    };
+
+    namespace {
+      constexpr const char* ProtocolVersion = "2.0";
+      constexpr const char* EncryptionAlgorithm = "AES_GCM_256";
+      // The content key is wrapped after the protocol version, padded to 8 bytes, so that a
+      // wrapped key can't be replayed with another version.
+      constexpr size_t WrappedProtocolVersionSize = 8;
+      // The number of unwrapped content keys kept, they are all dropped once there's more.
+      constexpr size_t MaxDownloadKeys = 256;
+
+      std::vector<uint8_t> GetKeyWrapPayload(const std::vector<uint8_t>& key)
+      {
+        std::vector<uint8_t> payload(WrappedProtocolVersionSize, 0);
+        std::copy(
+            ProtocolVersion, ProtocolVersion + std::char_traits<char>::length(ProtocolVersion),
+            payload.begin());
+        payload.insert(payload.end(), key.begin(), key.end());
+        return payload;
+      }
+
+      std::string GetStringField(const json& object, const char* name)
+      {
+        auto ite = object.find(name);
+        if (ite == object.end() || !ite->is_string())
+        {
+          throw std::runtime_error(
+              std::string("The encryption data of the blob has no ") + name + ".");
+        }
+        return ite->get<std::string>();
+      }
+
+      const json& GetObjectField(const json& object, const char* name)
+      {
+        auto ite = object.find(name);
+        if (ite == object.end() || !ite->is_object())
+        {
+          throw std::runtime_error(
+              std::string("The encryption data of the blob has no ") + name + ".");
+        }
+        return *ite;
+      }
+    } // namespace
+
+    constexpr int64_t ClientSideEncryptor::RegionLength;
+    constexpr int64_t ClientSideEncryptor::RegionOverhead;
+
+    std::shared_ptr<const ContentEncryptionKey> ClientSideEncryptor::GetUploadKey(
+        const BlobClientSideEncryption& encryption,
+        const Azure::Core::Context& context)
+    {
+      auto& state = *encryption.m_state;
+      // The lock is held while the key is wrapped, so that concurrent uploads wrap it once.
+      std::lock_guard<std::mutex> guard(state.Mutex);
+      if (state.UploadKey)
+      {
+        return state.UploadKey;
+      }
+
+      std::vector<uint8_t> key(Storage::_internal::AesGcmKey::KeySize);
+      Storage::_internal::FillSecureRandomBytes(key.data(), key.size());
+      auto uploadKey = std::make_shared<ContentEncryptionKey>(key);
+      const auto wrappedKey = encryption.m_keyEncryptionKey->WrapKey(
+          encryption.m_keyWrapAlgorithm, GetKeyWrapPayload(key), context);
+      std::fill(key.begin(), key.end(), static_cast<uint8_t>(0));
+
+      json encryptionData;
+      encryptionData["EncryptionMode"] = "FullBlob";
+      encryptionData["WrappedContentKey"]["KeyId"]
+          = encryption.m_keyEncryptionKey->GetKeyId();
+      encryptionData["WrappedContentKey"]["EncryptedKey"]
+          = Azure::Core::Convert::Base64Encode(wrappedKey);
+      encryptionData["WrappedContentKey"]["Algorithm"] = encryption.m_keyWrapAlgorithm;
+      encryptionData["EncryptionAgent"]["Protocol"] = ProtocolVersion;
+      encryptionData["EncryptionAgent"]["EncryptionAlgorithm"] = EncryptionAlgorithm;
+      encryptionData["EncryptedRegionInfo"]["DataLength"] = RegionLength;
+      encryptionData["EncryptedRegionInfo"]["NonceLength"]
+          = Storage::_internal::AesGcmKey::NonceSize;
+      encryptionData["KeyWrappingMetadata"]["EncryptionLibrary"]
+          = std::string("azsdk-cpp-storage-blobs/") + PackageVersion::ToString();
+      uploadKey->EncryptionData = encryptionData.dump();
+
+      state.UploadKey = uploadKey;
+      return uploadKey;
+    }
+
+    ContentDecryptionKey ClientSideEncryptor::GetDownloadKey(
+        const BlobClientSideEncryption& encryption,
+        const std::string& encryptionData,
+        const Azure::Core::Context& context)
+    {
+      json encryptionDataJson;
+      try
+      {
+        encryptionDataJson = json::parse(encryptionData);
+      }
+      catch (json::exception&)
+      {
+        throw std::runtime_error("The encryption data of the blob is not valid JSON.");
+      }
+      if (!encryptionDataJson.is_object())
+      {
+        throw std::runtime_error("The encryption data of the blob is not a JSON object.");
+      }
+      const auto& agent = GetObjectField(encryptionDataJson, "EncryptionAgent");
+      if (GetStringField(agent, "Protocol") != ProtocolVersion
+          || GetStringField(agent, "EncryptionAlgorithm") != EncryptionAlgorithm)
+      {
+        throw std::runtime_error(
+            "The blob is encrypted with an unsupported version of the client-side encryption.");
+      }
+      const auto& regionInfo = GetObjectField(encryptionDataJson, "EncryptedRegionInfo");
+      auto dataLength = regionInfo.find("DataLength");
+      auto nonceLength = regionInfo.find("NonceLength");
+      if (dataLength == regionInfo.end() || !dataLength->is_number_integer()
+          || dataLength->get<int64_t>() <= 0 || nonceLength == regionInfo.end()
+          || !nonceLength->is_number_integer()
+          || nonceLength->get<int64_t>()
+              != static_cast<int64_t>(Storage::_internal::AesGcmKey::NonceSize))
+      {
+        throw std::runtime_error("The encryption data of the blob has invalid region info.");
+      }
+      const auto& wrappedContentKey = GetObjectField(encryptionDataJson, "WrappedContentKey");
+      const std::string keyId = GetStringField(wrappedContentKey, "KeyId");
+      if (keyId != encryption.m_keyEncryptionKey->GetKeyId())
+      {
+        throw std::runtime_error(
+            "The blob is encrypted with another key encryption key, " + keyId + ".");
+      }
+      const std::string encryptedKey = GetStringField(wrappedContentKey, "EncryptedKey");
+
+      ContentDecryptionKey downloadKey;
+      downloadKey.RegionLength = dataLength->get<int64_t>();
+      auto& state = *encryption.m_state;
+      {
+        std::lock_guard<std::mutex> guard(state.Mutex);
+        auto ite = state.DownloadKeys.find(encryptedKey);
+        if (ite != state.DownloadKeys.end())
+        {
+          downloadKey.Key = ite->second;
+          return downloadKey;
+        }
+      }
+
+      auto payload = encryption.m_keyEncryptionKey->UnwrapKey(
+          GetStringField(wrappedContentKey, "Algorithm"),
+          Azure::Core::Convert::Base64Decode(encryptedKey),
+          context);
+      const auto expectedPrefix = GetKeyWrapPayload(std::vector<uint8_t>());
+      if (payload.size() != WrappedProtocolVersionSize + Storage::_internal::AesGcmKey::KeySize
+          || !std::equal(expectedPrefix.begin(), expectedPrefix.end(), payload.begin()))
+      {
+        throw std::runtime_error("The content key of the blob is not valid.");
+      }
+      downloadKey.Key = std::make_shared<const Storage::_internal::AesGcmKey>(
+          std::vector<uint8_t>(payload.begin() + WrappedProtocolVersionSize, payload.end()));
+      std::fill(payload.begin(), payload.end(), static_cast<uint8_t>(0));
+
+      std::lock_guard<std::mutex> guard(state.Mutex);
+      if (state.DownloadKeys.size() >= MaxDownloadKeys)
+      {
+        state.DownloadKeys.clear();
+      }
+      state.DownloadKeys.emplace(encryptedKey, downloadKey.Key);
+      return downloadKey;
+    }
+
+    std::vector<uint8_t> ClientSideEncryptor::EncryptRegions(
+        const Storage::_internal::AesGcmKey& key,
+        const uint8_t* data,
+        size_t length)
+    {
+      const size_t regionLength = static_cast<size_t>(RegionLength);
+      const size_t numRegions = (length + regionLength - 1) / regionLength;
+      std::vector<uint8_t> encrypted(length + numRegions * static_cast<size_t>(RegionOverhead));
+      uint8_t* output = encrypted.data();
+      for (size_t offset = 0; offset < length; offset += regionLength)
+      {
+        const size_t chunkLength = std::min(regionLength, length - offset);
+        uint8_t* nonce = output;
+        uint8_t* ciphertext = nonce + Storage::_internal::AesGcmKey::NonceSize;
+        uint8_t* tag = ciphertext + chunkLength;
+        Storage::_internal::FillSecureRandomBytes(nonce, Storage::_internal::AesGcmKey::NonceSize);
+        key.Encrypt(nonce, data + offset, chunkLength, ciphertext, tag);
+        output = tag + Storage::_internal::AesGcmKey::TagSize;
+      }
+      return encrypted;
+    }
+
+    void ClientSideEncryptor::DecryptRegion(
+        const Storage::_internal::AesGcmKey& key,
+        const uint8_t* region,
+        size_t regionLength,
+        uint8_t* data)
+    {
+      if (regionLength < static_cast<size_t>(RegionOverhead))
+      {
+        throw Azure::Core::RequestFailedException(
+            "An encrypted region of the blob is truncated.");
+      }
+      const size_t length = regionLength - static_cast<size_t>(RegionOverhead);
+      const uint8_t* ciphertext = region + Storage::_internal::AesGcmKey::NonceSize;
+      if (!key.Decrypt(region, ciphertext, length, ciphertext + length, data))
+      {
+        throw Azure::Core::RequestFailedException(
+            "An encrypted region of the blob failed authentication.");
+      }
+    }
+
+    int64_t ClientSideEncryptor::GetDecryptedLength(int64_t encryptedLength, int64_t regionLength)
+    {
+      const int64_t encryptedRegionLength = regionLength + RegionOverhead;
+      const int64_t fullRegions = encryptedLength / encryptedRegionLength;
+      const int64_t lastRegionLength = encryptedLength % encryptedRegionLength;
+      if (lastRegionLength != 0 && lastRegionLength <= RegionOverhead)
+      {
+        throw Azure::Core::RequestFailedException("The encrypted blob is truncated.");
+      }
+      return fullRegions * regionLength
+          + (lastRegionLength == 0 ? 0 : lastRegionLength - RegionOverhead);
+    }
+
+  } // namespace _detail
+
+  BlobClientSideEncryption::BlobClientSideEncryption(
+      std::shared_ptr<KeyEncryptionKey> keyEncryptionKey,
+      std::string keyWrapAlgorithm)
+      : m_keyEncryptionKey(std::move(keyEncryptionKey)),
+        m_keyWrapAlgorithm(std::move(keyWrapAlgorithm)),
+        m_state(std::make_shared<_detail::BlobClientSideEncryptionState>())
+  {
+    if (!m_keyEncryptionKey)
+    {
+      throw std::invalid_argument("keyEncryptionKey cannot be null.");
+    }
+  }
+
+  BlobClientSideEncryption::~BlobClientSideEncryption() {}
+
+}}} // namespace Azure::Storage::Blobs
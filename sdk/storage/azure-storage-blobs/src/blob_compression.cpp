@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "private/blob_compression.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include <azure/core/exception.hpp>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace _detail {
+
+  namespace {
+    // The gzip format of zlib, with the largest window.
+    constexpr int GzipWindowBits = 16 + MAX_WBITS;
+    // The lengths given to zlib are limited to uInt.
+    constexpr size_t MaxZlibLength = 1024 * 1024 * 1024;
+
+    uInt NextZlibLength(size_t remaining)
+    {
+      return static_cast<uInt>(std::min(remaining, MaxZlibLength));
+    }
+  } // namespace
+
+  std::vector<uint8_t> GzipCompress(const uint8_t* data, size_t length)
+  {
+    z_stream stream{};
+    if (deflateInit2(
+            &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GzipWindowBits, 8, Z_DEFAULT_STRATEGY)
+        != Z_OK)
+    {
+      throw std::runtime_error("Failed to initialize gzip compression.");
+    }
+
+    // The compressed data of incompressible content is a bit larger than the content.
+    std::vector<uint8_t> compressed(length + length / 1000 + 64);
+    size_t inputOffset = 0;
+    size_t outputOffset = 0;
+    int ret = Z_OK;
+    while (ret != Z_STREAM_END)
+    {
+      if (outputOffset == compressed.size())
+      {
+        compressed.resize(compressed.size() * 2);
+      }
+      stream.next_in = const_cast<Bytef*>(data + inputOffset);
+      stream.avail_in = NextZlibLength(length - inputOffset);
+      stream.next_out = compressed.data() + outputOffset;
+      stream.avail_out = NextZlibLength(compressed.size() - outputOffset);
+      const uInt availIn = stream.avail_in;
+      const uInt availOut = stream.avail_out;
+      const bool lastInput = length - inputOffset == availIn;
+      ret = deflate(&stream, lastInput ? Z_FINISH : Z_NO_FLUSH);
+      inputOffset += availIn - stream.avail_in;
+      outputOffset += availOut - stream.avail_out;
+      if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+      {
+        deflateEnd(&stream);
+        throw std::runtime_error("Failed to compress data.");
+      }
+    }
+    deflateEnd(&stream);
+    compressed.resize(outputOffset);
+    return compressed;
+  }
+
+  void GzipDecompress(const uint8_t* data, size_t length, uint8_t* output, size_t outputLength)
+  {
+    z_stream stream{};
+    if (inflateInit2(&stream, GzipWindowBits) != Z_OK)
+    {
+      throw std::runtime_error("Failed to initialize gzip decompression.");
+    }
+
+    size_t inputOffset = 0;
+    size_t outputOffset = 0;
+    int ret = Z_OK;
+    while (ret == Z_OK)
+    {
+      stream.next_in = const_cast<Bytef*>(data + inputOffset);
+      stream.avail_in = NextZlibLength(length - inputOffset);
+      stream.next_out = output + outputOffset;
+      stream.avail_out = NextZlibLength(outputLength - outputOffset);
+      const uInt availIn = stream.avail_in;
+      const uInt availOut = stream.avail_out;
+      ret = inflate(&stream, Z_NO_FLUSH);
+      inputOffset += availIn - stream.avail_in;
+      outputOffset += availOut - stream.avail_out;
+      if (ret == Z_OK && availIn == stream.avail_in && availOut == stream.avail_out)
+      {
+        // No progress, the stream is truncated or larger than the output.
+        break;
+      }
+    }
+    inflateEnd(&stream);
+    if (ret != Z_STREAM_END || inputOffset != length || outputOffset != outputLength)
+    {
+      throw Azure::Core::RequestFailedException(
+          "The content of a compressed block of the blob is corrupted.");
+    }
+  }
+
+}}}} // namespace Azure::Storage::Blobs::_detail
@@ -3,11 +3,25 @@
 
 #include "azure/storage/blobs/blob_container_client.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
 #include <azure/core/http/policies/policy.hpp>
+#include <azure/core/platform.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
 #include <azure/storage/common/internal/constants.hpp>
+#include <azure/storage/common/internal/file_io.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
@@ -15,10 +29,225 @@
 #include "azure/storage/blobs/block_blob_client.hpp"
 #include "azure/storage/blobs/page_blob_client.hpp"
 
+#include "private/blob_download_cache_policy.hpp"
 #include "private/package_version.hpp"
 
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    constexpr int64_t MaxUploadBlobSize = 5000 * 1024 * 1024ULL;
+    constexpr int64_t MaxStageBlockSize = 4000 * 1024 * 1024ULL;
+    constexpr int64_t MaxBlockNumber = 50000;
+
+    std::string GetBlockId(int64_t id)
+    {
+      constexpr size_t BlockIdLength = 64;
+      std::string blockId = std::to_string(id);
+      blockId = std::string(BlockIdLength - blockId.length(), '0') + blockId;
+      return Azure::Core::Convert::Base64Encode(
+          std::vector<uint8_t>(blockId.begin(), blockId.end()));
+    }
+
+    // Whether a file named after the rest of the name of a blob stays in the directory it's
+    // downloaded to.
+    bool IsInDirectory(const std::string& relativePath)
+    {
+      if (relativePath.empty() || relativePath[0] == '/' || relativePath[0] == '\\')
+      {
+        return false;
+      }
+#if defined(AZ_PLATFORM_WINDOWS)
+      if (relativePath.find(':') != std::string::npos)
+      {
+        return false;
+      }
+#endif
+      size_t segmentStart = 0;
+      while (true)
+      {
+        const size_t segmentEnd = relativePath.find_first_of("/\\", segmentStart);
+        if (relativePath.compare(segmentStart, segmentEnd - segmentStart, "..") == 0)
+        {
+          return false;
+        }
+        if (segmentEnd == std::string::npos)
+        {
+          return true;
+        }
+        segmentStart = segmentEnd + 1;
+      }
+    }
+
+    // Records the files transferred by UploadDirectory() and DownloadDirectory(), one line each,
+    // so that a transfer started again skips them. The lines are written as the files are done,
+    // a last line cut short by a crash is written over.
+    class TransferJournal final {
+    public:
+      explicit TransferJournal(const std::string& path)
+      {
+        if (path.empty())
+        {
+          return;
+        }
+        m_writer = std::make_unique<_internal::FileWriter>(
+            path, _internal::FileIoMode::Buffered, false);
+        _internal::FileReader reader(path);
+        if (reader.GetFileSize() == 0)
+        {
+          return;
+        }
+        Azure::Core::IO::_internal::RandomAccessFileBodyStream stream(
+            reader.GetHandle(), 0, reader.GetFileSize());
+        const auto content = stream.ReadToEnd();
+        auto lineStart = content.begin();
+        for (auto lineEnd = std::find(lineStart, content.end(), '\n'); lineEnd != content.end();
+             lineEnd = std::find(lineStart, content.end(), '\n'))
+        {
+          m_entries.emplace(lineStart, lineEnd);
+          lineStart = lineEnd + 1;
+        }
+        m_size = static_cast<int64_t>(lineStart - content.begin());
+      }
+
+      // Whether the previous transfers recorded the entry.
+      bool Contains(const std::string& entry) const { return m_entries.count(entry) != 0; }
+
+      void Add(const std::string& entry)
+      {
+        if (!m_writer)
+        {
+          return;
+        }
+        const std::string line = entry + "\n";
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_writer->Write(reinterpret_cast<const uint8_t*>(line.data()), line.length(), m_size);
+        m_size += static_cast<int64_t>(line.length());
+      }
+
+    private:
+      std::unordered_set<std::string> m_entries;
+      std::unique_ptr<_internal::FileWriter> m_writer;
+      std::mutex m_mutex;
+      int64_t m_size = 0;
+    };
+
+    // A file uploaded in blocks, shared by the tasks uploading its blocks.
+    struct FileUpload final
+    {
+      FileUpload(
+          BlockBlobClient blobClient,
+          std::shared_ptr<_internal::FileReader> fileReader,
+          std::string journalEntry,
+          int64_t blockSize)
+          : BlobClient(std::move(blobClient)), FileReader(std::move(fileReader)),
+            JournalEntry(std::move(journalEntry)), BlockSize(blockSize),
+            NumBlocks((FileReader->GetFileSize() + blockSize - 1) / blockSize),
+            NumPendingBlocks(NumBlocks)
+      {
+      }
+
+      BlockBlobClient BlobClient;
+      std::shared_ptr<_internal::FileReader> FileReader;
+      std::string JournalEntry;
+      int64_t BlockSize;
+      int64_t NumBlocks;
+      std::atomic<int64_t> NumPendingBlocks;
+    };
+
+    // A blob downloaded in chunks, shared by the tasks downloading its chunks.
+    struct FileDownload final
+    {
+      FileDownload(
+          Blobs::BlobClient blobClient,
+          const std::string& fileName,
+          Azure::ETag eTag,
+          std::string journalEntry,
+          int64_t blobSize,
+          int64_t chunkSize)
+          : BlobClient(std::move(blobClient)), FileWriter(fileName), ETag(std::move(eTag)),
+            JournalEntry(std::move(journalEntry)), BlobSize(blobSize), ChunkSize(chunkSize),
+            NumChunks((blobSize + chunkSize - 1) / chunkSize), NumPendingChunks(NumChunks)
+      {
+      }
+
+      Blobs::BlobClient BlobClient;
+      _internal::FileWriter FileWriter;
+      Azure::ETag ETag;
+      std::string JournalEntry;
+      int64_t BlobSize;
+      int64_t ChunkSize;
+      int64_t NumChunks;
+      std::atomic<int64_t> NumPendingChunks;
+    };
+
+    // Calls getFunc with the client of each blob, with up to concurrency calls at the same time,
+    // and passes what it returns to onResult, or null if the blob doesn't exist. The names given
+    // more than once are coalesced into a single call.
+    template <class T>
+    void ForEachBlobConcurrently(
+        const BlobContainerClient& containerClient,
+        const std::vector<std::string>& blobNames,
+        int32_t concurrency,
+        const std::function<Azure::Response<T>(const BlobClient&)>& getFunc,
+        const std::function<void(const std::string&, Azure::Nullable<T>)>& onResult,
+        const std::shared_ptr<TransferExecutor>& executor)
+    {
+      std::unordered_set<std::string> requestedNames;
+      size_t nextName = 0;
+      _internal::ConcurrentStreamTransfer(
+          concurrency,
+          [&](int64_t) -> std::function<void()> {
+            while (nextName < blobNames.size())
+            {
+              const std::string& blobName = blobNames[nextName++];
+              if (!requestedNames.insert(blobName).second)
+              {
+                continue;
+              }
+              return [&, blobClient = containerClient.GetBlobClient(blobName)]() {
+                Azure::Nullable<T> result;
+                try
+                {
+                  result = std::move(getFunc(blobClient).Value);
+                }
+                catch (StorageException& e)
+                {
+                  if (e.StatusCode != Core::Http::HttpStatusCode::NotFound)
+                  {
+                    throw;
+                  }
+                }
+                onResult(blobName, std::move(result));
+              };
+            }
+            return nullptr;
+          },
+          executor);
+    }
+
+    _detail::BlobRestClient::BlobContainer::CreateBlobContainerOptions
+    GetCreateProtocolLayerOptions(const CreateBlobContainerOptions& options)
+    {
+      _detail::BlobRestClient::BlobContainer::CreateBlobContainerOptions protocolLayerOptions;
+      protocolLayerOptions.AccessType = options.AccessType;
+      protocolLayerOptions.Metadata = options.Metadata;
+      protocolLayerOptions.DefaultEncryptionScope = options.DefaultEncryptionScope;
+      protocolLayerOptions.PreventEncryptionScopeOverride
+          = options.PreventEncryptionScopeOverride;
+      return protocolLayerOptions;
+    }
+
+    _detail::BlobRestClient::BlobContainer::DeleteBlobContainerOptions
+    GetDeleteProtocolLayerOptions(const DeleteBlobContainerOptions& options)
+    {
+      _detail::BlobRestClient::BlobContainer::DeleteBlobContainerOptions protocolLayerOptions;
+      protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+      protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
+      protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
+      return protocolLayerOptions;
+    }
+  } // namespace
+
   BlobContainerClient BlobContainerClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& blobContainerName,
@@ -52,16 +281,32 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_blobContainerUrl.GetHost(), newOptions.SecondaryHostForRetryReads));
+        m_blobContainerUrl.GetHost(),
+        newOptions.SecondaryHostForRetryReads,
+        newOptions.SecondaryReadBalancer));
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion));
+    if (newOptions.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(newOptions.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, newOptions.ApiVersion}});
   }
 
   BlobContainerClient::BlobContainerClient(
@@ -73,7 +318,19 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_blobContainerUrl.GetHost(), options.SecondaryHostForRetryReads));
+        m_blobContainerUrl.GetHost(),
+        options.SecondaryHostForRetryReads,
+        options.SecondaryReadBalancer));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
     {
       Azure::Core::Credentials::TokenRequestContext tokenContext;
@@ -82,126 +339,140 @@ namespace Azure { namespace Storage { namespace Blobs {
           std::make_unique<Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
               credential, tokenContext));
     }
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
+    if (options.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(options.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   BlobContainerClient::BlobContainerClient(
       const std::string& blobContainerUrl,
       const BlobClientOptions& options)
       : m_blobContainerUrl(blobContainerUrl), m_customerProvidedKey(options.CustomerProvidedKey),
-        m_encryptionScope(options.EncryptionScope)
+        m_encryptionScope(options.EncryptionScope), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_blobContainerUrl.GetHost(), options.SecondaryHostForRetryReads));
+        m_blobContainerUrl.GetHost(),
+        options.SecondaryHostForRetryReads,
+        options.SecondaryReadBalancer));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
+    if (options.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(options.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   BlobClient BlobContainerClient::GetBlobClient(const std::string& blobName) const
   {
     auto blobUrl = m_blobContainerUrl;
     blobUrl.AppendPath(_internal::UrlEncodePath(blobName));
-    return BlobClient(std::move(blobUrl), m_pipeline, m_customerProvidedKey, m_encryptionScope);
+    return BlobClient(
+        std::move(blobUrl),
+        m_pipeline,
+        m_customerProvidedKey,
+        m_encryptionScope,
+        m_transferExecutor,
+        m_bufferPool);
   }
 
   BlockBlobClient BlobContainerClient::GetBlockBlobClient(const std::string& blobName) const
   {
-    return GetBlobClient(blobName).AsBlockBlobClient();
+    return BlockBlobClient(GetBlobClient(blobName));
   }
 
   AppendBlobClient BlobContainerClient::GetAppendBlobClient(const std::string& blobName) const
   {
-    return GetBlobClient(blobName).AsAppendBlobClient();
+    return AppendBlobClient(GetBlobClient(blobName));
   }
 
   PageBlobClient BlobContainerClient::GetPageBlobClient(const std::string& blobName) const
   {
-    return GetBlobClient(blobName).AsPageBlobClient();
+    return PageBlobClient(GetBlobClient(blobName));
   }
 
   Azure::Response<Models::CreateBlobContainerResult> BlobContainerClient::Create(
       const CreateBlobContainerOptions& options,
       const Azure::Core::Context& context) const
   {
-    _detail::BlobRestClient::BlobContainer::CreateBlobContainerOptions protocolLayerOptions;
-    protocolLayerOptions.AccessType = options.AccessType;
-    protocolLayerOptions.Metadata = options.Metadata;
-    protocolLayerOptions.DefaultEncryptionScope = options.DefaultEncryptionScope;
-    protocolLayerOptions.PreventEncryptionScopeOverride = options.PreventEncryptionScopeOverride;
     return _detail::BlobRestClient::BlobContainer::Create(
-        *m_pipeline, m_blobContainerUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobContainerUrl, GetCreateProtocolLayerOptions(options), context);
   }
 
   Azure::Response<Models::CreateBlobContainerResult> BlobContainerClient::CreateIfNotExists(
       const CreateBlobContainerOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
+    auto request = _detail::BlobRestClient::BlobContainer::CreateCreateMessage(
+        m_blobContainerUrl, GetCreateProtocolLayerOptions(options));
+    auto response = m_pipeline->Send(request, context);
+    // An existing container is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response, Core::Http::HttpStatusCode::Conflict, {"ContainerAlreadyExists"}))
     {
-      return Create(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.StatusCode == Core::Http::HttpStatusCode::Conflict
-          && e.ErrorCode == "ContainerAlreadyExists")
-      {
-        Models::CreateBlobContainerResult ret;
-        ret.Created = false;
-        return Azure::Response<Models::CreateBlobContainerResult>(
-            std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::CreateBlobContainerResult ret;
+      ret.Created = false;
+      return Azure::Response<Models::CreateBlobContainerResult>(
+          std::move(ret), std::move(response));
     }
+    return _detail::BlobRestClient::BlobContainer::CreateCreateResponse(
+        std::move(response), context);
   }
 
   Azure::Response<Models::DeleteBlobContainerResult> BlobContainerClient::Delete(
       const DeleteBlobContainerOptions& options,
       const Azure::Core::Context& context) const
   {
-    _detail::BlobRestClient::BlobContainer::DeleteBlobContainerOptions protocolLayerOptions;
-    protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
-    protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
-    protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
     return _detail::BlobRestClient::BlobContainer::Delete(
-        *m_pipeline, m_blobContainerUrl, protocolLayerOptions, context);
+        *m_pipeline, m_blobContainerUrl, GetDeleteProtocolLayerOptions(options), context);
   }
 
   Azure::Response<Models::DeleteBlobContainerResult> BlobContainerClient::DeleteIfExists(
       const DeleteBlobContainerOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
+    auto request = _detail::BlobRestClient::BlobContainer::DeleteCreateMessage(
+        m_blobContainerUrl, GetDeleteProtocolLayerOptions(options));
+    auto response = m_pipeline->Send(request, context);
+    // A missing container is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response, Core::Http::HttpStatusCode::NotFound, {"ContainerNotFound"}))
     {
-      return Delete(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.StatusCode == Core::Http::HttpStatusCode::NotFound
-          && e.ErrorCode == "ContainerNotFound")
-      {
-        Models::DeleteBlobContainerResult ret;
-        ret.Deleted = false;
-        return Azure::Response<Models::DeleteBlobContainerResult>(
-            std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::DeleteBlobContainerResult ret;
+      ret.Deleted = false;
+      return Azure::Response<Models::DeleteBlobContainerResult>(
+          std::move(ret), std::move(response));
     }
+    return _detail::BlobRestClient::BlobContainer::DeleteCreateResponse(
+        std::move(response), context);
   }
 
   Azure::Response<Models::BlobContainerProperties> BlobContainerClient::GetProperties(
@@ -275,7 +546,7 @@ namespace Azure { namespace Storage { namespace Blobs {
     pagedResponse.m_blobContainerClient = std::make_shared<BlobContainerClient>(*this);
     pagedResponse.m_operationOptions = options;
     pagedResponse.CurrentPageToken = options.ContinuationToken.ValueOr(std::string());
-    pagedResponse.NextPageToken = response.Value.ContinuationToken;
+    pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
     pagedResponse.RawResponse = std::move(response.RawResponse);
 
     return pagedResponse;
@@ -332,12 +603,422 @@ namespace Azure { namespace Storage { namespace Blobs {
     pagedResponse.m_operationOptions = options;
     pagedResponse.m_delimiter = delimiter;
     pagedResponse.CurrentPageToken = options.ContinuationToken.ValueOr(std::string());
-    pagedResponse.NextPageToken = response.Value.ContinuationToken;
+    pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
     pagedResponse.RawResponse = std::move(response.RawResponse);
 
     return pagedResponse;
   }
 
+  void BlobContainerClient::ListBlobsConcurrently(
+      const std::function<void(std::vector<Models::BlobItem>)>& onBlobs,
+      const ListBlobsConcurrentlyOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    // The partitions found while listing are queued, the listing is done once the queue is empty
+    // and no partition is being listed.
+    std::mutex partitionsMutex;
+    std::condition_variable partitionsChanged;
+    std::deque<std::string> pendingPrefixes(options.Prefixes.begin(), options.Prefixes.end());
+    if (pendingPrefixes.empty())
+    {
+      pendingPrefixes.emplace_back();
+    }
+    int numListingPartitions = 0;
+    bool failed = false;
+
+    auto listPartition = [&](const std::string& prefix) {
+      ListBlobsOptions listOptions;
+      if (!prefix.empty())
+      {
+        listOptions.Prefix = prefix;
+      }
+      listOptions.PageSizeHint = options.PageSizeHint;
+      listOptions.Include = options.Include;
+      if (options.Delimiter.empty())
+      {
+        for (auto page = ListBlobs(listOptions, context); page.HasPage();
+             page.MoveToNextPage(context))
+        {
+          onBlobs(std::move(page.Blobs));
+        }
+        return;
+      }
+      for (auto page = ListBlobsByHierarchy(options.Delimiter, listOptions, context);
+           page.HasPage();
+           page.MoveToNextPage(context))
+      {
+        if (!page.BlobPrefixes.empty())
+        {
+          {
+            std::lock_guard<std::mutex> guard(partitionsMutex);
+            for (auto& blobPrefix : page.BlobPrefixes)
+            {
+              pendingPrefixes.push_back(std::move(blobPrefix));
+            }
+          }
+          partitionsChanged.notify_all();
+        }
+        onBlobs(std::move(page.Blobs));
+      }
+    };
+
+    _internal::ConcurrentStreamTransfer(
+        options.Concurrency,
+        [&](int64_t) -> std::function<void()> {
+          std::unique_lock<std::mutex> guard(partitionsMutex);
+          partitionsChanged.wait(guard, [&]() {
+            return failed || !pendingPrefixes.empty() || numListingPartitions == 0;
+          });
+          if (failed || pendingPrefixes.empty())
+          {
+            return nullptr;
+          }
+          std::string prefix = std::move(pendingPrefixes.front());
+          pendingPrefixes.pop_front();
+          ++numListingPartitions;
+          return [&, prefix]() {
+            bool partitionFailed = true;
+            // Wakes up the threads waiting for a partition even if the listing throws.
+            auto onPartitionDone = [&]() {
+              {
+                std::lock_guard<std::mutex> doneGuard(partitionsMutex);
+                --numListingPartitions;
+                failed = failed || partitionFailed;
+              }
+              partitionsChanged.notify_all();
+            };
+            try
+            {
+              listPartition(prefix);
+            }
+            catch (...)
+            {
+              onPartitionDone();
+              throw;
+            }
+            partitionFailed = false;
+            onPartitionDone();
+          };
+        },
+        m_transferExecutor);
+  }
+
+  void BlobContainerClient::GetBlobsProperties(
+      const std::vector<std::string>& blobNames,
+      const std::function<void(const std::string&, Azure::Nullable<Models::BlobProperties>)>&
+          onProperties,
+      const GetBlobsPropertiesOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    ForEachBlobConcurrently<Models::BlobProperties>(
+        *this,
+        blobNames,
+        options.Concurrency,
+        [&](const BlobClient& blobClient) {
+          return blobClient.GetProperties(GetBlobPropertiesOptions(), context);
+        },
+        onProperties,
+        m_transferExecutor);
+  }
+
+  void BlobContainerClient::GetBlobsTags(
+      const std::vector<std::string>& blobNames,
+      const std::function<
+          void(const std::string&, Azure::Nullable<std::map<std::string, std::string>>)>& onTags,
+      const GetBlobsTagsOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    ForEachBlobConcurrently<std::map<std::string, std::string>>(
+        *this,
+        blobNames,
+        options.Concurrency,
+        [&](const BlobClient& blobClient) {
+          return blobClient.GetTags(GetBlobTagsOptions(), context);
+        },
+        onTags,
+        m_transferExecutor);
+  }
+
+  Models::DownloadBlobsResult BlobContainerClient::DownloadBlobs(
+      const std::vector<std::string>& blobNames,
+      const std::function<void(const std::string&, Azure::Nullable<std::vector<uint8_t>>)>&
+          onContent,
+      const DownloadBlobsOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    std::atomic<int64_t> transferredBlobCount(0);
+    std::atomic<int64_t> transferredSize(0);
+    const auto start = std::chrono::steady_clock::now();
+    ForEachBlobConcurrently<std::vector<uint8_t>>(
+        *this,
+        blobNames,
+        options.Concurrency,
+        [&](const BlobClient& blobClient) {
+          // Without a range the whole blob comes in the response to a single request.
+          auto response = blobClient.Download(DownloadBlobOptions(), context);
+          std::vector<uint8_t> content(static_cast<size_t>(response.Value.BlobSize));
+          const size_t bytesRead
+              = response.Value.BodyStream->ReadToCount(content.data(), content.size(), context);
+          if (bytesRead != content.size())
+          {
+            throw Azure::Core::RequestFailedException("Error when reading body stream.");
+          }
+          return Azure::Response<std::vector<uint8_t>>(
+              std::move(content), std::move(response.RawResponse));
+        },
+        [&](const std::string& blobName, Azure::Nullable<std::vector<uint8_t>> content) {
+          if (content.HasValue())
+          {
+            ++transferredBlobCount;
+            transferredSize += static_cast<int64_t>(content.Value().size());
+          }
+          onContent(blobName, std::move(content));
+        },
+        m_transferExecutor);
+
+    Models::DownloadBlobsResult result;
+    result.TransferredBlobCount = transferredBlobCount;
+    result.TransferredSize = transferredSize;
+    result.Elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    return result;
+  }
+
+  Models::UploadBlobDirectoryResult BlobContainerClient::UploadDirectory(
+      const std::string& directory,
+      const std::string& blobPrefix,
+      const UploadBlobDirectoryOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    if (options.TransferOptions.SingleUploadThreshold > MaxUploadBlobSize)
+    {
+      throw Azure::Core::RequestFailedException("Single upload threshold is too big");
+    }
+    if (options.TransferOptions.ChunkSize > MaxStageBlockSize)
+    {
+      throw Azure::Core::RequestFailedException("Block size is too big.");
+    }
+    if (options.TransferOptions.ChunkSize <= 0)
+    {
+      throw Azure::Core::RequestFailedException("Block size must be positive.");
+    }
+
+    const std::vector<std::string> fileNames = _internal::ListFilesRecursively(directory);
+    TransferJournal journal(options.JournalPath);
+    Models::UploadBlobDirectoryResult result;
+    std::atomic<int64_t> transferredFileCount(0);
+    std::atomic<int64_t> transferredSize(0);
+    auto onFileUploaded = [&](const std::string& journalEntry, int64_t fileSize) {
+      journal.Add(journalEntry);
+      ++transferredFileCount;
+      transferredSize += fileSize;
+    };
+
+    // The small files are uploaded by a task each, the large ones by a task per block. The blocks
+    // of a large file are scheduled one after the other before moving to the next file.
+    size_t fileIndex = 0;
+    std::shared_ptr<FileUpload> fileUpload;
+    int64_t nextBlock = 0;
+    _internal::ConcurrentStreamTransfer(
+        options.TransferOptions.Concurrency,
+        [&](int64_t) -> std::function<void()> {
+          while (!fileUpload || nextBlock == fileUpload->NumBlocks)
+          {
+            fileUpload.reset();
+            if (fileIndex == fileNames.size())
+            {
+              return nullptr;
+            }
+            const std::string& fileName = fileNames[fileIndex++];
+            auto fileReader = std::make_shared<_internal::FileReader>(directory + "/" + fileName);
+            const int64_t fileSize = fileReader->GetFileSize();
+            std::string journalEntry = std::to_string(fileSize) + " " + fileName;
+            if (journal.Contains(journalEntry))
+            {
+              ++result.SkippedFileCount;
+              continue;
+            }
+            auto blobClient = GetBlockBlobClient(blobPrefix + fileName);
+            if (fileSize <= options.TransferOptions.SingleUploadThreshold)
+            {
+              return [&, blobClient, fileReader, journalEntry, fileSize]() {
+                Azure::Core::IO::_internal::RandomAccessFileBodyStream contentStream(
+                    fileReader->GetHandle(), 0, fileSize);
+                UploadBlockBlobOptions uploadOptions;
+                uploadOptions.AccessTier = options.AccessTier;
+                blobClient.Upload(contentStream, uploadOptions, context);
+                onFileUploaded(journalEntry, fileSize);
+              };
+            }
+            const int64_t blockSize = std::max(
+                options.TransferOptions.ChunkSize,
+                (fileSize + MaxBlockNumber - 1) / MaxBlockNumber);
+            if (blockSize > MaxStageBlockSize)
+            {
+              throw Azure::Core::RequestFailedException("Block size is too big.");
+            }
+            fileUpload = std::make_shared<FileUpload>(
+                std::move(blobClient), std::move(fileReader), std::move(journalEntry), blockSize);
+            nextBlock = 0;
+          }
+
+          const int64_t blockId = nextBlock++;
+          auto upload = fileUpload;
+          return [&, upload, blockId]() {
+            const int64_t offset = blockId * upload->BlockSize;
+            const int64_t length
+                = std::min(upload->BlockSize, upload->FileReader->GetFileSize() - offset);
+            Azure::Core::IO::_internal::RandomAccessFileBodyStream contentStream(
+                upload->FileReader->GetHandle(), offset, length);
+            upload->BlobClient.StageBlock(
+                GetBlockId(blockId), contentStream, StageBlockOptions(), context);
+            if (--upload->NumPendingBlocks != 0)
+            {
+              return;
+            }
+            std::vector<std::string> blockIds(static_cast<size_t>(upload->NumBlocks));
+            for (size_t i = 0; i < blockIds.size(); ++i)
+            {
+              blockIds[i] = GetBlockId(static_cast<int64_t>(i));
+            }
+            CommitBlockListOptions commitBlockListOptions;
+            commitBlockListOptions.AccessTier = options.AccessTier;
+            upload->BlobClient.CommitBlockList(blockIds, commitBlockListOptions, context);
+            onFileUploaded(upload->JournalEntry, upload->FileReader->GetFileSize());
+          };
+        },
+        m_transferExecutor);
+
+    result.TransferredFileCount = transferredFileCount;
+    result.TransferredSize = transferredSize;
+    return result;
+  }
+
+  Models::DownloadBlobDirectoryResult BlobContainerClient::DownloadDirectory(
+      const std::string& blobPrefix,
+      const std::string& directory,
+      const DownloadBlobDirectoryOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const int64_t chunkSize = options.TransferOptions.ChunkSize;
+    if (chunkSize <= 0)
+    {
+      throw Azure::Core::RequestFailedException("Chunk size must be positive.");
+    }
+
+    TransferJournal journal(options.JournalPath);
+    Models::DownloadBlobDirectoryResult result;
+    std::atomic<int64_t> transferredFileCount(0);
+    std::atomic<int64_t> transferredSize(0);
+    auto onBlobDownloaded = [&](const std::string& journalEntry, int64_t blobSize) {
+      journal.Add(journalEntry);
+      ++transferredFileCount;
+      transferredSize += blobSize;
+    };
+
+    // The blobs are scheduled as they are listed and downloaded by a task per chunk, the chunks
+    // of a blob are scheduled one after the other before moving to the next blob.
+    ListBlobsOptions listOptions;
+    if (!blobPrefix.empty())
+    {
+      listOptions.Prefix = blobPrefix;
+    }
+    auto page = ListBlobs(listOptions, context);
+    page.EnablePrefetch(context);
+    size_t blobIndex = 0;
+    std::unordered_set<std::string> createdDirectories;
+    std::shared_ptr<FileDownload> fileDownload;
+    int64_t nextChunk = 0;
+    _internal::ConcurrentStreamTransfer(
+        options.TransferOptions.Concurrency,
+        [&](int64_t) -> std::function<void()> {
+          while (!fileDownload || nextChunk == fileDownload->NumChunks)
+          {
+            fileDownload.reset();
+            if (blobIndex == page.Blobs.size())
+            {
+              if (!page.NextPageToken.HasValue() || page.NextPageToken.Value().empty())
+              {
+                return nullptr;
+              }
+              page.MoveToNextPage(context);
+              blobIndex = 0;
+              continue;
+            }
+            const auto& blob = page.Blobs[blobIndex++];
+            const std::string relativePath = blob.Name.substr(blobPrefix.length());
+            // The markers of the virtual directories aren't files.
+            if (!relativePath.empty() && relativePath.back() == '/' && blob.BlobSize == 0)
+            {
+              continue;
+            }
+            if (!IsInDirectory(relativePath))
+            {
+              throw std::runtime_error(
+                  "The file of blob " + blob.Name + " would be outside of the directory.");
+            }
+            std::string journalEntry = blob.Details.ETag.ToString() + " " + blob.Name;
+            if (journal.Contains(journalEntry))
+            {
+              ++result.SkippedFileCount;
+              continue;
+            }
+            const std::string fileName = directory + "/" + relativePath;
+            const std::string parentDirectory = fileName.substr(0, fileName.find_last_of("/\\"));
+            if (createdDirectories.insert(parentDirectory).second)
+            {
+              _internal::CreateDirectories(parentDirectory);
+            }
+
+            if (blob.BlobSize == 0)
+            {
+              _internal::FileWriter emptyFile(fileName);
+              onBlobDownloaded(journalEntry, 0);
+              continue;
+            }
+            fileDownload = std::make_shared<FileDownload>(
+                GetBlobClient(blob.Name),
+                fileName,
+                blob.Details.ETag,
+                std::move(journalEntry),
+                blob.BlobSize,
+                chunkSize);
+            nextChunk = 0;
+          }
+
+          const int64_t chunkId = nextChunk++;
+          auto download = fileDownload;
+          return [&, download, chunkId]() {
+            const int64_t offset = chunkId * download->ChunkSize;
+            const int64_t length = std::min(download->ChunkSize, download->BlobSize - offset);
+            DownloadBlobOptions chunkOptions;
+            chunkOptions.Range = Core::Http::HttpRange();
+            chunkOptions.Range.Value().Offset = offset;
+            chunkOptions.Range.Value().Length = length;
+            chunkOptions.AccessConditions.IfMatch = download->ETag;
+            auto bodyStream
+                = std::move(download->BlobClient.Download(chunkOptions, context).Value.BodyStream);
+            _internal::PooledBuffer buffer(m_bufferPool, static_cast<size_t>(length), context);
+            const size_t bytesRead
+                = bodyStream->ReadToCount(buffer.Data(), static_cast<size_t>(length), context);
+            if (bytesRead != static_cast<size_t>(length))
+            {
+              throw Azure::Core::RequestFailedException("Error when reading body stream.");
+            }
+            download->FileWriter.Write(buffer.Data(), bytesRead, offset);
+            if (--download->NumPendingChunks == 0)
+            {
+              onBlobDownloaded(download->JournalEntry, download->BlobSize);
+            }
+          };
+        },
+        m_transferExecutor);
+
+    result.TransferredFileCount = transferredFileCount;
+    result.TransferredSize = transferredSize;
+    return result;
+  }
+
   Azure::Response<Models::BlobContainerAccessPolicy> BlobContainerClient::GetAccessPolicy(
       const GetBlobContainerAccessPolicyOptions& options,
       const Azure::Core::Context& context) const
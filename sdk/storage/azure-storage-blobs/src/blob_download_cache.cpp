@@ -0,0 +1,269 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/blob_download_cache.hpp"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <azure/core/etag.hpp>
+#include <azure/core/http/http.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+#include "private/blob_download_cache_policy.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace _detail {
+
+    struct BlobDownloadCacheEntry final
+    {
+      std::string Key;
+      Azure::ETag ETag;
+      Azure::Core::CaseInsensitiveMap Headers;
+      std::shared_ptr<const std::vector<uint8_t>> Content;
+    };
+
+    // The entries are ordered from the most to the least recently used.
+    struct BlobDownloadCacheState final
+    {
+      std::mutex Mutex;
+      std::list<BlobDownloadCacheEntry> Entries;
+      std::unordered_map<std::string, std::list<BlobDownloadCacheEntry>::iterator> Index;
+      int64_t Size = 0;
+
+      void Erase(const std::string& key)
+      {
+        auto ite = Index.find(key);
+        if (ite != Index.end())
+        {
+          Size -= static_cast<int64_t>(ite->second->Content->size());
+          Entries.erase(ite->second);
+          Index.erase(ite);
+        }
+      }
+    };
+
+    namespace {
+      // The headers a download sends when it isn't a plain download of the whole blob.
+      constexpr const char* UncachedRequestHeaders[] = {
+          "x-ms-range",
+          "range",
+          "if-match",
+          "if-none-match",
+          "if-modified-since",
+          "if-unmodified-since",
+          "x-ms-if-tags",
+          "x-ms-encryption-key",
+      };
+
+      // The headers of a 304 response that replace the ones of the cached 200 response.
+      constexpr const char* NotModifiedResponseHeaders[] = {
+          "date",
+          "x-ms-request-id",
+          "x-ms-client-request-id",
+          "x-ms-version",
+      };
+
+      // Returns the key of the blob a request downloads, or an empty string if the response to
+      // the request can't be cached.
+      std::string GetCacheKey(const Core::Http::Request& request)
+      {
+        if (request.GetMethod() != Core::Http::HttpMethod::Get)
+        {
+          return std::string();
+        }
+        for (const char* header : UncachedRequestHeaders)
+        {
+          if (Core::Http::_detail::RequestHelpers::FindHeader(request, header) != nullptr)
+          {
+            return std::string();
+          }
+        }
+        // The SAS token and the timeout don't change what's downloaded, they are left out so that
+        // a renewed token doesn't miss the cache.
+        std::map<std::string, std::string> keyParameters;
+        for (const auto& parameter : request.GetUrl().GetQueryParametersView())
+        {
+          if (parameter.first == "comp" || parameter.first == "restype")
+          {
+            return std::string();
+          }
+          if (parameter.first == "snapshot" || parameter.first == "versionid")
+          {
+            keyParameters.insert(parameter);
+          }
+        }
+        Core::Url url = request.GetUrl();
+        url.SetQueryParameters(std::move(keyParameters));
+        return url.GetAbsoluteUrl();
+      }
+
+      // Reads the cached content of a blob, and keeps it alive until the stream is destroyed.
+      class CachedBodyStream final : public Core::IO::BodyStream {
+      public:
+        explicit CachedBodyStream(std::shared_ptr<const std::vector<uint8_t>> content)
+            : m_content(std::move(content)), m_stream(m_content->data(), m_content->size())
+        {
+        }
+
+        int64_t Length() const override { return m_stream.Length(); }
+
+        void Rewind() override { m_stream.Rewind(); }
+
+      private:
+        size_t OnRead(uint8_t* buffer, size_t count, Core::Context const& context) override
+        {
+          return m_stream.Read(buffer, count, context);
+        }
+
+        std::shared_ptr<const std::vector<uint8_t>> m_content;
+        Core::IO::MemoryBodyStream m_stream;
+      };
+    } // namespace
+
+    std::unique_ptr<Core::Http::RawResponse> BlobDownloadCachePolicy::Send(
+        Core::Http::Request& request,
+        Core::Http::Policies::NextHttpPolicy nextPolicy,
+        Core::Context const& context) const
+    {
+      const std::string key = GetCacheKey(request);
+      if (key.empty())
+      {
+        return nextPolicy.Send(request, context);
+      }
+
+      auto& state = *m_cache->m_state;
+      Azure::ETag cachedETag;
+      {
+        std::lock_guard<std::mutex> guard(state.Mutex);
+        auto ite = state.Index.find(key);
+        if (ite != state.Index.end())
+        {
+          cachedETag = ite->second->ETag;
+        }
+      }
+      if (cachedETag.HasValue())
+      {
+        request.SetHeader("If-None-Match", cachedETag.ToString());
+      }
+
+      auto response = nextPolicy.Send(request, context);
+      if (!response)
+      {
+        return response;
+      }
+
+      const auto statusCode = response->GetStatusCode();
+      if (statusCode == Core::Http::HttpStatusCode::NotModified && cachedETag.HasValue())
+      {
+        std::lock_guard<std::mutex> guard(state.Mutex);
+        auto ite = state.Index.find(key);
+        // The entry may have been evicted or replaced by another download in the meantime, the
+        // 304 is then returned as is and fails the download.
+        if (ite != state.Index.end() && ite->second->ETag == cachedETag)
+        {
+          state.Entries.splice(state.Entries.begin(), state.Entries, ite->second);
+          const auto& entry = *ite->second;
+          auto cachedResponse = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          for (const auto& header : entry.Headers)
+          {
+            cachedResponse->SetHeader(header.first, header.second);
+          }
+          const auto& notModifiedHeaders = response->GetHeaders();
+          for (const char* name : NotModifiedResponseHeaders)
+          {
+            auto header = notModifiedHeaders.find(name);
+            if (header != notModifiedHeaders.end())
+            {
+              cachedResponse->SetHeader(header->first, header->second);
+            }
+          }
+          cachedResponse->SetBodyStream(std::make_unique<CachedBodyStream>(entry.Content));
+          return cachedResponse;
+        }
+        return response;
+      }
+
+      if (statusCode != Core::Http::HttpStatusCode::Ok)
+      {
+        if (statusCode == Core::Http::HttpStatusCode::NotFound)
+        {
+          std::lock_guard<std::mutex> guard(state.Mutex);
+          state.Erase(key);
+        }
+        return response;
+      }
+
+      const auto& headers = response->GetHeaders();
+      auto etagHeader = headers.find("etag");
+      auto contentLengthHeader = headers.find("content-length");
+      if (etagHeader == headers.end() || contentLengthHeader == headers.end()
+          || std::stoll(contentLengthHeader->second) > m_cache->MaxBlobSize())
+      {
+        std::lock_guard<std::mutex> guard(state.Mutex);
+        state.Erase(key);
+        return response;
+      }
+
+      auto bodyStream = response->ExtractBodyStream();
+      auto content = std::make_shared<std::vector<uint8_t>>(
+          bodyStream ? bodyStream->ReadToEnd(context) : response->GetBody());
+      BlobDownloadCacheEntry entry;
+      entry.Key = key;
+      entry.ETag = Azure::ETag(etagHeader->second);
+      entry.Headers = headers;
+      entry.Content = content;
+      response->SetBodyStream(std::make_unique<CachedBodyStream>(content));
+
+      std::lock_guard<std::mutex> guard(state.Mutex);
+      state.Erase(key);
+      state.Size += static_cast<int64_t>(content->size());
+      state.Entries.push_front(std::move(entry));
+      state.Index.emplace(key, state.Entries.begin());
+      while (state.Size > m_cache->Capacity())
+      {
+        state.Erase(state.Entries.back().Key);
+      }
+      return response;
+    }
+
+  } // namespace _detail
+
+  BlobDownloadCache::BlobDownloadCache(int64_t capacity, int64_t maxBlobSize)
+      : m_capacity(capacity), m_maxBlobSize(maxBlobSize),
+        m_state(std::make_shared<_detail::BlobDownloadCacheState>())
+  {
+    if (capacity < 0)
+    {
+      throw std::invalid_argument("capacity cannot be negative.");
+    }
+    if (maxBlobSize < 0 || maxBlobSize > capacity)
+    {
+      throw std::invalid_argument("maxBlobSize must be between 0 and capacity.");
+    }
+  }
+
+  BlobDownloadCache::~BlobDownloadCache() {}
+
+  int64_t BlobDownloadCache::Size() const
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    return m_state->Size;
+  }
+
+  void BlobDownloadCache::Clear()
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    m_state->Entries.clear();
+    m_state->Index.clear();
+    m_state->Size = 0;
+  }
+
+}}} // namespace Azure::Storage::Blobs
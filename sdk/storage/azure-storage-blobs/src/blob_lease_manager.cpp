@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/blob_lease_manager.hpp"
+
+#include <azure/storage/common/storage_exception.hpp>
+
+#include "azure/storage/blobs/blob_lease_client.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    // The delay before trying again a renewal which failed while the lease may still be held.
+    constexpr std::chrono::seconds RenewRetryInterval(1);
+
+    // True if the service rejected the renewal because the lease isn't held anymore, such as a
+    // lease which expired and was acquired by someone else, or whose blob was deleted.
+    bool IsLeaseLost(const StorageException& e)
+    {
+      return e.StatusCode == Core::Http::HttpStatusCode::Conflict
+          || e.StatusCode == Core::Http::HttpStatusCode::PreconditionFailed
+          || e.StatusCode == Core::Http::HttpStatusCode::NotFound;
+    }
+  } // namespace
+
+  struct BlobLeaseManager::State final
+  {
+    struct Lease final
+    {
+      std::shared_ptr<BlobLeaseClient> LeaseClient;
+      std::chrono::steady_clock::duration Duration;
+      // When the lease expires unless it is renewed.
+      std::chrono::steady_clock::time_point ExpiryTime;
+      // Tells a lease added again apart from its previous renewals.
+      uint64_t Generation = 0;
+    };
+
+    struct Renewal final
+    {
+      std::chrono::steady_clock::time_point Time;
+      const BlobLeaseClient* Key;
+      uint64_t Generation;
+
+      // The earliest renewal is at the top of the queue.
+      bool operator<(const Renewal& other) const { return Time > other.Time; }
+    };
+
+    std::function<void(const std::shared_ptr<BlobLeaseClient>&)> OnLeaseLost;
+    Azure::Core::Context Context;
+
+    mutable std::mutex Mutex;
+    // Notified when a lease is added and when the manager stops.
+    std::condition_variable Changed;
+    std::map<const BlobLeaseClient*, Lease> Leases;
+    // The renewals of a lease removed or added again are skipped once they are due.
+    std::priority_queue<Renewal> Renewals;
+    uint64_t NextGeneration = 0;
+    std::mt19937_64 Random{std::random_device{}()};
+    bool Stopping = false;
+
+    std::vector<std::thread> RenewThreads;
+
+    // Schedules the next renewal of a lease which was just acquired or renewed.
+    void ScheduleRenewal(const Lease& lease, std::chrono::steady_clock::time_point now)
+    {
+      std::uniform_int_distribution<std::chrono::steady_clock::rep> jitter(
+          0, (lease.Duration / 10).count());
+      Renewals.push(Renewal{
+          now + lease.Duration / 2 - std::chrono::steady_clock::duration(jitter(Random)),
+          lease.LeaseClient.get(),
+          lease.Generation});
+    }
+
+    // Renews the leases once they are due, until the manager stops.
+    void RenewLeases();
+  };
+
+  void BlobLeaseManager::State::RenewLeases()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (!Stopping)
+    {
+      if (Renewals.empty())
+      {
+        Changed.wait(lock);
+        continue;
+      }
+      const Renewal renewal = Renewals.top();
+      auto lease = Leases.find(renewal.Key);
+      if (lease == Leases.end() || lease->second.Generation != renewal.Generation)
+      {
+        Renewals.pop();
+        continue;
+      }
+      if (std::chrono::steady_clock::now() < renewal.Time)
+      {
+        Changed.wait_until(lock, renewal.Time);
+        continue;
+      }
+      Renewals.pop();
+
+      const auto leaseClient = lease->second.LeaseClient;
+      const auto sendTime = std::chrono::steady_clock::now();
+      bool renewed = false;
+      bool lost = false;
+      lock.unlock();
+      try
+      {
+        leaseClient->Renew(RenewLeaseOptions(), Context);
+        renewed = true;
+      }
+      catch (StorageException& e)
+      {
+        lost = IsLeaseLost(e);
+      }
+      catch (std::exception&)
+      {
+      }
+      lock.lock();
+
+      lease = Leases.find(renewal.Key);
+      if (lease == Leases.end() || lease->second.Generation != renewal.Generation)
+      {
+        continue;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if (renewed)
+      {
+        lease->second.ExpiryTime = sendTime + lease->second.Duration;
+        ScheduleRenewal(lease->second, now);
+      }
+      else if (!lost && now + RenewRetryInterval < lease->second.ExpiryTime)
+      {
+        Renewals.push(Renewal{now + RenewRetryInterval, renewal.Key, renewal.Generation});
+      }
+      else
+      {
+        Leases.erase(lease);
+        if (OnLeaseLost && !Stopping)
+        {
+          lock.unlock();
+          OnLeaseLost(leaseClient);
+          lock.lock();
+        }
+      }
+    }
+  }
+
+  BlobLeaseManager::BlobLeaseManager(const BlobLeaseManagerOptions& options)
+      : m_state(std::make_unique<State>())
+  {
+    if (options.Concurrency < 1)
+    {
+      throw std::invalid_argument("Concurrency must be at least 1.");
+    }
+    m_state->OnLeaseLost = options.OnLeaseLost;
+    for (int32_t i = 0; i < options.Concurrency; ++i)
+    {
+      m_state->RenewThreads.emplace_back([this]() { m_state->RenewLeases(); });
+    }
+  }
+
+  BlobLeaseManager::~BlobLeaseManager()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_state->Mutex);
+      m_state->Stopping = true;
+    }
+    m_state->Context.Cancel();
+    m_state->Changed.notify_all();
+    for (auto& renewThread : m_state->RenewThreads)
+    {
+      renewThread.join();
+    }
+  }
+
+  void BlobLeaseManager::Add(
+      std::shared_ptr<BlobLeaseClient> leaseClient,
+      std::chrono::seconds duration)
+  {
+    if (duration <= std::chrono::seconds::zero())
+    {
+      throw std::invalid_argument("The duration of a renewed lease must be positive.");
+    }
+    const auto now = std::chrono::steady_clock::now();
+    State::Lease lease;
+    lease.Duration = duration;
+    lease.ExpiryTime = now + duration;
+    {
+      std::lock_guard<std::mutex> guard(m_state->Mutex);
+      lease.Generation = m_state->NextGeneration++;
+      lease.LeaseClient = std::move(leaseClient);
+      m_state->ScheduleRenewal(lease, now);
+      m_state->Leases[lease.LeaseClient.get()] = std::move(lease);
+    }
+    m_state->Changed.notify_all();
+  }
+
+  bool BlobLeaseManager::Remove(const std::shared_ptr<BlobLeaseClient>& leaseClient)
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    return m_state->Leases.erase(leaseClient.get()) != 0;
+  }
+
+  size_t BlobLeaseManager::GetLeaseCount() const
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    return m_state->Leases.size();
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -0,0 +1,389 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/blob_read_stream.hpp"
+
+#include <azure/core/exception.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
+
+#include "azure/storage/blobs/blob_client.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <list>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    // Waits are split so that a cancelled context is noticed quickly.
+    constexpr std::chrono::milliseconds MaxWaitDuration(100);
+  } // namespace
+
+  struct BlobReadStream::Chunk final
+  {
+    // The offset of the range in the stream, a multiple of the chunk size.
+    int64_t Offset = 0;
+    size_t Length = 0;
+    _internal::PooledBuffer Buffer;
+    // Cancelled when the range is dropped before it is downloaded.
+    Azure::Core::Context Context;
+    // Guarded by the mutex of the state. A range is downloaded by the first of its task and the
+    // reader to start it.
+    bool Started = false;
+    bool Done = false;
+    std::exception_ptr Exception;
+  };
+
+  struct BlobReadStream::State final
+  {
+    explicit State(const BlobClient& client) : Client(client) {}
+
+    BlobClient Client;
+    BlobAccessConditions AccessConditions;
+    int64_t Offset = 0;
+    int64_t Length = 0;
+    int64_t ChunkSize = 0;
+    int Concurrency = 1;
+    int64_t CacheSize = 0;
+    // Cancelled when the stream is destroyed.
+    Azure::Core::Context Context;
+
+    std::mutex Mutex;
+    std::condition_variable ChunkDone;
+    // The tasks submitted to the executor which haven't returned yet, they use the state.
+    int PendingTasks = 0;
+
+    // Only used by the reader. The ranges read ahead, in order, the first one contains the
+    // position unless it is empty.
+    std::deque<std::shared_ptr<Chunk>> Chunks;
+    int64_t PrefetchOffset = 0;
+    int ReadaheadChunks = 1;
+    int64_t Position = 0;
+
+    // The downloaded ranges which aren't read ahead anymore, the most recently used first.
+    std::list<std::shared_ptr<Chunk>> CachedChunks;
+    std::map<int64_t, std::list<std::shared_ptr<Chunk>>::iterator> CachedChunkOffsets;
+    int64_t CachedBytes = 0;
+
+    // Downloads adjacent ranges with a single request.
+    void Download(
+        const std::vector<std::shared_ptr<Chunk>>& chunks,
+        const Azure::Core::Context& context) const;
+    void FinishChunk(Chunk& chunk, std::exception_ptr exception);
+
+    // Keeps a range which isn't read ahead anymore if it's downloaded, evicting the least
+    // recently used ones beyond CacheSize. Cancels its download otherwise.
+    void CacheChunk(std::shared_ptr<Chunk> chunk);
+    std::shared_ptr<Chunk> TakeCachedChunk(int64_t offset);
+    void ClearCache();
+  };
+
+  void BlobReadStream::State::Download(
+      const std::vector<std::shared_ptr<Chunk>>& chunks,
+      const Azure::Core::Context& context) const
+  {
+    DownloadBlobOptions options;
+    options.Range = Core::Http::HttpRange();
+    options.Range.Value().Offset = Offset + chunks.front()->Offset;
+    options.Range.Value().Length = chunks.back()->Offset
+        + static_cast<int64_t>(chunks.back()->Length) - chunks.front()->Offset;
+    options.AccessConditions = AccessConditions;
+    auto response = Client.Download(options, context);
+    for (const auto& chunk : chunks)
+    {
+      if (response.Value.BodyStream->ReadToCount(chunk->Buffer.Data(), chunk->Length, context)
+          != chunk->Length)
+      {
+        throw Azure::Core::RequestFailedException("Error when reading body stream.");
+      }
+    }
+  }
+
+  void BlobReadStream::State::FinishChunk(Chunk& chunk, std::exception_ptr exception)
+  {
+    std::lock_guard<std::mutex> guard(Mutex);
+    chunk.Done = true;
+    chunk.Exception = std::move(exception);
+    ChunkDone.notify_all();
+  }
+
+  void BlobReadStream::State::CacheChunk(std::shared_ptr<Chunk> chunk)
+  {
+    {
+      std::lock_guard<std::mutex> guard(Mutex);
+      if (!chunk->Done || chunk->Exception || static_cast<int64_t>(chunk->Length) > CacheSize)
+      {
+        chunk->Context.Cancel();
+        return;
+      }
+    }
+    CachedBytes += static_cast<int64_t>(chunk->Length);
+    CachedChunks.push_front(chunk);
+    CachedChunkOffsets[chunk->Offset] = CachedChunks.begin();
+    while (CachedBytes > CacheSize)
+    {
+      CachedBytes -= static_cast<int64_t>(CachedChunks.back()->Length);
+      CachedChunkOffsets.erase(CachedChunks.back()->Offset);
+      CachedChunks.pop_back();
+    }
+  }
+
+  std::shared_ptr<BlobReadStream::Chunk> BlobReadStream::State::TakeCachedChunk(int64_t offset)
+  {
+    auto cachedChunk = CachedChunkOffsets.find(offset);
+    if (cachedChunk == CachedChunkOffsets.end())
+    {
+      return nullptr;
+    }
+    auto chunk = std::move(*cachedChunk->second);
+    CachedChunks.erase(cachedChunk->second);
+    CachedChunkOffsets.erase(cachedChunk);
+    CachedBytes -= static_cast<int64_t>(chunk->Length);
+    return chunk;
+  }
+
+  void BlobReadStream::State::ClearCache()
+  {
+    CachedChunks.clear();
+    CachedChunkOffsets.clear();
+    CachedBytes = 0;
+  }
+
+  BlobReadStream::BlobReadStream(
+      const BlobClient& client,
+      const OpenReadOptions& options,
+      int64_t offset,
+      int64_t length,
+      const Azure::Core::Context& context)
+      : m_state(std::make_unique<State>(client))
+  {
+    m_state->AccessConditions = options.AccessConditions;
+    m_state->Offset = offset;
+    m_state->Length = length;
+    m_state->ChunkSize = options.TransferOptions.ChunkSize;
+    m_state->Concurrency = options.TransferOptions.Concurrency;
+    m_state->CacheSize = options.CacheSize;
+    m_state->ReadaheadChunks = m_state->Concurrency;
+    m_state->Context = context.WithDeadline((Azure::DateTime::max)());
+  }
+
+  BlobReadStream::~BlobReadStream()
+  {
+    m_state->Context.Cancel();
+    // The tasks which haven't started yet return right away.
+    std::unique_lock<std::mutex> lock(m_state->Mutex);
+    m_state->ChunkDone.wait(lock, [this]() { return m_state->PendingTasks == 0; });
+  }
+
+  int64_t BlobReadStream::Length() const { return m_state->Length; }
+
+  int64_t BlobReadStream::Position() const { return m_state->Position; }
+
+  void BlobReadStream::Seek(int64_t position)
+  {
+    State& state = *m_state;
+    if (position < 0 || position > state.Length)
+    {
+      throw std::out_of_range("The position is out of the stream.");
+    }
+    if (position == state.Position)
+    {
+      return;
+    }
+
+    if (position > state.Position)
+    {
+      while (!state.Chunks.empty()
+             && state.Chunks.front()->Offset + static_cast<int64_t>(state.Chunks.front()->Length)
+                 <= position)
+      {
+        state.CacheChunk(std::move(state.Chunks.front()));
+        state.Chunks.pop_front();
+      }
+    }
+    state.Position = position;
+    if (state.Chunks.empty() || state.Chunks.front()->Offset > position)
+    {
+      // A random access, reading ahead from the new position is likely a waste.
+      DropChunks();
+    }
+  }
+
+  void BlobReadStream::DropChunks()
+  {
+    State& state = *m_state;
+    for (auto& chunk : state.Chunks)
+    {
+      state.CacheChunk(std::move(chunk));
+    }
+    state.Chunks.clear();
+    state.PrefetchOffset = state.Position / state.ChunkSize * state.ChunkSize;
+    state.ReadaheadChunks = 1;
+  }
+
+  void BlobReadStream::Prefetch(int64_t readEnd, const Azure::Core::Context& context)
+  {
+    State& state = *m_state;
+    while ((static_cast<int>(state.Chunks.size()) < state.ReadaheadChunks
+            || state.PrefetchOffset < readEnd)
+           && state.PrefetchOffset < state.Length)
+    {
+      auto chunk = state.TakeCachedChunk(state.PrefetchOffset);
+      if (chunk)
+      {
+        state.PrefetchOffset += static_cast<int64_t>(chunk->Length);
+        state.Chunks.push_back(std::move(chunk));
+        continue;
+      }
+
+      const size_t length = static_cast<size_t>(
+          std::min(state.ChunkSize, state.Length - state.PrefetchOffset));
+      // Only the range at the position waits for a buffer, once the cache is cleared. The others
+      // don't, the buffers of the pool may be held by the ranges of this stream.
+      _internal::PooledBuffer buffer
+          = _internal::PooledBuffer::TryTake(state.Client.m_bufferPool, length);
+      if (!buffer.Data() && state.Chunks.empty())
+      {
+        state.ClearCache();
+        buffer = _internal::PooledBuffer(state.Client.m_bufferPool, length, context);
+      }
+      if (!buffer.Data())
+      {
+        break;
+      }
+
+      chunk = std::make_shared<Chunk>();
+      chunk->Offset = state.PrefetchOffset;
+      chunk->Length = length;
+      chunk->Buffer = std::move(buffer);
+      chunk->Context = state.Context.WithDeadline((Azure::DateTime::max)());
+      state.Chunks.push_back(chunk);
+      state.PrefetchOffset += static_cast<int64_t>(length);
+      if (chunk->Offset < readEnd)
+      {
+        // The reader downloads the ranges it reads itself.
+        continue;
+      }
+
+      {
+        std::lock_guard<std::mutex> guard(state.Mutex);
+        ++state.PendingTasks;
+      }
+      State* statePointer = m_state.get();
+      _internal::SubmitTransferTask(state.Client.m_transferExecutor, [statePointer, chunk]() {
+        bool started = false;
+        {
+          std::lock_guard<std::mutex> guard(statePointer->Mutex);
+          started = chunk->Started;
+          chunk->Started = true;
+        }
+        if (!started)
+        {
+          std::exception_ptr exception;
+          try
+          {
+            statePointer->Download({chunk}, chunk->Context);
+          }
+          catch (...)
+          {
+            exception = std::current_exception();
+          }
+          statePointer->FinishChunk(*chunk, std::move(exception));
+        }
+        // The state may be destroyed as soon as the mutex is unlocked.
+        std::lock_guard<std::mutex> guard(statePointer->Mutex);
+        --statePointer->PendingTasks;
+        statePointer->ChunkDone.notify_all();
+      });
+    }
+  }
+
+  size_t BlobReadStream::OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context)
+  {
+    State& state = *m_state;
+    if (count == 0 || state.Position >= state.Length)
+    {
+      return 0;
+    }
+
+    const int64_t readEnd = state.Position
+        + static_cast<int64_t>(std::min(
+            static_cast<uint64_t>(count), static_cast<uint64_t>(state.Length - state.Position)));
+    Prefetch(readEnd, context);
+
+    // The first adjacent ranges read which nobody has started downloading are downloaded with a
+    // single request.
+    std::vector<std::shared_ptr<Chunk>> chunksToDownload;
+    {
+      std::lock_guard<std::mutex> guard(state.Mutex);
+      for (const auto& chunk : state.Chunks)
+      {
+        if (chunk->Offset >= readEnd || (chunk->Started && !chunksToDownload.empty()))
+        {
+          break;
+        }
+        if (!chunk->Started)
+        {
+          chunk->Started = true;
+          chunksToDownload.push_back(chunk);
+        }
+      }
+    }
+    if (!chunksToDownload.empty())
+    {
+      std::exception_ptr exception;
+      try
+      {
+        state.Download(chunksToDownload, context);
+      }
+      catch (...)
+      {
+        exception = std::current_exception();
+      }
+      for (const auto& chunk : chunksToDownload)
+      {
+        state.FinishChunk(*chunk, exception);
+      }
+    }
+
+    const std::shared_ptr<Chunk> chunk = state.Chunks.front();
+    {
+      std::unique_lock<std::mutex> lock(state.Mutex);
+      while (!chunk->Done)
+      {
+        context.ThrowIfCancelled();
+        state.ChunkDone.wait_for(lock, MaxWaitDuration);
+      }
+    }
+    if (chunk->Exception)
+    {
+      // The ranges read ahead likely failed too, they are all downloaded again by the next read.
+      DropChunks();
+      std::rethrow_exception(chunk->Exception);
+    }
+
+    const int64_t chunkPosition = state.Position - chunk->Offset;
+    const size_t bytesRead
+        = std::min(count, chunk->Length - static_cast<size_t>(chunkPosition));
+    std::memcpy(buffer, chunk->Buffer.Data() + chunkPosition, bytesRead);
+    state.Position += static_cast<int64_t>(bytesRead);
+    if (state.Position == chunk->Offset + static_cast<int64_t>(chunk->Length))
+    {
+      // The reads are sequential, more ranges are read ahead.
+      state.CacheChunk(std::move(state.Chunks.front()));
+      state.Chunks.pop_front();
+      state.ReadaheadChunks = std::min(state.ReadaheadChunks * 2, state.Concurrency);
+    }
+    return bytesRead;
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -39,8 +39,10 @@ namespace Azure { namespace Storage { namespace Blobs {
       std::chrono::milliseconds period,
       Azure::Core::Context& context)
   {
+    int32_t pollCount = 0;
     while (true)
     {
+      ++pollCount;
       auto rawResponse = Poll(context);
 
       if (m_status == Azure::Core::OperationStatus::Succeeded)
@@ -57,7 +59,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         throw Azure::Core::RequestFailedException("Operation was cancelled.");
       }
 
-      std::this_thread::sleep_for(period);
+      WaitBeforeNextPoll(period, pollCount, context);
     }
   }
 
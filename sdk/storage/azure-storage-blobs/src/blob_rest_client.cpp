@@ -67,10 +67,19 @@ namespace Azure { namespace Storage { namespace Blobs { namespace Models {
   const ArchiveStatus ArchiveStatus::RehydratePendingToHot("rehydrate-pending-to-hot");
   const ArchiveStatus ArchiveStatus::RehydratePendingToCool("rehydrate-pending-to-cool");
 
+  const BlobCompressionCodec BlobCompressionCodec::Gzip("gzip");
+
   const BlobType BlobType::BlockBlob("BlockBlob");
   const BlobType BlobType::PageBlob("PageBlob");
   const BlobType BlobType::AppendBlob("AppendBlob");
 
+  const BlobQueryArrowFieldType BlobQueryArrowFieldType::Int64("int64");
+  const BlobQueryArrowFieldType BlobQueryArrowFieldType::Bool("bool");
+  const BlobQueryArrowFieldType BlobQueryArrowFieldType::Timestamp("timestamp[ms]");
+  const BlobQueryArrowFieldType BlobQueryArrowFieldType::String("string");
+  const BlobQueryArrowFieldType BlobQueryArrowFieldType::Double("double");
+  const BlobQueryArrowFieldType BlobQueryArrowFieldType::Decimal("decimal");
+
   const RehydratePriority RehydratePriority::High("High");
   const RehydratePriority RehydratePriority::Standard("Standard");
 
@@ -5,6 +5,7 @@
 
 #include <azure/core/http/http.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/sas_token_template.hpp>
 
 /* cSpell:ignore rscc, rscd, rsce, rscl, rsct, skoid, sktid */
 
@@ -34,6 +35,172 @@ namespace Azure { namespace Storage { namespace Sas {
         throw std::invalid_argument("Unknown BlobSasResource value.");
       }
     }
+
+    void AppendResponseHeaderQueryParameters(
+        const BlobSasBuilder& builder,
+        std::map<std::string, std::string>& query)
+    {
+      if (!builder.CacheControl.empty())
+      {
+        query["rscc"] = _internal::UrlEncodeQueryParameter(builder.CacheControl);
+      }
+      if (!builder.ContentDisposition.empty())
+      {
+        query["rscd"] = _internal::UrlEncodeQueryParameter(builder.ContentDisposition);
+      }
+      if (!builder.ContentEncoding.empty())
+      {
+        query["rsce"] = _internal::UrlEncodeQueryParameter(builder.ContentEncoding);
+      }
+      if (!builder.ContentLanguage.empty())
+      {
+        query["rscl"] = _internal::UrlEncodeQueryParameter(builder.ContentLanguage);
+      }
+      if (!builder.ContentType.empty())
+      {
+        query["rsct"] = _internal::UrlEncodeQueryParameter(builder.ContentType);
+      }
+    }
+
+    bool IsBlobResource(BlobSasResource resource)
+    {
+      return resource == BlobSasResource::Blob || resource == BlobSasResource::BlobSnapshot
+          || resource == BlobSasResource::BlobVersion;
+    }
+
+    std::string GetSnapshotVersion(const BlobSasBuilder& builder)
+    {
+      if (builder.Resource == BlobSasResource::BlobSnapshot)
+      {
+        return builder.Snapshot;
+      }
+      else if (builder.Resource == BlobSasResource::BlobVersion)
+      {
+        return builder.BlobVersionId;
+      }
+      return std::string();
+    }
+
+    // The blob name goes between the string to sign prefix and suffix.
+    _internal::SasTokenParts GetSasTokenParts(
+        const BlobSasBuilder& builder,
+        const std::string& permissions,
+        const std::string& accountName)
+    {
+      std::string canonicalName = "/blob/" + accountName + "/" + builder.BlobContainerName;
+      if (IsBlobResource(builder.Resource))
+      {
+        canonicalName += "/";
+      }
+      std::string protocol = _detail::SasProtocolToString(builder.Protocol);
+      std::string resource = BlobSasResourceToString(builder.Resource);
+
+      std::string startsOnStr = builder.StartsOn.HasValue()
+          ? builder.StartsOn.Value().ToString(
+              Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
+          : "";
+      std::string expiresOnStr = builder.Identifier.empty()
+          ? builder.ExpiresOn.ToString(
+              Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
+          : "";
+
+      _internal::SasTokenParts parts;
+      parts.StringToSignPrefix
+          = permissions + "\n" + startsOnStr + "\n" + expiresOnStr + "\n" + canonicalName;
+      parts.StringToSignSuffix = "\n" + builder.Identifier + "\n"
+          + (builder.IPRange.HasValue() ? builder.IPRange.Value() : "") + "\n" + protocol + "\n"
+          + _internal::DefaultSasVersion + "\n" + resource + "\n" + GetSnapshotVersion(builder)
+          + "\n" + builder.CacheControl + "\n" + builder.ContentDisposition + "\n"
+          + builder.ContentEncoding + "\n" + builder.ContentLanguage + "\n" + builder.ContentType;
+
+      auto& query = parts.QueryParameters;
+      query["sv"] = _internal::UrlEncodeQueryParameter(_internal::DefaultSasVersion);
+      query["spr"] = _internal::UrlEncodeQueryParameter(protocol);
+      if (!startsOnStr.empty())
+      {
+        query["st"] = _internal::UrlEncodeQueryParameter(startsOnStr);
+      }
+      if (!expiresOnStr.empty())
+      {
+        query["se"] = _internal::UrlEncodeQueryParameter(expiresOnStr);
+      }
+      if (builder.IPRange.HasValue())
+      {
+        query["sip"] = _internal::UrlEncodeQueryParameter(builder.IPRange.Value());
+      }
+      if (!builder.Identifier.empty())
+      {
+        query["si"] = _internal::UrlEncodeQueryParameter(builder.Identifier);
+      }
+      query["sr"] = _internal::UrlEncodeQueryParameter(resource);
+      if (!permissions.empty())
+      {
+        query["sp"] = _internal::UrlEncodeQueryParameter(permissions);
+      }
+      AppendResponseHeaderQueryParameters(builder, query);
+      return parts;
+    }
+
+    _internal::SasTokenParts GetSasTokenParts(
+        const BlobSasBuilder& builder,
+        const std::string& permissions,
+        const Blobs::Models::UserDelegationKey& userDelegationKey,
+        const std::string& accountName)
+    {
+      std::string canonicalName = "/blob/" + accountName + "/" + builder.BlobContainerName;
+      if (IsBlobResource(builder.Resource))
+      {
+        canonicalName += "/";
+      }
+      std::string protocol = _detail::SasProtocolToString(builder.Protocol);
+      std::string resource = BlobSasResourceToString(builder.Resource);
+
+      std::string startsOnStr = builder.StartsOn.HasValue()
+          ? builder.StartsOn.Value().ToString(
+              Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
+          : "";
+      std::string expiresOnStr = builder.ExpiresOn.ToString(
+          Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate);
+      std::string signedStartsOnStr = userDelegationKey.SignedStartsOn.ToString(
+          Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate);
+      std::string signedExpiresOnStr = userDelegationKey.SignedExpiresOn.ToString(
+          Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate);
+
+      _internal::SasTokenParts parts;
+      parts.StringToSignPrefix
+          = permissions + "\n" + startsOnStr + "\n" + expiresOnStr + "\n" + canonicalName;
+      parts.StringToSignSuffix = "\n" + userDelegationKey.SignedObjectId + "\n"
+          + userDelegationKey.SignedTenantId + "\n" + signedStartsOnStr + "\n" + signedExpiresOnStr
+          + "\n" + userDelegationKey.SignedService + "\n" + userDelegationKey.SignedVersion
+          + "\n\n\n\n" + (builder.IPRange.HasValue() ? builder.IPRange.Value() : "") + "\n"
+          + protocol + "\n" + _internal::DefaultSasVersion + "\n" + resource + "\n"
+          + GetSnapshotVersion(builder) + "\n" + builder.CacheControl + "\n"
+          + builder.ContentDisposition + "\n" + builder.ContentEncoding + "\n"
+          + builder.ContentLanguage + "\n" + builder.ContentType;
+
+      auto& query = parts.QueryParameters;
+      query["sv"] = _internal::UrlEncodeQueryParameter(_internal::DefaultSasVersion);
+      query["sr"] = _internal::UrlEncodeQueryParameter(resource);
+      if (!startsOnStr.empty())
+      {
+        query["st"] = _internal::UrlEncodeQueryParameter(startsOnStr);
+      }
+      query["se"] = _internal::UrlEncodeQueryParameter(expiresOnStr);
+      query["sp"] = _internal::UrlEncodeQueryParameter(permissions);
+      if (builder.IPRange.HasValue())
+      {
+        query["sip"] = _internal::UrlEncodeQueryParameter(builder.IPRange.Value());
+      }
+      query["spr"] = _internal::UrlEncodeQueryParameter(protocol);
+      query["skoid"] = _internal::UrlEncodeQueryParameter(userDelegationKey.SignedObjectId);
+      query["sktid"] = _internal::UrlEncodeQueryParameter(userDelegationKey.SignedTenantId);
+      query["skt"] = _internal::UrlEncodeQueryParameter(signedStartsOnStr);
+      query["ske"] = _internal::UrlEncodeQueryParameter(signedExpiresOnStr);
+      query["sks"] = _internal::UrlEncodeQueryParameter(userDelegationKey.SignedService);
+      query["skv"] = _internal::UrlEncodeQueryParameter(userDelegationKey.SignedVersion);
+      AppendResponseHeaderQueryParameters(builder, query);
+      return parts;
+    }
   } // namespace
 
   void BlobSasBuilder::SetPermissions(BlobContainerSasPermissions permissions)
@@ -111,189 +278,52 @@ namespace Azure { namespace Storage { namespace Sas {
 
   std::string BlobSasBuilder::GenerateSasToken(const StorageSharedKeyCredential& credential)
   {
-    std::string canonicalName = "/blob/" + credential.AccountName + "/" + BlobContainerName;
-    if (Resource == BlobSasResource::Blob || Resource == BlobSasResource::BlobSnapshot
-        || Resource == BlobSasResource::BlobVersion)
-    {
-      canonicalName += "/" + BlobName;
-    }
-    std::string protocol = _detail::SasProtocolToString(Protocol);
-    std::string resource = BlobSasResourceToString(Resource);
-
-    std::string snapshotVersion;
-    if (Resource == BlobSasResource::BlobSnapshot)
-    {
-      snapshotVersion = Snapshot;
-    }
-    else if (Resource == BlobSasResource::BlobVersion)
-    {
-      snapshotVersion = BlobVersionId;
-    }
-
-    std::string startsOnStr = StartsOn.HasValue()
-        ? StartsOn.Value().ToString(
-            Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
-        : "";
-    std::string expiresOnStr = Identifier.empty()
-        ? ExpiresOn.ToString(
-            Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
-        : "";
-
-    std::string stringToSign = Permissions + "\n" + startsOnStr + "\n" + expiresOnStr + "\n"
-        + canonicalName + "\n" + Identifier + "\n" + (IPRange.HasValue() ? IPRange.Value() : "")
-        + "\n" + protocol + "\n" + _internal::DefaultSasVersion + "\n" + resource + "\n"
-        + snapshotVersion + "\n" + CacheControl + "\n" + ContentDisposition + "\n" + ContentEncoding
-        + "\n" + ContentLanguage + "\n" + ContentType;
-
-    std::string signature = Azure::Core::Convert::Base64Encode(_internal::HmacSha256(
-        std::vector<uint8_t>(stringToSign.begin(), stringToSign.end()),
-        Azure::Core::Convert::Base64Decode(credential.GetAccountKey())));
-
-    Azure::Core::Url builder;
-    builder.AppendQueryParameter(
-        "sv", _internal::UrlEncodeQueryParameter(_internal::DefaultSasVersion));
-    builder.AppendQueryParameter("spr", _internal::UrlEncodeQueryParameter(protocol));
-    if (!startsOnStr.empty())
-    {
-      builder.AppendQueryParameter("st", _internal::UrlEncodeQueryParameter(startsOnStr));
-    }
-    if (!expiresOnStr.empty())
-    {
-      builder.AppendQueryParameter("se", _internal::UrlEncodeQueryParameter(expiresOnStr));
-    }
-    if (IPRange.HasValue())
-    {
-      builder.AppendQueryParameter("sip", _internal::UrlEncodeQueryParameter(IPRange.Value()));
-    }
-    if (!Identifier.empty())
-    {
-      builder.AppendQueryParameter("si", _internal::UrlEncodeQueryParameter(Identifier));
-    }
-    builder.AppendQueryParameter("sr", _internal::UrlEncodeQueryParameter(resource));
-    if (!Permissions.empty())
-    {
-      builder.AppendQueryParameter("sp", _internal::UrlEncodeQueryParameter(Permissions));
-    }
-    builder.AppendQueryParameter("sig", _internal::UrlEncodeQueryParameter(signature));
-    if (!CacheControl.empty())
-    {
-      builder.AppendQueryParameter("rscc", _internal::UrlEncodeQueryParameter(CacheControl));
-    }
-    if (!ContentDisposition.empty())
-    {
-      builder.AppendQueryParameter("rscd", _internal::UrlEncodeQueryParameter(ContentDisposition));
-    }
-    if (!ContentEncoding.empty())
-    {
-      builder.AppendQueryParameter("rsce", _internal::UrlEncodeQueryParameter(ContentEncoding));
-    }
-    if (!ContentLanguage.empty())
-    {
-      builder.AppendQueryParameter("rscl", _internal::UrlEncodeQueryParameter(ContentLanguage));
-    }
-    if (!ContentType.empty())
-    {
-      builder.AppendQueryParameter("rsct", _internal::UrlEncodeQueryParameter(ContentType));
-    }
-
-    return builder.GetAbsoluteUrl();
+    return _internal::GenerateSasToken(
+        *credential.GetSigningKey(),
+        GetSasTokenParts(*this, Permissions, credential.AccountName),
+        IsBlobResource(Resource) ? BlobName : std::string());
   }
 
   std::string BlobSasBuilder::GenerateSasToken(
       const Blobs::Models::UserDelegationKey& userDelegationKey,
       const std::string& accountName)
   {
-    std::string canonicalName = "/blob/" + accountName + "/" + BlobContainerName;
-    if (Resource == BlobSasResource::Blob || Resource == BlobSasResource::BlobSnapshot
-        || Resource == BlobSasResource::BlobVersion)
-    {
-      canonicalName += "/" + BlobName;
-    }
-    std::string protocol = _detail::SasProtocolToString(Protocol);
-    std::string resource = BlobSasResourceToString(Resource);
+    return _internal::GenerateSasToken(
+        Azure::Core::Convert::Base64Decode(userDelegationKey.Value),
+        GetSasTokenParts(*this, Permissions, userDelegationKey, accountName),
+        IsBlobResource(Resource) ? BlobName : std::string());
+  }
 
-    std::string snapshotVersion;
-    if (Resource == BlobSasResource::BlobSnapshot)
-    {
-      snapshotVersion = Snapshot;
-    }
-    else if (Resource == BlobSasResource::BlobVersion)
+  BlobSasTokenGenerator::BlobSasTokenGenerator(
+      const BlobSasBuilder& builder,
+      const StorageSharedKeyCredential& credential)
+  {
+    if (!IsBlobResource(builder.Resource))
     {
-      snapshotVersion = BlobVersionId;
+      throw std::invalid_argument("BlobSasTokenGenerator requires a blob resource.");
     }
+    m_template = std::make_shared<_internal::SasTokenTemplate>(
+        *credential.GetSigningKey(),
+        GetSasTokenParts(builder, builder.Permissions, credential.AccountName));
+  }
 
-    std::string startsOnStr = StartsOn.HasValue()
-        ? StartsOn.Value().ToString(
-            Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
-        : "";
-    std::string expiresOnStr = ExpiresOn.ToString(
-        Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate);
-    std::string signedStartsOnStr = userDelegationKey.SignedStartsOn.ToString(
-        Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate);
-    std::string signedExpiresOnStr = userDelegationKey.SignedExpiresOn.ToString(
-        Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate);
-
-    std::string stringToSign = Permissions + "\n" + startsOnStr + "\n" + expiresOnStr + "\n"
-        + canonicalName + "\n" + userDelegationKey.SignedObjectId + "\n"
-        + userDelegationKey.SignedTenantId + "\n" + signedStartsOnStr + "\n" + signedExpiresOnStr
-        + "\n" + userDelegationKey.SignedService + "\n" + userDelegationKey.SignedVersion
-        + "\n\n\n\n" + (IPRange.HasValue() ? IPRange.Value() : "") + "\n" + protocol + "\n"
-        + _internal::DefaultSasVersion + "\n" + resource + "\n" + snapshotVersion + "\n"
-        + CacheControl + "\n" + ContentDisposition + "\n" + ContentEncoding + "\n" + ContentLanguage
-        + "\n" + ContentType;
-
-    std::string signature = Azure::Core::Convert::Base64Encode(_internal::HmacSha256(
-        std::vector<uint8_t>(stringToSign.begin(), stringToSign.end()),
-        Azure::Core::Convert::Base64Decode(userDelegationKey.Value)));
-
-    Azure::Core::Url builder;
-    builder.AppendQueryParameter(
-        "sv", _internal::UrlEncodeQueryParameter(_internal::DefaultSasVersion));
-    builder.AppendQueryParameter("sr", _internal::UrlEncodeQueryParameter(resource));
-    if (!startsOnStr.empty())
-    {
-      builder.AppendQueryParameter("st", _internal::UrlEncodeQueryParameter(startsOnStr));
-    }
-    builder.AppendQueryParameter("se", _internal::UrlEncodeQueryParameter(expiresOnStr));
-    builder.AppendQueryParameter("sp", _internal::UrlEncodeQueryParameter(Permissions));
-    if (IPRange.HasValue())
-    {
-      builder.AppendQueryParameter("sip", _internal::UrlEncodeQueryParameter(IPRange.Value()));
-    }
-    builder.AppendQueryParameter("spr", _internal::UrlEncodeQueryParameter(protocol));
-    builder.AppendQueryParameter(
-        "skoid", _internal::UrlEncodeQueryParameter(userDelegationKey.SignedObjectId));
-    builder.AppendQueryParameter(
-        "sktid", _internal::UrlEncodeQueryParameter(userDelegationKey.SignedTenantId));
-    builder.AppendQueryParameter("skt", _internal::UrlEncodeQueryParameter(signedStartsOnStr));
-    builder.AppendQueryParameter("ske", _internal::UrlEncodeQueryParameter(signedExpiresOnStr));
-    builder.AppendQueryParameter(
-        "sks", _internal::UrlEncodeQueryParameter(userDelegationKey.SignedService));
-    builder.AppendQueryParameter(
-        "skv", _internal::UrlEncodeQueryParameter(userDelegationKey.SignedVersion));
-    if (!CacheControl.empty())
-    {
-      builder.AppendQueryParameter("rscc", _internal::UrlEncodeQueryParameter(CacheControl));
-    }
-    if (!ContentDisposition.empty())
-    {
-      builder.AppendQueryParameter("rscd", _internal::UrlEncodeQueryParameter(ContentDisposition));
-    }
-    if (!ContentEncoding.empty())
-    {
-      builder.AppendQueryParameter("rsce", _internal::UrlEncodeQueryParameter(ContentEncoding));
-    }
-    if (!ContentLanguage.empty())
-    {
-      builder.AppendQueryParameter("rscl", _internal::UrlEncodeQueryParameter(ContentLanguage));
-    }
-    if (!ContentType.empty())
+  BlobSasTokenGenerator::BlobSasTokenGenerator(
+      const BlobSasBuilder& builder,
+      const Blobs::Models::UserDelegationKey& userDelegationKey,
+      const std::string& accountName)
+  {
+    if (!IsBlobResource(builder.Resource))
     {
-      builder.AppendQueryParameter("rsct", _internal::UrlEncodeQueryParameter(ContentType));
+      throw std::invalid_argument("BlobSasTokenGenerator requires a blob resource.");
     }
-    builder.AppendQueryParameter("sig", _internal::UrlEncodeQueryParameter(signature));
+    m_template = std::make_shared<_internal::SasTokenTemplate>(
+        Azure::Core::Convert::Base64Decode(userDelegationKey.Value),
+        GetSasTokenParts(builder, builder.Permissions, userDelegationKey, accountName));
+  }
 
-    return builder.GetAbsoluteUrl();
+  std::string BlobSasTokenGenerator::GenerateSasToken(const std::string& blobName) const
+  {
+    return m_template->GenerateSasToken(blobName);
   }
 
 }}} // namespace Azure::Storage::Sas
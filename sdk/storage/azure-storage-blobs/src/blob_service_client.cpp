@@ -4,13 +4,16 @@
 #include "azure/storage/blobs/blob_service_client.hpp"
 
 #include <azure/core/http/policies/policy.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
 #include <azure/storage/common/internal/constants.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
+#include "private/blob_download_cache_policy.hpp"
 #include "private/package_version.hpp"
 
 namespace Azure { namespace Storage { namespace Blobs {
@@ -46,16 +49,32 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_serviceUrl.GetHost(), newOptions.SecondaryHostForRetryReads));
+        m_serviceUrl.GetHost(),
+        newOptions.SecondaryHostForRetryReads,
+        newOptions.SecondaryReadBalancer));
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion));
+    if (newOptions.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(newOptions.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, newOptions.ApiVersion}});
   }
 
   BlobServiceClient::BlobServiceClient(
@@ -67,7 +86,19 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_serviceUrl.GetHost(), options.SecondaryHostForRetryReads));
+        m_serviceUrl.GetHost(),
+        options.SecondaryHostForRetryReads,
+        options.SecondaryReadBalancer));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
     {
       Azure::Core::Credentials::TokenRequestContext tokenContext;
@@ -76,35 +107,56 @@ namespace Azure { namespace Storage { namespace Blobs {
           std::make_unique<Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
               credential, tokenContext));
     }
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
+    if (options.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(options.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   BlobServiceClient::BlobServiceClient(
       const std::string& serviceUrl,
       const BlobClientOptions& options)
       : m_serviceUrl(serviceUrl), m_customerProvidedKey(options.CustomerProvidedKey),
-        m_encryptionScope(options.EncryptionScope)
+        m_encryptionScope(options.EncryptionScope), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool), m_secondaryReadBalancer(options.SecondaryReadBalancer)
   {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
-        m_serviceUrl.GetHost(), options.SecondaryHostForRetryReads));
+        m_serviceUrl.GetHost(),
+        options.SecondaryHostForRetryReads,
+        options.SecondaryReadBalancer));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
+    if (options.DownloadCache)
+    {
+      perOperationPolicies.emplace_back(
+          std::make_unique<_detail::BlobDownloadCachePolicy>(options.DownloadCache));
+    }
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::BlobServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   BlobContainerClient BlobServiceClient::GetBlobContainerClient(
@@ -113,7 +165,12 @@ namespace Azure { namespace Storage { namespace Blobs {
     auto blobContainerUrl = m_serviceUrl;
     blobContainerUrl.AppendPath(_internal::UrlEncodePath(blobContainerName));
     return BlobContainerClient(
-        std::move(blobContainerUrl), m_pipeline, m_customerProvidedKey, m_encryptionScope);
+        std::move(blobContainerUrl),
+        m_pipeline,
+        m_customerProvidedKey,
+        m_encryptionScope,
+        m_transferExecutor,
+        m_bufferPool);
   }
 
   ListBlobContainersPagedResponse BlobServiceClient::ListBlobContainers(
@@ -138,7 +195,7 @@ namespace Azure { namespace Storage { namespace Blobs {
     pagedResponse.m_blobServiceClient = std::make_shared<BlobServiceClient>(*this);
     pagedResponse.m_operationOptions = options;
     pagedResponse.CurrentPageToken = options.ContinuationToken.ValueOr(std::string());
-    pagedResponse.NextPageToken = response.Value.ContinuationToken;
+    pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
     pagedResponse.RawResponse = std::move(response.RawResponse);
 
     return pagedResponse;
@@ -194,8 +251,13 @@ namespace Azure { namespace Storage { namespace Blobs {
   {
     (void)options;
     _detail::BlobRestClient::Service::GetServiceStatisticsOptions protocolLayerOptions;
-    return _detail::BlobRestClient::Service::GetStatistics(
+    auto response = _detail::BlobRestClient::Service::GetStatistics(
         *m_pipeline, m_serviceUrl, protocolLayerOptions, context);
+    if (m_secondaryReadBalancer && response.Value.GeoReplication.LastSyncedOn.HasValue())
+    {
+      m_secondaryReadBalancer->SetLastSyncTime(response.Value.GeoReplication.LastSyncedOn.Value());
+    }
+    return response;
   }
 
   FindBlobsByTagsPagedResponse BlobServiceClient::FindBlobsByTags(
@@ -220,12 +282,46 @@ namespace Azure { namespace Storage { namespace Blobs {
     pagedResponse.m_operationOptions = options;
     pagedResponse.m_tagFilterSqlExpression = tagFilterSqlExpression;
     pagedResponse.CurrentPageToken = options.ContinuationToken.ValueOr(std::string());
-    pagedResponse.NextPageToken = response.Value.ContinuationToken;
+    pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
     pagedResponse.RawResponse = std::move(response.RawResponse);
 
     return pagedResponse;
   }
 
+  void BlobServiceClient::FindBlobsByTagsConcurrently(
+      const std::string& tagFilterSqlExpression,
+      const std::function<void(const Models::TaggedBlobItem&, const BlobClient&)>& onBlob,
+      const FindBlobsByTagsConcurrentlyOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    // The blobs of a page are scheduled one after the other while the next page is prefetched.
+    FindBlobsByTagsOptions findOptions;
+    findOptions.PageSizeHint = options.PageSizeHint;
+    auto page = FindBlobsByTags(tagFilterSqlExpression, findOptions, context);
+    page.EnablePrefetch(context);
+    size_t blobIndex = 0;
+    _internal::ConcurrentStreamTransfer(
+        options.Concurrency,
+        [&](int64_t) -> std::function<void()> {
+          while (blobIndex == page.TaggedBlobs.size())
+          {
+            if (!page.NextPageToken.HasValue() || page.NextPageToken.Value().empty())
+            {
+              return nullptr;
+            }
+            page.MoveToNextPage(context);
+            blobIndex = 0;
+          }
+          Models::TaggedBlobItem blob = std::move(page.TaggedBlobs[blobIndex++]);
+          BlobClient blobClient
+              = GetBlobContainerClient(blob.BlobContainerName).GetBlobClient(blob.BlobName);
+          return [&onBlob, blob = std::move(blob), blobClient = std::move(blobClient)]() {
+            onBlob(blob, blobClient);
+          };
+        },
+        m_transferExecutor);
+  }
+
   Azure::Response<BlobContainerClient> BlobServiceClient::CreateBlobContainer(
       const std::string& blobContainerName,
       const CreateBlobContainerOptions& options,
@@ -15,16 +15,350 @@
 #include <windows.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <azure/core/internal/cryptography/md5_multi_buffer.hpp>
 #include <azure/core/io/body_stream.hpp>
 #include <azure/storage/common/crypt.hpp>
 #include <azure/storage/common/internal/concurrent_transfer.hpp>
 #include <azure/storage/common/internal/constants.hpp>
 #include <azure/storage/common/internal/file_io.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
+#include <azure/storage/common/internal/transfer_progress.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
+#include "private/avro_parser.hpp"
+#include "private/blob_compression.hpp"
+#include "private/client_side_encryptor.hpp"
+
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    constexpr int64_t MaxStageBlockSize = 4000 * 1024 * 1024ULL;
+    constexpr int64_t MaxBlockNumber = 50000;
+
+    // Gets the options of the transfer of the blocks staged by UploadFrom().
+    _internal::ConcurrentTransferOptions GetStageBlocksTransferOptions(
+        int64_t blobSize,
+        const UploadBlockBlobFromOptions& options)
+    {
+      constexpr int64_t DefaultStageBlockSize = 4 * 1024 * 1024ULL;
+      constexpr int64_t DefaultAutoTuneMaxStageBlockSize = 64 * 1024 * 1024ULL;
+      constexpr int64_t BlockGrainSize = 1 * 1024 * 1024;
+
+      int64_t minChunkSize = (blobSize + MaxBlockNumber - 1) / MaxBlockNumber;
+      minChunkSize = (minChunkSize + BlockGrainSize - 1) / BlockGrainSize * BlockGrainSize;
+      int64_t chunkSize;
+      if (options.TransferOptions.ChunkSize.HasValue())
+      {
+        chunkSize = options.TransferOptions.ChunkSize.Value();
+      }
+      else if (options.TransferOptions.AutoTune)
+      {
+        chunkSize = std::max(DefaultAutoTuneMaxStageBlockSize, minChunkSize);
+      }
+      else
+      {
+        chunkSize = std::max(DefaultStageBlockSize, minChunkSize);
+      }
+      if (chunkSize > MaxStageBlockSize)
+      {
+        throw Azure::Core::RequestFailedException("Block size is too big.");
+      }
+
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = chunkSize;
+      transferOptions.Concurrency = options.TransferOptions.Concurrency;
+      transferOptions.AutoTune = options.TransferOptions.AutoTune;
+      // The tuned blocks stay large enough for the blob to fit in MaxBlockNumber blocks.
+      transferOptions.MinChunkSize = std::max(_internal::AutoTuneMinChunkSize, minChunkSize);
+      return transferOptions;
+    }
+
+    // Gets the ID of the block at chunkId of a blob staged by UploadFrom(). The IDs of the
+    // resumable uploads that verify the reused blocks end with the CRC64 of the content of the
+    // block, so that a block staged by an interrupted upload only has the same ID if it has the
+    // same content.
+    std::string GetStageBlockId(int64_t chunkId, const std::vector<uint8_t>& crc64 = {})
+    {
+      constexpr size_t BlockIdLength = 64;
+      constexpr char HexDigits[] = "0123456789abcdef";
+      std::string suffix;
+      if (!crc64.empty())
+      {
+        suffix = "-";
+        for (uint8_t byte : crc64)
+        {
+          suffix += HexDigits[byte >> 4];
+          suffix += HexDigits[byte & 0x0f];
+        }
+      }
+      std::string blockId = std::to_string(chunkId);
+      blockId = std::string(BlockIdLength - blockId.length() - suffix.length(), '0') + blockId
+          + suffix;
+      return Azure::Core::Convert::Base64Encode(
+          std::vector<uint8_t>(blockId.begin(), blockId.end()));
+    }
+
+    // Gets the sizes of the uncommitted blocks of a blob by their IDs, these are the blocks staged
+    // by an interrupted UploadFrom() that a resumable upload can reuse.
+    std::unordered_map<std::string, int64_t> GetUncommittedBlockSizes(
+        const BlockBlobClient& client,
+        const Azure::Core::Context& context)
+    {
+      std::unordered_map<std::string, int64_t> blockSizes;
+      GetBlockListOptions getBlockListOptions;
+      getBlockListOptions.ListType = Models::BlockListType::Uncommitted;
+      try
+      {
+        auto blockList = client.GetBlockList(getBlockListOptions, context);
+        for (const auto& block : blockList.Value.UncommittedBlocks)
+        {
+          blockSizes.emplace(block.Name, block.Size);
+        }
+      }
+      catch (StorageException& e)
+      {
+        // The blob doesn't exist yet, nothing was staged.
+        if (e.StatusCode != Azure::Core::Http::HttpStatusCode::NotFound)
+        {
+          throw;
+        }
+      }
+      return blockSizes;
+    }
+
+    // Calls send with stream, or with a stream adding the data read to progress if it's reported.
+    template <class Send>
+    auto SendWithProgress(
+        Azure::Core::IO::BodyStream& stream,
+        _internal::TransferProgress& progress,
+        Send send) -> decltype(send(stream))
+    {
+      if (!progress.IsEnabled())
+      {
+        return send(stream);
+      }
+      _internal::TransferProgressStream progressStream(stream, progress);
+      return send(progressStream);
+    }
+
+    // Returns whether an UploadFrom() compresses or encrypts the content of the blob.
+    bool IsTransformedUpload(const UploadBlockBlobFromOptions& options)
+    {
+      return options.CompressionCodec.HasValue() || options.ClientSideEncryption != nullptr;
+    }
+
+    // Checks the options of an UploadFrom() compressing or encrypting the content of the blob.
+    void CheckTransformOptions(const UploadBlockBlobFromOptions& options)
+    {
+      if (options.CompressionCodec.HasValue()
+          && options.CompressionCodec.Value() != Models::BlobCompressionCodec::Gzip)
+      {
+        throw std::invalid_argument(
+            "Unsupported compression codec " + options.CompressionCodec.Value().ToString() + ".");
+      }
+      if (options.CompressionCodec.HasValue() && options.TransferOptions.Resumable)
+      {
+        throw std::invalid_argument("A compressed upload can't be resumable.");
+      }
+      if (options.ClientSideEncryption && options.CompressionCodec.HasValue())
+      {
+        throw std::invalid_argument("An encrypted upload can't be compressed.");
+      }
+      if (options.ClientSideEncryption && options.TransferOptions.Resumable)
+      {
+        throw std::invalid_argument("An encrypted upload can't be resumable.");
+      }
+    }
+
+    // Stages the blocks of an UploadFrom() compressing or encrypting the content of the blob, each
+    // transformed on its own by the thread staging it, and commits them. getChunk returns the
+    // content of the block at offset, read in the buffer it's given unless the content is in
+    // memory.
+    template <class GetChunk>
+    Azure::Response<Models::UploadBlockBlobFromResult> UploadTransformedBlocks(
+        const BlockBlobClient& client,
+        int64_t blobSize,
+        _internal::ConcurrentTransferOptions transferOptions,
+        const UploadBlockBlobFromOptions& options,
+        GetChunk getChunk,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      // The blocks are decompressed or decrypted at fixed offsets.
+      transferOptions.AutoTune = false;
+      std::shared_ptr<const _detail::ContentEncryptionKey> encryptionKey;
+      if (options.ClientSideEncryption)
+      {
+        encryptionKey = _detail::ClientSideEncryptor::GetUploadKey(
+            *options.ClientSideEncryption, context);
+        // The blocks are whole regions, and stay within the size of a block once encrypted.
+        constexpr int64_t RegionLength = _detail::ClientSideEncryptor::RegionLength;
+        constexpr int64_t MaxRegionsPerBlock
+            = MaxStageBlockSize / (RegionLength + _detail::ClientSideEncryptor::RegionOverhead);
+        transferOptions.ChunkSize = std::min(
+            (transferOptions.ChunkSize + RegionLength - 1) / RegionLength * RegionLength,
+            MaxRegionsPerBlock * RegionLength);
+      }
+      // The content of a block is counted once it's staged.
+      _internal::TransferProgress progress(
+          options.TransferOptions.ProgressHandler,
+          options.TransferOptions.MaxProgressReportsPerSecond);
+      auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
+        std::vector<uint8_t> chunkBuffer;
+        const uint8_t* chunkData = getChunk(offset, length, chunkBuffer);
+        auto transformed = encryptionKey
+            ? _detail::ClientSideEncryptor::EncryptRegions(
+                encryptionKey->Key, chunkData, static_cast<size_t>(length))
+            : _detail::GzipCompress(chunkData, static_cast<size_t>(length));
+        Azure::Core::IO::MemoryBodyStream contentStream(transformed.data(), transformed.size());
+        client.StageBlock(GetStageBlockId(chunkId), contentStream, StageBlockOptions(), context);
+        progress.Add(length);
+      };
+      const int64_t numBlocks = _internal::ConcurrentTransfer(
+          0, blobSize, transferOptions, uploadBlockFunc, transferExecutor);
+      progress.Complete();
+
+      std::vector<std::string> blockIds(static_cast<size_t>(numBlocks));
+      for (size_t i = 0; i < blockIds.size(); ++i)
+      {
+        blockIds[i] = GetStageBlockId(static_cast<int64_t>(i));
+      }
+      CommitBlockListOptions commitBlockListOptions;
+      commitBlockListOptions.HttpHeaders = options.HttpHeaders;
+      commitBlockListOptions.Metadata = options.Metadata;
+      if (encryptionKey)
+      {
+        commitBlockListOptions.Metadata[_detail::EncryptionDataMetadataName]
+            = encryptionKey->EncryptionData;
+      }
+      else
+      {
+        commitBlockListOptions.HttpHeaders.ContentEncoding
+            = options.CompressionCodec.Value().ToString();
+        commitBlockListOptions.Metadata[_detail::CompressionCodecMetadataName]
+            = options.CompressionCodec.Value().ToString();
+        commitBlockListOptions.Metadata[_detail::CompressionBlockSizeMetadataName]
+            = std::to_string(transferOptions.ChunkSize);
+        commitBlockListOptions.Metadata[_detail::UncompressedSizeMetadataName]
+            = std::to_string(blobSize);
+      }
+      commitBlockListOptions.Tags = options.Tags;
+      commitBlockListOptions.AccessTier = options.AccessTier;
+      auto commitBlockListResponse
+          = client.CommitBlockList(blockIds, commitBlockListOptions, context);
+
+      Models::UploadBlockBlobFromResult ret;
+      ret.ETag = std::move(commitBlockListResponse.Value.ETag);
+      ret.LastModified = std::move(commitBlockListResponse.Value.LastModified);
+      ret.VersionId = std::move(commitBlockListResponse.Value.VersionId);
+      ret.IsServerEncrypted = commitBlockListResponse.Value.IsServerEncrypted;
+      ret.EncryptionKeySha256 = std::move(commitBlockListResponse.Value.EncryptionKeySha256);
+      ret.EncryptionScope = std::move(commitBlockListResponse.Value.EncryptionScope);
+      return Azure::Response<Models::UploadBlockBlobFromResult>(
+          std::move(ret), std::move(commitBlockListResponse.RawResponse));
+    }
+
+    // Decodes the Avro records of the response of a query as it's read, returns the content of
+    // the records of the result, and reports the others to the handlers of the options.
+    class BlobQueryBodyStream final : public Azure::Core::IO::BodyStream {
+    public:
+      BlobQueryBodyStream(
+          std::unique_ptr<Azure::Core::IO::BodyStream> stream,
+          std::function<void(Models::BlobQueryError)> errorHandler,
+          std::function<void(int64_t, int64_t)> progressHandler)
+          : m_reader(std::move(stream)), m_errorHandler(std::move(errorHandler)),
+            m_progressHandler(std::move(progressHandler))
+      {
+      }
+
+      int64_t Length() const override { return -1; }
+
+    private:
+      size_t OnRead(uint8_t* buffer, size_t count, const Azure::Core::Context& context) override
+      {
+        while (m_dataOffset == m_data.size())
+        {
+          if (m_ended || !ReadRecord(context))
+          {
+            return 0;
+          }
+        }
+        const size_t readSize = std::min(count, m_data.size() - m_dataOffset);
+        std::copy(
+            m_data.begin() + m_dataOffset, m_data.begin() + m_dataOffset + readSize, buffer);
+        m_dataOffset += readSize;
+        return readSize;
+      }
+
+      bool ReadRecord(const Azure::Core::Context& context)
+      {
+        _detail::AvroDatum record;
+        if (!m_reader.Next(record, context))
+        {
+          m_ended = true;
+          return false;
+        }
+        const std::string& name = record.Schema->Name;
+        const auto suffix = name.substr(name.find_last_of('.') + 1);
+        if (suffix == "resultData")
+        {
+          m_data = record.Field("data").String;
+          m_dataOffset = 0;
+        }
+        else if (suffix == "error")
+        {
+          Models::BlobQueryError error;
+          error.IsFatal = record.Field("fatal").Boolean;
+          error.Name = record.Field("name").String;
+          error.Description = record.Field("description").String;
+          error.Position = record.Field("position").Long;
+          if (m_errorHandler)
+          {
+            m_errorHandler(std::move(error));
+          }
+          else if (error.IsFatal)
+          {
+            throw StorageException(
+                "The query failed with error " + error.Name + ": " + error.Description);
+          }
+        }
+        else if (suffix == "progress")
+        {
+          if (m_progressHandler)
+          {
+            m_progressHandler(
+                record.Field("bytesScanned").Long, record.Field("totalBytes").Long);
+          }
+        }
+        else if (suffix == "end")
+        {
+          if (m_progressHandler)
+          {
+            const int64_t totalBytes = record.Field("totalBytes").Long;
+            m_progressHandler(totalBytes, totalBytes);
+          }
+          m_ended = true;
+          return false;
+        }
+        return true;
+      }
+
+      _detail::AvroObjectContainerReader m_reader;
+      std::function<void(Models::BlobQueryError)> m_errorHandler;
+      std::function<void(int64_t, int64_t)> m_progressHandler;
+      std::string m_data;
+      size_t m_dataOffset = 0;
+      bool m_ended = false;
+    };
+  } // namespace
+
   BlockBlobClient BlockBlobClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& blobContainerName,
@@ -123,17 +457,18 @@ namespace Azure { namespace Storage { namespace Blobs {
       const UploadBlockBlobFromOptions& options,
       const Azure::Core::Context& context) const
   {
-    constexpr int64_t DefaultStageBlockSize = 4 * 1024 * 1024ULL;
-    constexpr int64_t MaxStageBlockSize = 4000 * 1024 * 1024ULL;
-    constexpr int64_t MaxBlockNumber = 50000;
-    constexpr int64_t BlockGrainSize = 1 * 1024 * 1024;
-
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
     if (static_cast<uint64_t>(options.TransferOptions.SingleUploadThreshold)
         > std::numeric_limits<size_t>::max())
     {
       throw Azure::Core::RequestFailedException("Single upload threshold is too big");
     }
-    if (bufferSize <= static_cast<size_t>(options.TransferOptions.SingleUploadThreshold))
+    CheckTransformOptions(options);
+    _internal::TransferProgress progress(
+        options.TransferOptions.ProgressHandler,
+        options.TransferOptions.MaxProgressReportsPerSecond);
+    if (!IsTransformedUpload(options)
+        && bufferSize <= static_cast<size_t>(options.TransferOptions.SingleUploadThreshold))
     {
       Azure::Core::IO::MemoryBodyStream contentStream(buffer, bufferSize);
       UploadBlockBlobOptions uploadBlockBlobOptions;
@@ -141,57 +476,105 @@ namespace Azure { namespace Storage { namespace Blobs {
       uploadBlockBlobOptions.Metadata = options.Metadata;
       uploadBlockBlobOptions.Tags = options.Tags;
       uploadBlockBlobOptions.AccessTier = options.AccessTier;
-      return Upload(contentStream, uploadBlockBlobOptions, context);
+      auto response
+          = SendWithProgress(contentStream, progress, [&](Azure::Core::IO::BodyStream& content) {
+              return Upload(content, uploadBlockBlobOptions, bulkContext);
+            });
+      progress.Complete();
+      return response;
     }
 
-    int64_t chunkSize;
-    if (options.TransferOptions.ChunkSize.HasValue())
+    auto transferOptions
+        = GetStageBlocksTransferOptions(static_cast<int64_t>(bufferSize), options);
+    if (IsTransformedUpload(options))
     {
-      chunkSize = options.TransferOptions.ChunkSize.Value();
+      return UploadTransformedBlocks(
+          *this,
+          static_cast<int64_t>(bufferSize),
+          transferOptions,
+          options,
+          [buffer](int64_t offset, int64_t, std::vector<uint8_t>&) { return buffer + offset; },
+          m_transferExecutor,
+          bulkContext);
     }
-    else
+
+    const bool resumable = options.TransferOptions.Resumable;
+    const bool verifyBlocks = resumable && options.TransferOptions.VerifyResumedBlocks;
+    std::unordered_map<std::string, int64_t> uncommittedBlockSizes;
+    if (resumable)
     {
-      int64_t minChunkSize = (bufferSize + MaxBlockNumber - 1) / MaxBlockNumber;
-      minChunkSize = (minChunkSize + BlockGrainSize - 1) / BlockGrainSize * BlockGrainSize;
-      chunkSize = std::max(DefaultStageBlockSize, minChunkSize);
+      transferOptions.AutoTune = false;
+      uncommittedBlockSizes = GetUncommittedBlockSizes(*this, bulkContext);
     }
-    if (chunkSize > MaxStageBlockSize)
+    // The IDs of verified blocks depend on their content, they are kept as the blocks are staged.
+    // The blocks are then cut at fixed offsets and there is one ID per chunk.
+    std::vector<std::string> blockIds;
+    if (verifyBlocks)
     {
-      throw Azure::Core::RequestFailedException("Block size is too big.");
+      blockIds.resize(static_cast<size_t>(
+          (static_cast<int64_t>(bufferSize) + transferOptions.ChunkSize - 1)
+          / transferOptions.ChunkSize));
     }
 
-    std::vector<std::string> blockIds;
-    auto getBlockId = [](int64_t id) {
-      constexpr size_t BlockIdLength = 64;
-      std::string blockId = std::to_string(id);
-      blockId = std::string(BlockIdLength - blockId.length(), '0') + blockId;
-      return Azure::Core::Convert::Base64Encode(
-          std::vector<uint8_t>(blockId.begin(), blockId.end()));
-    };
-
-    auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
-      Azure::Core::IO::MemoryBodyStream contentStream(buffer + offset, static_cast<size_t>(length));
+    auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
       StageBlockOptions chunkOptions;
-      auto blockInfo = StageBlock(getBlockId(chunkId), contentStream, chunkOptions, context);
-      if (chunkId == numChunks - 1)
+      std::string blockId;
+      if (verifyBlocks)
+      {
+        ContentHash hash;
+        hash.Algorithm = HashAlgorithm::Crc64;
+        hash.Value = Crc64Hash().Final(buffer + offset, static_cast<size_t>(length));
+        blockId = GetStageBlockId(chunkId, hash.Value);
+        chunkOptions.TransactionalContentHash = std::move(hash);
+      }
+      else
+      {
+        blockId = GetStageBlockId(chunkId);
+      }
+      auto uncommittedBlock = uncommittedBlockSizes.find(blockId);
+      if (uncommittedBlock == uncommittedBlockSizes.end() || uncommittedBlock->second != length)
       {
-        blockIds.resize(static_cast<size_t>(numChunks));
+        if (!verifyBlocks && options.TransferOptions.ComputeTransactionalMd5)
+        {
+          ContentHash hash;
+          hash.Algorithm = HashAlgorithm::Md5;
+          hash.Value = Azure::Core::Cryptography::_internal::ComputeMd5MultiBuffer(
+              buffer + offset, static_cast<size_t>(length));
+          chunkOptions.TransactionalContentHash = std::move(hash);
+        }
+        Azure::Core::IO::MemoryBodyStream contentStream(
+            buffer + offset, static_cast<size_t>(length));
+        SendWithProgress(contentStream, progress, [&](Azure::Core::IO::BodyStream& content) {
+          return StageBlock(blockId, content, chunkOptions, bulkContext);
+        });
+      }
+      else
+      {
+        progress.Add(length);
+      }
+      if (verifyBlocks)
+      {
+        blockIds[static_cast<size_t>(chunkId)] = std::move(blockId);
       }
     };
 
-    _internal::ConcurrentTransfer(
-        0, bufferSize, chunkSize, options.TransferOptions.Concurrency, uploadBlockFunc);
-
-    for (size_t i = 0; i < blockIds.size(); ++i)
+    const int64_t numBlocks = _internal::ConcurrentTransfer(
+        0, bufferSize, transferOptions, uploadBlockFunc, m_transferExecutor);
+    progress.Complete();
+    if (!verifyBlocks)
     {
-      blockIds[i] = getBlockId(static_cast<int64_t>(i));
+      blockIds.resize(static_cast<size_t>(numBlocks));
+      for (size_t i = 0; i < blockIds.size(); ++i)
+      {
+        blockIds[i] = GetStageBlockId(static_cast<int64_t>(i));
+      }
     }
     CommitBlockListOptions commitBlockListOptions;
     commitBlockListOptions.HttpHeaders = options.HttpHeaders;
     commitBlockListOptions.Metadata = options.Metadata;
     commitBlockListOptions.Tags = options.Tags;
     commitBlockListOptions.AccessTier = options.AccessTier;
-    auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions, context);
+    auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions, bulkContext);
 
     Models::UploadBlockBlobFromResult ret;
     ret.ETag = std::move(commitBlockListResponse.Value.ETag);
@@ -209,70 +592,275 @@ namespace Azure { namespace Storage { namespace Blobs {
       const UploadBlockBlobFromOptions& options,
       const Azure::Core::Context& context) const
   {
-    constexpr int64_t DefaultStageBlockSize = 4 * 1024 * 1024ULL;
-    constexpr int64_t MaxStageBlockSize = 4000 * 1024 * 1024ULL;
-    constexpr int64_t MaxBlockNumber = 50000;
-    constexpr int64_t BlockGrainSize = 1 * 1024 * 1024;
-
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    CheckTransformOptions(options);
+    _internal::TransferProgress progress(
+        options.TransferOptions.ProgressHandler,
+        options.TransferOptions.MaxProgressReportsPerSecond);
     {
       Azure::Core::IO::FileBodyStream contentStream(fileName);
 
-      if (contentStream.Length() <= options.TransferOptions.SingleUploadThreshold)
+      if (!IsTransformedUpload(options)
+          && contentStream.Length() <= options.TransferOptions.SingleUploadThreshold)
       {
         UploadBlockBlobOptions uploadBlockBlobOptions;
         uploadBlockBlobOptions.HttpHeaders = options.HttpHeaders;
         uploadBlockBlobOptions.Metadata = options.Metadata;
         uploadBlockBlobOptions.Tags = options.Tags;
         uploadBlockBlobOptions.AccessTier = options.AccessTier;
-        return Upload(contentStream, uploadBlockBlobOptions, context);
+        auto response = SendWithProgress(
+            contentStream, progress, [&](Azure::Core::IO::BodyStream& content) {
+              return Upload(content, uploadBlockBlobOptions, bulkContext);
+            });
+        progress.Complete();
+        return response;
       }
     }
 
+    _internal::FileReader fileReader(
+        fileName,
+        options.TransferOptions.UnbufferedIo        ? _internal::FileIoMode::Unbuffered
+            : options.TransferOptions.MemoryMapFile ? _internal::FileIoMode::MemoryMapped
+                                                    : _internal::FileIoMode::Buffered);
+    const uint8_t* mappedData = fileReader.GetMappedData();
+
+    const int64_t fileSize = fileReader.GetFileSize();
+    auto transferOptions = GetStageBlocksTransferOptions(fileSize, options);
+    const bool resumable = options.TransferOptions.Resumable;
+    const bool verifyBlocks = resumable && options.TransferOptions.VerifyResumedBlocks;
+    std::unordered_map<std::string, int64_t> uncommittedBlockSizes;
+    if (resumable)
+    {
+      transferOptions.AutoTune = false;
+      uncommittedBlockSizes = GetUncommittedBlockSizes(*this, bulkContext);
+    }
+    // The IDs of verified blocks depend on their content, they are kept as the blocks are staged.
+    // The blocks are then cut at fixed offsets and there is one ID per chunk.
     std::vector<std::string> blockIds;
-    auto getBlockId = [](int64_t id) {
-      constexpr size_t BlockIdLength = 64;
-      std::string blockId = std::to_string(id);
-      blockId = std::string(BlockIdLength - blockId.length(), '0') + blockId;
-      return Azure::Core::Convert::Base64Encode(
-          std::vector<uint8_t>(blockId.begin(), blockId.end()));
+    if (verifyBlocks)
+    {
+      blockIds.resize(static_cast<size_t>(
+          (fileSize + transferOptions.ChunkSize - 1) / transferOptions.ChunkSize));
+    }
+
+    auto openFileStream = [&](int64_t offset, int64_t length)
+        -> std::unique_ptr<Azure::Core::IO::BodyStream> {
+      if (fileReader.IsUnbuffered())
+      {
+        return std::make_unique<_internal::UnbufferedFileBodyStream>(
+            fileReader, offset, length, m_bufferPool);
+      }
+      return std::make_unique<Azure::Core::IO::_internal::RandomAccessFileBodyStream>(
+          fileReader.GetHandle(), offset, length);
     };
 
-    _internal::FileReader fileReader(fileName);
+    if (IsTransformedUpload(options))
+    {
+      auto getChunk = [&](int64_t offset, int64_t length, std::vector<uint8_t>& chunkBuffer) {
+        if (mappedData != nullptr)
+        {
+          return mappedData + offset;
+        }
+        chunkBuffer.resize(static_cast<size_t>(length));
+        openFileStream(offset, length)
+            ->ReadToCount(chunkBuffer.data(), chunkBuffer.size(), bulkContext);
+        return static_cast<const uint8_t*>(chunkBuffer.data());
+      };
+      return UploadTransformedBlocks(
+          *this, fileSize, transferOptions, options, getChunk, m_transferExecutor, bulkContext);
+    }
 
-    auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
-      Azure::Core::IO::_internal::RandomAccessFileBodyStream contentStream(
-          fileReader.GetHandle(), offset, length);
+    auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
       StageBlockOptions chunkOptions;
-      auto blockInfo = StageBlock(getBlockId(chunkId), contentStream, chunkOptions, context);
-      if (chunkId == numChunks - 1)
+      std::string blockId;
+      // The content of a verified block is read in memory to hash it before it's staged, unless
+      // the file is mapped.
+      _internal::PooledBuffer blockBuffer;
+      const uint8_t* blockData = mappedData != nullptr ? mappedData + offset : nullptr;
+      auto readBlock = [&]() {
+        if (blockData == nullptr)
+        {
+          blockBuffer = _internal::PooledBuffer(
+              m_bufferPool, static_cast<size_t>(length), bulkContext);
+          openFileStream(offset, length)
+              ->ReadToCount(blockBuffer.Data(), static_cast<size_t>(length), bulkContext);
+          blockData = blockBuffer.Data();
+        }
+      };
+      if (verifyBlocks)
+      {
+        readBlock();
+        ContentHash hash;
+        hash.Algorithm = HashAlgorithm::Crc64;
+        hash.Value = Crc64Hash().Final(blockData, static_cast<size_t>(length));
+        blockId = GetStageBlockId(chunkId, hash.Value);
+        chunkOptions.TransactionalContentHash = std::move(hash);
+      }
+      else
+      {
+        blockId = GetStageBlockId(chunkId);
+      }
+      auto uncommittedBlock = uncommittedBlockSizes.find(blockId);
+      if (uncommittedBlock != uncommittedBlockSizes.end() && uncommittedBlock->second == length)
+      {
+        if (verifyBlocks)
+        {
+          blockIds[static_cast<size_t>(chunkId)] = std::move(blockId);
+        }
+        progress.Add(length);
+        return;
+      }
+
+      if (!verifyBlocks && options.TransferOptions.ComputeTransactionalMd5)
       {
-        blockIds.resize(static_cast<size_t>(numChunks));
+        readBlock();
+        ContentHash hash;
+        hash.Algorithm = HashAlgorithm::Md5;
+        hash.Value = Azure::Core::Cryptography::_internal::ComputeMd5MultiBuffer(
+            blockData, static_cast<size_t>(length));
+        chunkOptions.TransactionalContentHash = std::move(hash);
+      }
+
+      auto contentStream = blockData != nullptr
+          ? std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+              blockData, static_cast<size_t>(length))
+          : openFileStream(offset, length);
+      SendWithProgress(*contentStream, progress, [&](Azure::Core::IO::BodyStream& content) {
+        return StageBlock(blockId, content, chunkOptions, bulkContext);
+      });
+      if (verifyBlocks)
+      {
+        blockIds[static_cast<size_t>(chunkId)] = std::move(blockId);
       }
     };
 
-    int64_t chunkSize;
-    if (options.TransferOptions.ChunkSize.HasValue())
+    const int64_t numBlocks = _internal::ConcurrentTransfer(
+        0, fileSize, transferOptions, uploadBlockFunc, m_transferExecutor);
+    progress.Complete();
+    if (!verifyBlocks)
     {
-      chunkSize = options.TransferOptions.ChunkSize.Value();
+      blockIds.resize(static_cast<size_t>(numBlocks));
+      for (size_t i = 0; i < blockIds.size(); ++i)
+      {
+        blockIds[i] = GetStageBlockId(static_cast<int64_t>(i));
+      }
     }
-    else
+    CommitBlockListOptions commitBlockListOptions;
+    commitBlockListOptions.HttpHeaders = options.HttpHeaders;
+    commitBlockListOptions.Metadata = options.Metadata;
+    commitBlockListOptions.Tags = options.Tags;
+    commitBlockListOptions.AccessTier = options.AccessTier;
+    auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions, bulkContext);
+
+    Models::UploadBlockBlobFromResult result;
+    result.ETag = std::move(commitBlockListResponse.Value.ETag);
+    result.LastModified = std::move(commitBlockListResponse.Value.LastModified);
+    result.VersionId = std::move(commitBlockListResponse.Value.VersionId);
+    result.IsServerEncrypted = commitBlockListResponse.Value.IsServerEncrypted;
+    result.EncryptionKeySha256 = std::move(commitBlockListResponse.Value.EncryptionKeySha256);
+    result.EncryptionScope = std::move(commitBlockListResponse.Value.EncryptionScope);
+    return Azure::Response<Models::UploadBlockBlobFromResult>(
+        std::move(result), std::move(commitBlockListResponse.RawResponse));
+  }
+
+  Azure::Response<Models::UploadBlockBlobFromResult> BlockBlobClient::UploadFromStream(
+      Azure::Core::IO::BodyStream& stream,
+      const UploadBlockBlobFromOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    constexpr int64_t DefaultStageBlockSize = 8 * 1024 * 1024;
+
+    const int64_t blockSize = options.TransferOptions.ChunkSize.HasValue()
+        ? options.TransferOptions.ChunkSize.Value()
+        : DefaultStageBlockSize;
+    if (blockSize > MaxStageBlockSize
+        || static_cast<uint64_t>(blockSize) > std::numeric_limits<size_t>::max())
     {
-      int64_t minChunkSize = (fileReader.GetFileSize() + MaxBlockNumber - 1) / MaxBlockNumber;
-      minChunkSize = (minChunkSize + BlockGrainSize - 1) / BlockGrainSize * BlockGrainSize;
-      chunkSize = std::max(DefaultStageBlockSize, minChunkSize);
+      throw Azure::Core::RequestFailedException("Block size is too big.");
     }
-    if (chunkSize > MaxStageBlockSize)
+    if (blockSize <= 0)
     {
-      throw Azure::Core::RequestFailedException("Block size is too big.");
+      throw Azure::Core::RequestFailedException("Block size must be positive.");
     }
 
-    _internal::ConcurrentTransfer(
-        0,
-        fileReader.GetFileSize(),
-        chunkSize,
-        options.TransferOptions.Concurrency,
-        uploadBlockFunc);
+    // The first block tells whether the stream is small enough for a single upload.
+    auto firstBlock = std::make_shared<_internal::PooledBuffer>(
+        m_bufferPool, static_cast<size_t>(blockSize), bulkContext);
+    const size_t firstBlockLength
+        = stream.ReadToCount(firstBlock->Data(), firstBlock->Size(), bulkContext);
+    _internal::TransferProgress progress(
+        options.TransferOptions.ProgressHandler,
+        options.TransferOptions.MaxProgressReportsPerSecond);
+    if (firstBlockLength < firstBlock->Size()
+        && static_cast<int64_t>(firstBlockLength) <= options.TransferOptions.SingleUploadThreshold)
+    {
+      Azure::Core::IO::MemoryBodyStream contentStream(firstBlock->Data(), firstBlockLength);
+      UploadBlockBlobOptions uploadBlockBlobOptions;
+      uploadBlockBlobOptions.HttpHeaders = options.HttpHeaders;
+      uploadBlockBlobOptions.Metadata = options.Metadata;
+      uploadBlockBlobOptions.Tags = options.Tags;
+      uploadBlockBlobOptions.AccessTier = options.AccessTier;
+      auto response
+          = SendWithProgress(contentStream, progress, [&](Azure::Core::IO::BodyStream& content) {
+              return Upload(content, uploadBlockBlobOptions, bulkContext);
+            });
+      progress.Complete();
+      return response;
+    }
 
+    auto getBlockId = [](int64_t id) {
+      constexpr size_t BlockIdLength = 64;
+      std::string blockId = std::to_string(id);
+      blockId = std::string(BlockIdLength - blockId.length(), '0') + blockId;
+      return Azure::Core::Convert::Base64Encode(
+          std::vector<uint8_t>(blockId.begin(), blockId.end()));
+    };
+
+    // The blocks are read one at a time, in order, each into its own buffer which is given back
+    // once the block is staged.
+    bool endOfStream = firstBlockLength < firstBlock->Size();
+    auto readBlockFunc = [&](int64_t chunkId) -> std::function<void()> {
+      std::shared_ptr<_internal::PooledBuffer> block;
+      size_t blockLength;
+      if (chunkId == 0)
+      {
+        block = std::move(firstBlock);
+        blockLength = firstBlockLength;
+      }
+      else
+      {
+        if (endOfStream)
+        {
+          return nullptr;
+        }
+        block = std::make_shared<_internal::PooledBuffer>(
+            m_bufferPool, static_cast<size_t>(blockSize), bulkContext);
+        blockLength = stream.ReadToCount(block->Data(), block->Size(), bulkContext);
+        endOfStream = blockLength < block->Size();
+      }
+      if (blockLength == 0)
+      {
+        return nullptr;
+      }
+      if (chunkId >= MaxBlockNumber)
+      {
+        throw Azure::Core::RequestFailedException("Stream is too big for the block size.");
+      }
+      return [this, block, blockLength, chunkId, &getBlockId, &progress, &bulkContext]() {
+        Azure::Core::IO::MemoryBodyStream contentStream(block->Data(), blockLength);
+        StageBlockOptions chunkOptions;
+        SendWithProgress(contentStream, progress, [&](Azure::Core::IO::BodyStream& content) {
+          return StageBlock(getBlockId(chunkId), content, chunkOptions, bulkContext);
+        });
+      };
+    };
+
+    const int64_t numBlocks = _internal::ConcurrentStreamTransfer(
+        options.TransferOptions.Concurrency, readBlockFunc, m_transferExecutor);
+    progress.Complete();
+
+    std::vector<std::string> blockIds(static_cast<size_t>(numBlocks));
     for (size_t i = 0; i < blockIds.size(); ++i)
     {
       blockIds[i] = getBlockId(static_cast<int64_t>(i));
@@ -282,17 +870,122 @@ namespace Azure { namespace Storage { namespace Blobs {
     commitBlockListOptions.Metadata = options.Metadata;
     commitBlockListOptions.Tags = options.Tags;
     commitBlockListOptions.AccessTier = options.AccessTier;
-    auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions, context);
+    auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions, bulkContext);
 
-    Models::UploadBlockBlobFromResult result;
-    result.ETag = commitBlockListResponse.Value.ETag;
-    result.LastModified = commitBlockListResponse.Value.LastModified;
-    result.VersionId = commitBlockListResponse.Value.VersionId;
-    result.IsServerEncrypted = commitBlockListResponse.Value.IsServerEncrypted;
-    result.EncryptionKeySha256 = commitBlockListResponse.Value.EncryptionKeySha256;
-    result.EncryptionScope = commitBlockListResponse.Value.EncryptionScope;
+    Models::UploadBlockBlobFromResult ret;
+    ret.ETag = std::move(commitBlockListResponse.Value.ETag);
+    ret.LastModified = std::move(commitBlockListResponse.Value.LastModified);
+    ret.VersionId = std::move(commitBlockListResponse.Value.VersionId);
+    ret.IsServerEncrypted = commitBlockListResponse.Value.IsServerEncrypted;
+    ret.EncryptionKeySha256 = std::move(commitBlockListResponse.Value.EncryptionKeySha256);
+    ret.EncryptionScope = std::move(commitBlockListResponse.Value.EncryptionScope);
     return Azure::Response<Models::UploadBlockBlobFromResult>(
-        std::move(result), std::move(commitBlockListResponse.RawResponse));
+        std::move(ret), std::move(commitBlockListResponse.RawResponse));
+  }
+
+  Azure::Response<Models::SyncBlockBlobFromResult> BlockBlobClient::SyncFrom(
+      const std::string& fileName,
+      const SyncBlockBlobFromOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    _internal::FileReader fileReader(
+        fileName,
+        options.TransferOptions.MemoryMapFile ? _internal::FileIoMode::MemoryMapped
+                                              : _internal::FileIoMode::Buffered);
+    const uint8_t* mappedData = fileReader.GetMappedData();
+    const int64_t fileSize = fileReader.GetFileSize();
+
+    UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.ChunkSize = options.TransferOptions.ChunkSize;
+    uploadOptions.TransferOptions.Concurrency = options.TransferOptions.Concurrency;
+    const auto transferOptions = GetStageBlocksTransferOptions(fileSize, uploadOptions);
+
+    Azure::ETag blobETag;
+    std::unordered_map<std::string, int64_t> committedBlockSizes;
+    {
+      GetBlockListOptions getBlockListOptions;
+      getBlockListOptions.ListType = Models::BlockListType::Committed;
+      try
+      {
+        auto blockList = GetBlockList(getBlockListOptions, context);
+        blobETag = blockList.Value.ETag;
+        for (const auto& block : blockList.Value.CommittedBlocks)
+        {
+          committedBlockSizes.emplace(block.Name, block.Size);
+        }
+      }
+      catch (StorageException& e)
+      {
+        if (e.StatusCode != Azure::Core::Http::HttpStatusCode::NotFound)
+        {
+          throw;
+        }
+      }
+    }
+
+    std::vector<std::string> blockIds(static_cast<size_t>(
+        (fileSize + transferOptions.ChunkSize - 1) / transferOptions.ChunkSize));
+    std::atomic<int64_t> uploadedSize{0};
+
+    auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
+      _internal::PooledBuffer blockBuffer;
+      const uint8_t* blockData = mappedData != nullptr ? mappedData + offset : nullptr;
+      if (blockData == nullptr)
+      {
+        blockBuffer = _internal::PooledBuffer(m_bufferPool, static_cast<size_t>(length), context);
+        Azure::Core::IO::_internal::RandomAccessFileBodyStream(
+            fileReader.GetHandle(), offset, length)
+            .ReadToCount(blockBuffer.Data(), static_cast<size_t>(length), context);
+        blockData = blockBuffer.Data();
+      }
+      ContentHash hash;
+      hash.Algorithm = HashAlgorithm::Crc64;
+      hash.Value = Crc64Hash().Final(blockData, static_cast<size_t>(length));
+      std::string blockId = GetStageBlockId(chunkId, hash.Value);
+
+      auto committedBlock = committedBlockSizes.find(blockId);
+      if (committedBlock == committedBlockSizes.end() || committedBlock->second != length)
+      {
+        StageBlockOptions chunkOptions;
+        chunkOptions.TransactionalContentHash = std::move(hash);
+        Azure::Core::IO::MemoryBodyStream contentStream(blockData, static_cast<size_t>(length));
+        StageBlock(blockId, contentStream, chunkOptions, context);
+        uploadedSize += length;
+      }
+      blockIds[static_cast<size_t>(chunkId)] = std::move(blockId);
+    };
+
+    _internal::ConcurrentTransfer(
+        0, fileSize, transferOptions, uploadBlockFunc, m_transferExecutor);
+
+    // Committing the latest version of each block reuses the committed ones. The blob must not
+    // have been changed since its block list was read, or the reused blocks may be gone.
+    CommitBlockListOptions commitBlockListOptions;
+    commitBlockListOptions.HttpHeaders = options.HttpHeaders;
+    commitBlockListOptions.Metadata = options.Metadata;
+    commitBlockListOptions.Tags = options.Tags;
+    commitBlockListOptions.AccessTier = options.AccessTier;
+    if (blobETag.HasValue())
+    {
+      commitBlockListOptions.AccessConditions.IfMatch = blobETag;
+    }
+    else
+    {
+      commitBlockListOptions.AccessConditions.IfNoneMatch = Azure::ETag::Any();
+    }
+    auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions, context);
+
+    Models::SyncBlockBlobFromResult ret;
+    ret.ETag = std::move(commitBlockListResponse.Value.ETag);
+    ret.LastModified = std::move(commitBlockListResponse.Value.LastModified);
+    ret.VersionId = std::move(commitBlockListResponse.Value.VersionId);
+    ret.IsServerEncrypted = commitBlockListResponse.Value.IsServerEncrypted;
+    ret.EncryptionKeySha256 = std::move(commitBlockListResponse.Value.EncryptionKeySha256);
+    ret.EncryptionScope = std::move(commitBlockListResponse.Value.EncryptionScope);
+    ret.UploadedSize = uploadedSize;
+    ret.ReusedSize = fileSize - ret.UploadedSize;
+    return Azure::Response<Models::SyncBlockBlobFromResult>(
+        std::move(ret), std::move(commitBlockListResponse.RawResponse));
   }
 
   Azure::Response<Models::StageBlockResult> BlockBlobClient::StageBlock(
@@ -343,6 +1036,100 @@ namespace Azure { namespace Storage { namespace Blobs {
         *m_pipeline, m_blobUrl, protocolLayerOptions, context);
   }
 
+  Azure::Response<Models::UploadBlockBlobFromResult> BlockBlobClient::CopyFromUriParallel(
+      const std::string& sourceUri,
+      const CopyBlobFromUriParallelOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    constexpr int64_t DefaultCopyBlockSize = 64 * 1024 * 1024;
+    constexpr int64_t MaxCopyBlockSize = 100 * 1024 * 1024;
+    constexpr int64_t BlockGrainSize = 1 * 1024 * 1024;
+
+    StageBlockFromUriOptions chunkOptions;
+    chunkOptions.SourceAccessConditions.IfModifiedSince
+        = options.SourceAccessConditions.IfModifiedSince;
+    chunkOptions.SourceAccessConditions.IfUnmodifiedSince
+        = options.SourceAccessConditions.IfUnmodifiedSince;
+    chunkOptions.SourceAccessConditions.IfMatch = options.SourceAccessConditions.IfMatch;
+    chunkOptions.SourceAccessConditions.IfNoneMatch = options.SourceAccessConditions.IfNoneMatch;
+
+    int64_t sourceLength;
+    if (options.SourceLength.HasValue())
+    {
+      sourceLength = options.SourceLength.Value();
+    }
+    else
+    {
+      // The source is authorized by its URL, not by the credential of this client.
+      auto sourceProperties = BlobClient(sourceUri).GetProperties(
+          GetBlobPropertiesOptions(), context);
+      sourceLength = sourceProperties.Value.BlobSize;
+      // A source changed while it's copied fails the copy, instead of mixing its versions.
+      if (!chunkOptions.SourceAccessConditions.IfMatch.HasValue())
+      {
+        chunkOptions.SourceAccessConditions.IfMatch = sourceProperties.Value.ETag;
+      }
+    }
+
+    int64_t chunkSize;
+    if (options.TransferOptions.ChunkSize.HasValue())
+    {
+      chunkSize = options.TransferOptions.ChunkSize.Value();
+    }
+    else
+    {
+      int64_t minChunkSize = (sourceLength + MaxBlockNumber - 1) / MaxBlockNumber;
+      minChunkSize = (minChunkSize + BlockGrainSize - 1) / BlockGrainSize * BlockGrainSize;
+      chunkSize = std::max(DefaultCopyBlockSize, minChunkSize);
+    }
+    if (chunkSize > MaxCopyBlockSize)
+    {
+      throw Azure::Core::RequestFailedException("Block size is too big.");
+    }
+
+    auto getBlockId = [](int64_t id) {
+      constexpr size_t BlockIdLength = 64;
+      std::string blockId = std::to_string(id);
+      blockId = std::string(BlockIdLength - blockId.length(), '0') + blockId;
+      return Azure::Core::Convert::Base64Encode(
+          std::vector<uint8_t>(blockId.begin(), blockId.end()));
+    };
+
+    auto copyBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
+      StageBlockFromUriOptions rangeOptions = chunkOptions;
+      rangeOptions.SourceRange = Azure::Core::Http::HttpRange{offset, length};
+      StageBlockFromUri(getBlockId(chunkId), sourceUri, rangeOptions, context);
+    };
+
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = chunkSize;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    const int64_t numBlocks = _internal::ConcurrentTransfer(
+        0, sourceLength, transferOptions, copyBlockFunc, m_transferExecutor);
+
+    std::vector<std::string> blockIds(static_cast<size_t>(numBlocks));
+    for (size_t i = 0; i < blockIds.size(); ++i)
+    {
+      blockIds[i] = getBlockId(static_cast<int64_t>(i));
+    }
+    CommitBlockListOptions commitBlockListOptions;
+    commitBlockListOptions.HttpHeaders = options.HttpHeaders;
+    commitBlockListOptions.Metadata = options.Metadata;
+    commitBlockListOptions.Tags = options.Tags;
+    commitBlockListOptions.AccessTier = options.AccessTier;
+    auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions, context);
+
+    Models::UploadBlockBlobFromResult result;
+    result.ETag = std::move(commitBlockListResponse.Value.ETag);
+    result.LastModified = std::move(commitBlockListResponse.Value.LastModified);
+    result.VersionId = std::move(commitBlockListResponse.Value.VersionId);
+    result.IsServerEncrypted = commitBlockListResponse.Value.IsServerEncrypted;
+    result.EncryptionKeySha256 = std::move(commitBlockListResponse.Value.EncryptionKeySha256);
+    result.EncryptionScope = std::move(commitBlockListResponse.Value.EncryptionScope);
+    return Azure::Response<Models::UploadBlockBlobFromResult>(
+        std::move(result), std::move(commitBlockListResponse.RawResponse));
+  }
+
   Azure::Response<Models::CommitBlockListResult> BlockBlobClient::CommitBlockList(
       const std::vector<std::string>& blockIds,
       const CommitBlockListOptions& options,
@@ -387,4 +1174,32 @@ namespace Azure { namespace Storage { namespace Blobs {
         *m_pipeline, m_blobUrl, protocolLayerOptions, _internal::WithReplicaStatus(context));
   }
 
+  Azure::Response<Models::QueryBlobResult> BlockBlobClient::Query(
+      const std::string& querySqlExpression,
+      const QueryBlobOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    _detail::BlobRestClient::BlockBlob::QueryBlobOptions protocolLayerOptions;
+    protocolLayerOptions.Expression = querySqlExpression;
+    protocolLayerOptions.InputSerialization = options.InputTextConfiguration.m_serialization;
+    protocolLayerOptions.OutputSerialization = options.OutputTextConfiguration.m_serialization;
+    protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+    if (m_customerProvidedKey.HasValue())
+    {
+      protocolLayerOptions.EncryptionKey = m_customerProvidedKey.Value().Key;
+      protocolLayerOptions.EncryptionKeySha256 = m_customerProvidedKey.Value().KeyHash;
+      protocolLayerOptions.EncryptionAlgorithm = m_customerProvidedKey.Value().Algorithm;
+    }
+    protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
+    protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
+    protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
+    protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+    protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
+    auto response = _detail::BlobRestClient::BlockBlob::Query(
+        *m_pipeline, m_blobUrl, protocolLayerOptions, _internal::WithReplicaStatus(context));
+    response.Value.BodyStream = std::make_unique<BlobQueryBodyStream>(
+        std::move(response.Value.BodyStream), options.ErrorHandler, options.ProgressHandler);
+    return response;
+  }
+
 }}} // namespace Azure::Storage::Blobs
@@ -3,14 +3,224 @@
 
 #include "azure/storage/blobs/page_blob_client.hpp"
 
+#include <azure/core/internal/diagnostics/span.hpp>
+#include <azure/core/io/body_stream.hpp>
 #include <azure/storage/common/internal/concurrent_transfer.hpp>
 #include <azure/storage/common/internal/constants.hpp>
 #include <azure/storage/common/internal/file_io.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    constexpr int64_t PageSize = 512;
+    constexpr int64_t MaxUploadPagesSize = 4 * 1024 * 1024;
+
+    // Whether the page of PageSize bytes is all zeros. The words of the page are ORed together
+    // without branches, which compilers vectorize.
+    bool IsZeroPage(const uint8_t* page)
+    {
+      uint64_t bits = 0;
+      for (int64_t i = 0; i < PageSize; i += sizeof(uint64_t))
+      {
+        uint64_t word;
+        std::memcpy(&word, page + i, sizeof(word));
+        bits |= word;
+      }
+      return bits == 0;
+    }
+
+    // Uploads the pages of data, the content of the blob from offset, which aren't all zeros.
+    // Consecutive pages are uploaded by a single request. Returns the number of bytes uploaded.
+    int64_t UploadNonZeroPages(
+        const PageBlobClient& client,
+        const uint8_t* data,
+        int64_t offset,
+        int64_t length,
+        const Azure::Core::Context& context)
+    {
+      int64_t uploadedSize = 0;
+      int64_t runStart = -1;
+      for (int64_t position = 0; position <= length; position += PageSize)
+      {
+        const bool isZero = position == length || IsZeroPage(data + position);
+        if (!isZero && runStart < 0)
+        {
+          runStart = position;
+        }
+        else if (isZero && runStart >= 0)
+        {
+          Azure::Core::IO::MemoryBodyStream content(
+              data + runStart, static_cast<size_t>(position - runStart));
+          client.UploadPages(offset + runStart, content, UploadPagesOptions(), context);
+          uploadedSize += position - runStart;
+          runStart = -1;
+        }
+      }
+      return uploadedSize;
+    }
+
+    // Creates the page blob, then uploads its content in chunks concurrently with uploadChunk,
+    // which is called with the offset and the length of each chunk and returns the number of
+    // bytes it uploaded.
+    Azure::Response<Models::UploadPageBlobFromResult> CreateAndUploadChunks(
+        const PageBlobClient& client,
+        int64_t blobSize,
+        const UploadPageBlobFromOptions& options,
+        const std::function<int64_t(int64_t, int64_t)>& uploadChunk,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      if (blobSize % PageSize != 0)
+      {
+        throw Azure::Core::RequestFailedException(
+            "The size of a page blob must be a multiple of 512 bytes.");
+      }
+      const int64_t chunkSize = options.TransferOptions.ChunkSize;
+      if (chunkSize <= 0 || chunkSize % PageSize != 0 || chunkSize > MaxUploadPagesSize)
+      {
+        throw Azure::Core::RequestFailedException(
+            "Chunk size must be a positive multiple of 512 bytes, up to 4 MiB.");
+      }
+
+      CreatePageBlobOptions createOptions;
+      createOptions.HttpHeaders = options.HttpHeaders;
+      createOptions.Metadata = options.Metadata;
+      createOptions.Tags = options.Tags;
+      createOptions.AccessTier = options.AccessTier;
+      auto createResponse = client.Create(blobSize, createOptions, context);
+
+      // A new page blob reads as zeros, the pages of zeros are skipped.
+      std::atomic<int64_t> uploadedSize{0};
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = chunkSize;
+      transferOptions.Concurrency = options.TransferOptions.Concurrency;
+      _internal::ConcurrentTransfer(
+          0,
+          blobSize,
+          transferOptions,
+          [&](int64_t offset, int64_t length, int64_t) {
+            uploadedSize += uploadChunk(offset, length);
+          },
+          transferExecutor);
+
+      Models::UploadPageBlobFromResult ret;
+      ret.VersionId = std::move(createResponse.Value.VersionId);
+      ret.IsServerEncrypted = createResponse.Value.IsServerEncrypted;
+      ret.EncryptionKeySha256 = std::move(createResponse.Value.EncryptionKeySha256);
+      ret.EncryptionScope = std::move(createResponse.Value.EncryptionScope);
+      ret.UploadedSize = uploadedSize;
+      return Azure::Response<Models::UploadPageBlobFromResult>(
+          std::move(ret), std::move(createResponse.RawResponse));
+    }
+
+    // Downloads the page ranges of the blob to the same offsets of the file, concurrently, split
+    // in chunks of up to chunkSize bytes. Returns the number of bytes downloaded.
+    int64_t DownloadPageRanges(
+        const PageBlobClient& client,
+        const std::vector<Azure::Core::Http::HttpRange>& pageRanges,
+        int64_t blobSize,
+        const DownloadBlobOptions& chunkOptions,
+        int64_t chunkSize,
+        int32_t concurrency,
+        _internal::FileWriter& fileWriter,
+        const std::shared_ptr<BufferPool>& bufferPool,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      chunkSize = std::max<int64_t>(chunkSize, 1);
+      std::vector<Azure::Core::Http::HttpRange> chunks;
+      int64_t downloadedSize = 0;
+      for (const auto& pageRange : pageRanges)
+      {
+        const int64_t end = std::min(pageRange.Offset + pageRange.Length.Value(), blobSize);
+        for (int64_t offset = pageRange.Offset; offset < end; offset += chunkSize)
+        {
+          Azure::Core::Http::HttpRange chunk;
+          chunk.Offset = offset;
+          chunk.Length = std::min(chunkSize, end - offset);
+          chunks.push_back(chunk);
+          downloadedSize += chunk.Length.Value();
+        }
+      }
+
+      auto downloadChunkFunc = [&](int64_t chunkIndex, int64_t, int64_t) {
+        const auto& chunk = chunks[static_cast<size_t>(chunkIndex)];
+        DownloadBlobOptions options = chunkOptions;
+        options.Range = chunk;
+        auto downloadResponse = client.Download(options, context);
+
+        constexpr size_t bufferSize = 4 * 1024 * 1024;
+        _internal::PooledBuffer buffer(bufferPool, bufferSize, context);
+        int64_t offset = chunk.Offset;
+        int64_t length = chunk.Length.Value();
+        while (length > 0)
+        {
+          const size_t readSize = static_cast<size_t>(std::min<int64_t>(bufferSize, length));
+          const size_t bytesRead
+              = downloadResponse.Value.BodyStream->ReadToCount(buffer.Data(), readSize, context);
+          if (bytesRead != readSize)
+          {
+            throw Azure::Core::RequestFailedException("Error when reading body stream.");
+          }
+          fileWriter.Write(buffer.Data(), bytesRead, offset);
+          offset += static_cast<int64_t>(bytesRead);
+          length -= static_cast<int64_t>(bytesRead);
+        }
+      };
+
+      // The chunks are downloaded one per transfer.
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = 1;
+      transferOptions.Concurrency = concurrency;
+      _internal::ConcurrentTransfer(
+          0,
+          static_cast<int64_t>(chunks.size()),
+          transferOptions,
+          downloadChunkFunc,
+          transferExecutor);
+      return downloadedSize;
+    }
+
+    _detail::BlobRestClient::PageBlob::CreatePageBlobOptions GetCreateProtocolLayerOptions(
+        int64_t blobSize,
+        const CreatePageBlobOptions& options,
+        const Azure::Nullable<EncryptionKey>& customerProvidedKey,
+        const Azure::Nullable<std::string>& encryptionScope)
+    {
+      _detail::BlobRestClient::PageBlob::CreatePageBlobOptions protocolLayerOptions;
+      protocolLayerOptions.BlobSize = blobSize;
+      protocolLayerOptions.SequenceNumber = options.SequenceNumber;
+      protocolLayerOptions.HttpHeaders = options.HttpHeaders;
+      protocolLayerOptions.Metadata = options.Metadata;
+      protocolLayerOptions.AccessTier = options.AccessTier;
+      protocolLayerOptions.Tags = options.Tags;
+      protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+      protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
+      protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
+      protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
+      protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+      protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
+      if (customerProvidedKey.HasValue())
+      {
+        protocolLayerOptions.EncryptionKey = customerProvidedKey.Value().Key;
+        protocolLayerOptions.EncryptionKeySha256 = customerProvidedKey.Value().KeyHash;
+        protocolLayerOptions.EncryptionAlgorithm = customerProvidedKey.Value().Algorithm;
+      }
+      protocolLayerOptions.EncryptionScope = encryptionScope;
+      return protocolLayerOptions;
+    }
+  } // namespace
+
   PageBlobClient PageBlobClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& blobContainerName,
@@ -80,28 +290,12 @@ namespace Azure { namespace Storage { namespace Blobs {
       const CreatePageBlobOptions& options,
       const Azure::Core::Context& context) const
   {
-    _detail::BlobRestClient::PageBlob::CreatePageBlobOptions protocolLayerOptions;
-    protocolLayerOptions.BlobSize = blobSize;
-    protocolLayerOptions.SequenceNumber = options.SequenceNumber;
-    protocolLayerOptions.HttpHeaders = options.HttpHeaders;
-    protocolLayerOptions.Metadata = options.Metadata;
-    protocolLayerOptions.AccessTier = options.AccessTier;
-    protocolLayerOptions.Tags = options.Tags;
-    protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
-    protocolLayerOptions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
-    protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
-    protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
-    protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
-    protocolLayerOptions.IfTags = options.AccessConditions.TagConditions;
-    if (m_customerProvidedKey.HasValue())
-    {
-      protocolLayerOptions.EncryptionKey = m_customerProvidedKey.Value().Key;
-      protocolLayerOptions.EncryptionKeySha256 = m_customerProvidedKey.Value().KeyHash;
-      protocolLayerOptions.EncryptionAlgorithm = m_customerProvidedKey.Value().Algorithm;
-    }
-    protocolLayerOptions.EncryptionScope = m_encryptionScope;
     return _detail::BlobRestClient::PageBlob::Create(
-        *m_pipeline, m_blobUrl, protocolLayerOptions, context);
+        *m_pipeline,
+        m_blobUrl,
+        GetCreateProtocolLayerOptions(
+            blobSize, options, m_customerProvidedKey, m_encryptionScope),
+        context);
   }
 
   Azure::Response<Models::CreatePageBlobResult> PageBlobClient::CreateIfNotExists(
@@ -111,22 +305,74 @@ namespace Azure { namespace Storage { namespace Blobs {
   {
     auto optionsCopy = options;
     optionsCopy.AccessConditions.IfNoneMatch = Azure::ETag::Any();
-    try
-    {
-      return Create(blobContentLength, optionsCopy, context);
-    }
-    catch (StorageException& e)
+    auto request = _detail::BlobRestClient::PageBlob::CreateCreateMessage(
+        m_blobUrl,
+        GetCreateProtocolLayerOptions(
+            blobContentLength, optionsCopy, m_customerProvidedKey, m_encryptionScope));
+    auto response = m_pipeline->Send(request, context);
+    // An existing blob is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response, Core::Http::HttpStatusCode::Conflict, {"BlobAlreadyExists"}))
     {
-      if (e.StatusCode == Core::Http::HttpStatusCode::Conflict
-          && e.ErrorCode == "BlobAlreadyExists")
-      {
-        Models::CreatePageBlobResult ret;
-        ret.Created = false;
-        return Azure::Response<Models::CreatePageBlobResult>(
-            std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::CreatePageBlobResult ret;
+      ret.Created = false;
+      return Azure::Response<Models::CreatePageBlobResult>(std::move(ret), std::move(response));
     }
+    return _detail::BlobRestClient::PageBlob::CreateCreateResponse(std::move(response), context);
+  }
+
+  Azure::Response<Models::UploadPageBlobFromResult> PageBlobClient::UploadFrom(
+      const uint8_t* buffer,
+      size_t bufferSize,
+      const UploadPageBlobFromOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("PageBlobClient.UploadFrom", bulkContext);
+    return CreateAndUploadChunks(
+        *this,
+        static_cast<int64_t>(bufferSize),
+        options,
+        [&](int64_t offset, int64_t length) {
+          return UploadNonZeroPages(*this, buffer + offset, offset, length, span.GetContext());
+        },
+        m_transferExecutor,
+        span.GetContext());
+  }
+
+  Azure::Response<Models::UploadPageBlobFromResult> PageBlobClient::UploadFrom(
+      const std::string& fileName,
+      const UploadPageBlobFromOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("PageBlobClient.UploadFrom", bulkContext);
+    _internal::FileReader fileReader(fileName, _internal::FileIoMode::MemoryMapped);
+    const uint8_t* mappedData = fileReader.GetMappedData();
+    return CreateAndUploadChunks(
+        *this,
+        fileReader.GetFileSize(),
+        options,
+        [&](int64_t offset, int64_t length) {
+          if (mappedData != nullptr)
+          {
+            return UploadNonZeroPages(
+                *this, mappedData + offset, offset, length, span.GetContext());
+          }
+          // The chunk is read to be scanned for pages of zeros before it is uploaded.
+          _internal::PooledBuffer buffer(
+              m_bufferPool, static_cast<size_t>(length), span.GetContext());
+          Azure::Core::IO::_internal::RandomAccessFileBodyStream fileStream(
+              fileReader.GetHandle(), offset, length);
+          if (fileStream.ReadToCount(buffer.Data(), static_cast<size_t>(length), span.GetContext())
+              != static_cast<size_t>(length))
+          {
+            throw std::runtime_error("Failed to read file.");
+          }
+          return UploadNonZeroPages(*this, buffer.Data(), offset, length, span.GetContext());
+        },
+        m_transferExecutor,
+        span.GetContext());
   }
 
   Azure::Response<Models::UploadPagesResult> PageBlobClient::UploadPages(
@@ -161,6 +407,18 @@ namespace Azure { namespace Storage { namespace Blobs {
         *m_pipeline, m_blobUrl, content, protocolLayerOptions, context);
   }
 
+  std::unique_ptr<PageBlobWriter> PageBlobClient::OpenWrite(
+      const OpenWritePageBlobOptions& options) const
+  {
+    if (options.RangeSize <= 0 || options.RangeSize % PageSize != 0
+        || options.RangeSize > MaxUploadPagesSize)
+    {
+      throw Azure::Core::RequestFailedException(
+          "Range size must be a positive multiple of 512 bytes, up to 4 MiB.");
+    }
+    return std::unique_ptr<PageBlobWriter>(new PageBlobWriter(*this, options, m_transferExecutor));
+  }
+
   Azure::Response<Models::UploadPagesFromUriResult> PageBlobClient::UploadPagesFromUri(
       int64_t destinationOffset,
       std::string sourceUri,
@@ -294,6 +552,97 @@ namespace Azure { namespace Storage { namespace Blobs {
     return pagedResponse;
   }
 
+  Azure::Response<Models::DownloadPageBlobSparseToResult> PageBlobClient::DownloadSparseTo(
+      const std::string& fileName,
+      const DownloadPageBlobSparseToOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("PageBlobClient.DownloadSparseTo", bulkContext);
+    GetPageRangesOptions getPageRangesOptions;
+    getPageRangesOptions.AccessConditions = options.AccessConditions;
+    auto pageRanges = GetPageRanges(getPageRangesOptions, span.GetContext());
+
+    Models::DownloadPageBlobSparseToResult ret;
+    ret.ETag = pageRanges.ETag;
+    ret.LastModified = pageRanges.LastModified;
+    ret.BlobSize = pageRanges.BlobSize;
+
+    // The clear pages are never written, they are the holes of the file.
+    _internal::FileWriter fileWriter(fileName);
+    fileWriter.ResizeSparse(ret.BlobSize);
+
+    DownloadBlobOptions chunkOptions;
+    chunkOptions.AccessConditions = options.AccessConditions;
+    // The ranges listed are those of this version of the blob.
+    chunkOptions.AccessConditions.IfMatch = ret.ETag;
+    ret.DownloadedSize = DownloadPageRanges(
+        *this,
+        pageRanges.PageRanges,
+        ret.BlobSize,
+        chunkOptions,
+        options.TransferOptions.ChunkSize,
+        options.TransferOptions.Concurrency,
+        fileWriter,
+        m_bufferPool,
+        m_transferExecutor,
+        span.GetContext());
+
+    return Azure::Response<Models::DownloadPageBlobSparseToResult>(
+        std::move(ret), std::move(pageRanges.RawResponse));
+  }
+
+  Azure::Response<Models::DownloadPageBlobDiffToResult> PageBlobClient::DownloadDiffTo(
+      const std::string& previousSnapshot,
+      const std::string& fileName,
+      const DownloadPageBlobDiffToOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    Azure::Core::Diagnostics::_internal::Span span("PageBlobClient.DownloadDiffTo", bulkContext);
+    GetPageRangesOptions getPageRangesOptions;
+    getPageRangesOptions.AccessConditions = options.AccessConditions;
+    auto diff = GetPageRangesDiff(previousSnapshot, getPageRangesOptions, span.GetContext());
+
+    Models::DownloadPageBlobDiffToResult ret;
+    ret.ETag = diff.ETag;
+    ret.LastModified = diff.LastModified;
+    ret.BlobSize = diff.BlobSize;
+
+    _internal::FileWriter fileWriter(fileName, _internal::FileIoMode::Buffered, false);
+    fileWriter.ResizeSparse(ret.BlobSize);
+    for (const auto& clearRange : diff.ClearRanges)
+    {
+      const int64_t length
+          = std::min(clearRange.Offset + clearRange.Length.Value(), ret.BlobSize)
+          - clearRange.Offset;
+      if (length > 0)
+      {
+        fileWriter.ZeroRange(clearRange.Offset, length);
+        ret.ClearedSize += length;
+      }
+    }
+
+    DownloadBlobOptions chunkOptions;
+    chunkOptions.AccessConditions = options.AccessConditions;
+    // The ranges listed are those of this version of the blob.
+    chunkOptions.AccessConditions.IfMatch = ret.ETag;
+    ret.DownloadedSize = DownloadPageRanges(
+        *this,
+        diff.PageRanges,
+        ret.BlobSize,
+        chunkOptions,
+        options.TransferOptions.ChunkSize,
+        options.TransferOptions.Concurrency,
+        fileWriter,
+        m_bufferPool,
+        m_transferExecutor,
+        span.GetContext());
+
+    return Azure::Response<Models::DownloadPageBlobDiffToResult>(
+        std::move(ret), std::move(diff.RawResponse));
+  }
+
   GetPageRangesDiffPagedResponse PageBlobClient::GetPageRangesDiff(
       const std::string& previousSnapshot,
       const GetPageRangesOptions& options,
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/page_blob_writer.hpp"
+
+#include <azure/core/io/body_stream.hpp>
+#include <azure/storage/common/internal/range_write_coalescer.hpp>
+
+#include "azure/storage/blobs/page_blob_client.hpp"
+
+#include <utility>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    constexpr int64_t PageSize = 512;
+  } // namespace
+
+  struct PageBlobWriter::State final
+  {
+    State(
+        const PageBlobClient& client,
+        const OpenWritePageBlobOptions& options,
+        std::shared_ptr<TransferExecutor> transferExecutor)
+        : Client(client), AccessConditions(options.AccessConditions),
+          Coalescer(
+              GetCoalescerOptions(options),
+              [this](
+                  int64_t offset,
+                  const uint8_t* data,
+                  size_t length,
+                  const Azure::Core::Context& context) {
+                Azure::Core::IO::MemoryBodyStream content(data, length);
+                UploadPagesOptions uploadOptions;
+                uploadOptions.AccessConditions = AccessConditions;
+                Client.UploadPages(offset, content, uploadOptions, context);
+              },
+              [this](
+                  int64_t offset,
+                  uint8_t* data,
+                  size_t length,
+                  const Azure::Core::Context& context) {
+                DownloadBlobOptions downloadOptions;
+                downloadOptions.Range = Azure::Core::Http::HttpRange();
+                downloadOptions.Range.Value().Offset = offset;
+                downloadOptions.Range.Value().Length = static_cast<int64_t>(length);
+                downloadOptions.AccessConditions = AccessConditions;
+                auto response = Client.Download(downloadOptions, context);
+                response.Value.BodyStream->ReadToCount(data, length, context);
+              },
+              std::move(transferExecutor))
+    {
+    }
+
+    static _internal::RangeWriteCoalescerOptions GetCoalescerOptions(
+        const OpenWritePageBlobOptions& options)
+    {
+      _internal::RangeWriteCoalescerOptions coalescerOptions;
+      coalescerOptions.Alignment = PageSize;
+      coalescerOptions.MaxRangeSize = options.RangeSize;
+      coalescerOptions.Concurrency = options.Concurrency;
+      coalescerOptions.MaxBufferedSize = options.MaxBufferedSize;
+      return coalescerOptions;
+    }
+
+    PageBlobClient Client;
+    PageBlobAccessConditions AccessConditions;
+    _internal::RangeWriteCoalescer Coalescer;
+  };
+
+  PageBlobWriter::PageBlobWriter(
+      const PageBlobClient& client,
+      const OpenWritePageBlobOptions& options,
+      std::shared_ptr<TransferExecutor> transferExecutor)
+      : m_state(std::make_unique<State>(client, options, std::move(transferExecutor)))
+  {
+  }
+
+  PageBlobWriter::~PageBlobWriter()
+  {
+    try
+    {
+      m_state->Coalescer.Flush(Azure::Core::Context());
+    }
+    catch (...)
+    {
+    }
+  }
+
+  void PageBlobWriter::WriteAt(
+      int64_t offset,
+      const uint8_t* data,
+      size_t length,
+      const Azure::Core::Context& context)
+  {
+    m_state->Coalescer.WriteAt(offset, data, length, context);
+  }
+
+  void PageBlobWriter::Flush(const Azure::Core::Context& context)
+  {
+    m_state->Coalescer.Flush(context);
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <azure/core/context.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace _detail {
+
+  enum class AvroDatumType
+  {
+    Null,
+    Boolean,
+    Int,
+    Long,
+    Float,
+    Double,
+    Bytes,
+    String,
+    Record,
+    Enum,
+    Array,
+    Map,
+    Union,
+    Fixed,
+  };
+
+  // The schema of a value of an Avro file. Records, enums and fixed have the full name of their
+  // type. The fields of records, the branches of unions and the items of arrays and maps point to
+  // the schemas owned by the reader that parsed them.
+  struct AvroSchema final
+  {
+    AvroDatumType Type = AvroDatumType::Null;
+    std::string Name;
+    // The names of the fields of a record, or the symbols of an enum.
+    std::vector<std::string> FieldNames;
+    // The types of the fields of a record, the branches of a union, or the type of the items of an
+    // array or of the values of a map.
+    std::vector<const AvroSchema*> Children;
+    // The size of a fixed.
+    size_t Size = 0;
+  };
+
+  // A value decoded from an Avro file. The value of a union is the value of its branch, whose
+  // schema tells which branch it is.
+  struct AvroDatum final
+  {
+    const AvroSchema* Schema = nullptr;
+    bool Boolean = false;
+    // The value of an int or a long, or the index of the symbol of an enum.
+    int64_t Long = 0;
+    double Double = 0.0;
+    // The content of bytes, a string or a fixed.
+    std::string String;
+    // The fields of a record, or the items of an array, or the values of a map.
+    std::vector<AvroDatum> Items;
+    // The keys of the values of a map.
+    std::vector<std::string> Keys;
+
+    // Gets a field of a record, throws if the record has no such field.
+    const AvroDatum& Field(const std::string& name) const;
+  };
+
+  // Reads the values of an Avro object container file from a stream as they are received, one
+  // at a time. Only the null codec is supported.
+  class AvroObjectContainerReader final {
+  public:
+    explicit AvroObjectContainerReader(std::unique_ptr<Azure::Core::IO::BodyStream> stream);
+
+    // Reads the next value of the file. Returns false at the end of the file.
+    bool Next(AvroDatum& datum, const Azure::Core::Context& context);
+
+  private:
+    void ReadHeader(const Azure::Core::Context& context);
+    bool FillBuffer(const Azure::Core::Context& context);
+    uint8_t ReadByte(const Azure::Core::Context& context);
+    void ReadBytes(uint8_t* buffer, size_t count, const Azure::Core::Context& context);
+    int64_t ReadLong(const Azure::Core::Context& context);
+    std::string ReadString(const Azure::Core::Context& context);
+    void ReadDatum(
+        const AvroSchema& schema,
+        AvroDatum& datum,
+        const Azure::Core::Context& context);
+
+    std::unique_ptr<Azure::Core::IO::BodyStream> m_stream;
+    std::vector<uint8_t> m_buffer;
+    size_t m_bufferOffset = 0;
+    size_t m_bufferLength = 0;
+    bool m_headerRead = false;
+    std::array<uint8_t, 16> m_syncMarker{};
+    int64_t m_remainingBlockObjects = 0;
+    std::vector<std::unique_ptr<AvroSchema>> m_schemas;
+    const AvroSchema* m_schema = nullptr;
+  };
+
+}}}} // namespace Azure::Storage::Blobs::_detail
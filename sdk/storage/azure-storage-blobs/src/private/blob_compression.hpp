@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace _detail {
+
+  // The metadata of a blob compressed by UploadFrom(): the codec, the size of its blocks before
+  // they are compressed, all of them but the last, and the size of its content.
+  constexpr const char* CompressionCodecMetadataName = "azsdkcompressioncodec";
+  constexpr const char* CompressionBlockSizeMetadataName = "azsdkcompressionblocksize";
+  constexpr const char* UncompressedSizeMetadataName = "azsdkuncompressedsize";
+
+  // Compresses data in a gzip stream.
+  std::vector<uint8_t> GzipCompress(const uint8_t* data, size_t length);
+
+  // Decompresses a gzip stream, which must decompress to exactly outputLength bytes. Throws if
+  // the stream is corrupted or has another size.
+  void GzipDecompress(const uint8_t* data, size_t length, uint8_t* output, size_t outputLength);
+
+}}}} // namespace Azure::Storage::Blobs::_detail
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <memory>
+
+#include <azure/core/context.hpp>
+#include <azure/core/http/policies/policy.hpp>
+
+#include "azure/storage/blobs/blob_download_cache.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs { namespace _detail {
+
+  // Serves the downloads of whole blobs from a BlobDownloadCache when the service answers that
+  // they haven't changed. It runs once per operation, before the retries, so that a retried
+  // download isn't made conditional if its first try wasn't.
+  class BlobDownloadCachePolicy final : public Core::Http::Policies::HttpPolicy {
+  public:
+    explicit BlobDownloadCachePolicy(std::shared_ptr<BlobDownloadCache> cache)
+        : m_cache(std::move(cache))
+    {
+    }
+
+    ~BlobDownloadCachePolicy() override {}
+
+    std::unique_ptr<HttpPolicy> Clone() const override
+    {
+      return std::make_unique<BlobDownloadCachePolicy>(*this);
+    }
+
+    std::unique_ptr<Core::Http::RawResponse> Send(
+        Core::Http::Request& request,
+        Core::Http::Policies::NextHttpPolicy nextPolicy,
+        Core::Context const& context) const override;
+
+  private:
+    std::shared_ptr<BlobDownloadCache> m_cache;
+  };
+
+}}}} // namespace Azure::Storage::Blobs::_detail
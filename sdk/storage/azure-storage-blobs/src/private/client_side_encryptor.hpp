@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <azure/core/context.hpp>
+#include <azure/storage/common/crypt.hpp>
+
+#include "azure/storage/blobs/blob_client_side_encryption.hpp"
+
+namespace Azure { namespace Storage { namespace Blobs { namespace _detail {
+
+  // The metadata holding the encryption data of a blob encrypted on the client side.
+  constexpr const char* EncryptionDataMetadataName = "encryptiondata";
+
+  // A content key, with the encryption data of the blobs it encrypts.
+  struct ContentEncryptionKey final
+  {
+    explicit ContentEncryptionKey(const std::vector<uint8_t>& key) : Key(key) {}
+
+    Storage::_internal::AesGcmKey Key;
+    std::string EncryptionData;
+  };
+
+  // The content key of an encrypted blob and the size of its regions, read from its encryption
+  // data.
+  struct ContentDecryptionKey final
+  {
+    std::shared_ptr<const Storage::_internal::AesGcmKey> Key;
+    int64_t RegionLength = 0;
+  };
+
+  class ClientSideEncryptor final {
+  public:
+    // The size of the regions of the uploaded blobs.
+    static constexpr int64_t RegionLength = 4 * 1024 * 1024;
+    // The size a region grows by when it's encrypted, for its nonce and tag.
+    static constexpr int64_t RegionOverhead
+        = Storage::_internal::AesGcmKey::NonceSize + Storage::_internal::AesGcmKey::TagSize;
+
+    // Gets the content key of the uploads, generated and wrapped by the first one.
+    static std::shared_ptr<const ContentEncryptionKey> GetUploadKey(
+        const BlobClientSideEncryption& encryption,
+        const Azure::Core::Context& context);
+
+    // Gets the content key of a blob from its encryption data, unwrapped by the first download of
+    // a blob encrypted with it. Throws if the blob is encrypted in an unsupported format or with
+    // another key encryption key.
+    static ContentDecryptionKey GetDownloadKey(
+        const BlobClientSideEncryption& encryption,
+        const std::string& encryptionData,
+        const Azure::Core::Context& context);
+
+    // Encrypts data, which starts at the beginning of a region, in regions of a nonce, the
+    // ciphertext and the tag.
+    static std::vector<uint8_t> EncryptRegions(
+        const Storage::_internal::AesGcmKey& key,
+        const uint8_t* data,
+        size_t length);
+
+    // Decrypts an encrypted region of a nonce, the ciphertext and the tag. Throws if it doesn't
+    // decrypt with the key.
+    static void DecryptRegion(
+        const Storage::_internal::AesGcmKey& key,
+        const uint8_t* region,
+        size_t regionLength,
+        uint8_t* data);
+
+    // Gets the size of the content of a blob whose encrypted size is encryptedLength.
+    static int64_t GetDecryptedLength(int64_t encryptedLength, int64_t regionLength);
+  };
+
+}}}} // namespace Azure::Storage::Blobs::_detail
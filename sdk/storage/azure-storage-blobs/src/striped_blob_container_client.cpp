@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/blobs/striped_blob_container_client.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    // FNV-1a, the same on every platform, unlike std::hash, so that all the processes sharing the
+    // containers pick the same container for a blob.
+    uint64_t HashName(const std::string& name)
+    {
+      uint64_t hash = 14695981039346656037ULL;
+      for (const char c : name)
+      {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    // The finalizer of SplitMix64, so that the rank of a container for a blob doesn't follow the
+    // bits shared by the hashes of similar names.
+    uint64_t Mix(uint64_t value)
+    {
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+      return value ^ (value >> 31);
+    }
+  } // namespace
+
+  StripedBlobContainerClient::StripedBlobContainerClient(
+      std::vector<BlobContainerClient> containerClients)
+      : m_containerClients(std::move(containerClients))
+  {
+    if (m_containerClients.empty())
+    {
+      throw std::invalid_argument("At least one container is needed to stripe the blobs.");
+    }
+    m_containerHashes.reserve(m_containerClients.size());
+    for (const auto& containerClient : m_containerClients)
+    {
+      m_containerHashes.push_back(HashName(containerClient.GetUrl()));
+    }
+  }
+
+  StripedBlobContainerClient::StripedBlobContainerClient(
+      const std::vector<BlobServiceClient>& serviceClients,
+      const std::string& blobContainerName)
+      : StripedBlobContainerClient(
+          [&serviceClients, &blobContainerName]() {
+            std::vector<BlobContainerClient> containerClients;
+            containerClients.reserve(serviceClients.size());
+            for (const auto& serviceClient : serviceClients)
+            {
+              containerClients.push_back(serviceClient.GetBlobContainerClient(blobContainerName));
+            }
+            return containerClients;
+          }())
+  {
+  }
+
+  size_t StripedBlobContainerClient::GetContainerIndex(const std::string& blobName) const
+  {
+    const uint64_t nameHash = HashName(blobName);
+    size_t index = 0;
+    uint64_t highestRank = 0;
+    for (size_t i = 0; i < m_containerHashes.size(); ++i)
+    {
+      const uint64_t rank = Mix(nameHash ^ m_containerHashes[i]);
+      if (i == 0 || rank > highestRank)
+      {
+        index = i;
+        highestRank = rank;
+      }
+    }
+    return index;
+  }
+
+  void StripedBlobContainerClient::ListBlobsConcurrently(
+      const std::function<void(std::vector<Models::BlobItem>)>& onBlobs,
+      const ListBlobsConcurrentlyOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    // The containers are listed one after another, each of them with the concurrency of the
+    // options, so that the number of requests in flight doesn't grow with the containers.
+    for (const auto& containerClient : m_containerClients)
+    {
+      containerClient.ListBlobsConcurrently(onBlobs, options, context);
+    }
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of deleting a blob which doesn't exist, without the network.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/storage/blobs.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace Test {
+
+  /**
+   * @brief A test to measure deleting a blob if it exists, with a transport answering that the
+   * blob is not found.
+   *
+   * @remark The expected failure is handled without throwing, its cost can be compared with the
+   * `exception` test of Azure Core.
+   */
+  class DeleteBlobIfExistsCanned : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Storage::Blobs::BlobClient> m_blobClient;
+
+  public:
+    /**
+     * @brief Construct a new DeleteBlobIfExistsCanned test.
+     *
+     * @param options The test options.
+     */
+    DeleteBlobIfExistsCanned(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the blob client with a transport answering 404 BlobNotFound.
+     *
+     */
+    void Setup() override
+    {
+      const std::string body
+          = "<?xml version=\"1.0\" encoding=\"utf-8\"?><Error><Code>BlobNotFound</Code>"
+            "<Message>The specified blob does not exist.\n"
+            "RequestId:c5ca2e5d-b01e-0046-5a5e-08f8d3000000\n"
+            "Time:2022-01-13T21:37:53.0000000Z</Message></Error>";
+
+      Azure::Perf::CannedResponse response;
+      response.StatusCode = Azure::Core::Http::HttpStatusCode::NotFound;
+      response.ReasonPhrase = "The specified blob does not exist.";
+      response.Headers = {
+          {"content-type", "application/xml"},
+          {"x-ms-error-code", "BlobNotFound"},
+          {"x-ms-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000"},
+          {"x-ms-version", "2020-02-10"},
+          {"date", "Thu, 13 Jan 2022 21:37:53 GMT"},
+      };
+      response.Body.assign(body.begin(), body.end());
+
+      Azure::Storage::Blobs::BlobClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_blobClient = std::make_unique<Azure::Storage::Blobs::BlobClient>(
+          "https://account.blob.core.windows.net/container/blob",
+          std::make_shared<Azure::Storage::StorageSharedKeyCredential>(
+              "account", "YWNjb3VudEtleQ=="),
+          options);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      auto result = m_blobClient->DeleteIfExists({}, context);
+      (void)result;
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override { return {}; }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "DeleteBlobIfExistsCanned",
+          "Delete a blob which doesn't exist, with a canned response. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Blobs::Test::DeleteBlobIfExistsCanned>(
+                options);
+          }};
+    }
+  };
+
+}}}} // namespace Azure::Storage::Blobs::Test
@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of the SDK layers when downloading a blob, without the network.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/storage/blobs.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace Test {
+
+  /**
+   * @brief A test to measure downloading a blob with a transport returning a canned response.
+   *
+   * @remark The request is signed with a shared key and goes through all the policies of the
+   * client, and the response headers are deserialized and the body is read from a stream. Only
+   * the network is left out, so no storage account is needed.
+   */
+  class DownloadBlobCanned : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Storage::Blobs::BlobClient> m_blobClient;
+    std::vector<uint8_t> m_downloadBuffer;
+
+  public:
+    /**
+     * @brief Construct a new DownloadBlobCanned test.
+     *
+     * @param options The test options.
+     */
+    DownloadBlobCanned(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the blob client with a canned response of the size from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const size = m_options.GetMandatoryOption<size_t>("Size");
+      m_downloadBuffer.resize(size);
+
+      Azure::Perf::CannedResponse response;
+      response.Headers = {
+          {"content-type", "application/octet-stream"},
+          {"etag", "\"0x8D9C2A1B3E4F5A6\""},
+          {"last-modified", "Thu, 13 Jan 2022 21:37:52 GMT"},
+          {"x-ms-creation-time", "Thu, 13 Jan 2022 21:37:52 GMT"},
+          {"x-ms-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000"},
+          {"x-ms-version", "2020-02-10"},
+          {"x-ms-blob-type", "BlockBlob"},
+          {"x-ms-lease-status", "unlocked"},
+          {"x-ms-lease-state", "available"},
+          {"x-ms-server-encrypted", "true"},
+          {"accept-ranges", "bytes"},
+          {"date", "Thu, 13 Jan 2022 21:37:53 GMT"},
+      };
+      response.Body.resize(size);
+
+      Azure::Storage::Blobs::BlobClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_blobClient = std::make_unique<Azure::Storage::Blobs::BlobClient>(
+          "https://account.blob.core.windows.net/container/blob",
+          std::make_shared<Azure::Storage::StorageSharedKeyCredential>(
+              "account", "YWNjb3VudEtleQ=="),
+          options);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      auto result = m_blobClient->Download({}, context);
+      result.Value.BodyStream->ReadToCount(
+          m_downloadBuffer.data(), m_downloadBuffer.size(), context);
+    }
+
+    /**
+     * @brief Each run downloads the whole blob.
+     *
+     */
+    int64_t GetBytesPerOperation() override
+    {
+      return static_cast<int64_t>(m_downloadBuffer.size());
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {{"Size", {"--size"}, "Size of payload (in bytes)", 1, true}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "DownloadBlobCanned",
+          "Download a blob from a canned response. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Blobs::Test::DownloadBlobCanned>(options);
+          }};
+    }
+  };
+
+}}}} // namespace Azure::Storage::Blobs::Test
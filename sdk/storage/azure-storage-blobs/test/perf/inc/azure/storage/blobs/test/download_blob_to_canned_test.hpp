@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of the SDK layers when downloading a blob to a buffer, without the
+ * network.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/storage/blobs.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace Test {
+
+  /**
+   * @brief A test to measure downloading a blob to a buffer with a transport returning a canned
+   * response.
+   *
+   * @remark The blob is smaller than the initial chunk, so it is downloaded with a single
+   * request, and the properties of the response are moved into the result. Run with `--profile`
+   * to see the allocations of each operation.
+   */
+  class DownloadBlobToCanned : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Storage::Blobs::BlobClient> m_blobClient;
+    std::vector<uint8_t> m_downloadBuffer;
+
+  public:
+    /**
+     * @brief Construct a new DownloadBlobToCanned test.
+     *
+     * @param options The test options.
+     */
+    DownloadBlobToCanned(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the blob client with a canned response of the size from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const size = m_options.GetMandatoryOption<size_t>("Size");
+      m_downloadBuffer.resize(size);
+
+      Azure::Perf::CannedResponse response;
+      response.Headers = {
+          {"content-type", "application/octet-stream"},
+          {"content-range", "bytes 0-" + std::to_string(size - 1) + "/" + std::to_string(size)},
+          {"etag", "\"0x8D9C2A1B3E4F5A6\""},
+          {"last-modified", "Thu, 13 Jan 2022 21:37:52 GMT"},
+          {"x-ms-creation-time", "Thu, 13 Jan 2022 21:37:52 GMT"},
+          {"x-ms-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000"},
+          {"x-ms-version", "2020-02-10"},
+          {"x-ms-version-id", "2022-01-13T21:37:52.4167436Z"},
+          {"x-ms-blob-type", "BlockBlob"},
+          {"x-ms-lease-status", "unlocked"},
+          {"x-ms-lease-state", "available"},
+          {"x-ms-server-encrypted", "true"},
+          {"accept-ranges", "bytes"},
+          {"date", "Thu, 13 Jan 2022 21:37:53 GMT"},
+      };
+      response.StatusCode = Azure::Core::Http::HttpStatusCode::PartialContent;
+      response.Body.resize(size);
+
+      Azure::Storage::Blobs::BlobClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_blobClient = std::make_unique<Azure::Storage::Blobs::BlobClient>(
+          "https://account.blob.core.windows.net/container/blob",
+          std::make_shared<Azure::Storage::StorageSharedKeyCredential>(
+              "account", "YWNjb3VudEtleQ=="),
+          options);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      m_blobClient->DownloadTo(m_downloadBuffer.data(), m_downloadBuffer.size(), {}, context);
+    }
+
+    /**
+     * @brief Each run downloads the whole blob.
+     *
+     */
+    int64_t GetBytesPerOperation() override
+    {
+      return static_cast<int64_t>(m_downloadBuffer.size());
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {{"Size", {"--size"}, "Size of payload (in bytes)", 1, true}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "DownloadBlobToCanned",
+          "Download a blob to a buffer from a canned response. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Blobs::Test::DownloadBlobToCanned>(options);
+          }};
+    }
+  };
+
+}}}} // namespace Azure::Storage::Blobs::Test
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of deserializing a list of blobs, without the network.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/storage/blobs.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace Test {
+
+  /**
+   * @brief A test to measure listing blobs with a transport returning a canned page of blobs.
+   *
+   * @remark Most of the time of the test is spent parsing the XML of the page.
+   */
+  class ListBlobCanned : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Storage::Blobs::BlobContainerClient> m_containerClient;
+
+  public:
+    /**
+     * @brief Construct a new ListBlobCanned test.
+     *
+     * @param options The test options.
+     */
+    ListBlobCanned(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the container client with a page of the number of blobs from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const count = m_options.GetMandatoryOption<int>("Count");
+
+      std::string body = "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+                         "ServiceEndpoint=\"https://account.blob.core.windows.net/\" "
+                         "ContainerName=\"container\"><Blobs>";
+      for (auto blob = 0; blob < count; blob++)
+      {
+        body += "<Blob><Name>Azure.Storage.Blobs.Perf.Scenarios.ListBlob-" + std::to_string(blob)
+            + "</Name><Properties>"
+              "<Creation-Time>Thu, 13 Jan 2022 21:37:52 GMT</Creation-Time>"
+              "<Last-Modified>Thu, 13 Jan 2022 21:37:52 GMT</Last-Modified>"
+              "<Etag>0x8D9C2A1B3E4F5A6</Etag>"
+              "<Content-Length>1024</Content-Length>"
+              "<Content-Type>application/octet-stream</Content-Type>"
+              "<Content-MD5>1B2M2Y8AsgTpgAmY7PhCfg==</Content-MD5>"
+              "<BlobType>BlockBlob</BlobType>"
+              "<AccessTier>Hot</AccessTier>"
+              "<AccessTierInferred>true</AccessTierInferred>"
+              "<LeaseStatus>unlocked</LeaseStatus>"
+              "<LeaseState>available</LeaseState>"
+              "<ServerEncrypted>true</ServerEncrypted>"
+              "</Properties></Blob>";
+      }
+      body += "</Blobs><NextMarker /></EnumerationResults>";
+
+      Azure::Perf::CannedResponse response;
+      response.Headers = {
+          {"content-type", "application/xml"},
+          {"x-ms-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000"},
+          {"x-ms-version", "2020-02-10"},
+          {"date", "Thu, 13 Jan 2022 21:37:53 GMT"},
+      };
+      response.Body.assign(body.begin(), body.end());
+
+      Azure::Storage::Blobs::BlobClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_containerClient = std::make_unique<Azure::Storage::Blobs::BlobContainerClient>(
+          "https://account.blob.core.windows.net/container",
+          std::make_shared<Azure::Storage::StorageSharedKeyCredential>(
+              "account", "YWNjb3VudEtleQ=="),
+          options);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      auto page = m_containerClient->ListBlobs({}, context);
+      for (auto const& blob : page.Blobs)
+      {
+        (void)blob;
+      }
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {{"Count", {"--count"}, "Number of blobs in the page", 1, true}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "ListBlobCanned",
+          "List a canned page of blobs. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Blobs::Test::ListBlobCanned>(options);
+          }};
+    }
+  };
+
+}}}} // namespace Azure::Storage::Blobs::Test
@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the overhead of the SDK layers when uploading a blob from a buffer, without the
+ * network.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/storage/blobs.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace Test {
+
+  /**
+   * @brief A test to measure uploading a blob from a buffer with a transport returning a canned
+   * response.
+   *
+   * @remark The buffer is smaller than the single upload threshold, so it is uploaded with a
+   * single request, and the properties of the response are moved into the result. Run with
+   * `--profile` to see the allocations of each operation.
+   */
+  class UploadBlobFromCanned : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Storage::Blobs::BlockBlobClient> m_blockBlobClient;
+    std::vector<uint8_t> m_uploadBuffer;
+
+  public:
+    /**
+     * @brief Construct a new UploadBlobFromCanned test.
+     *
+     * @param options The test options.
+     */
+    UploadBlobFromCanned(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create the block blob client with a canned response to the upload.
+     *
+     */
+    void Setup() override
+    {
+      m_uploadBuffer.resize(m_options.GetMandatoryOption<size_t>("Size"));
+
+      Azure::Perf::CannedResponse response;
+      response.StatusCode = Azure::Core::Http::HttpStatusCode::Created;
+      response.Headers = {
+          {"etag", "\"0x8D9C2A1B3E4F5A6\""},
+          {"last-modified", "Thu, 13 Jan 2022 21:37:52 GMT"},
+          {"content-md5", "1B2M2Y8AsgTpgAmY7PhCfg=="},
+          {"x-ms-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000"},
+          {"x-ms-version", "2020-02-10"},
+          {"x-ms-version-id", "2022-01-13T21:37:52.4167436Z"},
+          {"x-ms-request-server-encrypted", "true"},
+          {"date", "Thu, 13 Jan 2022 21:37:53 GMT"},
+      };
+
+      Azure::Storage::Blobs::BlobClientOptions options;
+      options.Transport.Transport
+          = std::make_shared<Azure::Perf::CannedResponseTransport>(std::move(response));
+      m_blockBlobClient = std::make_unique<Azure::Storage::Blobs::BlockBlobClient>(
+          "https://account.blob.core.windows.net/container/blob",
+          std::make_shared<Azure::Storage::StorageSharedKeyCredential>(
+              "account", "YWNjb3VudEtleQ=="),
+          options);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      m_blockBlobClient->UploadFrom(m_uploadBuffer.data(), m_uploadBuffer.size(), {}, context);
+    }
+
+    /**
+     * @brief Each run uploads the whole buffer.
+     *
+     */
+    int64_t GetBytesPerOperation() override
+    {
+      return static_cast<int64_t>(m_uploadBuffer.size());
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {{"Size", {"--size"}, "Size of payload (in bytes)", 1, true}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "UploadBlobFromCanned",
+          "Upload a blob from a buffer with a canned response. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Blobs::Test::UploadBlobFromCanned>(options);
+          }};
+    }
+  };
+
+}}}} // namespace Azure::Storage::Blobs::Test
@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the throughput of the parallel transfer of `UploadFrom`.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/perf/random_stream.hpp>
+
+#include "azure/storage/blobs/test/blob_base_test.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs { namespace Test {
+
+  /**
+   * @brief A test to measure uploading a blob from a buffer with the transfer options from the
+   * command line.
+   *
+   * @remark The blobs larger than the chunk size are uploaded in blocks, so that the tests of a
+   * sweep over the chunk size and the concurrency measure the parallel transfer.
+   */
+  class UploadBlobFrom : public Azure::Storage::Blobs::Test::BlobsTest {
+  private:
+    std::vector<uint8_t> m_uploadBuffer;
+    Azure::Storage::Blobs::UploadBlockBlobFromOptions m_uploadOptions;
+
+  public:
+    /**
+     * @brief Construct a new UploadBlobFrom test.
+     *
+     * @param options The test options.
+     */
+    UploadBlobFrom(Azure::Perf::TestOptions options) : BlobsTest(options) {}
+
+    /**
+     * @brief Create the buffer to upload and the transfer options.
+     *
+     */
+    void Setup() override
+    {
+      // Call base to create blob client
+      BlobsTest::Setup();
+
+      auto const size = m_options.GetMandatoryOption<int64_t>("Size");
+      m_uploadBuffer = Azure::Perf::RandomStream::Create(static_cast<size_t>(size))
+                           ->ReadToEnd(Azure::Core::Context::ApplicationContext);
+
+      auto& transferOptions = m_uploadOptions.TransferOptions;
+      transferOptions.Concurrency
+          = m_options.GetOptionOrDefault<int32_t>("Concurrency", transferOptions.Concurrency);
+      auto const chunkSize = m_options.GetOptionOrDefault<int64_t>("ChunkSize", 0);
+      if (chunkSize != 0)
+      {
+        transferOptions.ChunkSize = chunkSize;
+        transferOptions.SingleUploadThreshold = chunkSize;
+      }
+      transferOptions.AutoTune = m_options.GetOptionOrDefault<bool>("AutoTune", false);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      m_blobClient->UploadFrom(
+          m_uploadBuffer.data(), m_uploadBuffer.size(), m_uploadOptions, context);
+    }
+
+    /**
+     * @brief Each run transfers the whole blob.
+     *
+     */
+    int64_t GetBytesPerOperation() override
+    {
+      return static_cast<int64_t>(m_uploadBuffer.size());
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Size", {"--size", "-s"}, "Size of payload (in bytes)", 1, true},
+          {"Concurrency",
+           {"--concurrency"},
+           "The maximum number of threads of the transfer",
+           1,
+           false},
+          {"ChunkSize",
+           {"--chunk-size"},
+           "The size of the blocks (in bytes), the larger blobs are uploaded in blocks",
+           1,
+           false},
+          {"AutoTune",
+           {"--auto-tune"},
+           "Whether the chunk size and the concurrency are tuned during the transfer",
+           1,
+           false}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "UploadBlobFrom",
+          "Upload a blob from a buffer with parallel transfer.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Blobs::Test::UploadBlobFrom>(options);
+          }};
+    }
+  };
+
+}}}} // namespace Azure::Storage::Blobs::Test
@@ -3,15 +3,22 @@
 
 #include <azure/perf.hpp>
 
+#include "azure/storage/blobs/test/delete_blob_if_exists_canned_test.hpp"
+#include "azure/storage/blobs/test/download_blob_canned_test.hpp"
 #include "azure/storage/blobs/test/download_blob_from_sas.hpp"
 #include "azure/storage/blobs/test/download_blob_pipeline_only.hpp"
 #include "azure/storage/blobs/test/download_blob_test.hpp"
+#include "azure/storage/blobs/test/download_blob_to_canned_test.hpp"
+#include "azure/storage/blobs/test/download_blob_to_test.hpp"
 
 #if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
 #include "azure/storage/blobs/test/download_blob_transport_only.hpp"
 #endif
 
+#include "azure/storage/blobs/test/list_blob_canned_test.hpp"
 #include "azure/storage/blobs/test/list_blob_test.hpp"
+#include "azure/storage/blobs/test/upload_blob_from_canned_test.hpp"
+#include "azure/storage/blobs/test/upload_blob_from_test.hpp"
 #include "azure/storage/blobs/test/upload_blob_test.hpp"
 
 int main(int argc, char** argv)
@@ -24,6 +31,13 @@ int main(int argc, char** argv)
         Azure::Storage::Blobs::Test::UploadBlob::GetTestMetadata(),
         Azure::Storage::Blobs::Test::ListBlob::GetTestMetadata(),
         Azure::Storage::Blobs::Test::DownloadBlobSas::GetTestMetadata(),
+        Azure::Storage::Blobs::Test::DownloadBlobCanned::GetTestMetadata(),
+        Azure::Storage::Blobs::Test::UploadBlobFrom::GetTestMetadata(),
+        Azure::Storage::Blobs::Test::DownloadBlobTo::GetTestMetadata(),
+        Azure::Storage::Blobs::Test::ListBlobCanned::GetTestMetadata(),
+        Azure::Storage::Blobs::Test::DeleteBlobIfExistsCanned::GetTestMetadata(),
+        Azure::Storage::Blobs::Test::UploadBlobFromCanned::GetTestMetadata(),
+        Azure::Storage::Blobs::Test::DownloadBlobToCanned::GetTestMetadata(),
 #if defined(BUILD_CURL_HTTP_TRANSPORT_ADAPTER)
         Azure::Storage::Blobs::Test::DownloadBlobWithTransportOnly::GetTestMetadata(),
 #endif
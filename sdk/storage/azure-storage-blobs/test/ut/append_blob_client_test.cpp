@@ -3,10 +3,84 @@
 
 #include "append_blob_client_test.hpp"
 
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <azure/storage/blobs/blob_lease_client.hpp>
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // Serves an append blob whose content is blobContent. The appends at another position than
+    // the end of the blob fail, the size of the others is kept.
+    class MockAppendBlobTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockAppendBlobTransportPolicy(
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::vector<uint8_t>> blobContent,
+          std::shared_ptr<std::vector<size_t>> appendSizes)
+          : m_mutex(std::move(mutex)), m_blobContent(std::move(blobContent)),
+            m_appendSizes(std::move(appendSizes))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockAppendBlobTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        std::lock_guard<std::mutex> guard(*m_mutex);
+        const std::string blobSize = std::to_string(m_blobContent->size());
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetMethod() == Core::Http::HttpMethod::Head)
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetHeader("content-length", blobSize);
+          response->SetHeader("x-ms-blob-type", "AppendBlob");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("x-ms-server-encrypted", "true");
+        }
+        else if (request.GetHeaders().at("x-ms-blob-condition-appendpos") != blobSize)
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::PreconditionFailed, "Precondition Failed");
+          response->SetHeader("x-ms-error-code", "AppendPositionConditionNotMet");
+        }
+        else
+        {
+          auto content = request.GetBodyStream()->ReadToEnd(context);
+          m_blobContent->insert(m_blobContent->end(), content.begin(), content.end());
+          m_appendSizes->push_back(content.size());
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("x-ms-blob-append-offset", blobSize);
+          response->SetHeader(
+              "x-ms-blob-committed-block-count", std::to_string(m_appendSizes->size()));
+          response->SetHeader("x-ms-request-server-encrypted", "true");
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::vector<uint8_t>> m_blobContent;
+      std::shared_ptr<std::vector<size_t>> m_appendSizes;
+    };
+  } // namespace
+
   std::shared_ptr<Azure::Storage::Blobs::AppendBlobClient> AppendBlobClientTest::m_appendBlobClient;
   std::string AppendBlobClientTest::m_blobName;
   Azure::Storage::Blobs::CreateAppendBlobOptions AppendBlobClientTest::m_blobUploadOptions;
@@ -40,6 +114,107 @@ namespace Azure { namespace Storage { namespace Test {
 
   void AppendBlobClientTest::TearDownTestSuite() { BlobContainerClientTest::TearDownTestSuite(); }
 
+  TEST(AppendBlobWriterTest, GroupsWrites)
+  {
+    auto mutex = std::make_shared<std::mutex>();
+    auto blobContent = std::make_shared<std::vector<uint8_t>>(RandomBuffer(5));
+    auto appendSizes = std::make_shared<std::vector<size_t>>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockAppendBlobTransportPolicy>(mutex, blobContent, appendSizes));
+    Blobs::AppendBlobClient appendBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    std::vector<uint8_t> expectedContent = *blobContent;
+    Blobs::OpenWriteAppendBlobOptions options;
+    options.BlockSize = 1_KB;
+    options.FlushInterval = std::chrono::hours(1);
+    options.MaxBufferedSize = 2_KB;
+    {
+      auto writer = appendBlobClient.OpenWrite(options);
+      EXPECT_EQ(writer->GetCommittedSize(), 5);
+      for (int i = 0; i < 100; ++i)
+      {
+        auto data = RandomBuffer(37);
+        writer->Write(data.data(), data.size());
+        expectedContent.insert(expectedContent.end(), data.begin(), data.end());
+      }
+      writer->Flush();
+      EXPECT_EQ(writer->GetCommittedSize(), 3705);
+      {
+        std::lock_guard<std::mutex> guard(*mutex);
+        EXPECT_EQ(*blobContent, expectedContent);
+        EXPECT_EQ(*appendSizes, std::vector<size_t>({1024, 1024, 1024, 628}));
+      }
+
+      // The data left is appended when the writer is destroyed.
+      auto data = RandomBuffer(10);
+      writer->Write(data.data(), data.size());
+      expectedContent.insert(expectedContent.end(), data.begin(), data.end());
+    }
+    EXPECT_EQ(*blobContent, expectedContent);
+
+    // Data which doesn't fill a block is appended after the flush interval.
+    options.FlushInterval = std::chrono::milliseconds(10);
+    auto writer = appendBlobClient.OpenWrite(options);
+    auto data = RandomBuffer(10);
+    writer->Write(data.data(), data.size());
+    for (int i = 0; i < 500 && writer->GetCommittedSize() != 3725; ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(writer->GetCommittedSize(), 3725);
+
+    // An append by another client fails the writer.
+    {
+      std::lock_guard<std::mutex> guard(*mutex);
+      blobContent->push_back(0);
+    }
+    writer->Write(data.data(), data.size());
+    EXPECT_THROW(writer->Flush(), StorageException);
+    EXPECT_THROW(writer->Write(data.data(), data.size()), StorageException);
+    EXPECT_EQ(writer->GetCommittedSize(), 3725);
+  }
+
+  TEST_F(AppendBlobClientTest, OpenWrite)
+  {
+    auto appendBlobClient = Azure::Storage::Blobs::AppendBlobClient::CreateFromConnectionString(
+        StandardStorageConnectionString(), m_containerName, RandomString());
+    appendBlobClient.Create();
+    std::vector<uint8_t> content;
+    {
+      Blobs::OpenWriteAppendBlobOptions options;
+      options.BlockSize = 64_KB;
+      auto writer = appendBlobClient.OpenWrite(options);
+      std::vector<std::thread> threads;
+      std::mutex contentMutex;
+      for (int i = 0; i < 4; ++i)
+      {
+        threads.emplace_back([&]() {
+          for (int j = 0; j < 100; ++j)
+          {
+            auto data = RandomBuffer(1_KB + 1);
+            std::lock_guard<std::mutex> guard(contentMutex);
+            writer->Write(data.data(), data.size());
+            content.insert(content.end(), data.begin(), data.end());
+          }
+        });
+      }
+      for (auto& thread : threads)
+      {
+        thread.join();
+      }
+      writer->Flush();
+      EXPECT_EQ(writer->GetCommittedSize(), static_cast<int64_t>(content.size()));
+    }
+    auto properties = appendBlobClient.GetProperties().Value;
+    EXPECT_EQ(properties.BlobSize, static_cast<int64_t>(content.size()));
+    EXPECT_LT(properties.CommittedBlockCount.Value(), 10);
+    std::vector<uint8_t> downloadContent(content.size());
+    appendBlobClient.DownloadTo(downloadContent.data(), downloadContent.size());
+    EXPECT_EQ(downloadContent, content);
+  }
+
   TEST_F(AppendBlobClientTest, CreateAppendDelete)
   {
     auto appendBlobClient = Azure::Storage::Blobs::AppendBlobClient::CreateFromConnectionString(
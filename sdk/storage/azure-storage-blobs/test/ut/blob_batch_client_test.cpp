@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <azure/storage/blobs.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    // Answers a batch request with responseBody, and keeps the body of the request.
+    class MockBatchTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockBatchTransportPolicy(
+          std::string responseBody,
+          std::shared_ptr<std::string> requestBody)
+          : m_responseBody(std::move(responseBody)), m_requestBody(std::move(requestBody))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockBatchTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy nextPolicy,
+          Core::Context const& context) const override
+      {
+        (void)nextPolicy;
+        auto body = request.GetBodyStream()->ReadToEnd(context);
+        m_requestBody->assign(body.begin(), body.end());
+
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Accepted, "Accepted");
+        response->SetBody(std::vector<uint8_t>(m_responseBody.begin(), m_responseBody.end()));
+        response->SetHeader("content-length", std::to_string(m_responseBody.length()));
+        response->SetHeader(
+            "content-type", "multipart/mixed; boundary=batchresponse_dummy-boundary");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::string m_responseBody;
+      std::shared_ptr<std::string> m_requestBody;
+    };
+
+    size_t CountOccurrences(const std::string& text, const std::string& pattern)
+    {
+      size_t count = 0;
+      for (auto position = text.find(pattern); position != std::string::npos;
+           position = text.find(pattern, position + pattern.length()))
+      {
+        ++count;
+      }
+      return count;
+    }
+  } // namespace
+
+  TEST(BlobBatchClientTest, SubmitBatchOffline)
+  {
+    // The parts of the response are out of order, the second operation fails.
+    const std::string errorBody = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                                  "<Error><Code>BlobNotFound</Code>"
+                                  "<Message>The specified blob does not exist.</Message></Error>";
+    const std::string responseBody = "--batchresponse_dummy-boundary\r\n"
+                                     "Content-Type: application/http\r\n"
+                                     "Content-ID: 1\r\n"
+                                     "\r\n"
+                                     "HTTP/1.1 404 The specified blob does not exist.\r\n"
+                                     "x-ms-error-code: BlobNotFound\r\n"
+                                     "x-ms-request-id: request-1\r\n"
+                                     "Content-Type: application/xml\r\n"
+                                     "Content-Length: "
+        + std::to_string(errorBody.length())
+        + "\r\n"
+          "\r\n"
+        + errorBody
+        + "\r\n"
+          "--batchresponse_dummy-boundary\r\n"
+          "Content-Type: application/http\r\n"
+          "Content-ID: 0\r\n"
+          "\r\n"
+          "HTTP/1.1 202 Accepted\r\n"
+          "x-ms-delete-type-permanent: true\r\n"
+          "x-ms-request-id: request-0\r\n"
+          "\r\n"
+          "--batchresponse_dummy-boundary--\r\n";
+
+    auto requestBody = std::make_shared<std::string>();
+    Blobs::BlobClientOptions options;
+    options.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBatchTransportPolicy>(responseBody, requestBody));
+    auto credential = std::make_shared<StorageSharedKeyCredential>(
+        "account", "ZHVtbXlrZXlkdW1teWtleWR1bW15a2V5ZHVtbXlrZXk=");
+    Blobs::BlobBatchClient batchClient(
+        "https://account.blob.core.windows.net", credential, options);
+
+    auto batch = batchClient.CreateBatch();
+    EXPECT_EQ(batch.DeleteBlob("container", "blob0"), 0);
+    EXPECT_EQ(batch.DeleteBlob("container", "blob 1"), 1);
+    EXPECT_EQ(batch.GetOperationCount(), 2);
+    EXPECT_THROW(
+        batch.SetBlobAccessTier("container", "blob2", Blobs::Models::AccessTier::Cool),
+        std::invalid_argument);
+
+    auto result = batchClient.SubmitBatch(batch).Value;
+    ASSERT_EQ(result.OperationResults.size(), 2U);
+    EXPECT_EQ(result.OperationResults[0].StatusCode, Core::Http::HttpStatusCode::Accepted);
+    EXPECT_EQ(result.OperationResults[0].RequestId, "request-0");
+    EXPECT_TRUE(result.OperationResults[0].ErrorCode.empty());
+    EXPECT_EQ(result.OperationResults[1].StatusCode, Core::Http::HttpStatusCode::NotFound);
+    EXPECT_EQ(result.OperationResults[1].RequestId, "request-1");
+    EXPECT_EQ(result.OperationResults[1].ErrorCode, "BlobNotFound");
+    EXPECT_EQ(result.OperationResults[1].Message, "The specified blob does not exist.");
+
+    // Each operation is signed on its own.
+    EXPECT_NE(requestBody->find("DELETE /container/blob0 HTTP/1.1\r\n"), std::string::npos);
+    EXPECT_NE(requestBody->find("DELETE /container/blob%201 HTTP/1.1\r\n"), std::string::npos);
+    EXPECT_EQ(CountOccurrences(*requestBody, "Content-ID: "), 2U);
+    EXPECT_EQ(CountOccurrences(*requestBody, "authorization: SharedKey account:"), 2U);
+    EXPECT_EQ(CountOccurrences(*requestBody, "x-ms-date: "), 2U);
+
+    EXPECT_THROW(batchClient.SubmitBatch(batchClient.CreateBatch()), std::invalid_argument);
+  }
+
+  TEST(BlobBatchClientTest, BatchLimits)
+  {
+    Blobs::BlobBatchClient batchClient("https://account.blob.core.windows.net");
+    auto batch = batchClient.CreateBatch();
+    for (int32_t i = 0; i < 256; ++i)
+    {
+      EXPECT_EQ(
+          batch.SetBlobAccessTier(
+              "container", "blob" + std::to_string(i), Blobs::Models::AccessTier::Cool),
+          i);
+    }
+    EXPECT_THROW(
+        batch.SetBlobAccessTier("container", "blob", Blobs::Models::AccessTier::Cool),
+        std::invalid_argument);
+    EXPECT_EQ(batch.GetOperationCount(), 256);
+  }
+
+  TEST(BlobBatchClientTest, SubmitBatches)
+  {
+    const std::string containerName = LowercaseRandomString();
+    auto containerClient = Blobs::BlobContainerClient::CreateFromConnectionString(
+        StandardStorageConnectionString(), containerName);
+    containerClient.Create();
+
+    auto batchClient
+        = Blobs::BlobBatchClient::CreateFromConnectionString(StandardStorageConnectionString());
+    std::vector<Blobs::BlobBatch> batches;
+    std::vector<std::string> blobNames;
+    for (int i = 0; i < 3; ++i)
+    {
+      batches.push_back(batchClient.CreateBatch());
+      for (int j = 0; j < 2; ++j)
+      {
+        const std::string blobName = RandomString();
+        containerClient.GetBlockBlobClient(blobName).UploadFrom(nullptr, 0);
+        batches.back().SetBlobAccessTier(containerName, blobName, Blobs::Models::AccessTier::Cool);
+        blobNames.push_back(blobName);
+      }
+    }
+    batches.push_back(batchClient.CreateBatch());
+    batches.back().SetBlobAccessTier(
+        containerName, RandomString(), Blobs::Models::AccessTier::Cool);
+
+    auto results = batchClient.SubmitBatches(batches);
+    ASSERT_EQ(results.size(), batches.size());
+    for (size_t i = 0; i + 1 < results.size(); ++i)
+    {
+      ASSERT_EQ(results[i].OperationResults.size(), 2U);
+      for (const auto& operationResult : results[i].OperationResults)
+      {
+        EXPECT_EQ(operationResult.StatusCode, Core::Http::HttpStatusCode::Ok);
+        EXPECT_FALSE(operationResult.RequestId.empty());
+      }
+    }
+    ASSERT_EQ(results.back().OperationResults.size(), 1U);
+    EXPECT_EQ(results.back().OperationResults[0].ErrorCode, "BlobNotFound");
+    for (const auto& blobName : blobNames)
+    {
+      EXPECT_EQ(
+          containerClient.GetBlobClient(blobName).GetProperties().Value.AccessTier.Value(),
+          Blobs::Models::AccessTier::Cool);
+    }
+
+    auto deleteBatch = batchClient.CreateBatch();
+    for (const auto& blobName : blobNames)
+    {
+      deleteBatch.DeleteBlob(containerName, blobName);
+    }
+    for (const auto& operationResult : batchClient.SubmitBatch(deleteBatch).Value.OperationResults)
+    {
+      EXPECT_EQ(operationResult.StatusCode, Core::Http::HttpStatusCode::Accepted);
+    }
+    containerClient.Delete();
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -3,13 +3,19 @@
 
 #include "blob_container_client_test.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <thread>
 
 #include <azure/core/internal/cryptography/sha_hash.hpp>
 #include <azure/storage/blobs/blob_lease_client.hpp>
 #include <azure/storage/blobs/blob_sas_builder.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/file_io.hpp>
 
 namespace Azure { namespace Storage { namespace Blobs { namespace Models {
 
@@ -306,6 +312,725 @@ namespace Azure { namespace Storage { namespace Test {
     EXPECT_EQ(items, blobs);
   }
 
+  TEST_F(BlobContainerClientTest, ListBlobsConcurrently)
+  {
+    const std::string delimiter = "/";
+    const std::string prefix = RandomString();
+    std::set<std::string> blobs;
+    for (const auto& blobNamePrefix :
+         {prefix + "-a" + delimiter, prefix + "-b" + delimiter + "c" + delimiter, prefix + "-d"})
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        std::string blobName = blobNamePrefix + RandomString();
+        auto blobClient = m_blobContainerClient->GetBlockBlobClient(blobName);
+        auto emptyContent = Azure::Core::IO::MemoryBodyStream(nullptr, 0);
+        blobClient.Upload(emptyContent);
+        blobs.insert(blobName);
+      }
+    }
+
+    std::mutex itemsMutex;
+    std::set<std::string> items;
+    auto onBlobs = [&](std::vector<Blobs::Models::BlobItem> page) {
+      std::lock_guard<std::mutex> guard(itemsMutex);
+      for (const auto& i : page)
+      {
+        EXPECT_TRUE(items.insert(i.Name).second);
+      }
+    };
+
+    Azure::Storage::Blobs::ListBlobsConcurrentlyOptions options;
+    options.Prefixes = {prefix + "-a", prefix + "-b", prefix + "-d"};
+    options.PageSizeHint = 2;
+    options.Concurrency = 4;
+    m_blobContainerClient->ListBlobsConcurrently(onBlobs, options);
+    EXPECT_EQ(items, blobs);
+
+    items.clear();
+    options.Delimiter.clear();
+    m_blobContainerClient->ListBlobsConcurrently(onBlobs, options);
+    EXPECT_EQ(items, blobs);
+  }
+
+  TEST_F(BlobContainerClientTest, GetBlobsPropertiesAndTags)
+  {
+    std::vector<std::string> blobNames;
+    std::map<std::string, std::string> tags = {{"key", "value"}};
+    for (int i = 0; i < 5; ++i)
+    {
+      std::string blobName = RandomString();
+      auto blobClient = m_blobContainerClient->GetBlockBlobClient(blobName);
+      std::vector<uint8_t> content(i);
+      blobClient.UploadFrom(content.data(), content.size());
+      blobClient.SetTags(tags);
+      blobNames.push_back(blobName);
+    }
+    const std::string missingBlobName = RandomString();
+    std::vector<std::string> requestedNames = blobNames;
+    requestedNames.push_back(blobNames[0]);
+    requestedNames.push_back(missingBlobName);
+
+    std::mutex resultsMutex;
+    std::map<std::string, Azure::Nullable<int64_t>> sizes;
+    Blobs::GetBlobsPropertiesOptions propertiesOptions;
+    propertiesOptions.Concurrency = 3;
+    m_blobContainerClient->GetBlobsProperties(
+        requestedNames,
+        [&](const std::string& blobName, Azure::Nullable<Blobs::Models::BlobProperties> properties) {
+          std::lock_guard<std::mutex> guard(resultsMutex);
+          EXPECT_TRUE(sizes
+                          .emplace(
+                              blobName,
+                              properties.HasValue() ? properties.Value().BlobSize
+                                                    : Azure::Nullable<int64_t>())
+                          .second);
+        },
+        propertiesOptions);
+    EXPECT_EQ(sizes.size(), blobNames.size() + 1);
+    for (size_t i = 0; i < blobNames.size(); ++i)
+    {
+      EXPECT_EQ(sizes[blobNames[i]].Value(), static_cast<int64_t>(i));
+    }
+    EXPECT_FALSE(sizes[missingBlobName].HasValue());
+
+    std::map<std::string, Azure::Nullable<std::map<std::string, std::string>>> blobsTags;
+    m_blobContainerClient->GetBlobsTags(
+        requestedNames,
+        [&](const std::string& blobName,
+            Azure::Nullable<std::map<std::string, std::string>> blobTags) {
+          std::lock_guard<std::mutex> guard(resultsMutex);
+          EXPECT_TRUE(blobsTags.emplace(blobName, std::move(blobTags)).second);
+        });
+    EXPECT_EQ(blobsTags.size(), blobNames.size() + 1);
+    for (const auto& blobName : blobNames)
+    {
+      EXPECT_EQ(blobsTags[blobName].Value(), tags);
+    }
+    EXPECT_FALSE(blobsTags[missingBlobName].HasValue());
+  }
+
+  TEST_F(BlobContainerClientTest, DownloadBlobs)
+  {
+    std::vector<std::string> blobNames;
+    std::vector<std::vector<uint8_t>> contents;
+    for (int i = 0; i < 5; ++i)
+    {
+      std::string blobName = RandomString();
+      auto blobClient = m_blobContainerClient->GetBlockBlobClient(blobName);
+      contents.push_back(RandomBuffer(static_cast<size_t>(i) * 1024));
+      blobClient.UploadFrom(contents.back().data(), contents.back().size());
+      blobNames.push_back(blobName);
+    }
+    const std::string missingBlobName = RandomString();
+    std::vector<std::string> requestedNames = blobNames;
+    requestedNames.push_back(blobNames[0]);
+    requestedNames.push_back(missingBlobName);
+
+    std::mutex resultsMutex;
+    std::map<std::string, Azure::Nullable<std::vector<uint8_t>>> downloaded;
+    Blobs::DownloadBlobsOptions options;
+    options.Concurrency = 3;
+    auto result = m_blobContainerClient->DownloadBlobs(
+        requestedNames,
+        [&](const std::string& blobName, Azure::Nullable<std::vector<uint8_t>> content) {
+          std::lock_guard<std::mutex> guard(resultsMutex);
+          EXPECT_TRUE(downloaded.emplace(blobName, std::move(content)).second);
+        },
+        options);
+    EXPECT_EQ(downloaded.size(), blobNames.size() + 1);
+    for (size_t i = 0; i < blobNames.size(); ++i)
+    {
+      EXPECT_EQ(downloaded[blobNames[i]].Value(), contents[i]);
+    }
+    EXPECT_FALSE(downloaded[missingBlobName].HasValue());
+    EXPECT_EQ(result.TransferredBlobCount, static_cast<int64_t>(blobNames.size()));
+    EXPECT_EQ(result.TransferredSize, 10 * 1024);
+    EXPECT_GT(result.Elapsed.count(), 0);
+  }
+
+  namespace {
+    // Counts the copies made of it, one for each pipeline built with it.
+    class CountClonesPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit CountClonesPolicy(std::shared_ptr<int> cloneCount)
+          : m_cloneCount(std::move(cloneCount))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        ++*m_cloneCount;
+        return std::make_unique<CountClonesPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy nextPolicy,
+          Core::Context const& context) const override
+      {
+        return nextPolicy.Send(request, context);
+      }
+
+    private:
+      std::shared_ptr<int> m_cloneCount;
+    };
+  } // namespace
+
+  TEST(BlobClientPipelineTest, SharedByDerivedClients)
+  {
+    auto cloneCount = std::make_shared<int>(0);
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<CountClonesPolicy>(cloneCount));
+    Blobs::BlobServiceClient serviceClient("https://account.blob.core.windows.net", clientOptions);
+    const int serviceCloneCount = *cloneCount;
+    EXPECT_GT(serviceCloneCount, 0);
+
+    auto containerClient = serviceClient.GetBlobContainerClient("container");
+    for (int i = 0; i < 100; ++i)
+    {
+      const std::string blobName = "blob" + std::to_string(i);
+      auto blockBlobClient = containerClient.GetBlockBlobClient(blobName);
+      EXPECT_EQ(
+          blockBlobClient.GetUrl(), "https://account.blob.core.windows.net/container/" + blobName);
+      containerClient.GetBlobClient(blobName).AsBlockBlobClient();
+      containerClient.GetAppendBlobClient(blobName);
+      containerClient.GetPageBlobClient(blobName);
+    }
+    EXPECT_EQ(*cloneCount, serviceCloneCount);
+  }
+
+  namespace {
+    // The listings are parsed while they are read from the body stream of the response.
+    class StringBodyStream final : public Azure::Core::IO::BodyStream {
+    public:
+      // The reads fail once failAfter bytes have been read.
+      explicit StringBodyStream(std::string data, size_t failAfter = std::string::npos)
+          : m_data(std::move(data)), m_failAfter(std::min(failAfter, m_data.size()))
+      {
+      }
+
+      int64_t Length() const override { return static_cast<int64_t>(m_data.size()); }
+
+    private:
+      size_t OnRead(uint8_t* buffer, size_t count, const Azure::Core::Context&) override
+      {
+        if (m_offset == m_failAfter && m_failAfter != m_data.size())
+        {
+          throw Core::Http::TransportException("Connection reset.");
+        }
+        size_t length = std::min(count, m_failAfter - m_offset);
+        std::memcpy(buffer, m_data.data() + m_offset, length);
+        m_offset += length;
+        return length;
+      }
+
+      std::string m_data;
+      size_t m_failAfter;
+      size_t m_offset = 0;
+    };
+
+    // Lists the blobs of names like the service.
+    class MockListBlobsTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockListBlobsTransportPolicy(
+          std::vector<std::string> names,
+          int numFailedBodies = 0)
+          : m_names(std::move(names)), m_numFailedBodies(numFailedBodies)
+      {
+        std::sort(m_names.begin(), m_names.end());
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockListBlobsTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        auto query = request.GetUrl().GetQueryParameters();
+        const std::string prefix = Core::Url::Decode(query["prefix"]);
+        const std::string delimiter = Core::Url::Decode(query["delimiter"]);
+        const size_t pageSize = std::stoul(query["maxresults"]);
+        const size_t marker = query["marker"].empty() ? 0 : std::stoul(query["marker"]);
+
+        std::vector<std::string> items;
+        for (const auto& name : m_names)
+        {
+          if (name.compare(0, prefix.length(), prefix) != 0)
+          {
+            continue;
+          }
+          const auto delimiterPosition
+              = delimiter.empty() ? std::string::npos : name.find(delimiter, prefix.length());
+          std::string item = delimiterPosition == std::string::npos
+              ? "<Blob><Name>" + name + "</Name><Properties /></Blob>"
+              : "<BlobPrefix><Name>" + name.substr(0, delimiterPosition + delimiter.length())
+                  + "</Name></BlobPrefix>";
+          if (items.empty() || items.back() != item)
+          {
+            items.push_back(std::move(item));
+          }
+        }
+
+        std::string body = "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+                           "ServiceEndpoint=\"https://account.blob.core.windows.net/\" "
+                           "ContainerName=\"container\"><Blobs>";
+        for (size_t i = marker; i < std::min(items.size(), marker + pageSize); ++i)
+        {
+          body += items[i];
+        }
+        body += "</Blobs><NextMarker>";
+        if (marker + pageSize < items.size())
+        {
+          body += std::to_string(marker + pageSize);
+        }
+        body += "</NextMarker></EnumerationResults>";
+
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        response->SetHeader("content-length", std::to_string(body.length()));
+        response->SetHeader("content-type", "application/xml");
+        // The bodies of the first listings fail halfway, like a connection that is reset.
+        const size_t failAfter
+            = m_numRequests->fetch_add(1) < m_numFailedBodies ? body.length() / 2 : body.length();
+        response->SetBodyStream(std::make_unique<StringBodyStream>(std::move(body), failAfter));
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+      int GetNumRequests() const { return m_numRequests->load(); }
+
+    private:
+      std::vector<std::string> m_names;
+      int m_numFailedBodies;
+      // Shared by the clones of the policy.
+      std::shared_ptr<std::atomic<int>> m_numRequests = std::make_shared<std::atomic<int>>(0);
+    };
+  } // namespace
+
+  TEST(ListBlobsTest, RequestsPageAgainWhenBodyFails)
+  {
+    const std::vector<std::string> names = {"a", "b", "c"};
+    Blobs::BlobClientOptions clientOptions;
+    auto transport = std::make_unique<MockListBlobsTransportPolicy>(names, 2);
+    auto const& mockTransport = *transport;
+    clientOptions.PerRetryPolicies.emplace_back(std::move(transport));
+    Blobs::BlobContainerClient containerClient(
+        "https://account.blob.core.windows.net/container", clientOptions);
+
+    Blobs::ListBlobsOptions options;
+    options.PageSizeHint = 5;
+    std::vector<std::string> items;
+    for (const auto& blob : containerClient.ListBlobs(options).Blobs)
+    {
+      items.push_back(blob.Name);
+    }
+    EXPECT_EQ(items, names);
+    EXPECT_EQ(mockTransport.GetNumRequests(), 3);
+
+    // The page is requested again ReliableStreamRetryCount times at most.
+    Blobs::BlobClientOptions failingClientOptions;
+    failingClientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockListBlobsTransportPolicy>(names, 1000));
+    Blobs::BlobContainerClient failingContainerClient(
+        "https://account.blob.core.windows.net/container", failingClientOptions);
+    EXPECT_THROW(failingContainerClient.ListBlobs(options), Core::Http::TransportException);
+  }
+
+  TEST(ListBlobsConcurrentlyTest, SplitsPartitions)
+  {
+    const std::vector<std::string> names
+        = {"a/1", "a/2", "a/b/1", "a/b/c/1", "b", "c/1", "c/2", "c/3", "d/e/1", "d/f/1"};
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockListBlobsTransportPolicy>(names));
+    Blobs::BlobContainerClient containerClient(
+        "https://account.blob.core.windows.net/container", clientOptions);
+
+    std::mutex itemsMutex;
+    std::vector<std::string> items;
+    auto onBlobs = [&](std::vector<Blobs::Models::BlobItem> page) {
+      std::lock_guard<std::mutex> guard(itemsMutex);
+      for (const auto& i : page)
+      {
+        items.push_back(i.Name);
+      }
+    };
+
+    Blobs::ListBlobsConcurrentlyOptions options;
+    options.PageSizeHint = 2;
+    options.Concurrency = 3;
+    containerClient.ListBlobsConcurrently(onBlobs, options);
+    std::sort(items.begin(), items.end());
+    EXPECT_EQ(items, names);
+
+    items.clear();
+    options.Delimiter.clear();
+    options.Prefixes = {"a/", "c"};
+    containerClient.ListBlobsConcurrently(onBlobs, options);
+    std::sort(items.begin(), items.end());
+    EXPECT_EQ(
+        items,
+        (std::vector<std::string>{"a/1", "a/2", "a/b/1", "a/b/c/1", "c/1", "c/2", "c/3"}));
+  }
+
+  TEST(StripedBlobContainerClientTest, SpreadsBlobsOverAccounts)
+  {
+    std::vector<Blobs::BlobServiceClient> serviceClients;
+    for (int i = 0; i < 4; ++i)
+    {
+      serviceClients.emplace_back(
+          "https://account" + std::to_string(i) + ".blob.core.windows.net");
+    }
+    Blobs::StripedBlobContainerClient stripedClient(serviceClients, "container");
+    ASSERT_EQ(stripedClient.GetContainerClients().size(), size_t(4));
+
+    std::vector<int> blobCounts(4);
+    std::map<std::string, std::string> blobUrls;
+    for (int i = 0; i < 4000; ++i)
+    {
+      const std::string blobName = "dir/blob" + std::to_string(i);
+      const size_t index = stripedClient.GetContainerIndex(blobName);
+      ++blobCounts[index];
+      const auto blobUrl = stripedClient.GetBlockBlobClient(blobName).GetUrl();
+      EXPECT_EQ(
+          blobUrl,
+          "https://account" + std::to_string(index) + ".blob.core.windows.net/container/"
+              + blobName);
+      blobUrls[blobName] = blobUrl;
+    }
+    for (const int blobCount : blobCounts)
+    {
+      EXPECT_GT(blobCount, 800);
+      EXPECT_LT(blobCount, 1200);
+    }
+
+    // The container of a blob doesn't depend on the order of the containers, and a new container
+    // only takes blobs from the others.
+    std::reverse(serviceClients.begin(), serviceClients.end());
+    serviceClients.emplace_back("https://account4.blob.core.windows.net");
+    Blobs::StripedBlobContainerClient grownClient(serviceClients, "container");
+    int movedBlobs = 0;
+    for (const auto& blobUrl : blobUrls)
+    {
+      const auto newUrl = grownClient.GetBlobClient(blobUrl.first).GetUrl();
+      if (newUrl != blobUrl.second)
+      {
+        ++movedBlobs;
+        EXPECT_EQ(newUrl.find("https://account4."), size_t(0));
+      }
+    }
+    EXPECT_GT(movedBlobs, 600);
+    EXPECT_LT(movedBlobs, 1000);
+
+    EXPECT_THROW(
+        Blobs::StripedBlobContainerClient(std::vector<Blobs::BlobContainerClient>()),
+        std::invalid_argument);
+  }
+
+  TEST(StripedBlobContainerClientTest, ListsAllAccounts)
+  {
+    std::vector<Blobs::BlobContainerClient> containerClients;
+    std::vector<std::string> names;
+    for (int i = 0; i < 3; ++i)
+    {
+      const std::vector<std::string> accountNames
+          = {std::to_string(i) + "/1", std::to_string(i) + "/2", std::to_string(i) + "/3"};
+      names.insert(names.end(), accountNames.begin(), accountNames.end());
+      Blobs::BlobClientOptions clientOptions;
+      clientOptions.PerRetryPolicies.emplace_back(
+          std::make_unique<MockListBlobsTransportPolicy>(accountNames));
+      containerClients.emplace_back(
+          "https://account" + std::to_string(i) + ".blob.core.windows.net/container",
+          clientOptions);
+    }
+    Blobs::StripedBlobContainerClient stripedClient(std::move(containerClients));
+
+    std::mutex itemsMutex;
+    std::vector<std::string> items;
+    Blobs::ListBlobsConcurrentlyOptions options;
+    options.PageSizeHint = 2;
+    stripedClient.ListBlobsConcurrently(
+        [&](std::vector<Blobs::Models::BlobItem> page) {
+          std::lock_guard<std::mutex> guard(itemsMutex);
+          for (const auto& i : page)
+          {
+            items.push_back(i.Name);
+          }
+        },
+        options);
+    std::sort(items.begin(), items.end());
+    EXPECT_EQ(items, names);
+  }
+
+  namespace {
+    // Keeps the blobs uploaded to it in memory, and lists and downloads them like the service.
+    class MockBlobDirectoryTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct Blob
+      {
+        std::string Content;
+        std::string ETag;
+      };
+
+      struct State
+      {
+        std::mutex Mutex;
+        std::map<std::string, Blob> Blobs;
+        std::map<std::string, std::map<std::string, std::string>> StagedBlocks;
+        int NumStagedBlocks = 0;
+        int NumDownloadedRanges = 0;
+        int LastETag = 0;
+      };
+
+      explicit MockBlobDirectoryTransportPolicy(std::shared_ptr<State> state)
+          : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockBlobDirectoryTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        auto query = request.GetUrl().GetQueryParameters();
+        auto headers = request.GetHeaders();
+        const std::string containerPath = "container";
+        const std::string path = request.GetUrl().GetPath();
+        const std::string blobName
+            = path.length() > containerPath.length() ? path.substr(containerPath.length() + 1) : "";
+        auto body = request.GetBodyStream()->ReadToEnd(context);
+
+        std::lock_guard<std::mutex> guard(m_state->Mutex);
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetMethod() == Core::Http::HttpMethod::Get && query["comp"] == "list")
+        {
+          const std::string prefix = Core::Url::Decode(query["prefix"]);
+          std::string listBody = "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+                                 "ServiceEndpoint=\"https://account.blob.core.windows.net/\" "
+                                 "ContainerName=\"container\"><Blobs>";
+          for (const auto& blob : m_state->Blobs)
+          {
+            if (blob.first.compare(0, prefix.length(), prefix) == 0)
+            {
+              listBody += "<Blob><Name>" + blob.first + "</Name><Properties><Content-Length>"
+                  + std::to_string(blob.second.Content.length()) + "</Content-Length><Etag>"
+                  + blob.second.ETag + "</Etag></Properties></Blob>";
+            }
+          }
+          listBody += "</Blobs><NextMarker /></EnumerationResults>";
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetHeader("content-type", "application/xml");
+          response->SetHeader("content-length", std::to_string(listBody.length()));
+          response->SetBodyStream(std::make_unique<StringBodyStream>(std::move(listBody)));
+        }
+        else if (request.GetMethod() == Core::Http::HttpMethod::Get)
+        {
+          const auto& blob = m_state->Blobs.at(blobName);
+          EXPECT_EQ(headers.at("if-match"), blob.ETag);
+          const std::string range = headers.at("x-ms-range");
+          const auto dashPosition = range.find('-');
+          const size_t start = std::stoull(range.substr(6, dashPosition - 6));
+          const size_t end = std::stoull(range.substr(dashPosition + 1));
+          ++m_state->NumDownloadedRanges;
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::PartialContent, "Partial Content");
+          response->SetBodyStream(std::make_unique<StringBodyStream>(
+              blob.Content.substr(start, end - start + 1)));
+          response->SetHeader("content-length", std::to_string(end - start + 1));
+          response->SetHeader(
+              "content-range",
+              "bytes " + std::to_string(start) + "-" + std::to_string(end) + "/"
+                  + std::to_string(blob.Content.length()));
+          response->SetHeader("x-ms-blob-type", "BlockBlob");
+          response->SetHeader("x-ms-server-encrypted", "true");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("etag", blob.ETag);
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        else
+        {
+          if (query["comp"] == "block")
+          {
+            ++m_state->NumStagedBlocks;
+            m_state->StagedBlocks[blobName][Core::Url::Decode(query["blockid"])]
+                = std::string(body.begin(), body.end());
+          }
+          else if (query["comp"] == "blocklist")
+          {
+            const std::string blockList(body.begin(), body.end());
+            std::string content;
+            const std::string latestTag = "<Latest>";
+            for (auto position = blockList.find(latestTag); position != std::string::npos;
+                 position = blockList.find(latestTag, position))
+            {
+              position += latestTag.length();
+              const auto blockIdEnd = blockList.find('<', position);
+              content += m_state->StagedBlocks[blobName].at(
+                  blockList.substr(position, blockIdEnd - position));
+            }
+            m_state->StagedBlocks.erase(blobName);
+            m_state->Blobs[blobName]
+                = {std::move(content), "\"" + std::to_string(++m_state->LastETag) + "\""};
+          }
+          else
+          {
+            m_state->Blobs[blobName] = {
+                std::string(body.begin(), body.end()),
+                "\"" + std::to_string(++m_state->LastETag) + "\""};
+          }
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("etag", DummyETag.ToString());
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("x-ms-request-server-encrypted", "true");
+        }
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+
+    void WriteFile(const std::string& fileName, const std::vector<uint8_t>& content)
+    {
+      _internal::FileWriter fileWriter(fileName);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+  } // namespace
+
+  TEST(BlobDirectoryTransferTest, UploadsAndDownloads)
+  {
+    auto state = std::make_shared<MockBlobDirectoryTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlobDirectoryTransportPolicy>(state));
+    Blobs::BlobContainerClient containerClient(
+        "https://account.blob.core.windows.net/container", clientOptions);
+
+    const std::string sourceDirectory = RandomString();
+    const std::map<std::string, std::vector<uint8_t>> files
+        = {{"a", RandomBuffer(10)}, {"sub/b", RandomBuffer(250)}, {"sub/deeper/c", {}}};
+    _internal::CreateDirectories(sourceDirectory + "/sub/deeper");
+    for (const auto& file : files)
+    {
+      WriteFile(sourceDirectory + "/" + file.first, file.second);
+    }
+
+    Blobs::UploadBlobDirectoryOptions uploadOptions;
+    uploadOptions.JournalPath = RandomString();
+    uploadOptions.TransferOptions.SingleUploadThreshold = 100;
+    uploadOptions.TransferOptions.ChunkSize = 64;
+    uploadOptions.TransferOptions.Concurrency = 4;
+    auto uploadResult = containerClient.UploadDirectory(sourceDirectory, "dir/", uploadOptions);
+    EXPECT_EQ(uploadResult.TransferredFileCount, 3);
+    EXPECT_EQ(uploadResult.SkippedFileCount, 0);
+    EXPECT_EQ(uploadResult.TransferredSize, 260);
+    EXPECT_EQ(state->NumStagedBlocks, 4);
+    ASSERT_EQ(state->Blobs.size(), 3U);
+    for (const auto& file : files)
+    {
+      EXPECT_EQ(
+          state->Blobs.at("dir/" + file.first).Content,
+          std::string(file.second.begin(), file.second.end()));
+    }
+
+    // The files recorded in the journal are skipped, unless they changed size.
+    WriteFile(sourceDirectory + "/a", RandomBuffer(20));
+    uploadResult = containerClient.UploadDirectory(sourceDirectory, "dir/", uploadOptions);
+    EXPECT_EQ(uploadResult.TransferredFileCount, 1);
+    EXPECT_EQ(uploadResult.SkippedFileCount, 2);
+    EXPECT_EQ(uploadResult.TransferredSize, 20);
+    WriteFile(sourceDirectory + "/a", files.at("a"));
+    DeleteFile(uploadOptions.JournalPath);
+    containerClient.UploadDirectory(sourceDirectory, "dir/", uploadOptions);
+
+    const std::string destinationDirectory = RandomString();
+    Blobs::DownloadBlobDirectoryOptions downloadOptions;
+    downloadOptions.JournalPath = RandomString();
+    downloadOptions.TransferOptions.ChunkSize = 64;
+    downloadOptions.TransferOptions.Concurrency = 4;
+    auto downloadResult
+        = containerClient.DownloadDirectory("dir/", destinationDirectory, downloadOptions);
+    EXPECT_EQ(downloadResult.TransferredFileCount, 3);
+    EXPECT_EQ(downloadResult.TransferredSize, 260);
+    EXPECT_EQ(state->NumDownloadedRanges, 5);
+    for (const auto& file : files)
+    {
+      EXPECT_EQ(ReadFile(destinationDirectory + "/" + file.first), file.second);
+    }
+    downloadResult
+        = containerClient.DownloadDirectory("dir/", destinationDirectory, downloadOptions);
+    EXPECT_EQ(downloadResult.TransferredFileCount, 0);
+    EXPECT_EQ(downloadResult.SkippedFileCount, 3);
+
+    // A blob whose file would be outside of the directory isn't downloaded.
+    state->Blobs["dir/../escaped"] = {"content", "\"escaped\""};
+    EXPECT_THROW(
+        containerClient.DownloadDirectory("dir/", destinationDirectory), std::runtime_error);
+
+    for (const auto& file : files)
+    {
+      DeleteFile(sourceDirectory + "/" + file.first);
+      DeleteFile(destinationDirectory + "/" + file.first);
+    }
+    for (const auto& subdirectory : {"/sub/deeper", "/sub", ""})
+    {
+      DeleteFile(sourceDirectory + subdirectory);
+      DeleteFile(destinationDirectory + subdirectory);
+    }
+    DeleteFile(uploadOptions.JournalPath);
+    DeleteFile(downloadOptions.JournalPath);
+  }
+
+  TEST_F(BlobContainerClientTest, UploadDownloadDirectory)
+  {
+    const std::string sourceDirectory = RandomString();
+    const std::string destinationDirectory = RandomString();
+    const auto content = RandomBuffer(static_cast<size_t>(1_MB + 123));
+    _internal::CreateDirectories(sourceDirectory + "/sub");
+    WriteFile(sourceDirectory + "/file", content);
+    WriteFile(sourceDirectory + "/sub/file", content);
+    const std::string blobPrefix = RandomString() + "/";
+
+    Blobs::UploadBlobDirectoryOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 512_KB;
+    uploadOptions.TransferOptions.ChunkSize = 256_KB;
+    auto uploadResult
+        = m_blobContainerClient->UploadDirectory(sourceDirectory, blobPrefix, uploadOptions);
+    EXPECT_EQ(uploadResult.TransferredFileCount, 2);
+    EXPECT_EQ(uploadResult.TransferredSize, static_cast<int64_t>(content.size() * 2));
+
+    Blobs::DownloadBlobDirectoryOptions downloadOptions;
+    downloadOptions.TransferOptions.ChunkSize = 256_KB;
+    auto downloadResult = m_blobContainerClient->DownloadDirectory(
+        blobPrefix, destinationDirectory, downloadOptions);
+    EXPECT_EQ(downloadResult.TransferredFileCount, 2);
+    EXPECT_EQ(ReadFile(destinationDirectory + "/file"), content);
+    EXPECT_EQ(ReadFile(destinationDirectory + "/sub/file"), content);
+
+    for (const auto& directory : {sourceDirectory, destinationDirectory})
+    {
+      DeleteFile(directory + "/file");
+      DeleteFile(directory + "/sub/file");
+      DeleteFile(directory + "/sub");
+      DeleteFile(directory);
+    }
+  }
+
   TEST_F(BlobContainerClientTest, ListBlobsOtherStuff)
   {
     std::string blobName = RandomString();
@@ -496,6 +1221,110 @@ namespace Azure { namespace Storage { namespace Test {
     containerClient.Delete();
   }
 
+  namespace {
+    // Renews the leases whose ID is held, and rejects the renewal of the others.
+    class MockLeaseTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct State
+      {
+        std::mutex Mutex;
+        std::string HeldLeaseId;
+        std::map<std::string, int> Renewals;
+      };
+
+      explicit MockLeaseTransportPolicy(std::shared_ptr<State> state) : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockLeaseTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        std::lock_guard<std::mutex> guard(m_state->Mutex);
+        const auto leaseId = request.GetHeaders().at("x-ms-lease-id");
+        ++m_state->Renewals[leaseId];
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (leaseId == m_state->HeldLeaseId)
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetHeader("etag", "\"0x8D83B58BDF51D75\"");
+          response->SetHeader("last-modified", "Fri, 07 Aug 2020 07:44:35 GMT");
+          response->SetHeader("x-ms-lease-id", leaseId);
+        }
+        else
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Conflict, "Conflict");
+          response->SetHeader("x-ms-error-code", "LeaseIdMismatchWithLeaseOperation");
+        }
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+  } // namespace
+
+  TEST(BlobLeaseManagerTest, RenewsLeases)
+  {
+    auto state = std::make_shared<MockLeaseTransportPolicy::State>();
+    state->HeldLeaseId = Blobs::BlobLeaseClient::CreateUniqueLeaseId();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockLeaseTransportPolicy>(state));
+    Blobs::BlobContainerClient containerClient(
+        "https://account.blob.core.windows.net/container", clientOptions);
+
+    std::mutex lostMutex;
+    std::vector<std::string> lostLeaseIds;
+    Blobs::BlobLeaseManagerOptions options;
+    options.Concurrency = 2;
+    options.OnLeaseLost = [&](const std::shared_ptr<Blobs::BlobLeaseClient>& leaseClient) {
+      std::lock_guard<std::mutex> guard(lostMutex);
+      lostLeaseIds.push_back(leaseClient->GetLeaseId());
+    };
+    Blobs::BlobLeaseManager leaseManager(options);
+
+    auto heldLease = std::make_shared<Blobs::BlobLeaseClient>(
+        containerClient.GetBlobClient("held"), state->HeldLeaseId);
+    const std::string lostLeaseId = Blobs::BlobLeaseClient::CreateUniqueLeaseId();
+    auto lostLease = std::make_shared<Blobs::BlobLeaseClient>(
+        containerClient.GetBlobClient("lost"), lostLeaseId);
+    auto removedLease = std::make_shared<Blobs::BlobLeaseClient>(
+        containerClient.GetBlobClient("removed"), state->HeldLeaseId + "-removed");
+    leaseManager.Add(heldLease, std::chrono::seconds(1));
+    leaseManager.Add(lostLease, std::chrono::seconds(1));
+    leaseManager.Add(removedLease, std::chrono::seconds(1));
+    EXPECT_EQ(leaseManager.GetLeaseCount(), size_t(3));
+    EXPECT_TRUE(leaseManager.Remove(removedLease));
+    EXPECT_FALSE(leaseManager.Remove(removedLease));
+    EXPECT_THROW(leaseManager.Add(heldLease, std::chrono::seconds(-1)), std::invalid_argument);
+
+    // Renewed about every 400 to 500 milliseconds.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    EXPECT_EQ(leaseManager.GetLeaseCount(), size_t(1));
+    {
+      std::lock_guard<std::mutex> guard(state->Mutex);
+      EXPECT_GE(state->Renewals[state->HeldLeaseId], 2);
+      EXPECT_LE(state->Renewals[state->HeldLeaseId], 4);
+      EXPECT_EQ(state->Renewals[lostLeaseId], 1);
+      EXPECT_EQ(state->Renewals.count(state->HeldLeaseId + "-removed"), size_t(0));
+    }
+    {
+      std::lock_guard<std::mutex> guard(lostMutex);
+      EXPECT_EQ(lostLeaseIds, std::vector<std::string>{lostLeaseId});
+    }
+  }
+
   TEST_F(BlobContainerClientTest, DISABLED_EncryptionScope)
   {
     {
@@ -876,6 +1705,51 @@ namespace Azure { namespace Storage { namespace Test {
     EXPECT_EQ(findResults[0].BlobContainerName, m_containerName);
   }
 
+  TEST_F(BlobContainerClientTest, FindBlobsByTagsConcurrently)
+  {
+    std::map<std::string, std::string> tags;
+    std::string c1 = "k" + RandomString();
+    std::string v1 = RandomString();
+    tags[c1] = v1;
+
+    std::map<std::string, int64_t> blobSizes;
+    for (int i = 0; i < 5; ++i)
+    {
+      std::string blobName = RandomString();
+      auto blobClient = m_blobContainerClient->GetBlockBlobClient(blobName);
+      std::vector<uint8_t> content(i);
+      blobClient.UploadFrom(content.data(), content.size());
+      blobClient.SetTags(tags);
+      blobSizes[blobName] = i;
+    }
+
+    auto blobServiceClient = Azure::Storage::Blobs::BlobServiceClient::CreateFromConnectionString(
+        StandardStorageConnectionString());
+    Blobs::FindBlobsByTagsConcurrentlyOptions options;
+    options.Concurrency = 3;
+    options.PageSizeHint = 2;
+    std::mutex foundMutex;
+    std::map<std::string, int64_t> foundSizes;
+    for (int i = 0; i < 30 && foundSizes.size() != blobSizes.size(); ++i)
+    {
+      if (i != 0)
+      {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+      }
+      foundSizes.clear();
+      blobServiceClient.FindBlobsByTagsConcurrently(
+          c1 + " = '" + v1 + "'",
+          [&](const Blobs::Models::TaggedBlobItem& blob, const Blobs::BlobClient& blobClient) {
+            EXPECT_EQ(blob.BlobContainerName, m_containerName);
+            const int64_t blobSize = blobClient.GetProperties().Value.BlobSize;
+            std::lock_guard<std::mutex> guard(foundMutex);
+            EXPECT_TRUE(foundSizes.emplace(blob.BlobName, blobSize).second);
+          },
+          options);
+    }
+    EXPECT_EQ(foundSizes, blobSizes);
+  }
+
   TEST_F(BlobContainerClientTest, AccessConditionTags)
   {
     std::map<std::string, std::string> tags;
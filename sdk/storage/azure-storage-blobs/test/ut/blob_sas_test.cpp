@@ -548,4 +548,42 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST(BlobSasTokenGeneratorTest, SameAsBuilder)
+  {
+    StorageSharedKeyCredential credential(
+        "account", Azure::Core::Convert::Base64Encode(RandomBuffer(64)));
+    Blobs::Models::UserDelegationKey userDelegationKey;
+    userDelegationKey.SignedObjectId = "object";
+    userDelegationKey.SignedTenantId = "tenant";
+    userDelegationKey.SignedStartsOn = Azure::DateTime(2021, 1, 1);
+    userDelegationKey.SignedExpiresOn = Azure::DateTime(2021, 1, 2);
+    userDelegationKey.SignedService = "b";
+    userDelegationKey.SignedVersion = "2020-02-10";
+    userDelegationKey.Value = Azure::Core::Convert::Base64Encode(RandomBuffer(32));
+
+    Sas::BlobSasBuilder builder;
+    builder.Protocol = Sas::SasProtocol::HttpsOnly;
+    builder.StartsOn = Azure::DateTime(2021, 1, 1);
+    builder.ExpiresOn = Azure::DateTime(2021, 1, 2);
+    builder.BlobContainerName = "container";
+    builder.Resource = Sas::BlobSasResource::Blob;
+    builder.ContentType = "text/plain";
+    builder.SetPermissions(Sas::BlobSasPermissions::Read);
+
+    const Sas::BlobSasTokenGenerator generator(builder, credential);
+    const Sas::BlobSasTokenGenerator userDelegationGenerator(
+        builder, userDelegationKey, credential.AccountName);
+    for (const std::string blobName : {"blob", "dir/blob name+1", ""})
+    {
+      builder.BlobName = blobName;
+      EXPECT_EQ(generator.GenerateSasToken(blobName), builder.GenerateSasToken(credential));
+      EXPECT_EQ(
+          userDelegationGenerator.GenerateSasToken(blobName),
+          builder.GenerateSasToken(userDelegationKey, credential.AccountName));
+    }
+
+    builder.Resource = Sas::BlobSasResource::BlobContainer;
+    EXPECT_THROW(Sas::BlobSasTokenGenerator(builder, credential), std::invalid_argument);
+  }
+
 }}} // namespace Azure::Storage::Test
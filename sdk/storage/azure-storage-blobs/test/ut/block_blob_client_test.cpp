@@ -3,8 +3,16 @@
 
 #include "block_blob_client_test.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <future>
+#include <map>
+#include <mutex>
 #include <random>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include <azure/core/cryptography/hash.hpp>
@@ -26,6 +34,1650 @@ namespace Azure { namespace Storage { namespace Blobs { namespace Models {
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // A stream of unknown length which can't be rewound and returns the data in small pieces,
+    // like a pipe.
+    class ForwardOnlyBodyStream final : public Azure::Core::IO::BodyStream {
+    public:
+      explicit ForwardOnlyBodyStream(const std::vector<uint8_t>& content) : m_content(content) {}
+
+      int64_t Length() const override { return -1; }
+
+      void Rewind() override { throw std::runtime_error("The stream can't be rewound."); }
+
+    private:
+      size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const&) override
+      {
+        const size_t bytesRead
+            = std::min({count, m_content.size() - m_offset, static_cast<size_t>(100_KB + 7)});
+        std::copy(
+            m_content.begin() + m_offset, m_content.begin() + m_offset + bytesRead, buffer);
+        m_offset += bytesRead;
+        return bytesRead;
+      }
+
+      const std::vector<uint8_t>& m_content;
+      size_t m_offset = 0;
+    };
+
+    // Answers the requests staging blocks from a URL and committing them, and keeps their block
+    // IDs and source ranges.
+    class MockCopyTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct StagedBlock
+      {
+        std::string BlockId;
+        std::string SourceRange;
+      };
+
+      explicit MockCopyTransportPolicy(
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::vector<StagedBlock>> stagedBlocks,
+          std::shared_ptr<std::string> blockList)
+          : m_mutex(std::move(mutex)), m_stagedBlocks(std::move(stagedBlocks)),
+            m_blockList(std::move(blockList))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockCopyTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        auto query = request.GetUrl().GetQueryParameters();
+        auto headers = request.GetHeaders();
+        {
+          std::lock_guard<std::mutex> guard(*m_mutex);
+          if (query["comp"] == "block")
+          {
+            m_stagedBlocks->push_back(
+                {Core::Url::Decode(query["blockid"]), headers.at("x-ms-source-range")});
+          }
+          else
+          {
+            auto body = request.GetBodyStream()->ReadToEnd(context);
+            m_blockList->assign(body.begin(), body.end());
+          }
+        }
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Created, "Created");
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-server-encrypted", "true");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::vector<StagedBlock>> m_stagedBlocks;
+      std::shared_ptr<std::string> m_blockList;
+    };
+  } // namespace
+
+  TEST(CopyFromUriParallelTest, StagesRanges)
+  {
+    auto mutex = std::make_shared<std::mutex>();
+    auto stagedBlocks = std::make_shared<std::vector<MockCopyTransportPolicy::StagedBlock>>();
+    auto blockList = std::make_shared<std::string>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockCopyTransportPolicy>(mutex, stagedBlocks, blockList));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    Blobs::CopyBlobFromUriParallelOptions options;
+    options.SourceLength = 10_MB + 1;
+    options.TransferOptions.ChunkSize = 4_MB;
+    options.TransferOptions.Concurrency = 3;
+    blockBlobClient.CopyFromUriParallel(
+        "https://source.blob.core.windows.net/container/blob?sig=signature", options);
+
+    ASSERT_EQ(stagedBlocks->size(), 3U);
+    std::sort(
+        stagedBlocks->begin(),
+        stagedBlocks->end(),
+        [](const MockCopyTransportPolicy::StagedBlock& lhs,
+           const MockCopyTransportPolicy::StagedBlock& rhs) { return lhs.BlockId < rhs.BlockId; });
+    EXPECT_EQ((*stagedBlocks)[0].SourceRange, "bytes=0-" + std::to_string(4_MB - 1));
+    EXPECT_EQ(
+        (*stagedBlocks)[1].SourceRange,
+        "bytes=" + std::to_string(4_MB) + "-" + std::to_string(8_MB - 1));
+    EXPECT_EQ(
+        (*stagedBlocks)[2].SourceRange,
+        "bytes=" + std::to_string(8_MB) + "-" + std::to_string(10_MB));
+    // The blocks are committed in the order of their ranges.
+    size_t position = 0;
+    for (const auto& stagedBlock : *stagedBlocks)
+    {
+      position = blockList->find(stagedBlock.BlockId, position);
+      EXPECT_NE(position, std::string::npos);
+    }
+
+    options.TransferOptions.ChunkSize = 101_MB;
+    EXPECT_THROW(
+        blockBlobClient.CopyFromUriParallel("https://source.blob.core.windows.net/c/b", options),
+        Azure::Core::RequestFailedException);
+  }
+
+  namespace {
+    // Serves the blobs of a map keyed by path, answers 304 when If-None-Match has their ETag.
+    class MockConditionalDownloadTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct Blob
+      {
+        std::string Content;
+        std::string ETag;
+      };
+
+      struct State
+      {
+        std::mutex Mutex;
+        std::map<std::string, Blob> Blobs;
+        int FullDownloads = 0;
+        int NotModifiedDownloads = 0;
+      };
+
+      explicit MockConditionalDownloadTransportPolicy(std::shared_ptr<State> state)
+          : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockConditionalDownloadTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        std::lock_guard<std::mutex> guard(m_state->Mutex);
+        const auto& blob = m_state->Blobs.at(request.GetUrl().GetPath());
+        auto headers = request.GetHeaders();
+        std::unique_ptr<Core::Http::RawResponse> response;
+        auto ifNoneMatch = headers.find("if-none-match");
+        if (ifNoneMatch != headers.end() && ifNoneMatch->second == blob.ETag)
+        {
+          ++m_state->NotModifiedDownloads;
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::NotModified, "Not Modified");
+        }
+        else
+        {
+          ++m_state->FullDownloads;
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          // The content outlives the stream, the tests read it before changing the blob.
+          response->SetBodyStream(std::make_unique<Core::IO::MemoryBodyStream>(
+              reinterpret_cast<const uint8_t*>(blob.Content.data()), blob.Content.length()));
+          response->SetHeader("content-length", std::to_string(blob.Content.length()));
+          response->SetHeader("x-ms-blob-type", "BlockBlob");
+          response->SetHeader("x-ms-server-encrypted", "true");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        response->SetHeader("etag", blob.ETag);
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+
+    std::string DownloadToString(const Blobs::BlobClient& blobClient)
+    {
+      auto bodyStream = blobClient.Download().Value.BodyStream->ReadToEnd();
+      return std::string(bodyStream.begin(), bodyStream.end());
+    }
+  } // namespace
+
+  TEST(BlobDownloadCacheTest, ServesNotModifiedBlobs)
+  {
+    auto state = std::make_shared<MockConditionalDownloadTransportPolicy::State>();
+    state->Blobs["container/small"] = {std::string(40, 'a'), "\"etag-1\""};
+    state->Blobs["container/other"] = {std::string(40, 'b'), "\"etag-2\""};
+    state->Blobs["container/large"] = {std::string(60, 'c'), "\"etag-3\""};
+    auto cache = std::make_shared<Blobs::BlobDownloadCache>(100, 50);
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.DownloadCache = cache;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockConditionalDownloadTransportPolicy>(state));
+    Blobs::BlobContainerClient containerClient(
+        "https://account.blob.core.windows.net/container", clientOptions);
+    auto smallBlobClient = containerClient.GetBlobClient("small");
+
+    EXPECT_EQ(DownloadToString(smallBlobClient), std::string(40, 'a'));
+    EXPECT_EQ(state->FullDownloads, 1);
+    EXPECT_EQ(cache->Size(), 40);
+    EXPECT_EQ(DownloadToString(smallBlobClient), std::string(40, 'a'));
+    EXPECT_EQ(state->FullDownloads, 1);
+    EXPECT_EQ(state->NotModifiedDownloads, 1);
+
+    // Another client with a SAS token shares the cached blob.
+    Blobs::BlobClient sasBlobClient(
+        "https://account.blob.core.windows.net/container/small?sig=signature", clientOptions);
+    EXPECT_EQ(DownloadToString(sasBlobClient), std::string(40, 'a'));
+    EXPECT_EQ(state->NotModifiedDownloads, 2);
+
+    // A changed blob is downloaded again.
+    state->Blobs["container/small"] = {std::string(30, 'd'), "\"etag-4\""};
+    EXPECT_EQ(DownloadToString(smallBlobClient), std::string(30, 'd'));
+    EXPECT_EQ(state->FullDownloads, 2);
+    EXPECT_EQ(cache->Size(), 30);
+
+    // Ranges and blobs larger than the limit aren't cached.
+    Blobs::DownloadBlobOptions rangeOptions;
+    rangeOptions.Range = Core::Http::HttpRange{0, 10};
+    smallBlobClient.Download(rangeOptions);
+    EXPECT_EQ(state->FullDownloads, 3);
+    EXPECT_EQ(DownloadToString(containerClient.GetBlobClient("large")), std::string(60, 'c'));
+    EXPECT_EQ(cache->Size(), 30);
+
+    // The least recently used blob is evicted.
+    DownloadToString(containerClient.GetBlobClient("other"));
+    DownloadToString(containerClient.GetBlobClient("other"));
+    EXPECT_EQ(state->NotModifiedDownloads, 3);
+    EXPECT_EQ(cache->Size(), 70);
+    state->Blobs["container/other"].ETag = "\"etag-5\"";
+    state->Blobs["container/other"].Content = std::string(50, 'e');
+    DownloadToString(containerClient.GetBlobClient("other"));
+    EXPECT_EQ(cache->Size(), 80);
+    state->Blobs["container/large"] = {std::string(50, 'f'), "\"etag-6\""};
+    DownloadToString(containerClient.GetBlobClient("large"));
+    EXPECT_EQ(cache->Size(), 100);
+    DownloadToString(containerClient.GetBlobClient("small"));
+    EXPECT_EQ(cache->Size(), 80);
+    const int fullDownloads = state->FullDownloads;
+    DownloadToString(containerClient.GetBlobClient("other"));
+    EXPECT_EQ(state->FullDownloads, fullDownloads + 1);
+
+    cache->Clear();
+    EXPECT_EQ(cache->Size(), 0);
+    EXPECT_THROW(Blobs::BlobDownloadCache(10, 20), std::invalid_argument);
+  }
+
+  namespace {
+    // Stages and commits blocks and lists them like the service, and fails the commits while
+    // FailCommit is set, like an interrupted upload.
+    class MockBlockListTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct State
+      {
+        std::mutex Mutex;
+        std::map<std::string, int64_t> UncommittedBlocks;
+        std::vector<std::pair<std::string, int64_t>> CommittedBlocks;
+        std::vector<std::string> StagedBlockIds;
+        std::string CommitCondition;
+        int Crc64StagedBlocks = 0;
+        // The blocks staged with the MD5 of their content.
+        int Md5StagedBlocks = 0;
+        bool FailCommit = false;
+      };
+
+      explicit MockBlockListTransportPolicy(std::shared_ptr<State> state)
+          : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockBlockListTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        std::lock_guard<std::mutex> guard(m_state->Mutex);
+        auto query = request.GetUrl().GetQueryParameters();
+        auto headers = request.GetHeaders();
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetMethod() == Core::Http::HttpMethod::Get)
+        {
+          std::string body
+              = "<?xml version=\"1.0\" encoding=\"utf-8\"?><BlockList><CommittedBlocks>";
+          auto appendBlock = [&body](const std::string& name, int64_t size) {
+            body += "<Block><Name>" + name + "</Name><Size>" + std::to_string(size)
+                + "</Size></Block>";
+          };
+          for (const auto& block : m_state->CommittedBlocks)
+          {
+            appendBlock(block.first, block.second);
+          }
+          body += "</CommittedBlocks><UncommittedBlocks>";
+          for (const auto& block : m_state->UncommittedBlocks)
+          {
+            appendBlock(block.first, block.second);
+          }
+          body += "</UncommittedBlocks></BlockList>";
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+          if (!m_state->CommittedBlocks.empty())
+          {
+            response->SetHeader("etag", DummyETag.ToString());
+          }
+        }
+        else if (query["comp"] == "block")
+        {
+          const std::string blockId = Core::Url::Decode(query["blockid"]);
+          const auto content = request.GetBodyStream()->ReadToEnd(context);
+          m_state->UncommittedBlocks[blockId] = static_cast<int64_t>(content.size());
+          m_state->StagedBlockIds.push_back(blockId);
+          if (headers.count("x-ms-content-crc64") != 0)
+          {
+            ++m_state->Crc64StagedBlocks;
+          }
+          auto contentMd5 = headers.find("content-md5");
+          if (contentMd5 != headers.end()
+              && contentMd5->second
+                  == Core::Convert::Base64Encode(Core::Cryptography::Md5Hash().Final(
+                      content.data(), content.size())))
+          {
+            ++m_state->Md5StagedBlocks;
+          }
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+        }
+        else if (m_state->FailCommit)
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::PreconditionFailed, "Precondition Failed");
+        }
+        else
+        {
+          auto ifMatch = headers.find("if-match");
+          auto ifNoneMatch = headers.find("if-none-match");
+          m_state->CommitCondition.clear();
+          if (ifMatch != headers.end())
+          {
+            m_state->CommitCondition = "if-match: " + ifMatch->second;
+          }
+          else if (ifNoneMatch != headers.end())
+          {
+            m_state->CommitCondition = "if-none-match: " + ifNoneMatch->second;
+          }
+          // The latest version of a block is the uncommitted one if there is one.
+          auto body = request.GetBodyStream()->ReadToEnd(context);
+          const std::string blockList(body.begin(), body.end());
+          std::vector<std::pair<std::string, int64_t>> committedBlocks;
+          for (size_t begin = blockList.find("<Latest>"); begin != std::string::npos;
+               begin = blockList.find("<Latest>", begin))
+          {
+            begin += 8;
+            const size_t end = blockList.find("</Latest>", begin);
+            const std::string blockId = blockList.substr(begin, end - begin);
+            auto uncommittedBlock = m_state->UncommittedBlocks.find(blockId);
+            if (uncommittedBlock != m_state->UncommittedBlocks.end())
+            {
+              committedBlocks.emplace_back(blockId, uncommittedBlock->second);
+            }
+            else
+            {
+              committedBlocks.push_back(*std::find_if(
+                  m_state->CommittedBlocks.begin(),
+                  m_state->CommittedBlocks.end(),
+                  [&blockId](const std::pair<std::string, int64_t>& block) {
+                    return block.first == blockId;
+                  }));
+            }
+          }
+          m_state->CommittedBlocks = std::move(committedBlocks);
+          m_state->UncommittedBlocks.clear();
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("etag", DummyETag.ToString());
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        response->SetHeader("x-ms-request-server-encrypted", "true");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+  } // namespace
+
+  TEST(ResumableUploadTest, ReusesUncommittedBlocks)
+  {
+    auto state = std::make_shared<MockBlockListTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockListTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(10_KB + 1));
+    Blobs::UploadBlockBlobFromOptions options;
+    options.TransferOptions.SingleUploadThreshold = 0;
+    options.TransferOptions.ChunkSize = 4_KB;
+    options.TransferOptions.Resumable = true;
+
+    state->FailCommit = true;
+    EXPECT_THROW(
+        blockBlobClient.UploadFrom(content.data(), content.size(), options), StorageException);
+    EXPECT_EQ(state->StagedBlockIds.size(), 3U);
+    // The block staged with another size is staged again.
+    state->UncommittedBlocks.erase(state->StagedBlockIds[1]);
+    state->UncommittedBlocks[state->StagedBlockIds[2]] = 1;
+    state->StagedBlockIds.clear();
+    state->FailCommit = false;
+    blockBlobClient.UploadFrom(content.data(), content.size(), options);
+    EXPECT_EQ(state->StagedBlockIds.size(), 2U);
+    EXPECT_EQ(state->Crc64StagedBlocks, 0);
+
+    // The verified blocks are only reused if their content hasn't changed.
+    const std::string tempFilename = RandomString();
+    {
+      _internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+    options.TransferOptions.VerifyResumedBlocks = true;
+    state->StagedBlockIds.clear();
+    state->FailCommit = true;
+    EXPECT_THROW(blockBlobClient.UploadFrom(tempFilename, options), StorageException);
+    EXPECT_EQ(state->StagedBlockIds.size(), 3U);
+    EXPECT_EQ(state->Crc64StagedBlocks, 3);
+    content[static_cast<size_t>(5_KB)] ^= 0xff;
+    {
+      _internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+    state->StagedBlockIds.clear();
+    state->FailCommit = false;
+    blockBlobClient.UploadFrom(tempFilename, options);
+    EXPECT_EQ(state->StagedBlockIds.size(), 1U);
+    EXPECT_EQ(state->Crc64StagedBlocks, 4);
+    DeleteFile(tempFilename);
+  }
+
+  TEST(TransactionalMd5UploadTest, StagesBlocksWithMd5)
+  {
+    auto state = std::make_shared<MockBlockListTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockListTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    // Blocks large enough to be hashed together by the concurrent threads.
+    std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(200_KB + 1));
+    const std::string tempFilename = RandomString();
+    {
+      _internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+    Blobs::UploadBlockBlobFromOptions options;
+    options.TransferOptions.SingleUploadThreshold = 0;
+    options.TransferOptions.ChunkSize = 32_KB;
+    options.TransferOptions.Concurrency = 8;
+    blockBlobClient.UploadFrom(content.data(), content.size(), options);
+    EXPECT_EQ(state->Md5StagedBlocks, 0);
+
+    options.TransferOptions.ComputeTransactionalMd5 = true;
+    blockBlobClient.UploadFrom(content.data(), content.size(), options);
+    EXPECT_EQ(state->Md5StagedBlocks, 7);
+    blockBlobClient.UploadFrom(tempFilename, options);
+    EXPECT_EQ(state->Md5StagedBlocks, 14);
+
+    // The verified blocks are staged with their CRC64 instead.
+    options.TransferOptions.Resumable = true;
+    options.TransferOptions.VerifyResumedBlocks = true;
+    state->UncommittedBlocks.clear();
+    blockBlobClient.UploadFrom(tempFilename, options);
+    EXPECT_EQ(state->Md5StagedBlocks, 14);
+    EXPECT_EQ(state->Crc64StagedBlocks, 7);
+    DeleteFile(tempFilename);
+  }
+
+  TEST(UploadProgressTest, ReportsUploadedBytes)
+  {
+    auto state = std::make_shared<MockBlockListTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockListTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(10_KB + 1));
+    std::mutex reportsMutex;
+    std::vector<int64_t> reports;
+    Blobs::UploadBlockBlobFromOptions options;
+    options.TransferOptions.ChunkSize = 4_KB;
+    options.TransferOptions.Concurrency = 3;
+    options.TransferOptions.MaxProgressReportsPerSecond = 0;
+    options.TransferOptions.ProgressHandler = [&](int64_t bytes) {
+      std::lock_guard<std::mutex> guard(reportsMutex);
+      reports.push_back(bytes);
+    };
+
+    // In a single request and in blocks.
+    for (int64_t singleUploadThreshold : {int64_t(1_MB), int64_t(0)})
+    {
+      options.TransferOptions.SingleUploadThreshold = singleUploadThreshold;
+      reports.clear();
+      blockBlobClient.UploadFrom(content.data(), content.size(), options);
+      ASSERT_FALSE(reports.empty());
+      EXPECT_EQ(reports.back(), static_cast<int64_t>(content.size()));
+    }
+
+    // The reused blocks are counted too.
+    options.TransferOptions.Resumable = true;
+    state->FailCommit = true;
+    EXPECT_THROW(
+        blockBlobClient.UploadFrom(content.data(), content.size(), options), StorageException);
+    state->FailCommit = false;
+    reports.clear();
+    state->StagedBlockIds.clear();
+    blockBlobClient.UploadFrom(content.data(), content.size(), options);
+    EXPECT_TRUE(state->StagedBlockIds.empty());
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(reports.back(), static_cast<int64_t>(content.size()));
+  }
+
+  TEST(SyncFromTest, UploadsChangedBlocks)
+  {
+    auto state = std::make_shared<MockBlockListTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockListTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(10_KB + 1));
+    const std::string tempFilename = RandomString();
+    auto writeFile = [&]() {
+      _internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(content.data(), content.size(), 0);
+    };
+    writeFile();
+    Blobs::SyncBlockBlobFromOptions options;
+    options.TransferOptions.ChunkSize = 4_KB;
+
+    auto result = blockBlobClient.SyncFrom(tempFilename, options).Value;
+    EXPECT_EQ(result.UploadedSize, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(result.ReusedSize, 0);
+    EXPECT_EQ(state->CommitCondition, "if-none-match: *");
+    ASSERT_EQ(state->CommittedBlocks.size(), 3U);
+    EXPECT_EQ(state->Crc64StagedBlocks, 3);
+
+    // Only the changed block is staged, the other ones are committed again.
+    content[static_cast<size_t>(9_KB)] ^= 0xff;
+    writeFile();
+    const auto committedBlocks = state->CommittedBlocks;
+    state->StagedBlockIds.clear();
+    result = blockBlobClient.SyncFrom(tempFilename, options).Value;
+    EXPECT_EQ(result.UploadedSize, 2_KB + 1);
+    EXPECT_EQ(result.ReusedSize, 8_KB);
+    EXPECT_EQ(state->CommitCondition, "if-match: " + DummyETag.ToString());
+    ASSERT_EQ(state->StagedBlockIds.size(), 1U);
+    ASSERT_EQ(state->CommittedBlocks.size(), 3U);
+    EXPECT_EQ(state->CommittedBlocks[0], committedBlocks[0]);
+    EXPECT_EQ(state->CommittedBlocks[1], committedBlocks[1]);
+    EXPECT_EQ(state->CommittedBlocks[2].first, state->StagedBlockIds[0]);
+
+    // A blob uploaded by a verified resumable upload is synchronized without uploading it again.
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 0;
+    uploadOptions.TransferOptions.ChunkSize = 4_KB;
+    uploadOptions.TransferOptions.Resumable = true;
+    uploadOptions.TransferOptions.VerifyResumedBlocks = true;
+    content = RandomBuffer(static_cast<size_t>(12_KB));
+    writeFile();
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+    result = blockBlobClient.SyncFrom(tempFilename, options).Value;
+    EXPECT_EQ(result.UploadedSize, 0);
+    EXPECT_EQ(result.ReusedSize, 12_KB);
+    DeleteFile(tempFilename);
+  }
+
+  namespace {
+    // Stages and commits the content of blocks, lists the committed blocks, and downloads ranges
+    // of the committed content and its properties, with its metadata and Content-Encoding.
+    class MockBlockContentTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct State
+      {
+        std::mutex Mutex;
+        std::map<std::string, std::string> UncommittedBlocks;
+        std::vector<std::pair<std::string, int64_t>> CommittedBlocks;
+        std::string Content;
+        std::string ContentEncoding;
+        std::map<std::string, std::string> Metadata;
+        int RangeDownloads = 0;
+      };
+
+      explicit MockBlockContentTransportPolicy(std::shared_ptr<State> state)
+          : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockBlockContentTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        std::lock_guard<std::mutex> guard(m_state->Mutex);
+        auto query = request.GetUrl().GetQueryParameters();
+        auto headers = request.GetHeaders();
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetMethod() == Core::Http::HttpMethod::Get && query["comp"] == "blocklist")
+        {
+          std::string body
+              = "<?xml version=\"1.0\" encoding=\"utf-8\"?><BlockList><CommittedBlocks>";
+          for (const auto& block : m_state->CommittedBlocks)
+          {
+            body += "<Block><Name>" + block.first + "</Name><Size>"
+                + std::to_string(block.second) + "</Size></Block>";
+          }
+          body += "</CommittedBlocks><UncommittedBlocks></UncommittedBlocks></BlockList>";
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+        }
+        else if (
+            (request.GetMethod() == Core::Http::HttpMethod::Get
+             || request.GetMethod() == Core::Http::HttpMethod::Head)
+            && headers.count("if-match") != 0 && headers.at("if-match") != DummyETag.ToString())
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::PreconditionFailed, "Precondition Failed");
+          response->SetHeader("x-ms-error-code", "ConditionNotMet");
+        }
+        else if (
+            request.GetMethod() == Core::Http::HttpMethod::Get
+            || request.GetMethod() == Core::Http::HttpMethod::Head)
+        {
+          const int64_t contentLength = static_cast<int64_t>(m_state->Content.length());
+          int64_t begin = 0;
+          int64_t end = contentLength;
+          auto range = headers.find("x-ms-range");
+          if (range != headers.end())
+          {
+            ++m_state->RangeDownloads;
+            const size_t dash = range->second.find('-');
+            begin = std::stoll(range->second.substr(6, dash - 6));
+            end = std::min<int64_t>(end, std::stoll(range->second.substr(dash + 1)) + 1);
+            response = std::make_unique<Core::Http::RawResponse>(
+                1, 1, Core::Http::HttpStatusCode::PartialContent, "Partial Content");
+            response->SetHeader(
+                "content-range",
+                "bytes " + std::to_string(begin) + "-" + std::to_string(end - 1) + "/"
+                    + std::to_string(contentLength));
+          }
+          else
+          {
+            response = std::make_unique<Core::Http::RawResponse>(
+                1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          }
+          // The content outlives the stream, the tests read it before changing the blob.
+          if (request.GetMethod() == Core::Http::HttpMethod::Get)
+          {
+            response->SetBodyStream(std::make_unique<Core::IO::MemoryBodyStream>(
+                reinterpret_cast<const uint8_t*>(m_state->Content.data()) + begin,
+                static_cast<size_t>(end - begin)));
+          }
+          response->SetHeader("content-length", std::to_string(end - begin));
+          if (!m_state->ContentEncoding.empty())
+          {
+            response->SetHeader("content-encoding", m_state->ContentEncoding);
+          }
+          for (const auto& metadata : m_state->Metadata)
+          {
+            response->SetHeader("x-ms-meta-" + metadata.first, metadata.second);
+          }
+          response->SetHeader("x-ms-blob-type", "BlockBlob");
+          response->SetHeader("x-ms-server-encrypted", "true");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        else if (query["comp"] == "block")
+        {
+          auto body = request.GetBodyStream()->ReadToEnd(context);
+          m_state->UncommittedBlocks[Core::Url::Decode(query["blockid"])]
+              = std::string(body.begin(), body.end());
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+        }
+        else
+        {
+          auto body = request.GetBodyStream()->ReadToEnd(context);
+          const std::string blockList(body.begin(), body.end());
+          m_state->CommittedBlocks.clear();
+          m_state->Content.clear();
+          for (size_t begin = blockList.find("<Latest>"); begin != std::string::npos;
+               begin = blockList.find("<Latest>", begin))
+          {
+            begin += 8;
+            const size_t end = blockList.find("</Latest>", begin);
+            const std::string blockId = blockList.substr(begin, end - begin);
+            const std::string& blockContent = m_state->UncommittedBlocks.at(blockId);
+            m_state->CommittedBlocks.emplace_back(
+                blockId, static_cast<int64_t>(blockContent.length()));
+            m_state->Content += blockContent;
+          }
+          m_state->UncommittedBlocks.clear();
+          m_state->Metadata.clear();
+          m_state->ContentEncoding.clear();
+          for (const auto& header : headers)
+          {
+            if (header.first.compare(0, 10, "x-ms-meta-") == 0)
+            {
+              m_state->Metadata[header.first.substr(10)] = header.second;
+            }
+            else if (header.first == "x-ms-blob-content-encoding")
+            {
+              m_state->ContentEncoding = header.second;
+            }
+          }
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("x-ms-request-server-encrypted", "true");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+  } // namespace
+
+  TEST(CompressedTransferTest, CompressesBlocks)
+  {
+    auto state = std::make_shared<MockBlockContentTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockContentTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    std::string line;
+    for (int i = 0; line.length() < 1_MB + 100_KB; ++i)
+    {
+      line += "2001-08-23T07:00:00Z INFO request " + std::to_string(i % 97) + " completed\n";
+    }
+    const std::vector<uint8_t> content(line.begin(), line.end());
+
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.CompressionCodec = Blobs::Models::BlobCompressionCodec::Gzip;
+    uploadOptions.TransferOptions.ChunkSize = 64_KB;
+    uploadOptions.TransferOptions.Concurrency = 4;
+    uploadOptions.Metadata["key"] = "value";
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+    EXPECT_EQ(state->CommittedBlocks.size(), (content.size() + 64_KB - 1) / 64_KB);
+    EXPECT_LT(state->Content.length(), content.size() / 5);
+    EXPECT_EQ(state->ContentEncoding, "gzip");
+    EXPECT_EQ(state->Metadata["key"], "value");
+
+    // The blocks beyond the first chunk are downloaded one range each.
+    Blobs::DownloadBlobToOptions downloadOptions;
+    downloadOptions.TransferOptions.InitialChunkSize = 10_KB;
+    downloadOptions.TransferOptions.Concurrency = 4;
+    std::vector<uint8_t> downloaded(content.size());
+    auto downloadResult
+        = blockBlobClient.DownloadTo(downloaded.data(), downloaded.size(), downloadOptions);
+    EXPECT_EQ(downloaded, content);
+    EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Length.Value(), downloadResult.Value.BlobSize);
+    EXPECT_GT(state->RangeDownloads, 0);
+    EXPECT_LT(state->RangeDownloads, static_cast<int>(state->CommittedBlocks.size()));
+    std::vector<uint8_t> smallBuffer(content.size() - 1);
+    EXPECT_THROW(
+        blockBlobClient.DownloadTo(smallBuffer.data(), smallBuffer.size()),
+        Azure::Core::RequestFailedException);
+
+    // The raw content is downloaded on demand.
+    downloadOptions.DecompressContent = false;
+    std::vector<uint8_t> compressed(content.size());
+    downloadResult
+        = blockBlobClient.DownloadTo(compressed.data(), compressed.size(), downloadOptions);
+    EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(state->Content.length()));
+
+    // Files download the blocks of the first chunk with it.
+    const std::string fileName = RandomString(10);
+    {
+      _internal::FileWriter fileWriter(fileName);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+    uploadOptions.TransferOptions.ChunkSize = 100_KB;
+    blockBlobClient.UploadFrom(fileName, uploadOptions);
+    EXPECT_EQ(state->Metadata["azsdkcompressionblocksize"], std::to_string(100_KB));
+    state->RangeDownloads = 0;
+    blockBlobClient.DownloadTo(fileName);
+    EXPECT_EQ(state->RangeDownloads, 0);
+    EXPECT_EQ(ReadFile(fileName), content);
+    DeleteFile(fileName);
+
+    uploadOptions.TransferOptions.Resumable = true;
+    EXPECT_THROW(
+        blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions),
+        std::invalid_argument);
+  }
+
+  TEST(AsyncFileIoTest, DownloadsToFile)
+  {
+    auto state = std::make_shared<MockBlockContentTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockContentTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    const auto content = RandomBuffer(static_cast<size_t>(10_MB + 123));
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 0;
+    uploadOptions.TransferOptions.ChunkSize = 4_MB;
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+
+    // The chunks are larger than the buffer, so that their writes overlap the reads.
+    Blobs::DownloadBlobToOptions downloadOptions;
+    downloadOptions.TransferOptions.AsyncFileIo = true;
+    downloadOptions.TransferOptions.InitialChunkSize = 5_MB;
+    downloadOptions.TransferOptions.ChunkSize = 9_MB + 7;
+    downloadOptions.TransferOptions.Concurrency = 2;
+    for (bool unbuffered : {false, true})
+    {
+      downloadOptions.TransferOptions.UnbufferedIo = unbuffered;
+      const std::string fileName = RandomString(10);
+      auto downloadResult = blockBlobClient.DownloadTo(fileName, downloadOptions);
+      EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(content.size()));
+      EXPECT_EQ(ReadFile(fileName), content);
+      DeleteFile(fileName);
+    }
+  }
+
+  TEST(KnownSizeDownloadTest, RequestsAllRangesAtOnce)
+  {
+    auto state = std::make_shared<MockBlockContentTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockContentTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    const auto content = RandomBuffer(static_cast<size_t>(1_MB + 123));
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 0;
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+
+    // The whole blob is downloaded in chunks, without a first chunk of InitialChunkSize.
+    Blobs::DownloadBlobToOptions downloadOptions;
+    downloadOptions.BlobSize = static_cast<int64_t>(content.size());
+    downloadOptions.ETag = DummyETag;
+    downloadOptions.TransferOptions.ChunkSize = 256_KB;
+    downloadOptions.TransferOptions.Concurrency = 4;
+    std::vector<uint8_t> downloaded(content.size());
+    state->RangeDownloads = 0;
+    auto downloadResult
+        = blockBlobClient.DownloadTo(downloaded.data(), downloaded.size(), downloadOptions);
+    EXPECT_EQ(state->RangeDownloads, 5);
+    EXPECT_EQ(downloaded, content);
+    EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Offset, 0);
+    EXPECT_EQ(
+        downloadResult.Value.ContentRange.Length.Value(), static_cast<int64_t>(content.size()));
+    EXPECT_EQ(downloadResult.Value.Details.ETag, DummyETag);
+
+    downloadOptions.Range = Core::Http::HttpRange();
+    downloadOptions.Range.Value().Offset = 100_KB;
+    downloadOptions.Range.Value().Length = 300_KB;
+    const std::string fileName = RandomString(10);
+    state->RangeDownloads = 0;
+    downloadResult = blockBlobClient.DownloadTo(fileName, downloadOptions);
+    EXPECT_EQ(state->RangeDownloads, 2);
+    EXPECT_EQ(
+        ReadFile(fileName),
+        std::vector<uint8_t>(content.begin() + 100_KB, content.begin() + 400_KB));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Offset, 100_KB);
+    EXPECT_EQ(downloadResult.Value.ContentRange.Length.Value(), 300_KB);
+    downloadOptions.Range.Reset();
+
+    // The download fails if the blob was modified since its ETag was known.
+    downloadOptions.ETag = DummyETag2;
+    EXPECT_THROW(
+        blockBlobClient.DownloadTo(downloaded.data(), downloaded.size(), downloadOptions),
+        StorageException);
+
+    // A compressed blob is downloaded again the regular way to be decompressed.
+    uploadOptions.CompressionCodec = Blobs::Models::BlobCompressionCodec::Gzip;
+    uploadOptions.TransferOptions.ChunkSize = 64_KB;
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+    downloadOptions.BlobSize = static_cast<int64_t>(state->Content.length());
+    downloadOptions.ETag = DummyETag;
+    downloadOptions.TransferOptions.ChunkSize = 64_KB;
+    for (bool toFile : {false, true})
+    {
+      if (toFile)
+      {
+        downloadResult = blockBlobClient.DownloadTo(fileName, downloadOptions);
+        EXPECT_EQ(ReadFile(fileName), content);
+      }
+      else
+      {
+        // Large enough for the compressed blob, so that its chunks are requested.
+        std::vector<uint8_t> buffer(std::max(content.size(), state->Content.length()));
+        downloadResult = blockBlobClient.DownloadTo(buffer.data(), buffer.size(), downloadOptions);
+        buffer.resize(content.size());
+        EXPECT_EQ(buffer, content);
+      }
+      EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(content.size()));
+    }
+    DeleteFile(fileName);
+  }
+
+  TEST(SinkDownloadTest, PassesChunksInOrder)
+  {
+    auto state = std::make_shared<MockBlockContentTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockContentTransportPolicy>(state));
+    // Smaller than the chunks read ahead, so that they wait for the sink.
+    clientOptions.BufferPool = std::make_shared<BufferPool>(3 * 64_KB, 0);
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    const auto content = RandomBuffer(static_cast<size_t>(1_MB + 123));
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 0;
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+
+    Blobs::DownloadBlobToOptions downloadOptions;
+    downloadOptions.TransferOptions.ChunkSize = 64_KB;
+    downloadOptions.TransferOptions.Concurrency = 8;
+    const auto callingThread = std::this_thread::get_id();
+    std::vector<uint8_t> downloaded;
+    int sinkCalls = 0;
+    auto sink = [&](const uint8_t* data, size_t length) {
+      EXPECT_EQ(std::this_thread::get_id(), callingThread);
+      EXPECT_LE(length, static_cast<size_t>(64_KB));
+      if (++sinkCalls == 1)
+      {
+        // A slow sink, the next chunks are downloaded meanwhile.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      }
+      downloaded.insert(downloaded.end(), data, data + length);
+    };
+    auto downloadResult = blockBlobClient.DownloadTo(sink, downloadOptions);
+    EXPECT_EQ(downloaded, content);
+    EXPECT_EQ(sinkCalls, 17);
+    EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Offset, 0);
+    EXPECT_EQ(
+        downloadResult.Value.ContentRange.Length.Value(), static_cast<int64_t>(content.size()));
+
+    downloadOptions.Range = Core::Http::HttpRange();
+    downloadOptions.Range.Value().Offset = 100_KB;
+    downloadOptions.Range.Value().Length = 300_KB;
+    downloaded.clear();
+    downloadResult = blockBlobClient.DownloadTo(sink, downloadOptions);
+    EXPECT_EQ(
+        downloaded, std::vector<uint8_t>(content.begin() + 100_KB, content.begin() + 400_KB));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Offset, 100_KB);
+    EXPECT_EQ(downloadResult.Value.ContentRange.Length.Value(), 300_KB);
+
+    // The download stops when the sink throws.
+    downloadOptions.Range.Reset();
+    sinkCalls = 0;
+    EXPECT_THROW(
+        blockBlobClient.DownloadTo(
+            [&sinkCalls](const uint8_t*, size_t) {
+              if (++sinkCalls == 3)
+              {
+                throw std::runtime_error("The sink failed.");
+              }
+            },
+            downloadOptions),
+        std::runtime_error);
+    EXPECT_EQ(sinkCalls, 3);
+  }
+
+  TEST(ConcurrentDownloadTest, PassesChunksUnordered)
+  {
+    auto state = std::make_shared<MockBlockContentTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockContentTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    const auto content = RandomBuffer(static_cast<size_t>(1_MB + 123));
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 0;
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+
+    Blobs::DownloadBlobConcurrentlyOptions downloadOptions;
+    downloadOptions.ChunkSize = 64_KB;
+    downloadOptions.Concurrency = 4;
+    std::mutex downloadedMutex;
+    std::vector<uint8_t> downloaded;
+    int chunkCalls = 0;
+    auto onChunk = [&](int64_t offset, const uint8_t* data, size_t length) {
+      EXPECT_LE(length, static_cast<size_t>(64_KB));
+      std::lock_guard<std::mutex> guard(downloadedMutex);
+      ++chunkCalls;
+      const auto position = static_cast<size_t>(offset);
+      if (downloaded.size() < position + length)
+      {
+        downloaded.resize(position + length);
+      }
+      std::copy(data, data + length, downloaded.begin() + position);
+    };
+    auto downloadResult = blockBlobClient.DownloadConcurrently(onChunk, downloadOptions);
+    EXPECT_EQ(downloaded, content);
+    EXPECT_EQ(chunkCalls, 17);
+    EXPECT_EQ(state->RangeDownloads, 17);
+    EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Offset, 0);
+    EXPECT_EQ(
+        downloadResult.Value.ContentRange.Length.Value(), static_cast<int64_t>(content.size()));
+
+    downloadOptions.Range = Core::Http::HttpRange();
+    downloadOptions.Range.Value().Offset = 100_KB;
+    downloadOptions.Range.Value().Length = 300_KB;
+    downloaded.clear();
+    downloadResult = blockBlobClient.DownloadConcurrently(onChunk, downloadOptions);
+    EXPECT_EQ(
+        std::vector<uint8_t>(downloaded.begin() + 100_KB, downloaded.end()),
+        std::vector<uint8_t>(content.begin() + 100_KB, content.begin() + 400_KB));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Offset, 100_KB);
+    EXPECT_EQ(downloadResult.Value.ContentRange.Length.Value(), 300_KB);
+
+    // The download stops when the handler throws.
+    downloadOptions.Range.Reset();
+    EXPECT_THROW(
+        blockBlobClient.DownloadConcurrently(
+            [](int64_t, const uint8_t*, size_t) {
+              throw std::runtime_error("The handler failed.");
+            },
+            downloadOptions),
+        std::runtime_error);
+  }
+
+  namespace {
+    // Wraps keys with a XOR, and counts the keys it wraps and unwraps.
+    class MockKeyEncryptionKey final : public Blobs::KeyEncryptionKey {
+    public:
+      explicit MockKeyEncryptionKey(std::string keyId) : m_keyId(std::move(keyId)) {}
+
+      std::string GetKeyId() const override { return m_keyId; }
+
+      std::vector<uint8_t> WrapKey(
+          const std::string& algorithm,
+          const std::vector<uint8_t>& key,
+          const Core::Context&) const override
+      {
+        EXPECT_EQ(algorithm, "XOR");
+        ++WrapCount;
+        return Xor(key);
+      }
+
+      std::vector<uint8_t> UnwrapKey(
+          const std::string& algorithm,
+          const std::vector<uint8_t>& wrappedKey,
+          const Core::Context&) const override
+      {
+        EXPECT_EQ(algorithm, "XOR");
+        ++UnwrapCount;
+        return Xor(wrappedKey);
+      }
+
+      mutable std::atomic<int> WrapCount{0};
+      mutable std::atomic<int> UnwrapCount{0};
+
+    private:
+      static std::vector<uint8_t> Xor(std::vector<uint8_t> key)
+      {
+        for (auto& b : key)
+        {
+          b ^= 0x5a;
+        }
+        return key;
+      }
+
+      std::string m_keyId;
+    };
+  } // namespace
+
+  TEST(ClientSideEncryptionTest, EncryptsRegions)
+  {
+    auto state = std::make_shared<MockBlockContentTransportPolicy::State>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockBlockContentTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    auto keyEncryptionKey = std::make_shared<MockKeyEncryptionKey>("key1");
+    auto encryption = std::make_shared<Blobs::BlobClientSideEncryption>(keyEncryptionKey, "XOR");
+    const std::vector<uint8_t> content = RandomBuffer(9_MB + 100_KB);
+
+    // The chunks are rounded up to whole regions of 4 MiB.
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.ClientSideEncryption = encryption;
+    uploadOptions.TransferOptions.ChunkSize = 1_MB;
+    uploadOptions.TransferOptions.Concurrency = 4;
+    uploadOptions.Metadata["key"] = "value";
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+    EXPECT_EQ(state->CommittedBlocks.size(), 3U);
+    EXPECT_EQ(state->Content.length(), content.size() + 3 * 28);
+    EXPECT_NE(state->Metadata["encryptiondata"].find("\"AES_GCM_256\""), std::string::npos);
+    EXPECT_EQ(state->Metadata["key"], "value");
+    EXPECT_NE(
+        state->Content.substr(12, 1_KB),
+        std::string(content.begin(), content.begin() + 1_KB));
+    // The content key is wrapped once for all the uploads.
+    blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions);
+    EXPECT_EQ(keyEncryptionKey->WrapCount, 1);
+
+    Blobs::DownloadBlobToOptions downloadOptions;
+    downloadOptions.ClientSideEncryption = encryption;
+    downloadOptions.TransferOptions.Concurrency = 4;
+    std::vector<uint8_t> downloaded(content.size());
+    auto downloadResult
+        = blockBlobClient.DownloadTo(downloaded.data(), downloaded.size(), downloadOptions);
+    EXPECT_EQ(downloaded, content);
+    EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Length.Value(), downloadResult.Value.BlobSize);
+    EXPECT_EQ(downloadResult.Value.Details.Metadata.at("key"), "value");
+    std::vector<uint8_t> smallBuffer(content.size() - 1);
+    EXPECT_THROW(
+        blockBlobClient.DownloadTo(smallBuffer.data(), smallBuffer.size(), downloadOptions),
+        Azure::Core::RequestFailedException);
+
+    // A range across regions downloads only the regions it overlaps.
+    downloadOptions.Range = Core::Http::HttpRange();
+    downloadOptions.Range.Value().Offset = 4_MB - 10;
+    downloadOptions.Range.Value().Length = 100;
+    state->RangeDownloads = 0;
+    downloadResult
+        = blockBlobClient.DownloadTo(downloaded.data(), downloaded.size(), downloadOptions);
+    EXPECT_EQ(
+        std::vector<uint8_t>(downloaded.begin(), downloaded.begin() + 100),
+        std::vector<uint8_t>(content.begin() + 4_MB - 10, content.begin() + 4_MB + 90));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Offset, static_cast<int64_t>(4_MB - 10));
+    EXPECT_EQ(downloadResult.Value.ContentRange.Length.Value(), 100);
+    EXPECT_EQ(state->RangeDownloads, 2);
+    downloadOptions.Range.Reset();
+    // The content key is unwrapped once for all the downloads.
+    EXPECT_EQ(keyEncryptionKey->UnwrapCount, 1);
+
+    const std::string fileName = RandomString(10);
+    blockBlobClient.DownloadTo(fileName, downloadOptions);
+    EXPECT_EQ(ReadFile(fileName), content);
+    DeleteFile(fileName);
+
+    // Without the encryption, the encrypted content is downloaded as is.
+    std::vector<uint8_t> encrypted(state->Content.length());
+    downloadResult = blockBlobClient.DownloadTo(encrypted.data(), encrypted.size());
+    EXPECT_EQ(downloadResult.Value.BlobSize, static_cast<int64_t>(state->Content.length()));
+
+    // A region that doesn't match its tag fails the download.
+    state->Content[5_MB] = static_cast<char>(state->Content[5_MB] ^ 1);
+    EXPECT_THROW(
+        blockBlobClient.DownloadTo(downloaded.data(), downloaded.size(), downloadOptions),
+        Azure::Core::RequestFailedException);
+
+    // The blob can't be decrypted with another key encryption key.
+    downloadOptions.ClientSideEncryption = std::make_shared<Blobs::BlobClientSideEncryption>(
+        std::make_shared<MockKeyEncryptionKey>("key2"), "XOR");
+    EXPECT_THROW(
+        blockBlobClient.DownloadTo(downloaded.data(), downloaded.size(), downloadOptions),
+        std::runtime_error);
+
+    uploadOptions.CompressionCodec = Blobs::Models::BlobCompressionCodec::Gzip;
+    EXPECT_THROW(
+        blockBlobClient.UploadFrom(content.data(), content.size(), uploadOptions),
+        std::invalid_argument);
+  }
+
+  namespace {
+    // Encodes the values of an Avro object container file.
+    class AvroWriter final {
+    public:
+      void WriteLong(int64_t value)
+      {
+        uint64_t zigZag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        while (zigZag >= 0x80)
+        {
+          m_content.push_back(static_cast<char>((zigZag & 0x7f) | 0x80));
+          zigZag >>= 7;
+        }
+        m_content.push_back(static_cast<char>(zigZag));
+      }
+
+      void WriteString(const std::string& value)
+      {
+        WriteLong(static_cast<int64_t>(value.length()));
+        m_content += value;
+      }
+
+      void WriteRaw(const std::string& value) { m_content += value; }
+
+      const std::string& Content() const { return m_content; }
+
+    private:
+      std::string m_content;
+    };
+
+    // Builds the response of a query, in the format of the service: a union of result data,
+    // error, progress and end records, split in two blocks.
+    std::string BuildQueryResponse()
+    {
+      const std::string schema = R"([
+        {"type": "record", "name": "com.microsoft.azure.storage.queryBlobContents.resultData",
+         "fields": [{"name": "data", "type": "bytes"}]},
+        {"type": "record", "name": "com.microsoft.azure.storage.queryBlobContents.error",
+         "fields": [{"name": "fatal", "type": "boolean"}, {"name": "name", "type": "string"},
+                    {"name": "description", "type": "string"},
+                    {"name": "position", "type": "long"}]},
+        {"type": "record", "name": "com.microsoft.azure.storage.queryBlobContents.progress",
+         "fields": [{"name": "bytesScanned", "type": "long"},
+                    {"name": "totalBytes", "type": "long"}]},
+        {"type": "record", "name": "com.microsoft.azure.storage.queryBlobContents.end",
+         "fields": [{"name": "totalBytes", "type": "long"}]}])";
+      const std::string syncMarker = "0123456789abcdef";
+      AvroWriter header;
+      header.WriteRaw(std::string("Obj\x01", 4));
+      header.WriteLong(2);
+      header.WriteString("avro.schema");
+      header.WriteString(schema);
+      header.WriteString("avro.codec");
+      header.WriteString("null");
+      header.WriteLong(0);
+      header.WriteRaw(syncMarker);
+
+      AvroWriter firstBlock;
+      firstBlock.WriteLong(0);
+      firstBlock.WriteString("1,a\n");
+      firstBlock.WriteLong(2);
+      firstBlock.WriteLong(50);
+      firstBlock.WriteLong(100);
+      firstBlock.WriteLong(1);
+      firstBlock.WriteRaw(std::string(1, '\0'));
+      firstBlock.WriteString("InvalidColumnOrdinal");
+      firstBlock.WriteString("Column ordinal out of range.");
+      firstBlock.WriteLong(60);
+      AvroWriter secondBlock;
+      secondBlock.WriteLong(0);
+      secondBlock.WriteString("3,c\n");
+      secondBlock.WriteLong(3);
+      secondBlock.WriteLong(100);
+
+      AvroWriter content;
+      content.WriteRaw(header.Content());
+      content.WriteLong(3);
+      content.WriteLong(static_cast<int64_t>(firstBlock.Content().length()));
+      content.WriteRaw(firstBlock.Content());
+      content.WriteRaw(syncMarker);
+      content.WriteLong(2);
+      content.WriteLong(static_cast<int64_t>(secondBlock.Content().length()));
+      content.WriteRaw(secondBlock.Content());
+      content.WriteRaw(syncMarker);
+      return content.Content();
+    }
+
+    // Answers the queries with an Avro response, and keeps the body of the last query request.
+    class MockQueryTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct State
+      {
+        std::mutex Mutex;
+        std::string Response;
+        std::string RequestBody;
+      };
+
+      explicit MockQueryTransportPolicy(std::shared_ptr<State> state) : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockQueryTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        std::lock_guard<std::mutex> guard(m_state->Mutex);
+        auto requestBody = request.GetBodyStream()->ReadToEnd(context);
+        m_state->RequestBody = std::string(requestBody.begin(), requestBody.end());
+        auto response
+            = std::make_unique<Core::Http::RawResponse>(1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        // The response outlives the stream, the tests read it before changing the state.
+        response->SetBodyStream(std::make_unique<Core::IO::MemoryBodyStream>(
+            reinterpret_cast<const uint8_t*>(m_state->Response.data()),
+            m_state->Response.length()));
+        response->SetHeader("etag", "\"etag\"");
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-server-encrypted", "true");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+  } // namespace
+
+  TEST(BlobQueryTest, DecodesAvroResponse)
+  {
+    auto state = std::make_shared<MockQueryTransportPolicy::State>();
+    state->Response = BuildQueryResponse();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockQueryTransportPolicy>(state));
+    Blobs::BlockBlobClient blockBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    Blobs::QueryBlobOptions queryOptions;
+    queryOptions.InputTextConfiguration
+        = Blobs::BlobQueryInputTextOptions::CreateCsvTextOptions("\n", ",", "\"", "\\", true);
+    queryOptions.OutputTextConfiguration
+        = Blobs::BlobQueryOutputTextOptions::CreateJsonTextOptions("\n");
+    std::vector<Blobs::Models::BlobQueryError> errors;
+    queryOptions.ErrorHandler
+        = [&errors](Blobs::Models::BlobQueryError error) { errors.push_back(std::move(error)); };
+    std::vector<std::pair<int64_t, int64_t>> progress;
+    queryOptions.ProgressHandler = [&progress](int64_t bytesScanned, int64_t totalBytes) {
+      progress.emplace_back(bytesScanned, totalBytes);
+    };
+    auto queryResult = blockBlobClient.Query("SELECT * from BlobStorage", queryOptions);
+    EXPECT_EQ(queryResult.Value.ETag, Azure::ETag("\"etag\""));
+    EXPECT_EQ(queryResult.Value.BodyStream->Length(), -1);
+    auto data = queryResult.Value.BodyStream->ReadToEnd();
+    EXPECT_EQ(std::string(data.begin(), data.end()), "1,a\n3,c\n");
+    ASSERT_EQ(errors.size(), 1U);
+    EXPECT_FALSE(errors[0].IsFatal);
+    EXPECT_EQ(errors[0].Name, "InvalidColumnOrdinal");
+    EXPECT_EQ(errors[0].Description, "Column ordinal out of range.");
+    EXPECT_EQ(errors[0].Position, 60);
+    ASSERT_EQ(progress.size(), 2U);
+    EXPECT_EQ(progress[0], std::make_pair(int64_t(50), int64_t(100)));
+    EXPECT_EQ(progress[1], std::make_pair(int64_t(100), int64_t(100)));
+
+    const auto& requestBody = state->RequestBody;
+    EXPECT_NE(
+        requestBody.find("<Expression>SELECT * from BlobStorage</Expression>"),
+        std::string::npos);
+    EXPECT_NE(requestBody.find("<HasHeaders>true</HasHeaders>"), std::string::npos);
+    EXPECT_NE(requestBody.find("<Type>json</Type>"), std::string::npos);
+
+    // Without an error handler, a fatal error fails the read.
+    std::string fatalResponse = state->Response;
+    const auto fatalOffset = fatalResponse.find(std::string(1, '\0') + "\x28InvalidColumnOrdinal");
+    ASSERT_NE(fatalOffset, std::string::npos);
+    fatalResponse[fatalOffset] = '\x01';
+    state->Response = fatalResponse;
+    auto failedResult = blockBlobClient.Query("SELECT * from BlobStorage");
+    EXPECT_THROW(failedResult.Value.BodyStream->ReadToEnd(), StorageException);
+  }
+
+  namespace {
+    // Encodes the events of a change feed chunk in an Avro object container file.
+    std::string BuildChangeFeedChunk(const std::vector<std::pair<std::string, std::string>>& events)
+    {
+      const std::string schema = R"(
+        {"type": "record", "name": "com.microsoft.azure.storage.blobChangeFeed.BlobChangeEvent",
+         "fields": [{"name": "topic", "type": "string"}, {"name": "subject", "type": "string"},
+                    {"name": "eventType", "type": "string"},
+                    {"name": "eventTime", "type": "string"}, {"name": "id", "type": "string"},
+                    {"name": "data", "type": {"type": "record", "name": "BlobChangeEventData",
+                     "fields": [{"name": "api", "type": "string"},
+                                {"name": "etag", "type": "string"},
+                                {"name": "contentLength", "type": "long"},
+                                {"name": "blobType", "type": "string"},
+                                {"name": "url", "type": "string"},
+                                {"name": "sequencer", "type": ["null", "string"]}]}}]})";
+      const std::string syncMarker = "0123456789abcdef";
+      AvroWriter block;
+      for (const auto& event : events)
+      {
+        block.WriteString("/subscriptions/sub/resourceGroups/rg/providers/"
+                          "Microsoft.Storage/storageAccounts/account");
+        block.WriteString("/blobServices/default/containers/container/blobs/" + event.first);
+        block.WriteString("BlobCreated");
+        block.WriteString(event.second);
+        block.WriteString(event.first + "-id");
+        block.WriteString("PutBlob");
+        block.WriteString("\"etag\"");
+        block.WriteLong(static_cast<int64_t>(event.first.length()));
+        block.WriteString("BlockBlob");
+        block.WriteString("https://account.blob.core.windows.net/container/" + event.first);
+        block.WriteLong(0);
+      }
+
+      AvroWriter content;
+      content.WriteRaw(std::string("Obj\x01", 4));
+      content.WriteLong(2);
+      content.WriteString("avro.schema");
+      content.WriteString(schema);
+      content.WriteString("avro.codec");
+      content.WriteString("null");
+      content.WriteLong(0);
+      content.WriteRaw(syncMarker);
+      if (!events.empty())
+      {
+        content.WriteLong(static_cast<int64_t>(events.size()));
+        content.WriteLong(static_cast<int64_t>(block.Content().length()));
+        content.WriteRaw(block.Content());
+        content.WriteRaw(syncMarker);
+      }
+      return content.Content();
+    }
+
+    // Serves the blobs of the change feed container, which are listed and downloaded.
+    class MockChangeFeedTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct State
+      {
+        std::mutex Mutex;
+        std::map<std::string, std::string> Blobs;
+        // The bodies of the responses, which outlive their streams.
+        std::deque<std::string> Responses;
+      };
+
+      explicit MockChangeFeedTransportPolicy(std::shared_ptr<State> state)
+          : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockChangeFeedTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        std::lock_guard<std::mutex> guard(m_state->Mutex);
+        auto query = request.GetUrl().GetQueryParameters();
+        auto response
+            = std::make_unique<Core::Http::RawResponse>(1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        std::string body;
+        if (query["comp"] == "list")
+        {
+          const std::string prefix = Core::Url::Decode(query["prefix"]);
+          body = "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+                 "ServiceEndpoint=\"https://account.blob.core.windows.net/\" "
+                 "ContainerName=\"$blobchangefeed\"><Blobs>";
+          for (const auto& blob : m_state->Blobs)
+          {
+            if (blob.first.compare(0, prefix.length(), prefix) == 0)
+            {
+              body += "<Blob><Name>" + blob.first + "</Name><Properties /></Blob>";
+            }
+          }
+          body += "</Blobs><NextMarker /></EnumerationResults>";
+          response->SetHeader("content-type", "application/xml");
+        }
+        else
+        {
+          const std::string path = Core::Url::Decode(request.GetUrl().GetPath());
+          body = m_state->Blobs.at(path.substr(path.find('/') + 1));
+          response->SetHeader("x-ms-blob-type", "BlockBlob");
+          response->SetHeader("x-ms-server-encrypted", "true");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("etag", "\"etag\"");
+        }
+        response->SetHeader("content-length", std::to_string(body.length()));
+        // Like the transport policy, the responses of the requests buffering them are buffered.
+        if (request.ShouldBufferResponse())
+        {
+          response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+        }
+        else
+        {
+          m_state->Responses.push_back(std::move(body));
+          response->SetBodyStream(std::make_unique<Core::IO::MemoryBodyStream>(
+              reinterpret_cast<const uint8_t*>(m_state->Responses.back().data()),
+              m_state->Responses.back().length()));
+        }
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+  } // namespace
+
+  TEST(BlobChangeFeedTest, ReadsShardsAndResumes)
+  {
+    auto state = std::make_shared<MockChangeFeedTransportPolicy::State>();
+    state->Blobs["meta/segments.json"] = R"({"lastConsumable": "2020-05-04T20:00:00.000Z"})";
+    state->Blobs["idx/segments/2020/05/04/1800/meta.json"] = R"({"status": "Finalized",
+        "chunkFilePaths": ["$blobchangefeed/log/00/2020/05/04/1800/",
+                           "$blobchangefeed/log/01/2020/05/04/1800/"]})";
+    state->Blobs["idx/segments/2020/05/04/1900/meta.json"] = R"({"status": "Published",
+        "chunkFilePaths": ["$blobchangefeed/log/00/2020/05/04/1900/"]})";
+    state->Blobs["idx/segments/2020/05/04/2000/meta.json"] = R"({"status": "Published",
+        "chunkFilePaths": ["$blobchangefeed/log/00/2020/05/04/2000/"]})";
+    state->Blobs["log/00/2020/05/04/1800/00000.avro"] = BuildChangeFeedChunk(
+        {{"a", "2020-05-04T18:01:00.0000000Z"}, {"b", "2020-05-04T18:02:00.0000000Z"}});
+    state->Blobs["log/00/2020/05/04/1800/00001.avro"]
+        = BuildChangeFeedChunk({{"c", "2020-05-04T18:03:00.0000000Z"}});
+    state->Blobs["log/01/2020/05/04/1800/00000.avro"]
+        = BuildChangeFeedChunk({{"d", "2020-05-04T18:04:00.0000000Z"}});
+    state->Blobs["log/00/2020/05/04/1900/00000.avro"]
+        = BuildChangeFeedChunk({{"e", "2020-05-04T19:01:00.0000000Z"}});
+    state->Blobs["log/00/2020/05/04/2000/00000.avro"]
+        = BuildChangeFeedChunk({{"f", "2020-05-04T20:01:00.0000000Z"}});
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockChangeFeedTransportPolicy>(state));
+    Blobs::BlobChangeFeedClient changeFeedClient(
+        Blobs::BlobServiceClient("https://account.blob.core.windows.net/", clientOptions));
+
+    std::mutex pagesMutex;
+    std::vector<std::pair<std::vector<std::string>, std::string>> pages;
+    auto onEvents = [&](std::vector<Blobs::Models::BlobChangeFeedEvent> events,
+                        const std::string& cursor) {
+      std::vector<std::string> subjects;
+      for (const auto& event : events)
+      {
+        subjects.push_back(event.Subject.substr(event.Subject.rfind('/') + 1));
+      }
+      std::lock_guard<std::mutex> guard(pagesMutex);
+      pages.emplace_back(std::move(subjects), cursor);
+    };
+    auto readSubjects = [&](const Blobs::ReadBlobChangeFeedOptions& options) {
+      pages.clear();
+      const std::string cursor = changeFeedClient.ReadEvents(onEvents, options);
+      std::vector<std::string> subjects;
+      for (const auto& page : pages)
+      {
+        subjects.insert(subjects.end(), page.first.begin(), page.first.end());
+      }
+      std::sort(subjects.begin(), subjects.end());
+      return std::make_pair(subjects, cursor);
+    };
+
+    // The segments from the last consumable one aren't read yet.
+    const auto firstRead = readSubjects(Blobs::ReadBlobChangeFeedOptions());
+    EXPECT_EQ(firstRead.first, std::vector<std::string>({"a", "b", "c", "d", "e"}));
+    std::vector<Blobs::Models::BlobChangeFeedEvent> events;
+    changeFeedClient.ReadEvents(
+        [&](std::vector<Blobs::Models::BlobChangeFeedEvent> page, const std::string&) {
+          std::lock_guard<std::mutex> guard(pagesMutex);
+          events.insert(events.end(), page.begin(), page.end());
+        });
+    auto event = std::find_if(events.begin(), events.end(), [](const auto& e) {
+      return e.Id == "c-id";
+    });
+    ASSERT_NE(event, events.end());
+    EXPECT_EQ(event->EventType, "BlobCreated");
+    EXPECT_EQ(
+        event->EventTime,
+        Azure::DateTime::Parse("2020-05-04T18:03:00Z", Azure::DateTime::DateFormat::Rfc3339));
+    EXPECT_EQ(event->Data.Api, "PutBlob");
+    EXPECT_EQ(event->Data.ETag, Azure::ETag("\"etag\""));
+    EXPECT_EQ(event->Data.ContentLength, 1);
+    EXPECT_EQ(event->Data.BlobType, Blobs::Models::BlobType::BlockBlob);
+    EXPECT_EQ(event->Data.Url, "https://account.blob.core.windows.net/container/c");
+    EXPECT_TRUE(event->Data.Sequencer.empty());
+
+    // The finalized segment is skipped, the one still published is read again from the cursor.
+    state->Blobs["log/00/2020/05/04/1900/00000.avro"] = BuildChangeFeedChunk(
+        {{"e", "2020-05-04T19:01:00.0000000Z"}, {"g", "2020-05-04T19:02:00.0000000Z"}});
+    Blobs::ReadBlobChangeFeedOptions resumeOptions;
+    resumeOptions.Cursor = firstRead.second;
+    EXPECT_EQ(readSubjects(resumeOptions).first, std::vector<std::string>({"g"}));
+
+    // A read interrupted after a page resumes after its events.
+    readSubjects(Blobs::ReadBlobChangeFeedOptions());
+    auto firstPage = std::find_if(pages.begin(), pages.end(), [](const auto& page) {
+      return page.first == std::vector<std::string>({"a", "b"});
+    });
+    ASSERT_NE(firstPage, pages.end());
+    resumeOptions.Cursor = firstPage->second;
+    const auto resumedRead = readSubjects(resumeOptions).first;
+    EXPECT_EQ(std::count(resumedRead.begin(), resumedRead.end(), "a"), 0);
+    EXPECT_EQ(std::count(resumedRead.begin(), resumedRead.end(), "b"), 0);
+    EXPECT_EQ(std::count(resumedRead.begin(), resumedRead.end(), "c"), 1);
+    EXPECT_EQ(std::count(resumedRead.begin(), resumedRead.end(), "g"), 1);
+
+    // The events are filtered by time.
+    Blobs::ReadBlobChangeFeedOptions timeOptions;
+    timeOptions.StartsOn
+        = Azure::DateTime::Parse("2020-05-04T18:02:30Z", Azure::DateTime::DateFormat::Rfc3339);
+    timeOptions.EndsOn
+        = Azure::DateTime::Parse("2020-05-04T19:00:00Z", Azure::DateTime::DateFormat::Rfc3339);
+    EXPECT_EQ(readSubjects(timeOptions).first, std::vector<std::string>({"c", "d"}));
+
+    resumeOptions.Cursor = "{\"version\": 2}";
+    EXPECT_THROW(changeFeedClient.ReadEvents(onEvents, resumeOptions), std::invalid_argument);
+    resumeOptions.Cursor = "cursor";
+    EXPECT_THROW(changeFeedClient.ReadEvents(onEvents, resumeOptions), std::invalid_argument);
+  }
+
   std::shared_ptr<Azure::Storage::Blobs::BlockBlobClient> BlockBlobClientTest::m_blockBlobClient;
   std::string BlockBlobClientTest::m_blobName;
   Azure::Storage::Blobs::UploadBlockBlobOptions BlockBlobClientTest::m_blobUploadOptions;
@@ -260,6 +1912,228 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST_F(BlockBlobClientTest, DownloadToValidateCrc64)
+  {
+    const std::vector<uint8_t> blobContent = RandomBuffer(static_cast<size_t>(9_MB + 3));
+    auto blobClient = m_blobContainerClient->GetBlockBlobClient(RandomString());
+    blobClient.UploadFrom(blobContent.data(), blobContent.size());
+
+    Blobs::DownloadBlobToOptions options;
+    options.ValidateContentCrc64 = true;
+    options.TransferOptions.InitialChunkSize = 8_MB;
+    options.TransferOptions.ChunkSize = 1_MB + 1;
+
+    auto expectedCrc64 = [&](size_t offset, size_t length) {
+      return Crc64Hash().Final(blobContent.data() + offset, length);
+    };
+
+    std::vector<uint8_t> downloadBuffer(blobContent.size());
+    auto res = blobClient.DownloadTo(downloadBuffer.data(), downloadBuffer.size(), options);
+    EXPECT_EQ(downloadBuffer, blobContent);
+    ASSERT_TRUE(res.Value.TransactionalContentHash.HasValue());
+    EXPECT_EQ(res.Value.TransactionalContentHash.Value().Algorithm, HashAlgorithm::Crc64);
+    EXPECT_EQ(
+        res.Value.TransactionalContentHash.Value().Value, expectedCrc64(0, blobContent.size()));
+
+    options.Range = Azure::Core::Http::HttpRange();
+    options.Range.Value().Offset = 1_MB + 7;
+    options.Range.Value().Length = 5_MB;
+    std::string tempFilename = RandomString();
+    res = blobClient.DownloadTo(tempFilename, options);
+    EXPECT_EQ(
+        ReadFile(tempFilename),
+        std::vector<uint8_t>(
+            blobContent.begin() + static_cast<size_t>(1_MB + 7),
+            blobContent.begin() + static_cast<size_t>(6_MB + 7)));
+    ASSERT_TRUE(res.Value.TransactionalContentHash.HasValue());
+    EXPECT_EQ(
+        res.Value.TransactionalContentHash.Value().Value,
+        expectedCrc64(static_cast<size_t>(1_MB + 7), static_cast<size_t>(5_MB)));
+    DeleteFile(tempFilename);
+
+    auto emptyBlobClient = m_blobContainerClient->GetBlockBlobClient(RandomString());
+    emptyBlobClient.UploadFrom(blobContent.data(), 0);
+    options.Range.Reset();
+    res = emptyBlobClient.DownloadTo(downloadBuffer.data(), 0, options);
+    EXPECT_EQ(res.Value.BlobSize, 0);
+    ASSERT_TRUE(res.Value.TransactionalContentHash.HasValue());
+    EXPECT_EQ(res.Value.TransactionalContentHash.Value().Value, Crc64Hash().Final());
+  }
+
+  TEST_F(BlockBlobClientTest, MemoryMappedFileTransfer)
+  {
+    const std::vector<uint8_t> blobContent = RandomBuffer(static_cast<size_t>(5_MB + 3));
+    const std::string uploadFilename = RandomString();
+    {
+      _internal::FileWriter fileWriter(uploadFilename);
+      fileWriter.Write(blobContent.data(), blobContent.size(), 0);
+    }
+    auto blobClient = m_blobContainerClient->GetBlockBlobClient(RandomString());
+
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 0;
+    uploadOptions.TransferOptions.ChunkSize = 1_MB;
+    uploadOptions.TransferOptions.MemoryMapFile = true;
+    blobClient.UploadFrom(uploadFilename, uploadOptions);
+    DeleteFile(uploadFilename);
+    EXPECT_EQ(blobClient.GetBlockList().Value.CommittedBlocks.size(), 6U);
+
+    Blobs::DownloadBlobToOptions downloadOptions;
+    downloadOptions.TransferOptions.InitialChunkSize = 1_MB;
+    downloadOptions.TransferOptions.ChunkSize = 1_MB + 1;
+    downloadOptions.TransferOptions.MemoryMapFile = true;
+    const std::string downloadFilename = RandomString();
+    auto res = blobClient.DownloadTo(downloadFilename, downloadOptions);
+    EXPECT_EQ(res.Value.BlobSize, static_cast<int64_t>(blobContent.size()));
+    EXPECT_EQ(ReadFile(downloadFilename), blobContent);
+
+    downloadOptions.Range = Azure::Core::Http::HttpRange();
+    downloadOptions.Range.Value().Offset = 3_MB;
+    res = blobClient.DownloadTo(downloadFilename, downloadOptions);
+    EXPECT_EQ(
+        ReadFile(downloadFilename),
+        std::vector<uint8_t>(
+            blobContent.begin() + static_cast<size_t>(3_MB), blobContent.end()));
+    DeleteFile(downloadFilename);
+  }
+
+  TEST_F(BlockBlobClientTest, UploadFromStream)
+  {
+    auto blobClient = m_blobContainerClient->GetBlockBlobClient(RandomString());
+    Blobs::UploadBlockBlobFromOptions options;
+    options.TransferOptions.ChunkSize = 1_MB;
+    options.TransferOptions.Concurrency = 3;
+    options.Metadata = {{"key", "value"}};
+
+    // Staged in blocks, the last one partial.
+    {
+      const std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(5_MB + 3));
+      ForwardOnlyBodyStream stream(content);
+      auto res = blobClient.UploadFromStream(stream, options);
+      EXPECT_TRUE(res.Value.ETag.HasValue());
+      EXPECT_EQ(blobClient.GetBlockList().Value.CommittedBlocks.size(), 6U);
+      EXPECT_EQ(blobClient.GetProperties().Value.Metadata, options.Metadata);
+      EXPECT_EQ(blobClient.Download().Value.BodyStream->ReadToEnd(), content);
+    }
+    // A stream of a whole number of blocks.
+    {
+      const std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(2_MB));
+      ForwardOnlyBodyStream stream(content);
+      blobClient.UploadFromStream(stream, options);
+      EXPECT_EQ(blobClient.GetBlockList().Value.CommittedBlocks.size(), 2U);
+      EXPECT_EQ(blobClient.Download().Value.BodyStream->ReadToEnd(), content);
+    }
+    // Uploaded at once when the stream ends within the first block.
+    {
+      const std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(100_KB));
+      ForwardOnlyBodyStream stream(content);
+      blobClient.UploadFromStream(stream, options);
+      EXPECT_TRUE(blobClient.GetBlockList().Value.CommittedBlocks.empty());
+      EXPECT_EQ(blobClient.Download().Value.BodyStream->ReadToEnd(), content);
+    }
+    // An empty stream.
+    {
+      const std::vector<uint8_t> content;
+      ForwardOnlyBodyStream stream(content);
+      options.TransferOptions.SingleUploadThreshold = 0;
+      blobClient.UploadFromStream(stream, options);
+      EXPECT_EQ(blobClient.GetProperties().Value.BlobSize, 0);
+    }
+  }
+
+  TEST_F(BlockBlobClientTest, OpenRead)
+  {
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<size_t>(3_MB + 5));
+    auto blobClient = m_blobContainerClient->GetBlockBlobClient(RandomString());
+    blobClient.UploadFrom(content.data(), content.size());
+
+    Blobs::OpenReadOptions options;
+    options.TransferOptions.ChunkSize = 256_KB;
+    options.TransferOptions.Concurrency = 4;
+    {
+      auto stream = blobClient.OpenRead(options);
+      EXPECT_EQ(stream->Length(), static_cast<int64_t>(content.size()));
+      EXPECT_EQ(stream->ReadToEnd(), content);
+      EXPECT_EQ(stream->Position(), stream->Length());
+
+      // Reads after seeking backward and forward, within and out of the ranges read ahead.
+      std::vector<uint8_t> buffer(static_cast<size_t>(100_KB));
+      for (int64_t position : {int64_t(0), int64_t(2_MB + 7), int64_t(1_MB), int64_t(1_MB + 300)})
+      {
+        stream->Seek(position);
+        const size_t bytesRead = stream->ReadToCount(buffer.data(), buffer.size());
+        EXPECT_EQ(bytesRead, buffer.size());
+        EXPECT_TRUE(std::equal(
+            buffer.begin(), buffer.end(), content.begin() + static_cast<size_t>(position)));
+      }
+      stream->Rewind();
+      EXPECT_EQ(stream->ReadToEnd(), content);
+      EXPECT_THROW(stream->Seek(stream->Length() + 1), std::out_of_range);
+    }
+    // Reads of several ranges at once, with and without the cache.
+    for (int64_t cacheSize : {int64_t(0), int64_t(1_MB)})
+    {
+      options.CacheSize = cacheSize;
+      auto stream = blobClient.OpenRead(options);
+      std::vector<uint8_t> buffer(static_cast<size_t>(700_KB));
+      for (int64_t position : {int64_t(1_MB + 3), int64_t(5), int64_t(1_MB + 3), int64_t(200_KB)})
+      {
+        stream->Seek(position);
+        EXPECT_EQ(stream->ReadToCount(buffer.data(), buffer.size()), buffer.size());
+        EXPECT_TRUE(std::equal(
+            buffer.begin(), buffer.end(), content.begin() + static_cast<size_t>(position)));
+      }
+    }
+    {
+      options.Range = Core::Http::HttpRange();
+      options.Range.Value().Offset = 1_MB;
+      options.Range.Value().Length = 1_MB;
+      auto stream = blobClient.OpenRead(options);
+      EXPECT_EQ(
+          stream->ReadToEnd(),
+          std::vector<uint8_t>(
+              content.begin() + static_cast<size_t>(1_MB),
+              content.begin() + static_cast<size_t>(2_MB)));
+      options.Range.Reset();
+    }
+    // The reads fail once the blob is modified.
+    {
+      auto stream = blobClient.OpenRead(options);
+      blobClient.UploadFrom(content.data(), content.size());
+      EXPECT_THROW(stream->ReadToEnd(), StorageException);
+    }
+  }
+
+  TEST_F(BlockBlobClientTest, UnbufferedFileTransfer)
+  {
+    const std::vector<uint8_t> blobContent = RandomBuffer(static_cast<size_t>(5_MB + 3));
+    const std::string uploadFilename = RandomString();
+    {
+      _internal::FileWriter fileWriter(uploadFilename);
+      fileWriter.Write(blobContent.data(), blobContent.size(), 0);
+    }
+    auto blobClient = m_blobContainerClient->GetBlockBlobClient(RandomString());
+
+    Blobs::UploadBlockBlobFromOptions uploadOptions;
+    uploadOptions.TransferOptions.SingleUploadThreshold = 0;
+    uploadOptions.TransferOptions.ChunkSize = 1_MB;
+    uploadOptions.TransferOptions.UnbufferedIo = true;
+    blobClient.UploadFrom(uploadFilename, uploadOptions);
+    DeleteFile(uploadFilename);
+    EXPECT_EQ(blobClient.GetBlockList().Value.CommittedBlocks.size(), 6U);
+
+    // Chunks which don't start on an aligned offset.
+    Blobs::DownloadBlobToOptions downloadOptions;
+    downloadOptions.TransferOptions.InitialChunkSize = 1_MB - 1;
+    downloadOptions.TransferOptions.ChunkSize = 1_MB + 1;
+    downloadOptions.TransferOptions.UnbufferedIo = true;
+    const std::string downloadFilename = RandomString();
+    auto res = blobClient.DownloadTo(downloadFilename, downloadOptions);
+    EXPECT_EQ(res.Value.BlobSize, static_cast<int64_t>(blobContent.size()));
+    EXPECT_EQ(ReadFile(downloadFilename), blobContent);
+    DeleteFile(downloadFilename);
+  }
+
   TEST_F(BlockBlobClientTest, DISABLED_LastAccessTime)
   {
     {
@@ -346,6 +2220,32 @@ namespace Azure { namespace Storage { namespace Test {
     EXPECT_FALSE(blobItem.Details.IncrementalCopyDestinationSnapshot.HasValue());
   }
 
+  TEST_F(BlockBlobClientTest, CopyFromUriParallel)
+  {
+    const std::string blobName = RandomString();
+    auto blockBlobClient = m_blobContainerClient->GetBlockBlobClient(blobName);
+    Blobs::CopyBlobFromUriParallelOptions options;
+    options.TransferOptions.ChunkSize = 3_MB;
+    options.TransferOptions.Concurrency = 2;
+    options.Metadata = {{"key1", "value1"}};
+    auto res = blockBlobClient.CopyFromUriParallel(m_blockBlobClient->GetUrl() + GetSas(), options);
+    EXPECT_TRUE(res.Value.ETag.HasValue());
+    EXPECT_TRUE(IsValidTime(res.Value.LastModified));
+
+    auto blockList = blockBlobClient.GetBlockList().Value;
+    EXPECT_EQ(blockList.CommittedBlocks.size(), 3U);
+    EXPECT_EQ(blockBlobClient.GetProperties().Value.Metadata, options.Metadata);
+    auto downloadContent = blockBlobClient.Download().Value.BodyStream->ReadToEnd();
+    EXPECT_EQ(downloadContent, m_blobContent);
+
+    // The blocks can't be copied from a source which changed since its ETag was read.
+    options.SourceLength = static_cast<int64_t>(m_blobContent.size());
+    options.SourceAccessConditions.IfMatch = DummyETag;
+    EXPECT_THROW(
+        blockBlobClient.CopyFromUriParallel(m_blockBlobClient->GetUrl() + GetSas(), options),
+        StorageException);
+  }
+
   TEST_F(BlockBlobClientTest, AsyncCopyFromUri)
   {
     const std::string blobName = RandomString();
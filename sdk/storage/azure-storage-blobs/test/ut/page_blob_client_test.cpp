@@ -3,7 +3,11 @@
 
 #include "page_blob_client_test.hpp"
 
+#include <algorithm>
 #include <future>
+#include <map>
+#include <mutex>
+#include <set>
 #include <vector>
 
 #include <azure/core/cryptography/hash.hpp>
@@ -13,6 +17,195 @@
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // Serves a page blob whose content is blobContent, with the valid page ranges pageRanges, and
+    // keeps the ranges downloaded.
+    class MockSparseBlobTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockSparseBlobTransportPolicy(
+          std::shared_ptr<const std::vector<uint8_t>> blobContent,
+          std::string pageRanges,
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::vector<std::string>> downloadedRanges)
+          : m_blobContent(std::move(blobContent)), m_pageRanges(std::move(pageRanges)),
+            m_mutex(std::move(mutex)), m_downloadedRanges(std::move(downloadedRanges))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockSparseBlobTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        const std::string blobSize = std::to_string(m_blobContent->size());
+        auto headers = request.GetHeaders();
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetUrl().GetQueryParameters()["comp"] == "pagelist")
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetBody(std::vector<uint8_t>(m_pageRanges.begin(), m_pageRanges.end()));
+          response->SetHeader("x-ms-blob-content-length", blobSize);
+        }
+        else
+        {
+          EXPECT_EQ(headers.at("if-match"), DummyETag.ToString());
+          const std::string range = headers.at("x-ms-range");
+          {
+            std::lock_guard<std::mutex> guard(*m_mutex);
+            m_downloadedRanges->push_back(range);
+          }
+          const auto dashPosition = range.find('-');
+          const size_t start = std::stoull(range.substr(6, dashPosition - 6));
+          const size_t end = std::stoull(range.substr(dashPosition + 1));
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::PartialContent, "Partial Content");
+          response->SetBodyStream(std::make_unique<Core::IO::MemoryBodyStream>(
+              m_blobContent->data() + start, end - start + 1));
+          response->SetHeader("content-length", std::to_string(end - start + 1));
+          response->SetHeader(
+              "content-range",
+              "bytes " + std::to_string(start) + "-" + std::to_string(end) + "/" + blobSize);
+          response->SetHeader("x-ms-blob-type", "PageBlob");
+          response->SetHeader("x-ms-server-encrypted", "true");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<const std::vector<uint8_t>> m_blobContent;
+      std::string m_pageRanges;
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::vector<std::string>> m_downloadedRanges;
+    };
+
+    // Accepts the creation of a page blob and the uploads of its pages, and keeps their ranges and
+    // content.
+    class MockUploadPagesTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockUploadPagesTransportPolicy(
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::map<std::string, std::vector<uint8_t>>> uploadedPages)
+          : m_mutex(std::move(mutex)), m_uploadedPages(std::move(uploadedPages))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockUploadPagesTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        if (request.GetUrl().GetQueryParameters()["comp"] == "page")
+        {
+          auto content = request.GetBodyStream()->ReadToEnd(context);
+          std::lock_guard<std::mutex> guard(*m_mutex);
+          (*m_uploadedPages)[request.GetHeaders().at("x-ms-range")] = std::move(content);
+        }
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Created, "Created");
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-blob-sequence-number", "0");
+        response->SetHeader("x-ms-request-server-encrypted", "true");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::map<std::string, std::vector<uint8_t>>> m_uploadedPages;
+    };
+
+    // Serves a page blob whose content is blobContent, downloading its ranges and uploading its
+    // pages, and keeps the ranges uploaded and downloaded.
+    class MockPageBlobTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockPageBlobTransportPolicy(
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::vector<uint8_t>> blobContent,
+          std::shared_ptr<std::vector<std::string>> uploadedRanges,
+          std::shared_ptr<std::vector<std::string>> downloadedRanges)
+          : m_mutex(std::move(mutex)), m_blobContent(std::move(blobContent)),
+            m_uploadedRanges(std::move(uploadedRanges)),
+            m_downloadedRanges(std::move(downloadedRanges))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockPageBlobTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        const std::string range = request.GetHeaders().at("x-ms-range");
+        const auto dashPosition = range.find('-');
+        const size_t start = std::stoull(range.substr(6, dashPosition - 6));
+        const size_t end = std::stoull(range.substr(dashPosition + 1));
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetMethod() == Core::Http::HttpMethod::Put)
+        {
+          auto content = request.GetBodyStream()->ReadToEnd(context);
+          EXPECT_EQ(content.size(), end - start + 1);
+          std::lock_guard<std::mutex> guard(*m_mutex);
+          std::copy(content.begin(), content.end(), m_blobContent->begin() + start);
+          m_uploadedRanges->push_back(range);
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("x-ms-blob-sequence-number", "0");
+          response->SetHeader("x-ms-request-server-encrypted", "true");
+        }
+        else
+        {
+          std::lock_guard<std::mutex> guard(*m_mutex);
+          m_downloadedRanges->push_back(range);
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::PartialContent, "Partial Content");
+          response->SetBodyStream(std::make_unique<Core::IO::MemoryBodyStream>(
+              m_blobContent->data() + start, end - start + 1));
+          response->SetHeader("content-length", std::to_string(end - start + 1));
+          response->SetHeader(
+              "content-range",
+              "bytes " + std::to_string(start) + "-" + std::to_string(end) + "/"
+                  + std::to_string(m_blobContent->size()));
+          response->SetHeader("x-ms-blob-type", "PageBlob");
+          response->SetHeader("x-ms-server-encrypted", "true");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Blobs::_detail::ApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::vector<uint8_t>> m_blobContent;
+      std::shared_ptr<std::vector<std::string>> m_uploadedRanges;
+      std::shared_ptr<std::vector<std::string>> m_downloadedRanges;
+    };
+  } // namespace
+
   std::shared_ptr<Azure::Storage::Blobs::PageBlobClient> PageBlobClientTest::m_pageBlobClient;
   std::string PageBlobClientTest::m_blobName;
   Azure::Storage::Blobs::CreatePageBlobOptions PageBlobClientTest::m_blobUploadOptions;
@@ -164,6 +357,276 @@ namespace Azure { namespace Storage { namespace Test {
     EXPECT_EQ(static_cast<uint64_t>(clearRanges[0].Length.Value()), 1_KB);
   }
 
+  TEST(PageBlobUploadFromTest, SkipsZeroPages)
+  {
+    // The pages 0, 1, 3, 4, 5, 6 and 12 aren't zeros, in chunks of 4 pages.
+    std::vector<uint8_t> content(13 * 512, 0);
+    for (const size_t page : {0, 1, 3, 4, 5, 12})
+    {
+      RandomBuffer(content.data() + page * 512, 512);
+    }
+    content[7 * 512 - 1] = 1;
+    const std::string tempFilename = RandomString();
+    {
+      _internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+
+    for (const bool fromFile : {false, true})
+    {
+      auto mutex = std::make_shared<std::mutex>();
+      auto uploadedPages = std::make_shared<std::map<std::string, std::vector<uint8_t>>>();
+      Blobs::BlobClientOptions clientOptions;
+      clientOptions.PerRetryPolicies.emplace_back(
+          std::make_unique<MockUploadPagesTransportPolicy>(mutex, uploadedPages));
+      Blobs::PageBlobClient pageBlobClient(
+          "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+      Blobs::UploadPageBlobFromOptions options;
+      options.TransferOptions.ChunkSize = 2_KB;
+      options.TransferOptions.Concurrency = 2;
+      auto result = fromFile ? pageBlobClient.UploadFrom(tempFilename, options).Value
+                             : pageBlobClient.UploadFrom(content.data(), content.size(), options)
+                                   .Value;
+      EXPECT_EQ(result.UploadedSize, 3584);
+      EXPECT_TRUE(result.IsServerEncrypted);
+
+      ASSERT_EQ(uploadedPages->size(), 4U);
+      for (const auto& range : std::vector<std::pair<size_t, size_t>>{
+               {0, 1023}, {1536, 2047}, {2048, 3583}, {6144, 6655}})
+      {
+        const std::string rangeHeader
+            = "bytes=" + std::to_string(range.first) + "-" + std::to_string(range.second);
+        ASSERT_EQ(uploadedPages->count(rangeHeader), 1U);
+        EXPECT_EQ(
+            uploadedPages->at(rangeHeader),
+            std::vector<uint8_t>(
+                content.begin() + range.first, content.begin() + range.second + 1));
+      }
+
+      options.TransferOptions.ChunkSize = 1000;
+      EXPECT_THROW(
+          pageBlobClient.UploadFrom(content.data(), content.size(), options),
+          Azure::Core::RequestFailedException);
+    }
+    Blobs::PageBlobClient pageBlobClient("https://account.blob.core.windows.net/container/blob");
+    EXPECT_THROW(
+        pageBlobClient.UploadFrom(content.data(), content.size() - 1),
+        Azure::Core::RequestFailedException);
+    DeleteFile(tempFilename);
+  }
+
+  TEST(PageBlobWriterTest, CoalescesWrites)
+  {
+    auto mutex = std::make_shared<std::mutex>();
+    auto blobContent = std::make_shared<std::vector<uint8_t>>(RandomBuffer(16 * 1024));
+    auto uploadedRanges = std::make_shared<std::vector<std::string>>();
+    auto downloadedRanges = std::make_shared<std::vector<std::string>>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockPageBlobTransportPolicy>(
+        mutex, blobContent, uploadedRanges, downloadedRanges));
+    Blobs::PageBlobClient pageBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    std::vector<uint8_t> expectedContent = *blobContent;
+    Blobs::OpenWritePageBlobOptions options;
+    options.RangeSize = 2_KB;
+    {
+      auto writer = pageBlobClient.OpenWrite(options);
+      // Writes of 10 bytes from 100 to 4100, and an overwrite in the middle.
+      for (int64_t offset = 100; offset < 4100; offset += 10)
+      {
+        auto data = RandomBuffer(10);
+        writer->WriteAt(offset, data.data(), data.size());
+        std::copy(data.begin(), data.end(), expectedContent.begin() + offset);
+      }
+      auto data = RandomBuffer(100);
+      writer->WriteAt(2000, data.data(), data.size());
+      std::copy(data.begin(), data.end(), expectedContent.begin() + 2000);
+      EXPECT_TRUE(uploadedRanges->empty());
+
+      writer->Flush();
+      EXPECT_EQ(*blobContent, expectedContent);
+      EXPECT_EQ(
+          std::set<std::string>(uploadedRanges->begin(), uploadedRanges->end()),
+          std::set<std::string>({"bytes=0-2047", "bytes=2048-4095", "bytes=4096-4607"}));
+      EXPECT_EQ(
+          std::set<std::string>(downloadedRanges->begin(), downloadedRanges->end()),
+          std::set<std::string>({"bytes=0-99", "bytes=4100-4607"}));
+
+      // The data left is uploaded when the writer is destroyed.
+      uploadedRanges->clear();
+      data = RandomBuffer(512);
+      writer->WriteAt(8192, data.data(), data.size());
+      std::copy(data.begin(), data.end(), expectedContent.begin() + 8192);
+    }
+    EXPECT_EQ(*blobContent, expectedContent);
+    EXPECT_EQ(*uploadedRanges, std::vector<std::string>({"bytes=8192-8703"}));
+
+    options.RangeSize = 1000;
+    EXPECT_THROW(pageBlobClient.OpenWrite(options), Azure::Core::RequestFailedException);
+  }
+
+  TEST_F(PageBlobClientTest, OpenWrite)
+  {
+    auto pageBlobClient = Azure::Storage::Blobs::PageBlobClient::CreateFromConnectionString(
+        StandardStorageConnectionString(), m_containerName, RandomString());
+    std::vector<uint8_t> expectedContent(static_cast<size_t>(8_KB));
+    pageBlobClient.Create(expectedContent.size());
+
+    auto writer = pageBlobClient.OpenWrite();
+    for (size_t offset = 100; offset < 6000; offset += 100)
+    {
+      auto data = RandomBuffer(50);
+      writer->WriteAt(static_cast<int64_t>(offset), data.data(), data.size());
+      std::copy(data.begin(), data.end(), expectedContent.begin() + offset);
+    }
+    writer->Flush();
+    auto downloaded = pageBlobClient.Download().Value.BodyStream->ReadToEnd();
+    EXPECT_EQ(downloaded, expectedContent);
+  }
+
+  TEST_F(PageBlobClientTest, UploadFrom)
+  {
+    auto pageBlobClient = Azure::Storage::Blobs::PageBlobClient::CreateFromConnectionString(
+        StandardStorageConnectionString(), m_containerName, RandomString());
+    std::vector<uint8_t> content(static_cast<size_t>(8_MB + 4_KB), 0);
+    RandomBuffer(content.data() + 1_KB, 3_KB);
+    RandomBuffer(content.data() + 6_MB, 4_KB);
+
+    auto result = pageBlobClient.UploadFrom(content.data(), content.size()).Value;
+    EXPECT_EQ(result.UploadedSize, 7_KB);
+    std::vector<uint8_t> downloadContent(content.size());
+    pageBlobClient.DownloadTo(downloadContent.data(), downloadContent.size());
+    EXPECT_EQ(downloadContent, content);
+    auto pageRanges = pageBlobClient.GetPageRanges().PageRanges;
+    ASSERT_EQ(pageRanges.size(), 2U);
+    EXPECT_EQ(pageRanges[0].Offset, 1_KB);
+    EXPECT_EQ(pageRanges[1].Offset, 6_MB);
+  }
+
+  TEST(DownloadSparseToTest, DownloadsValidRanges)
+  {
+    auto blobContent = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(8_KB), 0);
+    RandomBuffer(blobContent->data() + 512, 1_KB);
+    RandomBuffer(blobContent->data() + 3_KB, 2_KB + 512);
+    const std::string pageRanges = "<?xml version=\"1.0\" encoding=\"utf-8\"?><PageList>"
+                                   "<PageRange><Start>512</Start><End>1535</End></PageRange>"
+                                   "<PageRange><Start>3072</Start><End>5631</End></PageRange>"
+                                   "</PageList>";
+    auto mutex = std::make_shared<std::mutex>();
+    auto downloadedRanges = std::make_shared<std::vector<std::string>>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockSparseBlobTransportPolicy>(
+        blobContent, pageRanges, mutex, downloadedRanges));
+    Blobs::PageBlobClient pageBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    const std::string tempFilename = RandomString();
+    Blobs::DownloadPageBlobSparseToOptions options;
+    options.TransferOptions.ChunkSize = 1_KB;
+    options.TransferOptions.Concurrency = 2;
+    auto result = pageBlobClient.DownloadSparseTo(tempFilename, options).Value;
+    EXPECT_EQ(result.ETag, DummyETag);
+    EXPECT_EQ(result.BlobSize, 8_KB);
+    EXPECT_EQ(result.DownloadedSize, 3_KB + 512);
+    EXPECT_EQ(ReadFile(tempFilename), *blobContent);
+    DeleteFile(tempFilename);
+
+    std::sort(downloadedRanges->begin(), downloadedRanges->end());
+    EXPECT_EQ(
+        *downloadedRanges,
+        std::vector<std::string>(
+            {"bytes=3072-4095", "bytes=4096-5119", "bytes=512-1535", "bytes=5120-5631"}));
+  }
+
+  TEST_F(PageBlobClientTest, DownloadSparseTo)
+  {
+    auto pageBlobClient = Azure::Storage::Blobs::PageBlobClient::CreateFromConnectionString(
+        StandardStorageConnectionString(), m_containerName, RandomString());
+    std::vector<uint8_t> blobContent(static_cast<size_t>(4_MB), 0);
+    pageBlobClient.Create(blobContent.size());
+    auto pageContent = RandomBuffer(static_cast<size_t>(8_KB));
+    std::copy(pageContent.begin(), pageContent.end(), blobContent.begin() + 1_MB);
+    auto pageStream = Azure::Core::IO::MemoryBodyStream(pageContent.data(), pageContent.size());
+    pageBlobClient.UploadPages(1_MB, pageStream);
+
+    const std::string tempFilename = RandomString();
+    auto result = pageBlobClient.DownloadSparseTo(tempFilename).Value;
+    EXPECT_EQ(result.BlobSize, static_cast<int64_t>(blobContent.size()));
+    EXPECT_EQ(result.DownloadedSize, 8_KB);
+    EXPECT_EQ(ReadFile(tempFilename), blobContent);
+    DeleteFile(tempFilename);
+  }
+
+  TEST(DownloadDiffToTest, AppliesChanges)
+  {
+    auto blobContent = std::make_shared<std::vector<uint8_t>>(RandomBuffer(8_KB));
+    std::fill(blobContent->begin() + 2_KB, blobContent->begin() + 3_KB, uint8_t(0));
+    const std::string pageRanges = "<?xml version=\"1.0\" encoding=\"utf-8\"?><PageList>"
+                                   "<PageRange><Start>512</Start><End>1535</End></PageRange>"
+                                   "<ClearRange><Start>2048</Start><End>3071</End></ClearRange>"
+                                   "<PageRange><Start>6144</Start><End>8191</End></PageRange>"
+                                   "</PageList>";
+    auto mutex = std::make_shared<std::mutex>();
+    auto downloadedRanges = std::make_shared<std::vector<std::string>>();
+    Blobs::BlobClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockSparseBlobTransportPolicy>(
+        blobContent, pageRanges, mutex, downloadedRanges));
+    Blobs::PageBlobClient pageBlobClient(
+        "https://account.blob.core.windows.net/container/blob", clientOptions);
+
+    // The copy of the previous snapshot differs from the blob only in the changed ranges, the blob
+    // was resized from 6 KiB.
+    const std::string tempFilename = RandomString();
+    std::vector<uint8_t> previousContent(blobContent->begin(), blobContent->begin() + 6_KB);
+    RandomBuffer(previousContent.data() + 512, 1_KB);
+    RandomBuffer(previousContent.data() + 2_KB, 1_KB);
+    {
+      _internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(previousContent.data(), previousContent.size(), 0);
+    }
+
+    auto result = pageBlobClient.DownloadDiffTo("snapshot", tempFilename).Value;
+    EXPECT_EQ(result.ETag, DummyETag);
+    EXPECT_EQ(result.BlobSize, 8_KB);
+    EXPECT_EQ(result.DownloadedSize, 3_KB);
+    EXPECT_EQ(result.ClearedSize, 1_KB);
+    EXPECT_EQ(ReadFile(tempFilename), *blobContent);
+    DeleteFile(tempFilename);
+
+    std::sort(downloadedRanges->begin(), downloadedRanges->end());
+    EXPECT_EQ(*downloadedRanges, std::vector<std::string>({"bytes=512-1535", "bytes=6144-8191"}));
+  }
+
+  TEST_F(PageBlobClientTest, DownloadDiffTo)
+  {
+    auto pageBlobClient = Azure::Storage::Blobs::PageBlobClient::CreateFromConnectionString(
+        StandardStorageConnectionString(), m_containerName, RandomString());
+    pageBlobClient.Create(64_KB);
+    auto pageContent = RandomBuffer(static_cast<size_t>(8_KB));
+    auto pageStream = Azure::Core::IO::MemoryBodyStream(pageContent.data(), pageContent.size());
+    pageBlobClient.UploadPages(0, pageStream);
+    const std::string snapshot = pageBlobClient.CreateSnapshot().Value.Snapshot;
+    const std::string tempFilename = RandomString();
+    pageBlobClient.WithSnapshot(snapshot).DownloadSparseTo(tempFilename);
+
+    pageStream.Rewind();
+    pageBlobClient.UploadPages(16_KB, pageStream);
+    Azure::Core::Http::HttpRange clearRange;
+    clearRange.Offset = 0;
+    clearRange.Length = 4_KB;
+    pageBlobClient.ClearPages(clearRange);
+
+    auto result = pageBlobClient.DownloadDiffTo(snapshot, tempFilename).Value;
+    EXPECT_EQ(result.DownloadedSize, 8_KB);
+    EXPECT_EQ(result.ClearedSize, 4_KB);
+    std::vector<uint8_t> blobContent(static_cast<size_t>(64_KB));
+    pageBlobClient.DownloadTo(blobContent.data(), blobContent.size());
+    EXPECT_EQ(ReadFile(tempFilename), blobContent);
+    DeleteFile(tempFilename);
+  }
+
   TEST_F(PageBlobClientTest, UploadFromUri)
   {
     auto pageBlobClient = Azure::Storage::Blobs::PageBlobClient::CreateFromConnectionString(
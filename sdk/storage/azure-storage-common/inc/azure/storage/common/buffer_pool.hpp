@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "azure/storage/common/transfer_affinity.hpp"
+
+namespace Azure { namespace Storage {
+
+  namespace _internal {
+    class PooledBuffer;
+  } // namespace _internal
+
+  /**
+   * @brief A pool of the buffers the storage clients transfer chunks through, such as the chunks
+   * of `DownloadTo()`, shared by all the transfers of the clients using it.
+   *
+   * @remark The buffers are reused by the next chunks once they are transferred, instead of being
+   * allocated for every chunk. The memory of all the buffers of the pool, used or not, is limited
+   * to MaxMemory(): a chunk which needs a buffer waits until others give theirs back, which slows
+   * the transfers down instead of growing the memory. A single buffer larger than MaxMemory() is
+   * only allocated when no other buffer is used. Up to MaxIdleMemory() of the buffers given back
+   * are kept for later chunks, the others are freed.
+   */
+  class BufferPool final {
+  public:
+    /**
+     * @brief Initializes a new instance of the BufferPool.
+     *
+     * @param maxMemory The maximum number of bytes of all the buffers of the pool.
+     * @param maxIdleMemory The maximum number of bytes of the buffers kept while nobody uses them.
+     *
+     * @throw std::invalid_argument if maxMemory is less than 1, or if maxIdleMemory is negative or
+     * greater than maxMemory.
+     */
+    explicit BufferPool(int64_t maxMemory, int64_t maxIdleMemory);
+
+    /**
+     * @brief Initializes a new instance of the BufferPool which allocates its buffers in the
+     * memory of the NUMA node of an affinity, such as the node of the network interface.
+     *
+     * @remark Huge pages make the transfers of large chunks cheaper for the CPU. They're
+     * transparent huge pages on Linux and large pages on Windows, where the process needs the
+     * privilege to lock pages in memory. The buffers are allocated with regular pages where huge
+     * pages can't be used.
+     *
+     * @param maxMemory The maximum number of bytes of all the buffers of the pool.
+     * @param maxIdleMemory The maximum number of bytes of the buffers kept while nobody uses them.
+     * @param affinity The NUMA node the buffers are allocated on.
+     * @param useHugePages Whether the buffers are allocated with huge pages.
+     *
+     * @throw std::invalid_argument if maxMemory is less than 1, or if maxIdleMemory is negative or
+     * greater than maxMemory.
+     */
+    explicit BufferPool(
+        int64_t maxMemory,
+        int64_t maxIdleMemory,
+        const TransferAffinity& affinity,
+        bool useHugePages);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Frees the buffers of the pool.
+     */
+    ~BufferPool();
+
+    /**
+     * @brief Gets the maximum number of bytes of all the buffers of the pool.
+     *
+     * @return The maximum number of bytes of all the buffers of the pool.
+     */
+    int64_t MaxMemory() const;
+
+    /**
+     * @brief Gets the maximum number of bytes of the buffers kept while nobody uses them.
+     *
+     * @return The maximum number of bytes of the idle buffers.
+     */
+    int64_t MaxIdleMemory() const;
+
+    /**
+     * @brief Gets the NUMA node the buffers of the pool are allocated on.
+     *
+     * @return The affinity of the buffers.
+     */
+    const TransferAffinity& Affinity() const;
+
+    /**
+     * @brief Gets whether the buffers of the pool are allocated with huge pages.
+     *
+     * @return true if the buffers are allocated with huge pages where possible.
+     */
+    bool UsesHugePages() const;
+
+    /**
+     * @brief Gets the pool used by the clients whose options don't have one, which is created the
+     * first time it is needed. It holds up to 1 GiB of buffers and keeps up to 64 MiB of them
+     * idle.
+     *
+     * @return The default pool.
+     */
+    static std::shared_ptr<BufferPool> GetDefault();
+
+  private:
+    struct State;
+
+    std::unique_ptr<State> m_state;
+
+    friend class _internal::PooledBuffer;
+  };
+
+}} // namespace Azure::Storage
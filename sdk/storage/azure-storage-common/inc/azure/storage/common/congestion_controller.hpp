@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Azure { namespace Storage {
+
+  namespace _internal {
+    class CongestionWindow;
+    class CongestionControlPolicy;
+  } // namespace _internal
+
+  /**
+   * @brief Limits the number of requests in flight to each storage account, for all the storage
+   * clients sharing it, such as the clients of all the services running in a process, and adjusts
+   * the limits from the throttling of the accounts.
+   *
+   * @remark The limit of an account is halved when the account throttles a request, with a 503
+   * Server Busy response, and it grows by one after a limit worth of requests aren't throttled.
+   * It isn't halved again for the requests sent before it was halved. The concurrent transfers
+   * of the clients wait for the limit of the account, so that they settle at the rate the
+   * account sustains instead of all retrying on their own. Every try of a request is counted,
+   * including the retries, and a request is counted until its response headers are received.
+   */
+  class CongestionController final {
+  public:
+    /**
+     * @brief Initializes a new instance of the CongestionController.
+     *
+     * @param maxConcurrency The largest limit of the requests in flight to an account, which is
+     * also the limit until the account throttles a request.
+     * @param minConcurrency The smallest limit of the requests in flight to an account.
+     *
+     * @throw std::invalid_argument if minConcurrency is less than 1 or greater than
+     * maxConcurrency.
+     */
+    explicit CongestionController(int32_t maxConcurrency = 64, int32_t minConcurrency = 1);
+
+    CongestionController(const CongestionController&) = delete;
+    CongestionController& operator=(const CongestionController&) = delete;
+
+    /**
+     * @brief Destructs the CongestionController.
+     */
+    ~CongestionController();
+
+    /**
+     * @brief Gets the current limit of the requests in flight to an account.
+     *
+     * @param host The host name of the account, such as `account.blob.core.windows.net`.
+     * @return The current limit of the account.
+     */
+    int32_t GetConcurrencyLimit(const std::string& host) const;
+
+  private:
+    _internal::CongestionWindow& GetWindow(const std::string& host) const;
+
+    int32_t m_maxConcurrency;
+    int32_t m_minConcurrency;
+    mutable std::mutex m_mutex;
+    // By host name, created the first time a host is requested.
+    mutable std::map<std::string, std::unique_ptr<_internal::CongestionWindow>> m_windows;
+
+    friend class _internal::CongestionControlPolicy;
+  };
+
+}} // namespace Azure::Storage
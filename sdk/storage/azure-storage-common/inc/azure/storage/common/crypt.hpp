@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "azure/core/cryptography/hash.hpp"
+#include "azure/core/internal/cryptography/hmac.hpp"
 #include <azure/core/base64.hpp>
 
 namespace Azure { namespace Storage {
@@ -40,6 +41,129 @@ namespace Azure { namespace Storage {
     std::vector<uint8_t> HmacSha256(
         const std::vector<uint8_t>& data,
         const std::vector<uint8_t>& key);
+
+    /**
+     * @brief Computes the HMAC-SHA256 of data with a key which is processed once, when it is
+     * constructed, instead of for each data.
+     *
+     * @remark #Sign can be called concurrently.
+     */
+    class HmacSha256Key final {
+    public:
+      /**
+       * @brief Constructs `%HmacSha256Key`.
+       *
+       * @param key The key of the HMAC.
+       */
+      explicit HmacSha256Key(const std::vector<uint8_t>& key);
+
+      HmacSha256Key(const HmacSha256Key&) = delete;
+      HmacSha256Key& operator=(const HmacSha256Key&) = delete;
+
+      /**
+       * @brief Computes the HMAC-SHA256 of data, same as #HmacSha256 with the key.
+       *
+       * @param data The data to compute the HMAC of.
+       * @param length The size of the data.
+       *
+       * @return The HMAC.
+       */
+      std::vector<uint8_t> Sign(const uint8_t* data, size_t length) const;
+
+      /**
+       * @brief Gets a copy of the HMAC right after the key was processed, to sign data which is
+       * appended in several parts.
+       *
+       * @return The HMAC, with no data appended.
+       */
+      Core::Cryptography::_internal::HmacSha256 GetKeyedHmac() const;
+
+    private:
+      Core::Cryptography::_internal::HmacSha256 m_hmac;
+    };
+
+    /**
+     * @brief Encrypts and decrypts data with AES-256 in GCM mode, with a key that is processed
+     * once, when it is constructed.
+     *
+     * @remark #Encrypt and #Decrypt can be called concurrently.
+     */
+    class AesGcmKey final {
+    public:
+      /**
+       * @brief The size of the key in bytes.
+       */
+      static constexpr size_t KeySize = 32;
+
+      /**
+       * @brief The size of a nonce in bytes.
+       */
+      static constexpr size_t NonceSize = 12;
+
+      /**
+       * @brief The size of an authentication tag in bytes.
+       */
+      static constexpr size_t TagSize = 16;
+
+      /**
+       * @brief Constructs `%AesGcmKey`.
+       *
+       * @param key The key, of KeySize bytes.
+       */
+      explicit AesGcmKey(const std::vector<uint8_t>& key);
+
+      AesGcmKey(const AesGcmKey&) = delete;
+      AesGcmKey& operator=(const AesGcmKey&) = delete;
+
+      ~AesGcmKey();
+
+      /**
+       * @brief Encrypts data.
+       *
+       * @param nonce The nonce, of NonceSize bytes, which must never be used twice with the key.
+       * @param data The data to encrypt.
+       * @param length The size of the data.
+       * @param ciphertext Receives the encrypted data, of the size of the data.
+       * @param tag Receives the authentication tag, of TagSize bytes.
+       */
+      void Encrypt(
+          const uint8_t* nonce,
+          const uint8_t* data,
+          size_t length,
+          uint8_t* ciphertext,
+          uint8_t* tag) const;
+
+      /**
+       * @brief Decrypts data and checks its authentication tag.
+       *
+       * @param nonce The nonce the data was encrypted with.
+       * @param ciphertext The encrypted data.
+       * @param length The size of the encrypted data.
+       * @param tag The authentication tag of the encrypted data.
+       * @param data Receives the decrypted data, of the size of the encrypted data.
+       *
+       * @return False if the authentication tag doesn't match, in which case the content of data
+       * must not be used.
+       */
+      bool Decrypt(
+          const uint8_t* nonce,
+          const uint8_t* ciphertext,
+          size_t length,
+          const uint8_t* tag,
+          uint8_t* data) const;
+
+    private:
+      std::vector<uint8_t> m_key;
+    };
+
+    /**
+     * @brief Fills a buffer with cryptographically secure random bytes.
+     *
+     * @param buffer The buffer to fill.
+     * @param length The size of the buffer.
+     */
+    void FillSecureRandomBytes(uint8_t* buffer, size_t length);
+
     std::string UrlEncodeQueryParameter(const std::string& value);
     std::string UrlEncodePath(const std::string& value);
   } // namespace _internal
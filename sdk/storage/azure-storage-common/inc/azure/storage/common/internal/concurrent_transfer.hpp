@@ -3,66 +3,99 @@
 
 #pragma once
 
-#include <algorithm>
-#include <atomic>
-#include <cstdlib>
+#include <chrono>
+#include <cstdint>
 #include <functional>
-#include <future>
-#include <stdexcept>
-#include <vector>
+#include <memory>
+
+#include <azure/core/context.hpp>
+
+#include "azure/storage/common/transfer_executor.hpp"
 
 namespace Azure { namespace Storage { namespace _internal {
 
-  inline void ConcurrentTransfer(
+  // The smallest chunks of a transfer whose chunk size is tuned.
+  constexpr int64_t AutoTuneMinChunkSize = 1 * 1024 * 1024;
+
+  struct ConcurrentTransferOptions final
+  {
+    // The size of the chunks, the largest size when AutoTune is true.
+    int64_t ChunkSize = 0;
+    // The number of chunks transferred at the same time, the largest number when AutoTune is true.
+    int Concurrency = 1;
+    // Tunes the chunk size, between MinChunkSize and ChunkSize, and the concurrency with a
+    // TransferTuner while the range is transferred.
+    bool AutoTune = false;
+    int64_t MinChunkSize = AutoTuneMinChunkSize;
+  };
+
+  // Tunes the chunk size and the concurrency of a transfer from its throughput, AIMD-style. The
+  // chunks are measured in rounds of as many chunks as the concurrency. Both values start small
+  // and grow, the concurrency by one and the chunk size twofold, after each round faster than the
+  // previous one. They are halved after a round much slower than the previous one, and they don't
+  // change while the throughput is stable.
+  class TransferTuner final {
+  public:
+    explicit TransferTuner(
+        int64_t minChunkSize,
+        int64_t maxChunkSize,
+        int maxConcurrency,
+        std::chrono::steady_clock::time_point start);
+
+    int64_t ChunkSize() const { return m_chunkSize; }
+    int Concurrency() const { return m_concurrency; }
+
+    void OnChunkTransferred(int64_t length, std::chrono::steady_clock::time_point now);
+
+  private:
+    int64_t m_minChunkSize;
+    int64_t m_maxChunkSize;
+    int m_maxConcurrency;
+    int64_t m_chunkSize;
+    int m_concurrency;
+    bool m_plateaued = false;
+
+    std::chrono::steady_clock::time_point m_roundStart;
+    int64_t m_roundLength = 0;
+    int m_roundChunks = 0;
+    // Bytes per second of the previous round, or zero before the first round is done.
+    double m_throughput = 0.0;
+  };
+
+  // Returns the context of an operation transferring data in chunks, such as UploadFrom() or
+  // DownloadTo(), whose requests are bulk unless the caller chose the traffic class of context.
+  // The interactive requests sent meanwhile go first.
+  Azure::Core::Context WithBulkTrafficClass(const Azure::Core::Context& context);
+
+  // Transfers the range in chunks. The calling thread transfers chunks too, the others are
+  // transferred on executor, or on the default executor if it's null. transferFunc is called with
+  // the offset, the length and the ID of each chunk, the IDs follow the order of the offsets. The
+  // first exception thrown by transferFunc is rethrown once all the started chunks are done.
+  // Returns the number of chunks.
+  int64_t ConcurrentTransfer(
       int64_t offset,
       int64_t length,
-      int64_t chunkSize,
+      const ConcurrentTransferOptions& options,
+      std::function<void(int64_t, int64_t, int64_t)> transferFunc,
+      const std::shared_ptr<TransferExecutor>& executor);
+
+  // Transfers chunks whose number isn't known upfront, such as the chunks read from a stream.
+  // nextChunkFunc is called by one thread at a time with the ID of the next chunk, in order, and
+  // returns the function transferring the chunk, or null once there are no chunks left. Up to
+  // concurrency chunks are prepared and transferred at the same time, the calling thread
+  // transfers chunks too. The function of a chunk is destroyed before its thread calls
+  // nextChunkFunc again, so that the memory it holds is bounded by the concurrency. The first
+  // exception thrown by nextChunkFunc or by the function of a chunk stops the transfer and is
+  // rethrown once all the started chunks are done. Returns the number of chunks.
+  int64_t ConcurrentStreamTransfer(
       int concurrency,
-      // offset, length, chunk ID, number of chunks
-      std::function<void(int64_t, int64_t, int64_t, int64_t)> transferFunc)
-  {
-    std::atomic<int> numWorkingThreads{concurrency};
-    std::atomic<int> nextChunkId{0};
-    std::atomic<bool> failed{false};
-
-    const auto numChunks = (length + chunkSize - 1) / chunkSize;
-
-    auto threadFunc = [&]() {
-      while (true)
-      {
-        int chunkId = nextChunkId.fetch_add(1);
-        if (chunkId >= numChunks || failed)
-        {
-          break;
-        }
-        int64_t chunkOffset = offset + chunkSize * chunkId;
-        int64_t chunkLength = std::min(length - chunkSize * chunkId, chunkSize);
-        try
-        {
-          transferFunc(chunkOffset, chunkLength, chunkId, numChunks);
-        }
-        catch (const std::exception&)
-        {
-          if (failed.exchange(true) == false)
-          {
-            numWorkingThreads.fetch_sub(1);
-            throw;
-          }
-        }
-      }
-      numWorkingThreads.fetch_sub(1);
-    };
-
-    std::vector<std::future<void>> threadHandles;
-    for (int i = 0; i < std::min<int64_t>(concurrency, numChunks) - 1; ++i)
-    {
-      threadHandles.emplace_back(std::async(std::launch::async, threadFunc));
-    }
-    threadFunc();
-    for (auto& handle : threadHandles)
-    {
-      handle.get();
-    }
-  }
+      std::function<std::function<void()>(int64_t)> nextChunkFunc,
+      const std::shared_ptr<TransferExecutor>& executor);
+
+  // Runs task in the background on executor, or on the default executor if it's null, counted as
+  // one of the chunks in flight of the executor. task must not throw.
+  void SubmitTransferTask(
+      const std::shared_ptr<TransferExecutor>& executor,
+      std::function<void()> task);
 
 }}} // namespace Azure::Storage::_internal
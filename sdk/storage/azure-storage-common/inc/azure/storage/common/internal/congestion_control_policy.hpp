@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <azure/core/context.hpp>
+#include <azure/core/http/policies/policy.hpp>
+
+#include "azure/storage/common/congestion_controller.hpp"
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  // An AIMD limit of the requests in flight to one host. The limit grows by 1/limit for each
+  // request not throttled, so by one for each limit worth of requests, and it is halved when a
+  // request is throttled. A throttled request sent before the last decrease doesn't decrease the
+  // limit again, the requests of the same round are throttled for the same reason.
+  class CongestionWindow final {
+  public:
+    enum class Outcome
+    {
+      // A response which isn't throttled, the limit grows.
+      Succeeded,
+      // A response throttled by the service, the limit is halved.
+      Throttled,
+      // No response, such as a connection error, the limit doesn't change.
+      Failed,
+    };
+
+    explicit CongestionWindow(int32_t minLimit, int32_t maxLimit);
+
+    // Waits until there are fewer requests in flight than the limit, and counts one more. A bulk
+    // request also waits while interactive requests are waiting, they go first. Throws if the
+    // context is cancelled while waiting. Returns when the request is sent.
+    std::chrono::steady_clock::time_point Acquire(const Azure::Core::Context& context);
+
+    // Counts one request fewer in flight, sent at sendTime.
+    void Release(Outcome outcome, std::chrono::steady_clock::time_point sendTime);
+
+    int32_t Limit() const;
+    int32_t InFlight() const;
+
+  private:
+    const double m_minLimit;
+    const double m_maxLimit;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_released;
+    double m_limit;
+    int32_t m_inFlight = 0;
+    int32_t m_waitingInteractive = 0;
+    std::chrono::steady_clock::time_point m_lastDecrease;
+  };
+
+  class CongestionControlPolicy final : public Core::Http::Policies::HttpPolicy {
+  public:
+    explicit CongestionControlPolicy(std::shared_ptr<CongestionController> congestionController)
+        : m_congestionController(std::move(congestionController))
+    {
+    }
+
+    ~CongestionControlPolicy() override {}
+
+    std::unique_ptr<HttpPolicy> Clone() const override
+    {
+      return std::make_unique<CongestionControlPolicy>(*this);
+    }
+
+    std::unique_ptr<Core::Http::RawResponse> Send(
+        Core::Http::Request& request,
+        Core::Http::Policies::NextHttpPolicy nextPolicy,
+        Core::Context const& context) const override;
+
+  private:
+    std::shared_ptr<CongestionController> m_congestionController;
+  };
+
+}}} // namespace Azure::Storage::_internal
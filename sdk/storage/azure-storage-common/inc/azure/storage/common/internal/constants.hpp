@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+
 namespace Azure { namespace Storage { namespace _internal {
   constexpr static const char* BlobServicePackageName = "storage-blobs";
   constexpr static const char* DatalakeServicePackageName = "storage-files-datalake";
@@ -16,7 +19,13 @@ namespace Azure { namespace Storage { namespace _internal {
   constexpr static const char* HttpHeaderRequestId = "x-ms-request-id";
   constexpr static const char* HttpHeaderClientRequestId = "x-ms-client-request-id";
   constexpr static const char* HttpHeaderContentType = "content-type";
+  constexpr static const char* HttpHeaderErrorCode = "x-ms-error-code";
   constexpr static const char* DefaultSasVersion = "2020-02-10";
 
   constexpr int ReliableStreamRetryCount = 3;
+  constexpr std::chrono::milliseconds ReliableStreamRetryDelay(800);
+  constexpr std::chrono::milliseconds ReliableStreamMaxRetryDelay(60 * 1000);
+  constexpr std::chrono::milliseconds ReliableStreamStallTimeout(30 * 1000);
+  constexpr int64_t ReliableStreamMinimumThroughput = 1024;
+  constexpr std::chrono::milliseconds ReliableStreamThroughputWindow(60 * 1000);
 }}} // namespace Azure::Storage::_internal
@@ -3,10 +3,17 @@
 
 #pragma once
 
+#include <azure/core/context.hpp>
+#include <azure/core/io/body_stream.hpp>
 #include <azure/core/platform.hpp>
 
+#include "azure/storage/common/buffer_pool.hpp"
+
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Azure { namespace Storage { namespace _internal {
 
@@ -16,9 +23,87 @@ namespace Azure { namespace Storage { namespace _internal {
   using FileHandle = int;
 #endif
 
+  enum class FileIoMode
+  {
+    Buffered,
+    // The file is mapped in memory when possible.
+    MemoryMapped,
+    // The file is read or written bypassing the page cache when possible, with O_DIRECT,
+    // F_NOCACHE or FILE_FLAG_NO_BUFFERING.
+    Unbuffered,
+  };
+
+  // The alignment of the offsets, the lengths and the buffers of unbuffered reads and writes.
+  constexpr size_t UnbufferedIoAlignment = 4096;
+
+  // A buffer aligned for unbuffered reads and writes.
+  class AlignedBuffer final {
+  public:
+    explicit AlignedBuffer(size_t size);
+
+    // Allocates the buffer on a NUMA node, or anywhere if numaNode is -1, and with huge pages,
+    // where possible. Falls back to a regular allocation.
+    explicit AlignedBuffer(size_t size, int numaNode, bool useHugePages);
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept { *this = std::move(other); }
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
+
+    ~AlignedBuffer() { Unmap(); }
+
+    uint8_t* Data() const { return m_data; }
+
+    size_t Size() const { return m_size; }
+
+  private:
+    void Unmap() noexcept;
+
+    std::unique_ptr<uint8_t[]> m_storage;
+    // The pages mapped for the buffer, instead of m_storage.
+    void* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+  };
+
+  // Positioned writes submitted to an io_uring of the calling thread on Linux, so that several
+  // writes cost a single system call, and a write continues in the background while the thread
+  // receives the next data. Each write gets an increasing ID.
+  class IoRing final {
+  public:
+    // The ring of the calling thread, or null where io_uring isn't available, such as on other
+    // platforms, on older kernels, or where it's disabled.
+    static IoRing* GetThreadRing();
+
+    // Waits for the writes in flight.
+    ~IoRing();
+
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    // Queues a write of the buffer, which must stay valid until the write is done, and returns its
+    // ID. The writes queued are submitted by Submit() or Wait().
+    uint64_t QueueWrite(FileHandle handle, const uint8_t* buffer, size_t length, int64_t offset);
+
+    // Submits the writes queued without waiting for them.
+    void Submit();
+
+    // Submits the writes queued and waits until the ones up to id are done, or all of them by
+    // default. Throws if one of them failed.
+    void Wait(uint64_t id = (std::numeric_limits<uint64_t>::max)());
+
+  private:
+    struct Ring;
+
+    explicit IoRing(std::unique_ptr<Ring> ring);
+
+    void Reap();
+
+    std::unique_ptr<Ring> m_ring;
+  };
+
   class FileReader final {
   public:
-    FileReader(const std::string& filename);
+    FileReader(const std::string& filename, FileIoMode mode = FileIoMode::Buffered);
 
     ~FileReader();
 
@@ -26,23 +111,114 @@ namespace Azure { namespace Storage { namespace _internal {
 
     int64_t GetFileSize() const { return m_fileSize; }
 
+    // The content of the file mapped in memory, or null if it isn't mapped, for example because
+    // it's empty. The file is read through the handle then.
+    const uint8_t* GetMappedData() const { return m_mappedData; }
+
+    // Whether the file can be read with ReadUnbuffered().
+    bool IsUnbuffered() const { return m_unbuffered; }
+
+    // Reads bypassing the page cache. The buffer, the length and the offset must be aligned to
+    // UnbufferedIoAlignment. Returns the number of bytes read, which is less than length only at
+    // the end of the file.
+    size_t ReadUnbuffered(uint8_t* buffer, size_t length, int64_t offset) const;
+
   private:
     FileHandle m_handle;
     int64_t m_fileSize;
+    const uint8_t* m_mappedData = nullptr;
+#if defined(AZ_PLATFORM_WINDOWS)
+    void* m_mappingHandle = nullptr;
+#endif
+    bool m_unbuffered = false;
+    FileHandle m_unbufferedHandle{};
   };
 
   class FileWriter final {
   public:
-    FileWriter(const std::string& filename);
+    // In MemoryMapped mode, the file is opened for reading too, so that it can be mapped in memory
+    // by Map(). An existing file is emptied, unless truncate is false.
+    FileWriter(
+        const std::string& filename,
+        FileIoMode mode = FileIoMode::Buffered,
+        bool truncate = true);
 
     ~FileWriter();
 
     FileHandle GetHandle() const { return m_handle; }
 
+    // In Unbuffered mode, the part of the data whose offset, length and address are aligned to
+    // UnbufferedIoAlignment is written bypassing the page cache, the rest is buffered.
     void Write(const uint8_t* buffer, size_t length, int64_t offset);
 
+    // Queues the writes of Write() to ring, without waiting for them. Returns the ID of the last
+    // write queued, which must be waited for before the buffer is reused, or 0 if there is
+    // nothing to write.
+    uint64_t QueueWrite(IoRing& ring, const uint8_t* buffer, size_t length, int64_t offset);
+
+    // Resizes the file to fileSize bytes, with the disk space allocated, and maps it in memory.
+    // Returns the mapped content of the file, or null if it can't be mapped, in which case the
+    // file must be written with Write(). Can only be called once.
+    uint8_t* Map(int64_t fileSize);
+
+    // Resizes the file to fileSize bytes without allocating the disk space, so that the parts of
+    // the file which are never written are holes reading as zeros, on file systems supporting
+    // sparse files.
+    void ResizeSparse(int64_t fileSize);
+
+    // Zeroes length bytes of the file from offset, deallocating their disk space where the file
+    // system supports it, or writing zeros otherwise.
+    void ZeroRange(int64_t offset, int64_t length);
+
   private:
     FileHandle m_handle;
+    FileIoMode m_mode;
+    uint8_t* m_mappedData = nullptr;
+    int64_t m_mappedSize = 0;
+#if defined(AZ_PLATFORM_WINDOWS)
+    void* m_mappingHandle = nullptr;
+#endif
+    bool m_unbuffered = false;
+    FileHandle m_unbufferedHandle{};
+  };
+
+  // Returns the paths of the regular files in directory and its subdirectories, relative to
+  // directory and separated by '/'. The files are in no particular order.
+  std::vector<std::string> ListFilesRecursively(const std::string& directory);
+
+  // Creates the directory at path, and its parents which don't exist yet.
+  void CreateDirectories(const std::string& path);
+
+  class PooledBuffer;
+
+  // Reads a range of a file opened in Unbuffered mode, through an aligned buffer taken from the
+  // pool, or from the default pool if null, on the first read.
+  class UnbufferedFileBodyStream final : public Azure::Core::IO::BodyStream {
+  public:
+    explicit UnbufferedFileBodyStream(
+        const FileReader& fileReader,
+        int64_t offset,
+        int64_t length,
+        std::shared_ptr<BufferPool> bufferPool = nullptr);
+
+    ~UnbufferedFileBodyStream() override;
+
+    int64_t Length() const override { return m_length; }
+
+    void Rewind() override { m_position = 0; }
+
+  private:
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+
+    const FileReader& m_fileReader;
+    int64_t m_offset;
+    int64_t m_length;
+    int64_t m_position = 0;
+    std::shared_ptr<BufferPool> m_bufferPool;
+    std::unique_ptr<PooledBuffer> m_buffer;
+    // The offset in the file of the data in m_buffer, and its length.
+    int64_t m_bufferOffset = 0;
+    size_t m_bufferLength = 0;
   };
 
 }}} // namespace Azure::Storage::_internal
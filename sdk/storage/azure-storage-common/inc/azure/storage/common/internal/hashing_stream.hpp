@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+
+#include <azure/core/context.hpp>
+#include <azure/core/cryptography/hash.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  /**
+   * @brief Decorates a body stream by appending the data read from it to a hash, so that the data
+   * is hashed while it is received instead of in a separate pass.
+   *
+   * @remark Data read again after Rewind() is not hashed again, the stream is expected to return
+   * the same content.
+   */
+  class HashingStream final : public Azure::Core::IO::BodyStream {
+  public:
+    /**
+     * @param inner The stream to read from, which must outlive this stream.
+     * @param hash The hash to append the data to, which must outlive this stream.
+     */
+    explicit HashingStream(
+        Azure::Core::IO::BodyStream& inner,
+        Azure::Core::Cryptography::Hash& hash)
+        : m_inner(inner), m_hash(hash)
+    {
+    }
+
+    HashingStream(const HashingStream&) = delete;
+    HashingStream& operator=(const HashingStream&) = delete;
+
+    int64_t Length() const override { return m_inner.Length(); }
+
+    void Rewind() override
+    {
+      m_inner.Rewind();
+      m_offset = 0;
+    }
+
+  private:
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+
+    Azure::Core::IO::BodyStream& m_inner;
+    Azure::Core::Cryptography::Hash& m_hash;
+    // The offset of the next read and the number of bytes appended to the hash so far.
+    int64_t m_offset = 0;
+    int64_t m_hashedLength = 0;
+  };
+
+}}} // namespace Azure::Storage::_internal
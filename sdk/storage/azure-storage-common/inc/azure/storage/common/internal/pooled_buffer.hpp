@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <azure/core/context.hpp>
+
+#include "azure/storage/common/buffer_pool.hpp"
+#include "azure/storage/common/internal/file_io.hpp"
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  // A buffer taken from a pool, which is given back when it is destroyed. The buffer is aligned to
+  // UnbufferedIoAlignment. A task shouldn't take a buffer while it holds another one from the same
+  // pool, it could wait for itself.
+  class PooledBuffer final {
+  public:
+    PooledBuffer() = default;
+
+    // Takes a buffer of at least size bytes from the pool, or from the default pool if null.
+    // Waits while the pool is full, throws if the context is cancelled then.
+    explicit PooledBuffer(
+        std::shared_ptr<BufferPool> pool,
+        size_t size,
+        const Azure::Core::Context& context);
+
+    // Takes a buffer like the constructor does, or returns an empty one instead of waiting while
+    // the pool is full.
+    static PooledBuffer TryTake(std::shared_ptr<BufferPool> pool, size_t size);
+
+    PooledBuffer(PooledBuffer&& other) noexcept { *this = std::move(other); }
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+
+    ~PooledBuffer() { Release(); }
+
+    uint8_t* Data() const { return m_buffer ? m_buffer->Data() : nullptr; }
+
+    // The requested size, the buffer may be larger.
+    size_t Size() const { return m_size; }
+
+  private:
+    void Release() noexcept;
+
+    std::shared_ptr<BufferPool> m_pool;
+    std::unique_ptr<AlignedBuffer> m_buffer;
+    size_t m_size = 0;
+  };
+
+}}} // namespace Azure::Storage::_internal
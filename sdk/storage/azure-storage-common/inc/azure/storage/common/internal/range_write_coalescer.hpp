@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <azure/core/context.hpp>
+
+#include "azure/storage/common/transfer_executor.hpp"
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  struct RangeWriteCoalescerOptions final
+  {
+    // The ranges uploaded start and end at multiples of Alignment, 1 for no alignment.
+    int64_t Alignment = 1;
+    // The largest range uploaded by a single request, a multiple of Alignment.
+    int64_t MaxRangeSize = 4 * 1024 * 1024;
+    // The number of ranges uploaded at the same time by a flush.
+    int Concurrency = 1;
+    // The writes flush the data buffered once it reaches this many bytes.
+    int64_t MaxBufferedSize = 16 * 1024 * 1024;
+  };
+
+  // Buffers the writes at random offsets of a blob or a file, merging the adjacent and
+  // overlapping ones, the latest data winning, and uploads them by ranges of up to MaxRangeSize
+  // bytes, concurrently. The bytes of an aligned range not written, at its unaligned edges or
+  // between writes sharing an aligned block, are read back from the service before it is
+  // uploaded. The flushes upload one after the other, so that a range written again while it is
+  // uploaded is uploaded again after it. The coalescer is thread-safe.
+  class RangeWriteCoalescer final {
+  public:
+    // Uploads length bytes of data at offset.
+    using UploadFunc
+        = std::function<void(int64_t, const uint8_t*, size_t, const Azure::Core::Context&)>;
+    // Reads length bytes at offset into data.
+    using ReadFunc = std::function<void(int64_t, uint8_t*, size_t, const Azure::Core::Context&)>;
+
+    // readFunc can be null when the alignment is 1, the ranges are then only made of data written.
+    // The ranges are uploaded on executor, or on the default executor if it's null.
+    explicit RangeWriteCoalescer(
+        const RangeWriteCoalescerOptions& options,
+        UploadFunc uploadFunc,
+        ReadFunc readFunc,
+        std::shared_ptr<TransferExecutor> executor);
+
+    // Copies the data into the buffer, and flushes the buffer once it's full. Throws the
+    // exception of a failed flush, the data isn't written then.
+    void WriteAt(
+        int64_t offset,
+        const uint8_t* data,
+        size_t length,
+        const Azure::Core::Context& context);
+
+    // Uploads the data written so far and waits for it. A failed flush fails all the following
+    // writes and flushes with the same exception.
+    void Flush(const Azure::Core::Context& context);
+
+    // The number of bytes written and not uploaded yet, not counting the ones being flushed.
+    int64_t BufferedSize() const;
+
+  private:
+    RangeWriteCoalescerOptions m_options;
+    UploadFunc m_uploadFunc;
+    ReadFunc m_readFunc;
+    std::shared_ptr<TransferExecutor> m_executor;
+
+    // Taken for the whole flush, so that the flushes don't overlap.
+    std::mutex m_flushMutex;
+    mutable std::mutex m_mutex;
+    // The data written, by offset. The extents neither overlap nor touch.
+    std::map<int64_t, std::vector<uint8_t>> m_extents;
+    int64_t m_bufferedSize = 0;
+    std::exception_ptr m_exception;
+  };
+
+}}} // namespace Azure::Storage::_internal
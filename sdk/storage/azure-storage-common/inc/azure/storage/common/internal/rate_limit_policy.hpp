@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <azure/core/context.hpp>
+#include <azure/core/http/policies/policy.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+#include "azure/storage/common/rate_limiter.hpp"
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  // A token bucket refilled at a constant rate, which holds up to one second worth of tokens. The
+  // tokens are taken even when there aren't enough of them, the bucket goes in debt and the next
+  // takers wait until the debt is paid back. That keeps the waits fair and lets a single request
+  // take more tokens than the bucket holds.
+  class TokenBucket final {
+  public:
+    explicit TokenBucket(int64_t tokensPerSecond);
+
+    // Takes the tokens and returns how long to wait before using them.
+    std::chrono::steady_clock::duration Take(
+        int64_t numTokens,
+        std::chrono::steady_clock::time_point now);
+
+    // Gives back tokens which were taken but not used.
+    void Return(int64_t numTokens);
+
+    // Takes the tokens and waits until they can be used. Throws if the context is cancelled while
+    // waiting, the tokens are returned then.
+    void Acquire(int64_t numTokens, const Azure::Core::Context& context);
+
+  private:
+    const double m_tokensPerSecond;
+    const double m_capacity;
+
+    std::mutex m_mutex;
+    double m_tokens;
+    std::chrono::steady_clock::time_point m_lastRefill;
+  };
+
+  // Takes tokens from a bucket for the bytes read from the stream, after they are read.
+  class RateLimitedBodyStream final : public Azure::Core::IO::BodyStream {
+  public:
+    explicit RateLimitedBodyStream(
+        std::unique_ptr<Azure::Core::IO::BodyStream> inner,
+        std::shared_ptr<TokenBucket> bytes)
+        : m_inner(std::move(inner)), m_bytes(std::move(bytes))
+    {
+    }
+
+    int64_t Length() const override { return m_inner->Length(); }
+
+    void Rewind() override { m_inner->Rewind(); }
+
+  private:
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+
+    std::unique_ptr<Azure::Core::IO::BodyStream> m_inner;
+    std::shared_ptr<TokenBucket> m_bytes;
+  };
+
+  class RateLimitPolicy final : public Core::Http::Policies::HttpPolicy {
+  public:
+    explicit RateLimitPolicy(std::shared_ptr<RateLimiter> rateLimiter)
+        : m_rateLimiter(std::move(rateLimiter))
+    {
+    }
+
+    ~RateLimitPolicy() override {}
+
+    std::unique_ptr<HttpPolicy> Clone() const override
+    {
+      return std::make_unique<RateLimitPolicy>(*this);
+    }
+
+    std::unique_ptr<Core::Http::RawResponse> Send(
+        Core::Http::Request& request,
+        Core::Http::Policies::NextHttpPolicy nextPolicy,
+        Core::Context const& context) const override;
+
+  private:
+    std::shared_ptr<RateLimiter> m_rateLimiter;
+  };
+
+}}} // namespace Azure::Storage::_internal
@@ -2,8 +2,11 @@
 // SPDX-License-Identifier: MIT
 
 #include <algorithm>
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <utility>
 
 #include <azure/core/context.hpp>
 #include <azure/core/io/body_stream.hpp>
@@ -15,6 +18,19 @@ namespace Azure { namespace Storage { namespace _internal {
   {
     // configures the maximun retries to be done.
     int32_t MaxRetryRequests;
+    // The delay before reconnecting after a failed read, doubled after each consecutive failed
+    // read up to MaxRetryDelay, with a random jitter of -20% to +30%.
+    std::chrono::milliseconds RetryDelay = std::chrono::milliseconds(0);
+    std::chrono::milliseconds MaxRetryDelay = std::chrono::milliseconds(0);
+    // A read receiving nothing for this long is abandoned and the stream reconnects right away,
+    // so that a connection which has become very slow doesn't stall the download. Zero disables
+    // the detection.
+    std::chrono::milliseconds StallTimeout = std::chrono::milliseconds(0);
+    // A connection receiving less than this many bytes per second over the last ThroughputWindow
+    // of time spent in reads is replaced after the read, before the next one. Zero disables the
+    // check.
+    int64_t MinimumThroughput = 0;
+    std::chrono::milliseconds ThroughputWindow = std::chrono::milliseconds(0);
   };
 
   /**
@@ -28,6 +44,10 @@ namespace Azure { namespace Storage { namespace _internal {
    * @remark An HTTPGetter callback is expected to calculate and set the range header based on the
    * offset provided by the ReliableStream.
    *
+   * @remark The reconnects alternate between the secondary and the primary host of the client,
+   * starting with the secondary one, through the context given to the HTTPGetter callback. They
+   * only go to the secondary host if the client has one.
+   *
    */
   class ReliableStream final : public Azure::Core::IO::BodyStream {
   private:
@@ -41,8 +61,32 @@ namespace Azure { namespace Storage { namespace _internal {
         m_streamReconnector;
     // Options to use when getting a new bodyStream like current offset
     int64_t m_retryOffset;
+    // The reconnects so far, and the failed reads since the last successful one, not counting
+    // the stalled ones.
+    int32_t m_reconnects = 0;
+    int32_t m_failedReads = 0;
+    // The duration and the size of the reads from the inner stream during the last
+    // ThroughputWindow of time spent reading, and their totals.
+    std::deque<std::pair<std::chrono::steady_clock::duration, size_t>> m_reads;
+    std::chrono::steady_clock::duration m_readDuration{};
+    int64_t m_readBytes = 0;
+
+    // Records a read from the inner stream, returns false if the throughput of the inner stream
+    // has become too low.
+    bool OnInnerRead(size_t readBytes, std::chrono::steady_clock::duration duration);
+
+    // Waits before reconnecting after a failed read.
+    void WaitBeforeReconnect(Azure::Core::Context const& context) const;
+
+    // Reads from the inner stream through innerRead, reconnecting and retrying when it fails.
+    template <class InnerRead>
+    size_t ReadFromInner(InnerRead const& innerRead, Azure::Core::Context const& context);
 
     size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override;
+    size_t OnReadV(
+        Azure::Core::IO::ReadBuffer const* buffers,
+        size_t bufferCount,
+        Azure::Core::Context const& context) override;
 
   public:
     explicit ReliableStream(
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <azure/core/internal/cryptography/hmac.hpp>
+
+#include "azure/storage/common/crypt.hpp"
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  // The parts of the SAS tokens of a builder which don't depend on the name of the resource. The
+  // name is at the end of the canonical name, between StringToSignPrefix and StringToSignSuffix.
+  struct SasTokenParts final
+  {
+    std::string StringToSignPrefix;
+    std::string StringToSignSuffix;
+    // The encoded query parameters of the token, except the signature.
+    std::map<std::string, std::string> QueryParameters;
+  };
+
+  // Generates the SAS token of a resource from the parts of its builder.
+  std::string GenerateSasToken(
+      const std::vector<uint8_t>& key,
+      const SasTokenParts& parts,
+      const std::string& resourceName);
+
+  // Same as above, with a key that was processed once, such as the signing key of a
+  // StorageSharedKeyCredential.
+  std::string GenerateSasToken(
+      const HmacSha256Key& key,
+      const SasTokenParts& parts,
+      const std::string& resourceName);
+
+  // Generates the SAS tokens of resources which only differ by their name. The HMAC of the string
+  // to sign before the name and the query parameters around the signature are computed once, so
+  // a token only signs the name and the rest of the string to sign.
+  class SasTokenTemplate final {
+  public:
+    explicit SasTokenTemplate(const std::vector<uint8_t>& key, const SasTokenParts& parts);
+    explicit SasTokenTemplate(const HmacSha256Key& key, const SasTokenParts& parts);
+
+    // Can be called concurrently.
+    std::string GenerateSasToken(const std::string& resourceName) const;
+
+  private:
+    Core::Cryptography::_internal::HmacSha256 m_hmac;
+    std::string m_stringToSignSuffix;
+    // The token before and after the value of the signature.
+    std::string m_tokenPrefix;
+    std::string m_tokenSuffix;
+  };
+
+}}} // namespace Azure::Storage::_internal
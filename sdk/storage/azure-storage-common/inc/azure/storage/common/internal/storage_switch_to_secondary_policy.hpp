@@ -3,12 +3,18 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <random>
 #include <string>
 
+#include <azure/core/datetime.hpp>
 #include <azure/core/http/policies/policy.hpp>
+#include <azure/core/nullable.hpp>
 
 #include "azure/storage/common/dll_import_export.hpp"
+#include "azure/storage/common/secondary_read_balancer.hpp"
 
 namespace Azure { namespace Storage { namespace _internal {
 
@@ -19,10 +25,67 @@ namespace Azure { namespace Storage { namespace _internal {
     return context.WithValue(SecondaryHostReplicaStatusKey, std::make_shared<bool>(true));
   }
 
+  AZ_STORAGE_COMMON_DLLEXPORT extern const Azure::Core::Context::Key ReadFromSecondaryKey;
+
+  // Makes the first try of the GET and HEAD requests sent with the context go to the secondary
+  // host, for example to resume a read which failed on the primary host. The retries alternate
+  // between the hosts as usual.
+  inline Azure::Core::Context WithReadFromSecondary(const Azure::Core::Context& context)
+  {
+    return context.WithValue(ReadFromSecondaryKey, true);
+  }
+
+  // The state of a SecondaryReadBalancer shared by the policies of its clients: the average
+  // latencies of the hosts, the last sync time of the secondary host, and the host of the next
+  // read of the round robin.
+  class SecondaryReadBalancerState final {
+  public:
+    explicit SecondaryReadBalancerState(
+        SecondaryReadBalancer::Strategy strategy,
+        Azure::Nullable<std::chrono::seconds> maxReplicationLag)
+        : m_strategy(strategy), m_maxReplicationLag(std::move(maxReplicationLag))
+    {
+    }
+
+    // Returns whether the first try of a read sent at now goes to the secondary host. random is
+    // uniformly distributed in [0, 1).
+    bool ChooseSecondary(const Azure::DateTime& now, double random);
+
+    // Records the time a try took on a host until its response was received.
+    void RecordLatency(bool secondary, std::chrono::steady_clock::duration latency);
+
+    // Records a try which failed on a host with a server error or throttling, or without a
+    // response.
+    void RecordFailure(bool secondary);
+
+    void SetLastSyncTime(const Azure::DateTime& lastSyncTime);
+
+    // Returns a number uniformly distributed in [0, 1).
+    double NextRandom();
+
+  private:
+    const SecondaryReadBalancer::Strategy m_strategy;
+    const Azure::Nullable<std::chrono::seconds> m_maxReplicationLag;
+
+    std::mutex m_mutex;
+    Azure::Nullable<Azure::DateTime> m_lastSyncTime;
+    bool m_nextSecondary = false;
+    // The average latencies of the primary and the secondary host in seconds, or zero before the
+    // first try on the host.
+    double m_latencies[2] = {0.0, 0.0};
+    std::mt19937_64 m_random{std::random_device{}()};
+  };
+
   class StorageSwitchToSecondaryPolicy final : public Azure::Core::Http::Policies::HttpPolicy {
   public:
-    explicit StorageSwitchToSecondaryPolicy(std::string primaryHost, std::string secondaryHost)
-        : m_primaryHost(std::move(primaryHost)), m_secondaryHost(std::move(secondaryHost))
+    // The first tries of the reads are spread between the hosts by readBalancer, if it isn't
+    // null.
+    explicit StorageSwitchToSecondaryPolicy(
+        std::string primaryHost,
+        std::string secondaryHost,
+        std::shared_ptr<SecondaryReadBalancer> readBalancer = nullptr)
+        : m_primaryHost(std::move(primaryHost)), m_secondaryHost(std::move(secondaryHost)),
+          m_readBalancer(std::move(readBalancer))
     {
     }
 
@@ -39,6 +102,7 @@ namespace Azure { namespace Storage { namespace _internal {
   private:
     std::string m_primaryHost;
     std::string m_secondaryHost;
+    std::shared_ptr<SecondaryReadBalancer> m_readBalancer;
   };
 
 }}} // namespace Azure::Storage::_internal
@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include <azure/core/context.hpp>
+#include <azure/core/io/body_stream.hpp>
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  /**
+   * @brief Aggregates the bytes transferred by the threads of a concurrent transfer, and reports
+   * their total to a handler at most a number of times per second, and once more when the
+   * transfer is done.
+   *
+   * @remark The threads add to counters of their own, each on its own cache line, so that they
+   * don't contend with each other. The thread whose addition is due for a report sums the
+   * counters and calls the handler, the reports don't overlap.
+   */
+  class TransferProgress final {
+  public:
+    /**
+     * @param handler Called with the total number of bytes transferred. May be null, then
+     * nothing is reported.
+     * @param maxReportsPerSecond The maximum number of reports per second, each addition is
+     * reported if it's not positive.
+     */
+    explicit TransferProgress(std::function<void(int64_t)> handler, int32_t maxReportsPerSecond);
+
+    TransferProgress(const TransferProgress&) = delete;
+    TransferProgress& operator=(const TransferProgress&) = delete;
+
+    /**
+     * @brief Returns whether the progress is reported.
+     */
+    bool IsEnabled() const { return static_cast<bool>(m_handler); }
+
+    /**
+     * @brief Adds bytes transferred, or removes them when negative, such as the bytes of a
+     * request sent again.
+     */
+    void Add(int64_t bytes);
+
+    /**
+     * @brief Reports the total once the transfer is done.
+     */
+    void Complete();
+
+  private:
+    static constexpr size_t CounterCount = 32;
+    static constexpr size_t CacheLineSize = 64;
+
+    struct Counter final
+    {
+      std::atomic<int64_t> Bytes{0};
+      char Padding[CacheLineSize - sizeof(std::atomic<int64_t>)];
+    };
+
+    void Report(bool wait);
+
+    std::function<void(int64_t)> m_handler;
+    int64_t m_reportInterval;
+    Counter m_counters[CounterCount];
+    // The time of the next report, in ticks of the steady clock.
+    std::atomic<int64_t> m_nextReport{0};
+    std::atomic_flag m_reporting = ATOMIC_FLAG_INIT;
+    int64_t m_reportedBytes = -1;
+  };
+
+  /**
+   * @brief Decorates a body stream by adding the data read from it to a transfer progress. The
+   * data read again after Rewind() is removed from the progress first.
+   */
+  class TransferProgressStream final : public Azure::Core::IO::BodyStream {
+  public:
+    /**
+     * @param inner The stream to read from, which must outlive this stream.
+     * @param progress The progress to add the data to, which must outlive this stream.
+     */
+    explicit TransferProgressStream(
+        Azure::Core::IO::BodyStream& inner,
+        TransferProgress& progress)
+        : m_inner(inner), m_progress(progress)
+    {
+    }
+
+    int64_t Length() const override { return m_inner.Length(); }
+
+    void Rewind() override
+    {
+      m_inner.Rewind();
+      m_progress.Add(-m_offset);
+      m_offset = 0;
+    }
+
+    bool SupportsContiguousRead() const override { return m_inner.SupportsContiguousRead(); }
+
+  private:
+    size_t OnRead(uint8_t* buffer, size_t count, Azure::Core::Context const& context) override
+    {
+      return Added(m_inner.Read(buffer, count, context));
+    }
+
+    size_t OnReadContiguous(
+        uint8_t const** data,
+        size_t count,
+        Azure::Core::Context const& context) override
+    {
+      return Added(m_inner.ReadContiguous(data, count, context));
+    }
+
+    size_t OnReadV(
+        Azure::Core::IO::ReadBuffer const* buffers,
+        size_t bufferCount,
+        Azure::Core::Context const& context) override
+    {
+      return Added(m_inner.ReadV(buffers, bufferCount, context));
+    }
+
+    size_t Added(size_t bytes)
+    {
+      m_offset += static_cast<int64_t>(bytes);
+      m_progress.Add(static_cast<int64_t>(bytes));
+      return bytes;
+    }
+
+    Azure::Core::IO::BodyStream& m_inner;
+    TransferProgress& m_progress;
+    int64_t m_offset = 0;
+  };
+
+}}} // namespace Azure::Storage::_internal
@@ -3,9 +3,14 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
+#include <azure/core/context.hpp>
+#include <azure/core/io/body_stream.hpp>
+
 namespace Azure { namespace Storage { namespace _internal {
 
   enum class XmlNodeType
@@ -32,9 +37,59 @@ namespace Azure { namespace Storage { namespace _internal {
     std::string Value;
   };
 
+  // A null-terminated string owned by the XmlReader it was read from, valid until the next call to
+  // XmlReader::Read(). It converts to std::string, so it is only copied when the value is kept.
+  class XmlStringView final {
+  public:
+    XmlStringView() = default;
+    explicit XmlStringView(const char* data, size_t length) : m_data(data), m_length(length) {}
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_length; }
+    size_t length() const { return m_length; }
+    bool empty() const { return m_length == 0; }
+
+    operator std::string() const { return std::string(m_data, m_length); }
+
+    template <size_t N> bool operator==(const char (&other)[N]) const
+    {
+      return m_length == N - 1 && std::memcmp(m_data, other, N - 1) == 0;
+    }
+    template <size_t N> bool operator!=(const char (&other)[N]) const { return !(*this == other); }
+    bool operator==(const std::string& other) const
+    {
+      return m_length == other.length() && std::memcmp(m_data, other.data(), m_length) == 0;
+    }
+    bool operator!=(const std::string& other) const { return !(*this == other); }
+
+  private:
+    const char* m_data = "";
+    size_t m_length = 0;
+  };
+
+  // A node read by XmlReader, its name and value are only valid until the next call to
+  // XmlReader::Read().
+  struct XmlNodeView final
+  {
+    explicit XmlNodeView(
+        XmlNodeType type,
+        XmlStringView name = XmlStringView(),
+        XmlStringView value = XmlStringView())
+        : Type(type), Name(name), Value(value)
+    {
+    }
+
+    XmlNodeType Type;
+    XmlStringView Name;
+    XmlStringView Value;
+  };
+
   class XmlReader final {
   public:
     explicit XmlReader(const char* data, size_t length);
+    // Reads the document from the stream while parsing it, the stream and the context must
+    // outlive the reader.
+    explicit XmlReader(Azure::Core::IO::BodyStream& stream, const Azure::Core::Context& context);
     XmlReader(const XmlReader& other) = delete;
     XmlReader& operator=(const XmlReader& other) = delete;
     XmlReader(XmlReader&& other) noexcept { *this = std::move(other); }
@@ -46,7 +101,7 @@ namespace Azure { namespace Storage { namespace _internal {
     }
     ~XmlReader();
 
-    XmlNode Read();
+    XmlNodeView Read();
 
   private:
     void* m_context = nullptr;
@@ -74,4 +129,12 @@ namespace Azure { namespace Storage { namespace _internal {
     void* m_context = nullptr;
   };
 
+  // Appends text to a document, escaped like the text of the elements written by XmlWriter, so
+  // that a document serialized once can be completed without a writer.
+  void AppendXmlText(std::string& document, const std::string& text);
+
+  // Unescapes the raw text of an element of a document in place, like XmlReader does, and returns
+  // its length once unescaped. The text mustn't contain CDATA sections.
+  size_t UnescapeXmlTextInPlace(char* text, size_t length);
+
 }}} // namespace Azure::Storage::_internal
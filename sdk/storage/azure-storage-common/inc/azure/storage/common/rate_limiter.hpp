@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace Azure { namespace Storage {
+
+  namespace _internal {
+    class TokenBucket;
+    class RateLimitPolicy;
+  } // namespace _internal
+
+  /**
+   * @brief Limits the bandwidth and the rate of the requests of the storage clients sharing it,
+   * such as the clients of all the services running in a process.
+   *
+   * @remark Both limits are enforced with token buckets which hold up to one second worth of
+   * tokens, so a short burst may reach twice the rate. The bytes of the request bodies are
+   * counted before the requests are sent, the bytes of the response bodies are counted as they
+   * are read. Every try of a request is counted, including the retries.
+   */
+  class RateLimiter final {
+  public:
+    /**
+     * @brief Initializes a new instance of the RateLimiter.
+     *
+     * @param bytesPerSecond The maximum number of bytes sent and received per second, or 0 for no
+     * limit.
+     * @param requestsPerSecond The maximum number of requests sent per second, or 0 for no limit.
+     *
+     * @throw std::invalid_argument if bytesPerSecond or requestsPerSecond is negative.
+     */
+    explicit RateLimiter(int64_t bytesPerSecond, int64_t requestsPerSecond);
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * @brief Destructs the RateLimiter.
+     */
+    ~RateLimiter();
+
+    /**
+     * @brief Gets the maximum number of bytes sent and received per second.
+     *
+     * @return The maximum number of bytes per second, or 0 if there is no limit.
+     */
+    int64_t BytesPerSecond() const { return m_bytesPerSecond; }
+
+    /**
+     * @brief Gets the maximum number of requests sent per second.
+     *
+     * @return The maximum number of requests per second, or 0 if there is no limit.
+     */
+    int64_t RequestsPerSecond() const { return m_requestsPerSecond; }
+
+  private:
+    int64_t m_bytesPerSecond;
+    int64_t m_requestsPerSecond;
+    // Null when there is no limit.
+    std::shared_ptr<_internal::TokenBucket> m_bytes;
+    std::shared_ptr<_internal::TokenBucket> m_requests;
+
+    friend class _internal::RateLimitPolicy;
+  };
+
+}} // namespace Azure::Storage
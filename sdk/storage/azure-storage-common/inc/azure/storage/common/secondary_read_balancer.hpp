@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include <azure/core/datetime.hpp>
+#include <azure/core/nullable.hpp>
+
+namespace Azure { namespace Storage {
+
+  namespace _internal {
+    class SecondaryReadBalancerState;
+    class StorageSwitchToSecondaryPolicy;
+  } // namespace _internal
+
+  /**
+   * @brief Spreads the first tries of the reads of the storage clients sharing it between the
+   * primary and the secondary host of a read-access geo-redundant account, instead of only
+   * retrying them on the secondary host.
+   *
+   * @remark Only the reads which can be retried on the secondary host are spread, and only when
+   * the clients have a secondary host. A read which isn't found on the secondary host, or doesn't
+   * meet its conditions there, is sent to the primary host and the rest of its operation stays on
+   * the primary host. The data read from the secondary host may be stale, see
+   * https://docs.microsoft.com/azure/storage/common/geo-redundant-design.
+   */
+  class SecondaryReadBalancer final {
+  public:
+    /**
+     * @brief How the reads are spread between the hosts.
+     */
+    enum class Strategy
+    {
+      /**
+       * @brief The reads alternate between the hosts.
+       */
+      RoundRobin,
+
+      /**
+       * @brief Each read goes to a host chosen at random with a weight inversely proportional to
+       * its average latency, so the faster host gets more reads. A host whose requests fail with
+       * server errors or throttling is weighted as if it were slower.
+       */
+      LatencyWeighted,
+    };
+
+    /**
+     * @brief Initializes a new instance of the SecondaryReadBalancer.
+     *
+     * @param strategy How the reads are spread between the hosts.
+     * @param maxReplicationLag If set, the reads only go to the secondary host while the last
+     * sync time set with #SetLastSyncTime is at most this long ago. Until it's set, the reads stay
+     * on the primary host.
+     */
+    explicit SecondaryReadBalancer(
+        Strategy strategy,
+        Azure::Nullable<std::chrono::seconds> maxReplicationLag
+        = Azure::Nullable<std::chrono::seconds>());
+
+    SecondaryReadBalancer(const SecondaryReadBalancer&) = delete;
+    SecondaryReadBalancer& operator=(const SecondaryReadBalancer&) = delete;
+
+    /**
+     * @brief Destructs the SecondaryReadBalancer.
+     */
+    ~SecondaryReadBalancer();
+
+    /**
+     * @brief Gets how the reads are spread between the hosts.
+     *
+     * @return The strategy.
+     */
+    Strategy GetStrategy() const { return m_strategy; }
+
+    /**
+     * @brief Sets the time of the last write replicated to the secondary host, as returned by
+     * the statistics of the service. The statistics got by the clients sharing the balancer set
+     * it too.
+     *
+     * @param lastSyncTime The last sync time of the secondary host.
+     */
+    void SetLastSyncTime(const Azure::DateTime& lastSyncTime);
+
+  private:
+    Strategy m_strategy;
+    std::shared_ptr<_internal::SecondaryReadBalancerState> m_state;
+
+    friend class _internal::StorageSwitchToSecondaryPolicy;
+  };
+
+}} // namespace Azure::Storage
@@ -17,11 +17,15 @@ namespace Azure { namespace Storage {
     struct ShareSasBuilder;
     struct DataLakeSasBuilder;
     struct QueueSasBuilder;
+    class BlobSasTokenGenerator;
+    class ShareSasTokenGenerator;
+    class DataLakeSasTokenGenerator;
   } // namespace Sas
 
   namespace _internal {
     class SharedKeyPolicy;
-  }
+    class HmacSha256Key;
+  } // namespace _internal
 
   /**
    * @brief A StorageSharedKeyCredential is a credential backed by a storage account's name and
@@ -51,6 +55,7 @@ namespace Azure { namespace Storage {
     {
       std::lock_guard<std::mutex> guard(m_mutex);
       m_accountKey = std::move(accountKey);
+      m_signingKey.reset();
     }
 
     /**
@@ -65,14 +70,21 @@ namespace Azure { namespace Storage {
     friend struct Sas::DataLakeSasBuilder;
     friend struct Sas::QueueSasBuilder;
     friend struct Sas::AccountSasBuilder;
+    friend class Sas::BlobSasTokenGenerator;
+    friend class Sas::ShareSasTokenGenerator;
+    friend class Sas::DataLakeSasTokenGenerator;
     std::string GetAccountKey() const
     {
       std::lock_guard<std::mutex> guard(m_mutex);
       return m_accountKey;
     }
+    // The decoded account key, ready to sign the requests and SAS tokens. It is created on first
+    // use and after the key is updated.
+    std::shared_ptr<const _internal::HmacSha256Key> GetSigningKey() const;
 
     mutable std::mutex m_mutex;
     std::string m_accountKey;
+    mutable std::shared_ptr<const _internal::HmacSha256Key> m_signingKey;
   };
 
   namespace _internal {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <initializer_list>
 #include <map>
 #include <memory>
 #include <stdexcept>
@@ -39,4 +40,18 @@ namespace Azure { namespace Storage {
     static StorageException CreateFromResponse(
         std::unique_ptr<Azure::Core::Http::RawResponse> response);
   };
+
+  namespace _internal {
+    /**
+     * @brief Checks whether a storage service response failed with \p statusCode and one of
+     * \p errorCodes, without the cost of creating and throwing a #StorageException.
+     *
+     * @remark The error code is read from the `x-ms-error-code` header. The body of the response
+     * is only parsed when the header is missing.
+     */
+    bool IsFailedWith(
+        const Azure::Core::Http::RawResponse& response,
+        Azure::Core::Http::HttpStatusCode statusCode,
+        std::initializer_list<const char*> errorCodes);
+  } // namespace _internal
 }} // namespace Azure::Storage
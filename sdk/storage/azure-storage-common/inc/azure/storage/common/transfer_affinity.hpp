@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage {
+
+  /**
+   * @brief Where the threads of a TransferExecutor run and where the buffers of a BufferPool are
+   * allocated, such as on the NUMA node of the network interface the transfers go through.
+   *
+   * @remark On a host with several NUMA nodes, the chunks are transferred faster by threads
+   * running on the node the network interface is attached to, through buffers in the memory of
+   * that node. A default TransferAffinity lets the threads run on any CPU and the buffers be
+   * allocated anywhere. Threads are pinned on Linux and Windows, and buffers are allocated on a
+   * node on Linux and Windows, the affinity is ignored elsewhere.
+   */
+  class TransferAffinity final {
+  public:
+    /**
+     * @brief Initializes a new instance of the TransferAffinity which lets the threads run on any
+     * CPU and the buffers be allocated anywhere.
+     */
+    TransferAffinity() = default;
+
+    /**
+     * @brief Initializes a new instance of the TransferAffinity which runs the threads on some
+     * CPUs, without choosing where the buffers are allocated.
+     *
+     * @param cpus The indices of the CPUs the threads run on.
+     *
+     * @throw std::invalid_argument if an index is negative.
+     */
+    explicit TransferAffinity(std::vector<int> cpus);
+
+    /**
+     * @brief Creates a TransferAffinity which runs the threads on the CPUs of a NUMA node and
+     * allocates the buffers in its memory.
+     *
+     * @param numaNode The index of the NUMA node.
+     * @return The affinity of the NUMA node.
+     *
+     * @throw std::invalid_argument if numaNode is negative.
+     * @throw std::runtime_error if the CPUs of the NUMA node can't be found.
+     */
+    static TransferAffinity CreateFromNumaNode(int numaNode);
+
+    /**
+     * @brief Creates a TransferAffinity for the NUMA node a network interface is attached to, such
+     * as `eth0`.
+     *
+     * @remark The NUMA node of a network interface is found on Linux. The default affinity is
+     * returned for a network interface which isn't attached to a NUMA node, such as on a host with
+     * a single node, and on the other platforms.
+     *
+     * @param networkInterface The name of the network interface.
+     * @return The affinity of the NUMA node of the network interface.
+     *
+     * @throw std::runtime_error if the network interface doesn't exist.
+     */
+    static TransferAffinity CreateFromNetworkInterface(const std::string& networkInterface);
+
+    /**
+     * @brief Gets the indices of the CPUs the threads run on.
+     *
+     * @return The indices of the CPUs, or an empty vector if the threads run on any CPU.
+     */
+    const std::vector<int>& Cpus() const { return m_cpus; }
+
+    /**
+     * @brief Gets the NUMA node the buffers are allocated on.
+     *
+     * @return The index of the NUMA node, or -1 if the buffers are allocated anywhere.
+     */
+    int NumaNode() const { return m_numaNode; }
+
+  private:
+    std::vector<int> m_cpus;
+    int m_numaNode = -1;
+  };
+
+}} // namespace Azure::Storage
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "azure/storage/common/transfer_affinity.hpp"
+
+namespace Azure { namespace Storage {
+
+  class TransferExecutor;
+
+  namespace _internal {
+    struct ConcurrentTransferOptions;
+
+    int64_t ConcurrentTransfer(
+        int64_t offset,
+        int64_t length,
+        const ConcurrentTransferOptions& options,
+        std::function<void(int64_t, int64_t, int64_t)> transferFunc,
+        const std::shared_ptr<TransferExecutor>& executor);
+
+    int64_t ConcurrentStreamTransfer(
+        int concurrency,
+        std::function<std::function<void()>(int64_t)> nextChunkFunc,
+        const std::shared_ptr<TransferExecutor>& executor);
+
+    void SubmitTransferTask(
+        const std::shared_ptr<TransferExecutor>& executor,
+        std::function<void()> task);
+  } // namespace _internal
+
+  /**
+   * @brief A pool of threads on which the storage clients transfer the chunks of their concurrent
+   * uploads and downloads, such as `UploadFrom()` and `DownloadTo()`.
+   *
+   * @remark Each thread has its own queue of work and takes work from the queues of the other
+   * threads when its own is empty. The number of chunks being transferred at the same time by all
+   * the transfers sharing the executor, including the chunks transferred by the threads which
+   * started the transfers, is limited to MaxInFlightChunks(). A transfer still uses at most the
+   * concurrency of its options.
+   */
+  class TransferExecutor final {
+  public:
+    /**
+     * @brief Initializes a new instance of the TransferExecutor and starts its threads.
+     *
+     * @param threadCount The number of threads of the executor.
+     * @param maxInFlightChunks The maximum number of chunks transferred at the same time.
+     *
+     * @throw std::invalid_argument if threadCount or maxInFlightChunks is less than 1.
+     */
+    explicit TransferExecutor(int threadCount, int maxInFlightChunks);
+
+    /**
+     * @brief Initializes a new instance of the TransferExecutor and starts its threads on the CPUs
+     * of an affinity, such as the CPUs of the NUMA node of the network interface.
+     *
+     * @param threadCount The number of threads of the executor.
+     * @param maxInFlightChunks The maximum number of chunks transferred at the same time.
+     * @param affinity The CPUs the threads run on.
+     *
+     * @throw std::invalid_argument if threadCount or maxInFlightChunks is less than 1.
+     */
+    explicit TransferExecutor(
+        int threadCount,
+        int maxInFlightChunks,
+        const TransferAffinity& affinity);
+
+    TransferExecutor(const TransferExecutor&) = delete;
+    TransferExecutor& operator=(const TransferExecutor&) = delete;
+
+    /**
+     * @brief Runs the remaining work and stops the threads of the executor.
+     */
+    ~TransferExecutor();
+
+    /**
+     * @brief Gets the number of threads of the executor.
+     *
+     * @return The number of threads of the executor.
+     */
+    int ThreadCount() const;
+
+    /**
+     * @brief Gets the maximum number of chunks transferred at the same time.
+     *
+     * @return The maximum number of chunks transferred at the same time.
+     */
+    int MaxInFlightChunks() const;
+
+    /**
+     * @brief Gets the CPUs the threads of the executor run on.
+     *
+     * @return The affinity of the threads.
+     */
+    const TransferAffinity& Affinity() const;
+
+    /**
+     * @brief Gets the executor used by the clients whose options don't have one, which is created
+     * the first time it is needed.
+     *
+     * @return The default executor.
+     */
+    static std::shared_ptr<TransferExecutor> GetDefault();
+
+  private:
+    struct State;
+
+    void Submit(std::function<void()> task);
+    void AcquireChunk();
+    void ReleaseChunk();
+
+    std::unique_ptr<State> m_state;
+
+    friend int64_t _internal::ConcurrentTransfer(
+        int64_t offset,
+        int64_t length,
+        const _internal::ConcurrentTransferOptions& options,
+        std::function<void(int64_t, int64_t, int64_t)> transferFunc,
+        const std::shared_ptr<TransferExecutor>& executor);
+    friend int64_t _internal::ConcurrentStreamTransfer(
+        int concurrency,
+        std::function<std::function<void()>(int64_t)> nextChunkFunc,
+        const std::shared_ptr<TransferExecutor>& executor);
+    friend void _internal::SubmitTransferTask(
+        const std::shared_ptr<TransferExecutor>& executor,
+        std::function<void()> task);
+  };
+
+}} // namespace Azure::Storage
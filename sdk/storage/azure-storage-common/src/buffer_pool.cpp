@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/buffer_pool.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include "azure/storage/common/internal/pooled_buffer.hpp"
+
+namespace Azure { namespace Storage {
+
+  namespace {
+    // The sizes of the buffers are rounded up so that chunks of slightly different sizes share
+    // buffers.
+    constexpr size_t BufferSizeGranularity = 64 * 1024;
+    // Waits are split so that a cancelled context is noticed quickly.
+    constexpr std::chrono::milliseconds MaxWaitDuration(100);
+  } // namespace
+
+  struct BufferPool::State final
+  {
+    int64_t MaxMemory = 0;
+    int64_t MaxIdleMemory = 0;
+    TransferAffinity Affinity;
+    bool UseHugePages = false;
+
+    std::mutex Mutex;
+    std::condition_variable BufferReleased;
+    // The bytes of all the buffers, and of the idle ones.
+    int64_t Memory = 0;
+    int64_t IdleMemory = 0;
+    size_t UsedBuffers = 0;
+    std::multimap<size_t, std::unique_ptr<_internal::AlignedBuffer>> IdleBuffers;
+
+    // Returns null instead of waiting if context is null.
+    std::unique_ptr<_internal::AlignedBuffer> Acquire(
+        size_t size,
+        const Azure::Core::Context* context);
+    void Release(std::unique_ptr<_internal::AlignedBuffer> buffer);
+  };
+
+  std::unique_ptr<_internal::AlignedBuffer> BufferPool::State::Acquire(
+      size_t size,
+      const Azure::Core::Context* context)
+  {
+    const size_t bufferSize
+        = (size + BufferSizeGranularity - 1) / BufferSizeGranularity * BufferSizeGranularity;
+
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (true)
+    {
+      // An idle buffer is reused unless it is at least twice as large as needed.
+      auto idleBuffer = IdleBuffers.lower_bound(bufferSize);
+      if (idleBuffer != IdleBuffers.end() && idleBuffer->first / 2 < bufferSize)
+      {
+        auto buffer = std::move(idleBuffer->second);
+        IdleMemory -= static_cast<int64_t>(idleBuffer->first);
+        IdleBuffers.erase(idleBuffer);
+        ++UsedBuffers;
+        return buffer;
+      }
+
+      // The largest idle buffers are freed to make room for the new one.
+      while (!IdleBuffers.empty() && Memory + static_cast<int64_t>(bufferSize) > MaxMemory)
+      {
+        auto largest = std::prev(IdleBuffers.end());
+        Memory -= static_cast<int64_t>(largest->first);
+        IdleMemory -= static_cast<int64_t>(largest->first);
+        IdleBuffers.erase(largest);
+      }
+      if (Memory + static_cast<int64_t>(bufferSize) <= MaxMemory || UsedBuffers == 0)
+      {
+        Memory += static_cast<int64_t>(bufferSize);
+        ++UsedBuffers;
+        lock.unlock();
+        try
+        {
+          return std::make_unique<_internal::AlignedBuffer>(
+              bufferSize, Affinity.NumaNode(), UseHugePages);
+        }
+        catch (...)
+        {
+          lock.lock();
+          Memory -= static_cast<int64_t>(bufferSize);
+          --UsedBuffers;
+          BufferReleased.notify_all();
+          throw;
+        }
+      }
+
+      if (!context)
+      {
+        return nullptr;
+      }
+      context->ThrowIfCancelled();
+      BufferReleased.wait_for(lock, MaxWaitDuration);
+    }
+  }
+
+  void BufferPool::State::Release(std::unique_ptr<_internal::AlignedBuffer> buffer)
+  {
+    const size_t bufferSize = buffer->Size();
+    {
+      std::lock_guard<std::mutex> guard(Mutex);
+      --UsedBuffers;
+      if (IdleMemory + static_cast<int64_t>(bufferSize) <= MaxIdleMemory)
+      {
+        IdleMemory += static_cast<int64_t>(bufferSize);
+        IdleBuffers.emplace(bufferSize, std::move(buffer));
+      }
+      else
+      {
+        Memory -= static_cast<int64_t>(bufferSize);
+      }
+    }
+    BufferReleased.notify_all();
+    // A buffer which isn't kept is freed here, outside of the lock.
+  }
+
+  BufferPool::BufferPool(int64_t maxMemory, int64_t maxIdleMemory)
+      : BufferPool(maxMemory, maxIdleMemory, TransferAffinity(), false)
+  {
+  }
+
+  BufferPool::BufferPool(
+      int64_t maxMemory,
+      int64_t maxIdleMemory,
+      const TransferAffinity& affinity,
+      bool useHugePages)
+      : m_state(std::make_unique<State>())
+  {
+    if (maxMemory < 1)
+    {
+      throw std::invalid_argument("maxMemory must be at least 1.");
+    }
+    if (maxIdleMemory < 0 || maxIdleMemory > maxMemory)
+    {
+      throw std::invalid_argument("maxIdleMemory must be between 0 and maxMemory.");
+    }
+    m_state->MaxMemory = maxMemory;
+    m_state->MaxIdleMemory = maxIdleMemory;
+    m_state->Affinity = affinity;
+    m_state->UseHugePages = useHugePages;
+  }
+
+  BufferPool::~BufferPool() {}
+
+  int64_t BufferPool::MaxMemory() const { return m_state->MaxMemory; }
+
+  int64_t BufferPool::MaxIdleMemory() const { return m_state->MaxIdleMemory; }
+
+  const TransferAffinity& BufferPool::Affinity() const { return m_state->Affinity; }
+
+  bool BufferPool::UsesHugePages() const { return m_state->UseHugePages; }
+
+  std::shared_ptr<BufferPool> BufferPool::GetDefault()
+  {
+    static const std::shared_ptr<BufferPool> defaultPool
+        = std::make_shared<BufferPool>(1024 * 1024 * 1024, 64 * 1024 * 1024);
+    return defaultPool;
+  }
+
+  namespace _internal {
+
+    PooledBuffer::PooledBuffer(
+        std::shared_ptr<BufferPool> pool,
+        size_t size,
+        const Azure::Core::Context& context)
+        : m_pool(pool ? std::move(pool) : BufferPool::GetDefault()),
+          m_buffer(m_pool->m_state->Acquire(size, &context)), m_size(size)
+    {
+    }
+
+    PooledBuffer PooledBuffer::TryTake(std::shared_ptr<BufferPool> pool, size_t size)
+    {
+      PooledBuffer buffer;
+      buffer.m_pool = pool ? std::move(pool) : BufferPool::GetDefault();
+      buffer.m_buffer = buffer.m_pool->m_state->Acquire(size, nullptr);
+      if (buffer.m_buffer)
+      {
+        buffer.m_size = size;
+      }
+      else
+      {
+        buffer.m_pool.reset();
+      }
+      return buffer;
+    }
+
+    PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept
+    {
+      if (this != &other)
+      {
+        Release();
+        m_pool = std::move(other.m_pool);
+        m_buffer = std::move(other.m_buffer);
+        m_size = other.m_size;
+        other.m_size = 0;
+      }
+      return *this;
+    }
+
+    void PooledBuffer::Release() noexcept
+    {
+      if (m_buffer)
+      {
+        m_pool->m_state->Release(std::move(m_buffer));
+      }
+      m_pool.reset();
+      m_size = 0;
+    }
+
+  } // namespace _internal
+
+}} // namespace Azure::Storage
@@ -0,0 +1,373 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/concurrent_transfer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include <azure/core/http/traffic_class.hpp>
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  namespace {
+    // A round at least this much faster than the previous one makes the tuner grow the chunk size
+    // and the concurrency, a round this much slower makes it shrink them.
+    constexpr double IncreaseThreshold = 1.1;
+    constexpr double DecreaseThreshold = 0.7;
+
+    // Shared with the workers submitted to the executor, which may only start after the transfer
+    // has returned. They don't call TransferFunc then, all the chunks have already been taken.
+    struct TransferState final
+    {
+      int64_t End = 0;
+      ConcurrentTransferOptions Options;
+      std::function<void(int64_t, int64_t, int64_t)> TransferFunc;
+      // The private members of the executor used by the workers.
+      std::function<void(std::function<void()>)> Submit;
+      std::function<void()> AcquireChunk;
+      std::function<void()> ReleaseChunk;
+
+      std::mutex Mutex;
+      int64_t NextOffset = 0;
+      int64_t NextChunkId = 0;
+      std::unique_ptr<TransferTuner> Tuner;
+      std::exception_ptr Exception;
+      // The workers, including the calling thread and the workers which haven't started yet.
+      int NumWorkers = 0;
+      // The workers submitted to the executor which have started and are not done yet.
+      int NumRunningWorkers = 0;
+      std::condition_variable WorkerDone;
+
+      int64_t ChunkSize() const { return Tuner ? Tuner->ChunkSize() : Options.ChunkSize; }
+      int Concurrency() const { return Tuner ? Tuner->Concurrency() : Options.Concurrency; }
+
+      // Returns the number of workers to submit to reach the concurrency, which are counted as
+      // workers already.
+      int AddWorkers()
+      {
+        const int64_t numRemainingChunks = (End - NextOffset + ChunkSize() - 1) / ChunkSize();
+        const int64_t numNewWorkers
+            = std::min<int64_t>(Concurrency(), numRemainingChunks) - NumWorkers;
+        if (numNewWorkers <= 0)
+        {
+          return 0;
+        }
+        NumWorkers += static_cast<int>(numNewWorkers);
+        return static_cast<int>(numNewWorkers);
+      }
+    };
+
+    void RunWorker(const std::shared_ptr<TransferState>& sharedState, bool isCallingThread);
+
+    void SubmitWorkers(const std::shared_ptr<TransferState>& sharedState, int numWorkers)
+    {
+      for (int i = 0; i < numWorkers; ++i)
+      {
+        sharedState->Submit([sharedState]() { RunWorker(sharedState, false); });
+      }
+    }
+
+    void RunWorker(const std::shared_ptr<TransferState>& sharedState, bool isCallingThread)
+    {
+      TransferState& state = *sharedState;
+      std::unique_lock<std::mutex> lock(state.Mutex);
+      if (!isCallingThread)
+      {
+        ++state.NumRunningWorkers;
+      }
+      // The workers above the concurrency stop, except for the calling thread.
+      while (!state.Exception && state.NextOffset < state.End
+             && (isCallingThread || state.NumWorkers <= state.Concurrency()))
+      {
+        const int64_t chunkOffset = state.NextOffset;
+        const int64_t chunkLength = std::min(state.End - chunkOffset, state.ChunkSize());
+        const int64_t chunkId = state.NextChunkId++;
+        state.NextOffset += chunkLength;
+        lock.unlock();
+
+        std::exception_ptr exception;
+        state.AcquireChunk();
+        try
+        {
+          state.TransferFunc(chunkOffset, chunkLength, chunkId);
+        }
+        catch (...)
+        {
+          exception = std::current_exception();
+        }
+        state.ReleaseChunk();
+        const auto now = std::chrono::steady_clock::now();
+
+        lock.lock();
+        if (exception)
+        {
+          if (!state.Exception)
+          {
+            state.Exception = exception;
+          }
+          continue;
+        }
+        if (state.Tuner)
+        {
+          state.Tuner->OnChunkTransferred(chunkLength, now);
+          const int numNewWorkers = state.AddWorkers();
+          if (numNewWorkers != 0)
+          {
+            lock.unlock();
+            SubmitWorkers(sharedState, numNewWorkers);
+            lock.lock();
+          }
+        }
+      }
+      --state.NumWorkers;
+      if (!isCallingThread)
+      {
+        --state.NumRunningWorkers;
+      }
+      lock.unlock();
+      state.WorkerDone.notify_all();
+    }
+
+    struct StreamTransferState final
+    {
+      std::function<std::function<void()>(int64_t)> NextChunkFunc;
+      std::function<void()> AcquireChunk;
+      std::function<void()> ReleaseChunk;
+
+      std::mutex Mutex;
+      int64_t NextChunkId = 0;
+      // Set once nextChunkFunc has returned null or anything has thrown.
+      bool Done = false;
+      std::exception_ptr Exception;
+      int NumRunningWorkers = 0;
+      std::condition_variable WorkerDone;
+
+      void SetException(std::exception_ptr exception)
+      {
+        if (!Exception)
+        {
+          Exception = exception;
+        }
+        Done = true;
+      }
+    };
+
+    void RunStreamWorker(const std::shared_ptr<StreamTransferState>& sharedState)
+    {
+      StreamTransferState& state = *sharedState;
+      std::unique_lock<std::mutex> lock(state.Mutex);
+      ++state.NumRunningWorkers;
+      while (!state.Done)
+      {
+        // The chunks are prepared in order under the lock, such as when they are read from a
+        // stream, and transferred concurrently.
+        lock.unlock();
+        state.AcquireChunk();
+        lock.lock();
+        std::function<void()> transferChunkFunc;
+        if (!state.Done)
+        {
+          try
+          {
+            transferChunkFunc = state.NextChunkFunc(state.NextChunkId);
+          }
+          catch (...)
+          {
+            state.SetException(std::current_exception());
+          }
+        }
+        if (!transferChunkFunc)
+        {
+          state.ReleaseChunk();
+          state.Done = true;
+          break;
+        }
+        ++state.NextChunkId;
+        lock.unlock();
+
+        std::exception_ptr exception;
+        try
+        {
+          transferChunkFunc();
+        }
+        catch (...)
+        {
+          exception = std::current_exception();
+        }
+        transferChunkFunc = nullptr;
+        state.ReleaseChunk();
+
+        lock.lock();
+        if (exception)
+        {
+          state.SetException(exception);
+        }
+      }
+      --state.NumRunningWorkers;
+      lock.unlock();
+      state.WorkerDone.notify_all();
+    }
+  } // namespace
+
+  TransferTuner::TransferTuner(
+      int64_t minChunkSize,
+      int64_t maxChunkSize,
+      int maxConcurrency,
+      std::chrono::steady_clock::time_point start)
+      : m_minChunkSize(std::max<int64_t>(1, std::min(minChunkSize, maxChunkSize))),
+        m_maxChunkSize(std::max(m_minChunkSize, maxChunkSize)),
+        m_maxConcurrency(std::max(1, maxConcurrency)), m_chunkSize(m_minChunkSize),
+        m_concurrency(std::min(2, m_maxConcurrency)), m_roundStart(start)
+  {
+  }
+
+  void TransferTuner::OnChunkTransferred(int64_t length, std::chrono::steady_clock::time_point now)
+  {
+    m_roundLength += length;
+    if (++m_roundChunks < m_concurrency)
+    {
+      return;
+    }
+
+    const double seconds
+        = std::max(std::chrono::duration<double>(now - m_roundStart).count(), 1e-6);
+    const double throughput = static_cast<double>(m_roundLength) / seconds;
+    const double previousThroughput = m_throughput;
+    m_throughput = throughput;
+    m_roundStart = now;
+    m_roundLength = 0;
+    m_roundChunks = 0;
+
+    if (previousThroughput != 0.0 && throughput < previousThroughput * DecreaseThreshold)
+    {
+      m_concurrency = std::max(1, m_concurrency / 2);
+      m_chunkSize = std::max(m_minChunkSize, m_chunkSize / 2);
+      m_plateaued = false;
+    }
+    else if (
+        !m_plateaued
+        && (previousThroughput == 0.0 || throughput > previousThroughput * IncreaseThreshold))
+    {
+      m_concurrency = std::min(m_maxConcurrency, m_concurrency + 1);
+      m_chunkSize = std::min(m_maxChunkSize, m_chunkSize * 2);
+    }
+    else
+    {
+      m_plateaued = true;
+    }
+  }
+
+  Azure::Core::Context WithBulkTrafficClass(const Azure::Core::Context& context)
+  {
+    if (Azure::Core::Http::GetTrafficClass(context).HasValue())
+    {
+      return context;
+    }
+    return Azure::Core::Http::WithTrafficClass(context, Azure::Core::Http::TrafficClass::Bulk);
+  }
+
+  int64_t ConcurrentTransfer(
+      int64_t offset,
+      int64_t length,
+      const ConcurrentTransferOptions& options,
+      std::function<void(int64_t, int64_t, int64_t)> transferFunc,
+      const std::shared_ptr<TransferExecutor>& executor)
+  {
+    if (length <= 0)
+    {
+      return 0;
+    }
+
+    const std::shared_ptr<TransferExecutor> transferExecutor
+        = executor ? executor : TransferExecutor::GetDefault();
+    // The workers don't keep the executor alive, it runs all of its tasks before being destroyed.
+    TransferExecutor* executorPointer = transferExecutor.get();
+
+    auto state = std::make_shared<TransferState>();
+    state->End = offset + length;
+    state->Options = options;
+    state->TransferFunc = std::move(transferFunc);
+    state->Submit = [executorPointer](std::function<void()> task) {
+      executorPointer->Submit(std::move(task));
+    };
+    state->AcquireChunk = [executorPointer]() { executorPointer->AcquireChunk(); };
+    state->ReleaseChunk = [executorPointer]() { executorPointer->ReleaseChunk(); };
+    state->NextOffset = offset;
+    if (options.AutoTune)
+    {
+      state->Tuner = std::make_unique<TransferTuner>(
+          options.MinChunkSize,
+          options.ChunkSize,
+          options.Concurrency,
+          std::chrono::steady_clock::now());
+    }
+
+    int numWorkers;
+    {
+      std::lock_guard<std::mutex> guard(state->Mutex);
+      state->NumWorkers = 1;
+      numWorkers = state->AddWorkers();
+    }
+    SubmitWorkers(state, numWorkers);
+    RunWorker(state, true);
+
+    std::unique_lock<std::mutex> lock(state->Mutex);
+    state->WorkerDone.wait(lock, [&state]() { return state->NumRunningWorkers == 0; });
+    if (state->Exception)
+    {
+      std::rethrow_exception(state->Exception);
+    }
+    return state->NextChunkId;
+  }
+
+  int64_t ConcurrentStreamTransfer(
+      int concurrency,
+      std::function<std::function<void()>(int64_t)> nextChunkFunc,
+      const std::shared_ptr<TransferExecutor>& executor)
+  {
+    const std::shared_ptr<TransferExecutor> transferExecutor
+        = executor ? executor : TransferExecutor::GetDefault();
+    TransferExecutor* executorPointer = transferExecutor.get();
+
+    auto state = std::make_shared<StreamTransferState>();
+    state->NextChunkFunc = std::move(nextChunkFunc);
+    state->AcquireChunk = [executorPointer]() { executorPointer->AcquireChunk(); };
+    state->ReleaseChunk = [executorPointer]() { executorPointer->ReleaseChunk(); };
+
+    // The workers which start after the transfer is done return right away.
+    for (int i = 1; i < concurrency; ++i)
+    {
+      executorPointer->Submit([state]() { RunStreamWorker(state); });
+    }
+    RunStreamWorker(state);
+
+    std::unique_lock<std::mutex> lock(state->Mutex);
+    state->WorkerDone.wait(lock, [&state]() { return state->NumRunningWorkers == 0; });
+    // The functions of the chunks don't outlive the call, the workers which start later don't
+    // call them.
+    state->NextChunkFunc = nullptr;
+    if (state->Exception)
+    {
+      std::rethrow_exception(state->Exception);
+    }
+    return state->NextChunkId;
+  }
+
+  void SubmitTransferTask(
+      const std::shared_ptr<TransferExecutor>& executor,
+      std::function<void()> task)
+  {
+    // The executor outlives its tasks, the pointer is valid while the task runs.
+    TransferExecutor* executorPointer
+        = executor ? executor.get() : TransferExecutor::GetDefault().get();
+    executorPointer->Submit([executorPointer, task]() {
+      executorPointer->AcquireChunk();
+      task();
+      executorPointer->ReleaseChunk();
+    });
+  }
+
+}}} // namespace Azure::Storage::_internal
@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/congestion_control_policy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <azure/core/http/traffic_class.hpp>
+
+#include "azure/storage/common/internal/constants.hpp"
+
+namespace Azure { namespace Storage {
+
+  namespace _internal {
+
+    namespace {
+      // Waits are split so that a cancelled context is noticed quickly.
+      constexpr std::chrono::milliseconds MaxWaitDuration(100);
+
+      bool IsThrottled(const Core::Http::RawResponse& response)
+      {
+        if (response.GetStatusCode() == Core::Http::HttpStatusCode::ServiceUnavailable
+            || response.GetStatusCode() == Core::Http::HttpStatusCode::TooManyRequests)
+        {
+          return true;
+        }
+        const auto& headers = response.GetHeaders();
+        const auto errorCode = headers.find(HttpHeaderErrorCode);
+        return errorCode != headers.end() && errorCode->second == "ServerBusy";
+      }
+    } // namespace
+
+    CongestionWindow::CongestionWindow(int32_t minLimit, int32_t maxLimit)
+        : m_minLimit(static_cast<double>(minLimit)), m_maxLimit(static_cast<double>(maxLimit)),
+          m_limit(m_maxLimit), m_lastDecrease((std::chrono::steady_clock::time_point::min)())
+    {
+    }
+
+    std::chrono::steady_clock::time_point CongestionWindow::Acquire(
+        const Azure::Core::Context& context)
+    {
+      const bool isBulk
+          = Core::Http::GetTrafficClass(context).ValueOr(Core::Http::TrafficClass::Interactive)
+          == Core::Http::TrafficClass::Bulk;
+      std::unique_lock<std::mutex> guard(m_mutex);
+      if (!isBulk)
+      {
+        ++m_waitingInteractive;
+      }
+      while (m_inFlight >= static_cast<int32_t>(m_limit) || (isBulk && m_waitingInteractive != 0))
+      {
+        if (context.IsCancelled())
+        {
+          if (!isBulk)
+          {
+            --m_waitingInteractive;
+          }
+          guard.unlock();
+          m_released.notify_all();
+          context.ThrowIfCancelled();
+        }
+        m_released.wait_for(guard, MaxWaitDuration);
+      }
+      ++m_inFlight;
+      // The bulk requests waiting for the last interactive one can go if there is room left.
+      const bool wakeBulk = !isBulk && --m_waitingInteractive == 0;
+      guard.unlock();
+      if (wakeBulk)
+      {
+        m_released.notify_all();
+      }
+      return std::chrono::steady_clock::now();
+    }
+
+    void CongestionWindow::Release(Outcome outcome, std::chrono::steady_clock::time_point sendTime)
+    {
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (outcome == Outcome::Throttled)
+        {
+          if (sendTime > m_lastDecrease)
+          {
+            // Halves the requests actually in flight, which may be fewer than the limit.
+            m_limit = std::max(
+                m_minLimit, std::floor(std::min(m_limit, static_cast<double>(m_inFlight)) / 2));
+            m_lastDecrease = std::chrono::steady_clock::now();
+          }
+        }
+        else if (outcome == Outcome::Succeeded)
+        {
+          m_limit = std::min(m_maxLimit, m_limit + 1 / m_limit);
+        }
+        --m_inFlight;
+      }
+      m_released.notify_all();
+    }
+
+    int32_t CongestionWindow::Limit() const
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      return static_cast<int32_t>(m_limit);
+    }
+
+    int32_t CongestionWindow::InFlight() const
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      return m_inFlight;
+    }
+
+    std::unique_ptr<Core::Http::RawResponse> CongestionControlPolicy::Send(
+        Core::Http::Request& request,
+        Core::Http::Policies::NextHttpPolicy nextPolicy,
+        Core::Context const& context) const
+    {
+      auto& window = m_congestionController->GetWindow(request.GetUrl().GetHost());
+      const auto sendTime = window.Acquire(context);
+      std::unique_ptr<Core::Http::RawResponse> response;
+      try
+      {
+        response = nextPolicy.Send(request, context);
+      }
+      catch (...)
+      {
+        window.Release(CongestionWindow::Outcome::Failed, sendTime);
+        throw;
+      }
+      auto outcome = CongestionWindow::Outcome::Failed;
+      if (response)
+      {
+        outcome = IsThrottled(*response) ? CongestionWindow::Outcome::Throttled
+                                         : CongestionWindow::Outcome::Succeeded;
+      }
+      window.Release(outcome, sendTime);
+      return response;
+    }
+
+  } // namespace _internal
+
+  CongestionController::CongestionController(int32_t maxConcurrency, int32_t minConcurrency)
+      : m_maxConcurrency(maxConcurrency), m_minConcurrency(minConcurrency)
+  {
+    if (minConcurrency < 1)
+    {
+      throw std::invalid_argument("minConcurrency must be at least 1.");
+    }
+    if (minConcurrency > maxConcurrency)
+    {
+      throw std::invalid_argument("minConcurrency cannot be greater than maxConcurrency.");
+    }
+  }
+
+  CongestionController::~CongestionController() {}
+
+  int32_t CongestionController::GetConcurrencyLimit(const std::string& host) const
+  {
+    return GetWindow(host).Limit();
+  }
+
+  _internal::CongestionWindow& CongestionController::GetWindow(const std::string& host) const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto& window = m_windows[host];
+    if (!window)
+    {
+      window = std::make_unique<_internal::CongestionWindow>(m_minConcurrency, m_maxConcurrency);
+    }
+    return *window;
+  }
+
+}} // namespace Azure::Storage
@@ -5,26 +5,43 @@
 
 #include <azure/core/platform.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+// The PCLMULQDQ code path is compiled on x86 and used when the CPU supports it at runtime.
+#define AZ_STORAGE_CRC64_PCLMUL
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(AZ_STORAGE_CRC64_PCLMUL) && (defined(__GNUC__) || defined(__clang__))
+#define AZ_STORAGE_CRC64_TARGET(features) __attribute__((target(features)))
+#else
+#define AZ_STORAGE_CRC64_TARGET(features)
+#endif
+
 #if defined(AZ_PLATFORM_WINDOWS)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
 #if !defined(NOMINMAX)
 #define NOMINMAX
 #endif
-// Windows needs to go before bcrypt
 #include <windows.h>
 
 #include <bcrypt.h>
-#elif defined(AZ_PLATFORM_POSIX)
-#include <openssl/bio.h>
-#include <openssl/buffer.h>
+#else
 #include <openssl/evp.h>
-#include <openssl/hmac.h>
-#include <openssl/sha.h>
+#include <openssl/rand.h>
 #endif
 
-#include <algorithm>
-#include <stdexcept>
-#include <vector>
-
 #include <azure/core/http/http.hpp>
 
 #include "azure/storage/common/storage_common.hpp"
@@ -78,152 +95,258 @@ namespace Azure { namespace Storage {
     }
   } // namespace _internal
 
-#if defined(AZ_PLATFORM_WINDOWS)
-
   namespace _internal {
 
-    enum class AlgorithmType
+    std::vector<uint8_t> HmacSha256(
+        const std::vector<uint8_t>& data,
+        const std::vector<uint8_t>& key)
     {
-      HmacSha256,
-    };
+      Core::Cryptography::_internal::HmacSha256 hmac(key);
+      return hmac.Final(data.data(), data.size());
+    }
+
+    HmacSha256Key::HmacSha256Key(const std::vector<uint8_t>& key) : m_hmac(key) {}
 
-    struct AlgorithmProviderInstance final
+    std::vector<uint8_t> HmacSha256Key::Sign(const uint8_t* data, size_t length) const
     {
-      BCRYPT_ALG_HANDLE Handle;
-      size_t ContextSize;
-      size_t HashLength;
+      // The HMAC right after the key was processed is copied, so the key isn't processed again.
+      Core::Cryptography::_internal::HmacSha256 hmac(m_hmac);
+      return hmac.Final(data, length);
+    }
 
-      AlgorithmProviderInstance(AlgorithmType type)
+    Core::Cryptography::_internal::HmacSha256 HmacSha256Key::GetKeyedHmac() const
+    {
+      return m_hmac;
+    }
+
+#if defined(AZ_PLATFORM_WINDOWS)
+    namespace {
+      // The algorithm provider is opened once, the handle can be used concurrently.
+      BCRYPT_ALG_HANDLE GetAesGcmAlgorithm()
       {
-        const wchar_t* algorithmId = nullptr;
-        if (type == AlgorithmType::HmacSha256)
-        {
-          algorithmId = BCRYPT_SHA256_ALGORITHM;
-        }
-        else
-        {
-          throw std::runtime_error("Unknown algorithm type.");
-        }
+        static const BCRYPT_ALG_HANDLE algorithm = []() {
+          BCRYPT_ALG_HANDLE handle = nullptr;
+          if (!BCRYPT_SUCCESS(
+                  BCryptOpenAlgorithmProvider(&handle, BCRYPT_AES_ALGORITHM, nullptr, 0))
+              || !BCRYPT_SUCCESS(BCryptSetProperty(
+                  handle,
+                  BCRYPT_CHAINING_MODE,
+                  reinterpret_cast<PUCHAR>(const_cast<wchar_t*>(BCRYPT_CHAIN_MODE_GCM)),
+                  sizeof(BCRYPT_CHAIN_MODE_GCM),
+                  0)))
+          {
+            throw std::runtime_error("Failed to open the AES-GCM algorithm provider.");
+          }
+          return handle;
+        }();
+        return algorithm;
+      }
 
-        unsigned long algorithmFlags = 0;
-        if (type == AlgorithmType::HmacSha256)
+      // Encrypts or decrypts with a key handle of its own, so that the calls don't share the state
+      // of a key.
+      bool AesGcmCrypt(
+          const std::vector<uint8_t>& key,
+          bool encrypt,
+          const uint8_t* nonce,
+          const uint8_t* input,
+          size_t length,
+          uint8_t* output,
+          uint8_t* tag)
+      {
+        if (length > static_cast<size_t>(std::numeric_limits<ULONG>::max()))
         {
-          algorithmFlags = BCRYPT_ALG_HANDLE_HMAC_FLAG;
+          throw std::invalid_argument("The data to encrypt is too large.");
         }
-        NTSTATUS status
-            = BCryptOpenAlgorithmProvider(&Handle, algorithmId, nullptr, algorithmFlags);
-        if (!BCRYPT_SUCCESS(status))
+        BCRYPT_KEY_HANDLE keyHandle = nullptr;
+        if (!BCRYPT_SUCCESS(BCryptGenerateSymmetricKey(
+                GetAesGcmAlgorithm(),
+                &keyHandle,
+                nullptr,
+                0,
+                const_cast<PUCHAR>(key.data()),
+                static_cast<ULONG>(key.size()),
+                0)))
         {
-          throw std::runtime_error("BCryptOpenAlgorithmProvider failed.");
+          throw std::runtime_error("Failed to create the AES-GCM key.");
         }
-        DWORD objectLength = 0;
-        DWORD dataLength = 0;
-        status = BCryptGetProperty(
-            Handle,
-            BCRYPT_OBJECT_LENGTH,
-            reinterpret_cast<PBYTE>(&objectLength),
-            sizeof(objectLength),
-            &dataLength,
-            0);
-        if (!BCRYPT_SUCCESS(status))
+        BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO authInfo;
+        BCRYPT_INIT_AUTH_MODE_INFO(authInfo);
+        authInfo.pbNonce = const_cast<PUCHAR>(nonce);
+        authInfo.cbNonce = static_cast<ULONG>(AesGcmKey::NonceSize);
+        authInfo.pbTag = tag;
+        authInfo.cbTag = static_cast<ULONG>(AesGcmKey::TagSize);
+        ULONG outputLength = 0;
+        const NTSTATUS status = encrypt
+            ? BCryptEncrypt(
+                keyHandle,
+                const_cast<PUCHAR>(input),
+                static_cast<ULONG>(length),
+                &authInfo,
+                nullptr,
+                0,
+                output,
+                static_cast<ULONG>(length),
+                &outputLength,
+                0)
+            : BCryptDecrypt(
+                keyHandle,
+                const_cast<PUCHAR>(input),
+                static_cast<ULONG>(length),
+                &authInfo,
+                nullptr,
+                0,
+                output,
+                static_cast<ULONG>(length),
+                &outputLength,
+                0);
+        BCryptDestroyKey(keyHandle);
+        // STATUS_AUTH_TAG_MISMATCH, which isn't defined by windows.h.
+        constexpr NTSTATUS AuthTagMismatch = static_cast<NTSTATUS>(0xC000A002L);
+        if (!encrypt && status == AuthTagMismatch)
         {
-          throw std::runtime_error("BCryptGetProperty failed.");
+          return false;
         }
-        ContextSize = objectLength;
-        DWORD hashLength = 0;
-        status = BCryptGetProperty(
-            Handle,
-            BCRYPT_HASH_LENGTH,
-            reinterpret_cast<PBYTE>(&hashLength),
-            sizeof(hashLength),
-            &dataLength,
-            0);
         if (!BCRYPT_SUCCESS(status))
         {
-          throw std::runtime_error("BCryptGetProperty failed.");
+          throw std::runtime_error(
+              encrypt ? "Failed to encrypt with AES-GCM." : "Failed to decrypt with AES-GCM.");
         }
-        HashLength = hashLength;
+        return true;
       }
+    } // namespace
 
-      ~AlgorithmProviderInstance() { BCryptCloseAlgorithmProvider(Handle, 0); }
-    };
-
-    std::vector<uint8_t> HmacSha256(
-        const std::vector<uint8_t>& data,
-        const std::vector<uint8_t>& key)
+    void FillSecureRandomBytes(uint8_t* buffer, size_t length)
     {
-      _azure_ASSERT_MSG(data.size() <= std::numeric_limits<ULONG>::max(), "Data size is too big.");
-
-      static AlgorithmProviderInstance AlgorithmProvider(AlgorithmType::HmacSha256);
-
-      std::string context;
-      context.resize(AlgorithmProvider.ContextSize);
-
-      BCRYPT_HASH_HANDLE hashHandle;
-      NTSTATUS status = BCryptCreateHash(
-          AlgorithmProvider.Handle,
-          &hashHandle,
-          reinterpret_cast<PUCHAR>(&context[0]),
-          static_cast<ULONG>(context.size()),
-          reinterpret_cast<PUCHAR>(const_cast<uint8_t*>(&key[0])),
-          static_cast<ULONG>(key.size()),
-          0);
-      if (!BCRYPT_SUCCESS(status))
+      if (length > static_cast<size_t>(std::numeric_limits<ULONG>::max())
+          || !BCRYPT_SUCCESS(BCryptGenRandom(
+              nullptr, buffer, static_cast<ULONG>(length), BCRYPT_USE_SYSTEM_PREFERRED_RNG)))
       {
-        throw std::runtime_error("BCryptCreateHash failed.");
+        throw std::runtime_error("Failed to generate random bytes.");
       }
-
-      status = BCryptHashData(
-          hashHandle,
-          reinterpret_cast<PBYTE>(const_cast<uint8_t*>(data.data())),
-          static_cast<ULONG>(data.size()),
-          0);
-      if (!BCRYPT_SUCCESS(status))
+    }
+#else
+    namespace {
+      struct CipherContextDeleter final
+      {
+        void operator()(EVP_CIPHER_CTX* context) const { EVP_CIPHER_CTX_free(context); }
+      };
+
+      // Encrypts or decrypts with a cipher context of its own, so that the calls don't share the
+      // state of a key. The data is passed in pieces whose size fits in an int.
+      bool AesGcmCrypt(
+          const std::vector<uint8_t>& key,
+          bool encrypt,
+          const uint8_t* nonce,
+          const uint8_t* input,
+          size_t length,
+          uint8_t* output,
+          uint8_t* tag)
       {
-        throw std::runtime_error("BCryptHashData failed.");
+        std::unique_ptr<EVP_CIPHER_CTX, CipherContextDeleter> context(EVP_CIPHER_CTX_new());
+        if (!context
+            || EVP_CipherInit_ex(
+                   context.get(), EVP_aes_256_gcm(), nullptr, key.data(), nonce, encrypt ? 1 : 0)
+                != 1)
+        {
+          throw std::runtime_error("Failed to initialize AES-GCM.");
+        }
+        constexpr size_t MaxUpdateLength = 1024 * 1024 * 1024;
+        for (size_t offset = 0; offset < length;)
+        {
+          const int updateLength = static_cast<int>(std::min(length - offset, MaxUpdateLength));
+          int outputLength = 0;
+          if (EVP_CipherUpdate(
+                  context.get(), output + offset, &outputLength, input + offset, updateLength)
+              != 1)
+          {
+            throw std::runtime_error("Failed to process data with AES-GCM.");
+          }
+          offset += static_cast<size_t>(updateLength);
+        }
+        if (!encrypt
+            && EVP_CIPHER_CTX_ctrl(
+                   context.get(),
+                   EVP_CTRL_GCM_SET_TAG,
+                   static_cast<int>(AesGcmKey::TagSize),
+                   tag)
+                != 1)
+        {
+          throw std::runtime_error("Failed to set the AES-GCM tag.");
+        }
+        int finalLength = 0;
+        if (EVP_CipherFinal_ex(context.get(), output + length, &finalLength) != 1)
+        {
+          if (!encrypt)
+          {
+            return false;
+          }
+          throw std::runtime_error("Failed to encrypt with AES-GCM.");
+        }
+        if (encrypt
+            && EVP_CIPHER_CTX_ctrl(
+                   context.get(),
+                   EVP_CTRL_GCM_GET_TAG,
+                   static_cast<int>(AesGcmKey::TagSize),
+                   tag)
+                != 1)
+        {
+          throw std::runtime_error("Failed to get the AES-GCM tag.");
+        }
+        return true;
       }
+    } // namespace
 
-      std::vector<uint8_t> hash;
-      hash.resize(AlgorithmProvider.HashLength);
-      status = BCryptFinishHash(
-          hashHandle, reinterpret_cast<PUCHAR>(&hash[0]), static_cast<ULONG>(hash.size()), 0);
-      if (!BCRYPT_SUCCESS(status))
+    void FillSecureRandomBytes(uint8_t* buffer, size_t length)
+    {
+      constexpr size_t MaxRandLength = 1024 * 1024 * 1024;
+      for (size_t offset = 0; offset < length;)
       {
-        throw std::runtime_error("BCryptFinishHash failed.");
+        const int randLength = static_cast<int>(std::min(length - offset, MaxRandLength));
+        if (RAND_bytes(buffer + offset, randLength) != 1)
+        {
+          throw std::runtime_error("Failed to generate random bytes.");
+        }
+        offset += static_cast<size_t>(randLength);
       }
+    }
+#endif
 
-      BCryptDestroyHash(hashHandle);
+    constexpr size_t AesGcmKey::KeySize;
+    constexpr size_t AesGcmKey::NonceSize;
+    constexpr size_t AesGcmKey::TagSize;
 
-      return hash;
+    AesGcmKey::AesGcmKey(const std::vector<uint8_t>& key) : m_key(key)
+    {
+      if (key.size() != KeySize)
+      {
+        throw std::invalid_argument("The AES-GCM key must be 32 bytes.");
+      }
     }
-  } // namespace _internal
 
-#elif defined(AZ_PLATFORM_POSIX)
+    AesGcmKey::~AesGcmKey() { std::fill(m_key.begin(), m_key.end(), uint8_t(0)); }
 
-  namespace _internal {
+    void AesGcmKey::Encrypt(
+        const uint8_t* nonce,
+        const uint8_t* data,
+        size_t length,
+        uint8_t* ciphertext,
+        uint8_t* tag) const
+    {
+      AesGcmCrypt(m_key, true, nonce, data, length, ciphertext, tag);
+    }
 
-    std::vector<uint8_t> HmacSha256(
-        const std::vector<uint8_t>& data,
-        const std::vector<uint8_t>& key)
+    bool AesGcmKey::Decrypt(
+        const uint8_t* nonce,
+        const uint8_t* ciphertext,
+        size_t length,
+        const uint8_t* tag,
+        uint8_t* data) const
     {
-      uint8_t hash[EVP_MAX_MD_SIZE];
-      unsigned int hashLength = 0;
-      HMAC(
-          EVP_sha256(),
-          key.data(),
-          static_cast<int>(key.size()),
-          reinterpret_cast<const unsigned char*>(data.data()),
-          data.size(),
-          reinterpret_cast<unsigned char*>(&hash[0]),
-          &hashLength);
-
-      return std::vector<uint8_t>(std::begin(hash), std::begin(hash) + hashLength);
+      return AesGcmCrypt(m_key, false, nonce, ciphertext, length, data, const_cast<uint8_t*>(tag));
     }
 
   } // namespace _internal
 
-#endif
-
   static constexpr uint64_t Crc64Poly = 0x9A6C9329AC4BC9B5ULL;
   static constexpr uint64_t Crc64MU1[] = {
       0x0000000000000000ULL, 0x7f6ef0c830358979ULL, 0xfedde190606b12f2ULL, 0x81b31158505e9b8bULL,
@@ -855,12 +978,100 @@ namespace Azure { namespace Storage {
     return vr[0] ^ vr[1];
   }
 
+#if defined(AZ_STORAGE_CRC64_PCLMUL)
+#if defined(_MSC_VER)
+  static bool IsPclmulSupported()
+  {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0;
+  }
+#else
+  static bool IsPclmulSupported() { return __builtin_cpu_supports("pclmul"); }
+#endif
+
+  static bool UsePclmul()
+  {
+    static const bool usePclmul = IsPclmulSupported();
+    return usePclmul;
+  }
+
+  // Multiplies both halves of x by the two constants of k and adds the products, which moves the
+  // 128 bits of x forward. Bits are reflected, so the low half holds the highest powers of x.
+  AZ_STORAGE_CRC64_TARGET("pclmul,sse2") static __m128i Crc64Fold(__m128i x, __m128i k)
+  {
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+  }
+
+  // Folds the data 64 bytes at a time into a 128-bit value with the same CRC, using carry-less
+  // multiplications, then computes its CRC with the table. Requires at least 64 bytes and returns
+  // the number of bytes processed, which is a multiple of 16.
+  // See "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction", V. Gopal et al.
+  AZ_STORAGE_CRC64_TARGET("pclmul,sse2")
+  static size_t Crc64AppendPclmul(uint64_t& uCrc, const uint8_t* data, size_t length)
+  {
+    // Each constant is x^n mod Crc64Poly, bit-reflected, to move 64 bits forward by n + 1 bits.
+    __m128i const fold512 = _mm_set_epi64x(
+        static_cast<int64_t>(0x62242240ace5045aULL), static_cast<int64_t>(0x0c32cdb31e18a84aULL));
+    __m128i const fold384 = _mm_set_epi64x(
+        static_cast<int64_t>(0xa3ffdc1fe8e82a8bULL), static_cast<int64_t>(0xbdd7ac0ee1a4a0f0ULL));
+    __m128i const fold256 = _mm_set_epi64x(
+        static_cast<int64_t>(0xe1e0bb9d45d7a44cULL), static_cast<int64_t>(0xb0bc2e589204f500ULL));
+    __m128i const fold128 = _mm_set_epi64x(
+        static_cast<int64_t>(0x21e9761e252621acULL), static_cast<int64_t>(0xeadc41fd2ba3d420ULL));
+
+    const __m128i* blocks = reinterpret_cast<const __m128i*>(data);
+    __m128i x0 = _mm_xor_si128(
+        _mm_loadu_si128(blocks), _mm_set_epi64x(0, static_cast<int64_t>(uCrc)));
+    __m128i x1 = _mm_loadu_si128(blocks + 1);
+    __m128i x2 = _mm_loadu_si128(blocks + 2);
+    __m128i x3 = _mm_loadu_si128(blocks + 3);
+    size_t offset = 64;
+
+    for (; length - offset >= 64; offset += 64)
+    {
+      blocks = reinterpret_cast<const __m128i*>(data + offset);
+      x0 = _mm_xor_si128(Crc64Fold(x0, fold512), _mm_loadu_si128(blocks));
+      x1 = _mm_xor_si128(Crc64Fold(x1, fold512), _mm_loadu_si128(blocks + 1));
+      x2 = _mm_xor_si128(Crc64Fold(x2, fold512), _mm_loadu_si128(blocks + 2));
+      x3 = _mm_xor_si128(Crc64Fold(x3, fold512), _mm_loadu_si128(blocks + 3));
+    }
+
+    __m128i x = _mm_xor_si128(
+        _mm_xor_si128(Crc64Fold(x0, fold384), Crc64Fold(x1, fold256)),
+        _mm_xor_si128(Crc64Fold(x2, fold128), x3));
+    for (; length - offset >= 16; offset += 16)
+    {
+      x = _mm_xor_si128(
+          Crc64Fold(x, fold128), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)));
+    }
+
+    uint8_t folded[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), x);
+    uCrc = 0;
+    for (uint8_t b : folded)
+    {
+      uCrc = (uCrc >> 8) ^ Crc64MU1[(uCrc ^ b) & 0xff];
+    }
+    return offset;
+  }
+#endif
+
   void Crc64Hash::OnAppend(const uint8_t* data, size_t length)
   {
     m_length += length;
 
     uint64_t uCrc = m_context ^ ~0ULL;
 
+#if defined(AZ_STORAGE_CRC64_PCLMUL)
+    if (length >= 64 && UsePclmul())
+    {
+      size_t const processed = Crc64AppendPclmul(uCrc, data, length);
+      data += processed;
+      length -= processed;
+    }
+#endif
+
     uint64_t pData = 0;
 
     size_t uStop = length - (length % 32);
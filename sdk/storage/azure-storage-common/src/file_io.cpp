@@ -5,13 +5,22 @@
 
 #include <azure/core/platform.hpp>
 
+#include "azure/storage/common/internal/pooled_buffer.hpp"
+
 #if defined(AZ_PLATFORM_POSIX)
+#include <dirent.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
 
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
 #if defined(AZ_PLATFORM_WINDOWS)
 #if !defined(WIN32_LEAN_AND_MEAN)
 #define WIN32_LEAN_AND_MEAN
@@ -20,39 +29,366 @@
 #define NOMINMAX
 #endif
 #include <windows.h>
+#include <winioctl.h>
 #endif
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace Azure { namespace Storage { namespace _internal {
 
+  namespace {
+    // The largest buffer of an UnbufferedFileBodyStream.
+    constexpr int64_t MaxUnbufferedReadSize = 4 * 1024 * 1024;
+    constexpr int64_t Alignment = static_cast<int64_t>(UnbufferedIoAlignment);
+
+    bool CanMap(int64_t fileSize)
+    {
+      return fileSize > 0 && static_cast<uint64_t>(fileSize) <= std::numeric_limits<size_t>::max();
+    }
+
+    bool IsAligned(uint64_t value) { return value % UnbufferedIoAlignment == 0; }
+
+    bool IsAligned(const uint8_t* address)
+    {
+      return IsAligned(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(address)));
+    }
+
 #if defined(AZ_PLATFORM_WINDOWS)
-  FileReader::FileReader(const std::string& filename)
+    std::wstring ToWideString(const std::string& filename)
+    {
+      int sizeNeeded = MultiByteToWideChar(
+          CP_UTF8,
+          MB_ERR_INVALID_CHARS,
+          filename.data(),
+          static_cast<int>(filename.length()),
+          nullptr,
+          0);
+      if (sizeNeeded == 0)
+      {
+        throw std::runtime_error("Invalid filename.");
+      }
+      std::wstring filenameW(sizeNeeded, L'\0');
+      if (MultiByteToWideChar(
+              CP_UTF8,
+              MB_ERR_INVALID_CHARS,
+              filename.data(),
+              static_cast<int>(filename.length()),
+              &filenameW[0],
+              sizeNeeded)
+          == 0)
+      {
+        throw std::runtime_error("Invalid filename.");
+      }
+      return filenameW;
+    }
+
+    std::string ToUtf8String(const wchar_t* filenameW)
+    {
+      int sizeNeeded
+          = WideCharToMultiByte(CP_UTF8, 0, filenameW, -1, nullptr, 0, nullptr, nullptr);
+      if (sizeNeeded == 0)
+      {
+        throw std::runtime_error("Invalid filename.");
+      }
+      std::string filename(sizeNeeded, '\0');
+      if (WideCharToMultiByte(
+              CP_UTF8, 0, filenameW, -1, &filename[0], sizeNeeded, nullptr, nullptr)
+          == 0)
+      {
+        throw std::runtime_error("Invalid filename.");
+      }
+      // The terminating null character is counted in sizeNeeded.
+      filename.pop_back();
+      return filename;
+    }
+
+    // Opens a second handle of a file bypassing the system cache, or returns
+    // INVALID_HANDLE_VALUE.
+    HANDLE OpenUnbuffered(const std::wstring& filenameW, DWORD desiredAccess)
+    {
+#if !defined(WINAPI_PARTITION_DESKTOP) \
+    || WINAPI_PARTITION_DESKTOP // See azure/core/platform.hpp for explanation.
+      return CreateFileW(
+          filenameW.data(),
+          desiredAccess,
+          FILE_SHARE_READ | FILE_SHARE_WRITE,
+          nullptr,
+          OPEN_EXISTING,
+          FILE_FLAG_NO_BUFFERING,
+          NULL);
+#else
+      (void)filenameW;
+      (void)desiredAccess;
+      return INVALID_HANDLE_VALUE;
+#endif
+    }
+
+    void WriteAt(FileHandle handle, const uint8_t* buffer, size_t length, int64_t offset)
+    {
+      if (length == 0)
+      {
+        return;
+      }
+      if (length > std::numeric_limits<DWORD>::max())
+      {
+        throw std::runtime_error("Failed to write file.");
+      }
+
+      OVERLAPPED overlapped;
+      std::memset(&overlapped, 0, sizeof(overlapped));
+      overlapped.Offset = static_cast<DWORD>(static_cast<uint64_t>(offset));
+      overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+
+      DWORD bytesWritten;
+      BOOL ret = WriteFile(
+          static_cast<HANDLE>(handle),
+          buffer,
+          static_cast<DWORD>(length),
+          &bytesWritten,
+          &overlapped);
+      if (!ret)
+      {
+        throw std::runtime_error("Failed to write file.");
+      }
+    }
+#elif defined(AZ_PLATFORM_POSIX)
+    // Opens a second descriptor of a file bypassing the page cache, or returns -1.
+    int OpenUnbuffered(const std::string& filename, int flags)
+    {
+#if defined(O_DIRECT)
+      return open(filename.data(), flags | O_DIRECT);
+#elif defined(F_NOCACHE)
+      int fd = open(filename.data(), flags);
+      if (fd != -1 && fcntl(fd, F_NOCACHE, 1) == -1)
+      {
+        close(fd);
+        fd = -1;
+      }
+      return fd;
+#else
+      (void)filename;
+      (void)flags;
+      return -1;
+#endif
+    }
+
+    void WriteAt(FileHandle handle, const uint8_t* buffer, size_t length, int64_t offset)
+    {
+      if (length == 0)
+      {
+        return;
+      }
+      if (offset > static_cast<int64_t>(std::numeric_limits<off_t>::max()))
+      {
+        throw std::runtime_error("Failed to write file.");
+      }
+      ssize_t bytesWritten = pwrite(handle, buffer, length, static_cast<off_t>(offset));
+      if (bytesWritten < 0 || static_cast<size_t>(bytesWritten) != length)
+      {
+        throw std::runtime_error("Failed to write file.");
+      }
+    }
+#endif
+
+    // Calls writeAt with the parts of a write to a FileWriter, with the part aligned for an
+    // unbuffered write to unbufferedHandle when unbuffered is true.
+    template <class WriteAtFunc>
+    void SplitWrite(
+        bool unbuffered,
+        FileHandle handle,
+        FileHandle unbufferedHandle,
+        const uint8_t* buffer,
+        size_t length,
+        int64_t offset,
+        WriteAtFunc writeAt)
+    {
+      if (unbuffered)
+      {
+        const size_t headLength
+            = std::min(length, static_cast<size_t>((Alignment - offset % Alignment) % Alignment));
+        const size_t alignedLength
+            = (length - headLength) / UnbufferedIoAlignment * UnbufferedIoAlignment;
+        if (alignedLength != 0 && IsAligned(buffer + headLength))
+        {
+          const int64_t alignedOffset = offset + static_cast<int64_t>(headLength);
+          writeAt(handle, buffer, headLength, offset);
+          writeAt(unbufferedHandle, buffer + headLength, alignedLength, alignedOffset);
+          writeAt(
+              handle,
+              buffer + headLength + alignedLength,
+              length - headLength - alignedLength,
+              alignedOffset + static_cast<int64_t>(alignedLength));
+          return;
+        }
+      }
+      writeAt(handle, buffer, length, offset);
+    }
+
+    void WriteZeros(FileHandle handle, int64_t offset, int64_t length)
+    {
+      const std::vector<uint8_t> zeros(
+          static_cast<size_t>(std::min<int64_t>(length, MaxUnbufferedReadSize)), 0);
+      while (length > 0)
+      {
+        const size_t writeSize = static_cast<size_t>(std::min<int64_t>(length, zeros.size()));
+        WriteAt(handle, zeros.data(), writeSize, offset);
+        offset += static_cast<int64_t>(writeSize);
+        length -= static_cast<int64_t>(writeSize);
+      }
+    }
+  } // namespace
+
+  AlignedBuffer::AlignedBuffer(size_t size) : AlignedBuffer(size, -1, false) {}
+
+  AlignedBuffer::AlignedBuffer(size_t size, int numaNode, bool useHugePages)
+      : m_size(size)
   {
-    int sizeNeeded = MultiByteToWideChar(
-        CP_UTF8,
-        MB_ERR_INVALID_CHARS,
-        filename.data(),
-        static_cast<int>(filename.length()),
-        nullptr,
-        0);
-    if (sizeNeeded == 0)
+#if defined(__linux__)
+    if ((numaNode >= 0 || useHugePages) && size != 0)
+    {
+      // Transparent huge pages only back the ranges aligned to their size, so the mapping is
+      // aligned by mapping more and unmapping the ends.
+      constexpr size_t HugePageSize = 2 * 1024 * 1024;
+      const size_t alignment = useHugePages ? HugePageSize : UnbufferedIoAlignment;
+      const size_t mappingSize = (size + alignment - 1) / alignment * alignment;
+      const size_t reservedSize = mappingSize + alignment - UnbufferedIoAlignment;
+      void* reserved
+          = mmap(nullptr, reservedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (reserved != MAP_FAILED)
+      {
+        uint8_t* const reservedBegin = static_cast<uint8_t*>(reserved);
+        uint8_t* const begin = reservedBegin
+            + (alignment - reinterpret_cast<uintptr_t>(reserved) % alignment) % alignment;
+        if (begin != reservedBegin)
+        {
+          munmap(reservedBegin, static_cast<size_t>(begin - reservedBegin));
+        }
+        const size_t tailSize = reservedSize - static_cast<size_t>(begin - reservedBegin)
+            - mappingSize;
+        if (tailSize != 0)
+        {
+          munmap(begin + mappingSize, tailSize);
+        }
+        m_mapping = begin;
+        m_mappingSize = mappingSize;
+        m_data = begin;
+
+        // Both are hints, applied before the pages are touched: the buffer works without them.
+#if defined(MADV_HUGEPAGE)
+        if (useHugePages)
+        {
+          madvise(begin, mappingSize, MADV_HUGEPAGE);
+        }
+#endif
+#if defined(__NR_mbind)
+        if (numaNode >= 0)
+        {
+          constexpr size_t BitsPerMask = sizeof(unsigned long) * 8;
+          std::vector<unsigned long> nodeMask(static_cast<size_t>(numaNode) / BitsPerMask + 1, 0);
+          nodeMask.back() |= 1UL << (static_cast<size_t>(numaNode) % BitsPerMask);
+          syscall(
+              __NR_mbind,
+              begin,
+              mappingSize,
+              MPOL_PREFERRED,
+              nodeMask.data(),
+              nodeMask.size() * BitsPerMask + 1,
+              0);
+        }
+#endif
+        return;
+      }
+    }
+#elif defined(AZ_PLATFORM_WINDOWS) \
+    && (!defined(WINAPI_PARTITION_DESKTOP) \
+        || WINAPI_PARTITION_DESKTOP) // See azure/core/platform.hpp for explanation.
+    if ((numaNode >= 0 || useHugePages) && size != 0)
+    {
+      const DWORD preferredNode
+          = numaNode >= 0 ? static_cast<DWORD>(numaNode) : NUMA_NO_PREFERRED_NODE;
+      // Large pages need the SeLockMemoryPrivilege, regular pages are used without it.
+      const size_t largePageSize = useHugePages ? GetLargePageMinimum() : 0;
+      if (largePageSize != 0)
+      {
+        const size_t mappingSize = (size + largePageSize - 1) / largePageSize * largePageSize;
+        m_mapping = VirtualAllocExNuma(
+            GetCurrentProcess(),
+            nullptr,
+            mappingSize,
+            MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+            PAGE_READWRITE,
+            preferredNode);
+      }
+      if (m_mapping == nullptr)
+      {
+        m_mapping = VirtualAllocExNuma(
+            GetCurrentProcess(),
+            nullptr,
+            size,
+            MEM_RESERVE | MEM_COMMIT,
+            PAGE_READWRITE,
+            preferredNode);
+      }
+      if (m_mapping != nullptr)
+      {
+        m_data = static_cast<uint8_t*>(m_mapping);
+        return;
+      }
+    }
+#else
+    (void)numaNode;
+    (void)useHugePages;
+#endif
+
+    m_storage = std::make_unique<uint8_t[]>(size + UnbufferedIoAlignment);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(m_storage.get());
+    m_data = m_storage.get()
+        + (UnbufferedIoAlignment - address % UnbufferedIoAlignment) % UnbufferedIoAlignment;
+  }
+
+  AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept
+  {
+    if (this != &other)
     {
-      throw std::runtime_error("Invalid filename.");
+      Unmap();
+      m_storage = std::move(other.m_storage);
+      m_mapping = other.m_mapping;
+      m_mappingSize = other.m_mappingSize;
+      m_data = other.m_data;
+      m_size = other.m_size;
+      other.m_mapping = nullptr;
+      other.m_mappingSize = 0;
+      other.m_data = nullptr;
+      other.m_size = 0;
     }
-    std::wstring filenameW(sizeNeeded, L'\0');
-    if (MultiByteToWideChar(
-            CP_UTF8,
-            MB_ERR_INVALID_CHARS,
-            filename.data(),
-            static_cast<int>(filename.length()),
-            &filenameW[0],
-            sizeNeeded)
-        == 0)
+    return *this;
+  }
+
+  void AlignedBuffer::Unmap() noexcept
+  {
+    if (m_mapping == nullptr)
     {
-      throw std::runtime_error("Invalid filename.");
+      return;
     }
+#if defined(AZ_PLATFORM_WINDOWS)
+    VirtualFree(m_mapping, 0, MEM_RELEASE);
+#elif defined(AZ_PLATFORM_POSIX)
+    munmap(m_mapping, m_mappingSize);
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+  }
+
+#if defined(AZ_PLATFORM_WINDOWS)
+  FileReader::FileReader(const std::string& filename, FileIoMode mode)
+  {
+    const std::wstring filenameW = ToWideString(filename);
 
     HANDLE fileHandle;
 
@@ -83,87 +419,286 @@ namespace Azure { namespace Storage { namespace _internal {
     }
     m_handle = static_cast<void*>(fileHandle);
     m_fileSize = fileSize.QuadPart;
+
+#if !defined(WINAPI_PARTITION_DESKTOP) \
+    || WINAPI_PARTITION_DESKTOP // See azure/core/platform.hpp for explanation.
+    if (mode == FileIoMode::MemoryMapped && CanMap(m_fileSize))
+    {
+      HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mappingHandle != NULL)
+      {
+        void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (view != nullptr)
+        {
+          m_mappingHandle = static_cast<void*>(mappingHandle);
+          m_mappedData = static_cast<const uint8_t*>(view);
+        }
+        else
+        {
+          CloseHandle(mappingHandle);
+        }
+      }
+    }
+#endif
+    if (mode == FileIoMode::Unbuffered)
+    {
+      HANDLE unbufferedHandle = OpenUnbuffered(filenameW, GENERIC_READ);
+      if (unbufferedHandle != INVALID_HANDLE_VALUE)
+      {
+        m_unbufferedHandle = static_cast<void*>(unbufferedHandle);
+        m_unbuffered = true;
+      }
+    }
   }
 
-  FileReader::~FileReader() { CloseHandle(static_cast<HANDLE>(m_handle)); }
+  FileReader::~FileReader()
+  {
+    if (m_mappedData != nullptr)
+    {
+      UnmapViewOfFile(m_mappedData);
+      CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if (m_unbuffered)
+    {
+      CloseHandle(static_cast<HANDLE>(m_unbufferedHandle));
+    }
+    CloseHandle(static_cast<HANDLE>(m_handle));
+  }
 
-  FileWriter::FileWriter(const std::string& filename)
+  size_t FileReader::ReadUnbuffered(uint8_t* buffer, size_t length, int64_t offset) const
   {
-    int sizeNeeded = MultiByteToWideChar(
-        CP_UTF8,
-        MB_ERR_INVALID_CHARS,
-        filename.data(),
-        static_cast<int>(filename.length()),
-        nullptr,
-        0);
-    if (sizeNeeded == 0)
+    if (length > std::numeric_limits<DWORD>::max())
     {
-      throw std::runtime_error("Invalid filename.");
+      throw std::runtime_error("Failed to read file.");
     }
-    std::wstring filenameW(sizeNeeded, L'\0');
-    if (MultiByteToWideChar(
-            CP_UTF8,
-            MB_ERR_INVALID_CHARS,
-            filename.data(),
-            static_cast<int>(filename.length()),
-            &filenameW[0],
-            sizeNeeded)
-        == 0)
+
+    OVERLAPPED overlapped;
+    std::memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = static_cast<DWORD>(static_cast<uint64_t>(offset));
+    overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+
+    DWORD bytesRead;
+    BOOL ret = ReadFile(
+        static_cast<HANDLE>(m_unbufferedHandle),
+        buffer,
+        static_cast<DWORD>(length),
+        &bytesRead,
+        &overlapped);
+    if (!ret)
     {
-      throw std::runtime_error("Invalid filename.");
+      if (GetLastError() == ERROR_HANDLE_EOF)
+      {
+        return 0;
+      }
+      throw std::runtime_error("Failed to read file.");
     }
+    return static_cast<size_t>(bytesRead);
+  }
+
+  FileWriter::FileWriter(const std::string& filename, FileIoMode mode, bool truncate)
+      : m_mode(mode)
+  {
+    const std::wstring filenameW = ToWideString(filename);
+    const DWORD creationDisposition = truncate ? CREATE_ALWAYS : OPEN_ALWAYS;
 
     HANDLE fileHandle;
+    // Mapping a file for writing requires read access too.
+    const DWORD desiredAccess
+        = mode == FileIoMode::MemoryMapped ? GENERIC_READ | GENERIC_WRITE : GENERIC_WRITE;
 
 #if !defined(WINAPI_PARTITION_DESKTOP) \
     || WINAPI_PARTITION_DESKTOP // See azure/core/platform.hpp for explanation.
     fileHandle = CreateFileW(
         filenameW.data(),
-        GENERIC_WRITE,
+        desiredAccess,
         FILE_SHARE_READ | FILE_SHARE_WRITE,
         nullptr,
-        CREATE_ALWAYS,
+        creationDisposition,
         FILE_ATTRIBUTE_NORMAL,
         NULL);
 #else
     fileHandle = CreateFile2(
-        filenameW.data(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, CREATE_ALWAYS, NULL);
+        filenameW.data(),
+        desiredAccess,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        creationDisposition,
+        NULL);
 #endif
     if (fileHandle == INVALID_HANDLE_VALUE)
     {
       throw std::runtime_error("Failed to open file.");
     }
     m_handle = static_cast<void*>(fileHandle);
+
+    if (mode == FileIoMode::Unbuffered)
+    {
+      HANDLE unbufferedHandle = OpenUnbuffered(filenameW, GENERIC_WRITE);
+      if (unbufferedHandle != INVALID_HANDLE_VALUE)
+      {
+        m_unbufferedHandle = static_cast<void*>(unbufferedHandle);
+        m_unbuffered = true;
+      }
+    }
   }
 
-  FileWriter::~FileWriter() { CloseHandle(static_cast<HANDLE>(m_handle)); }
+  FileWriter::~FileWriter()
+  {
+    if (m_mappedData != nullptr)
+    {
+      UnmapViewOfFile(m_mappedData);
+      CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if (m_unbuffered)
+    {
+      CloseHandle(static_cast<HANDLE>(m_unbufferedHandle));
+    }
+    CloseHandle(static_cast<HANDLE>(m_handle));
+  }
 
-  void FileWriter::Write(const uint8_t* buffer, size_t length, int64_t offset)
+  uint8_t* FileWriter::Map(int64_t fileSize)
   {
-    if (length > std::numeric_limits<DWORD>::max())
+#if !defined(WINAPI_PARTITION_DESKTOP) \
+    || WINAPI_PARTITION_DESKTOP // See azure/core/platform.hpp for explanation.
+    if (m_mode != FileIoMode::MemoryMapped || m_mappedData != nullptr || !CanMap(fileSize))
+    {
+      return nullptr;
+    }
+    HANDLE fileHandle = static_cast<HANDLE>(m_handle);
+    LARGE_INTEGER size;
+    size.QuadPart = fileSize;
+    if (!SetFilePointerEx(fileHandle, size, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle))
+    {
+      return nullptr;
+    }
+    HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    if (mappingHandle == NULL)
     {
-      throw std::runtime_error("Failed to write file.");
+      return nullptr;
     }
+    void* view = MapViewOfFile(mappingHandle, FILE_MAP_WRITE, 0, 0, 0);
+    if (view == nullptr)
+    {
+      CloseHandle(mappingHandle);
+      return nullptr;
+    }
+    m_mappingHandle = static_cast<void*>(mappingHandle);
+    m_mappedData = static_cast<uint8_t*>(view);
+    m_mappedSize = fileSize;
+    return m_mappedData;
+#else
+    (void)fileSize;
+    return nullptr;
+#endif
+  }
 
-    OVERLAPPED overlapped;
-    std::memset(&overlapped, 0, sizeof(overlapped));
-    overlapped.Offset = static_cast<DWORD>(static_cast<uint64_t>(offset));
-    overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+  void FileWriter::ResizeSparse(int64_t fileSize)
+  {
+    HANDLE fileHandle = static_cast<HANDLE>(m_handle);
+#if !defined(WINAPI_PARTITION_DESKTOP) \
+    || WINAPI_PARTITION_DESKTOP // See azure/core/platform.hpp for explanation.
+    // Without the sparse attribute, NTFS allocates and zeroes the clusters up to the end of file.
+    // The file is still resized if the file system doesn't support it.
+    DWORD bytesReturned = 0;
+    DeviceIoControl(
+        fileHandle, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytesReturned, nullptr);
+#endif
+    LARGE_INTEGER size;
+    size.QuadPart = fileSize;
+    if (!SetFilePointerEx(fileHandle, size, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle))
+    {
+      throw std::runtime_error("Failed to resize file.");
+    }
+  }
 
-    DWORD bytesWritten;
-    BOOL ret = WriteFile(
-        static_cast<HANDLE>(m_handle),
-        buffer,
-        static_cast<DWORD>(length),
-        &bytesWritten,
-        &overlapped);
-    if (!ret)
+  void FileWriter::ZeroRange(int64_t offset, int64_t length)
+  {
+    if (length <= 0)
+    {
+      return;
+    }
+#if !defined(WINAPI_PARTITION_DESKTOP) \
+    || WINAPI_PARTITION_DESKTOP // See azure/core/platform.hpp for explanation.
+    // The clusters of a sparse file are deallocated.
+    FILE_ZERO_DATA_INFORMATION zeroData;
+    zeroData.FileOffset.QuadPart = offset;
+    zeroData.BeyondFinalZero.QuadPart = offset + length;
+    DWORD bytesReturned = 0;
+    if (DeviceIoControl(
+            static_cast<HANDLE>(m_handle),
+            FSCTL_SET_ZERO_DATA,
+            &zeroData,
+            sizeof(zeroData),
+            nullptr,
+            0,
+            &bytesReturned,
+            nullptr))
+    {
+      return;
+    }
+#endif
+    WriteZeros(m_handle, offset, length);
+  }
+
+  std::vector<std::string> ListFilesRecursively(const std::string& directory)
+  {
+    std::vector<std::string> files;
+    std::vector<std::string> pendingDirectories{std::string()};
+    while (!pendingDirectories.empty())
+    {
+      const std::string relativeDirectory = std::move(pendingDirectories.back());
+      pendingDirectories.pop_back();
+      const std::wstring patternW = ToWideString(
+          (relativeDirectory.empty() ? directory : directory + "/" + relativeDirectory) + "/*");
+      WIN32_FIND_DATAW findData;
+      HANDLE findHandle = FindFirstFileExW(
+          patternW.data(), FindExInfoBasic, &findData, FindExSearchNameMatch, nullptr, 0);
+      if (findHandle == INVALID_HANDLE_VALUE)
+      {
+        throw std::runtime_error("Failed to list directory.");
+      }
+      do
+      {
+        const std::string name = ToUtf8String(findData.cFileName);
+        if (name == "." || name == "..")
+        {
+          continue;
+        }
+        std::string path = relativeDirectory.empty() ? name : relativeDirectory + "/" + name;
+        if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+        {
+          files.push_back(std::move(path));
+        }
+        // Directory junctions and symbolic links aren't followed, they could make a cycle.
+        else if ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0)
+        {
+          pendingDirectories.push_back(std::move(path));
+        }
+      } while (FindNextFileW(findHandle, &findData));
+      FindClose(findHandle);
+    }
+    return files;
+  }
+
+  void CreateDirectories(const std::string& path)
+  {
+    // The parents which can't be created, such as the drive, are expected to exist.
+    for (size_t position = path.find_first_of("/\\", 1); position != std::string::npos;
+         position = path.find_first_of("/\\", position + 1))
+    {
+      CreateDirectoryW(ToWideString(path.substr(0, position)).data(), nullptr);
+    }
+    const std::wstring pathW = ToWideString(path);
+    if (!CreateDirectoryW(pathW.data(), nullptr))
     {
-      throw std::runtime_error("Failed to write file.");
+      const DWORD attributes = GetFileAttributesW(pathW.data());
+      if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+      {
+        throw std::runtime_error("Failed to create directory.");
+      }
     }
   }
 #elif defined(AZ_PLATFORM_POSIX)
-  FileReader::FileReader(const std::string& filename)
+  FileReader::FileReader(const std::string& filename, FileIoMode mode)
   {
     m_handle = open(filename.data(), O_RDONLY);
     if (m_handle == -1)
@@ -176,34 +711,310 @@ namespace Azure { namespace Storage { namespace _internal {
       close(m_handle);
       throw std::runtime_error("Failed to get size of file.");
     }
+
+    if (mode == FileIoMode::MemoryMapped && CanMap(m_fileSize))
+    {
+      void* data
+          = mmap(nullptr, static_cast<size_t>(m_fileSize), PROT_READ, MAP_SHARED, m_handle, 0);
+      if (data != MAP_FAILED)
+      {
+        m_mappedData = static_cast<const uint8_t*>(data);
+      }
+    }
+    if (mode == FileIoMode::Unbuffered)
+    {
+      m_unbufferedHandle = OpenUnbuffered(filename, O_RDONLY);
+      m_unbuffered = m_unbufferedHandle != -1;
+    }
+  }
+
+  FileReader::~FileReader()
+  {
+    if (m_mappedData != nullptr)
+    {
+      munmap(
+          const_cast<void*>(static_cast<const void*>(m_mappedData)),
+          static_cast<size_t>(m_fileSize));
+    }
+    if (m_unbuffered)
+    {
+      close(m_unbufferedHandle);
+    }
+    close(m_handle);
   }
 
-  FileReader::~FileReader() { close(m_handle); }
+  size_t FileReader::ReadUnbuffered(uint8_t* buffer, size_t length, int64_t offset) const
+  {
+    if (offset > static_cast<int64_t>(std::numeric_limits<off_t>::max()))
+    {
+      throw std::runtime_error("Failed to read file.");
+    }
+    size_t totalRead = 0;
+    while (totalRead < length)
+    {
+      ssize_t bytesRead = pread(
+          m_unbufferedHandle,
+          buffer + totalRead,
+          length - totalRead,
+          static_cast<off_t>(offset + static_cast<int64_t>(totalRead)));
+      if (bytesRead < 0)
+      {
+        throw std::runtime_error("Failed to read file.");
+      }
+      if (bytesRead == 0)
+      {
+        break;
+      }
+      totalRead += static_cast<size_t>(bytesRead);
+      // Only the last read of the file may end on an unaligned offset.
+      if (!IsAligned(totalRead))
+      {
+        break;
+      }
+    }
+    return totalRead;
+  }
 
-  FileWriter::FileWriter(const std::string& filename)
+  FileWriter::FileWriter(const std::string& filename, FileIoMode mode, bool truncate)
+      : m_mode(mode)
   {
+    // Mapping a file for writing requires read access too.
     m_handle = open(
-        filename.data(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        filename.data(),
+        (mode == FileIoMode::MemoryMapped ? O_RDWR : O_WRONLY) | O_CREAT | (truncate ? O_TRUNC : 0),
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
     if (m_handle == -1)
     {
       throw std::runtime_error("Failed to open file.");
     }
+
+    if (mode == FileIoMode::Unbuffered)
+    {
+      m_unbufferedHandle = OpenUnbuffered(filename, O_WRONLY);
+      m_unbuffered = m_unbufferedHandle != -1;
+    }
   }
 
-  FileWriter::~FileWriter() { close(m_handle); }
+  FileWriter::~FileWriter()
+  {
+    if (m_mappedData != nullptr)
+    {
+      munmap(m_mappedData, static_cast<size_t>(m_mappedSize));
+    }
+    if (m_unbuffered)
+    {
+      close(m_unbufferedHandle);
+    }
+    close(m_handle);
+  }
 
-  void FileWriter::Write(const uint8_t* buffer, size_t length, int64_t offset)
+  uint8_t* FileWriter::Map(int64_t fileSize)
   {
-    if (offset > static_cast<int64_t>(std::numeric_limits<off_t>::max()))
+    if (m_mode != FileIoMode::MemoryMapped || m_mappedData != nullptr || !CanMap(fileSize)
+        || fileSize > static_cast<int64_t>(std::numeric_limits<off_t>::max()))
+    {
+      return nullptr;
+    }
+    // The disk space is allocated upfront where possible, running out of it while writing to the
+    // mapped pages would raise SIGBUS instead of failing a write.
+#if defined(__APPLE__)
+    if (ftruncate(m_handle, static_cast<off_t>(fileSize)) != 0)
+#else
+    if (posix_fallocate(m_handle, 0, static_cast<off_t>(fileSize)) != 0)
+#endif
+    {
+      return nullptr;
+    }
+    void* data = mmap(
+        nullptr, static_cast<size_t>(fileSize), PROT_READ | PROT_WRITE, MAP_SHARED, m_handle, 0);
+    if (data == MAP_FAILED)
     {
-      throw std::runtime_error("Failed to write file.");
+      return nullptr;
     }
-    ssize_t bytesWritten = pwrite(m_handle, buffer, length, static_cast<off_t>(offset));
-    if (bytesWritten < 0 || static_cast<size_t>(bytesWritten) != length)
+    m_mappedData = static_cast<uint8_t*>(data);
+    m_mappedSize = fileSize;
+    return m_mappedData;
+  }
+
+  void FileWriter::ResizeSparse(int64_t fileSize)
+  {
+    // Growing a file with ftruncate() leaves a hole, the disk space is allocated when written.
+    if (fileSize > static_cast<int64_t>(std::numeric_limits<off_t>::max())
+        || ftruncate(m_handle, static_cast<off_t>(fileSize)) != 0)
     {
-      throw std::runtime_error("Failed to write file.");
+      throw std::runtime_error("Failed to resize file.");
     }
   }
+
+  void FileWriter::ZeroRange(int64_t offset, int64_t length)
+  {
+    if (length <= 0)
+    {
+      return;
+    }
+#if defined(FALLOC_FL_PUNCH_HOLE)
+    if (offset <= static_cast<int64_t>(std::numeric_limits<off_t>::max()) - length
+        && fallocate(
+               m_handle,
+               FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+               static_cast<off_t>(offset),
+               static_cast<off_t>(length))
+            == 0)
+    {
+      return;
+    }
 #endif
+    WriteZeros(m_handle, offset, length);
+  }
+
+  std::vector<std::string> ListFilesRecursively(const std::string& directory)
+  {
+    std::vector<std::string> files;
+    std::vector<std::string> pendingDirectories{std::string()};
+    while (!pendingDirectories.empty())
+    {
+      const std::string relativeDirectory = std::move(pendingDirectories.back());
+      pendingDirectories.pop_back();
+      const std::string absoluteDirectory
+          = relativeDirectory.empty() ? directory : directory + "/" + relativeDirectory;
+      DIR* directoryHandle = opendir(absoluteDirectory.data());
+      if (directoryHandle == nullptr)
+      {
+        throw std::runtime_error("Failed to list directory.");
+      }
+      while (const dirent* entry = readdir(directoryHandle))
+      {
+        const std::string name = entry->d_name;
+        if (name == "." || name == "..")
+        {
+          continue;
+        }
+        std::string path = relativeDirectory.empty() ? name : relativeDirectory + "/" + name;
+        struct stat fileStatus;
+        if (lstat((absoluteDirectory + "/" + name).data(), &fileStatus) != 0)
+        {
+          continue;
+        }
+        if (S_ISDIR(fileStatus.st_mode))
+        {
+          pendingDirectories.push_back(std::move(path));
+        }
+        // Symbolic links to files are followed, the ones to directories aren't, they could make
+        // a cycle.
+        else if (
+            S_ISREG(fileStatus.st_mode)
+            || (S_ISLNK(fileStatus.st_mode)
+                && stat((absoluteDirectory + "/" + name).data(), &fileStatus) == 0
+                && S_ISREG(fileStatus.st_mode)))
+        {
+          files.push_back(std::move(path));
+        }
+      }
+      closedir(directoryHandle);
+    }
+    return files;
+  }
+
+  void CreateDirectories(const std::string& path)
+  {
+    // The parents which can't be created, such as the ones without permission, are expected to
+    // exist.
+    for (size_t position = path.find('/', 1); position != std::string::npos;
+         position = path.find('/', position + 1))
+    {
+      mkdir(path.substr(0, position).data(), 0777);
+    }
+    if (mkdir(path.data(), 0777) != 0)
+    {
+      struct stat fileStatus;
+      if (stat(path.data(), &fileStatus) != 0 || !S_ISDIR(fileStatus.st_mode))
+      {
+        throw std::runtime_error("Failed to create directory.");
+      }
+    }
+  }
+#endif
+
+  void FileWriter::Write(const uint8_t* buffer, size_t length, int64_t offset)
+  {
+    SplitWrite(m_unbuffered, m_handle, m_unbufferedHandle, buffer, length, offset, WriteAt);
+  }
+
+  uint64_t FileWriter::QueueWrite(
+      IoRing& ring,
+      const uint8_t* buffer,
+      size_t length,
+      int64_t offset)
+  {
+    uint64_t lastId = 0;
+    SplitWrite(
+        m_unbuffered,
+        m_handle,
+        m_unbufferedHandle,
+        buffer,
+        length,
+        offset,
+        [&ring, &lastId](
+            FileHandle handle, const uint8_t* partBuffer, size_t partLength, int64_t partOffset) {
+          if (partLength != 0)
+          {
+            lastId = ring.QueueWrite(handle, partBuffer, partLength, partOffset);
+          }
+        });
+    return lastId;
+  }
+
+  UnbufferedFileBodyStream::UnbufferedFileBodyStream(
+      const FileReader& fileReader,
+      int64_t offset,
+      int64_t length,
+      std::shared_ptr<BufferPool> bufferPool)
+      : m_fileReader(fileReader), m_offset(offset), m_length(length),
+        m_bufferPool(std::move(bufferPool))
+  {
+  }
+
+  UnbufferedFileBodyStream::~UnbufferedFileBodyStream() {}
+
+  size_t UnbufferedFileBodyStream::OnRead(
+      uint8_t* buffer,
+      size_t count,
+      Azure::Core::Context const& context)
+  {
+    if (m_position >= m_length || count == 0)
+    {
+      return 0;
+    }
+    if (!m_buffer)
+    {
+      // One more aligned block for the skew of the offset.
+      m_buffer = std::make_unique<PooledBuffer>(
+          m_bufferPool,
+          static_cast<size_t>(std::min(
+              MaxUnbufferedReadSize, (m_length + 2 * Alignment - 1) / Alignment * Alignment)),
+          context);
+    }
+    const int64_t fileOffset = m_offset + m_position;
+    if (fileOffset < m_bufferOffset
+        || fileOffset >= m_bufferOffset + static_cast<int64_t>(m_bufferLength))
+    {
+      m_bufferOffset = fileOffset / Alignment * Alignment;
+      m_bufferLength
+          = m_fileReader.ReadUnbuffered(m_buffer->Data(), m_buffer->Size(), m_bufferOffset);
+      if (fileOffset >= m_bufferOffset + static_cast<int64_t>(m_bufferLength))
+      {
+        throw std::runtime_error("Failed to read file.");
+      }
+    }
+    const size_t bytesRead = static_cast<size_t>(std::min<int64_t>(
+        std::min<int64_t>(
+            static_cast<int64_t>(count),
+            m_bufferOffset + static_cast<int64_t>(m_bufferLength) - fileOffset),
+        m_length - m_position));
+    std::memcpy(
+        buffer, m_buffer->Data() + static_cast<size_t>(fileOffset - m_bufferOffset), bytesRead);
+    m_position += static_cast<int64_t>(bytesRead);
+    return bytesRead;
+  }
 
 }}} // namespace Azure::Storage::_internal
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/hashing_stream.hpp"
+
+#include <algorithm>
+
+using Azure::Core::Context;
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  size_t HashingStream::OnRead(uint8_t* buffer, size_t count, Context const& context)
+  {
+    size_t const readBytes = m_inner.Read(buffer, count, context);
+    int64_t const end = m_offset + static_cast<int64_t>(readBytes);
+    if (end > m_hashedLength)
+    {
+      size_t const skipped = static_cast<size_t>(std::max<int64_t>(m_hashedLength - m_offset, 0));
+      m_hash.Append(buffer + skipped, readBytes - skipped);
+      m_hashedLength = end;
+    }
+    m_offset = end;
+    return readBytes;
+  }
+
+}}} // namespace Azure::Storage::_internal
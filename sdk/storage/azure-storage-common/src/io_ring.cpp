@@ -0,0 +1,357 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/file_io.hpp"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define AZ_STORAGE_IO_URING
+#endif
+
+namespace Azure { namespace Storage { namespace _internal {
+
+#if defined(AZ_STORAGE_IO_URING)
+  namespace {
+    // The number of writes in flight per thread. A write to a FileWriter is up to three writes,
+    // two of them can be in flight while the data of the next one is received.
+    constexpr unsigned RingEntries = 8;
+  } // namespace
+
+  struct IoRing::Ring final
+  {
+    struct Write final
+    {
+      // 0 when the slot is free.
+      uint64_t Id = 0;
+      FileHandle Handle = -1;
+      iovec Buffer{};
+      int64_t Offset = 0;
+    };
+
+    int Fd = -1;
+    void* SqRing = MAP_FAILED;
+    size_t SqRingSize = 0;
+    void* CqRing = MAP_FAILED;
+    size_t CqRingSize = 0;
+    void* Sqes = MAP_FAILED;
+    size_t SqesSize = 0;
+
+    unsigned* SqTail = nullptr;
+    unsigned SqMask = 0;
+    unsigned* SqArray = nullptr;
+    unsigned* CqHead = nullptr;
+    unsigned* CqTail = nullptr;
+    unsigned CqMask = 0;
+    io_uring_cqe* Cqes = nullptr;
+
+    unsigned ToSubmit = 0;
+    std::vector<Write> Writes = std::vector<Write>(RingEntries);
+    uint64_t NextId = 1;
+    bool Failed = false;
+
+    ~Ring()
+    {
+      if (Sqes != MAP_FAILED)
+      {
+        munmap(Sqes, SqesSize);
+      }
+      if (CqRing != MAP_FAILED && CqRing != SqRing)
+      {
+        munmap(CqRing, CqRingSize);
+      }
+      if (SqRing != MAP_FAILED)
+      {
+        munmap(SqRing, SqRingSize);
+      }
+      if (Fd != -1)
+      {
+        close(Fd);
+      }
+    }
+
+    bool Setup()
+    {
+      io_uring_params params;
+      std::memset(&params, 0, sizeof(params));
+      Fd = static_cast<int>(syscall(__NR_io_uring_setup, RingEntries, &params));
+      if (Fd < 0)
+      {
+        Fd = -1;
+        return false;
+      }
+
+      SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+      CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+      const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (singleMmap)
+      {
+        SqRingSize = CqRingSize = std::max(SqRingSize, CqRingSize);
+      }
+      SqRing = mmap(
+          nullptr,
+          SqRingSize,
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE,
+          Fd,
+          IORING_OFF_SQ_RING);
+      if (SqRing == MAP_FAILED)
+      {
+        return false;
+      }
+      CqRing = singleMmap ? SqRing
+                          : mmap(
+                              nullptr,
+                              CqRingSize,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE,
+                              Fd,
+                              IORING_OFF_CQ_RING);
+      if (CqRing == MAP_FAILED)
+      {
+        return false;
+      }
+      SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+      Sqes = mmap(
+          nullptr,
+          SqesSize,
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE,
+          Fd,
+          IORING_OFF_SQES);
+      if (Sqes == MAP_FAILED)
+      {
+        return false;
+      }
+
+      auto* sq = static_cast<uint8_t*>(SqRing);
+      auto* cq = static_cast<uint8_t*>(CqRing);
+      SqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+      SqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+      SqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+      CqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+      CqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+      CqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+      Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+      return true;
+    }
+
+    int Enter(unsigned toSubmit, unsigned minComplete)
+    {
+      while (true)
+      {
+        const int ret = static_cast<int>(syscall(
+            __NR_io_uring_enter,
+            Fd,
+            toSubmit,
+            minComplete,
+            minComplete != 0 ? IORING_ENTER_GETEVENTS : 0,
+            nullptr,
+            0));
+        if (ret >= 0 || errno != EINTR)
+        {
+          return ret;
+        }
+      }
+    }
+
+    // Writes the rest of a short write synchronously.
+    bool WriteRest(const Write& write, size_t written)
+    {
+      auto* buffer = static_cast<const uint8_t*>(write.Buffer.iov_base);
+      while (written < write.Buffer.iov_len)
+      {
+        const ssize_t ret = pwrite(
+            write.Handle,
+            buffer + written,
+            write.Buffer.iov_len - written,
+            static_cast<off_t>(write.Offset + static_cast<int64_t>(written)));
+        if (ret <= 0)
+        {
+          return false;
+        }
+        written += static_cast<size_t>(ret);
+      }
+      return true;
+    }
+  };
+
+  IoRing* IoRing::GetThreadRing()
+  {
+    static std::atomic<bool> unavailable(false);
+    thread_local std::unique_ptr<IoRing> threadRing;
+    if (!threadRing && !unavailable.load(std::memory_order_relaxed))
+    {
+      auto ring = std::make_unique<Ring>();
+      if (ring->Setup())
+      {
+        threadRing.reset(new IoRing(std::move(ring)));
+      }
+      else
+      {
+        unavailable.store(true, std::memory_order_relaxed);
+      }
+    }
+    return threadRing.get();
+  }
+
+  IoRing::IoRing(std::unique_ptr<Ring> ring) : m_ring(std::move(ring)) {}
+
+  IoRing::~IoRing()
+  {
+    try
+    {
+      Wait();
+    }
+    catch (...)
+    {
+    }
+  }
+
+  uint64_t IoRing::QueueWrite(
+      FileHandle handle,
+      const uint8_t* buffer,
+      size_t length,
+      int64_t offset)
+  {
+    Ring& ring = *m_ring;
+    auto freeSlot = std::find_if(ring.Writes.begin(), ring.Writes.end(), [](const Ring::Write& w) {
+      return w.Id == 0;
+    });
+    if (freeSlot == ring.Writes.end())
+    {
+      // All the slots are in flight, the oldest write is waited for.
+      Wait(std::min_element(
+               ring.Writes.begin(),
+               ring.Writes.end(),
+               [](const Ring::Write& a, const Ring::Write& b) { return a.Id < b.Id; })
+               ->Id);
+      freeSlot = std::find_if(ring.Writes.begin(), ring.Writes.end(), [](const Ring::Write& w) {
+        return w.Id == 0;
+      });
+    }
+    freeSlot->Id = ring.NextId++;
+    freeSlot->Handle = handle;
+    freeSlot->Buffer.iov_base = const_cast<uint8_t*>(buffer);
+    freeSlot->Buffer.iov_len = length;
+    freeSlot->Offset = offset;
+
+    // This thread is the only producer of the submission queue.
+    const unsigned tail = *ring.SqTail;
+    const unsigned index = tail & ring.SqMask;
+    auto* sqe = static_cast<io_uring_sqe*>(ring.Sqes) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = handle;
+    sqe->addr = reinterpret_cast<uint64_t>(&freeSlot->Buffer);
+    sqe->len = 1;
+    sqe->off = static_cast<uint64_t>(offset);
+    sqe->user_data = freeSlot->Id;
+    ring.SqArray[index] = index;
+    __atomic_store_n(ring.SqTail, tail + 1, __ATOMIC_RELEASE);
+    ++ring.ToSubmit;
+    return freeSlot->Id;
+  }
+
+  void IoRing::Submit()
+  {
+    Ring& ring = *m_ring;
+    while (ring.ToSubmit != 0)
+    {
+      const int submitted = ring.Enter(ring.ToSubmit, 0);
+      if (submitted < 0)
+      {
+        throw std::runtime_error("Failed to submit file writes.");
+      }
+      ring.ToSubmit -= static_cast<unsigned>(submitted);
+    }
+  }
+
+  void IoRing::Reap()
+  {
+    Ring& ring = *m_ring;
+    unsigned head = *ring.CqHead;
+    const unsigned tail = __atomic_load_n(ring.CqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+      const io_uring_cqe& cqe = ring.Cqes[head & ring.CqMask];
+      auto write = std::find_if(
+          ring.Writes.begin(), ring.Writes.end(), [&cqe](const Ring::Write& w) {
+            return w.Id == cqe.user_data;
+          });
+      if (write == ring.Writes.end())
+      {
+        continue;
+      }
+      if (cqe.res < 0 || !ring.WriteRest(*write, static_cast<size_t>(cqe.res)))
+      {
+        ring.Failed = true;
+      }
+      write->Id = 0;
+    }
+    __atomic_store_n(ring.CqHead, head, __ATOMIC_RELEASE);
+  }
+
+  void IoRing::Wait(uint64_t id)
+  {
+    Ring& ring = *m_ring;
+    Submit();
+    auto isPending = [&ring, id]() {
+      return std::any_of(ring.Writes.begin(), ring.Writes.end(), [id](const Ring::Write& w) {
+        return w.Id != 0 && w.Id <= id;
+      });
+    };
+    Reap();
+    while (isPending())
+    {
+      if (ring.Enter(0, 1) < 0)
+      {
+        throw std::runtime_error("Failed to wait for file writes.");
+      }
+      Reap();
+    }
+    if (ring.Failed)
+    {
+      ring.Failed = false;
+      throw std::runtime_error("Failed to write file.");
+    }
+  }
+
+#else
+  struct IoRing::Ring final
+  {
+  };
+
+  IoRing* IoRing::GetThreadRing() { return nullptr; }
+
+  IoRing::IoRing(std::unique_ptr<Ring> ring) : m_ring(std::move(ring)) {}
+
+  IoRing::~IoRing() {}
+
+  uint64_t IoRing::QueueWrite(FileHandle, const uint8_t*, size_t, int64_t)
+  {
+    throw std::logic_error("io_uring isn't available.");
+  }
+
+  void IoRing::Submit() {}
+
+  void IoRing::Reap() {}
+
+  void IoRing::Wait(uint64_t) {}
+#endif
+
+}}} // namespace Azure::Storage::_internal
@@ -0,0 +1,252 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/range_write_coalescer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "azure/storage/common/internal/concurrent_transfer.hpp"
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  namespace {
+    int64_t ExtentEnd(const std::pair<const int64_t, std::vector<uint8_t>>& extent)
+    {
+      return extent.first + static_cast<int64_t>(extent.second.size());
+    }
+  } // namespace
+
+  RangeWriteCoalescer::RangeWriteCoalescer(
+      const RangeWriteCoalescerOptions& options,
+      UploadFunc uploadFunc,
+      ReadFunc readFunc,
+      std::shared_ptr<TransferExecutor> executor)
+      : m_options(options), m_uploadFunc(std::move(uploadFunc)), m_readFunc(std::move(readFunc)),
+        m_executor(std::move(executor))
+  {
+    if (m_options.Alignment <= 0 || m_options.MaxRangeSize <= 0
+        || m_options.MaxRangeSize % m_options.Alignment != 0)
+    {
+      throw std::invalid_argument(
+          "MaxRangeSize must be a positive multiple of a positive Alignment.");
+    }
+    if (m_options.Alignment > 1 && !m_readFunc)
+    {
+      throw std::invalid_argument("readFunc is required to align the ranges.");
+    }
+  }
+
+  void RangeWriteCoalescer::WriteAt(
+      int64_t offset,
+      const uint8_t* data,
+      size_t length,
+      const Azure::Core::Context& context)
+  {
+    if (offset < 0)
+    {
+      throw std::invalid_argument("offset cannot be negative.");
+    }
+    if (length == 0)
+    {
+      return;
+    }
+    const int64_t end = offset + static_cast<int64_t>(length);
+
+    bool flush = false;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (m_exception)
+      {
+        std::rethrow_exception(m_exception);
+      }
+
+      // The extents overlapping or touching the write, which are merged with it.
+      auto first = m_extents.upper_bound(offset);
+      if (first != m_extents.begin() && ExtentEnd(*std::prev(first)) >= offset)
+      {
+        --first;
+      }
+      auto last = first;
+      int64_t mergedStart = offset;
+      int64_t mergedEnd = end;
+      int64_t mergedSize = 0;
+      for (; last != m_extents.end() && last->first <= end; ++last)
+      {
+        mergedStart = std::min(mergedStart, last->first);
+        mergedEnd = std::max(mergedEnd, ExtentEnd(*last));
+        mergedSize += static_cast<int64_t>(last->second.size());
+      }
+
+      if (first != last && std::next(first) == last && first->first == mergedStart)
+      {
+        // Most writes extend or overwrite a single extent starting before them.
+        auto& extent = first->second;
+        extent.resize(static_cast<size_t>(mergedEnd - mergedStart));
+        std::memcpy(extent.data() + (offset - mergedStart), data, length);
+      }
+      else
+      {
+        std::vector<uint8_t> extent(static_cast<size_t>(mergedEnd - mergedStart));
+        for (auto i = first; i != last; ++i)
+        {
+          std::memcpy(extent.data() + (i->first - mergedStart), i->second.data(), i->second.size());
+        }
+        std::memcpy(extent.data() + (offset - mergedStart), data, length);
+        m_extents.erase(first, last);
+        m_extents.emplace(mergedStart, std::move(extent));
+      }
+      m_bufferedSize += mergedEnd - mergedStart - mergedSize;
+      flush = m_bufferedSize >= m_options.MaxBufferedSize;
+    }
+
+    if (flush)
+    {
+      Flush(context);
+    }
+  }
+
+  void RangeWriteCoalescer::Flush(const Azure::Core::Context& context)
+  {
+    std::lock_guard<std::mutex> flushGuard(m_flushMutex);
+    std::map<int64_t, std::vector<uint8_t>> extents;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (m_exception)
+      {
+        std::rethrow_exception(m_exception);
+      }
+      extents.swap(m_extents);
+      m_bufferedSize = 0;
+    }
+    if (extents.empty())
+    {
+      return;
+    }
+
+    // The extents are widened to the alignment, the widened extents overlapping or touching are
+    // merged into spans, and the spans are split in ranges of up to MaxRangeSize bytes.
+    const int64_t alignment = m_options.Alignment;
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    auto addSpan = [&](int64_t spanStart, int64_t spanEnd) {
+      for (int64_t rangeOffset = spanStart; rangeOffset < spanEnd;
+           rangeOffset += m_options.MaxRangeSize)
+      {
+        ranges.emplace_back(rangeOffset, std::min(m_options.MaxRangeSize, spanEnd - rangeOffset));
+      }
+    };
+    int64_t spanStart = extents.begin()->first / alignment * alignment;
+    int64_t spanEnd = spanStart;
+    for (const auto& extent : extents)
+    {
+      const int64_t start = extent.first / alignment * alignment;
+      const int64_t end = (ExtentEnd(extent) + alignment - 1) / alignment * alignment;
+      if (start > spanEnd)
+      {
+        addSpan(spanStart, spanEnd);
+        spanStart = start;
+      }
+      spanEnd = std::max(spanEnd, end);
+    }
+    addSpan(spanStart, spanEnd);
+
+    auto uploadRange = [&](int64_t rangeOffset, int64_t rangeLength) {
+      const int64_t rangeEnd = rangeOffset + rangeLength;
+      auto first = extents.upper_bound(rangeOffset);
+      if (first != extents.begin() && ExtentEnd(*std::prev(first)) > rangeOffset)
+      {
+        --first;
+      }
+
+      // A range within a single extent is uploaded from the extent.
+      if (first != extents.end() && first->first <= rangeOffset && ExtentEnd(*first) >= rangeEnd)
+      {
+        m_uploadFunc(
+            rangeOffset,
+            first->second.data() + (rangeOffset - first->first),
+            static_cast<size_t>(rangeLength),
+            context);
+        return;
+      }
+
+      // The bytes not written are read first. The gaps closer than the alignment are read
+      // together, the data written between them is copied over what was read.
+      std::vector<uint8_t> buffer(static_cast<size_t>(rangeLength));
+      std::vector<std::pair<int64_t, int64_t>> gaps;
+      auto addGap = [&](int64_t gapStart, int64_t gapEnd) {
+        if (!gaps.empty() && gapStart - gaps.back().second < alignment)
+        {
+          gaps.back().second = gapEnd;
+        }
+        else
+        {
+          gaps.emplace_back(gapStart, gapEnd);
+        }
+      };
+      int64_t position = rangeOffset;
+      for (auto i = first; i != extents.end() && i->first < rangeEnd; ++i)
+      {
+        if (i->first > position)
+        {
+          addGap(position, i->first);
+        }
+        position = ExtentEnd(*i);
+      }
+      if (position < rangeEnd)
+      {
+        addGap(position, rangeEnd);
+      }
+      for (const auto& gap : gaps)
+      {
+        m_readFunc(
+            gap.first,
+            buffer.data() + (gap.first - rangeOffset),
+            static_cast<size_t>(gap.second - gap.first),
+            context);
+      }
+
+      for (auto i = first; i != extents.end() && i->first < rangeEnd; ++i)
+      {
+        const int64_t copyStart = std::max(i->first, rangeOffset);
+        const int64_t copyEnd = std::min(ExtentEnd(*i), rangeEnd);
+        std::memcpy(
+            buffer.data() + (copyStart - rangeOffset),
+            i->second.data() + (copyStart - i->first),
+            static_cast<size_t>(copyEnd - copyStart));
+      }
+      m_uploadFunc(rangeOffset, buffer.data(), buffer.size(), context);
+    };
+
+    ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = m_options.Concurrency;
+    try
+    {
+      ConcurrentTransfer(
+          0,
+          static_cast<int64_t>(ranges.size()),
+          transferOptions,
+          [&](int64_t index, int64_t, int64_t) {
+            const auto& range = ranges[static_cast<size_t>(index)];
+            uploadRange(range.first, range.second);
+          },
+          m_executor);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_exception = std::current_exception();
+      throw;
+    }
+  }
+
+  int64_t RangeWriteCoalescer::BufferedSize() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_bufferedSize;
+  }
+
+}}} // namespace Azure::Storage::_internal
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/rate_limit_policy.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace Azure { namespace Storage {
+
+  namespace _internal {
+
+    namespace {
+      // Waits are split so that a cancelled context is noticed quickly.
+      constexpr std::chrono::milliseconds MaxSleepDuration(100);
+    } // namespace
+
+    TokenBucket::TokenBucket(int64_t tokensPerSecond)
+        : m_tokensPerSecond(static_cast<double>(tokensPerSecond)),
+          m_capacity(static_cast<double>(tokensPerSecond)), m_tokens(m_capacity),
+          m_lastRefill(std::chrono::steady_clock::now())
+    {
+    }
+
+    std::chrono::steady_clock::duration TokenBucket::Take(
+        int64_t numTokens,
+        std::chrono::steady_clock::time_point now)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (now > m_lastRefill)
+      {
+        m_tokens = std::min(
+            m_capacity,
+            m_tokens
+                + std::chrono::duration<double>(now - m_lastRefill).count() * m_tokensPerSecond);
+        m_lastRefill = now;
+      }
+      const double debt = std::max(-m_tokens, 0.0);
+      m_tokens -= static_cast<double>(numTokens);
+      return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(debt / m_tokensPerSecond));
+    }
+
+    void TokenBucket::Return(int64_t numTokens)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_tokens = std::min(m_capacity, m_tokens + static_cast<double>(numTokens));
+    }
+
+    void TokenBucket::Acquire(int64_t numTokens, const Azure::Core::Context& context)
+    {
+      const auto now = std::chrono::steady_clock::now();
+      const auto deadline = now + Take(numTokens, now);
+      while (true)
+      {
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero())
+        {
+          return;
+        }
+        if (context.IsCancelled())
+        {
+          Return(numTokens);
+          context.ThrowIfCancelled();
+        }
+        std::this_thread::sleep_for(
+            std::min<std::chrono::steady_clock::duration>(remaining, MaxSleepDuration));
+      }
+    }
+
+    size_t RateLimitedBodyStream::OnRead(
+        uint8_t* buffer,
+        size_t count,
+        Azure::Core::Context const& context)
+    {
+      const size_t bytesRead = m_inner->Read(buffer, count, context);
+      if (bytesRead != 0)
+      {
+        m_bytes->Acquire(static_cast<int64_t>(bytesRead), context);
+      }
+      return bytesRead;
+    }
+
+    std::unique_ptr<Core::Http::RawResponse> RateLimitPolicy::Send(
+        Core::Http::Request& request,
+        Core::Http::Policies::NextHttpPolicy nextPolicy,
+        Core::Context const& context) const
+    {
+      if (m_rateLimiter->m_requests)
+      {
+        m_rateLimiter->m_requests->Acquire(1, context);
+      }
+      const auto& bytes = m_rateLimiter->m_bytes;
+      // A policy can't replace the body stream of the request, so the whole body is counted
+      // before it is sent.
+      if (bytes && request.GetBodyStream()->Length() > 0)
+      {
+        bytes->Acquire(request.GetBodyStream()->Length(), context);
+      }
+
+      auto response = nextPolicy.Send(request, context);
+      if (bytes && response)
+      {
+        auto bodyStream = response->ExtractBodyStream();
+        if (bodyStream)
+        {
+          response->SetBodyStream(
+              std::make_unique<RateLimitedBodyStream>(std::move(bodyStream), bytes));
+        }
+        else if (!response->GetBody().empty())
+        {
+          bytes->Acquire(static_cast<int64_t>(response->GetBody().size()), context);
+        }
+      }
+      return response;
+    }
+
+  } // namespace _internal
+
+  RateLimiter::RateLimiter(int64_t bytesPerSecond, int64_t requestsPerSecond)
+      : m_bytesPerSecond(bytesPerSecond), m_requestsPerSecond(requestsPerSecond)
+  {
+    if (bytesPerSecond < 0)
+    {
+      throw std::invalid_argument("bytesPerSecond cannot be negative.");
+    }
+    if (requestsPerSecond < 0)
+    {
+      throw std::invalid_argument("requestsPerSecond cannot be negative.");
+    }
+    if (bytesPerSecond != 0)
+    {
+      m_bytes = std::make_shared<_internal::TokenBucket>(bytesPerSecond);
+    }
+    if (requestsPerSecond != 0)
+    {
+      m_requests = std::make_shared<_internal::TokenBucket>(requestsPerSecond);
+    }
+  }
+
+  RateLimiter::~RateLimiter() {}
+
+}} // namespace Azure::Storage
@@ -3,16 +3,76 @@
 
 #include "azure/storage/common/internal/reliable_stream.hpp"
 
+#include <azure/core/datetime.hpp>
 #include <azure/core/http/http.hpp>
 
+#include "azure/storage/common/internal/storage_switch_to_secondary_policy.hpp"
+
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
 using Azure::Core::Context;
 using Azure::Core::IO::BodyStream;
 
 namespace Azure { namespace Storage { namespace _internal {
 
-  size_t ReliableStream::OnRead(uint8_t* buffer, size_t count, Context const& context)
+  namespace {
+    // Waits are split so that a cancelled context is noticed quickly.
+    constexpr std::chrono::milliseconds MaxWaitDuration(100);
+  } // namespace
+
+  void ReliableStream::WaitBeforeReconnect(Context const& context) const
+  {
+    if (m_options.RetryDelay <= std::chrono::milliseconds(0))
+    {
+      return;
+    }
+    const int32_t shift = std::min(m_failedReads - 1, std::numeric_limits<int32_t>::digits - 2);
+    const double jitterFactor
+        = 0.8 + static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX) * 0.5;
+    const auto delay = std::min(
+        std::chrono::duration<double, std::milli>(m_options.RetryDelay) * (int64_t(1) << shift)
+            * jitterFactor,
+        std::chrono::duration<double, std::milli>(m_options.MaxRetryDelay));
+
+    const auto end = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay);
+    for (auto now = std::chrono::steady_clock::now(); now < end;
+         now = std::chrono::steady_clock::now())
+    {
+      context.ThrowIfCancelled();
+      std::this_thread::sleep_for(
+          std::min<std::chrono::steady_clock::duration>(end - now, MaxWaitDuration));
+    }
+    context.ThrowIfCancelled();
+  }
+
+  bool ReliableStream::OnInnerRead(size_t readBytes, std::chrono::steady_clock::duration duration)
+  {
+    if (m_options.MinimumThroughput <= 0)
+    {
+      return true;
+    }
+    m_reads.emplace_back(duration, readBytes);
+    m_readDuration += duration;
+    m_readBytes += static_cast<int64_t>(readBytes);
+    while (m_reads.size() > 1
+           && m_readDuration - m_reads.front().first >= m_options.ThroughputWindow)
+    {
+      m_readDuration -= m_reads.front().first;
+      m_readBytes -= static_cast<int64_t>(m_reads.front().second);
+      m_reads.pop_front();
+    }
+    return m_readDuration < m_options.ThroughputWindow
+        || static_cast<double>(m_readBytes)
+        >= static_cast<double>(m_options.MinimumThroughput)
+            * std::chrono::duration<double>(m_readDuration).count();
+  }
+
+  template <class InnerRead>
+  size_t ReliableStream::ReadFromInner(InnerRead const& innerRead, Context const& context)
   {
-    (void)context;
     for (int64_t intent = 1;; intent++)
     {
       // check if we need to get inner stream
@@ -22,15 +82,49 @@ namespace Azure { namespace Storage { namespace _internal {
         // if this fails, throw bubbles up
         // As m_inner is unique_pr, it will be destructed on reassignment, cleaning up network
         // session.
-        this->m_inner = this->m_streamReconnector(this->m_retryOffset, context);
+        // The failed read might be the primary host's fault, every other reconnect reads from
+        // the secondary host.
+        ++this->m_reconnects;
+        this->m_inner = this->m_streamReconnector(
+            this->m_retryOffset,
+            this->m_reconnects % 2 == 1 ? WithReadFromSecondary(context) : context);
       }
       try
       {
-        auto const readBytes = this->m_inner->Read(buffer, count, context);
+        auto const readStart = std::chrono::steady_clock::now();
+        auto const readBytes = innerRead(
+            *this->m_inner,
+            m_options.StallTimeout > std::chrono::milliseconds(0)
+                ? context.WithDeadline(std::chrono::system_clock::now() + m_options.StallTimeout)
+                : context);
         // update offset
         this->m_retryOffset += readBytes;
+        this->m_failedReads = 0;
+        if (!OnInnerRead(readBytes, std::chrono::steady_clock::now() - readStart))
+        {
+          // The connection has become too slow, the next read reconnects at the current offset.
+          this->m_inner.reset();
+          this->m_reads.clear();
+          this->m_readDuration = std::chrono::steady_clock::duration();
+          this->m_readBytes = 0;
+        }
         return readBytes;
       }
+      catch (Azure::Core::OperationCancelledException const&)
+      {
+        if (context.IsCancelled())
+        {
+          throw;
+        }
+        // The read stalled, the connection is dropped and replaced right away.
+        this->m_inner.reset();
+        if (intent == this->m_options.MaxRetryRequests)
+        {
+          throw Azure::Core::Http::TransportException(
+              "Reading the body stream stalled for longer than "
+              + std::to_string(m_options.StallTimeout.count()) + " ms.");
+        }
+      }
       catch (std::runtime_error const& e)
       {
         // forget about the inner stream. We will need to request a new one
@@ -43,7 +137,31 @@ namespace Azure { namespace Storage { namespace _internal {
           // max retry. End loop. Rethrow
           throw;
         }
+        ++m_failedReads;
+        WaitBeforeReconnect(context);
       }
     }
   }
+
+  size_t ReliableStream::OnRead(uint8_t* buffer, size_t count, Context const& context)
+  {
+    return ReadFromInner(
+        [buffer, count](BodyStream& inner, Context const& readContext) {
+          return inner.Read(buffer, count, readContext);
+        },
+        context);
+  }
+
+  size_t ReliableStream::OnReadV(
+      Azure::Core::IO::ReadBuffer const* buffers,
+      size_t bufferCount,
+      Context const& context)
+  {
+    return ReadFromInner(
+        [buffers, bufferCount](BodyStream& inner, Context const& readContext) {
+          return inner.ReadV(buffers, bufferCount, readContext);
+        },
+        context);
+  }
+
 }}} // namespace Azure::Storage::_internal
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/sas_token_template.hpp"
+
+#include <azure/core/base64.hpp>
+#include <azure/core/url.hpp>
+
+#include "azure/storage/common/crypt.hpp"
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  namespace {
+    const std::string SignatureQueryParameter = "sig";
+  } // namespace
+
+  std::string GenerateSasToken(
+      const std::vector<uint8_t>& key,
+      const SasTokenParts& parts,
+      const std::string& resourceName)
+  {
+    return GenerateSasToken(HmacSha256Key(key), parts, resourceName);
+  }
+
+  std::string GenerateSasToken(
+      const HmacSha256Key& key,
+      const SasTokenParts& parts,
+      const std::string& resourceName)
+  {
+    const std::string stringToSign
+        = parts.StringToSignPrefix + resourceName + parts.StringToSignSuffix;
+    const std::string signature = Azure::Core::Convert::Base64Encode(
+        key.Sign(reinterpret_cast<const uint8_t*>(stringToSign.data()), stringToSign.size()));
+
+    Azure::Core::Url builder;
+    for (const auto& parameter : parts.QueryParameters)
+    {
+      builder.AppendQueryParameter(parameter.first, parameter.second);
+    }
+    builder.AppendQueryParameter(SignatureQueryParameter, UrlEncodeQueryParameter(signature));
+    return builder.GetAbsoluteUrl();
+  }
+
+  SasTokenTemplate::SasTokenTemplate(const std::vector<uint8_t>& key, const SasTokenParts& parts)
+      : SasTokenTemplate(HmacSha256Key(key), parts)
+  {
+  }
+
+  SasTokenTemplate::SasTokenTemplate(const HmacSha256Key& key, const SasTokenParts& parts)
+      : m_hmac(key.GetKeyedHmac()), m_stringToSignSuffix(parts.StringToSignSuffix)
+  {
+    m_hmac.Append(
+        reinterpret_cast<const uint8_t*>(parts.StringToSignPrefix.data()),
+        parts.StringToSignPrefix.size());
+
+    // The query parameters are sorted by name, like in Azure::Core::Url, so the signature goes
+    // between the parameters before and after its name.
+    const auto signature = parts.QueryParameters.lower_bound(SignatureQueryParameter);
+    m_tokenPrefix = Azure::Core::_detail::FormatEncodedUrlQueryParameters(
+        std::map<std::string, std::string>(parts.QueryParameters.begin(), signature));
+    m_tokenPrefix += m_tokenPrefix.empty() ? '?' : '&';
+    m_tokenPrefix += SignatureQueryParameter + "=";
+    for (auto ite = signature; ite != parts.QueryParameters.end(); ++ite)
+    {
+      m_tokenSuffix += '&' + ite->first + '=' + ite->second;
+    }
+  }
+
+  std::string SasTokenTemplate::GenerateSasToken(const std::string& resourceName) const
+  {
+    Core::Cryptography::_internal::HmacSha256 hmac(m_hmac);
+    hmac.Append(reinterpret_cast<const uint8_t*>(resourceName.data()), resourceName.size());
+    const auto signature = hmac.Final(
+        reinterpret_cast<const uint8_t*>(m_stringToSignSuffix.data()),
+        m_stringToSignSuffix.size());
+
+    return m_tokenPrefix + UrlEncodeQueryParameter(Azure::Core::Convert::Base64Encode(signature))
+        + m_tokenSuffix;
+  }
+
+}}} // namespace Azure::Storage::_internal
@@ -5,6 +5,10 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <azure/core/http/http.hpp>
 #include <azure/core/internal/strings.hpp>
@@ -15,74 +19,90 @@ namespace Azure { namespace Storage { namespace _internal {
 
   std::string SharedKeyPolicy::GetSignature(const Core::Http::Request& request) const
   {
-    std::string string_to_sign;
-    string_to_sign += request.GetMethod().ToString() + "\n";
+    // The string to sign is appended to a buffer reused by the requests of the thread, so its
+    // capacity is only grown by the first requests.
+    thread_local std::string string_to_sign;
+    thread_local std::vector<std::pair<std::string, std::string>> ordered_kv;
+    string_to_sign.clear();
+    ordered_kv.clear();
+
+    string_to_sign += request.GetMethod().ToString();
+    string_to_sign += '\n';
 
-    const auto& headers = request.GetHeaders();
-    for (std::string headerName :
-         {"Content-Encoding",
-          "Content-Language",
-          "Content-Length",
-          "Content-MD5",
-          "Content-Type",
-          "Date",
-          "If-Modified-Since",
-          "If-Match",
-          "If-None-Match",
-          "If-Unmodified-Since",
-          "Range"})
+    // The headers are read from the request without copying them into a new map, and the names
+    // are found without being copied into strings. The names are already lowercase, like the
+    // names of the request headers, so they are not lowered for each request.
+    using Core::Http::_detail::RequestHelpers;
+    static const char* const HeaderNames[] = {
+        "content-encoding",
+        "content-language",
+        "content-length",
+        "content-md5",
+        "content-type",
+        "date",
+        "if-modified-since",
+        "if-match",
+        "if-none-match",
+        "if-unmodified-since",
+        "range"};
+    for (const char* headerName : HeaderNames)
     {
-      auto ite = headers.find(Azure::Core::_internal::StringExtensions::ToLower(headerName));
-      if (ite != headers.end())
+      const std::string* value = RequestHelpers::FindHeader(request, headerName);
+      if (value != nullptr)
       {
-        if (headerName == "Content-Length" && ite->second == "0")
+        if (std::strcmp(headerName, "content-length") == 0 && *value == "0")
         {
           // do nothing
         }
         else
         {
-          string_to_sign += ite->second;
+          string_to_sign += *value;
         }
       }
-      string_to_sign += "\n";
+      string_to_sign += '\n';
     }
 
     // canonicalized headers
-    const std::string prefix = "x-ms-";
-    std::vector<std::pair<std::string, std::string>> ordered_kv;
-    for (auto ite = headers.lower_bound(prefix);
-         ite != headers.end() && ite->first.substr(0, prefix.length()) == prefix;
-         ++ite)
-    {
-      std::string key = Azure::Core::_internal::StringExtensions::ToLower(ite->first);
-      ordered_kv.emplace_back(std::make_pair(std::move(key), ite->second));
-    }
-    std::sort(ordered_kv.begin(), ordered_kv.end());
-    for (const auto& p : ordered_kv)
-    {
-      string_to_sign += p.first + ":" + p.second + "\n";
-    }
-    ordered_kv.clear();
+    // The request stores the header names in lowercase and sorted, so they are appended in the
+    // order they are visited without being copied and sorted again.
+    RequestHelpers::ForEachHeader(
+        request, [](const std::string& name, const std::string& value) {
+          if (name.compare(0, 5, "x-ms-") == 0)
+          {
+            string_to_sign += name;
+            string_to_sign += ':';
+            string_to_sign += value;
+            string_to_sign += '\n';
+          }
+        });
 
     // canonicalized resource
-    string_to_sign += "/" + m_credential->AccountName + "/" + request.GetUrl().GetPath() + "\n";
-    for (const auto& query : request.GetUrl().GetQueryParameters())
+    string_to_sign += '/';
+    string_to_sign += m_credential->AccountName;
+    string_to_sign += '/';
+    string_to_sign += request.GetUrl().GetPath();
+    string_to_sign += '\n';
+    for (const auto& query : request.GetUrl().GetQueryParametersView())
     {
-      std::string key = Azure::Core::_internal::StringExtensions::ToLower(query.first);
       ordered_kv.emplace_back(
-          std::make_pair(Azure::Core::Url::Decode(key), Azure::Core::Url::Decode(query.second)));
+          Azure::Core::Url::Decode(
+              Azure::Core::_internal::StringExtensions::ToLower(query.first)),
+          Azure::Core::Url::Decode(query.second));
     }
     std::sort(ordered_kv.begin(), ordered_kv.end());
     for (const auto& p : ordered_kv)
     {
-      string_to_sign += p.first + ":" + p.second + "\n";
+      string_to_sign += p.first;
+      string_to_sign += ':';
+      string_to_sign += p.second;
+      string_to_sign += '\n';
     }
 
     // remove last linebreak
     string_to_sign.pop_back();
 
-    return Azure::Core::Convert::Base64Encode(_internal::HmacSha256(
-        std::vector<uint8_t>(string_to_sign.begin(), string_to_sign.end()),
-        Azure::Core::Convert::Base64Decode(m_credential->GetAccountKey())));
+    // The account key is decoded once, and signs the buffer without it being copied.
+    return Azure::Core::Convert::Base64Encode(m_credential->GetSigningKey()->Sign(
+        reinterpret_cast<const uint8_t*>(string_to_sign.data()), string_to_sign.size()));
   }
 }}} // namespace Azure::Storage::_internal
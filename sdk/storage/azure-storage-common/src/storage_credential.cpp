@@ -3,6 +3,10 @@
 
 #include "azure/storage/common/storage_credential.hpp"
 
+#include "azure/storage/common/crypt.hpp"
+
+#include <azure/core/base64.hpp>
+
 #include <algorithm>
 
 namespace Azure { namespace Storage { namespace _internal {
@@ -115,3 +119,18 @@ namespace Azure { namespace Storage { namespace _internal {
     return connectionStringParts;
   }
 }}} // namespace Azure::Storage::_internal
+
+namespace Azure { namespace Storage {
+
+  std::shared_ptr<const _internal::HmacSha256Key> StorageSharedKeyCredential::GetSigningKey() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (!m_signingKey)
+    {
+      m_signingKey = std::make_shared<const _internal::HmacSha256Key>(
+          Azure::Core::Convert::Base64Decode(m_accountKey));
+    }
+    return m_signingKey;
+  }
+
+}} // namespace Azure::Storage
@@ -3,6 +3,7 @@
 
 #include "azure/storage/common/storage_exception.hpp"
 
+#include <algorithm>
 #include <type_traits>
 
 #include <azure/core/http/policies/policy.hpp>
@@ -12,6 +13,123 @@
 #include "azure/storage/common/internal/xml_wrapper.hpp"
 
 namespace Azure { namespace Storage {
+  namespace {
+    // Parses the error code, the message and the additional information of a failed response from
+    // its body.
+    void ParseError(
+        const Azure::Core::Http::RawResponse& response,
+        const std::vector<uint8_t>& body,
+        std::string& errorCode,
+        std::string& message,
+        std::map<std::string, std::string>& additionalInformation)
+    {
+      if (response.GetHeaders().find(_internal::HttpHeaderContentType)
+          != response.GetHeaders().end())
+      {
+        if (response.GetHeaders().at(_internal::HttpHeaderContentType).find("xml")
+            != std::string::npos)
+        {
+          auto xmlReader = _internal::XmlReader(
+              reinterpret_cast<const char*>(body.data()), body.size());
+
+          enum class XmlTagName
+          {
+            XmlTagError,
+            XmlTagCode,
+            XmlTagMessage,
+            XmlTagUnknown,
+          };
+          std::vector<XmlTagName> path;
+          std::string startTagName;
+
+          while (true)
+          {
+            auto node = xmlReader.Read();
+            if (node.Type == _internal::XmlNodeType::End)
+            {
+              break;
+            }
+            else if (node.Type == _internal::XmlNodeType::EndTag)
+            {
+              startTagName.clear();
+              if (path.size() > 0)
+              {
+                path.pop_back();
+              }
+              else
+              {
+                break;
+              }
+            }
+            else if (node.Type == _internal::XmlNodeType::StartTag)
+            {
+              startTagName = node.Name;
+              if (node.Name == "Error")
+              {
+                path.emplace_back(XmlTagName::XmlTagError);
+              }
+              else if (node.Name == "Code")
+              {
+                path.emplace_back(XmlTagName::XmlTagCode);
+              }
+              else if (node.Name == "Message")
+              {
+                path.emplace_back(XmlTagName::XmlTagMessage);
+              }
+              else
+              {
+                path.emplace_back(XmlTagName::XmlTagUnknown);
+              }
+            }
+            else if (node.Type == _internal::XmlNodeType::Text)
+            {
+              if (path.size() == 2 && path[0] == XmlTagName::XmlTagError
+                  && path[1] == XmlTagName::XmlTagCode)
+              {
+                errorCode = node.Value;
+              }
+              else if (
+                  path.size() == 2 && path[0] == XmlTagName::XmlTagError
+                  && path[1] == XmlTagName::XmlTagMessage)
+              {
+                message = node.Value;
+              }
+              else if (
+                  path.size() == 2 && path[0] == XmlTagName::XmlTagError
+                  && path[1] == XmlTagName::XmlTagUnknown)
+              {
+                if (!startTagName.empty())
+                {
+                  additionalInformation.emplace(std::move(startTagName), node.Value);
+                }
+              }
+            }
+          }
+        }
+        else if (
+            response.GetHeaders().at(_internal::HttpHeaderContentType).find("html")
+            != std::string::npos)
+        {
+          // TODO: add a refined message parsed from result.
+          message = std::string(body.begin(), body.end());
+        }
+        else if (
+            response.GetHeaders().at(_internal::HttpHeaderContentType).find("json")
+            != std::string::npos)
+        {
+          auto jsonParser = Azure::Core::Json::_internal::json::parse(body);
+          errorCode = jsonParser["error"]["code"].get<std::string>();
+          message = jsonParser["error"]["message"].get<std::string>();
+        }
+        else
+        {
+          // TODO: add a refined message parsed from result.
+          message = std::string(body.begin(), body.end());
+        }
+      }
+    }
+  } // namespace
+
   StorageException StorageException::CreateFromResponse(
       std::unique_ptr<Azure::Core::Http::RawResponse> response)
   {
@@ -36,110 +154,7 @@ namespace Azure { namespace Storage {
     std::string message;
     std::map<std::string, std::string> additionalInformation;
 
-    if (response->GetHeaders().find(_internal::HttpHeaderContentType)
-        != response->GetHeaders().end())
-    {
-      if (response->GetHeaders().at(_internal::HttpHeaderContentType).find("xml")
-          != std::string::npos)
-      {
-        auto xmlReader = _internal::XmlReader(
-            reinterpret_cast<const char*>(bodyBuffer.data()), bodyBuffer.size());
-
-        enum class XmlTagName
-        {
-          XmlTagError,
-          XmlTagCode,
-          XmlTagMessage,
-          XmlTagUnknown,
-        };
-        std::vector<XmlTagName> path;
-        std::string startTagName;
-
-        while (true)
-        {
-          auto node = xmlReader.Read();
-          if (node.Type == _internal::XmlNodeType::End)
-          {
-            break;
-          }
-          else if (node.Type == _internal::XmlNodeType::EndTag)
-          {
-            startTagName.clear();
-            if (path.size() > 0)
-            {
-              path.pop_back();
-            }
-            else
-            {
-              break;
-            }
-          }
-          else if (node.Type == _internal::XmlNodeType::StartTag)
-          {
-            startTagName = node.Name;
-            if (node.Name == "Error")
-            {
-              path.emplace_back(XmlTagName::XmlTagError);
-            }
-            else if (node.Name == "Code")
-            {
-              path.emplace_back(XmlTagName::XmlTagCode);
-            }
-            else if (node.Name == "Message")
-            {
-              path.emplace_back(XmlTagName::XmlTagMessage);
-            }
-            else
-            {
-              path.emplace_back(XmlTagName::XmlTagUnknown);
-            }
-          }
-          else if (node.Type == _internal::XmlNodeType::Text)
-          {
-            if (path.size() == 2 && path[0] == XmlTagName::XmlTagError
-                && path[1] == XmlTagName::XmlTagCode)
-            {
-              errorCode = node.Value;
-            }
-            else if (
-                path.size() == 2 && path[0] == XmlTagName::XmlTagError
-                && path[1] == XmlTagName::XmlTagMessage)
-            {
-              message = node.Value;
-            }
-            else if (
-                path.size() == 2 && path[0] == XmlTagName::XmlTagError
-                && path[1] == XmlTagName::XmlTagUnknown)
-            {
-              if (!startTagName.empty())
-              {
-                additionalInformation.emplace(std::move(startTagName), node.Value);
-              }
-            }
-          }
-        }
-      }
-      else if (
-          response->GetHeaders().at(_internal::HttpHeaderContentType).find("html")
-          != std::string::npos)
-      {
-        // TODO: add a refined message parsed from result.
-        message = std::string(bodyBuffer.begin(), bodyBuffer.end());
-      }
-      else if (
-          response->GetHeaders().at(_internal::HttpHeaderContentType).find("json")
-          != std::string::npos)
-      {
-        auto jsonParser = Azure::Core::Json::_internal::json::parse(bodyBuffer);
-        errorCode = jsonParser["error"]["code"].get<std::string>();
-        message = jsonParser["error"]["message"].get<std::string>();
-      }
-      else
-      {
-        // TODO: add a refined message parsed from result.
-        message = std::string(bodyBuffer.begin(), bodyBuffer.end());
-      }
-    }
+    ParseError(*response, bodyBuffer, errorCode, message, additionalInformation);
 
     StorageException result = StorageException(
         std::to_string(static_cast<std::underlying_type<Azure::Core::Http::HttpStatusCode>::type>(
@@ -155,4 +170,30 @@ namespace Azure { namespace Storage {
     result.AdditionalInformation = std::move(additionalInformation);
     return result;
   }
+
+  namespace _internal {
+    bool IsFailedWith(
+        const Azure::Core::Http::RawResponse& response,
+        Azure::Core::Http::HttpStatusCode statusCode,
+        std::initializer_list<const char*> errorCodes)
+    {
+      if (response.GetStatusCode() != statusCode)
+      {
+        return false;
+      }
+      std::string errorCode;
+      auto errorCodeHeader = response.GetHeaders().find(HttpHeaderErrorCode);
+      if (errorCodeHeader != response.GetHeaders().end())
+      {
+        errorCode = errorCodeHeader->second;
+      }
+      else
+      {
+        std::string message;
+        std::map<std::string, std::string> additionalInformation;
+        ParseError(response, response.GetBody(), errorCode, message, additionalInformation);
+      }
+      return std::find(errorCodes.begin(), errorCodes.end(), errorCode) != errorCodes.end();
+    }
+  } // namespace _internal
 }} // namespace Azure::Storage
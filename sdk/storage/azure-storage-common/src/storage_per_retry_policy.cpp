@@ -8,6 +8,27 @@
 
 #include <algorithm>
 #include <chrono>
+#include <string>
+
+namespace {
+// The requests sent during the same second share the same date, which is only formatted once per
+// second and thread.
+const std::string& GetCurrentDateString()
+{
+  thread_local std::chrono::seconds::rep cachedSeconds = -1;
+  thread_local std::string cachedDateString;
+
+  auto const now = std::chrono::system_clock::now();
+  auto const seconds
+      = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+  if (seconds != cachedSeconds)
+  {
+    cachedDateString = Azure::DateTime(now).ToString(Azure::DateTime::DateFormat::Rfc1123);
+    cachedSeconds = seconds;
+  }
+  return cachedDateString;
+}
+} // namespace
 
 namespace Azure { namespace Storage { namespace _internal {
 
@@ -23,10 +44,7 @@ namespace Azure { namespace Storage { namespace _internal {
     if (headers.find(HttpHeaderDate) == headers.end())
     {
       // add x-ms-date header in RFC1123 format
-      request.SetHeader(
-          HttpHeaderXMsDate,
-          DateTime(std::chrono::system_clock::now())
-              .ToString(Azure::DateTime::DateFormat::Rfc1123));
+      request.SetHeader(HttpHeaderXMsDate, GetCurrentDateString());
     }
 
     const char* HttpHeaderTimeout = "timeout";
@@ -3,50 +3,186 @@
 
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
 
-namespace Azure { namespace Storage { namespace _internal {
+#include <algorithm>
 
-  Azure::Core::Context::Key const SecondaryHostReplicaStatusKey;
+namespace Azure { namespace Storage {
 
-  std::unique_ptr<Azure::Core::Http::RawResponse> StorageSwitchToSecondaryPolicy::Send(
-      Azure::Core::Http::Request& request,
-      Azure::Core::Http::Policies::NextHttpPolicy nextPolicy,
-      const Azure::Core::Context& context) const
-  {
-    std::shared_ptr<bool> replicaStatus;
-    context.TryGetValue(SecondaryHostReplicaStatusKey, replicaStatus);
+  namespace _internal {
+
+    namespace {
+      // The weight of a new latency in the average latency of a host.
+      constexpr double LatencySmoothing = 0.2;
+      // The latency a failed try counts as on a host without a latency yet, in seconds. The
+      // average latency of a host is doubled by each failed try, up to the maximum.
+      constexpr double FailureLatency = 1.0;
+      constexpr double MaxLatency = 60.0;
+
+      bool IsFailure(Azure::Core::Http::HttpStatusCode statusCode)
+      {
+        return statusCode == Azure::Core::Http::HttpStatusCode::TooManyRequests
+            || static_cast<int>(statusCode) >= 500;
+      }
+    } // namespace
+
+    Azure::Core::Context::Key const SecondaryHostReplicaStatusKey;
+    Azure::Core::Context::Key const ReadFromSecondaryKey;
+
+    bool SecondaryReadBalancerState::ChooseSecondary(const Azure::DateTime& now, double random)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (m_maxReplicationLag.HasValue()
+          && (!m_lastSyncTime.HasValue()
+              || now - m_lastSyncTime.Value() > m_maxReplicationLag.Value()))
+      {
+        return false;
+      }
+      if (m_strategy == SecondaryReadBalancer::Strategy::RoundRobin)
+      {
+        const bool secondary = m_nextSecondary;
+        m_nextSecondary = !m_nextSecondary;
+        return secondary;
+      }
+      // Until both hosts have a latency, they get as many reads.
+      if (m_latencies[0] == 0.0 || m_latencies[1] == 0.0)
+      {
+        return random < 0.5;
+      }
+      return random < m_latencies[0] / (m_latencies[0] + m_latencies[1]);
+    }
+
+    void SecondaryReadBalancerState::RecordLatency(
+        bool secondary,
+        std::chrono::steady_clock::duration latency)
+    {
+      const double seconds = std::max(std::chrono::duration<double>(latency).count(), 1e-6);
+      std::lock_guard<std::mutex> guard(m_mutex);
+      double& average = m_latencies[secondary ? 1 : 0];
+      average = average == 0.0 ? seconds
+                               : average * (1.0 - LatencySmoothing) + seconds * LatencySmoothing;
+    }
+
+    void SecondaryReadBalancerState::RecordFailure(bool secondary)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      double& average = m_latencies[secondary ? 1 : 0];
+      average = average == 0.0 ? FailureLatency : std::min(average * 2.0, MaxLatency);
+    }
+
+    void SecondaryReadBalancerState::SetLastSyncTime(const Azure::DateTime& lastSyncTime)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_lastSyncTime = lastSyncTime;
+    }
 
-    bool considerSecondary = (request.GetMethod() == Azure::Core::Http::HttpMethod::Get
-                              || request.GetMethod() == Azure::Core::Http::HttpMethod::Head)
-        && !m_secondaryHost.empty() && replicaStatus && *replicaStatus;
+    double SecondaryReadBalancerState::NextRandom()
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      return std::uniform_real_distribution<double>(0.0, 1.0)(m_random);
+    }
 
-    if (considerSecondary
-        && Azure::Core::Http::Policies::_internal::RetryPolicy::GetRetryCount(context) > 0)
+    std::unique_ptr<Azure::Core::Http::RawResponse> StorageSwitchToSecondaryPolicy::Send(
+        Azure::Core::Http::Request& request,
+        Azure::Core::Http::Policies::NextHttpPolicy nextPolicy,
+        const Azure::Core::Context& context) const
     {
-      // switch host
-      if (request.GetUrl().GetHost() == m_primaryHost)
+      std::shared_ptr<bool> replicaStatus;
+      context.TryGetValue(SecondaryHostReplicaStatusKey, replicaStatus);
+
+      bool considerSecondary = (request.GetMethod() == Azure::Core::Http::HttpMethod::Get
+                                || request.GetMethod() == Azure::Core::Http::HttpMethod::Head)
+          && !m_secondaryHost.empty() && replicaStatus && *replicaStatus;
+
+      const int32_t retryCount
+          = Azure::Core::Http::Policies::_internal::RetryPolicy::GetRetryCount(context);
+      bool readFromSecondary = false;
+      context.TryGetValue(ReadFromSecondaryKey, readFromSecondary);
+      SecondaryReadBalancerState* balancer
+          = considerSecondary && m_readBalancer ? m_readBalancer->m_state.get() : nullptr;
+      if (considerSecondary && retryCount <= 0 && readFromSecondary)
+      {
+        request.GetUrl().SetHost(m_secondaryHost);
+      }
+      else if (
+          balancer != nullptr && retryCount <= 0
+          && balancer->ChooseSecondary(
+              Azure::DateTime(std::chrono::system_clock::now()), balancer->NextRandom()))
       {
         request.GetUrl().SetHost(m_secondaryHost);
       }
+      else if (considerSecondary && retryCount > 0)
+      {
+        // switch host
+        if (request.GetUrl().GetHost() == m_primaryHost)
+        {
+          request.GetUrl().SetHost(m_secondaryHost);
+        }
+        else
+        {
+          request.GetUrl().SetHost(m_primaryHost);
+        }
+      }
+
+      std::unique_ptr<Azure::Core::Http::RawResponse> response;
+      if (balancer == nullptr)
+      {
+        response = nextPolicy.Send(request, context);
+      }
       else
       {
+        const bool secondary = request.GetUrl().GetHost() == m_secondaryHost;
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+          response = nextPolicy.Send(request, context);
+        }
+        catch (Azure::Core::OperationCancelledException&)
+        {
+          throw;
+        }
+        catch (...)
+        {
+          balancer->RecordFailure(secondary);
+          throw;
+        }
+        if (IsFailure(response->GetStatusCode()))
+        {
+          balancer->RecordFailure(secondary);
+        }
+        else
+        {
+          balancer->RecordLatency(secondary, std::chrono::steady_clock::now() - start);
+        }
+      }
+
+      if (considerSecondary
+          && (response->GetStatusCode() == Azure::Core::Http::HttpStatusCode::NotFound
+              || response->GetStatusCode() == Core::Http::HttpStatusCode::PreconditionFailed)
+          && request.GetUrl().GetHost() == m_secondaryHost)
+      {
+        *replicaStatus = false;
+        // switch back
         request.GetUrl().SetHost(m_primaryHost);
+        response = nextPolicy.Send(request, context);
       }
+
+      return response;
     }
 
-    auto response = nextPolicy.Send(request, context);
+  } // namespace _internal
 
-    if (considerSecondary
-        && (response->GetStatusCode() == Azure::Core::Http::HttpStatusCode::NotFound
-            || response->GetStatusCode() == Core::Http::HttpStatusCode::PreconditionFailed)
-        && request.GetUrl().GetHost() == m_secondaryHost)
-    {
-      *replicaStatus = false;
-      // switch back
-      request.GetUrl().SetHost(m_primaryHost);
-      response = nextPolicy.Send(request, context);
-    }
+  SecondaryReadBalancer::SecondaryReadBalancer(
+      Strategy strategy,
+      Azure::Nullable<std::chrono::seconds> maxReplicationLag)
+      : m_strategy(strategy), m_state(std::make_shared<_internal::SecondaryReadBalancerState>(
+                                  strategy, std::move(maxReplicationLag)))
+  {
+  }
 
-    return response;
+  SecondaryReadBalancer::~SecondaryReadBalancer() {}
+
+  void SecondaryReadBalancer::SetLastSyncTime(const Azure::DateTime& lastSyncTime)
+  {
+    m_state->SetLastSyncTime(lastSyncTime);
   }
 
-}}} // namespace Azure::Storage::_internal
+}} // namespace Azure::Storage
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/transfer_affinity.hpp"
+
+#include <azure/core/platform.hpp>
+
+#if defined(AZ_PLATFORM_WINDOWS)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace Azure { namespace Storage {
+
+  namespace {
+#if defined(__linux__)
+    // Reads the first line of a file of sysfs.
+    bool ReadSysfsLine(const std::string& path, std::string& line)
+    {
+      std::ifstream file(path);
+      return file && std::getline(file, line);
+    }
+
+    // Parses a CPU list of sysfs, such as "0-15,32-47".
+    std::vector<int> ParseCpuList(const std::string& cpuList)
+    {
+      std::vector<int> cpus;
+      size_t position = 0;
+      while (position < cpuList.size())
+      {
+        size_t end = cpuList.find(',', position);
+        if (end == std::string::npos)
+        {
+          end = cpuList.size();
+        }
+        const std::string range = cpuList.substr(position, end - position);
+        position = end + 1;
+        if (range.empty())
+        {
+          continue;
+        }
+        const size_t dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+          cpus.push_back(cpu);
+        }
+      }
+      return cpus;
+    }
+#endif
+  } // namespace
+
+  TransferAffinity::TransferAffinity(std::vector<int> cpus) : m_cpus(std::move(cpus))
+  {
+    if (std::any_of(m_cpus.begin(), m_cpus.end(), [](int cpu) { return cpu < 0; }))
+    {
+      throw std::invalid_argument("The indices of the CPUs can't be negative.");
+    }
+  }
+
+  TransferAffinity TransferAffinity::CreateFromNumaNode(int numaNode)
+  {
+    if (numaNode < 0)
+    {
+      throw std::invalid_argument("numaNode can't be negative.");
+    }
+
+    std::vector<int> cpus;
+#if defined(__linux__)
+    std::string cpuList;
+    if (ReadSysfsLine(
+            "/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist", cpuList))
+    {
+      cpus = ParseCpuList(cpuList);
+    }
+#elif defined(AZ_PLATFORM_WINDOWS)
+    GROUP_AFFINITY groupAffinity{};
+    if (numaNode <= 0xFFFF
+        && GetNumaNodeProcessorMaskEx(static_cast<USHORT>(numaNode), &groupAffinity))
+    {
+      for (int bit = 0; bit < static_cast<int>(sizeof(KAFFINITY) * 8); ++bit)
+      {
+        if (groupAffinity.Mask & (static_cast<KAFFINITY>(1) << bit))
+        {
+          cpus.push_back(groupAffinity.Group * static_cast<int>(sizeof(KAFFINITY) * 8) + bit);
+        }
+      }
+    }
+#endif
+    if (cpus.empty())
+    {
+      throw std::runtime_error(
+          "Failed to get the CPUs of NUMA node " + std::to_string(numaNode) + ".");
+    }
+
+    TransferAffinity affinity(std::move(cpus));
+    affinity.m_numaNode = numaNode;
+    return affinity;
+  }
+
+  TransferAffinity TransferAffinity::CreateFromNetworkInterface(
+      const std::string& networkInterface)
+  {
+#if defined(__linux__)
+    const std::string path = "/sys/class/net/" + networkInterface;
+    std::string line;
+    if (networkInterface.empty() || networkInterface.find('/') != std::string::npos
+        || !ReadSysfsLine(path + "/ifindex", line))
+    {
+      throw std::runtime_error("Network interface " + networkInterface + " doesn't exist.");
+    }
+    // Virtual interfaces have no device, and devices of hosts with a single node have -1.
+    if (ReadSysfsLine(path + "/device/numa_node", line))
+    {
+      const int numaNode = std::stoi(line);
+      if (numaNode >= 0)
+      {
+        return CreateFromNumaNode(numaNode);
+      }
+    }
+#else
+    (void)networkInterface;
+#endif
+    return TransferAffinity();
+  }
+
+}} // namespace Azure::Storage
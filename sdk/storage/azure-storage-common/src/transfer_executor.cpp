@@ -0,0 +1,252 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/transfer_executor.hpp"
+
+#include <azure/core/platform.hpp>
+
+#if defined(AZ_PLATFORM_WINDOWS)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage {
+
+  struct TransferExecutor::State final
+  {
+    struct WorkQueue final
+    {
+      std::mutex Mutex;
+      std::deque<std::function<void()>> Tasks;
+    };
+
+    // One queue per thread. A thread takes the newest task of its own queue and the oldest task
+    // of the other queues.
+    std::vector<std::unique_ptr<WorkQueue>> Queues;
+    std::vector<std::thread> Threads;
+    std::atomic<size_t> NextQueue{0};
+
+    // Wakes up the idle threads when tasks are submitted or when the executor is stopped.
+    std::mutex Mutex;
+    std::condition_variable TaskSubmitted;
+    size_t PendingTasks = 0;
+    bool Stopped = false;
+
+    std::mutex ChunkMutex;
+    std::condition_variable ChunkReleased;
+    int MaxInFlightChunks = 0;
+    int InFlightChunks = 0;
+
+    TransferAffinity Affinity;
+
+    bool TryPop(size_t index, std::function<void()>& task);
+    void Run(size_t index);
+  };
+
+  namespace {
+    // The executor and the index of the queue of the worker thread running on this thread, if
+    // any, so that the tasks it submits go to its own queue.
+    thread_local const void* CurrentExecutor = nullptr;
+    thread_local size_t CurrentQueue = 0;
+
+    // Pins the calling thread to some CPUs. It's best effort, the thread keeps running anywhere
+    // if the CPUs can't be used, such as when they aren't allowed for the process.
+    void PinCurrentThread(const std::vector<int>& cpus)
+    {
+      if (cpus.empty())
+      {
+        return;
+      }
+#if defined(__linux__)
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      for (int cpu : cpus)
+      {
+        if (cpu < CPU_SETSIZE)
+        {
+          CPU_SET(cpu, &cpuSet);
+        }
+      }
+      pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#elif defined(AZ_PLATFORM_WINDOWS)
+      // A thread runs in a single processor group, the one of the first CPU.
+      constexpr int GroupSize = static_cast<int>(sizeof(KAFFINITY) * 8);
+      GROUP_AFFINITY groupAffinity{};
+      groupAffinity.Group = static_cast<WORD>(cpus.front() / GroupSize);
+      for (int cpu : cpus)
+      {
+        if (cpu / GroupSize == groupAffinity.Group)
+        {
+          groupAffinity.Mask |= static_cast<KAFFINITY>(1) << (cpu % GroupSize);
+        }
+      }
+      SetThreadGroupAffinity(GetCurrentThread(), &groupAffinity, nullptr);
+#endif
+    }
+  } // namespace
+
+  bool TransferExecutor::State::TryPop(size_t index, std::function<void()>& task)
+  {
+    for (size_t i = 0; i < Queues.size(); ++i)
+    {
+      auto& queue = *Queues[(index + i) % Queues.size()];
+      std::lock_guard<std::mutex> guard(queue.Mutex);
+      if (queue.Tasks.empty())
+      {
+        continue;
+      }
+      if (i == 0)
+      {
+        task = std::move(queue.Tasks.back());
+        queue.Tasks.pop_back();
+      }
+      else
+      {
+        task = std::move(queue.Tasks.front());
+        queue.Tasks.pop_front();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  void TransferExecutor::State::Run(size_t index)
+  {
+    CurrentExecutor = this;
+    CurrentQueue = index;
+    PinCurrentThread(Affinity.Cpus());
+    while (true)
+    {
+      std::function<void()> task;
+      if (TryPop(index, task))
+      {
+        {
+          std::lock_guard<std::mutex> guard(Mutex);
+          --PendingTasks;
+        }
+        task();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(Mutex);
+      TaskSubmitted.wait(lock, [this]() { return Stopped || PendingTasks != 0; });
+      if (Stopped && PendingTasks == 0)
+      {
+        return;
+      }
+    }
+  }
+
+  TransferExecutor::TransferExecutor(int threadCount, int maxInFlightChunks)
+      : TransferExecutor(threadCount, maxInFlightChunks, TransferAffinity())
+  {
+  }
+
+  TransferExecutor::TransferExecutor(
+      int threadCount,
+      int maxInFlightChunks,
+      const TransferAffinity& affinity)
+      : m_state(std::make_unique<State>())
+  {
+    if (threadCount < 1)
+    {
+      throw std::invalid_argument("threadCount must be at least 1.");
+    }
+    if (maxInFlightChunks < 1)
+    {
+      throw std::invalid_argument("maxInFlightChunks must be at least 1.");
+    }
+    m_state->MaxInFlightChunks = maxInFlightChunks;
+    m_state->Affinity = affinity;
+    for (int i = 0; i < threadCount; ++i)
+    {
+      m_state->Queues.push_back(std::make_unique<State::WorkQueue>());
+    }
+    for (size_t i = 0; i < m_state->Queues.size(); ++i)
+    {
+      m_state->Threads.emplace_back(&State::Run, m_state.get(), i);
+    }
+  }
+
+  TransferExecutor::~TransferExecutor()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_state->Mutex);
+      m_state->Stopped = true;
+    }
+    m_state->TaskSubmitted.notify_all();
+    for (auto& thread : m_state->Threads)
+    {
+      thread.join();
+    }
+  }
+
+  int TransferExecutor::ThreadCount() const { return static_cast<int>(m_state->Threads.size()); }
+
+  int TransferExecutor::MaxInFlightChunks() const { return m_state->MaxInFlightChunks; }
+
+  const TransferAffinity& TransferExecutor::Affinity() const { return m_state->Affinity; }
+
+  std::shared_ptr<TransferExecutor> TransferExecutor::GetDefault()
+  {
+    // The chunks are mostly spent waiting for the network, so there are more threads than cores.
+    static const std::shared_ptr<TransferExecutor> defaultExecutor = []() {
+      const int threadCount
+          = std::max(8, 2 * static_cast<int>(std::thread::hardware_concurrency()));
+      return std::make_shared<TransferExecutor>(threadCount, 4 * threadCount);
+    }();
+    return defaultExecutor;
+  }
+
+  void TransferExecutor::Submit(std::function<void()> task)
+  {
+    const size_t index = CurrentExecutor == m_state.get()
+        ? CurrentQueue
+        : m_state->NextQueue.fetch_add(1) % m_state->Queues.size();
+    {
+      auto& queue = *m_state->Queues[index];
+      std::lock_guard<std::mutex> guard(queue.Mutex);
+      queue.Tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> guard(m_state->Mutex);
+      ++m_state->PendingTasks;
+    }
+    m_state->TaskSubmitted.notify_one();
+  }
+
+  void TransferExecutor::AcquireChunk()
+  {
+    std::unique_lock<std::mutex> lock(m_state->ChunkMutex);
+    m_state->ChunkReleased.wait(
+        lock, [this]() { return m_state->InFlightChunks < m_state->MaxInFlightChunks; });
+    ++m_state->InFlightChunks;
+  }
+
+  void TransferExecutor::ReleaseChunk()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_state->ChunkMutex);
+      --m_state->InFlightChunks;
+    }
+    m_state->ChunkReleased.notify_one();
+  }
+
+}} // namespace Azure::Storage
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/common/internal/transfer_progress.hpp"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace Azure { namespace Storage { namespace _internal {
+
+  namespace {
+    // The threads get consecutive indexes, so that the threads of a transfer use different
+    // counters.
+    size_t GetThreadIndex()
+    {
+      static std::atomic<size_t> nextIndex{0};
+      thread_local const size_t index = nextIndex++;
+      return index;
+    }
+
+    int64_t GetTicks() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+  } // namespace
+
+  TransferProgress::TransferProgress(
+      std::function<void(int64_t)> handler,
+      int32_t maxReportsPerSecond)
+      : m_handler(std::move(handler)),
+        m_reportInterval(
+            maxReportsPerSecond > 0
+                ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::seconds(1))
+                        .count()
+                    / maxReportsPerSecond
+                : 0)
+  {
+  }
+
+  void TransferProgress::Add(int64_t bytes)
+  {
+    if (!m_handler)
+    {
+      return;
+    }
+    m_counters[GetThreadIndex() % CounterCount].Bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    // The thread moving the time of the next report makes the report.
+    const int64_t now = GetTicks();
+    int64_t nextReport = m_nextReport.load(std::memory_order_relaxed);
+    if (now >= nextReport
+        && m_nextReport.compare_exchange_strong(
+            nextReport, now + m_reportInterval, std::memory_order_relaxed))
+    {
+      Report(false);
+    }
+  }
+
+  void TransferProgress::Complete()
+  {
+    if (m_handler)
+    {
+      Report(true);
+    }
+  }
+
+  void TransferProgress::Report(bool wait)
+  {
+    // A report due while another one is made is skipped, the last one waits for it instead.
+    while (m_reporting.test_and_set(std::memory_order_acquire))
+    {
+      if (!wait)
+      {
+        return;
+      }
+      std::this_thread::yield();
+    }
+
+    int64_t bytes = 0;
+    for (const auto& counter : m_counters)
+    {
+      bytes += counter.Bytes.load(std::memory_order_relaxed);
+    }
+    try
+    {
+      if (bytes != m_reportedBytes)
+      {
+        m_reportedBytes = bytes;
+        m_handler(bytes);
+      }
+    }
+    catch (...)
+    {
+      m_reporting.clear(std::memory_order_release);
+      throw;
+    }
+    m_reporting.clear(std::memory_order_release);
+  }
+
+}}} // namespace Azure::Storage::_internal
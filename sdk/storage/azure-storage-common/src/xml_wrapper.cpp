@@ -3,10 +3,19 @@
 
 #include "azure/storage/common/internal/xml_wrapper.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <limits>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <azure/core/platform.hpp>
 
@@ -20,16 +29,17 @@
 #include <webservices.h>
 #else
 #include <libxml/xmlreader.h>
-#include <libxml/xmlwriter.h>
 #endif
 
 namespace Azure { namespace Storage { namespace _internal {
 
+  // The platform readers parse the documents the pull parser below doesn't support.
+
 #if defined(AZ_PLATFORM_WINDOWS)
 
-  struct XmlReaderContext
+  struct PlatformXmlReaderContext
   {
-    XmlReaderContext()
+    PlatformXmlReaderContext()
     {
       HRESULT ret = WsCreateError(nullptr, 0, &error);
       if (ret != NO_ERROR)
@@ -43,9 +53,9 @@ namespace Azure { namespace Storage { namespace _internal {
         throw std::runtime_error("Failed to initialize xml reader.");
       }
     }
-    XmlReaderContext(const XmlReaderContext&) = delete;
-    XmlReaderContext& operator=(const XmlReaderContext&) = delete;
-    ~XmlReaderContext()
+    PlatformXmlReaderContext(const PlatformXmlReaderContext&) = delete;
+    PlatformXmlReaderContext& operator=(const PlatformXmlReaderContext&) = delete;
+    ~PlatformXmlReaderContext()
     {
       WsFreeReader(reader);
       WsFreeError(error);
@@ -56,495 +66,1053 @@ namespace Azure { namespace Storage { namespace _internal {
     bool readingAttributes = false;
     ULONG attributeIndex = 0;
     const WS_XML_ELEMENT_NODE* attributeElementNode = nullptr;
+    // The document, the reader parses it in place.
+    std::vector<char> buffer;
+    // The name and value of the last node read. WebServices strings aren't null-terminated and
+    // moving to the next node invalidates them, so they are copied here, reusing the capacity.
+    std::string name;
+    std::string value;
   };
 
-  XmlReader::XmlReader(const char* data, size_t length)
-  {
-    if (length > static_cast<size_t>(std::numeric_limits<ULONG>::max()))
+  namespace {
+    // Parses the start of a document followed by the rest of the stream, if any.
+    std::unique_ptr<PlatformXmlReaderContext> CreatePlatformXmlReader(
+        std::vector<char> document,
+        Azure::Core::IO::BodyStream* stream,
+        const Azure::Core::Context* context)
     {
-      throw std::runtime_error("Xml data too big.");
-    }
+      // Only buffer input is used with WebServices, so the document is read before being parsed.
+      if (stream)
+      {
+        auto rest = stream->ReadToEnd(*context);
+        document.insert(document.end(), rest.begin(), rest.end());
+      }
+      if (document.size() > static_cast<size_t>(std::numeric_limits<ULONG>::max()))
+      {
+        throw std::runtime_error("Xml data too big.");
+      }
 
-    auto context = std::make_unique<XmlReaderContext>();
+      auto readerContext = std::make_unique<PlatformXmlReaderContext>();
+      readerContext->buffer = std::move(document);
+
+      WS_XML_READER_BUFFER_INPUT bufferInput;
+      ZeroMemory(&bufferInput, sizeof(bufferInput));
+      bufferInput.input.inputType = WS_XML_READER_INPUT_TYPE_BUFFER;
+      bufferInput.encodedData = readerContext->buffer.data();
+      bufferInput.encodedDataSize = static_cast<ULONG>(readerContext->buffer.size());
+      WS_XML_READER_TEXT_ENCODING textEncoding;
+      ZeroMemory(&textEncoding, sizeof(textEncoding));
+      textEncoding.encoding.encodingType = WS_XML_READER_ENCODING_TYPE_TEXT;
+      textEncoding.charSet = WS_CHARSET_AUTO;
+      HRESULT ret = WsSetInput(
+          readerContext->reader,
+          &textEncoding.encoding,
+          &bufferInput.input,
+          nullptr,
+          0,
+          readerContext->error);
+      if (ret != S_OK)
+      {
+        throw std::runtime_error("Failed to initialize xml reader.");
+      }
 
-    WS_XML_READER_BUFFER_INPUT bufferInput;
-    ZeroMemory(&bufferInput, sizeof(bufferInput));
-    bufferInput.input.inputType = WS_XML_READER_INPUT_TYPE_BUFFER;
-    bufferInput.encodedData = const_cast<char*>(data);
-    bufferInput.encodedDataSize = static_cast<ULONG>(length);
-    WS_XML_READER_TEXT_ENCODING textEncoding;
-    ZeroMemory(&textEncoding, sizeof(textEncoding));
-    textEncoding.encoding.encodingType = WS_XML_READER_ENCODING_TYPE_TEXT;
-    textEncoding.charSet = WS_CHARSET_AUTO;
-    HRESULT ret = WsSetInput(
-        context->reader, &textEncoding.encoding, &bufferInput.input, nullptr, 0, context->error);
-    if (ret != S_OK)
+      WS_CHARSET charSet;
+      ret = WsGetReaderProperty(
+          readerContext->reader,
+          WS_XML_READER_PROPERTY_CHARSET,
+          &charSet,
+          sizeof(charSet),
+          readerContext->error);
+      if (ret != S_OK)
+      {
+        throw std::runtime_error("Failed to get xml encoding.");
+      }
+      if (charSet != WS_CHARSET_UTF8)
+      {
+        throw std::runtime_error("Unsupported xml encoding.");
+      }
+
+      return readerContext;
+    }
+
+    XmlNodeView ReadPlatformXmlNode(PlatformXmlReaderContext* context)
     {
-      throw std::runtime_error("Failed to initialize xml reader.");
+      auto moveToNext = [&]() {
+        HRESULT ret = WsReadNode(context->reader, context->error);
+        if (!SUCCEEDED(ret))
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+      };
+
+      if (context->readingAttributes)
+      {
+        const WS_XML_ATTRIBUTE* attribute
+            = context->attributeElementNode->attributes[context->attributeIndex];
+
+        context->name.assign(
+            reinterpret_cast<const char*>(attribute->localName->bytes),
+            attribute->localName->length);
+
+        if (attribute->value->textType != WS_XML_TEXT_TYPE_UTF8)
+        {
+          throw std::runtime_error("Unsupported xml encoding.");
+        }
+
+        const WS_XML_UTF8_TEXT* utf8Text
+            = reinterpret_cast<const WS_XML_UTF8_TEXT*>(attribute->value);
+        context->value.assign(
+            reinterpret_cast<const char*>(utf8Text->value.bytes), utf8Text->value.length);
+
+        if (++context->attributeIndex == context->attributeElementNode->attributeCount)
+        {
+          moveToNext();
+          context->readingAttributes = false;
+          context->attributeElementNode = nullptr;
+          context->attributeIndex = 0;
+        }
+
+        return XmlNodeView{
+            XmlNodeType::Attribute,
+            XmlStringView(context->name.data(), context->name.size()),
+            XmlStringView(context->value.data(), context->value.size())};
+      }
+
+      const WS_XML_NODE* node;
+      HRESULT ret = WsGetReaderNode(context->reader, &node, context->error);
+      if (!SUCCEEDED(ret))
+      {
+        throw std::runtime_error("Failed to parse xml.");
+      }
+      switch (node->nodeType)
+      {
+        case WS_XML_NODE_TYPE_ELEMENT: {
+          const WS_XML_ELEMENT_NODE* elementNode
+              = reinterpret_cast<const WS_XML_ELEMENT_NODE*>(node);
+          context->name.assign(
+              reinterpret_cast<const char*>(elementNode->localName->bytes),
+              elementNode->localName->length);
+
+          if (elementNode->attributeCount != 0)
+          {
+            context->readingAttributes = true;
+            context->attributeElementNode = elementNode;
+            context->attributeIndex = 0;
+          }
+          else
+          {
+            moveToNext();
+          }
+
+          return XmlNodeView{
+              XmlNodeType::StartTag, XmlStringView(context->name.data(), context->name.size())};
+        }
+        case WS_XML_NODE_TYPE_TEXT: {
+          context->value.clear();
+          while (true)
+          {
+            const WS_XML_TEXT_NODE* textNode = (const WS_XML_TEXT_NODE*)node;
+            if (textNode->text->textType != WS_XML_TEXT_TYPE_UTF8)
+            {
+              throw std::runtime_error("Unsupported xml encoding.");
+            }
+            const WS_XML_UTF8_TEXT* utf8Text
+                = reinterpret_cast<const WS_XML_UTF8_TEXT*>(textNode->text);
+            context->value.append(
+                reinterpret_cast<const char*>(utf8Text->value.bytes), utf8Text->value.length);
+
+            moveToNext();
+            ret = WsGetReaderNode(context->reader, &node, context->error);
+            if (!SUCCEEDED(ret))
+            {
+              throw std::runtime_error("Failed to parse xml.");
+            }
+            if (node->nodeType != WS_XML_NODE_TYPE_TEXT)
+            {
+              break;
+            }
+          }
+          return XmlNodeView{
+              XmlNodeType::Text,
+              XmlStringView(),
+              XmlStringView(context->value.data(), context->value.size())};
+        }
+        case WS_XML_NODE_TYPE_END_ELEMENT:
+          moveToNext();
+          return XmlNodeView{XmlNodeType::EndTag};
+        case WS_XML_NODE_TYPE_EOF:
+          return XmlNodeView{XmlNodeType::End};
+        case WS_XML_NODE_TYPE_CDATA:
+        case WS_XML_NODE_TYPE_END_CDATA:
+        case WS_XML_NODE_TYPE_COMMENT:
+        case WS_XML_NODE_TYPE_BOF:
+          moveToNext();
+          return ReadPlatformXmlNode(context);
+        default:
+          throw std::runtime_error(
+              "Unknown type " + std::to_string(node->nodeType) + " while parsing xml.");
+      }
     }
+  } // namespace
+
+#else
 
-    WS_CHARSET charSet;
-    ret = WsGetReaderProperty(
-        context->reader, WS_XML_READER_PROPERTY_CHARSET, &charSet, sizeof(charSet), context->error);
-    if (ret != S_OK)
+  struct XmlGlobalInitializer final
+  {
+    XmlGlobalInitializer() { xmlInitParser(); }
+    ~XmlGlobalInitializer() { xmlCleanupParser(); }
+  };
+
+  static void XmlGlobalInitialize() { static XmlGlobalInitializer globalInitializer; }
+
+  struct PlatformXmlReaderContext
+  {
+    PlatformXmlReaderContext() = default;
+    PlatformXmlReaderContext(const PlatformXmlReaderContext&) = delete;
+    PlatformXmlReaderContext& operator=(const PlatformXmlReaderContext&) = delete;
+    ~PlatformXmlReaderContext()
     {
-      throw std::runtime_error("Failed to get xml encoding.");
+      if (reader)
+      {
+        xmlFreeTextReader(reader);
+      }
     }
-    if (charSet != WS_CHARSET_UTF8)
+
+    xmlTextReaderPtr reader = nullptr;
+    bool readingAttributes = false;
+    bool readingEmptyTag = false;
+    // The start of the document, read before the rest of the stream.
+    std::vector<char> buffer;
+    size_t bufferOffset = 0;
+    // The stream the rest of the document is read from, if it is not parsed from memory.
+    Azure::Core::IO::BodyStream* stream = nullptr;
+    const Azure::Core::Context* context = nullptr;
+    // An exception thrown while reading from the stream, it can't go through libxml2.
+    std::exception_ptr streamException;
+
+    void ThrowParseError()
     {
-      throw std::runtime_error("Unsupported xml encoding.");
+      if (streamException)
+      {
+        std::rethrow_exception(streamException);
+      }
+      throw std::runtime_error("Failed to parse xml.");
     }
+  };
 
-    m_context = context.release();
-  }
+  namespace {
+    int ReadFromStream(void* ioContext, char* buffer, int length)
+    {
+      auto context = static_cast<PlatformXmlReaderContext*>(ioContext);
+      if (context->bufferOffset != context->buffer.size())
+      {
+        const size_t copied = std::min(
+            static_cast<size_t>(length), context->buffer.size() - context->bufferOffset);
+        std::memcpy(buffer, context->buffer.data() + context->bufferOffset, copied);
+        context->bufferOffset += copied;
+        return static_cast<int>(copied);
+      }
+      try
+      {
+        return static_cast<int>(context->stream->Read(
+            reinterpret_cast<uint8_t*>(buffer), static_cast<size_t>(length), *context->context));
+      }
+      catch (...)
+      {
+        context->streamException = std::current_exception();
+        return -1;
+      }
+    }
 
-  XmlReader::~XmlReader()
-  {
-    if (m_context)
+    // Names and values returned by libxml2 are null-terminated and owned by the reader.
+    XmlStringView ToStringView(const xmlChar* text)
     {
-      delete static_cast<XmlReaderContext*>(m_context);
+      if (!text)
+      {
+        return XmlStringView();
+      }
+      auto data = reinterpret_cast<const char*>(text);
+      return XmlStringView(data, std::strlen(data));
     }
-  }
 
-  XmlNode XmlReader::Read()
-  {
-    auto context = static_cast<XmlReaderContext*>(m_context);
+    // Parses the start of a document followed by the rest of the stream, if any.
+    std::unique_ptr<PlatformXmlReaderContext> CreatePlatformXmlReader(
+        std::vector<char> document,
+        Azure::Core::IO::BodyStream* stream,
+        const Azure::Core::Context* context)
+    {
+      XmlGlobalInitialize();
 
-    auto moveToNext = [&]() {
-      HRESULT ret = WsReadNode(context->reader, context->error);
-      if (!SUCCEEDED(ret))
+      auto readerContext = std::make_unique<PlatformXmlReaderContext>();
+      readerContext->buffer = std::move(document);
+      if (stream)
       {
-        throw std::runtime_error("Failed to parse xml.");
+        // libxml2 pulls the document from the stream in small chunks while it is parsed.
+        readerContext->stream = stream;
+        readerContext->context = context;
+        readerContext->reader
+            = xmlReaderForIO(ReadFromStream, nullptr, readerContext.get(), nullptr, nullptr, 0);
+        if (!readerContext->reader)
+        {
+          readerContext->ThrowParseError();
+        }
       }
-    };
+      else
+      {
+        if (readerContext->buffer.size() > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+          throw std::runtime_error("Xml data too big.");
+        }
+        readerContext->reader = xmlReaderForMemory(
+            readerContext->buffer.data(),
+            static_cast<int>(readerContext->buffer.size()),
+            nullptr,
+            nullptr,
+            0);
+        if (!readerContext->reader)
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+      }
+      return readerContext;
+    }
 
-    if (context->readingAttributes)
+    XmlNodeView ReadPlatformXmlNode(PlatformXmlReaderContext* context)
     {
-      const WS_XML_ATTRIBUTE* attribute
-          = context->attributeElementNode->attributes[context->attributeIndex];
-
-      std::string name(
-          reinterpret_cast<const char*>(attribute->localName->bytes), attribute->localName->length);
+      if (context->readingAttributes)
+      {
+        int ret = xmlTextReaderMoveToNextAttribute(context->reader);
+        if (ret == 1)
+        {
+          return XmlNodeView{
+              XmlNodeType::Attribute,
+              ToStringView(xmlTextReaderConstName(context->reader)),
+              ToStringView(xmlTextReaderConstValue(context->reader))};
+        }
+        else if (ret == 0)
+        {
+          context->readingAttributes = false;
+        }
+        else
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+      }
+      if (context->readingEmptyTag)
+      {
+        context->readingEmptyTag = false;
+        return XmlNodeView{XmlNodeType::EndTag};
+      }
 
-      if (attribute->value->textType != WS_XML_TEXT_TYPE_UTF8)
+      int ret = xmlTextReaderRead(context->reader);
+      if (ret == 0)
       {
-        throw std::runtime_error("Unsupported xml encoding.");
+        return XmlNodeView{XmlNodeType::End};
+      }
+      if (ret != 1)
+      {
+        context->ThrowParseError();
       }
 
-      const WS_XML_UTF8_TEXT* utf8Text
-          = reinterpret_cast<const WS_XML_UTF8_TEXT*>(attribute->value);
-      std::string value(
-          reinterpret_cast<const char*>(utf8Text->value.bytes), utf8Text->value.length);
+      int type = xmlTextReaderNodeType(context->reader);
+      bool is_empty = xmlTextReaderIsEmptyElement(context->reader) == 1;
+      bool has_value = xmlTextReaderHasValue(context->reader) == 1;
+      bool has_attributes = xmlTextReaderHasAttributes(context->reader) == 1;
 
-      if (++context->attributeIndex == context->attributeElementNode->attributeCount)
+      // libxml2 reports the attributes of an element at its end tag too.
+      if (has_attributes && type == XML_READER_TYPE_ELEMENT)
       {
-        moveToNext();
-        context->readingAttributes = false;
-        context->attributeElementNode = nullptr;
-        context->attributeIndex = 0;
+        context->readingAttributes = true;
       }
 
-      return XmlNode{XmlNodeType::Attribute, std::move(name), std::move(value)};
+      if (type == XML_READER_TYPE_ELEMENT && is_empty)
+      {
+        context->readingEmptyTag = true;
+        return XmlNodeView{
+            XmlNodeType::StartTag, ToStringView(xmlTextReaderConstName(context->reader))};
+      }
+      else if (type == XML_READER_TYPE_ELEMENT)
+      {
+        return XmlNodeView{
+            XmlNodeType::StartTag, ToStringView(xmlTextReaderConstName(context->reader))};
+      }
+      else if (type == XML_READER_TYPE_END_ELEMENT)
+      {
+        return XmlNodeView{XmlNodeType::EndTag};
+      }
+      else if (type == XML_READER_TYPE_TEXT)
+      {
+        if (has_value)
+        {
+          return XmlNodeView{
+              XmlNodeType::Text,
+              XmlStringView(),
+              ToStringView(xmlTextReaderConstValue(context->reader))};
+        }
+      }
+      else if (
+          type == XML_READER_TYPE_SIGNIFICANT_WHITESPACE || type == XML_READER_TYPE_DOCUMENT_TYPE
+          || type == XML_READER_TYPE_COMMENT || type == XML_READER_TYPE_PROCESSING_INSTRUCTION)
+      {
+        // silently ignore, like the pull parser
+      }
+      else
+      {
+        throw std::runtime_error(
+            "Unknown type " + std::to_string(type) + " while parsing xml.");
+      }
+
+      return ReadPlatformXmlNode(context);
     }
+  } // namespace
+
+#endif
 
-    const WS_XML_NODE* node;
-    HRESULT ret = WsGetReaderNode(context->reader, &node, context->error);
-    if (!SUCCEEDED(ret))
+  namespace {
+    constexpr size_t StreamBufferSize = 64 * 1024;
+
+    bool IsXmlWhitespace(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r'; }
+
+    // Normalizes the whitespace of the raw value of an attribute in place, like the line ends and
+    // the whitespace characters are normalized by XML parsers, and returns its new length.
+    size_t NormalizeAttributeValueInPlace(char* value, size_t length)
     {
-      throw std::runtime_error("Failed to parse xml.");
+      char* destination = value;
+      for (size_t i = 0; i < length; ++i)
+      {
+        if (value[i] == '\r' && i + 1 != length && value[i + 1] == '\n')
+        {
+          continue;
+        }
+        *destination++ = IsXmlWhitespace(value[i]) ? ' ' : value[i];
+      }
+      return static_cast<size_t>(destination - value);
     }
-    switch (node->nodeType)
-    {
-      case WS_XML_NODE_TYPE_ELEMENT: {
-        const WS_XML_ELEMENT_NODE* elementNode = reinterpret_cast<const WS_XML_ELEMENT_NODE*>(node);
-        std::string name(
-            reinterpret_cast<const char*>(elementNode->localName->bytes),
-            elementNode->localName->length);
 
-        if (elementNode->attributeCount != 0)
+    // Parses the documents returned by the services, which are UTF-8, have no DTD and only use the
+    // predefined entities, without the overhead of a general parser: the markup is found with a
+    // few scans of the buffer, the text is unescaped in place, and the nodes returned point into
+    // the buffer. A document streamed from the service is parsed while it is read, the buffer only
+    // holds the nodes which haven't been parsed yet.
+    class XmlPullParser final {
+    public:
+      // The document is copied, so that it can be unescaped in place.
+      explicit XmlPullParser(const char* data, size_t length)
+          : m_buffer(data, data + length), m_end(length)
+      {
+      }
+
+      explicit XmlPullParser(
+          Azure::Core::IO::BodyStream& stream,
+          const Azure::Core::Context& context)
+          : m_stream(&stream), m_context(&context)
+      {
+      }
+
+      // Returns false if the document has a document type declaration, which can define entities,
+      // or isn't UTF-8. Only reads the prolog, so that the document can be parsed by another
+      // reader.
+      bool IsSupported();
+
+      // The part of the document read from the stream, or the whole document.
+      std::vector<char> TakeBuffer()
+      {
+        m_buffer.resize(m_end);
+        m_buffer.erase(
+            m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_begin));
+        return std::move(m_buffer);
+      }
+
+      XmlNodeView Read();
+
+    private:
+      struct Attribute final
+      {
+        size_t NameOffset;
+        size_t NameLength;
+        size_t ValueOffset;
+        size_t ValueLength;
+      };
+
+      // The part of the buffer which hasn't been parsed, the offsets below are relative to it.
+      char* Data() { return m_buffer.data() + m_begin; }
+      size_t Available() const { return m_end - m_begin; }
+
+      // Reads more of the stream, after moving the part which hasn't been parsed to the start of
+      // the buffer. Returns false at the end of the document.
+      bool Fill()
+      {
+        if (!m_stream)
         {
-          context->readingAttributes = true;
-          context->attributeElementNode = elementNode;
-          context->attributeIndex = 0;
+          return false;
         }
-        else
+        if (m_begin != 0)
         {
-          moveToNext();
+          std::memmove(m_buffer.data(), Data(), Available());
+          m_end -= m_begin;
+          m_begin = 0;
         }
-
-        return XmlNode{XmlNodeType::StartTag, std::move(name)};
+        if (m_end == m_buffer.size())
+        {
+          m_buffer.resize(std::max(m_buffer.size() * 2, StreamBufferSize));
+        }
+        const size_t read = m_stream->Read(
+            reinterpret_cast<uint8_t*>(m_buffer.data() + m_end),
+            m_buffer.size() - m_end,
+            *m_context);
+        if (read == 0)
+        {
+          m_stream = nullptr;
+          return false;
+        }
+        m_end += read;
+        return true;
       }
-      case WS_XML_NODE_TYPE_TEXT: {
-        std::string value;
-        while (true)
+
+      bool Ensure(size_t length)
+      {
+        while (Available() < length)
         {
-          const WS_XML_TEXT_NODE* textNode = (const WS_XML_TEXT_NODE*)node;
-          if (textNode->text->textType != WS_XML_TEXT_TYPE_UTF8)
+          if (!Fill())
           {
-            throw std::runtime_error("Unsupported xml encoding.");
+            return false;
           }
-          const WS_XML_UTF8_TEXT* utf8Text
-              = reinterpret_cast<const WS_XML_UTF8_TEXT*>(textNode->text);
-          value += std::string(
-              reinterpret_cast<const char*>(utf8Text->value.bytes), utf8Text->value.length);
+        }
+        return true;
+      }
 
-          moveToNext();
-          ret = WsGetReaderNode(context->reader, &node, context->error);
-          if (!SUCCEEDED(ret))
+      size_t Find(size_t offset, const char* pattern, size_t patternLength)
+      {
+        while (true)
+        {
+          if (offset < Available())
           {
-            throw std::runtime_error("Failed to parse xml.");
+            const char* const data = Data();
+            const char* const end = data + Available();
+            const char* const found = patternLength == 1
+                ? static_cast<const char*>(
+                    std::memchr(data + offset, *pattern, Available() - offset))
+                : std::search(data + offset, end, pattern, pattern + patternLength);
+            if (found && found != end)
+            {
+              return static_cast<size_t>(found - data);
+            }
           }
-          if (node->nodeType != WS_XML_NODE_TYPE_TEXT)
+          offset = std::max(offset, Available() - std::min(Available(), patternLength - 1));
+          if (!Fill())
           {
-            break;
+            return std::string::npos;
           }
         }
-        return XmlNode{XmlNodeType::Text, std::string(), std::move(value)};
-      }
-      case WS_XML_NODE_TYPE_END_ELEMENT:
-        moveToNext();
-        return XmlNode{XmlNodeType::EndTag, std::string()};
-      case WS_XML_NODE_TYPE_EOF:
-        return XmlNode{XmlNodeType::End};
-      case WS_XML_NODE_TYPE_CDATA:
-      case WS_XML_NODE_TYPE_END_CDATA:
-      case WS_XML_NODE_TYPE_COMMENT:
-      case WS_XML_NODE_TYPE_BOF:
-        moveToNext();
-        return Read();
-      default:
-        throw std::runtime_error(
-            "Unknown type " + std::to_string(node->nodeType) + " while parsing xml.");
-    }
-  }
+      }
 
-  struct XmlWriterContext
-  {
-    XmlWriterContext()
+      bool StartsWith(size_t offset, const char* prefix, size_t prefixLength)
+      {
+        return Ensure(offset + prefixLength)
+            && std::memcmp(Data() + offset, prefix, prefixLength) == 0;
+      }
+
+      // Reads the text up to the next markup with the CDATA sections it contains, and unescapes it
+      // in place, at an offset of the buffer. Returns false at the end of the document.
+      bool ReadText(size_t& offset, size_t& length, bool& isWhitespace);
+
+      XmlNodeView ReadStartTag();
+      XmlNodeView ReadEndTag();
+
+      std::vector<char> m_buffer;
+      size_t m_begin = 0;
+      size_t m_end = 0;
+      Azure::Core::IO::BodyStream* m_stream = nullptr;
+      const Azure::Core::Context* m_context = nullptr;
+      // Whether the '<' starting the markup at the start of the buffer was parsed.
+      bool m_inMarkup = false;
+      std::vector<Attribute> m_attributes;
+      size_t m_nextAttribute = 0;
+      bool m_readingEmptyTag = false;
+      bool m_rootRead = false;
+      // The names of the open elements, to match the end tags.
+      std::string m_openElements;
+      std::vector<size_t> m_openElementLengths;
+    };
+
+    bool XmlPullParser::IsSupported()
     {
-      HRESULT ret = WsCreateError(nullptr, 0, &error);
-      if (ret != NO_ERROR)
+      if (StartsWith(0, "\xEF\xBB\xBF", 3))
       {
-        throw std::runtime_error("Failed to initialize xml writer.");
+        m_begin += 3;
       }
-      ret = WsCreateWriter(nullptr, 0, &writer, error);
-      if (ret != NO_ERROR)
+      // A document in UTF-16 starts with a byte order mark, or with a null byte.
+      if (Ensure(2)
+          && (std::memcmp(Data(), "\xFF\xFE", 2) == 0 || std::memcmp(Data(), "\xFE\xFF", 2) == 0
+              || Data()[0] == '\0' || Data()[1] == '\0'))
       {
-        WsFreeError(error);
-        throw std::runtime_error("Failed to initialize xml writer.");
+        return false;
       }
-      ret = WsCreateHeap(1024 * 1024 * 1024, 512, nullptr, 0, &heap, error);
-      if (ret != NO_ERROR)
+      size_t offset = 0;
+      while (true)
       {
-        WsFreeWriter(writer);
-        WsFreeError(error);
-        throw std::runtime_error("Failed to initialize xml writer.");
+        while (Ensure(offset + 1) && IsXmlWhitespace(Data()[offset]))
+        {
+          ++offset;
+        }
+        if (StartsWith(offset, "<?", 2))
+        {
+          const size_t end = Find(offset, "?>", 2);
+          if (end == std::string::npos)
+          {
+            return true;
+          }
+          const std::string declaration(Data() + offset, Data() + end);
+          const size_t encoding = declaration.find("encoding");
+          if (declaration.compare(0, 6, "<?xml ") == 0 && encoding != std::string::npos)
+          {
+            const size_t valueStart = declaration.find_first_of("\"'", encoding);
+            const size_t valueEnd = valueStart == std::string::npos
+                ? std::string::npos
+                : declaration.find(declaration[valueStart], valueStart + 1);
+            if (valueEnd == std::string::npos)
+            {
+              return false;
+            }
+            std::string value = declaration.substr(valueStart + 1, valueEnd - valueStart - 1);
+            std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+              return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            });
+            if (value != "utf-8" && value != "utf8")
+            {
+              return false;
+            }
+          }
+          offset = end + 2;
+        }
+        else if (StartsWith(offset, "<!--", 4))
+        {
+          const size_t end = Find(offset + 4, "-->", 3);
+          if (end == std::string::npos)
+          {
+            return true;
+          }
+          offset = end + 3;
+        }
+        else
+        {
+          // The declarations other than comments come before the root element.
+          return !StartsWith(offset, "<!", 2);
+        }
       }
     }
-    XmlWriterContext(const XmlWriterContext&) = delete;
-    XmlWriterContext& operator=(const XmlWriterContext&) = delete;
-    ~XmlWriterContext()
-    {
-      WsFreeHeap(heap);
-      WsFreeWriter(writer);
-      WsFreeError(error);
-    }
-
-    WS_XML_WRITER* writer = nullptr;
-    WS_ERROR* error = nullptr;
-    WS_HEAP* heap = nullptr;
-    WS_XML_BUFFER* buffer = nullptr;
-  };
-
-  XmlWriter::XmlWriter()
-  {
-    auto context = std::make_unique<XmlWriterContext>();
 
-    HRESULT ret = WsCreateXmlBuffer(context->heap, nullptr, 0, &context->buffer, context->error);
-    if (ret != NO_ERROR)
+    bool XmlPullParser::ReadText(size_t& textOffset, size_t& length, bool& isWhitespace)
     {
-      throw std::runtime_error("Failed to initialize xml writer.");
+      length = 0;
+      isWhitespace = true;
+      size_t offset = 0;
+      while (true)
+      {
+        const size_t markup = Find(offset, "<", 1);
+        const size_t textEnd = markup == std::string::npos ? Available() : markup;
+        char* data = Data();
+        isWhitespace = isWhitespace && std::all_of(data + offset, data + textEnd, IsXmlWhitespace);
+        if (length != offset)
+        {
+          std::memmove(data + length, data + offset, textEnd - offset);
+        }
+        length += UnescapeXmlTextInPlace(data + length, textEnd - offset);
+        if (markup == std::string::npos)
+        {
+          m_begin = m_end;
+          return false;
+        }
+        if (!StartsWith(markup + 1, "![CDATA[", 8))
+        {
+          textOffset = m_begin;
+          m_begin += markup + 1;
+          return true;
+        }
+        const size_t cdataStart = markup + 9;
+        const size_t cdataEnd = Find(cdataStart, "]]>", 3);
+        if (cdataEnd == std::string::npos)
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+        data = Data();
+        std::memmove(data + length, data + cdataStart, cdataEnd - cdataStart);
+        length += cdataEnd - cdataStart;
+        isWhitespace = false;
+        offset = cdataEnd + 3;
+      }
     }
 
-    ret = WsSetOutputToBuffer(context->writer, context->buffer, nullptr, 0, context->error);
-    if (ret != NO_ERROR)
+    XmlNodeView XmlPullParser::ReadStartTag()
     {
-      throw std::runtime_error("Failed to initialize xml writer.");
-    }
-
-    m_context = context.release();
-  }
+      // The end of the tag is the first '>' which isn't in the value of an attribute.
+      size_t tagEnd = 0;
+      char quote = '\0';
+      while (true)
+      {
+        if (tagEnd == Available() && !Fill())
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+        const char c = Data()[tagEnd];
+        if (quote != '\0')
+        {
+          quote = c == quote ? '\0' : quote;
+        }
+        else if (c == '"' || c == '\'')
+        {
+          quote = c;
+        }
+        else if (c == '>')
+        {
+          break;
+        }
+        ++tagEnd;
+      }
 
-  XmlWriter::~XmlWriter()
-  {
-    if (m_context)
-    {
-      delete static_cast<XmlWriterContext*>(m_context);
-    }
-  }
+      // The tag is parsed in place, the names and values are null-terminated once the characters
+      // following them are parsed.
+      char* const data = Data();
+      auto isNameEnd
+          = [](char c) { return IsXmlWhitespace(c) || c == '/' || c == '>' || c == '='; };
+      auto skipWhitespace = [&](size_t i) {
+        while (i != tagEnd && IsXmlWhitespace(data[i]))
+        {
+          ++i;
+        }
+        return i;
+      };
+      size_t i = 0;
+      while (i != tagEnd && !isNameEnd(data[i]))
+      {
+        ++i;
+      }
+      const size_t nameLength = i;
+      // There is a single root element.
+      if (nameLength == 0 || (m_rootRead && m_openElementLengths.empty()))
+      {
+        throw std::runtime_error("Failed to parse xml.");
+      }
+      m_attributes.clear();
+      m_nextAttribute = 0;
+      bool isEmpty = false;
+      while ((i = skipWhitespace(i)) != tagEnd)
+      {
+        if (data[i] == '/')
+        {
+          if (i + 1 != tagEnd)
+          {
+            throw std::runtime_error("Failed to parse xml.");
+          }
+          isEmpty = true;
+          break;
+        }
+        const size_t attributeNameOffset = i;
+        while (i != tagEnd && !isNameEnd(data[i]))
+        {
+          ++i;
+        }
+        const size_t attributeNameLength = i - attributeNameOffset;
+        i = skipWhitespace(i);
+        if (attributeNameLength == 0 || i == tagEnd || data[i] != '=')
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+        i = skipWhitespace(i + 1);
+        if (i == tagEnd || (data[i] != '"' && data[i] != '\''))
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+        const size_t valueOffset = i + 1;
+        const size_t valueEnd = static_cast<size_t>(
+            static_cast<const char*>(std::memchr(data + valueOffset, data[i], tagEnd - valueOffset))
+            - data);
+        size_t valueLength
+            = NormalizeAttributeValueInPlace(data + valueOffset, valueEnd - valueOffset);
+        valueLength = UnescapeXmlTextInPlace(data + valueOffset, valueLength);
+        data[attributeNameOffset + attributeNameLength] = '\0';
+        data[valueOffset + valueLength] = '\0';
+        m_attributes.push_back(Attribute{
+            m_begin + attributeNameOffset,
+            attributeNameLength,
+            m_begin + valueOffset,
+            valueLength});
+        i = valueEnd + 1;
+      }
 
-  void XmlWriter::Write(XmlNode node)
-  {
-    auto context = static_cast<XmlWriterContext*>(m_context);
-    if (node.Type == XmlNodeType::StartTag)
-    {
-      if (!node.Value.empty())
+      if (isEmpty)
       {
-        Write(XmlNode{XmlNodeType::StartTag, std::move(node.Name)});
-        Write(XmlNode{XmlNodeType::Text, std::string(), std::move(node.Value)});
-        Write(XmlNode{XmlNodeType::EndTag});
-        return;
-      }
-      WS_XML_STRING name;
-      name.bytes = reinterpret_cast<BYTE*>(&node.Name[0]);
-      name.length = static_cast<ULONG>(node.Name.length());
-      name.dictionary = nullptr;
-      WS_XML_STRING ns = WS_XML_STRING_NULL;
-      HRESULT ret = WsWriteStartElement(context->writer, nullptr, &name, &ns, context->error);
-      if (!SUCCEEDED(ret))
+        m_readingEmptyTag = true;
+      }
+      else
       {
-        throw std::runtime_error("Failed to write xml.");
+        m_openElements.append(data, nameLength);
+        m_openElementLengths.push_back(nameLength);
       }
+      data[nameLength] = '\0';
+      const size_t nameOffset = m_begin;
+      m_begin += tagEnd + 1;
+      m_inMarkup = false;
+      m_rootRead = true;
+      return XmlNodeView{XmlNodeType::StartTag, XmlStringView(&m_buffer[nameOffset], nameLength)};
     }
-    else if (node.Type == XmlNodeType::EndTag)
+
+    XmlNodeView XmlPullParser::ReadEndTag()
     {
-      HRESULT ret = WsWriteEndElement(context->writer, context->error);
-      if (!SUCCEEDED(ret))
+      const size_t tagEnd = Find(1, ">", 1);
+      if (tagEnd == std::string::npos || m_openElementLengths.empty())
       {
-        throw std::runtime_error("Failed to write xml.");
+        throw std::runtime_error("Failed to parse xml.");
       }
-    }
-    else if (node.Type == XmlNodeType::Text)
-    {
-      HRESULT ret = WsWriteCharsUtf8(
-          context->writer,
-          reinterpret_cast<const BYTE*>(node.Value.data()),
-          static_cast<ULONG>(node.Value.size()),
-          context->error);
-      if (!SUCCEEDED(ret))
+      const char* const data = Data();
+      size_t nameEnd = tagEnd;
+      while (nameEnd != 1 && IsXmlWhitespace(data[nameEnd - 1]))
       {
-        throw std::runtime_error("Failed to write xml.");
+        --nameEnd;
       }
+      const size_t nameLength = m_openElementLengths.back();
+      if (nameEnd - 1 != nameLength
+          || m_openElements.compare(
+                 m_openElements.length() - nameLength, nameLength, data + 1, nameLength)
+              != 0)
+      {
+        throw std::runtime_error("Failed to parse xml.");
+      }
+      m_openElements.resize(m_openElements.length() - nameLength);
+      m_openElementLengths.pop_back();
+      m_begin += tagEnd + 1;
+      m_inMarkup = false;
+      return XmlNodeView{XmlNodeType::EndTag};
     }
-    else if (node.Type == XmlNodeType::Attribute)
+
+    XmlNodeView XmlPullParser::Read()
     {
-      WS_XML_STRING name;
-      name.bytes = reinterpret_cast<BYTE*>(&node.Name[0]);
-      name.length = static_cast<ULONG>(node.Name.length());
-      name.dictionary = nullptr;
-      WS_XML_STRING ns = WS_XML_STRING_NULL;
-      HRESULT ret
-          = WsWriteStartAttribute(context->writer, nullptr, &name, &ns, FALSE, context->error);
-      if (!SUCCEEDED(ret))
+      if (m_nextAttribute != m_attributes.size())
       {
-        throw std::runtime_error("Failed to write xml.");
+        const Attribute& attribute = m_attributes[m_nextAttribute++];
+        return XmlNodeView{
+            XmlNodeType::Attribute,
+            XmlStringView(m_buffer.data() + attribute.NameOffset, attribute.NameLength),
+            XmlStringView(m_buffer.data() + attribute.ValueOffset, attribute.ValueLength)};
       }
-      Write(XmlNode{XmlNodeType::Text, std::string(), std::move(node.Value)});
-      ret = WsWriteEndAttribute(context->writer, context->error);
-      if (!SUCCEEDED(ret))
+      if (m_readingEmptyTag)
       {
-        throw std::runtime_error("Failed to write xml.");
+        m_readingEmptyTag = false;
+        return XmlNodeView{XmlNodeType::EndTag};
       }
-    }
-    else if (node.Type == XmlNodeType::End)
-    {
-    }
-    else
-    {
-      throw std::runtime_error(
-          "Unsupported XmlNode type "
-          + std::to_string(static_cast<std::underlying_type<XmlNodeType>::type>(node.Type)) + ".");
-    }
-  }
 
-  std::string XmlWriter::GetDocument()
-  {
-    auto context = static_cast<XmlWriterContext*>(m_context);
-
-    BOOL boolValueTrue = TRUE;
-    WS_XML_WRITER_PROPERTY writerProperty;
-    writerProperty.id = WS_XML_WRITER_PROPERTY_WRITE_DECLARATION;
-    writerProperty.value = &boolValueTrue;
-    writerProperty.valueSize = sizeof(boolValueTrue);
-    void* xml = nullptr;
-    ULONG xmlLength = 0;
-    HRESULT ret = WsWriteXmlBufferToBytes(
-        context->writer,
-        context->buffer,
-        nullptr,
-        &writerProperty,
-        1,
-        context->heap,
-        &xml,
-        &xmlLength,
-        context->error);
-    if (!SUCCEEDED(ret))
-    {
-      throw std::runtime_error("Failed to write xml.");
-    }
-
-    return std::string(static_cast<const char*>(xml), xmlLength);
-  }
-
-#else
+      while (true)
+      {
+        if (!m_inMarkup)
+        {
+          size_t textOffset = 0;
+          size_t length = 0;
+          bool isWhitespace = true;
+          const bool hasMarkup = ReadText(textOffset, length, isWhitespace);
+          // Only whitespace may be around the root element.
+          if (!isWhitespace && m_openElementLengths.empty())
+          {
+            throw std::runtime_error("Failed to parse xml.");
+          }
+          if (!hasMarkup)
+          {
+            if (!m_rootRead || !m_openElementLengths.empty())
+            {
+              throw std::runtime_error("Failed to parse xml.");
+            }
+            return XmlNodeView{XmlNodeType::End};
+          }
+          // The '<' of the markup may be replaced by the null terminator of the text.
+          m_inMarkup = true;
+          if (!isWhitespace)
+          {
+            m_buffer[textOffset + length] = '\0';
+            return XmlNodeView{
+                XmlNodeType::Text, XmlStringView(), XmlStringView(&m_buffer[textOffset], length)};
+          }
+        }
 
-  struct XmlGlobalInitializer final
-  {
-    XmlGlobalInitializer() { xmlInitParser(); }
-    ~XmlGlobalInitializer() { xmlCleanupParser(); }
-  };
+        if (!Ensure(1))
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+        const char c = Data()[0];
+        if (c == '/')
+        {
+          return ReadEndTag();
+        }
+        if (c != '?' && c != '!')
+        {
+          return ReadStartTag();
+        }
+        // Processing instructions and comments are skipped.
+        const size_t end = c == '?' ? Find(1, "?>", 2)
+            : StartsWith(1, "--", 2) ? Find(3, "-->", 3)
+                                     : std::string::npos;
+        if (end == std::string::npos)
+        {
+          throw std::runtime_error("Failed to parse xml.");
+        }
+        m_begin += end + (c == '?' ? 2 : 3);
+        m_inMarkup = false;
+      }
+    }
+  } // namespace
 
-  static void XmlGlobalInitialize() { static XmlGlobalInitializer globalInitializer; }
+  namespace {
+    struct XmlReaderContext final
+    {
+      template <class... Args>
+      explicit XmlReaderContext(Args&&... args) : parser(std::forward<Args>(args)...)
+      {
+      }
 
-  struct XmlReaderContext
-  {
-    xmlTextReaderPtr reader = nullptr;
-    bool readingAttributes = false;
-    bool readingEmptyTag = false;
-  };
+      XmlPullParser parser;
+      // Parses the document instead of the pull parser when it isn't supported.
+      std::unique_ptr<PlatformXmlReaderContext> platformReader;
+    };
+  } // namespace
 
   XmlReader::XmlReader(const char* data, size_t length)
   {
-    XmlGlobalInitialize();
-
-    if (length > static_cast<size_t>(std::numeric_limits<int>::max()))
+    auto context = std::make_unique<XmlReaderContext>(data, length);
+    if (!context->parser.IsSupported())
     {
-      throw std::runtime_error("Xml data too big.");
+      context->platformReader
+          = CreatePlatformXmlReader(context->parser.TakeBuffer(), nullptr, nullptr);
     }
+    m_context = context.release();
+  }
 
-    xmlTextReaderPtr reader
-        = xmlReaderForMemory(data, static_cast<int>(length), nullptr, nullptr, 0);
-    if (!reader)
+  XmlReader::XmlReader(Azure::Core::IO::BodyStream& stream, const Azure::Core::Context& context)
+  {
+    auto readerContext = std::make_unique<XmlReaderContext>(stream, context);
+    if (!readerContext->parser.IsSupported())
     {
-      throw std::runtime_error("Failed to parse xml.");
+      readerContext->platformReader
+          = CreatePlatformXmlReader(readerContext->parser.TakeBuffer(), &stream, &context);
     }
-
-    XmlReaderContext* context = new XmlReaderContext();
-    context->reader = reader;
-    m_context = context;
+    m_context = readerContext.release();
   }
 
   XmlReader::~XmlReader()
   {
     if (m_context)
     {
-      auto context = static_cast<XmlReaderContext*>(m_context);
-      xmlFreeTextReader(static_cast<xmlTextReaderPtr>(context->reader));
-      delete context;
+      delete static_cast<XmlReaderContext*>(m_context);
     }
   }
 
-  XmlNode XmlReader::Read()
+  XmlNodeView XmlReader::Read()
   {
     auto context = static_cast<XmlReaderContext*>(m_context);
-    if (context->readingAttributes)
-    {
-      int ret = xmlTextReaderMoveToNextAttribute(context->reader);
-      if (ret == 1)
-      {
-        const char* name = reinterpret_cast<const char*>(xmlTextReaderConstName(context->reader));
-        const char* value = reinterpret_cast<const char*>(xmlTextReaderConstValue(context->reader));
-        return XmlNode{XmlNodeType::Attribute, name, value};
-      }
-      else if (ret == 0)
-      {
-        context->readingAttributes = false;
-      }
-      else
-      {
-        throw std::runtime_error("Failed to parse xml.");
-      }
-    }
-    if (context->readingEmptyTag)
+    if (context->platformReader)
     {
-      context->readingEmptyTag = false;
-      return XmlNode{XmlNodeType::EndTag};
+      return ReadPlatformXmlNode(context->platformReader.get());
     }
+    return context->parser.Read();
+  }
 
-    int ret = xmlTextReaderRead(context->reader);
-    if (ret == 0)
-    {
-      return XmlNode{XmlNodeType::End};
-    }
-    if (ret != 1)
+  namespace {
+    // Escapes the same characters as libxml2.
+    void EscapeXml(std::string& document, const std::string& text, bool isAttribute)
     {
-      throw std::runtime_error("Failed to parse xml.");
+      for (auto c : text)
+      {
+        switch (c)
+        {
+          case '&':
+            document += "&amp;";
+            break;
+          case '<':
+            document += "&lt;";
+            break;
+          case '>':
+            document += "&gt;";
+            break;
+          case '"':
+            document += "&quot;";
+            break;
+          case '\r':
+            document += "&#13;";
+            break;
+          case '\n':
+            document += isAttribute ? "&#10;" : "\n";
+            break;
+          case '\t':
+            document += isAttribute ? "&#9;" : "\t";
+            break;
+          default:
+            document += c;
+            break;
+        }
+      }
     }
+  } // namespace
 
-    int type = xmlTextReaderNodeType(context->reader);
-    bool is_empty = xmlTextReaderIsEmptyElement(context->reader) == 1;
-    bool has_value = xmlTextReaderHasValue(context->reader) == 1;
-    bool has_attributes = xmlTextReaderHasAttributes(context->reader) == 1;
-
-    const char* name = reinterpret_cast<const char*>(xmlTextReaderConstName(context->reader));
-    const char* value = reinterpret_cast<const char*>(xmlTextReaderConstValue(context->reader));
+  // The writer is the same on all platforms. The documents sent to the services are small and
+  // have fixed schemas, so appending to a string is cheaper than setting up a libxml2 or
+  // WebServices writer for each request.
+  struct XmlWriterContext
+  {
+    std::string document;
+    // The offset and length of the names of the open elements, in the document.
+    std::vector<std::pair<size_t, size_t>> openElements;
+    // Whether the last start tag is missing its closing '>', so attributes can still be added.
+    bool startTagOpen = false;
 
-    if (has_attributes)
+    void CloseStartTag()
     {
-      context->readingAttributes = true;
+      if (startTagOpen)
+      {
+        document += '>';
+        startTagOpen = false;
+      }
     }
 
-    if (type == XML_READER_TYPE_ELEMENT && is_empty)
-    {
-      context->readingEmptyTag = true;
-      return XmlNode{XmlNodeType::StartTag, name};
-    }
-    else if (type == XML_READER_TYPE_ELEMENT)
-    {
-      return XmlNode{XmlNodeType::StartTag, name};
-    }
-    else if (type == XML_READER_TYPE_END_ELEMENT)
+    void StartElement(const std::string& name)
     {
-      return XmlNode{XmlNodeType::EndTag};
+      CloseStartTag();
+      document += '<';
+      openElements.emplace_back(document.size(), name.size());
+      document += name;
+      startTagOpen = true;
     }
-    else if (type == XML_READER_TYPE_TEXT)
+
+    void EndElement()
     {
-      if (has_value)
+      if (openElements.empty())
       {
-        return XmlNode{XmlNodeType::Text, std::string(), value};
+        throw std::runtime_error("Failed to write xml.");
       }
+      if (startTagOpen)
+      {
+        document += "/>";
+        startTagOpen = false;
+      }
+      else
+      {
+        auto const& element = openElements.back();
+        // Reserve first, so the name isn't moved while it is appended.
+        document.reserve(document.size() + element.second + 3);
+        document += "</";
+        document.append(document.data() + element.first, element.second);
+        document += '>';
+      }
+      openElements.pop_back();
     }
-    else if (type == XML_READER_TYPE_SIGNIFICANT_WHITESPACE)
-    {
-      // silently ignore
-    }
-    else
+
+    void Escape(const std::string& text, bool isAttribute)
     {
-      throw std::runtime_error("Unknown type " + std::to_string(type) + " while parsing xml.");
+      EscapeXml(document, text, isAttribute);
     }
-
-    return Read();
-  }
-
-  struct XmlWriterContext
-  {
-    xmlBufferPtr buffer;
-    xmlTextWriterPtr writer;
   };
 
   XmlWriter::XmlWriter()
   {
-    XmlGlobalInitialize();
-    auto buffer = xmlBufferCreate();
-
-    if (!buffer)
-    {
-      throw std::runtime_error("Failed to initialize xml writer.");
-    }
-
-    auto writer = xmlNewTextWriterMemory(static_cast<xmlBufferPtr>(buffer), 0);
-
-    if (!writer)
-    {
-      xmlBufferFree(static_cast<xmlBufferPtr>(buffer));
-      throw std::runtime_error("Failed to initialize xml writer.");
-    }
-
-    xmlTextWriterStartDocument(static_cast<xmlTextWriterPtr>(writer), nullptr, nullptr, nullptr);
-
     auto context = new XmlWriterContext;
-    context->buffer = buffer;
-    context->writer = writer;
+    context->document.reserve(1024);
+    context->document += "<?xml version=\"1.0\"?>\n";
     m_context = context;
   }
 
@@ -552,50 +1120,51 @@ namespace Azure { namespace Storage { namespace _internal {
   {
     if (m_context)
     {
-      auto context = static_cast<XmlWriterContext*>(m_context);
-      xmlFreeTextWriter(static_cast<xmlTextWriterPtr>(context->writer));
-      xmlBufferFree(static_cast<xmlBufferPtr>(context->buffer));
-      delete context;
+      delete static_cast<XmlWriterContext*>(m_context);
     }
   }
 
-  namespace {
-    inline xmlChar* BadCast(const char* x)
-    {
-      return const_cast<xmlChar*>(reinterpret_cast<const xmlChar*>(x));
-    }
-  } // namespace
-
   void XmlWriter::Write(XmlNode node)
   {
     auto context = static_cast<XmlWriterContext*>(m_context);
-    xmlTextWriterPtr writer = context->writer;
     if (node.Type == XmlNodeType::StartTag)
     {
-      if (node.Value.empty())
-      {
-        xmlTextWriterStartElement(writer, BadCast(node.Name.data()));
-      }
-      else
+      context->StartElement(node.Name);
+      if (!node.Value.empty())
       {
-        xmlTextWriterWriteElement(writer, BadCast(node.Name.data()), BadCast(node.Value.data()));
+        context->CloseStartTag();
+        context->Escape(node.Value, false);
+        context->EndElement();
       }
     }
     else if (node.Type == XmlNodeType::EndTag)
     {
-      xmlTextWriterEndElement(writer);
+      context->EndElement();
     }
     else if (node.Type == XmlNodeType::Text)
     {
-      xmlTextWriterWriteString(writer, BadCast(node.Value.data()));
+      context->CloseStartTag();
+      context->Escape(node.Value, false);
     }
     else if (node.Type == XmlNodeType::Attribute)
     {
-      xmlTextWriterWriteAttribute(writer, BadCast(node.Name.data()), BadCast(node.Value.data()));
+      if (!context->startTagOpen)
+      {
+        throw std::runtime_error("Failed to write xml.");
+      }
+      context->document += ' ';
+      context->document += node.Name;
+      context->document += "=\"";
+      context->Escape(node.Value, true);
+      context->document += '"';
     }
     else if (node.Type == XmlNodeType::End)
     {
-      xmlTextWriterEndDocument(writer);
+      while (!context->openElements.empty())
+      {
+        context->EndElement();
+      }
+      context->document += '\n';
     }
     else
     {
@@ -608,10 +1177,98 @@ namespace Azure { namespace Storage { namespace _internal {
   std::string XmlWriter::GetDocument()
   {
     auto context = static_cast<XmlWriterContext*>(m_context);
-    xmlBufferPtr buffer = context->buffer;
-    return std::string(reinterpret_cast<const char*>(buffer->content), buffer->use);
+    return context->document;
   }
 
-#endif
+  void AppendXmlText(std::string& document, const std::string& text)
+  {
+    EscapeXml(document, text, false);
+  }
+
+  size_t UnescapeXmlTextInPlace(char* text, size_t length)
+  {
+    const char* source = text;
+    const char* const end = text + length;
+    // The text is usually left as it is, Base64 for instance.
+    source = std::find_if(source, end, [](char c) { return c == '&' || c == '\r'; });
+    char* destination = text + (source - text);
+    while (source != end)
+    {
+      if (*source == '\r')
+      {
+        // The line ends are normalized.
+        *destination++ = '\n';
+        source += (source + 1 != end && source[1] == '\n') ? 2 : 1;
+        continue;
+      }
+      if (*source != '&')
+      {
+        *destination++ = *source++;
+        continue;
+      }
+      // The longest reference is &#x10FFFF;.
+      const char* const referenceEnd
+          = std::find(source, source + std::min<ptrdiff_t>(10, end - source), ';');
+      const std::string reference(source + 1, referenceEnd);
+      uint32_t codePoint = 0;
+      if (reference.size() > 1 && reference[0] == '#')
+      {
+        const bool hexadecimal = reference[1] == 'x';
+        codePoint = static_cast<uint32_t>(std::strtoul(
+            reference.c_str() + (hexadecimal ? 2 : 1), nullptr, hexadecimal ? 16 : 10));
+      }
+      else if (reference == "lt")
+      {
+        codePoint = '<';
+      }
+      else if (reference == "gt")
+      {
+        codePoint = '>';
+      }
+      else if (reference == "amp")
+      {
+        codePoint = '&';
+      }
+      else if (reference == "quot")
+      {
+        codePoint = '"';
+      }
+      else if (reference == "apos")
+      {
+        codePoint = '\'';
+      }
+      if (referenceEnd == end || *referenceEnd != ';' || codePoint == 0 || codePoint > 0x10FFFF)
+      {
+        // Not a reference, it's kept as it is.
+        *destination++ = *source++;
+        continue;
+      }
+      // A reference is never shorter than the UTF-8 encoding of its character.
+      if (codePoint < 0x80)
+      {
+        *destination++ = static_cast<char>(codePoint);
+      }
+      else if (codePoint < 0x800)
+      {
+        *destination++ = static_cast<char>(0xC0 | (codePoint >> 6));
+        *destination++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+      else if (codePoint < 0x10000)
+      {
+        *destination++ = static_cast<char>(0xE0 | (codePoint >> 12));
+        *destination++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *destination++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+      else
+      {
+        *destination++ = static_cast<char>(0xF0 | (codePoint >> 18));
+        *destination++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        *destination++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *destination++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+      source = referenceEnd + 1;
+    }
+    return static_cast<size_t>(destination - text);
+  }
 
 }}} // namespace Azure::Storage::_internal
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <azure/storage/common/buffer_pool.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(BufferPoolTest, ReuseBuffers)
+  {
+    auto pool = std::make_shared<BufferPool>(1_MB, 512_KB);
+    EXPECT_EQ(pool->MaxMemory(), static_cast<int64_t>(1_MB));
+    EXPECT_EQ(pool->MaxIdleMemory(), static_cast<int64_t>(512_KB));
+    EXPECT_THROW(BufferPool(0, 0), std::invalid_argument);
+    EXPECT_THROW(BufferPool(1, -1), std::invalid_argument);
+    EXPECT_THROW(BufferPool(1, 2), std::invalid_argument);
+
+    uint8_t* data = nullptr;
+    {
+      _internal::PooledBuffer buffer(pool, static_cast<size_t>(100_KB), Core::Context());
+      EXPECT_EQ(buffer.Size(), static_cast<size_t>(100_KB));
+      EXPECT_EQ(
+          reinterpret_cast<uintptr_t>(buffer.Data()) % _internal::UnbufferedIoAlignment, 0U);
+      data = buffer.Data();
+    }
+    // A buffer of about the same size is reused, a much smaller one isn't.
+    {
+      _internal::PooledBuffer smallBuffer(pool, static_cast<size_t>(10_KB), Core::Context());
+      EXPECT_NE(smallBuffer.Data(), data);
+      _internal::PooledBuffer buffer(pool, static_cast<size_t>(90_KB), Core::Context());
+      EXPECT_EQ(buffer.Data(), data);
+
+      _internal::PooledBuffer movedBuffer(std::move(buffer));
+      EXPECT_EQ(movedBuffer.Data(), data);
+      EXPECT_EQ(buffer.Data(), nullptr);
+      EXPECT_EQ(buffer.Size(), 0U);
+    }
+    {
+      _internal::PooledBuffer buffer(pool, static_cast<size_t>(128_KB), Core::Context());
+      EXPECT_EQ(buffer.Data(), data);
+    }
+
+    // A buffer larger than the pool is allocated when no other buffer is used.
+    {
+      _internal::PooledBuffer buffer(pool, static_cast<size_t>(2_MB), Core::Context());
+      EXPECT_EQ(buffer.Size(), static_cast<size_t>(2_MB));
+    }
+    {
+      _internal::PooledBuffer buffer;
+      EXPECT_EQ(buffer.Data(), nullptr);
+      buffer = _internal::PooledBuffer(nullptr, static_cast<size_t>(1_KB), Core::Context());
+      EXPECT_NE(buffer.Data(), nullptr);
+    }
+  }
+
+  TEST(BufferPoolTest, NumaNodeAndHugePages)
+  {
+    EXPECT_EQ(std::make_shared<BufferPool>(1_MB, 512_KB)->Affinity().NumaNode(), -1);
+    EXPECT_FALSE(std::make_shared<BufferPool>(1_MB, 512_KB)->UsesHugePages());
+
+    TransferAffinity affinity;
+#if defined(__linux__)
+    affinity = TransferAffinity::CreateFromNumaNode(0);
+#endif
+    for (bool useHugePages : {false, true})
+    {
+      auto pool = std::make_shared<BufferPool>(16_MB, 16_MB, affinity, useHugePages);
+      EXPECT_EQ(pool->Affinity().NumaNode(), affinity.NumaNode());
+      EXPECT_EQ(pool->UsesHugePages(), useHugePages);
+
+      uint8_t* data = nullptr;
+      {
+        _internal::PooledBuffer buffer(pool, static_cast<size_t>(3_MB), Core::Context());
+        EXPECT_EQ(
+            reinterpret_cast<uintptr_t>(buffer.Data()) % _internal::UnbufferedIoAlignment, 0U);
+        EXPECT_EQ(buffer.Data()[0], 0);
+        std::memset(buffer.Data(), 'a', buffer.Size());
+        data = buffer.Data();
+      }
+      _internal::PooledBuffer buffer(pool, static_cast<size_t>(3_MB), Core::Context());
+      EXPECT_EQ(buffer.Data(), data);
+      EXPECT_EQ(buffer.Data()[buffer.Size() - 1], 'a');
+    }
+  }
+
+  TEST(BufferPoolTest, WaitWhenFull)
+  {
+    auto pool = std::make_shared<BufferPool>(1_MB, 1_MB);
+    auto buffer = std::make_unique<_internal::PooledBuffer>(
+        pool, static_cast<size_t>(768_KB), Core::Context());
+
+    std::atomic<bool> acquired{false};
+    std::thread waiter([&]() {
+      _internal::PooledBuffer otherBuffer(pool, static_cast<size_t>(512_KB), Core::Context());
+      acquired = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_FALSE(acquired);
+    EXPECT_EQ(
+        _internal::PooledBuffer::TryTake(pool, static_cast<size_t>(512_KB)).Data(), nullptr);
+    EXPECT_NE(
+        _internal::PooledBuffer::TryTake(pool, static_cast<size_t>(128_KB)).Data(), nullptr);
+    buffer.reset();
+    waiter.join();
+    EXPECT_TRUE(acquired);
+
+    // A cancelled context stops the wait.
+    buffer = std::make_unique<_internal::PooledBuffer>(
+        pool, static_cast<size_t>(768_KB), Core::Context());
+    Core::Context context;
+    context.Cancel();
+    EXPECT_THROW(
+        _internal::PooledBuffer(pool, static_cast<size_t>(512_KB), context),
+        Core::OperationCancelledException);
+  }
+
+}}} // namespace Azure::Storage::Test
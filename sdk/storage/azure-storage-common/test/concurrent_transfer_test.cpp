@@ -0,0 +1,354 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/transfer_executor.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(ConcurrentTransferTest, TransferChunks)
+  {
+    auto executor = std::make_shared<TransferExecutor>(4, 16);
+    EXPECT_EQ(executor->ThreadCount(), 4);
+    EXPECT_EQ(executor->MaxInFlightChunks(), 16);
+
+    for (int concurrency : {1, 3, 8})
+    {
+      const int64_t offset = 100;
+      const int64_t length = 1000;
+      const int64_t chunkSize = 64;
+      std::vector<std::atomic<int>> transferred(static_cast<size_t>(length));
+      _internal::ConcurrentTransferOptions options;
+      options.ChunkSize = chunkSize;
+      options.Concurrency = concurrency;
+      const int64_t numChunks = _internal::ConcurrentTransfer(
+          offset,
+          length,
+          options,
+          [&](int64_t chunkOffset, int64_t chunkLength, int64_t chunkId) {
+            EXPECT_EQ(chunkOffset, offset + chunkId * chunkSize);
+            EXPECT_EQ(chunkLength, chunkId == 15 ? length % chunkSize : chunkSize);
+            for (int64_t i = chunkOffset; i < chunkOffset + chunkLength; ++i)
+            {
+              ++transferred[static_cast<size_t>(i - offset)];
+            }
+          },
+          executor);
+      EXPECT_EQ(numChunks, 16);
+      for (const auto& count : transferred)
+      {
+        EXPECT_EQ(count.load(), 1);
+      }
+    }
+
+    bool called = false;
+    _internal::ConcurrentTransferOptions options;
+    options.ChunkSize = 64;
+    options.Concurrency = 4;
+    EXPECT_EQ(
+        _internal::ConcurrentTransfer(
+            0, 0, options, [&](int64_t, int64_t, int64_t) { called = true; }, nullptr),
+        0);
+    EXPECT_FALSE(called);
+
+    EXPECT_THROW(TransferExecutor(0, 1), std::invalid_argument);
+    EXPECT_THROW(TransferExecutor(1, 0), std::invalid_argument);
+    EXPECT_TRUE(TransferExecutor::GetDefault());
+    EXPECT_EQ(TransferExecutor::GetDefault(), TransferExecutor::GetDefault());
+  }
+
+  TEST(ConcurrentTransferTest, Affinity)
+  {
+    EXPECT_TRUE(TransferAffinity().Cpus().empty());
+    EXPECT_EQ(TransferAffinity().NumaNode(), -1);
+    EXPECT_THROW(TransferAffinity(std::vector<int>{0, -1}), std::invalid_argument);
+    EXPECT_THROW(TransferAffinity::CreateFromNumaNode(-1), std::invalid_argument);
+    EXPECT_THROW(TransferAffinity::CreateFromNumaNode(100000), std::runtime_error);
+
+    auto executor = std::make_shared<TransferExecutor>(2, 4, TransferAffinity({0}));
+    EXPECT_EQ(executor->Affinity().Cpus(), std::vector<int>{0});
+    EXPECT_TRUE(std::make_shared<TransferExecutor>(2, 4)->Affinity().Cpus().empty());
+
+    std::atomic<int> pinnedChunks{0};
+    _internal::ConcurrentTransferOptions options;
+    options.ChunkSize = 1;
+    options.Concurrency = 4;
+    _internal::ConcurrentTransfer(
+        0,
+        16,
+        options,
+        [&](int64_t, int64_t, int64_t) {
+#if defined(__linux__)
+          cpu_set_t cpuSet;
+          CPU_ZERO(&cpuSet);
+          pthread_getaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+          if (CPU_COUNT(&cpuSet) == 1 && CPU_ISSET(0, &cpuSet))
+          {
+            ++pinnedChunks;
+          }
+#endif
+        },
+        executor);
+#if defined(__linux__)
+    // The chunks are transferred by the threads of the executor and by the calling thread.
+    EXPECT_GT(pinnedChunks.load(), 0);
+
+    const auto nodeAffinity = TransferAffinity::CreateFromNumaNode(0);
+    EXPECT_EQ(nodeAffinity.NumaNode(), 0);
+    EXPECT_FALSE(nodeAffinity.Cpus().empty());
+    // The loopback interface isn't attached to a NUMA node.
+    EXPECT_EQ(TransferAffinity::CreateFromNetworkInterface("lo").NumaNode(), -1);
+    EXPECT_THROW(
+        TransferAffinity::CreateFromNetworkInterface("doesnotexist0"), std::runtime_error);
+#endif
+  }
+
+  TEST(ConcurrentTransferTest, MaxInFlightChunks)
+  {
+    auto executor = std::make_shared<TransferExecutor>(8, 3);
+    std::atomic<int> inFlightChunks{0};
+    std::atomic<int> maxInFlightChunks{0};
+    auto transferFunc = [&](int64_t, int64_t, int64_t) {
+      int current = ++inFlightChunks;
+      int previous = maxInFlightChunks;
+      while (previous < current && !maxInFlightChunks.compare_exchange_weak(previous, current))
+      {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      --inFlightChunks;
+    };
+
+    _internal::ConcurrentTransferOptions options;
+    options.ChunkSize = 1;
+    options.Concurrency = 4;
+    std::vector<std::thread> transfers;
+    for (int i = 0; i < 4; ++i)
+    {
+      transfers.emplace_back(
+          [&]() { _internal::ConcurrentTransfer(0, 32, options, transferFunc, executor); });
+    }
+    for (auto& transfer : transfers)
+    {
+      transfer.join();
+    }
+    EXPECT_GT(maxInFlightChunks.load(), 0);
+    EXPECT_LE(maxInFlightChunks.load(), 3);
+  }
+
+  TEST(ConcurrentTransferTest, Exception)
+  {
+    auto executor = std::make_shared<TransferExecutor>(2, 8);
+    std::atomic<int> numCalls{0};
+    _internal::ConcurrentTransferOptions options;
+    options.ChunkSize = 1;
+    options.Concurrency = 4;
+    try
+    {
+      _internal::ConcurrentTransfer(
+          0,
+          100,
+          options,
+          [&](int64_t, int64_t, int64_t chunkId) {
+            ++numCalls;
+            if (chunkId == 5)
+            {
+              throw std::runtime_error("Chunk failed.");
+            }
+          },
+          executor);
+      FAIL();
+    }
+    catch (std::runtime_error& e)
+    {
+      EXPECT_STREQ(e.what(), "Chunk failed.");
+    }
+
+    // The executor is still usable after a failed transfer.
+    numCalls = 0;
+    _internal::ConcurrentTransfer(
+        0, 10, options, [&](int64_t, int64_t, int64_t) { ++numCalls; }, executor);
+    EXPECT_EQ(numCalls.load(), 10);
+  }
+
+  TEST(ConcurrentTransferTest, TransferTuner)
+  {
+    const int64_t minChunkSize = 1024;
+    const int64_t maxChunkSize = 8 * 1024;
+    auto now = std::chrono::steady_clock::now();
+    _internal::TransferTuner tuner(minChunkSize, maxChunkSize, 4, now);
+    EXPECT_EQ(tuner.ChunkSize(), minChunkSize);
+    EXPECT_EQ(tuner.Concurrency(), 2);
+
+    // Transfers a round of chunks at the given number of bytes per millisecond.
+    auto transferRound = [&](int64_t bytesPerMillisecond) {
+      const int numChunks = tuner.Concurrency();
+      const int64_t chunkSize = tuner.ChunkSize();
+      for (int i = 0; i < numChunks; ++i)
+      {
+        now += std::chrono::milliseconds(chunkSize / bytesPerMillisecond);
+        tuner.OnChunkTransferred(chunkSize, now);
+      }
+    };
+
+    // Grows while the throughput improves, up to the maximums.
+    transferRound(1);
+    EXPECT_EQ(tuner.ChunkSize(), 2 * minChunkSize);
+    EXPECT_EQ(tuner.Concurrency(), 3);
+    transferRound(2);
+    EXPECT_EQ(tuner.ChunkSize(), 4 * minChunkSize);
+    EXPECT_EQ(tuner.Concurrency(), 4);
+    transferRound(4);
+    EXPECT_EQ(tuner.ChunkSize(), maxChunkSize);
+    EXPECT_EQ(tuner.Concurrency(), 4);
+
+    // Stays put while the throughput is stable.
+    transferRound(4);
+    EXPECT_EQ(tuner.ChunkSize(), maxChunkSize);
+    EXPECT_EQ(tuner.Concurrency(), 4);
+    transferRound(8);
+    EXPECT_EQ(tuner.ChunkSize(), maxChunkSize);
+    EXPECT_EQ(tuner.Concurrency(), 4);
+
+    // Shrinks when the throughput drops.
+    transferRound(2);
+    EXPECT_EQ(tuner.ChunkSize(), maxChunkSize / 2);
+    EXPECT_EQ(tuner.Concurrency(), 2);
+    transferRound(1);
+    EXPECT_EQ(tuner.ChunkSize(), maxChunkSize / 4);
+    EXPECT_EQ(tuner.Concurrency(), 1);
+    transferRound(1);
+    EXPECT_EQ(tuner.ChunkSize(), maxChunkSize / 4);
+    EXPECT_EQ(tuner.Concurrency(), 1);
+  }
+
+  TEST(ConcurrentTransferTest, AutoTune)
+  {
+    auto executor = std::make_shared<TransferExecutor>(4, 16);
+    const int64_t length = 100000;
+    _internal::ConcurrentTransferOptions options;
+    options.ChunkSize = 1000;
+    options.Concurrency = 4;
+    options.AutoTune = true;
+    options.MinChunkSize = 10;
+
+    std::vector<std::atomic<int>> transferred(static_cast<size_t>(length));
+    std::atomic<int64_t> nextOffset{0};
+    std::atomic<int64_t> numCalls{0};
+    std::atomic<int> inFlightChunks{0};
+    std::atomic<int> maxInFlightChunks{0};
+    const int64_t numChunks = _internal::ConcurrentTransfer(
+        0,
+        length,
+        options,
+        [&](int64_t chunkOffset, int64_t chunkLength, int64_t) {
+          ++numCalls;
+          int current = ++inFlightChunks;
+          int previous = maxInFlightChunks;
+          while (previous < current && !maxInFlightChunks.compare_exchange_weak(previous, current))
+          {
+          }
+          EXPECT_GT(chunkLength, 0);
+          EXPECT_LE(chunkLength, options.ChunkSize);
+          EXPECT_TRUE(
+              chunkLength >= options.MinChunkSize || chunkOffset + chunkLength == length);
+          for (int64_t i = chunkOffset; i < chunkOffset + chunkLength; ++i)
+          {
+            ++transferred[static_cast<size_t>(i)];
+          }
+          nextOffset += chunkLength;
+          --inFlightChunks;
+        },
+        executor);
+    EXPECT_EQ(numChunks, numCalls.load());
+    EXPECT_EQ(nextOffset.load(), length);
+    EXPECT_LE(maxInFlightChunks.load(), options.Concurrency);
+    for (const auto& count : transferred)
+    {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+
+  TEST(ConcurrentTransferTest, StreamTransfer)
+  {
+    auto executor = std::make_shared<TransferExecutor>(4, 16);
+    const int concurrency = 3;
+    const int64_t numChunks = 50;
+
+    std::vector<std::atomic<int>> transferred(static_cast<size_t>(numChunks));
+    std::atomic<int> inFlightChunks{0};
+    std::atomic<int> maxInFlightChunks{0};
+    int64_t nextChunkId = 0;
+    const int64_t numTransferred = _internal::ConcurrentStreamTransfer(
+        concurrency,
+        [&](int64_t chunkId) -> std::function<void()> {
+          // Called in order, by one thread at a time.
+          EXPECT_EQ(chunkId, nextChunkId++);
+          if (chunkId == numChunks)
+          {
+            return nullptr;
+          }
+          int current = ++inFlightChunks;
+          int previous = maxInFlightChunks;
+          while (previous < current && !maxInFlightChunks.compare_exchange_weak(previous, current))
+          {
+          }
+          auto holder = std::shared_ptr<int>(nullptr, [&](int*) { --inFlightChunks; });
+          return [&, chunkId, holder]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++transferred[static_cast<size_t>(chunkId)];
+          };
+        },
+        executor);
+    EXPECT_EQ(numTransferred, numChunks);
+    EXPECT_EQ(nextChunkId, numChunks + 1);
+    EXPECT_LE(maxInFlightChunks.load(), concurrency);
+    for (const auto& count : transferred)
+    {
+      EXPECT_EQ(count.load(), 1);
+    }
+
+    // The first exception stops the transfer.
+    std::atomic<int64_t> numCalls{0};
+    EXPECT_THROW(
+        _internal::ConcurrentStreamTransfer(
+            concurrency,
+            [&](int64_t chunkId) -> std::function<void()> {
+              ++numCalls;
+              if (chunkId == 5)
+              {
+                throw std::runtime_error("Failed to read chunk.");
+              }
+              return []() {};
+            },
+            executor),
+        std::runtime_error);
+    EXPECT_EQ(numCalls.load(), 6);
+    EXPECT_THROW(
+        _internal::ConcurrentStreamTransfer(
+            concurrency,
+            [&](int64_t chunkId) -> std::function<void()> {
+              return [chunkId]() {
+                if (chunkId == 2)
+                {
+                  throw std::runtime_error("Failed to transfer chunk.");
+                }
+              };
+            },
+            executor),
+        std::runtime_error);
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,204 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <azure/core/http/raw_response.hpp>
+#include <azure/core/http/traffic_class.hpp>
+#include <azure/core/internal/http/pipeline.hpp>
+#include <azure/storage/common/congestion_controller.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    // Throttles the requests beyond the number the account sustains at the same time.
+    class BusyAccountTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct State
+      {
+        int SustainedConcurrency = 0;
+        std::atomic<int> InFlight{0};
+        std::atomic<int> MaxInFlight{0};
+        std::atomic<int> Throttled{0};
+      };
+
+      explicit BusyAccountTransportPolicy(std::shared_ptr<State> state)
+          : m_state(std::move(state))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<BusyAccountTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request&,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        const int inFlight = ++m_state->InFlight;
+        int maxInFlight = m_state->MaxInFlight;
+        while (inFlight > maxInFlight
+               && !m_state->MaxInFlight.compare_exchange_weak(maxInFlight, inFlight))
+        {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (inFlight > m_state->SustainedConcurrency)
+        {
+          ++m_state->Throttled;
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::ServiceUnavailable, "Server Busy");
+          response->SetHeader("x-ms-error-code", "ServerBusy");
+        }
+        else
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        }
+        --m_state->InFlight;
+        return response;
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+  } // namespace
+
+  TEST(CongestionControlPolicyTest, CongestionWindow)
+  {
+    _internal::CongestionWindow window(1, 8);
+    EXPECT_EQ(window.Limit(), 8);
+
+    std::vector<std::chrono::steady_clock::time_point> sendTimes;
+    for (int i = 0; i < 8; ++i)
+    {
+      sendTimes.push_back(window.Acquire(Core::Context()));
+    }
+    EXPECT_EQ(window.InFlight(), 8);
+
+    // Waits for a request to be released once the limit is reached.
+    auto context = Core::Context::ApplicationContext.WithDeadline(
+        std::chrono::system_clock::now() + std::chrono::milliseconds(50));
+    EXPECT_THROW(window.Acquire(context), Core::OperationCancelledException);
+    EXPECT_EQ(window.InFlight(), 8);
+
+    // The requests of the same round are throttled for the same reason, the limit is halved once.
+    window.Release(_internal::CongestionWindow::Outcome::Throttled, sendTimes[0]);
+    EXPECT_EQ(window.Limit(), 4);
+    window.Release(_internal::CongestionWindow::Outcome::Throttled, sendTimes[1]);
+    EXPECT_EQ(window.Limit(), 4);
+    window.Release(_internal::CongestionWindow::Outcome::Failed, sendTimes[2]);
+    EXPECT_EQ(window.Limit(), 4);
+    for (size_t i = 3; i < sendTimes.size(); ++i)
+    {
+      window.Release(_internal::CongestionWindow::Outcome::Succeeded, sendTimes[i]);
+    }
+    EXPECT_EQ(window.InFlight(), 0);
+    EXPECT_EQ(window.Limit(), 5);
+
+    // A request sent after the decrease halves the requests in flight.
+    sendTimes.clear();
+    for (int i = 0; i < 3; ++i)
+    {
+      sendTimes.push_back(window.Acquire(Core::Context()));
+    }
+    window.Release(_internal::CongestionWindow::Outcome::Throttled, sendTimes[0]);
+    EXPECT_EQ(window.Limit(), 1);
+    window.Release(_internal::CongestionWindow::Outcome::Succeeded, sendTimes[1]);
+    window.Release(_internal::CongestionWindow::Outcome::Succeeded, sendTimes[2]);
+    EXPECT_EQ(window.Limit(), 2);
+
+    // The limit grows by one for each limit worth of requests, up to the largest limit.
+    for (int i = 0; i < 1000; ++i)
+    {
+      window.Release(
+          _internal::CongestionWindow::Outcome::Succeeded, window.Acquire(Core::Context()));
+    }
+    EXPECT_EQ(window.Limit(), 8);
+
+    EXPECT_THROW(CongestionController(4, 0), std::invalid_argument);
+    EXPECT_THROW(CongestionController(4, 5), std::invalid_argument);
+  }
+
+  TEST(CongestionControlPolicyTest, InteractiveBeforeBulk)
+  {
+    _internal::CongestionWindow window(1, 1);
+    const auto sendTime = window.Acquire(Core::Context());
+
+    // The bulk request waits first, the interactive request sent meanwhile goes before it.
+    std::atomic<int> order{0};
+    std::atomic<int> bulkOrder{0};
+    std::atomic<int> interactiveOrder{0};
+    std::thread bulk([&]() {
+      const auto bulkSendTime = window.Acquire(
+          Core::Http::WithTrafficClass(Core::Context(), Core::Http::TrafficClass::Bulk));
+      bulkOrder = ++order;
+      window.Release(_internal::CongestionWindow::Outcome::Succeeded, bulkSendTime);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::thread interactive([&]() {
+      const auto interactiveSendTime = window.Acquire(Core::Context());
+      interactiveOrder = ++order;
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      window.Release(_internal::CongestionWindow::Outcome::Succeeded, interactiveSendTime);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(order, 0);
+
+    window.Release(_internal::CongestionWindow::Outcome::Succeeded, sendTime);
+    interactive.join();
+    bulk.join();
+    EXPECT_EQ(interactiveOrder, 1);
+    EXPECT_EQ(bulkOrder, 2);
+    EXPECT_EQ(window.InFlight(), 0);
+  }
+
+  TEST(CongestionControlPolicyTest, SettlesAtSustainedConcurrency)
+  {
+    auto state = std::make_shared<BusyAccountTransportPolicy::State>();
+    state->SustainedConcurrency = 4;
+    auto congestionController = std::make_shared<CongestionController>(32);
+    std::vector<std::unique_ptr<Core::Http::Policies::HttpPolicy>> policies;
+    policies.emplace_back(
+        std::make_unique<_internal::CongestionControlPolicy>(congestionController));
+    policies.emplace_back(std::make_unique<BusyAccountTransportPolicy>(state));
+    Core::Http::_internal::HttpPipeline pipeline(std::move(policies));
+
+    const std::string host = "account.blob.core.windows.net";
+    EXPECT_EQ(congestionController->GetConcurrencyLimit(host), 32);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 16; ++i)
+    {
+      threads.emplace_back([&pipeline, &host]() {
+        for (int j = 0; j < 50; ++j)
+        {
+          Core::Http::Request request(
+              Core::Http::HttpMethod::Get, Core::Url("https://" + host + "/container/blob"));
+          pipeline.Send(request, Core::Context());
+        }
+      });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    EXPECT_LE(state->MaxInFlight, 16);
+    EXPECT_LE(congestionController->GetConcurrencyLimit(host), 8);
+    // Most of the requests are sent once the limit settled.
+    EXPECT_LT(state->Throttled, 16 * 50 / 4);
+    // Every account has a limit of its own.
+    EXPECT_EQ(congestionController->GetConcurrencyLimit("other.blob.core.windows.net"), 32);
+  }
+
+}}} // namespace Azure::Storage::Test
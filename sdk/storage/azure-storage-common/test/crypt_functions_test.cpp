@@ -28,6 +28,74 @@ namespace Azure { namespace Storage { namespace Test {
         "+SBESxQVhI53mSEdZJcCBpdBkaqwzfPaVYZMAf5LP3c=");
   }
 
+  TEST(CryptFunctionsTest, HmacSha256Key)
+  {
+    std::string key = "8CwtGFF1mGR4bPEP9eZ0x1fxKiQ3Ca5N";
+    const _internal::HmacSha256Key hmacKey(std::vector<uint8_t>(key.begin(), key.end()));
+    const std::string data = "Hello Azure!";
+    EXPECT_EQ(
+        Azure::Core::Convert::Base64Encode(hmacKey.Sign(nullptr, 0)),
+        "fFy2T+EuCvAgouw/vB/RAJ75z7jwTj+uiURebkFKF5M=");
+    for (int i = 0; i < 2; ++i)
+    {
+      EXPECT_EQ(
+          Azure::Core::Convert::Base64Encode(
+              hmacKey.Sign(reinterpret_cast<const uint8_t*>(data.data()), data.size())),
+          "+SBESxQVhI53mSEdZJcCBpdBkaqwzfPaVYZMAf5LP3c=");
+    }
+
+    auto randomData = RandomBuffer(1024);
+    const std::vector<uint8_t> emptyKey;
+    const std::vector<uint8_t> longKey = RandomBuffer(100);
+    for (const auto& k : {emptyKey, longKey})
+    {
+      EXPECT_EQ(
+          _internal::HmacSha256Key(k).Sign(randomData.data(), randomData.size()),
+          _internal::HmacSha256(randomData, k));
+    }
+
+    // The keyed HMAC signs data appended in parts like Sign does in one call.
+    auto hmac = hmacKey.GetKeyedHmac();
+    hmac.Append(reinterpret_cast<const uint8_t*>(data.data()), 6);
+    EXPECT_EQ(
+        Azure::Core::Convert::Base64Encode(hmac.Final(
+            reinterpret_cast<const uint8_t*>(data.data()) + 6, data.size() - 6)),
+        "+SBESxQVhI53mSEdZJcCBpdBkaqwzfPaVYZMAf5LP3c=");
+  }
+
+  TEST(CryptFunctionsTest, AesGcmKey)
+  {
+    // Test case 15 of the GCM specification.
+    const auto key = Azure::Core::Convert::Base64Decode(
+        "/v/pkoZlcxxtao+UZzCDCP7/6ZKGZXMcbWqPlGcwgwg=");
+    const auto nonce = Azure::Core::Convert::Base64Decode("yv66vvrO263eyviI");
+    const auto data = Azure::Core::Convert::Base64Decode(
+        "2TEyJfiEBuWlWQnFr/UmmoanqVMVNPfaLkwwPYoxinIcPAyVlWgJUy/PDiRJprUlsWrt9aoN5le6Y3s5Gq/SVQ==");
+    const _internal::AesGcmKey aesGcmKey(key);
+    std::vector<uint8_t> ciphertext(data.size());
+    std::vector<uint8_t> tag(_internal::AesGcmKey::TagSize);
+    aesGcmKey.Encrypt(nonce.data(), data.data(), data.size(), ciphertext.data(), tag.data());
+    EXPECT_EQ(
+        Azure::Core::Convert::Base64Encode(ciphertext),
+        "Ui3B8JlWfQf0fzejKoRCfWQ6jNy/5cDJdZiivSVV0aqMsI5IWQ27PaewixBWgog4xfYeY5O6egq8yfZiiYAVrQ==");
+    EXPECT_EQ(Azure::Core::Convert::Base64Encode(tag), "sJTaxdk0cb3sGlAicOPMbA==");
+
+    std::vector<uint8_t> decrypted(data.size());
+    EXPECT_TRUE(aesGcmKey.Decrypt(
+        nonce.data(), ciphertext.data(), ciphertext.size(), tag.data(), decrypted.data()));
+    EXPECT_EQ(decrypted, data);
+    ciphertext[10] ^= 1;
+    EXPECT_FALSE(aesGcmKey.Decrypt(
+        nonce.data(), ciphertext.data(), ciphertext.size(), tag.data(), decrypted.data()));
+    EXPECT_THROW(_internal::AesGcmKey(std::vector<uint8_t>(16)), std::invalid_argument);
+
+    std::vector<uint8_t> random1(32);
+    std::vector<uint8_t> random2(32);
+    _internal::FillSecureRandomBytes(random1.data(), random1.size());
+    _internal::FillSecureRandomBytes(random2.data(), random2.size());
+    EXPECT_NE(random1, random2);
+  }
+
   static std::vector<uint8_t> ComputeHash(const std::string& data)
   {
     const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data.data());
@@ -111,6 +179,42 @@ namespace Azure { namespace Storage { namespace Test {
         crc64Single.Final(reinterpret_cast<const uint8_t*>(allData.data()), allData.size()));
   }
 
+  TEST(CryptFunctionsTest, Crc64Hash_Bitwise)
+  {
+    // The hash of every length and alignment is compared against a bitwise implementation, which
+    // covers the remainders of the block-wise implementations.
+    auto crc64Bitwise = [](const uint8_t* data, size_t length) {
+      uint64_t crc = ~0ULL;
+      for (size_t i = 0; i < length; ++i)
+      {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+          crc = (crc >> 1) ^ (0x9A6C9329AC4BC9B5ULL * (crc & 1));
+        }
+      }
+      crc ^= ~0ULL;
+      std::vector<uint8_t> binary;
+      for (size_t i = 0; i < sizeof(crc); ++i)
+      {
+        binary.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+      }
+      return binary;
+    };
+
+    auto data = RandomBuffer(1024);
+    for (size_t offset = 0; offset < 8; ++offset)
+    {
+      for (size_t length = 0; length + offset <= data.size(); ++length)
+      {
+        Crc64Hash instance;
+        ASSERT_EQ(
+            instance.Final(data.data() + offset, length),
+            crc64Bitwise(data.data() + offset, length));
+      }
+    }
+  }
+
   TEST(CryptFunctionsTest, Crc64Hash_ExpectThrow)
   {
     std::string data = "";
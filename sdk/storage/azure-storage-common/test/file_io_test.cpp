@@ -0,0 +1,224 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <azure/storage/common/internal/file_io.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(FileIoTest, MemoryMapped)
+  {
+    const auto content = RandomBuffer(static_cast<size_t>(1_MB + 123));
+    const std::string filename = RandomString();
+
+    {
+      _internal::FileWriter fileWriter(filename, _internal::FileIoMode::MemoryMapped);
+      uint8_t* mappedData = fileWriter.Map(static_cast<int64_t>(content.size()));
+      ASSERT_NE(mappedData, nullptr);
+      EXPECT_EQ(fileWriter.Map(static_cast<int64_t>(content.size())), nullptr);
+      std::memcpy(mappedData, content.data(), content.size());
+    }
+    EXPECT_EQ(ReadFile(filename), content);
+
+    {
+      _internal::FileReader fileReader(filename, _internal::FileIoMode::MemoryMapped);
+      EXPECT_EQ(fileReader.GetFileSize(), static_cast<int64_t>(content.size()));
+      ASSERT_NE(fileReader.GetMappedData(), nullptr);
+      EXPECT_EQ(
+          std::vector<uint8_t>(
+              fileReader.GetMappedData(), fileReader.GetMappedData() + content.size()),
+          content);
+    }
+    {
+      _internal::FileReader fileReader(filename);
+      EXPECT_EQ(fileReader.GetMappedData(), nullptr);
+    }
+
+    // Files which aren't opened for mapping, or empty files, aren't mapped.
+    {
+      _internal::FileWriter fileWriter(filename);
+      EXPECT_EQ(fileWriter.Map(static_cast<int64_t>(content.size())), nullptr);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+    EXPECT_EQ(ReadFile(filename), content);
+    {
+      _internal::FileWriter fileWriter(filename, _internal::FileIoMode::MemoryMapped);
+      EXPECT_EQ(fileWriter.Map(0), nullptr);
+    }
+    {
+      _internal::FileReader fileReader(filename, _internal::FileIoMode::MemoryMapped);
+      EXPECT_EQ(fileReader.GetFileSize(), 0);
+      EXPECT_EQ(fileReader.GetMappedData(), nullptr);
+    }
+    DeleteFile(filename);
+  }
+
+  TEST(FileIoTest, Unbuffered)
+  {
+    const size_t alignment = _internal::UnbufferedIoAlignment;
+    const auto content = RandomBuffer(alignment * 8 + 123);
+    const std::string filename = RandomString();
+
+    // The file system may not support unbuffered I/O, the data is written and read through the
+    // page cache then.
+    {
+      _internal::FileWriter fileWriter(filename, _internal::FileIoMode::Unbuffered);
+      // Unaligned, then from an aligned buffer at the alignment of the offset, then the rest.
+      fileWriter.Write(content.data(), alignment + 7, 0);
+      _internal::AlignedBuffer buffer(alignment * 4);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.Data()) % alignment, 0U);
+      EXPECT_EQ(buffer.Size(), alignment * 4);
+      std::memcpy(buffer.Data() + 7, content.data() + alignment + 7, alignment * 2);
+      fileWriter.Write(buffer.Data() + 7, alignment * 2, alignment + 7);
+      fileWriter.Write(
+          content.data() + alignment * 3 + 7,
+          content.size() - alignment * 3 - 7,
+          static_cast<int64_t>(alignment * 3 + 7));
+    }
+    EXPECT_EQ(ReadFile(filename), content);
+
+    {
+      _internal::FileReader fileReader(filename, _internal::FileIoMode::Unbuffered);
+      EXPECT_EQ(fileReader.GetFileSize(), static_cast<int64_t>(content.size()));
+      if (fileReader.IsUnbuffered())
+      {
+        _internal::AlignedBuffer buffer(alignment * 16);
+        EXPECT_EQ(fileReader.ReadUnbuffered(buffer.Data(), alignment, 0), alignment);
+        EXPECT_EQ(
+            fileReader.ReadUnbuffered(buffer.Data(), buffer.Size(), 0), content.size());
+        EXPECT_EQ(std::vector<uint8_t>(buffer.Data(), buffer.Data() + content.size()), content);
+
+        for (const auto& range : std::vector<std::pair<size_t, size_t>>{
+                 {0, content.size()}, {5, alignment * 2}, {alignment * 7 + 1, 200}, {100, 0}})
+        {
+          _internal::UnbufferedFileBodyStream stream(
+              fileReader, static_cast<int64_t>(range.first), static_cast<int64_t>(range.second));
+          EXPECT_EQ(stream.Length(), static_cast<int64_t>(range.second));
+          const std::vector<uint8_t> expected(
+              content.begin() + range.first, content.begin() + range.first + range.second);
+          EXPECT_EQ(stream.ReadToEnd(), expected);
+          stream.Rewind();
+          EXPECT_EQ(stream.ReadToEnd(), expected);
+        }
+        // Reading past the end of the file fails.
+        _internal::UnbufferedFileBodyStream stream(
+            fileReader, static_cast<int64_t>(content.size()), 10);
+        EXPECT_THROW(stream.ReadToEnd(), std::runtime_error);
+      }
+    }
+    DeleteFile(filename);
+  }
+
+  TEST(FileIoTest, IoRing)
+  {
+    _internal::IoRing* ring = _internal::IoRing::GetThreadRing();
+    if (ring == nullptr)
+    {
+      GTEST_SKIP();
+    }
+    EXPECT_EQ(_internal::IoRing::GetThreadRing(), ring);
+
+    const size_t alignment = _internal::UnbufferedIoAlignment;
+    const size_t chunkSize = alignment * 4 + 5;
+    const auto content = RandomBuffer(chunkSize * 20);
+
+    for (auto mode : {_internal::FileIoMode::Buffered, _internal::FileIoMode::Unbuffered})
+    {
+      const std::string filename = RandomString();
+      {
+        // More writes than the ring holds, some of them split for unbuffered I/O.
+        _internal::FileWriter fileWriter(filename, mode);
+        std::vector<_internal::AlignedBuffer> buffers;
+        std::vector<uint64_t> ids;
+        for (size_t offset = 0; offset < content.size(); offset += chunkSize)
+        {
+          buffers.emplace_back(chunkSize);
+          std::memcpy(buffers.back().Data(), content.data() + offset, chunkSize);
+          ids.push_back(fileWriter.QueueWrite(
+              *ring, buffers.back().Data(), chunkSize, static_cast<int64_t>(offset)));
+          EXPECT_NE(ids.back(), 0U);
+        }
+        EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+        EXPECT_EQ(fileWriter.QueueWrite(*ring, buffers.back().Data(), 0, 0), 0U);
+        ring->Wait(ids.front());
+        ring->Wait();
+      }
+      EXPECT_EQ(ReadFile(filename), content);
+      DeleteFile(filename);
+    }
+
+    // A failed write is thrown by the wait for it, here to a file opened for reading.
+    const std::string filename = RandomString();
+    {
+      _internal::FileWriter fileWriter(filename);
+    }
+    {
+      _internal::FileReader fileReader(filename);
+      ring->QueueWrite(fileReader.GetHandle(), content.data(), content.size(), 0);
+      EXPECT_THROW(ring->Wait(), std::runtime_error);
+      ring->Wait();
+    }
+    DeleteFile(filename);
+  }
+
+  TEST(FileIoTest, Sparse)
+  {
+    auto content = RandomBuffer(static_cast<size_t>(1_MB));
+    const std::string filename = RandomString();
+
+    {
+      _internal::FileWriter fileWriter(filename);
+      fileWriter.ResizeSparse(2_MB);
+      fileWriter.Write(content.data(), content.size(), 0);
+    }
+    auto expected = content;
+    expected.resize(static_cast<size_t>(2_MB), 0);
+    EXPECT_EQ(ReadFile(filename), expected);
+
+    // The file isn't emptied, the zeroed range is kept in it.
+    {
+      _internal::FileWriter fileWriter(filename, _internal::FileIoMode::Buffered, false);
+      fileWriter.ZeroRange(4_KB, 64_KB + 123);
+      fileWriter.ResizeSparse(512_KB);
+    }
+    std::fill(content.begin() + 4_KB, content.begin() + 68_KB + 123, uint8_t(0));
+    content.resize(static_cast<size_t>(512_KB));
+    EXPECT_EQ(ReadFile(filename), content);
+    DeleteFile(filename);
+  }
+
+  TEST(FileIoTest, Directories)
+  {
+    const std::string directory = RandomString();
+    _internal::CreateDirectories(directory + "/a/b");
+    _internal::CreateDirectories(directory + "/a/b");
+    _internal::CreateDirectories(directory + "/c");
+    const std::vector<std::string> filenames = {"1", "a/2", "a/b/3", "a/b/4"};
+    for (const auto& filename : filenames)
+    {
+      _internal::FileWriter fileWriter(directory + "/" + filename);
+    }
+
+    auto files = _internal::ListFilesRecursively(directory);
+    std::sort(files.begin(), files.end());
+    EXPECT_EQ(files, filenames);
+    EXPECT_THROW(_internal::ListFilesRecursively(directory + "/d"), std::runtime_error);
+    EXPECT_THROW(_internal::CreateDirectories(directory + "/1"), std::runtime_error);
+    for (const auto& filename : filenames)
+    {
+      DeleteFile(directory + "/" + filename);
+    }
+    for (const auto& subdirectory : {"/a/b", "/a", "/c", ""})
+    {
+      DeleteFile(directory + subdirectory);
+    }
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/io/body_stream.hpp>
+#include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/hashing_stream.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    std::vector<uint8_t> ReadAll(
+        Azure::Core::IO::BodyStream& stream,
+        std::vector<uint8_t>& buffer,
+        size_t chunkSize)
+    {
+      std::vector<uint8_t> data;
+      while (true)
+      {
+        size_t readBytes = stream.Read(buffer.data(), chunkSize);
+        if (readBytes == 0)
+        {
+          break;
+        }
+        data.insert(data.end(), buffer.begin(), buffer.begin() + readBytes);
+      }
+      return data;
+    }
+  } // namespace
+
+  TEST(HashingStreamTest, Read)
+  {
+    auto data = RandomBuffer(static_cast<size_t>(3_MB + 123));
+    Crc64Hash expected;
+    auto const expectedHash = expected.Final(data.data(), data.size());
+
+    for (size_t chunkSize : {size_t(1000), static_cast<size_t>(256_KB)})
+    {
+      Azure::Core::IO::MemoryBodyStream inner(data);
+      Crc64Hash hash;
+      std::vector<uint8_t> buffer(chunkSize);
+      _internal::HashingStream stream(inner, hash);
+      EXPECT_EQ(stream.Length(), static_cast<int64_t>(data.size()));
+      EXPECT_EQ(ReadAll(stream, buffer, chunkSize), data);
+      EXPECT_EQ(hash.Final(), expectedHash);
+    }
+  }
+
+  TEST(HashingStreamTest, Rewind)
+  {
+    auto data = RandomBuffer(static_cast<size_t>(1_MB));
+    Crc64Hash expected;
+    auto const expectedHash = expected.Final(data.data(), data.size());
+
+    Azure::Core::IO::MemoryBodyStream inner(data);
+    Crc64Hash hash;
+    std::vector<uint8_t> buffer(static_cast<size_t>(128_KB));
+    _internal::HashingStream stream(inner, hash);
+
+    // The data read again after rewinding is only hashed once.
+    EXPECT_EQ(stream.Read(buffer.data(), buffer.size()), buffer.size());
+    EXPECT_EQ(stream.Read(buffer.data(), 1000), size_t(1000));
+    stream.Rewind();
+    EXPECT_EQ(stream.Read(buffer.data(), 500), size_t(500));
+    stream.Rewind();
+    EXPECT_EQ(ReadAll(stream, buffer, buffer.size()), data);
+    EXPECT_EQ(hash.Final(), expectedHash);
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the CRC64 hash performance.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/storage/common/crypt.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  /**
+   * @brief Measure hashing a buffer with CRC64, as the chunks of a transfer are.
+   *
+   * @remark With several chunks, each chunk is hashed on its own and the hashes are concatenated,
+   * as the hash of a blob is built from the hashes of its chunks transferred concurrently.
+   */
+  class Crc64Test : public Azure::Perf::PerfTest {
+  private:
+    std::vector<uint8_t> m_data;
+    size_t m_chunkSize = 0;
+
+  public:
+    /**
+     * @brief Construct a new CRC64 test.
+     *
+     * @param options The test options.
+     */
+    Crc64Test(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Fill the buffer with the size from the options.
+     *
+     */
+    void Setup() override
+    {
+      m_data.resize(m_options.GetOptionOrDefault<size_t>("Size", 4 * 1024 * 1024));
+      m_chunkSize = m_options.GetOptionOrDefault<size_t>("ChunkSize", m_data.size());
+      for (size_t i = 0; i < m_data.size(); i++)
+      {
+        m_data[i] = static_cast<uint8_t>(i * 31);
+      }
+    }
+
+    /**
+     * @brief Hash the chunks of the buffer and concatenate their hashes.
+     *
+     */
+    void Run(Azure::Core::Context const&) override
+    {
+      Azure::Storage::Crc64Hash hash;
+      for (size_t offset = 0; offset < m_data.size(); offset += m_chunkSize)
+      {
+        Azure::Storage::Crc64Hash chunkHash;
+        chunkHash.Append(m_data.data() + offset, (std::min)(m_chunkSize, m_data.size() - offset));
+        hash.Concatenate(chunkHash);
+      }
+      hash.Final();
+    }
+
+    /**
+     * @brief The bytes hashed by each run.
+     *
+     */
+    int64_t GetBytesPerOperation() override { return static_cast<int64_t>(m_data.size()); }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Size", {"-s", "--size"}, "The number of bytes to hash, 4 MiB by default.", 1},
+          {"ChunkSize",
+           {"-c", "--chunkSize"},
+           "The number of bytes of each chunk hashed on its own, the whole buffer by default.",
+           1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "Crc64Test",
+          "Measures hashing a buffer with CRC64, chunk by chunk",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Test::Crc64Test>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the performance of signing the requests with a shared key.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/internal/http/pipeline.hpp>
+#include <azure/perf.hpp>
+#include <azure/storage/common/internal/shared_key_policy.hpp>
+#include <azure/storage/common/storage_credential.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace _detail {
+    /**
+     * @brief A policy ending the pipeline, which returns an empty response without sending the
+     * request.
+     *
+     */
+    class NoOpTransportPolicy final : public Azure::Core::Http::Policies::HttpPolicy {
+    public:
+      std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy> Clone() const override
+      {
+        return std::make_unique<NoOpTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+          Azure::Core::Http::Request&,
+          Azure::Core::Http::Policies::NextHttpPolicy,
+          Azure::Core::Context const&) const override
+      {
+        return std::make_unique<Azure::Core::Http::RawResponse>(
+            1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+      }
+    };
+  } // namespace _detail
+
+  /**
+   * @brief Measure signing a request with the SharedKey scheme, as the shared key policy does for
+   * every request sent with a storage shared key credential.
+   */
+  class SharedKeySignatureTest : public Azure::Perf::PerfTest {
+  private:
+    std::unique_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    std::unique_ptr<Azure::Core::Http::Request> m_request;
+
+  public:
+    /**
+     * @brief Construct a new shared key signature test.
+     *
+     * @param options The test options.
+     */
+    SharedKeySignatureTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Create a pipeline signing the requests and the request of a block upload, with the
+     * number of metadata headers from the options.
+     *
+     */
+    void Setup() override
+    {
+      std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> policies;
+      policies.push_back(std::make_unique<Azure::Storage::_internal::SharedKeyPolicy>(
+          std::make_shared<Azure::Storage::StorageSharedKeyCredential>(
+              "account", "YWNjb3VudEtleQ==")));
+      policies.push_back(std::make_unique<_detail::NoOpTransportPolicy>());
+      m_pipeline = std::make_unique<Azure::Core::Http::_internal::HttpPipeline>(policies);
+
+      m_request = std::make_unique<Azure::Core::Http::Request>(
+          Azure::Core::Http::HttpMethod::Put,
+          Azure::Core::Url("https://account.blob.core.windows.net/container/folder/blob"
+                           "?comp=block&blockid=MDAwMDAwMDAwMDAwMDAwMA%3D%3D&timeout=60"));
+      m_request->SetHeader("content-length", "4194304");
+      m_request->SetHeader("content-type", "application/octet-stream");
+      m_request->SetHeader("x-ms-client-request-id", "c5ca2e5d-b01e-0046-5a5e-08f8d3000000");
+      m_request->SetHeader("x-ms-date", "Thu, 13 Jan 2022 21:37:52 GMT");
+      m_request->SetHeader("x-ms-version", "2020-02-10");
+      auto const metadata = m_options.GetOptionOrDefault<int>("Metadata", 0);
+      for (auto count = 0; count < metadata; count++)
+      {
+        m_request->SetHeader("x-ms-meta-key" + std::to_string(count), "value");
+      }
+    }
+
+    /**
+     * @brief Sign the request.
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      m_pipeline->Send(*m_request, context);
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Metadata",
+           {"-m", "--metadata"},
+           "The number of metadata headers of the request, none by default.",
+           1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "SharedKeySignatureTest",
+          "Measures signing a request with a storage shared key. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Test::SharedKeySignatureTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Storage::Test
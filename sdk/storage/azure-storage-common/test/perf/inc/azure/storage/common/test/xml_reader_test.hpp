@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the performance of reading the XML of the responses.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/storage/common/internal/xml_wrapper.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  /**
+   * @brief Measure reading every node of a canned page of a blob listing, without deserializing
+   * it into the models of the clients.
+   */
+  class XmlReaderTest : public Azure::Perf::PerfTest {
+  private:
+    std::string m_document;
+
+  public:
+    /**
+     * @brief Construct a new XmlReader test.
+     *
+     * @param options The test options.
+     */
+    XmlReaderTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+
+    /**
+     * @brief Build a page with the number of blobs from the options.
+     *
+     */
+    void Setup() override
+    {
+      auto const count = m_options.GetOptionOrDefault<int>("Count", 1000);
+
+      m_document = "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+                   "ServiceEndpoint=\"https://account.blob.core.windows.net/\" "
+                   "ContainerName=\"container\"><Blobs>";
+      for (auto blob = 0; blob < count; blob++)
+      {
+        m_document += "<Blob><Name>folder/blob&amp;name-" + std::to_string(blob)
+            + "</Name><Properties>"
+              "<Creation-Time>Thu, 13 Jan 2022 21:37:52 GMT</Creation-Time>"
+              "<Last-Modified>Thu, 13 Jan 2022 21:37:52 GMT</Last-Modified>"
+              "<Etag>0x8D9C2A1B3E4F5A6</Etag>"
+              "<Content-Length>1024</Content-Length>"
+              "<Content-Type>application/octet-stream</Content-Type>"
+              "<Content-MD5>1B2M2Y8AsgTpgAmY7PhCfg==</Content-MD5>"
+              "<BlobType>BlockBlob</BlobType>"
+              "<AccessTier>Hot</AccessTier>"
+              "<AccessTierInferred>true</AccessTierInferred>"
+              "<LeaseStatus>unlocked</LeaseStatus>"
+              "<LeaseState>available</LeaseState>"
+              "<ServerEncrypted>true</ServerEncrypted>"
+              "</Properties></Blob>";
+      }
+      m_document += "</Blobs><NextMarker /></EnumerationResults>";
+    }
+
+    /**
+     * @brief Read the nodes of the page.
+     *
+     */
+    void Run(Azure::Core::Context const&) override
+    {
+      Azure::Storage::_internal::XmlReader reader(m_document.data(), m_document.size());
+      while (reader.Read().Type != Azure::Storage::_internal::XmlNodeType::End)
+      {
+      }
+    }
+
+    /**
+     * @brief The bytes of XML read by each run.
+     *
+     */
+    int64_t GetBytesPerOperation() override { return static_cast<int64_t>(m_document.size()); }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Count", {"--count"}, "The number of blobs in the page, 1000 by default.", 1}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "XmlReaderTest",
+          "Read the nodes of a canned page of blobs. No network.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Test::XmlReaderTest>(options);
+          }};
+    }
+  };
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/perf.hpp>
+
+#include "azure/storage/common/test/crc64_test.hpp"
+#include "azure/storage/common/test/shared_key_signature_test.hpp"
+#include "azure/storage/common/test/xml_reader_test.hpp"
+
+#include <vector>
+
+int main(int argc, char** argv)
+{
+
+  // Create the test list
+  std::vector<Azure::Perf::TestMetadata> tests{
+      Azure::Storage::Test::Crc64Test::GetTestMetadata(),
+      Azure::Storage::Test::SharedKeySignatureTest::GetTestMetadata(),
+      Azure::Storage::Test::XmlReaderTest::GetTestMetadata()};
+
+  Azure::Perf::Program::Run(Azure::Core::Context::ApplicationContext, tests, argc, argv);
+
+  return 0;
+}
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <azure/storage/common/internal/range_write_coalescer.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    // A blob in memory, recording the ranges uploaded and read.
+    struct FakeBlob final
+    {
+      explicit FakeBlob(size_t size) : Content(size)
+      {
+        for (size_t i = 0; i < size; ++i)
+        {
+          Content[i] = static_cast<uint8_t>(i * 7);
+        }
+      }
+
+      std::vector<uint8_t> Content;
+      std::mutex Mutex;
+      std::vector<std::pair<int64_t, int64_t>> Uploads;
+      std::vector<std::pair<int64_t, int64_t>> Reads;
+
+      _internal::RangeWriteCoalescer::UploadFunc UploadFunc()
+      {
+        return [this](int64_t offset, const uint8_t* data, size_t length, const Core::Context&) {
+          std::memcpy(Content.data() + offset, data, length);
+          std::lock_guard<std::mutex> guard(Mutex);
+          Uploads.emplace_back(offset, static_cast<int64_t>(length));
+        };
+      }
+
+      _internal::RangeWriteCoalescer::ReadFunc ReadFunc()
+      {
+        return [this](int64_t offset, uint8_t* data, size_t length, const Core::Context&) {
+          std::memcpy(data, Content.data() + offset, length);
+          std::lock_guard<std::mutex> guard(Mutex);
+          Reads.emplace_back(offset, static_cast<int64_t>(length));
+        };
+      }
+    };
+  } // namespace
+
+  TEST(RangeWriteCoalescerTest, CoalescesWrites)
+  {
+    FakeBlob blob(64 * 1024);
+    std::vector<uint8_t> expected = blob.Content;
+    _internal::RangeWriteCoalescerOptions options;
+    options.Alignment = 512;
+    options.MaxRangeSize = 4096;
+    options.Concurrency = 4;
+    _internal::RangeWriteCoalescer coalescer(options, blob.UploadFunc(), blob.ReadFunc(), nullptr);
+
+    // Sequential writes of 100 bytes from an unaligned offset, rewritten partly.
+    std::vector<uint8_t> data(100, 'a');
+    for (int64_t offset = 1000; offset < 1000 + 100 * 50; offset += 100)
+    {
+      coalescer.WriteAt(offset, data.data(), data.size(), Core::Context());
+      std::memcpy(expected.data() + offset, data.data(), data.size());
+    }
+    std::vector<uint8_t> overwrite(300, 'b');
+    coalescer.WriteAt(1500, overwrite.data(), overwrite.size(), Core::Context());
+    std::memcpy(expected.data() + 1500, overwrite.data(), overwrite.size());
+    EXPECT_EQ(coalescer.BufferedSize(), 100 * 50);
+    EXPECT_TRUE(blob.Uploads.empty());
+
+    coalescer.Flush(Core::Context());
+    EXPECT_EQ(coalescer.BufferedSize(), 0);
+    EXPECT_EQ(blob.Content, expected);
+    // [512, 6144) in ranges of 4 KiB, with the bytes before 1000 and after 6000 read back.
+    ASSERT_EQ(blob.Uploads.size(), 2U);
+    int64_t uploadedSize = 0;
+    for (const auto& upload : blob.Uploads)
+    {
+      EXPECT_EQ(upload.first % 512, 0);
+      EXPECT_EQ(upload.second % 512, 0);
+      EXPECT_LE(upload.second, 4096);
+      uploadedSize += upload.second;
+    }
+    EXPECT_EQ(uploadedSize, 6144 - 512);
+    int64_t readSize = 0;
+    for (const auto& read : blob.Reads)
+    {
+      readSize += read.second;
+    }
+    EXPECT_EQ(readSize, (1000 - 512) + (6144 - 6000));
+
+    // Writes sharing a page are read back together and uploaded with a single request.
+    blob.Uploads.clear();
+    blob.Reads.clear();
+    for (int64_t offset : {10000, 10010, 10100, 10500})
+    {
+      coalescer.WriteAt(offset, data.data(), 5, Core::Context());
+      std::memcpy(expected.data() + offset, data.data(), 5);
+    }
+    coalescer.Flush(Core::Context());
+    EXPECT_EQ(blob.Content, expected);
+    ASSERT_EQ(blob.Uploads.size(), 1U);
+    EXPECT_EQ(blob.Uploads[0], std::make_pair(int64_t(9728), int64_t(1024)));
+    EXPECT_EQ(blob.Reads.size(), 1U);
+
+    // Nothing to flush.
+    blob.Uploads.clear();
+    coalescer.Flush(Core::Context());
+    EXPECT_TRUE(blob.Uploads.empty());
+
+    EXPECT_THROW(
+        coalescer.WriteAt(-1, data.data(), data.size(), Core::Context()), std::invalid_argument);
+    options.MaxRangeSize = 1000;
+    EXPECT_THROW(
+        _internal::RangeWriteCoalescer(options, blob.UploadFunc(), blob.ReadFunc(), nullptr),
+        std::invalid_argument);
+    options.MaxRangeSize = 4096;
+    EXPECT_THROW(
+        _internal::RangeWriteCoalescer(options, blob.UploadFunc(), nullptr, nullptr),
+        std::invalid_argument);
+  }
+
+  TEST(RangeWriteCoalescerTest, RandomWrites)
+  {
+    std::mt19937_64 random(0);
+    for (int64_t alignment : {1, 512})
+    {
+      FakeBlob blob(1024 * 1024);
+      std::vector<uint8_t> expected = blob.Content;
+      _internal::RangeWriteCoalescerOptions options;
+      options.Alignment = alignment;
+      options.MaxRangeSize = 64 * 1024;
+      options.Concurrency = 8;
+      options.MaxBufferedSize = 256 * 1024;
+      _internal::RangeWriteCoalescer coalescer(
+          options, blob.UploadFunc(), alignment == 1 ? nullptr : blob.ReadFunc(), nullptr);
+
+      std::vector<uint8_t> data(16 * 1024);
+      for (int write = 0; write < 2000; ++write)
+      {
+        const size_t length = static_cast<size_t>(random() % data.size()) + 1;
+        const int64_t offset
+            = static_cast<int64_t>(random() % (blob.Content.size() - length + 1));
+        for (size_t i = 0; i < length; ++i)
+        {
+          data[i] = static_cast<uint8_t>(random());
+        }
+        coalescer.WriteAt(offset, data.data(), length, Core::Context());
+        std::memcpy(expected.data() + offset, data.data(), length);
+      }
+      coalescer.Flush(Core::Context());
+      EXPECT_EQ(blob.Content, expected);
+      for (const auto& upload : blob.Uploads)
+      {
+        EXPECT_EQ(upload.first % alignment, 0);
+        EXPECT_EQ(upload.second % alignment, 0);
+        EXPECT_LE(upload.second, options.MaxRangeSize);
+      }
+      if (alignment == 1)
+      {
+        EXPECT_TRUE(blob.Reads.empty());
+      }
+    }
+  }
+
+  TEST(RangeWriteCoalescerTest, FailedFlush)
+  {
+    int uploads = 0;
+    _internal::RangeWriteCoalescer coalescer(
+        _internal::RangeWriteCoalescerOptions(),
+        [&](int64_t, const uint8_t*, size_t, const Core::Context&) {
+          ++uploads;
+          throw std::runtime_error("upload failed");
+        },
+        nullptr,
+        nullptr);
+    std::vector<uint8_t> data(100);
+    coalescer.WriteAt(0, data.data(), data.size(), Core::Context());
+    EXPECT_THROW(coalescer.Flush(Core::Context()), std::runtime_error);
+    EXPECT_THROW(
+        coalescer.WriteAt(100, data.data(), data.size(), Core::Context()), std::runtime_error);
+    EXPECT_THROW(coalescer.Flush(Core::Context()), std::runtime_error);
+    EXPECT_EQ(uploads, 1);
+  }
+
+}}} // namespace Azure::Storage::Test
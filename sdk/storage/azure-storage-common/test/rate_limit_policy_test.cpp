@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <chrono>
+#include <stdexcept>
+
+#include <azure/core/http/raw_response.hpp>
+#include <azure/core/internal/http/pipeline.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
+#include <azure/storage/common/rate_limiter.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    // Responds to every request with the content, as a body stream.
+    class ContentTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit ContentTransportPolicy(const std::vector<uint8_t>& content) : m_content(content) {}
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<ContentTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request&,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        response->SetBodyStream(
+            std::make_unique<Core::IO::MemoryBodyStream>(m_content.data(), m_content.size()));
+        return response;
+      }
+
+    private:
+      const std::vector<uint8_t>& m_content;
+    };
+
+    Core::Http::_internal::HttpPipeline CreatePipeline(
+        std::shared_ptr<RateLimiter> rateLimiter,
+        const std::vector<uint8_t>& content)
+    {
+      std::vector<std::unique_ptr<Core::Http::Policies::HttpPolicy>> policies;
+      policies.emplace_back(std::make_unique<_internal::RateLimitPolicy>(rateLimiter));
+      policies.emplace_back(std::make_unique<ContentTransportPolicy>(content));
+      return Core::Http::_internal::HttpPipeline(std::move(policies));
+    }
+  } // namespace
+
+  TEST(RateLimitPolicyTest, TokenBucket)
+  {
+    // Taken before the bucket is created, so that it isn't refilled by the time the test takes.
+    auto now = std::chrono::steady_clock::now();
+    _internal::TokenBucket bucket(1000);
+
+    // The bucket starts full, then goes in debt.
+    EXPECT_EQ(bucket.Take(600, now), std::chrono::steady_clock::duration::zero());
+    EXPECT_EQ(bucket.Take(600, now), std::chrono::steady_clock::duration::zero());
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::milliseconds>(bucket.Take(100, now)).count(),
+        200);
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::milliseconds>(bucket.Take(0, now)).count(), 300);
+
+    // It is refilled over time, up to its capacity.
+    now += std::chrono::milliseconds(200);
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::milliseconds>(bucket.Take(0, now)).count(), 100);
+    now += std::chrono::seconds(10);
+    EXPECT_EQ(bucket.Take(1000, now), std::chrono::steady_clock::duration::zero());
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::milliseconds>(bucket.Take(0, now)).count(), 0);
+    bucket.Return(500);
+    EXPECT_EQ(bucket.Take(500, now), std::chrono::steady_clock::duration::zero());
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::milliseconds>(bucket.Take(0, now)).count(), 0);
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::milliseconds>(bucket.Take(1, now)).count(), 0);
+    EXPECT_EQ(
+        std::chrono::duration_cast<std::chrono::milliseconds>(bucket.Take(0, now)).count(), 1);
+  }
+
+  TEST(RateLimitPolicyTest, RateLimiter)
+  {
+    RateLimiter rateLimiter(1024, 10);
+    EXPECT_EQ(rateLimiter.BytesPerSecond(), 1024);
+    EXPECT_EQ(rateLimiter.RequestsPerSecond(), 10);
+    EXPECT_NO_THROW(RateLimiter(0, 0));
+    EXPECT_THROW(RateLimiter(-1, 0), std::invalid_argument);
+    EXPECT_THROW(RateLimiter(0, -1), std::invalid_argument);
+  }
+
+  TEST(RateLimitPolicyTest, LimitRequests)
+  {
+    const std::vector<uint8_t> content;
+    auto pipeline = CreatePipeline(std::make_shared<RateLimiter>(0, 20), content);
+
+    // The first 20 requests are sent right away, the last one waits for 9 more tokens.
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 30; ++i)
+    {
+      Core::Http::Request request(
+          Core::Http::HttpMethod::Get, Core::Url("https://account.blob.core.windows.net"));
+      EXPECT_TRUE(pipeline.Send(request, Core::Context()));
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+  }
+
+  TEST(RateLimitPolicyTest, LimitBytes)
+  {
+    const auto content = RandomBuffer(static_cast<size_t>(96_KB));
+    auto pipeline = CreatePipeline(std::make_shared<RateLimiter>(64_KB, 0), content);
+
+    // The first 72 KB are received right away, the last read waits for 24 more KB of tokens.
+    const auto start = std::chrono::steady_clock::now();
+    Core::Http::Request request(
+        Core::Http::HttpMethod::Get, Core::Url("https://account.blob.core.windows.net"), false);
+    auto response = pipeline.Send(request, Core::Context());
+    auto bodyStream = response->ExtractBodyStream();
+    EXPECT_EQ(bodyStream->Length(), static_cast<int64_t>(content.size()));
+    std::vector<uint8_t> received(content.size());
+    for (size_t offset = 0; offset < received.size(); offset += static_cast<size_t>(8_KB))
+    {
+      EXPECT_EQ(
+          bodyStream->ReadToCount(&received[offset], static_cast<size_t>(8_KB)),
+          static_cast<int64_t>(8_KB));
+    }
+    EXPECT_EQ(received, content);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300));
+
+    // A cancelled context stops the wait.
+    Core::Context context;
+    context.Cancel();
+    bodyStream->Rewind();
+    EXPECT_THROW(
+        bodyStream->ReadToCount(received.data(), received.size(), context),
+        Core::OperationCancelledException);
+  }
+
+}}} // namespace Azure::Storage::Test
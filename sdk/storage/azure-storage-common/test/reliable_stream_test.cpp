@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <azure/core/http/http.hpp>
+#include <azure/core/io/body_stream.hpp>
+#include <azure/storage/common/internal/reliable_stream.hpp>
+#include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    // Reads the data from an offset and fails after failAfter bytes, or stalls until the context
+    // is cancelled if stall is true.
+    class FlakyBodyStream final : public Core::IO::BodyStream {
+    public:
+      explicit FlakyBodyStream(
+          const std::vector<uint8_t>& data,
+          size_t offset,
+          size_t failAfter,
+          bool stall = false)
+          : m_data(data), m_offset(offset), m_end(std::min(data.size(), offset + failAfter)),
+            m_stall(stall)
+      {
+      }
+
+      int64_t Length() const override { return static_cast<int64_t>(m_data.size() - m_offset); }
+
+    private:
+      size_t OnRead(uint8_t* buffer, size_t count, Core::Context const& context) override
+      {
+        if (m_offset == m_end && m_offset != m_data.size())
+        {
+          while (m_stall)
+          {
+            context.ThrowIfCancelled();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+          }
+          throw Core::Http::TransportException("Connection reset.");
+        }
+        const size_t bytesRead = std::min(count, m_end - m_offset);
+        std::copy(m_data.begin() + m_offset, m_data.begin() + m_offset + bytesRead, buffer);
+        m_offset += bytesRead;
+        return bytesRead;
+      }
+
+      const std::vector<uint8_t>& m_data;
+      size_t m_offset;
+      size_t m_end;
+      bool m_stall;
+    };
+
+    // Reads the data from an offset, a few bytes at a time and slowly.
+    class SlowBodyStream final : public Core::IO::BodyStream {
+    public:
+      explicit SlowBodyStream(const std::vector<uint8_t>& data) : m_data(data) {}
+
+      int64_t Length() const override { return static_cast<int64_t>(m_data.size()); }
+
+    private:
+      size_t OnRead(uint8_t* buffer, size_t count, Core::Context const&) override
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const size_t bytesRead = std::min({count, size_t(10), m_data.size() - m_offset});
+        std::copy(m_data.begin() + m_offset, m_data.begin() + m_offset + bytesRead, buffer);
+        m_offset += bytesRead;
+        return bytesRead;
+      }
+
+      const std::vector<uint8_t>& m_data;
+      size_t m_offset = 0;
+    };
+  } // namespace
+
+  TEST(ReliableStreamTest, Reconnect)
+  {
+    const std::vector<uint8_t> data = RandomBuffer(static_cast<size_t>(100_KB));
+    std::vector<bool> readFromSecondary;
+    std::vector<int64_t> offsets;
+    _internal::ReliableStreamOptions options;
+    options.MaxRetryRequests = 3;
+    options.RetryDelay = std::chrono::milliseconds(50);
+    options.MaxRetryDelay = std::chrono::milliseconds(1000);
+    _internal::ReliableStream stream(
+        std::make_unique<FlakyBodyStream>(data, 0, static_cast<size_t>(30_KB)),
+        options,
+        [&](int64_t offset, const Core::Context& context) -> std::unique_ptr<Core::IO::BodyStream> {
+          bool secondary = false;
+          context.TryGetValue(_internal::ReadFromSecondaryKey, secondary);
+          readFromSecondary.push_back(secondary);
+          offsets.push_back(offset);
+          return std::make_unique<FlakyBodyStream>(
+              data, static_cast<size_t>(offset), static_cast<size_t>(40_KB));
+        });
+
+    // Every failure waits before reconnecting.
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(stream.ReadToEnd(), data);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(40 + 40));
+    EXPECT_EQ(offsets, std::vector<int64_t>({int64_t(30_KB), int64_t(70_KB)}));
+    EXPECT_EQ(readFromSecondary, std::vector<bool>({true, false}));
+
+    // The consecutive failures wait twice as long as the previous one, the last one is rethrown.
+    _internal::ReliableStream failingStream(
+        std::make_unique<FlakyBodyStream>(data, 0, 0),
+        options,
+        [&](int64_t offset, const Core::Context&) -> std::unique_ptr<Core::IO::BodyStream> {
+          return std::make_unique<FlakyBodyStream>(data, static_cast<size_t>(offset), 0);
+        });
+    const auto failingStart = std::chrono::steady_clock::now();
+    EXPECT_THROW(failingStream.ReadToEnd(), Core::Http::TransportException);
+    EXPECT_GE(
+        std::chrono::steady_clock::now() - failingStart, std::chrono::milliseconds(40 + 80));
+  }
+
+  TEST(ReliableStreamTest, ReadV)
+  {
+    const std::vector<uint8_t> data = RandomBuffer(static_cast<size_t>(100_KB));
+    _internal::ReliableStreamOptions options;
+    options.RetryDelay = std::chrono::milliseconds(0);
+    _internal::ReliableStream stream(
+        std::make_unique<FlakyBodyStream>(data, 0, static_cast<size_t>(30_KB)),
+        options,
+        [&](int64_t offset, const Core::Context&) -> std::unique_ptr<Core::IO::BodyStream> {
+          return std::make_unique<FlakyBodyStream>(
+              data, static_cast<size_t>(offset), static_cast<size_t>(40_KB));
+        });
+
+    // The reads into several buffers reconnect like the others.
+    std::vector<uint8_t> read(data.size() + 1);
+    size_t totalRead = 0;
+    for (;;)
+    {
+      const size_t segment = std::min(static_cast<size_t>(16_KB), read.size() - totalRead);
+      const size_t secondSegment
+          = std::min(static_cast<size_t>(16_KB), read.size() - totalRead - segment);
+      const Core::IO::ReadBuffer buffers[] = {
+          {read.data() + totalRead, segment},
+          {read.data() + totalRead + segment, secondSegment},
+      };
+      const size_t readBytes = stream.ReadV(buffers, 2);
+      if (readBytes == 0)
+      {
+        break;
+      }
+      totalRead += readBytes;
+    }
+    read.resize(totalRead);
+    EXPECT_EQ(read, data);
+  }
+
+  TEST(ReliableStreamTest, Stall)
+  {
+    const std::vector<uint8_t> data = RandomBuffer(static_cast<size_t>(100_KB));
+    int reconnects = 0;
+    _internal::ReliableStreamOptions options;
+    options.MaxRetryRequests = 3;
+    options.StallTimeout = std::chrono::milliseconds(100);
+    auto reconnector
+        = [&](int64_t offset, const Core::Context&) -> std::unique_ptr<Core::IO::BodyStream> {
+      ++reconnects;
+      return std::make_unique<FlakyBodyStream>(data, static_cast<size_t>(offset), data.size());
+    };
+
+    // A stalled read is abandoned after the timeout.
+    {
+      _internal::ReliableStream stream(
+          std::make_unique<FlakyBodyStream>(data, 0, static_cast<size_t>(10_KB), true),
+          options,
+          reconnector);
+      EXPECT_EQ(stream.ReadToEnd(), data);
+      EXPECT_EQ(reconnects, 1);
+    }
+
+    // A cancelled context isn't mistaken for a stall.
+    {
+      _internal::ReliableStream stream(
+          std::make_unique<FlakyBodyStream>(data, 0, static_cast<size_t>(10_KB), true),
+          options,
+          reconnector);
+      std::vector<uint8_t> buffer(static_cast<size_t>(10_KB));
+      EXPECT_EQ(stream.ReadToCount(buffer.data(), buffer.size()), buffer.size());
+      Core::Context context;
+      context.Cancel();
+      EXPECT_THROW(
+          stream.Read(buffer.data(), buffer.size(), context), Core::OperationCancelledException);
+      EXPECT_EQ(reconnects, 1);
+    }
+  }
+
+  TEST(ReliableStreamTest, MinimumThroughput)
+  {
+    const std::vector<uint8_t> data = RandomBuffer(static_cast<size_t>(100_KB));
+    std::vector<int64_t> offsets;
+    _internal::ReliableStreamOptions options;
+    options.MaxRetryRequests = 3;
+    options.MinimumThroughput = 10000;
+    options.ThroughputWindow = std::chrono::milliseconds(50);
+
+    // The connection receiving 1000 bytes per second is replaced once a window was spent reading
+    // from it, without failing any read.
+    _internal::ReliableStream stream(
+        std::make_unique<SlowBodyStream>(data),
+        options,
+        [&](int64_t offset, const Core::Context&) -> std::unique_ptr<Core::IO::BodyStream> {
+          offsets.push_back(offset);
+          return std::make_unique<FlakyBodyStream>(
+              data, static_cast<size_t>(offset), data.size());
+        });
+    EXPECT_EQ(stream.ReadToEnd(), data);
+    ASSERT_EQ(offsets.size(), 1U);
+    EXPECT_GE(offsets[0], 50);
+    EXPECT_LE(offsets[0], 100);
+  }
+
+}}} // namespace Azure::Storage::Test
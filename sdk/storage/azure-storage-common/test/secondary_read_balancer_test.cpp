@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <azure/core/http/raw_response.hpp>
+#include <azure/core/internal/http/pipeline.hpp>
+#include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
+#include <azure/storage/common/secondary_read_balancer.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    constexpr const char* PrimaryHost = "account.blob.core.windows.net";
+    constexpr const char* SecondaryHost = "account-secondary.blob.core.windows.net";
+
+    // Counts the requests sent to each host, and responds with the status of the host.
+    class HostTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      struct State
+      {
+        std::map<std::string, int> Requests;
+        std::map<std::string, Core::Http::HttpStatusCode> StatusCodes;
+      };
+
+      explicit HostTransportPolicy(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<HostTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        const std::string host = request.GetUrl().GetHost();
+        ++m_state->Requests[host];
+        auto statusCode = m_state->StatusCodes.find(host);
+        return std::make_unique<Core::Http::RawResponse>(
+            1,
+            1,
+            statusCode == m_state->StatusCodes.end() ? Core::Http::HttpStatusCode::Ok
+                                                     : statusCode->second,
+            "");
+      }
+
+    private:
+      std::shared_ptr<State> m_state;
+    };
+
+    Core::Http::_internal::HttpPipeline CreatePipeline(
+        std::shared_ptr<SecondaryReadBalancer> readBalancer,
+        std::shared_ptr<HostTransportPolicy::State> state)
+    {
+      std::vector<std::unique_ptr<Core::Http::Policies::HttpPolicy>> policies;
+      policies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
+          PrimaryHost, SecondaryHost, std::move(readBalancer)));
+      policies.emplace_back(std::make_unique<HostTransportPolicy>(std::move(state)));
+      return Core::Http::_internal::HttpPipeline(std::move(policies));
+    }
+
+    void SendReads(Core::Http::_internal::HttpPipeline& pipeline, int numReads)
+    {
+      for (int i = 0; i < numReads; ++i)
+      {
+        Core::Http::Request request(
+            Core::Http::HttpMethod::Get, Core::Url(std::string("https://") + PrimaryHost + "/c/b"));
+        pipeline.Send(request, _internal::WithReplicaStatus(Core::Context()));
+      }
+    }
+  } // namespace
+
+  TEST(SecondaryReadBalancerTest, RoundRobin)
+  {
+    auto state = std::make_shared<HostTransportPolicy::State>();
+    auto pipeline = CreatePipeline(
+        std::make_shared<SecondaryReadBalancer>(SecondaryReadBalancer::Strategy::RoundRobin),
+        state);
+    SendReads(pipeline, 10);
+    EXPECT_EQ(state->Requests[PrimaryHost], 5);
+    EXPECT_EQ(state->Requests[SecondaryHost], 5);
+
+    // Writes and reads which can't go to the secondary host stay on the primary host.
+    state->Requests.clear();
+    Core::Http::Request write(
+        Core::Http::HttpMethod::Put, Core::Url(std::string("https://") + PrimaryHost + "/c/b"));
+    pipeline.Send(write, _internal::WithReplicaStatus(Core::Context()));
+    for (int i = 0; i < 2; ++i)
+    {
+      Core::Http::Request read(
+          Core::Http::HttpMethod::Get, Core::Url(std::string("https://") + PrimaryHost + "/c/b"));
+      pipeline.Send(read, Core::Context());
+    }
+    EXPECT_EQ(state->Requests[PrimaryHost], 3);
+    EXPECT_EQ(state->Requests[SecondaryHost], 0);
+
+    // A read not found on the secondary host is sent to the primary host.
+    state->Requests.clear();
+    state->StatusCodes[SecondaryHost] = Core::Http::HttpStatusCode::NotFound;
+    SendReads(pipeline, 2);
+    EXPECT_EQ(state->Requests[PrimaryHost], 2);
+    EXPECT_EQ(state->Requests[SecondaryHost], 1);
+  }
+
+  TEST(SecondaryReadBalancerTest, LatencyWeighted)
+  {
+    _internal::SecondaryReadBalancerState balancer(
+        SecondaryReadBalancer::Strategy::LatencyWeighted, Azure::Nullable<std::chrono::seconds>());
+    const Azure::DateTime now(std::chrono::system_clock::now());
+
+    // The hosts get as many reads until they both have a latency.
+    EXPECT_FALSE(balancer.ChooseSecondary(now, 0.6));
+    EXPECT_TRUE(balancer.ChooseSecondary(now, 0.4));
+    balancer.RecordLatency(false, std::chrono::milliseconds(90));
+    EXPECT_TRUE(balancer.ChooseSecondary(now, 0.4));
+
+    // The secondary host is 9 times faster, it gets 90% of the reads.
+    balancer.RecordLatency(true, std::chrono::milliseconds(10));
+    EXPECT_TRUE(balancer.ChooseSecondary(now, 0.85));
+    EXPECT_FALSE(balancer.ChooseSecondary(now, 0.95));
+
+    // Failures weigh the secondary host down.
+    for (int i = 0; i < 5; ++i)
+    {
+      balancer.RecordFailure(true);
+    }
+    EXPECT_FALSE(balancer.ChooseSecondary(now, 0.5));
+    EXPECT_TRUE(balancer.ChooseSecondary(now, 0.1));
+  }
+
+  TEST(SecondaryReadBalancerTest, ReplicationLag)
+  {
+    auto readBalancer = std::make_shared<SecondaryReadBalancer>(
+        SecondaryReadBalancer::Strategy::RoundRobin, std::chrono::seconds(60));
+    auto state = std::make_shared<HostTransportPolicy::State>();
+    auto pipeline = CreatePipeline(readBalancer, state);
+
+    // The reads stay on the primary host until the last sync time is known, and while it's too
+    // long ago.
+    SendReads(pipeline, 4);
+    EXPECT_EQ(state->Requests[SecondaryHost], 0);
+    readBalancer->SetLastSyncTime(
+        Azure::DateTime(std::chrono::system_clock::now() - std::chrono::minutes(5)));
+    SendReads(pipeline, 4);
+    EXPECT_EQ(state->Requests[SecondaryHost], 0);
+    readBalancer->SetLastSyncTime(Azure::DateTime(std::chrono::system_clock::now()));
+    SendReads(pipeline, 4);
+    EXPECT_EQ(state->Requests[SecondaryHost], 2);
+  }
+
+}}} // namespace Azure::Storage::Test
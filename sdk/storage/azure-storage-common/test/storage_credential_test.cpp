@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
+#include <azure/core/base64.hpp>
+#include <azure/storage/common/account_sas_builder.hpp>
 #include <azure/storage/common/storage_credential.hpp>
 
 #include "test_base.hpp"
@@ -23,4 +25,26 @@ namespace Azure { namespace Storage { namespace Test {
         "testaccount.blob.core.windows.net");
   }
 
+  TEST(StorageCredentialTest, SasSignedWithUpdatedKey)
+  {
+    const std::string key1 = Azure::Core::Convert::Base64Encode(RandomBuffer(64));
+    const std::string key2 = Azure::Core::Convert::Base64Encode(RandomBuffer(64));
+
+    Sas::AccountSasBuilder builder;
+    builder.ExpiresOn = Azure::DateTime(2030, 1, 1);
+    builder.Services = Sas::AccountSasServices::Blobs;
+    builder.ResourceTypes = Sas::AccountSasResource::Object;
+    builder.SetPermissions(Sas::AccountSasPermissions::Read);
+
+    StorageSharedKeyCredential credential("testaccount", key1);
+    const auto token1 = builder.GenerateSasToken(credential);
+    EXPECT_EQ(builder.GenerateSasToken(credential), token1);
+
+    // The HMAC state kept by the credential is replaced when its key is updated.
+    credential.Update(key2);
+    const auto token2 = builder.GenerateSasToken(credential);
+    EXPECT_NE(token2, token1);
+    EXPECT_EQ(token2, builder.GenerateSasToken(StorageSharedKeyCredential("testaccount", key2)));
+  }
+
 }}} // namespace Azure::Storage::Test
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/storage/common/storage_exception.hpp>
+
+#include <string>
+#include <vector>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(StorageExceptionTest, IsFailedWith)
+  {
+    using Azure::Core::Http::HttpStatusCode;
+    using Azure::Core::Http::RawResponse;
+
+    RawResponse response(1, 1, HttpStatusCode::NotFound, "The specified blob does not exist.");
+    response.SetHeader("x-ms-error-code", "BlobNotFound");
+    EXPECT_TRUE(_internal::IsFailedWith(
+        response, HttpStatusCode::NotFound, {"BlobNotFound", "ContainerNotFound"}));
+    EXPECT_FALSE(_internal::IsFailedWith(response, HttpStatusCode::NotFound, {"ShareNotFound"}));
+    EXPECT_FALSE(_internal::IsFailedWith(response, HttpStatusCode::Conflict, {"BlobNotFound"}));
+
+    // Without the header, the error code is read from the body.
+    RawResponse bodyResponse(1, 1, HttpStatusCode::Conflict, "Conflict");
+    bodyResponse.SetHeader("content-type", "application/xml");
+    const std::string body
+        = "<?xml version=\"1.0\" encoding=\"utf-8\"?><Error><Code>ContainerAlreadyExists</Code>"
+          "<Message>The specified container already exists.</Message></Error>";
+    bodyResponse.SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+    EXPECT_TRUE(_internal::IsFailedWith(
+        bodyResponse, HttpStatusCode::Conflict, {"ContainerAlreadyExists"}));
+    EXPECT_FALSE(
+        _internal::IsFailedWith(bodyResponse, HttpStatusCode::Conflict, {"BlobAlreadyExists"}));
+
+    RawResponse okResponse(1, 1, HttpStatusCode::Ok, "OK");
+    EXPECT_FALSE(_internal::IsFailedWith(okResponse, HttpStatusCode::NotFound, {"BlobNotFound"}));
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <azure/core/io/body_stream.hpp>
+#include <azure/storage/common/internal/transfer_progress.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(TransferProgressTest, ReportsTheTotal)
+  {
+    std::vector<int64_t> reports;
+    std::atomic<int> concurrentReports{0};
+    bool overlapped = false;
+    {
+      // Rate limited, from many threads.
+      _internal::TransferProgress progress(
+          [&](int64_t bytes) {
+            overlapped = overlapped || ++concurrentReports > 1;
+            reports.push_back(bytes);
+            --concurrentReports;
+          },
+          1);
+      EXPECT_TRUE(progress.IsEnabled());
+      std::vector<std::thread> threads;
+      for (int i = 0; i < 16; ++i)
+      {
+        threads.emplace_back([&progress]() {
+          for (int j = 0; j < 1000; ++j)
+          {
+            progress.Add(10);
+          }
+        });
+      }
+      for (auto& thread : threads)
+      {
+        thread.join();
+      }
+      progress.Complete();
+    }
+    EXPECT_FALSE(overlapped);
+    ASSERT_GE(reports.size(), 1U);
+    EXPECT_LE(reports.size(), 3U);
+    EXPECT_EQ(reports.back(), 160000);
+
+    // Every addition is reported without a limit.
+    reports.clear();
+    _internal::TransferProgress progress([&](int64_t bytes) { reports.push_back(bytes); }, 0);
+    progress.Add(5);
+    progress.Add(7);
+    progress.Complete();
+    EXPECT_EQ(reports, std::vector<int64_t>({5, 12}));
+
+    _internal::TransferProgress disabled(nullptr, 10);
+    EXPECT_FALSE(disabled.IsEnabled());
+    disabled.Add(5);
+    disabled.Complete();
+  }
+
+  TEST(TransferProgressTest, Stream)
+  {
+    std::vector<int64_t> reports;
+    _internal::TransferProgress progress([&](int64_t bytes) { reports.push_back(bytes); }, 0);
+    std::vector<uint8_t> data(100);
+    Azure::Core::IO::MemoryBodyStream memoryStream(data);
+    _internal::TransferProgressStream stream(memoryStream, progress);
+    EXPECT_EQ(stream.Length(), 100);
+    EXPECT_TRUE(stream.SupportsContiguousRead());
+
+    uint8_t buffer[30];
+    EXPECT_EQ(stream.Read(buffer, sizeof(buffer)), 30U);
+    const uint8_t* contiguous = nullptr;
+    EXPECT_EQ(stream.ReadContiguous(&contiguous, 20), 20U);
+    // The data read again is only counted once.
+    stream.Rewind();
+    EXPECT_EQ(stream.ReadToEnd().size(), 100U);
+    progress.Complete();
+    EXPECT_EQ(reports.front(), 30);
+    EXPECT_EQ(reports[1], 50);
+    EXPECT_EQ(reports[2], 0);
+    EXPECT_EQ(reports.back(), 100);
+  }
+
+}}} // namespace Azure::Storage::Test
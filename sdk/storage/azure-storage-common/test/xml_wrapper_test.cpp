@@ -0,0 +1,269 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <azure/storage/common/internal/xml_wrapper.hpp>
+
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    // Returns a few bytes at a time, so that elements and text are split across reads.
+    class ChunkedBodyStream final : public Azure::Core::IO::BodyStream {
+    public:
+      explicit ChunkedBodyStream(const std::string& data, size_t chunkSize)
+          : m_data(data), m_chunkSize(chunkSize)
+      {
+      }
+
+      int64_t Length() const override { return static_cast<int64_t>(m_data.size()); }
+
+      bool Failed = false;
+
+    private:
+      size_t OnRead(uint8_t* buffer, size_t count, const Azure::Core::Context&) override
+      {
+        if (Failed)
+        {
+          throw std::runtime_error("Stream failed.");
+        }
+        size_t length = std::min({count, m_chunkSize, m_data.size() - m_offset});
+        std::memcpy(buffer, m_data.data() + m_offset, length);
+        m_offset += length;
+        return length;
+      }
+
+      std::string m_data;
+      size_t m_chunkSize;
+      size_t m_offset = 0;
+    };
+
+    std::vector<_internal::XmlNode> ReadAll(_internal::XmlReader& reader)
+    {
+      std::vector<_internal::XmlNode> nodes;
+      while (true)
+      {
+        auto node = reader.Read();
+        if (node.Type == _internal::XmlNodeType::End)
+        {
+          break;
+        }
+        nodes.emplace_back(node.Type, node.Name, node.Value);
+      }
+      return nodes;
+    }
+  } // namespace
+
+  TEST(XmlWrapperTest, NodeView)
+  {
+    const std::string document = "<Blob Name=\"n\"><Metadata><Key>value</Key></Metadata></Blob>";
+    _internal::XmlReader reader(document.data(), document.size());
+
+    auto node = reader.Read();
+    EXPECT_EQ(node.Type, _internal::XmlNodeType::StartTag);
+    EXPECT_TRUE(node.Name == "Blob");
+    EXPECT_TRUE(node.Name != "Blobs");
+    EXPECT_TRUE(node.Name != "Blo");
+    EXPECT_TRUE(node.Name == std::string("Blob"));
+    EXPECT_TRUE(node.Value.empty());
+    EXPECT_STREQ(node.Value.data(), "");
+
+    node = reader.Read();
+    EXPECT_EQ(node.Type, _internal::XmlNodeType::Attribute);
+    std::string name = node.Name;
+    EXPECT_EQ(name, "Name");
+    EXPECT_EQ(std::string(node.Value), "n");
+
+    reader.Read();
+    node = reader.Read();
+    EXPECT_EQ(node.Name.length(), size_t(3));
+    EXPECT_STREQ(node.Name.data(), "Key");
+    node = reader.Read();
+    EXPECT_EQ(node.Type, _internal::XmlNodeType::Text);
+    EXPECT_TRUE(node.Name.empty());
+    EXPECT_EQ(node.Value.size(), size_t(5));
+    EXPECT_STREQ(node.Value.data(), "value");
+  }
+
+  TEST(XmlWrapperTest, ReadFromStream)
+  {
+    std::string document = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                           "<EnumerationResults ContainerName=\"container\"><Blobs>";
+    for (int i = 0; i < 1000; ++i)
+    {
+      document += "<Blob><Name>blob" + std::to_string(i) + "</Name><Properties /></Blob>";
+    }
+    document += "</Blobs><NextMarker>marker</NextMarker></EnumerationResults>";
+
+    _internal::XmlReader memoryReader(document.data(), document.size());
+    auto expected = ReadAll(memoryReader);
+
+    ChunkedBodyStream stream(document, 7);
+    Azure::Core::Context context;
+    _internal::XmlReader streamReader(stream, context);
+    auto nodes = ReadAll(streamReader);
+
+    ASSERT_EQ(nodes.size(), expected.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      EXPECT_EQ(nodes[i].Type, expected[i].Type);
+      EXPECT_EQ(nodes[i].Name, expected[i].Name);
+      EXPECT_EQ(nodes[i].Value, expected[i].Value);
+    }
+    EXPECT_EQ(nodes[1].Name, "ContainerName");
+    EXPECT_EQ(nodes[1].Value, "container");
+  }
+
+  TEST(XmlWrapperTest, ReadFromFailingStream)
+  {
+    std::string document = "<EnumerationResults>";
+    for (int i = 0; i < 1000; ++i)
+    {
+      document += "<Blob><Name>blob" + std::to_string(i) + "</Name></Blob>";
+    }
+    document += "</EnumerationResults>";
+
+    ChunkedBodyStream stream(document, document.size() / 2);
+    Azure::Core::Context context;
+    _internal::XmlReader reader(stream, context);
+    reader.Read();
+    stream.Failed = true;
+    try
+    {
+      ReadAll(reader);
+      FAIL();
+    }
+    catch (std::runtime_error& e)
+    {
+      EXPECT_STREQ(e.what(), "Stream failed.");
+    }
+  }
+
+  TEST(XmlWrapperTest, PullParser)
+  {
+    const std::string declaration = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n";
+    const std::string body
+        = "<EnumerationResults xmlns:x=\"urn:x\" a='1 > \"0\"'>\r\n"
+          "  <Blobs>\r\n"
+          "    <Blob><Name>a&lt;b&amp;c&#xE9; &#128512;</Name>"
+          "<Properties x:b = \"line\r\nend\ttab&#10;\" /></Blob>\r\n"
+          "    <Blob><Name> </Name><Empty></Empty><Text>a\r\nb </Text></Blob>\r\n"
+          "  </Blobs>\r\n"
+          "  <NextMarker />\r\n"
+          "</EnumerationResults>\r\n";
+    const std::string document = declaration + body;
+    _internal::XmlReader reader(document.data(), document.size());
+    const auto nodes = ReadAll(reader);
+
+    // The document type declaration makes libxml2 or WebServices parse the document.
+    const std::string platformDocument
+        = declaration + "<!DOCTYPE EnumerationResults>\r\n" + body;
+    _internal::XmlReader platformReader(platformDocument.data(), platformDocument.size());
+    const auto expected = ReadAll(platformReader);
+    ASSERT_EQ(nodes.size(), expected.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      EXPECT_EQ(nodes[i].Type, expected[i].Type);
+      EXPECT_EQ(nodes[i].Name, expected[i].Name);
+      EXPECT_EQ(nodes[i].Value, expected[i].Value);
+    }
+    ASSERT_GT(nodes.size(), size_t(8));
+    EXPECT_EQ(nodes[2].Name, "a");
+    EXPECT_EQ(nodes[2].Value, "1 > \"0\"");
+    EXPECT_EQ(nodes[6].Value, "a<b&c\xC3\xA9 \xF0\x9F\x98\x80");
+    EXPECT_EQ(nodes[9].Value, "line end tab\n");
+
+    // The document is parsed the same way when it is read a byte at a time.
+    ChunkedBodyStream stream(document, 1);
+    Azure::Core::Context context;
+    _internal::XmlReader streamReader(stream, context);
+    const auto streamNodes = ReadAll(streamReader);
+    ASSERT_EQ(streamNodes.size(), nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      EXPECT_EQ(streamNodes[i].Type, nodes[i].Type);
+      EXPECT_EQ(streamNodes[i].Name, nodes[i].Name);
+      EXPECT_EQ(streamNodes[i].Value, nodes[i].Value);
+    }
+
+    // CDATA sections are merged into the text around them, comments are skipped.
+    const std::string cdataDocument
+        = "<!-- c --><Text>a<![CDATA[<b>&amp;]]>c<!-- c --></Text><!-- c -->";
+    _internal::XmlReader cdataReader(cdataDocument.data(), cdataDocument.size());
+    const auto cdataNodes = ReadAll(cdataReader);
+    ASSERT_EQ(cdataNodes.size(), size_t(3));
+    EXPECT_EQ(cdataNodes[1].Value, "a<b>&amp;c");
+
+    // A document which isn't UTF-8 is parsed by libxml2 or WebServices too.
+    const std::string latin1Document
+        = "<?xml version='1.0' encoding='ISO-8859-1'?><Name>caf\xE9</Name>";
+    _internal::XmlReader latin1Reader(latin1Document.data(), latin1Document.size());
+    const auto latin1Nodes = ReadAll(latin1Reader);
+    ASSERT_EQ(latin1Nodes.size(), size_t(3));
+    EXPECT_EQ(latin1Nodes[1].Value, "caf\xC3\xA9");
+
+    for (std::string malformed :
+         {"", "<a>", "<a></b>", "<a><b></a></b>", "<a b></a>", "<a b=\"c></a>", "<a/><b/>",
+          "text<a/>", "<a/>text", "<a><![CDATA[b</a>"})
+    {
+      _internal::XmlReader malformedReader(malformed.data(), malformed.size());
+      EXPECT_THROW(ReadAll(malformedReader), std::runtime_error) << malformed;
+    }
+  }
+
+  TEST(XmlWrapperTest, Write)
+  {
+    _internal::XmlWriter writer;
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "BlockList"});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::Attribute, "a", "\"<&>\n"});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Latest", "id1"});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Empty"});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::EndTag});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Text"});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::Text, std::string(), "a<b&c>\"d\n"});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "Open"});
+    writer.Write(_internal::XmlNode{_internal::XmlNodeType::End});
+
+    EXPECT_EQ(
+        writer.GetDocument(),
+        "<?xml version=\"1.0\"?>\n<BlockList a=\"&quot;&lt;&amp;&gt;&#10;\"><Latest>id1</Latest>"
+        "<Empty/><Text>a&lt;b&amp;c&gt;&quot;d\n<Open/></Text></BlockList>\n");
+  }
+
+  TEST(XmlWrapperTest, UnescapeTextInPlace)
+  {
+    // The same as the text read.
+    for (std::string text :
+         {"",
+          "plain+/=",
+          "a&lt;b&amp;c&gt;&quot;d&apos;",
+          "a&#13;\r\nb\rc&#10;",
+          "&#xE9;&#8364;&#x1F600;"})
+    {
+      const std::string document = "<Text>" + text + "</Text>";
+      _internal::XmlReader reader(document.data(), document.size());
+      reader.Read();
+      auto node = reader.Read();
+      std::string expected;
+      if (node.Type == _internal::XmlNodeType::Text)
+      {
+        expected = node.Value;
+      }
+
+      const size_t length = _internal::UnescapeXmlTextInPlace(&text[0], text.size());
+      EXPECT_EQ(text.substr(0, length), expected);
+    }
+
+    // What isn't a valid reference is kept.
+    std::string text = "&unknown; & &#0; &#x110000; &amp";
+    const size_t length = _internal::UnescapeXmlTextInPlace(&text[0], text.size());
+    EXPECT_EQ(text.substr(0, length), "&unknown; & &#0; &#x110000; &amp");
+  }
+
+}}} // namespace Azure::Storage::Test
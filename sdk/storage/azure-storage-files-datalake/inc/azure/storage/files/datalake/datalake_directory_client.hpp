@@ -229,7 +229,84 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         const ListPathsOptions& options = ListPathsOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Sets POSIX access control rights on the directory and all the files and directories
+     * under it, changing its subtrees concurrently.
+     * @param acls Sets POSIX access control rights on files and directories. Each access control
+     * entry (ACE) consists of a scope, a type, a user or group identifier, and permissions.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::SetPathAccessControlListRecursiveConcurrentlyResult>
+     * containing summary stats of the operation.
+     * @remark The subdirectories and the files directly under the directory are changed
+     * concurrently, each with the recursive mode of the service, by batches continued with their
+     * continuation token. The directory itself is changed last, its access control list is
+     * computed from its current one for updates and removals. This request is sent to dfs
+     * endpoint.
+     */
+    Azure::Response<Models::SetPathAccessControlListRecursiveConcurrentlyResult>
+    SetAccessControlListRecursiveConcurrently(
+        const std::vector<Models::Acl>& acls,
+        const SetPathAccessControlListRecursiveConcurrentlyOptions& options
+        = SetPathAccessControlListRecursiveConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const
+    {
+      return ChangeAccessControlListRecursiveConcurrently(
+          _detail::PathSetAccessControlRecursiveMode::Set, acls, options, context);
+    }
+
+    /**
+     * @brief Updates POSIX access control rights on the directory and all the files and
+     * directories under it, changing its subtrees concurrently.
+     * @param acls Updates POSIX access control rights on files and directories. Each access control
+     * entry (ACE) consists of a scope, a type, a user or group identifier, and permissions.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::UpdatePathAccessControlListRecursiveConcurrentlyResult>
+     * containing summary stats of the operation.
+     * @remark This request is sent to dfs endpoint.
+     */
+    Azure::Response<Models::UpdatePathAccessControlListRecursiveConcurrentlyResult>
+    UpdateAccessControlListRecursiveConcurrently(
+        const std::vector<Models::Acl>& acls,
+        const UpdatePathAccessControlListRecursiveConcurrentlyOptions& options
+        = UpdatePathAccessControlListRecursiveConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const
+    {
+      return ChangeAccessControlListRecursiveConcurrently(
+          _detail::PathSetAccessControlRecursiveMode::Modify, acls, options, context);
+    }
+
+    /**
+     * @brief Removes POSIX access control rights on the directory and all the files and
+     * directories under it, changing its subtrees concurrently.
+     * @param acls Removes POSIX access control rights on files and directories. Each access control
+     * entry (ACE) consists of a scope, a type, a user or group identifier, and permissions.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::RemovePathAccessControlListRecursiveConcurrentlyResult>
+     * containing summary stats of the operation.
+     * @remark This request is sent to dfs endpoint.
+     */
+    Azure::Response<Models::RemovePathAccessControlListRecursiveConcurrentlyResult>
+    RemoveAccessControlListRecursiveConcurrently(
+        const std::vector<Models::Acl>& acls,
+        const RemovePathAccessControlListRecursiveConcurrentlyOptions& options
+        = RemovePathAccessControlListRecursiveConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const
+    {
+      return ChangeAccessControlListRecursiveConcurrently(
+          _detail::PathSetAccessControlRecursiveMode::Remove, acls, options, context);
+    }
+
   private:
+    Azure::Response<Models::SetPathAccessControlListRecursiveConcurrentlyResult>
+    ChangeAccessControlListRecursiveConcurrently(
+        _detail::PathSetAccessControlRecursiveMode mode,
+        const std::vector<Models::Acl>& acls,
+        const SetPathAccessControlListRecursiveConcurrentlyOptions& options,
+        const Azure::Core::Context& context) const;
+
     explicit DataLakeDirectoryClient(
         Azure::Core::Url directoryUrl,
         Blobs::BlobClient blobClient,
@@ -13,6 +13,7 @@
 #include <azure/storage/blobs/block_blob_client.hpp>
 #include <azure/storage/common/storage_credential.hpp>
 
+#include "azure/storage/files/datalake/datalake_file_writer.hpp"
 #include "azure/storage/files/datalake/datalake_options.hpp"
 #include "azure/storage/files/datalake/datalake_path_client.hpp"
 #include "azure/storage/files/datalake/datalake_responses.hpp"
@@ -252,6 +253,20 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         const DownloadFileToOptions& options = DownloadFileToOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Opens a writer appending the data written to it to this file, by buffers grouping
+     * many writes instead of a request per write.
+     *
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations. Cancelling it also fails the
+     * appends and flushes of the writer.
+     * @return A DataLakeFileWriter appending to the file from its current end, or from its
+     * beginning if it's overwritten.
+     */
+    std::unique_ptr<DataLakeFileWriter> OpenWrite(
+        const OpenWriteFileOptions& options = OpenWriteFileOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Schedules the file for deletion.
      * @param expiryOrigin Specify the origin of expiry.
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <azure/core/credentials/credentials.hpp>
 #include <azure/core/internal/http/pipeline.hpp>
@@ -181,6 +183,26 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         const ListPathsOptions& options = ListPathsOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Lists all the paths of this file system recursively, with several requests at the
+     * same time, one for each directory at the root of the file system.
+     *
+     * @remark The pages of paths are passed to \p onPaths once they are received, from several
+     * threads at the same time. Every partition fetches its next page in the background while its
+     * current page is processed, so that at most two pages per partition listed at the same time
+     * are held in memory. The pages aren't ordered.
+     *
+     * @param onPaths Called with the paths of each page. It must be safe to call it from several
+     * threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @remark This request is sent to dfs endpoint.
+     */
+    void ListPathsConcurrently(
+        const std::function<void(std::vector<Models::PathItem>)>& onPaths,
+        const ListPathsConcurrentlyOptions& options = ListPathsConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Gets the permissions for this file system. The permissions indicate whether
      * file system data may be accessed publicly.
@@ -240,6 +262,22 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         const RenameDirectoryOptions& options = RenameDirectoryOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Renames files and directories, several of them at the same time. A failed rename
+     * doesn't stop the others, its outcome is reported with the others'.
+     * @param paths The paths to rename, and where to.
+     * @param options Optional parameters to rename the paths.
+     * @param context Context for cancelling long running operations.
+     * @return RenamePathsResult containing the outcome of the rename of every path.
+     * @remark Every rename is retried like a single rename, by the retry policy of the client
+     * options. A path is renamed before the paths after it only if the concurrency is 1.
+     * @remark This request is sent to dfs endpoint.
+     */
+    Models::RenamePathsResult RenamePaths(
+        const std::vector<Models::RenamePathItem>& paths,
+        const RenamePathsOptions& options = RenamePathsOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
   private:
     Azure::Core::Url m_fileSystemUrl;
     Blobs::BlobContainerClient m_blobContainerClient;
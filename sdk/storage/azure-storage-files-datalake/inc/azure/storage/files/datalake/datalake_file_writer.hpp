@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <azure/core/context.hpp>
+
+namespace Azure { namespace Storage { namespace Files { namespace DataLake {
+
+  class DataLakeFileClient;
+  struct OpenWriteFileOptions;
+
+  /**
+   * @brief A writer appending to a file, returned by
+   * #Azure::Storage::Files::DataLake::DataLakeFileClient::OpenWrite.
+   *
+   * @remark The data written is buffered in memory and appended in the background by buffers of up
+   * to the buffer size of the options, as soon as a buffer is full or once its data has waited for
+   * the flush interval of the options. Up to the maximum concurrency of the options buffers are
+   * appended at the same time, each at its own offset. The data appended is flushed to the file
+   * once it has waited for the flush interval, when Flush() is called and when the writer is
+   * destroyed. Writes wait while the writer buffers the maximum buffered size of the options. The
+   * writer is thread-safe, the data is written to the file in the order it is written.
+   */
+  class DataLakeFileWriter final {
+  public:
+    /**
+     * @brief Appends and flushes the data written and not flushed yet, ignoring failures, and stops
+     * the background appends. Call Flush() first to know whether the data was flushed.
+     */
+    ~DataLakeFileWriter();
+
+    /**
+     * @brief Writes data to the file. The data is copied, and appended later.
+     *
+     * @param data The data to write.
+     * @param length The number of bytes of data.
+     * @param context Context for cancelling the wait for the buffer to have room for the data.
+     *
+     * @throw Azure::Storage::StorageException A previous append or flush failed, the data wasn't
+     * written.
+     */
+    void Write(
+        const uint8_t* data,
+        size_t length,
+        const Azure::Core::Context& context = Azure::Core::Context());
+
+    /**
+     * @brief Appends and flushes all the data written so far, without waiting for the buffer size
+     * or the flush interval, and waits for it to be flushed. The flushes of several threads at the
+     * same time share the same requests.
+     *
+     * @param context Context for cancelling the wait for the data to be flushed.
+     *
+     * @throw Azure::Storage::StorageException An append or a flush failed. All the following writes
+     * and flushes fail too.
+     */
+    void Flush(const Azure::Core::Context& context = Azure::Core::Context());
+
+    /**
+     * @brief Gets the size of the file after the data flushed by the writer so far.
+     *
+     * @return The position of the last flush.
+     */
+    int64_t GetCommittedSize() const;
+
+  private:
+    struct State;
+
+    explicit DataLakeFileWriter(
+        const DataLakeFileClient& client,
+        const OpenWriteFileOptions& options,
+        int64_t fileSize,
+        const Azure::Core::Context& context);
+
+    std::unique_ptr<State> m_state;
+
+    friend class DataLakeFileClient;
+  };
+
+}}}} // namespace Azure::Storage::Files::DataLake
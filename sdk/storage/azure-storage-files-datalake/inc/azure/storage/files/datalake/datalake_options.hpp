@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,6 +43,32 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
      * API version used by this client.
      */
     std::string ApiVersion = _detail::DefaultServiceApiVersion;
+
+    /**
+     * @brief The executor on which the chunks of concurrent uploads and downloads are
+     * transferred. If null, the default executor shared by all the clients is used.
+     */
+    std::shared_ptr<Azure::Storage::TransferExecutor> TransferExecutor;
+
+    /**
+     * @brief The pool of the buffers through which the chunks of concurrent uploads and downloads
+     * are transferred, which limits their memory. If null, the default pool shared by all the
+     * clients is used.
+     */
+    std::shared_ptr<Azure::Storage::BufferPool> BufferPool;
+
+    /**
+     * @brief Limits the bandwidth and the rate of the requests of the client. The same limiter
+     * can be shared by several clients. If null, there is no limit.
+     */
+    std::shared_ptr<Azure::Storage::RateLimiter> RateLimiter;
+
+    /**
+     * @brief Limits the number of requests of the client in flight to each account, adjusting
+     * the limits when the accounts throttle the requests. The same controller can be shared by
+     * several clients. If null, the requests in flight aren't limited.
+     */
+    std::shared_ptr<Azure::Storage::CongestionController> CongestionController;
   };
 
   /**
@@ -180,6 +207,37 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     Azure::Nullable<int32_t> PageSizeHint;
   };
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::DataLake::DataLakeFileSystemClient::ListPathsConcurrently.
+   */
+  struct ListPathsConcurrentlyOptions final
+  {
+    /**
+     * If true, the directories at the root of the file system are listed as partitions of their
+     * own, at the same time. Otherwise the whole file system is listed as a single partition.
+     */
+    bool PartitionByTopLevelDirectories = true;
+
+    /**
+     * The maximum number of partitions listed at the same time.
+     */
+    int32_t Concurrency = 8;
+
+    /**
+     * Valid only when Hierarchical Namespace is enabled for the account. If "true", the user
+     * identity values returned in the owner and group fields of each list entry will be transformed
+     * from Azure Active Directory Object IDs to User Principal Names.
+     */
+    Azure::Nullable<bool> UserPrincipalName;
+
+    /**
+     * An optional value that specifies the maximum number of items to return in each page. If
+     * omitted or greater than 5,000, each page will include up to 5,000 items.
+     */
+    Azure::Nullable<int32_t> PageSizeHint;
+  };
+
   /**
    * @brief Optional parameters for
    * #Azure::Storage::Files::DataLake::FileSystemClient::GetAccessPolicy.
@@ -241,6 +299,24 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     PathAccessConditions SourceAccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::DataLake::DataLakeFileSystemClient::RenamePaths.
+   */
+  struct RenamePathsOptions final
+  {
+    /**
+     * If not specified, the source's file system is used. Otherwise, rename to destination file
+     * system.
+     */
+    Azure::Nullable<std::string> DestinationFileSystem;
+
+    /**
+     * The maximum number of paths renamed at the same time.
+     */
+    int32_t Concurrency = 8;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Files::DataLake::PathClient::Append.
    */
@@ -567,6 +643,42 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
 
   using RemovePathAccessControlListRecursiveOptions = SetPathAccessControlListRecursiveOptions;
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::DataLake::DataLakeDirectoryClient::SetAccessControlListRecursiveConcurrently.
+   */
+  struct SetPathAccessControlListRecursiveConcurrentlyOptions final
+  {
+    /**
+     * The maximum number of paths changed by a single request. If omitted or greater than 2,000, a
+     * request changes up to 2,000 paths.
+     */
+    Azure::Nullable<int32_t> BatchSize;
+
+    /**
+     * If true, the paths which fail to be changed are reported and skipped. Otherwise the
+     * operation stops after the first batch with a failure.
+     */
+    bool ContinueOnFailure = false;
+
+    /**
+     * The maximum number of subtrees changed at the same time.
+     */
+    int32_t Concurrency = 8;
+
+    /**
+     * Called after every batch with the number of directories and files it changed and the paths
+     * it failed to change. The calls are serialized.
+     */
+    std::function<void(int32_t, int32_t, const std::vector<Models::AclFailedEntry>&)>
+        ProgressHandler;
+  };
+
+  using UpdatePathAccessControlListRecursiveConcurrentlyOptions
+      = SetPathAccessControlListRecursiveConcurrentlyOptions;
+  using RemovePathAccessControlListRecursiveConcurrentlyOptions
+      = SetPathAccessControlListRecursiveConcurrentlyOptions;
+
   using CreateFileOptions = CreatePathOptions;
   using CreateDirectoryOptions = CreatePathOptions;
 
@@ -585,6 +697,20 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
      */
     Storage::Metadata Metadata;
 
+    /**
+     * If true, the file is uploaded to the dfs endpoint instead of as a block blob to the blob
+     * endpoint: it's created, its chunks are appended at their offsets concurrently, then they're
+     * flushed with a single Flush. Only the ETag, the LastModified and IsServerEncrypted of the
+     * result are set.
+     */
+    bool UseDfsEndpoint = false;
+
+    /**
+     * If true, the final Flush of an upload to the dfs endpoint closes the file stream, which
+     * raises a file closed event. Ignored when uploading to the blob endpoint.
+     */
+    Azure::Nullable<bool> Close;
+
     /**
      * Options for parallel transfer.
      */
@@ -606,9 +732,82 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
        * The maximum number of threads that may be used in a parallel transfer.
        */
       int32_t Concurrency = 5;
+
+      /**
+       * If true, the chunk size and the concurrency are tuned while the file is uploaded from the
+       * measured throughput, between 1 MiB and ChunkSize, or 64 MiB if ChunkSize isn't set, and
+       * between 1 and Concurrency. They start small and grow until the throughput stops
+       * improving, and shrink when it drops.
+       */
+      bool AutoTune = false;
+
+      /**
+       * If true, the file uploaded by `UploadFrom(fileName)` is mapped in memory and the data is
+       * sent from the mapped pages, instead of being read through a buffer. Ignored if the file
+       * can't be mapped.
+       */
+      bool MemoryMapFile = false;
+
+      /**
+       * If true, the file uploaded by `UploadFrom(fileName)` is read bypassing the page cache of
+       * the operating system where the file system supports it, so that large uploads don't evict
+       * other data from the cache. Takes precedence over MemoryMapFile.
+       */
+      bool UnbufferedIo = false;
+
+      /**
+       * If true, the CRC64 of every chunk appended by an upload to the dfs endpoint is computed
+       * and sent with it, and checked by the service. Ignored when uploading to the blob endpoint.
+       */
+      bool ValidateContentCrc64 = false;
     } TransferOptions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Files::DataLake::DataLakeFileClient::OpenWrite.
+   */
+  struct OpenWriteFileOptions final
+  {
+    /**
+     * If true, the file is created, replacing any existing file, and the writer writes from its
+     * beginning. Otherwise the writer appends to the end of the existing file.
+     */
+    bool Overwrite = false;
+
+    /**
+     * Specify the http headers set on the file when the writer creates it and flushes its data.
+     */
+    Models::PathHttpHeaders HttpHeaders;
+
+    /**
+     * Specify the lease access conditions of every append and flush of the writer.
+     */
+    LeaseAccessConditions AccessConditions;
+
+    /**
+     * The maximum number of bytes appended by a single request. This value cannot be larger than
+     * 4000 MiB.
+     */
+    int64_t BufferSize = 4 * 1024 * 1024;
+
+    /**
+     * The maximum number of appends in flight at the same time.
+     */
+    int32_t MaxConcurrency = 4;
+
+    /**
+     * The time after which the data written is appended and flushed even if it doesn't fill a
+     * buffer.
+     */
+    std::chrono::milliseconds FlushInterval = std::chrono::seconds(1);
+
+    /**
+     * The maximum number of bytes written which aren't appended yet. Writes wait while the writer
+     * buffers this many bytes.
+     */
+    int64_t MaxBufferedSize = 32 * 1024 * 1024;
+  };
+
   using ScheduleFileExpiryOriginType = Blobs::Models::ScheduleBlobExpiryOriginType;
 
   /**
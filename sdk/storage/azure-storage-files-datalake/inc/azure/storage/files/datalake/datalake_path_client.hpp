@@ -314,6 +314,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         const Azure::Core::Context& context) const;
 
     friend class DataLakeFileSystemClient;
+    friend class DataLakeDirectoryClient;
     friend class DataLakeLeaseClient;
   };
 }}}} // namespace Azure::Storage::Files::DataLake
@@ -179,6 +179,69 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       DateTime LastModified;
     };
 
+    /**
+     * @brief A path to rename, and where to.
+     */
+    struct RenamePathItem final
+    {
+      /**
+       * The path renamed, in the file system.
+       */
+      std::string SourcePath;
+
+      /**
+       * The path the source path is renamed to, in the destination file system.
+       */
+      std::string DestinationPath;
+    };
+
+    /**
+     * @brief The outcome of the rename of one path.
+     */
+    struct RenamePathOutcome final
+    {
+      /**
+       * If the path is renamed.
+       */
+      bool Renamed = false;
+
+      /**
+       * The HTTP status code of the failed rename, or of its last attempt.
+       */
+      Azure::Core::Http::HttpStatusCode StatusCode = Azure::Core::Http::HttpStatusCode::None;
+
+      /**
+       * The error code of the failed rename.
+       */
+      std::string ErrorCode;
+
+      /**
+       * The error message of the failed rename.
+       */
+      std::string ErrorMessage;
+    };
+
+    /**
+     * @brief The information returned when renaming paths concurrently.
+     */
+    struct RenamePathsResult final
+    {
+      /**
+       * The outcome of the rename of every path, in the order of the paths.
+       */
+      std::vector<RenamePathOutcome> Outcomes;
+
+      /**
+       * Number of paths renamed successfully.
+       */
+      int64_t NumberOfSuccessfulRenames = 0;
+
+      /**
+       * Number of paths that failed to be renamed.
+       */
+      int64_t NumberOfFailures = 0;
+    };
+
     // PathClient models:
 
     /**
@@ -663,6 +726,38 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     using CreateDirectoryResult = CreatePathResult;
     using DeleteDirectoryResult = DeletePathResult;
 
+    /**
+     * @brief The information returned when changing the access control list of a directory tree
+     * concurrently.
+     */
+    struct SetPathAccessControlListRecursiveConcurrentlyResult final
+    {
+      /**
+       * Number of directories where Access Control List has been updated successfully.
+       */
+      int64_t NumberOfSuccessfulDirectories = 0;
+
+      /**
+       * Number of files where Access Control List has been updated successfully.
+       */
+      int64_t NumberOfSuccessfulFiles = 0;
+
+      /**
+       * Number of paths where Access Control List update has failed.
+       */
+      int64_t NumberOfFailures = 0;
+
+      /**
+       * The paths where Access Control List update has failed.
+       */
+      std::vector<AclFailedEntry> FailedEntries;
+    };
+
+    using UpdatePathAccessControlListRecursiveConcurrentlyResult
+        = SetPathAccessControlListRecursiveConcurrentlyResult;
+    using RemovePathAccessControlListRecursiveConcurrentlyResult
+        = SetPathAccessControlListRecursiveConcurrentlyResult;
+
   } // namespace Models
 
   /**
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <type_traits>
 
@@ -12,8 +13,16 @@
 
 #include "azure/storage/files/datalake/datalake_responses.hpp"
 
+namespace Azure { namespace Storage {
+  namespace _internal {
+    class SasTokenTemplate;
+  } // namespace _internal
+}} // namespace Azure::Storage
+
 namespace Azure { namespace Storage { namespace Sas {
 
+  class DataLakeSasTokenGenerator;
+
   /**
    * @brief Specifies which resources are accessible via the shared access signature.
    */
@@ -337,7 +346,55 @@ namespace Azure { namespace Storage { namespace Sas {
         const std::string& accountName);
 
   private:
+    friend class DataLakeSasTokenGenerator;
     std::string Permissions;
   };
 
+  /**
+   * @brief DataLakeSasTokenGenerator is used to generate the Shared Access Signatures (SAS) of
+   * many paths of a file system, which only differ by the path.
+   *
+   * @details The parts of the SAS which are the same for all the paths, such as the permissions
+   * and the expiry, are formatted and signed once when the generator is constructed, so
+   * generating the SAS of a path only signs the path. The tokens are the same as the ones of
+   * DataLakeSasBuilder with the path.
+   */
+  class DataLakeSasTokenGenerator final {
+  public:
+    /**
+     * @brief Constructs a generator signing the SAS with a StorageSharedKeyCredential.
+     *
+     * @param builder The properties of the SAS. Its resource must be a file. Its path is ignored.
+     * @param credential The storage account's shared key credential.
+     */
+    explicit DataLakeSasTokenGenerator(
+        const DataLakeSasBuilder& builder,
+        const StorageSharedKeyCredential& credential);
+
+    /**
+     * @brief Constructs a generator signing the SAS with an account's user delegation key.
+     *
+     * @param builder The properties of the SAS. Its resource must be a file or a directory. Its
+     * path is ignored.
+     * @param userDelegationKey UserDelegationKey returned from
+     * BlobServiceClient.GetUserDelegationKey.
+     * @param accountName The name of the storage account.
+     */
+    explicit DataLakeSasTokenGenerator(
+        const DataLakeSasBuilder& builder,
+        const Files::DataLake::Models::UserDelegationKey& userDelegationKey,
+        const std::string& accountName);
+
+    /**
+     * @brief Generates the SAS of a path. Can be called concurrently.
+     *
+     * @param path The path of the file or directory being made accessible.
+     * @return The SAS query parameters used for authenticating requests.
+     */
+    std::string GenerateSasToken(const std::string& path) const;
+
+  private:
+    std::shared_ptr<const _internal::SasTokenTemplate> m_template;
+  };
+
 }}} // namespace Azure::Storage::Sas
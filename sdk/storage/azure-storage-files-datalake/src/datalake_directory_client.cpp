@@ -3,8 +3,13 @@
 
 #include "azure/storage/files/datalake/datalake_directory_client.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
 #include <azure/storage/common/internal/constants.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
@@ -15,6 +20,44 @@
 
 namespace Azure { namespace Storage { namespace Files { namespace DataLake {
 
+  namespace {
+    // Applies the change of a recursive mode to the access control list of a single path, the
+    // entries are identified by their scope, type and id.
+    std::vector<Models::Acl> ChangeAcls(
+        _detail::PathSetAccessControlRecursiveMode mode,
+        std::vector<Models::Acl> currentAcls,
+        const std::vector<Models::Acl>& acls)
+    {
+      if (mode == _detail::PathSetAccessControlRecursiveMode::Set)
+      {
+        return acls;
+      }
+      for (const auto& acl : acls)
+      {
+        auto currentAcl
+            = std::find_if(currentAcls.begin(), currentAcls.end(), [&](const Models::Acl& other) {
+                return other.Scope == acl.Scope && other.Type == acl.Type && other.Id == acl.Id;
+              });
+        if (mode == _detail::PathSetAccessControlRecursiveMode::Remove)
+        {
+          if (currentAcl != currentAcls.end())
+          {
+            currentAcls.erase(currentAcl);
+          }
+        }
+        else if (currentAcl != currentAcls.end())
+        {
+          currentAcl->Permissions = acl.Permissions;
+        }
+        else
+        {
+          currentAcls.push_back(acl);
+        }
+      }
+      return currentAcls;
+    }
+  } // namespace
+
   DataLakeDirectoryClient DataLakeDirectoryClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& fileSystemName,
@@ -226,8 +269,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     fileSystemUrl.SetPath(fileSystemName);
 
     auto clientCopy = *this;
-    std::function<ListPathsPagedResponse(std::string, const Azure::Core::Context&)> func;
-    func = [func, clientCopy, protocolLayerOptions, fileSystemUrl](
+    std::function<ListPathsPagedResponse(std::string, const Azure::Core::Context&)> func = [clientCopy, protocolLayerOptions, fileSystemUrl](
                std::string continuationToken, const Azure::Core::Context& context) {
       auto protocolLayerOptionsCopy = protocolLayerOptions;
       if (!continuationToken.empty())
@@ -243,15 +285,155 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       ListPathsPagedResponse pagedResponse;
 
       pagedResponse.Paths = std::move(response.Value.Items);
-      pagedResponse.m_onNextPageFunc = func;
       pagedResponse.CurrentPageToken = continuationToken;
-      pagedResponse.NextPageToken = response.Value.ContinuationToken;
+      pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
       pagedResponse.RawResponse = std::move(response.RawResponse);
 
       return pagedResponse;
     };
 
-    return func(options.ContinuationToken.ValueOr(std::string()), context);
+    // The next pages are fetched with the same function, kept by ListPathsPagedResponse.
+    auto pagedResponse = func(options.ContinuationToken.ValueOr(std::string()), context);
+    pagedResponse.m_onNextPageFunc = std::move(func);
+    return pagedResponse;
+  }
+
+  Azure::Response<Models::SetPathAccessControlListRecursiveConcurrentlyResult>
+  DataLakeDirectoryClient::ChangeAccessControlListRecursiveConcurrently(
+      _detail::PathSetAccessControlRecursiveMode mode,
+      const std::vector<Models::Acl>& acls,
+      const SetPathAccessControlListRecursiveConcurrentlyOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    Models::SetPathAccessControlListRecursiveConcurrentlyResult ret;
+    std::unique_ptr<Azure::Core::Http::RawResponse> lastResponse;
+    std::mutex resultMutex;
+    std::atomic<bool> failed{false};
+
+    auto reportBatch = [&](int32_t successfulDirectories,
+                           int32_t successfulFiles,
+                           int32_t failures,
+                           std::vector<Models::AclFailedEntry> failedEntries,
+                           std::unique_ptr<Azure::Core::Http::RawResponse> response) {
+      std::lock_guard<std::mutex> guard(resultMutex);
+      ret.NumberOfSuccessfulDirectories += successfulDirectories;
+      ret.NumberOfSuccessfulFiles += successfulFiles;
+      ret.NumberOfFailures += failures;
+      if (options.ProgressHandler)
+      {
+        options.ProgressHandler(successfulDirectories, successfulFiles, failedEntries);
+      }
+      ret.FailedEntries.insert(
+          ret.FailedEntries.end(),
+          std::make_move_iterator(failedEntries.begin()),
+          std::make_move_iterator(failedEntries.end()));
+      lastResponse = std::move(response);
+      if (failures > 0 && !options.ContinueOnFailure)
+      {
+        failed = true;
+      }
+    };
+
+    // Changes a path and all the paths under it by batches, following the continuation tokens
+    // until they're all changed or a batch failed.
+    SetPathAccessControlListRecursiveOptions batchOptions;
+    batchOptions.PageSizeHint = options.BatchSize;
+    batchOptions.ContinueOnFailure = options.ContinueOnFailure;
+    auto changeSubtree = [&](const DataLakePathClient& pathClient) {
+      for (auto page
+           = pathClient.SetAccessControlListRecursiveInternal(mode, acls, batchOptions, context);
+           page.HasPage() && !failed;
+           page.MoveToNextPage(context))
+      {
+        reportBatch(
+            page.NumberOfSuccessfulDirectories,
+            page.NumberOfSuccessfulFiles,
+            page.NumberOfFailures,
+            std::move(page.FailedEntries),
+            std::move(page.RawResponse));
+      }
+    };
+
+    // The names of the paths listed are relative to the file system.
+    std::vector<std::string> subdirectoryNames;
+    std::vector<std::string> fileNames;
+    for (auto page = ListPaths(false, ListPathsOptions(), context); page.HasPage();
+         page.MoveToNextPage(context))
+    {
+      for (auto& path : page.Paths)
+      {
+        std::string name = path.Name.substr(path.Name.rfind('/') + 1);
+        (path.IsDirectory ? subdirectoryNames : fileNames).push_back(std::move(name));
+      }
+    }
+
+    if (subdirectoryNames.empty())
+    {
+      // Without subtrees to change concurrently, the directory is changed by batches at once.
+      changeSubtree(*this);
+      return Azure::Response<Models::SetPathAccessControlListRecursiveConcurrentlyResult>(
+          std::move(ret), std::move(lastResponse));
+    }
+
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.Concurrency;
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(subdirectoryNames.size() + fileNames.size()),
+        transferOptions,
+        [&](int64_t pathIndex, int64_t, int64_t) {
+          if (failed)
+          {
+            return;
+          }
+          const auto index = static_cast<size_t>(pathIndex);
+          if (index < subdirectoryNames.size())
+          {
+            changeSubtree(GetSubdirectoryClient(subdirectoryNames[index]));
+          }
+          else
+          {
+            changeSubtree(GetFileClient(fileNames[index - subdirectoryNames.size()]));
+          }
+        },
+        m_blobClient.m_transferExecutor);
+    if (failed)
+    {
+      return Azure::Response<Models::SetPathAccessControlListRecursiveConcurrentlyResult>(
+          std::move(ret), std::move(lastResponse));
+    }
+
+    // The recursive mode would change the whole tree again, the directory itself is changed alone.
+    try
+    {
+      std::vector<Models::Acl> directoryAcls = acls;
+      if (mode != _detail::PathSetAccessControlRecursiveMode::Set)
+      {
+        directoryAcls = ChangeAcls(
+            mode,
+            GetAccessControlList(GetPathAccessControlListOptions(), context).Value.Acls,
+            acls);
+      }
+      auto response = SetAccessControlList(
+          std::move(directoryAcls), SetPathAccessControlListOptions(), context);
+      reportBatch(1, 0, 0, std::vector<Models::AclFailedEntry>(), std::move(response.RawResponse));
+    }
+    catch (StorageException& e)
+    {
+      if (!options.ContinueOnFailure)
+      {
+        throw;
+      }
+      const std::string currentPath = m_pathUrl.GetPath();
+      std::vector<Models::AclFailedEntry> failedEntries(1);
+      failedEntries[0].Name = currentPath.substr(currentPath.find('/') + 1);
+      failedEntries[0].Type = "DIRECTORY";
+      failedEntries[0].ErrorMessage = e.Message;
+      reportBatch(0, 0, 1, std::move(failedEntries), std::move(e.RawResponse));
+    }
+    return Azure::Response<Models::SetPathAccessControlListRecursiveConcurrentlyResult>(
+        std::move(ret), std::move(lastResponse));
   }
 
 }}}} // namespace Azure::Storage::Files::DataLake
@@ -3,9 +3,15 @@
 
 #include "azure/storage/files/datalake/datalake_file_client.hpp"
 
+#include <atomic>
+#include <functional>
+
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
 #include <azure/storage/common/internal/constants.hpp>
+#include <azure/storage/common/internal/file_io.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
@@ -75,6 +81,85 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       }
       return Models::LeaseStatus();
     }
+
+    // Uploads a file to the dfs endpoint: creates it, appends its chunks at their offsets
+    // concurrently with appendChunk, which returns whether the chunk is encrypted, then flushes
+    // them all at once.
+    Azure::Response<Models::UploadFileFromResult> UploadAppendedChunks(
+        const DataLakeFileClient& client,
+        int64_t fileSize,
+        const UploadFileFromOptions& options,
+        const std::function<bool(int64_t, int64_t)>& appendChunk,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      constexpr int64_t DefaultAppendSize = 4 * 1024 * 1024;
+      constexpr int64_t DefaultAutoTuneMaxAppendSize = 64 * 1024 * 1024;
+      constexpr int64_t MaxAppendSize = 4000 * 1024 * 1024LL;
+
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = options.TransferOptions.ChunkSize.HasValue()
+          ? options.TransferOptions.ChunkSize.Value()
+          : options.TransferOptions.AutoTune ? DefaultAutoTuneMaxAppendSize
+                                             : DefaultAppendSize;
+      transferOptions.Concurrency = options.TransferOptions.Concurrency;
+      transferOptions.AutoTune = options.TransferOptions.AutoTune;
+      if (fileSize < options.TransferOptions.SingleUploadThreshold)
+      {
+        transferOptions.ChunkSize = fileSize;
+        transferOptions.AutoTune = false;
+      }
+      if (transferOptions.ChunkSize > MaxAppendSize)
+      {
+        throw Azure::Core::RequestFailedException("Append size is too big.");
+      }
+
+      CreateFileOptions createOptions;
+      createOptions.HttpHeaders = options.HttpHeaders;
+      createOptions.Metadata = options.Metadata;
+      client.Create(createOptions, context);
+
+      std::atomic<bool> isServerEncrypted{false};
+      _internal::ConcurrentTransfer(
+          0,
+          fileSize,
+          transferOptions,
+          [&](int64_t offset, int64_t length, int64_t) {
+            if (appendChunk(offset, length))
+            {
+              isServerEncrypted = true;
+            }
+          },
+          transferExecutor);
+
+      // The headers set when the file was created are cleared by a flush without them.
+      FlushFileOptions flushOptions;
+      flushOptions.HttpHeaders = options.HttpHeaders;
+      flushOptions.Close = options.Close;
+      auto flushResponse = client.Flush(fileSize, flushOptions, context);
+
+      Models::UploadFileFromResult ret;
+      ret.ETag = std::move(flushResponse.Value.ETag);
+      ret.LastModified = std::move(flushResponse.Value.LastModified);
+      ret.IsServerEncrypted = isServerEncrypted;
+      return Azure::Response<Models::UploadFileFromResult>(
+          std::move(ret), std::move(flushResponse.RawResponse));
+    }
+
+    Azure::Nullable<ContentHash> GetAppendContentHash(
+        const uint8_t* data,
+        int64_t length,
+        const UploadFileFromOptions& options)
+    {
+      if (!options.TransferOptions.ValidateContentCrc64)
+      {
+        return Azure::Nullable<ContentHash>();
+      }
+      ContentHash hash;
+      hash.Algorithm = HashAlgorithm::Crc64;
+      hash.Value = Crc64Hash().Final(data, static_cast<size_t>(length));
+      return hash;
+    }
   } // namespace
 
   DataLakeFileClient DataLakeFileClient::CreateFromConnectionString(
@@ -259,14 +344,70 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       const UploadFileFromOptions& options,
       const Azure::Core::Context& context) const
   {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    if (options.UseDfsEndpoint)
+    {
+      _internal::FileReader fileReader(
+          fileName,
+          options.TransferOptions.UnbufferedIo        ? _internal::FileIoMode::Unbuffered
+              : options.TransferOptions.MemoryMapFile ? _internal::FileIoMode::MemoryMapped
+                                                      : _internal::FileIoMode::Buffered);
+      const uint8_t* mappedData = fileReader.GetMappedData();
+      const auto& bufferPool = m_blobClient.m_bufferPool;
+      auto appendChunk = [&](int64_t offset, int64_t length) {
+        std::unique_ptr<Azure::Core::IO::BodyStream> contentStream;
+        AppendFileOptions appendOptions;
+        // The chunk is read in memory to hash it before it's appended, unless the file is mapped.
+        _internal::PooledBuffer chunkBuffer;
+        const uint8_t* chunkData = mappedData != nullptr ? mappedData + offset : nullptr;
+        if (chunkData == nullptr && options.TransferOptions.ValidateContentCrc64)
+        {
+          chunkBuffer = _internal::PooledBuffer(
+              bufferPool, static_cast<size_t>(length), bulkContext);
+          Azure::Core::IO::_internal::RandomAccessFileBodyStream(
+              fileReader.GetHandle(), offset, length)
+              .ReadToCount(chunkBuffer.Data(), static_cast<size_t>(length), bulkContext);
+          chunkData = chunkBuffer.Data();
+        }
+        if (chunkData != nullptr)
+        {
+          appendOptions.TransactionalContentHash
+              = GetAppendContentHash(chunkData, length, options);
+          contentStream = std::make_unique<Azure::Core::IO::MemoryBodyStream>(
+              chunkData, static_cast<size_t>(length));
+        }
+        else if (fileReader.IsUnbuffered())
+        {
+          contentStream = std::make_unique<_internal::UnbufferedFileBodyStream>(
+              fileReader, offset, length, bufferPool);
+        }
+        else
+        {
+          contentStream = std::make_unique<Azure::Core::IO::_internal::RandomAccessFileBodyStream>(
+              fileReader.GetHandle(), offset, length);
+        }
+        return Append(*contentStream, offset, appendOptions, bulkContext).Value.IsServerEncrypted;
+      };
+      return UploadAppendedChunks(
+          *this,
+          fileReader.GetFileSize(),
+          options,
+          appendChunk,
+          m_blobClient.m_transferExecutor,
+          bulkContext);
+    }
+
     Blobs::UploadBlockBlobFromOptions blobOptions;
     blobOptions.TransferOptions.SingleUploadThreshold
         = options.TransferOptions.SingleUploadThreshold;
     blobOptions.TransferOptions.ChunkSize = options.TransferOptions.ChunkSize;
     blobOptions.TransferOptions.Concurrency = options.TransferOptions.Concurrency;
+    blobOptions.TransferOptions.AutoTune = options.TransferOptions.AutoTune;
+    blobOptions.TransferOptions.MemoryMapFile = options.TransferOptions.MemoryMapFile;
+    blobOptions.TransferOptions.UnbufferedIo = options.TransferOptions.UnbufferedIo;
     blobOptions.HttpHeaders = FromPathHttpHeaders(options.HttpHeaders);
     blobOptions.Metadata = options.Metadata;
-    return m_blobClient.AsBlockBlobClient().UploadFrom(fileName, blobOptions, context);
+    return m_blobClient.AsBlockBlobClient().UploadFrom(fileName, blobOptions, bulkContext);
   }
 
   Azure::Response<Models::UploadFileFromResult> DataLakeFileClient::UploadFrom(
@@ -275,14 +416,36 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       const UploadFileFromOptions& options,
       const Azure::Core::Context& context) const
   {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    if (options.UseDfsEndpoint)
+    {
+      auto appendChunk = [&](int64_t offset, int64_t length) {
+        AppendFileOptions appendOptions;
+        appendOptions.TransactionalContentHash
+            = GetAppendContentHash(buffer + offset, length, options);
+        Azure::Core::IO::MemoryBodyStream contentStream(
+            buffer + offset, static_cast<size_t>(length));
+        return Append(contentStream, offset, appendOptions, bulkContext).Value.IsServerEncrypted;
+      };
+      return UploadAppendedChunks(
+          *this,
+          static_cast<int64_t>(bufferSize),
+          options,
+          appendChunk,
+          m_blobClient.m_transferExecutor,
+          bulkContext);
+    }
+
     Blobs::UploadBlockBlobFromOptions blobOptions;
     blobOptions.TransferOptions.SingleUploadThreshold
         = options.TransferOptions.SingleUploadThreshold;
     blobOptions.TransferOptions.ChunkSize = options.TransferOptions.ChunkSize;
     blobOptions.TransferOptions.Concurrency = options.TransferOptions.Concurrency;
+    blobOptions.TransferOptions.AutoTune = options.TransferOptions.AutoTune;
     blobOptions.HttpHeaders = FromPathHttpHeaders(options.HttpHeaders);
     blobOptions.Metadata = options.Metadata;
-    return m_blobClient.AsBlockBlobClient().UploadFrom(buffer, bufferSize, blobOptions, context);
+    return m_blobClient.AsBlockBlobClient().UploadFrom(
+        buffer, bufferSize, blobOptions, bulkContext);
   }
 
   Azure::Response<Models::DownloadFileToResult> DataLakeFileClient::DownloadTo(
@@ -370,6 +533,39 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         std::move(ret), std::move(result.RawResponse));
   }
 
+  std::unique_ptr<DataLakeFileWriter> DataLakeFileClient::OpenWrite(
+      const OpenWriteFileOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    constexpr int64_t MaxAppendSize = 4000 * 1024 * 1024LL;
+    if (options.BufferSize <= 0 || options.BufferSize > MaxAppendSize)
+    {
+      throw Azure::Core::RequestFailedException(
+          "Buffer size must be positive and cannot be larger than 4000 MiB.");
+    }
+    if (options.MaxConcurrency <= 0)
+    {
+      throw Azure::Core::RequestFailedException("Concurrency must be positive.");
+    }
+
+    int64_t fileSize = 0;
+    if (options.Overwrite)
+    {
+      CreateFileOptions createOptions;
+      createOptions.HttpHeaders = options.HttpHeaders;
+      createOptions.AccessConditions.LeaseId = options.AccessConditions.LeaseId;
+      Create(createOptions, context);
+    }
+    else
+    {
+      GetPathPropertiesOptions propertiesOptions;
+      propertiesOptions.AccessConditions.LeaseId = options.AccessConditions.LeaseId;
+      fileSize = GetProperties(propertiesOptions, context).Value.FileSize;
+    }
+    return std::unique_ptr<DataLakeFileWriter>(
+        new DataLakeFileWriter(*this, options, fileSize, context));
+  }
+
   Azure::Response<Models::ScheduleFileDeletionResult> DataLakeFileClient::ScheduleDeletion(
       ScheduleFileExpiryOriginType expiryOrigin,
       const ScheduleFileDeletionOptions& options,
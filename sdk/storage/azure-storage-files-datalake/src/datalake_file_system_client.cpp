@@ -6,10 +6,12 @@
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/storage/blobs/protocol/blob_rest_client.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
 #include <azure/storage/common/internal/constants.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
@@ -22,6 +24,40 @@
 
 namespace Azure { namespace Storage { namespace Files { namespace DataLake {
 
+  namespace {
+    Blobs::CreateBlobContainerOptions GetBlobCreateOptions(const CreateFileSystemOptions& options)
+    {
+      Blobs::CreateBlobContainerOptions blobOptions;
+      blobOptions.Metadata = options.Metadata;
+      if (options.AccessType == Models::PublicAccessType::FileSystem)
+      {
+        blobOptions.AccessType = Blobs::Models::PublicAccessType::BlobContainer;
+      }
+      else if (options.AccessType == Models::PublicAccessType::Path)
+      {
+        blobOptions.AccessType = Blobs::Models::PublicAccessType::Blob;
+      }
+      else if (options.AccessType == Models::PublicAccessType::None)
+      {
+        blobOptions.AccessType = Blobs::Models::PublicAccessType::None;
+      }
+      else
+      {
+        blobOptions.AccessType = Blobs::Models::PublicAccessType(options.AccessType.ToString());
+      }
+      return blobOptions;
+    }
+
+    Blobs::DeleteBlobContainerOptions GetBlobDeleteOptions(const DeleteFileSystemOptions& options)
+    {
+      Blobs::DeleteBlobContainerOptions blobOptions;
+      blobOptions.AccessConditions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
+      blobOptions.AccessConditions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
+      blobOptions.AccessConditions.LeaseId = options.AccessConditions.LeaseId;
+      return blobOptions;
+    }
+  } // namespace
+
   DataLakeFileSystemClient DataLakeFileSystemClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& fileSystemName,
@@ -60,15 +96,24 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
         m_fileSystemUrl.GetHost(), newOptions.SecondaryHostForRetryReads));
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::DatalakeServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, newOptions.ApiVersion}});
   }
 
   DataLakeFileSystemClient::DataLakeFileSystemClient(
@@ -84,6 +129,16 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
         m_fileSystemUrl.GetHost(), options.SecondaryHostForRetryReads));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
     {
       Azure::Core::Credentials::TokenRequestContext tokenContext;
@@ -92,14 +147,13 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
           std::make_unique<Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
               credential, tokenContext));
     }
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::DatalakeServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   DataLakeFileSystemClient::DataLakeFileSystemClient(
@@ -113,15 +167,24 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
         m_fileSystemUrl.GetHost(), options.SecondaryHostForRetryReads));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::DatalakeServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   DataLakeFileClient DataLakeFileSystemClient::GetFileClient(const std::string& fileName) const
@@ -145,25 +208,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       const CreateFileSystemOptions& options,
       const Azure::Core::Context& context) const
   {
-    Blobs::CreateBlobContainerOptions blobOptions;
-    blobOptions.Metadata = options.Metadata;
-    if (options.AccessType == Models::PublicAccessType::FileSystem)
-    {
-      blobOptions.AccessType = Blobs::Models::PublicAccessType::BlobContainer;
-    }
-    else if (options.AccessType == Models::PublicAccessType::Path)
-    {
-      blobOptions.AccessType = Blobs::Models::PublicAccessType::Blob;
-    }
-    else if (options.AccessType == Models::PublicAccessType::None)
-    {
-      blobOptions.AccessType = Blobs::Models::PublicAccessType::None;
-    }
-    else
-    {
-      blobOptions.AccessType = Blobs::Models::PublicAccessType(options.AccessType.ToString());
-    }
-    auto result = m_blobContainerClient.Create(blobOptions, context);
+    auto result = m_blobContainerClient.Create(GetBlobCreateOptions(options), context);
     Models::CreateFileSystemResult ret;
     ret.ETag = std::move(result.Value.ETag);
     ret.LastModified = std::move(result.Value.LastModified);
@@ -176,32 +221,21 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       const CreateFileSystemOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
-    {
-      return Create(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.ErrorCode == _detail::ContainerAlreadyExists)
-      {
-        Models::CreateFileSystemResult ret;
-        ret.Created = false;
-        return Azure::Response<Models::CreateFileSystemResult>(
-            std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
-    }
+    auto result
+        = m_blobContainerClient.CreateIfNotExists(GetBlobCreateOptions(options), context);
+    Models::CreateFileSystemResult ret;
+    ret.ETag = std::move(result.Value.ETag);
+    ret.LastModified = std::move(result.Value.LastModified);
+    ret.Created = result.Value.Created;
+    return Azure::Response<Models::CreateFileSystemResult>(
+        std::move(ret), std::move(result.RawResponse));
   }
 
   Azure::Response<Models::DeleteFileSystemResult> DataLakeFileSystemClient::Delete(
       const DeleteFileSystemOptions& options,
       const Azure::Core::Context& context) const
   {
-    Blobs::DeleteBlobContainerOptions blobOptions;
-    blobOptions.AccessConditions.IfModifiedSince = options.AccessConditions.IfModifiedSince;
-    blobOptions.AccessConditions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
-    blobOptions.AccessConditions.LeaseId = options.AccessConditions.LeaseId;
-    auto result = m_blobContainerClient.Delete(blobOptions, context);
+    auto result = m_blobContainerClient.Delete(GetBlobDeleteOptions(options), context);
     Models::DeleteFileSystemResult ret;
     ret.Deleted = true;
     return Azure::Response<Models::DeleteFileSystemResult>(
@@ -212,20 +246,11 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       const DeleteFileSystemOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
-    {
-      return Delete(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.ErrorCode == _detail::ContainerNotFound)
-      {
-        Models::DeleteFileSystemResult ret;
-        ret.Deleted = false;
-        return Azure::Response<Models::DeleteFileSystemResult>(ret, std::move(e.RawResponse));
-      }
-      throw;
-    }
+    auto result = m_blobContainerClient.DeleteIfExists(GetBlobDeleteOptions(options), context);
+    Models::DeleteFileSystemResult ret;
+    ret.Deleted = result.Value.Deleted;
+    return Azure::Response<Models::DeleteFileSystemResult>(
+        std::move(ret), std::move(result.RawResponse));
   }
 
   Azure::Response<Models::FileSystemProperties> DataLakeFileSystemClient::GetProperties(
@@ -271,8 +296,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     protocolLayerOptions.RecursiveRequired = recursive;
 
     auto clientCopy = *this;
-    std::function<ListPathsPagedResponse(std::string, const Azure::Core::Context&)> func;
-    func = [func, clientCopy, protocolLayerOptions](
+    std::function<ListPathsPagedResponse(std::string, const Azure::Core::Context&)> func = [clientCopy, protocolLayerOptions](
                std::string continuationToken, const Azure::Core::Context& context) {
       auto protocolLayerOptionsCopy = protocolLayerOptions;
       if (!continuationToken.empty())
@@ -287,15 +311,68 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
 
       ListPathsPagedResponse pagedResponse;
       pagedResponse.Paths = std::move(response.Value.Items);
-      pagedResponse.m_onNextPageFunc = func;
       pagedResponse.CurrentPageToken = continuationToken;
-      pagedResponse.NextPageToken = response.Value.ContinuationToken;
+      pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
       pagedResponse.RawResponse = std::move(response.RawResponse);
 
       return pagedResponse;
     };
 
-    return func(options.ContinuationToken.ValueOr(std::string()), context);
+    // The next pages are fetched with the same function, kept by ListPathsPagedResponse.
+    auto pagedResponse = func(options.ContinuationToken.ValueOr(std::string()), context);
+    pagedResponse.m_onNextPageFunc = std::move(func);
+    return pagedResponse;
+  }
+
+  void DataLakeFileSystemClient::ListPathsConcurrently(
+      const std::function<void(std::vector<Models::PathItem>)>& onPaths,
+      const ListPathsConcurrentlyOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    ListPathsOptions listOptions;
+    listOptions.UserPrincipalName = options.UserPrincipalName;
+    listOptions.PageSizeHint = options.PageSizeHint;
+
+    // The next page of a partition is fetched while the current one is processed.
+    auto listPartition = [&](ListPathsPagedResponse page) {
+      for (page.EnablePrefetch(context); page.HasPage(); page.MoveToNextPage(context))
+      {
+        onPaths(std::move(page.Paths));
+      }
+    };
+
+    if (!options.PartitionByTopLevelDirectories)
+    {
+      listPartition(ListPaths(true, listOptions, context));
+      return;
+    }
+
+    std::vector<std::string> directoryNames;
+    for (auto page = ListPaths(false, listOptions, context); page.HasPage();
+         page.MoveToNextPage(context))
+    {
+      for (const auto& path : page.Paths)
+      {
+        if (path.IsDirectory)
+        {
+          directoryNames.push_back(path.Name);
+        }
+      }
+      onPaths(std::move(page.Paths));
+    }
+
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.Concurrency;
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(directoryNames.size()),
+        transferOptions,
+        [&](int64_t directoryIndex, int64_t, int64_t) {
+          listPartition(GetDirectoryClient(directoryNames[static_cast<size_t>(directoryIndex)])
+                            .ListPaths(true, listOptions, context));
+        },
+        m_blobContainerClient.m_transferExecutor);
   }
 
   Azure::Response<Models::FileSystemAccessPolicy> DataLakeFileSystemClient::GetAccessPolicy(
@@ -458,4 +535,74 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         std::move(renamedDirectoryClient), std::move(result.RawResponse));
   }
 
+  Models::RenamePathsResult DataLakeFileSystemClient::RenamePaths(
+      const std::vector<Models::RenamePathItem>& paths,
+      const RenamePathsOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    std::string destinationFileSystem;
+    if (options.DestinationFileSystem.HasValue())
+    {
+      destinationFileSystem = options.DestinationFileSystem.Value();
+    }
+    else
+    {
+      const std::string& currentPath = m_fileSystemUrl.GetPath();
+      destinationFileSystem = currentPath.substr(0, currentPath.find('/'));
+    }
+
+    Models::RenamePathsResult ret;
+    ret.Outcomes.resize(paths.size());
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.Concurrency;
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(paths.size()),
+        transferOptions,
+        [&](int64_t pathIndex, int64_t, int64_t) {
+          const auto& path = paths[static_cast<size_t>(pathIndex)];
+          auto& outcome = ret.Outcomes[static_cast<size_t>(pathIndex)];
+
+          auto sourceDfsUrl = m_fileSystemUrl;
+          sourceDfsUrl.AppendPath(_internal::UrlEncodePath(path.SourcePath));
+
+          auto destinationDfsUrl = m_fileSystemUrl;
+          destinationDfsUrl.SetPath(_internal::UrlEncodePath(destinationFileSystem));
+          destinationDfsUrl.AppendPath(_internal::UrlEncodePath(path.DestinationPath));
+
+          _detail::DataLakeRestClient::Path::CreateOptions protocolLayerOptions;
+          protocolLayerOptions.Mode = _detail::PathRenameMode::Legacy;
+          protocolLayerOptions.RenameSource = "/" + sourceDfsUrl.GetPath();
+          // The failures are reported with the outcomes, the other paths are still renamed.
+          // Cancelling the context stops all the renames.
+          try
+          {
+            _detail::DataLakeRestClient::Path::Create(
+                destinationDfsUrl, *m_pipeline, context, protocolLayerOptions);
+            outcome.Renamed = true;
+          }
+          catch (const Azure::Core::RequestFailedException& e)
+          {
+            outcome.StatusCode = e.StatusCode;
+            outcome.ErrorCode = e.ErrorCode;
+            outcome.ErrorMessage = e.Message;
+          }
+        },
+        m_blobContainerClient.m_transferExecutor);
+
+    for (const auto& outcome : ret.Outcomes)
+    {
+      if (outcome.Renamed)
+      {
+        ++ret.NumberOfSuccessfulRenames;
+      }
+      else
+      {
+        ++ret.NumberOfFailures;
+      }
+    }
+    return ret;
+  }
+
 }}}} // namespace Azure::Storage::Files::DataLake
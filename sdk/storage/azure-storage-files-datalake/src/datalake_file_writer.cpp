@@ -0,0 +1,282 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/files/datalake/datalake_file_writer.hpp"
+
+#include <azure/core/io/body_stream.hpp>
+
+#include "azure/storage/files/datalake/datalake_file_client.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Files { namespace DataLake {
+
+  namespace {
+    // Waits are split so that a cancelled context is noticed quickly.
+    constexpr std::chrono::milliseconds MaxWaitDuration(100);
+  } // namespace
+
+  struct DataLakeFileWriter::State final
+  {
+    explicit State(const DataLakeFileClient& client) : Client(client) {}
+
+    struct Buffer final
+    {
+      std::vector<uint8_t> Data;
+      // When the first byte of the buffer was written.
+      std::chrono::steady_clock::time_point FirstWriteTime;
+    };
+
+    DataLakeFileClient Client;
+    Models::PathHttpHeaders HttpHeaders;
+    LeaseAccessConditions AccessConditions;
+    size_t BufferSize = 0;
+    std::chrono::milliseconds FlushInterval{0};
+    size_t MaxBufferedSize = 0;
+    Azure::Core::Context Context;
+
+    std::mutex Mutex;
+    // Notified when data is written, requested to be flushed, appended or flushed, and when the
+    // writer fails or stops.
+    std::condition_variable Changed;
+    // The data written and not appended yet, in buffers of up to BufferSize bytes. Only the last
+    // buffer is written to, the first one is taken out when it is appended.
+    std::deque<Buffer> Buffers;
+    // The bytes written and not appended yet, including those of the buffers being appended.
+    size_t BufferedSize = 0;
+    // The offset of the next buffer taken out to be appended.
+    int64_t NextAppendOffset = 0;
+    // The end of the data appended without gaps, the appends finishing out of order.
+    int64_t AppendedSize = 0;
+    // The appends finished beyond AppendedSize, by offset, with their end.
+    std::map<int64_t, int64_t> AppendedRanges;
+    // When the first byte of every buffer taken out and not flushed yet was written, by offset.
+    std::map<int64_t, std::chrono::steady_clock::time_point> UnflushedWriteTimes;
+    // The size of the file after the data flushed, and after all the data written.
+    int64_t CommittedSize = 0;
+    int64_t WrittenSize = 0;
+    // The size of the file requested by the flushes, the buffers are appended without waiting for
+    // them to be full until it is reached.
+    int64_t FlushedSize = 0;
+    bool Flushing = false;
+    bool Stopping = false;
+    std::exception_ptr Exception;
+
+    std::vector<std::thread> AppendThreads;
+
+    // Appends the buffers once they are ready and flushes the data appended once it's due, until
+    // the writer is stopped with all its data flushed or an append or a flush fails.
+    void AppendBuffers();
+    void ThrowIfFailed() const
+    {
+      if (Exception)
+      {
+        std::rethrow_exception(Exception);
+      }
+    }
+  };
+
+  void DataLakeFileWriter::State::AppendBuffers()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (!Exception)
+    {
+      if (Stopping && Buffers.empty() && NextAppendOffset == CommittedSize)
+      {
+        return;
+      }
+
+      const auto now = std::chrono::steady_clock::now();
+      // Only one flush is sent at a time, the data appended meanwhile is flushed by the next one.
+      if (!Flushing && AppendedSize > CommittedSize
+          && ((FlushedSize > CommittedSize && AppendedSize >= FlushedSize)
+              || (Stopping && AppendedSize == WrittenSize)
+              || now >= UnflushedWriteTimes.begin()->second + FlushInterval))
+      {
+        Flushing = true;
+        const int64_t flushPosition = AppendedSize;
+        lock.unlock();
+        try
+        {
+          // The data appended beyond the flush position by the other appends is retained.
+          FlushFileOptions options;
+          options.RetainUncommittedData = true;
+          options.HttpHeaders = HttpHeaders;
+          options.AccessConditions.LeaseId = AccessConditions.LeaseId;
+          Client.Flush(flushPosition, options, Context);
+        }
+        catch (...)
+        {
+          lock.lock();
+          Exception = std::current_exception();
+          Changed.notify_all();
+          return;
+        }
+        lock.lock();
+        Flushing = false;
+        CommittedSize = flushPosition;
+        UnflushedWriteTimes.erase(
+            UnflushedWriteTimes.begin(), UnflushedWriteTimes.lower_bound(flushPosition));
+        Changed.notify_all();
+        continue;
+      }
+
+      if (!Buffers.empty()
+          && (Buffers.size() > 1 || Buffers.front().Data.size() == BufferSize || Stopping
+              || FlushedSize > NextAppendOffset
+              || now >= Buffers.front().FirstWriteTime + FlushInterval))
+      {
+        // The writes go to a new buffer while this one is appended.
+        std::vector<uint8_t> buffer = std::move(Buffers.front().Data);
+        const int64_t offset = NextAppendOffset;
+        UnflushedWriteTimes.emplace(offset, Buffers.front().FirstWriteTime);
+        Buffers.pop_front();
+        NextAppendOffset += static_cast<int64_t>(buffer.size());
+        lock.unlock();
+        try
+        {
+          Azure::Core::IO::MemoryBodyStream content(buffer.data(), buffer.size());
+          AppendFileOptions options;
+          options.AccessConditions = AccessConditions;
+          Client.Append(content, offset, options, Context);
+        }
+        catch (...)
+        {
+          lock.lock();
+          Exception = std::current_exception();
+          Changed.notify_all();
+          return;
+        }
+        lock.lock();
+        AppendedRanges.emplace(offset, offset + static_cast<int64_t>(buffer.size()));
+        while (!AppendedRanges.empty() && AppendedRanges.begin()->first == AppendedSize)
+        {
+          AppendedSize = AppendedRanges.begin()->second;
+          AppendedRanges.erase(AppendedRanges.begin());
+        }
+        BufferedSize -= buffer.size();
+        Changed.notify_all();
+        continue;
+      }
+
+      auto waitUntil = std::chrono::steady_clock::time_point::max();
+      if (!Buffers.empty())
+      {
+        waitUntil = Buffers.front().FirstWriteTime + FlushInterval;
+      }
+      if (!Flushing && AppendedSize > CommittedSize)
+      {
+        waitUntil = std::min(waitUntil, UnflushedWriteTimes.begin()->second + FlushInterval);
+      }
+      if (waitUntil == std::chrono::steady_clock::time_point::max())
+      {
+        Changed.wait(lock);
+      }
+      else
+      {
+        Changed.wait_until(lock, waitUntil);
+      }
+    }
+  }
+
+  DataLakeFileWriter::DataLakeFileWriter(
+      const DataLakeFileClient& client,
+      const OpenWriteFileOptions& options,
+      int64_t fileSize,
+      const Azure::Core::Context& context)
+      : m_state(std::make_unique<State>(client))
+  {
+    m_state->HttpHeaders = options.HttpHeaders;
+    m_state->AccessConditions = options.AccessConditions;
+    m_state->BufferSize = static_cast<size_t>(options.BufferSize);
+    m_state->FlushInterval = options.FlushInterval;
+    m_state->MaxBufferedSize
+        = static_cast<size_t>(std::max(options.MaxBufferedSize, options.BufferSize));
+    m_state->Context = context;
+    m_state->NextAppendOffset = fileSize;
+    m_state->AppendedSize = fileSize;
+    m_state->CommittedSize = fileSize;
+    m_state->WrittenSize = fileSize;
+    m_state->FlushedSize = fileSize;
+    for (int32_t i = 0; i < options.MaxConcurrency; ++i)
+    {
+      m_state->AppendThreads.emplace_back([this]() { m_state->AppendBuffers(); });
+    }
+  }
+
+  DataLakeFileWriter::~DataLakeFileWriter()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_state->Mutex);
+      m_state->Stopping = true;
+    }
+    m_state->Changed.notify_all();
+    for (auto& appendThread : m_state->AppendThreads)
+    {
+      appendThread.join();
+    }
+  }
+
+  void DataLakeFileWriter::Write(
+      const uint8_t* data,
+      size_t length,
+      const Azure::Core::Context& context)
+  {
+    State& state = *m_state;
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    while (length > 0)
+    {
+      state.ThrowIfFailed();
+      if (state.BufferedSize >= state.MaxBufferedSize)
+      {
+        context.ThrowIfCancelled();
+        state.Changed.wait_for(lock, MaxWaitDuration);
+        continue;
+      }
+      if (state.Buffers.empty() || state.Buffers.back().Data.size() == state.BufferSize)
+      {
+        state.Buffers.emplace_back();
+        state.Buffers.back().FirstWriteTime = std::chrono::steady_clock::now();
+      }
+      auto& buffer = state.Buffers.back().Data;
+      const size_t writeSize = std::min(
+          {length, state.BufferSize - buffer.size(), state.MaxBufferedSize - state.BufferedSize});
+      buffer.insert(buffer.end(), data, data + writeSize);
+      data += writeSize;
+      length -= writeSize;
+      state.BufferedSize += writeSize;
+      state.WrittenSize += static_cast<int64_t>(writeSize);
+      state.Changed.notify_all();
+    }
+  }
+
+  void DataLakeFileWriter::Flush(const Azure::Core::Context& context)
+  {
+    State& state = *m_state;
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    const int64_t flushedSize = state.WrittenSize;
+    state.FlushedSize = std::max(state.FlushedSize, flushedSize);
+    state.Changed.notify_all();
+    while (state.CommittedSize < flushedSize)
+    {
+      state.ThrowIfFailed();
+      context.ThrowIfCancelled();
+      state.Changed.wait_for(lock, MaxWaitDuration);
+    }
+  }
+
+  int64_t DataLakeFileWriter::GetCommittedSize() const
+  {
+    std::lock_guard<std::mutex> guard(m_state->Mutex);
+    return m_state->CommittedSize;
+  }
+
+}}}} // namespace Azure::Storage::Files::DataLake
@@ -89,7 +89,10 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
 
   void ListPathsPagedResponse::OnNextPage(const Azure::Core::Context& context)
   {
-    *this = m_onNextPageFunc(NextPageToken.Value(), context);
+    // The pages returned by the function don't have it.
+    auto onNextPageFunc = m_onNextPageFunc;
+    *this = onNextPageFunc(NextPageToken.Value(), context);
+    m_onNextPageFunc = std::move(onNextPageFunc);
   }
 
   void SetPathAccessControlListRecursivePagedResponse::OnNextPage(
@@ -111,7 +114,10 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       *this = m_dataLakePathClient->RemoveAccessControlListRecursive(
           m_acls, m_operationOptions, context);
     }
-    _azure_UNREACHABLE_CODE();
+    else
+    {
+      _azure_UNREACHABLE_CODE();
+    }
   }
 
 }}}} // namespace Azure::Storage::Files::DataLake
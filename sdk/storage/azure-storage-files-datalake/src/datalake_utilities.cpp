@@ -97,6 +97,10 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake { nam
     blobOptions.SecondaryHostForRetryReads
         = _detail::GetBlobUrlFromUrl(options.SecondaryHostForRetryReads);
     blobOptions.ApiVersion = options.ApiVersion;
+    blobOptions.TransferExecutor = options.TransferExecutor;
+    blobOptions.BufferPool = options.BufferPool;
+    blobOptions.RateLimiter = options.RateLimiter;
+    blobOptions.CongestionController = options.CongestionController;
     return blobOptions;
   }
 
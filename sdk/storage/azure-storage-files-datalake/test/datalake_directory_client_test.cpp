@@ -4,13 +4,107 @@
 #include "datalake_directory_client_test.hpp"
 
 #include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
+#include <azure/core/uuid.hpp>
 #include <azure/identity/client_secret_credential.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // Serves the directory filesystem/dir, which contains the directories a and b and the file f.
+    // The recursive changes of a directory take two batches, the one of a file takes one. The
+    // access control list of dir is currentAcl.
+    class MockAccessControlRecursiveTransportPolicy final
+        : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockAccessControlRecursiveTransportPolicy(
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::string> currentAcl,
+          std::shared_ptr<std::map<std::string, int>> recursiveChanges)
+          : m_mutex(std::move(mutex)), m_currentAcl(std::move(currentAcl)),
+            m_recursiveChanges(std::move(recursiveChanges))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockAccessControlRecursiveTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        std::lock_guard<std::mutex> guard(*m_mutex);
+        const auto query = request.GetUrl().GetQueryParameters();
+        const std::string path = request.GetUrl().GetPath();
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        std::string body;
+        if (request.GetMethod() == Core::Http::HttpMethod::Get)
+        {
+          body = "{\"paths\":[";
+          for (std::string name : {"a", "b", "f"})
+          {
+            body += std::string(name == "a" ? "" : ",") + "{\"name\":\"dir/" + name
+                + "\",\"isDirectory\":\"" + (name == "f" ? "false" : "true")
+                + "\",\"lastModified\":\"Thu, 23 Aug 2001 07:00:00 GMT\",\"etag\":\""
+                + DummyETag.ToString()
+                + "\",\"owner\":\"$superuser\",\"group\":\"$superuser\","
+                  "\"permissions\":\"rwxr-x---\"}";
+          }
+          body += "]}";
+        }
+        else if (request.GetMethod() == Core::Http::HttpMethod::Head)
+        {
+          response->SetHeader("x-ms-acl", *m_currentAcl);
+          response->SetHeader("x-ms-owner", "$superuser");
+          response->SetHeader("x-ms-group", "$superuser");
+        }
+        else if (query.at("action") == "setAccessControl")
+        {
+          *m_currentAcl = request.GetHeaders().at("x-ms-acl");
+        }
+        else
+        {
+          ++(*m_recursiveChanges)[path];
+          const bool isFile = path == "filesystem/dir/f";
+          const bool isFirstBatch = query.find("continuation") == query.end();
+          if (!isFile && isFirstBatch)
+          {
+            response->SetHeader("x-ms-continuation", "token");
+          }
+          body = std::string("{\"directoriesSuccessful\":")
+              + (isFile ? "0" : isFirstBatch ? "2" : "1") + ",\"filesSuccessful\":"
+              + (isFile ? "1" : isFirstBatch ? "3" : "0")
+              + ",\"failureCount\":0,\"failedEntries\":[]}";
+        }
+        if (!body.empty())
+        {
+          response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+          response->SetHeader("content-type", "application/json");
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Files::DataLake::_detail::DefaultServiceApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::string> m_currentAcl;
+      std::shared_ptr<std::map<std::string, int>> m_recursiveChanges;
+    };
+  } // namespace
+
   std::shared_ptr<Files::DataLake::DataLakeDirectoryClient>
       DataLakeDirectoryClientTest::m_directoryClient;
   std::string DataLakeDirectoryClientTest::m_directoryName;
@@ -633,6 +727,56 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST(DataLakeAccessControlRecursiveConcurrentlyTest, ChangesSubtreesThenDirectory)
+  {
+    auto mutex = std::make_shared<std::mutex>();
+    auto currentAcl = std::make_shared<std::string>("user::rwx,group::r-x,other::---,user:u1:r--");
+    auto recursiveChanges = std::make_shared<std::map<std::string, int>>();
+    Files::DataLake::DataLakeClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockAccessControlRecursiveTransportPolicy>(
+            mutex, currentAcl, recursiveChanges));
+    Files::DataLake::DataLakeDirectoryClient directoryClient(
+        "https://account.dfs.core.windows.net/filesystem/dir", clientOptions);
+
+    Files::DataLake::UpdatePathAccessControlListRecursiveConcurrentlyOptions options;
+    options.BatchSize = 5;
+    options.Concurrency = 2;
+    int32_t progressDirectories = 0;
+    int32_t progressFiles = 0;
+    int batches = 0;
+    options.ProgressHandler = [&](int32_t directories,
+                                  int32_t files,
+                                  const std::vector<Files::DataLake::Models::AclFailedEntry>&
+                                      failedEntries) {
+      progressDirectories += directories;
+      progressFiles += files;
+      ++batches;
+      EXPECT_TRUE(failedEntries.empty());
+    };
+    auto result = directoryClient.UpdateAccessControlListRecursiveConcurrently(
+        Files::DataLake::Models::Acl::DeserializeAcls("user:u1:rwx,user:u2:r-x"), options);
+
+    // Two batches for each directory, one for the file, then the directory itself.
+    EXPECT_EQ(result.Value.NumberOfSuccessfulDirectories, 7);
+    EXPECT_EQ(result.Value.NumberOfSuccessfulFiles, 7);
+    EXPECT_EQ(result.Value.NumberOfFailures, 0);
+    EXPECT_TRUE(result.Value.FailedEntries.empty());
+    EXPECT_EQ(progressDirectories, 7);
+    EXPECT_EQ(progressFiles, 7);
+    EXPECT_EQ(batches, 6);
+    EXPECT_EQ(
+        *recursiveChanges,
+        (std::map<std::string, int>{
+            {"filesystem/dir/a", 2}, {"filesystem/dir/b", 2}, {"filesystem/dir/f", 1}}));
+    EXPECT_EQ(*currentAcl, "user::rwx,group::r-x,other::---,user:u1:rwx,user:u2:r-x");
+
+    auto removeResult = directoryClient.RemoveAccessControlListRecursiveConcurrently(
+        Files::DataLake::Models::Acl::DeserializeAcls("user:u1:---"));
+    EXPECT_EQ(removeResult.Value.NumberOfSuccessfulDirectories, 7);
+    EXPECT_EQ(*currentAcl, "user::rwx,group::r-x,other::---,user:u2:r-x");
+  }
+
   TEST_F(DataLakeDirectoryClientTest, ConstructorsWorks)
   {
     {
@@ -4,11 +4,16 @@
 #include "datalake_file_client_test.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <future>
+#include <map>
+#include <mutex>
 #include <random>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include <azure/core/uuid.hpp>
 #include <azure/identity/client_secret_credential.hpp>
 #include <azure/storage/blobs.hpp>
 #include <azure/storage/common/internal/file_io.hpp>
@@ -27,6 +32,91 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake { nam
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // Serves a file whose flushed content is fileContent. The data appended is kept by position
+    // until it's flushed, the flushes of data which wasn't appended fail.
+    class MockFileAppendTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockFileAppendTransportPolicy(
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::vector<uint8_t>> fileContent,
+          std::shared_ptr<std::vector<int64_t>> flushPositions)
+          : m_mutex(std::move(mutex)), m_fileContent(std::move(fileContent)),
+            m_flushPositions(std::move(flushPositions)),
+            m_appendedData(std::make_shared<std::map<int64_t, std::vector<uint8_t>>>())
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockFileAppendTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        std::lock_guard<std::mutex> guard(*m_mutex);
+        const auto query = request.GetUrl().GetQueryParameters();
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetMethod() == Core::Http::HttpMethod::Head)
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetHeader("content-length", std::to_string(m_fileContent->size()));
+          response->SetHeader("x-ms-blob-type", "BlockBlob");
+          response->SetHeader("x-ms-creation-time", "Thu, 23 Aug 2001 07:00:00 GMT");
+          response->SetHeader("x-ms-server-encrypted", "true");
+        }
+        else if (query.at("action") == "append")
+        {
+          (*m_appendedData)[std::stoll(query.at("position"))]
+              = request.GetBodyStream()->ReadToEnd(context);
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Accepted, "Accepted");
+          response->SetHeader("x-ms-request-server-encrypted", "true");
+        }
+        else
+        {
+          const int64_t position = std::stoll(query.at("position"));
+          auto appended = m_appendedData->find(static_cast<int64_t>(m_fileContent->size()));
+          while (static_cast<int64_t>(m_fileContent->size()) < position
+                 && appended != m_appendedData->end())
+          {
+            m_fileContent->insert(
+                m_fileContent->end(), appended->second.begin(), appended->second.end());
+            appended = m_appendedData->erase(appended);
+          }
+          if (static_cast<int64_t>(m_fileContent->size()) != position)
+          {
+            response = std::make_unique<Core::Http::RawResponse>(
+                1, 1, Core::Http::HttpStatusCode::BadRequest, "Bad Request");
+            response->SetHeader("x-ms-error-code", "InvalidFlushPosition");
+          }
+          else
+          {
+            m_flushPositions->push_back(position);
+            response = std::make_unique<Core::Http::RawResponse>(
+                1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+            response->SetHeader("content-length", "0");
+          }
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Files::DataLake::_detail::DefaultServiceApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::vector<uint8_t>> m_fileContent;
+      std::shared_ptr<std::vector<int64_t>> m_flushPositions;
+      std::shared_ptr<std::map<int64_t, std::vector<uint8_t>>> m_appendedData;
+    };
+  } // namespace
+
   std::shared_ptr<Files::DataLake::DataLakeFileClient> DataLakeFileClientTest::m_fileClient;
   std::string DataLakeFileClientTest::m_fileName;
 
@@ -476,6 +566,137 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST_F(DataLakeFileClientTest, ConcurrentUploadDfsEndpoint)
+  {
+    std::vector<uint8_t> fileContent = RandomBuffer(static_cast<size_t>(3_MB));
+    std::string tempFilename = RandomString();
+    {
+      Azure::Storage::_internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(fileContent.data(), fileContent.size(), 0);
+    }
+
+    for (bool fromFile : {false, true})
+    {
+      auto fileClient = m_fileSystemClient->GetFileClient(RandomString());
+
+      Azure::Storage::Files::DataLake::UploadFileFromOptions options;
+      options.UseDfsEndpoint = true;
+      options.Close = true;
+      options.TransferOptions.ChunkSize = 1_MB;
+      options.TransferOptions.Concurrency = 2;
+      options.TransferOptions.ValidateContentCrc64 = true;
+      options.HttpHeaders = GetInterestingHttpHeaders();
+      options.Metadata = RandomMetadata();
+      auto res = fromFile ? fileClient.UploadFrom(tempFilename, options)
+                          : fileClient.UploadFrom(fileContent.data(), fileContent.size(), options);
+      EXPECT_TRUE(res.Value.ETag.HasValue());
+      EXPECT_TRUE(IsValidTime(res.Value.LastModified));
+      auto properties = fileClient.GetProperties().Value;
+      EXPECT_EQ(properties.FileSize, static_cast<int64_t>(fileContent.size()));
+      EXPECT_EQ(properties.HttpHeaders, options.HttpHeaders);
+      EXPECT_EQ(properties.Metadata, options.Metadata);
+      EXPECT_EQ(properties.ETag, res.Value.ETag);
+      EXPECT_EQ(properties.LastModified, res.Value.LastModified);
+      std::vector<uint8_t> downloadContent(fileContent.size(), '\x00');
+      fileClient.DownloadTo(downloadContent.data(), downloadContent.size());
+      EXPECT_EQ(downloadContent, fileContent);
+    }
+    DeleteFile(tempFilename);
+  }
+
+  TEST(DataLakeFileWriterTest, AppendsBuffersConcurrently)
+  {
+    auto mutex = std::make_shared<std::mutex>();
+    auto fileContent = std::make_shared<std::vector<uint8_t>>(RandomBuffer(5));
+    auto flushPositions = std::make_shared<std::vector<int64_t>>();
+    Files::DataLake::DataLakeClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockFileAppendTransportPolicy>(mutex, fileContent, flushPositions));
+    Files::DataLake::DataLakeFileClient fileClient(
+        "https://account.dfs.core.windows.net/filesystem/file", clientOptions);
+
+    std::vector<uint8_t> expectedContent = *fileContent;
+    Files::DataLake::OpenWriteFileOptions options;
+    options.BufferSize = 1_KB;
+    options.MaxConcurrency = 3;
+    options.FlushInterval = std::chrono::hours(1);
+    options.MaxBufferedSize = 4_KB;
+    {
+      auto writer = fileClient.OpenWrite(options);
+      EXPECT_EQ(writer->GetCommittedSize(), 5);
+      for (int i = 0; i < 100; ++i)
+      {
+        auto data = RandomBuffer(37);
+        writer->Write(data.data(), data.size());
+        expectedContent.insert(expectedContent.end(), data.begin(), data.end());
+      }
+      writer->Flush();
+      EXPECT_EQ(writer->GetCommittedSize(), 3705);
+      {
+        std::lock_guard<std::mutex> guard(*mutex);
+        EXPECT_EQ(*fileContent, expectedContent);
+        EXPECT_EQ(*flushPositions, std::vector<int64_t>({3705}));
+      }
+
+      // The data left is appended and flushed when the writer is destroyed.
+      auto data = RandomBuffer(10);
+      writer->Write(data.data(), data.size());
+      expectedContent.insert(expectedContent.end(), data.begin(), data.end());
+    }
+    EXPECT_EQ(*fileContent, expectedContent);
+    EXPECT_EQ(*flushPositions, std::vector<int64_t>({3705, 3715}));
+
+    // Data which doesn't fill a buffer is appended and flushed after the flush interval.
+    options.FlushInterval = std::chrono::milliseconds(10);
+    auto writer = fileClient.OpenWrite(options);
+    auto data = RandomBuffer(10);
+    writer->Write(data.data(), data.size());
+    for (int i = 0; i < 500 && writer->GetCommittedSize() != 3725; ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(writer->GetCommittedSize(), 3725);
+  }
+
+  TEST_F(DataLakeFileClientTest, OpenWrite)
+  {
+    auto fileClient = m_fileSystemClient->GetFileClient(RandomString());
+    std::vector<uint8_t> content;
+    {
+      Files::DataLake::OpenWriteFileOptions options;
+      options.Overwrite = true;
+      options.BufferSize = 64_KB;
+      options.HttpHeaders = GetInterestingHttpHeaders();
+      auto writer = fileClient.OpenWrite(options);
+      std::vector<std::thread> threads;
+      std::mutex contentMutex;
+      for (int i = 0; i < 4; ++i)
+      {
+        threads.emplace_back([&]() {
+          for (int j = 0; j < 100; ++j)
+          {
+            auto data = RandomBuffer(1_KB + 1);
+            std::lock_guard<std::mutex> guard(contentMutex);
+            writer->Write(data.data(), data.size());
+            content.insert(content.end(), data.begin(), data.end());
+          }
+        });
+      }
+      for (auto& thread : threads)
+      {
+        thread.join();
+      }
+      writer->Flush();
+      EXPECT_EQ(writer->GetCommittedSize(), static_cast<int64_t>(content.size()));
+    }
+    auto properties = fileClient.GetProperties().Value;
+    EXPECT_EQ(properties.FileSize, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(properties.HttpHeaders, GetInterestingHttpHeaders());
+    std::vector<uint8_t> downloadContent(content.size(), '\x00');
+    fileClient.DownloadTo(downloadContent.data(), downloadContent.size());
+    EXPECT_EQ(downloadContent, content);
+  }
+
   TEST_F(DataLakeFileClientTest, ConstructorsWorks)
   {
     {
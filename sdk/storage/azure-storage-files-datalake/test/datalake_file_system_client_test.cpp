@@ -4,7 +4,12 @@
 #include "datalake_file_system_client_test.hpp"
 
 #include <algorithm>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 
+#include <azure/core/uuid.hpp>
 #include <azure/identity/client_secret_credential.hpp>
 #include <azure/storage/common/crypt.hpp>
 
@@ -16,6 +21,161 @@ namespace Azure { namespace Storage { namespace Blobs { namespace Models {
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // Lists the paths of a file system, the directories end with a slash. The pages have the
+    // number of paths of maxresults, the continuation token is the index of the next path.
+    class MockListPathsTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockListPathsTransportPolicy(
+          std::vector<std::string> paths,
+          std::shared_ptr<std::vector<std::string>> listedDirectories)
+          : m_paths(std::move(paths)), m_listedDirectories(std::move(listedDirectories))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockListPathsTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        const auto query = request.GetUrl().GetQueryParameters();
+        const bool recursive = query.at("recursive") == "true";
+        std::string prefix;
+        if (query.find("directory") != query.end())
+        {
+          prefix = query.at("directory") + "/";
+        }
+        {
+          std::lock_guard<std::mutex> guard(*m_mutex);
+          m_listedDirectories->push_back(prefix);
+        }
+        std::vector<std::string> paths;
+        for (const auto& path : m_paths)
+        {
+          const std::string name = path.substr(0, path.find_last_not_of('/') + 1);
+          if (name.compare(0, prefix.size(), prefix) == 0
+              && (recursive || name.find('/', prefix.size()) == std::string::npos))
+          {
+            paths.push_back(path);
+          }
+        }
+        size_t begin = 0;
+        if (query.find("continuation") != query.end())
+        {
+          begin = std::stoul(query.at("continuation"));
+        }
+        const size_t end = std::min(paths.size(), begin + std::stoul(query.at("maxresults")));
+
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        std::string body = "{\"paths\":[";
+        for (size_t i = begin; i < end; ++i)
+        {
+          const bool isDirectory = paths[i].back() == '/';
+          body += std::string(i == begin ? "" : ",") + "{\"name\":\""
+              + paths[i].substr(0, paths[i].size() - (isDirectory ? 1 : 0))
+              + "\",\"isDirectory\":\"" + (isDirectory ? "true" : "false")
+              + "\",\"lastModified\":\"Thu, 23 Aug 2001 07:00:00 GMT\",\"etag\":\""
+              + DummyETag.ToString()
+              + "\",\"owner\":\"$superuser\",\"group\":\"$superuser\","
+                "\"permissions\":\"rwxr-x---\"}";
+        }
+        body += "]}";
+        if (end != paths.size())
+        {
+          response->SetHeader("x-ms-continuation", std::to_string(end));
+        }
+        response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+        response->SetHeader("content-type", "application/json");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Files::DataLake::_detail::DefaultServiceApiVersion);
+        return response;
+      }
+
+    private:
+      std::vector<std::string> m_paths;
+      std::shared_ptr<std::vector<std::string>> m_listedDirectories;
+      std::shared_ptr<std::mutex> m_mutex = std::make_shared<std::mutex>();
+    };
+
+    // Renames the paths of a file system. The first attempt to rename a path starting with "busy"
+    // fails with a retriable error.
+    class MockRenameTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockRenameTransportPolicy(std::shared_ptr<std::set<std::string>> paths)
+          : m_paths(std::move(paths))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockRenameTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        const std::string fileSystemPrefix = "/filesystem/";
+        const std::string source
+            = request.GetHeaders().at("x-ms-rename-source").substr(fileSystemPrefix.size());
+        const std::string destination
+            = request.GetUrl().GetPath().substr(fileSystemPrefix.size() - 1);
+
+        std::unique_ptr<Core::Http::RawResponse> response;
+        std::lock_guard<std::mutex> guard(*m_mutex);
+        if (source.compare(0, 4, "busy") == 0 && m_busyPaths->insert(source).second)
+        {
+          response = CreateErrorResponse(
+              Core::Http::HttpStatusCode::ServiceUnavailable, "ServerBusy", "Server busy.");
+        }
+        else if (m_paths->erase(source) == 0)
+        {
+          response = CreateErrorResponse(
+              Core::Http::HttpStatusCode::NotFound,
+              "SourcePathNotFound",
+              "The source path for a rename operation does not exist.");
+        }
+        else
+        {
+          m_paths->insert(destination);
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("etag", DummyETag.ToString());
+          response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        }
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Files::DataLake::_detail::DefaultServiceApiVersion);
+        return response;
+      }
+
+    private:
+      static std::unique_ptr<Core::Http::RawResponse> CreateErrorResponse(
+          Core::Http::HttpStatusCode statusCode,
+          const std::string& errorCode,
+          const std::string& message)
+      {
+        auto response = std::make_unique<Core::Http::RawResponse>(1, 1, statusCode, errorCode);
+        const std::string body = "{\"error\":{\"code\":\"" + errorCode + "\",\"message\":\""
+            + message + "\"}}";
+        response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+        response->SetHeader("content-type", "application/json");
+        return response;
+      }
+
+      std::shared_ptr<std::set<std::string>> m_paths;
+      std::shared_ptr<std::set<std::string>> m_busyPaths
+          = std::make_shared<std::set<std::string>>();
+      std::shared_ptr<std::mutex> m_mutex = std::make_shared<std::mutex>();
+    };
+  } // namespace
+
   const size_t PathTestSize = 5;
 
   std::shared_ptr<Files::DataLake::DataLakeFileSystemClient>
@@ -300,6 +460,89 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST(DataLakeListPathsConcurrentlyTest, ListsTopLevelDirectoriesConcurrently)
+  {
+    const std::vector<std::string> paths
+        = {"a/", "a/x", "a/y/", "a/y/z", "b/", "b/w", "c/", "f", "g"};
+    auto listedDirectories = std::make_shared<std::vector<std::string>>();
+    Files::DataLake::DataLakeClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockListPathsTransportPolicy>(paths, listedDirectories));
+    Files::DataLake::DataLakeFileSystemClient fileSystemClient(
+        "https://account.dfs.core.windows.net/filesystem", clientOptions);
+
+    for (bool partition : {true, false})
+    {
+      listedDirectories->clear();
+      Files::DataLake::ListPathsConcurrentlyOptions options;
+      options.PartitionByTopLevelDirectories = partition;
+      options.Concurrency = 2;
+      options.PageSizeHint = 2;
+      std::mutex listedMutex;
+      std::vector<std::string> listedPaths;
+      fileSystemClient.ListPathsConcurrently(
+          [&](std::vector<Files::DataLake::Models::PathItem> pathItems) {
+            std::lock_guard<std::mutex> guard(listedMutex);
+            EXPECT_LE(pathItems.size(), 2U);
+            for (const auto& pathItem : pathItems)
+            {
+              listedPaths.push_back(pathItem.Name + (pathItem.IsDirectory ? "/" : ""));
+            }
+          },
+          options);
+      std::sort(listedPaths.begin(), listedPaths.end());
+      EXPECT_EQ(listedPaths, paths);
+
+      // The root pages, then the pages of each top-level directory.
+      std::sort(listedDirectories->begin(), listedDirectories->end());
+      EXPECT_EQ(
+          *listedDirectories,
+          partition ? std::vector<std::string>({"", "", "", "a/", "a/", "b/", "c/"})
+                    : std::vector<std::string>({"", "", "", "", ""}));
+    }
+  }
+
+  TEST(DataLakeRenamePathsTest, ReportsTheOutcomeOfEveryRename)
+  {
+    auto paths = std::make_shared<std::set<std::string>>(
+        std::set<std::string>{"staging/a", "staging/b", "staging/c", "busy"});
+    Files::DataLake::DataLakeClientOptions clientOptions;
+    clientOptions.Retry.RetryDelay = std::chrono::milliseconds(1);
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockRenameTransportPolicy>(paths));
+    Files::DataLake::DataLakeFileSystemClient fileSystemClient(
+        "https://account.dfs.core.windows.net/filesystem", clientOptions);
+
+    std::vector<Files::DataLake::Models::RenamePathItem> renames;
+    for (std::string name : {"staging/a", "staging/missing", "staging/b", "busy", "staging/c"})
+    {
+      Files::DataLake::Models::RenamePathItem rename;
+      rename.SourcePath = name;
+      rename.DestinationPath = "partitioned/" + name;
+      renames.push_back(std::move(rename));
+    }
+    Files::DataLake::RenamePathsOptions options;
+    options.Concurrency = 2;
+    auto result = fileSystemClient.RenamePaths(renames, options);
+
+    EXPECT_EQ(result.NumberOfSuccessfulRenames, 4);
+    EXPECT_EQ(result.NumberOfFailures, 1);
+    ASSERT_EQ(result.Outcomes.size(), renames.size());
+    for (size_t i = 0; i < renames.size(); ++i)
+    {
+      EXPECT_EQ(result.Outcomes[i].Renamed, i != 1);
+    }
+    EXPECT_EQ(result.Outcomes[1].StatusCode, Core::Http::HttpStatusCode::NotFound);
+    EXPECT_EQ(result.Outcomes[1].ErrorCode, "SourcePathNotFound");
+    EXPECT_FALSE(result.Outcomes[1].ErrorMessage.empty());
+    EXPECT_EQ(
+        *paths,
+        std::set<std::string>(
+            {"partitioned/busy",
+             "partitioned/staging/a",
+             "partitioned/staging/b",
+             "partitioned/staging/c"}));
+  }
+
   TEST_F(DataLakeFileSystemClientTest, UnencodedPathDirectoryFileNameWorks)
   {
     const std::string non_ascii_word = "\xE6\xB5\x8B\xE8\xAF\x95";
@@ -441,4 +441,41 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST(DataLakeSasTokenGeneratorTest, SameAsBuilder)
+  {
+    StorageSharedKeyCredential credential(
+        "account", Azure::Core::Convert::Base64Encode(RandomBuffer(64)));
+    Files::DataLake::Models::UserDelegationKey userDelegationKey;
+    userDelegationKey.SignedObjectId = "object";
+    userDelegationKey.SignedTenantId = "tenant";
+    userDelegationKey.SignedStartsOn = Azure::DateTime(2021, 1, 1);
+    userDelegationKey.SignedExpiresOn = Azure::DateTime(2021, 1, 2);
+    userDelegationKey.SignedService = "b";
+    userDelegationKey.SignedVersion = "2020-02-10";
+    userDelegationKey.Value = Azure::Core::Convert::Base64Encode(RandomBuffer(32));
+
+    Sas::DataLakeSasBuilder builder;
+    builder.Protocol = Sas::SasProtocol::HttpsOnly;
+    builder.ExpiresOn = Azure::DateTime(2021, 1, 2);
+    builder.FileSystemName = "filesystem";
+    builder.Resource = Sas::DataLakeSasResource::File;
+    builder.DirectoryDepth = 1;
+    builder.SetPermissions(Sas::DataLakeSasPermissions::Read);
+
+    const Sas::DataLakeSasTokenGenerator generator(builder, credential);
+    const Sas::DataLakeSasTokenGenerator userDelegationGenerator(
+        builder, userDelegationKey, credential.AccountName);
+    for (const std::string path : {"file", "dir/file name+1"})
+    {
+      builder.Path = path;
+      EXPECT_EQ(generator.GenerateSasToken(path), builder.GenerateSasToken(credential));
+      EXPECT_EQ(
+          userDelegationGenerator.GenerateSasToken(path),
+          builder.GenerateSasToken(userDelegationKey, credential.AccountName));
+    }
+
+    builder.Resource = Sas::DataLakeSasResource::FileSystem;
+    EXPECT_THROW(Sas::DataLakeSasTokenGenerator(builder, credential), std::invalid_argument);
+  }
+
 }}} // namespace Azure::Storage::Test
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Define the base behavior of the tests using a DataLake file client.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/uuid.hpp>
+#include <azure/perf.hpp>
+
+#include <azure/storage/files/datalake.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Files { namespace DataLake { namespace Test {
+
+  /**
+   * @brief A base test that set up a DataLake files performance test.
+   *
+   */
+  class DataLakeTest : public Azure::Perf::PerfTest {
+  protected:
+    std::string m_fileSystemName;
+    std::string m_fileName;
+    std::unique_ptr<Azure::Storage::Files::DataLake::DataLakeFileSystemClient> m_fileSystemClient;
+    std::unique_ptr<Azure::Storage::Files::DataLake::DataLakeFileClient> m_fileClient;
+
+  public:
+    /**
+     * @brief Create the file system and the file client
+     *
+     */
+    void Setup() override
+    {
+      // Get connection string from env
+      const static std::string connectionString = std::getenv("STORAGE_CONNECTION_STRING");
+
+      // Generate random file system and file names.
+      m_fileSystemName = "filesystem" + Azure::Core::Uuid::CreateUuid().ToString();
+      m_fileName = "file" + Azure::Core::Uuid::CreateUuid().ToString();
+
+      m_fileSystemClient
+          = std::make_unique<Azure::Storage::Files::DataLake::DataLakeFileSystemClient>(
+              Azure::Storage::Files::DataLake::DataLakeFileSystemClient::CreateFromConnectionString(
+                  connectionString, m_fileSystemName));
+      m_fileSystemClient->CreateIfNotExists();
+      m_fileClient = std::make_unique<Azure::Storage::Files::DataLake::DataLakeFileClient>(
+          m_fileSystemClient->GetFileClient(m_fileName));
+    }
+
+    void Cleanup() override { m_fileSystemClient->DeleteIfExists(); }
+
+    /**
+     * @brief Construct a new DataLakeTest test.
+     *
+     * @param options The test options.
+     */
+    DataLakeTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+  };
+
+}}}}} // namespace Azure::Storage::Files::DataLake::Test
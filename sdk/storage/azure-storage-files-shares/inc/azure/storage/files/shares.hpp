@@ -12,6 +12,7 @@
 #include "azure/storage/files/shares/share_client.hpp"
 #include "azure/storage/files/shares/share_directory_client.hpp"
 #include "azure/storage/files/shares/share_file_client.hpp"
+#include "azure/storage/files/shares/share_file_writer.hpp"
 #include "azure/storage/files/shares/share_lease_client.hpp"
 #include "azure/storage/files/shares/share_sas_builder.hpp"
 #include "azure/storage/files/shares/share_service_client.hpp"
@@ -3725,10 +3725,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           std::string ApiVersionParameter = _detail::DefaultServiceApiVersion;
         };
 
-        static Azure::Response<Models::CreateShareResult> Create(
+        static Azure::Core::Http::Request CreateCreateMessage(
             const Azure::Core::Url& url,
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
-            Azure::Core::Context context,
             const CreateOptions& createOptions)
         {
           Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Put, url);
@@ -3755,6 +3753,23 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
                 _detail::HeaderAccessTier, createOptions.XMsAccessTier.Value().ToString());
           }
           request.SetHeader(_detail::HeaderVersion, createOptions.ApiVersionParameter);
+          return request;
+        }
+
+        static Azure::Response<Models::CreateShareResult> CreateCreateResponse(
+            Azure::Core::Context context,
+            std::unique_ptr<Azure::Core::Http::RawResponse> responsePtr)
+        {
+          return CreateParseResult(context, std::move(responsePtr));
+        }
+
+        static Azure::Response<Models::CreateShareResult> Create(
+            const Azure::Core::Url& url,
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            Azure::Core::Context context,
+            const CreateOptions& createOptions)
+        {
+          auto request = CreateCreateMessage(url, createOptions);
           return CreateParseResult(context, pipeline.Send(request, context));
         }
 
@@ -3804,10 +3819,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           Azure::Nullable<std::string> LeaseIdOptional;
         };
 
-        static Azure::Response<Models::DeleteShareResult> Delete(
+        static Azure::Core::Http::Request DeleteCreateMessage(
             const Azure::Core::Url& url,
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
-            Azure::Core::Context context,
             const DeleteOptions& deleteOptions)
         {
           Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Delete, url);
@@ -3835,6 +3848,23 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           {
             request.SetHeader(_detail::HeaderLeaseId, deleteOptions.LeaseIdOptional.Value());
           }
+          return request;
+        }
+
+        static Azure::Response<Models::DeleteShareResult> DeleteCreateResponse(
+            Azure::Core::Context context,
+            std::unique_ptr<Azure::Core::Http::RawResponse> responsePtr)
+        {
+          return DeleteParseResult(context, std::move(responsePtr));
+        }
+
+        static Azure::Response<Models::DeleteShareResult> Delete(
+            const Azure::Core::Url& url,
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            Azure::Core::Context context,
+            const DeleteOptions& deleteOptions)
+        {
+          auto request = DeleteCreateMessage(url, deleteOptions);
           return DeleteParseResult(context, pipeline.Send(request, context));
         }
 
@@ -5188,10 +5218,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           std::string FileLastWriteTime;
         };
 
-        static Azure::Response<Models::CreateDirectoryResult> Create(
+        static Azure::Core::Http::Request CreateCreateMessage(
             const Azure::Core::Url& url,
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
-            Azure::Core::Context context,
             const CreateOptions& createOptions)
         {
           Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Put, url);
@@ -5220,6 +5248,23 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           request.SetHeader(_detail::HeaderFileAttributes, createOptions.FileAttributes);
           request.SetHeader(_detail::HeaderFileCreatedOn, createOptions.FileCreationTime);
           request.SetHeader(_detail::HeaderFileLastWrittenOn, createOptions.FileLastWriteTime);
+          return request;
+        }
+
+        static Azure::Response<Models::CreateDirectoryResult> CreateCreateResponse(
+            Azure::Core::Context context,
+            std::unique_ptr<Azure::Core::Http::RawResponse> responsePtr)
+        {
+          return CreateParseResult(context, std::move(responsePtr));
+        }
+
+        static Azure::Response<Models::CreateDirectoryResult> Create(
+            const Azure::Core::Url& url,
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            Azure::Core::Context context,
+            const CreateOptions& createOptions)
+        {
+          auto request = CreateCreateMessage(url, createOptions);
           return CreateParseResult(context, pipeline.Send(request, context));
         }
 
@@ -5261,10 +5306,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           std::string ApiVersionParameter = _detail::DefaultServiceApiVersion;
         };
 
-        static Azure::Response<Models::DeleteDirectoryResult> Delete(
+        static Azure::Core::Http::Request DeleteCreateMessage(
             const Azure::Core::Url& url,
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
-            Azure::Core::Context context,
             const DeleteOptions& deleteOptions)
         {
           Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Delete, url);
@@ -5276,6 +5319,23 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
                 _internal::UrlEncodeQueryParameter(std::to_string(deleteOptions.Timeout.Value())));
           }
           request.SetHeader(_detail::HeaderVersion, deleteOptions.ApiVersionParameter);
+          return request;
+        }
+
+        static Azure::Response<Models::DeleteDirectoryResult> DeleteCreateResponse(
+            Azure::Core::Context context,
+            std::unique_ptr<Azure::Core::Http::RawResponse> responsePtr)
+        {
+          return DeleteParseResult(context, std::move(responsePtr));
+        }
+
+        static Azure::Response<Models::DeleteDirectoryResult> Delete(
+            const Azure::Core::Url& url,
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            Azure::Core::Context context,
+            const DeleteOptions& deleteOptions)
+        {
+          auto request = DeleteCreateMessage(url, deleteOptions);
           return DeleteParseResult(context, pipeline.Send(request, context));
         }
 
@@ -6509,10 +6569,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           Azure::Nullable<std::string> LeaseIdOptional;
         };
 
-        static Azure::Response<Models::DeleteFileResult> Delete(
+        static Azure::Core::Http::Request DeleteCreateMessage(
             const Azure::Core::Url& url,
-            Azure::Core::Http::_internal::HttpPipeline& pipeline,
-            Azure::Core::Context context,
             const DeleteOptions& deleteOptions)
         {
           Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Delete, url);
@@ -6527,6 +6585,23 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           {
             request.SetHeader(_detail::HeaderLeaseId, deleteOptions.LeaseIdOptional.Value());
           }
+          return request;
+        }
+
+        static Azure::Response<Models::DeleteFileResult> DeleteCreateResponse(
+            Azure::Core::Context context,
+            std::unique_ptr<Azure::Core::Http::RawResponse> responsePtr)
+        {
+          return DeleteParseResult(context, std::move(responsePtr));
+        }
+
+        static Azure::Response<Models::DeleteFileResult> Delete(
+            const Azure::Core::Url& url,
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            Azure::Core::Context context,
+            const DeleteOptions& deleteOptions)
+        {
+          auto request = DeleteCreateMessage(url, deleteOptions);
           return DeleteParseResult(context, pipeline.Send(request, context));
         }
 
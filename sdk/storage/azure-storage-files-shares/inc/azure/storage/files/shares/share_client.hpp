@@ -231,11 +231,16 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
   private:
     Azure::Core::Url m_shareUrl;
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    std::shared_ptr<TransferExecutor> m_transferExecutor;
+    std::shared_ptr<BufferPool> m_bufferPool;
 
     explicit ShareClient(
         Azure::Core::Url shareUrl,
-        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline)
-        : m_shareUrl(std::move(shareUrl)), m_pipeline(std::move(pipeline))
+        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline,
+        std::shared_ptr<TransferExecutor> transferExecutor,
+        std::shared_ptr<BufferPool> bufferPool)
+        : m_shareUrl(std::move(shareUrl)), m_pipeline(std::move(pipeline)),
+          m_transferExecutor(std::move(transferExecutor)), m_bufferPool(std::move(bufferPool))
     {
     }
     friend class ShareLeaseClient;
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <azure/core/internal/http/pipeline.hpp>
 #include <azure/core/response.hpp>
@@ -138,6 +140,23 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         const DeleteDirectoryOptions& options = DeleteDirectoryOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Deletes the directory with its files and its subdirectories. The tree is listed with
+     * several directories listed at the same time, then the files are deleted concurrently, then
+     * the subdirectories, deepest first, each of them once it's empty.
+     *
+     * @remark The files and the directories created in the tree while it's deleted may fail the
+     * delete of their parent directory.
+     *
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::DeleteDirectoryRecursiveResult> containing the number of
+     * files and directories deleted.
+     */
+    Azure::Response<Models::DeleteDirectoryRecursiveResult> DeleteRecursive(
+        const DeleteDirectoryRecursiveOptions& options = DeleteDirectoryRecursiveOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Gets the properties of the directory.
      * @param options Optional parameters to get this directory's properties.
@@ -188,6 +207,29 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         const ListFilesAndDirectoriesOptions& options = ListFilesAndDirectoriesOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Lists the files and the directories of this directory and of its subdirectories,
+     * recursively, with several directories listed at the same time.
+     *
+     * @remark The pages of entries are passed to \p onItems once they are received, from several
+     * threads at the same time, so that at most one page per directory listed at the same time is
+     * held in memory. The pages aren't ordered.
+     *
+     * @param onItems Called with the path of the directory listed, relative to this directory and
+     * empty for this directory itself, and with the subdirectories and the files of each page. It
+     * must be safe to call it from several threads at the same time.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     */
+    void ListFilesAndDirectoriesConcurrently(
+        const std::function<void(
+            const std::string&,
+            std::vector<Models::DirectoryItem>,
+            std::vector<Models::FileItem>)>& onItems,
+        const ListFilesAndDirectoriesConcurrentlyOptions& options
+        = ListFilesAndDirectoriesConcurrentlyOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Returns a sequence of the open handles on a directory or a file. Enumerating the
      * handles may make multiple requests to the service while fetching all the values.
@@ -228,11 +270,16 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
   private:
     Azure::Core::Url m_shareDirectoryUrl;
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    std::shared_ptr<TransferExecutor> m_transferExecutor;
+    std::shared_ptr<BufferPool> m_bufferPool;
 
     explicit ShareDirectoryClient(
         Azure::Core::Url shareDirectoryUrl,
-        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline)
-        : m_shareDirectoryUrl(std::move(shareDirectoryUrl)), m_pipeline(std::move(pipeline))
+        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline,
+        std::shared_ptr<TransferExecutor> transferExecutor,
+        std::shared_ptr<BufferPool> bufferPool)
+        : m_shareDirectoryUrl(std::move(shareDirectoryUrl)), m_pipeline(std::move(pipeline)),
+          m_transferExecutor(std::move(transferExecutor)), m_bufferPool(std::move(bufferPool))
     {
     }
 
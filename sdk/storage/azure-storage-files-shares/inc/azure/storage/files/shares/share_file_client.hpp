@@ -13,6 +13,7 @@
 #include "azure/storage/files/shares/protocol/share_rest_client.hpp"
 #include "azure/storage/files/shares/share_client.hpp"
 #include "azure/storage/files/shares/share_directory_client.hpp"
+#include "azure/storage/files/shares/share_file_writer.hpp"
 #include "azure/storage/files/shares/share_options.hpp"
 #include "azure/storage/files/shares/share_responses.hpp"
 
@@ -154,6 +155,48 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         const DownloadFileToOptions& options = DownloadFileToOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Downloads the valid ranges of this file to a local file, concurrently. The rest of
+     * the local file is left as holes reading as zeros, so that the unallocated ranges of a mostly
+     * empty file, such as a virtual disk or a database file, are neither downloaded nor written to
+     * the disk.
+     *
+     * @remark The local file is only sparse on file systems which support sparse files, elsewhere
+     * the holes take disk space but are still not downloaded.
+     *
+     * @param fileName A file path to write the downloaded content to.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::DownloadFileSparseToResult> describing the downloaded file.
+     */
+    Azure::Response<Models::DownloadFileSparseToResult> DownloadSparseTo(
+        const std::string& fileName,
+        const DownloadFileSparseToOptions& options = DownloadFileSparseToOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Brings a local file holding a copy of a previous share snapshot of this file up to
+     * date, downloading only the ranges changed since the snapshot. The changed ranges are
+     * downloaded concurrently and the cleared ones are zeroed in the local file, as holes on file
+     * systems which support sparse files.
+     *
+     * @remark The local file is resized to the size of the file, it is created if it doesn't
+     * exist. The changed and cleared ranges are returned so that they can be applied to another
+     * copy of the file with #UploadDiffFrom.
+     *
+     * @param previousShareSnapshot The share snapshot the local file is a copy of, which must be
+     * older than this file or share snapshot.
+     * @param fileName The path of the copy of the previous share snapshot.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::DownloadFileDiffToResult> describing the downloaded file.
+     */
+    Azure::Response<Models::DownloadFileDiffToResult> DownloadDiffTo(
+        const std::string& previousShareSnapshot,
+        const std::string& fileName,
+        const DownloadFileDiffToOptions& options = DownloadFileDiffToOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Creates a new file, or updates the content of an existing file. Updating
      * an existing file overwrites any existing metadata on the file.
@@ -258,6 +301,29 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         const SetFileMetadataOptions& options = SetFileMetadataOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Applies changes made to a local file to this file, which holds a copy of the local
+     * file before the changes. The changed ranges are uploaded concurrently from the local file
+     * and the cleared ones are cleared in this file, so that only the changes are transferred.
+     *
+     * @remark This file is resized to the size of the local file if they differ, its HTTP headers
+     * and SMB properties are kept. The ranges are typically those returned by #DownloadDiffTo or
+     * #GetRangeListDiff on the source of the copy.
+     *
+     * @param fileName The path of the local file.
+     * @param ranges The ranges changed in the local file, to upload.
+     * @param clearRanges The ranges cleared in the local file, to clear.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::UploadFileDiffFromResult> describing the updated file.
+     */
+    Azure::Response<Models::UploadFileDiffFromResult> UploadDiffFrom(
+        const std::string& fileName,
+        const std::vector<Azure::Core::Http::HttpRange>& ranges,
+        const std::vector<Azure::Core::Http::HttpRange>& clearRanges,
+        const UploadFileDiffFromOptions& options = UploadFileDiffFromOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Uploads some data to a range of the file.
      * @param offset Specifies the starting offset for the content to be written as a range.
@@ -272,6 +338,15 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         const UploadFileRangeOptions& options = UploadFileRangeOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Opens a writer writing to this file at random offsets, which merges the adjacent and
+     * overlapping writes and uploads them by ranges, concurrently, instead of a request per write.
+     * @param options Optional parameters to open the writer.
+     * @return A ShareFileWriter writing to the file.
+     */
+    std::unique_ptr<ShareFileWriter> OpenWrite(
+        const OpenWriteShareFileOptions& options = OpenWriteShareFileOptions()) const;
+
     /**
      * @brief Clears some range of data within the file.
      * @param offset Specifies the starting offset for the content to be cleared within the file.
@@ -361,14 +436,37 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         const UploadFileRangeFromUriOptions& options = UploadFileRangeFromUriOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Copies a file or a blob into this file on the service side, copying the ranges of
+     * the source concurrently with UploadRangeFromUri. The data of the source isn't transferred
+     * through the client.
+     *
+     * @remark The file is created with the size of the source, unless a resumable copy keeps it.
+     *
+     * @param sourceUri Specifies the URL of the source file or blob, up to 2 KB in length. The
+     * source must either be public or must be authorized via a shared access signature.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return Azure::Response<Models::CopyFileFromUriParallelResult> describing the copy.
+     */
+    Azure::Response<Models::CopyFileFromUriParallelResult> CopyFromUriParallel(
+        const std::string& sourceUri,
+        const CopyFileFromUriParallelOptions& options = CopyFileFromUriParallelOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
   private:
     Azure::Core::Url m_shareFileUrl;
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    std::shared_ptr<TransferExecutor> m_transferExecutor;
+    std::shared_ptr<BufferPool> m_bufferPool;
 
     explicit ShareFileClient(
         Azure::Core::Url shareFileUrl,
-        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline)
-        : m_shareFileUrl(std::move(shareFileUrl)), m_pipeline(std::move(pipeline))
+        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline,
+        std::shared_ptr<TransferExecutor> transferExecutor,
+        std::shared_ptr<BufferPool> bufferPool)
+        : m_shareFileUrl(std::move(shareFileUrl)), m_pipeline(std::move(pipeline)),
+          m_transferExecutor(std::move(transferExecutor)), m_bufferPool(std::move(bufferPool))
     {
     }
 
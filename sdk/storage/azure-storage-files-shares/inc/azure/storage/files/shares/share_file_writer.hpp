@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <azure/core/context.hpp>
+#include <azure/storage/common/transfer_executor.hpp>
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares {
+
+  class ShareFileClient;
+  struct OpenWriteShareFileOptions;
+
+  /**
+   * @brief A writer writing to a file at random offsets, returned by
+   * #Azure::Storage::Files::Shares::ShareFileClient::OpenWrite.
+   *
+   * @remark The data written is buffered in memory, the adjacent and overlapping writes merged
+   * with the latest data winning, until it reaches the maximum buffered size of the options or
+   * until Flush() is called. It's then uploaded by ranges of up to the range size of the options,
+   * several ranges at the same time. The file must be large enough for the data written. The
+   * writer is thread-safe.
+   */
+  class ShareFileWriter final {
+  public:
+    /**
+     * @brief Uploads the data written and not uploaded yet, ignoring failures. Call Flush() first
+     * to know whether the data was uploaded.
+     */
+    ~ShareFileWriter();
+
+    /**
+     * @brief Writes data to the file at an offset. The data is copied, and uploaded later.
+     *
+     * @param offset The offset of the file to write the data at.
+     * @param data The data to write.
+     * @param length The number of bytes of data.
+     * @param context Context for cancelling the upload of the data buffered, when the write fills
+     * the buffer.
+     *
+     * @throw Azure::Storage::StorageException A previous upload failed, the data wasn't written.
+     */
+    void WriteAt(
+        int64_t offset,
+        const uint8_t* data,
+        size_t length,
+        const Azure::Core::Context& context = Azure::Core::Context());
+
+    /**
+     * @brief Uploads all the data written so far, and waits for it to be uploaded.
+     *
+     * @param context Context for cancelling the upload.
+     *
+     * @throw Azure::Storage::StorageException An upload failed. All the following writes and
+     * flushes fail too.
+     */
+    void Flush(const Azure::Core::Context& context = Azure::Core::Context());
+
+  private:
+    struct State;
+
+    explicit ShareFileWriter(
+        const ShareFileClient& client,
+        const OpenWriteShareFileOptions& options,
+        std::shared_ptr<TransferExecutor> transferExecutor);
+
+    std::unique_ptr<State> m_state;
+
+    friend class ShareFileClient;
+  };
+
+}}}} // namespace Azure::Storage::Files::Shares
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -10,6 +11,10 @@
 #include <azure/core/internal/client_options.hpp>
 #include <azure/core/nullable.hpp>
 #include <azure/storage/common/access_conditions.hpp>
+#include <azure/storage/common/buffer_pool.hpp>
+#include <azure/storage/common/congestion_controller.hpp>
+#include <azure/storage/common/rate_limiter.hpp>
+#include <azure/storage/common/transfer_executor.hpp>
 
 #include "azure/storage/files/shares/protocol/share_rest_client.hpp"
 
@@ -26,6 +31,32 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
      * API version used by this client.
      */
     std::string ApiVersion = _detail::DefaultServiceApiVersion;
+
+    /**
+     * @brief The executor on which the chunks of concurrent uploads and downloads are
+     * transferred. If null, the default executor shared by all the clients is used.
+     */
+    std::shared_ptr<Azure::Storage::TransferExecutor> TransferExecutor;
+
+    /**
+     * @brief The pool of the buffers through which the chunks of concurrent uploads and downloads
+     * are transferred, which limits their memory. If null, the default pool shared by all the
+     * clients is used.
+     */
+    std::shared_ptr<Azure::Storage::BufferPool> BufferPool;
+
+    /**
+     * @brief Limits the bandwidth and the rate of the requests of the client. The same limiter
+     * can be shared by several clients. If null, there is no limit.
+     */
+    std::shared_ptr<Azure::Storage::RateLimiter> RateLimiter;
+
+    /**
+     * @brief Limits the number of requests of the client in flight to each account, adjusting
+     * the limits when the accounts throttle the requests. The same controller can be shared by
+     * several clients. If null, the requests in flight aren't limited.
+     */
+    std::shared_ptr<Azure::Storage::CongestionController> CongestionController;
   };
 
   /**
@@ -216,6 +247,25 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
   {
   };
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::Shares::ShareDirectoryClient::DeleteRecursive.
+   */
+  struct DeleteDirectoryRecursiveOptions final
+  {
+    /**
+     * If true, the handles open on the directory, its files and its subdirectories are closed
+     * before they are deleted, so that open handles don't fail the deletes.
+     */
+    bool ForceCloseHandles = false;
+
+    /**
+     * The maximum number of directories listed, and of files and directories deleted, at the
+     * same time.
+     */
+    int32_t Concurrency = 8;
+  };
+
   /**
    * @brief Optional parameters for
    * #Azure::Storage::Files::Shares::ShareDirectoryClient::GetProperties.
@@ -275,6 +325,42 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     Azure::Nullable<int32_t> PageSizeHint;
   };
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::Shares::ShareDirectoryClient::ListFilesAndDirectoriesConcurrently.
+   */
+  struct ListFilesAndDirectoriesConcurrentlyOptions final
+  {
+    /**
+     * Filters the entries of this directory to those whose name begins with the specified prefix.
+     * The subdirectories listed are listed entirely.
+     */
+    Azure::Nullable<std::string> Prefix;
+
+    /**
+     * The depth of the deepest subdirectories listed, 0 lists only this directory, 1 its
+     * subdirectories as well, and so on. All the subdirectories are listed when it's null.
+     */
+    Azure::Nullable<int32_t> MaxDepth;
+
+    /**
+     * The maximum number of directories listed at the same time.
+     */
+    int32_t Concurrency = 8;
+
+    /**
+     * The maximum number of directories found and waiting to be listed by any thread. The
+     * directories found beyond it are listed later by the thread which found them, so that the
+     * memory held by a wide share stays bounded.
+     */
+    int32_t MaxPendingDirectories = 1024;
+
+    /**
+     * Specifies the maximum number of entries to return in each page.
+     */
+    Azure::Nullable<int32_t> PageSizeHint;
+  };
+
   /**
    * @brief Optional parameters for
    * #Azure::Storage::Files::Shares::ShareDirectoryClient::ListHandles.
@@ -516,6 +602,33 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     LeaseAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for #Azure::Storage::Files::Shares::ShareFileClient::OpenWrite.
+   */
+  struct OpenWriteShareFileOptions final
+  {
+    /**
+     * The maximum number of bytes uploaded by a single request. This value cannot be larger than
+     * 4 MiB.
+     */
+    int64_t RangeSize = 4 * 1024 * 1024;
+
+    /**
+     * The maximum number of ranges uploaded at the same time.
+     */
+    int32_t Concurrency = 5;
+
+    /**
+     * The number of bytes written which makes the writer upload the data buffered.
+     */
+    int64_t MaxBufferedSize = 16 * 1024 * 1024;
+
+    /**
+     * Every upload will only succeed if the access condition is met.
+     */
+    LeaseAccessConditions AccessConditions;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Files::Shares::ShareFileClient::ClearRange.
    */
@@ -550,6 +663,69 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     LeaseAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::Shares::ShareFileClient::CopyFromUriParallel.
+   */
+  struct CopyFileFromUriParallelOptions final
+  {
+    /**
+     * The size of the source. The properties of the source are fetched to get its size if it
+     * isn't set, which requires the source to be a file. It must be set to copy from a blob.
+     */
+    Azure::Nullable<int64_t> SourceLength;
+
+    /**
+     * The standard HTTP header system properties of the file created. They aren't copied from the
+     * source.
+     */
+    Models::FileHttpHeaders HttpHeaders;
+
+    /**
+     * Name-value pairs associated with the file created as metadata. They aren't copied from the
+     * source.
+     */
+    Storage::Metadata Metadata;
+
+    /**
+     * Called after each range is copied with the number of bytes copied so far, including those
+     * copied before a resumed copy, and the size of the source. It's called by the threads
+     * copying the ranges, one at a time.
+     */
+    std::function<void(int64_t, int64_t)> ProgressHandler;
+
+    /**
+     * If true, the ranges already copied by an interrupted copy of the same source to this file
+     * are skipped instead of being copied again. The file is kept if it has the size of the
+     * source, and a range is skipped if it's entirely within the valid ranges of the file. The
+     * interrupted copy must have used the same ChunkSize, and the source must not have changed
+     * since.
+     */
+    bool Resumable = false;
+
+    /**
+     * The operation will only succeed if the lease access condition is met.
+     */
+    LeaseAccessConditions AccessConditions;
+
+    /**
+     * Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * The size of the ranges of the source copied with a request each. This value cannot be
+       * larger than 4 MiB.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * The maximum number of ranges copied at the same time.
+       */
+      int32_t Concurrency = 5;
+    } TransferOptions;
+  };
+
   /**
    * @brief Optional parameters for #Azure::Storage::Files::Shares::ShareFileClient::GetRangeList.
    */
@@ -641,6 +817,108 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
        * The maximum number of threads that may be used in a parallel transfer.
        */
       int32_t Concurrency = 5;
+
+      /**
+       * If true, the chunk size and the concurrency are tuned while the file is downloaded from
+       * the measured throughput, between 1 MiB and ChunkSize and between 1 and Concurrency. They
+       * start small and grow until the throughput stops improving, and shrink when it drops.
+       */
+      bool AutoTune = false;
+
+      /**
+       * If true, the file downloaded to by `DownloadTo(fileName)` is written bypassing the page
+       * cache of the operating system where the file system supports it, so that large downloads
+       * don't evict other data from the cache. The parts of the ranges which aren't aligned to the
+       * block size of the file system are still written through the cache.
+       */
+      bool UnbufferedIo = false;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::Shares::ShareFileClient::DownloadSparseTo.
+   */
+  struct DownloadFileSparseToOptions final
+  {
+    /**
+     * @brief The operation will only succeed if the access condition is met.
+     */
+    LeaseAccessConditions AccessConditions;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The maximum number of bytes in a single request. Valid ranges larger than this are
+       * downloaded in several requests.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of threads that may be used in a parallel transfer.
+       */
+      int32_t Concurrency = 5;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::Shares::ShareFileClient::DownloadDiffTo.
+   */
+  struct DownloadFileDiffToOptions final
+  {
+    /**
+     * @brief The operation will only succeed if the access condition is met.
+     */
+    LeaseAccessConditions AccessConditions;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The maximum number of bytes in a single request. Changed ranges larger than this
+       * are downloaded in several requests.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of threads that may be used in a parallel transfer.
+       */
+      int32_t Concurrency = 5;
+    } TransferOptions;
+  };
+
+  /**
+   * @brief Optional parameters for
+   * #Azure::Storage::Files::Shares::ShareFileClient::UploadDiffFrom.
+   */
+  struct UploadFileDiffFromOptions final
+  {
+    /**
+     * @brief The operation will only succeed if the access condition is met.
+     */
+    LeaseAccessConditions AccessConditions;
+
+    /**
+     * @brief Options for parallel transfer.
+     */
+    struct
+    {
+      /**
+       * @brief The maximum number of bytes in a single request. Changed ranges larger than this
+       * are uploaded in several requests. It can't be larger than 4 MiB.
+       */
+      int64_t ChunkSize = 4 * 1024 * 1024;
+
+      /**
+       * @brief The maximum number of threads that may be used in a parallel transfer.
+       */
+      int32_t Concurrency = 5;
     } TransferOptions;
   };
 
@@ -692,6 +970,20 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
        * The maximum number of threads that may be used in a parallel transfer.
        */
       int32_t Concurrency = 5;
+
+      /**
+       * If true, the chunk size and the concurrency are tuned while the file is uploaded from
+       * the measured throughput, between 1 MiB and ChunkSize and between 1 and Concurrency. They
+       * start small and grow until the throughput stops improving, and shrink when it drops.
+       */
+      bool AutoTune = false;
+
+      /**
+       * If true, the file uploaded by `UploadFrom(fileName)` is read bypassing the page cache of
+       * the operating system where the file system supports it, so that large uploads don't evict
+       * other data from the cache.
+       */
+      bool UnbufferedIo = false;
     } TransferOptions;
   };
 
@@ -184,6 +184,118 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       DownloadFileDetails Details;
     };
 
+    /**
+     * @brief The information returned when downloading the valid ranges of a file to a sparse
+     * file.
+     */
+    struct DownloadFileSparseToResult final
+    {
+      /**
+       * The ETag of the downloaded version of the file.
+       */
+      Azure::ETag ETag;
+
+      /**
+       * The data and time the file was last modified.
+       */
+      DateTime LastModified;
+
+      /**
+       * The size of the file, and of the local file written.
+       */
+      int64_t FileSize = 0;
+
+      /**
+       * The number of bytes downloaded, the size of the valid ranges of the file.
+       */
+      int64_t DownloadedSize = 0;
+    };
+
+    /**
+     * @brief The information returned when deleting a directory recursively.
+     */
+    struct DeleteDirectoryRecursiveResult final
+    {
+      /**
+       * The number of files deleted.
+       */
+      int64_t DeletedFileCount = 0;
+
+      /**
+       * The number of directories deleted, including the directory itself.
+       */
+      int64_t DeletedDirectoryCount = 0;
+
+      /**
+       * The number of handles closed before the deletes.
+       */
+      int64_t ClosedHandleCount = 0;
+    };
+
+    /**
+     * @brief The information returned when bringing a local copy of a previous share snapshot of
+     * a file up to date.
+     */
+    struct DownloadFileDiffToResult final
+    {
+      /**
+       * The ETag of the downloaded version of the file.
+       */
+      Azure::ETag ETag;
+
+      /**
+       * The data and time the file was last modified.
+       */
+      DateTime LastModified;
+
+      /**
+       * The size of the file, and of the local file written.
+       */
+      int64_t FileSize = 0;
+
+      /**
+       * The ranges changed since the previous share snapshot, which were downloaded.
+       */
+      std::vector<Azure::Core::Http::HttpRange> Ranges;
+
+      /**
+       * The ranges cleared since the previous share snapshot, which were zeroed in the local file.
+       */
+      std::vector<Azure::Core::Http::HttpRange> ClearRanges;
+
+      /**
+       * The number of bytes downloaded, the size of the changed ranges.
+       */
+      int64_t DownloadedSize = 0;
+
+      /**
+       * The number of bytes zeroed in the local file, the size of the cleared ranges.
+       */
+      int64_t ClearedSize = 0;
+    };
+
+    /**
+     * @brief The information returned when applying the changed and cleared ranges of a local
+     * file to a file.
+     */
+    struct UploadFileDiffFromResult final
+    {
+      /**
+       * The size of the file after the update, the size of the local file.
+       */
+      int64_t FileSize = 0;
+
+      /**
+       * The number of bytes uploaded, the size of the changed ranges.
+       */
+      int64_t UploadedSize = 0;
+
+      /**
+       * The number of bytes cleared in the file, the size of the cleared ranges.
+       */
+      int64_t ClearedSize = 0;
+    };
+
     /**
      * @brief The information returned when forcing a file handle to close.
      */
@@ -202,6 +314,29 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       bool IsServerEncrypted = false;
     };
 
+    /**
+     * @brief The information returned when copying a file from a source with parallel range
+     * copies.
+     */
+    struct CopyFileFromUriParallelResult final
+    {
+      /**
+       * The size of the source, and of the file.
+       */
+      int64_t FileSize = 0;
+
+      /**
+       * The number of bytes copied by this operation.
+       */
+      int64_t CopiedSize = 0;
+
+      /**
+       * The number of bytes skipped because they were copied by an interrupted copy which was
+       * resumed.
+       */
+      int64_t ResumedSize = 0;
+    };
+
   } // namespace Models
 
   /**
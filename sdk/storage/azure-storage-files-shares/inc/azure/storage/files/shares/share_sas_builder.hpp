@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <type_traits>
 
@@ -10,8 +11,16 @@
 #include <azure/storage/common/account_sas_builder.hpp>
 #include <azure/storage/common/internal/constants.hpp>
 
+namespace Azure { namespace Storage {
+  namespace _internal {
+    class SasTokenTemplate;
+  } // namespace _internal
+}} // namespace Azure::Storage
+
 namespace Azure { namespace Storage { namespace Sas {
 
+  class ShareSasTokenGenerator;
+
   /**
    * @brief Specifies which resources are accessible via the shared access signature.
    */
@@ -231,7 +240,42 @@ namespace Azure { namespace Storage { namespace Sas {
     std::string GenerateSasToken(const StorageSharedKeyCredential& credential);
 
   private:
+    friend class ShareSasTokenGenerator;
     std::string Permissions;
   };
 
+  /**
+   * @brief ShareSasTokenGenerator is used to generate the Shared Access Signatures (SAS) of many
+   * files of a share, which only differ by the file path.
+   *
+   * @details The parts of the SAS which are the same for all the files, such as the permissions
+   * and the expiry, are formatted and signed once when the generator is constructed, so
+   * generating the SAS of a file only signs its path. The tokens are the same as the ones of
+   * ShareSasBuilder with the file path.
+   */
+  class ShareSasTokenGenerator final {
+  public:
+    /**
+     * @brief Constructs a generator signing the SAS with a StorageSharedKeyCredential.
+     *
+     * @param builder The properties of the SAS. Its resource must be a file. Its file path is
+     * ignored.
+     * @param credential The storage account's shared key credential.
+     */
+    explicit ShareSasTokenGenerator(
+        const ShareSasBuilder& builder,
+        const StorageSharedKeyCredential& credential);
+
+    /**
+     * @brief Generates the SAS of a file. Can be called concurrently.
+     *
+     * @param filePath The path of the file being made accessible.
+     * @return The SAS query parameters used for authenticating requests.
+     */
+    std::string GenerateSasToken(const std::string& filePath) const;
+
+  private:
+    std::shared_ptr<const _internal::SasTokenTemplate> m_template;
+  };
+
 }}} // namespace Azure::Storage::Sas
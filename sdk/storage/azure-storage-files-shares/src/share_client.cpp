@@ -6,10 +6,11 @@
 #include <azure/core/credentials/credentials.hpp>
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
 #include <azure/storage/common/internal/constants.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
 #include "azure/storage/files/shares/share_directory_client.hpp"
@@ -19,6 +20,29 @@
 
 namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
+  namespace {
+    _detail::ShareRestClient::Share::CreateOptions GetCreateProtocolLayerOptions(
+        const CreateShareOptions& options)
+    {
+      auto protocolLayerOptions = _detail::ShareRestClient::Share::CreateOptions();
+      protocolLayerOptions.Metadata = options.Metadata;
+      protocolLayerOptions.ShareQuota = options.ShareQuotaInGiB;
+      protocolLayerOptions.XMsAccessTier = options.AccessTier;
+      return protocolLayerOptions;
+    }
+
+    _detail::ShareRestClient::Share::DeleteOptions GetDeleteProtocolLayerOptions(
+        const DeleteShareOptions& options)
+    {
+      auto protocolLayerOptions = _detail::ShareRestClient::Share::DeleteOptions();
+      if (options.DeleteSnapshots.HasValue() && options.DeleteSnapshots.Value())
+      {
+        protocolLayerOptions.XMsDeleteSnapshots = Models::DeleteSnapshotsOption::Include;
+      }
+      return protocolLayerOptions;
+    }
+  } // namespace
+
   ShareClient ShareClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& shareName,
@@ -42,7 +66,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const std::string& shareUrl,
       std::shared_ptr<StorageSharedKeyCredential> credential,
       const ShareClientOptions& options)
-      : m_shareUrl(shareUrl)
+      : m_shareUrl(shareUrl), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     ShareClientOptions newOptions = options;
     newOptions.PerRetryPolicies.emplace_back(
@@ -50,36 +75,55 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::FileServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, newOptions.ApiVersion}});
   }
 
   ShareClient::ShareClient(const std::string& shareUrl, const ShareClientOptions& options)
-      : m_shareUrl(shareUrl)
+      : m_shareUrl(shareUrl), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::FileServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   ShareDirectoryClient ShareClient::GetRootDirectoryClient() const
   {
-    return ShareDirectoryClient(m_shareUrl, m_pipeline);
+    return ShareDirectoryClient(m_shareUrl, m_pipeline, m_transferExecutor, m_bufferPool);
   }
 
   ShareClient ShareClient::WithSnapshot(const std::string& snapshot) const
@@ -101,12 +145,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const CreateShareOptions& options,
       const Azure::Core::Context& context) const
   {
-    auto protocolLayerOptions = _detail::ShareRestClient::Share::CreateOptions();
-    protocolLayerOptions.Metadata = options.Metadata;
-    protocolLayerOptions.ShareQuota = options.ShareQuotaInGiB;
-    protocolLayerOptions.XMsAccessTier = options.AccessTier;
     auto result = _detail::ShareRestClient::Share::Create(
-        m_shareUrl, *m_pipeline, context, protocolLayerOptions);
+        m_shareUrl, *m_pipeline, context, GetCreateProtocolLayerOptions(options));
     Models::CreateShareResult ret;
     ret.Created = true;
     ret.ETag = std::move(result.Value.ETag);
@@ -119,33 +159,26 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const CreateShareOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
+    auto request = _detail::ShareRestClient::Share::CreateCreateMessage(
+        m_shareUrl, GetCreateProtocolLayerOptions(options));
+    auto response = m_pipeline->Send(request, context);
+    // An existing share is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response, Core::Http::HttpStatusCode::Conflict, {_detail::ShareAlreadyExists}))
     {
-      return Create(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.ErrorCode == _detail::ShareAlreadyExists)
-      {
-        Models::CreateShareResult ret;
-        ret.Created = false;
-        return Azure::Response<Models::CreateShareResult>(std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::CreateShareResult ret;
+      ret.Created = false;
+      return Azure::Response<Models::CreateShareResult>(std::move(ret), std::move(response));
     }
+    return _detail::ShareRestClient::Share::CreateCreateResponse(context, std::move(response));
   }
 
   Azure::Response<Models::DeleteShareResult> ShareClient::Delete(
       const DeleteShareOptions& options,
       const Azure::Core::Context& context) const
   {
-    auto protocolLayerOptions = _detail::ShareRestClient::Share::DeleteOptions();
-    if (options.DeleteSnapshots.HasValue() && options.DeleteSnapshots.Value())
-    {
-      protocolLayerOptions.XMsDeleteSnapshots = Models::DeleteSnapshotsOption::Include;
-    }
     auto result = _detail::ShareRestClient::Share::Delete(
-        m_shareUrl, *m_pipeline, context, protocolLayerOptions);
+        m_shareUrl, *m_pipeline, context, GetDeleteProtocolLayerOptions(options));
     Models::DeleteShareResult ret;
     ret.Deleted = true;
     return Azure::Response<Models::DeleteShareResult>(
@@ -156,20 +189,18 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const DeleteShareOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
+    auto request = _detail::ShareRestClient::Share::DeleteCreateMessage(
+        m_shareUrl, GetDeleteProtocolLayerOptions(options));
+    auto response = m_pipeline->Send(request, context);
+    // A missing share is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response, Core::Http::HttpStatusCode::NotFound, {_detail::ShareNotFound}))
     {
-      return Delete(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.ErrorCode == _detail::ShareNotFound)
-      {
-        Models::DeleteShareResult ret;
-        ret.Deleted = false;
-        return Azure::Response<Models::DeleteShareResult>(std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::DeleteShareResult ret;
+      ret.Deleted = false;
+      return Azure::Response<Models::DeleteShareResult>(std::move(ret), std::move(response));
     }
+    return _detail::ShareRestClient::Share::DeleteCreateResponse(context, std::move(response));
   }
 
   Azure::Response<Models::CreateShareSnapshotResult> ShareClient::CreateSnapshot(
@@ -3,13 +3,21 @@
 
 #include "azure/storage/files/shares/share_directory_client.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 #include <azure/core/credentials/credentials.hpp>
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
 #include <azure/storage/common/internal/constants.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
 #include "azure/storage/files/shares/share_file_client.hpp"
@@ -18,6 +26,52 @@
 
 namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
+  namespace {
+    _detail::ShareRestClient::Directory::CreateOptions GetCreateProtocolLayerOptions(
+        const CreateDirectoryOptions& options)
+    {
+      auto protocolLayerOptions = _detail::ShareRestClient::Directory::CreateOptions();
+      protocolLayerOptions.Metadata = options.Metadata;
+      protocolLayerOptions.FileAttributes = options.SmbProperties.Attributes.ToString();
+      if (protocolLayerOptions.FileAttributes.empty())
+      {
+        protocolLayerOptions.FileAttributes = Models::FileAttributes::Directory.ToString();
+      }
+      if (options.SmbProperties.CreatedOn.HasValue())
+      {
+        protocolLayerOptions.FileCreationTime = options.SmbProperties.CreatedOn.Value().ToString(
+            Azure::DateTime::DateFormat::Rfc3339, DateTime::TimeFractionFormat::AllDigits);
+      }
+      else
+      {
+        protocolLayerOptions.FileCreationTime = std::string(FileDefaultTimeValue);
+      }
+      if (options.SmbProperties.LastWrittenOn.HasValue())
+      {
+        protocolLayerOptions.FileLastWriteTime
+            = options.SmbProperties.LastWrittenOn.Value().ToString(
+                Azure::DateTime::DateFormat::Rfc3339, DateTime::TimeFractionFormat::AllDigits);
+      }
+      else
+      {
+        protocolLayerOptions.FileLastWriteTime = std::string(FileDefaultTimeValue);
+      }
+      if (options.DirectoryPermission.HasValue())
+      {
+        protocolLayerOptions.FilePermission = options.DirectoryPermission.Value();
+      }
+      else if (options.SmbProperties.PermissionKey.HasValue())
+      {
+        protocolLayerOptions.FilePermissionKey = options.SmbProperties.PermissionKey;
+      }
+      else
+      {
+        protocolLayerOptions.FilePermission = std::string(FileInheritPermission);
+      }
+      return protocolLayerOptions;
+    }
+  } // namespace
+
   ShareDirectoryClient ShareDirectoryClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& shareName,
@@ -44,7 +98,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const std::string& shareDirectoryUrl,
       std::shared_ptr<StorageSharedKeyCredential> credential,
       const ShareClientOptions& options)
-      : m_shareDirectoryUrl(shareDirectoryUrl)
+      : m_shareDirectoryUrl(shareDirectoryUrl), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     ShareClientOptions newOptions = options;
     newOptions.PerRetryPolicies.emplace_back(
@@ -52,33 +107,52 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::FileServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, newOptions.ApiVersion}});
   }
 
   ShareDirectoryClient::ShareDirectoryClient(
       const std::string& shareDirectoryUrl,
       const ShareClientOptions& options)
-      : m_shareDirectoryUrl(shareDirectoryUrl)
+      : m_shareDirectoryUrl(shareDirectoryUrl), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::FileServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   ShareDirectoryClient ShareDirectoryClient::GetSubdirectoryClient(
@@ -86,14 +160,14 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
   {
     auto builder = m_shareDirectoryUrl;
     builder.AppendPath(_internal::UrlEncodePath(subdirectoryName));
-    return ShareDirectoryClient(builder, m_pipeline);
+    return ShareDirectoryClient(builder, m_pipeline, m_transferExecutor, m_bufferPool);
   }
 
   ShareFileClient ShareDirectoryClient::GetFileClient(const std::string& fileName) const
   {
     auto builder = m_shareDirectoryUrl;
     builder.AppendPath(_internal::UrlEncodePath(fileName));
-    return ShareFileClient(builder, m_pipeline);
+    return ShareFileClient(builder, m_pipeline, m_transferExecutor, m_bufferPool);
   }
 
   ShareDirectoryClient ShareDirectoryClient::WithShareSnapshot(
@@ -116,45 +190,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const CreateDirectoryOptions& options,
       const Azure::Core::Context& context) const
   {
-    auto protocolLayerOptions = _detail::ShareRestClient::Directory::CreateOptions();
-    protocolLayerOptions.Metadata = options.Metadata;
-    protocolLayerOptions.FileAttributes = options.SmbProperties.Attributes.ToString();
-    if (protocolLayerOptions.FileAttributes.empty())
-    {
-      protocolLayerOptions.FileAttributes = Models::FileAttributes::Directory.ToString();
-    }
-    if (options.SmbProperties.CreatedOn.HasValue())
-    {
-      protocolLayerOptions.FileCreationTime = options.SmbProperties.CreatedOn.Value().ToString(
-          Azure::DateTime::DateFormat::Rfc3339, DateTime::TimeFractionFormat::AllDigits);
-    }
-    else
-    {
-      protocolLayerOptions.FileCreationTime = std::string(FileDefaultTimeValue);
-    }
-    if (options.SmbProperties.LastWrittenOn.HasValue())
-    {
-      protocolLayerOptions.FileLastWriteTime = options.SmbProperties.LastWrittenOn.Value().ToString(
-          Azure::DateTime::DateFormat::Rfc3339, DateTime::TimeFractionFormat::AllDigits);
-    }
-    else
-    {
-      protocolLayerOptions.FileLastWriteTime = std::string(FileDefaultTimeValue);
-    }
-    if (options.DirectoryPermission.HasValue())
-    {
-      protocolLayerOptions.FilePermission = options.DirectoryPermission.Value();
-    }
-    else if (options.SmbProperties.PermissionKey.HasValue())
-    {
-      protocolLayerOptions.FilePermissionKey = options.SmbProperties.PermissionKey;
-    }
-    else
-    {
-      protocolLayerOptions.FilePermission = std::string(FileInheritPermission);
-    }
     auto result = _detail::ShareRestClient::Directory::Create(
-        m_shareDirectoryUrl, *m_pipeline, context, protocolLayerOptions);
+        m_shareDirectoryUrl, *m_pipeline, context, GetCreateProtocolLayerOptions(options));
     Models::CreateDirectoryResult ret;
     ret.Created = true;
     ret.ETag = std::move(result.Value.ETag);
@@ -171,21 +208,18 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const Azure::Core::Context& context) const
 
   {
-    try
+    auto request = _detail::ShareRestClient::Directory::CreateCreateMessage(
+        m_shareDirectoryUrl, GetCreateProtocolLayerOptions(options));
+    auto response = m_pipeline->Send(request, context);
+    // An existing directory is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response, Core::Http::HttpStatusCode::Conflict, {_detail::ResourceAlreadyExists}))
     {
-      return Create(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.ErrorCode == _detail::ResourceAlreadyExists)
-      {
-        Models::CreateDirectoryResult ret;
-        ret.Created = false;
-        return Azure::Response<Models::CreateDirectoryResult>(
-            std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
+      Models::CreateDirectoryResult ret;
+      ret.Created = false;
+      return Azure::Response<Models::CreateDirectoryResult>(std::move(ret), std::move(response));
     }
+    return _detail::ShareRestClient::Directory::CreateCreateResponse(context, std::move(response));
   }
 
   Azure::Response<Models::DeleteDirectoryResult> ShareDirectoryClient::Delete(
@@ -206,22 +240,114 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const DeleteDirectoryOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
+    (void)options;
+    auto request = _detail::ShareRestClient::Directory::DeleteCreateMessage(
+        m_shareDirectoryUrl, _detail::ShareRestClient::Directory::DeleteOptions());
+    auto response = m_pipeline->Send(request, context);
+    // A missing directory is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response,
+            Core::Http::HttpStatusCode::NotFound,
+            {_detail::ShareNotFound, _detail::ParentNotFound, _detail::ResourceNotFound}))
     {
-      return Delete(options, context);
+      Models::DeleteDirectoryResult ret;
+      ret.Deleted = false;
+      return Azure::Response<Models::DeleteDirectoryResult>(std::move(ret), std::move(response));
     }
-    catch (StorageException& e)
+    return _detail::ShareRestClient::Directory::DeleteCreateResponse(context, std::move(response));
+  }
+
+  Azure::Response<Models::DeleteDirectoryRecursiveResult> ShareDirectoryClient::DeleteRecursive(
+      const DeleteDirectoryRecursiveOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    Models::DeleteDirectoryRecursiveResult ret;
+    if (options.ForceCloseHandles)
     {
-      if (e.ErrorCode == _detail::ShareNotFound || e.ErrorCode == _detail::ParentNotFound
-          || e.ErrorCode == _detail::ResourceNotFound)
+      ForceCloseAllDirectoryHandlesOptions closeHandlesOptions;
+      closeHandlesOptions.Recursive = true;
+      for (auto page = ForceCloseAllHandles(closeHandlesOptions, context); page.HasPage();
+           page.MoveToNextPage(context))
       {
-        Models::DeleteDirectoryResult ret;
-        ret.Deleted = false;
-        return Azure::Response<Models::DeleteDirectoryResult>(
-            std::move(ret), std::move(e.RawResponse));
+        ret.ClosedHandleCount += page.NumberOfHandlesClosed;
       }
-      throw;
     }
+
+    std::mutex itemsMutex;
+    std::vector<std::string> filePaths;
+    // The paths of the subdirectories, by depth.
+    std::vector<std::vector<std::string>> directoryPaths;
+    ListFilesAndDirectoriesConcurrentlyOptions listOptions;
+    listOptions.Concurrency = options.Concurrency;
+    ListFilesAndDirectoriesConcurrently(
+        [&](const std::string& directoryPath,
+            std::vector<Models::DirectoryItem> directories,
+            std::vector<Models::FileItem> files) {
+          const std::string prefix = directoryPath.empty() ? std::string() : directoryPath + "/";
+          const size_t depth = directoryPath.empty()
+              ? 0
+              : static_cast<size_t>(std::count(directoryPath.begin(), directoryPath.end(), '/'))
+                  + 1;
+          std::lock_guard<std::mutex> guard(itemsMutex);
+          for (const auto& file : files)
+          {
+            filePaths.push_back(prefix + file.Name);
+          }
+          if (!directories.empty() && directoryPaths.size() <= depth)
+          {
+            directoryPaths.resize(depth + 1);
+          }
+          for (const auto& directory : directories)
+          {
+            directoryPaths[depth].push_back(prefix + directory.Name);
+          }
+        },
+        listOptions,
+        context);
+
+    // The items deleted in the meantime are skipped.
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.Concurrency;
+    std::atomic<int64_t> deletedFileCount{0};
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(filePaths.size()),
+        transferOptions,
+        [&](int64_t fileIndex, int64_t, int64_t) {
+          if (GetFileClient(filePaths[static_cast<size_t>(fileIndex)])
+                  .DeleteIfExists(DeleteFileOptions(), context)
+                  .Value.Deleted)
+          {
+            ++deletedFileCount;
+          }
+        },
+        m_transferExecutor);
+    ret.DeletedFileCount = deletedFileCount;
+
+    // The directories of a depth are empty once the deeper ones are deleted.
+    std::atomic<int64_t> deletedDirectoryCount{0};
+    for (auto level = directoryPaths.rbegin(); level != directoryPaths.rend(); ++level)
+    {
+      _internal::ConcurrentTransfer(
+          0,
+          static_cast<int64_t>(level->size()),
+          transferOptions,
+          [&](int64_t directoryIndex, int64_t, int64_t) {
+            if (GetSubdirectoryClient((*level)[static_cast<size_t>(directoryIndex)])
+                    .DeleteIfExists(DeleteDirectoryOptions(), context)
+                    .Value.Deleted)
+            {
+              ++deletedDirectoryCount;
+            }
+          },
+          m_transferExecutor);
+    }
+
+    auto deleteResponse = Delete(DeleteDirectoryOptions(), context);
+    ret.DeletedDirectoryCount = deletedDirectoryCount + 1;
+    return Azure::Response<Models::DeleteDirectoryRecursiveResult>(
+        std::move(ret), std::move(deleteResponse.RawResponse));
   }
 
   Azure::Response<Models::DirectoryProperties> ShareDirectoryClient::GetProperties(
@@ -318,12 +444,128 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     pagedResponse.m_shareDirectoryClient = std::make_shared<ShareDirectoryClient>(*this);
     pagedResponse.m_operationOptions = options;
     pagedResponse.CurrentPageToken = options.ContinuationToken.ValueOr(std::string());
-    pagedResponse.NextPageToken = response.Value.ContinuationToken;
+    pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
     pagedResponse.RawResponse = std::move(response.RawResponse);
 
     return pagedResponse;
   }
 
+  void ShareDirectoryClient::ListFilesAndDirectoriesConcurrently(
+      const std::function<void(
+          const std::string&,
+          std::vector<Models::DirectoryItem>,
+          std::vector<Models::FileItem>)>& onItems,
+      const ListFilesAndDirectoriesConcurrentlyOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    struct PendingDirectory
+    {
+      std::string Path;
+      int32_t Depth;
+    };
+
+    // The directories found while listing are queued, the listing is done once the queue is empty
+    // and no directory is being listed.
+    std::mutex directoriesMutex;
+    std::condition_variable directoriesChanged;
+    std::deque<PendingDirectory> pendingDirectories;
+    pendingDirectories.push_back({std::string(), 0});
+    const size_t maxPendingDirectories
+        = static_cast<size_t>(std::max<int32_t>(options.MaxPendingDirectories, 1));
+    int numListingDirectories = 0;
+    bool failed = false;
+
+    // Lists a directory, the subdirectories which don't fit in the queue are added to
+    // localDirectories.
+    auto listDirectory = [&](const PendingDirectory& directory,
+                             std::vector<PendingDirectory>& localDirectories) {
+      ListFilesAndDirectoriesOptions listOptions;
+      if (directory.Path.empty())
+      {
+        listOptions.Prefix = options.Prefix;
+      }
+      listOptions.PageSizeHint = options.PageSizeHint;
+      const bool listSubdirectories
+          = !options.MaxDepth.HasValue() || directory.Depth < options.MaxDepth.Value();
+      const auto directoryClient
+          = directory.Path.empty() ? *this : GetSubdirectoryClient(directory.Path);
+      for (auto page = directoryClient.ListFilesAndDirectories(listOptions, context);
+           page.HasPage();
+           page.MoveToNextPage(context))
+      {
+        if (listSubdirectories && !page.Directories.empty())
+        {
+          {
+            std::lock_guard<std::mutex> guard(directoriesMutex);
+            for (const auto& subdirectory : page.Directories)
+            {
+              PendingDirectory pendingDirectory{
+                  directory.Path.empty() ? subdirectory.Name
+                                         : directory.Path + "/" + subdirectory.Name,
+                  directory.Depth + 1};
+              if (pendingDirectories.size() < maxPendingDirectories)
+              {
+                pendingDirectories.push_back(std::move(pendingDirectory));
+              }
+              else
+              {
+                localDirectories.push_back(std::move(pendingDirectory));
+              }
+            }
+          }
+          directoriesChanged.notify_all();
+        }
+        onItems(directory.Path, std::move(page.Directories), std::move(page.Files));
+      }
+    };
+
+    _internal::ConcurrentStreamTransfer(
+        options.Concurrency,
+        [&](int64_t) -> std::function<void()> {
+          std::unique_lock<std::mutex> guard(directoriesMutex);
+          directoriesChanged.wait(guard, [&]() {
+            return failed || !pendingDirectories.empty() || numListingDirectories == 0;
+          });
+          if (failed || pendingDirectories.empty())
+          {
+            return nullptr;
+          }
+          PendingDirectory directory = std::move(pendingDirectories.front());
+          pendingDirectories.pop_front();
+          ++numListingDirectories;
+          return [&, directory]() {
+            bool directoryFailed = true;
+            // Wakes up the threads waiting for a directory even if the listing throws.
+            auto onDirectoryDone = [&]() {
+              {
+                std::lock_guard<std::mutex> doneGuard(directoriesMutex);
+                --numListingDirectories;
+                failed = failed || directoryFailed;
+              }
+              directoriesChanged.notify_all();
+            };
+            try
+            {
+              std::vector<PendingDirectory> localDirectories{directory};
+              while (!localDirectories.empty())
+              {
+                PendingDirectory localDirectory = std::move(localDirectories.back());
+                localDirectories.pop_back();
+                listDirectory(localDirectory, localDirectories);
+              }
+            }
+            catch (...)
+            {
+              onDirectoryDone();
+              throw;
+            }
+            directoryFailed = false;
+            onDirectoryDone();
+          };
+        },
+        m_transferExecutor);
+  }
+
   ListDirectoryHandlesPagedResponse ShareDirectoryClient::ListHandles(
       const ListDirectoryHandlesOptions& options,
       const Azure::Core::Context& context) const
@@ -344,7 +586,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     pagedResponse.m_shareDirectoryClient = std::make_shared<ShareDirectoryClient>(*this);
     pagedResponse.m_operationOptions = options;
     pagedResponse.CurrentPageToken = options.ContinuationToken.ValueOr(std::string());
-    pagedResponse.NextPageToken = response.Value.ContinuationToken;
+    pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
     pagedResponse.RawResponse = std::move(response.RawResponse);
 
     return pagedResponse;
@@ -3,18 +3,23 @@
 
 #include "azure/storage/files/shares/share_file_client.hpp"
 
+#include <algorithm>
+#include <mutex>
+
 #include <azure/core/credentials/credentials.hpp>
 #include <azure/core/http/policies/policy.hpp>
 #include <azure/core/internal/io/null_body_stream.hpp>
 #include <azure/core/io/body_stream.hpp>
 #include <azure/storage/common/crypt.hpp>
 #include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
 #include <azure/storage/common/internal/constants.hpp>
 #include <azure/storage/common/internal/file_io.hpp>
+#include <azure/storage/common/internal/pooled_buffer.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/reliable_stream.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
 #include "azure/storage/files/shares/share_constants.hpp"
@@ -23,6 +28,84 @@
 
 namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
+  namespace {
+    // Downloads the ranges of the file to the same offsets of the local file, concurrently, split
+    // in chunks of up to chunkSize bytes. Each chunk must be of the version of the file with eTag.
+    // Returns the number of bytes downloaded.
+    int64_t DownloadFileRanges(
+        const ShareFileClient& client,
+        const std::vector<Azure::Core::Http::HttpRange>& ranges,
+        int64_t fileSize,
+        const Azure::ETag& eTag,
+        const LeaseAccessConditions& accessConditions,
+        int64_t chunkSize,
+        int32_t concurrency,
+        _internal::FileWriter& fileWriter,
+        const std::shared_ptr<BufferPool>& bufferPool,
+        const std::shared_ptr<TransferExecutor>& transferExecutor,
+        const Azure::Core::Context& context)
+    {
+      chunkSize = std::max<int64_t>(chunkSize, 1);
+      std::vector<Azure::Core::Http::HttpRange> chunks;
+      int64_t downloadedSize = 0;
+      for (const auto& range : ranges)
+      {
+        const int64_t end = std::min(range.Offset + range.Length.Value(), fileSize);
+        for (int64_t offset = range.Offset; offset < end; offset += chunkSize)
+        {
+          Azure::Core::Http::HttpRange chunk;
+          chunk.Offset = offset;
+          chunk.Length = std::min(chunkSize, end - offset);
+          chunks.push_back(chunk);
+          downloadedSize += chunk.Length.Value();
+        }
+      }
+
+      auto downloadChunkFunc = [&](int64_t chunkIndex, int64_t, int64_t) {
+        const auto& chunk = chunks[static_cast<size_t>(chunkIndex)];
+        DownloadFileOptions options;
+        options.Range = chunk;
+        options.AccessConditions = accessConditions;
+        auto downloadResponse = client.Download(options, context);
+        if (downloadResponse.Value.Details.ETag != eTag)
+        {
+          throw Azure::Core::RequestFailedException(
+              "File was modified in the middle of download.");
+        }
+
+        constexpr size_t bufferSize = 4 * 1024 * 1024;
+        _internal::PooledBuffer buffer(bufferPool, bufferSize, context);
+        int64_t offset = chunk.Offset;
+        int64_t length = chunk.Length.Value();
+        while (length > 0)
+        {
+          const size_t readSize = static_cast<size_t>(std::min<int64_t>(bufferSize, length));
+          const size_t bytesRead
+              = downloadResponse.Value.BodyStream->ReadToCount(buffer.Data(), readSize, context);
+          if (bytesRead != readSize)
+          {
+            throw Azure::Core::RequestFailedException("Error when reading body stream.");
+          }
+          fileWriter.Write(buffer.Data(), bytesRead, offset);
+          offset += static_cast<int64_t>(bytesRead);
+          length -= static_cast<int64_t>(bytesRead);
+        }
+      };
+
+      // The chunks are downloaded one per transfer.
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = 1;
+      transferOptions.Concurrency = concurrency;
+      _internal::ConcurrentTransfer(
+          0,
+          static_cast<int64_t>(chunks.size()),
+          transferOptions,
+          downloadChunkFunc,
+          transferExecutor);
+      return downloadedSize;
+    }
+  } // namespace
+
   ShareFileClient ShareFileClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& shareName,
@@ -49,7 +132,8 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const std::string& shareFileUrl,
       std::shared_ptr<StorageSharedKeyCredential> credential,
       const ShareClientOptions& options)
-      : m_shareFileUrl(shareFileUrl)
+      : m_shareFileUrl(shareFileUrl), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     ShareClientOptions newOptions = options;
     newOptions.PerRetryPolicies.emplace_back(
@@ -57,33 +141,52 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::FileServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, newOptions.ApiVersion}});
   }
 
   ShareFileClient::ShareFileClient(
       const std::string& shareFileUrl,
       const ShareClientOptions& options)
-      : m_shareFileUrl(shareFileUrl)
+      : m_shareFileUrl(shareFileUrl), m_transferExecutor(options.TransferExecutor),
+        m_bufferPool(options.BufferPool)
   {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::FileServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion}});
   }
 
   ShareFileClient ShareFileClient::WithShareSnapshot(const std::string& shareSnapshot) const
@@ -201,21 +304,22 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const DeleteFileOptions& options,
       const Azure::Core::Context& context) const
   {
-    try
-    {
-      return Delete(options, context);
-    }
-    catch (StorageException& e)
-    {
-      if (e.ErrorCode == _detail::ShareNotFound || e.ErrorCode == _detail::ParentNotFound
-          || e.ErrorCode == _detail::ResourceNotFound)
-      {
-        Models::DeleteFileResult ret;
-        ret.Deleted = false;
-        return Azure::Response<Models::DeleteFileResult>(std::move(ret), std::move(e.RawResponse));
-      }
-      throw;
-    }
+    auto protocolLayerOptions = _detail::ShareRestClient::File::DeleteOptions();
+    protocolLayerOptions.LeaseIdOptional = options.AccessConditions.LeaseId;
+    auto request = _detail::ShareRestClient::File::DeleteCreateMessage(
+        m_shareFileUrl, protocolLayerOptions);
+    auto response = m_pipeline->Send(request, context);
+    // A missing file is checked without throwing and parsing a StorageException.
+    if (_internal::IsFailedWith(
+            *response,
+            Core::Http::HttpStatusCode::NotFound,
+            {_detail::ShareNotFound, _detail::ParentNotFound, _detail::ResourceNotFound}))
+    {
+      Models::DeleteFileResult ret;
+      ret.Deleted = false;
+      return Azure::Response<Models::DeleteFileResult>(std::move(ret), std::move(response));
+    }
+    return _detail::ShareRestClient::File::DeleteCreateResponse(context, std::move(response));
   }
 
   Azure::Response<Models::DownloadFileResult> ShareFileClient::Download(
@@ -279,6 +383,11 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
       _internal::ReliableStreamOptions reliableStreamOptions;
       reliableStreamOptions.MaxRetryRequests = _internal::ReliableStreamRetryCount;
+      reliableStreamOptions.RetryDelay = _internal::ReliableStreamRetryDelay;
+      reliableStreamOptions.MaxRetryDelay = _internal::ReliableStreamMaxRetryDelay;
+      reliableStreamOptions.StallTimeout = _internal::ReliableStreamStallTimeout;
+      reliableStreamOptions.MinimumThroughput = _internal::ReliableStreamMinimumThroughput;
+      reliableStreamOptions.ThroughputWindow = _internal::ReliableStreamThroughputWindow;
       downloadResponse.Value.BodyStream = std::make_unique<_internal::ReliableStream>(
           std::move(downloadResponse.Value.BodyStream), reliableStreamOptions, retryFunction);
     }
@@ -474,6 +583,100 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         m_shareFileUrl, *m_pipeline, context, protocolLayerOptions);
   }
 
+  Azure::Response<Models::UploadFileDiffFromResult> ShareFileClient::UploadDiffFrom(
+      const std::string& fileName,
+      const std::vector<Azure::Core::Http::HttpRange>& ranges,
+      const std::vector<Azure::Core::Http::HttpRange>& clearRanges,
+      const UploadFileDiffFromOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    _internal::FileReader fileReader(fileName);
+
+    Models::UploadFileDiffFromResult ret;
+    ret.FileSize = fileReader.GetFileSize();
+
+    GetFilePropertiesOptions getPropertiesOptions;
+    getPropertiesOptions.AccessConditions = options.AccessConditions;
+    auto properties = GetProperties(getPropertiesOptions, context);
+    std::unique_ptr<Azure::Core::Http::RawResponse> rawResponse
+        = std::move(properties.RawResponse);
+    if (properties.Value.FileSize != ret.FileSize)
+    {
+      // The SMB properties are preserved when left empty, the HTTP headers have to be set again.
+      SetFilePropertiesOptions setPropertiesOptions;
+      setPropertiesOptions.Size = ret.FileSize;
+      setPropertiesOptions.AccessConditions = options.AccessConditions;
+      rawResponse = SetProperties(
+                        properties.Value.HttpHeaders,
+                        Models::FileSmbProperties(),
+                        setPropertiesOptions,
+                        context)
+                        .RawResponse;
+    }
+
+    // Both the changed and the cleared ranges are limited to the size of the local file, the
+    // changed ones are split in chunks of up to ChunkSize bytes.
+    struct RangeUpdate
+    {
+      int64_t Offset;
+      int64_t Length;
+      bool Clear;
+    };
+    std::vector<RangeUpdate> updates;
+    const int64_t chunkSize = std::max<int64_t>(options.TransferOptions.ChunkSize, 1);
+    for (const auto& range : ranges)
+    {
+      const int64_t end = std::min(range.Offset + range.Length.Value(), ret.FileSize);
+      for (int64_t offset = range.Offset; offset < end; offset += chunkSize)
+      {
+        const int64_t length = std::min(chunkSize, end - offset);
+        updates.push_back({offset, length, false});
+        ret.UploadedSize += length;
+      }
+    }
+    for (const auto& range : clearRanges)
+    {
+      const int64_t end = std::min(range.Offset + range.Length.Value(), ret.FileSize);
+      if (end > range.Offset)
+      {
+        updates.push_back({range.Offset, end - range.Offset, true});
+        ret.ClearedSize += end - range.Offset;
+      }
+    }
+
+    auto updateRangeFunc = [&](int64_t updateIndex, int64_t, int64_t) {
+      const auto& update = updates[static_cast<size_t>(updateIndex)];
+      if (update.Clear)
+      {
+        ClearFileRangeOptions clearRangeOptions;
+        clearRangeOptions.AccessConditions = options.AccessConditions;
+        ClearRange(update.Offset, update.Length, clearRangeOptions, context);
+      }
+      else
+      {
+        Azure::Core::IO::_internal::RandomAccessFileBodyStream contentStream(
+            fileReader.GetHandle(), update.Offset, update.Length);
+        UploadFileRangeOptions uploadRangeOptions;
+        uploadRangeOptions.AccessConditions = options.AccessConditions;
+        UploadRange(update.Offset, contentStream, uploadRangeOptions, context);
+      }
+    };
+
+    // The updates are applied one per transfer.
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(updates.size()),
+        transferOptions,
+        updateRangeFunc,
+        m_transferExecutor);
+
+    return Azure::Response<Models::UploadFileDiffFromResult>(
+        std::move(ret), std::move(rawResponse));
+  }
+
   Azure::Response<Models::UploadFileRangeResult> ShareFileClient::UploadRange(
       int64_t offset,
       Azure::Core::IO::BodyStream& content,
@@ -497,6 +700,18 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         m_shareFileUrl, content, *m_pipeline, context, protocolLayerOptions);
   }
 
+  std::unique_ptr<ShareFileWriter> ShareFileClient::OpenWrite(
+      const OpenWriteShareFileOptions& options) const
+  {
+    constexpr int64_t MaxUploadRangeSize = 4 * 1024 * 1024;
+    if (options.RangeSize <= 0 || options.RangeSize > MaxUploadRangeSize)
+    {
+      throw Azure::Core::RequestFailedException("Range size is too big.");
+    }
+    return std::unique_ptr<ShareFileWriter>(
+        new ShareFileWriter(*this, options, m_transferExecutor));
+  }
+
   Azure::Response<Models::ClearFileRangeResult> ShareFileClient::ClearRange(
       int64_t offset,
       int64_t length,
@@ -597,7 +812,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     pagedResponse.m_shareFileClient = std::make_shared<ShareFileClient>(*this);
     pagedResponse.m_operationOptions = options;
     pagedResponse.CurrentPageToken = options.ContinuationToken.ValueOr(std::string());
-    pagedResponse.NextPageToken = response.Value.ContinuationToken;
+    pagedResponse.NextPageToken = std::move(response.Value.ContinuationToken);
     pagedResponse.RawResponse = std::move(response.RawResponse);
 
     return pagedResponse;
@@ -649,6 +864,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const DownloadFileToOptions& options,
       const Azure::Core::Context& context) const
   {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
     // Just start downloading using an initial chunk. If it's a small file, we'll get the whole
     // thing in one shot. If it's a large file, we'll get its full size in Content-Range and can
     // keep downloading it in chunks.
@@ -667,7 +883,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       firstChunkOptions.Range.Value().Length = firstChunkLength;
     }
 
-    auto firstChunk = Download(firstChunkOptions, context);
+    auto firstChunk = Download(firstChunkOptions, bulkContext);
     const Azure::ETag etag = firstChunk.Value.Details.ETag;
 
     int64_t fileSize;
@@ -696,7 +912,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     }
 
     int64_t bytesRead = firstChunk.Value.BodyStream->ReadToCount(
-        buffer, static_cast<size_t>(firstChunkLength), context);
+        buffer, static_cast<size_t>(firstChunkLength), bulkContext);
     if (bytesRead != firstChunkLength)
     {
       throw Azure::Core::RequestFailedException("Error when reading body stream.");
@@ -715,16 +931,17 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
     // Keep downloading the remaining in parallel
     auto downloadChunkFunc
-        = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+        = [&](int64_t offset, int64_t length, int64_t chunkId) {
+            (void)chunkId;
             DownloadFileOptions chunkOptions;
             chunkOptions.Range = Core::Http::HttpRange();
             chunkOptions.Range.Value().Offset = offset;
             chunkOptions.Range.Value().Length = length;
-            auto chunk = Download(chunkOptions, context);
+            auto chunk = Download(chunkOptions, bulkContext);
             int64_t bytesRead = chunk.Value.BodyStream->ReadToCount(
                 buffer + (offset - firstChunkOffset),
                 static_cast<size_t>(chunkOptions.Range.Value().Length.Value()),
-                context);
+                bulkContext);
             if (bytesRead != chunkOptions.Range.Value().Length.Value())
             {
               throw Azure::Core::RequestFailedException("Error when reading body stream.");
@@ -735,7 +952,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
                   "File was modified in the middle of download.");
             }
 
-            if (chunkId == numChunks - 1)
+            if (offset + length == firstChunkOffset + fileRangeSize)
             {
               ret = returnTypeConverter(chunk);
             }
@@ -744,12 +961,12 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     int64_t remainingOffset = firstChunkOffset + firstChunkLength;
     int64_t remainingSize = fileRangeSize - firstChunkLength;
 
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = options.TransferOptions.ChunkSize;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    transferOptions.AutoTune = options.TransferOptions.AutoTune;
     _internal::ConcurrentTransfer(
-        remainingOffset,
-        remainingSize,
-        options.TransferOptions.ChunkSize,
-        options.TransferOptions.Concurrency,
-        downloadChunkFunc);
+        remainingOffset, remainingSize, transferOptions, downloadChunkFunc, m_transferExecutor);
     ret.Value.ContentRange.Offset = firstChunkOffset;
     ret.Value.ContentRange.Length = fileRangeSize;
     return ret;
@@ -760,6 +977,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const DownloadFileToOptions& options,
       const Azure::Core::Context& context) const
   {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
     // Just start downloading using an initial chunk. If it's a small file, we'll get the whole
     // thing in one shot. If it's a large file, we'll get its full size in Content-Range and can
     // keep downloading it in chunks.
@@ -777,9 +995,12 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       firstChunkOptions.Range.Value().Length = firstChunkLength;
     }
 
-    _internal::FileWriter fileWriter(fileName);
+    _internal::FileWriter fileWriter(
+        fileName,
+        options.TransferOptions.UnbufferedIo ? _internal::FileIoMode::Unbuffered
+                                             : _internal::FileIoMode::Buffered);
 
-    auto firstChunk = Download(firstChunkOptions, context);
+    auto firstChunk = Download(firstChunkOptions, bulkContext);
     const Azure::ETag etag = firstChunk.Value.Details.ETag;
 
     int64_t fileSize;
@@ -800,28 +1021,33 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     }
     firstChunkLength = std::min(firstChunkLength, fileRangeSize);
 
-    auto bodyStreamToFile = [](Azure::Core::IO::BodyStream& stream,
-                               _internal::FileWriter& fileWriter,
-                               int64_t offset,
-                               int64_t length,
-                               const Azure::Core::Context& context) {
+    auto bodyStreamToFile = [this](
+                                Azure::Core::IO::BodyStream& stream,
+                                _internal::FileWriter& fileWriter,
+                                int64_t offset,
+                                int64_t length,
+                                const Azure::Core::Context& bulkContext) {
       constexpr size_t bufferSize = 4 * 1024 * 1024;
-      std::vector<uint8_t> buffer(bufferSize);
+      // The data is placed in the aligned buffer at the same alignment as in the file, so that
+      // most of it can be written bypassing the page cache in unbuffered mode.
+      _internal::PooledBuffer buffer(m_bufferPool, bufferSize, bulkContext);
+      size_t skew = static_cast<size_t>(offset % _internal::UnbufferedIoAlignment);
       while (length > 0)
       {
-        size_t readSize = static_cast<size_t>(std::min<int64_t>(bufferSize, length));
-        size_t bytesRead = stream.ReadToCount(buffer.data(), readSize, context);
+        size_t readSize = static_cast<size_t>(std::min<int64_t>(bufferSize - skew, length));
+        size_t bytesRead = stream.ReadToCount(buffer.Data() + skew, readSize, bulkContext);
         if (bytesRead != readSize)
         {
           throw Azure::Core::RequestFailedException("Error when reading body stream.");
         }
-        fileWriter.Write(buffer.data(), bytesRead, offset);
+        fileWriter.Write(buffer.Data() + skew, bytesRead, offset);
         length -= bytesRead;
         offset += bytesRead;
+        skew = 0;
       }
     };
 
-    bodyStreamToFile(*(firstChunk.Value.BodyStream), fileWriter, 0, firstChunkLength, context);
+    bodyStreamToFile(*(firstChunk.Value.BodyStream), fileWriter, 0, firstChunkLength, bulkContext);
     firstChunk.Value.BodyStream.reset();
 
     auto returnTypeConverter = [](Azure::Response<Models::DownloadFileResult>& response) {
@@ -836,12 +1062,13 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
     // Keep downloading the remaining in parallel
     auto downloadChunkFunc
-        = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+        = [&](int64_t offset, int64_t length, int64_t chunkId) {
+            (void)chunkId;
             DownloadFileOptions chunkOptions;
             chunkOptions.Range = Core::Http::HttpRange();
             chunkOptions.Range.Value().Offset = offset;
             chunkOptions.Range.Value().Length = length;
-            auto chunk = Download(chunkOptions, context);
+            auto chunk = Download(chunkOptions, bulkContext);
             if (chunk.Value.Details.ETag != etag)
             {
               throw Azure::Core::RequestFailedException(
@@ -852,9 +1079,9 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
                 fileWriter,
                 offset - firstChunkOffset,
                 chunkOptions.Range.Value().Length.Value(),
-                context);
+                bulkContext);
 
-            if (chunkId == numChunks - 1)
+            if (offset + length == firstChunkOffset + fileRangeSize)
             {
               ret = returnTypeConverter(chunk);
             }
@@ -863,23 +1090,107 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     int64_t remainingOffset = firstChunkOffset + firstChunkLength;
     int64_t remainingSize = fileRangeSize - firstChunkLength;
 
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = options.TransferOptions.ChunkSize;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    transferOptions.AutoTune = options.TransferOptions.AutoTune;
     _internal::ConcurrentTransfer(
-        remainingOffset,
-        remainingSize,
-        options.TransferOptions.ChunkSize,
-        options.TransferOptions.Concurrency,
-        downloadChunkFunc);
+        remainingOffset, remainingSize, transferOptions, downloadChunkFunc, m_transferExecutor);
     ret.Value.ContentRange.Offset = firstChunkOffset;
     ret.Value.ContentRange.Length = fileRangeSize;
     return ret;
   }
 
+  Azure::Response<Models::DownloadFileSparseToResult> ShareFileClient::DownloadSparseTo(
+      const std::string& fileName,
+      const DownloadFileSparseToOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    GetFileRangeListOptions getRangeListOptions;
+    getRangeListOptions.AccessConditions = options.AccessConditions;
+    auto rangeList = GetRangeList(getRangeListOptions, context);
+
+    Models::DownloadFileSparseToResult ret;
+    ret.ETag = std::move(rangeList.Value.ETag);
+    ret.LastModified = std::move(rangeList.Value.LastModified);
+    ret.FileSize = rangeList.Value.FileSize;
+
+    // The unallocated ranges are never written, they are the holes of the local file.
+    _internal::FileWriter fileWriter(fileName);
+    fileWriter.ResizeSparse(ret.FileSize);
+
+    ret.DownloadedSize = DownloadFileRanges(
+        *this,
+        rangeList.Value.Ranges,
+        ret.FileSize,
+        ret.ETag,
+        options.AccessConditions,
+        options.TransferOptions.ChunkSize,
+        options.TransferOptions.Concurrency,
+        fileWriter,
+        m_bufferPool,
+        m_transferExecutor,
+        context);
+
+    return Azure::Response<Models::DownloadFileSparseToResult>(
+        std::move(ret), std::move(rangeList.RawResponse));
+  }
+
+  Azure::Response<Models::DownloadFileDiffToResult> ShareFileClient::DownloadDiffTo(
+      const std::string& previousShareSnapshot,
+      const std::string& fileName,
+      const DownloadFileDiffToOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    GetFileRangeListOptions getRangeListOptions;
+    getRangeListOptions.AccessConditions = options.AccessConditions;
+    auto diff = GetRangeListDiff(previousShareSnapshot, getRangeListOptions, context);
+
+    Models::DownloadFileDiffToResult ret;
+    ret.ETag = std::move(diff.Value.ETag);
+    ret.LastModified = std::move(diff.Value.LastModified);
+    ret.FileSize = diff.Value.FileSize;
+
+    _internal::FileWriter fileWriter(fileName, _internal::FileIoMode::Buffered, false);
+    fileWriter.ResizeSparse(ret.FileSize);
+    for (const auto& clearRange : diff.Value.ClearRanges)
+    {
+      const int64_t length
+          = std::min(clearRange.Offset + clearRange.Length.Value(), ret.FileSize)
+          - clearRange.Offset;
+      if (length > 0)
+      {
+        fileWriter.ZeroRange(clearRange.Offset, length);
+        ret.ClearedSize += length;
+      }
+    }
+
+    ret.DownloadedSize = DownloadFileRanges(
+        *this,
+        diff.Value.Ranges,
+        ret.FileSize,
+        ret.ETag,
+        options.AccessConditions,
+        options.TransferOptions.ChunkSize,
+        options.TransferOptions.Concurrency,
+        fileWriter,
+        m_bufferPool,
+        m_transferExecutor,
+        context);
+    ret.Ranges = std::move(diff.Value.Ranges);
+    ret.ClearRanges = std::move(diff.Value.ClearRanges);
+
+    return Azure::Response<Models::DownloadFileDiffToResult>(
+        std::move(ret), std::move(diff.RawResponse));
+  }
+
   Azure::Response<Models::UploadFileFromResult> ShareFileClient::UploadFrom(
       const uint8_t* buffer,
       size_t bufferSize,
       const UploadFileFromOptions& options,
       const Azure::Core::Context& context) const
   {
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
     _detail::ShareRestClient::File::CreateOptions protocolLayerOptions;
     protocolLayerOptions.XMsContentLength = bufferSize;
     protocolLayerOptions.FileAttributes = options.SmbProperties.Attributes.ToString();
@@ -947,28 +1258,31 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     }
     protocolLayerOptions.Metadata = options.Metadata;
     auto createResult = _detail::ShareRestClient::File::Create(
-        m_shareFileUrl, *m_pipeline, context, protocolLayerOptions);
+        m_shareFileUrl, *m_pipeline, bulkContext, protocolLayerOptions);
 
-    auto uploadPageFunc = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+    auto uploadPageFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
       (void)chunkId;
-      (void)numChunks;
       // TODO: Investigate changing lambda parameters to be size_t, unless they need to be int64_t
       // for some reason.
       Azure::Core::IO::MemoryBodyStream contentStream(buffer + offset, static_cast<size_t>(length));
       UploadFileRangeOptions uploadRangeOptions;
-      UploadRange(offset, contentStream, uploadRangeOptions, context);
+      UploadRange(offset, contentStream, uploadRangeOptions, bulkContext);
     };
 
-    int64_t chunkSize = options.TransferOptions.ChunkSize;
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = options.TransferOptions.ChunkSize;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    transferOptions.AutoTune = options.TransferOptions.AutoTune;
     if (bufferSize < static_cast<size_t>(options.TransferOptions.SingleUploadThreshold))
     {
-      chunkSize = bufferSize;
+      transferOptions.ChunkSize = bufferSize;
+      transferOptions.AutoTune = false;
     }
 
     if (bufferSize > 0)
     {
       _internal::ConcurrentTransfer(
-          0, bufferSize, chunkSize, options.TransferOptions.Concurrency, uploadPageFunc);
+          0, bufferSize, transferOptions, uploadPageFunc, m_transferExecutor);
     }
 
     Models::UploadFileFromResult result;
@@ -982,7 +1296,11 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       const UploadFileFromOptions& options,
       const Azure::Core::Context& context) const
   {
-    _internal::FileReader fileReader(fileName);
+    const auto bulkContext = _internal::WithBulkTrafficClass(context);
+    _internal::FileReader fileReader(
+        fileName,
+        options.TransferOptions.UnbufferedIo ? _internal::FileIoMode::Unbuffered
+                                             : _internal::FileIoMode::Buffered);
 
     _detail::ShareRestClient::File::CreateOptions protocolLayerOptions;
     protocolLayerOptions.XMsContentLength = fileReader.GetFileSize();
@@ -1051,28 +1369,40 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     }
     protocolLayerOptions.Metadata = options.Metadata;
     auto createResult = _detail::ShareRestClient::File::Create(
-        m_shareFileUrl, *m_pipeline, context, protocolLayerOptions);
+        m_shareFileUrl, *m_pipeline, bulkContext, protocolLayerOptions);
 
-    auto uploadPageFunc = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+    auto uploadPageFunc = [&](int64_t offset, int64_t length, int64_t chunkId) {
       (void)chunkId;
-      (void)numChunks;
-      Azure::Core::IO::_internal::RandomAccessFileBodyStream contentStream(
-          fileReader.GetHandle(), offset, length);
+      std::unique_ptr<Azure::Core::IO::BodyStream> contentStream;
+      if (fileReader.IsUnbuffered())
+      {
+        contentStream = std::make_unique<_internal::UnbufferedFileBodyStream>(
+            fileReader, offset, length, m_bufferPool);
+      }
+      else
+      {
+        contentStream = std::make_unique<Azure::Core::IO::_internal::RandomAccessFileBodyStream>(
+            fileReader.GetHandle(), offset, length);
+      }
       UploadFileRangeOptions uploadRangeOptions;
-      UploadRange(offset, contentStream, uploadRangeOptions, context);
+      UploadRange(offset, *contentStream, uploadRangeOptions, bulkContext);
     };
 
     const int64_t fileSize = fileReader.GetFileSize();
-    int64_t chunkSize = options.TransferOptions.ChunkSize;
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = options.TransferOptions.ChunkSize;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    transferOptions.AutoTune = options.TransferOptions.AutoTune;
     if (fileSize < options.TransferOptions.SingleUploadThreshold)
     {
-      chunkSize = fileSize;
+      transferOptions.ChunkSize = fileSize;
+      transferOptions.AutoTune = false;
     }
 
     if (fileSize > 0)
     {
       _internal::ConcurrentTransfer(
-          0, fileSize, chunkSize, options.TransferOptions.Concurrency, uploadPageFunc);
+          0, fileSize, transferOptions, uploadPageFunc, m_transferExecutor);
     }
 
     Models::UploadFileFromResult result;
@@ -1081,6 +1411,121 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         std::move(result), std::move(createResult.RawResponse));
   }
 
+  Azure::Response<Models::CopyFileFromUriParallelResult> ShareFileClient::CopyFromUriParallel(
+      const std::string& sourceUri,
+      const CopyFileFromUriParallelOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    constexpr int64_t MaxCopyRangeSize = 4 * 1024 * 1024;
+    const int64_t chunkSize = options.TransferOptions.ChunkSize;
+    if (chunkSize <= 0 || chunkSize > MaxCopyRangeSize)
+    {
+      throw Azure::Core::RequestFailedException("Range size is too big.");
+    }
+
+    Models::CopyFileFromUriParallelResult ret;
+    if (options.SourceLength.HasValue())
+    {
+      ret.FileSize = options.SourceLength.Value();
+    }
+    else
+    {
+      // The source is authorized by its URL, not by the credential of this client.
+      ret.FileSize = ShareFileClient(sourceUri).GetProperties(GetFilePropertiesOptions(), context)
+                         .Value.FileSize;
+    }
+
+    // The valid ranges of the file kept by a resumable copy are those already copied.
+    std::vector<Azure::Core::Http::HttpRange> copiedRanges;
+    std::unique_ptr<Azure::Core::Http::RawResponse> rawResponse;
+    if (options.Resumable)
+    {
+      try
+      {
+        GetFileRangeListOptions getRangeListOptions;
+        getRangeListOptions.AccessConditions = options.AccessConditions;
+        auto rangeList = GetRangeList(getRangeListOptions, context);
+        if (rangeList.Value.FileSize == ret.FileSize)
+        {
+          copiedRanges = std::move(rangeList.Value.Ranges);
+          rawResponse = std::move(rangeList.RawResponse);
+        }
+      }
+      catch (StorageException& e)
+      {
+        if (e.ErrorCode != _detail::ResourceNotFound)
+        {
+          throw;
+        }
+      }
+    }
+    if (!rawResponse)
+    {
+      CreateFileOptions createOptions;
+      createOptions.HttpHeaders = options.HttpHeaders;
+      createOptions.Metadata = options.Metadata;
+      createOptions.AccessConditions = options.AccessConditions;
+      rawResponse = Create(ret.FileSize, createOptions, context).RawResponse;
+    }
+
+    auto isCopied = [&](int64_t offset, int64_t length) {
+      auto range = std::upper_bound(
+          copiedRanges.begin(),
+          copiedRanges.end(),
+          offset,
+          [](int64_t o, const Azure::Core::Http::HttpRange& r) { return o < r.Offset; });
+      if (range == copiedRanges.begin())
+      {
+        return false;
+      }
+      --range;
+      return offset + length <= range->Offset + range->Length.Value();
+    };
+    std::vector<Azure::Core::Http::HttpRange> chunks;
+    for (int64_t offset = 0; offset < ret.FileSize; offset += chunkSize)
+    {
+      const int64_t length = std::min(chunkSize, ret.FileSize - offset);
+      if (isCopied(offset, length))
+      {
+        ret.ResumedSize += length;
+      }
+      else
+      {
+        chunks.push_back(Azure::Core::Http::HttpRange{offset, length});
+        ret.CopiedSize += length;
+      }
+    }
+
+    std::mutex progressMutex;
+    int64_t progress = ret.ResumedSize;
+    auto copyRangeFunc = [&](int64_t chunkIndex, int64_t, int64_t) {
+      const auto& chunk = chunks[static_cast<size_t>(chunkIndex)];
+      UploadFileRangeFromUriOptions rangeOptions;
+      rangeOptions.AccessConditions = options.AccessConditions;
+      UploadRangeFromUri(chunk.Offset, sourceUri, chunk, rangeOptions, context);
+      if (options.ProgressHandler)
+      {
+        std::lock_guard<std::mutex> guard(progressMutex);
+        progress += chunk.Length.Value();
+        options.ProgressHandler(progress, ret.FileSize);
+      }
+    };
+
+    // The ranges are copied one per transfer.
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.TransferOptions.Concurrency;
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(chunks.size()),
+        transferOptions,
+        copyRangeFunc,
+        m_transferExecutor);
+
+    return Azure::Response<Models::CopyFileFromUriParallelResult>(
+        std::move(ret), std::move(rawResponse));
+  }
+
   Azure::Response<Models::UploadFileRangeFromUriResult> ShareFileClient::UploadRangeFromUri(
       int64_t destinationOffset,
       const std::string& sourceUri,
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/files/shares/share_file_writer.hpp"
+
+#include <azure/core/io/body_stream.hpp>
+#include <azure/storage/common/internal/range_write_coalescer.hpp>
+
+#include "azure/storage/files/shares/share_file_client.hpp"
+
+#include <utility>
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares {
+
+  struct ShareFileWriter::State final
+  {
+    State(
+        const ShareFileClient& client,
+        const OpenWriteShareFileOptions& options,
+        std::shared_ptr<TransferExecutor> transferExecutor)
+        : Client(client), AccessConditions(options.AccessConditions),
+          Coalescer(
+              GetCoalescerOptions(options),
+              [this](
+                  int64_t offset,
+                  const uint8_t* data,
+                  size_t length,
+                  const Azure::Core::Context& context) {
+                Azure::Core::IO::MemoryBodyStream content(data, length);
+                UploadFileRangeOptions uploadOptions;
+                uploadOptions.AccessConditions = AccessConditions;
+                Client.UploadRange(offset, content, uploadOptions, context);
+              },
+              nullptr,
+              std::move(transferExecutor))
+    {
+    }
+
+    static _internal::RangeWriteCoalescerOptions GetCoalescerOptions(
+        const OpenWriteShareFileOptions& options)
+    {
+      // Ranges of a file don't need to be aligned.
+      _internal::RangeWriteCoalescerOptions coalescerOptions;
+      coalescerOptions.MaxRangeSize = options.RangeSize;
+      coalescerOptions.Concurrency = options.Concurrency;
+      coalescerOptions.MaxBufferedSize = options.MaxBufferedSize;
+      return coalescerOptions;
+    }
+
+    ShareFileClient Client;
+    LeaseAccessConditions AccessConditions;
+    _internal::RangeWriteCoalescer Coalescer;
+  };
+
+  ShareFileWriter::ShareFileWriter(
+      const ShareFileClient& client,
+      const OpenWriteShareFileOptions& options,
+      std::shared_ptr<TransferExecutor> transferExecutor)
+      : m_state(std::make_unique<State>(client, options, std::move(transferExecutor)))
+  {
+  }
+
+  ShareFileWriter::~ShareFileWriter()
+  {
+    try
+    {
+      m_state->Coalescer.Flush(Azure::Core::Context());
+    }
+    catch (...)
+    {
+    }
+  }
+
+  void ShareFileWriter::WriteAt(
+      int64_t offset,
+      const uint8_t* data,
+      size_t length,
+      const Azure::Core::Context& context)
+  {
+    m_state->Coalescer.WriteAt(offset, data, length, context);
+  }
+
+  void ShareFileWriter::Flush(const Azure::Core::Context& context)
+  {
+    m_state->Coalescer.Flush(context);
+  }
+
+}}}} // namespace Azure::Storage::Files::Shares
@@ -3,7 +3,6 @@
 
 #include "azure/storage/files/shares/share_responses.hpp"
 
-#include <thread>
 
 #include "azure/storage/files/shares/share_directory_client.hpp"
 #include "azure/storage/files/shares/share_file_client.hpp"
@@ -39,8 +38,10 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
       std::chrono::milliseconds period,
       Azure::Core::Context& context)
   {
+    int32_t pollCount = 0;
     while (true)
     {
+      ++pollCount;
       auto rawResponse = Poll(context);
 
       if (m_status == Azure::Core::OperationStatus::Succeeded)
@@ -57,7 +58,7 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
         throw Azure::Core::RequestFailedException("Operation was cancelled.");
       }
 
-      std::this_thread::sleep_for(period);
+      WaitBeforeNextPoll(period, pollCount, context);
     }
   }
 
@@ -5,6 +5,7 @@
 
 #include <azure/core/http/http.hpp>
 #include <azure/storage/common/crypt.hpp>
+#include <azure/storage/common/internal/sas_token_template.hpp>
 
 /* cSpell:ignore rscc, rscd, rsce, rscl, rsct */
 
@@ -26,6 +27,85 @@ namespace Azure { namespace Storage { namespace Sas {
         throw std::invalid_argument("Unknown ShareSasResource value.");
       }
     }
+
+    // The file path goes between the string to sign prefix and suffix.
+    _internal::SasTokenParts GetSasTokenParts(
+        const ShareSasBuilder& builder,
+        const std::string& permissions,
+        const std::string& accountName)
+    {
+      std::string canonicalName = "/file/" + accountName + "/" + builder.ShareName;
+      if (builder.Resource == ShareSasResource::File)
+      {
+        canonicalName += "/";
+      }
+      std::string protocol = _detail::SasProtocolToString(builder.Protocol);
+      std::string resource = ShareSasResourceToString(builder.Resource);
+
+      std::string startsOnStr = builder.StartsOn.HasValue()
+          ? builder.StartsOn.Value().ToString(
+              Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
+          : "";
+      std::string expiresOnStr = builder.Identifier.empty()
+          ? builder.ExpiresOn.ToString(
+              Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
+          : "";
+
+      _internal::SasTokenParts parts;
+      parts.StringToSignPrefix
+          = permissions + "\n" + startsOnStr + "\n" + expiresOnStr + "\n" + canonicalName;
+      parts.StringToSignSuffix = "\n" + builder.Identifier + "\n"
+          + (builder.IPRange.HasValue() ? builder.IPRange.Value() : "") + "\n" + protocol + "\n"
+          + _internal::DefaultSasVersion + "\n" + builder.CacheControl + "\n"
+          + builder.ContentDisposition + "\n" + builder.ContentEncoding + "\n"
+          + builder.ContentLanguage + "\n" + builder.ContentType;
+
+      auto& query = parts.QueryParameters;
+      query["sv"] = _internal::UrlEncodeQueryParameter(_internal::DefaultSasVersion);
+      query["spr"] = _internal::UrlEncodeQueryParameter(protocol);
+      if (!startsOnStr.empty())
+      {
+        query["st"] = _internal::UrlEncodeQueryParameter(startsOnStr);
+      }
+      if (!expiresOnStr.empty())
+      {
+        query["se"] = _internal::UrlEncodeQueryParameter(expiresOnStr);
+      }
+      if (builder.IPRange.HasValue())
+      {
+        query["sip"] = _internal::UrlEncodeQueryParameter(builder.IPRange.Value());
+      }
+      if (!builder.Identifier.empty())
+      {
+        query["si"] = _internal::UrlEncodeQueryParameter(builder.Identifier);
+      }
+      query["sr"] = _internal::UrlEncodeQueryParameter(resource);
+      if (!permissions.empty())
+      {
+        query["sp"] = _internal::UrlEncodeQueryParameter(permissions);
+      }
+      if (!builder.CacheControl.empty())
+      {
+        query["rscc"] = _internal::UrlEncodeQueryParameter(builder.CacheControl);
+      }
+      if (!builder.ContentDisposition.empty())
+      {
+        query["rscd"] = _internal::UrlEncodeQueryParameter(builder.ContentDisposition);
+      }
+      if (!builder.ContentEncoding.empty())
+      {
+        query["rsce"] = _internal::UrlEncodeQueryParameter(builder.ContentEncoding);
+      }
+      if (!builder.ContentLanguage.empty())
+      {
+        query["rscl"] = _internal::UrlEncodeQueryParameter(builder.ContentLanguage);
+      }
+      if (!builder.ContentType.empty())
+      {
+        query["rsct"] = _internal::UrlEncodeQueryParameter(builder.ContentType);
+      }
+      return parts;
+    }
   } // namespace
 
   void ShareSasBuilder::SetPermissions(ShareSasPermissions permissions)
@@ -78,80 +158,28 @@ namespace Azure { namespace Storage { namespace Sas {
 
   std::string ShareSasBuilder::GenerateSasToken(const StorageSharedKeyCredential& credential)
   {
-    std::string canonicalName = "/file/" + credential.AccountName + "/" + ShareName;
-    if (Resource == ShareSasResource::File)
-    {
-      canonicalName += "/" + FilePath;
-    }
-    std::string protocol = _detail::SasProtocolToString(Protocol);
-    std::string resource = ShareSasResourceToString(Resource);
-
-    std::string startsOnStr = StartsOn.HasValue()
-        ? StartsOn.Value().ToString(
-            Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
-        : "";
-    std::string expiresOnStr = Identifier.empty()
-        ? ExpiresOn.ToString(
-            Azure::DateTime::DateFormat::Rfc3339, Azure::DateTime::TimeFractionFormat::Truncate)
-        : "";
-
-    std::string stringToSign = Permissions + "\n" + startsOnStr + "\n" + expiresOnStr + "\n"
-        + canonicalName + "\n" + Identifier + "\n" + (IPRange.HasValue() ? IPRange.Value() : "")
-        + "\n" + protocol + "\n" + _internal::DefaultSasVersion + "\n" + CacheControl + "\n"
-        + ContentDisposition + "\n" + ContentEncoding + "\n" + ContentLanguage + "\n" + ContentType;
-
-    std::string signature = Azure::Core::Convert::Base64Encode(_internal::HmacSha256(
-        std::vector<uint8_t>(stringToSign.begin(), stringToSign.end()),
-        Azure::Core::Convert::Base64Decode(credential.GetAccountKey())));
+    return _internal::GenerateSasToken(
+        *credential.GetSigningKey(),
+        GetSasTokenParts(*this, Permissions, credential.AccountName),
+        Resource == ShareSasResource::File ? FilePath : std::string());
+  }
 
-    Azure::Core::Url builder;
-    builder.AppendQueryParameter(
-        "sv", _internal::UrlEncodeQueryParameter(_internal::DefaultSasVersion));
-    builder.AppendQueryParameter("spr", _internal::UrlEncodeQueryParameter(protocol));
-    if (!startsOnStr.empty())
-    {
-      builder.AppendQueryParameter("st", _internal::UrlEncodeQueryParameter(startsOnStr));
-    }
-    if (!expiresOnStr.empty())
-    {
-      builder.AppendQueryParameter("se", _internal::UrlEncodeQueryParameter(expiresOnStr));
-    }
-    if (IPRange.HasValue())
-    {
-      builder.AppendQueryParameter("sip", _internal::UrlEncodeQueryParameter(IPRange.Value()));
-    }
-    if (!Identifier.empty())
-    {
-      builder.AppendQueryParameter("si", _internal::UrlEncodeQueryParameter(Identifier));
-    }
-    builder.AppendQueryParameter("sr", _internal::UrlEncodeQueryParameter(resource));
-    if (!Permissions.empty())
-    {
-      builder.AppendQueryParameter("sp", _internal::UrlEncodeQueryParameter(Permissions));
-    }
-    builder.AppendQueryParameter("sig", _internal::UrlEncodeQueryParameter(signature));
-    if (!CacheControl.empty())
-    {
-      builder.AppendQueryParameter("rscc", _internal::UrlEncodeQueryParameter(CacheControl));
-    }
-    if (!ContentDisposition.empty())
-    {
-      builder.AppendQueryParameter("rscd", _internal::UrlEncodeQueryParameter(ContentDisposition));
-    }
-    if (!ContentEncoding.empty())
-    {
-      builder.AppendQueryParameter("rsce", _internal::UrlEncodeQueryParameter(ContentEncoding));
-    }
-    if (!ContentLanguage.empty())
-    {
-      builder.AppendQueryParameter("rscl", _internal::UrlEncodeQueryParameter(ContentLanguage));
-    }
-    if (!ContentType.empty())
+  ShareSasTokenGenerator::ShareSasTokenGenerator(
+      const ShareSasBuilder& builder,
+      const StorageSharedKeyCredential& credential)
+  {
+    if (builder.Resource != ShareSasResource::File)
     {
-      builder.AppendQueryParameter("rsct", _internal::UrlEncodeQueryParameter(ContentType));
+      throw std::invalid_argument("ShareSasTokenGenerator requires a file resource.");
     }
+    m_template = std::make_shared<_internal::SasTokenTemplate>(
+        *credential.GetSigningKey(),
+        GetSasTokenParts(builder, builder.Permissions, credential.AccountName));
+  }
 
-    return builder.GetAbsoluteUrl();
+  std::string ShareSasTokenGenerator::GenerateSasToken(const std::string& filePath) const
+  {
+    return m_template->GenerateSasToken(filePath);
   }
 
 }}} // namespace Azure::Storage::Sas
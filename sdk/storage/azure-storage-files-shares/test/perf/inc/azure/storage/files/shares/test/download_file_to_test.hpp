@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Test the throughput of the parallel transfer of `DownloadTo`.
+ *
+ */
+
+#pragma once
+
+#include <azure/perf.hpp>
+#include <azure/perf/random_stream.hpp>
+
+#include "azure/storage/files/shares/test/share_base_test.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares { namespace Test {
+
+  /**
+   * @brief A test to measure downloading a file to a buffer with the transfer options from the
+   * command line.
+   *
+   * @remark The first range request is also of the chunk size, so that the tests of a sweep over
+   * the chunk size and the concurrency measure the parallel transfer.
+   */
+  class DownloadFileTo : public Azure::Storage::Files::Shares::Test::SharesTest {
+  private:
+    std::vector<uint8_t> m_downloadBuffer;
+    Azure::Storage::Files::Shares::DownloadFileToOptions m_downloadOptions;
+
+  public:
+    /**
+     * @brief Construct a new DownloadFileTo test.
+     *
+     * @param options The test options.
+     */
+    DownloadFileTo(Azure::Perf::TestOptions options) : SharesTest(options) {}
+
+    /**
+     * @brief Upload the file to download and create the transfer options.
+     *
+     */
+    void Setup() override
+    {
+      // Call base to create file client
+      SharesTest::Setup();
+
+      auto const size = m_options.GetMandatoryOption<int64_t>("Size");
+      m_downloadBuffer = Azure::Perf::RandomStream::Create(static_cast<size_t>(size))
+                             ->ReadToEnd(Azure::Core::Context::ApplicationContext);
+      m_fileClient->UploadFrom(m_downloadBuffer.data(), m_downloadBuffer.size());
+
+      auto& transferOptions = m_downloadOptions.TransferOptions;
+      transferOptions.Concurrency
+          = m_options.GetOptionOrDefault<int32_t>("Concurrency", transferOptions.Concurrency);
+      auto const chunkSize = m_options.GetOptionOrDefault<int64_t>("ChunkSize", 0);
+      if (chunkSize != 0)
+      {
+        transferOptions.ChunkSize = chunkSize;
+        transferOptions.InitialChunkSize = chunkSize;
+      }
+      transferOptions.AutoTune = m_options.GetOptionOrDefault<bool>("AutoTune", false);
+    }
+
+    /**
+     * @brief Define the test
+     *
+     */
+    void Run(Azure::Core::Context const& context) override
+    {
+      m_fileClient->DownloadTo(
+          m_downloadBuffer.data(), m_downloadBuffer.size(), m_downloadOptions, context);
+    }
+
+    /**
+     * @brief Each run transfers the whole file.
+     *
+     */
+    int64_t GetBytesPerOperation() override
+    {
+      return static_cast<int64_t>(m_downloadBuffer.size());
+    }
+
+    /**
+     * @brief Define the test options for the test.
+     *
+     * @return The list of test options.
+     */
+    std::vector<Azure::Perf::TestOption> GetTestOptions() override
+    {
+      return {
+          {"Size", {"--size", "-s"}, "Size of payload (in bytes)", 1, true},
+          {"Concurrency",
+           {"--concurrency"},
+           "The maximum number of threads of the transfer",
+           1,
+           false},
+          {"ChunkSize",
+           {"--chunk-size"},
+           "The size of the range requests (in bytes)",
+           1,
+           false},
+          {"AutoTune",
+           {"--auto-tune"},
+           "Whether the chunk size and the concurrency are tuned during the transfer",
+           1,
+           false}};
+    }
+
+    /**
+     * @brief Get the static Test Metadata for the test.
+     *
+     * @return Azure::Perf::TestMetadata describing the test.
+     */
+    static Azure::Perf::TestMetadata GetTestMetadata()
+    {
+      return {
+          "DownloadFileTo",
+          "Download a file to a buffer with parallel transfer.",
+          [](Azure::Perf::TestOptions options) {
+            return std::make_unique<Azure::Storage::Files::Shares::Test::DownloadFileTo>(options);
+          }};
+    }
+  };
+
+}}}}} // namespace Azure::Storage::Files::Shares::Test
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Define the base behavior of the tests using a share file client.
+ *
+ */
+
+#pragma once
+
+#include <azure/core/uuid.hpp>
+#include <azure/perf.hpp>
+
+#include <azure/storage/files/shares.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares { namespace Test {
+
+  /**
+   * @brief A base test that set up a share files performance test.
+   *
+   */
+  class SharesTest : public Azure::Perf::PerfTest {
+  protected:
+    std::string m_shareName;
+    std::string m_fileName;
+    std::unique_ptr<Azure::Storage::Files::Shares::ShareClient> m_shareClient;
+    std::unique_ptr<Azure::Storage::Files::Shares::ShareFileClient> m_fileClient;
+
+  public:
+    /**
+     * @brief Create the share and the file client
+     *
+     */
+    void Setup() override
+    {
+      // Get connection string from env
+      const static std::string connectionString = std::getenv("STORAGE_CONNECTION_STRING");
+
+      // Generate random share and file names.
+      m_shareName = "share" + Azure::Core::Uuid::CreateUuid().ToString();
+      m_fileName = "file" + Azure::Core::Uuid::CreateUuid().ToString();
+
+      m_shareClient = std::make_unique<Azure::Storage::Files::Shares::ShareClient>(
+          Azure::Storage::Files::Shares::ShareClient::CreateFromConnectionString(
+              connectionString, m_shareName));
+      m_shareClient->CreateIfNotExists();
+      m_fileClient = std::make_unique<Azure::Storage::Files::Shares::ShareFileClient>(
+          m_shareClient->GetRootDirectoryClient().GetFileClient(m_fileName));
+    }
+
+    void Cleanup() override { m_shareClient->DeleteIfExists(); }
+
+    /**
+     * @brief Construct a new SharesTest test.
+     *
+     * @param options The test options.
+     */
+    SharesTest(Azure::Perf::TestOptions options) : PerfTest(options) {}
+  };
+
+}}}}} // namespace Azure::Storage::Files::Shares::Test
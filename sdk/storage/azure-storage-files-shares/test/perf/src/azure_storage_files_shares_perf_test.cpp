@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/perf.hpp>
+
+#include "azure/storage/files/shares/test/download_file_to_test.hpp"
+#include "azure/storage/files/shares/test/upload_file_from_test.hpp"
+
+#include <vector>
+
+int main(int argc, char** argv)
+{
+
+  // Create the test list
+  std::vector<Azure::Perf::TestMetadata> tests{
+      Azure::Storage::Files::Shares::Test::UploadFileFrom::GetTestMetadata(),
+      Azure::Storage::Files::Shares::Test::DownloadFileTo::GetTestMetadata()};
+
+  Azure::Perf::Program::Run(Azure::Core::Context::ApplicationContext, tests, argc, argv);
+
+  return 0;
+}
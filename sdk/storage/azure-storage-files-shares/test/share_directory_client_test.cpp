@@ -5,6 +5,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <mutex>
+
+#include <azure/core/uuid.hpp>
 
 namespace Azure { namespace Storage { namespace Test {
 
@@ -453,4 +456,190 @@ namespace Azure { namespace Storage { namespace Test {
     {
     }
   }
+
+  namespace {
+    // Lists the directories of the file paths like the service, the directories being the
+    // prefixes of the paths, and records the paths deleted in order.
+    class MockListFilesAndDirectoriesTransportPolicy final
+        : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockListFilesAndDirectoriesTransportPolicy(
+          std::vector<std::string> paths,
+          std::shared_ptr<std::vector<std::string>> deletedPaths = nullptr)
+          : m_paths(std::move(paths)), m_deletedPaths(std::move(deletedPaths)),
+            m_mutex(std::make_shared<std::mutex>())
+      {
+        std::sort(m_paths.begin(), m_paths.end());
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockListFilesAndDirectoriesTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        auto query = request.GetUrl().GetQueryParameters();
+        const std::string urlPath = Core::Url::Decode(request.GetUrl().GetPath());
+        if (request.GetMethod() == Core::Http::HttpMethod::Delete)
+        {
+          {
+            std::lock_guard<std::mutex> guard(*m_mutex);
+            m_deletedPaths->push_back(
+                urlPath.length() > 6 ? urlPath.substr(std::string("share/").length()) : "");
+          }
+          auto response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Accepted, "Accepted");
+          response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+          response->SetHeader("x-ms-version", Files::Shares::_detail::DefaultServiceApiVersion);
+          return response;
+        }
+        const std::string directory
+            = urlPath.length() > 6 ? urlPath.substr(std::string("share/").length()) + "/" : "";
+        const std::string prefix = directory + Core::Url::Decode(query["prefix"]);
+        const size_t pageSize
+            = query["maxresults"].empty() ? m_paths.size() : std::stoul(query["maxresults"]);
+        const size_t marker = query["marker"].empty() ? 0 : std::stoul(query["marker"]);
+
+        std::vector<std::string> items;
+        for (const auto& path : m_paths)
+        {
+          if (path.compare(0, prefix.length(), prefix) != 0)
+          {
+            continue;
+          }
+          const auto slashPosition = path.find('/', directory.length());
+          std::string item = slashPosition == std::string::npos
+              ? "<File><Name>" + path.substr(directory.length())
+                  + "</Name><Properties><Content-Length>0</Content-Length></Properties></File>"
+              : "<Directory><Name>"
+                  + path.substr(directory.length(), slashPosition - directory.length())
+                  + "</Name></Directory>";
+          if (items.empty() || items.back() != item)
+          {
+            items.push_back(std::move(item));
+          }
+        }
+
+        std::string body = "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+                           "ServiceEndpoint=\"https://account.file.core.windows.net/\" "
+                           "ShareName=\"share\" DirectoryPath=\"\"><Entries>";
+        for (size_t i = marker; i < std::min(items.size(), marker + pageSize); ++i)
+        {
+          body += items[i];
+        }
+        body += "</Entries><NextMarker>";
+        if (marker + pageSize < items.size())
+        {
+          body += std::to_string(marker + pageSize);
+        }
+        body += "</NextMarker></EnumerationResults>";
+
+        auto response = std::make_unique<Core::Http::RawResponse>(
+            1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+        response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+        response->SetHeader("content-length", std::to_string(body.length()));
+        response->SetHeader("content-type", "application/xml");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Files::Shares::_detail::DefaultServiceApiVersion);
+        return response;
+      }
+
+    private:
+      std::vector<std::string> m_paths;
+      std::shared_ptr<std::vector<std::string>> m_deletedPaths;
+      std::shared_ptr<std::mutex> m_mutex;
+    };
+  } // namespace
+
+  TEST(ShareListFilesAndDirectoriesConcurrentlyTest, ListsSubdirectories)
+  {
+    const std::vector<std::string> paths
+        = {"a/1", "a/2", "a/b/1", "a/b/c/1", "ab", "b", "c/1", "c/2", "c/3", "d/e/1", "d/f/1"};
+    Files::Shares::ShareClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockListFilesAndDirectoriesTransportPolicy>(paths));
+    Files::Shares::ShareDirectoryClient directoryClient(
+        "https://account.file.core.windows.net/share", clientOptions);
+
+    std::mutex itemsMutex;
+    std::vector<std::string> files;
+    std::vector<std::string> directories;
+    auto onItems = [&](const std::string& directoryPath,
+                       std::vector<Files::Shares::Models::DirectoryItem> directoryItems,
+                       std::vector<Files::Shares::Models::FileItem> fileItems) {
+      const std::string prefix = directoryPath.empty() ? "" : directoryPath + "/";
+      std::lock_guard<std::mutex> guard(itemsMutex);
+      for (const auto& i : directoryItems)
+      {
+        directories.push_back(prefix + i.Name);
+      }
+      for (const auto& i : fileItems)
+      {
+        files.push_back(prefix + i.Name);
+      }
+    };
+
+    Files::Shares::ListFilesAndDirectoriesConcurrentlyOptions options;
+    options.PageSizeHint = 2;
+    options.Concurrency = 3;
+    options.MaxPendingDirectories = 1;
+    directoryClient.ListFilesAndDirectoriesConcurrently(onItems, options);
+    std::sort(files.begin(), files.end());
+    std::sort(directories.begin(), directories.end());
+    EXPECT_EQ(files, paths);
+    EXPECT_EQ(
+        directories, (std::vector<std::string>{"a", "a/b", "a/b/c", "c", "d", "d/e", "d/f"}));
+
+    files.clear();
+    directories.clear();
+    options.Prefix = "a";
+    options.MaxDepth = 1;
+    directoryClient.ListFilesAndDirectoriesConcurrently(onItems, options);
+    std::sort(files.begin(), files.end());
+    std::sort(directories.begin(), directories.end());
+    EXPECT_EQ(files, (std::vector<std::string>{"a/1", "a/2", "ab"}));
+    EXPECT_EQ(directories, (std::vector<std::string>{"a", "a/b"}));
+  }
+
+  TEST(ShareDirectoryDeleteRecursiveTest, DeletesFilesThenDirectories)
+  {
+    const std::vector<std::string> paths
+        = {"dir/a/1",
+           "dir/a/2",
+           "dir/a/b/1",
+           "dir/a/b/c/1",
+           "dir/b",
+           "dir/c/1",
+           "dir/d/e/1",
+           "dir/d/f/1",
+           "other/1"};
+    auto deletedPaths = std::make_shared<std::vector<std::string>>();
+    Files::Shares::ShareClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockListFilesAndDirectoriesTransportPolicy>(paths, deletedPaths));
+    Files::Shares::ShareDirectoryClient directoryClient(
+        "https://account.file.core.windows.net/share/dir", clientOptions);
+
+    Files::Shares::DeleteDirectoryRecursiveOptions options;
+    options.Concurrency = 3;
+    auto result = directoryClient.DeleteRecursive(options).Value;
+    EXPECT_EQ(result.DeletedFileCount, 8);
+    EXPECT_EQ(result.DeletedDirectoryCount, 8);
+
+    // Each directory is deleted after its files and its subdirectories.
+    ASSERT_EQ(deletedPaths->size(), 16U);
+    EXPECT_EQ(deletedPaths->back(), "dir");
+    for (size_t i = 0; i < deletedPaths->size(); ++i)
+    {
+      const std::string prefix = (*deletedPaths)[i] + "/";
+      for (size_t j = i + 1; j < deletedPaths->size(); ++j)
+      {
+        EXPECT_NE((*deletedPaths)[j].compare(0, prefix.length(), prefix), 0);
+      }
+    }
+  }
 }}} // namespace Azure::Storage::Test
@@ -6,15 +6,191 @@
 #include <algorithm>
 #include <chrono>
 #include <future>
+#include <mutex>
 #include <random>
 
 #include <azure/core/cryptography/hash.hpp>
+#include <azure/core/uuid.hpp>
 #include <azure/storage/common/crypt.hpp>
 #include <azure/storage/common/internal/file_io.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // Serves a file whose content is fileContent, with the ranges rangeList, and keeps the ranges
+    // downloaded.
+    class MockSparseFileTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockSparseFileTransportPolicy(
+          std::shared_ptr<const std::vector<uint8_t>> fileContent,
+          std::string rangeList,
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::vector<std::string>> downloadedRanges)
+          : m_fileContent(std::move(fileContent)), m_rangeList(std::move(rangeList)),
+            m_mutex(std::move(mutex)), m_downloadedRanges(std::move(downloadedRanges))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockSparseFileTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        const std::string fileSize = std::to_string(m_fileContent->size());
+        auto headers = request.GetHeaders();
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (request.GetUrl().GetQueryParameters()["comp"] == "rangelist")
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetBody(std::vector<uint8_t>(m_rangeList.begin(), m_rangeList.end()));
+          response->SetHeader("x-ms-content-length", fileSize);
+        }
+        else
+        {
+          const std::string range = headers.at("x-ms-range");
+          {
+            std::lock_guard<std::mutex> guard(*m_mutex);
+            m_downloadedRanges->push_back(range);
+          }
+          const auto dashPosition = range.find('-');
+          const size_t start = std::stoull(range.substr(6, dashPosition - 6));
+          const size_t end = std::stoull(range.substr(dashPosition + 1));
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::PartialContent, "Partial Content");
+          response->SetBodyStream(std::make_unique<Core::IO::MemoryBodyStream>(
+              m_fileContent->data() + start, end - start + 1));
+          response->SetHeader("content-length", std::to_string(end - start + 1));
+          response->SetHeader(
+              "content-range",
+              "bytes " + std::to_string(start) + "-" + std::to_string(end) + "/" + fileSize);
+          response->SetHeader("content-type", "application/octet-stream");
+          response->SetHeader("accept-ranges", "bytes");
+          response->SetHeader("x-ms-server-encrypted", "true");
+          response->SetHeader("x-ms-file-attributes", "Archive");
+          response->SetHeader("x-ms-file-creation-time", "2001-08-23T07:00:00.0000000Z");
+          response->SetHeader("x-ms-file-last-write-time", "2001-08-23T07:00:00.0000000Z");
+          response->SetHeader("x-ms-file-change-time", "2001-08-23T07:00:00.0000000Z");
+          response->SetHeader("x-ms-file-permission-key", "permission-key");
+          response->SetHeader("x-ms-file-id", "1");
+          response->SetHeader("x-ms-file-parent-id", "0");
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Files::Shares::_detail::DefaultServiceApiVersion);
+        return response;
+      }
+
+    private:
+      std::shared_ptr<const std::vector<uint8_t>> m_fileContent;
+      std::string m_rangeList;
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::vector<std::string>> m_downloadedRanges;
+    };
+
+    // Serves the requests of a parallel copy into a file, which exists with the valid ranges of
+    // rangeList if it isn't empty.
+    class MockFileCopyTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockFileCopyTransportPolicy(
+          int64_t fileSize,
+          std::string rangeList,
+          std::shared_ptr<std::mutex> mutex,
+          std::shared_ptr<std::vector<std::string>> requests)
+          : m_fileSize(fileSize), m_rangeList(std::move(rangeList)), m_mutex(std::move(mutex)),
+            m_requests(std::move(requests))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockFileCopyTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        auto headers = request.GetHeaders();
+        const std::string comp = request.GetUrl().GetQueryParameters()["comp"];
+        std::unique_ptr<Core::Http::RawResponse> response;
+        if (comp == "rangelist")
+        {
+          {
+            std::lock_guard<std::mutex> guard(*m_mutex);
+            m_requests->push_back("rangelist");
+          }
+          if (m_rangeList.empty())
+          {
+            const std::string error = "<?xml version=\"1.0\" encoding=\"utf-8\"?><Error>"
+                                      "<Code>ResourceNotFound</Code>"
+                                      "<Message>The specified resource does not exist.</Message>"
+                                      "</Error>";
+            response = std::make_unique<Core::Http::RawResponse>(
+                1, 1, Core::Http::HttpStatusCode::NotFound, "Not Found");
+            response->SetBody(std::vector<uint8_t>(error.begin(), error.end()));
+            response->SetHeader("content-type", "application/xml");
+          }
+          else
+          {
+            response = std::make_unique<Core::Http::RawResponse>(
+                1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+            response->SetBody(std::vector<uint8_t>(m_rangeList.begin(), m_rangeList.end()));
+            response->SetHeader("x-ms-content-length", std::to_string(m_fileSize));
+          }
+        }
+        else if (comp == "range")
+        {
+          EXPECT_EQ(headers.at("x-ms-copy-source"), "https://account.file.core.windows.net/s/f");
+          {
+            std::lock_guard<std::mutex> guard(*m_mutex);
+            m_requests->push_back(headers.at("x-ms-range"));
+          }
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("x-ms-content-crc64", "AAAAAAAAAAA=");
+          response->SetHeader("x-ms-request-server-encrypted", "true");
+        }
+        else
+        {
+          {
+            std::lock_guard<std::mutex> guard(*m_mutex);
+            m_requests->push_back("create " + headers.at("x-ms-content-length"));
+          }
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          response->SetHeader("x-ms-request-server-encrypted", "true");
+          response->SetHeader("x-ms-file-attributes", "Archive");
+          response->SetHeader("x-ms-file-creation-time", "2001-08-23T07:00:00.0000000Z");
+          response->SetHeader("x-ms-file-last-write-time", "2001-08-23T07:00:00.0000000Z");
+          response->SetHeader("x-ms-file-change-time", "2001-08-23T07:00:00.0000000Z");
+          response->SetHeader("x-ms-file-permission-key", "permission-key");
+          response->SetHeader("x-ms-file-id", "1");
+          response->SetHeader("x-ms-file-parent-id", "0");
+        }
+        response->SetHeader("etag", DummyETag.ToString());
+        response->SetHeader("last-modified", "Thu, 23 Aug 2001 07:00:00 GMT");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", Files::Shares::_detail::DefaultServiceApiVersion);
+        return response;
+      }
+
+    private:
+      int64_t m_fileSize;
+      std::string m_rangeList;
+      std::shared_ptr<std::mutex> m_mutex;
+      std::shared_ptr<std::vector<std::string>> m_requests;
+    };
+  } // namespace
+
   std::shared_ptr<Files::Shares::ShareFileClient> FileShareFileClientTest::m_fileClient;
   std::string FileShareFileClientTest::m_fileName;
   std::vector<uint8_t> FileShareFileClientTest::m_fileContent;
@@ -705,6 +881,33 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST_F(FileShareFileClientTest, OpenWrite)
+  {
+    auto fileClient = m_shareClient->GetRootDirectoryClient().GetFileClient(RandomString());
+    std::vector<uint8_t> expectedContent(static_cast<size_t>(64 * 1024));
+    fileClient.Create(static_cast<int64_t>(expectedContent.size()));
+
+    Files::Shares::OpenWriteShareFileOptions options;
+    options.RangeSize = 16 * 1024;
+    auto writer = fileClient.OpenWrite(options);
+    for (size_t offset = 0; offset < 40 * 1024; offset += 100)
+    {
+      auto data = RandomBuffer(100);
+      writer->WriteAt(static_cast<int64_t>(offset), data.data(), data.size());
+      std::copy(data.begin(), data.end(), expectedContent.begin() + offset);
+    }
+    auto data = RandomBuffer(1000);
+    writer->WriteAt(50000, data.data(), data.size());
+    std::copy(data.begin(), data.end(), expectedContent.begin() + 50000);
+    writer->Flush();
+
+    auto downloaded = fileClient.Download().Value.BodyStream->ReadToEnd();
+    EXPECT_EQ(downloaded, expectedContent);
+
+    options.RangeSize = 8 * 1024 * 1024;
+    EXPECT_THROW(fileClient.OpenWrite(options), Azure::Core::RequestFailedException);
+  }
+
   TEST_F(FileShareFileClientTest, CopyRelated)
   {
     size_t fileSize = 1 * 1024 * 1024;
@@ -975,4 +1178,248 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST_F(FileShareFileClientTest, CopyFromUriParallel)
+  {
+    std::string fileName = RandomString();
+    auto fileContent = RandomBuffer(static_cast<size_t>(9_MB));
+    auto sourceFileClient = m_shareClient->GetRootDirectoryClient().GetFileClient(fileName);
+    sourceFileClient.UploadFrom(fileContent.data(), fileContent.size());
+
+    Sas::ShareSasBuilder fileSasBuilder;
+    fileSasBuilder.Protocol = Sas::SasProtocol::HttpsAndHttp;
+    fileSasBuilder.StartsOn = std::chrono::system_clock::now() - std::chrono::minutes(5);
+    fileSasBuilder.ExpiresOn = std::chrono::system_clock::now() + std::chrono::minutes(60);
+    fileSasBuilder.ShareName = m_shareName;
+    fileSasBuilder.FilePath = fileName;
+    fileSasBuilder.Resource = Sas::ShareSasResource::File;
+    fileSasBuilder.SetPermissions(Sas::ShareSasPermissions::Read);
+    std::string sourceSas = fileSasBuilder.GenerateSasToken(
+        *_internal::ParseConnectionString(StandardStorageConnectionString()).KeyCredential);
+
+    auto destFileClient = m_shareClient->GetRootDirectoryClient().GetFileClient(RandomString());
+    Files::Shares::CopyFileFromUriParallelOptions options;
+    options.Resumable = true;
+    auto result
+        = destFileClient.CopyFromUriParallel(sourceFileClient.GetUrl() + sourceSas, options).Value;
+    EXPECT_EQ(result.FileSize, 9_MB);
+    EXPECT_EQ(result.CopiedSize, 9_MB);
+    std::vector<uint8_t> downloadContent(fileContent.size());
+    destFileClient.DownloadTo(downloadContent.data(), downloadContent.size());
+    EXPECT_EQ(downloadContent, fileContent);
+
+    result
+        = destFileClient.CopyFromUriParallel(sourceFileClient.GetUrl() + sourceSas, options).Value;
+    EXPECT_EQ(result.CopiedSize, 0);
+    EXPECT_EQ(result.ResumedSize, 9_MB);
+  }
+
+  TEST(ShareFileDownloadSparseToTest, DownloadsValidRanges)
+  {
+    auto fileContent = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(8_KB), 0);
+    RandomBuffer(fileContent->data() + 512, 1_KB);
+    RandomBuffer(fileContent->data() + 3_KB, 2_KB + 512);
+    const std::string rangeList = "<?xml version=\"1.0\" encoding=\"utf-8\"?><Ranges>"
+                                  "<Range><Start>512</Start><End>1535</End></Range>"
+                                  "<Range><Start>3072</Start><End>5631</End></Range>"
+                                  "</Ranges>";
+    auto mutex = std::make_shared<std::mutex>();
+    auto downloadedRanges = std::make_shared<std::vector<std::string>>();
+    Files::Shares::ShareClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockSparseFileTransportPolicy>(
+        fileContent, rangeList, mutex, downloadedRanges));
+    Files::Shares::ShareFileClient fileClient(
+        "https://account.file.core.windows.net/share/file", clientOptions);
+
+    const std::string tempFilename = RandomString();
+    Files::Shares::DownloadFileSparseToOptions options;
+    options.TransferOptions.ChunkSize = 1_KB;
+    options.TransferOptions.Concurrency = 2;
+    auto result = fileClient.DownloadSparseTo(tempFilename, options).Value;
+    EXPECT_EQ(result.ETag, DummyETag);
+    EXPECT_EQ(result.FileSize, 8_KB);
+    EXPECT_EQ(result.DownloadedSize, 3_KB + 512);
+    EXPECT_EQ(ReadFile(tempFilename), *fileContent);
+    DeleteFile(tempFilename);
+
+    std::sort(downloadedRanges->begin(), downloadedRanges->end());
+    EXPECT_EQ(
+        *downloadedRanges,
+        std::vector<std::string>(
+            {"bytes=3072-4095", "bytes=4096-5119", "bytes=512-1535", "bytes=5120-5631"}));
+  }
+
+  TEST(ShareFileDownloadDiffToTest, AppliesChanges)
+  {
+    auto fileContent = std::make_shared<std::vector<uint8_t>>(RandomBuffer(8_KB));
+    std::fill(fileContent->begin() + 2_KB, fileContent->begin() + 3_KB, uint8_t(0));
+    const std::string rangeList = "<?xml version=\"1.0\" encoding=\"utf-8\"?><Ranges>"
+                                  "<Range><Start>512</Start><End>1535</End></Range>"
+                                  "<ClearRange><Start>2048</Start><End>3071</End></ClearRange>"
+                                  "<Range><Start>6144</Start><End>8191</End></Range>"
+                                  "</Ranges>";
+    auto mutex = std::make_shared<std::mutex>();
+    auto downloadedRanges = std::make_shared<std::vector<std::string>>();
+    Files::Shares::ShareClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockSparseFileTransportPolicy>(
+        fileContent, rangeList, mutex, downloadedRanges));
+    Files::Shares::ShareFileClient fileClient(
+        "https://account.file.core.windows.net/share/file", clientOptions);
+
+    // The copy of the previous share snapshot differs from the file only in the changed ranges,
+    // the file was resized from 6 KiB.
+    const std::string tempFilename = RandomString();
+    std::vector<uint8_t> previousContent(fileContent->begin(), fileContent->begin() + 6_KB);
+    RandomBuffer(previousContent.data() + 512, 1_KB);
+    RandomBuffer(previousContent.data() + 2_KB, 1_KB);
+    {
+      _internal::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(previousContent.data(), previousContent.size(), 0);
+    }
+
+    auto result = fileClient.DownloadDiffTo("snapshot", tempFilename).Value;
+    EXPECT_EQ(result.ETag, DummyETag);
+    EXPECT_EQ(result.FileSize, 8_KB);
+    EXPECT_EQ(result.DownloadedSize, 3_KB);
+    EXPECT_EQ(result.ClearedSize, 1_KB);
+    EXPECT_EQ(result.Ranges.size(), 2U);
+    EXPECT_EQ(result.ClearRanges.size(), 1U);
+    EXPECT_EQ(ReadFile(tempFilename), *fileContent);
+    DeleteFile(tempFilename);
+
+    std::sort(downloadedRanges->begin(), downloadedRanges->end());
+    EXPECT_EQ(*downloadedRanges, std::vector<std::string>({"bytes=512-1535", "bytes=6144-8191"}));
+  }
+
+  TEST(ShareFileCopyFromUriParallelTest, CopiesAndResumesRanges)
+  {
+    const std::string sourceUri = "https://account.file.core.windows.net/s/f";
+    auto mutex = std::make_shared<std::mutex>();
+    auto requests = std::make_shared<std::vector<std::string>>();
+    std::vector<int64_t> progress;
+    Files::Shares::CopyFileFromUriParallelOptions options;
+    options.SourceLength = 10_KB;
+    options.TransferOptions.ChunkSize = 4_KB;
+    options.TransferOptions.Concurrency = 2;
+    options.ProgressHandler = [&](int64_t copied, int64_t total) {
+      EXPECT_EQ(total, 10_KB);
+      progress.push_back(copied);
+    };
+    {
+      Files::Shares::ShareClientOptions clientOptions;
+      clientOptions.PerRetryPolicies.emplace_back(
+          std::make_unique<MockFileCopyTransportPolicy>(10_KB, "", mutex, requests));
+      Files::Shares::ShareFileClient fileClient(
+          "https://account.file.core.windows.net/share/file", clientOptions);
+
+      auto result = fileClient.CopyFromUriParallel(sourceUri, options).Value;
+      EXPECT_EQ(result.FileSize, 10_KB);
+      EXPECT_EQ(result.CopiedSize, 10_KB);
+      EXPECT_EQ(result.ResumedSize, 0);
+      EXPECT_EQ(progress.size(), 3U);
+      EXPECT_EQ(progress.back(), 10_KB);
+      EXPECT_EQ(requests->front(), "create 10240");
+      std::sort(requests->begin() + 1, requests->end());
+      EXPECT_EQ(
+          *requests,
+          std::vector<std::string>(
+              {"create 10240", "bytes=0-4095", "bytes=4096-8191", "bytes=8192-10239"}));
+    }
+
+    // The file being resumed has the first range and part of the second one, the second one is
+    // copied again.
+    requests->clear();
+    progress.clear();
+    options.Resumable = true;
+    {
+      const std::string rangeList = "<?xml version=\"1.0\" encoding=\"utf-8\"?><Ranges>"
+                                    "<Range><Start>0</Start><End>5119</End></Range>"
+                                    "</Ranges>";
+      Files::Shares::ShareClientOptions clientOptions;
+      clientOptions.PerRetryPolicies.emplace_back(
+          std::make_unique<MockFileCopyTransportPolicy>(10_KB, rangeList, mutex, requests));
+      Files::Shares::ShareFileClient fileClient(
+          "https://account.file.core.windows.net/share/file", clientOptions);
+
+      auto result = fileClient.CopyFromUriParallel(sourceUri, options).Value;
+      EXPECT_EQ(result.CopiedSize, 6_KB);
+      EXPECT_EQ(result.ResumedSize, 4_KB);
+      EXPECT_EQ(progress.size(), 2U);
+      EXPECT_EQ(progress.back(), 10_KB);
+      std::sort(requests->begin(), requests->end());
+      EXPECT_EQ(
+          *requests,
+          std::vector<std::string>({"bytes=4096-8191", "bytes=8192-10239", "rangelist"}));
+    }
+
+    // A file which doesn't exist is created.
+    requests->clear();
+    {
+      Files::Shares::ShareClientOptions clientOptions;
+      clientOptions.PerRetryPolicies.emplace_back(
+          std::make_unique<MockFileCopyTransportPolicy>(10_KB, "", mutex, requests));
+      Files::Shares::ShareFileClient fileClient(
+          "https://account.file.core.windows.net/share/file", clientOptions);
+
+      auto result = fileClient.CopyFromUriParallel(sourceUri, options).Value;
+      EXPECT_EQ(result.CopiedSize, 10_KB);
+      EXPECT_EQ(requests->size(), 5U);
+      EXPECT_EQ(requests->at(0), "rangelist");
+      EXPECT_EQ(requests->at(1), "create 10240");
+    }
+  }
+
+  TEST_F(FileShareFileClientTest, DownloadSparseTo)
+  {
+    auto fileClient = m_shareClient->GetRootDirectoryClient().GetFileClient(RandomString());
+    std::vector<uint8_t> fileContent(static_cast<size_t>(4_MB), 0);
+    fileClient.Create(fileContent.size());
+    auto rangeContent = RandomBuffer(static_cast<size_t>(8_KB));
+    std::copy(rangeContent.begin(), rangeContent.end(), fileContent.begin() + 1_MB);
+    auto rangeStream = Azure::Core::IO::MemoryBodyStream(rangeContent.data(), rangeContent.size());
+    fileClient.UploadRange(1_MB, rangeStream);
+
+    const std::string tempFilename = RandomString();
+    auto result = fileClient.DownloadSparseTo(tempFilename).Value;
+    EXPECT_EQ(result.FileSize, static_cast<int64_t>(fileContent.size()));
+    EXPECT_EQ(result.DownloadedSize, 8_KB);
+    EXPECT_EQ(ReadFile(tempFilename), fileContent);
+    DeleteFile(tempFilename);
+  }
+
+  TEST_F(FileShareFileClientTest, DownloadDiffToUploadDiffFrom)
+  {
+    auto sourceClient = m_shareClient->GetRootDirectoryClient().GetFileClient(RandomString());
+    auto sourceContent = RandomBuffer(static_cast<size_t>(64_KB));
+    sourceClient.UploadFrom(sourceContent.data(), sourceContent.size());
+    const std::string snapshot = m_shareClient->CreateSnapshot().Value.Snapshot;
+    const std::string tempFilename = RandomString();
+    sourceClient.DownloadTo(tempFilename);
+    auto destinationClient = m_shareClient->GetRootDirectoryClient().GetFileClient(RandomString());
+    destinationClient.UploadFrom(tempFilename);
+
+    auto rangeContent = RandomBuffer(static_cast<size_t>(8_KB));
+    auto rangeStream = Azure::Core::IO::MemoryBodyStream(rangeContent.data(), rangeContent.size());
+    sourceClient.UploadRange(16_KB, rangeStream);
+    sourceClient.ClearRange(0, 4_KB);
+
+    auto downloadResult = sourceClient.DownloadDiffTo(snapshot, tempFilename).Value;
+    EXPECT_EQ(downloadResult.DownloadedSize, 8_KB);
+    EXPECT_EQ(downloadResult.ClearedSize, 4_KB);
+    std::vector<uint8_t> fileContent(static_cast<size_t>(64_KB));
+    sourceClient.DownloadTo(fileContent.data(), fileContent.size());
+    EXPECT_EQ(ReadFile(tempFilename), fileContent);
+
+    auto uploadResult = destinationClient
+                            .UploadDiffFrom(
+                                tempFilename, downloadResult.Ranges, downloadResult.ClearRanges)
+                            .Value;
+    EXPECT_EQ(uploadResult.FileSize, 64_KB);
+    EXPECT_EQ(uploadResult.UploadedSize, 8_KB);
+    EXPECT_EQ(uploadResult.ClearedSize, 4_KB);
+    std::vector<uint8_t> destinationContent(static_cast<size_t>(64_KB));
+    destinationClient.DownloadTo(destinationContent.data(), destinationContent.size());
+    EXPECT_EQ(destinationContent, fileContent);
+    DeleteFile(tempFilename);
+  }
+
 }}} // namespace Azure::Storage::Test
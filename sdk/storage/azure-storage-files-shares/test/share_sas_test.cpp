@@ -216,4 +216,28 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST(ShareSasTokenGeneratorTest, SameAsBuilder)
+  {
+    StorageSharedKeyCredential credential(
+        "account", Azure::Core::Convert::Base64Encode(RandomBuffer(64)));
+
+    Sas::ShareSasBuilder builder;
+    builder.Protocol = Sas::SasProtocol::HttpsOnly;
+    builder.ExpiresOn = Azure::DateTime(2021, 1, 2);
+    builder.IPRange = "0.0.0.0-255.255.255.255";
+    builder.ShareName = "share";
+    builder.Resource = Sas::ShareSasResource::File;
+    builder.SetPermissions(Sas::ShareFileSasPermissions::Read);
+
+    const Sas::ShareSasTokenGenerator generator(builder, credential);
+    for (const std::string filePath : {"file", "dir/file name+1"})
+    {
+      builder.FilePath = filePath;
+      EXPECT_EQ(generator.GenerateSasToken(filePath), builder.GenerateSasToken(credential));
+    }
+
+    builder.Resource = Sas::ShareSasResource::Share;
+    EXPECT_THROW(Sas::ShareSasTokenGenerator(builder, credential), std::invalid_argument);
+  }
+
 }}} // namespace Azure::Storage::Test
@@ -10,5 +10,7 @@
 
 #include "azure/storage/queues/dll_import_export.hpp"
 #include "azure/storage/queues/queue_client.hpp"
+#include "azure/storage/queues/queue_poller.hpp"
+#include "azure/storage/queues/queue_processor.hpp"
 #include "azure/storage/queues/queue_sas_builder.hpp"
 #include "azure/storage/queues/queue_service_client.hpp"
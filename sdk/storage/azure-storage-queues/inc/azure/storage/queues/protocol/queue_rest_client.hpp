@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <string>
 #include <type_traits>
@@ -78,6 +79,11 @@ namespace Azure { namespace Storage { namespace Queues {
        * The number of times the message has been dequeued.
        */
       int64_t DequeueCount = 0;
+      /**
+       * The reference of the payload of the message in the payload store of the client, if the
+       * message was enqueued with its payload offloaded. Null otherwise.
+       */
+      Azure::Nullable<std::string> PayloadReference;
     }; // struct PeekedQueueMessage
 
     /**
@@ -96,6 +102,24 @@ namespace Azure { namespace Storage { namespace Queues {
       Storage::Metadata Metadata;
     }; // struct QueueItem
 
+    /**
+     * @brief The text of a received message in the body of the raw response it was received in,
+     * see #Azure::Storage::Queues::ReceiveMessagesOptions::MessageTextViewOnly. It's valid as long
+     * as the response.
+     */
+    struct QueueMessageTextView final
+    {
+      /**
+       * The first character of the text, which isn't null-terminated. Null if the message text was
+       * copied into QueueMessage::MessageText instead.
+       */
+      char* Data = nullptr;
+      /**
+       * The number of characters of the text.
+       */
+      size_t Size = 0;
+    }; // struct QueueMessageTextView
+
     /**
      * @brief A message object stored in the queue.
      */
@@ -129,6 +153,16 @@ namespace Azure { namespace Storage { namespace Queues {
        * The number of times the message has been dequeued.
        */
       int64_t DequeueCount = 0;
+      /**
+       * The reference of the payload of the message in the payload store of the client, if the
+       * message was enqueued with its payload offloaded. Null otherwise.
+       */
+      Azure::Nullable<std::string> PayloadReference;
+      /**
+       * The content of the message in the body of the response, when it's not copied into
+       * MessageText.
+       */
+      QueueMessageTextView MessageTextView;
     }; // struct QueueMessage
 
     /**
@@ -1788,6 +1822,17 @@ namespace Azure { namespace Storage { namespace Queues {
             writer.Write(_internal::XmlNode{_internal::XmlNodeType::End});
             xml_body = writer.GetDocument();
           }
+          return EnqueueMessage(pipeline, url, xml_body, options, context);
+        }
+
+        // Sends a message already serialized to xml_body, options.MessageText is ignored.
+        static Azure::Response<EnqueueMessageResult> EnqueueMessage(
+            Azure::Core::Http::_internal::HttpPipeline& pipeline,
+            const Azure::Core::Url& url,
+            const std::string& xml_body,
+            const EnqueueMessageOptions& options,
+            const Azure::Core::Context& context)
+        {
           Azure::Core::IO::MemoryBodyStream xml_body_stream(
               reinterpret_cast<const uint8_t*>(xml_body.data()), xml_body.length());
           auto request = Azure::Core::Http::Request(
@@ -1832,6 +1877,7 @@ namespace Azure { namespace Storage { namespace Queues {
           Azure::Nullable<int32_t> Timeout;
           Azure::Nullable<int64_t> MaxMessages;
           Azure::Nullable<std::chrono::seconds> VisibilityTimeout;
+          bool MessageTextViewOnly = false;
         }; // struct ReceiveMessagesOptions
 
         static Azure::Response<ReceivedMessages> ReceiveMessages(
@@ -1867,9 +1913,19 @@ namespace Azure { namespace Storage { namespace Queues {
           }
           {
             const auto& httpResponseBody = httpResponse.GetBody();
-            _internal::XmlReader reader(
-                reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
-            response = ReceivedMessagesFromXml(reader);
+            // Polling an empty queue returns an empty list, which is skipped without setting up
+            // a reader.
+            if (HasQueueMessageElement(httpResponseBody))
+            {
+              _internal::XmlReader reader(
+                  reinterpret_cast<const char*>(httpResponseBody.data()),
+                  httpResponseBody.size());
+              response = ReceivedMessagesFromXml(reader, !options.MessageTextViewOnly);
+            }
+          }
+          if (options.MessageTextViewOnly)
+          {
+            SetMessageTextViews(httpResponse.GetBody(), response.Messages);
           }
           return Azure::Response<ReceivedMessages>(std::move(response), std::move(pHttpResponse));
         }
@@ -2073,6 +2129,54 @@ namespace Azure { namespace Storage { namespace Queues {
         }
 
       private:
+        static bool HasQueueMessageElement(const std::vector<uint8_t>& body)
+        {
+          static constexpr char Tag[] = "<QueueMessage";
+          const char* end = reinterpret_cast<const char*>(body.data()) + body.size();
+          const char* tag = reinterpret_cast<const char*>(body.data());
+          while ((tag = std::search(tag, end, Tag, Tag + sizeof(Tag) - 1)) != end)
+          {
+            // Not QueueMessagesList.
+            tag += sizeof(Tag) - 1;
+            if (tag != end && (*tag == '>' || *tag == '/' || *tag == ' '))
+            {
+              return true;
+            }
+          }
+          return false;
+        }
+
+        // Points the messages to their text in the body, unescaped in place. The service returns
+        // the text of every message in one MessageText element, in the order of the messages.
+        static void SetMessageTextViews(
+            std::vector<uint8_t>& body,
+            std::vector<QueueMessage>& messages)
+        {
+          static constexpr char StartTag[] = "<MessageText";
+          static constexpr char EndTag[] = "</MessageText>";
+          char* position = reinterpret_cast<char*>(body.data());
+          char* const end = position + body.size();
+          for (auto& message : messages)
+          {
+            position = std::search(position, end, StartTag, StartTag + sizeof(StartTag) - 1);
+            position = std::find(position, end, '>');
+            if (position == end)
+            {
+              break;
+            }
+            // An empty text may be an empty element.
+            const bool emptyElement = *(position - 1) == '/';
+            ++position;
+            char* const textEnd = emptyElement
+                ? position
+                : std::search(position, end, EndTag, EndTag + sizeof(EndTag) - 1);
+            message.MessageTextView.Data = position;
+            message.MessageTextView.Size = _internal::UnescapeXmlTextInPlace(
+                position, static_cast<size_t>(textEnd - position));
+            position = textEnd;
+          }
+        }
+
         static EnqueueMessageResult EnqueueMessageResultFromXml(_internal::XmlReader& reader)
         {
           EnqueueMessageResult ret;
@@ -2295,7 +2399,9 @@ namespace Azure { namespace Storage { namespace Queues {
           return ret;
         }
 
-        static ReceivedMessages ReceivedMessagesFromXml(_internal::XmlReader& reader)
+        static ReceivedMessages ReceivedMessagesFromXml(
+            _internal::XmlReader& reader,
+            bool copyMessageText)
         {
           ReceivedMessages ret;
           enum class XmlTagName
@@ -2340,7 +2446,7 @@ namespace Azure { namespace Storage { namespace Queues {
               if (path.size() == 2 && path[0] == XmlTagName::k_QueueMessagesList
                   && path[1] == XmlTagName::k_QueueMessage)
               {
-                ret.Messages.emplace_back(QueueMessageFromXml(reader));
+                ret.Messages.emplace_back(QueueMessageFromXml(reader, copyMessageText));
                 path.pop_back();
               }
             }
@@ -2438,7 +2544,7 @@ namespace Azure { namespace Storage { namespace Queues {
           return ret;
         }
 
-        static QueueMessage QueueMessageFromXml(_internal::XmlReader& reader)
+        static QueueMessage QueueMessageFromXml(_internal::XmlReader& reader, bool copyMessageText)
         {
           QueueMessage ret;
           enum class XmlTagName
@@ -2508,7 +2614,7 @@ namespace Azure { namespace Storage { namespace Queues {
             }
             else if (node.Type == _internal::XmlNodeType::Text)
             {
-              if (path.size() == 1 && path[0] == XmlTagName::k_MessageText)
+              if (path.size() == 1 && path[0] == XmlTagName::k_MessageText && copyMessageText)
               {
                 ret.MessageText = node.Value;
               }
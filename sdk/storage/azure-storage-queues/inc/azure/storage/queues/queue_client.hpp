@@ -10,11 +10,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <azure/core/credentials/credentials.hpp>
 #include <azure/storage/common/storage_credential.hpp>
 
 #include "azure/storage/queues/queue_options.hpp"
+#include "azure/storage/queues/queue_responses.hpp"
 
 namespace Azure { namespace Storage { namespace Queues {
 
@@ -174,6 +176,23 @@ namespace Azure { namespace Storage { namespace Queues {
         const EnqueueMessageOptions& options = EnqueueMessageOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Adds new messages to the back of the queue, several of them at the same time. A
+     * failed message doesn't stop the others, its outcome is reported with the others'.
+     *
+     * @param messageTexts The texts of the messages.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A EnqueueMessagesResult containing the outcome of the enqueue of every message.
+     * @remark Every message is sent in its own request, retried like a single enqueue by the retry
+     * policy of the client options. A message is enqueued before the messages after it only if
+     * the concurrency is 1.
+     */
+    Models::EnqueueMessagesResult EnqueueMessages(
+        const std::vector<std::string>& messageTexts,
+        const EnqueueMessagesOptions& options = EnqueueMessagesOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Receives one or more messages from the front of the queue. Returns empty collection if
      * there's not message available.
@@ -233,6 +252,34 @@ namespace Azure { namespace Storage { namespace Queues {
         const DeleteMessageOptions& options = DeleteMessageOptions(),
         const Azure::Core::Context& context = Azure::Core::Context()) const;
 
+    /**
+     * @brief Permanently removes a received message from the queue, and deletes its payload from
+     * the payload store if it was offloaded.
+     *
+     * @param message The message received.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling long running operations.
+     * @return A DeleteMessageResult describing the result.
+     * @remark The payload is deleted only once the message is, so a payload is never missing for
+     * a message still in the queue.
+     */
+    Azure::Response<Models::DeleteMessageResult> DeleteMessage(
+        const Models::QueueMessage& message,
+        const DeleteMessageOptions& options = DeleteMessageOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
+    /**
+     * @brief Downloads the payload of an offloaded message from the payload store, when the
+     * payloads aren't prefetched on receive.
+     *
+     * @param payloadReference The payload reference of the message received or peeked.
+     * @param context Context for cancelling long running operations.
+     * @return The text of the message as it was enqueued.
+     */
+    std::string DownloadMessagePayload(
+        const std::string& payloadReference,
+        const Azure::Core::Context& context = Azure::Core::Context()) const;
+
     /**
      * @brief Deletes all messages from the queue.
      *
@@ -247,14 +294,17 @@ namespace Azure { namespace Storage { namespace Queues {
   private:
     explicit QueueClient(
         Azure::Core::Url queueUrl,
-        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline)
-        : m_queueUrl(std::move(queueUrl)), m_pipeline(std::move(pipeline))
+        std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> pipeline,
+        PayloadOffloadOptions payloadOffload)
+        : m_queueUrl(std::move(queueUrl)), m_pipeline(std::move(pipeline)),
+          m_payloadOffload(std::move(payloadOffload))
     {
     }
 
   private:
     Azure::Core::Url m_queueUrl;
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    PayloadOffloadOptions m_payloadOffload;
 
     friend class QueueServiceClient;
   };
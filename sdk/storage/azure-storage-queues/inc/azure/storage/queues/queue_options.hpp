@@ -9,9 +9,15 @@
 #pragma once
 
 #include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <string>
 
+#include <azure/core/context.hpp>
 #include <azure/core/internal/client_options.hpp>
+#include <azure/storage/common/congestion_controller.hpp>
+#include <azure/storage/common/rate_limiter.hpp>
 
 #include "azure/storage/queues/protocol/queue_rest_client.hpp"
 
@@ -59,6 +65,83 @@ namespace Azure { namespace Storage { namespace Queues {
     std::string m_version;
   };
 
+  /**
+   * @brief Stores the payloads of the messages too large to be enqueued as they are, the messages
+   * enqueued carry a reference to their payload instead. It's typically implemented with a blob
+   * container, the references being blob names.
+   */
+  class QueueMessagePayloadStore {
+  public:
+    /**
+     * @brief Destructs the store.
+     */
+    virtual ~QueueMessagePayloadStore() = default;
+
+    /**
+     * @brief Stores a payload. Called by several threads at the same time.
+     *
+     * @param payload The text of the message.
+     * @param context Context for cancelling long running operations.
+     * @return The reference enqueued in place of the payload. It mustn't contain characters that
+     * are invalid in XML.
+     */
+    virtual std::string Upload(const std::string& payload, const Azure::Core::Context& context)
+        = 0;
+
+    /**
+     * @brief Retrieves a payload stored by Upload.
+     *
+     * @param payloadReference The reference returned by Upload.
+     * @param context Context for cancelling long running operations.
+     * @return The text of the message.
+     */
+    virtual std::string Download(
+        const std::string& payloadReference,
+        const Azure::Core::Context& context)
+        = 0;
+
+    /**
+     * @brief Deletes a payload stored by Upload.
+     *
+     * @param payloadReference The reference returned by Upload.
+     * @param context Context for cancelling long running operations.
+     */
+    virtual void Delete(const std::string& payloadReference, const Azure::Core::Context& context)
+        = 0;
+  };
+
+  /**
+   * @brief The offload of the payloads of large messages to a store, see
+   * #Azure::Storage::Queues::QueueClientOptions::PayloadOffload.
+   */
+  struct PayloadOffloadOptions final
+  {
+    /**
+     * @brief Stores the payloads of the messages larger than the threshold. If null, the messages
+     * are never offloaded.
+     */
+    std::shared_ptr<QueueMessagePayloadStore> Store;
+
+    /**
+     * @brief The size in bytes above which the text of a message is offloaded. The default leaves
+     * room for the escaping of the text under the 64 KiB limit of the service.
+     */
+    size_t Threshold = 48 * 1024;
+
+    /**
+     * @brief Whether the payloads of the messages received or peeked are downloaded before the
+     * messages are returned. If false, the text of an offloaded message is left as enqueued, and
+     * its payload is downloaded with
+     * #Azure::Storage::Queues::QueueClient::DownloadMessagePayload.
+     */
+    bool PrefetchPayloads = true;
+
+    /**
+     * @brief The maximum number of payloads being prefetched at the same time.
+     */
+    int32_t Concurrency = 8;
+  };
+
   struct QueueClientOptions final : Azure::Core::_internal::ClientOptions
   {
     /**
@@ -74,6 +157,27 @@ namespace Azure { namespace Storage { namespace Queues {
      * API version used by this client.
      */
     ServiceVersion ApiVersion{_detail::ApiVersion};
+
+    /**
+     * @brief Limits the bandwidth and the rate of the requests of the client. The same limiter
+     * can be shared by several clients. If null, there is no limit.
+     */
+    std::shared_ptr<Azure::Storage::RateLimiter> RateLimiter;
+
+    /**
+     * @brief Limits the number of requests of the client in flight to each account, adjusting
+     * the limits when the accounts throttle the requests. The same controller can be shared by
+     * several clients. If null, the requests in flight aren't limited.
+     */
+    std::shared_ptr<Azure::Storage::CongestionController> CongestionController;
+
+    /**
+     * @brief Offloads the payloads of large messages to a store. The text of a message above the
+     * threshold is uploaded to the store and a reference to it is enqueued instead. The payloads
+     * are restored when the messages are received or peeked, and deleted with the messages by
+     * #Azure::Storage::Queues::QueueClient::DeleteMessage.
+     */
+    PayloadOffloadOptions PayloadOffload;
   };
 
   /**
@@ -196,6 +300,28 @@ namespace Azure { namespace Storage { namespace Queues {
     AZ_STORAGE_QUEUES_DLLEXPORT const static std::chrono::seconds MessageNeverExpires;
   };
 
+  /**
+   * Optional parameters for #Azure::Storage::Queues::QueueClient::EnqueueMessages.
+   */
+  struct EnqueueMessagesOptions final
+  {
+    /**
+     * Specifies how long the messages should be invisible to dequeue and peek operations.
+     */
+    Azure::Nullable<std::chrono::seconds> VisibilityTimeout;
+
+    /**
+     * Specifies the time-to-live interval for the messages, see
+     * #Azure::Storage::Queues::EnqueueMessageOptions::TimeToLive.
+     */
+    Azure::Nullable<std::chrono::seconds> TimeToLive;
+
+    /**
+     * The maximum number of messages being sent at the same time.
+     */
+    int32_t Concurrency = 16;
+  };
+
   /**
    * Optional parameters for #Azure::Storage::Queues::QueueClient::ReceiveMessages.
    */
@@ -210,6 +336,15 @@ namespace Azure { namespace Storage { namespace Queues {
      * interval specified by this parameter.
      */
     Azure::Nullable<std::chrono::seconds> VisibilityTimeout;
+
+    /**
+     * @brief If true, the text of the messages isn't copied into QueueMessage::MessageText, which
+     * is left empty. It's accessed with QueueMessage::MessageTextView instead, in the body of the
+     * raw response, where the texts containing XML escapes are unescaped in place. Base64 texts
+     * can then be decoded in place with
+     * #Azure::Storage::Queues::Base64DecodeMessageTextInPlace.
+     */
+    bool MessageTextViewOnly = false;
   };
 
   /**
@@ -248,4 +383,71 @@ namespace Azure { namespace Storage { namespace Queues {
   {
   };
 
+  /**
+   * Optional parameters for #Azure::Storage::Queues::QueuePoller.
+   */
+  struct QueuePollerOptions final
+  {
+    /**
+     * The delay before receiving again after a receive call returns no message, doubled after
+     * every following empty receive up to MaxIdleDelay. The delays are jittered by -20% to +30%.
+     */
+    std::chrono::milliseconds MinIdleDelay = std::chrono::milliseconds(100);
+
+    /**
+     * The maximum delay before receiving again when the queue is empty.
+     */
+    std::chrono::milliseconds MaxIdleDelay = std::chrono::seconds(10);
+  };
+
+  /**
+   * Optional parameters for #Azure::Storage::Queues::QueueProcessor.
+   */
+  struct QueueProcessorOptions final
+  {
+    /**
+     * The maximum number of receive calls in flight at the same time.
+     */
+    int32_t ReceiveConcurrency = 2;
+
+    /**
+     * The maximum number of messages handled at the same time.
+     */
+    int32_t HandlerConcurrency = 16;
+
+    /**
+     * The maximum number of messages received and not handled yet, including those requested by
+     * the receive calls in flight. Each receive call requests up to 32 messages.
+     */
+    int32_t MaxBufferedMessages = 64;
+
+    /**
+     * The visibility timeout of the messages received, extended by this much every half of it
+     * until the messages are handled.
+     */
+    std::chrono::seconds VisibilityTimeout = std::chrono::seconds(30);
+
+    /**
+     * The maximum number of messages deleted at the same time.
+     */
+    int32_t DeleteConcurrency = 4;
+
+    /**
+     * The delay before receiving again after a receive call returns no message, doubled after
+     * every following empty receive up to MaxIdleDelay. The delays are jittered by -20% to +30%.
+     */
+    std::chrono::milliseconds MinIdleDelay = std::chrono::milliseconds(100);
+
+    /**
+     * The maximum delay before receiving again when the queue is empty.
+     */
+    std::chrono::milliseconds MaxIdleDelay = std::chrono::seconds(10);
+
+    /**
+     * Called with the exceptions thrown by the handler, and by the requests of the processor once
+     * the retry policy of the client gave up on them. Called by several threads at the same time.
+     */
+    std::function<void(std::exception_ptr)> ErrorHandler;
+  };
+
 }}} // namespace Azure::Storage::Queues
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+/**
+ * @file
+ * @brief Defines Queue poller.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <azure/core/context.hpp>
+#include <azure/core/response.hpp>
+
+#include "azure/storage/queues/queue_client.hpp"
+#include "azure/storage/queues/queue_options.hpp"
+
+namespace Azure { namespace Storage { namespace Queues {
+
+  namespace _detail {
+    class IdleBackoff;
+  } // namespace _detail
+
+  /**
+   * @brief Receives messages from a queue, waiting for them while the queue is empty.
+   *
+   * @remark The queue is polled with a delay after every empty receive, starting from the minimum
+   * idle delay of the options and doubling up to the maximum one, with a jitter so that several
+   * consumers don't poll at the same time. Once messages arrive the delay goes back to the minimum.
+   * A poller is used by one thread at a time.
+   */
+  class QueuePoller final {
+  public:
+    /**
+     * @brief Initializes a new instance of QueuePoller.
+     *
+     * @param queueClient The client of the queue.
+     * @param options Optional parameters to execute this function.
+     */
+    explicit QueuePoller(
+        QueueClient queueClient,
+        const QueuePollerOptions& options = QueuePollerOptions());
+
+    /**
+     * @brief Destructs the poller.
+     */
+    ~QueuePoller();
+
+    /**
+     * @brief Initializes a new instance of QueuePoller taking the state of another one.
+     *
+     * @param other The poller to move from.
+     */
+    QueuePoller(QueuePoller&& other) noexcept;
+
+    /**
+     * @brief Takes the state of another poller.
+     *
+     * @param other The poller to move from.
+     * @return This poller.
+     */
+    QueuePoller& operator=(QueuePoller&& other) noexcept;
+
+    /**
+     * @brief Receives one or more messages from the front of the queue, polling it until there are
+     * messages.
+     *
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling the requests and the wait, a context with a deadline
+     * limits the wait.
+     * @return A ReceivedMessages that contains at least one queue message.
+     */
+    Azure::Response<Models::ReceivedMessages> ReceiveMessages(
+        const ReceiveMessagesOptions& options = ReceiveMessagesOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context());
+
+  private:
+    QueueClient m_queueClient;
+    std::unique_ptr<_detail::IdleBackoff> m_idleBackoff;
+  };
+
+}}} // namespace Azure::Storage::Queues
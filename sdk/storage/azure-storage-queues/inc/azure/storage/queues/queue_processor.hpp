@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+/**
+ * @file
+ * @brief Defines Queue processor.
+ *
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <azure/core/context.hpp>
+
+#include "azure/storage/queues/queue_client.hpp"
+#include "azure/storage/queues/queue_options.hpp"
+
+namespace Azure { namespace Storage { namespace Queues {
+
+  /**
+   * @brief Receives the messages of a queue and handles them concurrently, until it's stopped.
+   *
+   * @remark Up to the receive concurrency of the options receive calls are in flight at the same
+   * time, and the messages received are buffered until one of the handler threads takes them, the
+   * receive calls waiting while the maximum number of buffered messages is reached. A message
+   * handled successfully is deleted in the background, with its offloaded payload if it has one, a
+   * message whose handler throws is left to be received again once its visibility timeout
+   * expires. The visibility timeout of the messages buffered and being handled is extended with
+   * UpdateMessage every half visibility timeout, so that long handlers keep their messages. When
+   * the queue is empty, the receive calls back off from the minimum to the maximum idle delay of
+   * the options.
+   */
+  class QueueProcessor final {
+  public:
+    /**
+     * @brief Handles a message received from the queue. Called by several threads at the same
+     * time, each with a different message.
+     */
+    using MessageHandler
+        = std::function<void(const Models::QueueMessage& message, const Azure::Core::Context&)>;
+
+    /**
+     * @brief Initializes a new instance of QueueProcessor and starts receiving messages.
+     *
+     * @param queueClient The client of the queue, its pipeline is used for all the requests.
+     * @param handler Handles the messages received.
+     * @param options Optional parameters to execute this function.
+     * @param context Context for cancelling the requests, passed to the handler too. Once it's
+     * cancelled, no more message is received.
+     */
+    explicit QueueProcessor(
+        QueueClient queueClient,
+        MessageHandler handler,
+        const QueueProcessorOptions& options = QueueProcessorOptions(),
+        const Azure::Core::Context& context = Azure::Core::Context());
+
+    /**
+     * @brief Stops the processor, see Stop().
+     */
+    ~QueueProcessor();
+
+    QueueProcessor(const QueueProcessor&) = delete;
+    QueueProcessor& operator=(const QueueProcessor&) = delete;
+
+    /**
+     * @brief Stops receiving messages, and waits for the messages received to be handled and for
+     * the messages handled successfully to be deleted.
+     */
+    void Stop();
+
+  private:
+    struct State;
+
+    std::unique_ptr<State> m_state;
+  };
+
+}}} // namespace Azure::Storage::Queues
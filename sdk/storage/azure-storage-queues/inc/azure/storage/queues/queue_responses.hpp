@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <azure/core/paged_response.hpp>
 
@@ -20,6 +21,66 @@ namespace Azure { namespace Storage { namespace Queues {
 
   class QueueServiceClient;
 
+  namespace Models {
+
+    /**
+     * @brief The outcome of the enqueue of one message.
+     */
+    struct EnqueueMessageOutcome final
+    {
+      /**
+       * The message enqueued, null if it failed to be enqueued.
+       */
+      Azure::Nullable<EnqueueMessageResult> EnqueuedMessage;
+
+      /**
+       * The HTTP status code of the failed enqueue, or of its last attempt.
+       */
+      Azure::Core::Http::HttpStatusCode StatusCode = Azure::Core::Http::HttpStatusCode::None;
+
+      /**
+       * The error code of the failed enqueue.
+       */
+      std::string ErrorCode;
+
+      /**
+       * The error message of the failed enqueue.
+       */
+      std::string ErrorMessage;
+    };
+
+    /**
+     * @brief Response type for #Azure::Storage::Queues::QueueClient::EnqueueMessages.
+     */
+    struct EnqueueMessagesResult final
+    {
+      /**
+       * The outcome of the enqueue of every message, in the order of the messages.
+       */
+      std::vector<EnqueueMessageOutcome> Outcomes;
+
+      /**
+       * Number of messages enqueued successfully.
+       */
+      int64_t NumberOfSuccessfulMessages = 0;
+
+      /**
+       * Number of messages that failed to be enqueued.
+       */
+      int64_t NumberOfFailures = 0;
+    };
+
+  } // namespace Models
+
+  /**
+   * @brief Decodes the Base64 text of a message received with
+   * #Azure::Storage::Queues::ReceiveMessagesOptions::MessageTextViewOnly in place, in the body of
+   * the response.
+   *
+   * @param messageText The view of the text of the message. It's updated to the decoded bytes.
+   */
+  void Base64DecodeMessageTextInPlace(Models::QueueMessageTextView& messageText);
+
   /**
    * @brief Response type for #Azure::Storage::Queues::QueueServiceClient::ListQueues.
    */
@@ -174,6 +174,7 @@ namespace Azure { namespace Storage { namespace Queues {
   private:
     Azure::Core::Url m_serviceUrl;
     std::shared_ptr<Azure::Core::Http::_internal::HttpPipeline> m_pipeline;
+    PayloadOffloadOptions m_payloadOffload;
   };
 
 }}} // namespace Azure::Storage::Queues
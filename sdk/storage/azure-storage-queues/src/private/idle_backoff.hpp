@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace Azure { namespace Storage { namespace Queues { namespace _detail {
+
+  // The delay before polling an empty queue again. It doubles after every empty poll up to the
+  // maximum, and is jittered like the delays of the retry policy so that the consumers of a queue
+  // don't poll it in lockstep.
+  class IdleBackoff final {
+  public:
+    explicit IdleBackoff(std::chrono::milliseconds minDelay, std::chrono::milliseconds maxDelay)
+        : m_minDelay(minDelay), m_maxDelay(std::max(minDelay, maxDelay)), m_delay(minDelay)
+    {
+    }
+
+    // Returns the delay after an empty poll.
+    std::chrono::milliseconds NextDelay()
+    {
+      const double jitterFactor
+          = 0.8 + static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX) * 0.5;
+      const auto delay = std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(
+          static_cast<double>(m_delay.count()) * jitterFactor));
+      m_delay = std::min(m_delay * 2, m_maxDelay);
+      return std::min(delay, m_maxDelay);
+    }
+
+    // Called when messages arrive, the next empty poll is followed by the minimum delay again.
+    void Reset() { m_delay = m_minDelay; }
+
+  private:
+    std::chrono::milliseconds m_minDelay;
+    std::chrono::milliseconds m_maxDelay;
+    std::chrono::milliseconds m_delay;
+  };
+
+}}}} // namespace Azure::Storage::Queues::_detail
@@ -4,16 +4,91 @@
 #include "azure/storage/queues/queue_client.hpp"
 
 #include <azure/core/http/policies/policy.hpp>
+#include <azure/core/internal/diagnostics/span.hpp>
+#include <azure/storage/common/internal/concurrent_transfer.hpp>
+#include <azure/storage/common/internal/congestion_control_policy.hpp>
+#include <azure/storage/common/internal/rate_limit_policy.hpp>
 #include <azure/storage/common/internal/shared_key_policy.hpp>
 #include <azure/storage/common/internal/storage_per_retry_policy.hpp>
-#include <azure/storage/common/internal/storage_service_version_policy.hpp>
 #include <azure/storage/common/internal/storage_switch_to_secondary_policy.hpp>
+#include <azure/storage/common/internal/xml_wrapper.hpp>
 #include <azure/storage/common/storage_common.hpp>
 
 #include "private/package_version.hpp"
 
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
 namespace Azure { namespace Storage { namespace Queues {
 
+  namespace {
+    // Starts the text of the messages whose payload is offloaded, followed by the payload
+    // reference.
+    const std::string PayloadReferencePrefix = "azure-storage-queue-payload:";
+
+    // The text of a message as it was enqueued, which is only in the body of the response when
+    // it's not copied.
+    std::pair<const char*, size_t> GetReceivedText(const Models::QueueMessage& message)
+    {
+      if (message.MessageTextView.Data != nullptr)
+      {
+        return {message.MessageTextView.Data, message.MessageTextView.Size};
+      }
+      return {message.MessageText.data(), message.MessageText.size()};
+    }
+
+    std::pair<const char*, size_t> GetReceivedText(const Models::PeekedQueueMessage& message)
+    {
+      return {message.MessageText.data(), message.MessageText.size()};
+    }
+
+    // Finds the messages whose payload is offloaded and downloads their payloads, unless the
+    // payloads aren't prefetched.
+    template <class MessageType>
+    void RestorePayloads(
+        std::vector<MessageType>& messages,
+        const PayloadOffloadOptions& payloadOffload,
+        const Azure::Core::Context& context)
+    {
+      if (!payloadOffload.Store)
+      {
+        return;
+      }
+      std::vector<MessageType*> offloadedMessages;
+      for (auto& message : messages)
+      {
+        const auto text = GetReceivedText(message);
+        if (text.second >= PayloadReferencePrefix.size()
+            && std::memcmp(text.first, PayloadReferencePrefix.data(), PayloadReferencePrefix.size())
+                == 0)
+        {
+          message.PayloadReference = std::string(
+              text.first + PayloadReferencePrefix.size(),
+              text.second - PayloadReferencePrefix.size());
+          offloadedMessages.push_back(&message);
+        }
+      }
+      if (!payloadOffload.PrefetchPayloads || offloadedMessages.empty())
+      {
+        return;
+      }
+      _internal::ConcurrentTransferOptions transferOptions;
+      transferOptions.ChunkSize = 1;
+      transferOptions.Concurrency = payloadOffload.Concurrency;
+      _internal::ConcurrentTransfer(
+          0,
+          static_cast<int64_t>(offloadedMessages.size()),
+          transferOptions,
+          [&](int64_t messageIndex, int64_t, int64_t) {
+            auto& message = *offloadedMessages[static_cast<size_t>(messageIndex)];
+            message.MessageText
+                = payloadOffload.Store->Download(message.PayloadReference.Value(), context);
+          },
+          nullptr);
+    }
+  } // namespace
+
   QueueClient QueueClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& queueName,
@@ -47,15 +122,25 @@ namespace Azure { namespace Storage { namespace Queues {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
         m_queueUrl.GetHost(), newOptions.SecondaryHostForRetryReads));
+    if (newOptions.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(newOptions.RateLimiter));
+    }
+    if (newOptions.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(newOptions.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(newOptions.ApiVersion.ToString()));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         newOptions,
         _internal::QueueServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{
+            {_internal::HttpHeaderXMsVersion, newOptions.ApiVersion.ToString()}});
   }
 
   QueueClient::QueueClient(
@@ -68,6 +153,16 @@ namespace Azure { namespace Storage { namespace Queues {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
         m_queueUrl.GetHost(), options.SecondaryHostForRetryReads));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
     {
       Azure::Core::Credentials::TokenRequestContext tokenContext;
@@ -76,44 +171,53 @@ namespace Azure { namespace Storage { namespace Queues {
           std::make_unique<Azure::Core::Http::Policies::_internal::BearerTokenAuthenticationPolicy>(
               credential, tokenContext));
     }
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion.ToString()));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::QueueServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion.ToString()}});
   }
 
   QueueClient::QueueClient(const std::string& queueUrl, const QueueClientOptions& options)
-      : m_queueUrl(queueUrl)
+      : m_queueUrl(queueUrl), m_payloadOffload(options.PayloadOffload)
   {
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perRetryPolicies;
     std::vector<std::unique_ptr<Azure::Core::Http::Policies::HttpPolicy>> perOperationPolicies;
     perRetryPolicies.emplace_back(std::make_unique<_internal::StorageSwitchToSecondaryPolicy>(
         m_queueUrl.GetHost(), options.SecondaryHostForRetryReads));
+    if (options.RateLimiter)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::RateLimitPolicy>(options.RateLimiter));
+    }
+    if (options.CongestionController)
+    {
+      perRetryPolicies.emplace_back(
+          std::make_unique<_internal::CongestionControlPolicy>(options.CongestionController));
+    }
     perRetryPolicies.emplace_back(std::make_unique<_internal::StoragePerRetryPolicy>());
-    perOperationPolicies.emplace_back(
-        std::make_unique<_internal::StorageServiceVersionPolicy>(options.ApiVersion.ToString()));
     m_pipeline = std::make_shared<Azure::Core::Http::_internal::HttpPipeline>(
         options,
         _internal::QueueServicePackageName,
         _detail::PackageVersion::ToString(),
         std::move(perRetryPolicies),
-        std::move(perOperationPolicies));
+        std::move(perOperationPolicies),
+        Core::CaseInsensitiveMap{{_internal::HttpHeaderXMsVersion, options.ApiVersion.ToString()}});
   }
 
   Azure::Response<Models::CreateQueueResult> QueueClient::Create(
       const CreateQueueOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.Create", context);
     try
     {
       _detail::QueueRestClient::Queue::CreateQueueOptions protocolLayerOptions;
       protocolLayerOptions.Metadata = options.Metadata;
       return _detail::QueueRestClient::Queue::Create(
-          *m_pipeline, m_queueUrl, protocolLayerOptions, context);
+          *m_pipeline, m_queueUrl, protocolLayerOptions, span.GetContext());
     }
     catch (StorageException& e)
     {
@@ -131,12 +235,13 @@ namespace Azure { namespace Storage { namespace Queues {
       const DeleteQueueOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.Delete", context);
     (void)options;
     try
     {
       _detail::QueueRestClient::Queue::DeleteQueueOptions protocolLayerOptions;
       return _detail::QueueRestClient::Queue::Delete(
-          *m_pipeline, m_queueUrl, protocolLayerOptions, context);
+          *m_pipeline, m_queueUrl, protocolLayerOptions, span.GetContext());
     }
     catch (StorageException& e)
     {
@@ -154,10 +259,11 @@ namespace Azure { namespace Storage { namespace Queues {
       const GetQueuePropertiesOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.GetProperties", context);
     (void)options;
     _detail::QueueRestClient::Queue::GetQueuePropertiesOptions protocolLayerOptions;
     return _detail::QueueRestClient::Queue::GetProperties(
-        *m_pipeline, m_queueUrl, protocolLayerOptions, context);
+        *m_pipeline, m_queueUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::SetQueueMetadataResult> QueueClient::SetMetadata(
@@ -165,21 +271,23 @@ namespace Azure { namespace Storage { namespace Queues {
       const SetQueueMetadataOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.SetMetadata", context);
     (void)options;
     _detail::QueueRestClient::Queue::SetQueueMetadataOptions protocolLayerOptions;
     protocolLayerOptions.Metadata = std::move(metadata);
     return _detail::QueueRestClient::Queue::SetMetadata(
-        *m_pipeline, m_queueUrl, protocolLayerOptions, context);
+        *m_pipeline, m_queueUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::QueueAccessPolicy> QueueClient::GetAccessPolicy(
       const GetQueueAccessPolicyOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.GetAccessPolicy", context);
     (void)options;
     _detail::QueueRestClient::Queue::GetQueueAccessPolicyOptions protocolLayerOptions;
     return _detail::QueueRestClient::Queue::GetAccessPolicy(
-        *m_pipeline, m_queueUrl, protocolLayerOptions, context);
+        *m_pipeline, m_queueUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::SetQueueAccessPolicyResult> QueueClient::SetAccessPolicy(
@@ -187,11 +295,12 @@ namespace Azure { namespace Storage { namespace Queues {
       const SetQueueAccessPolicyOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.SetAccessPolicy", context);
     (void)options;
     _detail::QueueRestClient::Queue::SetQueueAccessPolicyOptions protocolLayerOptions;
     protocolLayerOptions.SignedIdentifiers = accessPolicy.SignedIdentifiers;
     return _detail::QueueRestClient::Queue::SetAccessPolicy(
-        *m_pipeline, m_queueUrl, protocolLayerOptions, context);
+        *m_pipeline, m_queueUrl, protocolLayerOptions, span.GetContext());
   }
 
   Azure::Response<Models::EnqueueMessageResult> QueueClient::EnqueueMessage(
@@ -199,40 +308,147 @@ namespace Azure { namespace Storage { namespace Queues {
       const EnqueueMessageOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.EnqueueMessage", context);
     auto messagesUrl = m_queueUrl;
     messagesUrl.AppendPath("messages");
     _detail::QueueRestClient::Queue::EnqueueMessageOptions protocolLayerOptions;
+    if (m_payloadOffload.Store && messageText.size() > m_payloadOffload.Threshold)
+    {
+      // The message is enqueued only once its payload is stored, so that it's never received
+      // without it.
+      messageText
+          = PayloadReferencePrefix + m_payloadOffload.Store->Upload(messageText, span.GetContext());
+    }
     protocolLayerOptions.MessageText = std::move(messageText);
     protocolLayerOptions.TimeToLive = options.TimeToLive;
     protocolLayerOptions.VisibilityTimeout = options.VisibilityTimeout;
     return _detail::QueueRestClient::Queue::EnqueueMessage(
-        *m_pipeline, messagesUrl, protocolLayerOptions, context);
+        *m_pipeline, messagesUrl, protocolLayerOptions, span.GetContext());
+  }
+
+  Models::EnqueueMessagesResult QueueClient::EnqueueMessages(
+      const std::vector<std::string>& messageTexts,
+      const EnqueueMessagesOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.EnqueueMessages", context);
+    const Azure::Core::Context& spanContext = span.GetContext();
+    auto messagesUrl = m_queueUrl;
+    messagesUrl.AppendPath("messages");
+    _detail::QueueRestClient::Queue::EnqueueMessageOptions protocolLayerOptions;
+    protocolLayerOptions.TimeToLive = options.TimeToLive;
+    protocolLayerOptions.VisibilityTimeout = options.VisibilityTimeout;
+
+    // The envelope of the messages is serialized once, around a placeholder for their text, only
+    // their text is escaped for each message.
+    std::string envelopeStart;
+    std::string envelopeEnd;
+    {
+      const std::string placeholder = "MessageTextPlaceholder";
+      _internal::XmlWriter writer;
+      writer.Write(_internal::XmlNode{_internal::XmlNodeType::StartTag, "QueueMessage"});
+      writer.Write(
+          _internal::XmlNode{_internal::XmlNodeType::StartTag, "MessageText", placeholder});
+      writer.Write(_internal::XmlNode{_internal::XmlNodeType::End});
+      const std::string envelope = writer.GetDocument();
+      const size_t placeholderOffset = envelope.find(placeholder);
+      envelopeStart = envelope.substr(0, placeholderOffset);
+      envelopeEnd = envelope.substr(placeholderOffset + placeholder.size());
+    }
+
+    Models::EnqueueMessagesResult ret;
+    ret.Outcomes.resize(messageTexts.size());
+    _internal::ConcurrentTransferOptions transferOptions;
+    transferOptions.ChunkSize = 1;
+    transferOptions.Concurrency = options.Concurrency;
+    _internal::ConcurrentTransfer(
+        0,
+        static_cast<int64_t>(messageTexts.size()),
+        transferOptions,
+        [&](int64_t messageIndex, int64_t, int64_t) {
+          const auto& messageText = messageTexts[static_cast<size_t>(messageIndex)];
+          auto& outcome = ret.Outcomes[static_cast<size_t>(messageIndex)];
+          // The failures are reported with the outcomes, the other messages are still sent.
+          // Cancelling the context stops all the messages.
+          try
+          {
+            std::string xmlBody = envelopeStart;
+            if (m_payloadOffload.Store && messageText.size() > m_payloadOffload.Threshold)
+            {
+              // The payloads are uploaded concurrently too, each message being enqueued once
+              // its payload is stored.
+              _internal::AppendXmlText(
+                  xmlBody,
+                  PayloadReferencePrefix
+                      + m_payloadOffload.Store->Upload(messageText, spanContext));
+            }
+            else
+            {
+              _internal::AppendXmlText(xmlBody, messageText);
+            }
+            xmlBody += envelopeEnd;
+            outcome.EnqueuedMessage = _detail::QueueRestClient::Queue::EnqueueMessage(
+                                          *m_pipeline,
+                                          messagesUrl,
+                                          xmlBody,
+                                          protocolLayerOptions,
+                                          spanContext)
+                                          .Value;
+          }
+          catch (const Azure::Core::RequestFailedException& e)
+          {
+            outcome.StatusCode = e.StatusCode;
+            outcome.ErrorCode = e.ErrorCode;
+            outcome.ErrorMessage = e.Message;
+          }
+        },
+        nullptr);
+
+    for (const auto& outcome : ret.Outcomes)
+    {
+      if (outcome.EnqueuedMessage.HasValue())
+      {
+        ++ret.NumberOfSuccessfulMessages;
+      }
+      else
+      {
+        ++ret.NumberOfFailures;
+      }
+    }
+    return ret;
   }
 
   Azure::Response<Models::ReceivedMessages> QueueClient::ReceiveMessages(
       const ReceiveMessagesOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.ReceiveMessages", context);
     auto messagesUrl = m_queueUrl;
     messagesUrl.AppendPath("messages");
     _detail::QueueRestClient::Queue::ReceiveMessagesOptions protocolLayerOptions;
     protocolLayerOptions.MaxMessages = options.MaxMessages;
     protocolLayerOptions.VisibilityTimeout = options.VisibilityTimeout;
-    return _detail::QueueRestClient::Queue::ReceiveMessages(
-        *m_pipeline, messagesUrl, protocolLayerOptions, context);
+    protocolLayerOptions.MessageTextViewOnly = options.MessageTextViewOnly;
+    auto response = _detail::QueueRestClient::Queue::ReceiveMessages(
+        *m_pipeline, messagesUrl, protocolLayerOptions, span.GetContext());
+    RestorePayloads(response.Value.Messages, m_payloadOffload, span.GetContext());
+    return response;
   }
 
   Azure::Response<Models::PeekedMessages> QueueClient::PeekMessages(
       const PeekMessagesOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.PeekMessages", context);
     (void)options;
     auto messagesUrl = m_queueUrl;
     messagesUrl.AppendPath("messages");
     _detail::QueueRestClient::Queue::PeekMessagesOptions protocolLayerOptions;
     protocolLayerOptions.MaxMessages = options.MaxMessages;
-    return _detail::QueueRestClient::Queue::PeekMessages(
-        *m_pipeline, messagesUrl, protocolLayerOptions, context);
+    auto response = _detail::QueueRestClient::Queue::PeekMessages(
+        *m_pipeline, messagesUrl, protocolLayerOptions, span.GetContext());
+    RestorePayloads(response.Value.Messages, m_payloadOffload, span.GetContext());
+    return response;
   }
 
   Azure::Response<Models::UpdateMessageResult> QueueClient::UpdateMessage(
@@ -242,6 +458,7 @@ namespace Azure { namespace Storage { namespace Queues {
       const UpdateMessageOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.UpdateMessage", context);
     auto messageUrl = m_queueUrl;
     messageUrl.AppendPath("messages");
     messageUrl.AppendPath(_internal::UrlEncodePath(messageId));
@@ -252,7 +469,7 @@ namespace Azure { namespace Storage { namespace Queues {
       protocolLayerOptions.PopReceipt = popReceipt;
       protocolLayerOptions.VisibilityTimeout = visibilityTimeout;
       return _detail::QueueRestClient::Queue::UpdateMessage(
-          *m_pipeline, messageUrl, protocolLayerOptions, context);
+          *m_pipeline, messageUrl, protocolLayerOptions, span.GetContext());
     }
     else
     {
@@ -260,7 +477,7 @@ namespace Azure { namespace Storage { namespace Queues {
       protocolLayerOptions.PopReceipt = popReceipt;
       protocolLayerOptions.VisibilityTimeout = visibilityTimeout;
       return _detail::QueueRestClient::Queue::UpdateMessageVisibility(
-          *m_pipeline, messageUrl, protocolLayerOptions, context);
+          *m_pipeline, messageUrl, protocolLayerOptions, span.GetContext());
     }
   }
 
@@ -270,6 +487,7 @@ namespace Azure { namespace Storage { namespace Queues {
       const DeleteMessageOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.DeleteMessage", context);
     (void)options;
     auto messageUrl = m_queueUrl;
     messageUrl.AppendPath("messages");
@@ -277,19 +495,44 @@ namespace Azure { namespace Storage { namespace Queues {
     _detail::QueueRestClient::Queue::DeleteMessageOptions protocolLayerOptions;
     protocolLayerOptions.PopReceipt = popReceipt;
     return _detail::QueueRestClient::Queue::DeleteMessage(
-        *m_pipeline, messageUrl, protocolLayerOptions, context);
+        *m_pipeline, messageUrl, protocolLayerOptions, span.GetContext());
+  }
+
+  Azure::Response<Models::DeleteMessageResult> QueueClient::DeleteMessage(
+      const Models::QueueMessage& message,
+      const DeleteMessageOptions& options,
+      const Azure::Core::Context& context) const
+  {
+    auto response = DeleteMessage(message.MessageId, message.PopReceipt, options, context);
+    if (message.PayloadReference.HasValue() && m_payloadOffload.Store)
+    {
+      m_payloadOffload.Store->Delete(message.PayloadReference.Value(), context);
+    }
+    return response;
+  }
+
+  std::string QueueClient::DownloadMessagePayload(
+      const std::string& payloadReference,
+      const Azure::Core::Context& context) const
+  {
+    if (!m_payloadOffload.Store)
+    {
+      throw std::invalid_argument("The client has no payload store.");
+    }
+    return m_payloadOffload.Store->Download(payloadReference, context);
   }
 
   Azure::Response<Models::ClearMessagesResult> QueueClient::ClearMessages(
       const ClearMessagesOptions& options,
       const Azure::Core::Context& context) const
   {
+    Azure::Core::Diagnostics::_internal::Span span("QueueClient.ClearMessages", context);
     (void)options;
     auto messagesUrl = m_queueUrl;
     messagesUrl.AppendPath("messages");
     _detail::QueueRestClient::Queue::ClearMessagesOptions protocolLayerOptions;
     return _detail::QueueRestClient::Queue::ClearMessages(
-        *m_pipeline, messagesUrl, protocolLayerOptions, context);
+        *m_pipeline, messagesUrl, protocolLayerOptions, span.GetContext());
   }
 
 }}} // namespace Azure::Storage::Queues
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/queues/queue_poller.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "private/idle_backoff.hpp"
+
+namespace Azure { namespace Storage { namespace Queues {
+
+  namespace {
+    // Waits are split so that a cancelled context is noticed quickly.
+    constexpr std::chrono::milliseconds MaxWaitDuration(100);
+  } // namespace
+
+  QueuePoller::QueuePoller(QueueClient queueClient, const QueuePollerOptions& options)
+      : m_queueClient(std::move(queueClient)),
+        m_idleBackoff(
+            std::make_unique<_detail::IdleBackoff>(options.MinIdleDelay, options.MaxIdleDelay))
+  {
+  }
+
+  QueuePoller::~QueuePoller() = default;
+
+  QueuePoller::QueuePoller(QueuePoller&& other) noexcept = default;
+
+  QueuePoller& QueuePoller::operator=(QueuePoller&& other) noexcept = default;
+
+  Azure::Response<Models::ReceivedMessages> QueuePoller::ReceiveMessages(
+      const ReceiveMessagesOptions& options,
+      const Azure::Core::Context& context)
+  {
+    while (true)
+    {
+      auto response = m_queueClient.ReceiveMessages(options, context);
+      if (!response.Value.Messages.empty())
+      {
+        m_idleBackoff->Reset();
+        return response;
+      }
+      const auto waitUntil = std::chrono::steady_clock::now() + m_idleBackoff->NextDelay();
+      for (auto now = std::chrono::steady_clock::now(); now < waitUntil;
+           now = std::chrono::steady_clock::now())
+      {
+        context.ThrowIfCancelled();
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+            waitUntil - now, MaxWaitDuration));
+      }
+      context.ThrowIfCancelled();
+    }
+  }
+
+}}} // namespace Azure::Storage::Queues
@@ -0,0 +1,351 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "azure/storage/queues/queue_processor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "private/idle_backoff.hpp"
+
+namespace Azure { namespace Storage { namespace Queues {
+
+  namespace {
+    // The maximum number of messages the service returns from a receive call.
+    constexpr int32_t MaxMessagesPerReceive = 32;
+  } // namespace
+
+  struct QueueProcessor::State final
+  {
+    State(
+        QueueClient queueClient,
+        MessageHandler handler,
+        const QueueProcessorOptions& options,
+        const Azure::Core::Context& context)
+        : Client(std::move(queueClient)), Handler(std::move(handler)), Options(options),
+          Context(context)
+    {
+    }
+
+    // A message received and not deleted or abandoned yet.
+    struct Message final
+    {
+      std::string PopReceipt;
+      // Deleted with the message.
+      Azure::Nullable<std::string> PayloadReference;
+      // When its visibility timeout is extended next.
+      std::chrono::steady_clock::time_point ExtendAt;
+      // The pop receipt changes once the visibility timeout is extended, so a message handled
+      // meanwhile is deleted after that.
+      bool Extending = false;
+      bool Handled = false;
+      bool Succeeded = false;
+    };
+
+    QueueClient Client;
+    MessageHandler Handler;
+    QueueProcessorOptions Options;
+    Azure::Core::Context Context;
+
+    std::mutex Mutex;
+    // Notified when messages are received, taken, handled or deleted, when the visibility timeout
+    // of a message is extended, and when the processor stops.
+    std::condition_variable Changed;
+    // The messages received and not taken by a handler yet.
+    std::deque<Models::QueueMessage> BufferedMessages;
+    // The number of messages requested by the receive calls in flight.
+    int32_t RequestedMessageCount = 0;
+    // The messages received and not deleted or abandoned yet, by id.
+    std::map<std::string, Message> Messages;
+    // The messages handled successfully and not deleted yet, with their latest pop receipt.
+    std::deque<Models::QueueMessage> PendingDeletes;
+    int32_t RunningReceivers = 0;
+    int32_t RunningHandlers = 0;
+    bool Stopping = false;
+
+    std::vector<std::thread> Threads;
+
+    void ReceiveMessages();
+    void HandleMessages();
+    void ExtendVisibilityTimeouts();
+    void DeleteMessages();
+    // Queues the message for deletion if it was handled successfully, and forgets it. The mutex
+    // must be held.
+    void FinishMessage(std::map<std::string, Message>::iterator message);
+    void ReportError(std::exception_ptr exception) const
+    {
+      // The failures caused by the cancellation of the context are expected.
+      if (Options.ErrorHandler && !Context.IsCancelled())
+      {
+        Options.ErrorHandler(exception);
+      }
+    }
+  };
+
+  void QueueProcessor::State::ReceiveMessages()
+  {
+    _detail::IdleBackoff idleBackoff(Options.MinIdleDelay, Options.MaxIdleDelay);
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (!Stopping && !Context.IsCancelled())
+    {
+      const int32_t room = Options.MaxBufferedMessages
+          - static_cast<int32_t>(BufferedMessages.size()) - RequestedMessageCount;
+      if (room <= 0)
+      {
+        Changed.wait(lock);
+        continue;
+      }
+      const int32_t maxMessages = std::min(room, MaxMessagesPerReceive);
+      RequestedMessageCount += maxMessages;
+      lock.unlock();
+      std::vector<Models::QueueMessage> messages;
+      try
+      {
+        ReceiveMessagesOptions receiveOptions;
+        receiveOptions.MaxMessages = maxMessages;
+        receiveOptions.VisibilityTimeout = Options.VisibilityTimeout;
+        messages = Client.ReceiveMessages(receiveOptions, Context).Value.Messages;
+      }
+      catch (...)
+      {
+        ReportError(std::current_exception());
+      }
+      const auto extendAt = std::chrono::steady_clock::now() + Options.VisibilityTimeout / 2;
+      lock.lock();
+      RequestedMessageCount -= maxMessages;
+      for (auto& message : messages)
+      {
+        auto& receivedMessage = Messages[message.MessageId];
+        receivedMessage.PopReceipt = message.PopReceipt;
+        receivedMessage.PayloadReference = message.PayloadReference;
+        receivedMessage.ExtendAt = extendAt;
+        BufferedMessages.push_back(std::move(message));
+      }
+      Changed.notify_all();
+      if (!messages.empty())
+      {
+        idleBackoff.Reset();
+        continue;
+      }
+      // The queue is empty, or the request failed.
+      Changed.wait_for(lock, idleBackoff.NextDelay(), [this]() { return Stopping; });
+    }
+    --RunningReceivers;
+    Changed.notify_all();
+  }
+
+  void QueueProcessor::State::HandleMessages()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (true)
+    {
+      if (BufferedMessages.empty())
+      {
+        if (RunningReceivers == 0)
+        {
+          break;
+        }
+        Changed.wait(lock);
+        continue;
+      }
+      Models::QueueMessage message = std::move(BufferedMessages.front());
+      BufferedMessages.pop_front();
+      Changed.notify_all();
+      lock.unlock();
+      bool succeeded = false;
+      try
+      {
+        Handler(message, Context);
+        succeeded = true;
+      }
+      catch (...)
+      {
+        ReportError(std::current_exception());
+      }
+      lock.lock();
+      auto handledMessage = Messages.find(message.MessageId);
+      if (handledMessage != Messages.end())
+      {
+        handledMessage->second.Handled = true;
+        handledMessage->second.Succeeded = succeeded;
+        if (!handledMessage->second.Extending)
+        {
+          FinishMessage(handledMessage);
+        }
+      }
+    }
+    --RunningHandlers;
+    Changed.notify_all();
+  }
+
+  void QueueProcessor::State::ExtendVisibilityTimeouts()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (true)
+    {
+      // The messages left are all extended by this thread once the handlers are done.
+      if (Messages.empty() && RunningHandlers == 0)
+      {
+        break;
+      }
+      auto nextMessage = Messages.end();
+      for (auto i = Messages.begin(); i != Messages.end(); ++i)
+      {
+        if (!i->second.Handled && i->second.ExtendAt != std::chrono::steady_clock::time_point::max()
+            && (nextMessage == Messages.end() || i->second.ExtendAt < nextMessage->second.ExtendAt))
+        {
+          nextMessage = i;
+        }
+      }
+      if (nextMessage == Messages.end())
+      {
+        Changed.wait(lock);
+        continue;
+      }
+      if (nextMessage->second.ExtendAt > std::chrono::steady_clock::now())
+      {
+        Changed.wait_until(lock, nextMessage->second.ExtendAt);
+        continue;
+      }
+
+      nextMessage->second.Extending = true;
+      const std::string messageId = nextMessage->first;
+      const std::string popReceipt = nextMessage->second.PopReceipt;
+      lock.unlock();
+      Azure::Nullable<std::string> newPopReceipt;
+      try
+      {
+        newPopReceipt = Client
+                            .UpdateMessage(
+                                messageId,
+                                popReceipt,
+                                Options.VisibilityTimeout,
+                                UpdateMessageOptions(),
+                                Context)
+                            .Value.PopReceipt;
+      }
+      catch (...)
+      {
+        ReportError(std::current_exception());
+      }
+      lock.lock();
+      // The message is only forgotten by this thread while it's extended.
+      nextMessage->second.Extending = false;
+      if (newPopReceipt.HasValue())
+      {
+        nextMessage->second.PopReceipt = std::move(newPopReceipt.Value());
+        nextMessage->second.ExtendAt
+            = std::chrono::steady_clock::now() + Options.VisibilityTimeout / 2;
+      }
+      else
+      {
+        // The message was likely received by another consumer, it's not extended any more.
+        nextMessage->second.ExtendAt = std::chrono::steady_clock::time_point::max();
+      }
+      if (nextMessage->second.Handled)
+      {
+        FinishMessage(nextMessage);
+      }
+      Changed.notify_all();
+    }
+  }
+
+  void QueueProcessor::State::DeleteMessages()
+  {
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (true)
+    {
+      if (PendingDeletes.empty())
+      {
+        if (RunningHandlers == 0 && Messages.empty())
+        {
+          break;
+        }
+        Changed.wait(lock);
+        continue;
+      }
+      auto pendingDelete = std::move(PendingDeletes.front());
+      PendingDeletes.pop_front();
+      lock.unlock();
+      try
+      {
+        Client.DeleteMessage(pendingDelete, DeleteMessageOptions(), Context);
+      }
+      catch (...)
+      {
+        ReportError(std::current_exception());
+      }
+      lock.lock();
+    }
+    Changed.notify_all();
+  }
+
+  void QueueProcessor::State::FinishMessage(std::map<std::string, Message>::iterator message)
+  {
+    // A message whose handler failed is received again once its visibility timeout expires.
+    if (message->second.Succeeded)
+    {
+      Models::QueueMessage pendingDelete;
+      pendingDelete.MessageId = message->first;
+      pendingDelete.PopReceipt = std::move(message->second.PopReceipt);
+      pendingDelete.PayloadReference = std::move(message->second.PayloadReference);
+      PendingDeletes.push_back(std::move(pendingDelete));
+    }
+    Messages.erase(message);
+    Changed.notify_all();
+  }
+
+  QueueProcessor::QueueProcessor(
+      QueueClient queueClient,
+      MessageHandler handler,
+      const QueueProcessorOptions& options,
+      const Azure::Core::Context& context)
+      : m_state(
+          std::make_unique<State>(std::move(queueClient), std::move(handler), options, context))
+  {
+    State* state = m_state.get();
+    state->Options.MaxBufferedMessages = std::max(options.MaxBufferedMessages, 1);
+    state->RunningReceivers = std::max(options.ReceiveConcurrency, 1);
+    state->RunningHandlers = std::max(options.HandlerConcurrency, 1);
+    for (int32_t i = 0; i < std::max(options.DeleteConcurrency, 1); ++i)
+    {
+      state->Threads.emplace_back([state]() { state->DeleteMessages(); });
+    }
+    state->Threads.emplace_back([state]() { state->ExtendVisibilityTimeouts(); });
+    for (int32_t i = 0; i < state->RunningHandlers; ++i)
+    {
+      state->Threads.emplace_back([state]() { state->HandleMessages(); });
+    }
+    for (int32_t i = 0; i < state->RunningReceivers; ++i)
+    {
+      state->Threads.emplace_back([state]() { state->ReceiveMessages(); });
+    }
+  }
+
+  QueueProcessor::~QueueProcessor() { Stop(); }
+
+  void QueueProcessor::Stop()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_state->Mutex);
+      m_state->Stopping = true;
+    }
+    m_state->Changed.notify_all();
+    for (auto& thread : m_state->Threads)
+    {
+      if (thread.joinable())
+      {
+        thread.join();
+      }
+    }
+  }
+
+}}} // namespace Azure::Storage::Queues
@@ -3,10 +3,19 @@
 
 #include "azure/storage/queues/queue_responses.hpp"
 
+#include <azure/core/base64.hpp>
+
 #include "azure/storage/queues/queue_service_client.hpp"
 
 namespace Azure { namespace Storage { namespace Queues {
 
+  void Base64DecodeMessageTextInPlace(Models::QueueMessageTextView& messageText)
+  {
+    // The bytes are written behind the characters being decoded.
+    messageText.Size = Azure::Core::_internal::Base64::Decode(
+        messageText.Data, messageText.Size, reinterpret_cast<uint8_t*>(messageText.Data));
+  }
+
   void ListQueuesPagedResponse::OnNextPage(const Azure::Core::Context& context)
   {
     m_operationOptions.ContinuationToken = NextPageToken;
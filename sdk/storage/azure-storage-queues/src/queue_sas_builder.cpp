@@ -49,9 +49,8 @@ namespace Azure { namespace Storage { namespace Sas {
         + canonicalName + "\n" + Identifier + "\n" + (IPRange.HasValue() ? IPRange.Value() : "")
         + "\n" + protocol + "\n" + _internal::DefaultSasVersion;
 
-    std::string signature = Azure::Core::Convert::Base64Encode(_internal::HmacSha256(
-        std::vector<uint8_t>(stringToSign.begin(), stringToSign.end()),
-        Azure::Core::Convert::Base64Decode(credential.GetAccountKey())));
+    std::string signature = Azure::Core::Convert::Base64Encode(credential.GetSigningKey()->Sign(
+        reinterpret_cast<const uint8_t*>(stringToSign.data()), stringToSign.size()));
 
     Azure::Core::Url builder;
     builder.AppendQueryParameter(
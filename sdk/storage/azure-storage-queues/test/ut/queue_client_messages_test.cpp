@@ -3,11 +3,338 @@
 
 #include "queue_client_test.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include <azure/core/uuid.hpp>
 
 namespace Azure { namespace Storage { namespace Test {
 
+  namespace {
+    // Enqueues messages, recording the bodies of the requests. The messages whose text contains
+    // "invalid" are rejected.
+    class MockEnqueueTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockEnqueueTransportPolicy(std::shared_ptr<std::vector<std::string>> bodies)
+          : m_bodies(std::move(bodies))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockEnqueueTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        const auto requestBody = request.GetBodyStream()->ReadToEnd(context);
+        const std::string body(requestBody.begin(), requestBody.end());
+        {
+          std::lock_guard<std::mutex> guard(*m_mutex);
+          m_bodies->push_back(body);
+        }
+        const std::string date = "Thu, 23 Aug 2001 07:00:00 GMT";
+        std::unique_ptr<Core::Http::RawResponse> response;
+        std::string responseBody = "<?xml version=\"1.0\" encoding=\"utf-8\"?>";
+        if (body.find("invalid") != std::string::npos)
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::BadRequest, "Bad Request");
+          responseBody += "<Error><Code>InvalidXmlDocument</Code><Message>XML specified is not "
+                          "syntactically valid.</Message></Error>";
+          response->SetHeader("x-ms-error-code", "InvalidXmlDocument");
+        }
+        else
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          responseBody += "<QueueMessagesList><QueueMessage><MessageId>"
+              + Core::Uuid::CreateUuid().ToString() + "</MessageId><InsertionTime>" + date
+              + "</InsertionTime><ExpirationTime>" + date
+              + "</ExpirationTime><PopReceipt>receipt</PopReceipt><TimeNextVisible>" + date
+              + "</TimeNextVisible></QueueMessage></QueueMessagesList>";
+        }
+        response->SetBody(std::vector<uint8_t>(responseBody.begin(), responseBody.end()));
+        response->SetHeader("content-type", "application/xml");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", "2018-03-28");
+        return response;
+      }
+
+    private:
+      std::shared_ptr<std::vector<std::string>> m_bodies;
+      std::shared_ptr<std::mutex> m_mutex = std::make_shared<std::mutex>();
+    };
+
+    struct MockMessages final
+    {
+      std::mutex Mutex;
+      // The text of every message enqueued, by id.
+      std::map<std::string, std::string> Messages;
+      std::set<std::string> DeletedMessages;
+    };
+
+    // Enqueues, receives, peeks and deletes the messages of a queue. The messages are received
+    // every time, the message texts must need no escaping.
+    class MockMessagesTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockMessagesTransportPolicy(std::shared_ptr<MockMessages> messages)
+          : m_messages(std::move(messages))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockMessagesTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const& context) const override
+      {
+        const std::string date = "Thu, 23 Aug 2001 07:00:00 GMT";
+        std::unique_ptr<Core::Http::RawResponse> response;
+        std::string responseBody = "<?xml version=\"1.0\" encoding=\"utf-8\"?>";
+        std::lock_guard<std::mutex> guard(m_messages->Mutex);
+        if (request.GetMethod() == Core::Http::HttpMethod::Post)
+        {
+          const auto requestBody = request.GetBodyStream()->ReadToEnd(context);
+          const std::string body(requestBody.begin(), requestBody.end());
+          const size_t textStart = body.find("<MessageText>") + std::strlen("<MessageText>");
+          const std::string messageId
+              = "message" + std::to_string(100 + m_messages->Messages.size());
+          m_messages->Messages.emplace(
+              messageId, body.substr(textStart, body.find("</MessageText>") - textStart));
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Created, "Created");
+          responseBody += "<QueueMessagesList><QueueMessage><MessageId>" + messageId
+              + "</MessageId><InsertionTime>" + date + "</InsertionTime><ExpirationTime>" + date
+              + "</ExpirationTime><PopReceipt>receipt</PopReceipt><TimeNextVisible>" + date
+              + "</TimeNextVisible></QueueMessage></QueueMessagesList>";
+        }
+        else if (request.GetMethod() == Core::Http::HttpMethod::Get)
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          responseBody += "<QueueMessagesList>";
+          for (const auto& message : m_messages->Messages)
+          {
+            responseBody += "<QueueMessage><MessageId>" + message.first
+                + "</MessageId><InsertionTime>" + date + "</InsertionTime><ExpirationTime>" + date
+                + "</ExpirationTime><PopReceipt>receipt</PopReceipt><TimeNextVisible>" + date
+                + "</TimeNextVisible><DequeueCount>1</DequeueCount><MessageText>"
+                + message.second + "</MessageText></QueueMessage>";
+          }
+          responseBody += "</QueueMessagesList>";
+        }
+        else
+        {
+          const std::string path = request.GetUrl().GetPath();
+          m_messages->DeletedMessages.insert(path.substr(path.rfind('/') + 1));
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::NoContent, "No Content");
+          responseBody.clear();
+        }
+        response->SetBody(std::vector<uint8_t>(responseBody.begin(), responseBody.end()));
+        response->SetHeader("content-type", "application/xml");
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", "2018-03-28");
+        return response;
+      }
+
+    private:
+      std::shared_ptr<MockMessages> m_messages;
+    };
+
+    class MockPayloadStore final : public Queues::QueueMessagePayloadStore {
+    public:
+      std::string Upload(const std::string& payload, const Core::Context&) override
+      {
+        std::lock_guard<std::mutex> guard(Mutex);
+        const std::string payloadReference = "payload" + std::to_string(++UploadCount);
+        Payloads.emplace(payloadReference, payload);
+        return payloadReference;
+      }
+
+      std::string Download(const std::string& payloadReference, const Core::Context&) override
+      {
+        std::lock_guard<std::mutex> guard(Mutex);
+        ++DownloadCount;
+        return Payloads.at(payloadReference);
+      }
+
+      void Delete(const std::string& payloadReference, const Core::Context&) override
+      {
+        std::lock_guard<std::mutex> guard(Mutex);
+        Payloads.erase(payloadReference);
+      }
+
+      std::mutex Mutex;
+      std::map<std::string, std::string> Payloads;
+      int32_t UploadCount = 0;
+      int32_t DownloadCount = 0;
+    };
+  } // namespace
+
+  TEST(QueueClientEnqueueMessagesTest, ReportsTheOutcomeOfEveryMessage)
+  {
+    auto bodies = std::make_shared<std::vector<std::string>>();
+    Queues::QueueClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockEnqueueTransportPolicy>(bodies));
+    Queues::QueueClient queueClient("https://account.queue.core.windows.net/queue", clientOptions);
+
+    std::vector<std::string> messageTexts;
+    for (int i = 0; i < 50; ++i)
+    {
+      messageTexts.push_back(i == 7 ? "invalid" : "<message " + std::to_string(i) + " & \"text\">");
+    }
+    Queues::EnqueueMessagesOptions options;
+    options.Concurrency = 4;
+    auto result = queueClient.EnqueueMessages(messageTexts, options);
+
+    EXPECT_EQ(result.NumberOfSuccessfulMessages, 49);
+    EXPECT_EQ(result.NumberOfFailures, 1);
+    ASSERT_EQ(result.Outcomes.size(), messageTexts.size());
+    for (size_t i = 0; i < messageTexts.size(); ++i)
+    {
+      EXPECT_EQ(result.Outcomes[i].EnqueuedMessage.HasValue(), i != 7);
+    }
+    EXPECT_EQ(result.Outcomes[7].StatusCode, Core::Http::HttpStatusCode::BadRequest);
+    EXPECT_EQ(result.Outcomes[7].ErrorCode, "InvalidXmlDocument");
+    EXPECT_FALSE(result.Outcomes[7].ErrorMessage.empty());
+
+    // The bodies are the same as those of single enqueues.
+    std::vector<std::string> batchBodies = *bodies;
+    bodies->clear();
+    for (const auto& messageText : messageTexts)
+    {
+      try
+      {
+        queueClient.EnqueueMessage(messageText);
+      }
+      catch (StorageException&)
+      {
+      }
+    }
+    std::sort(batchBodies.begin(), batchBodies.end());
+    std::sort(bodies->begin(), bodies->end());
+    EXPECT_EQ(batchBodies, *bodies);
+  }
+
+  TEST(QueueClientReceiveMessagesTest, ViewsTheMessageTextsInTheResponse)
+  {
+    auto messages = std::make_shared<MockMessages>();
+    Queues::QueueClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockMessagesTransportPolicy>(messages));
+    Queues::QueueClient queueClient("https://account.queue.core.windows.net/queue", clientOptions);
+    const std::vector<uint8_t> binary = {0, 1, 2, 250, 251, 252, 253, 254, 255};
+    messages->Messages.emplace("message1", "a &lt;b&gt; &amp; &#13;\nc");
+    messages->Messages.emplace("message2", Core::Convert::Base64Encode(binary));
+    messages->Messages.emplace("message3", "");
+
+    Queues::ReceiveMessagesOptions options;
+    options.MessageTextViewOnly = true;
+    auto response = queueClient.ReceiveMessages(options);
+    auto& receivedMessages = response.Value.Messages;
+    ASSERT_EQ(receivedMessages.size(), 3U);
+    for (const auto& message : receivedMessages)
+    {
+      EXPECT_TRUE(message.MessageText.empty());
+      ASSERT_NE(message.MessageTextView.Data, nullptr);
+    }
+    const auto& rawBody = response.RawResponse->GetBody();
+    const char* bodyStart = reinterpret_cast<const char*>(rawBody.data());
+    EXPECT_GE(receivedMessages[1].MessageTextView.Data, bodyStart);
+    EXPECT_LE(receivedMessages[1].MessageTextView.Data, bodyStart + rawBody.size());
+    const auto& textView = receivedMessages[0].MessageTextView;
+    EXPECT_EQ(std::string(textView.Data, textView.Size), "a <b> & \r\nc");
+    EXPECT_EQ(receivedMessages[2].MessageTextView.Size, 0U);
+
+    Queues::Base64DecodeMessageTextInPlace(receivedMessages[1].MessageTextView);
+    EXPECT_EQ(
+        std::vector<uint8_t>(
+            receivedMessages[1].MessageTextView.Data,
+            receivedMessages[1].MessageTextView.Data + receivedMessages[1].MessageTextView.Size),
+        binary);
+
+    // The texts are copied by default.
+    receivedMessages = queueClient.ReceiveMessages().Value.Messages;
+    ASSERT_EQ(receivedMessages.size(), 3U);
+    EXPECT_EQ(receivedMessages[0].MessageText, "a <b> & \r\nc");
+    EXPECT_EQ(receivedMessages[0].MessageTextView.Data, nullptr);
+  }
+
+  TEST(QueueClientPayloadOffloadTest, OffloadsTheLargePayloads)
+  {
+    auto messages = std::make_shared<MockMessages>();
+    auto store = std::make_shared<MockPayloadStore>();
+    Queues::QueueClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(
+        std::make_unique<MockMessagesTransportPolicy>(messages));
+    clientOptions.PayloadOffload.Store = store;
+    clientOptions.PayloadOffload.Threshold = 16;
+    Queues::QueueClient queueClient("https://account.queue.core.windows.net/queue", clientOptions);
+
+    const std::vector<std::string> messageTexts
+        = {"small", std::string(100, 'a'), "small too", std::string(17, 'b'), std::string(16, 'c')};
+    queueClient.EnqueueMessage(messageTexts[0]);
+    queueClient.EnqueueMessage(messageTexts[1]);
+    auto enqueueResult = queueClient.EnqueueMessages(
+        std::vector<std::string>(messageTexts.begin() + 2, messageTexts.end()));
+    EXPECT_EQ(enqueueResult.NumberOfSuccessfulMessages, 3);
+    EXPECT_EQ(store->Payloads.size(), 2U);
+    for (const auto& message : messages->Messages)
+    {
+      EXPECT_LE(message.second.size(), 40U);
+    }
+
+    // The payloads are prefetched.
+    auto receivedMessages = queueClient.ReceiveMessages().Value.Messages;
+    ASSERT_EQ(receivedMessages.size(), messageTexts.size());
+    for (size_t i = 0; i < messageTexts.size(); ++i)
+    {
+      EXPECT_EQ(receivedMessages[i].MessageText, messageTexts[i]);
+      EXPECT_EQ(receivedMessages[i].PayloadReference.HasValue(), i == 1 || i == 3);
+    }
+    EXPECT_EQ(store->DownloadCount, 2);
+
+    // Or downloaded on demand.
+    clientOptions.PayloadOffload.PrefetchPayloads = false;
+    Queues::QueueClient lazyQueueClient(
+        "https://account.queue.core.windows.net/queue", clientOptions);
+    auto peekedMessages = lazyQueueClient.PeekMessages().Value.Messages;
+    ASSERT_EQ(peekedMessages.size(), messageTexts.size());
+    EXPECT_EQ(peekedMessages[0].MessageText, messageTexts[0]);
+    EXPECT_FALSE(peekedMessages[0].PayloadReference.HasValue());
+    ASSERT_TRUE(peekedMessages[1].PayloadReference.HasValue());
+    EXPECT_NE(peekedMessages[1].MessageText, messageTexts[1]);
+    EXPECT_EQ(store->DownloadCount, 2);
+    EXPECT_EQ(
+        lazyQueueClient.DownloadMessagePayload(peekedMessages[1].PayloadReference.Value()),
+        messageTexts[1]);
+
+    // The payloads are deleted with their messages.
+    for (const auto& message : receivedMessages)
+    {
+      queueClient.DeleteMessage(message);
+    }
+    EXPECT_EQ(messages->DeletedMessages.size(), messageTexts.size());
+    EXPECT_TRUE(store->Payloads.empty());
+  }
+
   TEST_F(QueueClientTest, EnqueueMessage)
   {
     auto queueClient = Azure::Storage::Queues::QueueClient::CreateFromConnectionString(
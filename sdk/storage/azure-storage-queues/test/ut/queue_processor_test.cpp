@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "queue_client_test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <azure/core/uuid.hpp>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    struct MockQueue final
+    {
+      std::mutex Mutex;
+      // The pop receipt of every message, empty until the message is received.
+      std::map<std::string, std::string> Messages;
+      std::set<std::string> DeletedMessages;
+      int64_t ReceiveCount = 0;
+      int64_t UpdateCount = 0;
+      int32_t PopReceiptVersion = 0;
+    };
+
+    // Serves the requests of the messages of a queue. A message is received once, its pop receipt
+    // changes when it's updated and it's deleted only with its latest pop receipt.
+    class MockQueueTransportPolicy final : public Core::Http::Policies::HttpPolicy {
+    public:
+      explicit MockQueueTransportPolicy(std::shared_ptr<MockQueue> queue)
+          : m_queue(std::move(queue))
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<MockQueueTransportPolicy>(*this);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Http::Request& request,
+          Core::Http::Policies::NextHttpPolicy,
+          Core::Context const&) const override
+      {
+        const std::string date = "Thu, 23 Aug 2001 07:00:00 GMT";
+        const std::string path = request.GetUrl().GetPath();
+        const std::string messageId = path.substr(path.rfind('/') + 1);
+        const auto query = request.GetUrl().GetQueryParameters();
+        std::unique_ptr<Core::Http::RawResponse> response;
+        std::lock_guard<std::mutex> guard(m_queue->Mutex);
+        if (request.GetMethod() == Core::Http::HttpMethod::Get)
+        {
+          ++m_queue->ReceiveCount;
+          size_t maxMessages = query.find("numofmessages") == query.end()
+              ? 1
+              : std::stoul(query.at("numofmessages"));
+          std::string body = "<?xml version=\"1.0\" encoding=\"utf-8\"?><QueueMessagesList>";
+          for (auto& message : m_queue->Messages)
+          {
+            if (maxMessages == 0)
+            {
+              break;
+            }
+            if (!message.second.empty())
+            {
+              continue;
+            }
+            message.second = NewPopReceipt();
+            --maxMessages;
+            body += "<QueueMessage><MessageId>" + message.first + "</MessageId><InsertionTime>"
+                + date + "</InsertionTime><ExpirationTime>" + date + "</ExpirationTime><PopReceipt>"
+                + message.second + "</PopReceipt><TimeNextVisible>" + date
+                + "</TimeNextVisible><DequeueCount>1</DequeueCount><MessageText>" + message.first
+                + "</MessageText></QueueMessage>";
+          }
+          body += "</QueueMessagesList>";
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::Ok, "OK");
+          response->SetBody(std::vector<uint8_t>(body.begin(), body.end()));
+          response->SetHeader("content-type", "application/xml");
+        }
+        else if (
+            m_queue->Messages.find(messageId) == m_queue->Messages.end()
+            || m_queue->Messages.at(messageId) != query.at("popreceipt"))
+        {
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::NotFound, "Not Found");
+        }
+        else if (request.GetMethod() == Core::Http::HttpMethod::Put)
+        {
+          ++m_queue->UpdateCount;
+          m_queue->Messages.at(messageId) = NewPopReceipt();
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::NoContent, "No Content");
+          response->SetHeader("x-ms-popreceipt", m_queue->Messages.at(messageId));
+          response->SetHeader("x-ms-time-next-visible", date);
+        }
+        else
+        {
+          m_queue->Messages.erase(messageId);
+          m_queue->DeletedMessages.insert(messageId);
+          response = std::make_unique<Core::Http::RawResponse>(
+              1, 1, Core::Http::HttpStatusCode::NoContent, "No Content");
+        }
+        response->SetHeader("x-ms-request-id", Core::Uuid::CreateUuid().ToString());
+        response->SetHeader("x-ms-version", "2018-03-28");
+        return response;
+      }
+
+    private:
+      std::string NewPopReceipt() const
+      {
+        return "receipt" + std::to_string(++m_queue->PopReceiptVersion);
+      }
+
+      std::shared_ptr<MockQueue> m_queue;
+    };
+  } // namespace
+
+  TEST(QueueProcessorTest, HandlesAndDeletesMessagesConcurrently)
+  {
+    auto queue = std::make_shared<MockQueue>();
+    std::set<std::string> messageIds;
+    for (int i = 0; i < 100; ++i)
+    {
+      const std::string messageId = "message" + std::to_string(100 + i);
+      queue->Messages.emplace(messageId, std::string());
+      messageIds.insert(messageId);
+    }
+    Queues::QueueClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockQueueTransportPolicy>(queue));
+    Queues::QueueClient queueClient("https://account.queue.core.windows.net/queue", clientOptions);
+
+    // The slow message outlives the first half of its visibility timeout, the failed one is left
+    // in the queue.
+    const std::string slowMessageId = "message100";
+    const std::string failedMessageId = "message101";
+    std::mutex handledMutex;
+    std::set<std::string> handledMessageIds;
+    std::atomic<int32_t> handlingCount{0};
+    std::atomic<int32_t> maxHandlingCount{0};
+    std::atomic<int32_t> errorCount{0};
+    Queues::QueueProcessorOptions options;
+    options.HandlerConcurrency = 4;
+    options.MaxBufferedMessages = 8;
+    options.VisibilityTimeout = std::chrono::seconds(1);
+    options.MinIdleDelay = std::chrono::milliseconds(1);
+    options.MaxIdleDelay = std::chrono::milliseconds(10);
+    options.ErrorHandler = [&](std::exception_ptr) { ++errorCount; };
+    {
+      Queues::QueueProcessor processor(
+          queueClient,
+          [&](const Queues::Models::QueueMessage& message, const Core::Context&) {
+            const int32_t count = ++handlingCount;
+            int32_t maxCount = maxHandlingCount;
+            while (count > maxCount && !maxHandlingCount.compare_exchange_weak(maxCount, count))
+            {
+            }
+            EXPECT_EQ(message.MessageText, message.MessageId);
+            if (message.MessageId == slowMessageId)
+            {
+              std::this_thread::sleep_for(std::chrono::milliseconds(800));
+            }
+            {
+              std::lock_guard<std::mutex> guard(handledMutex);
+              EXPECT_TRUE(handledMessageIds.insert(message.MessageId).second);
+            }
+            --handlingCount;
+            if (message.MessageId == failedMessageId)
+            {
+              throw std::runtime_error("handler failed");
+            }
+          },
+          options);
+      while (true)
+      {
+        {
+          std::lock_guard<std::mutex> guard(handledMutex);
+          if (handledMessageIds.size() == messageIds.size())
+          {
+            break;
+          }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+
+    EXPECT_EQ(handledMessageIds, messageIds);
+    EXPECT_LE(maxHandlingCount, 4);
+    EXPECT_EQ(errorCount, 1);
+    messageIds.erase(failedMessageId);
+    EXPECT_EQ(queue->DeletedMessages, messageIds);
+    EXPECT_EQ(queue->Messages.size(), 1U);
+    EXPECT_GE(queue->UpdateCount, 1);
+  }
+
+  TEST(QueuePollerTest, WaitsForMessagesWithBackoff)
+  {
+    auto queue = std::make_shared<MockQueue>();
+    Queues::QueueClientOptions clientOptions;
+    clientOptions.PerRetryPolicies.emplace_back(std::make_unique<MockQueueTransportPolicy>(queue));
+    Queues::QueueClient queueClient("https://account.queue.core.windows.net/queue", clientOptions);
+    Queues::QueuePollerOptions options;
+    options.MinIdleDelay = std::chrono::milliseconds(5);
+    options.MaxIdleDelay = std::chrono::milliseconds(20);
+    Queues::QueuePoller poller(queueClient, options);
+
+    // The empty polls back off until the deadline.
+    EXPECT_THROW(
+        poller.ReceiveMessages(
+            Queues::ReceiveMessagesOptions(),
+            Core::Context::ApplicationContext.WithDeadline(
+                std::chrono::system_clock::now() + std::chrono::milliseconds(200))),
+        Core::OperationCancelledException);
+    {
+      std::lock_guard<std::mutex> guard(queue->Mutex);
+      // 5, 10, then 20 ms apart, jittered.
+      EXPECT_GE(queue->ReceiveCount, 5);
+      EXPECT_LE(queue->ReceiveCount, 20);
+      queue->ReceiveCount = 0;
+    }
+
+    std::thread producer([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      std::lock_guard<std::mutex> guard(queue->Mutex);
+      queue->Messages.emplace("message", std::string());
+    });
+    Queues::ReceiveMessagesOptions receiveOptions;
+    receiveOptions.MaxMessages = 32;
+    auto messages = poller.ReceiveMessages(receiveOptions).Value.Messages;
+    producer.join();
+    ASSERT_EQ(messages.size(), 1U);
+    EXPECT_EQ(messages[0].MessageId, "message");
+    EXPECT_GT(queue->ReceiveCount, 1);
+  }
+
+}}} // namespace Azure::Storage::Test